@@ -40,7 +40,7 @@ ExternalProject_Add(
     -DCMAKE_POSITION_INDEPENDENT_CODE=ON
     -DCMAKE_BUILD_TYPE=${THIRD_PARTY_BUILD_TYPE}
     -DCMAKE_PREFIX_PATH=${prefix_path}
-    -DFAISS_ENABLE_GPU=OFF
+    -DFAISS_ENABLE_GPU=${FAISS_ENABLE_GPU}
     -DFAISS_ENABLE_PYTHON=OFF
     -DBLA_STATIC=ON
     -DBUILD_TESTING=OFF
@@ -0,0 +1,59 @@
+# Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+INCLUDE(ExternalProject)
+message(STATUS "Include google benchmark...")
+
+SET(GBENCHMARK_SOURCES_DIR ${THIRD_PARTY_PATH}/source/gbenchmark)
+SET(GBENCHMARK_BINARY_DIR ${THIRD_PARTY_PATH}/build/gbenchmark)
+SET(GBENCHMARK_INSTALL_DIR ${THIRD_PARTY_PATH}/install/gbenchmark)
+SET(GBENCHMARK_INCLUDE_DIR "${GBENCHMARK_INSTALL_DIR}/include" CACHE PATH "google benchmark include directory." FORCE)
+SET(GBENCHMARK_LIBRARIES "${GBENCHMARK_INSTALL_DIR}/lib/libbenchmark.a" CACHE FILEPATH "google benchmark library." FORCE)
+
+# only used by micro benchmark, so fetch it on demand instead of a submodule.
+ExternalProject_Add(
+    extern_gbenchmark
+    ${EXTERNAL_PROJECT_LOG_ARGS}
+
+    GIT_REPOSITORY https://github.com/google/benchmark.git
+    GIT_TAG v1.8.3
+    GIT_SHALLOW TRUE
+
+    SOURCE_DIR ${GBENCHMARK_SOURCES_DIR}
+    BINARY_DIR ${GBENCHMARK_BINARY_DIR}
+    PREFIX ${GBENCHMARK_BINARY_DIR}
+
+    UPDATE_COMMAND ""
+    CMAKE_ARGS -DCMAKE_CXX_COMPILER=${CMAKE_CXX_COMPILER}
+    -DCMAKE_C_COMPILER=${CMAKE_C_COMPILER}
+    -DCMAKE_CXX_FLAGS=${CMAKE_CXX_FLAGS}
+    -DCMAKE_C_FLAGS=${CMAKE_C_FLAGS}
+    -DCMAKE_INSTALL_PREFIX=${GBENCHMARK_INSTALL_DIR}
+    -DCMAKE_INSTALL_LIBDIR=${GBENCHMARK_INSTALL_DIR}/lib
+    -DCMAKE_POSITION_INDEPENDENT_CODE=ON
+    -DCMAKE_BUILD_TYPE=Release
+    -DBENCHMARK_ENABLE_TESTING=OFF
+    -DBENCHMARK_ENABLE_GTEST_TESTS=OFF
+    -DBENCHMARK_ENABLE_WERROR=OFF
+    ${EXTERNAL_OPTIONAL_ARGS}
+    LIST_SEPARATOR |
+    CMAKE_CACHE_ARGS -DCMAKE_INSTALL_PREFIX:PATH=${GBENCHMARK_INSTALL_DIR}
+    -DCMAKE_INSTALL_LIBDIR:PATH=${GBENCHMARK_INSTALL_DIR}/lib
+    -DCMAKE_POSITION_INDEPENDENT_CODE:BOOL=ON
+    -DCMAKE_BUILD_TYPE:STRING=Release
+)
+
+ADD_LIBRARY(gbenchmark STATIC IMPORTED GLOBAL)
+SET_PROPERTY(TARGET gbenchmark PROPERTY IMPORTED_LOCATION ${GBENCHMARK_LIBRARIES})
+ADD_DEPENDENCIES(gbenchmark extern_gbenchmark)
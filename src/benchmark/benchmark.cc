@@ -14,10 +14,13 @@
 
 #include "benchmark/benchmark.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <csignal>
 #include <cstddef>
 #include <cstdint>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <mutex>
@@ -50,6 +53,8 @@ DEFINE_uint32(concurrency, 1, "Concurrency of request");
 DEFINE_uint64(req_num, 10000, "Request number");
 DEFINE_uint32(timelimit, 0, "Time limit in seconds");
 
+DEFINE_uint32(target_qps, 0, "Target qps of all threads for open loop test, 0 means closed loop");
+
 DEFINE_uint32(delay, 2, "Interval in seconds between intermediate reports");
 
 DEFINE_bool(is_single_region_txn, true, "Is single region txn");
@@ -69,13 +74,14 @@ DEFINE_uint32(vector_dimension, 256, "Vector dimension");
 DEFINE_string(vector_value_type, "FLOAT", "Vector value type");
 DEFINE_validator(vector_value_type, [](const char*, const std::string& value) -> bool {
   auto value_type = dingodb::Helper::ToUpper(value);
-  return value_type == "FLOAT" || value_type == "UINT8";
+  return value_type == "FLOAT" || value_type == "UINT8" || value_type == "INT8";
 });
 DEFINE_uint32(vector_max_element_num, 100000, "Vector index contain max element number");
 DEFINE_string(vector_metric_type, "L2", "Calcute vector distance method");
 DEFINE_validator(vector_metric_type, [](const char*, const std::string& value) -> bool {
   auto metric_type = dingodb::Helper::ToUpper(value);
-  return metric_type == "NONE" || metric_type == "L2" || metric_type == "IP" || metric_type == "COSINE";
+  return metric_type == "NONE" || metric_type == "L2" || metric_type == "IP" || metric_type == "COSINE" ||
+         metric_type == "HAMMING";
 });
 DEFINE_string(vector_partition_vector_ids, "", "Vector id used by partition");
 
@@ -89,7 +95,8 @@ DEFINE_uint32(ivf_bucket_max_size, 1280000, "IVF bucket max size");
 DEFINE_uint32(ivf_nbits_per_idx, 8, "IVF nbits per idx");
 
 // vector search
-DEFINE_string(vector_dataset, "", "Open source dataset, like sift/gist/glove/mnist etc.., hdf5 format");
+DEFINE_string(vector_dataset, "",
+              "Open source dataset, like sift/gist/glove/mnist etc.. hdf5 format, or deep1B etc.. fbin directory");
 DEFINE_validator(vector_dataset, [](const char*, const std::string& value) -> bool {
   return value.empty() || dingodb::Helper::IsExistPath(value);
 });
@@ -105,16 +112,31 @@ DEFINE_bool(vector_search_use_brute_force, false, "Vector search flag use_brute_
 DEFINE_bool(vector_search_enable_range_search, false, "Vector search flag enable_range_search");
 DEFINE_double(vector_search_radius, 0.1, "Vector search flag radius");
 
+// vector search sweep, grid of comma separated values, empty means not sweep the param
+DEFINE_string(vector_search_sweep_ef_search, "", "Vector search sweep ef_search values, e.g. 16,32,64,128");
+DEFINE_string(vector_search_sweep_nprobe, "", "Vector search sweep nprobe values, e.g. 8,16,32");
+DEFINE_string(vector_search_sweep_topk, "", "Vector search sweep topk values, e.g. 1,10,100");
+DEFINE_string(vector_search_sweep_output, "", "Vector search sweep result file, json if end with .json else csv");
+DECLARE_int32(vector_search_ef_search);
+DECLARE_int32(vector_search_nprobe);
+
 DECLARE_uint32(vector_put_batch_size);
 DECLARE_uint32(vector_arrange_concurrency);
 DECLARE_bool(vector_search_arrange_data);
 
 DECLARE_string(benchmark);
+DECLARE_string(failpoint_scenario);
 DECLARE_uint32(key_size);
 DECLARE_uint32(value_size);
 DECLARE_uint32(batch_size);
 DECLARE_bool(is_pessimistic_txn);
 DECLARE_string(txn_isolation_level);
+DECLARE_double(workload_read_proportion);
+DECLARE_double(workload_update_proportion);
+DECLARE_double(workload_insert_proportion);
+DECLARE_double(workload_scan_proportion);
+DECLARE_double(workload_rmw_proportion);
+DECLARE_string(workload_request_distribution);
 
 namespace dingodb {
 namespace benchmark {
@@ -146,11 +168,66 @@ static bool IsTransactionBenchmark() {
           FLAGS_benchmark == "readtxnrandom" || FLAGS_benchmark == "readtxnmissing");
 }
 
+static bool IsVectorSearchSweep() {
+  return FLAGS_benchmark == "searchvector" &&
+         (!FLAGS_vector_search_sweep_ef_search.empty() || !FLAGS_vector_search_sweep_nprobe.empty() ||
+          !FLAGS_vector_search_sweep_topk.empty());
+}
+
+template <typename T>
+static std::vector<T> ParseSweepValues(const std::string& str, T default_value) {
+  std::vector<int64_t> values;
+  if (!str.empty()) {
+    Helper::SplitString(str, ',', values);
+  }
+  if (values.empty()) {
+    return {default_value};
+  }
+
+  return std::vector<T>(values.begin(), values.end());
+}
+
 static bool IsVectorBenchmark() {
   return FLAGS_benchmark == "fillvectorseq" || FLAGS_benchmark == "fillvectorrandom" ||
          FLAGS_benchmark == "searchvector";
 }
 
+// Open loop pacer of a thread, requests are scheduled at a fixed interval regardless of response time.
+// Latency is measured from the scheduled time instead of the send time, so a slow response is not hidden
+// by the delayed requests behind it, it is called coordinated omission correction.
+class RequestPacer {
+ public:
+  RequestPacer()
+      : interval_us_(FLAGS_target_qps > 0 ? static_cast<int64_t>(FLAGS_concurrency) * 1000000 / FLAGS_target_qps : 0),
+        next_time_us_(Helper::TimestampUs()) {}
+
+  // Wait to the scheduled time of next request, return the scheduled time.
+  int64_t Wait() {
+    if (interval_us_ <= 0) {
+      return 0;
+    }
+
+    int64_t scheduled_time_us = next_time_us_;
+    next_time_us_ += interval_us_;
+    int64_t now_us = Helper::TimestampUs();
+    if (scheduled_time_us > now_us) {
+      std::this_thread::sleep_for(std::chrono::microseconds(scheduled_time_us - now_us));
+    }
+    return scheduled_time_us;
+  }
+
+  size_t Latency(int64_t scheduled_time_us, size_t eplased_time) const {
+    if (interval_us_ <= 0) {
+      return eplased_time;
+    }
+    return Helper::TimestampUs() - scheduled_time_us;
+  }
+
+ private:
+  const int64_t interval_us_;
+  int64_t next_time_us_;
+};
+
 Stats::Stats() {
   latency_recorder_ = std::make_shared<bvar::LatencyRecorder>();
   recall_recorder_ = std::make_shared<bvar::LatencyRecorder>();
@@ -238,33 +315,169 @@ std::shared_ptr<Benchmark> Benchmark::New(std::shared_ptr<sdk::CoordinatorProxy>
 }
 
 void Benchmark::Stop() {
+  is_stop_.store(true, std::memory_order_relaxed);
   for (auto& thread_entry : thread_entries_) {
     thread_entry->is_stop.store(true, std::memory_order_relaxed);
   }
 }
 
 bool Benchmark::Run() {
+  if (IsVectorSearchSweep()) {
+    // arrange the neighbors of the max topk, recall@k use the k nearest of them
+    auto topks = ParseSweepValues<uint32_t>(FLAGS_vector_search_sweep_topk, FLAGS_vector_search_topk);
+    FLAGS_vector_search_topk = *std::max_element(topks.begin(), topks.end());
+  }
+
+  if (!FLAGS_failpoint_scenario.empty() && !IsVectorSearchSweep()) {
+    failpoint_scenario_ = FailPointScenario::New();
+    if (failpoint_scenario_ == nullptr || !failpoint_scenario_->Init()) {
+      return false;
+    }
+  }
+
   if (!Arrange()) {
     Clean();
     return false;
   }
 
+  if (IsVectorSearchSweep()) {
+    RunVectorSearchSweep();
+    Clean();
+    return true;
+  }
+
   Launch();
 
   size_t start_time = Helper::TimestampMs();
+  if (failpoint_scenario_ != nullptr) {
+    failpoint_scenario_->Start();
+  }
 
   // Interval report
   IntervalReport();
 
   Wait();
 
+  if (failpoint_scenario_ != nullptr) {
+    failpoint_scenario_->Stop();
+  }
+
   // Cumulative report
   Report(true, Helper::TimestampMs() - start_time);
 
+  if (failpoint_scenario_ != nullptr) {
+    failpoint_scenario_->Report();
+  }
+
   Clean();
   return true;
 }
 
+void Benchmark::RunVectorSearchSweep() {
+  auto ef_searchs = ParseSweepValues<int32_t>(FLAGS_vector_search_sweep_ef_search, FLAGS_vector_search_ef_search);
+  auto nprobes = ParseSweepValues<int32_t>(FLAGS_vector_search_sweep_nprobe, FLAGS_vector_search_nprobe);
+  auto topks = ParseSweepValues<uint32_t>(FLAGS_vector_search_sweep_topk, FLAGS_vector_search_topk);
+
+  std::vector<SweepResult> results;
+  for (auto ef_search : ef_searchs) {
+    for (auto nprobe : nprobes) {
+      for (auto topk : topks) {
+        if (is_stop_.load(std::memory_order_relaxed)) {
+          ReportSweep(results);
+          return;
+        }
+
+        FLAGS_vector_search_ef_search = ef_search;
+        FLAGS_vector_search_nprobe = nprobe;
+        FLAGS_vector_search_topk = topk;
+        std::cout << COLOR_GREEN
+                  << fmt::format("Sweep ef_search({}) nprobe({}) topk({}):", ef_search, nprobe, topk) << COLOR_RESET
+                  << '\n';
+
+        {
+          std::lock_guard lock(mutex_);
+          stats_interval_ = std::make_shared<Stats>();
+          stats_cumulative_ = std::make_shared<Stats>();
+        }
+        thread_entries_.clear();
+
+        Launch();
+        size_t start_time = Helper::TimestampMs();
+        IntervalReport();
+        Wait();
+        size_t milliseconds = std::max(Helper::TimestampMs() - start_time, static_cast<size_t>(1));
+        Report(true, milliseconds);
+
+        std::lock_guard lock(mutex_);
+        SweepResult result;
+        result.ef_search = ef_search;
+        result.nprobe = nprobe;
+        result.topk = topk;
+        result.req_num = stats_cumulative_->ReqNum();
+        result.error_count = stats_cumulative_->ErrorCount();
+        result.qps = result.req_num * 1000.0 / milliseconds;
+        result.p50_latency_us = stats_cumulative_->LatencyPercentile(0.5);
+        result.p99_latency_us = stats_cumulative_->LatencyPercentile(0.99);
+        result.recall = stats_cumulative_->RecallAvg() / 100.0;
+        results.push_back(result);
+      }
+    }
+  }
+
+  ReportSweep(results);
+}
+
+void Benchmark::ReportSweep(const std::vector<SweepResult>& results) {
+  std::cout << COLOR_GREEN << "Sweep:" << COLOR_RESET << '\n';
+  std::cout << COLOR_GREEN
+            << fmt::format("{:>12}{:>10}{:>10}{:>8}{:>10}{:>10}{:>10}{:>10}{:>12}", "INDEX_TYPE", "EF_SEARCH",
+                           "NPROBE", "TOPK", "REQ_NUM", "QPS", "P50(us)", "P99(us)", "RECALL(%)")
+            << COLOR_RESET << '\n';
+  for (const auto& result : results) {
+    std::cout << fmt::format("{:>12}{:>10}{:>10}{:>8}{:>10}{:>10.0f}{:>10}{:>10}{:>12.2f}", FLAGS_vector_index_type,
+                             result.ef_search, result.nprobe, result.topk, result.req_num, result.qps,
+                             result.p50_latency_us, result.p99_latency_us, result.recall)
+              << '\n';
+  }
+
+  if (FLAGS_vector_search_sweep_output.empty()) {
+    return;
+  }
+
+  std::ofstream ofile(FLAGS_vector_search_sweep_output, std::ofstream::out | std::ofstream::trunc);
+  if (!ofile.is_open()) {
+    std::cerr << fmt::format("Open sweep output file {} failed", FLAGS_vector_search_sweep_output) << '\n';
+    return;
+  }
+
+  const std::string json_suffix = ".json";
+  const auto& path = FLAGS_vector_search_sweep_output;
+  bool is_json = path.size() >= json_suffix.size() &&
+                 path.compare(path.size() - json_suffix.size(), json_suffix.size(), json_suffix) == 0;
+  if (is_json) {
+    ofile << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+      const auto& result = results[i];
+      ofile << fmt::format(
+          "  {{\"index_type\": \"{}\", \"dataset\": \"{}\", \"ef_search\": {}, \"nprobe\": {}, \"topk\": {}, "
+          "\"req_num\": {}, \"errors\": {}, \"qps\": {:.2f}, \"p50_us\": {}, \"p99_us\": {}, \"recall\": {:.2f}}}{}\n",
+          FLAGS_vector_index_type, FLAGS_vector_dataset, result.ef_search, result.nprobe, result.topk, result.req_num,
+          result.error_count, result.qps, result.p50_latency_us, result.p99_latency_us, result.recall,
+          (i + 1 < results.size()) ? "," : "");
+    }
+    ofile << "]\n";
+  } else {
+    ofile << "index_type,dataset,ef_search,nprobe,topk,req_num,errors,qps,p50_us,p99_us,recall\n";
+    for (const auto& result : results) {
+      ofile << fmt::format("{},{},{},{},{},{},{},{:.2f},{},{},{:.2f}\n", FLAGS_vector_index_type, FLAGS_vector_dataset,
+                           result.ef_search, result.nprobe, result.topk, result.req_num, result.error_count,
+                           result.qps, result.p50_latency_us, result.p99_latency_us, result.recall);
+    }
+  }
+
+  std::cout << fmt::format("Write sweep result to {}", FLAGS_vector_search_sweep_output) << '\n';
+}
+
 bool Benchmark::Arrange() {
   std::cout << COLOR_GREEN << "Arrange: " << COLOR_RESET << '\n';
 
@@ -527,6 +740,8 @@ sdk::MetricType GetMetricType(const std::string& metric_type) {
     return sdk::MetricType::kInnerProduct;
   } else if (upper_metric_type == "COSINE") {
     return sdk::MetricType::kCosine;
+  } else if (upper_metric_type == "HAMMING") {
+    return sdk::MetricType::kHamming;
   }
 
   return sdk::MetricType::kNoneMetricType;
@@ -662,6 +877,7 @@ void Benchmark::ThreadRoutine(ThreadEntryPtr thread_entry) {
 void Benchmark::ExecutePerRegion(ThreadEntryPtr thread_entry) {
   auto region_entries = thread_entry->region_entries;
 
+  RequestPacer pacer;
   int64_t req_num_per_thread = static_cast<int64_t>(FLAGS_req_num / (FLAGS_concurrency * FLAGS_region_num));
   for (int64_t i = 0; i < req_num_per_thread; ++i) {
     if (thread_entry->is_stop.load(std::memory_order_relaxed)) {
@@ -669,13 +885,14 @@ void Benchmark::ExecutePerRegion(ThreadEntryPtr thread_entry) {
     }
 
     for (const auto& region_entry : region_entries) {
-      size_t eplased_time;
+      int64_t scheduled_time_us = pacer.Wait();
       auto result = operation_->Execute(region_entry);
+      size_t eplased_time = pacer.Latency(scheduled_time_us, result.eplased_time);
       {
         std::lock_guard lock(mutex_);
         if (result.status.ok()) {
-          stats_interval_->Add(result.eplased_time, result.write_bytes, result.read_bytes);
-          stats_cumulative_->Add(result.eplased_time, result.write_bytes, result.read_bytes);
+          stats_interval_->Add(eplased_time, result.write_bytes, result.read_bytes);
+          stats_cumulative_->Add(eplased_time, result.write_bytes, result.read_bytes);
         } else {
           stats_interval_->AddError();
           stats_cumulative_->AddError();
@@ -688,6 +905,7 @@ void Benchmark::ExecutePerRegion(ThreadEntryPtr thread_entry) {
 void Benchmark::ExecuteMultiRegion(ThreadEntryPtr thread_entry) {
   auto region_entries = thread_entry->region_entries;
 
+  RequestPacer pacer;
   int64_t req_num_per_thread = static_cast<int64_t>(FLAGS_req_num / FLAGS_concurrency);
 
   for (int64_t i = 0; i < req_num_per_thread; ++i) {
@@ -695,12 +913,14 @@ void Benchmark::ExecuteMultiRegion(ThreadEntryPtr thread_entry) {
       break;
     }
 
+    int64_t scheduled_time_us = pacer.Wait();
     auto result = operation_->Execute(region_entries);
+    size_t eplased_time = pacer.Latency(scheduled_time_us, result.eplased_time);
     {
       std::lock_guard lock(mutex_);
       if (result.status.ok()) {
-        stats_interval_->Add(result.eplased_time, result.write_bytes, result.read_bytes);
-        stats_cumulative_->Add(result.eplased_time, result.write_bytes, result.read_bytes);
+        stats_interval_->Add(eplased_time, result.write_bytes, result.read_bytes);
+        stats_cumulative_->Add(eplased_time, result.write_bytes, result.read_bytes);
       } else {
         stats_interval_->AddError();
         stats_cumulative_->AddError();
@@ -712,6 +932,7 @@ void Benchmark::ExecuteMultiRegion(ThreadEntryPtr thread_entry) {
 void Benchmark::ExecutePerVectorIndex(ThreadEntryPtr thread_entry) {
   auto vector_index_entries = thread_entry->vector_index_entries;
 
+  RequestPacer pacer;
   int64_t req_num_per_thread = static_cast<int64_t>(FLAGS_req_num / (FLAGS_concurrency * FLAGS_vector_index_num));
   for (int64_t i = 0; i < req_num_per_thread; ++i) {
     if (thread_entry->is_stop.load(std::memory_order_relaxed)) {
@@ -719,13 +940,14 @@ void Benchmark::ExecutePerVectorIndex(ThreadEntryPtr thread_entry) {
     }
 
     for (const auto& vector_index_entry : vector_index_entries) {
-      size_t eplased_time;
+      int64_t scheduled_time_us = pacer.Wait();
       auto result = operation_->Execute(vector_index_entry);
+      size_t eplased_time = pacer.Latency(scheduled_time_us, result.eplased_time);
       {
         std::lock_guard lock(mutex_);
         if (result.status.ok()) {
-          stats_interval_->Add(result.eplased_time, result.write_bytes, result.read_bytes, result.recalls);
-          stats_cumulative_->Add(result.eplased_time, result.write_bytes, result.read_bytes, result.recalls);
+          stats_interval_->Add(eplased_time, result.write_bytes, result.read_bytes, result.recalls);
+          stats_cumulative_->Add(eplased_time, result.write_bytes, result.read_bytes, result.recalls);
         } else {
           stats_interval_->AddError();
           stats_cumulative_->AddError();
@@ -749,6 +971,10 @@ void Benchmark::IntervalReport() {
       start_time = Helper::TimestampMs();
     }
 
+    if (failpoint_scenario_ != nullptr) {
+      failpoint_scenario_->Tick();
+    }
+
     // Check time limit
     if (FLAGS_timelimit > 0 && Helper::TimestampMs() - cumulative_start_time > FLAGS_timelimit * 1000) {
       Stop();
@@ -768,6 +994,10 @@ void Benchmark::Report(bool is_cumulative, size_t milliseconds) {
     stats_interval_->Clear();
   } else {
     stats_interval_->Report(false, milliseconds);
+    if (failpoint_scenario_ != nullptr) {
+      double qps = stats_interval_->ReqNum() * 1000.0 / std::max(milliseconds, static_cast<size_t>(1));
+      failpoint_scenario_->AddSample(qps, stats_interval_->LatencyPercentile(0.99));
+    }
     stats_interval_->Clear();
   }
 }
@@ -778,8 +1008,9 @@ Environment& Environment::GetInstance() {
 }
 
 bool Environment::Init() {
-  if (!IsSupportBenchmarkType(FLAGS_benchmark)) {
-    std::cerr << fmt::format("Not support benchmark {}, just support: {}", FLAGS_benchmark, GetSupportBenchmarkType())
+  if (FLAGS_benchmark != RaftBenchmark::kName && !IsSupportBenchmarkType(FLAGS_benchmark)) {
+    std::cerr << fmt::format("Not support benchmark {}, just support: {}{}", FLAGS_benchmark, GetSupportBenchmarkType(),
+                             RaftBenchmark::kName)
               << '\n';
     return false;
   }
@@ -804,10 +1035,15 @@ bool Environment::Init() {
 
 void Environment::AddBenchmark(BenchmarkPtr benchmark) { benchmarks_.push_back(benchmark); }
 
+void Environment::AddRaftBenchmark(RaftBenchmarkPtr raft_benchmark) { raft_benchmarks_.push_back(raft_benchmark); }
+
 void Environment::Stop() {
   for (auto& benchmark : benchmarks_) {
     benchmark->Stop();
   }
+  for (auto& raft_benchmark : raft_benchmarks_) {
+    raft_benchmark->Stop();
+  }
 }
 
 void Environment::PrintVersionInfo() {
@@ -857,6 +1093,8 @@ void Environment::PrintParam() {
   std::cout << fmt::format("{:<34}: {:>32}", "req_num", FLAGS_req_num) << '\n';
   std::cout << fmt::format("{:<34}: {:>32}", "delay(s)", FLAGS_delay) << '\n';
   std::cout << fmt::format("{:<34}: {:>32}", "timelimit(s)", FLAGS_timelimit) << '\n';
+  std::cout << fmt::format("{:<34}: {:>32}", "failpoint_scenario", FLAGS_failpoint_scenario) << '\n';
+  std::cout << fmt::format("{:<34}: {:>32}", "target_qps", FLAGS_target_qps) << '\n';
   std::cout << fmt::format("{:<34}: {:>32}", "key_size(byte)", FLAGS_key_size) << '\n';
   std::cout << fmt::format("{:<34}: {:>32}", "value_size(byte)", FLAGS_value_size) << '\n';
   std::cout << fmt::format("{:<34}: {:>32}", "batch_size", FLAGS_batch_size) << '\n';
@@ -865,6 +1103,14 @@ void Environment::PrintParam() {
   std::cout << fmt::format("{:<34}: {:>32}", "is_pessimistic_txn", FLAGS_is_pessimistic_txn ? "true" : "false") << '\n';
   std::cout << fmt::format("{:<34}: {:>32}", "txn_isolation_level", FLAGS_vector_search_topk) << '\n';
 
+  std::cout << fmt::format("{:<34}: {:>32}", "workload_read_proportion", FLAGS_workload_read_proportion) << '\n';
+  std::cout << fmt::format("{:<34}: {:>32}", "workload_update_proportion", FLAGS_workload_update_proportion) << '\n';
+  std::cout << fmt::format("{:<34}: {:>32}", "workload_insert_proportion", FLAGS_workload_insert_proportion) << '\n';
+  std::cout << fmt::format("{:<34}: {:>32}", "workload_scan_proportion", FLAGS_workload_scan_proportion) << '\n';
+  std::cout << fmt::format("{:<34}: {:>32}", "workload_rmw_proportion", FLAGS_workload_rmw_proportion) << '\n';
+  std::cout << fmt::format("{:<34}: {:>32}", "workload_request_distribution", FLAGS_workload_request_distribution)
+            << '\n';
+
   std::cout << fmt::format("{:<34}: {:>32}", "vector_dimension", FLAGS_vector_dimension) << '\n';
   std::cout << fmt::format("{:<34}: {:>32}", "vector_value_type", FLAGS_vector_value_type) << '\n';
   std::cout << fmt::format("{:<34}: {:>32}", "vector_max_element_num", FLAGS_vector_max_element_num) << '\n';
@@ -24,7 +24,9 @@
 #include <vector>
 
 #include "benchmark/dataset.h"
+#include "benchmark/failpoint_scenario.h"
 #include "benchmark/operation.h"
+#include "benchmark/raft_benchmark.h"
 #include "bvar/latency_recorder.h"
 #include "sdk/client.h"
 #include "sdk/coordinator_proxy.h"
@@ -45,6 +47,12 @@ class Stats {
 
   void Report(bool is_cumulative, size_t milliseconds) const;
 
+  size_t ReqNum() const { return req_num_; }
+  size_t ErrorCount() const { return error_count_; }
+  int64_t LatencyPercentile(double ratio) const { return latency_recorder_->latency_percentile(ratio); }
+  // Unit is 0.01%
+  int64_t RecallAvg() const { return recall_recorder_->latency(); }
+
  private:
   static std::string Header();
 
@@ -122,6 +130,21 @@ class Benchmark {
   bool ArrangeOperation();
   bool ArrangeData();
 
+  // Sweep vector search params grid, every grid point is a full run.
+  struct SweepResult {
+    int32_t ef_search;
+    int32_t nprobe;
+    uint32_t topk;
+    size_t req_num;
+    size_t error_count;
+    double qps;
+    int64_t p50_latency_us;
+    int64_t p99_latency_us;
+    double recall;
+  };
+  void RunVectorSearchSweep();
+  static void ReportSweep(const std::vector<SweepResult>& results);
+
   void Launch();
   void Wait();
 
@@ -154,9 +177,12 @@ class Benchmark {
 
   DatasetPtr dataset_;
 
+  FailPointScenarioPtr failpoint_scenario_;
+
   std::vector<RegionEntryPtr> region_entries_;
   std::vector<VectorIndexEntryPtr> vector_index_entries_;
   std::vector<ThreadEntryPtr> thread_entries_;
+  std::atomic<bool> is_stop_{false};
 
   std::mutex mutex_;
   StatsPtr stats_interval_;
@@ -174,6 +200,7 @@ class Environment {
   std::shared_ptr<sdk::Client> GetClient() { return client_; }
 
   void AddBenchmark(BenchmarkPtr benchmark);
+  void AddRaftBenchmark(RaftBenchmarkPtr raft_benchmark);
   void Stop();
 
  private:
@@ -184,6 +211,7 @@ class Environment {
   static void PrintParam();
 
   std::vector<BenchmarkPtr> benchmarks_;
+  std::vector<RaftBenchmarkPtr> raft_benchmarks_;
 
   std::shared_ptr<sdk::CoordinatorProxy> coordinator_proxy_;
   std::shared_ptr<sdk::Client> client_;
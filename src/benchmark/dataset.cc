@@ -14,14 +14,19 @@
 
 #include "benchmark/dataset.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cerrno>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <exception>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <map>
@@ -59,13 +64,18 @@ DEFINE_uint32(load_vector_dataset_concurrency, 4, "load vector dataset concurren
 
 DEFINE_uint32(batch_vector_entry_cache_size, 1024, "batch vector entry cache");
 
+DEFINE_uint32(vector_dataset_train_limit, 0, "only load the first n train vectors of bin dataset, 0 is all");
+
 DEFINE_string(vector_search_filter, "", "vector search filter,e.g. key=value;key=value");
 
 namespace dingodb {
 namespace benchmark {
 
 std::shared_ptr<Dataset> Dataset::New(std::string filepath) {
-  if (filepath.find("sift") != std::string::npos) {
+  if (BinDataset::IsBinDataset(filepath)) {
+    return std::make_shared<BinDataset>(filepath);
+
+  } else if (filepath.find("sift") != std::string::npos) {
     return std::make_shared<SiftDataset>(filepath);
 
   } else if (filepath.find("glove") != std::string::npos) {
@@ -875,5 +885,268 @@ Dataset::TestEntryPtr BeirBioasqDataset::ParseTestData(const rapidjson::Value& o
   return entry;
 }
 
+static bool PreadFull(int fd, void* buf, size_t size, off_t offset) {
+  char* dst = static_cast<char*>(buf);
+  while (size > 0) {
+    ssize_t n = pread(fd, dst, size, offset);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+
+    dst += n;
+    size -= n;
+    offset += n;
+  }
+
+  return true;
+}
+
+// read the whole bin file, only for test data and groundtruth which are small.
+template <typename T>
+static bool ReadBinFile(const std::string& filepath, uint32_t& row_count, uint32_t& dimension, std::vector<T>& data,
+                        size_t data_count_per_row = 1) {
+  int fd = open(filepath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(ERROR) << fmt::format("open file {} failed, errno: {}", filepath, errno);
+    return false;
+  }
+
+  uint32_t header[2] = {0};
+  bool ret = PreadFull(fd, header, sizeof(header), 0);
+  if (ret) {
+    row_count = header[0];
+    dimension = header[1];
+    data.resize(static_cast<size_t>(row_count) * dimension * data_count_per_row);
+    ret = PreadFull(fd, data.data(), data.size() * sizeof(T), sizeof(header));
+  }
+  close(fd);
+
+  LOG_IF(ERROR, !ret) << fmt::format("read file {} failed", filepath);
+  return ret;
+}
+
+static std::string FindBinFile(const std::string& dirpath, const std::string& prefix, const std::string& suffix) {
+  auto filenames = dingodb::Helper::TraverseDirectory(dirpath, prefix, true);
+  std::sort(filenames.begin(), filenames.end());
+  for (const auto& filename : filenames) {
+    if (filename.size() > suffix.size() &&
+        filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0) {
+      return fmt::format("{}/{}", dirpath, filename);
+    }
+  }
+
+  return "";
+}
+
+BinDataset::~BinDataset() {
+  stopped_.store(true);
+  if (train_thread_.joinable()) {
+    train_thread_.join();
+  }
+  if (train_fd_ >= 0) {
+    close(train_fd_);
+  }
+}
+
+bool BinDataset::IsBinDataset(const std::string& dirpath) {
+  return std::filesystem::is_directory(dirpath) && !FindBinFile(dirpath, "base", ".fbin").empty();
+}
+
+bool BinDataset::Init() {
+  std::lock_guard lock(mutex_);
+
+  train_filepath_ = FindBinFile(dirpath_, "base", ".fbin");
+  test_filepath_ = FindBinFile(dirpath_, "query", ".fbin");
+  groundtruth_filepath_ = FindBinFile(dirpath_, "groundtruth", ".ibin");
+  if (train_filepath_.empty() || test_filepath_.empty() || groundtruth_filepath_.empty()) {
+    std::cerr << fmt::format("dataset {} miss base*.fbin/query*.fbin/groundtruth*.ibin", dirpath_) << std::endl;
+    return false;
+  }
+
+  train_fd_ = open(train_filepath_.c_str(), O_RDONLY);
+  if (train_fd_ < 0) {
+    std::cerr << fmt::format("open file {} failed, errno: {}", train_filepath_, errno) << std::endl;
+    return false;
+  }
+
+  uint32_t header[2] = {0};
+  if (!PreadFull(train_fd_, header, sizeof(header), 0)) {
+    std::cerr << fmt::format("read file {} header failed", train_filepath_) << std::endl;
+    return false;
+  }
+  train_row_count_ = header[0];
+  dimension_ = header[1];
+  if (FLAGS_vector_dataset_train_limit > 0) {
+    train_row_count_ = std::min(train_row_count_, FLAGS_vector_dataset_train_limit);
+  }
+
+  std::cout << fmt::format("dataset train file({}) rows({}/{}) dimension({}), test file({}) groundtruth file({})",
+                           train_filepath_, train_row_count_, header[0], dimension_, test_filepath_,
+                           groundtruth_filepath_)
+            << std::endl;
+
+  if (FLAGS_vector_search_arrange_data) {
+    batch_vector_entry_cache_.resize(FLAGS_batch_vector_entry_cache_size);
+    train_thread_ = std::thread([this] { ParallelLoadTrainData(); });
+  }
+
+  return true;
+}
+
+uint32_t BinDataset::GetDimension() const { return dimension_; }
+uint32_t BinDataset::GetTrainDataCount() const { return train_row_count_; }
+uint32_t BinDataset::GetTestDataCount() const { return test_row_count_; }
+
+bool BinDataset::ReadTrainData(uint32_t row_offset, uint32_t row_count,
+                               std::vector<sdk::VectorWithId>& vector_with_ids) const {
+  std::vector<float> buf(static_cast<size_t>(row_count) * dimension_);
+  off_t offset = sizeof(uint32_t) * 2 + static_cast<off_t>(row_offset) * dimension_ * sizeof(float);
+  if (!PreadFull(train_fd_, buf.data(), buf.size() * sizeof(float), offset)) {
+    LOG(ERROR) << fmt::format("read file {} failed, row_offset: {} row_count: {}", train_filepath_, row_offset,
+                              row_count);
+    return false;
+  }
+
+  vector_with_ids.reserve(row_count);
+  for (uint32_t i = 0; i < row_count; ++i) {
+    sdk::VectorWithId vector_with_id;
+    vector_with_id.id = static_cast<int64_t>(row_offset) + i + 1;
+    vector_with_id.vector.dimension = dimension_;
+    vector_with_id.vector.value_type = sdk::ValueType::kFloat;
+    vector_with_id.vector.float_values.assign(buf.begin() + static_cast<size_t>(i) * dimension_,
+                                              buf.begin() + static_cast<size_t>(i + 1) * dimension_);
+
+    vector_with_ids.push_back(std::move(vector_with_id));
+  }
+
+  return true;
+}
+
+void BinDataset::ParallelLoadTrainData() {
+  uint64_t start_time = dingodb::Helper::TimestampMs();
+
+  uint32_t batch_size = std::max(FLAGS_vector_put_batch_size, static_cast<uint32_t>(1));
+  uint32_t batch_count = (train_row_count_ + batch_size - 1) / batch_size;
+  std::atomic<uint32_t> curr_batch_num = 0;
+  std::vector<std::thread> threads;
+  for (size_t thread_id = 0; thread_id < FLAGS_load_vector_dataset_concurrency; ++thread_id) {
+    threads.push_back(std::thread([&] {
+      while (!stopped_.load()) {
+        uint32_t batch_num = curr_batch_num.fetch_add(1);
+        if (batch_num >= batch_count) {
+          return;
+        }
+
+        uint32_t row_offset = batch_num * batch_size;
+        auto batch_vector_entry = std::make_shared<BatchVectorEntry>();
+        if (!ReadTrainData(row_offset, std::min(batch_size, train_row_count_ - row_offset),
+                           batch_vector_entry->vector_with_ids)) {
+          continue;
+        }
+
+        while (!stopped_.load()) {
+          {
+            std::lock_guard lock(mutex_);
+            // check is full
+            if ((tail_pos_ + 1) % FLAGS_batch_vector_entry_cache_size != head_pos_) {
+              batch_vector_entry_cache_[tail_pos_] = batch_vector_entry;
+              tail_pos_ = (tail_pos_ + 1) % FLAGS_batch_vector_entry_cache_size;
+              break;
+            }
+          }
+
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  train_load_finish_.store(true);
+
+  LOG(INFO) << fmt::format("Parallel load train data elapsed time: {} ms", dingodb::Helper::TimestampMs() - start_time);
+}
+
+void BinDataset::GetBatchTrainData(uint32_t, std::vector<sdk::VectorWithId>& vector_with_ids, bool& is_eof) {
+  is_eof = false;
+  for (;;) {
+    {
+      std::lock_guard lock(mutex_);
+
+      if (head_pos_ != tail_pos_) {
+        auto batch_vector_entry = batch_vector_entry_cache_[head_pos_];
+        batch_vector_entry_cache_[head_pos_] = nullptr;
+        head_pos_ = (head_pos_ + 1) % FLAGS_batch_vector_entry_cache_size;
+
+        for (auto& vector_with_id : batch_vector_entry->vector_with_ids) {
+          vector_with_ids.push_back(std::move(vector_with_id));
+        }
+        return;
+      }
+
+      // check finish after the cache is empty, the loader may push the last batch before finish
+      is_eof = train_load_finish_.load() || batch_vector_entry_cache_.empty();
+      if (is_eof) {
+        return;
+      }
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
+std::vector<Dataset::TestEntryPtr> BinDataset::GetTestData() {
+  std::vector<Dataset::TestEntryPtr> test_entries;
+
+  uint32_t row_count = 0;
+  uint32_t dimension = 0;
+  std::vector<float> test_data;
+  if (!ReadBinFile(test_filepath_, row_count, dimension, test_data)) {
+    return test_entries;
+  }
+  CHECK(dimension == dimension_) << fmt::format("test dimension({}) not match train dimension({})", dimension,
+                                                dimension_);
+
+  // ids and distances of a row are stored in two parts of file
+  uint32_t gt_row_count = 0;
+  uint32_t k = 0;
+  std::vector<int32_t> groundtruth;
+  if (!ReadBinFile(groundtruth_filepath_, gt_row_count, k, groundtruth, 2)) {
+    return test_entries;
+  }
+  CHECK(gt_row_count == row_count) << fmt::format("groundtruth rows({}) not match test rows({})", gt_row_count,
+                                                  row_count);
+  const int32_t* gt_ids = groundtruth.data();
+  const auto* gt_distances = reinterpret_cast<const float*>(groundtruth.data() + static_cast<size_t>(row_count) * k);
+
+  uint32_t topk = std::min(k, FLAGS_vector_search_topk);
+  test_entries.reserve(row_count);
+  for (uint32_t i = 0; i < row_count; ++i) {
+    auto test_entry = std::make_shared<Dataset::TestEntry>();
+    test_entry->vector_with_id.id = 0;
+    test_entry->vector_with_id.vector.dimension = dimension;
+    test_entry->vector_with_id.vector.value_type = sdk::ValueType::kFloat;
+    test_entry->vector_with_id.vector.float_values.assign(
+        test_data.begin() + static_cast<size_t>(i) * dimension,
+        test_data.begin() + static_cast<size_t>(i + 1) * dimension);
+
+    for (uint32_t j = 0; j < topk; ++j) {
+      size_t pos = static_cast<size_t>(i) * k + j;
+      test_entry->neighbors.insert(std::make_pair(static_cast<int64_t>(gt_ids[pos]) + 1, gt_distances[pos]));
+    }
+
+    test_entries.push_back(test_entry);
+  }
+  test_row_count_ = row_count;
+
+  return test_entries;
+}
+
 }  // namespace benchmark
 }  // namespace dingodb
\ No newline at end of file
@@ -23,6 +23,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -203,6 +204,56 @@ class BeirBioasqDataset : public JsonDataset {
   Dataset::TestEntryPtr ParseTestData(const rapidjson::Value& obj) const override;
 };
 
+// big-ann-benchmarks format, e.g. deep1B/text2image/laion, the directory contains
+// base*.fbin(train), query*.fbin(test) and groundtruth*.ibin.
+// fbin: uint32 row_count, uint32 dimension, row_count * dimension float.
+// ibin(groundtruth): uint32 row_count, uint32 k, row_count * k int32 ids, row_count * k float distances.
+// The train data is read by chunk with pread of load_vector_dataset_concurrency threads into a bounded cache,
+// so the memory is not related to the size of train data.
+class BinDataset : public Dataset {
+ public:
+  BinDataset(const std::string& dirpath) : dirpath_(dirpath) {}
+  ~BinDataset() override;
+
+  static bool IsBinDataset(const std::string& dirpath);
+
+  bool Init() override;
+
+  uint32_t GetDimension() const override;
+  uint32_t GetTrainDataCount() const override;
+  uint32_t GetTestDataCount() const override;
+
+  // Get train data by batch
+  void GetBatchTrainData(uint32_t batch_num, std::vector<sdk::VectorWithId>& vector_with_ids, bool& is_eof) override;
+
+  // Get all test data
+  std::vector<TestEntryPtr> GetTestData() override;
+
+ private:
+  void ParallelLoadTrainData();
+  bool ReadTrainData(uint32_t row_offset, uint32_t row_count, std::vector<sdk::VectorWithId>& vector_with_ids) const;
+
+  std::string dirpath_;
+
+  // train dataset
+  std::string train_filepath_;
+  int train_fd_{-1};
+  uint32_t train_row_count_{0};
+  uint32_t dimension_{0};
+  std::thread train_thread_;
+  std::atomic<bool> train_load_finish_{false};
+  std::atomic<bool> stopped_{false};
+  std::vector<BatchVectorEntryPtr> batch_vector_entry_cache_;
+  int head_pos_{0};
+  int tail_pos_{0};
+  std::mutex mutex_;
+
+  // test dataset
+  std::string test_filepath_;
+  std::string groundtruth_filepath_;
+  uint32_t test_row_count_{0};
+};
+
 }  // namespace benchmark
 }  // namespace dingodb
 
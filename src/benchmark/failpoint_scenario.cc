@@ -0,0 +1,282 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark/failpoint_scenario.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "benchmark/color.h"
+#include "brpc/channel.h"
+#include "brpc/controller.h"
+#include "butil/endpoint.h"
+#include "common/helper.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "proto/node.pb.h"
+
+DECLARE_uint32(timelimit);
+
+DEFINE_string(failpoint_scenario, "",
+              "Inject failpoint while benchmark, slow_disk/stall_apply/drop_heartbeat/kill_leader/custom, "
+              "the node must be built with ENABLE_FAILPOINT");
+DEFINE_string(failpoint_addrs, "",
+              "Node addrs of injected failpoint, e.g. 127.0.0.1:20001,127.0.0.1:20002, kill_leader use the first one");
+DEFINE_string(failpoint_name, "", "Failpoint name of custom scenario");
+DEFINE_string(failpoint_config, "", "Failpoint config, override the config of scenario, e.g. 100%sleep(100)");
+DEFINE_uint32(failpoint_start_s, 30, "Inject failpoint after benchmark run seconds, before it is the baseline");
+DEFINE_uint32(failpoint_duration_s, 30, "Clear failpoint after injected seconds");
+DEFINE_double(failpoint_recovery_ratio, 0.9, "Recovered when the interval qps reach the ratio of baseline qps");
+
+namespace dingodb {
+namespace benchmark {
+
+struct FailPointScenarioDefine {
+  std::string failpoint_name;
+  std::string config;
+  bool is_clear;
+};
+
+static const std::map<std::string, FailPointScenarioDefine> kFailPointScenarios = {
+    {"slow_disk", {"segment_log_sync", "100%sleep(50)", true}},
+    {"stall_apply", {"before_raft_apply", "100%sleep(200)", true}},
+    {"drop_heartbeat", {"before_store_heartbeat", "100%sleep(10000)", true}},
+    {"kill_leader", {"before_raft_commit", "1*panic", false}},
+};
+
+FailPointScenario::FailPointScenario(const std::string& scenario, const std::string& failpoint_name,
+                                     const std::string& config, bool is_clear)
+    : scenario_(scenario), failpoint_name_(failpoint_name), config_(config), is_clear_(is_clear) {}
+
+std::shared_ptr<FailPointScenario> FailPointScenario::New() {
+  if (FLAGS_failpoint_scenario.empty()) {
+    return nullptr;
+  }
+
+  if (FLAGS_failpoint_scenario == "custom") {
+    return std::make_shared<FailPointScenario>(FLAGS_failpoint_scenario, FLAGS_failpoint_name, FLAGS_failpoint_config,
+                                               true);
+  }
+
+  auto it = kFailPointScenarios.find(FLAGS_failpoint_scenario);
+  if (it == kFailPointScenarios.end()) {
+    std::cerr << fmt::format("Not support failpoint scenario: {}", FLAGS_failpoint_scenario) << '\n';
+    return nullptr;
+  }
+
+  const auto& define = it->second;
+  return std::make_shared<FailPointScenario>(FLAGS_failpoint_scenario, define.failpoint_name,
+                                             FLAGS_failpoint_config.empty() ? define.config : FLAGS_failpoint_config,
+                                             define.is_clear);
+}
+
+bool FailPointScenario::Init() {
+  if (failpoint_name_.empty() || config_.empty()) {
+    std::cerr << "Failpoint name or config is empty" << '\n';
+    return false;
+  }
+
+  Helper::SplitString(FLAGS_failpoint_addrs, ',', addrs_);
+  if (addrs_.empty()) {
+    std::cerr << "Failpoint addrs is empty" << '\n';
+    return false;
+  }
+  if (!is_clear_) {
+    addrs_.resize(1);
+  }
+
+  if (FLAGS_timelimit > 0 && FLAGS_timelimit <= FLAGS_failpoint_start_s + FLAGS_failpoint_duration_s) {
+    std::cerr << fmt::format("Timelimit({}) should be greater than failpoint_start_s({}) + failpoint_duration_s({})",
+                             FLAGS_timelimit, FLAGS_failpoint_start_s, FLAGS_failpoint_duration_s)
+              << '\n';
+    return false;
+  }
+
+  return true;
+}
+
+void FailPointScenario::Start() {
+  std::lock_guard lock(mutex_);
+  start_time_ms_ = Helper::TimestampMs();
+}
+
+void FailPointScenario::Tick() {
+  std::lock_guard lock(mutex_);
+
+  size_t elapsed_ms = Helper::TimestampMs() - start_time_ms_;
+  if (phase_ == Phase::kBaseline && elapsed_ms >= FLAGS_failpoint_start_s * 1000) {
+    for (const auto& addr : addrs_) {
+      SetFailPoint(addr);
+    }
+    std::cout << COLOR_GREEN << fmt::format("Inject failpoint {} {}", failpoint_name_, config_) << COLOR_RESET << '\n';
+    phase_ = Phase::kInjected;
+    inject_elapsed_ms_ = elapsed_ms;
+
+  } else if (phase_ == Phase::kInjected &&
+             elapsed_ms >= inject_elapsed_ms_ + static_cast<size_t>(FLAGS_failpoint_duration_s) * 1000) {
+    if (is_clear_) {
+      for (const auto& addr : addrs_) {
+        DeleteFailPoint(addr);
+      }
+      std::cout << COLOR_GREEN << fmt::format("Clear failpoint {}", failpoint_name_) << COLOR_RESET << '\n';
+    }
+    phase_ = Phase::kCleared;
+    clear_elapsed_ms_ = elapsed_ms;
+  }
+}
+
+void FailPointScenario::Stop() {
+  std::lock_guard lock(mutex_);
+
+  if (phase_ == Phase::kInjected) {
+    if (is_clear_) {
+      for (const auto& addr : addrs_) {
+        DeleteFailPoint(addr);
+      }
+    }
+    phase_ = Phase::kCleared;
+    clear_elapsed_ms_ = Helper::TimestampMs() - start_time_ms_;
+  }
+}
+
+void FailPointScenario::AddSample(double qps, int64_t p99_latency_us) {
+  std::lock_guard lock(mutex_);
+  samples_.push_back(Sample{Helper::TimestampMs() - start_time_ms_, qps, p99_latency_us, phase_});
+}
+
+void FailPointScenario::Report() {
+  std::lock_guard lock(mutex_);
+
+  // the first interval is warm up
+  double baseline_qps = 0;
+  int64_t baseline_p99_latency_us = 0;
+  int baseline_count = 0;
+  double event_min_qps = -1;
+  double event_sum_qps = 0;
+  int64_t event_max_p99_latency_us = 0;
+  int event_count = 0;
+  for (size_t i = 0; i < samples_.size(); ++i) {
+    const auto& sample = samples_[i];
+    if (sample.phase == Phase::kBaseline && i > 0) {
+      baseline_qps += sample.qps;
+      baseline_p99_latency_us = std::max(baseline_p99_latency_us, sample.p99_latency_us);
+      ++baseline_count;
+    } else if (sample.phase == Phase::kInjected) {
+      event_min_qps = event_min_qps < 0 ? sample.qps : std::min(event_min_qps, sample.qps);
+      event_sum_qps += sample.qps;
+      event_max_p99_latency_us = std::max(event_max_p99_latency_us, sample.p99_latency_us);
+      ++event_count;
+    }
+  }
+
+  std::cout << COLOR_GREEN << fmt::format("Failpoint scenario({}) {} {}:", scenario_, failpoint_name_, config_)
+            << COLOR_RESET << '\n';
+  if (baseline_count == 0 || event_count == 0) {
+    std::cout << "Not enough interval reports before or during failpoint, increase timelimit or failpoint_start_s"
+              << '\n';
+    return;
+  }
+  baseline_qps /= baseline_count;
+
+  // recovery time is from the failpoint cleared, or injected if not cleared, to the first interval
+  // reach recovery ratio of baseline qps after the dip.
+  double recovery_qps = baseline_qps * FLAGS_failpoint_recovery_ratio;
+  size_t recovery_from_ms = is_clear_ ? clear_elapsed_ms_ : inject_elapsed_ms_;
+  bool is_dip = false;
+  int64_t recovery_ms = -1;
+  for (const auto& sample : samples_) {
+    if (sample.phase == Phase::kBaseline) {
+      continue;
+    }
+
+    if (!is_dip) {
+      is_dip = sample.qps < recovery_qps;
+      continue;
+    }
+    if (sample.elapsed_ms > recovery_from_ms && sample.qps >= recovery_qps) {
+      recovery_ms = sample.elapsed_ms - recovery_from_ms;
+      break;
+    }
+  }
+
+  std::cout << fmt::format("{:<34}: {:>16.0f}", "baseline qps", baseline_qps) << '\n';
+  std::cout << fmt::format("{:<34}: {:>16}", "baseline p99(us)", baseline_p99_latency_us) << '\n';
+  std::cout << fmt::format("{:<34}: {:>16.0f}", "event avg qps", event_sum_qps / event_count) << '\n';
+  std::cout << fmt::format("{:<34}: {:>16.0f}", "event min qps", event_min_qps) << '\n';
+  std::cout << fmt::format("{:<34}: {:>15.2f}%", "throughput dip", (1 - event_min_qps / baseline_qps) * 100) << '\n';
+  std::cout << fmt::format("{:<34}: {:>16}", "event p99(us)", event_max_p99_latency_us) << '\n';
+  if (!is_dip) {
+    std::cout << fmt::format("{:<34}: {:>16}", "recovery time(ms)", "no dip") << '\n';
+  } else if (recovery_ms < 0) {
+    std::cout << fmt::format("{:<34}: {:>16}", "recovery time(ms)", "not recovered") << '\n';
+  } else {
+    std::cout << fmt::format("{:<34}: {:>16}", "recovery time(ms)", recovery_ms) << '\n';
+  }
+}
+
+bool FailPointScenario::SetFailPoint(const std::string& addr) {
+  brpc::Channel channel;
+  if (channel.Init(addr.c_str(), nullptr) != 0) {
+    std::cerr << fmt::format("Init channel of {} failed", addr) << '\n';
+    return false;
+  }
+
+  pb::node::SetFailPointRequest request;
+  pb::node::SetFailPointResponse response;
+  request.mutable_failpoint()->set_name(failpoint_name_);
+  request.mutable_failpoint()->set_config(config_);
+  brpc::Controller cntl;
+  pb::node::NodeService_Stub(&channel).SetFailPoint(&cntl, &request, &response, nullptr);
+  if (cntl.Failed() || response.error().errcode() != pb::error::OK) {
+    std::cerr << fmt::format("Set failpoint {} to {} failed, error: {} {}", failpoint_name_, addr, cntl.ErrorText(),
+                             response.error().errmsg())
+              << '\n';
+    return false;
+  }
+
+  return true;
+}
+
+bool FailPointScenario::DeleteFailPoint(const std::string& addr) {
+  brpc::Channel channel;
+  if (channel.Init(addr.c_str(), nullptr) != 0) {
+    std::cerr << fmt::format("Init channel of {} failed", addr) << '\n';
+    return false;
+  }
+
+  pb::node::DeleteFailPointRequest request;
+  pb::node::DeleteFailPointResponse response;
+  request.add_names(failpoint_name_);
+  brpc::Controller cntl;
+  pb::node::NodeService_Stub(&channel).DeleteFailPoints(&cntl, &request, &response, nullptr);
+  if (cntl.Failed() || response.error().errcode() != pb::error::OK) {
+    std::cerr << fmt::format("Delete failpoint {} of {} failed, error: {} {}", failpoint_name_, addr,
+                             cntl.ErrorText(), response.error().errmsg())
+              << '\n';
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace benchmark
+}  // namespace dingodb
@@ -0,0 +1,97 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_BENCHMARK_FAILPOINT_SCENARIO_H_
+#define DINGODB_BENCHMARK_FAILPOINT_SCENARIO_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dingodb {
+namespace benchmark {
+
+// Inject a failpoint into the nodes by NodeService.SetFailPoint while the benchmark is running,
+// and report the throughput dip, p99 latency during the event and recovery time, compare with the
+// baseline before the injection. Enabled by --failpoint_scenario:
+// 1. slow_disk: sleep in Segment::Sync of raft log.
+// 2. stall_apply: sleep before apply of store state machine.
+// 3. drop_heartbeat: block store heartbeat.
+// 4. kill_leader: panic the first node of failpoint_addrs at next raft commit, it is not cleared.
+// 5. custom: failpoint_name and failpoint_config.
+// The nodes must be built with ENABLE_FAILPOINT.
+class FailPointScenario {
+ public:
+  FailPointScenario(const std::string& scenario, const std::string& failpoint_name, const std::string& config,
+                    bool is_clear);
+  ~FailPointScenario() = default;
+
+  // Return nullptr if failpoint_scenario is empty.
+  static std::shared_ptr<FailPointScenario> New();
+
+  bool Init();
+
+  // Call when the benchmark launched, the injection time is relative to it.
+  void Start();
+  // Inject or clear failpoint by elapsed time, called by interval report.
+  void Tick();
+  // Clear failpoint if it is still injected.
+  void Stop();
+
+  // Add the result of an interval report.
+  void AddSample(double qps, int64_t p99_latency_us);
+
+  void Report();
+
+ private:
+  enum class Phase {
+    kBaseline = 0,
+    kInjected = 1,
+    kCleared = 2,
+  };
+
+  struct Sample {
+    size_t elapsed_ms;
+    double qps;
+    int64_t p99_latency_us;
+    Phase phase;
+  };
+
+  bool SetFailPoint(const std::string& addr);
+  bool DeleteFailPoint(const std::string& addr);
+
+  const std::string scenario_;
+  const std::string failpoint_name_;
+  const std::string config_;
+  // kill_leader is not cleared, the recovery time is relative to the injection.
+  const bool is_clear_;
+
+  std::vector<std::string> addrs_;
+
+  std::mutex mutex_;
+  Phase phase_{Phase::kBaseline};
+  size_t start_time_ms_{0};
+  size_t inject_elapsed_ms_{0};
+  size_t clear_elapsed_ms_{0};
+  std::vector<Sample> samples_;
+};
+using FailPointScenarioPtr = std::shared_ptr<FailPointScenario>;
+
+}  // namespace benchmark
+}  // namespace dingodb
+
+#endif  // DINGODB_BENCHMARK_FAILPOINT_SCENARIO_H_
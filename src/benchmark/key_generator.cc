@@ -0,0 +1,119 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark/key_generator.h"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+
+#include "common/helper.h"
+
+namespace dingodb {
+namespace benchmark {
+
+// ycsb zipfian constant
+static const double kZipfianTheta = 0.99;
+
+// fnv-1a hash, scatter the hot zipfian keys over the key space.
+static uint64_t FnvHash64(uint64_t value) {
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for (int i = 0; i < 8; ++i) {
+    hash ^= (value & 0xff);
+    hash *= 0x100000001B3ULL;
+    value >>= 8;
+  }
+  return hash;
+}
+
+std::shared_ptr<KeyGenerator> KeyGenerator::New(const std::string& distribution) {
+  auto upper_distribution = Helper::ToUpper(distribution);
+  if (upper_distribution == "ZIPFIAN") {
+    return std::make_shared<KeyGenerator>(Distribution::kZipfian);
+  } else if (upper_distribution == "LATEST") {
+    return std::make_shared<KeyGenerator>(Distribution::kLatest);
+  }
+
+  return std::make_shared<KeyGenerator>(Distribution::kUniform);
+}
+
+bool KeyGenerator::IsSupportDistribution(const std::string& distribution) {
+  auto upper_distribution = Helper::ToUpper(distribution);
+  return upper_distribution == "UNIFORM" || upper_distribution == "ZIPFIAN" || upper_distribution == "LATEST";
+}
+
+int64_t KeyGenerator::Next(int64_t item_count) {
+  if (item_count <= 1) {
+    return 0;
+  }
+
+  switch (distribution_) {
+    case Distribution::kZipfian:
+      return static_cast<int64_t>(FnvHash64(NextZipfian(item_count)) % item_count);
+    case Distribution::kLatest:
+      return item_count - 1 - NextZipfian(item_count);
+    default:
+      return static_cast<int64_t>(RandDouble() * item_count) % item_count;
+  }
+}
+
+// Algorithm from "Quickly Generating Billion-Record Synthetic Databases", Jim Gray et al.
+int64_t KeyGenerator::NextZipfian(int64_t item_count) {
+  double zetan = 0;
+  double eta = 0;
+  {
+    std::lock_guard lock(mutex_);
+    if (item_count != zeta_item_count_) {
+      zetan_ = (item_count > zeta_item_count_) ? zetan_ + Zeta(zeta_item_count_, item_count, kZipfianTheta)
+                                               : Zeta(0, item_count, kZipfianTheta);
+      double zeta2 = Zeta(0, 2, kZipfianTheta);
+      eta_ = (1 - std::pow(2.0 / item_count, 1 - kZipfianTheta)) / (1 - zeta2 / zetan_);
+      zeta_item_count_ = item_count;
+    }
+    zetan = zetan_;
+    eta = eta_;
+  }
+
+  double u = RandDouble();
+  double uz = u * zetan;
+  if (uz < 1.0) {
+    return 0;
+  }
+  if (uz < 1.0 + std::pow(0.5, kZipfianTheta)) {
+    return 1;
+  }
+
+  auto rank = static_cast<int64_t>(item_count * std::pow(eta * u - eta + 1, 1.0 / (1.0 - kZipfianTheta)));
+  return rank < item_count ? rank : item_count - 1;
+}
+
+// sum of 1/i^theta for i in (start, end]
+double KeyGenerator::Zeta(int64_t start, int64_t end, double theta) {
+  double sum = 0;
+  for (int64_t i = start; i < end; ++i) {
+    sum += 1 / std::pow(i + 1, theta);
+  }
+  return sum;
+}
+
+double KeyGenerator::RandDouble() {
+  thread_local std::mt19937_64 rng(std::random_device{}());
+  return std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+}
+
+}  // namespace benchmark
+}  // namespace dingodb
@@ -0,0 +1,67 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_BENCHMARK_KEY_GENERATOR_H_
+#define DINGODB_BENCHMARK_KEY_GENERATOR_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace dingodb {
+namespace benchmark {
+
+// Generate key index of workload, like ycsb request distribution.
+// uniform: every key has the same probability.
+// zipfian: a few keys are hot, the hot keys are scattered over key space.
+// latest: recently inserted keys are hot.
+class KeyGenerator {
+ public:
+  enum class Distribution {
+    kUniform,
+    kZipfian,
+    kLatest,
+  };
+
+  explicit KeyGenerator(Distribution distribution) : distribution_(distribution) {}
+  ~KeyGenerator() = default;
+
+  static std::shared_ptr<KeyGenerator> New(const std::string& distribution);
+  static bool IsSupportDistribution(const std::string& distribution);
+
+  // Return key index in [0, item_count), item_count can grow as keys are inserted.
+  int64_t Next(int64_t item_count);
+
+ private:
+  // Zipfian rank in [0, item_count), rank 0 is the hottest.
+  int64_t NextZipfian(int64_t item_count);
+
+  static double Zeta(int64_t start, int64_t end, double theta);
+  static double RandDouble();
+
+  const Distribution distribution_;
+
+  std::mutex mutex_;
+  // zeta of zipfian is computed incrementally when item count grow.
+  int64_t zeta_item_count_{0};
+  double zetan_{0};
+  double eta_{0};
+};
+using KeyGeneratorPtr = std::shared_ptr<KeyGenerator>;
+
+}  // namespace benchmark
+}  // namespace dingodb
+
+#endif  // DINGODB_BENCHMARK_KEY_GENERATOR_H_
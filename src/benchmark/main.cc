@@ -33,6 +33,12 @@ static std::string GetUsageMessage() {
   message += "\nUsage:";
   message += "\n  --coordinator_url dingo-store cluster endpoint, default(file://./coor_list)";
   message += "\n  --benchmark benchmark type, default(fillseq)";
+  message += "\n  --raft_bench_entry_sizes raft benchmark log entry sizes, default(256,4096,65536)";
+  message += "\n  --raft_bench_region_nums raft benchmark region numbers, default(1,8)";
+  message += "\n  --raft_bench_append_duration_s raft benchmark append duration, unit(second), default(10)";
+  message += "\n  --raft_bench_snapshot_region_sizes_mb raft snapshot region sizes, unit(MB), default(64,256)";
+  message += "\n  --raft_bench_transfer_leader_times raft benchmark transfer leader times, default(3)";
+  message += "\n  --raft_bench_timeout_s raft benchmark wait timeout, unit(second), default(300)";
   message += "\n  --show_version show dingo-store cluster version info, default(false)";
   message += "\n  --prefix region range prefix, used to distinguish region, default(BENCH)";
   message += "\n  --raw_engine raw engine type, support LSM/BTREE/XDP default(LSM)";
@@ -51,9 +57,9 @@ static std::string GetUsageMessage() {
   message += "\n  --is_pessimistic_txn optimistic or pessimistic transaction, default(false)";
   message += "\n  --txn_isolation_level transaction isolation level SI/RC, default(SI)";
   message += "\n  --vector_dimension vector dimension, default(256)";
-  message += "\n  --vector_value_type vector value type float/uint8, default(float)";
+  message += "\n  --vector_value_type vector value type float/uint8/int8, default(float)";
   message += "\n  --vector_max_element_num vector index contain max element number, default(100000)";
-  message += "\n  --vector_metric_type calcute vector distance method L2/IP/COSINE, default(L2)";
+  message += "\n  --vector_metric_type calcute vector distance method L2/IP/COSINE/HAMMING, default(L2)";
   message += "\n  --vector_partition_vector_ids vector id used by partition, default()";
   message += "\n  --vector_arrange_concurrency vector arrange concurrency, default(10)";
   message += "\n  --vector_put_batch_size vector put batch size, default(512)";
@@ -74,6 +80,12 @@ static std::string GetUsageMessage() {
   message += "\n  --vector_search_use_brute_force vector search flag use_brute_force, default(false)";
   message += "\n  --vector_search_enable_range_search vector search flag enable_range_search, default(false)";
   message += "\n  --vector_search_radius vector search flag radius, default(0.1)";
+  message += "\n  --vector_search_ef_search vector search HNSW ef_search, 0 is server default, default(128)";
+  message += "\n  --vector_search_nprobe vector search IVF nprobe, 0 is server default, default(0)";
+  message += "\n  --vector_search_sweep_ef_search sweep ef_search values, e.g. 16,32,64, default()";
+  message += "\n  --vector_search_sweep_nprobe sweep nprobe values, e.g. 8,16,32, default()";
+  message += "\n  --vector_search_sweep_topk sweep topk values, e.g. 1,10,100, default()";
+  message += "\n  --vector_search_sweep_output sweep result file, json if end with .json else csv, default()";
 
   return message;
 }
@@ -138,6 +150,13 @@ int main(int argc, char* argv[]) {
     return 1;
   }
 
+  if (FLAGS_benchmark == dingodb::benchmark::RaftBenchmark::kName) {
+    auto raft_benchmark =
+        dingodb::benchmark::RaftBenchmark::New(environment.GetCoordinatorProxy(), environment.GetClient());
+    environment.AddRaftBenchmark(raft_benchmark);
+    return raft_benchmark->Run() ? 0 : 1;
+  }
+
   auto benchmark = dingodb::benchmark::Benchmark::New(environment.GetCoordinatorProxy(), environment.GetClient());
 
   environment.AddBenchmark(benchmark);
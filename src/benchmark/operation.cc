@@ -16,10 +16,12 @@
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <limits>
 #include <memory>
 #include <random>
 #include <string>
@@ -28,6 +30,7 @@
 
 #include "benchmark/benchmark.h"
 #include "benchmark/dataset.h"
+#include "benchmark/key_generator.h"
 #include "common/helper.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
@@ -47,6 +50,18 @@ DEFINE_uint32(batch_size, 1, "Batch size");
 
 DEFINE_uint32(arrange_kv_num, 10000, "The number of kv for read");
 
+// workload
+DEFINE_double(workload_read_proportion, 0.5, "Workload proportion of read");
+DEFINE_double(workload_update_proportion, 0.5, "Workload proportion of update");
+DEFINE_double(workload_insert_proportion, 0.0, "Workload proportion of insert");
+DEFINE_double(workload_scan_proportion, 0.0, "Workload proportion of scan");
+DEFINE_double(workload_rmw_proportion, 0.0, "Workload proportion of read-modify-write");
+DEFINE_string(workload_request_distribution, "zipfian", "Workload key distribution, e.g. uniform/zipfian/latest");
+DEFINE_validator(workload_request_distribution, [](const char*, const std::string& value) -> bool {
+  return dingodb::benchmark::KeyGenerator::IsSupportDistribution(value);
+});
+DEFINE_uint32(workload_scan_max_length, 100, "Workload max kv number of scan, the length is uniform in [1, max]");
+
 DEFINE_bool(is_pessimistic_txn, false, "Optimistic or pessimistic transaction");
 DEFINE_string(txn_isolation_level, "SI", "Transaction isolation level");
 DEFINE_validator(txn_isolation_level, [](const char*, const std::string& value) -> bool {
@@ -63,6 +78,8 @@ DECLARE_bool(vector_search_with_table_data);
 DECLARE_bool(vector_search_use_brute_force);
 DECLARE_bool(vector_search_enable_range_search);
 DECLARE_double(vector_search_radius);
+DEFINE_int32(vector_search_ef_search, 128, "Vector search HNSW ef_search, 0 means server default");
+DEFINE_int32(vector_search_nprobe, 0, "Vector search IVF nprobe, 0 means server default");
 DEFINE_string(vector_search_filter_type, "", "Vector search filter type, e.g. pre/post");
 DEFINE_validator(vector_search_filter_type, [](const char*, const std::string& value) -> bool {
   auto filter_type = dingodb::Helper::ToUpper(value);
@@ -110,6 +127,8 @@ static OperationBuilderMap support_operations = {
      [](std::shared_ptr<sdk::Client> client) -> OperationPtr {
        return std::make_shared<ReadMissingOperation>(client);
      }},
+    {"workload",
+     [](std::shared_ptr<sdk::Client> client) -> OperationPtr { return std::make_shared<WorkloadOperation>(client); }},
     {"filltxnseq",
      [](std::shared_ptr<sdk::Client> client) -> OperationPtr { return std::make_shared<FillTxnSeqOperation>(client); }},
     {"filltxnrandom",
@@ -167,6 +186,15 @@ static std::string GenRandomString(int len) {
   return result;
 }
 
+static void SetSearchExtraParams(sdk::SearchParam& search_param) {
+  if (FLAGS_vector_search_ef_search > 0) {
+    search_param.extra_params[sdk::SearchExtraParamType::kEfSearch] = FLAGS_vector_search_ef_search;
+  }
+  if (FLAGS_vector_search_nprobe > 0) {
+    search_param.extra_params[sdk::SearchExtraParamType::kNprobe] = FLAGS_vector_search_nprobe;
+  }
+}
+
 static std::string GenSeqString(int num, int len) { return fmt::format("{0:0{1}}", num, len); }
 
 static std::string EncodeRawKey(const std::string& str) { return kClientRaw + str; }
@@ -615,6 +643,111 @@ Operation::Result ReadRandomOperation::Execute(RegionEntryPtr region_entry) {
   }
 }
 
+WorkloadOperation::WorkloadOperation(std::shared_ptr<sdk::Client> client)
+    : ReadOperation(client), key_generator_(KeyGenerator::New(FLAGS_workload_request_distribution)) {}
+
+Operation::Result WorkloadOperation::Execute(RegionEntryPtr region_entry) {
+  switch (NextOpType()) {
+    case OpType::kRead:
+      return KvGet(NextExistKey(region_entry));
+    case OpType::kUpdate:
+      return Update(NextExistKey(region_entry));
+    case OpType::kInsert:
+      return KvPut(region_entry, false);
+    case OpType::kScan:
+      return Scan(region_entry, NextExistKey(region_entry));
+    case OpType::kReadModifyWrite:
+      return ReadModifyWrite(NextExistKey(region_entry));
+  }
+
+  return KvGet(NextExistKey(region_entry));
+}
+
+WorkloadOperation::OpType WorkloadOperation::NextOpType() {
+  double total = FLAGS_workload_read_proportion + FLAGS_workload_update_proportion +
+                 FLAGS_workload_insert_proportion + FLAGS_workload_scan_proportion + FLAGS_workload_rmw_proportion;
+  if (total <= 0) {
+    return OpType::kRead;
+  }
+
+  double value = Helper::GenerateRealRandomInteger(0, UINT32_MAX) / static_cast<double>(UINT32_MAX) * total;
+  if ((value -= FLAGS_workload_read_proportion) < 0) {
+    return OpType::kRead;
+  }
+  if ((value -= FLAGS_workload_update_proportion) < 0) {
+    return OpType::kUpdate;
+  }
+  if ((value -= FLAGS_workload_insert_proportion) < 0) {
+    return OpType::kInsert;
+  }
+  if ((value -= FLAGS_workload_scan_proportion) < 0) {
+    return OpType::kScan;
+  }
+  return OpType::kReadModifyWrite;
+}
+
+// Arranged and inserted keys are all sequence keys, key of index i is prefix + GenSeqString(i).
+std::string WorkloadOperation::NextExistKey(RegionEntryPtr region_entry) {
+  int random_str_len = FLAGS_key_size - region_entry->prefix.size();
+  int64_t item_count = region_entry->counter.load(std::memory_order_relaxed);
+  int64_t index = key_generator_->Next(item_count);
+  return EncodeRawKey(region_entry->prefix + GenSeqString(index, random_str_len));
+}
+
+Operation::Result WorkloadOperation::Update(const std::string& key) {
+  Operation::Result result;
+
+  std::string value = GenRandomString(FLAGS_value_size);
+  result.write_bytes = key.size() + value.size();
+
+  int64_t start_time = Helper::TimestampUs();
+
+  result.status = raw_kv->Put(key, value);
+
+  result.eplased_time = Helper::TimestampUs() - start_time;
+
+  return result;
+}
+
+Operation::Result WorkloadOperation::Scan(RegionEntryPtr region_entry, const std::string& start_key) {
+  Operation::Result result;
+
+  uint64_t limit = Helper::GenerateRealRandomInteger(1, std::max(1U, FLAGS_workload_scan_max_length));
+  std::string end_key = EncodeRawKey(Helper::PrefixNext(region_entry->prefix));
+
+  int64_t start_time = Helper::TimestampUs();
+
+  std::vector<sdk::KVPair> kvs;
+  result.status = raw_kv->Scan(start_key, end_key, limit, kvs);
+  for (auto& kv : kvs) {
+    result.read_bytes += kv.key.size() + kv.value.size();
+  }
+
+  result.eplased_time = Helper::TimestampUs() - start_time;
+
+  return result;
+}
+
+Operation::Result WorkloadOperation::ReadModifyWrite(const std::string& key) {
+  Operation::Result result;
+
+  int64_t start_time = Helper::TimestampUs();
+
+  std::string value;
+  result.status = raw_kv->Get(key, value);
+  if (result.status.ok()) {
+    result.read_bytes = key.size() + value.size();
+
+    value = GenRandomString(FLAGS_value_size);
+    result.status = raw_kv->Put(key, value);
+    result.write_bytes = key.size() + value.size();
+  }
+
+  result.eplased_time = Helper::TimestampUs() - start_time;
+
+  return result;
+}
+
 Operation::Result ReadMissingOperation::Execute(RegionEntryPtr region_entry) {
   std::string& prefix = region_entry->prefix;
 
@@ -855,8 +988,12 @@ sdk::VectorWithId GenVectorWithId(int64_t vector_id) {
     vector_with_id.vector.value_type = sdk::ValueType::kFloat;
     vector_with_id.vector.float_values = Helper::GenerateFloatVector(FLAGS_vector_dimension);
     // vector_with_id.vector.float_values = FakeGenerateFloatVector(FLAGS_vector_dimension);
-  } else {
+  } else if (FLAGS_vector_value_type == "UINT8") {
+    // one bit per dimension
     vector_with_id.vector.value_type = sdk::ValueType::kUint8;
+    vector_with_id.vector.binary_values = Helper::GenerateInt8Vector((FLAGS_vector_dimension + 7) / 8);
+  } else {
+    vector_with_id.vector.value_type = sdk::ValueType::kInt8;
     vector_with_id.vector.binary_values = Helper::GenerateInt8Vector(FLAGS_vector_dimension);
   }
 
@@ -1087,6 +1224,7 @@ Operation::Result VectorSearchOperation::ExecuteAutoData(VectorIndexEntryPtr ent
   } else {
     search_param.topk = FLAGS_vector_search_topk;
   }
+  SetSearchExtraParams(search_param);
 
   std::string filter_type = dingodb::Helper::ToUpper(FLAGS_vector_search_filter_type);
   if (filter_type == "PRE") {
@@ -1119,16 +1257,34 @@ Operation::Result VectorSearchOperation::ExecuteAutoData(VectorIndexEntryPtr ent
   return VectorSearch(entry, vector_with_ids, search_param);
 }
 
+// Recall@k, the ground truth is the k nearest of neighbors, neighbors may be more than k when sweep topk.
 uint32_t CalculateRecallRate(const std::unordered_map<int64_t, float>& neighbors,
-                             const std::vector<sdk::VectorWithDistance>& vector_with_distances) {
+                             const std::vector<sdk::VectorWithDistance>& vector_with_distances, uint32_t topk) {
+  if (neighbors.empty()) {
+    return 0;
+  }
+
+  size_t k = (topk == 0) ? neighbors.size() : std::min(static_cast<size_t>(topk), neighbors.size());
+  float max_distance = std::numeric_limits<float>::max();
+  if (k < neighbors.size()) {
+    std::vector<float> distances;
+    distances.reserve(neighbors.size());
+    for (const auto& [_, distance] : neighbors) {
+      distances.push_back(distance);
+    }
+    std::nth_element(distances.begin(), distances.begin() + k - 1, distances.end());
+    max_distance = distances[k - 1];
+  }
+
   uint32_t hit_count = 0;
   for (const auto& vector_with_distance : vector_with_distances) {
-    if (neighbors.find(vector_with_distance.vector_data.id) != neighbors.end()) {
+    auto it = neighbors.find(vector_with_distance.vector_data.id);
+    if (it != neighbors.end() && it->second <= max_distance) {
       ++hit_count;
     }
   }
 
-  return (hit_count * 10000) / neighbors.size();
+  return (std::min(static_cast<size_t>(hit_count), k) * 10000) / k;
 }
 
 Operation::Result VectorSearchOperation::ExecuteManualData(VectorIndexEntryPtr entry) {
@@ -1141,7 +1297,7 @@ Operation::Result VectorSearchOperation::ExecuteManualData(VectorIndexEntryPtr e
   search_param.with_table_data = FLAGS_vector_search_with_table_data;
   search_param.use_brute_force = FLAGS_vector_search_use_brute_force;
   search_param.topk = FLAGS_vector_search_topk;
-  search_param.extra_params.insert(std::make_pair(sdk::SearchExtraParamType::kEfSearch, 128));
+  SetSearchExtraParams(search_param);
 
   std::string filter_type = dingodb::Helper::ToUpper(FLAGS_vector_search_filter_type);
   if (filter_type == "PRE") {
@@ -1189,7 +1345,8 @@ Operation::Result VectorSearchOperation::ExecuteManualData(VectorIndexEntryPtr e
     if (i < result.vector_search_results.size()) {
       auto& search_result = result.vector_search_results[i];
 
-      result.recalls.push_back(CalculateRecallRate(entry->neighbors, search_result.vector_datas));
+      result.recalls.push_back(
+          CalculateRecallRate(entry->neighbors, search_result.vector_datas, FLAGS_vector_search_topk));
     } else {
       result.recalls.push_back(0);
     }
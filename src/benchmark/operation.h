@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "benchmark/dataset.h"
+#include "benchmark/key_generator.h"
 #include "sdk/client.h"
 #include "sdk/status.h"
 #include "sdk/vector.h"
@@ -158,6 +159,35 @@ class ReadMissingOperation : public ReadOperation {
   Result Execute(RegionEntryPtr region_entry) override;
 };
 
+// Mixed workload operation, like ycsb core workload.
+// Every request is one of read/update/insert/scan/read-modify-write by the workload_*_proportion,
+// the key is chosen by workload_request_distribution over the arranged and inserted keys.
+class WorkloadOperation : public ReadOperation {
+ public:
+  WorkloadOperation(std::shared_ptr<sdk::Client> client);
+  ~WorkloadOperation() override = default;
+
+  Result Execute(RegionEntryPtr region_entry) override;
+
+ private:
+  enum class OpType {
+    kRead,
+    kUpdate,
+    kInsert,
+    kScan,
+    kReadModifyWrite,
+  };
+
+  OpType NextOpType();
+  std::string NextExistKey(RegionEntryPtr region_entry);
+
+  Result Update(const std::string& key);
+  Result Scan(RegionEntryPtr region_entry, const std::string& start_key);
+  Result ReadModifyWrite(const std::string& key);
+
+  KeyGeneratorPtr key_generator_;
+};
+
 // Transaction Sequence write operation
 class FillTxnSeqOperation : public BaseOperation {
  public:
@@ -0,0 +1,545 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark/raft_benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/color.h"
+#include "brpc/channel.h"
+#include "brpc/controller.h"
+#include "bthread/bthread.h"
+#include "butil/endpoint.h"
+#include "bvar/latency_recorder.h"
+#include "common/helper.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "glog/logging.h"
+#include "proto/coordinator.pb.h"
+#include "proto/debug.pb.h"
+#include "proto/error.pb.h"
+#include "proto/node.pb.h"
+
+DECLARE_string(prefix);
+DECLARE_uint32(replica);
+DECLARE_uint32(concurrency);
+DECLARE_uint32(key_size);
+DECLARE_bool(is_clean_region);
+
+DEFINE_string(raft_bench_entry_sizes, "256,4096,65536", "Raft benchmark log entry value sizes, e.g. 256,4096");
+DEFINE_string(raft_bench_region_nums, "1,8", "Raft benchmark region numbers, e.g. 1,8,32");
+DEFINE_int64(raft_bench_append_duration_s, 10, "Raft benchmark append duration of every entry size and region num");
+DEFINE_string(raft_bench_snapshot_region_sizes_mb, "64,256", "Raft benchmark snapshot region sizes, unit(MB)");
+DEFINE_uint32(raft_bench_transfer_leader_times, 3, "Raft benchmark transfer leader times");
+DEFINE_int64(raft_bench_timeout_s, 300, "Raft benchmark timeout of waiting snapshot or leader, unit(second)");
+
+namespace dingodb {
+namespace benchmark {
+
+static const std::string kClientRaw = "w";
+static const std::string kNamePrefix = "RaftBenchmark";
+
+static const int64_t kPollIntervalUs = 100 * 1000;
+static const uint32_t kFillValueSize = 4096;
+static const uint32_t kFillBatchSize = 64;
+
+static std::string EncodeRawKey(const std::string& str) { return kClientRaw + str; }
+
+static std::string GenRandomValue(std::mt19937_64& rng, uint32_t size) {
+  std::string value(size, '\0');
+  for (auto& c : value) {
+    c = static_cast<char>('a' + rng() % 26);
+  }
+  return value;
+}
+
+static std::string GenKey(const std::string& prefix, size_t seq) {
+  int len = std::max(static_cast<int>(FLAGS_key_size) - static_cast<int>(prefix.size()), 16);
+  return EncodeRawKey(prefix + fmt::format("{0:0{1}}", seq, len));
+}
+
+template <typename T>
+static std::vector<T> ParseValues(const std::string& str) {
+  std::vector<int64_t> values;
+  Helper::SplitString(str, ',', values);
+  return std::vector<T>(values.begin(), values.end());
+}
+
+static sdk::EngineType GetEngineType() { return sdk::EngineType::kLSM; }
+
+RaftBenchmark::RaftBenchmark(std::shared_ptr<sdk::CoordinatorProxy> coordinator_proxy,
+                             std::shared_ptr<sdk::Client> client)
+    : coordinator_proxy_(coordinator_proxy), client_(client) {}
+
+RaftBenchmarkPtr RaftBenchmark::New(std::shared_ptr<sdk::CoordinatorProxy> coordinator_proxy,
+                                    std::shared_ptr<sdk::Client> client) {
+  return std::make_shared<RaftBenchmark>(coordinator_proxy, client);
+}
+
+void RaftBenchmark::Stop() { is_stop_.store(true, std::memory_order_relaxed); }
+
+bool RaftBenchmark::Run() {
+  std::vector<AppendResult> append_results;
+  std::vector<SnapshotResult> snapshot_results;
+  std::vector<TransferLeaderResult> transfer_leader_results;
+
+  // append throughput by region num and entry size
+  for (auto region_num : ParseValues<uint32_t>(FLAGS_raft_bench_region_nums)) {
+    if (IsStop()) {
+      break;
+    }
+    auto region_entries = CreateRegions("append", region_num);
+    if (region_entries.size() != region_num) {
+      DropRegions(region_entries);
+      return false;
+    }
+
+    for (auto entry_size : ParseValues<uint32_t>(FLAGS_raft_bench_entry_sizes)) {
+      if (IsStop()) {
+        break;
+      }
+      auto result = RunAppend(region_entries, entry_size);
+      std::cout << fmt::format("append region_num({}) entry_size({}) done, {:.0f} entries/s {:.2f} MB/s",
+                               result.region_num, result.entry_size, result.entries_per_second,
+                               result.mb_per_second)
+                << '\n';
+      append_results.push_back(result);
+    }
+
+    // transfer leader on the region which has been written.
+    for (uint32_t i = 0; i < FLAGS_raft_bench_transfer_leader_times && !IsStop(); ++i) {
+      auto result = RunTransferLeader(region_entries[0]);
+      std::cout << fmt::format("transfer leader region({}) done, elect {}ms catch up {}ms", result.region_id,
+                               result.elect_ms, result.catch_up_ms)
+                << '\n';
+      transfer_leader_results.push_back(result);
+    }
+
+    DropRegions(region_entries);
+  }
+
+  // snapshot generation time by region size
+  for (auto region_size_mb : ParseValues<int64_t>(FLAGS_raft_bench_snapshot_region_sizes_mb)) {
+    if (IsStop()) {
+      break;
+    }
+    auto result = RunSnapshot(region_size_mb);
+    std::cout << fmt::format("snapshot region_size({}MB) done, elapsed {}ms", result.region_size_mb,
+                             result.elapsed_ms)
+              << '\n';
+    snapshot_results.push_back(result);
+  }
+
+  Report(append_results, snapshot_results, transfer_leader_results);
+
+  return true;
+}
+
+std::vector<RaftBenchmark::RegionEntry> RaftBenchmark::CreateRegions(const std::string& tag, uint32_t num) {
+  std::vector<RegionEntry> region_entries;
+  // timestamp in prefix, so the range does not conflict with the dropping regions of last round.
+  int64_t now_ms = Helper::TimestampMs();
+  for (uint32_t i = 0; i < num; ++i) {
+    auto name = fmt::format("{}_{}_{}_{}", kNamePrefix, tag, now_ms, i + 1);
+    std::string prefix = fmt::format("{}RAFT{}{}{:06}", FLAGS_prefix, tag, now_ms, i);
+
+    sdk::RegionCreator* tmp;
+    auto status = client_->NewRegionCreator(&tmp);
+    CHECK(status.ok()) << fmt::format("new region creator failed, {}", status.ToString());
+    std::shared_ptr<sdk::RegionCreator> creator(tmp);
+
+    int64_t region_id = 0;
+    status = creator->SetRegionName(name)
+                 .SetEngineType(GetEngineType())
+                 .SetReplicaNum(FLAGS_replica)
+                 .SetRange(EncodeRawKey(prefix), EncodeRawKey(Helper::PrefixNext(prefix)))
+                 .Create(region_id);
+    if (!status.IsOK() || region_id == 0) {
+      LOG(ERROR) << fmt::format("create region failed, name: {} error: {}", name, status.ToString());
+      break;
+    }
+
+    // wait leader elected, so raft status is available.
+    pb::common::Peer leader;
+    std::vector<pb::common::Peer> followers;
+    int64_t deadline_us = Helper::TimestampUs() + FLAGS_raft_bench_timeout_s * 1000 * 1000;
+    while (!GetLeaderPeer(region_id, leader, followers) && Helper::TimestampUs() < deadline_us) {
+      bthread_usleep(kPollIntervalUs);
+    }
+
+    std::cout << fmt::format("create region name({}) id({}) prefix({}) done", name, region_id, prefix) << '\n';
+    region_entries.push_back(RegionEntry{region_id, prefix});
+  }
+
+  return region_entries;
+}
+
+void RaftBenchmark::DropRegions(const std::vector<RegionEntry>& region_entries) {
+  if (!FLAGS_is_clean_region) {
+    return;
+  }
+  for (const auto& region_entry : region_entries) {
+    auto status = client_->DropRegion(region_entry.region_id);
+    if (!status.IsOK()) {
+      LOG(ERROR) << fmt::format("drop region {} failed, {}", region_entry.region_id, status.ToString());
+    }
+  }
+}
+
+void RaftBenchmark::Write(const std::vector<RegionEntry>& region_entries, uint32_t entry_size, int64_t duration_s,
+                          std::atomic<bool>& is_stop, AppendResult& result) {
+  bvar::LatencyRecorder latency_recorder;
+  std::atomic<size_t> req_num{0};
+  std::atomic<size_t> error_count{0};
+  std::atomic<size_t> seq{0};
+
+  int64_t deadline_us = Helper::TimestampUs() + duration_s * 1000 * 1000;
+  std::vector<std::thread> threads;
+  threads.reserve(FLAGS_concurrency);
+  for (uint32_t thread_no = 0; thread_no < FLAGS_concurrency; ++thread_no) {
+    threads.emplace_back([&, thread_no]() {
+      sdk::RawKV* tmp;
+      auto status = client_->NewRawKV(&tmp);
+      CHECK(status.IsOK()) << fmt::format("new raw kv failed, {}", status.ToString());
+      std::shared_ptr<sdk::RawKV> raw_kv(tmp);
+
+      std::mt19937_64 rng(std::random_device{}() + thread_no);
+      std::string value = GenRandomValue(rng, entry_size);
+      while (!is_stop.load(std::memory_order_relaxed) && !IsStop() && Helper::TimestampUs() < deadline_us) {
+        size_t count = seq.fetch_add(1, std::memory_order_relaxed);
+        const auto& region_entry = region_entries[count % region_entries.size()];
+        std::string key = GenKey(region_entry.prefix, count / region_entries.size());
+
+        int64_t start_time = Helper::TimestampUs();
+        status = raw_kv->Put(key, value);
+        latency_recorder << (Helper::TimestampUs() - start_time);
+        req_num.fetch_add(1, std::memory_order_relaxed);
+        if (!status.IsOK()) {
+          error_count.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  result.entry_size = entry_size;
+  result.req_num = req_num.load();
+  result.error_count = error_count.load();
+  result.p50_latency_us = latency_recorder.latency_percentile(0.5);
+  result.p99_latency_us = latency_recorder.latency_percentile(0.99);
+}
+
+RaftBenchmark::AppendResult RaftBenchmark::RunAppend(const std::vector<RegionEntry>& region_entries,
+                                                     uint32_t entry_size) {
+  AppendResult result;
+  result.region_num = region_entries.size();
+
+  int64_t start_log_index = SumLastLogIndex(region_entries);
+  int64_t start_time_us = Helper::TimestampUs();
+
+  std::atomic<bool> is_stop{false};
+  Write(region_entries, entry_size, FLAGS_raft_bench_append_duration_s, is_stop, result);
+
+  int64_t elapsed_us = std::max(Helper::TimestampUs() - start_time_us, static_cast<int64_t>(1));
+  // log entries of leaders include the entries of raft itself, e.g. configuration, so it is a little more than puts.
+  result.log_entries = SumLastLogIndex(region_entries) - start_log_index;
+  result.entries_per_second = static_cast<double>(result.log_entries) * 1000 * 1000 / elapsed_us;
+  result.mb_per_second = static_cast<double>(result.req_num - result.error_count) * entry_size / elapsed_us;
+
+  return result;
+}
+
+bool RaftBenchmark::Fill(const RegionEntry& region_entry, int64_t total_bytes) {
+  sdk::RawKV* tmp;
+  auto status = client_->NewRawKV(&tmp);
+  CHECK(status.IsOK()) << fmt::format("new raw kv failed, {}", status.ToString());
+  std::shared_ptr<sdk::RawKV> raw_kv(tmp);
+
+  std::mt19937_64 rng(std::random_device{}());
+  size_t seq = 0;
+  for (int64_t bytes = 0; bytes < total_bytes && !IsStop();) {
+    std::vector<sdk::KVPair> kvs;
+    kvs.reserve(kFillBatchSize);
+    for (uint32_t i = 0; i < kFillBatchSize; ++i) {
+      kvs.push_back(sdk::KVPair{GenKey(region_entry.prefix, seq++), GenRandomValue(rng, kFillValueSize)});
+      bytes += kvs.back().key.size() + kvs.back().value.size();
+    }
+
+    status = raw_kv->BatchPut(kvs);
+    if (!status.IsOK()) {
+      LOG(ERROR) << fmt::format("fill region {} failed, {}", region_entry.region_id, status.ToString());
+      return false;
+    }
+  }
+
+  return !IsStop();
+}
+
+RaftBenchmark::SnapshotResult RaftBenchmark::RunSnapshot(int64_t region_size_mb) {
+  SnapshotResult result{region_size_mb, 0, true};
+
+  auto region_entries = CreateRegions("snapshot", 1);
+  if (region_entries.empty()) {
+    return result;
+  }
+  const auto& region_entry = region_entries[0];
+
+  pb::common::Peer leader;
+  std::vector<pb::common::Peer> followers;
+  pb::common::BRaftStatus raft_status;
+  if (!Fill(region_entry, region_size_mb * 1024 * 1024) ||
+      !GetLeaderPeer(region_entry.region_id, leader, followers) ||
+      !GetRaftStatus(leader, region_entry.region_id, raft_status)) {
+    DropRegions(region_entries);
+    return result;
+  }
+  int64_t last_snapshot_index = raft_status.last_snapshot_index();
+
+  brpc::Channel channel;
+  butil::EndPoint endpoint;
+  butil::str2endpoint(leader.server_location().host().c_str(), leader.server_location().port(), &endpoint);
+  if (channel.Init(endpoint, nullptr) != 0) {
+    LOG(ERROR) << fmt::format("init channel to {} failed", Helper::EndPointToStr(endpoint));
+    DropRegions(region_entries);
+    return result;
+  }
+
+  pb::debug::SnapshotRequest request;
+  pb::debug::SnapshotResponse response;
+  request.set_region_id(region_entry.region_id);
+  brpc::Controller cntl;
+  cntl.set_timeout_ms(FLAGS_raft_bench_timeout_s * 1000);
+
+  int64_t start_time_ms = Helper::TimestampMs();
+  pb::debug::DebugService_Stub(&channel).Snapshot(&cntl, &request, &response, nullptr);
+  if (cntl.Failed() || response.error().errcode() != pb::error::OK) {
+    LOG(ERROR) << fmt::format("snapshot region {} failed, {} {}", region_entry.region_id, cntl.ErrorText(),
+                              response.error().errmsg());
+    DropRegions(region_entries);
+    return result;
+  }
+
+  // snapshot is done when the last snapshot index of the leader advances.
+  int64_t deadline_ms = start_time_ms + FLAGS_raft_bench_timeout_s * 1000;
+  while (Helper::TimestampMs() < deadline_ms && !IsStop()) {
+    if (GetRaftStatus(leader, region_entry.region_id, raft_status) &&
+        raft_status.last_snapshot_index() > last_snapshot_index) {
+      result.is_timeout = false;
+      break;
+    }
+    bthread_usleep(kPollIntervalUs);
+  }
+  result.elapsed_ms = Helper::TimestampMs() - start_time_ms;
+
+  DropRegions(region_entries);
+
+  return result;
+}
+
+RaftBenchmark::TransferLeaderResult RaftBenchmark::RunTransferLeader(const RegionEntry& region_entry) {
+  TransferLeaderResult result{region_entry.region_id, 0, 0, true};
+
+  pb::common::Peer leader;
+  std::vector<pb::common::Peer> followers;
+  if (!GetLeaderPeer(region_entry.region_id, leader, followers) || followers.empty()) {
+    LOG(ERROR) << fmt::format("region {} has no follower to transfer leader", region_entry.region_id);
+    return result;
+  }
+  const auto& new_leader = followers[0];
+
+  // keep writing during transfer, so followers have to catch up with the new leader.
+  std::atomic<bool> is_stop_write{false};
+  AppendResult write_result;
+  std::thread write_thread([&]() {
+    Write({region_entry}, 4096, FLAGS_raft_bench_timeout_s, is_stop_write, write_result);
+  });
+
+  brpc::Channel channel;
+  butil::EndPoint endpoint;
+  butil::str2endpoint(leader.server_location().host().c_str(), leader.server_location().port(), &endpoint);
+  if (channel.Init(endpoint, nullptr) == 0) {
+    pb::debug::TransferLeaderRequest request;
+    pb::debug::TransferLeaderResponse response;
+    request.set_region_id(region_entry.region_id);
+    *request.mutable_peer() = new_leader;
+    brpc::Controller cntl;
+
+    int64_t start_time_ms = Helper::TimestampMs();
+    int64_t deadline_ms = start_time_ms + FLAGS_raft_bench_timeout_s * 1000;
+    pb::debug::DebugService_Stub(&channel).TransferLeader(&cntl, &request, &response, nullptr);
+    if (!cntl.Failed() && response.error().errcode() == pb::error::OK) {
+      // elected when the new leader is in leader state.
+      pb::common::BRaftStatus raft_status;
+      bool is_elected = false;
+      while (Helper::TimestampMs() < deadline_ms && !IsStop()) {
+        if (GetRaftStatus(new_leader, region_entry.region_id, raft_status) &&
+            raft_status.raft_state() == pb::common::STATE_LEADER) {
+          is_elected = true;
+          break;
+        }
+        bthread_usleep(kPollIntervalUs);
+      }
+      result.elect_ms = Helper::TimestampMs() - start_time_ms;
+
+      // caught up when every follower has no lag to the last index when elected.
+      int64_t target_index = raft_status.last_index();
+      while (is_elected && Helper::TimestampMs() < deadline_ms && !IsStop()) {
+        if (GetRaftStatus(new_leader, region_entry.region_id, raft_status)) {
+          bool is_caught_up = raft_status.unstable_followers().empty();
+          for (const auto& [_, follower] : raft_status.stable_followers()) {
+            if (follower.installing_snapshot() || follower.next_index() <= target_index) {
+              is_caught_up = false;
+            }
+          }
+          if (is_caught_up) {
+            result.is_timeout = false;
+            break;
+          }
+        }
+        bthread_usleep(kPollIntervalUs);
+      }
+      result.catch_up_ms = Helper::TimestampMs() - start_time_ms - result.elect_ms;
+    } else {
+      LOG(ERROR) << fmt::format("transfer leader region {} failed, {} {}", region_entry.region_id, cntl.ErrorText(),
+                                response.error().errmsg());
+    }
+  }
+
+  is_stop_write.store(true, std::memory_order_relaxed);
+  write_thread.join();
+
+  return result;
+}
+
+bool RaftBenchmark::QueryRegion(int64_t region_id, pb::common::Region& region) {
+  pb::coordinator::QueryRegionRequest request;
+  pb::coordinator::QueryRegionResponse response;
+  request.set_region_id(region_id);
+  auto status = coordinator_proxy_->QueryRegion(request, response);
+  if (!status.IsOK() || response.error().errcode() != pb::error::OK) {
+    LOG(ERROR) << fmt::format("query region {} failed, {}", region_id, status.ToString());
+    return false;
+  }
+
+  region.Swap(response.mutable_region());
+  return true;
+}
+
+bool RaftBenchmark::GetLeaderPeer(int64_t region_id, pb::common::Peer& leader,
+                                  std::vector<pb::common::Peer>& followers) {
+  pb::common::Region region;
+  if (!QueryRegion(region_id, region) || region.leader_store_id() == 0) {
+    return false;
+  }
+
+  bool has_leader = false;
+  followers.clear();
+  for (const auto& peer : region.definition().peers()) {
+    if (peer.store_id() == region.leader_store_id()) {
+      leader = peer;
+      has_leader = true;
+    } else {
+      followers.push_back(peer);
+    }
+  }
+
+  return has_leader;
+}
+
+bool RaftBenchmark::GetRaftStatus(const pb::common::Peer& peer, int64_t region_id,
+                                  pb::common::BRaftStatus& raft_status) {
+  brpc::Channel channel;
+  butil::EndPoint endpoint;
+  butil::str2endpoint(peer.server_location().host().c_str(), peer.server_location().port(), &endpoint);
+  if (channel.Init(endpoint, nullptr) != 0) {
+    return false;
+  }
+
+  pb::node::GetRaftStatusRequest request;
+  pb::node::GetRaftStatusResponse response;
+  request.add_region_ids(region_id);
+  brpc::Controller cntl;
+  pb::node::NodeService_Stub(&channel).GetRaftStatus(&cntl, &request, &response, nullptr);
+  if (cntl.Failed() || response.error().errcode() != pb::error::OK || response.entries().empty()) {
+    return false;
+  }
+
+  raft_status.Swap(response.mutable_entries(0)->mutable_raft_status());
+  return true;
+}
+
+int64_t RaftBenchmark::SumLastLogIndex(const std::vector<RegionEntry>& region_entries) {
+  int64_t sum = 0;
+  for (const auto& region_entry : region_entries) {
+    pb::common::Peer leader;
+    std::vector<pb::common::Peer> followers;
+    pb::common::BRaftStatus raft_status;
+    if (GetLeaderPeer(region_entry.region_id, leader, followers) &&
+        GetRaftStatus(leader, region_entry.region_id, raft_status)) {
+      sum += raft_status.last_index();
+    }
+  }
+
+  return sum;
+}
+
+void RaftBenchmark::Report(const std::vector<AppendResult>& append_results,
+                           const std::vector<SnapshotResult>& snapshot_results,
+                           const std::vector<TransferLeaderResult>& transfer_leader_results) {
+  std::cout << '\n' << COLOR_GREEN << "Append:" << COLOR_RESET << '\n';
+  std::cout << COLOR_GREEN
+            << fmt::format("{:>12}{:>12}{:>10}{:>8}{:>14}{:>14}{:>10}{:>10}{:>10}", "REGION_NUM", "ENTRY_SIZE",
+                           "REQ_NUM", "ERRORS", "LOG_ENTRIES", "ENTRIES/S", "MB/S", "P50(us)", "P99(us)")
+            << COLOR_RESET << '\n';
+  for (const auto& result : append_results) {
+    std::cout << fmt::format("{:>12}{:>12}{:>10}{:>8}{:>14}{:>14.0f}{:>10.2f}{:>10}{:>10}", result.region_num,
+                             result.entry_size, result.req_num, result.error_count, result.log_entries,
+                             result.entries_per_second, result.mb_per_second, result.p50_latency_us,
+                             result.p99_latency_us)
+              << '\n';
+  }
+
+  std::cout << '\n' << COLOR_GREEN << "Snapshot:" << COLOR_RESET << '\n';
+  std::cout << COLOR_GREEN << fmt::format("{:>16}{:>14}{:>10}", "REGION_SIZE(MB)", "ELAPSED(ms)", "TIMEOUT")
+            << COLOR_RESET << '\n';
+  for (const auto& result : snapshot_results) {
+    std::cout << fmt::format("{:>16}{:>14}{:>10}", result.region_size_mb, result.elapsed_ms, result.is_timeout)
+              << '\n';
+  }
+
+  std::cout << '\n' << COLOR_GREEN << "TransferLeader:" << COLOR_RESET << '\n';
+  std::cout << COLOR_GREEN
+            << fmt::format("{:>12}{:>12}{:>16}{:>10}", "REGION_ID", "ELECT(ms)", "CATCH_UP(ms)", "TIMEOUT")
+            << COLOR_RESET << '\n';
+  for (const auto& result : transfer_leader_results) {
+    std::cout << fmt::format("{:>12}{:>12}{:>16}{:>10}", result.region_id, result.elect_ms, result.catch_up_ms,
+                             result.is_timeout)
+              << '\n';
+  }
+}
+
+}  // namespace benchmark
+}  // namespace dingodb
@@ -0,0 +1,116 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_BENCHMARK_RAFT_BENCHMARK_H_
+#define DINGODB_BENCHMARK_RAFT_BENCHMARK_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "proto/common.pb.h"
+#include "sdk/client.h"
+#include "sdk/coordinator_proxy.h"
+
+namespace dingodb {
+namespace benchmark {
+
+// Benchmark of raft replication on a store cluster, run by --benchmark=raft.
+// It measures the raft layer rather than client operations:
+// 1. append: log append throughput by entry size and region count, every put is a raft log entry.
+// 2. snapshot: snapshot generation time by region size, triggered by DebugService.Snapshot.
+// 3. transfer_leader: time until the new leader is elected and until all followers catch up with it.
+// Raft status is read from the store by NodeService.GetRaftStatus.
+class RaftBenchmark {
+ public:
+  static constexpr const char* kName = "raft";
+
+  RaftBenchmark(std::shared_ptr<sdk::CoordinatorProxy> coordinator_proxy, std::shared_ptr<sdk::Client> client);
+  ~RaftBenchmark() = default;
+
+  static std::shared_ptr<RaftBenchmark> New(std::shared_ptr<sdk::CoordinatorProxy> coordinator_proxy,
+                                            std::shared_ptr<sdk::Client> client);
+
+  void Stop();
+
+  bool Run();
+
+ private:
+  struct RegionEntry {
+    int64_t region_id;
+    std::string prefix;
+  };
+
+  struct AppendResult {
+    uint32_t region_num;
+    uint32_t entry_size;
+    size_t req_num;
+    size_t error_count;
+    int64_t log_entries;
+    double entries_per_second;
+    double mb_per_second;
+    int64_t p50_latency_us;
+    int64_t p99_latency_us;
+  };
+
+  struct SnapshotResult {
+    int64_t region_size_mb;
+    int64_t elapsed_ms;
+    bool is_timeout;
+  };
+
+  struct TransferLeaderResult {
+    int64_t region_id;
+    int64_t elect_ms;
+    int64_t catch_up_ms;
+    bool is_timeout;
+  };
+
+  std::vector<RegionEntry> CreateRegions(const std::string& tag, uint32_t num);
+  void DropRegions(const std::vector<RegionEntry>& region_entries);
+
+  AppendResult RunAppend(const std::vector<RegionEntry>& region_entries, uint32_t entry_size);
+  SnapshotResult RunSnapshot(int64_t region_size_mb);
+  TransferLeaderResult RunTransferLeader(const RegionEntry& region_entry);
+
+  // Put kv to regions by all threads until duration_s elapsed or is_stop is set.
+  void Write(const std::vector<RegionEntry>& region_entries, uint32_t entry_size, int64_t duration_s,
+             std::atomic<bool>& is_stop, AppendResult& result);
+  bool Fill(const RegionEntry& region_entry, int64_t total_bytes);
+
+  bool QueryRegion(int64_t region_id, pb::common::Region& region);
+  bool GetLeaderPeer(int64_t region_id, pb::common::Peer& leader, std::vector<pb::common::Peer>& followers);
+  static bool GetRaftStatus(const pb::common::Peer& peer, int64_t region_id, pb::common::BRaftStatus& raft_status);
+  // Sum of last log index of region leaders.
+  int64_t SumLastLogIndex(const std::vector<RegionEntry>& region_entries);
+
+  bool IsStop() const { return is_stop_.load(std::memory_order_relaxed); }
+
+  static void Report(const std::vector<AppendResult>& append_results,
+                     const std::vector<SnapshotResult>& snapshot_results,
+                     const std::vector<TransferLeaderResult>& transfer_leader_results);
+
+  std::shared_ptr<sdk::CoordinatorProxy> coordinator_proxy_;
+  std::shared_ptr<sdk::Client> client_;
+
+  std::atomic<bool> is_stop_{false};
+};
+using RaftBenchmarkPtr = std::shared_ptr<RaftBenchmark>;
+
+}  // namespace benchmark
+}  // namespace dingodb
+
+#endif  // DINGODB_BENCHMARK_RAFT_BENCHMARK_H_
@@ -44,6 +44,7 @@ DECLARE_bool(with_auto_increment);
 DECLARE_string(vector_index_type);
 DECLARE_bool(auto_split);
 DECLARE_int32(part_count);
+DECLARE_int32(pre_split_region_num);
 DECLARE_int32(ncentroids);
 DECLARE_string(metrics_type);
 DECLARE_int64(def_version);
@@ -483,6 +484,7 @@ void SendCreateTable(std::shared_ptr<dingodb::CoordinatorInteraction> coordinato
     part->mutable_id()->set_parent_entity_id(new_table_id);
     part->mutable_range()->set_start_key(client::Helper::EncodeRegionRange(part_ids[i]));
     part->mutable_range()->set_end_key(client::Helper::EncodeRegionRange(part_ids[i] + 1));
+    part->set_pre_split_region_num(FLAGS_pre_split_region_num);
   }
 
   request.mutable_request_info()->set_request_id(1024);
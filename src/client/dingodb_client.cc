@@ -86,6 +86,7 @@ DEFINE_int32(efconstruction, 0, "efconstruction");
 DEFINE_int32(nlinks, 0, "nlinks");
 DEFINE_int32(ncentroids, 10, "ncentroids default : 10");
 DEFINE_int32(part_count, 1, "partition count");
+DEFINE_int32(pre_split_region_num, 0, "pre-split region num of every partition when create table");
 DEFINE_bool(with_auto_increment, true, "with_auto_increment");
 DEFINE_string(vector_index_type, "", "vector_index_type:flat, hnsw, ivf_flat");
 DEFINE_int32(round_num, 1, "Round of requests");
@@ -170,6 +171,8 @@ DEFINE_string(client_uuid, "", "Request client_uuid");
 
 DEFINE_bool(store_create_region, false, "store create region");
 DEFINE_string(db_path, "", "rocksdb path");
+DEFINE_string(backup_path, "", "backup directory shared by all stores");
+DEFINE_int64(backup_ts, 0, "backup ts, 0 is a new tso");
 
 DEFINE_bool(show_vector, false, "show vector data");
 DEFINE_string(metrics_type, "L2", "metrics type");
@@ -327,6 +330,10 @@ void Sender(std::shared_ptr<client::Context> ctx, const std::string& method, int
       client::SendSnapshotVectorIndex(FLAGS_region_id);
     } else if (method == "Compact") {
       client::SendCompact("");
+    } else if (method == "BackupRegion") {
+      client::SendBackupRegion(FLAGS_region_id, FLAGS_backup_ts, FLAGS_backup_path);
+    } else if (method == "RestoreRegion") {
+      client::SendRestoreRegion(FLAGS_region_id, FLAGS_backup_path, FLAGS_source_id);
 
     } else if (method == "GetMemoryStats") {
       client::GetMemoryStats();
@@ -37,6 +37,7 @@
 #include "client/client_router.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "coordinator/tso_control.h"
 #include "fmt/core.h"
 #include "glog/logging.h"
 #include "proto/common.pb.h"
@@ -2894,6 +2895,57 @@ void SendCompact(const std::string& cf_name) {
   InteractionManager::GetInstance().SendRequestWithoutContext("DebugService", "Compact", request, response);
 }
 
+// The backup ts is a tso from coordinator if not set.
+void SendBackupRegion(int64_t region_id, int64_t backup_ts, const std::string& backup_path) {
+  if (backup_ts == 0) {
+    dingodb::pb::meta::TsoRequest tso_request;
+    dingodb::pb::meta::TsoResponse tso_response;
+    tso_request.set_op_type(::dingodb::pb::meta::TsoOpType::OP_GEN_TSO);
+    tso_request.set_count(1);
+
+    auto status = InteractionManager::GetInstance().SendRequestWithoutContext("MetaService", "TsoService",
+                                                                              tso_request, tso_response);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << "Gen tso failed, error: " << status.error_cstr();
+      return;
+    }
+    backup_ts = (tso_response.start_timestamp().physical() << ::dingodb::kLogicalBits) +
+                tso_response.start_timestamp().logical();
+  }
+
+  dingodb::pb::store::BackupRegionRequest request;
+  dingodb::pb::store::BackupRegionResponse response;
+
+  *(request.mutable_context()) = RegionRouter::GetInstance().GenConext(region_id);
+  request.set_backup_ts(backup_ts);
+  request.set_backup_path(backup_path);
+
+  // the resolved ts of txn region may be behind the new tso for a while.
+  for (int i = 0; i < 10; ++i) {
+    InteractionManager::GetInstance().SendRequestWithContext("StoreService", "BackupRegion", request, response);
+    if (response.error().errcode() != dingodb::pb::error::EBACKUP_TS_NOT_RESOLVED) {
+      break;
+    }
+    bthread_usleep(1000 * 1000);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("backup region {} backup_ts {} files {}", region_id, backup_ts,
+                                 response.meta().files_size());
+}
+
+void SendRestoreRegion(int64_t region_id, const std::string& backup_path, int64_t backup_region_id) {
+  dingodb::pb::store::RestoreRegionRequest request;
+  dingodb::pb::store::RestoreRegionResponse response;
+
+  *(request.mutable_context()) = RegionRouter::GetInstance().GenConext(region_id);
+  request.set_backup_path(backup_path);
+  request.set_backup_region_id(backup_region_id);
+
+  InteractionManager::GetInstance().SendRequestWithContext("StoreService", "RestoreRegion", request, response);
+  DINGO_LOG(INFO) << fmt::format("restore region {} from backup region {} files {}", region_id, backup_region_id,
+                                 response.restore_file_count());
+}
+
 void GetMemoryStats() {
   dingodb::pb::debug::GetMemoryStatsRequest request;
   dingodb::pb::debug::GetMemoryStatsResponse response;
@@ -2901,6 +2953,10 @@ void GetMemoryStats() {
   InteractionManager::GetInstance().SendRequestWithoutContext("DebugService", "GetMemoryStats", request, response);
 
   DINGO_LOG(INFO) << response.memory_stats();
+  for (const auto& subsystem_memory : response.subsystem_memories()) {
+    DINGO_LOG(INFO) << fmt::format("memory {} usage {} budget {}", subsystem_memory.name(),
+                                   subsystem_memory.usage_bytes(), subsystem_memory.budget_bytes());
+  }
 }
 
 void ReleaseFreeMemory(double rate) {
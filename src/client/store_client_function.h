@@ -186,6 +186,8 @@ void BatchSendAddRegion(int start_region_id, int region_count, int thread_num, c
                         std::vector<std::string>& raft_addrs);
 void SendSnapshotVectorIndex(int64_t vector_index_id);
 void SendCompact(const std::string& cf_name);
+void SendBackupRegion(int64_t region_id, int64_t backup_ts, const std::string& backup_path);
+void SendRestoreRegion(int64_t region_id, const std::string& backup_path, int64_t backup_region_id);
 void GetMemoryStats();
 void ReleaseFreeMemory(double rate);
 
@@ -0,0 +1,152 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/async_logger.h"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_int64(async_log_flush_interval_ms, 100, "max time the buffered log messages wait to be written");
+DEFINE_bool(async_log_drop_when_full, false, "drop the log message instead of waiting when the buffer is full");
+
+AsyncLogger::AsyncLogger(google::base::Logger* wrapped, int64_t max_buffer_bytes)
+    : wrapped_(wrapped), max_buffer_bytes_(max_buffer_bytes) {}
+
+AsyncLogger::~AsyncLogger() { Stop(); }
+
+void AsyncLogger::Start() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!stopped_) {
+    return;
+  }
+  stopped_ = false;
+  thread_ = std::thread([this] { Run(); });
+}
+
+void AsyncLogger::Stop() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (stopped_) {
+      return;
+    }
+    stopped_ = true;
+  }
+  wake_cond_.notify_all();
+  free_cond_.notify_all();
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  flush_cond_.notify_all();
+}
+
+void AsyncLogger::Write(bool force_flush, time_t timestamp, const char* message, size_t message_len) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!stopped_) {
+      int64_t len = static_cast<int64_t>(message_len);
+      if (!active_buffer_.messages.empty() && active_buffer_.bytes + len > max_buffer_bytes_) {
+        if (FLAGS_async_log_drop_when_full) {
+          dropped_count_.fetch_add(1);
+          return;
+        }
+
+        wake_cond_.notify_one();
+        free_cond_.wait(lock, [&] {
+          return stopped_ || active_buffer_.messages.empty() || active_buffer_.bytes + len <= max_buffer_bytes_;
+        });
+      }
+
+      if (!stopped_) {
+        active_buffer_.messages.push_back(Message{timestamp, std::string(message, message_len)});
+        active_buffer_.bytes += len;
+        active_buffer_.force_flush = active_buffer_.force_flush || force_flush;
+        if (active_buffer_.bytes >= max_buffer_bytes_ / 2) {
+          wake_cond_.notify_one();
+        }
+        return;
+      }
+    }
+  }
+
+  // not started or stopped, write directly
+  wrapped_->Write(force_flush, timestamp, message, message_len);
+}
+
+void AsyncLogger::Flush() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!stopped_) {
+      // the next swap takes the messages buffered now
+      int64_t target_seq = flushing_seq_ + 1;
+      flush_requested_ = true;
+      wake_cond_.notify_one();
+      flush_cond_.wait(lock, [&] { return stopped_ || written_seq_ >= target_seq; });
+    }
+  }
+
+  wrapped_->Flush();
+}
+
+uint32_t AsyncLogger::LogSize() { return wrapped_->LogSize(); }
+
+void AsyncLogger::Run() {
+  while (true) {
+    int64_t seq = 0;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_cond_.wait_for(lock, std::chrono::milliseconds(FLAGS_async_log_flush_interval_ms), [&] {
+        return stopped_ || flush_requested_ || active_buffer_.bytes >= max_buffer_bytes_ / 2;
+      });
+
+      if (active_buffer_.messages.empty()) {
+        written_seq_ = ++flushing_seq_;
+        flush_requested_ = false;
+        flush_cond_.notify_all();
+        if (stopped_) {
+          break;
+        }
+        continue;
+      }
+
+      std::swap(active_buffer_, flushing_buffer_);
+      seq = ++flushing_seq_;
+      flush_requested_ = false;
+    }
+    free_cond_.notify_all();
+
+    for (const auto& message : flushing_buffer_.messages) {
+      wrapped_->Write(false, message.timestamp, message.message.data(), message.message.size());
+    }
+    if (flushing_buffer_.force_flush) {
+      wrapped_->Flush();
+    }
+    flushing_buffer_.Clear();
+
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      written_seq_ = seq;
+    }
+    flush_cond_.notify_all();
+  }
+}
+
+}  // namespace dingodb
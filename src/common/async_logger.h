@@ -0,0 +1,94 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_ASYNC_LOGGER_H_
+#define DINGODB_COMMON_ASYNC_LOGGER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+
+namespace dingodb {
+
+// Wrap the glog file logger, the log threads only append the formatted message to a buffer,
+// a background thread swaps the buffers and writes them to the wrapped logger.
+// When the buffer is full, the log threads wait for the background thread, or drop the message
+// if async_log_drop_when_full. Flush() waits until all buffered messages are written, glog calls it
+// before abort of FATAL.
+class AsyncLogger : public google::base::Logger {
+ public:
+  AsyncLogger(google::base::Logger* wrapped, int64_t max_buffer_bytes);
+  ~AsyncLogger() override;
+
+  AsyncLogger(const AsyncLogger&) = delete;
+  AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+  void Start();
+  void Stop();
+
+  void Write(bool force_flush, time_t timestamp, const char* message, size_t message_len) override;
+  void Flush() override;
+  uint32_t LogSize() override;
+
+  int64_t DroppedCount() const { return dropped_count_.load(); }
+
+ private:
+  struct Message {
+    time_t timestamp;
+    std::string message;
+  };
+
+  struct Buffer {
+    std::vector<Message> messages;
+    int64_t bytes{0};
+    bool force_flush{false};
+
+    void Clear() {
+      messages.clear();
+      bytes = 0;
+      force_flush = false;
+    }
+  };
+
+  void Run();
+
+  google::base::Logger* wrapped_;
+  const int64_t max_buffer_bytes_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_cond_;
+  std::condition_variable free_cond_;
+  std::condition_variable flush_cond_;
+  Buffer active_buffer_;
+  Buffer flushing_buffer_;
+  // every swap of buffers increases it, Flush() waits for it.
+  int64_t written_seq_{0};
+  int64_t flushing_seq_{0};
+  std::atomic<int64_t> dropped_count_{0};
+  bool flush_requested_{false};
+  bool stopped_{true};
+  std::thread thread_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_ASYNC_LOGGER_H_
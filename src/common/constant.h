@@ -85,6 +85,7 @@ class Constant {
 
   // flat map init capacity
   static const int64_t kStoreRegionMetaInitCapacity = 1024;
+  static const int64_t kScanManagerInitCapacity = 1024;
 
   // internal schema name
   inline static const std::string kRootSchemaName = "ROOT";
@@ -114,12 +115,48 @@ class Constant {
   inline static const std::string kWriteBufferSizeDefaultValue = "67108864";  // 64MB
   inline static const std::string kPrefixExtractor = "prefix_extractor";
   inline static const std::string kPrefixExtractorDefaultValue = "24";
+  // prefix is the user key of txn key, txn key is padded user key + 8 bytes ts
+  inline static const std::string kPrefixExtractorTxnUserKey = "txn_user_key";
   inline static const std::string kMaxBytesForLevelBase = "max_bytes_for_level_base";
   inline static const std::string kMaxBytesForLevelBaseDefaultValue = "134217728";  // 128MB
   inline static const std::string kTargetFileSizeBase = "target_file_size_base";
   inline static const std::string kTargetFileSizeBaseDefaultValue = "67108864";  // 64MB
   inline static const std::string kMaxBytesForLevelMultiplier = "max_bytes_for_level_multiplier";
   inline static const std::string kMaxBytesForLevelMultiplierDefaultValue = "10";
+  // lru or hyper_clock
+  inline static const std::string kBlockCacheType = "block_cache_type";
+  inline static const std::string kBlockCacheTypeDefaultValue = "lru";
+  // bloom, ribbon or none
+  inline static const std::string kFilterPolicy = "filter_policy";
+  inline static const std::string kFilterPolicyDefaultValue = "bloom";
+  inline static const std::string kFilterBitsPerKey = "filter_bits_per_key";
+  inline static const std::string kFilterBitsPerKeyDefaultValue = "10";
+  inline static const std::string kWholeKeyFiltering = "whole_key_filtering";
+  inline static const std::string kWholeKeyFilteringDefaultValue = "true";
+  inline static const std::string kPartitionedIndexFilter = "partitioned_index_filter";
+  inline static const std::string kPartitionedIndexFilterDefaultValue = "false";
+  inline static const std::string kPinIndexFilterInCache = "pin_index_filter_in_cache";
+  inline static const std::string kPinIndexFilterInCacheDefaultValue = "false";
+  // integrated blob db, values not smaller than min_blob_size are separated into blob files
+  inline static const std::string kEnableBlobFiles = "enable_blob_files";
+  inline static const std::string kEnableBlobFilesDefaultValue = "false";
+  inline static const std::string kMinBlobSize = "min_blob_size";
+  inline static const std::string kMinBlobSizeDefaultValue = "4096";  // 4KB
+  inline static const std::string kBlobFileSize = "blob_file_size";
+  inline static const std::string kBlobFileSizeDefaultValue = "268435456";  // 256MB
+  inline static const std::string kEnableBlobGarbageCollection = "enable_blob_garbage_collection";
+  inline static const std::string kEnableBlobGarbageCollectionDefaultValue = "true";
+  // tiered storage, the lower levels beyond hot_path_target_size are placed on cold_path, empty cold_path is disabled
+  inline static const std::string kColdPath = "cold_path";
+  inline static const std::string kColdPathDefaultValue = "";
+  inline static const std::string kHotPathTargetSize = "hot_path_target_size";
+  inline static const std::string kHotPathTargetSizeDefaultValue = "0";  // 0 is all levels except the last one
+  // compression of all levels, default is none for L0-L1, lz4 for L2-L4, zstd for the others.
+  // e.g. vector data of floats is hardly compressed by lz4, none or zstd with dictionary is better.
+  inline static const std::string kCompressionType = "compression_type";
+  inline static const std::string kCompressionTypeDefaultValue = "default";  // default, none, lz4 or zstd
+  inline static const std::string kZstdMaxDictBytes = "zstd_max_dict_bytes";
+  inline static const std::string kZstdMaxDictBytesDefaultValue = "0";  // 0 is no dictionary
 
   static const int kRocksdbBackgroundThreadNumDefault = 16;
   static const int kStatsDumpPeriodSecDefault = 600;
@@ -165,6 +202,7 @@ class Constant {
   static constexpr int32_t kCreateIvfPqParamNsubvector = 64;
   static constexpr int32_t kCreateIvfPqParamNbitsPerIdx = 8;
   static constexpr int32_t kCreateIvfPqParamNbitsPerIdxMaxWarning = 16;
+  static constexpr int32_t kCreateIvfPqParamFastScanNbitsPerIdx = 4;
 
   static constexpr int32_t kSearchIvfPqParamNprobe = 80;
 
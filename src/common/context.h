@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "brpc/controller.h"
 #include "common/synchronization.h"
@@ -89,6 +90,12 @@ class Context {
     return *this;
   }
 
+  pb::store::ReadMode ReadMode() const { return read_mode_; }
+  Context& SetReadMode(pb::store::ReadMode read_mode) {
+    read_mode_ = read_mode;
+    return *this;
+  }
+
   void SetRawEngineType(pb::common::RawEngine raw_engine_type) { raw_engine_type_ = raw_engine_type; }
   pb::common::RawEngine RawEngineType() { return raw_engine_type_; }
 
@@ -121,6 +128,10 @@ class Context {
   WriteCbFunc WriteCb() { return write_cb_; }
   void SetWriteCb(WriteCbFunc write_cb) { write_cb_ = write_cb; }
 
+  // Per key result of the conditional write, set by apply handler.
+  const std::vector<bool>& KeyStates() const { return key_states_; }
+  void SetKeyStates(const std::vector<bool>& key_states) { key_states_ = key_states; }
+
  private:
   // brpc framework free resource
   brpc::Controller* cntl_{nullptr};
@@ -137,6 +148,8 @@ class Context {
   pb::common::RegionEpoch region_epoch_{};
   // Transaction isolation level
   pb::store::IsolationLevel isolation_level_{};
+  // Read on leader or follower
+  pb::store::ReadMode read_mode_{pb::store::ReadLeader};
 
   // Rocksdb delete range in files
   bool delete_files_in_range_{false};
@@ -149,6 +162,8 @@ class Context {
 
   WriteCbFunc write_cb_{};
 
+  std::vector<bool> key_states_;
+
   TrackerPtr tracker_;
 };
 
@@ -46,6 +46,7 @@
 #include "brpc/builtin/common.h"
 #include "bthread/bthread.h"
 #include "butil/compiler_specific.h"
+#include "butil/crc32c.h"
 #include "butil/endpoint.h"
 #include "butil/status.h"
 #include "butil/strings/string_split.h"
@@ -159,6 +160,18 @@ void Helper::SortPeers(std::vector<pb::common::Peer>& peers) {
   std::sort(peers.begin(), peers.end(), compare_func);
 }
 
+bool Helper::IsVectorIndexWarmPeer(const pb::common::RegionDefinition& definition, int64_t store_id,
+                                   int32_t warm_follower_num) {
+  std::vector<int64_t> store_ids;
+  for (const auto& peer : definition.peers()) {
+    store_ids.push_back(peer.store_id());
+  }
+  std::sort(store_ids.begin(), store_ids.end());
+
+  size_t warm_peer_num = std::min(store_ids.size(), static_cast<size_t>(std::max(warm_follower_num, 0)) + 1);
+  return std::find(store_ids.begin(), store_ids.begin() + warm_peer_num, store_id) != store_ids.begin() + warm_peer_num;
+}
+
 bool Helper::IsDifferencePeers(const std::vector<pb::common::Peer>& peers,
                                const std::vector<pb::common::Peer>& other_peers) {
   if (peers.size() != other_peers.size()) {
@@ -605,6 +618,72 @@ std::string Helper::CalculateMiddleKey(const std::string& start_key, const std::
   return real_mid;
 }
 
+std::vector<std::string> Helper::CalculateUniformSplitKeys(const std::string& start_key, const std::string& end_key,
+                                                           int32_t num) {
+  std::vector<std::string> split_keys;
+  if (num <= 1 || start_key >= end_key) {
+    return split_keys;
+  }
+
+  // keys are big endian numbers right padded to the same length, one more byte for narrow range.
+  size_t length = std::max(start_key.size(), end_key.size()) + 1;
+  std::string start = start_key;
+  std::string end = end_key;
+  start.resize(length, 0);
+  end.resize(length, 0);
+
+  std::vector<uint8_t> diff = SubtractByteArrays(std::vector<uint8_t>(start.begin(), start.end()),
+                                                 std::vector<uint8_t>(end.begin(), end.end()));
+  split_keys.reserve(num - 1);
+  for (int32_t i = 1; i < num; ++i) {
+    // offset = diff * i / num, the digit of quotient may exceed one byte, carry it from low to high.
+    std::vector<uint64_t> quotient(length, 0);
+    uint64_t remainder = 0;
+    for (size_t k = 0; k < length; ++k) {
+      uint64_t value = (remainder << 8) + static_cast<uint64_t>(diff[k]) * i;
+      quotient[k] = value / num;
+      remainder = value % num;
+    }
+
+    std::string key(length, 0);
+    uint64_t carry = 0;
+    for (size_t k = length; k-- > 0;) {
+      uint64_t value = quotient[k] + static_cast<uint8_t>(start[k]) + carry;
+      key[k] = static_cast<char>(value & 0xFF);
+      carry = value >> 8;
+    }
+
+    if (key > start_key && key < end_key && (split_keys.empty() || key > split_keys.back())) {
+      split_keys.push_back(std::move(key));
+    }
+  }
+
+  return split_keys;
+}
+
+std::vector<std::string> Helper::CalculateSampleSplitKeys(const std::string& start_key, const std::string& end_key,
+                                                          std::vector<std::string> sample_keys, int32_t num) {
+  std::vector<std::string> split_keys;
+  sample_keys.erase(std::remove_if(sample_keys.begin(), sample_keys.end(),
+                                   [&](const std::string& key) { return key <= start_key || key >= end_key; }),
+                    sample_keys.end());
+  if (num <= 1 || sample_keys.empty()) {
+    return split_keys;
+  }
+
+  std::sort(sample_keys.begin(), sample_keys.end());
+  sample_keys.erase(std::unique(sample_keys.begin(), sample_keys.end()), sample_keys.end());
+
+  for (int32_t i = 1; i < num; ++i) {
+    const auto& key = sample_keys[static_cast<size_t>(i) * sample_keys.size() / num];
+    if (split_keys.empty() || key > split_keys.back()) {
+      split_keys.push_back(key);
+    }
+  }
+
+  return split_keys;
+}
+
 std::vector<uint8_t> Helper::SubtractByteArrays(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
   size_t max_length = std::max(a.size(), b.size());
 
@@ -1432,6 +1511,15 @@ int64_t Helper::GetFileSize(const std::string& path) {
   }
 }
 
+uint32_t Helper::Crc32c(const butil::IOBuf& buf) {
+  uint32_t crc = 0;
+  for (size_t i = 0; i < buf.backing_block_num(); ++i) {
+    auto block = buf.backing_block(i);
+    crc = butil::crc32c::Extend(crc, block.data(), block.size());
+  }
+  return crc;
+}
+
 bool Helper::IsEqualVectorScalarValue(const pb::common::ScalarValue& value1, const pb::common::ScalarValue& value2) {
   if (value1.field_type() != value2.field_type()) {
     return false;
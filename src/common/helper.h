@@ -16,14 +16,17 @@
 #define DINGODB_COMMON_HELPER_H_
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include "braft/configuration.h"
 #include "butil/endpoint.h"
+#include "butil/iobuf.h"
 #include "butil/status.h"
 #include "fmt/core.h"
+#include "google/protobuf/arena.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/node.pb.h"
@@ -56,6 +59,10 @@ class Helper {
                                 const pb::common::RegionDefinition& dst_definition);
 
   static void SortPeers(std::vector<pb::common::Peer>& peers);
+  // The first warm_follower_num + 1 peers ordered by store id keep the vector index warm, so the leader is always
+  // able to transfer to a warm peer, whichever peer it is.
+  static bool IsVectorIndexWarmPeer(const pb::common::RegionDefinition& definition, int64_t store_id,
+                                    int32_t warm_follower_num);
   static std::vector<pb::common::Location> ExtractLocations(
       const google::protobuf::RepeatedPtrField<pb::common::Peer>& peers);
   static std::vector<pb::common::Location> ExtractLocations(const std::vector<pb::common::Peer>& peers);
@@ -134,6 +141,18 @@ class Helper {
     return vec;
   }
 
+  // Create message on its own arena, the sub messages and strings of the message are allocated in the arena blocks
+  // instead of one heap allocation each, the arena is freed with the last reference of the message.
+  template <typename T>
+  static std::shared_ptr<T> NewArenaMessage(size_t start_block_size) {
+    google::protobuf::ArenaOptions options;
+    options.start_block_size = start_block_size;
+    auto arena = std::make_shared<google::protobuf::Arena>(options);
+    auto* message = google::protobuf::Arena::CreateMessage<T>(arena.get());
+    // share the ownership of arena
+    return std::shared_ptr<T>(arena, message);
+  }
+
   template <typename T>
   static void VectorToPbRepeated(const std::vector<T>& vec, google::protobuf::RepeatedPtrField<T>* out) {
     for (auto& item : vec) {
@@ -141,6 +160,15 @@ class Helper {
     }
   }
 
+  // Swap the items into out, large values are not copied again.
+  template <typename T>
+  static void VectorToPbRepeated(std::vector<T>&& vec, google::protobuf::RepeatedPtrField<T>* out) {
+    out->Reserve(out->size() + vec.size());
+    for (auto& item : vec) {
+      out->Add()->Swap(&item);
+    }
+  }
+
   template <typename T>
   static void VectorToPbRepeated(const std::vector<T>& vec, google::protobuf::RepeatedField<T>* out) {
     for (auto& item : vec) {
@@ -278,6 +306,12 @@ class Helper {
   static std::string StringDivideByTwoRightAlign(const std::string& array);
 
   static std::string CalculateMiddleKey(const std::string& start_key, const std::string& end_key);
+  // Split [start_key, end_key) into num ranges of the same key span, return the num - 1 split keys.
+  static std::vector<std::string> CalculateUniformSplitKeys(const std::string& start_key, const std::string& end_key,
+                                                            int32_t num);
+  // Split [start_key, end_key) into num ranges of the same count of sample keys, return at most num - 1 split keys.
+  static std::vector<std::string> CalculateSampleSplitKeys(const std::string& start_key, const std::string& end_key,
+                                                           std::vector<std::string> sample_keys, int32_t num);
 
   static std::vector<uint8_t> SubtractByteArrays(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b);
   static std::vector<uint8_t> DivideByteArrayByTwo(const std::vector<uint8_t>& array);
@@ -299,6 +333,7 @@ class Helper {
   static butil::Status Rename(const std::string& src_path, const std::string& dst_path, bool is_force = true);
   static bool IsExistPath(const std::string& path);
   static int64_t GetFileSize(const std::string& path);
+  static uint32_t Crc32c(const butil::IOBuf& buf);
 
   // vector scalar index value
   static bool IsEqualVectorScalarValue(const pb::common::ScalarValue& value1, const pb::common::ScalarValue& value2);
@@ -14,16 +14,22 @@
 
 #include "common/latch.h"
 
+#include <algorithm>
 #include <cassert>
 #include <utility>
 
 #include "butil/scoped_lock.h"
+#include "butil/time.h"
+#include "bvar/latency_recorder.h"
 #include "gflags/gflags.h"
 
 namespace dingodb {
 
 DEFINE_uint32(latch_slot_num, 2048, "latch slot num");
 
+bvar::LatencyRecorder g_latch_slot_wait_recorder("dingo_latches_slot_wait");
+bvar::LatencyRecorder g_latch_range_wait_recorder("dingo_latches_range_wait");
+
 const size_t kWaitingListShrinkSize = 8;
 const size_t kWaitingListMaxCapacity = 16;
 
@@ -75,11 +81,14 @@ Lock::Lock(const std::vector<std::string>& keys) {
   requiredHashes.erase(last, requiredHashes.end());
 }
 
+Lock::Lock(const std::string& start_key, const std::string& end_key)
+    : isRangeLock(true), startKey(start_key), endKey(end_key) {}
+
 bool Lock::Acquired() const { return requiredHashes.size() == ownedCount; }
 
 void Lock::ForceAssumeAcquired() { ownedCount = requiredHashes.size(); }
 
-bool Lock::IsWriteLock() const { return !requiredHashes.empty(); }
+bool Lock::IsWriteLock() const { return isRangeLock || !requiredHashes.empty(); }
 
 uint64_t Lock::Hash(const std::string& key) {
   // Simple hashing for demonstration. In production, use a better hash function.
@@ -89,14 +98,19 @@ uint64_t Lock::Hash(const std::string& key) {
 Latches::Latches(size_t size) {
   slots_size = NextPowerOfTwo(size);
   slots_ptr = new std::vector<Slot>(slots_size);
+  CHECK_EQ(0, bthread_mutex_init(&gate_mutex_, nullptr));
 }
 
 Latches::Latches() {
   slots_size = NextPowerOfTwo(FLAGS_latch_slot_num);
   slots_ptr = new std::vector<Slot>(slots_size);
+  CHECK_EQ(0, bthread_mutex_init(&gate_mutex_, nullptr));
 }
 
-Latches::~Latches() { delete slots_ptr; }
+Latches::~Latches() {
+  delete slots_ptr;
+  CHECK_EQ(0, bthread_mutex_destroy(&gate_mutex_));
+}
 
 // CAUTION: this function is not safe, need to call before any usage begin
 void Latches::SetSlotNum(size_t size) {
@@ -104,24 +118,44 @@ void Latches::SetSlotNum(size_t size) {
   slots_ptr->resize(slots_size);
 }
 
-bool Latches::Acquire(Lock* lock, uint64_t who) const {
+bool Latches::Acquire(Lock* lock, uint64_t who, std::vector<uint64_t>* wakeup_list) const {
+  if (lock->isRangeLock) {
+    return AcquireRange(lock, who);
+  }
+
+  if (!EnterGate(lock, who, wakeup_list)) {
+    return false;
+  }
+
   size_t acquired_count = 0;
   for (size_t i = lock->ownedCount; i < lock->requiredHashes.size(); ++i) {
     auto key_hash = lock->requiredHashes[i];
-    BAIDU_SCOPED_LOCK(GetSlot(key_hash)->mutex);
-    Latch& latch = GetSlot(key_hash)->latch;
+    auto slot_index = static_cast<int64_t>(GetSlotIndex(key_hash));
+    Slot* slot = GetSlot(key_hash);
+    BAIDU_SCOPED_LOCK(slot->mutex);
+    Latch& latch = slot->latch;
 
     auto first_req = latch.GetFirstReqByHash(key_hash);
-    if (first_req.has_value()) {
-      if (first_req == who) {
-        ++acquired_count;
-      } else {
-        latch.WaitForWake(key_hash, who);
-        break;
-      }
-    } else {
+    if (first_req.has_value() && first_req != who) {
+      latch.WaitForWake(key_hash, who);
+      ++slot->waitCount;
+      lock->blockedSlot = slot_index;
+      lock->waitStartUs = butil::gettimeofday_us();
+      break;
+    }
+
+    if (!first_req.has_value()) {
       latch.WaitForWake(key_hash, who);
-      ++acquired_count;
+    }
+    ++slot->acquireCount;
+    ++acquired_count;
+
+    if (lock->blockedSlot == slot_index) {
+      uint64_t wait_us = butil::gettimeofday_us() - lock->waitStartUs;
+      slot->totalWaitUs += wait_us;
+      slot->maxWaitUs = std::max(slot->maxWaitUs, wait_us);
+      g_latch_slot_wait_recorder << wait_us;
+      lock->blockedSlot = -1;
     }
   }
 
@@ -131,6 +165,10 @@ bool Latches::Acquire(Lock* lock, uint64_t who) const {
 
 std::vector<uint64_t> Latches::Release(Lock* lock, uint64_t who,
                                        std::optional<std::pair<uint64_t, Lock*>> keep_latches_for_next_cmd) const {
+  if (lock->isRangeLock) {
+    return ReleaseRange(lock, who);
+  }
+
   uint64_t keep_latches_for_cid = 0;
   std::vector<uint64_t>::iterator keep_latches_it;
 
@@ -177,9 +215,134 @@ std::vector<uint64_t> Latches::Release(Lock* lock, uint64_t who,
   assert(keep_latchtes_for_next_cmd_pair == nullptr ||
          keep_latches_it == keep_latchtes_for_next_cmd_pair->second->requiredHashes.end());
 
+  if (lock->gateEntered) {
+    if (keep_latchtes_for_next_cmd_pair != nullptr) {
+      // the next cmd inherits the latches, so it inherits the gate too.
+      keep_latchtes_for_next_cmd_pair->second->gateEntered = true;
+    } else {
+      LeaveGate(lock, &wakeup_list);
+    }
+    lock->gateEntered = false;
+  }
+
   return wakeup_list;
 }
 
+// Key lock passes the gate in shared mode, it is lock free if there is no range lock.
+bool Latches::EnterGate(Lock* lock, uint64_t who, std::vector<uint64_t>* wakeup_list) const {
+  if (lock->gateEntered) {
+    return true;
+  }
+
+  gate_holders_.fetch_add(1);
+  if (!gate_closed_.load()) {
+    lock->gateEntered = true;
+    return true;
+  }
+
+  // range lock is held or waiting, back off.
+  BAIDU_SCOPED_LOCK(gate_mutex_);
+  if (!gate_closed_.load()) {
+    lock->gateEntered = true;
+    return true;
+  }
+
+  if (gate_holders_.fetch_sub(1) == 1 && range_owner_waiting_) {
+    CHECK(wakeup_list != nullptr) << "wakeup_list is required when use range lock.";
+    range_owner_waiting_ = false;
+    wakeup_list->push_back(range_owner_);
+  }
+
+  gate_waiters_.push_back(who);
+  return false;
+}
+
+void Latches::LeaveGate(Lock* /*lock*/, std::vector<uint64_t>* wakeup_list) const {
+  if (gate_holders_.fetch_sub(1) == 1 && gate_closed_.load()) {
+    BAIDU_SCOPED_LOCK(gate_mutex_);
+    if (range_owner_waiting_ && gate_holders_.load() == 0) {
+      range_owner_waiting_ = false;
+      wakeup_list->push_back(range_owner_);
+    }
+  }
+}
+
+// Range lock passes the gate in exclusive mode, it closes the gate first and then waits for all key locks leaving.
+bool Latches::AcquireRange(Lock* lock, uint64_t who) const {
+  BAIDU_SCOPED_LOCK(gate_mutex_);
+  if (range_owner_ == who) {
+    // woken up by the last key lock holder
+    if (gate_holders_.load() == 0) {
+      g_latch_range_wait_recorder << butil::gettimeofday_us() - lock->waitStartUs;
+      return true;
+    }
+    range_owner_waiting_ = true;
+    return false;
+  }
+
+  if (range_owner_ != 0) {
+    if (lock->waitStartUs == 0) {
+      lock->waitStartUs = butil::gettimeofday_us();
+    }
+    gate_waiters_.push_back(who);
+    return false;
+  }
+
+  range_owner_ = who;
+  gate_closed_.store(true);
+  if (lock->waitStartUs == 0) {
+    lock->waitStartUs = butil::gettimeofday_us();
+  }
+  if (gate_holders_.load() == 0) {
+    g_latch_range_wait_recorder << butil::gettimeofday_us() - lock->waitStartUs;
+    return true;
+  }
+
+  range_owner_waiting_ = true;
+  return false;
+}
+
+std::vector<uint64_t> Latches::ReleaseRange(Lock* /*lock*/, uint64_t who) const {
+  BAIDU_SCOPED_LOCK(gate_mutex_);
+  if (range_owner_ != who) {
+    return {};
+  }
+
+  range_owner_ = 0;
+  range_owner_waiting_ = false;
+  gate_closed_.store(false);
+
+  // wake up all waiters, they try again.
+  std::vector<uint64_t> wakeup_list(gate_waiters_.begin(), gate_waiters_.end());
+  gate_waiters_.clear();
+  return wakeup_list;
+}
+
+std::vector<SlotStat> Latches::GetHotSlots(size_t top_n) const {
+  std::vector<SlotStat> slot_stats;
+  for (size_t i = 0; i < slots_size; ++i) {
+    Slot& slot = (*slots_ptr)[i];
+    BAIDU_SCOPED_LOCK(slot.mutex);
+    if (slot.acquireCount == 0 && slot.waitCount == 0) {
+      continue;
+    }
+    slot_stats.push_back(
+        {i, slot.acquireCount, slot.waitCount, slot.totalWaitUs, slot.maxWaitUs, slot.latch.waiting.size()});
+  }
+
+  auto compare = [](const SlotStat& a, const SlotStat& b) {
+    return a.total_wait_us != b.total_wait_us ? a.total_wait_us > b.total_wait_us : a.wait_count > b.wait_count;
+  };
+  if (slot_stats.size() > top_n) {
+    std::partial_sort(slot_stats.begin(), slot_stats.begin() + top_n, slot_stats.end(), compare);
+    slot_stats.resize(top_n);
+  } else {
+    std::sort(slot_stats.begin(), slot_stats.end(), compare);
+  }
+
+  return slot_stats;
+}
+
 size_t Latches::NextPowerOfTwo(size_t n) {
   if (n == 0) {
     return 1;
@@ -194,9 +357,8 @@ size_t Latches::NextPowerOfTwo(size_t n) {
   return n + 1;
 }
 
-Slot* Latches::GetSlot(uint64_t hash) const {
-  auto index = hash & (slots_size - 1);
-  return &(*slots_ptr)[index];
-}
+size_t Latches::GetSlotIndex(uint64_t hash) const { return hash & (slots_size - 1); }
+
+Slot* Latches::GetSlot(uint64_t hash) const { return &(*slots_ptr)[GetSlotIndex(hash)]; }
 
 }  // namespace dingodb
@@ -15,8 +15,11 @@
 #ifndef DINGODB_COMMON_LATCH_H_
 #define DINGODB_COMMON_LATCH_H_
 
+#include <atomic>
+#include <cstdint>
 #include <deque>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "bthread/mutex.h"
@@ -47,7 +50,20 @@ class Lock {
   std::vector<uint64_t> requiredHashes{};
   size_t ownedCount = 0;
 
+  // range lock is exclusive with all other locks of the latches.
+  bool isRangeLock = false;
+  std::string startKey;
+  std::string endKey;
+
+  // key lock has passed the range gate of latches.
+  bool gateEntered = false;
+
+  // used for latch wait metrics.
+  int64_t waitStartUs = 0;
+  int64_t blockedSlot = -1;
+
   Lock(const std::vector<std::string>& keys);
+  Lock(const std::string& start_key, const std::string& end_key);
 
   bool Acquired() const;
 
@@ -63,6 +79,21 @@ struct Slot {
   ~Slot() { CHECK_EQ(0, bthread_mutex_destroy(&mutex)); }
   bthread_mutex_t mutex;
   Latch latch;
+
+  // contention stats, protected by mutex.
+  uint64_t acquireCount = 0;
+  uint64_t waitCount = 0;
+  uint64_t totalWaitUs = 0;
+  uint64_t maxWaitUs = 0;
+};
+
+struct SlotStat {
+  size_t index;
+  uint64_t acquire_count;
+  uint64_t wait_count;
+  uint64_t total_wait_us;
+  uint64_t max_wait_us;
+  size_t waiting_num;
 };
 
 class Latches {
@@ -73,7 +104,8 @@ class Latches {
 
   void SetSlotNum(size_t size);
 
-  bool Acquire(Lock* lock, uint64_t who) const;
+  // wakeup_list return the waiters need to be woken up when the range gate is released by a backing off key lock.
+  bool Acquire(Lock* lock, uint64_t who, std::vector<uint64_t>* wakeup_list = nullptr) const;
 
   // std::vector<uint64_t> Release(const Lock& lock, uint64_t who) const;
   std::vector<uint64_t> Release(Lock* lock, uint64_t who,
@@ -82,10 +114,33 @@ class Latches {
   size_t GetSlotIndex(uint64_t hash) const;
   Slot* GetSlot(uint64_t hash) const;
 
+  // top n slots order by total wait time.
+  std::vector<SlotStat> GetHotSlots(size_t top_n) const;
+
   std::vector<Slot>* slots_ptr;
   size_t slots_size;
 
   static size_t NextPowerOfTwo(size_t n);
+
+ private:
+  bool AcquireRange(Lock* lock, uint64_t who) const;
+  std::vector<uint64_t> ReleaseRange(Lock* lock, uint64_t who) const;
+
+  bool EnterGate(Lock* lock, uint64_t who, std::vector<uint64_t>* wakeup_list) const;
+  void LeaveGate(Lock* lock, std::vector<uint64_t>* wakeup_list) const;
+
+  // Range gate, key locks pass the gate in shared mode and range lock pass in exclusive mode.
+  // key lock holders count.
+  mutable std::atomic<int64_t> gate_holders_{0};
+  // range lock is held or waiting for key lock holders.
+  mutable std::atomic<bool> gate_closed_{false};
+  // protect the following members.
+  mutable bthread_mutex_t gate_mutex_;
+  // the range lock owner, 0 means no range lock.
+  mutable uint64_t range_owner_{0};
+  // the range lock owner is waiting for key lock holders leave.
+  mutable bool range_owner_waiting_{false};
+  mutable std::deque<uint64_t> gate_waiters_;
 };
 
 }  // namespace dingodb
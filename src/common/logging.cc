@@ -14,14 +14,27 @@
 
 #include "common/logging.h"
 
+#include <chrono>
 #include <cstdint>
 #include <iomanip>
 
+#include "bvar/passive_status.h"
+#include "common/async_logger.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/node.pb.h"
 
 namespace dingodb {
 
+DEFINE_bool(enable_async_log, false, "write the info log file by a background thread");
+DEFINE_int64(async_log_buffer_mb, 8, "max buffered size of async log");
+
+static AsyncLogger* g_async_logger = nullptr;
+
+static int64_t GetAsyncLogDroppedCount(void*) {
+  return g_async_logger == nullptr ? 0 : g_async_logger->DroppedCount();
+}
+
 void DingoLogger::InitLogger(const std::string& log_dir, const std::string& role, const pb::node::LogLevel& level) {
   FLAGS_logbufsecs = 0;
   FLAGS_max_log_size = 80;
@@ -36,6 +49,37 @@ void DingoLogger::InitLogger(const std::string& log_dir, const std::string& role
   google::SetLogDestination(google::GLOG_WARNING, fmt::format("{}/{}.warn.log.", log_dir, role).c_str());
   google::SetLogDestination(google::GLOG_ERROR, fmt::format("{}/{}.error.log.", log_dir, role).c_str());
   google::SetLogDestination(google::GLOG_FATAL, fmt::format("{}/{}.fatal.log.", log_dir, role).c_str());
+
+  // the info log file gets all messages, so only it is written asynchronously.
+  if (FLAGS_enable_async_log && g_async_logger == nullptr) {
+    g_async_logger =
+        new AsyncLogger(google::base::GetLogger(google::GLOG_INFO), FLAGS_async_log_buffer_mb * 1024 * 1024);
+    g_async_logger->Start();
+    google::base::SetLogger(google::GLOG_INFO, g_async_logger);
+
+    static bvar::PassiveStatus<int64_t> async_log_dropped_count("dingo_async_log_dropped_count",
+                                                                GetAsyncLogDroppedCount, nullptr);
+  }
+}
+
+bool LogRateLimiter::AllowEveryN(int64_t n) {
+  if (n <= 1) {
+    return true;
+  }
+  return count_.fetch_add(1, std::memory_order_relaxed) % n == 0;
+}
+
+bool LogRateLimiter::AllowEverySeconds(int64_t seconds) {
+  int64_t now_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count();
+  int64_t next_time_us = next_time_us_.load(std::memory_order_relaxed);
+  if (now_us < next_time_us) {
+    return false;
+  }
+  // only one thread wins when many threads reach the time together
+  return next_time_us_.compare_exchange_strong(next_time_us, now_us + seconds * 1000 * 1000,
+                                               std::memory_order_relaxed);
 }
 
 void DingoLogger::SetMinLogLevel(int level) { FLAGS_minloglevel = level; }
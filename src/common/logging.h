@@ -15,6 +15,9 @@
 #ifndef DINGODB_COMMON_LOGGING_H_
 #define DINGODB_COMMON_LOGGING_H_
 
+#include <atomic>
+#include <cstdint>
+
 #include "glog/logging.h"
 #include "proto/node.pb.h"
 
@@ -31,20 +34,57 @@ static constexpr int kGlobalValueOfDebug = DINGO_DEBUG;
 
 #define DINGO_LOG(level) DINGO_LOG_##level
 
+// LOG(severity) formats the message even if severity is less than minloglevel,
+// so check the level first and the stream is not evaluated.
+#define DINGO_LOG_IS_ON(severity) (FLAGS_minloglevel <= google::GLOG_##severity)
+
+// DINGO_LOG_STRIP_DEBUG removes the debug log from the binary, the stream is never evaluated.
+#ifdef DINGO_LOG_STRIP_DEBUG
+#define DINGO_LOG_DEBUG while (false) VLOG(DINGO_DEBUG) << CURRENT_FUNC_NAME
+#else
 #define DINGO_LOG_DEBUG VLOG(DINGO_DEBUG) << CURRENT_FUNC_NAME
-#define DINGO_LOG_INFO LOG(INFO) << CURRENT_FUNC_NAME
-#define DINGO_LOG_WARNING LOG(WARNING) << CURRENT_FUNC_NAME
-#define DINGO_LOG_ERROR LOG(ERROR) << CURRENT_FUNC_NAME
+#endif
+#define DINGO_LOG_INFO LOG_IF(INFO, DINGO_LOG_IS_ON(INFO)) << CURRENT_FUNC_NAME
+#define DINGO_LOG_WARNING LOG_IF(WARNING, DINGO_LOG_IS_ON(WARNING)) << CURRENT_FUNC_NAME
+#define DINGO_LOG_ERROR LOG_IF(ERROR, DINGO_LOG_IS_ON(ERROR)) << CURRENT_FUNC_NAME
 #define DINGO_LOG_FATAL LOG(FATAL) << CURRENT_FUNC_NAME
 
 #define DINGO_LOG_IF(level, condition) DINGO_LOG_IF_##level(condition)
 
+#ifdef DINGO_LOG_STRIP_DEBUG
+#define DINGO_LOG_IF_DEBUG(condition) while (false) VLOG_IF(DINGO_DEBUG, condition) << CURRENT_FUNC_NAME
+#else
 #define DINGO_LOG_IF_DEBUG(condition) VLOG_IF(DINGO_DEBUG, condition) << CURRENT_FUNC_NAME
-#define DINGO_LOG_IF_INFO(condition) LOG_IF(INFO, condition) << CURRENT_FUNC_NAME
-#define DINGO_LOG_IF_WARNING(condition) LOG_IF(WARNING, condition) << CURRENT_FUNC_NAME
-#define DINGO_LOG_IF_ERROR(condition) LOG_IF(ERROR, condition) << CURRENT_FUNC_NAME
+#endif
+#define DINGO_LOG_IF_INFO(condition) LOG_IF(INFO, (condition) && DINGO_LOG_IS_ON(INFO)) << CURRENT_FUNC_NAME
+#define DINGO_LOG_IF_WARNING(condition) LOG_IF(WARNING, (condition) && DINGO_LOG_IS_ON(WARNING)) << CURRENT_FUNC_NAME
+#define DINGO_LOG_IF_ERROR(condition) LOG_IF(ERROR, (condition) && DINGO_LOG_IS_ON(ERROR)) << CURRENT_FUNC_NAME
 #define DINGO_LOG_IF_FATAL(condition) LOG_IF(FATAL, condition) << CURRENT_FUNC_NAME
 
+// Rate limited log for hot path, every call site has its own limiter.
+// DINGO_LOG_EVERY_N logs the 1st, (n+1)th, (2n+1)th... call.
+#define DINGO_LOG_EVERY_N(level, n)                        \
+  DINGO_LOG_IF(level, ([](int64_t v) {                     \
+                 static ::dingodb::LogRateLimiter limiter; \
+                 return limiter.AllowEveryN(v);            \
+               })(n))
+// DINGO_LOG_EVERY_SECOND logs at most once every seconds.
+#define DINGO_LOG_EVERY_SECOND(level, seconds)             \
+  DINGO_LOG_IF(level, ([](int64_t v) {                     \
+                 static ::dingodb::LogRateLimiter limiter; \
+                 return limiter.AllowEverySeconds(v);      \
+               })(seconds))
+
+class LogRateLimiter {
+ public:
+  bool AllowEveryN(int64_t n);
+  bool AllowEverySeconds(int64_t seconds);
+
+ private:
+  std::atomic<int64_t> count_{0};
+  std::atomic<int64_t> next_time_us_{0};
+};
+
 class DingoLogger {
  public:
   static void InitLogger(const std::string& log_dir, const std::string& role, const pb::node::LogLevel& level);
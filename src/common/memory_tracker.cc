@@ -0,0 +1,109 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/memory_tracker.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "butil/status.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DEFINE_int64(memory_budget_total_bytes, 0, "memory budget of all subsystems, 0 is unlimited");
+DEFINE_int64(memory_budget_vector_index_bytes, 0, "memory budget of vector index, 0 is unlimited");
+DEFINE_int64(memory_budget_scan_context_bytes, 0, "memory budget of scan context, 0 is unlimited");
+
+MemoryTracker& MemoryTracker::GetInstance() {
+  static MemoryTracker instance;
+  return instance;
+}
+
+static int64_t GetUsage(void* arg) { return static_cast<std::atomic<int64_t>*>(arg)->load(); }
+
+static int64_t GetTotalUsage(void* arg) { return static_cast<MemoryTracker*>(arg)->TotalUsage(); }
+
+MemoryTracker::MemoryTracker() : bvar_total_usage_("dingo_memory_tracker_total_bytes", GetTotalUsage, this) {
+  for (int i = 0; i < static_cast<int>(Type::kMax); ++i) {
+    usages_[i].store(0);
+    bvar_usages_[i] = std::make_unique<bvar::PassiveStatus<int64_t>>(
+        fmt::format("dingo_memory_tracker_{}_bytes", TypeName(static_cast<Type>(i))), GetUsage, &usages_[i]);
+  }
+}
+
+std::string MemoryTracker::TypeName(Type type) {
+  switch (type) {
+    case Type::kVectorIndex:
+      return "vector_index";
+    case Type::kBlockCache:
+      return "block_cache";
+    case Type::kMemtable:
+      return "memtable";
+    case Type::kScanContext:
+      return "scan_context";
+    default:
+      return "unknown";
+  }
+}
+
+void MemoryTracker::Set(Type type, int64_t bytes) { usages_[static_cast<int>(type)].store(bytes); }
+
+void MemoryTracker::Add(Type type, int64_t bytes) { usages_[static_cast<int>(type)].fetch_add(bytes); }
+
+int64_t MemoryTracker::Usage(Type type) const { return usages_[static_cast<int>(type)].load(); }
+
+int64_t MemoryTracker::TotalUsage() const {
+  int64_t total = 0;
+  for (const auto& usage : usages_) {
+    total += usage.load();
+  }
+  return total;
+}
+
+int64_t MemoryTracker::Budget(Type type) {
+  switch (type) {
+    case Type::kVectorIndex:
+      return FLAGS_memory_budget_vector_index_bytes;
+    case Type::kScanContext:
+      return FLAGS_memory_budget_scan_context_bytes;
+    default:
+      return 0;
+  }
+}
+
+int64_t MemoryTracker::TotalBudget() { return FLAGS_memory_budget_total_bytes; }
+
+butil::Status MemoryTracker::CheckBudget(Type type, int64_t extra_bytes) const {
+  int64_t budget = Budget(type);
+  int64_t usage = Usage(type);
+  if (budget > 0 && usage + extra_bytes > budget) {
+    return butil::Status(pb::error::ESYSTEM_MEMORY_CAPACITY_FULL, "Memory of %s exceed budget, usage(%ld) budget(%ld)",
+                         TypeName(type).c_str(), usage, budget);
+  }
+
+  int64_t total_budget = TotalBudget();
+  int64_t total_usage = TotalUsage();
+  if (total_budget > 0 && total_usage + extra_bytes > total_budget) {
+    return butil::Status(pb::error::ESYSTEM_MEMORY_CAPACITY_FULL, "Memory exceed total budget, usage(%ld) budget(%ld)",
+                         total_usage, total_budget);
+  }
+
+  return butil::Status();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,71 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_MEMORY_TRACKER_H_
+#define DINGODB_COMMON_MEMORY_TRACKER_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "butil/status.h"
+#include "bvar/passive_status.h"
+
+namespace dingodb {
+
+// Memory accounting by subsystem.
+// The process is the root, every subsystem is a child with its own usage and budget, a budget of 0 is unlimited.
+// Usage of block cache and memtable is owned by rocksdb, so just be refreshed periodically, their size is limited
+// by rocksdb config and only count for the total budget.
+// Exceeding a budget rejects new memory consumers of the subsystem, e.g. loading vector index or creating scan.
+class MemoryTracker {
+ public:
+  enum class Type {
+    kVectorIndex = 0,
+    kBlockCache = 1,
+    kMemtable = 2,
+    kScanContext = 3,
+    kMax = 4,
+  };
+
+  static MemoryTracker& GetInstance();
+
+  static std::string TypeName(Type type);
+
+  void Set(Type type, int64_t bytes);
+  void Add(Type type, int64_t bytes);
+
+  int64_t Usage(Type type) const;
+  int64_t TotalUsage() const;
+
+  // 0 means unlimited.
+  static int64_t Budget(Type type);
+  static int64_t TotalBudget();
+
+  // Check whether consume extra_bytes exceed the budget of type or the total budget.
+  butil::Status CheckBudget(Type type, int64_t extra_bytes) const;
+
+ private:
+  MemoryTracker();
+
+  std::array<std::atomic<int64_t>, static_cast<int>(Type::kMax)> usages_;
+  std::array<std::unique_ptr<bvar::PassiveStatus<int64_t>>, static_cast<int>(Type::kMax)> bvar_usages_;
+  bvar::PassiveStatus<int64_t> bvar_total_usage_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_MEMORY_TRACKER_H_
@@ -0,0 +1,128 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/numa.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "butil/strings/string_split.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_numa_bind, false, "bind index region memory and search workers to numa node");
+
+// From linux/mempolicy.h
+static constexpr int kMpolBind = 2;
+static constexpr unsigned kMpolMfMove = 1 << 1;
+
+static std::string ReadSysfs(const std::string& path) {
+  std::ifstream file(path);
+  std::string line;
+  if (file.is_open()) {
+    std::getline(file, line);
+  }
+  return line;
+}
+
+std::vector<int> Numa::ParseList(const std::string& list) {
+  std::vector<int> result;
+  std::vector<std::string> parts;
+  butil::SplitString(list, ',', &parts);
+  for (const auto& part : parts) {
+    if (part.empty()) {
+      continue;
+    }
+    auto pos = part.find('-');
+    int first = std::atoi(part.substr(0, pos).c_str());
+    int last = pos == std::string::npos ? first : std::atoi(part.substr(pos + 1).c_str());
+    for (int i = first; i <= last; ++i) {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+
+int Numa::NodeNum() {
+  static const int node_num = [] {
+    auto nodes = ParseList(ReadSysfs("/sys/devices/system/node/online"));
+    return nodes.empty() ? 1 : nodes.back() + 1;
+  }();
+  return node_num;
+}
+
+bool Numa::IsEnabled() { return FLAGS_enable_numa_bind && NodeNum() > 1; }
+
+int Numa::NodeOfRegion(int64_t region_id) { return static_cast<int>(region_id % NodeNum()); }
+
+std::vector<int> Numa::NodeCpus(int node) {
+  return ParseList(ReadSysfs(fmt::format("/sys/devices/system/node/node{}/cpulist", node)));
+}
+
+bool Numa::BindCurrentThread(int node) {
+  auto cpus = NodeCpus(node);
+  if (cpus.empty()) {
+    return false;
+  }
+
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &cpu_set);
+  }
+  int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (ret != 0) {
+    DINGO_LOG(WARNING) << fmt::format("[numa] bind thread to node {} failed, ret: {}", node, ret);
+    return false;
+  }
+  return true;
+}
+
+bool Numa::BindMemory(void* addr, size_t size, int node) {
+  if (addr == nullptr || size == 0 || node < 0 || node >= 64) {
+    return false;
+  }
+
+  // mbind need page aligned range, the pages shared with other memory at both ends are skipped.
+  uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  uintptr_t start = (reinterpret_cast<uintptr_t>(addr) + page_size - 1) / page_size * page_size;
+  uintptr_t end = (reinterpret_cast<uintptr_t>(addr) + size) / page_size * page_size;
+  if (start >= end) {
+    return false;
+  }
+
+  unsigned long node_mask = 1UL << node;  // NOLINT
+  long ret = syscall(SYS_mbind, start, end - start, kMpolBind, &node_mask, sizeof(node_mask) * 8, kMpolMfMove);
+  if (ret != 0) {
+    DINGO_LOG(WARNING) << fmt::format("[numa] bind memory to node {} failed, size: {} error: {}", node, end - start,
+                                      errno);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,48 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_NUMA_H_  // NOLINT
+#define DINGODB_COMMON_NUMA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dingodb {
+
+// Numa placement of index regions, the topology is read from sysfs and no libnuma is needed.
+// A region is bound to node region_id % node_num, its index memory is allocated on the node,
+// and its searches run by the workers pinned on the node.
+class Numa {
+ public:
+  // Numa binding is enabled and the machine has more than one node.
+  static bool IsEnabled();
+
+  static int NodeNum();
+  static int NodeOfRegion(int64_t region_id);
+  static std::vector<int> NodeCpus(int node);
+
+  // Pin the current pthread to the cpus of node, must not be called in bthread.
+  static bool BindCurrentThread(int node);
+  // Bind the pages inside [addr, addr + size) to node, the faulted pages are migrated.
+  static bool BindMemory(void* addr, size_t size, int node);
+
+  // Parse the cpu or node list of sysfs, e.g. 0-3,8-11
+  static std::vector<int> ParseList(const std::string& list);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_NUMA_H_  // NOLINT
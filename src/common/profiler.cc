@@ -0,0 +1,219 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/profiler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "bthread/mutex.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+#ifdef BRPC_ENABLE_CPU_PROFILER
+#include "gperftools/profiler.h"
+#endif
+
+#ifdef LINK_TCMALLOC
+#include "gperftools/malloc_extension.h"
+#endif
+
+namespace dingodb {
+
+DEFINE_bool(enable_continuous_profiling, false, "enable periodic cpu profile and heap sample");
+DEFINE_int64(continuous_profiling_interval_s, 600, "interval of continuous profiling");
+DEFINE_int64(continuous_profiling_cpu_duration_s, 6, "cpu profile duration of every continuous profiling");
+DEFINE_string(profiling_path, "./profile", "directory of profile files");
+DEFINE_int32(profiling_max_files, 24, "max kept profile files of every type");
+DEFINE_int64(profiling_max_duration_s, 300, "max duration of on demand profile");
+
+Profiler& Profiler::GetInstance() {
+  static Profiler instance;
+  return instance;
+}
+
+std::string Profiler::TypeName(Type type) {
+  switch (type) {
+    case Type::kCpu:
+      return "cpu";
+    case Type::kHeap:
+      return "heap";
+    case Type::kContention:
+      return "contention";
+    default:
+      return "unknown";
+  }
+}
+
+void Profiler::ContinuousProfilingHandler(void*) {
+  if (!FLAGS_enable_continuous_profiling) {
+    return;
+  }
+
+  auto& profiler = GetInstance();
+  std::string filepath;
+  auto status = profiler.StartProfile(Type::kCpu, FLAGS_continuous_profiling_cpu_duration_s, filepath);
+  if (!status.ok()) {
+    DINGO_LOG(DEBUG) << fmt::format("[profiler] continuous cpu profile skip, {}", status.error_str());
+  }
+
+  status = profiler.DumpHeapProfile(filepath);
+  if (!status.ok()) {
+    DINGO_LOG(DEBUG) << fmt::format("[profiler] continuous heap profile skip, {}", status.error_str());
+  }
+}
+
+std::string Profiler::GenFilepath(Type type) {
+  return fmt::format("{}/{}.{}.prof", FLAGS_profiling_path, TypeName(type), Helper::TimestampMs());
+}
+
+std::vector<std::string> Profiler::ListProfiles(Type type) {
+  auto filenames = Helper::TraverseDirectory(FLAGS_profiling_path, TypeName(type) + ".", true, false);
+  std::sort(filenames.begin(), filenames.end());
+  return filenames;
+}
+
+void Profiler::RemoveOldProfiles(Type type) {
+  auto filenames = ListProfiles(type);
+  int64_t remove_count = static_cast<int64_t>(filenames.size()) - FLAGS_profiling_max_files;
+  for (int64_t i = 0; i < remove_count; ++i) {
+    Helper::RemoveFileOrDirectory(fmt::format("{}/{}", FLAGS_profiling_path, filenames[i]));
+  }
+}
+
+butil::Status Profiler::StartCpuProfile(const std::string& filepath) {
+#ifdef BRPC_ENABLE_CPU_PROFILER
+  if (!ProfilerStart(filepath.c_str())) {
+    return butil::Status(pb::error::EINTERNAL, "Start cpu profiler failed");
+  }
+  return butil::Status();
+#else
+  (void)filepath;
+  return butil::Status(pb::error::EINTERNAL, "Not enable BRPC_ENABLE_CPU_PROFILER");
+#endif
+}
+
+void Profiler::StopCpuProfile() {
+#ifdef BRPC_ENABLE_CPU_PROFILER
+  ProfilerStop();
+#endif
+}
+
+struct ProfileTask {
+  Profiler::Type type;
+  int64_t duration_s;
+  std::string filepath;
+  std::atomic<bool>* running;
+};
+
+butil::Status Profiler::StartProfile(Type type, int64_t duration_s, std::string& filepath) {
+  if (type == Type::kHeap) {
+    return DumpHeapProfile(filepath);
+  }
+  if (duration_s <= 0 || duration_s > FLAGS_profiling_max_duration_s) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param duration_s must be in (0, %ld]",
+                         FLAGS_profiling_max_duration_s);
+  }
+
+  auto status = Helper::CreateDirectories(FLAGS_profiling_path);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // cpu profiler and contention profiler are process wide, only one of each type at the same time.
+  auto* running = type == Type::kCpu ? &cpu_running_ : &contention_running_;
+  bool expected = false;
+  if (!running->compare_exchange_strong(expected, true)) {
+    return butil::Status(pb::error::EINTERNAL, "%s profiler is running", TypeName(type).c_str());
+  }
+
+  filepath = GenFilepath(type);
+  if (type == Type::kCpu) {
+    status = StartCpuProfile(filepath);
+  } else if (!bthread::ContentionProfilerStart(filepath.c_str())) {
+    status = butil::Status(pb::error::EINTERNAL, "Start contention profiler failed");
+  }
+  if (!status.ok()) {
+    running->store(false);
+    return status;
+  }
+
+  auto* task = new ProfileTask{type, duration_s, filepath, running};
+  bthread_t tid;
+  const bthread_attr_t attr = BTHREAD_ATTR_NORMAL;
+  bthread_start_background(
+      &tid, &attr,
+      [](void* arg) -> void* {
+        std::unique_ptr<ProfileTask> task(static_cast<ProfileTask*>(arg));
+        bthread_usleep(task->duration_s * 1000 * 1000);
+
+        if (task->type == Type::kCpu) {
+          StopCpuProfile();
+        } else {
+          bthread::ContentionProfilerStop();
+        }
+        task->running->store(false);
+        GetInstance().RemoveOldProfiles(task->type);
+
+        DINGO_LOG(INFO) << fmt::format("[profiler] {} profile finish, file: {}", TypeName(task->type),
+                                       task->filepath);
+        return nullptr;
+      },
+      task);
+
+  DINGO_LOG(INFO) << fmt::format("[profiler] {} profile start, duration: {}s file: {}", TypeName(type), duration_s,
+                                 filepath);
+
+  return butil::Status();
+}
+
+butil::Status Profiler::DumpHeapProfile(std::string& filepath) {
+#ifdef LINK_TCMALLOC
+  auto status = Helper::CreateDirectories(FLAGS_profiling_path);
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::string sample;
+  MallocExtension::instance()->GetHeapSample(&sample);
+  if (sample.empty()) {
+    return butil::Status(pb::error::EINTERNAL, "Heap sample is empty, maybe not set TCMALLOC_SAMPLE_PARAMETER");
+  }
+
+  filepath = GenFilepath(Type::kHeap);
+  std::ofstream ofile(filepath, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+  if (!ofile.is_open()) {
+    return butil::Status(pb::error::EINTERNAL, "Open file %s failed", filepath.c_str());
+  }
+  ofile << sample;
+  ofile.close();
+
+  RemoveOldProfiles(Type::kHeap);
+
+  return butil::Status();
+#else
+  (void)filepath;
+  return butil::Status(pb::error::EINTERNAL, "No use tcmalloc");
+#endif
+}
+
+}  // namespace dingodb
@@ -0,0 +1,73 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_PROFILER_H_
+#define DINGODB_COMMON_PROFILER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+
+namespace dingodb {
+
+// Profiles are written to profiling_path in pprof format, named {type}.{timestamp}.prof,
+// only the newest profiling_max_files of every type are kept.
+// Continuous profiling takes a cpu profile of continuous_profiling_cpu_duration_s and a heap sample
+// every continuous_profiling_interval_s, e.g. 6s of 600s is 1% of time.
+// cpu profile needs BRPC_ENABLE_CPU_PROFILER, heap sample needs LINK_TCMALLOC with
+// TCMALLOC_SAMPLE_PARAMETER env, bthread contention profile is always available.
+// pprof --collapsed or brpc /hotspots can render the profiles to flame graph.
+class Profiler {
+ public:
+  enum class Type {
+    kCpu,
+    kHeap,
+    kContention,
+  };
+
+  static Profiler& GetInstance();
+
+  // Crontab handler of continuous profiling.
+  static void ContinuousProfilingHandler(void*);
+
+  // Profile in background for duration_s, filepath is written when finished.
+  butil::Status StartProfile(Type type, int64_t duration_s, std::string& filepath);
+
+  // Dump heap sample at once.
+  butil::Status DumpHeapProfile(std::string& filepath);
+
+  // Profile files of type, sorted by time.
+  std::vector<std::string> ListProfiles(Type type);
+
+  static std::string TypeName(Type type);
+
+ private:
+  Profiler() = default;
+
+  std::string GenFilepath(Type type);
+  void RemoveOldProfiles(Type type);
+
+  static butil::Status StartCpuProfile(const std::string& filepath);
+  static void StopCpuProfile();
+
+  std::atomic<bool> cpu_running_{false};
+  std::atomic<bool> contention_running_{false};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_PROFILER_H_
@@ -14,18 +14,33 @@
 
 #include "common/runnable.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <string>
 
 #include "butil/compiler_specific.h"
+#include "butil/time.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/numa.h"
 #include "common/synchronization.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 
 namespace dingodb {
 
+DEFINE_int32(worker_set_steal_queue_capacity, 16384, "Queue capacity of every worker in work stealing worker set");
+DEFINE_int64(worker_set_steal_idle_wait_us, 1000, "Idle worker wait time before next steal in work stealing worker set");
+
+DEFINE_int32(worker_set_lane_default_weight, 4, "Dequeue weight of default lane in prior worker set");
+DEFINE_int32(worker_set_lane_point_read_weight, 8, "Dequeue weight of point read lane in prior worker set");
+DEFINE_int32(worker_set_lane_scan_weight, 2, "Dequeue weight of scan lane in prior worker set");
+DEFINE_int32(worker_set_lane_vector_search_weight, 2, "Dequeue weight of vector search lane in prior worker set");
+DEFINE_int32(worker_set_lane_background_weight, 1, "Dequeue weight of background lane in prior worker set");
+DEFINE_bool(worker_set_drop_expired_task, true, "Drop the task whose deadline passed while queued");
+DEFINE_uint32(worker_set_max_worker_num, 256, "Max worker num of worker set when resize at runtime");
+
 TaskRunnable::TaskRunnable() : id_(GenId()) { create_time_us_ = Helper::TimestampUs(); }
 TaskRunnable::~TaskRunnable() = default;
 
@@ -164,17 +179,75 @@ std::vector<std::string> Worker::GetPendingTaskTrace() {
   return traces;
 }
 
+StealWorker::StealWorker(uint32_t index, uint32_t queue_capacity)
+    : index_(index), stealable_tasks_(queue_capacity), ordered_tasks_(queue_capacity) {
+  bthread_mutex_init(&mutex_, nullptr);
+  bthread_cond_init(&cond_, nullptr);
+}
+
+StealWorker::~StealWorker() {
+  bthread_cond_destroy(&cond_);
+  bthread_mutex_destroy(&mutex_);
+}
+
+bool StealWorker::PushStealable(TaskRunnablePtr task) {
+  if (!stealable_tasks_.TryPush(task)) {
+    return false;
+  }
+  pending_task_count_.fetch_add(1, std::memory_order_relaxed);
+  WakeUp();
+  return true;
+}
+
+bool StealWorker::PushOrdered(TaskRunnablePtr task) {
+  if (!ordered_tasks_.TryPush(task)) {
+    return false;
+  }
+  pending_task_count_.fetch_add(1, std::memory_order_relaxed);
+  WakeUp();
+  return true;
+}
+
+void StealWorker::WakeUp() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (is_sleeping_) {
+    bthread_cond_signal(&cond_);
+  }
+}
+
+void StealWorker::Wait(int64_t timeout_us, const std::function<bool()>& has_task) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  // check again under lock, avoid missing the wake up of new task
+  if (has_task()) {
+    return;
+  }
+
+  is_sleeping_ = true;
+  timespec abstime = butil::microseconds_from_now(timeout_us);
+  bthread_cond_timedwait(&cond_, &mutex_, &abstime);
+  is_sleeping_ = false;
+}
+
 WorkerSet::WorkerSet(std::string name, uint32_t worker_num, int64_t max_pending_task_count)
+    : WorkerSet(name, worker_num, max_pending_task_count, false) {}
+
+WorkerSet::WorkerSet(std::string name, uint32_t worker_num, int64_t max_pending_task_count, bool use_work_stealing)
     : name_(name),
       worker_num_(worker_num),
       max_pending_task_count_(max_pending_task_count),
       active_worker_id_(0),
+      use_work_stealing_(use_work_stealing),
       total_task_count_metrics_(fmt::format("dingo_worker_set_{}_total_task_count", name)),
       pending_task_count_metrics_(fmt::format("dingo_worker_set_{}_pending_task_count", name)) {}
 
 WorkerSet::~WorkerSet() = default;
 
 bool WorkerSet::Init() {
+  if (use_work_stealing_) {
+    return InitStealWorkers();
+  }
+
+  workers_.reserve(std::max(worker_num_.load(), FLAGS_worker_set_max_worker_num));
   for (int i = 0; i < worker_num_; ++i) {
     auto worker = Worker::New([this](WorkerEventType type) { WatchWorker(type); });
     if (!worker->Init()) {
@@ -186,10 +259,127 @@ bool WorkerSet::Init() {
   return true;
 }
 
+bool WorkerSet::Resize(uint32_t worker_num) {
+  if (use_work_stealing_ || worker_num == 0 || worker_num > workers_.capacity()) {
+    DINGO_LOG(WARNING) << fmt::format("[execqueue] not support resize worker set {} to {}, capacity: {}", name_,
+                                      worker_num, workers_.capacity());
+    return false;
+  }
+
+  std::lock_guard lock(resize_mutex_);
+
+  // the workers removed by shrink are reused first
+  while (workers_.size() < worker_num) {
+    auto worker = Worker::New([this](WorkerEventType type) { WatchWorker(type); });
+    if (!worker->Init()) {
+      return false;
+    }
+    workers_.push_back(worker);
+  }
+
+  uint32_t old_worker_num = worker_num_.exchange(worker_num, std::memory_order_release);
+  DINGO_LOG(INFO) << fmt::format("[execqueue] resize worker set {} from {} to {}", name_, old_worker_num, worker_num);
+
+  return true;
+}
+
+bool WorkerSet::InitStealWorkers() {
+  for (uint32_t i = 0; i < worker_num_; ++i) {
+    steal_workers_.push_back(std::make_shared<StealWorker>(i, FLAGS_worker_set_steal_queue_capacity));
+  }
+
+  steal_bthreads_.reserve(worker_num_);
+  for (uint32_t i = 0; i < worker_num_; ++i) {
+    auto worker = steal_workers_[i];
+    steal_bthreads_.emplace_back([this, worker]() { RunStealWorker(worker); });
+  }
+
+  return true;
+}
+
 void WorkerSet::Destroy() {
   for (const auto& worker : workers_) {
     worker->Destroy();
   }
+
+  if (use_work_stealing_) {
+    is_stop_.store(true, std::memory_order_relaxed);
+    for (auto& worker : steal_workers_) {
+      worker->WakeUp();
+    }
+    for (auto& bthread : steal_bthreads_) {
+      bthread.Join();
+    }
+    steal_bthreads_.clear();
+  }
+}
+
+bool WorkerSet::ExecuteSteal(uint32_t index, TaskRunnablePtr task, bool is_ordered) {
+  bool ret = false;
+  if (is_ordered) {
+    ret = steal_workers_[index]->PushOrdered(task);
+  } else {
+    // try other workers when the queue is full
+    for (uint32_t i = 0; i < worker_num_ && !ret; ++i) {
+      ret = steal_workers_[(index + i) % worker_num_]->PushStealable(task);
+    }
+    if (ret) {
+      // the owner maybe busy, let a neighbour have chance to steal it
+      steal_workers_[(index + 1) % worker_num_]->WakeUp();
+    }
+  }
+
+  if (!ret) {
+    DINGO_LOG(WARNING) << fmt::format("[execqueue][type({})] worker queue is full, worker_set: {}", task->Type(),
+                                      name_);
+    return false;
+  }
+
+  IncPendingTaskCount();
+  IncTotalTaskCount();
+  return true;
+}
+
+StealWorker* WorkerSet::StealTask(uint32_t index, TaskRunnablePtr& task) {
+  for (uint32_t i = 1; i < worker_num_; ++i) {
+    auto& victim = steal_workers_[(index + i) % worker_num_];
+    if (victim->PopStealable(task)) {
+      return victim.get();
+    }
+  }
+
+  return nullptr;
+}
+
+void WorkerSet::RunStealWorker(StealWorkerPtr worker) {
+  auto has_task = [this, &worker]() {
+    if (worker->HasTask()) {
+      return true;
+    }
+    for (auto& other : steal_workers_) {
+      if (other->HasTask()) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  while (!is_stop_.load(std::memory_order_relaxed)) {
+    TaskRunnablePtr task;
+    StealWorker* owner = worker.get();
+    // ordered tasks first, then own stealable tasks, last steal from others.
+    if (!worker->PopOrdered(task) && !worker->PopStealable(task)) {
+      owner = StealTask(worker->Index(), task);
+      if (owner == nullptr) {
+        worker->Wait(FLAGS_worker_set_steal_idle_wait_us, has_task);
+        continue;
+      }
+    }
+
+    task->Run();
+    owner->DecPendingTaskCount();
+    DecPendingTaskCount();
+  }
 }
 
 bool WorkerSet::ExecuteRR(TaskRunnablePtr task) {
@@ -200,6 +390,10 @@ bool WorkerSet::ExecuteRR(TaskRunnablePtr task) {
     return false;
   }
 
+  if (use_work_stealing_) {
+    return ExecuteSteal(active_worker_id_.fetch_add(1) % worker_num_, task, false);
+  }
+
   auto ret = workers_[active_worker_id_.fetch_add(1) % worker_num_]->Execute(task);
   if (ret) {
     IncPendingTaskCount();
@@ -217,6 +411,10 @@ bool WorkerSet::ExecuteLeastQueue(TaskRunnablePtr task) {
     return false;
   }
 
+  if (use_work_stealing_) {
+    return ExecuteSteal(LeastPendingTaskWorker(), task, false);
+  }
+
   auto ret = workers_[LeastPendingTaskWorker()]->Execute(task);
   if (ret) {
     IncPendingTaskCount();
@@ -234,6 +432,10 @@ bool WorkerSet::ExecuteHashByRegionId(int64_t region_id, TaskRunnablePtr task) {
     return false;
   }
 
+  if (use_work_stealing_) {
+    return ExecuteSteal(region_id % worker_num_, task, true);
+  }
+
   auto ret = workers_[region_id % worker_num_]->Execute(task);
   if (ret) {
     IncPendingTaskCount();
@@ -252,10 +454,10 @@ void WorkerSet::WatchWorker(WorkerEventType type) {
 uint32_t WorkerSet::LeastPendingTaskWorker() {
   uint32_t index = 0;
   int32_t min_pending_count = INT32_MAX;
-  uint32_t worker_num = workers_.size();
+  uint32_t worker_num = use_work_stealing_ ? steal_workers_.size() : worker_num_.load(std::memory_order_acquire);
   for (uint32_t i = 0; i < worker_num; ++i) {
-    auto& worker = workers_[i];
-    int32_t pending_count = worker->PendingTaskCount();
+    int32_t pending_count =
+        use_work_stealing_ ? steal_workers_[i]->PendingTaskCount() : workers_[i]->PendingTaskCount();
     if (pending_count < min_pending_count) {
       min_pending_count = pending_count;
       index = i;
@@ -300,9 +502,19 @@ PriorWorkerSet::PriorWorkerSet(std::string name, uint32_t worker_num, int64_t ma
       total_task_count_metrics_(fmt::format("dingo_prior_worker_set_{}_total_task_count", name)),
       pending_task_count_metrics_(fmt::format("dingo_prior_worker_set_{}_pending_task_count", name)),
       queue_wait_metrics_(fmt::format("dingo_prior_worker_set_{}_queue_wait_latency", name)),
-      queue_run_metrics_(fmt::format("dingo_prior_worker_set_{}_queue_run_latency", name)) {
+      queue_run_metrics_(fmt::format("dingo_prior_worker_set_{}_queue_run_latency", name)),
+      expired_task_count_metrics_(fmt::format("dingo_prior_worker_set_{}_expired_task_count", name)) {
   bthread_mutex_init(&mutex_, nullptr);
   bthread_cond_init(&cond_, nullptr);
+
+  lane_tasks_.resize(kTaskLaneNum);
+  lane_weights_ = {FLAGS_worker_set_lane_default_weight, FLAGS_worker_set_lane_point_read_weight,
+                   FLAGS_worker_set_lane_scan_weight, FLAGS_worker_set_lane_vector_search_weight,
+                   FLAGS_worker_set_lane_background_weight};
+  for (auto& weight : lane_weights_) {
+    weight = std::max(weight, static_cast<int64_t>(1));
+  }
+  lane_current_weights_.resize(kTaskLaneNum, 0);
 }
 
 PriorWorkerSet::~PriorWorkerSet() {
@@ -311,55 +523,112 @@ PriorWorkerSet::~PriorWorkerSet() {
 }
 
 bool PriorWorkerSet::Init() {
-  uint32_t i = 0;
+  AddWorkers(worker_num_.load());
 
-  auto worker_function = [this, &i]() {
+  return true;
+}
+
+void PriorWorkerSet::AddWorkers(uint32_t worker_num) {
+  uint32_t start = use_pthread_ ? pthread_workers_.size() : bthread_workers_.size();
+  for (uint32_t i = start; i < worker_num; ++i) {
     if (use_pthread_) {
-      pthread_setname_np(pthread_self(), (name_ + ":" + std::to_string(i)).c_str());
+      pthread_workers_.push_back(std::thread([this, i]() { RunWorker(i); }));
+    } else {
+      bthread_workers_.push_back(Bthread([this, i]() { RunWorker(i); }));
     }
+  }
+}
 
-    while (true) {
-      bthread_mutex_lock(&mutex_);
-      while (pending_task_count_.load(std::memory_order_relaxed) == 0) {
-        bthread_cond_wait(&cond_, &mutex_);
-      }
+void PriorWorkerSet::RunWorker(uint32_t index) {
+  if (use_pthread_) {
+    pthread_setname_np(pthread_self(), (name_ + ":" + std::to_string(index)).c_str());
+    if (numa_node_ >= 0) {
+      Numa::BindCurrentThread(numa_node_);
+    }
+  }
 
-      // get task from task queue
-      TaskRunnablePtr task = nullptr;
-      int64_t now_time_us = 0;
-      if (!tasks_.empty()) {
-        task = tasks_.top();
-        tasks_.pop();
+  while (true) {
+    bthread_mutex_lock(&mutex_);
+    while (pending_task_count_.load(std::memory_order_relaxed) == 0 &&
+           index < worker_num_.load(std::memory_order_relaxed)) {
+      bthread_cond_wait(&cond_, &mutex_);
+    }
 
-        now_time_us = Helper::TimestampUs();
-        queue_wait_metrics_ << now_time_us - task->CreateTimeUs();
+    if (index >= worker_num_.load(std::memory_order_relaxed)) {
+      // the signal maybe for a task, pass it to the remained workers
+      if (pending_task_count_.load(std::memory_order_relaxed) > 0) {
+        bthread_cond_signal(&cond_);
       }
-
       bthread_mutex_unlock(&mutex_);
+      return;
+    }
 
-      if (BAIDU_UNLIKELY(task != nullptr)) {
+    // get task from task queue
+    TaskRunnablePtr task = PopTask();
+    int64_t now_time_us = 0;
+    if (task != nullptr) {
+      now_time_us = Helper::TimestampUs();
+      queue_wait_metrics_ << now_time_us - task->CreateTimeUs();
+    }
+
+    bthread_mutex_unlock(&mutex_);
+
+    if (BAIDU_UNLIKELY(task != nullptr)) {
+      if (FLAGS_worker_set_drop_expired_task && task->DeadlineUs() > 0 && now_time_us > task->DeadlineUs()) {
+        // the client has given up, don't waste worker on it
+        expired_task_count_metrics_ << 1;
+        task->Expire();
+      } else {
         task->Run();
         queue_run_metrics_ << Helper::TimestampUs() - now_time_us;
-        DecPendingTaskCount();
-        Notify(WorkerEventType::kFinishTask);
       }
+      DecPendingTaskCount();
+      Notify(WorkerEventType::kFinishTask);
     }
-  };
+  }
+}
 
-  if (use_pthread_) {
-    for (i = 0; i < worker_num_; ++i) {
-      pthread_workers_.push_back(std::thread(worker_function));
-    }
+bool PriorWorkerSet::Resize(uint32_t worker_num) {
+  if (worker_num == 0) {
+    return false;
+  }
+
+  std::lock_guard lock(resize_mutex_);
+
+  bthread_mutex_lock(&mutex_);
+  uint32_t old_worker_num = worker_num_.exchange(worker_num, std::memory_order_relaxed);
+  bthread_cond_broadcast(&cond_);
+  bthread_mutex_unlock(&mutex_);
+
+  if (worker_num > old_worker_num) {
+    AddWorkers(worker_num);
   } else {
-    for (i = 0; i < worker_num_; ++i) {
-      bthread_workers_.push_back(Bthread(worker_function));
+    // drain, the removed workers finish their running task
+    if (use_pthread_) {
+      for (uint32_t i = worker_num; i < pthread_workers_.size(); ++i) {
+        pthread_workers_[i].join();
+      }
+      pthread_workers_.resize(worker_num);
+    } else {
+      for (uint32_t i = worker_num; i < bthread_workers_.size(); ++i) {
+        bthread_workers_[i].Join();
+      }
+      bthread_workers_.resize(worker_num);
     }
   }
 
+  DINGO_LOG(INFO) << fmt::format("[execqueue] resize prior worker set {} from {} to {}", name_, old_worker_num,
+                                 worker_num);
+
   return true;
 }
 
 void PriorWorkerSet::Destroy() {
+  bthread_mutex_lock(&mutex_);
+  worker_num_.store(0, std::memory_order_relaxed);
+  bthread_cond_broadcast(&cond_);
+  bthread_mutex_unlock(&mutex_);
+
   if (use_pthread_) {
     for (auto& std_thread : pthread_workers_) {
       std_thread.join();
@@ -384,13 +653,37 @@ bool PriorWorkerSet::Execute(TaskRunnablePtr task) {
   IncTotalTaskCount();
 
   bthread_mutex_lock(&mutex_);
-  tasks_.push(task);
+  lane_tasks_[static_cast<int>(task->Lane())].push(task);
   bthread_cond_signal(&cond_);
   bthread_mutex_unlock(&mutex_);
 
   return true;
 }
 
+TaskRunnablePtr PriorWorkerSet::PopTask() {
+  int select_lane = -1;
+  int64_t total_weight = 0;
+  for (int i = 0; i < kTaskLaneNum; ++i) {
+    if (lane_tasks_[i].empty()) {
+      continue;
+    }
+    lane_current_weights_[i] += lane_weights_[i];
+    total_weight += lane_weights_[i];
+    if (select_lane == -1 || lane_current_weights_[i] > lane_current_weights_[select_lane]) {
+      select_lane = i;
+    }
+  }
+
+  if (select_lane == -1) {
+    return nullptr;
+  }
+
+  lane_current_weights_[select_lane] -= total_weight;
+  auto task = lane_tasks_[select_lane].top();
+  lane_tasks_[select_lane].pop();
+  return task;
+}
+
 bool PriorWorkerSet::ExecuteRR(TaskRunnablePtr task) { return Execute(task); }
 
 bool PriorWorkerSet::ExecuteLeastQueue(TaskRunnablePtr task) { return Execute(task); }
@@ -20,6 +20,7 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
 #include <thread>
@@ -32,6 +33,17 @@
 
 namespace dingodb {
 
+// Admission lane of task, every lane has its own queue and weight in PriorWorkerSet.
+enum class TaskLane : uint8_t {
+  kDefault = 0,
+  kPointRead = 1,
+  kScan = 2,
+  kVectorSearch = 3,
+  kBackground = 4,
+};
+
+constexpr int kTaskLaneNum = 5;
+
 class TaskRunnable {
  public:
   TaskRunnable();
@@ -57,17 +69,34 @@ class TaskRunnable {
 
   int64_t CreateTimeUs() const { return create_time_us_; }
 
+  TaskLane Lane() const { return lane_; }
+  void SetLane(TaskLane lane) { lane_ = lane; }
+
+  // 0 means no deadline
+  int64_t DeadlineUs() const { return deadline_us_; }
+  void SetDeadlineUs(int64_t deadline_us) { deadline_us_ = deadline_us; }
+
+  // called instead of Run when the deadline passed while queued
+  virtual void Expire() {}
+
  private:
   uint64_t id_{0};
   int32_t priority_{0};
   int64_t create_time_us_{0};
+  TaskLane lane_{TaskLane::kDefault};
+  int64_t deadline_us_{0};
 };
 
 using TaskRunnablePtr = std::shared_ptr<TaskRunnable>;
 
-// Custom Comparator for priority_queue
+// Custom Comparator for priority_queue, the top is the highest priority task, the earlier one if same priority.
 struct CompareTaskRunnable {
-  bool operator()(const TaskRunnablePtr& lhs, TaskRunnablePtr& rhs) const { return lhs.get() < rhs.get(); }
+  bool operator()(const TaskRunnablePtr& lhs, const TaskRunnablePtr& rhs) const {
+    if (lhs->Priority() != rhs->Priority()) {
+      return lhs->Priority() < rhs->Priority();
+    }
+    return lhs->Id() > rhs->Id();
+  }
 };
 
 int ExecuteRoutine(void*, bthread::TaskIterator<TaskRunnablePtr>& iter);
@@ -125,18 +154,152 @@ class Worker {
 
 using WorkerPtr = std::shared_ptr<Worker>;
 
+// Bounded lock-free multi-producer multi-consumer queue, Dmitry Vyukov's algorithm.
+template <typename T>
+class MPMCQueue {
+ public:
+  explicit MPMCQueue(uint32_t capacity) {
+    // round up to power of 2
+    capacity_ = 2;
+    while (capacity_ < capacity) {
+      capacity_ <<= 1;
+    }
+    mask_ = capacity_ - 1;
+    cells_ = std::make_unique<Cell[]>(capacity_);
+    for (uint64_t i = 0; i < capacity_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+  ~MPMCQueue() = default;
+
+  MPMCQueue(const MPMCQueue&) = delete;
+  MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+  bool TryPush(T value) {
+    Cell* cell = nullptr;
+    uint64_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      uint64_t seq = cell->sequence.load(std::memory_order_acquire);
+      int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // full
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+
+    cell->value = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool TryPop(T& value) {
+    Cell* cell = nullptr;
+    uint64_t pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      uint64_t seq = cell->sequence.load(std::memory_order_acquire);
+      int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos + 1);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // empty
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+
+    value = std::move(cell->value);
+    cell->value = T();
+    cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Empty() const { return head_.load(std::memory_order_acquire) >= tail_.load(std::memory_order_acquire); }
+
+ private:
+  struct Cell {
+    std::atomic<uint64_t> sequence;
+    T value;
+  };
+
+  uint64_t capacity_;
+  uint64_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+
+  alignas(64) std::atomic<uint64_t> head_{0};
+  alignas(64) std::atomic<uint64_t> tail_{0};
+};
+
+// Worker of work stealing WorkerSet.
+// The stealable tasks can be taken by any idle worker, the ordered tasks only run by owner in FIFO order.
+class StealWorker {
+ public:
+  StealWorker(uint32_t index, uint32_t queue_capacity);
+  ~StealWorker();
+
+  uint32_t Index() const { return index_; }
+
+  bool PushStealable(TaskRunnablePtr task);
+  bool PushOrdered(TaskRunnablePtr task);
+
+  bool PopOrdered(TaskRunnablePtr& task) { return ordered_tasks_.TryPop(task); }
+  // called by owner or thief
+  bool PopStealable(TaskRunnablePtr& task) { return stealable_tasks_.TryPop(task); }
+  bool HasTask() const { return !ordered_tasks_.Empty() || !stealable_tasks_.Empty(); }
+
+  int32_t PendingTaskCount() { return pending_task_count_.load(std::memory_order_relaxed); }
+  void DecPendingTaskCount() { pending_task_count_.fetch_sub(1, std::memory_order_relaxed); }
+
+  void WakeUp();
+  // sleep until wake up or timeout, skip sleep if has_task return true.
+  void Wait(int64_t timeout_us, const std::function<bool()>& has_task);
+
+ private:
+  uint32_t index_;
+  MPMCQueue<TaskRunnablePtr> stealable_tasks_;
+  MPMCQueue<TaskRunnablePtr> ordered_tasks_;
+  std::atomic<int32_t> pending_task_count_{0};
+
+  bthread_mutex_t mutex_;
+  bthread_cond_t cond_;
+  bool is_sleeping_{false};
+};
+
+using StealWorkerPtr = std::shared_ptr<StealWorker>;
+
 class WorkerSet {
  public:
   WorkerSet(std::string name, uint32_t worker_num, int64_t max_pending_task_count);
+  WorkerSet(std::string name, uint32_t worker_num, int64_t max_pending_task_count, bool use_work_stealing);
   ~WorkerSet();
 
   static std::shared_ptr<WorkerSet> New(std::string name, uint32_t worker_num, uint32_t max_pending_task_count) {
     return std::make_shared<WorkerSet>(name, worker_num, max_pending_task_count);
   }
+  // idle workers steal the tasks of busy workers, tasks of ExecuteHashByRegionId are not stolen to keep order.
+  static std::shared_ptr<WorkerSet> New(std::string name, uint32_t worker_num, uint32_t max_pending_task_count,
+                                        bool use_work_stealing) {
+    return std::make_shared<WorkerSet>(name, worker_num, max_pending_task_count, use_work_stealing);
+  }
 
   bool Init();
   void Destroy();
 
+  // Change the worker num at runtime, up to worker_set_max_worker_num, not support work stealing.
+  // The removed workers are not destroyed, they finish the queued tasks and wait for next grow.
+  // Tasks of ExecuteHashByRegionId keep order only if they are executed after the resize.
+  bool Resize(uint32_t worker_num);
+
   bool ExecuteRR(TaskRunnablePtr task);
   bool ExecuteLeastQueue(TaskRunnablePtr task);
   bool ExecuteHashByRegionId(int64_t region_id, TaskRunnablePtr task);
@@ -155,12 +318,26 @@ class WorkerSet {
  private:
   uint32_t LeastPendingTaskWorker();
 
+  bool InitStealWorkers();
+  bool ExecuteSteal(uint32_t index, TaskRunnablePtr task, bool is_ordered);
+  void RunStealWorker(StealWorkerPtr worker);
+  // return the victim worker, nullptr if no task stolen.
+  StealWorker* StealTask(uint32_t index, TaskRunnablePtr& task);
+
   const std::string name_;
   int64_t max_pending_task_count_;
-  uint32_t worker_num_;
+  std::atomic<uint32_t> worker_num_;
+  // reserved capacity, never reallocated, the first worker_num_ workers are used.
   std::vector<WorkerPtr> workers_;
+  std::mutex resize_mutex_;
   std::atomic<uint64_t> active_worker_id_;
 
+  // work stealing mode
+  bool use_work_stealing_{false};
+  std::atomic<bool> is_stop_{false};
+  std::vector<StealWorkerPtr> steal_workers_;
+  std::vector<Bthread> steal_bthreads_;
+
   std::atomic<int64_t> pending_task_count_{0};
 
   // Metrics
@@ -180,9 +357,16 @@ class PriorWorkerSet {
     return std::make_shared<PriorWorkerSet>(name, worker_num, max_pending_task_count, use_pthead);
   }
 
+  // Pin the pthread workers to the numa node, must be called before Init.
+  void SetNumaNode(int numa_node) { numa_node_ = numa_node; }
+
   bool Init();
   void Destroy();
 
+  // Change the worker num at runtime, the removed workers exit after their running task finished,
+  // it waits for them.
+  bool Resize(uint32_t worker_num);
+
   bool Execute(TaskRunnablePtr task);
   bool ExecuteRR(TaskRunnablePtr task);
   bool ExecuteLeastQueue(TaskRunnablePtr task);
@@ -202,18 +386,30 @@ class PriorWorkerSet {
   void Notify(WorkerEventType type);
 
  private:
+  // pick the lane by smooth weighted round robin, must hold mutex_
+  TaskRunnablePtr PopTask();
+
+  // start workers until worker_num, must hold resize_mutex_ or in Init
+  void AddWorkers(uint32_t worker_num);
+  // the worker exits when its index is not less than worker_num_
+  void RunWorker(uint32_t index);
+
   const std::string name_;
 
   bthread_mutex_t mutex_;
   bthread_cond_t cond_;
-  std::priority_queue<TaskRunnablePtr, std::vector<TaskRunnablePtr>, CompareTaskRunnable> tasks_;
+  std::vector<std::priority_queue<TaskRunnablePtr, std::vector<TaskRunnablePtr>, CompareTaskRunnable>> lane_tasks_;
+  std::vector<int64_t> lane_weights_;
+  std::vector<int64_t> lane_current_weights_;
 
   bool use_pthread_;
+  int numa_node_{-1};
   std::vector<Bthread> bthread_workers_;
   std::vector<std::thread> pthread_workers_;
 
   int64_t max_pending_task_count_;
-  uint32_t worker_num_;
+  std::atomic<uint32_t> worker_num_;
+  std::mutex resize_mutex_;
 
   std::atomic<int64_t> pending_task_count_{0};
 
@@ -225,6 +421,7 @@ class PriorWorkerSet {
   bvar::Adder<int64_t> pending_task_count_metrics_;
   bvar::LatencyRecorder queue_wait_metrics_;
   bvar::LatencyRecorder queue_run_metrics_;
+  bvar::Adder<uint64_t> expired_task_count_metrics_;
 };
 
 using PriorWorkerSetPtr = std::shared_ptr<PriorWorkerSet>;
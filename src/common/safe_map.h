@@ -15,9 +15,12 @@
 #ifndef DINGODB_COMMON_SAFE_MAP_H_
 #define DINGODB_COMMON_SAFE_MAP_H_
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <set>
 #include <utility>
 #include <vector>
@@ -478,6 +481,286 @@ class DingoSafeMap {
   TypeSafeMap safe_map;
 };
 
+// Implement a sharded ThreadSafeMap for read-mostly hot paths, e.g. region lookup.
+// Every shard is a DingoSafeMap, so reads are still served from the doubly buffered
+// data without any lock held by writers, while a writer only switches the buffer of
+// the shard which owns the key. Modifies of keys in different shards run in parallel
+// and only the readers of the same shard wait for the writer to finish switching.
+// Notice: Must call Init(capacity) before use, the capacity is split among the shards.
+// the return value of the member functions is the same as DingoSafeMap.
+template <typename T_KEY, typename T_VALUE, size_t SHARD_NUM = 32, typename T_HASH = std::hash<T_KEY>>
+class DingoShardedSafeMap {
+  static_assert(SHARD_NUM > 0, "shard num must be greater than 0");
+
+ public:
+  using TypeShardMap = DingoSafeMap<T_KEY, T_VALUE>;
+  using TypeRawMap = typename TypeShardMap::TypeRawMap;
+
+  DingoShardedSafeMap() = default;
+  DingoShardedSafeMap(const DingoShardedSafeMap &) = delete;
+  ~DingoShardedSafeMap() = default;
+
+  void Init(int64_t capacity) {
+    for (auto &shard : shards_) {
+      shard.Init(ShardCapacity(capacity));
+    }
+  }
+  void Resize(int64_t capacity) {
+    for (auto &shard : shards_) {
+      shard.Resize(ShardCapacity(capacity));
+    }
+  }
+
+  static constexpr size_t ShardNum() { return SHARD_NUM; }
+
+  // Get
+  // get value by key
+  int Get(const T_KEY &key, T_VALUE &value) { return Shard(key).Get(key, value); }
+
+  // multi-get value by key
+  int MultiGet(const std::vector<T_KEY> &keys, std::vector<T_VALUE> &values, std::vector<bool> &exists) {
+    for (const auto &key : keys) {
+      T_VALUE value;
+      int ret = Shard(key).Get(key, value);
+      values.push_back(value);
+      exists.push_back(ret > 0);
+    }
+
+    return 1;
+  }
+
+  // Get
+  // get value by key
+  T_VALUE Get(const T_KEY &key) { return Shard(key).Get(key); }
+
+  // GetAllKeys
+  // get all keys of the map
+  int GetAllKeys(std::vector<T_KEY> &keys) {
+    for (auto &shard : shards_) {
+      if (shard.GetAllKeys(keys) < 0) {
+        return -1;
+      }
+    }
+
+    return keys.size();
+  }
+
+  // GetAllKeys
+  // get all keys of the map
+  int GetAllKeys(std::set<T_KEY> &keys, std::function<bool(T_VALUE)> filter = nullptr) {
+    for (auto &shard : shards_) {
+      if (shard.GetAllKeys(keys, filter) < 0) {
+        return -1;
+      }
+    }
+
+    return keys.size();
+  }
+
+  // GetAllValues
+  // get all values of the map
+  int GetAllValues(std::vector<T_VALUE> &values, std::function<bool(T_VALUE)> filter = nullptr) {
+    for (auto &shard : shards_) {
+      if (shard.GetAllValues(values, filter) < 0) {
+        return -1;
+      }
+    }
+
+    return values.size();
+  }
+
+  // GetAllKeyValues
+  // get all keys and values of the map
+  int GetAllKeyValues(std::vector<T_KEY> &keys, std::vector<T_VALUE> &values,
+                      std::function<bool(T_VALUE)> filter = nullptr) {
+    for (auto &shard : shards_) {
+      if (shard.GetAllKeyValues(keys, values, filter) < 0) {
+        return -1;
+      }
+    }
+
+    return keys.size();
+  }
+
+  int GetAllKeyValues(std::map<T_KEY, T_VALUE> &key_value_map, std::function<bool(T_VALUE)> filter = nullptr) {
+    for (auto &shard : shards_) {
+      if (shard.GetAllKeyValues(key_value_map, filter) < 0) {
+        return -1;
+      }
+    }
+
+    return key_value_map.size();
+  }
+
+  // Exists
+  // check if the key exists in the safe map
+  bool Exists(const T_KEY &key) { return Shard(key).Exists(key); }
+
+  // SafeExists
+  // check if the key exists in the safe map
+  int SafeExists(const T_KEY &key, bool &exists) { return Shard(key).SafeExists(key, exists); }
+
+  // Size
+  // return the record count of map
+  int64_t Size() {
+    int64_t size = 0;
+    for (auto &shard : shards_) {
+      size += shard.Size();
+    }
+    return size;
+  }
+
+  // MemorySize
+  // return the memory size of map
+  int64_t MemorySize() {
+    int64_t size = 0;
+    for (auto &shard : shards_) {
+      size += shard.MemorySize();
+    }
+    return size;
+  }
+
+  // Copy
+  // copy the map with FlatMap input_map, every shard is replaced at once
+  int CopyFromRawMap(const TypeRawMap &input_map) {
+    std::vector<TypeRawMap> shard_maps(SHARD_NUM);
+    for (auto &shard_map : shard_maps) {
+      if (shard_map.init(ShardCapacity(input_map.size())) != 0) {
+        return -1;
+      }
+    }
+    for (typename TypeRawMap::const_iterator it = input_map.begin(); it != input_map.end(); ++it) {
+      shard_maps[ShardIndex(it->first)].insert(it->first, it->second);
+    }
+
+    for (size_t i = 0; i < SHARD_NUM; ++i) {
+      if (shards_[i].CopyFromRawMap(shard_maps[i]) < 0) {
+        return -1;
+      }
+    }
+
+    return 1;
+  }
+
+  // GetRawMapCopy
+  // get a copy of all shards
+  // the out_map must be initialized before call this function
+  int GetRawMapCopy(TypeRawMap &out_map) {
+    std::vector<T_KEY> keys;
+    std::vector<T_VALUE> values;
+    if (GetAllKeyValues(keys, values) < 0) {
+      return -1;
+    }
+
+    out_map.clear();
+    for (size_t i = 0; i < keys.size(); ++i) {
+      out_map.insert(keys[i], values[i]);
+    }
+    return 1;
+  }
+
+  // Put
+  // put key-value pair into map
+  int Put(const T_KEY &key, const T_VALUE &value) { return Shard(key).Put(key, value); }
+
+  // MultiPut
+  // put key-value pairs into map
+  int MultiPut(const std::vector<T_KEY> &key_list, const std::vector<T_VALUE> &value_list) {
+    if (key_list.empty() || key_list.size() != value_list.size()) {
+      return -1;
+    }
+
+    std::vector<std::vector<T_KEY>> key_lists(SHARD_NUM);
+    std::vector<std::vector<T_VALUE>> value_lists(SHARD_NUM);
+    for (size_t i = 0; i < key_list.size(); ++i) {
+      size_t index = ShardIndex(key_list[i]);
+      key_lists[index].push_back(key_list[i]);
+      value_lists[index].push_back(value_list[i]);
+    }
+
+    int ret = 1;
+    for (size_t i = 0; i < SHARD_NUM; ++i) {
+      if (!key_lists[i].empty() && shards_[i].MultiPut(key_lists[i], value_lists[i]) < 0) {
+        ret = -1;
+      }
+    }
+    return ret;
+  }
+
+  // MultiErase
+  // erase multi keys
+  int MultiErase(const std::vector<T_KEY> &key_list) {
+    if (key_list.empty()) {
+      return -1;
+    }
+
+    std::vector<std::vector<T_KEY>> key_lists(SHARD_NUM);
+    for (const auto &key : key_list) {
+      key_lists[ShardIndex(key)].push_back(key);
+    }
+
+    int ret = 1;
+    for (size_t i = 0; i < SHARD_NUM; ++i) {
+      if (!key_lists[i].empty() && shards_[i].MultiErase(key_lists[i]) < 0) {
+        ret = -1;
+      }
+    }
+    return ret;
+  }
+
+  // PutIfExists
+  // put key-value pair into map if key exists
+  int PutIfExists(const T_KEY &key, const T_VALUE &value) { return Shard(key).PutIfExists(key, value); }
+
+  // PutIfAbsent
+  // put key-value pair into map if key not exists
+  int PutIfAbsent(const T_KEY &key, const T_VALUE &value) { return Shard(key).PutIfAbsent(key, value); }
+
+  // PutIfEqual
+  // put key-value pair into map if key exists and value equals
+  int PutIfEqual(const T_KEY &key, const T_VALUE &value) { return Shard(key).PutIfEqual(key, value); }
+
+  // PutIfNotEqual
+  // put key-value pair into map if key exists and value not equals
+  int PutIfNotEqual(const T_KEY &key, const T_VALUE &value) { return Shard(key).PutIfNotEqual(key, value); }
+
+  // Erase
+  // erase key-value pair from map
+  int Erase(const T_KEY &key) { return Shard(key).Erase(key); }
+
+  // Clear
+  // erase all key-value pairs from map
+  int Clear() {
+    int ret = 1;
+    for (auto &shard : shards_) {
+      if (shard.Clear() < 0) {
+        ret = -1;
+      }
+    }
+    return ret;
+  }
+
+ private:
+  static int64_t ShardCapacity(int64_t capacity) {
+    return std::max(static_cast<int64_t>(capacity / SHARD_NUM), static_cast<int64_t>(kMinShardCapacity));
+  }
+
+  static size_t ShardIndex(const T_KEY &key) {
+    // mix the hash value, std::hash of integer is identity and the ids are usually continuous.
+    uint64_t hash = static_cast<uint64_t>(T_HASH()(key));
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash % SHARD_NUM;
+  }
+
+  TypeShardMap &Shard(const T_KEY &key) { return shards_[ShardIndex(key)]; }
+
+  static constexpr int64_t kMinShardCapacity = 8;
+
+  std::array<TypeShardMap, SHARD_NUM> shards_;
+};
+
 // Implement a ThreadSafeMap
 // Notice: Must call Init(capacity) before use
 // all membber functions except Size(), MemorySize() return 1 if success, return -1 if failed
@@ -735,9 +1018,10 @@ class DingoSafeStdMap {
 
   // FinIntervalValues
   // The real range is [lower_bound, upper_bound)
+  // limit: stop after limit values are found, 0 means no limit
   int FindIntervalValues(std::vector<T_VALUE> &values, T_KEY lower_bound, T_KEY upper_bound,
-                         std::function<bool(T_KEY)> key_filter = nullptr,
-                         std::function<bool(T_VALUE)> value_filter = nullptr) {
+                         std::function<bool(const T_KEY &)> key_filter = nullptr,
+                         std::function<bool(const T_VALUE &)> value_filter = nullptr, int64_t limit = 0) {
     TypeScopedPtr ptr;
     if (safe_map.Read(&ptr) != 0) {
       return -1;
@@ -775,8 +1059,11 @@ class DingoSafeStdMap {
         if (it->first >= upper_bound) {
           break;
         }
-        if ((key_filter == nullptr || key_filter(it->first)) & (value_filter == nullptr || value_filter(it->second))) {
+        if ((key_filter == nullptr || key_filter(it->first)) && (value_filter == nullptr || value_filter(it->second))) {
           values.push_back(it->second);
+          if (limit > 0 && static_cast<int64_t>(values.size()) >= limit) {
+            break;
+          }
         }
       }
 
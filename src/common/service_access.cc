@@ -158,6 +158,36 @@ std::vector<pb::node::RaftStatusEntry> ServiceAccess::GetRaftStatus(std::vector<
   return Helper::PbRepeatedToVector(response.entries());
 }
 
+butil::Status ServiceAccess::ReadIndex(int64_t region_id, const butil::EndPoint& endpoint, int64_t timeout_ms,
+                                       int64_t& read_index) {
+  auto channel = ChannelPool::GetInstance().GetChannel(endpoint);
+  if (channel == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Get channel failed, endpoint: %s",
+                         Helper::EndPointToStr(endpoint).c_str());
+  }
+
+  pb::node::NodeService_Stub stub(channel.get());
+
+  brpc::Controller cntl;
+  cntl.set_timeout_ms(timeout_ms);
+
+  pb::node::ReadIndexRequest request;
+  request.set_region_id(region_id);
+  pb::node::ReadIndexResponse response;
+  stub.ReadIndex(&cntl, &request, &response, nullptr);
+  if (cntl.Failed()) {
+    DINGO_LOG(ERROR) << fmt::format("[read_index][region({})] send request failed, error: {}", region_id,
+                                    cntl.ErrorText());
+    return butil::Status(pb::error::EINTERNAL, cntl.ErrorText());
+  }
+  if (response.error().errcode() != pb::error::OK) {
+    return butil::Status(response.error().errcode(), response.error().errmsg());
+  }
+
+  read_index = response.read_index();
+  return butil::Status::OK();
+}
+
 butil::Status ServiceAccess::InstallVectorIndexSnapshot(const pb::node::InstallVectorIndexSnapshotRequest& request,
                                                         const butil::EndPoint& endpoint,
                                                         pb::node::InstallVectorIndexSnapshotResponse& response) {
@@ -189,6 +219,34 @@ butil::Status ServiceAccess::InstallVectorIndexSnapshot(const pb::node::InstallV
   return butil::Status();
 }
 
+butil::Status ServiceAccess::PrepareIngestSst(const pb::node::PrepareIngestSstRequest& request,
+                                              const butil::EndPoint& endpoint) {
+  auto channel = ChannelPool::GetInstance().GetChannel(endpoint);
+  if (channel == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Get channel failed, endpoint: %s",
+                         Helper::EndPointToStr(endpoint).c_str());
+  }
+
+  brpc::Controller cntl;
+  cntl.set_timeout_ms(3600 * 1000);
+  pb::node::NodeService_Stub stub(channel.get());
+
+  pb::node::PrepareIngestSstResponse response;
+  stub.PrepareIngestSst(&cntl, &request, &response, nullptr);
+  if (cntl.Failed()) {
+    DINGO_LOG(ERROR) << fmt::format("Send PrepareIngestSst request failed, error {}", cntl.ErrorText());
+    return butil::Status(pb::error::EINTERNAL, cntl.ErrorText());
+  }
+
+  if (response.error().errcode() != pb::error::OK) {
+    DINGO_LOG(ERROR) << fmt::format("PrepareIngestSst response failed, error {} {}",
+                                    static_cast<int>(response.error().errcode()), response.error().errmsg());
+    return butil::Status(response.error().errcode(), response.error().errmsg());
+  }
+
+  return butil::Status();
+}
+
 butil::Status ServiceAccess::GetVectorIndexSnapshot(const pb::node::GetVectorIndexSnapshotRequest& request,
                                                     const butil::EndPoint& endpoint,
                                                     pb::node::GetVectorIndexSnapshotResponse& response) {
@@ -247,6 +305,82 @@ butil::Status ServiceAccess::CheckVectorIndex(const pb::node::CheckVectorIndexRe
   return butil::Status();
 }
 
+butil::Status ServiceAccess::GetRegionHash(const pb::node::GetRegionHashRequest& request,
+                                           const butil::EndPoint& endpoint, pb::node::GetRegionHashResponse& response) {
+  auto channel = ChannelPool::GetInstance().GetChannel(endpoint);
+  if (channel == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Get channel failed, endpoint: %s",
+                         Helper::EndPointToStr(endpoint).c_str());
+  }
+
+  brpc::Controller cntl;
+  cntl.set_timeout_ms(6000);
+  pb::node::NodeService_Stub stub(channel.get());
+
+  stub.GetRegionHash(&cntl, &request, &response, nullptr);
+  if (cntl.Failed()) {
+    DINGO_LOG(ERROR) << fmt::format("Send GetRegionHash request failed, error {}", cntl.ErrorText());
+    return butil::Status(pb::error::EINTERNAL, cntl.ErrorText());
+  }
+
+  if (response.error().errcode() != pb::error::OK) {
+    return butil::Status(response.error().errcode(), response.error().errmsg());
+  }
+
+  return butil::Status();
+}
+
+butil::Status ServiceAccess::PullRaftLog(const pb::node::PullRaftLogRequest& request, const butil::EndPoint& endpoint,
+                                         pb::node::PullRaftLogResponse& response) {
+  auto channel = ChannelPool::GetInstance().GetChannel(endpoint);
+  if (channel == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Get channel failed, endpoint: %s",
+                         Helper::EndPointToStr(endpoint).c_str());
+  }
+
+  brpc::Controller cntl;
+  cntl.set_timeout_ms(6000);
+  pb::node::NodeService_Stub stub(channel.get());
+
+  stub.PullRaftLog(&cntl, &request, &response, nullptr);
+  if (cntl.Failed()) {
+    DINGO_LOG(ERROR) << fmt::format("Send PullRaftLog request failed, error {}", cntl.ErrorText());
+    return butil::Status(pb::error::EINTERNAL, cntl.ErrorText());
+  }
+
+  if (response.error().errcode() != pb::error::OK) {
+    return butil::Status(response.error().errcode(), response.error().errmsg());
+  }
+
+  return butil::Status();
+}
+
+butil::Status ServiceAccess::GetLearnerSnapshot(const pb::node::GetLearnerSnapshotRequest& request,
+                                                const butil::EndPoint& endpoint,
+                                                pb::node::GetLearnerSnapshotResponse& response) {
+  auto channel = ChannelPool::GetInstance().GetChannel(endpoint);
+  if (channel == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Get channel failed, endpoint: %s",
+                         Helper::EndPointToStr(endpoint).c_str());
+  }
+
+  brpc::Controller cntl;
+  cntl.set_timeout_ms(6000);
+  pb::node::NodeService_Stub stub(channel.get());
+
+  stub.GetLearnerSnapshot(&cntl, &request, &response, nullptr);
+  if (cntl.Failed()) {
+    DINGO_LOG(ERROR) << fmt::format("Send GetLearnerSnapshot request failed, error {}", cntl.ErrorText());
+    return butil::Status(pb::error::EINTERNAL, cntl.ErrorText());
+  }
+
+  if (response.error().errcode() != pb::error::OK) {
+    return butil::Status(response.error().errcode(), response.error().errmsg());
+  }
+
+  return butil::Status();
+}
+
 std::shared_ptr<pb::fileservice::CleanFileReaderResponse> ServiceAccess::CleanFileReader(
     const pb::fileservice::CleanFileReaderRequest& request, const butil::EndPoint& endpoint) {
   auto channel = ChannelPool::GetInstance().GetChannel(endpoint);
@@ -54,6 +54,10 @@ class ServiceAccess {
   static std::vector<pb::store_internal::Region> GetRegionInfo(std::vector<int64_t> region_ids,
                                                                const butil::EndPoint& endpoint);
 
+  // Get read index of region from the leader node.
+  static butil::Status ReadIndex(int64_t region_id, const butil::EndPoint& endpoint, int64_t timeout_ms,
+                                 int64_t& read_index);
+
   static std::vector<pb::node::RaftStatusEntry> GetRaftStatus(std::vector<int64_t> region_ids,
                                                               const butil::EndPoint& endpoint);
 
@@ -64,9 +68,22 @@ class ServiceAccess {
                                               const butil::EndPoint& endpoint,
                                               pb::node::GetVectorIndexSnapshotResponse& response);
 
+  static butil::Status PrepareIngestSst(const pb::node::PrepareIngestSstRequest& request,
+                                        const butil::EndPoint& endpoint);
+
   static butil::Status CheckVectorIndex(const pb::node::CheckVectorIndexRequest& request,
                                         const butil::EndPoint& endpoint, pb::node::CheckVectorIndexResponse& response);
 
+  static butil::Status GetRegionHash(const pb::node::GetRegionHashRequest& request, const butil::EndPoint& endpoint,
+                                     pb::node::GetRegionHashResponse& response);
+
+  static butil::Status PullRaftLog(const pb::node::PullRaftLogRequest& request, const butil::EndPoint& endpoint,
+                                   pb::node::PullRaftLogResponse& response);
+
+  static butil::Status GetLearnerSnapshot(const pb::node::GetLearnerSnapshotRequest& request,
+                                          const butil::EndPoint& endpoint,
+                                          pb::node::GetLearnerSnapshotResponse& response);
+
   // FileService
   static std::shared_ptr<pb::fileservice::CleanFileReaderResponse> CleanFileReader(
       const pb::fileservice::CleanFileReaderRequest& request, const butil::EndPoint& endpoint);
@@ -0,0 +1,261 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/slow_log.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "butil/strings/string_split.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/debug.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_slow_log, true, "record slow requests of store and index service");
+DEFINE_int64(slow_log_threshold_ms, 500, "request elapsed time reach it is slow");
+DEFINE_string(slow_log_method_threshold_ms, "", "slow threshold of specific methods, e.g. VectorSearch:200,KvScan:50");
+DEFINE_validator(slow_log_method_threshold_ms, [](const char*, const std::string& value) -> bool {
+  return SlowLog::GetInstance().SetMethodThresholds(value);
+});
+DEFINE_int32(slow_log_capacity, 1024, "max slow requests kept in memory");
+
+SlowLog& SlowLog::GetInstance() {
+  static SlowLog instance;
+  return instance;
+}
+
+bool SlowLog::SetMethodThresholds(const std::string& str) {
+  std::map<std::string, int64_t> method_thresholds;
+  std::vector<std::string> items;
+  butil::SplitString(str, ',', &items);
+  for (const auto& item : items) {
+    if (item.empty()) {
+      continue;
+    }
+    std::vector<std::string> kv;
+    butil::SplitString(item, ':', &kv);
+    char* end = nullptr;
+    int64_t threshold_ms = kv.size() == 2 ? std::strtoll(kv[1].c_str(), &end, 10) : 0;
+    if (kv.size() != 2 || kv[0].empty() || kv[1].empty() || *end != '\0') {
+      DINGO_LOG(ERROR) << fmt::format("[slow_log] invalid method threshold {}", item);
+      return false;
+    }
+    method_thresholds[kv[0]] = threshold_ms;
+  }
+
+  int64_t min_threshold_ms = INT64_MAX;
+  for (const auto& [_, threshold_ms] : method_thresholds) {
+    min_threshold_ms = std::min(min_threshold_ms, threshold_ms);
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  method_thresholds_.swap(method_thresholds);
+  min_method_threshold_ms_.store(min_threshold_ms);
+  return true;
+}
+
+void SlowLog::Record(const std::string& method, int64_t elapsed_ns, const google::protobuf::Message& request,
+                     int32_t errcode, TrackerPtr tracker) {
+  int64_t elapsed_ms = elapsed_ns / 1000000;
+  if (BAIDU_LIKELY(!FLAGS_enable_slow_log ||
+                   elapsed_ms < std::min(FLAGS_slow_log_threshold_ms, min_method_threshold_ms_.load()))) {
+    return;
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = method_thresholds_.find(method);
+    int64_t threshold_ms = it != method_thresholds_.end() ? it->second : FLAGS_slow_log_threshold_ms;
+    if (elapsed_ms < threshold_ms) {
+      return;
+    }
+  }
+
+  pb::debug::SlowRequest slow_request;
+  slow_request.set_method(method);
+  slow_request.set_timestamp_ms(Helper::TimestampMs());
+  slow_request.set_elapsed_us(elapsed_ns / 1000);
+  slow_request.set_errcode(errcode);
+  if (tracker != nullptr) {
+    tracker->FillTimeInfo(slow_request.mutable_time_info());
+    if (tracker->IsTraced()) {
+      slow_request.set_trace_id(tracker->Span().trace_id);
+    }
+  }
+  SummarizeRequest(request, slow_request);
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  size_t capacity = std::max(1, FLAGS_slow_log_capacity);
+  if (slow_requests_.size() > capacity) {
+    // capacity is reduced, drop the oldest.
+    std::rotate(slow_requests_.begin(), slow_requests_.begin() + pos_, slow_requests_.end());
+    slow_requests_.erase(slow_requests_.begin(), slow_requests_.end() - capacity);
+    pos_ = 0;
+  }
+  if (slow_requests_.size() < capacity) {
+    slow_requests_.push_back(std::move(slow_request));
+    pos_ = slow_requests_.size() % capacity;
+  } else {
+    slow_requests_[pos_] = std::move(slow_request);
+    pos_ = (pos_ + 1) % capacity;
+  }
+}
+
+std::vector<pb::debug::SlowRequest> SlowLog::GetSlowRequests(const std::string& method, int64_t min_elapsed_us,
+                                                             int32_t limit) {
+  std::vector<pb::debug::SlowRequest> result;
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  size_t size = slow_requests_.size();
+  for (size_t i = 0; i < size; ++i) {
+    // from newest to oldest
+    const auto& slow_request = slow_requests_[(pos_ + size - 1 - i) % size];
+    if (!method.empty() && slow_request.method() != method) {
+      continue;
+    }
+    if (slow_request.elapsed_us() < min_elapsed_us) {
+      continue;
+    }
+    result.push_back(slow_request);
+    if (limit > 0 && static_cast<int32_t>(result.size()) >= limit) {
+      break;
+    }
+  }
+
+  return result;
+}
+
+static const google::protobuf::Message* GetMessageField(const google::protobuf::Message& message,
+                                                        const std::string& name) {
+  const auto* field = message.GetDescriptor()->FindFieldByName(name);
+  if (field == nullptr || field->is_repeated() || field->type() != google::protobuf::FieldDescriptor::TYPE_MESSAGE ||
+      !message.GetReflection()->HasField(message, field)) {
+    return nullptr;
+  }
+  return &message.GetReflection()->GetMessage(message, field);
+}
+
+static bool GetStringField(const google::protobuf::Message& message, const std::string& name, std::string& value) {
+  const auto* field = message.GetDescriptor()->FindFieldByName(name);
+  if (field == nullptr || field->is_repeated() ||
+      field->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_STRING) {
+    return false;
+  }
+  value = message.GetReflection()->GetString(message, field);
+  return true;
+}
+
+static int64_t GetInt64Field(const google::protobuf::Message& message, const std::string& name) {
+  const auto* field = message.GetDescriptor()->FindFieldByName(name);
+  if (field == nullptr || field->is_repeated() ||
+      field->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_INT64) {
+    return 0;
+  }
+  return message.GetReflection()->GetInt64(message, field);
+}
+
+// Keys of request are one of key, keys, range, kv, kvs, mutations, the first and last key are kept.
+static void SummarizeKeys(const google::protobuf::Message& request, pb::debug::SlowRequest& slow_request) {
+  std::string key;
+  if (GetStringField(request, "key", key)) {
+    slow_request.set_start_key(key);
+    slow_request.set_key_count(1);
+    return;
+  }
+
+  const auto* range = GetMessageField(request, "range");
+  if (range != nullptr) {
+    std::string start_key, end_key;
+    GetStringField(*range, "start_key", start_key);
+    GetStringField(*range, "end_key", end_key);
+    slow_request.set_start_key(start_key);
+    slow_request.set_end_key(end_key);
+    return;
+  }
+
+  const auto* kv = GetMessageField(request, "kv");
+  if (kv != nullptr && GetStringField(*kv, "key", key)) {
+    slow_request.set_start_key(key);
+    slow_request.set_key_count(1);
+    return;
+  }
+
+  const auto* desc = request.GetDescriptor();
+  const auto* reflection = request.GetReflection();
+  for (const auto* name : {"keys", "kvs", "mutations"}) {
+    const auto* field = desc->FindFieldByName(name);
+    if (field == nullptr || !field->is_repeated()) {
+      continue;
+    }
+    int size = reflection->FieldSize(request, field);
+    if (size == 0) {
+      continue;
+    }
+
+    std::function<std::string(int)> get_key;
+    if (field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_STRING) {
+      get_key = [&](int index) { return reflection->GetRepeatedString(request, field, index); };
+    } else if (field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE) {
+      get_key = [&](int index) {
+        std::string repeated_key;
+        GetStringField(reflection->GetRepeatedMessage(request, field, index), "key", repeated_key);
+        return repeated_key;
+      };
+    } else {
+      continue;
+    }
+
+    slow_request.set_start_key(get_key(0));
+    slow_request.set_end_key(get_key(size - 1));
+    slow_request.set_key_count(size);
+    return;
+  }
+}
+
+void SlowLog::SummarizeRequest(const google::protobuf::Message& request, pb::debug::SlowRequest& slow_request) {
+  const auto* request_info = GetMessageField(request, "request_info");
+  if (request_info != nullptr) {
+    slow_request.set_request_id(GetInt64Field(*request_info, "request_id"));
+  }
+
+  const auto* context = GetMessageField(request, "context");
+  if (context != nullptr) {
+    slow_request.set_region_id(GetInt64Field(*context, "region_id"));
+  }
+
+  SummarizeKeys(request, slow_request);
+
+  const auto* parameter = GetMessageField(request, "parameter");
+  if (parameter != nullptr) {
+    slow_request.set_vector_search_parameter(parameter->ShortDebugString().substr(0, Constant::kLogPrintMaxLength));
+  }
+
+  const auto* coprocessor = GetMessageField(request, "coprocessor");
+  if (coprocessor != nullptr) {
+    slow_request.set_coprocessor_hash(std::hash<std::string>{}(coprocessor->SerializeAsString()));
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,66 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_SLOW_LOG_H_
+#define DINGODB_COMMON_SLOW_LOG_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "common/tracker.h"
+#include "google/protobuf/message.h"
+#include "proto/debug.pb.h"
+
+namespace dingodb {
+
+// Ring buffer of the newest slow requests of store and index service.
+// A request is slow if elapsed time reach the threshold of its method, set by slow_log_method_threshold_ms,
+// e.g. "VectorSearch:200,KvScanContinue:50", other methods use slow_log_threshold_ms.
+// The request is summarized by reflection only when it is slow, so the normal path just compare the elapsed time.
+class SlowLog {
+ public:
+  static SlowLog& GetInstance();
+
+  void Record(const std::string& method, int64_t elapsed_ns, const google::protobuf::Message& request,
+              int32_t errcode, TrackerPtr tracker);
+
+  // Newest first.
+  std::vector<pb::debug::SlowRequest> GetSlowRequests(const std::string& method, int64_t min_elapsed_us,
+                                                      int32_t limit);
+
+  // Parse the method thresholds, e.g. "VectorSearch:200,KvScanContinue:50", called by the flag validator.
+  bool SetMethodThresholds(const std::string& str);
+
+  // Fill region, keys, vector search parameter and coprocessor of request.
+  static void SummarizeRequest(const google::protobuf::Message& request, pb::debug::SlowRequest& slow_request);
+
+ private:
+  SlowLog() = default;
+
+  bthread::Mutex mutex_;
+  std::vector<pb::debug::SlowRequest> slow_requests_;
+  // next position to write of the ring buffer.
+  size_t pos_{0};
+  std::map<std::string, int64_t> method_thresholds_;
+  // min threshold of method_thresholds_, for checking without lock.
+  std::atomic<int64_t> min_method_threshold_ms_{INT64_MAX};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_SLOW_LOG_H_
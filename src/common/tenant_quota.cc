@@ -0,0 +1,171 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/tenant_quota.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "butil/strings/string_number_conversions.h"
+#include "butil/strings/string_split.h"
+#include "butil/time.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_tenant_quota, false, "enable per-tenant request quota of store");
+DEFINE_int64(tenant_quota_default_qps, 0, "default request quota per second of tenant, 0 is unlimited");
+DEFINE_int64(tenant_quota_default_bytes, 0, "default request bytes quota per second of tenant, 0 is unlimited");
+DEFINE_string(tenant_quota_spec, "",
+              "quota of tenants, format tenant_id:qps:bytes_per_second:priority;..., 0 is unlimited");
+
+TenantQuota& TenantQuota::GetInstance() {
+  static TenantQuota instance;
+  return instance;
+}
+
+bool TenantQuota::IsEnabled() { return FLAGS_enable_tenant_quota; }
+
+bool TenantQuota::ParseSpec(const std::string& spec, std::map<int64_t, Quota>& quotas) {
+  std::vector<std::string> items;
+  butil::SplitString(spec, ';', &items);
+  for (const auto& item : items) {
+    if (item.empty()) {
+      continue;
+    }
+
+    std::vector<std::string> fields;
+    butil::SplitString(item, ':', &fields);
+    if (fields.size() < 3 || fields.size() > 4) {
+      return false;
+    }
+
+    int64_t tenant_id = 0;
+    Quota quota;
+    int64_t priority = 0;
+    if (!butil::StringToInt64(fields[0], &tenant_id) || !butil::StringToInt64(fields[1], &quota.qps) ||
+        !butil::StringToInt64(fields[2], &quota.bytes_per_second) ||
+        (fields.size() == 4 && !butil::StringToInt64(fields[3], &priority))) {
+      return false;
+    }
+    if (quota.qps < 0 || quota.bytes_per_second < 0) {
+      return false;
+    }
+
+    quota.priority = static_cast<int32_t>(priority);
+    quotas[tenant_id] = quota;
+  }
+
+  return true;
+}
+
+void TenantQuota::RefreshQuotas() {
+  if (spec_ == FLAGS_tenant_quota_spec && default_qps_ == FLAGS_tenant_quota_default_qps &&
+      default_bytes_per_second_ == FLAGS_tenant_quota_default_bytes) {
+    return;
+  }
+
+  std::map<int64_t, Quota> quotas;
+  if (ParseSpec(FLAGS_tenant_quota_spec, quotas)) {
+    quotas_.swap(quotas);
+  } else {
+    DINGO_LOG(ERROR) << fmt::format("[tenant_quota] parse tenant_quota_spec failed, spec: {}",
+                                    FLAGS_tenant_quota_spec);
+  }
+  spec_ = FLAGS_tenant_quota_spec;
+  default_qps_ = FLAGS_tenant_quota_default_qps;
+  default_bytes_per_second_ = FLAGS_tenant_quota_default_bytes;
+
+  for (auto& [tenant_id, bucket] : buckets_) {
+    bucket.quota = GetQuota(tenant_id);
+  }
+}
+
+TenantQuota::Quota TenantQuota::GetQuota(int64_t tenant_id) const {
+  auto it = quotas_.find(tenant_id);
+  if (it != quotas_.end()) {
+    return it->second;
+  }
+
+  Quota quota;
+  quota.qps = default_qps_;
+  quota.bytes_per_second = default_bytes_per_second_;
+  return quota;
+}
+
+TenantQuota::Bucket& TenantQuota::GetBucket(int64_t tenant_id) {
+  auto it = buckets_.find(tenant_id);
+  if (it != buckets_.end()) {
+    return it->second;
+  }
+
+  auto& bucket = buckets_[tenant_id];
+  bucket.quota = GetQuota(tenant_id);
+  bucket.request_tokens = static_cast<double>(bucket.quota.qps);
+  bucket.byte_tokens = static_cast<double>(bucket.quota.bytes_per_second);
+  bucket.last_refill_ms = butil::gettimeofday_ms();
+  bucket.request_count =
+      std::make_unique<bvar::Adder<int64_t>>(fmt::format("dingo_tenant_{}_request_count", tenant_id));
+  bucket.rejected_count =
+      std::make_unique<bvar::Adder<int64_t>>(fmt::format("dingo_tenant_{}_rejected_count", tenant_id));
+  bucket.bytes = std::make_unique<bvar::Adder<int64_t>>(fmt::format("dingo_tenant_{}_bytes", tenant_id));
+  return bucket;
+}
+
+butil::Status TenantQuota::Acquire(int64_t tenant_id, int64_t bytes, int32_t& priority) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  RefreshQuotas();
+  auto& bucket = GetBucket(tenant_id);
+  const auto& quota = bucket.quota;
+  priority = quota.priority;
+
+  // refill tokens, at most burst of 1 second.
+  int64_t now_ms = butil::gettimeofday_ms();
+  double elapsed_s = static_cast<double>(std::max(static_cast<int64_t>(0), now_ms - bucket.last_refill_ms)) / 1000;
+  bucket.last_refill_ms = now_ms;
+  bucket.request_tokens = std::min(static_cast<double>(quota.qps), bucket.request_tokens + elapsed_s * quota.qps);
+  bucket.byte_tokens = std::min(static_cast<double>(quota.bytes_per_second),
+                                bucket.byte_tokens + elapsed_s * quota.bytes_per_second);
+
+  if ((quota.qps > 0 && bucket.request_tokens < 1) || (quota.bytes_per_second > 0 && bucket.byte_tokens <= 0)) {
+    *bucket.rejected_count << 1;
+    return butil::Status(pb::error::ETENANT_QUOTA_EXCEEDED,
+                         fmt::format("Tenant {} exceed quota, qps: {} bytes_per_second: {}", tenant_id, quota.qps,
+                                     quota.bytes_per_second));
+  }
+
+  // a request larger than the left bytes is admitted too, the debt delays the following requests.
+  if (quota.qps > 0) {
+    bucket.request_tokens -= 1;
+  }
+  if (quota.bytes_per_second > 0) {
+    bucket.byte_tokens -= static_cast<double>(bytes);
+  }
+  *bucket.request_count << 1;
+  *bucket.bytes << bytes;
+
+  return butil::Status::OK();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,80 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_TENANT_QUOTA_H_
+#define DINGODB_COMMON_TENANT_QUOTA_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "butil/status.h"
+#include "bvar/reducer.h"
+
+namespace dingodb {
+
+// Per-tenant admission control of store requests.
+// Every tenant has a token bucket of requests and one of request bytes, refilled per second with 1 second burst,
+// a quota of 0 is unlimited. The request exceeding the quota is rejected with ETENANT_QUOTA_EXCEEDED,
+// the admitted request takes the priority of its tenant in the worker queue.
+// The quota comes from tenant_quota_spec, other tenants use the default quota.
+class TenantQuota {
+ public:
+  struct Quota {
+    int64_t qps{0};
+    int64_t bytes_per_second{0};
+    int32_t priority{0};
+  };
+
+  static TenantQuota& GetInstance();
+
+  static bool IsEnabled();
+
+  // Parse spec "tenant_id:qps:bytes_per_second:priority;...", priority is optional.
+  static bool ParseSpec(const std::string& spec, std::map<int64_t, Quota>& quotas);
+
+  // Consume one request and bytes of tenant, output the priority of tenant.
+  butil::Status Acquire(int64_t tenant_id, int64_t bytes, int32_t& priority);
+
+ private:
+  TenantQuota() = default;
+
+  struct Bucket {
+    Quota quota;
+    double request_tokens{0};
+    double byte_tokens{0};
+    int64_t last_refill_ms{0};
+
+    std::unique_ptr<bvar::Adder<int64_t>> request_count;
+    std::unique_ptr<bvar::Adder<int64_t>> rejected_count;
+    std::unique_ptr<bvar::Adder<int64_t>> bytes;
+  };
+
+  void RefreshQuotas();
+  Quota GetQuota(int64_t tenant_id) const;
+  Bucket& GetBucket(int64_t tenant_id);
+
+  std::mutex mutex_;
+  std::string spec_;
+  int64_t default_qps_{0};
+  int64_t default_bytes_per_second_{0};
+  std::map<int64_t, Quota> quotas_;
+  std::map<int64_t, Bucket> buckets_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_TENANT_QUOTA_H_
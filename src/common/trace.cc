@@ -0,0 +1,100 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/trace.h"
+
+#include <cstdint>
+#include <string>
+
+#include "butil/fast_rand.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_trace_span, true, "print the span of sampled request to log");
+
+int64_t Trace::GenId() {
+  int64_t id = 0;
+  while (id == 0) {
+    id = static_cast<int64_t>(butil::fast_rand() & INT64_MAX);
+  }
+  return id;
+}
+
+bool Trace::ShouldSample(double sample_rate) {
+  if (sample_rate <= 0) {
+    return false;
+  }
+  return sample_rate >= 1 || butil::fast_rand_double() < sample_rate;
+}
+
+void Trace::StartSpan(TraceSpan& span, int64_t trace_id, int64_t parent_span_id, const std::string& name,
+                      const std::string& kind) {
+  span.trace_id = trace_id != 0 ? trace_id : GenId();
+  span.span_id = GenId();
+  span.parent_span_id = parent_span_id;
+  span.name = name;
+  span.kind = kind;
+  span.start_time_us = Helper::TimestampUs();
+}
+
+void Trace::FinishSpan(TraceSpan& span, int32_t errcode) {
+  if (!span.IsSampled()) {
+    return;
+  }
+
+  span.duration_us = Helper::TimestampUs() - span.start_time_us;
+  span.errcode = errcode;
+  PrintSpan(span);
+}
+
+void Trace::PrintSpan(const TraceSpan& span) {
+  if (!FLAGS_enable_trace_span || !span.IsSampled()) {
+    return;
+  }
+
+  std::string attributes;
+  for (const auto& [key, value] : span.attributes) {
+    attributes += fmt::format("{}\"{}\":\"{}\"", attributes.empty() ? "" : ",", key, value);
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[trace] {{\"trace_id\":\"{:016x}\",\"span_id\":\"{:016x}\",\"parent_span_id\":\"{:016x}\",\"name\":\"{}\","
+      "\"kind\":\"{}\",\"start_time_us\":{},\"duration_us\":{},\"errcode\":{},\"attributes\":{{{}}}}}",
+      span.trace_id, span.span_id, span.parent_span_id, span.name, span.kind, span.start_time_us, span.duration_us,
+      span.errcode, attributes);
+}
+
+void Trace::SetRequestTrace(google::protobuf::Message* request, const TraceSpan& span) {
+  if (request == nullptr || !span.IsSampled()) {
+    return;
+  }
+
+  const auto* field = request->GetDescriptor()->FindFieldByName("request_info");
+  if (field == nullptr || field->message_type() != pb::common::RequestInfo::descriptor()) {
+    return;
+  }
+
+  auto* request_info =
+      static_cast<pb::common::RequestInfo*>(request->GetReflection()->MutableMessage(request, field));
+  auto* trace = request_info->mutable_trace();
+  trace->set_trace_id(span.trace_id);
+  trace->set_span_id(span.span_id);
+  trace->set_sampled(true);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,68 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_TRACE_H_
+#define DINGODB_COMMON_TRACE_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "google/protobuf/message.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Span of a sampled request, the fields follow the OpenTelemetry span model.
+// A finished span is printed as one json line with prefix [trace] to the log,
+// the log agent collects and exports them to the trace backend, so no exporter runs in process.
+struct TraceSpan {
+  int64_t trace_id{0};
+  int64_t span_id{0};
+  int64_t parent_span_id{0};
+  std::string name;
+  // client/server/internal
+  std::string kind;
+  int64_t start_time_us{0};
+  int64_t duration_us{0};
+  int32_t errcode{0};
+  std::map<std::string, std::string> attributes;
+
+  bool IsSampled() const { return trace_id != 0; }
+};
+
+class Trace {
+ public:
+  // Not zero random id.
+  static int64_t GenId();
+
+  // sample_rate is in [0, 1], 0 means never.
+  static bool ShouldSample(double sample_rate);
+
+  // Start a span, trace_id 0 means a new trace.
+  static void StartSpan(TraceSpan& span, int64_t trace_id, int64_t parent_span_id, const std::string& name,
+                        const std::string& kind);
+
+  // Set duration and print the span when it is sampled.
+  static void FinishSpan(TraceSpan& span, int32_t errcode = 0);
+
+  static void PrintSpan(const TraceSpan& span);
+
+  // Set request_info.trace of request by reflection, for the requests which have request_info.
+  static void SetRequestTrace(google::protobuf::Message* request, const TraceSpan& span);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_TRACE_H_
@@ -15,14 +15,24 @@
 #include "common/tracker.h"
 
 #include <memory>
+#include <string>
 
 #include "common/helper.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
 
 namespace dingodb {
 
+DEFINE_bool(enable_tracker_metrics, true, "enable per rpc method stage latency bvar metrics");
+
 Tracker::Tracker(const pb::common::RequestInfo& request_info) : request_info_(request_info) {
   start_time_ = Helper::TimestampNs();
   last_time_ = start_time_;
+
+  const auto& trace = request_info.trace();
+  if (trace.sampled() && trace.trace_id() != 0) {
+    Trace::StartSpan(span_, trace.trace_id(), trace.span_id(), "", "server");
+  }
 }
 
 std::shared_ptr<Tracker> Tracker::New(const pb::common::RequestInfo& request_info) {
@@ -71,4 +81,107 @@ void Tracker::SetRaftApplyTime() {
 }
 uint64_t Tracker::RaftApplyTime() const { return metrics_.raft_apply_time_ns; }
 
+void Tracker::AddEngineReadTime(uint64_t time_ns) { metrics_.engine_read_time_ns += time_ns; }
+uint64_t Tracker::EngineReadTime() const { return metrics_.engine_read_time_ns; }
+
+void Tracker::AddLockCfTime(uint64_t time_ns) { metrics_.lock_cf_time_ns += time_ns; }
+uint64_t Tracker::LockCfTime() const { return metrics_.lock_cf_time_ns; }
+
+void Tracker::AddCoprocessorTime(uint64_t time_ns) { metrics_.coprocessor_time_ns += time_ns; }
+uint64_t Tracker::CoprocessorTime() const { return metrics_.coprocessor_time_ns; }
+
+void Tracker::AddVectorSearchTime(uint64_t time_ns) { metrics_.vector_search_time_ns += time_ns; }
+uint64_t Tracker::VectorSearchTime() const { return metrics_.vector_search_time_ns; }
+
+void Tracker::AddSerializationTime(uint64_t time_ns) { metrics_.serialization_time_ns += time_ns; }
+uint64_t Tracker::SerializationTime() const { return metrics_.serialization_time_ns; }
+
+void Tracker::FillTimeInfo(pb::common::TimeInfo* time_info) const {
+  time_info->set_total_rpc_time_ns(metrics_.total_rpc_time_ns);
+  time_info->set_service_queue_wait_time_ns(metrics_.service_queue_wait_time_ns);
+  time_info->set_prepair_commit_time_ns(metrics_.prepair_commit_time_ns);
+  time_info->set_raft_commit_time_ns(metrics_.raft_commit_time_ns);
+  time_info->set_raft_queue_wait_time_ns(metrics_.raft_queue_wait_time_ns);
+  time_info->set_raft_apply_time_ns(metrics_.raft_apply_time_ns);
+  time_info->set_engine_read_time_ns(metrics_.engine_read_time_ns);
+  time_info->set_lock_cf_time_ns(metrics_.lock_cf_time_ns);
+  time_info->set_coprocessor_time_ns(metrics_.coprocessor_time_ns);
+  time_info->set_vector_search_time_ns(metrics_.vector_search_time_ns);
+  time_info->set_serialization_time_ns(metrics_.serialization_time_ns);
+}
+
+bool Tracker::IsTraced() const { return span_.IsSampled(); }
+
+const TraceSpan& Tracker::Span() const { return span_; }
+
+void Tracker::FinishSpan(const std::string& method_name, int32_t errcode) {
+  if (!span_.IsSampled()) {
+    return;
+  }
+
+  auto add_attribute = [this](const std::string& key, uint64_t time_ns) {
+    if (time_ns > 0) {
+      span_.attributes[key] = std::to_string(time_ns / 1000);
+    }
+  };
+
+  span_.name = method_name;
+  span_.attributes["request_id"] = std::to_string(request_info_.request_id());
+  add_attribute("service_queue_wait_us", metrics_.service_queue_wait_time_ns);
+  add_attribute("prepair_commit_us", metrics_.prepair_commit_time_ns);
+  add_attribute("raft_commit_us", metrics_.raft_commit_time_ns);
+  add_attribute("raft_queue_wait_us", metrics_.raft_queue_wait_time_ns);
+  add_attribute("raft_apply_us", metrics_.raft_apply_time_ns);
+  add_attribute("engine_read_us", metrics_.engine_read_time_ns);
+  add_attribute("lock_cf_us", metrics_.lock_cf_time_ns);
+  add_attribute("coprocessor_us", metrics_.coprocessor_time_ns);
+  add_attribute("vector_search_us", metrics_.vector_search_time_ns);
+  add_attribute("serialization_us", metrics_.serialization_time_ns);
+
+  Trace::FinishSpan(span_, errcode);
+}
+
+TrackerMetrics& TrackerMetrics::GetInstance() {
+  static TrackerMetrics instance;
+  return instance;
+}
+
+void TrackerMetrics::Record(const std::string& method_name, TrackerPtr tracker) {
+  if (!FLAGS_enable_tracker_metrics || tracker == nullptr) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto& recorders = method_recorders_[method_name];
+  if (recorders == nullptr) {
+    recorders = std::make_unique<MethodRecorders>();
+  }
+
+  RecordStage(method_name, *recorders, "total_rpc", tracker->TotalRpcTime());
+  RecordStage(method_name, *recorders, "service_queue_wait", tracker->ServiceQueueWaitTime());
+  RecordStage(method_name, *recorders, "prepair_commit", tracker->PrepairCommitTime());
+  RecordStage(method_name, *recorders, "raft_commit", tracker->RaftCommitTime());
+  RecordStage(method_name, *recorders, "raft_queue_wait", tracker->RaftQueueWaitTime());
+  RecordStage(method_name, *recorders, "raft_apply", tracker->RaftApplyTime());
+  RecordStage(method_name, *recorders, "engine_read", tracker->EngineReadTime());
+  RecordStage(method_name, *recorders, "lock_cf", tracker->LockCfTime());
+  RecordStage(method_name, *recorders, "coprocessor", tracker->CoprocessorTime());
+  RecordStage(method_name, *recorders, "vector_search", tracker->VectorSearchTime());
+  RecordStage(method_name, *recorders, "serialization", tracker->SerializationTime());
+}
+
+// Stage not passed by the method is skipped, so the recorder is only created for the passed stage.
+void TrackerMetrics::RecordStage(const std::string& method_name, MethodRecorders& recorders, const std::string& stage,
+                                 uint64_t time_ns) {
+  if (time_ns == 0) {
+    return;
+  }
+
+  auto& recorder = recorders.stages[stage];
+  if (recorder == nullptr) {
+    recorder = std::make_unique<bvar::LatencyRecorder>(fmt::format("dingo_tracker_{}_{}", method_name, stage));
+  }
+  *recorder << static_cast<int64_t>(time_ns / 1000);
+}
+
 }  // namespace dingodb
\ No newline at end of file
@@ -16,8 +16,13 @@
 #define DINGODB_COMMON_TRACKER_H_
 
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <string>
 
+#include "bthread/mutex.h"
+#include "bvar/latency_recorder.h"
+#include "common/trace.h"
 #include "proto/common.pb.h"
 
 namespace dingodb {
@@ -36,6 +41,13 @@ class Tracker {
     uint64_t raft_commit_time_ns{0};
     uint64_t raft_queue_wait_time_ns{0};
     uint64_t raft_apply_time_ns{0};
+
+    // Accumulated time of the stages below, one request may pass a stage many times.
+    uint64_t engine_read_time_ns{0};
+    uint64_t lock_cf_time_ns{0};
+    uint64_t coprocessor_time_ns{0};
+    uint64_t vector_search_time_ns{0};
+    uint64_t serialization_time_ns{0};
   };
 
   void SetTotalRpcTime();
@@ -56,15 +68,60 @@ class Tracker {
   void SetRaftApplyTime();
   uint64_t RaftApplyTime() const;
 
+  void AddEngineReadTime(uint64_t time_ns);
+  uint64_t EngineReadTime() const;
+
+  void AddLockCfTime(uint64_t time_ns);
+  uint64_t LockCfTime() const;
+
+  void AddCoprocessorTime(uint64_t time_ns);
+  uint64_t CoprocessorTime() const;
+
+  void AddVectorSearchTime(uint64_t time_ns);
+  uint64_t VectorSearchTime() const;
+
+  void AddSerializationTime(uint64_t time_ns);
+  uint64_t SerializationTime() const;
+
+  void FillTimeInfo(pb::common::TimeInfo* time_info) const;
+
+  // Server span of the sampled request, its parent is the span of the sender.
+  bool IsTraced() const;
+  const TraceSpan& Span() const;
+  // Print the span with the stage time as attributes.
+  void FinishSpan(const std::string& method_name, int32_t errcode);
+
  private:
   uint64_t start_time_;
   uint64_t last_time_;
 
   pb::common::RequestInfo request_info_;
   Metrics metrics_;
+  TraceSpan span_;
 };
 using TrackerPtr = std::shared_ptr<Tracker>;
 
+// Per rpc method latency of every stage, exposed by bvar as dingo_tracker_{method}_{stage}.
+class TrackerMetrics {
+ public:
+  static TrackerMetrics& GetInstance();
+
+  void Record(const std::string& method_name, TrackerPtr tracker);
+
+ private:
+  TrackerMetrics() = default;
+
+  struct MethodRecorders {
+    std::map<std::string, std::unique_ptr<bvar::LatencyRecorder>> stages;
+  };
+
+  void RecordStage(const std::string& method_name, MethodRecorders& recorders, const std::string& stage,
+                   uint64_t time_ns);
+
+  bthread::Mutex mutex_;
+  std::map<std::string, std::unique_ptr<MethodRecorders>> method_recorders_;
+};
+
 }  // namespace dingodb
 
 #endif  // DINGODB_COMMON_TRACKER_H_
\ No newline at end of file
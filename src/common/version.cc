@@ -33,6 +33,7 @@ DEFINE_bool(use_openblas, false, "use openblas");
 DEFINE_bool(use_tcmalloc, false, "use tcmalloc");
 DEFINE_bool(use_profiler, false, "use profiler");
 DEFINE_bool(use_sanitizer, false, "use sanitizer");
+DEFINE_bool(use_gpu, false, "use gpu");
 
 std::string GetBuildFlag() {
 #ifdef USE_MKL
@@ -65,11 +66,17 @@ std::string GetBuildFlag() {
   FLAGS_use_sanitizer = false;
 #endif
 
+#ifdef ENABLE_GPU
+  FLAGS_use_gpu = true;
+#else
+  FLAGS_use_gpu = false;
+#endif
+
   return butil::string_printf(
       "DINGO_STORE USE_MKL:[%s] USE_OPENBLAS:[%s] LINK_TCMALLOC:[%s] BRPC_ENABLE_CPU_PROFILER:[%s] "
-      "USE_SANITIZE:[%s]\n",
+      "USE_SANITIZE:[%s] ENABLE_GPU:[%s]\n",
       FLAGS_use_mkl ? "ON" : "OFF", FLAGS_use_openblas ? "ON" : "OFF", FLAGS_use_tcmalloc ? "ON" : "OFF",
-      FLAGS_use_profiler ? "ON" : "OFF", FLAGS_use_sanitizer ? "ON" : "OFF");
+      FLAGS_use_profiler ? "ON" : "OFF", FLAGS_use_sanitizer ? "ON" : "OFF", FLAGS_use_gpu ? "ON" : "OFF");
 }
 
 void DingoShowVerion() {
@@ -14,6 +14,7 @@
 
 #include "coordinator/auto_increment_control.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <fstream>
 #include <memory>
@@ -25,11 +26,15 @@
 #include "common/logging.h"
 #include "common/synchronization.h"
 #include "engine/snapshot.h"
+#include "gflags/gflags.h"
 #include "proto/error.pb.h"
 #include "server/server.h"
 
 namespace dingodb {
 
+DEFINE_int64(auto_increment_lease_count, 0,
+             "id count of auto increment leased by leader each time, 0 means every generate go through raft");
+
 AutoIncrementControl::AutoIncrementControl() {
   // init bthread mutex
   bthread_mutex_init(&auto_increment_map_mutex_, nullptr);
@@ -61,7 +66,10 @@ butil::Status AutoIncrementControl::GetAutoIncrement(int64_t table_id, int64_t&
       DINGO_LOG(WARNING) << " cannot find auto increment, table id: " << table_id;
       status = butil::Status(pb::error::Errno::EAUTO_INCREMENT_NOT_FOUND, "auto increment not found");
     } else {
-      start_id = *start_id_ptr;
+      // the persisted id is the end of lease, ids before it are not generated yet.
+      auto it = auto_increment_leases_.find(table_id);
+      start_id = (it != auto_increment_leases_.end() && it->second.start_id < it->second.end_id) ? it->second.start_id
+                                                                                                 : *start_id_ptr;
       status = butil::Status::OK();
     }
   }
@@ -221,6 +229,105 @@ butil::Status AutoIncrementControl::GenerateAutoIncrement(int64_t table_id, uint
   return butil::Status::OK();
 }
 
+bool AutoIncrementControl::GenerateAutoIncrementFromLease(int64_t table_id, uint32_t count,
+                                                          uint32_t auto_increment_increment,
+                                                          uint32_t auto_increment_offset, int64_t& start_id,
+                                                          int64_t& end_id) {
+  int64_t lease_count =
+      std::min(FLAGS_auto_increment_lease_count, static_cast<int64_t>(kAutoIncrementGenerateCountMax));
+  if (lease_count <= 0 || !IsLeader()) {
+    return false;
+  }
+
+  // illegal parameters are checked by GenerateAutoIncrement
+  if (count == 0 || count > kAutoIncrementGenerateCountMax || auto_increment_increment == 0 ||
+      auto_increment_increment > kAutoIncrementOffsetMax || auto_increment_offset == 0 ||
+      auto_increment_offset > kAutoIncrementOffsetMax) {
+    return false;
+  }
+
+  bool served = false;
+  bool need_lease = false;
+  {
+    BAIDU_SCOPED_LOCK(auto_increment_map_mutex_);
+    if (auto_increment_map_.seek(table_id) == nullptr) {
+      return false;
+    }
+
+    auto& lease = auto_increment_leases_[table_id];
+    if (lease.start_id < lease.end_id) {
+      int64_t generate_end_id =
+          GetGenerateEndId(lease.start_id, count, auto_increment_increment, auto_increment_offset);
+      if (generate_end_id <= lease.end_id) {
+        start_id = lease.start_id;
+        end_id = generate_end_id;
+        lease.start_id = generate_end_id;
+        served = true;
+      }
+    }
+
+    // renew before exhausted, so the next lease is ready when the current one is used up.
+    if (!lease.leasing && lease.end_id - lease.start_id < lease_count / 2) {
+      lease.leasing = true;
+      need_lease = true;
+    }
+  }
+
+  if (need_lease) {
+    AsyncLeaseAutoIncrement(table_id, static_cast<uint32_t>(lease_count));
+  }
+
+  return served;
+}
+
+void AutoIncrementControl::AsyncLeaseAutoIncrement(int64_t table_id, uint32_t lease_count) {
+  auto lease_function = [this, table_id, lease_count]() {
+    pb::coordinator_internal::MetaIncrement meta_increment;
+    auto* auto_increment = meta_increment.add_auto_increment();
+    auto_increment->set_id(table_id);
+    auto* increment = auto_increment->mutable_increment();
+    increment->set_update_type(pb::coordinator_internal::AutoIncrementUpdateType::READ_MODIFY_WRITE);
+    increment->set_generate_count(lease_count);
+    increment->set_increment(1);
+    increment->set_offset(1);
+    increment->set_lease(true);
+    auto_increment->set_op_type(pb::coordinator_internal::MetaIncrementOpType::UPDATE);
+
+    std::shared_ptr<Context> const ctx = std::make_shared<Context>();
+    ctx->SetRegionId(Constant::kAutoIncrementRegionId);
+
+    auto status = engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), meta_increment));
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << "lease auto increment failed, table id: " << table_id << ", errno=" << status.error_code()
+                         << " errmsg=" << status.error_str();
+      BAIDU_SCOPED_LOCK(auto_increment_map_mutex_);
+      auto it = auto_increment_leases_.find(table_id);
+      if (it != auto_increment_leases_.end()) {
+        it->second.leasing = false;
+      }
+    }
+  };
+
+  Bthread bth(&BTHREAD_ATTR_SMALL);
+  bth.Run(lease_function);
+}
+
+void AutoIncrementControl::ApplyAutoIncrementLease(int64_t table_id, int64_t start_id, int64_t end_id) {
+  auto& lease = auto_increment_leases_[table_id];
+  if (lease.start_id < lease.end_id && lease.end_id == start_id) {
+    // continuous with the current lease, just extend it.
+    lease.end_id = end_id;
+  } else {
+    // the rest of current lease is discarded, which only leaves a gap of ids.
+    lease.start_id = start_id;
+    lease.end_id = end_id;
+  }
+  lease.leasing = false;
+
+  DINGO_LOG(INFO) << "lease auto increment, table id: " << table_id << ", lease: [" << lease.start_id << ", "
+                  << lease.end_id << ")";
+}
+
 butil::Status AutoIncrementControl::DeleteAutoIncrement(int64_t table_id,
                                                         pb::coordinator_internal::MetaIncrement& meta_increment) {
   DINGO_LOG(INFO) << "table id" << table_id;
@@ -289,9 +396,20 @@ bool AutoIncrementControl::IsLeader() { return leader_term_.load(butil::memory_o
 
 void AutoIncrementControl::SetLeaderTerm(int64_t term) { leader_term_.store(term, butil::memory_order_release); }
 
-void AutoIncrementControl::OnLeaderStart(int64_t term) { DINGO_LOG(INFO) << "OnLeaderStart, term=" << term; }
+void AutoIncrementControl::OnLeaderStart(int64_t term) {
+  DINGO_LOG(INFO) << "OnLeaderStart, term=" << term;
 
-void AutoIncrementControl::OnLeaderStop() { DINGO_LOG(INFO) << "OnLeaderStop"; }
+  // leases of the old leader may be in use, never reuse them.
+  BAIDU_SCOPED_LOCK(auto_increment_map_mutex_);
+  auto_increment_leases_.clear();
+}
+
+void AutoIncrementControl::OnLeaderStop() {
+  DINGO_LOG(INFO) << "OnLeaderStop";
+
+  BAIDU_SCOPED_LOCK(auto_increment_map_mutex_);
+  auto_increment_leases_.clear();
+}
 
 // set raft_node to coordinator_control
 void AutoIncrementControl::SetRaftNode(std::shared_ptr<RaftNode> raft_node) { raft_node_ = raft_node; }
@@ -308,6 +426,7 @@ void AutoIncrementControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncr
       DINGO_LOG(INFO) << "create auto increment, table id: " << table_id
                       << ", start id: " << auto_increment.increment().start_id();
       auto_increment_map_[table_id] = auto_increment.increment().start_id();
+      auto_increment_leases_.erase(table_id);
     } else if (auto_increment.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
       int64_t* start_id_ptr = auto_increment_map_.seek(table_id);
       if (start_id_ptr == nullptr) {
@@ -321,7 +440,11 @@ void AutoIncrementControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncr
         int64_t end_id = GetGenerateEndId(source_start_id, auto_increment.increment().generate_count(),
                                           auto_increment.increment().increment(), auto_increment.increment().offset());
         // [source_start_id, end_id) has generated, so next start_id is end_id.
-        if (is_leader && response != nullptr) {
+        if (auto_increment.increment().lease()) {
+          if (is_leader && IsLeader()) {
+            ApplyAutoIncrementLease(table_id, source_start_id, end_id);
+          }
+        } else if (is_leader && response != nullptr) {
           pb::meta::GenerateAutoIncrementResponse* generate_response =
               static_cast<pb::meta::GenerateAutoIncrementResponse*>(response);
           generate_response->set_start_id(source_start_id);
@@ -338,6 +461,7 @@ void AutoIncrementControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncr
                              << auto_increment.increment().source_start_id();
         }
         auto_increment_map_[table_id] = auto_increment.increment().start_id();
+        auto_increment_leases_.erase(table_id);
         DINGO_LOG(INFO) << "update auto increment, table id: " << table_id
                         << ", old start id: " << auto_increment.increment().source_start_id()
                         << ", start id: " << auto_increment.increment().start_id();
@@ -345,6 +469,7 @@ void AutoIncrementControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncr
     } else if (auto_increment.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
       DINGO_LOG(INFO) << "delete auto increment " << auto_increment.ShortDebugString();
       auto_increment_map_.erase(table_id);
+      auto_increment_leases_.erase(table_id);
     }
   }
 }
@@ -448,6 +573,7 @@ bool AutoIncrementControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Me
 
   BAIDU_SCOPED_LOCK(auto_increment_map_mutex_);
   auto_increment_map_.clear();
+  auto_increment_leases_.clear();
   for (int i = 0; i < storage.elements_size(); i++) {
     const auto& element = storage.elements(i);
     auto_increment_map_[element.table_id()] = element.start_id();
@@ -69,6 +69,11 @@ class AutoIncrementControl : public MetaControl {
   butil::Status GenerateAutoIncrement(int64_t table_id, uint32_t count, uint32_t auto_increment_increment,
                                       uint32_t auto_increment_offset,
                                       pb::coordinator_internal::MetaIncrement &meta_increment);
+  // Leader generate from the leased id range in memory without raft, return false if the lease can't serve it,
+  // then the caller must go through raft by GenerateAutoIncrement.
+  // The lease is renewed asynchronously before it is exhausted.
+  bool GenerateAutoIncrementFromLease(int64_t table_id, uint32_t count, uint32_t auto_increment_increment,
+                                      uint32_t auto_increment_offset, int64_t &start_id, int64_t &end_id);
   butil::Status DeleteAutoIncrement(int64_t table_id, pb::coordinator_internal::MetaIncrement &meta_increment);
 
   // Get raft leader's server location
@@ -114,11 +119,24 @@ class AutoIncrementControl : public MetaControl {
   void SetKvEngine(std::shared_ptr<Engine> engine) { engine_ = engine; };
 
  private:
+  // Id range [start_id, end_id) leased by leader, end_id is persisted in auto_increment_map_ by raft.
+  struct AutoIncrementLease {
+    int64_t start_id{0};
+    int64_t end_id{0};
+    bool leasing{false};
+  };
+
+  // Propose a lease of table in background.
+  void AsyncLeaseAutoIncrement(int64_t table_id, uint32_t lease_count);
+  void ApplyAutoIncrementLease(int64_t table_id, int64_t start_id, int64_t end_id);
+
   static int64_t GetGenerateEndId(int64_t start_id, uint32_t count, uint32_t increment, uint32_t offset);
   static int64_t GetRealStartId(int64_t start_id, uint32_t auto_increment_increment, uint32_t auto_increment_offset);
 
   butil::FlatMap<int64_t, int64_t> auto_increment_map_;
   bthread_mutex_t auto_increment_map_mutex_;
+  // protected by auto_increment_map_mutex_, only on leader
+  std::map<int64_t, AutoIncrementLease> auto_increment_leases_;
 
   // node is leader or not
   butil::atomic<int64_t> leader_term_;
@@ -22,13 +22,17 @@
 #include <vector>
 
 #include "braft/configuration.h"
+#include "bthread/bthread.h"
 #include "bthread/mutex.h"
 #include "butil/compiler_specific.h"
+#include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/safe_map.h"
+#include "common/service_access.h"
 #include "coordinator/coordinator_meta_storage.h"
 #include "coordinator/coordinator_prefix.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator_internal.pb.h"
 #include "proto/meta.pb.h"
@@ -36,6 +40,13 @@
 
 namespace dingodb {
 
+DEFINE_bool(enable_coordinator_follower_read, false, "coordinator follower serve meta read requests");
+DEFINE_bool(coordinator_follower_read_strict, false,
+            "coordinator follower get read index from leader and wait it applied before read");
+DEFINE_int64(coordinator_follower_read_max_lag, 1000,
+             "max log count of follower applied index behind committed index for not strict follower read");
+DEFINE_int64(coordinator_follower_read_timeout_ms, 1000, "timeout of get read index and wait apply for follower read");
+
 CoordinatorControl::CoordinatorControl(std::shared_ptr<MetaReader> meta_reader, std::shared_ptr<MetaWriter> meta_writer,
                                        std::shared_ptr<RawEngine> raw_engine_of_meta)
     : meta_reader_(meta_reader), meta_writer_(meta_writer), leader_term_(-1), raw_engine_of_meta_(raw_engine_of_meta) {
@@ -545,6 +556,46 @@ void CoordinatorControl::GetLeaderLocation(pb::common::Location& leader_server_l
   this->GetServerLocation(leader_raft_location, leader_server_location);
 }
 
+bool CoordinatorControl::IsFollowerReadEnabled() { return FLAGS_enable_coordinator_follower_read; }
+
+butil::Status CoordinatorControl::CheckFollowerRead() {
+  if (!FLAGS_enable_coordinator_follower_read) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, "follower read is disabled");
+  }
+  if (raft_node_ == nullptr || !raft_node_->HasLeader()) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, "no leader");
+  }
+
+  if (!FLAGS_coordinator_follower_read_strict) {
+    auto raft_status = raft_node_->GetStatus();
+    if (raft_status->committed_index() - raft_status->known_applied_index() > FLAGS_coordinator_follower_read_max_lag) {
+      return butil::Status(pb::error::ERAFT_NOTLEADER, "follower applied index lag too much");
+    }
+    return butil::Status::OK();
+  }
+
+  // the node service of leader is on its raft endpoint too.
+  int64_t start_time = Helper::TimestampMs();
+  int64_t read_index = 0;
+  auto status = ServiceAccess::ReadIndex(Constant::kMetaRegionId, raft_node_->GetLeaderId().addr,
+                                         FLAGS_coordinator_follower_read_timeout_ms, read_index);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << "follower read get read index failed, leader: " << raft_node_->GetLeaderId().to_string()
+                       << ", error: " << status.error_str();
+    return butil::Status(pb::error::ERAFT_NOTLEADER, status.error_str());
+  }
+
+  auto state_machine = raft_node_->GetStateMachine();
+  while (state_machine->GetAppliedIndex() < read_index) {
+    if (Helper::TimestampMs() - start_time > FLAGS_coordinator_follower_read_timeout_ms) {
+      return butil::Status(pb::error::ERAFT_NOTLEADER, "wait read index applied timeout");
+    }
+    bthread_usleep(1000);
+  }
+
+  return butil::Status::OK();
+}
+
 // GetNextId only update id_epoch_map_temp_ in leader, the persistent id_epoch_map_ will be updated in on_apply
 // When on_leader_start, the id_epoch_map_temp_ will init from id_epoch_map_
 // only id_epoch_map_ is in state machine, and will persistent to raft and local rocksdb
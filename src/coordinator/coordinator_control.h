@@ -15,6 +15,7 @@
 #ifndef DINGODB_COORDINATOR_CONTROL_H_
 #define DINGODB_COORDINATOR_CONTROL_H_
 
+#include <atomic>
 #include <bitset>
 #include <cstdint>
 #include <map>
@@ -29,6 +30,7 @@
 #include "common/meta_control.h"
 #include "common/safe_map.h"
 #include "coordinator/coordinator_meta_storage.h"
+#include "coordinator/meta_snapshot.h"
 #include "engine/engine.h"
 #include "engine/snapshot.h"
 #include "google/protobuf/stubs/callback.h"
@@ -221,6 +223,13 @@ class CoordinatorControl : public MetaControl {
   // Get raft leader's server location for sdk use
   void GetLeaderLocation(pb::common::Location &leader_server_location) override;
 
+  // Follower read of meta, enabled by enable_coordinator_follower_read.
+  static bool IsFollowerReadEnabled();
+  // Check follower can serve read now, ERAFT_NOTLEADER means redirect to leader.
+  // Strict read wait the read index of leader to be applied, otherwise the applied log of follower can't be
+  // behind its committed log too much.
+  butil::Status CheckFollowerRead();
+
   // use raft_location to get server_location
   // in: raft_location
   // out: server_location
@@ -241,9 +250,19 @@ class CoordinatorControl : public MetaControl {
   // in: resource_tag
   // out: new region id
   // return: errno
+  // index_id and meta_increment are for vector aware placement, regions of the index in the uncommitted
+  // meta_increment are counted too.
   butil::Status SelectStore(pb::common::StoreType store_type, int32_t replica_num, const std::string &resource_tag,
                             const pb::common::IndexParameter &index_parameter, std::vector<int64_t> &store_ids,
-                            std::vector<pb::common::Store> &selected_stores_for_regions);
+                            std::vector<pb::common::Store> &selected_stores_for_regions, int64_t index_id,
+                            const pb::coordinator_internal::MetaIncrement &meta_increment);
+
+  // Select index nodes for vector index region by vector index memory, spread regions of the same index and
+  // prefer replicas with the same simd instruction set.
+  void SelectVectorIndexStore(int32_t replica_num, const pb::common::IndexParameter &index_parameter,
+                              int64_t index_id, const pb::coordinator_internal::MetaIncrement &meta_increment,
+                              std::vector<pb::common::Store> &candidate_stores,
+                              std::vector<pb::common::Store> &selected_stores_for_regions);
 
   butil::Status CheckRegionPrefix(const std::string &start_key, const std::string &end_key);
 
@@ -307,6 +326,10 @@ class CoordinatorControl : public MetaControl {
   butil::Status ChangePeerRegionWithTaskList(int64_t region_id, std::vector<int64_t> &new_store_ids,
                                              pb::coordinator_internal::MetaIncrement &meta_increment);
 
+  // change learner region, learners receive the log without joining the quorum
+  butil::Status ChangeLearnerRegionWithTaskList(int64_t region_id, std::vector<int64_t> &new_learner_store_ids,
+                                                pb::coordinator_internal::MetaIncrement &meta_increment);
+
   // transfer leader region
   butil::Status TransferLeaderRegionWithTaskList(int64_t region_id, int64_t new_leader_store_id,
                                                  pb::coordinator_internal::MetaIncrement &meta_increment);
@@ -586,6 +609,10 @@ class CoordinatorControl : public MetaControl {
   static pb::common::RegionStatus GenRegionStatus(const pb::common::RegionMetrics &region_metrics);
 
   void GetRegionMap(pb::common::RegionMap &region_map);
+  // get regions ordered by start key from range_region_map_, at most limit regions from start_key,
+  // next_start_key is empty if no more regions.
+  void GetRegionMap(const std::string &start_key, int64_t limit, pb::common::RegionMap &region_map,
+                    std::string &next_start_key);
   void GetRegionMapFull(pb::common::RegionMap &region_map);
   void GetDeletedRegionMap(pb::common::RegionMap &region_map);
   butil::Status AddDeletedRegionMap(int64_t region_id, bool force);
@@ -594,6 +621,11 @@ class CoordinatorControl : public MetaControl {
   void GetRegionIdsInMap(std::vector<int64_t> &region_ids);
   void RecycleDeletedTableAndIndex();
   void RecycleOutdatedStoreMetrics();
+
+  // balance leaders and replicas between stores by load, see coordinator_control_balance.cc
+  void BalanceLeaderAndRegion();
+  // merge adjacent small regions by region metrics, see coordinator_control_merge.cc
+  void MergeSmallRegions();
   void RecycleOrphanRegionOnStore();
   void RecycleOrphanRegionOnCoordinator();
   void DeleteRegionBvar(int64_t region_id);
@@ -679,9 +711,13 @@ class CoordinatorControl : public MetaControl {
   butil::Status GetIndexMetrics(int64_t schema_id, int64_t index_id, pb::meta::IndexMetricsWithId &index_metrics);
 
   // update store metrics with new metrics
-  // return new epoch
+  // out: need_full_region_metrics, delta region metrics is not based on the last accepted version
+  // return 0 or -1
   int64_t UpdateStoreMetrics(const pb::common::StoreMetrics &store_metrics,
-                             pb::coordinator_internal::MetaIncrement &meta_increment);
+                             pb::coordinator_internal::MetaIncrement &meta_increment, bool &need_full_region_metrics);
+
+  // refresh last_update_timestamp of the regions which store is leader, for unchanged regions of delta heartbeat
+  void TouchRegionMetrics(int64_t store_id, const std::vector<int64_t> &region_ids);
 
   // drop table
   // in: schema_id
@@ -783,6 +819,10 @@ class CoordinatorControl : public MetaControl {
   bool LoadMetaFromSnapshotFile(
       pb::coordinator_internal::MetaSnapshotFile &meta_snapshot_file) override;  // for raft fsm
 
+  // the maps saved in snapshot file, saved and loaded in parallel
+  std::vector<MetaSnapshotSection> GetMetaSnapshotSections(
+      pb::coordinator_internal::MetaSnapshotFile &meta_snapshot_file);
+
   butil::Status UpdateRegionCmdStatus(int64_t task_list_id, int64_t region_cmd_id,
                                       pb::coordinator::RegionCmdStatus status, pb::error::Error error,
                                       pb::coordinator_internal::MetaIncrement &meta_increment);
@@ -836,6 +876,10 @@ class CoordinatorControl : public MetaControl {
   // if task advance, this function will contruct meta_increment and apply to state_machine
   butil::Status ProcessTaskList();
 
+  // Process task lists at once instead of waiting for the crontab, e.g. a store reports the region cmd result,
+  // the crontab is the fallback. The triggers are coalesced, at most one triggered process is pending.
+  void TriggerProcessTaskList();
+
   // process single task
   butil::Status ProcessSingleTaskList(const pb::coordinator::TaskList &task_list,
                                       pb::coordinator_internal::MetaIncrement &meta_increment);
@@ -860,6 +904,9 @@ class CoordinatorControl : public MetaControl {
                                   std::vector<pb::coordinator_internal::RegionInternal> &regions);
   static butil::Status CalcTableInternalRange(const pb::meta::PartitionRule &partition_rule,
                                               pb::common::Range &table_internal_range);
+  // Ranges of the pre-split regions of partition, only the part range if not pre-split.
+  static std::vector<pb::common::Range> CalcPreSplitRanges(const pb::meta::Partition &partition,
+                                                           const pb::common::Range &part_range);
 
   // GC
   butil::Status UpdateGCSafePoint(int64_t safe_point, pb::coordinator::UpdateGCSafePointRequest::GcFlagType gc_flag,
@@ -909,6 +956,13 @@ class CoordinatorControl : public MetaControl {
  private:
   butil::Status ValidateTaskListConflict(int64_t region_id, int64_t second_region_id);
 
+  // region is not in balance cooldown and has no task list
+  bool CanBalanceRegion(int64_t region_id, int64_t now_ms);
+  // remove the old peer of region moves which new peer is added
+  void ProcessBalanceRegionMoves(int64_t now_ms, pb::coordinator_internal::MetaIncrement &meta_increment);
+  // region is normal and not in merge cooldown
+  bool CanMergeRegion(const pb::coordinator_internal::RegionInternal &region, int64_t now_ms);
+
   butil::Status GenerateTableIdAndPartIds(int64_t schema_id, int64_t part_count, pb::meta::EntityType entity_type,
                                           pb::coordinator_internal::MetaIncrement &meta_increment,
                                           pb::meta::TableIdWithPartIds *ids);
@@ -968,6 +1022,17 @@ class CoordinatorControl : public MetaControl {
   std::map<int64_t, StoreMetricsSlim> store_metrics_map_;
   bthread_mutex_t store_metrics_map_mutex_;
 
+  // balance state, only for leader use, only accessed by the balance task
+  struct BalanceRegionMove {
+    int64_t source_store_id;
+    int64_t target_store_id;
+    int64_t start_ms;
+  };
+  std::map<int64_t, BalanceRegionMove> balance_region_moves_;
+  std::map<int64_t, int64_t> balance_region_last_move_ms_;
+  // merge state, only for leader use, only accessed by the merge task
+  std::map<int64_t, int64_t> merge_region_last_ms_;
+
   // 8.table_metrics
   DingoSafeMap<int64_t, pb::coordinator_internal::TableMetricsInternal> table_metrics_map_;
 
@@ -1035,6 +1100,7 @@ class CoordinatorControl : public MetaControl {
   // raft kv engine
   std::shared_ptr<Engine> engine_;
   butil::atomic<bool> is_processing_task_list_;
+  std::atomic<bool> is_task_list_process_pending_{false};
 
   // bvar
   MetaBvarCoordinator coordinator_bvar_;
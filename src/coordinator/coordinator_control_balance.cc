@@ -0,0 +1,406 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "butil/containers/flat_map.h"
+#include "butil/time.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "coordinator/coordinator_control.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/coordinator_internal.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_balance_leader, false, "balance region leaders between stores by leader count, qps and cpu");
+DEFINE_bool(enable_balance_region, false, "balance region replicas between stores by region count and disk usage");
+DEFINE_double(balance_tolerance_ratio, 0.2,
+              "only balance store which score is higher than average * (1 + ratio), avoid balance back and forth");
+DEFINE_int32(balance_leader_max_ops, 4, "max transfer leader operations of a balance round");
+DEFINE_int32(balance_region_max_ops, 1, "max move region operations of a balance round");
+DEFINE_int64(balance_region_cooldown_s, 600, "region is not balanced again in cooldown seconds after balanced");
+DEFINE_int64(balance_region_move_timeout_s, 1800, "give up a region move if the new peer is not added in timeout");
+DEFINE_double(balance_count_weight, 1.0, "weight of leader/region count in store score");
+DEFINE_double(balance_qps_weight, 1.0, "weight of leader read/write qps in store score");
+DEFINE_double(balance_cpu_weight, 0.5, "weight of process cpu usage in store score");
+DEFINE_double(balance_disk_weight, 1.0, "weight of disk usage in store score");
+
+DECLARE_int32(vector_index_warm_follower_num);
+
+namespace {
+
+struct StoreLoad {
+  int64_t store_id{0};
+  int64_t leader_count{0};
+  int64_t region_count{0};
+  int64_t leader_qps{0};
+  double cpu_usage{0};
+  double disk_used_ratio{0};
+
+  double leader_score{0};
+  double region_score{0};
+};
+
+struct RegionLoad {
+  int64_t region_id{0};
+  int64_t leader_store_id{0};
+  int64_t qps{0};
+  std::vector<int64_t> store_ids;
+  // store ids the leader can transfer to.
+  std::vector<int64_t> leader_store_ids;
+};
+
+double Ratio(double value, double average) { return average > 0 ? value / average : 0; }
+
+// Score of every store is the weighted sum of the ratio of its load to the group average,
+// so the average score is the sum of active weights.
+void CalcScore(std::vector<StoreLoad*>& stores) {
+  double leader_count = 0, leader_qps = 0, cpu_usage = 0, region_count = 0, disk_used_ratio = 0;
+  for (auto* store : stores) {
+    leader_count += store->leader_count;
+    leader_qps += store->leader_qps;
+    cpu_usage += store->cpu_usage;
+    region_count += store->region_count;
+    disk_used_ratio += store->disk_used_ratio;
+  }
+  double n = stores.size();
+  for (auto* store : stores) {
+    store->leader_score = FLAGS_balance_count_weight * Ratio(store->leader_count, leader_count / n) +
+                          FLAGS_balance_qps_weight * Ratio(store->leader_qps, leader_qps / n) +
+                          FLAGS_balance_cpu_weight * Ratio(store->cpu_usage, cpu_usage / n);
+    store->region_score = FLAGS_balance_count_weight * Ratio(store->region_count, region_count / n) +
+                          FLAGS_balance_disk_weight * Ratio(store->disk_used_ratio, disk_used_ratio / n);
+  }
+}
+
+double AverageScore(const std::vector<StoreLoad*>& stores, bool is_leader) {
+  double sum = 0;
+  for (const auto* store : stores) {
+    sum += is_leader ? store->leader_score : store->region_score;
+  }
+  return stores.empty() ? 0 : sum / stores.size();
+}
+
+}  // namespace
+
+bool CoordinatorControl::CanBalanceRegion(int64_t region_id, int64_t now_ms) {
+  auto it = balance_region_last_move_ms_.find(region_id);
+  if (it != balance_region_last_move_ms_.end() && it->second + FLAGS_balance_region_cooldown_s * 1000 > now_ms) {
+    return false;
+  }
+
+  return ValidateTaskListConflict(region_id, region_id).ok();
+}
+
+// Move a replica in two steps, add the new peer first, then remove the old peer after the new peer is added.
+void CoordinatorControl::ProcessBalanceRegionMoves(int64_t now_ms,
+                                                   pb::coordinator_internal::MetaIncrement& meta_increment) {
+  for (auto it = balance_region_moves_.begin(); it != balance_region_moves_.end();) {
+    int64_t region_id = it->first;
+    const auto& move = it->second;
+
+    pb::coordinator_internal::RegionInternal region;
+    if (region_map_.Get(region_id, region) < 0 || region.state() != pb::common::RegionState::REGION_NORMAL) {
+      it = balance_region_moves_.erase(it);
+      continue;
+    }
+
+    std::vector<int64_t> store_ids;
+    bool has_source = false, has_target = false;
+    for (const auto& peer : region.definition().peers()) {
+      if (peer.role() == pb::common::PeerRole::LEARNER) {
+        continue;
+      }
+      has_source = has_source || peer.store_id() == move.source_store_id;
+      has_target = has_target || peer.store_id() == move.target_store_id;
+      if (peer.store_id() != move.source_store_id) {
+        store_ids.push_back(peer.store_id());
+      }
+    }
+
+    if (!has_source) {
+      it = balance_region_moves_.erase(it);
+      continue;
+    }
+    if (!has_target) {
+      if (move.start_ms + FLAGS_balance_region_move_timeout_s * 1000 < now_ms) {
+        DINGO_LOG(WARNING) << fmt::format("[balance.region][region({})] add peer on store({}) timeout, give up.",
+                                          region_id, move.target_store_id);
+        it = balance_region_moves_.erase(it);
+      } else {
+        ++it;
+      }
+      continue;
+    }
+
+    if (!ValidateTaskListConflict(region_id, region_id).ok()) {
+      ++it;
+      continue;
+    }
+
+    auto status = ChangePeerRegionWithTaskList(region_id, store_ids, meta_increment);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[balance.region][region({})] remove peer on store({}) failed, error: {}",
+                                        region_id, move.source_store_id, status.error_str());
+      ++it;
+      continue;
+    }
+
+    DINGO_LOG(INFO) << fmt::format("[balance.region][region({})] remove peer on store({}), move to store({}) finish.",
+                                   region_id, move.source_store_id, move.target_store_id);
+    balance_region_last_move_ms_[region_id] = now_ms;
+    it = balance_region_moves_.erase(it);
+  }
+}
+
+void CoordinatorControl::BalanceLeaderAndRegion() {
+  if (!IsLeader()) {
+    return;
+  }
+  if (!FLAGS_enable_balance_leader && !FLAGS_enable_balance_region) {
+    return;
+  }
+
+  int64_t now_ms = butil::gettimeofday_ms();
+  pb::coordinator_internal::MetaIncrement meta_increment;
+
+  for (auto it = balance_region_last_move_ms_.begin(); it != balance_region_last_move_ms_.end();) {
+    if (it->second + FLAGS_balance_region_cooldown_s * 1000 <= now_ms) {
+      it = balance_region_last_move_ms_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  if (FLAGS_enable_balance_region) {
+    ProcessBalanceRegionMoves(now_ms, meta_increment);
+  }
+
+  // collect store load
+  butil::FlatMap<int64_t, pb::common::Store> store_map_copy;
+  store_map_copy.init(100);
+  store_map_.GetRawMapCopy(store_map_copy);
+
+  std::map<int64_t, StoreLoad> store_loads;
+  // stores with same type and resource tag are balanced together
+  std::map<std::string, std::vector<StoreLoad*>> store_groups;
+  {
+    BAIDU_SCOPED_LOCK(store_metrics_map_mutex_);
+    for (const auto& [store_id, store] : store_map_copy) {
+      if (store.state() != pb::common::StoreState::STORE_NORMAL ||
+          store.in_state() != pb::common::StoreInState::STORE_IN) {
+        continue;
+      }
+      if (store.store_type() != pb::common::StoreType::NODE_TYPE_STORE &&
+          store.store_type() != pb::common::StoreType::NODE_TYPE_INDEX) {
+        continue;
+      }
+
+      auto& store_load = store_loads[store_id];
+      store_load.store_id = store_id;
+      auto metrics_it = store_metrics_map_.find(store_id);
+      if (metrics_it != store_metrics_map_.end()) {
+        const auto& own_metrics = metrics_it->second.store_own_metrics;
+        store_load.cpu_usage = own_metrics.process_used_cpu();
+        if (own_metrics.system_total_capacity() > 0) {
+          store_load.disk_used_ratio =
+              1.0 - static_cast<double>(own_metrics.system_free_capacity()) / own_metrics.system_total_capacity();
+        }
+      }
+      store_groups[fmt::format("{}_{}", static_cast<int>(store.store_type()), store.resource_tag())].push_back(
+          &store_load);
+    }
+  }
+
+  // collect region load
+  butil::FlatMap<int64_t, pb::coordinator_internal::RegionInternal> regions;
+  regions.init(3000);
+  region_map_.GetRawMapCopy(regions);
+
+  std::map<int64_t, std::vector<RegionLoad>> store_leader_regions;
+  std::map<int64_t, std::vector<RegionLoad>> store_regions;
+  for (const auto& [region_id, region] : regions) {
+    if (region.state() != pb::common::RegionState::REGION_NORMAL) {
+      continue;
+    }
+
+    RegionLoad region_load;
+    region_load.region_id = region_id;
+    pb::common::RegionMetrics region_metrics;
+    if (region_metrics_map_.Get(region_id, region_metrics) >= 0) {
+      region_load.leader_store_id = region_metrics.leader_store_id();
+      region_load.qps = region_metrics.read_qps() + region_metrics.write_qps();
+    }
+    bool need_warm_peer = region.region_type() == pb::common::INDEX_REGION && FLAGS_vector_index_warm_follower_num > 0;
+    for (const auto& peer : region.definition().peers()) {
+      // learners are placed on the dedicated stores, not balanced with voters.
+      if (peer.role() == pb::common::PeerRole::LEARNER) {
+        continue;
+      }
+      region_load.store_ids.push_back(peer.store_id());
+      if (!need_warm_peer || Helper::IsVectorIndexWarmPeer(region.definition(), peer.store_id(),
+                                                           FLAGS_vector_index_warm_follower_num)) {
+        region_load.leader_store_ids.push_back(peer.store_id());
+      }
+    }
+
+    for (auto store_id : region_load.store_ids) {
+      auto store_it = store_loads.find(store_id);
+      if (store_it == store_loads.end()) {
+        continue;
+      }
+      ++store_it->second.region_count;
+      store_regions[store_id].push_back(region_load);
+      if (store_id == region_load.leader_store_id) {
+        ++store_it->second.leader_count;
+        store_it->second.leader_qps += region_load.qps;
+        store_leader_regions[store_id].push_back(region_load);
+      }
+    }
+  }
+
+  for (auto& [group, stores] : store_groups) {
+    if (stores.size() < 2) {
+      continue;
+    }
+    CalcScore(stores);
+
+    // balance leader, transfer leader from the highest score store to its follower with lowest score.
+    for (int i = 0; FLAGS_enable_balance_leader && i < FLAGS_balance_leader_max_ops; ++i) {
+      double average = AverageScore(stores, true);
+      auto* source = *std::max_element(stores.begin(), stores.end(), [](const StoreLoad* lhs, const StoreLoad* rhs) {
+        return lhs->leader_score < rhs->leader_score;
+      });
+      if (source->leader_score <= average * (1 + FLAGS_balance_tolerance_ratio)) {
+        break;
+      }
+
+      // hottest region first, but not make the target hotter than the source.
+      auto& leader_regions = store_leader_regions[source->store_id];
+      std::sort(leader_regions.begin(), leader_regions.end(),
+                [](const RegionLoad& lhs, const RegionLoad& rhs) { return lhs.qps > rhs.qps; });
+
+      bool transferred = false;
+      for (auto region_it = leader_regions.begin(); region_it != leader_regions.end(); ++region_it) {
+        if (!CanBalanceRegion(region_it->region_id, now_ms)) {
+          continue;
+        }
+
+        StoreLoad* target = nullptr;
+        for (auto store_id : region_it->leader_store_ids) {
+          auto store_it = store_loads.find(store_id);
+          if (store_id == source->store_id || store_it == store_loads.end() ||
+              store_it->second.leader_score >= average) {
+            continue;
+          }
+          if (target == nullptr || store_it->second.leader_score < target->leader_score) {
+            target = &store_it->second;
+          }
+        }
+        if (target == nullptr ||
+            (region_it->qps > 0 && target->leader_qps + region_it->qps > source->leader_qps - region_it->qps)) {
+          continue;
+        }
+
+        auto status = TransferLeaderRegionWithTaskList(region_it->region_id, target->store_id, meta_increment);
+        if (!status.ok()) {
+          DINGO_LOG(WARNING) << fmt::format("[balance.leader][region({})] transfer leader to store({}) failed, error: {}",
+                                            region_it->region_id, target->store_id, status.error_str());
+          continue;
+        }
+
+        DINGO_LOG(INFO) << fmt::format(
+            "[balance.leader][region({})] transfer leader from store({}) score({:.2f}) to store({}) score({:.2f}), "
+            "average score({:.2f}) qps({})",
+            region_it->region_id, source->store_id, source->leader_score, target->store_id, target->leader_score,
+            average, region_it->qps);
+
+        balance_region_last_move_ms_[region_it->region_id] = now_ms;
+        --source->leader_count;
+        source->leader_qps -= region_it->qps;
+        ++target->leader_count;
+        target->leader_qps += region_it->qps;
+        leader_regions.erase(region_it);
+        CalcScore(stores);
+        transferred = true;
+        break;
+      }
+      if (!transferred) {
+        break;
+      }
+    }
+
+    // balance region, add a follower replica of the highest score store to the lowest score store.
+    for (int i = 0; FLAGS_enable_balance_region && i < FLAGS_balance_region_max_ops &&
+                    static_cast<int64_t>(balance_region_moves_.size()) < FLAGS_balance_region_max_ops;
+         ++i) {
+      double average = AverageScore(stores, false);
+      auto comp = [](const StoreLoad* lhs, const StoreLoad* rhs) { return lhs->region_score < rhs->region_score; };
+      auto* source = *std::max_element(stores.begin(), stores.end(), comp);
+      auto* target = *std::min_element(stores.begin(), stores.end(), comp);
+      if (source->region_score <= average * (1 + FLAGS_balance_tolerance_ratio) || target->region_score >= average) {
+        break;
+      }
+
+      bool moved = false;
+      for (const auto& region_load : store_regions[source->store_id]) {
+        if (region_load.leader_store_id == source->store_id ||
+            std::find(region_load.store_ids.begin(), region_load.store_ids.end(), target->store_id) !=
+                region_load.store_ids.end() ||
+            balance_region_moves_.find(region_load.region_id) != balance_region_moves_.end() ||
+            !CanBalanceRegion(region_load.region_id, now_ms)) {
+          continue;
+        }
+
+        std::vector<int64_t> new_store_ids = region_load.store_ids;
+        new_store_ids.push_back(target->store_id);
+        auto status = ChangePeerRegionWithTaskList(region_load.region_id, new_store_ids, meta_increment);
+        if (!status.ok()) {
+          DINGO_LOG(WARNING) << fmt::format("[balance.region][region({})] add peer on store({}) failed, error: {}",
+                                            region_load.region_id, target->store_id, status.error_str());
+          continue;
+        }
+
+        DINGO_LOG(INFO) << fmt::format(
+            "[balance.region][region({})] move from store({}) score({:.2f}) to store({}) score({:.2f}), average "
+            "score({:.2f})",
+            region_load.region_id, source->store_id, source->region_score, target->store_id, target->region_score,
+            average);
+
+        balance_region_moves_[region_load.region_id] = {source->store_id, target->store_id, now_ms};
+        --source->region_count;
+        ++target->region_count;
+        CalcScore(stores);
+        moved = true;
+        break;
+      }
+      if (!moved) {
+        break;
+      }
+    }
+  }
+
+  if (meta_increment.ByteSizeLong() > 0) {
+    SubmitMetaIncrementSync(meta_increment);
+  }
+}
+
+}  // namespace dingodb
@@ -18,6 +18,8 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <map>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -40,6 +42,7 @@
 #include "proto/error.pb.h"
 #include "proto/meta.pb.h"
 #include "server/server.h"
+#include "store/heartbeat.h"
 #include "vector/vector_index_hnsw.h"
 #include "vector/vector_index_utils.h"
 
@@ -55,6 +58,8 @@ DECLARE_bool(ip2hostname);
 DEFINE_int32(table_delete_after_deleted_time, 86400, "delete table after deleted time in seconds");
 DEFINE_int32(index_delete_after_deleted_time, 86400, "delete index after deleted time in seconds");
 DEFINE_int64(store_metrics_keep_time_s, 3600, "store metrics keep time in seconds");
+DEFINE_bool(coordinator_task_list_trigger_on_event, true,
+            "process task list at once when store reports region cmd result or heartbeat, not only by crontab");
 
 DEFINE_int32(
     region_update_timeout, 25,
@@ -74,6 +79,9 @@ DEFINE_int32(max_send_region_cmd_per_store, 100, "max send region cmd per store"
 
 DEFINE_int64(max_region_count, 40000, "max region of dingo");
 
+DEFINE_bool(enable_vector_aware_placement, false,
+            "place vector index regions by vector index memory and spread regions of the same index");
+
 // TODO: add epoch logic
 void CoordinatorControl::GetCoordinatorMap(int64_t cluster_id, int64_t& epoch, pb::common::Location& leader_location,
                                            std::vector<pb::common::Location>& locations,
@@ -878,10 +886,8 @@ void CoordinatorControl::GetRegionMap(pb::common::RegionMap& region_map) {
     butil::FlatMap<int64_t, pb::coordinator_internal::RegionInternal> region_internal_map_copy;
     region_internal_map_copy.init(30000);
     region_map_.GetRawMapCopy(region_internal_map_copy);
-    butil::FlatMap<int64_t, pb::common::RegionMetrics> region_metrics_map_copy;
-    region_metrics_map_copy.init(30000);
-    region_metrics_map_.GetRawMapCopy(region_metrics_map_copy);
 
+    region_map.mutable_regions()->Reserve(region_internal_map_copy.size());
     for (auto& element : region_internal_map_copy) {
       auto* tmp_region = region_map.add_regions();
       GenRegionSlim(element.second, *tmp_region);
@@ -889,6 +895,31 @@ void CoordinatorControl::GetRegionMap(pb::common::RegionMap& region_map) {
   }
 }
 
+void CoordinatorControl::GetRegionMap(const std::string& start_key, int64_t limit, pb::common::RegionMap& region_map,
+                                      std::string& next_start_key) {
+  region_map.set_epoch(GetPresentId(pb::coordinator_internal::IdEpochType::EPOCH_REGION));
+
+  // one more region to get the start key of next page
+  std::vector<pb::coordinator_internal::RegionInternal> region_internals;
+  range_region_map_.FindIntervalValues(
+      region_internals, start_key, std::string(9, '\xff'), nullptr,
+      [&start_key](const pb::coordinator_internal::RegionInternal& region) {
+        return region.id() > 0 && region.definition().range().start_key() >= start_key;
+      },
+      limit + 1);
+
+  next_start_key.clear();
+  if (static_cast<int64_t>(region_internals.size()) > limit) {
+    next_start_key = region_internals.back().definition().range().start_key();
+    region_internals.pop_back();
+  }
+
+  region_map.mutable_regions()->Reserve(region_internals.size());
+  for (const auto& region_internal : region_internals) {
+    GenRegionSlim(region_internal, *region_map.add_regions());
+  }
+}
+
 void CoordinatorControl::GetRegionMapFull(pb::common::RegionMap& region_map) {
   region_map.set_epoch(GetPresentId(pb::coordinator_internal::IdEpochType::EPOCH_REGION));
   {
@@ -1401,7 +1432,9 @@ butil::Status CoordinatorControl::SelectStore(pb::common::StoreType store_type,
                                               const std::string& resource_tag,
                                               const pb::common::IndexParameter& index_parameter,
                                               std::vector<int64_t>& store_ids,
-                                              std::vector<pb::common::Store>& selected_stores_for_regions) {
+                                              std::vector<pb::common::Store>& selected_stores_for_regions,
+                                              int64_t index_id,
+                                              const pb::coordinator_internal::MetaIncrement& meta_increment) {
   DINGO_LOG(INFO) << "SelectStore replica_num=" << replica_num << ", resource_tag=" << resource_tag
                   << ", store_ids.size=" << store_ids.size();
 
@@ -1626,6 +1659,18 @@ butil::Status CoordinatorControl::SelectStore(pb::common::StoreType store_type,
   }
   stores_for_regions.swap(tmp_stores_for_regions);
 
+  if (store_type == pb::common::StoreType::NODE_TYPE_INDEX && FLAGS_enable_vector_aware_placement) {
+    SelectVectorIndexStore(replica_num, index_parameter, index_id, meta_increment, stores_for_regions,
+                           selected_stores_for_regions);
+    if (selected_stores_for_regions.size() == replica_num) {
+      return butil::Status::OK();
+    }
+
+    selected_stores_for_regions.clear();
+    return butil::Status(pb::error::Errno::EREGION_UNAVAILABLE,
+                         "Not enough index nodes with enough memory for vector index region");
+  }
+
   struct StoreMore {
     pb::common::Store store;
     int64_t weight;
@@ -1731,6 +1776,120 @@ butil::Status CoordinatorControl::SelectStore(pb::common::StoreType store_type,
   return butil::Status::OK();
 }
 
+void CoordinatorControl::SelectVectorIndexStore(int32_t replica_num, const pb::common::IndexParameter& index_parameter,
+                                                int64_t index_id,
+                                                const pb::coordinator_internal::MetaIncrement& meta_increment,
+                                                std::vector<pb::common::Store>& candidate_stores,
+                                                std::vector<pb::common::Store>& selected_stores_for_regions) {
+  struct IndexStoreLoad {
+    pb::common::Store store;
+    int64_t index_region_count{0};
+    int64_t vector_index_memory{0};
+    int64_t available_memory{0};
+    int64_t total_memory{0};
+    std::string simd_name;
+  };
+
+  std::map<int64_t, IndexStoreLoad> store_loads;
+  int64_t index_memory = 0;
+  int64_t index_memory_region_count = 0;
+  for (const auto& store : candidate_stores) {
+    auto& store_load = store_loads[store.id()];
+    store_load.store = store;
+
+    std::vector<pb::common::StoreMetrics> store_metrics;
+    GetStoreRegionMetrics(store.id(), store_metrics);
+    if (store_metrics.empty()) {
+      continue;
+    }
+
+    const auto& own_metrics = store_metrics[0].store_own_metrics();
+    store_load.available_memory = own_metrics.system_available_memory();
+    store_load.total_memory = own_metrics.system_total_memory();
+    store_load.simd_name = own_metrics.simd_name();
+    for (const auto& [region_id, region_metrics] : store_metrics[0].region_metrics_map()) {
+      int64_t memory_bytes = region_metrics.vector_index_metrics().memory_bytes();
+      store_load.vector_index_memory += memory_bytes;
+      if (index_id > 0 && region_metrics.region_definition().index_id() == index_id) {
+        ++store_load.index_region_count;
+        index_memory += memory_bytes;
+        ++index_memory_region_count;
+      }
+    }
+  }
+
+  // memory of new region, average of the existing regions of the index, or the plan memory of hnsw.
+  int64_t region_memory = 0;
+  if (index_memory_region_count > 0) {
+    region_memory = index_memory / index_memory_region_count;
+  } else if (index_parameter.vector_index_parameter().vector_index_type() == pb::common::VECTOR_INDEX_TYPE_HNSW) {
+    const auto& hnsw_parameter = index_parameter.vector_index_parameter().hnsw_parameter();
+    region_memory = static_cast<int64_t>(hnsw_parameter.dimension()) * hnsw_parameter.max_elements() * 4;
+  }
+
+  // regions placed in the same meta_increment, e.g. other partitions of a creating index.
+  for (const auto& region_increment : meta_increment.regions()) {
+    if (region_increment.op_type() != pb::coordinator_internal::MetaIncrementOpType::CREATE) {
+      continue;
+    }
+    const auto& definition = region_increment.region().definition();
+    for (const auto& peer : definition.peers()) {
+      auto it = store_loads.find(peer.store_id());
+      if (it == store_loads.end()) {
+        continue;
+      }
+      it->second.vector_index_memory += region_memory;
+      it->second.available_memory -= region_memory;
+      if (index_id > 0 && definition.index_id() == index_id) {
+        ++it->second.index_region_count;
+      }
+    }
+  }
+
+  std::vector<IndexStoreLoad> loads;
+  for (auto& [store_id, store_load] : store_loads) {
+    if (store_load.total_memory > 0 && store_load.available_memory < region_memory) {
+      DINGO_LOG(INFO) << fmt::format("[placement][store({})] available memory {} is not enough for region memory {}",
+                                     store_id, store_load.available_memory, region_memory);
+      continue;
+    }
+    loads.push_back(store_load);
+  }
+
+  // fewer regions of the index first for search fan-out, then lower vector index memory ratio.
+  auto memory_ratio = [](const IndexStoreLoad& load) {
+    return load.total_memory > 0 ? static_cast<double>(load.vector_index_memory) / load.total_memory : 0;
+  };
+  std::sort(loads.begin(), loads.end(), [&](const IndexStoreLoad& lhs, const IndexStoreLoad& rhs) {
+    if (lhs.index_region_count != rhs.index_region_count) {
+      return lhs.index_region_count < rhs.index_region_count;
+    }
+    return memory_ratio(lhs) < memory_ratio(rhs);
+  });
+  if (loads.size() < replica_num) {
+    return;
+  }
+
+  // replicas with the same simd as the best store, if there are enough of them.
+  const auto& simd_name = loads[0].simd_name;
+  int64_t same_simd_count = std::count_if(loads.begin(), loads.end(),
+                                          [&](const IndexStoreLoad& load) { return load.simd_name == simd_name; });
+  if (same_simd_count >= replica_num) {
+    std::stable_partition(loads.begin(), loads.end(),
+                          [&](const IndexStoreLoad& load) { return load.simd_name == simd_name; });
+  }
+
+  std::string store_ids_str;
+  for (int i = 0; i < replica_num; ++i) {
+    selected_stores_for_regions.push_back(loads[i].store);
+    store_ids_str += fmt::format("{}({},{},{}),", loads[i].store.id(), loads[i].index_region_count,
+                                 loads[i].vector_index_memory, loads[i].simd_name);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[placement] index({}) region memory({}) select stores: {}", index_id, region_memory,
+                                 store_ids_str);
+}
+
 butil::Status CoordinatorControl::ValidateMaxRegionCount() {
   auto region_count = region_map_.Size();
   if (region_count > FLAGS_max_region_count) {
@@ -2042,7 +2201,8 @@ butil::Status CoordinatorControl::CreateRegionFinal(
   }
 
   // select store for region
-  ret = SelectStore(store_type, replica_num, resource_tag, new_index_parameter, store_ids, selected_stores_for_regions);
+  ret = SelectStore(store_type, replica_num, resource_tag, new_index_parameter, store_ids, selected_stores_for_regions,
+                    index_id, meta_increment);
   if (!ret.ok()) {
     return ret;
   }
@@ -2173,8 +2333,9 @@ butil::Status CoordinatorControl::GetCreateRegionStoreIds(pb::common::RegionType
   }
 
   // select store for region
-  auto ret =
-      SelectStore(store_type, replica_num, resource_tag, index_parameter, store_ids, selected_stores_for_regions);
+  pb::coordinator_internal::MetaIncrement meta_increment;
+  auto ret = SelectStore(store_type, replica_num, resource_tag, index_parameter, store_ids,
+                         selected_stores_for_regions, 0, meta_increment);
   if (!ret.ok()) {
     return ret;
   }
@@ -2321,6 +2482,12 @@ butil::Status CoordinatorControl::DropRegionPermanently(int64_t region_id,
   return butil::Status::OK();
 }
 
+static bool HasLearnerPeer(const pb::common::RegionDefinition& definition) {
+  return std::any_of(definition.peers().begin(), definition.peers().end(), [](const pb::common::Peer& peer) {
+    return peer.role() == pb::common::PeerRole::LEARNER;
+  });
+}
+
 butil::Status CoordinatorControl::SplitRegion(int64_t split_from_region_id, int64_t split_to_region_id,
                                               std::string split_watershed_key,
                                               pb::coordinator_internal::MetaIncrement& meta_increment) {
@@ -2332,6 +2499,12 @@ butil::Status CoordinatorControl::SplitRegion(int64_t split_from_region_id, int6
     return butil::Status(pb::error::Errno::EREGION_NOT_FOUND, "SplitRegion from region not exists");
   }
 
+  // learner does not apply split, remove the learners before split.
+  if (HasLearnerPeer(split_from_region.definition())) {
+    DINGO_LOG(ERROR) << "SplitRegion from region has learner, id = " << split_from_region_id;
+    return butil::Status(pb::error::Errno::ESPLIT_STATUS_ILLEGAL, "SplitRegion from region has learner");
+  }
+
   // validate split_to_region_id
   pb::coordinator_internal::RegionInternal split_to_region;
   ret = region_map_.Get(split_to_region_id, split_to_region);
@@ -2472,6 +2645,12 @@ butil::Status CoordinatorControl::SplitRegionWithTaskList(int64_t split_from_reg
     return butil::Status(pb::error::Errno::EREGION_NOT_FOUND, "SplitRegion from region not exists");
   }
 
+  // learner does not apply split, remove the learners before split.
+  if (HasLearnerPeer(split_from_region.definition())) {
+    DINGO_LOG(ERROR) << "SplitRegion from region has learner, id = " << split_from_region_id;
+    return butil::Status(pb::error::Errno::ESPLIT_STATUS_ILLEGAL, "SplitRegion from region has learner");
+  }
+
   // validate split_watershed_key
   if (split_watershed_key.empty()) {
     DINGO_LOG(ERROR) << "SplitRegion split_watershed_key is empty";
@@ -2709,6 +2888,13 @@ butil::Status CoordinatorControl::MergeRegionWithTaskList(int64_t merge_from_reg
                          "MergeRegion merge_from_region_id == merge_to_region_id");
   }
 
+  // learner does not apply merge, remove the learners before merge.
+  if (HasLearnerPeer(merge_from_region.definition()) || HasLearnerPeer(merge_to_region.definition())) {
+    DINGO_LOG(ERROR) << "MergeRegion region has learner, merge_from_region_id = " << merge_from_region_id
+                     << ", merge_to_region_id = " << merge_to_region_id;
+    return butil::Status(pb::error::Errno::EMERGE_STATUS_ILLEGAL, "MergeRegion region has learner");
+  }
+
   // validate region peers
   if (Helper::IsDifferencePeers(merge_from_region.definition(), merge_to_region.definition())) {
     return butil::Status(pb::error::EMERGE_PEER_NOT_MATCH, "Peers is differencce.");
@@ -2894,6 +3080,23 @@ butil::Status CoordinatorControl::ChangePeerRegionWithTaskList(
     return butil::Status(pb::error::Errno::EREGION_NOT_FOUND, "ChangePeerRegion region not exists");
   }
 
+  // learners are changed by ChangeLearnerRegionWithTaskList, only voters are changed here
+  std::vector<int64_t> old_store_ids;
+  std::set<int64_t> learner_store_ids;
+  for (const auto& peer : region.definition().peers()) {
+    if (peer.role() == pb::common::PeerRole::LEARNER) {
+      learner_store_ids.insert(peer.store_id());
+    } else {
+      old_store_ids.push_back(peer.store_id());
+    }
+  }
+  for (auto store_id : new_store_ids) {
+    if (learner_store_ids.count(store_id) > 0) {
+      DINGO_LOG(ERROR) << "ChangePeerRegion, region_id=" << region_id << ", store has learner, store_id = " << store_id;
+      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "ChangePeerRegion store has learner");
+    }
+  }
+
   // validate region has NORMAL status
   auto region_status = GetRegionStatus(region_id);
   if (region.state() != ::dingodb::pb::common::RegionState::REGION_NORMAL ||
@@ -2920,21 +3123,15 @@ butil::Status CoordinatorControl::ChangePeerRegionWithTaskList(
   }
 
   // validate new_store_ids
-  if (new_store_ids.size() != (region.definition().peers_size() + 1) &&
-      new_store_ids.size() != (region.definition().peers_size() - 1) && (!new_store_ids.empty())) {
+  if (new_store_ids.size() != (old_store_ids.size() + 1) && new_store_ids.size() != (old_store_ids.size() - 1) &&
+      (!new_store_ids.empty())) {
     DINGO_LOG(ERROR) << "ChangePeerRegion, region_id=" << region_id
                      << ", new_store_ids size not match, region_id = " << region_id
-                     << " old_size = " << region.definition().peers_size() << " new_size = " << new_store_ids.size();
+                     << " old_size = " << old_store_ids.size() << " new_size = " << new_store_ids.size();
     return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "ChangePeerRegion new_store_ids size not match");
   }
 
   // validate new_store_ids only has one new store or only less one store
-  std::vector<int64_t> old_store_ids;
-  old_store_ids.reserve(region.definition().peers_size());
-  for (int i = 0; i < region.definition().peers_size(); i++) {
-    old_store_ids.push_back(region.definition().peers(i).store_id());
-  }
-
   if (old_store_ids.empty()) {
     DINGO_LOG(ERROR) << "ChangePeerRegion, region_id=" << region_id
                      << ", old_store_ids is empty, region_id = " << region_id;
@@ -3141,6 +3338,144 @@ butil::Status CoordinatorControl::ChangePeerRegionWithTaskList(
   return butil::Status::OK();
 }
 
+// ChangeLearnerRegionWithTaskList
+// Add or remove one learner of store region. The learner region is created on the store first, then the leader
+// changes the learners of region definition by raft log, voters are not changed.
+butil::Status CoordinatorControl::ChangeLearnerRegionWithTaskList(
+    int64_t region_id, std::vector<int64_t>& new_learner_store_ids,
+    pb::coordinator_internal::MetaIncrement& meta_increment) {
+  auto validate_ret = ValidateTaskListConflict(region_id, region_id);
+  if (!validate_ret.ok()) {
+    DINGO_LOG(ERROR) << "ChangeLearnerRegion validate task list conflict failed, region_id=" << region_id;
+    return validate_ret;
+  }
+
+  pb::coordinator_internal::RegionInternal region;
+  int ret = region_map_.Get(region_id, region);
+  if (ret < 0) {
+    DINGO_LOG(ERROR) << "ChangeLearnerRegion region not exists, id = " << region_id;
+    return butil::Status(pb::error::Errno::EREGION_NOT_FOUND, "ChangeLearnerRegion region not exists");
+  }
+
+  // learner applies the log of store region only, index region has no learner.
+  if (region.region_type() != pb::common::RegionType::STORE_REGION) {
+    DINGO_LOG(ERROR) << "ChangeLearnerRegion region is not store region, region_id = " << region_id;
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "ChangeLearnerRegion region is not store region");
+  }
+
+  auto region_status = GetRegionStatus(region_id);
+  if (region.state() != ::dingodb::pb::common::RegionState::REGION_NORMAL ||
+      region_status.raft_status() != ::dingodb::pb::common::RegionRaftStatus::REGION_RAFT_HEALTHY ||
+      region_status.heartbeat_status() != ::dingodb::pb::common::RegionHeartbeatState::REGION_ONLINE) {
+    DINGO_LOG(ERROR) << "ChangeLearnerRegion region is not ready for change_learner, region_id = " << region_id;
+    return butil::Status(pb::error::Errno::ECHANGE_PEER_STATUS_ILLEGAL,
+                         "ChangeLearnerRegion region is not ready for change_learner");
+  }
+
+  auto leader_store_status = CheckRegionLeaderOnline(region_id);
+  if (!leader_store_status.ok()) {
+    DINGO_LOG(ERROR) << "ChangeLearnerRegion region leader is not ready for change_learner, region_id = "
+                     << region_id << ", error: " << leader_store_status.error_str();
+    return butil::Status(pb::error::Errno::ECHANGE_PEER_STATUS_ILLEGAL,
+                         "ChangeLearnerRegion region leader is not ready for change_learner, error: %s",
+                         leader_store_status.error_cstr());
+  }
+  auto leader_store_id = GetRegionLeaderId(region_id);
+  if (leader_store_id == 0) {
+    DINGO_LOG(ERROR) << "ChangeLearnerRegion region.leader_store_id() == 0, region_id = " << region_id;
+    return butil::Status(pb::error::Errno::ECHANGE_PEER_STATUS_ILLEGAL,
+                         "ChangeLearnerRegion region.leader_store_id() == 0");
+  }
+
+  std::set<int64_t> voter_store_ids;
+  std::vector<int64_t> old_learner_store_ids;
+  for (const auto& peer : region.definition().peers()) {
+    if (peer.role() == pb::common::PeerRole::LEARNER) {
+      old_learner_store_ids.push_back(peer.store_id());
+    } else {
+      voter_store_ids.insert(peer.store_id());
+    }
+  }
+
+  std::vector<int64_t> learner_diff_more;
+  std::vector<int64_t> learner_diff_less;
+  std::sort(new_learner_store_ids.begin(), new_learner_store_ids.end());
+  std::sort(old_learner_store_ids.begin(), old_learner_store_ids.end());
+  std::set_difference(new_learner_store_ids.begin(), new_learner_store_ids.end(), old_learner_store_ids.begin(),
+                      old_learner_store_ids.end(), std::inserter(learner_diff_more, learner_diff_more.begin()));
+  std::set_difference(old_learner_store_ids.begin(), old_learner_store_ids.end(), new_learner_store_ids.begin(),
+                      new_learner_store_ids.end(), std::inserter(learner_diff_less, learner_diff_less.begin()));
+
+  if (learner_diff_more.size() + learner_diff_less.size() != 1) {
+    DINGO_LOG(ERROR) << "ChangeLearnerRegion new_learner_store_ids can only has one diff store, region_id = "
+                     << region_id << " learner_diff_more.size() = " << learner_diff_more.size()
+                     << " learner_diff_less.size() = " << learner_diff_less.size();
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS,
+                         "ChangeLearnerRegion new_learner_store_ids can only has one diff store");
+  }
+
+  pb::common::RegionDefinition new_region_definition = region.definition();
+  new_region_definition.clear_peers();
+
+  auto* increment_task_list = CreateTaskList(meta_increment);
+  if (learner_diff_less.size() == 1) {
+    for (const auto& peer : region.definition().peers()) {
+      if (peer.store_id() != learner_diff_less.at(0)) {
+        *new_region_definition.add_peers() = peer;
+      }
+    }
+
+    // the leader removes the learner from region definition first, then the learner region is deleted.
+    AddChangePeerTask(increment_task_list, leader_store_id, region_id, new_region_definition, meta_increment);
+    AddDeleteTaskWithCheck(increment_task_list, learner_diff_less.at(0), region_id, new_region_definition.peers(),
+                           meta_increment);
+    AddCheckChangePeerResultTask(increment_task_list, region_id, new_region_definition);
+
+    return butil::Status::OK();
+  }
+
+  int64_t learner_store_id = learner_diff_more.at(0);
+  if (voter_store_ids.count(learner_store_id) > 0) {
+    DINGO_LOG(ERROR) << "ChangeLearnerRegion store already has voter, region_id = " << region_id
+                     << " store_id = " << learner_store_id;
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "ChangeLearnerRegion store already has voter");
+  }
+
+  auto store_status = CheckStoreNormal(learner_store_id);
+  if (!store_status.ok()) {
+    DINGO_LOG(ERROR) << "ChangeLearnerRegion learner store is not normal, region_id = " << region_id
+                     << " store_id = " << learner_store_id;
+    return butil::Status(pb::error::Errno::ECHANGE_PEER_STATUS_ILLEGAL,
+                         "ChangeLearnerRegion learner store is not normal, %s", store_status.error_cstr());
+  }
+
+  pb::common::Store store_to_add_learner;
+  ret = store_map_.Get(learner_store_id, store_to_add_learner);
+  if (ret < 0) {
+    DINGO_LOG(ERROR) << "ChangeLearnerRegion learner store not exists, region_id = " << region_id;
+    return butil::Status(pb::error::Errno::ESTORE_NOT_FOUND, "ChangeLearnerRegion learner store not exists");
+  }
+  if (store_to_add_learner.store_type() != pb::common::StoreType::NODE_TYPE_STORE) {
+    DINGO_LOG(ERROR) << "ChangeLearnerRegion learner store is not store node, region_id = " << region_id;
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "ChangeLearnerRegion learner store is not store node");
+  }
+
+  *new_region_definition.mutable_peers() = region.definition().peers();
+  auto* peer = new_region_definition.add_peers();
+  peer->set_store_id(store_to_add_learner.id());
+  peer->set_role(::dingodb::pb::common::PeerRole::LEARNER);
+  *(peer->mutable_server_location()) = store_to_add_learner.server_location();
+  *(peer->mutable_raft_location()) = store_to_add_learner.raft_location();
+
+  // the learner region bootstraps from a voter after it is created, then the leader adds it to region definition.
+  AddCreateTask(increment_task_list, learner_store_id, region_id, new_region_definition, meta_increment);
+  AddCheckStoreRegionTask(increment_task_list, learner_store_id, region_id);
+  AddChangePeerTask(increment_task_list, leader_store_id, region_id, new_region_definition, meta_increment);
+  AddCheckChangePeerResultTask(increment_task_list, region_id, new_region_definition);
+
+  return butil::Status::OK();
+}
+
 butil::Status CoordinatorControl::TransferLeaderRegionWithTaskList(
     int64_t region_id, int64_t new_leader_store_id, pb::coordinator_internal::MetaIncrement& meta_increment) {
   // check region_id exists
@@ -4052,16 +4387,42 @@ void CoordinatorControl::UpdateRegionMapAndStoreOperation(const pb::common::Stor
                     << store_metrics.region_metrics_map_size();
   }
 
+  // read all regions of the heartbeat at once, and put the updated region metrics by one MultiPut at last,
+  // each Put of DingoSafeMap waits for all readers, so the heartbeats of different stores block each other less.
+  std::vector<int64_t> region_ids;
+  region_ids.reserve(store_metrics.region_metrics_map_size());
+  for (const auto& it : store_metrics.region_metrics_map()) {
+    region_ids.push_back(it.second.id());
+  }
+
+  std::vector<pb::coordinator_internal::RegionInternal> regions;
+  std::vector<bool> region_exists;
+  std::vector<pb::common::RegionMetrics> old_region_metrics_list;
+  std::vector<bool> region_metrics_exists;
+  regions.reserve(region_ids.size());
+  region_exists.reserve(region_ids.size());
+  old_region_metrics_list.reserve(region_ids.size());
+  region_metrics_exists.reserve(region_ids.size());
+  if (region_map_.MultiGet(region_ids, regions, region_exists) < 0 ||
+      region_metrics_map_.MultiGet(region_ids, old_region_metrics_list, region_metrics_exists) < 0) {
+    DINGO_LOG(ERROR) << "UpdateRegionMapAndStoreOperation MultiGet failed, store_id=" << store_metrics.id();
+    return;
+  }
+
+  std::vector<int64_t> put_region_ids;
+  std::vector<pb::common::RegionMetrics> put_region_metrics_list;
+
   // update region_map
+  size_t region_index = 0;
   for (const auto& it : store_metrics.region_metrics_map()) {
     const auto& region_metrics = it.second;
+    size_t index = region_index++;
 
-    pb::coordinator_internal::RegionInternal region_to_update;
-    auto ret = region_map_.Get(region_metrics.id(), region_to_update);
-    if (ret < 0) {
+    if (!region_exists[index]) {
       DINGO_LOG(ERROR) << "region_to_update is not found in region_map_, region_id = " << region_metrics.id();
       continue;
     }
+    const auto& region_to_update = regions[index];
 
     // when region leader change or region state change, we need to update
     // region_map_ or when region last_update_timestamp is too old, we
@@ -4072,12 +4433,12 @@ void CoordinatorControl::UpdateRegionMapAndStoreOperation(const pb::common::Stor
     bool region_metrics_is_not_leader = false;
     bool leader_has_old_epoch = false;
 
-    pb::common::RegionMetrics region_metrics_to_update;
-    auto ret1 = region_metrics_map_.Get(region_metrics.id(), region_metrics_to_update);
-    if (ret1 < 0) {
+    pb::common::RegionMetrics& region_metrics_to_update = old_region_metrics_list[index];
+    if (!region_metrics_exists[index]) {
       region_metrics_to_update = region_metrics;
       *(region_metrics_to_update.mutable_region_status()) = GenRegionStatus(region_metrics);
-      region_metrics_map_.Put(region_metrics.id(), region_metrics_to_update);
+      put_region_ids.push_back(region_metrics.id());
+      put_region_metrics_list.push_back(region_metrics_to_update);
 
       DINGO_LOG(INFO) << "region_metrics_to_update is first time put into region_metrics_map_, region_id = "
                       << region_metrics.id() << ", from store_id: " << store_metrics.id();
@@ -4261,7 +4622,9 @@ void CoordinatorControl::UpdateRegionMapAndStoreOperation(const pb::common::Stor
 
       *(region_metrics_to_update.mutable_region_status()) = region_status_to_update;
 
-      region_metrics_map_.Put(region_metrics.id(), region_metrics_to_update);
+      // the later one of the same region overrides the first time put in MultiPut
+      put_region_ids.push_back(region_metrics.id());
+      put_region_metrics_list.push_back(region_metrics_to_update);
 
       DINGO_LOG(DEBUG) << "UpdateRegionMapAndStoreOperation region_metrics_map_ update region_id = "
                        << region_metrics.id() << " last_update_timestamp = "
@@ -4275,10 +4638,16 @@ void CoordinatorControl::UpdateRegionMapAndStoreOperation(const pb::common::Stor
                                                         region_metrics.region_size());
     }
   }
+
+  if (!put_region_ids.empty()) {
+    region_metrics_map_.MultiPut(put_region_ids, put_region_metrics_list);
+  }
 }
 
 int64_t CoordinatorControl::UpdateStoreMetrics(const pb::common::StoreMetrics& store_metrics,
-                                               pb::coordinator_internal::MetaIncrement& meta_increment) {
+                                               pb::coordinator_internal::MetaIncrement& meta_increment,
+                                               bool& need_full_region_metrics) {
+  need_full_region_metrics = false;
   //   int64_t store_map_epoch =
   //   GetPresentId(pb::coordinator_internal::IdEpochType::EPOCH_STORE);
   if (store_metrics.id() <= 0) {
@@ -4288,12 +4657,49 @@ int64_t CoordinatorControl::UpdateStoreMetrics(const pb::common::StoreMetrics& s
     return -1;
   }
 
+  // delta region metrics must base on the last accepted version, else let store send full region metrics.
+  int64_t region_num = store_metrics.region_metrics_map_size();
+  std::vector<int64_t> unchanged_region_ids;
+  if (store_metrics.is_delta_region_metrics()) {
+    BAIDU_SCOPED_LOCK(store_region_metrics_map_mutex_);
+    auto it = store_region_metrics_map_.find(store_metrics.id());
+    if (it == store_region_metrics_map_.end() ||
+        it->second.region_metrics_version() != store_metrics.region_metrics_base_version()) {
+      DINGO_LOG(WARNING) << "UpdateStoreMetrics delta region metrics version not match, store_id="
+                         << store_metrics.id() << ", base_version=" << store_metrics.region_metrics_base_version()
+                         << ", accepted_version="
+                         << (it == store_region_metrics_map_.end() ? 0 : it->second.region_metrics_version());
+      need_full_region_metrics = true;
+      return -1;
+    }
+
+    auto* mut_region_metrics_map = it->second.mutable_region_metrics_map();
+    for (auto region_id : store_metrics.removed_region_ids()) {
+      mut_region_metrics_map->erase(region_id);
+    }
+    for (const auto& [region_id, region_metrics] : store_metrics.region_metrics_map()) {
+      (*mut_region_metrics_map)[region_id] = region_metrics;
+    }
+    for (const auto& [region_id, region_metrics] : *mut_region_metrics_map) {
+      if (store_metrics.region_metrics_map().find(region_id) == store_metrics.region_metrics_map().end()) {
+        unchanged_region_ids.push_back(region_id);
+      }
+    }
+    it->second.set_region_metrics_version(store_metrics.region_metrics_version());
+    region_num = mut_region_metrics_map->size();
+
+    DINGO_LOG(INFO) << "UpdateStoreMetrics delta region metrics, store_id=" << store_metrics.id()
+                    << ", version=" << store_metrics.region_metrics_version()
+                    << ", changed=" << store_metrics.region_metrics_map_size()
+                    << ", removed=" << store_metrics.removed_region_ids_size() << ", total=" << region_num;
+  }
+
   if (!store_metrics.is_partial_region_metrics()) {
     BAIDU_SCOPED_LOCK(store_metrics_map_mutex_);
     StoreMetricsSlim store_metrics_slim;
     store_metrics_slim.store_id = store_metrics.id();
     store_metrics_slim.store_own_metrics = store_metrics.store_own_metrics();
-    store_metrics_slim.region_num = store_metrics.region_metrics_map_size();
+    store_metrics_slim.region_num = region_num;
     store_metrics_slim.update_time = butil::gettimeofday_ms();
 
     store_metrics_map_.insert_or_assign(store_metrics.id(), std::move(store_metrics_slim));
@@ -4302,25 +4708,31 @@ int64_t CoordinatorControl::UpdateStoreMetrics(const pb::common::StoreMetrics& s
                     << ", metrics: " << store_metrics.store_own_metrics().ShortDebugString();
   }
 
+  // the unchanged regions of delta region metrics are still alive.
+  TouchRegionMetrics(store_metrics.id(), unchanged_region_ids);
+
   if (store_metrics.region_metrics_map_size() <= 0) {
     DINGO_LOG(INFO) << "UpdateStoreMetrics store_metrics.region_metrics_map_size() <= 0, store_id="
                     << store_metrics.id() << ", do not update StoreMetrics";
     return 0;
   }
 
-  {
+  if (!store_metrics.is_delta_region_metrics() && store_metrics.is_partial_region_metrics()) {
     BAIDU_SCOPED_LOCK(store_region_metrics_map_mutex_);
-    if (store_metrics.is_partial_region_metrics()) {
-      if (store_region_metrics_map_.find(store_metrics.id()) == store_region_metrics_map_.end()) {
-        store_region_metrics_map_.insert_or_assign(store_metrics.id(), store_metrics);
-      } else {
-        for (const auto& region_metrics : store_metrics.region_metrics_map()) {
-          store_region_metrics_map_[store_metrics.id()].mutable_region_metrics_map()->insert(
-              {region_metrics.first, region_metrics.second});
-        }
-      }
-    } else {
+    if (store_region_metrics_map_.find(store_metrics.id()) == store_region_metrics_map_.end()) {
       store_region_metrics_map_.insert_or_assign(store_metrics.id(), store_metrics);
+    } else {
+      for (const auto& region_metrics : store_metrics.region_metrics_map()) {
+        store_region_metrics_map_[store_metrics.id()].mutable_region_metrics_map()->insert(
+            {region_metrics.first, region_metrics.second});
+      }
+    }
+  } else if (!store_metrics.is_delta_region_metrics()) {
+    // copy the full metrics out of the lock, only swap under the lock, the old one is released out of the lock too.
+    pb::common::StoreMetrics store_metrics_to_swap = store_metrics;
+    {
+      BAIDU_SCOPED_LOCK(store_region_metrics_map_mutex_);
+      store_region_metrics_map_[store_metrics.id()].Swap(&store_metrics_to_swap);
     }
   }
 
@@ -4337,6 +4749,40 @@ int64_t CoordinatorControl::UpdateStoreMetrics(const pb::common::StoreMetrics& s
   return 0;
 }
 
+void CoordinatorControl::TouchRegionMetrics(int64_t store_id, const std::vector<int64_t>& region_ids) {
+  if (region_ids.empty()) {
+    return;
+  }
+
+  std::vector<pb::common::RegionMetrics> region_metrics_list;
+  std::vector<bool> exists;
+  if (region_metrics_map_.MultiGet(region_ids, region_metrics_list, exists) < 0) {
+    return;
+  }
+
+  int64_t now = butil::gettimeofday_ms();
+  std::vector<int64_t> put_region_ids;
+  std::vector<pb::common::RegionMetrics> put_region_metrics_list;
+  for (size_t i = 0; i < region_ids.size(); ++i) {
+    auto& region_metrics = region_metrics_list[i];
+    if (!exists[i] || region_metrics.leader_store_id() != store_id) {
+      continue;
+    }
+
+    // same as full heartbeat, only update region_metrics_map_ when last_update_timestamp is too old.
+    if (region_metrics.region_status().last_update_timestamp() + FLAGS_region_update_timeout * 1000 >= now) {
+      continue;
+    }
+    region_metrics.mutable_region_status()->set_last_update_timestamp(now);
+    put_region_ids.push_back(region_ids[i]);
+    put_region_metrics_list.push_back(std::move(region_metrics));
+  }
+
+  if (!put_region_ids.empty()) {
+    region_metrics_map_.MultiPut(put_region_ids, put_region_metrics_list);
+  }
+}
+
 void CoordinatorControl::GetMemoryInfo(pb::coordinator::CoordinatorMemoryInfo& memory_info) {
   // compute size
   memory_info.set_id_epoch_safe_map_temp_count(id_epoch_map_safe_temp_.Size());
@@ -5236,6 +5682,8 @@ butil::Status CoordinatorControl::ProcessTaskList() {
   DINGO_LOG(DEBUG) << "start process task lists";
 
   AtomicGuard atomic_guard(is_processing_task_list_);
+  // the triggers from now on need another process
+  is_task_list_process_pending_.store(false);
 
   butil::FlatMap<int64_t, pb::coordinator::TaskList> task_list_map;
   task_list_map.init(100);
@@ -5274,6 +5722,19 @@ butil::Status CoordinatorControl::ProcessTaskList() {
   return butil::Status::OK();
 }
 
+void CoordinatorControl::TriggerProcessTaskList() {
+  if (!FLAGS_coordinator_task_list_trigger_on_event || task_list_map_.Size() == 0) {
+    return;
+  }
+
+  if (is_task_list_process_pending_.exchange(true)) {
+    return;
+  }
+
+  DINGO_LOG(DEBUG) << "trigger process task lists";
+  Heartbeat::TriggerCoordinatorTaskListProcess(nullptr);
+}
+
 butil::Status CoordinatorControl::CleanTaskList(int64_t task_list_id,
                                                 pb::coordinator_internal::MetaIncrement& meta_increment) {
   butil::FlatMap<int64_t, pb::coordinator::TaskList> task_list_map;
@@ -5333,7 +5794,8 @@ butil::Status CoordinatorControl::ScanRegions(const std::string& start_key, cons
       region_internals, lower_bound, upper_bound, nullptr,
       [lower_bound, upper_bound](const pb::coordinator_internal::RegionInternal& region) {
         return region.id() > 0 && region.definition().range().end_key() > lower_bound;
-      });
+      },
+      end_key.empty() ? 0 : limit);
   if (ret < 0) {
     DINGO_LOG(ERROR) << "range_region_map_.FindIntervalValues failed";
     return butil::Status(pb::error::EINTERNAL, "range_region_map_.FindIntervalValues failed");
@@ -27,6 +27,7 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "coordinator/coordinator_control.h"
+#include "coordinator/meta_snapshot.h"
 #include "engine/snapshot.h"
 #include "gflags/gflags.h"
 #include "google/protobuf/unknown_field_set.h"
@@ -172,789 +173,71 @@ std::shared_ptr<Snapshot> CoordinatorControl::PrepareRaftSnapshot() {
   return this->raw_engine_of_meta_->GetSnapshot();
 }
 
+// the maps in coordinator snapshot, deleted_* and common_disk maps are only on disk
+std::vector<MetaSnapshotSection> CoordinatorControl::GetMetaSnapshotSections(
+    pb::coordinator_internal::MetaSnapshotFile& meta_snapshot_file) {
+  return {
+      {"id_epoch_meta", id_epoch_meta_->internal_prefix, meta_snapshot_file.mutable_id_epoch_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return id_epoch_meta_->Recover(kvs); }},
+      {"coordinator_meta", coordinator_meta_->internal_prefix, meta_snapshot_file.mutable_coordinator_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return coordinator_meta_->Recover(kvs); }},
+      {"store_meta", store_meta_->internal_prefix, meta_snapshot_file.mutable_store_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return store_meta_->Recover(kvs); }},
+      {"executor_meta", executor_meta_->internal_prefix, meta_snapshot_file.mutable_executor_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return executor_meta_->Recover(kvs); }},
+      {"schema_meta", schema_meta_->internal_prefix, meta_snapshot_file.mutable_schema_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return schema_meta_->Recover(kvs); }},
+      {"region_meta", region_meta_->internal_prefix, meta_snapshot_file.mutable_region_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return region_meta_->Recover(kvs); }},
+      {"deleted_region_meta", deleted_region_meta_->internal_prefix,
+       meta_snapshot_file.mutable_deleted_region_map_kvs(), nullptr},
+      {"table_meta", table_meta_->internal_prefix, meta_snapshot_file.mutable_table_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return table_meta_->Recover(kvs); }},
+      {"deleted_table_meta", deleted_table_meta_->internal_prefix,
+       meta_snapshot_file.mutable_deleted_table_map_kvs(), nullptr},
+      {"store_operation_meta", store_operation_meta_->internal_prefix,
+       meta_snapshot_file.mutable_store_operation_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return store_operation_meta_->Recover(kvs); }},
+      {"region_cmd_meta", region_cmd_meta_->internal_prefix, meta_snapshot_file.mutable_region_cmd_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return region_cmd_meta_->Recover(kvs); }},
+      {"executor_user_meta", executor_user_meta_->internal_prefix, meta_snapshot_file.mutable_executor_user_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return executor_user_meta_->Recover(kvs); }},
+      {"task_list_meta", task_list_meta_->internal_prefix, meta_snapshot_file.mutable_task_list_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return task_list_meta_->Recover(kvs); }},
+      {"index_meta", index_meta_->internal_prefix, meta_snapshot_file.mutable_index_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return index_meta_->Recover(kvs); }},
+      {"deleted_index_meta", deleted_index_meta_->internal_prefix,
+       meta_snapshot_file.mutable_deleted_index_map_kvs(), nullptr},
+      {"table_index_meta", table_index_meta_->internal_prefix, meta_snapshot_file.mutable_table_index_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return table_index_meta_->Recover(kvs); }},
+      {"common_disk_meta", common_disk_meta_->internal_prefix,
+       meta_snapshot_file.mutable_common_disk_map_kvs(), nullptr},
+      {"common_mem_meta", common_mem_meta_->internal_prefix, meta_snapshot_file.mutable_common_mem_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return common_mem_meta_->Recover(kvs); }},
+      {"tenant_meta", tenant_meta_->internal_prefix, meta_snapshot_file.mutable_tenant_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return tenant_meta_->Recover(kvs); }},
+  };
+}
+
 bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapshot,
                                                 pb::coordinator_internal::MetaSnapshotFile& meta_snapshot_file) {
   DINGO_LOG(INFO) << "Coordinator start to LoadMetaToSnapshotFile";
 
-  std::vector<pb::common::KeyValue> kvs;
-
-  // 0.id_epoch map
-  if (!meta_reader_->Scan(snapshot, id_epoch_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_id_epoch_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-
-  DINGO_LOG(INFO) << "Snapshot id_epoch_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 1.coordinator map
-  if (!meta_reader_->Scan(snapshot, coordinator_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_coordinator_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot coordinator_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 2.store map
-  if (!meta_reader_->Scan(snapshot, store_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_store_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot store_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 3.executor map
-  if (!meta_reader_->Scan(snapshot, executor_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_executor_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot executor_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 4.schema map
-  if (!meta_reader_->Scan(snapshot, schema_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_schema_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot schema_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 5.region map
-  if (!meta_reader_->Scan(snapshot, region_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_region_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot region_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 5.1 deleted region map
-  if (!meta_reader_->Scan(snapshot, deleted_region_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_deleted_region_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot deleted_region_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 6.table map
-  if (!meta_reader_->Scan(snapshot, table_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_table_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot table_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 6.1 deleted table map
-  if (!meta_reader_->Scan(snapshot, deleted_table_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_deleted_table_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot deleted_table_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 8.table_metrics map
-
-  // 9.store_operation map
-  if (!meta_reader_->Scan(snapshot, store_operation_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_store_operation_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot store_operation_meta_, count=" << kvs.size();
-  kvs.clear();
-  // 9.1 region_cmd_map_
-  if (!meta_reader_->Scan(snapshot, region_cmd_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_region_cmd_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot region_cmd_meta_, count=" << kvs.size();
-  kvs.clear();
-
-  // 10.executor_user map
-  if (!meta_reader_->Scan(snapshot, executor_user_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_executor_user_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot executor_user_meta_, count=" << kvs.size();
-  kvs.clear();
-
-  // 11.task_list map
-  if (!meta_reader_->Scan(snapshot, task_list_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_task_list_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot task_list_meta_, count=" << kvs.size();
-  kvs.clear();
-
-  // 12.index map
-  if (!meta_reader_->Scan(snapshot, index_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_index_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot index_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 12.1 deleted_index map
-  if (!meta_reader_->Scan(snapshot, deleted_index_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_deleted_index_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot deleted_index_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 13.index_metrics map
-
-  // 50.table_index map
-  if (!meta_reader_->Scan(snapshot, table_index_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_table_index_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot table_index_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 51.1 common_disk_map
-  if (!meta_reader_->Scan(snapshot, common_disk_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_common_disk_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot common_disk_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 51.2 common_mem_map
-  if (!meta_reader_->Scan(snapshot, common_mem_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_common_mem_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot common_mem_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 52 tenant_mem_map
-  if (!meta_reader_->Scan(snapshot, tenant_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_tenant_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot tenant_mem_meta, count=" << kvs.size();
-  kvs.clear();
-
-  return true;
+  auto sections = GetMetaSnapshotSections(meta_snapshot_file);
+  return MetaSnapshot::Save(meta_reader_, snapshot, sections);
 }
 
 bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::MetaSnapshotFile& meta_snapshot_file) {
   DINGO_LOG(INFO) << "Coordinator start to LoadMetaFromSnapshotFile";
 
-  std::vector<pb::common::KeyValue> kvs;
-
-  // 0.id_epoch map
-  kvs.reserve(meta_snapshot_file.id_epoch_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.id_epoch_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.id_epoch_map_kvs(i));
-  }
-  {
-    // BAIDU_SCOPED_LOCK(id_epoch_map_mutex_);
-    if (!id_epoch_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(id_epoch_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete id_epoch_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range id_epoch_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write id_epoch_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put id_epoch_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot id_epoch_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 1.coordinator map
-  kvs.reserve(meta_snapshot_file.coordinator_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.coordinator_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.coordinator_map_kvs(i));
-  }
-  {
-    // BAIDU_SCOPED_LOCK(coordinator_map_mutex_);
-    if (!coordinator_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(coordinator_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete coordinator_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range coordinator_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write coordinator_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put coordinator_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot coordinator_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 2.store map
-  kvs.reserve(meta_snapshot_file.store_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.store_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.store_map_kvs(i));
-  }
-  {
-    // BAIDU_SCOPED_LOCK(store_map_mutex_);
-    if (!store_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(store_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete store_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range store_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write store_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put store_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot store_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 3.executor map
-  kvs.reserve(meta_snapshot_file.executor_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.executor_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.executor_map_kvs(i));
-  }
-  {
-    // BAIDU_SCOPED_LOCK(executor_map_mutex_);
-    if (!executor_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(executor_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete executor_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range executor_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write executor_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put executor_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot executor_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 4.schema map
-  kvs.reserve(meta_snapshot_file.schema_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.schema_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.schema_map_kvs(i));
-  }
-  {
-    // BAIDU_SCOPED_LOCK(schema_map_mutex_);
-    if (!schema_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(schema_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete schema_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range schema_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write schema_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put schema_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot schema_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 5.region map
-  kvs.reserve(meta_snapshot_file.region_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.region_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.region_map_kvs(i));
-  }
-  {
-    // BAIDU_SCOPED_LOCK(region_map_mutex_);
-    if (!region_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(region_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete region_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range region_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write region_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put region_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot region_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 5.1 deleted region map
-  kvs.reserve(meta_snapshot_file.deleted_region_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.deleted_region_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.deleted_region_map_kvs(i));
-  }
-  {
-    // BAIDU_SCOPED_LOCK(region_map_mutex_);
-    // if (!deleted_region_meta_->Recover(kvs)) {
-    //   return false;
-    // }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(deleted_region_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete deleted_region_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range deleted_region_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write deleted_region_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put deleted_region_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot deleted_region_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 6.table map
-  kvs.reserve(meta_snapshot_file.table_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.table_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.table_map_kvs(i));
-  }
-  {
-    // BAIDU_SCOPED_LOCK(table_map_mutex_);
-    if (!table_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(table_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete table_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range table_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write table_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put table_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot table_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 6.1 deleted table map
-  kvs.reserve(meta_snapshot_file.deleted_table_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.deleted_table_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.deleted_table_map_kvs(i));
-  }
-  {
-    // BAIDU_SCOPED_LOCK(deleted_table_map_mutex_);
-    // if (!deleted_table_meta_->Recover(kvs)) {
-    //   return false;
-    // }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(deleted_table_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete deleted_table_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range deleted_table_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write deleted_table_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put deleted_table_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot deleted_table_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 8.table_metrics map
-
-  // 9.store_operation map
-  kvs.reserve(meta_snapshot_file.store_operation_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.store_operation_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.store_operation_map_kvs(i));
-  }
-  {
-    if (!store_operation_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(store_operation_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete store_operation_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range store_operation_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write store_operation_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put store_operation_meta_ success in LoadMetaFromSnapshotFile";
-  }
-
-  DINGO_LOG(INFO) << "LoadSnapshot store_operation_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 9.1.region_cmd map
-  kvs.reserve(meta_snapshot_file.region_cmd_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.region_cmd_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.region_cmd_map_kvs(i));
-  }
-  {
-    if (!region_cmd_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(region_cmd_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete region_cmd_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range region_cmd_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write region_cmd_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put region_cmd_meta_ success in LoadMetaFromSnapshotFile";
-  }
-
-  DINGO_LOG(INFO) << "LoadSnapshot region_cmd_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 10.executor_user map
-  kvs.reserve(meta_snapshot_file.executor_user_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.executor_user_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.executor_user_map_kvs(i));
-  }
-  {
-    if (!executor_user_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(executor_user_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete executor_user_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range executor_user_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write executor_user_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put executor_user_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot executor_user_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 11.task_list map
-  kvs.reserve(meta_snapshot_file.task_list_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.task_list_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.task_list_map_kvs(i));
-  }
-  {
-    if (!task_list_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(task_list_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete task_list_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range task_list_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write task_list_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put task_list_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot task_list_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 12.index map
-  kvs.reserve(meta_snapshot_file.index_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.index_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.index_map_kvs(i));
-  }
-  {
-    // BAIDU_SCOPED_LOCK(index_map_mutex_);
-    if (!index_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(index_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete index_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range index_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write index_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put index_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot index_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 12.1 deleted_index map
-  kvs.reserve(meta_snapshot_file.deleted_index_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.deleted_index_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.deleted_index_map_kvs(i));
-  }
-  {
-    // if (!deleted_index_meta_->Recover(kvs)) {
-    //   return false;
-    // }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(deleted_index_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete deleted_index_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range deleted_index_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write deleted_index_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put deleted_index_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot deleted_index_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 13.index_metrics map
-
-  // 50.table_index map
-  kvs.reserve(meta_snapshot_file.table_index_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.table_index_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.table_index_map_kvs(i));
-  }
-  if (!table_index_meta_->Recover(kvs)) {
-    return false;
-  }
-
-  // remove data in rocksdb
-  if (!meta_writer_->DeletePrefix(table_index_meta_->internal_prefix)) {
-    DINGO_LOG(ERROR) << "Coordinator delete table_index_meta_ range failed in LoadMetaFromSnapshotFile";
+  auto sections = GetMetaSnapshotSections(meta_snapshot_file);
+  if (!MetaSnapshot::Load(meta_writer_, sections)) {
     return false;
   }
-  DINGO_LOG(INFO) << "Coordinator delete range table_index_meta_ success in LoadMetaFromSnapshotFile";
-
-  // write data to rocksdb
-  if (!meta_writer_->Put(kvs)) {
-    DINGO_LOG(ERROR) << "Coordinator write table_index_meta_ failed in LoadMetaFromSnapshotFile";
-    return false;
-  }
-  DINGO_LOG(INFO) << "Coordinator put table_index_meta_ success in LoadMetaFromSnapshotFile";
-  DINGO_LOG(INFO) << "LoadSnapshot table_index_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 51.1 common_disk_map
-  kvs.reserve(meta_snapshot_file.common_disk_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.common_disk_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.common_disk_map_kvs(i));
-  }
-  {
-    // if (!common_disk_meta_->Recover(kvs)) {
-    //   return false;
-    // }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(common_disk_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete common_disk_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range common_disk_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write common_disk_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put common_disk_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot common_disk_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 51.2 common_mem_map
-  kvs.reserve(meta_snapshot_file.common_mem_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.common_mem_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.common_mem_map_kvs(i));
-  }
-  {
-    // BAIDU_SCOPED_LOCK(common_mem_map_mutex_);
-    if (!common_mem_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(common_mem_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete common_mem_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range common_mem_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write common_mem_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put common_mem_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot common_mem_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 52 tenant_mem_map
-  kvs.reserve(meta_snapshot_file.tenant_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.tenant_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.tenant_map_kvs(i));
-  }
-  {
-    // BAIDU_SCOPED_LOCK(tenant_mem_map_mutex_);
-    if (!tenant_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(tenant_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete tenant_mem_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range tenant_mem_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write tenant_mem_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put tenant_mem_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot tenant_mem_meta, count=" << kvs.size();
-  kvs.clear();
 
   // build id_epoch, schema_name, table_name, index_name maps
   BuildTempMaps();
 
-  // build lease_to_key_map_temp_
-  // BuildLeaseToKeyMap();
-
-  // DINGO_LOG(INFO) << "LoadSnapshot lease_to_key_map_temp, count=" << lease_to_key_map_temp_.size();
-
   return true;
 }
 
@@ -0,0 +1,145 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "butil/containers/flat_map.h"
+#include "butil/time.h"
+#include "common/logging.h"
+#include "coordinator/coordinator_control.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/coordinator_internal.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_merge_region, false, "merge adjacent small regions automatically");
+DEFINE_int64(merge_region_max_size, 32 * 1024 * 1024, "only merge two regions which total size is less than it");
+DEFINE_int64(merge_region_max_keys, 200000, "only merge two regions which total row count is less than it");
+DEFINE_int64(merge_region_max_qps, 100, "region which read and write qps is more than it is not merged");
+DEFINE_int32(merge_region_max_ops, 2, "max merge operations of a merge round");
+DEFINE_int64(merge_region_cooldown_s, 3600,
+             "region is not merged in cooldown seconds after it is created, split or merged");
+
+namespace {
+
+struct MergeCandidate {
+  int64_t region_id{0};
+  std::string start_key;
+  std::string end_key;
+  int64_t size{0};
+  int64_t keys{0};
+};
+
+}  // namespace
+
+bool CoordinatorControl::CanMergeRegion(const pb::coordinator_internal::RegionInternal& region, int64_t now_ms) {
+  if (region.state() != pb::common::RegionState::REGION_NORMAL ||
+      region.create_timestamp() + FLAGS_merge_region_cooldown_s * 1000 > now_ms) {
+    return false;
+  }
+
+  auto it = merge_region_last_ms_.find(region.id());
+  return it == merge_region_last_ms_.end() || it->second + FLAGS_merge_region_cooldown_s * 1000 <= now_ms;
+}
+
+// Regions of the same partition are sorted by range, a region is merged to its left neighbor when both are small.
+// MergeRegionWithTaskList checks the rest, e.g. same peers, healthy status and task list conflict.
+void CoordinatorControl::MergeSmallRegions() {
+  if (!IsLeader() || !FLAGS_enable_merge_region) {
+    return;
+  }
+
+  int64_t now_ms = butil::gettimeofday_ms();
+  for (auto it = merge_region_last_ms_.begin(); it != merge_region_last_ms_.end();) {
+    if (it->second + FLAGS_merge_region_cooldown_s * 1000 <= now_ms) {
+      it = merge_region_last_ms_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  butil::FlatMap<int64_t, pb::coordinator_internal::RegionInternal> regions;
+  regions.init(3000);
+  region_map_.GetRawMapCopy(regions);
+
+  std::map<int64_t, std::vector<MergeCandidate>> part_regions;
+  for (const auto& [region_id, region] : regions) {
+    if (!CanMergeRegion(region, now_ms)) {
+      continue;
+    }
+
+    pb::common::RegionMetrics region_metrics;
+    if (region_metrics_map_.Get(region_id, region_metrics) < 0 ||
+        region_metrics.read_qps() + region_metrics.write_qps() > FLAGS_merge_region_max_qps) {
+      continue;
+    }
+
+    MergeCandidate candidate;
+    candidate.region_id = region_id;
+    candidate.start_key = region.definition().range().start_key();
+    candidate.end_key = region.definition().range().end_key();
+    candidate.size = region_metrics.region_size();
+    candidate.keys = region_metrics.row_count();
+    if (candidate.size >= FLAGS_merge_region_max_size || candidate.keys >= FLAGS_merge_region_max_keys) {
+      continue;
+    }
+    part_regions[region.definition().part_id()].push_back(std::move(candidate));
+  }
+
+  pb::coordinator_internal::MetaIncrement meta_increment;
+  int32_t merge_count = 0;
+  for (auto& [part_id, candidates] : part_regions) {
+    std::sort(candidates.begin(), candidates.end(),
+              [](const MergeCandidate& lhs, const MergeCandidate& rhs) { return lhs.start_key < rhs.start_key; });
+
+    for (size_t i = 0; i + 1 < candidates.size() && merge_count < FLAGS_merge_region_max_ops; ++i) {
+      const auto& left = candidates[i];
+      const auto& right = candidates[i + 1];
+      if (left.end_key != right.start_key || left.size + right.size >= FLAGS_merge_region_max_size ||
+          left.keys + right.keys >= FLAGS_merge_region_max_keys) {
+        continue;
+      }
+
+      auto status = MergeRegionWithTaskList(right.region_id, left.region_id, meta_increment);
+      if (!status.ok()) {
+        DINGO_LOG(WARNING) << fmt::format("[merge.region][region({})] merge to region({}) failed, error: {}",
+                                          right.region_id, left.region_id, status.error_str());
+        continue;
+      }
+
+      DINGO_LOG(INFO) << fmt::format(
+          "[merge.region][region({})] merge to region({}), part({}) size({}) keys({}), target size({}) keys({})",
+          right.region_id, left.region_id, part_id, right.size, right.keys, left.size, left.keys);
+
+      merge_region_last_ms_[left.region_id] = now_ms;
+      merge_region_last_ms_[right.region_id] = now_ms;
+      ++merge_count;
+      // the right region is gone, the next pair start from the region after it.
+      ++i;
+    }
+  }
+
+  if (meta_increment.ByteSizeLong() > 0) {
+    SubmitMetaIncrementSync(meta_increment);
+  }
+}
+
+}  // namespace dingodb
@@ -14,6 +14,7 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
@@ -44,11 +45,14 @@
 namespace dingodb {
 
 DEFINE_int64(max_partition_num_of_table, 1024, "max partition num of table");
+DEFINE_int64(max_pre_split_region_num_of_partition, 256, "max pre-split region num of one partition of table");
 DEFINE_int64(max_table_count, 10000, "max table num of dingo");
 DEFINE_int64(max_index_count, 10000, "max index num of dingo");
 DEFINE_int64(max_tenant_count, 1024, "max tenant num of dingo");
 DEFINE_uint32(default_replica_num, 3, "default replica number");
 
+DECLARE_bool(enable_vector_aware_placement);
+
 butil::Status CoordinatorControl::GenerateTableIdAndPartIds(int64_t schema_id, int64_t part_count,
                                                             pb::meta::EntityType entity_type,
                                                             pb::coordinator_internal::MetaIncrement& meta_increment,
@@ -596,6 +600,13 @@ butil::Status CoordinatorControl::CreateTable(int64_t schema_id, const pb::meta:
                          << ", table_definition:" << table_definition.ShortDebugString();
         return butil::Status(pb::error::Errno::ETABLE_DEFINITION_ILLEGAL, "part range is illegal");
       }
+      if (part.pre_split_region_num() < 0 ||
+          part.pre_split_region_num() > FLAGS_max_pre_split_region_num_of_partition) {
+        DINGO_LOG(ERROR) << "pre_split_region_num is illegal, part_id=" << part.id().entity_id()
+                         << ", pre_split_region_num=" << part.pre_split_region_num()
+                         << ", max_pre_split_region_num_of_partition=" << FLAGS_max_pre_split_region_num_of_partition;
+        return butil::Status(pb::error::Errno::ETABLE_DEFINITION_ILLEGAL, "pre_split_region_num is illegal");
+      }
       new_part_ids.push_back(part.id().entity_id());
       new_part_ranges.push_back(part.range());
     }
@@ -715,31 +726,47 @@ butil::Status CoordinatorControl::CreateTable(int64_t schema_id, const pb::meta:
   }
 
   // for partitions
+  size_t need_region_count = 0;
   for (int i = 0; i < new_part_ranges.size(); i++) {
-    int64_t new_region_id = 0;
     int64_t new_part_id = new_part_ids[i];
     auto new_part_range = new_part_ranges[i];
 
     std::string const region_name = std::string("T_") + std::to_string(schema_id) + std::string("_") +
                                     table_definition.name() + std::string("_part_") + std::to_string(new_part_id);
 
-    std::vector<pb::coordinator::StoreOperation> store_operations;
-    auto ret = CreateRegionFinal(region_name, pb::common::RegionType::STORE_REGION, region_raw_engine_type, "", replica,
-                                 new_part_range, schema_id, new_table_id, 0, new_part_id, tenant_id, index_parameter,
-                                 store_ids, 0, new_region_id, store_operations, meta_increment);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << "CreateRegion failed in CreateTable table_name=" << table_definition.name()
-                       << ", table_definition:" << table_definition.ShortDebugString() << " ret: " << ret.error_str();
-      return ret;
-    }
+    // pre-split regions of the partition share the part_id, like the regions split from it.
+    auto region_ranges = CalcPreSplitRanges(table_partition.partitions(i), new_part_range);
+    need_region_count += region_ranges.size();
+    for (size_t j = 0; j < region_ranges.size(); ++j) {
+      // scatter the first peer of pre-split regions, the store prefers the first peer as leader.
+      std::vector<int64_t> region_store_ids = store_ids;
+      if (!region_store_ids.empty()) {
+        std::rotate(region_store_ids.begin(), region_store_ids.begin() + (j % region_store_ids.size()),
+                    region_store_ids.end());
+      }
 
-    DINGO_LOG(INFO) << "CreateTable create region success, region_id=" << new_region_id;
+      int64_t new_region_id = 0;
+      std::vector<pb::coordinator::StoreOperation> store_operations;
+      auto ret = CreateRegionFinal(region_name, pb::common::RegionType::STORE_REGION, region_raw_engine_type, "",
+                                   replica, region_ranges[j], schema_id, new_table_id, 0, new_part_id, tenant_id,
+                                   index_parameter, region_store_ids, 0, new_region_id, store_operations,
+                                   meta_increment);
+      if (!ret.ok()) {
+        DINGO_LOG(ERROR) << "CreateRegion failed in CreateTable table_name=" << table_definition.name()
+                         << ", table_definition:" << table_definition.ShortDebugString()
+                         << " ret: " << ret.error_str();
+        return ret;
+      }
 
-    new_region_ids.push_back(new_region_id);
+      DINGO_LOG(INFO) << "CreateTable create region success, region_id=" << new_region_id
+                      << ", range=" << region_ranges[j].ShortDebugString();
+
+      new_region_ids.push_back(new_region_id);
+    }
   }
 
-  if (new_region_ids.size() < new_part_ranges.size()) {
-    DINGO_LOG(ERROR) << "Not enough regions is created, drop residual regions need=" << new_part_ranges.size()
+  if (new_region_ids.size() < need_region_count) {
+    DINGO_LOG(ERROR) << "Not enough regions is created, drop residual regions need=" << need_region_count
                      << " created=" << new_region_ids.size();
     for (auto region_id_to_delete : new_region_ids) {
       auto ret = DropRegion(region_id_to_delete, meta_increment);
@@ -764,6 +791,9 @@ butil::Status CoordinatorControl::CreateTable(int64_t schema_id, const pb::meta:
   auto* definition = table_internal.mutable_definition();
   *definition = table_definition;
   definition->set_create_timestamp(butil::gettimeofday_ms());
+  for (auto& part : *definition->mutable_table_partition()->mutable_partitions()) {
+    part.clear_sample_keys();
+  }
 
   // add table_internal to table_map_
   // update meta_increment
@@ -1175,11 +1205,17 @@ butil::Status CoordinatorControl::CreateIndex(int64_t schema_id, const pb::meta:
     std::string const region_name = std::string("I_") + std::to_string(schema_id) + std::string("_") +
                                     table_definition.name() + std::string("_part_") + std::to_string(new_part_id);
 
+    // vector aware placement select stores for every partition, so partitions are spread across index nodes.
+    std::vector<int64_t> part_store_ids;
+    if (!FLAGS_enable_vector_aware_placement || !table_definition.index_parameter().has_vector_index_parameter()) {
+      part_store_ids = store_ids;
+    }
+
     std::vector<pb::coordinator::StoreOperation> store_operations;
     auto ret = CreateRegionFinal(region_name, pb::common::RegionType::INDEX_REGION, region_raw_engine_type, "", replica,
                                  new_part_range, schema_id, 0, new_index_id, new_part_id, tenant_id,
-                                 table_definition.index_parameter(), store_ids, 0, new_region_id, store_operations,
-                                 meta_increment);
+                                 table_definition.index_parameter(), part_store_ids, 0, new_region_id,
+                                 store_operations, meta_increment);
     if (!ret.ok()) {
       DINGO_LOG(ERROR) << "CreateRegion failed in CreateIndex index_name=" << table_definition.name();
       return ret;
@@ -3141,6 +3177,39 @@ butil::Status CoordinatorControl::DropIndexOnTable(int64_t table_id, int64_t ind
   return butil::Status::OK();
 }
 
+std::vector<pb::common::Range> CoordinatorControl::CalcPreSplitRanges(const pb::meta::Partition& partition,
+                                                                      const pb::common::Range& part_range) {
+  std::vector<std::string> split_keys;
+  if (partition.pre_split_region_num() > 1) {
+    if (partition.sample_keys_size() > 0) {
+      split_keys = Helper::CalculateSampleSplitKeys(part_range.start_key(), part_range.end_key(),
+                                                    Helper::PbRepeatedToVector(partition.sample_keys()),
+                                                    partition.pre_split_region_num());
+    } else {
+      split_keys = Helper::CalculateUniformSplitKeys(part_range.start_key(), part_range.end_key(),
+                                                     partition.pre_split_region_num());
+    }
+  }
+
+  std::vector<pb::common::Range> ranges;
+  ranges.reserve(split_keys.size() + 1);
+  std::string start_key = part_range.start_key();
+  for (auto& split_key : split_keys) {
+    pb::common::Range range;
+    range.set_start_key(start_key);
+    range.set_end_key(split_key);
+    ranges.push_back(std::move(range));
+    start_key = std::move(split_key);
+  }
+
+  pb::common::Range range;
+  range.set_start_key(start_key);
+  range.set_end_key(part_range.end_key());
+  ranges.push_back(std::move(range));
+
+  return ranges;
+}
+
 butil::Status CoordinatorControl::CalcTableInternalRange(const pb::meta::PartitionRule& partition_rule,
                                                          pb::common::Range& table_internal_range) {
   if (partition_rule.partitions_size() > 0) {
@@ -3188,6 +3257,9 @@ butil::Status CoordinatorControl::TranslateEngineToRawEngine(const pb::common::E
     case pb::common::Engine::TXN_BTREE:
       raw_engine = pb::common::RawEngine::RAW_ENG_BDB;
       break;
+    case pb::common::Engine::ENG_MEMORY:
+      raw_engine = pb::common::RawEngine::RAW_ENG_MEMORY;
+      break;
     default:
       return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "engine not support");
   }
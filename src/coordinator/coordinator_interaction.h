@@ -61,6 +61,12 @@ class CoordinatorInteraction {
   butil::Status SendRequest(const std::string& api_name, const Request& request, Response& response,
                             int64_t time_out_ms = 60000);
 
+  // For read request which coordinator follower can serve, send to a random coordinator to spread the load,
+  // fall back to SendRequest if it can't serve.
+  template <typename Request, typename Response>
+  butil::Status SendReadRequest(const std::string& api_name, const Request& request, Response& response,
+                                int64_t time_out_ms = 60000);
+
   const ::google::protobuf::ServiceDescriptor* GetServiceDescriptor() const;
 
   void SetLeaderAddress(const butil::EndPoint& addr);
@@ -95,6 +101,43 @@ butil::Status CoordinatorInteraction::SendRequest(const std::string& api_name, c
   }
 }
 
+template <typename Request, typename Response>
+butil::Status CoordinatorInteraction::SendReadRequest(const std::string& api_name, const Request& request,
+                                                      Response& response, int64_t time_out_ms) {
+  if (use_service_name_ || channels_.size() <= 1) {
+    return SendRequest(api_name, request, response, time_out_ms);
+  }
+
+  const ::google::protobuf::ServiceDescriptor* service_desc = GetServiceDescriptor();
+  if (service_desc == nullptr) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Service type not found");
+  }
+
+  const ::google::protobuf::MethodDescriptor* method = service_desc->FindMethodByName(api_name);
+  if (method == nullptr) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Service method not found");
+  }
+
+  brpc::Controller cntl;
+  cntl.set_log_id(butil::fast_rand());
+  cntl.set_timeout_ms(time_out_ms);
+
+  int index = static_cast<int>(butil::fast_rand_less_than(channels_.size()));
+  channels_[index]->CallMethod(method, &cntl, &request, &response, nullptr);
+  if (!cntl.Failed() && response.error().errcode() != pb::error::ERAFT_NOTLEADER) {
+    if (response.error().errcode() != pb::error::OK) {
+      return butil::Status(response.error().errcode(), response.error().errmsg());
+    }
+    return butil::Status();
+  }
+
+  DINGO_LOG(DEBUG) << fmt::format("{} read from {} failed, fall back to leader, {} {}", api_name,
+                                  butil::endpoint2str(endpoints_[index]).c_str(), cntl.ErrorCode(),
+                                  response.error().errcode());
+  response.Clear();
+  return SendRequest(api_name, request, response, time_out_ms);
+}
+
 template <typename Request, typename Response>
 butil::Status CoordinatorInteraction::SendRequestByService(const std::string& api_name, const Request& request,
                                                            Response& response, int64_t time_out_ms) {
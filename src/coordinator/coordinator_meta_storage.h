@@ -15,6 +15,7 @@
 #ifndef DINGODB_COORDINATOR_META_STORAGE_H_
 #define DINGODB_COORDINATOR_META_STORAGE_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <utility>
@@ -40,6 +41,9 @@ namespace dingodb {
 #define COORDINATOR_ID_OF_MAP_MIN 1000
 #define COORDINATOR_GET_NEXT_IDS_MAX_BATCH 100000
 
+// batch size of putting recovered elements to memory map
+constexpr size_t kMetaRecoverBatchSize = 4096;
+
 inline std::string EncodeInt64Id(int64_t id) {
   Buf buf(sizeof(int64_t));
   DingoSchema<std::optional<int64_t>>::InternalEncodeKey(&buf, id);
@@ -340,34 +344,36 @@ class MetaDiskMap {
   std::string GenKey(std::string id) { return internal_prefix + "_" + id; }
   std::string GenKey(int64_t id) { return internal_prefix + "_" + EncodeInt64Id(id); }
 
-  pb::common::KeyValue TransformToKvValue(T element) {
+  pb::common::KeyValue TransformToKvValue(const T &element) {
     pb::common::KeyValue kv;
     kv.set_key(GenKey(element.id()));
     kv.set_value(element.SerializeAsString());
     return kv;
   }
 
-  void TransformToKvValue(T element, pb::common::KeyValue &kv) {
+  void TransformToKvValue(const T &element, pb::common::KeyValue &kv) {
     kv.set_key(GenKey(element.id()));
     kv.set_value(element.SerializeAsString());
   }
 
-  void TransformToKvValues(std::vector<T> elements, std::vector<pb::common::KeyValue> &kvs) {
-    for (auto &element : elements) {
+  void TransformToKvValues(const std::vector<T> &elements, std::vector<pb::common::KeyValue> &kvs) {
+    kvs.reserve(kvs.size() + elements.size());
+    for (const auto &element : elements) {
       pb::common::KeyValue kv;
       kv.set_key(GenKey(element.id()));
       kv.set_value(element.SerializeAsString());
-      kvs.push_back(kv);
+      kvs.push_back(std::move(kv));
     }
   }
 
   void TransformFromKvValue(const pb::common::KeyValue &kv, T &element) { element.ParsePartialFromString(kv.value()); };
 
   void TransformFromKvValues(const std::vector<pb::common::KeyValue> &kvs, std::vector<T> &elements) {
+    elements.reserve(elements.size() + kvs.size());
     for (const auto &kv : kvs) {
       T element;
       element.ParsePartialFromString(kv.value());
-      elements.push_back(element);
+      elements.push_back(std::move(element));
     }
   };
 
@@ -455,7 +461,7 @@ class MetaDiskMap {
     CHECK(ids.size() == elements.size());
 
     std::vector<pb::common::KeyValue> kvs;
-    TransformToKvValue(elements, kvs);
+    TransformToKvValues(elements, kvs);
     butil::Status status = raw_engine_->Writer()->KvBatchPutAndDelete(Constant::kStoreMetaCF, kvs, {});
     if (!status.ok()) {
       DINGO_LOG(ERROR) << fmt::format("Meta put keys {} failed, errcode: {} {}", ids.size(), status.error_code(),
@@ -668,21 +674,31 @@ class MetaMemMapFlat {
       : internal_prefix(std::string("METAFLT") + prefix), raw_engine_(raw_engine), elements_(elements){};
   ~MetaMemMapFlat() = default;
 
+  // parse and put in batches, only one batch of parsed elements is kept besides the map
   bool Recover(const std::vector<pb::common::KeyValue> &kvs) {
     elements_->Clear();
 
     std::vector<int64_t> key_list;
     std::vector<T> value_list;
+    key_list.reserve(std::min(kvs.size(), kMetaRecoverBatchSize));
+    value_list.reserve(std::min(kvs.size(), kMetaRecoverBatchSize));
 
     for (const auto &kv : kvs) {
-      int64_t id = ParseIntId(kv.key());
       T element;
       element.ParsePartialFromString(kv.value());
-      key_list.push_back(id);
-      value_list.push_back(element);
+      key_list.push_back(ParseIntId(kv.key()));
+      value_list.push_back(std::move(element));
+
+      if (key_list.size() >= kMetaRecoverBatchSize) {
+        elements_->MultiPut(key_list, value_list);
+        key_list.clear();
+        value_list.clear();
+      }
     }
 
-    elements_->MultiPut(key_list, value_list);
+    if (!key_list.empty()) {
+      elements_->MultiPut(key_list, value_list);
+    }
 
     return true;
   }
@@ -724,34 +740,36 @@ class MetaMemMapFlat {
   std::string GenKey(std::string id) { return internal_prefix + "_" + id; }
   std::string GenKey(int64_t id) { return internal_prefix + "_" + EncodeInt64(id); }
 
-  pb::common::KeyValue TransformToKvValue(T element) {
+  pb::common::KeyValue TransformToKvValue(const T &element) {
     pb::common::KeyValue kv;
     kv.set_key(GenKey(element.id()));
     kv.set_value(element.SerializeAsString());
     return kv;
   }
 
-  void TransformToKvValue(T element, pb::common::KeyValue &kv) {
+  void TransformToKvValue(const T &element, pb::common::KeyValue &kv) {
     kv.set_key(GenKey(element.id()));
     kv.set_value(element.SerializeAsString());
   }
 
-  void TransformToKvValues(std::vector<T> elements, std::vector<pb::common::KeyValue> &kvs) {
-    for (auto &element : elements) {
+  void TransformToKvValues(const std::vector<T> &elements, std::vector<pb::common::KeyValue> &kvs) {
+    kvs.reserve(kvs.size() + elements.size());
+    for (const auto &element : elements) {
       pb::common::KeyValue kv;
       kv.set_key(GenKey(element.id()));
       kv.set_value(element.SerializeAsString());
-      kvs.push_back(kv);
+      kvs.push_back(std::move(kv));
     }
   }
 
   void TransformFromKvValue(const pb::common::KeyValue &kv, T &element) { element.ParsePartialFromString(kv.value()); };
 
   void TransformFromKvValues(const std::vector<pb::common::KeyValue> &kvs, std::vector<T> &elements) {
+    elements.reserve(elements.size() + kvs.size());
     for (const auto &kv : kvs) {
       T element;
       element.ParsePartialFromString(kv.value());
-      elements.push_back(element);
+      elements.push_back(std::move(element));
     }
   };
 
@@ -761,11 +779,12 @@ class MetaMemMapFlat {
     elements_->GetRawMapCopy(temp_map);
 
     std::vector<pb::common::KeyValue> kvs;
+    kvs.reserve(temp_map.size());
     for (const auto &it : temp_map) {
       pb::common::KeyValue kv;
       kv.set_key(GenKey(it.first));
       kv.set_value(it.second.SerializeAsString());
-      kvs.push_back(kv);
+      kvs.push_back(std::move(kv));
     }
 
     return kvs;
@@ -927,21 +946,31 @@ class MetaMemMapStd {
       : internal_prefix(std::string("METASFM") + prefix), raw_engine_(raw_engine), elements_(elements){};
   ~MetaMemMapStd() = default;
 
+  // parse and put in batches, only one batch of parsed elements is kept besides the map
   bool Recover(const std::vector<pb::common::KeyValue> &kvs) {
     elements_->Clear();
 
     std::vector<std::string> key_list;
     std::vector<T> value_list;
+    key_list.reserve(std::min(kvs.size(), kMetaRecoverBatchSize));
+    value_list.reserve(std::min(kvs.size(), kMetaRecoverBatchSize));
 
     for (const auto &kv : kvs) {
-      std::string id = ParseId(kv.key());
       T element;
       element.ParsePartialFromString(kv.value());
-      key_list.push_back(id);
-      value_list.push_back(element);
+      key_list.push_back(ParseId(kv.key()));
+      value_list.push_back(std::move(element));
+
+      if (key_list.size() >= kMetaRecoverBatchSize) {
+        elements_->MultiPut(key_list, value_list);
+        key_list.clear();
+        value_list.clear();
+      }
     }
 
-    elements_->MultiPut(key_list, value_list);
+    if (!key_list.empty()) {
+      elements_->MultiPut(key_list, value_list);
+    }
 
     return true;
   }
@@ -959,34 +988,36 @@ class MetaMemMapStd {
 
   std::string GenKey(std::string id) { return internal_prefix + "_" + id; }
 
-  pb::common::KeyValue TransformToKvValue(T element) {
+  pb::common::KeyValue TransformToKvValue(const T &element) {
     pb::common::KeyValue kv;
     kv.set_key(GenKey(element.id()));
     kv.set_value(element.SerializeAsString());
     return kv;
   }
 
-  void TransformToKvValue(T element, pb::common::KeyValue &kv) {
+  void TransformToKvValue(const T &element, pb::common::KeyValue &kv) {
     kv.set_key(GenKey(element.id()));
     kv.set_value(element.SerializeAsString());
   }
 
-  void TransformToKvValues(std::vector<T> elements, std::vector<pb::common::KeyValue> &kvs) {
-    for (auto &element : elements) {
+  void TransformToKvValues(const std::vector<T> &elements, std::vector<pb::common::KeyValue> &kvs) {
+    kvs.reserve(kvs.size() + elements.size());
+    for (const auto &element : elements) {
       pb::common::KeyValue kv;
       kv.set_key(GenKey(element.id()));
       kv.set_value(element.SerializeAsString());
-      kvs.push_back(kv);
+      kvs.push_back(std::move(kv));
     }
   }
 
   void TransformFromKvValue(const pb::common::KeyValue &kv, T &element) { element.ParsePartialFromString(kv.value()); };
 
   void TransformFromKvValues(const std::vector<pb::common::KeyValue> &kvs, std::vector<T> &elements) {
+    elements.reserve(elements.size() + kvs.size());
     for (const auto &kv : kvs) {
       T element;
       element.ParsePartialFromString(kv.value());
-      elements.push_back(element);
+      elements.push_back(std::move(element));
     }
   };
 
@@ -1027,7 +1058,7 @@ class MetaMemMapStd {
     }
 
     std::vector<pb::common::KeyValue> kvs;
-    TransformToKvValue(elements, kvs);
+    TransformToKvValues(elements, kvs);
     butil::Status status = raw_engine_->Writer()->KvBatchPutAndDelete(Constant::kStoreMetaCF, kvs, {});
     if (!status.ok()) {
       DINGO_LOG(ERROR) << fmt::format("Meta put keys {} failed, errcode: {} {}", ids.size(), status.error_code(),
@@ -19,16 +19,21 @@
 
 #include <atomic>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
+#include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "brpc/stream.h"
 #include "bthread/types.h"
 #include "butil/status.h"
 #include "common/meta_control.h"
 #include "common/safe_map.h"
 #include "coordinator/coordinator_meta_storage.h"
+#include "coordinator/meta_snapshot.h"
 #include "engine/engine.h"
 #include "engine/snapshot.h"
 #include "google/protobuf/stubs/callback.h"
@@ -67,6 +72,23 @@ struct KvWatchNode {
   bool need_prev_kv;
 };
 
+// A long-lived watch on key range, events are pushed by brpc stream.
+// The events not sent yet are coalesced by key, only the latest event of a key is kept,
+// and they are sent in revision order.
+struct KvStreamWatchNode {
+  int64_t watch_id{0};
+  brpc::StreamId stream_id{brpc::INVALID_STREAM_ID};
+  std::string key;
+  std::string range_end;
+  int64_t start_revision{0};
+  bool no_put_event{false};
+  bool no_delete_event{false};
+  bool need_prev_kv{false};
+  // waiting the stream writable to send pending events
+  bool wait_writable{false};
+  std::map<std::string, pb::version::Event> pending_events;
+};
+
 class DeferDone {
  public:
   DeferDone() {
@@ -214,6 +236,10 @@ class KvControl : public MetaControl {
   bool LoadMetaFromSnapshotFile(
       pb::coordinator_internal::MetaSnapshotFile &meta_snapshot_file) override;  // for raft fsm
 
+  // the maps saved in snapshot file, saved and loaded in parallel
+  std::vector<MetaSnapshotSection> GetMetaSnapshotSections(
+      pb::coordinator_internal::MetaSnapshotFile &meta_snapshot_file);
+
   static void KvLogMetaIncrementSize(pb::coordinator_internal::MetaIncrement &meta_increment);
 
   // lease timeout/revoke task
@@ -332,6 +358,21 @@ class KvControl : public MetaControl {
   butil::Status TriggerOneWatch(const std::string &key, pb::version::Event::EventType event_type,
                                 pb::version::Kv &new_kv, pb::version::Kv &prev_kv);
 
+  // stream watch functions for api, the stream is accepted on cntl
+  butil::Status CreateStreamWatch(const pb::version::WatchCreateRequest &request, brpc::Controller *cntl,
+                                  pb::version::WatchResponse *response);
+  butil::Status CancelStreamWatch(int64_t watch_id);
+  // called when stream is closed by client or by CancelStreamWatch
+  void RemoveStreamWatch(int64_t watch_id);
+  bool HasStreamWatch() const { return stream_watch_count_.load(std::memory_order_relaxed) > 0; }
+
+  // stream watch functions for raft fsm
+  void TriggerStreamWatch(const std::string &key, pb::version::Event::EventType event_type,
+                          const pb::version::Kv &new_kv, const pb::version::Kv &prev_kv);
+  // send the pending events when the stream of slow watcher is writable again
+  void FlushStreamWatch(int64_t watch_id);
+  void CloseAllStreamWatch();
+
  private:
   // deprecated, will removed in the future
   // ids_epochs_temp (out of state machine, only for leader use)
@@ -348,6 +389,11 @@ class KvControl : public MetaControl {
   std::map<int64_t, KvLeaseWithKeys>
       lease_to_key_map_temp_;  // storage lease_id to key map, this map is built in on_leader_start
   bthread_mutex_t lease_to_key_map_temp_mutex_;
+  // (ttl_seconds + last_renew_ts_seconds, lease_id) of leases, the earliest deadline is on the top.
+  // renew does not touch it, LeaseTask pushes the renewed lease back with the new deadline when popped.
+  // protected by lease_to_key_map_temp_mutex_.
+  using LeaseDeadline = std::pair<int64_t, int64_t>;
+  std::priority_queue<LeaseDeadline, std::vector<LeaseDeadline>, std::greater<LeaseDeadline>> lease_deadline_heap_;
 
   // 15.version kv with lease
   DingoSafeStdMap<std::string, pb::coordinator_internal::KvIndexInternal> kv_index_map_;
@@ -364,6 +410,13 @@ class KvControl : public MetaControl {
   std::atomic<uint64_t> one_time_watch_closure_seq_{1000};  // used to generate unique closure id
   DingoSafeStdMap<uint64_t, bool> one_time_watch_closure_status_map_;
 
+  // stream watch map, watch_id -> node
+  // this map on work on leader, is out of state machine
+  std::map<int64_t, KvStreamWatchNode> stream_watch_map_;
+  bthread_mutex_t stream_watch_map_mutex_;
+  std::atomic<int64_t> stream_watch_seq_{1};
+  std::atomic<int64_t> stream_watch_count_{0};
+
   // Read meta data from persistence storage.
   std::shared_ptr<MetaReader> meta_reader_;
   // Write meta data to persistence storage.
@@ -107,6 +107,9 @@ void KvControl::OnLeaderStop() {
     one_time_watch_closure_map_.clear();
   }
 
+  // close stream watch, client will watch the new leader
+  CloseAllStreamWatch();
+
   DINGO_LOG(INFO) << "OnLeaderStop finished";
 }
 
@@ -115,178 +118,35 @@ std::shared_ptr<Snapshot> KvControl::PrepareRaftSnapshot() {
   return raw_engine_of_meta_->GetSnapshot();
 }
 
+// the maps in kv snapshot, kv_rev map is only on disk
+std::vector<MetaSnapshotSection> KvControl::GetMetaSnapshotSections(
+    pb::coordinator_internal::MetaSnapshotFile& meta_snapshot_file) {
+  return {
+      {"id_epoch_meta", id_epoch_meta_->internal_prefix, meta_snapshot_file.mutable_id_epoch_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return id_epoch_meta_->Recover(kvs); }},
+      {"kv_lease_meta", kv_lease_meta_->internal_prefix, meta_snapshot_file.mutable_lease_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return kv_lease_meta_->Recover(kvs); }},
+      {"kv_index_meta", kv_index_meta_->internal_prefix, meta_snapshot_file.mutable_kv_index_map_kvs(),
+       [this](const std::vector<pb::common::KeyValue>& kvs) { return kv_index_meta_->Recover(kvs); }},
+      {"kv_rev_meta", kv_rev_meta_->internal_prefix, meta_snapshot_file.mutable_kv_rev_map_kvs(), nullptr},
+  };
+}
+
 bool KvControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapshot,
                                        pb::coordinator_internal::MetaSnapshotFile& meta_snapshot_file) {
   DINGO_LOG(INFO) << "Coordinator start to LoadMetaToSnapshotFile";
 
-  std::vector<pb::common::KeyValue> kvs;
-
-  // 0.id_epoch map
-  if (!meta_reader_->Scan(snapshot, id_epoch_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_id_epoch_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-
-  DINGO_LOG(INFO) << "Snapshot id_epoch_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 14.lease_map_
-  if (!meta_reader_->Scan(snapshot, kv_lease_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_lease_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot lease_map_, count=" << kvs.size();
-  kvs.clear();
-
-  // 15.kv_index_map_
-  if (!meta_reader_->Scan(snapshot, kv_index_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_kv_index_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot kv_index_map_, count=" << kvs.size();
-  kvs.clear();
-
-  // 16.version_kv_rev_map_
-  if (!meta_reader_->Scan(snapshot, kv_rev_meta_->Prefix(), kvs)) {
-    return false;
-  }
-
-  for (const auto& kv : kvs) {
-    auto* snapshot_file_kv = meta_snapshot_file.add_kv_rev_map_kvs();
-    *snapshot_file_kv = kv;
-  }
-  DINGO_LOG(INFO) << "Snapshot version_kv_rev_map_, count=" << kvs.size();
-  kvs.clear();
-
-  return true;
+  auto sections = GetMetaSnapshotSections(meta_snapshot_file);
+  return MetaSnapshot::Save(meta_reader_, snapshot, sections);
 }
 
 bool KvControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::MetaSnapshotFile& meta_snapshot_file) {
   DINGO_LOG(INFO) << "Coordinator start to LoadMetaFromSnapshotFile";
 
-  std::vector<pb::common::KeyValue> kvs;
-
-  // 0.id_epoch map
-  kvs.reserve(meta_snapshot_file.id_epoch_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.id_epoch_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.id_epoch_map_kvs(i));
-  }
-  {
-    // BAIDU_SCOPED_LOCK(id_epoch_map_mutex_);
-    if (!id_epoch_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(id_epoch_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete id_epoch_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range id_epoch_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write id_epoch_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put id_epoch_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot id_epoch_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 14.lease_map_
-  kvs.reserve(meta_snapshot_file.lease_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.lease_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.lease_map_kvs(i));
-  }
-  {
-    // BAIDU_SCOPED_LOCK(lease_map_mutex_);
-    if (!kv_lease_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(kv_lease_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete lease_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range lease_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write lease_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put lease_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot version_lease_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 15.kv_index_map_
-  kvs.reserve(meta_snapshot_file.kv_index_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.kv_index_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.kv_index_map_kvs(i));
-  }
-  {
-    if (!kv_index_meta_->Recover(kvs)) {
-      return false;
-    }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(kv_index_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete kv_index_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range kv_index_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write kv_index_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put kv_index_meta_ success in LoadMetaFromSnapshotFile";
-  }
-  DINGO_LOG(INFO) << "LoadSnapshot version_kv_meta, count=" << kvs.size();
-  kvs.clear();
-
-  // 16.kv_rev_map_
-  kvs.reserve(meta_snapshot_file.kv_rev_map_kvs_size());
-  for (int i = 0; i < meta_snapshot_file.kv_rev_map_kvs_size(); i++) {
-    kvs.push_back(meta_snapshot_file.kv_rev_map_kvs(i));
-  }
-  {
-    // if (!kv_rev_meta_->Recover(kvs)) {
-    //   return false;
-    // }
-
-    // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(kv_rev_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete kv_rev_meta_ range failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator delete range kv_rev_meta_ success in LoadMetaFromSnapshotFile";
-
-    // write data to rocksdb
-    if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write kv_rev_meta_ failed in LoadMetaFromSnapshotFile";
-      return false;
-    }
-    DINGO_LOG(INFO) << "Coordinator put kv_rev_meta_ success in LoadMetaFromSnapshotFile";
+  auto sections = GetMetaSnapshotSections(meta_snapshot_file);
+  if (!MetaSnapshot::Load(meta_writer_, sections)) {
+    return false;
   }
-  DINGO_LOG(INFO) << "LoadSnapshot version_kv_rev_meta, count=" << kvs.size();
-  kvs.clear();
 
   // build id_epoch, schema_name, table_name, index_name maps
   BuildTempMaps();
@@ -705,7 +705,7 @@ butil::Status KvControl::KvPutApply(const std::string &key,
       << "), kv_index: " << kv_index.ShortDebugString();
 
   // trigger watch
-  if (!one_time_watch_map_.empty()) {
+  if (!one_time_watch_map_.empty() || HasStreamWatch()) {
     DINGO_LOG(INFO) << "KvPutApply one_time_watch_map_ is not empty, will trigger watch, key: " << key << "("
                     << Helper::StringToHex(key) << "), watch size: " << one_time_watch_map_.size();
 
@@ -722,6 +722,7 @@ butil::Status KvControl::KvPutApply(const std::string &key,
     new_kv.mutable_kv()->set_value(kv_rev.kv().value());
 
     TriggerOneWatch(key, pb::version::Event::EventType::Event_EventType_PUT, new_kv, prev_kv);
+    TriggerStreamWatch(key, pb::version::Event::EventType::Event_EventType_PUT, new_kv, prev_kv);
   }
 
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_kv)
@@ -847,7 +848,7 @@ butil::Status KvControl::KvDeleteApply(const std::string &key,
       << "), revision: " << op_revision.ShortDebugString();
 
   // trigger watch
-  if (!one_time_watch_map_.empty()) {
+  if (!one_time_watch_map_.empty() || HasStreamWatch()) {
     DINGO_LOG(INFO) << "KvDeleteApply one_time_watch_map_ is not empty, will trigger watch, key: " << key << "("
                     << Helper::StringToHex(key) << "), watch size: " << one_time_watch_map_.size();
 
@@ -864,6 +865,7 @@ butil::Status KvControl::KvDeleteApply(const std::string &key,
     new_kv.mutable_kv()->set_value(kv_rev.kv().value());
 
     TriggerOneWatch(key, pb::version::Event::EventType::Event_EventType_DELETE, new_kv, prev_kv);
+    TriggerStreamWatch(key, pb::version::Event::EventType::Event_EventType_DELETE, new_kv, prev_kv);
   }
 
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_kv)
@@ -873,6 +875,33 @@ butil::Status KvControl::KvDeleteApply(const std::string &key,
   return butil::Status::OK();
 }
 
+// Need compact if there is any revision older than compact_revision except the latest one, or the key is deleted.
+// Keys without old revisions are skipped, so the compaction does not propose raft log for every key.
+static bool NeedCompact(const pb::coordinator_internal::KvIndexInternal &kv_index,
+                        const pb::coordinator_internal::RevisionInternal &compact_revision) {
+  for (int i = 0; i < kv_index.generations_size(); ++i) {
+    const auto &generation = kv_index.generations(i);
+    bool is_latest_generation = (i == kv_index.generations_size() - 1);
+    if (!generation.has_create_revision()) {
+      if (is_latest_generation) {
+        return true;
+      }
+      continue;
+    }
+
+    for (int j = 0; j < generation.revisions_size(); ++j) {
+      if (is_latest_generation && j == generation.revisions_size() - 1) {
+        continue;
+      }
+      if (generation.revisions(j).main() < compact_revision.main()) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
 void KvControl::CompactionTask() {
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_kv) << "compaction task start";
 
@@ -903,9 +932,16 @@ void KvControl::CompactionTask() {
 
   compact_revision.set_sub(0);
 
-  // do compaction for each key
+  // do compaction for each key which has revisions to compact
   std::vector<std::string> keys_to_compact;
+  int64_t skip_count = 0;
   for (const auto &key : keys) {
+    pb::coordinator_internal::KvIndexInternal kv_index;
+    if (kv_index_map_.Get(key, kv_index) > 0 && !NeedCompact(kv_index, compact_revision)) {
+      ++skip_count;
+      continue;
+    }
+
     if (keys_to_compact.size() < 50) {
       keys_to_compact.push_back(key);
     } else {
@@ -929,7 +965,7 @@ void KvControl::CompactionTask() {
     }
   }
 
-  DINGO_LOG(INFO) << "compaction task end, keys_count=" << keys.size();
+  DINGO_LOG(INFO) << "compaction task end, keys_count=" << keys.size() << ", skip_count=" << skip_count;
 }
 
 static void Done(std::atomic<bool> *done) { done->store(true, std::memory_order_release); }
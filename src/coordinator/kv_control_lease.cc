@@ -15,6 +15,8 @@
 #include <sys/types.h>
 
 #include <cstdint>
+#include <functional>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -95,6 +97,9 @@ butil::Status KvControl::LeaseGrant(int64_t lease_id, int64_t ttl_seconds, int64
   {
     BAIDU_SCOPED_LOCK(lease_to_key_map_temp_mutex_);
     lease_to_key_map_temp_.emplace(lease_with_keys.lease.id(), lease_with_keys);
+    lease_deadline_heap_.emplace(
+        lease_with_keys.lease.ttl_seconds() + lease_with_keys.lease.last_renew_ts_seconds(),
+        lease_with_keys.lease.id());
   }
 
   return butil::Status::OK();
@@ -241,21 +246,42 @@ void KvControl::LeaseTask() {
       return;
     }
 
-    for (const auto &it : lease_to_key_map_temp_) {
-      const auto &lease = it.second.lease;
-      if (lease.ttl_seconds() + lease.last_renew_ts_seconds() < butil::gettimeofday_s()) {
+    // only pop the leases whose deadline in heap is near, the deadline in heap is not later than the real one.
+    auto now_seconds = butil::gettimeofday_s();
+    std::vector<LeaseDeadline> deadlines_to_push;
+    std::set<int64_t> popped_lease_ids;
+    while (!lease_deadline_heap_.empty() &&
+           lease_deadline_heap_.top().first < now_seconds + FLAGS_version_lease_print_ttl_remaining_seconds) {
+      auto lease_id = lease_deadline_heap_.top().second;
+      lease_deadline_heap_.pop();
+
+      // revoked lease, or a duplicated deadline of a lease granted again
+      auto iter = lease_to_key_map_temp_.find(lease_id);
+      if (iter == lease_to_key_map_temp_.end() || !popped_lease_ids.insert(lease_id).second) {
+        continue;
+      }
+
+      const auto &lease = iter->second.lease;
+      if (lease.ttl_seconds() + lease.last_renew_ts_seconds() < now_seconds) {
         DINGO_LOG(INFO) << "lease id " << lease.id() << " expired, will revoke";
         lease_ids_to_revoke.emplace_back(lease.id());
       } else {
-        auto remaining_ttl_seconds = lease.ttl_seconds() - (butil::gettimeofday_s() - lease.last_renew_ts_seconds());
+        auto remaining_ttl_seconds = lease.ttl_seconds() - (now_seconds - lease.last_renew_ts_seconds());
         if (remaining_ttl_seconds < FLAGS_version_lease_print_ttl_remaining_seconds) {
           DINGO_LOG(INFO) << "lease id " << lease.id() << " is ok, last_renew_ts_seconds "
                           << lease.last_renew_ts_seconds() << ", ttl_seconds " << lease.ttl_seconds()
                           << ", remaining ttl_seconds " << remaining_ttl_seconds;
         }
+        deadlines_to_push.emplace_back(lease.ttl_seconds() + lease.last_renew_ts_seconds(), lease.id());
       }
     }
 
+    // push after the loop, else the lease near deadline is popped again and again
+    for (const auto &deadline : deadlines_to_push) {
+      lease_deadline_heap_.push(deadline);
+    }
+
+    // revoke of all expired leases and their keys are submitted in one meta_increment
     for (const auto &lease_id : lease_ids_to_revoke) {
       LeaseRevoke(lease_id, meta_increment, true);
     }
@@ -324,8 +350,16 @@ void KvControl::BuildLeaseToKeyMap() {
     }
   }
 
+  std::vector<LeaseDeadline> deadlines;
+  deadlines.reserve(t_lease_to_key.size());
+  for (const auto &it : t_lease_to_key) {
+    deadlines.emplace_back(it.second.lease.ttl_seconds() + it.second.lease.last_renew_ts_seconds(), it.first);
+  }
+  decltype(lease_deadline_heap_) t_lease_deadline_heap(std::greater<LeaseDeadline>(), std::move(deadlines));
+
   BAIDU_SCOPED_LOCK(lease_to_key_map_temp_mutex_);
   lease_to_key_map_temp_.swap(t_lease_to_key);
+  lease_deadline_heap_.swap(t_lease_deadline_heap);
 }
 
 butil::Status KvControl::LeaseAddKeys(int64_t lease_id, std::set<std::string> &keys) {
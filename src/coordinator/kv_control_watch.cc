@@ -14,15 +14,18 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "brpc/closure_guard.h"
+#include "brpc/stream.h"
 #include "bthread/mutex.h"
 #include "butil/scoped_lock.h"
 #include "butil/status.h"
+#include "butil/iobuf.h"
 #include "butil/time.h"
 #include "common/logging.h"
 #include "coordinator/kv_control.h"
@@ -36,6 +39,10 @@ DEFINE_int64(version_watch_max_count, 50000, "max count of version watch");
 
 DEFINE_bool(dingo_log_switch_coor_watch, false, "switch for dingo log of kv control lease");
 
+DEFINE_int64(version_stream_watch_max_count, 10000, "max count of version stream watch");
+DEFINE_int64(version_stream_watch_max_pending_events, 10000,
+             "max coalesced pending events of a stream watch, the watch is closed if exceed");
+
 void WatchCancelCallback(KvControl* kv_control, uint64_t closure_id) {
   kv_control->CancelOneTimeWatchClosure(closure_id);
   // kv_control->RemoveOneTimeWatch(closure_id);
@@ -366,4 +373,251 @@ butil::Status KvControl::TriggerOneWatch(const std::string& key, pb::version::Ev
   return butil::Status::OK();
 }
 
+// close the stream watch node when stream is closed by client or server
+class KvStreamWatchHandler : public brpc::StreamInputHandler {
+ public:
+  KvStreamWatchHandler(KvControl* kv_control, int64_t watch_id) : kv_control_(kv_control), watch_id_(watch_id) {}
+
+  int on_received_messages(brpc::StreamId /*id*/, butil::IOBuf* const /*messages*/[], size_t /*size*/) override {
+    return 0;
+  }
+
+  void on_idle_timeout(brpc::StreamId /*id*/) override {}
+
+  void on_closed(brpc::StreamId /*id*/) override {
+    kv_control_->RemoveStreamWatch(watch_id_);
+    delete this;
+  }
+
+ private:
+  KvControl* kv_control_;
+  int64_t watch_id_;
+};
+
+struct KvStreamWritableArg {
+  KvControl* kv_control;
+  int64_t watch_id;
+};
+
+static void OnStreamWatchWritable(brpc::StreamId /*id*/, void* arg, int error_code) {
+  auto* writable_arg = static_cast<KvStreamWritableArg*>(arg);
+  if (error_code == 0) {
+    writable_arg->kv_control->FlushStreamWatch(writable_arg->watch_id);
+  }
+  delete writable_arg;
+}
+
+// range_end is empty means only key, range_end is "\0" means all keys >= key.
+static bool IsKeyInWatchRange(const std::string& key, const std::string& watch_key, const std::string& range_end) {
+  if (range_end.empty()) {
+    return key == watch_key;
+  }
+  if (range_end == std::string(1, '\0')) {
+    return key >= watch_key;
+  }
+  return key >= watch_key && key < range_end;
+}
+
+// send pending events in revision order, caller must hold stream_watch_map_mutex_
+// return false if the pending events exceed the limit, the watcher is too slow and should be closed.
+static bool FlushStreamWatchNode(KvControl* kv_control, KvStreamWatchNode& node) {
+  if (node.pending_events.empty() || node.wait_writable) {
+    return static_cast<int64_t>(node.pending_events.size()) <= FLAGS_version_stream_watch_max_pending_events;
+  }
+
+  std::vector<const pb::version::Event*> events;
+  events.reserve(node.pending_events.size());
+  for (const auto& [key, event] : node.pending_events) {
+    events.push_back(&event);
+  }
+  std::sort(events.begin(), events.end(), [](const pb::version::Event* lhs, const pb::version::Event* rhs) {
+    return lhs->kv().mod_revision() < rhs->kv().mod_revision();
+  });
+
+  pb::version::WatchResponse response;
+  response.set_watch_id(node.watch_id);
+  for (const auto* event : events) {
+    *response.add_events() = *event;
+  }
+
+  butil::IOBuf buf;
+  butil::IOBufAsZeroCopyOutputStream wrapper(&buf);
+  response.SerializeToZeroCopyStream(&wrapper);
+
+  int ret = brpc::StreamWrite(node.stream_id, buf);
+  if (ret == 0) {
+    node.pending_events.clear();
+    return true;
+  }
+
+  if (ret == EAGAIN) {
+    // stream buffer is full, keep events pending and coalesce the following events until writable
+    node.wait_writable = true;
+    brpc::StreamWait(node.stream_id, nullptr, OnStreamWatchWritable,
+                     new KvStreamWritableArg{kv_control, node.watch_id});
+  }
+
+  return static_cast<int64_t>(node.pending_events.size()) <= FLAGS_version_stream_watch_max_pending_events;
+}
+
+butil::Status KvControl::CreateStreamWatch(const pb::version::WatchCreateRequest& request, brpc::Controller* cntl,
+                                           pb::version::WatchResponse* response) {
+  if (stream_watch_count_.load(std::memory_order_relaxed) >= FLAGS_version_stream_watch_max_count) {
+    DINGO_LOG(ERROR) << "CreateStreamWatch, stream watch count exceeds limit, count:" << stream_watch_count_.load()
+                     << ", request:" << request.ShortDebugString();
+    return butil::Status(pb::error::Errno::EWATCH_COUNT_EXCEEDS_LIMIT, "stream watch count exceeds limit");
+  }
+
+  KvStreamWatchNode node;
+  node.watch_id = stream_watch_seq_.fetch_add(1, std::memory_order_relaxed);
+  node.key = request.key();
+  node.range_end = request.range_end();
+  node.start_revision = request.start_revision();
+  node.need_prev_kv = request.need_prev_kv();
+  for (const auto& filter : request.filters()) {
+    if (filter == pb::version::EventFilterType::NOPUT) {
+      node.no_put_event = true;
+    } else if (filter == pb::version::EventFilterType::NODELETE) {
+      node.no_delete_event = true;
+    }
+  }
+
+  if (node.start_revision == 0) {
+    node.start_revision = GetPresentId(pb::coordinator_internal::IdEpochType::ID_NEXT_REVISION);
+  } else if (!node.no_put_event) {
+    // catch up the keys modified after start_revision, only the latest kv is sent, deleted keys are not replayed
+    std::vector<pb::version::Kv> kvs;
+    int64_t total_count_in_range = 0;
+    bool has_more = false;
+    KvRange(node.key, node.range_end, 0, false, false, kvs, total_count_in_range, has_more);
+    for (auto& kv : kvs) {
+      if (kv.mod_revision() < node.start_revision) {
+        continue;
+      }
+      pb::version::Event event;
+      event.set_type(pb::version::Event::EventType::Event_EventType_PUT);
+      std::string key = kv.kv().key();
+      *event.mutable_kv() = std::move(kv);
+      node.pending_events.insert_or_assign(key, std::move(event));
+    }
+  }
+
+  auto* handler = new KvStreamWatchHandler(this, node.watch_id);
+  brpc::StreamOptions options;
+  options.handler = handler;
+  if (brpc::StreamAccept(&node.stream_id, *cntl, &options) != 0) {
+    delete handler;
+    DINGO_LOG(ERROR) << "CreateStreamWatch, accept stream failed, request:" << request.ShortDebugString();
+    return butil::Status(pb::error::Errno::EINTERNAL, "accept stream failed");
+  }
+
+  DINGO_LOG(INFO) << "CreateStreamWatch, watch_id:" << node.watch_id << ", stream_id:" << node.stream_id
+                  << ", key:" << Helper::StringToHex(node.key) << ", range_end:" << Helper::StringToHex(node.range_end)
+                  << ", start_revision:" << node.start_revision << ", catch_up_events:" << node.pending_events.size();
+
+  response->set_watch_id(node.watch_id);
+  response->set_created(true);
+
+  BAIDU_SCOPED_LOCK(stream_watch_map_mutex_);
+  auto it = stream_watch_map_.insert_or_assign(node.watch_id, std::move(node)).first;
+  stream_watch_count_.fetch_add(1, std::memory_order_relaxed);
+  FlushStreamWatchNode(this, it->second);
+
+  return butil::Status::OK();
+}
+
+butil::Status KvControl::CancelStreamWatch(int64_t watch_id) {
+  brpc::StreamId stream_id = brpc::INVALID_STREAM_ID;
+  {
+    BAIDU_SCOPED_LOCK(stream_watch_map_mutex_);
+    auto it = stream_watch_map_.find(watch_id);
+    if (it == stream_watch_map_.end()) {
+      return butil::Status(pb::error::Errno::EWATCH_NOT_EXIST, "stream watch not exist");
+    }
+    stream_id = it->second.stream_id;
+  }
+
+  DINGO_LOG(INFO) << "CancelStreamWatch, watch_id:" << watch_id << ", stream_id:" << stream_id;
+
+  // the node is removed in the on_closed of stream handler
+  brpc::StreamClose(stream_id);
+
+  return butil::Status::OK();
+}
+
+void KvControl::RemoveStreamWatch(int64_t watch_id) {
+  BAIDU_SCOPED_LOCK(stream_watch_map_mutex_);
+  if (stream_watch_map_.erase(watch_id) > 0) {
+    stream_watch_count_.fetch_sub(1, std::memory_order_relaxed);
+    DINGO_LOG(INFO) << "RemoveStreamWatch, watch_id:" << watch_id;
+  }
+}
+
+void KvControl::TriggerStreamWatch(const std::string& key, pb::version::Event::EventType event_type,
+                                   const pb::version::Kv& new_kv, const pb::version::Kv& prev_kv) {
+  std::vector<brpc::StreamId> slow_stream_ids;
+  {
+    BAIDU_SCOPED_LOCK(stream_watch_map_mutex_);
+    for (auto& [watch_id, node] : stream_watch_map_) {
+      if (!IsKeyInWatchRange(key, node.key, node.range_end)) {
+        continue;
+      }
+      if (node.no_put_event && event_type == pb::version::Event::EventType::Event_EventType_PUT) {
+        continue;
+      }
+      if (node.no_delete_event && event_type == pb::version::Event::EventType::Event_EventType_DELETE) {
+        continue;
+      }
+      if (node.start_revision > new_kv.mod_revision()) {
+        continue;
+      }
+
+      // coalesce with the pending event of the same key
+      pb::version::Event event;
+      event.set_type(event_type);
+      *event.mutable_kv() = new_kv;
+      if (node.need_prev_kv) {
+        auto it = node.pending_events.find(key);
+        *event.mutable_prev_kv() = (it != node.pending_events.end()) ? it->second.prev_kv() : prev_kv;
+      }
+      node.pending_events.insert_or_assign(key, std::move(event));
+
+      if (!FlushStreamWatchNode(this, node)) {
+        slow_stream_ids.push_back(node.stream_id);
+      }
+    }
+  }
+
+  for (auto stream_id : slow_stream_ids) {
+    DINGO_LOG(WARNING) << "TriggerStreamWatch, pending events exceed limit, close stream:" << stream_id;
+    brpc::StreamClose(stream_id);
+  }
+}
+
+void KvControl::FlushStreamWatch(int64_t watch_id) {
+  BAIDU_SCOPED_LOCK(stream_watch_map_mutex_);
+  auto it = stream_watch_map_.find(watch_id);
+  if (it == stream_watch_map_.end()) {
+    return;
+  }
+
+  it->second.wait_writable = false;
+  FlushStreamWatchNode(this, it->second);
+}
+
+void KvControl::CloseAllStreamWatch() {
+  std::vector<brpc::StreamId> stream_ids;
+  {
+    BAIDU_SCOPED_LOCK(stream_watch_map_mutex_);
+    for (const auto& [watch_id, node] : stream_watch_map_) {
+      stream_ids.push_back(node.stream_id);
+    }
+  }
+
+  DINGO_LOG(INFO) << "CloseAllStreamWatch, count:" << stream_ids.size();
+  for (auto stream_id : stream_ids) {
+    brpc::StreamClose(stream_id);
+  }
+}
+
 }  // namespace dingodb
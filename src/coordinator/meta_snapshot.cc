@@ -0,0 +1,131 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "coordinator/meta_snapshot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_int32(meta_snapshot_concurrency, 4, "concurrency of saving and loading meta maps of coordinator snapshot");
+
+bool MetaSnapshot::SaveSection(std::shared_ptr<MetaReader> meta_reader, std::shared_ptr<Snapshot> snapshot,
+                               MetaSnapshotSection& section) {
+  std::vector<pb::common::KeyValue> kvs;
+  if (!meta_reader->Scan(snapshot, section.prefix, kvs)) {
+    DINGO_LOG(ERROR) << fmt::format("Snapshot {} scan failed", section.name);
+    return false;
+  }
+
+  section.kvs->Reserve(kvs.size());
+  for (auto& kv : kvs) {
+    *section.kvs->Add() = std::move(kv);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("Snapshot {}, count={}", section.name, kvs.size());
+  return true;
+}
+
+bool MetaSnapshot::LoadSection(std::shared_ptr<MetaWriter> meta_writer, MetaSnapshotSection& section) {
+  std::vector<pb::common::KeyValue> kvs;
+  kvs.reserve(section.kvs->size());
+  for (auto& kv : *section.kvs) {
+    kvs.push_back(std::move(kv));
+  }
+  section.kvs->Clear();
+
+  if (section.recover != nullptr && !section.recover(kvs)) {
+    DINGO_LOG(ERROR) << fmt::format("LoadSnapshot {} recover failed", section.name);
+    return false;
+  }
+
+  // remove data in rocksdb
+  if (!meta_writer->DeletePrefix(section.prefix)) {
+    DINGO_LOG(ERROR) << fmt::format("LoadSnapshot {} delete range failed", section.name);
+    return false;
+  }
+
+  // write data to rocksdb
+  size_t count = kvs.size();
+  if (!meta_writer->Put(std::move(kvs))) {
+    DINGO_LOG(ERROR) << fmt::format("LoadSnapshot {} put failed", section.name);
+    return false;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("LoadSnapshot {}, count={}", section.name, count);
+  return true;
+}
+
+bool MetaSnapshot::Run(std::vector<MetaSnapshotSection>& sections,
+                       const std::function<bool(MetaSnapshotSection&)>& section_func) {
+  struct Parameter {
+    std::vector<MetaSnapshotSection>* sections;
+    const std::function<bool(MetaSnapshotSection&)>* section_func;
+    std::atomic<int> offset{0};
+    std::atomic<bool> success{true};
+  };
+
+  Parameter param;
+  param.sections = &sections;
+  param.section_func = &section_func;
+
+  auto task = [](void* arg) -> void* {
+    auto* param = static_cast<Parameter*>(arg);
+    for (;;) {
+      int offset = param->offset.fetch_add(1, std::memory_order_relaxed);
+      if (offset >= static_cast<int>(param->sections->size()) || !param->success.load(std::memory_order_relaxed)) {
+        break;
+      }
+
+      if (!(*param->section_func)(param->sections->at(offset))) {
+        param->success.store(false, std::memory_order_relaxed);
+        break;
+      }
+    }
+
+    return nullptr;
+  };
+
+  int concurrency = std::min(static_cast<int>(sections.size()), std::max(1, FLAGS_meta_snapshot_concurrency));
+  if (concurrency <= 1) {
+    task(&param);
+  } else if (!Helper::ParallelRunTask(task, &param, concurrency)) {
+    return false;
+  }
+
+  return param.success.load();
+}
+
+bool MetaSnapshot::Save(std::shared_ptr<MetaReader> meta_reader, std::shared_ptr<Snapshot> snapshot,
+                        std::vector<MetaSnapshotSection>& sections) {
+  return Run(sections, [&](MetaSnapshotSection& section) { return SaveSection(meta_reader, snapshot, section); });
+}
+
+bool MetaSnapshot::Load(std::shared_ptr<MetaWriter> meta_writer, std::vector<MetaSnapshotSection>& sections) {
+  return Run(sections, [&](MetaSnapshotSection& section) { return LoadSection(meta_writer, section); });
+}
+
+}  // namespace dingodb
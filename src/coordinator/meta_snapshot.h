@@ -0,0 +1,64 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COORDINATOR_META_SNAPSHOT_H_  // NOLINT
+#define DINGODB_COORDINATOR_META_SNAPSHOT_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine/snapshot.h"
+#include "google/protobuf/repeated_field.h"
+#include "meta/meta_reader.h"
+#include "meta/meta_writer.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+using SnapshotKvs = google::protobuf::RepeatedPtrField<pb::common::KeyValue>;
+
+// One meta map in MetaSnapshotFile, kvs is the field of the map.
+struct MetaSnapshotSection {
+  std::string name;
+  std::string prefix;
+  SnapshotKvs* kvs{nullptr};
+  // recover memory map when loading, nullptr for disk only map
+  std::function<bool(const std::vector<pb::common::KeyValue>&)> recover;
+};
+
+// Save and load the meta maps of snapshot in parallel, every map is independent,
+// a worker only touches the field of its own map, so no lock is needed.
+class MetaSnapshot {
+ public:
+  // Scan the maps from snapshot into their fields.
+  static bool Save(std::shared_ptr<MetaReader> meta_reader, std::shared_ptr<Snapshot> snapshot,
+                   std::vector<MetaSnapshotSection>& sections);
+
+  // Recover the maps and rewrite them to rocksdb, the fields are moved out and left empty.
+  static bool Load(std::shared_ptr<MetaWriter> meta_writer, std::vector<MetaSnapshotSection>& sections);
+
+ private:
+  static bool SaveSection(std::shared_ptr<MetaReader> meta_reader, std::shared_ptr<Snapshot> snapshot,
+                          MetaSnapshotSection& section);
+  static bool LoadSection(std::shared_ptr<MetaWriter> meta_writer, MetaSnapshotSection& section);
+  static bool Run(std::vector<MetaSnapshotSection>& sections,
+                  const std::function<bool(MetaSnapshotSection&)>& section_func);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COORDINATOR_META_SNAPSHOT_H_  // NOLINT
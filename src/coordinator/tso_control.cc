@@ -14,10 +14,13 @@
 
 #include "coordinator/tso_control.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "brpc/closure_guard.h"
 #include "butil/status.h"
@@ -25,6 +28,7 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
+#include "gflags/gflags.h"
 #include "engine/snapshot.h"
 #include "proto/coordinator_internal.pb.h"
 #include "proto/error.pb.h"
@@ -32,6 +36,9 @@
 
 namespace dingodb {
 
+DEFINE_bool(tso_enable_batch, true, "merge concurrent gen tso requests into one allocation");
+DEFINE_int32(tso_batch_max_requests, 256, "max requests merged into one tso allocation");
+
 void TsoClosure::Run() {
   // DINGO_LOG(INFO) << "TsoClosure run";
   if (!status().ok()) {
@@ -149,7 +156,20 @@ void TsoControl::GenTso(const pb::meta::TsoRequest* request, pb::meta::TsoRespon
     return;
   }
   pb::meta::TsoTimestamp current;
-  bool need_retry = false;
+  bool ok = FLAGS_tso_enable_batch ? GenTsoBatch(count, current) : AllocateTso(count, current);
+  if (!ok) {
+    response->mutable_error()->set_errcode(pb::error::Errno::EEXEC_FAIL);
+    response->mutable_error()->set_errmsg("gen tso failed");
+    DINGO_LOG(ERROR) << "gen tso failed";
+    return;
+  }
+  DINGO_LOG(DEBUG) << "gen tso current: (" << current.physical() << ", " << current.logical() << ")";
+  auto* timestamp = response->mutable_start_timestamp();
+  *timestamp = current;
+  response->set_count(count);
+}
+
+bool TsoControl::AllocateTso(int64_t count, pb::meta::TsoTimestamp& start_timestamp) {
   for (size_t i = 0; i < 50; i++) {
     {
       BAIDU_SCOPED_LOCK(tso_mutex_);
@@ -157,34 +177,75 @@ void TsoControl::GenTso(const pb::meta::TsoRequest* request, pb::meta::TsoRespon
       if (physical != 0) {
         int64_t new_logical = tso_obj_.current_timestamp.logical() + count;
         if (new_logical < kMaxLogical) {
-          current = tso_obj_.current_timestamp;
+          start_timestamp = tso_obj_.current_timestamp;
           tso_obj_.current_timestamp.set_logical(new_logical);
-          need_retry = false;
+          return true;
         } else {
           DINGO_LOG(WARNING) << "logical part outside of max logical interval, retry later, please check ntp time";
-          need_retry = true;
         }
       } else {
         DINGO_LOG(WARNING) << "timestamp not ok physical == 0, retry later";
-        need_retry = true;
       }
     }
-    if (!need_retry) {
-      break;
+    bthread_usleep(kUpdateTimestampIntervalMs * 1000LL);
+  }
+
+  return false;
+}
+
+// The first waiter becomes the allocator, it takes all waiting requests and allocates the sum of their count
+// at once, then hands out the sub ranges. Requests arrived during allocation wait for next round.
+bool TsoControl::GenTsoBatch(int64_t count, pb::meta::TsoTimestamp& start_timestamp) {
+  TsoBatchWaiter waiter;
+  waiter.count = count;
+
+  std::unique_lock<bthread::Mutex> lock(batch_mutex_);
+  batch_waiters_.push_back(&waiter);
+  while (!waiter.done) {
+    if (batch_allocating_) {
+      batch_cond_.wait(lock);
+      continue;
+    }
+
+    batch_allocating_ = true;
+    std::vector<TsoBatchWaiter*> waiters;
+    size_t batch_size = std::min(batch_waiters_.size(), static_cast<size_t>(std::max(1, FLAGS_tso_batch_max_requests)));
+    waiters.assign(batch_waiters_.begin(), batch_waiters_.begin() + batch_size);
+    batch_waiters_.erase(batch_waiters_.begin(), batch_waiters_.begin() + batch_size);
+    lock.unlock();
+
+    int64_t total_count = 0;
+    for (auto* batch_waiter : waiters) {
+      total_count += batch_waiter->count;
+    }
+    if (total_count >= kMaxLogical) {
+      // more than one physical tick, allocate one by one.
+      for (auto* batch_waiter : waiters) {
+        batch_waiter->ok = AllocateTso(batch_waiter->count, batch_waiter->start_timestamp);
+      }
     } else {
-      bthread_usleep(kUpdateTimestampIntervalMs * 1000LL);
+      pb::meta::TsoTimestamp batch_start;
+      bool ok = AllocateTso(total_count, batch_start);
+      int64_t logical = batch_start.logical();
+      for (auto* batch_waiter : waiters) {
+        batch_waiter->ok = ok;
+        batch_waiter->start_timestamp.set_physical(batch_start.physical());
+        batch_waiter->start_timestamp.set_logical(logical);
+        logical += batch_waiter->count;
+      }
     }
+    DINGO_LOG(DEBUG) << "gen tso batch size: " << waiters.size() << ", count: " << total_count;
+
+    lock.lock();
+    for (auto* batch_waiter : waiters) {
+      batch_waiter->done = true;
+    }
+    batch_allocating_ = false;
+    batch_cond_.notify_all();
   }
-  if (need_retry) {
-    response->mutable_error()->set_errcode(pb::error::Errno::EEXEC_FAIL);
-    response->mutable_error()->set_errmsg("gen tso failed");
-    DINGO_LOG(ERROR) << "gen tso failed";
-    return;
-  }
-  DINGO_LOG(INFO) << "gen tso current: (" << current.physical() << ", " << current.logical() << ")";
-  auto* timestamp = response->mutable_start_timestamp();
-  *timestamp = current;
-  response->set_count(count);
+
+  start_timestamp = waiter.start_timestamp;
+  return waiter.ok;
 }
 
 // This method is called by the gRPC server.
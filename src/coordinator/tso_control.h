@@ -21,7 +21,10 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
 #include "common/meta_control.h"
 #include "engine/engine.h"
 #include "proto/coordinator_internal.pb.h"
@@ -165,6 +168,10 @@ class TsoControl : public MetaControl {
                pb::meta::TsoResponse *response, google::protobuf::Closure *done);
 
   void GenTso(const pb::meta::TsoRequest *request, pb::meta::TsoResponse *response);
+  // Concurrent requests are merged into one allocation, one request allocate for all waiting requests.
+  bool GenTsoBatch(int64_t count, pb::meta::TsoTimestamp &start_timestamp);
+  // Allocate count logical timestamps, retry when logical is used up.
+  bool AllocateTso(int64_t count, pb::meta::TsoTimestamp &start_timestamp);
   void ResetTso(const pb::meta::TsoRequest &request, pb::meta::TsoResponse *response);
   void UpdateTso(const pb::meta::TsoRequest &request, pb::meta::TsoResponse *response);
 
@@ -178,6 +185,18 @@ class TsoControl : public MetaControl {
   bthread_mutex_t tso_mutex_;  // for tso_obj_
   bool is_healty_ = true;
 
+  // for batch gen tso
+  struct TsoBatchWaiter {
+    int64_t count{0};
+    pb::meta::TsoTimestamp start_timestamp;
+    bool ok{false};
+    bool done{false};
+  };
+  bthread::Mutex batch_mutex_;
+  bthread::ConditionVariable batch_cond_;
+  bool batch_allocating_{false};
+  std::vector<TsoBatchWaiter *> batch_waiters_;
+
   // node is leader or not
   butil::atomic<int64_t> leader_term_;
 
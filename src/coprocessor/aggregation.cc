@@ -18,6 +18,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <typeinfo>
 
 #include "common/logging.h"
 #include "fmt/core.h"
@@ -103,6 +104,19 @@ butil::Status Aggregation::Open(
   return butil::Status();
 }
 
+void Aggregation::Open(const std::vector<std::any>& init_result_record) {
+  result_record_ = std::make_shared<std::vector<std::any>>(init_result_record);
+  // string results must not be shared between groups
+  for (auto& result : *result_record_) {
+    if (result.type() == typeid(std::optional<std::shared_ptr<std::string>>)) {
+      auto& value = std::any_cast<std::optional<std::shared_ptr<std::string>>&>(result);
+      if (value.has_value() && value.value() != nullptr) {
+        value = std::make_shared<std::string>(*value.value());
+      }
+    }
+  }
+}
+
 butil::Status Aggregation::Execute(
     const std::vector<std::function<bool(const std::any&, std::any*)>>& aggregation_functions,
     const std::vector<std::any>& group_by_operator_record) {
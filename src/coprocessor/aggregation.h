@@ -42,6 +42,9 @@ class Aggregation {
       const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>& result_serial_schemas,
       const ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator>& aggregation_operators);
 
+  // Copy the initial result record built by above Open, avoid building it for every group.
+  void Open(const std::vector<std::any>& init_result_record);
+
   butil::Status Execute(const std::vector<std::function<bool(const std::any&, std::any*)>>& aggregation_functions,
                         const std::vector<std::any>& group_by_operator_record);
 
@@ -0,0 +1,102 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "coprocessor/aggregation_group_table.h"
+
+#include <cstring>
+#include <functional>
+#include <string_view>
+
+namespace dingodb {
+
+AggregationGroupTable::AggregationGroupTable() { slots_.resize(kInitCapacity, Slot{0, kEmptySlot}); }
+
+size_t AggregationGroupTable::FindOrInsert(std::string_view key, bool& is_new) {
+  uint64_t hash = std::hash<std::string_view>()(key);
+  size_t mask = slots_.size() - 1;
+  size_t pos = hash & mask;
+  while (slots_[pos].group_index != kEmptySlot) {
+    const auto& slot = slots_[pos];
+    if (slot.hash == hash && groups_[slot.group_index].key == key) {
+      is_new = false;
+      return slot.group_index;
+    }
+    pos = (pos + 1) & mask;
+  }
+
+  is_new = true;
+  size_t group_index = groups_.size();
+  groups_.push_back(Group{CopyToArena(key), nullptr});
+  slots_[pos] = Slot{hash, static_cast<uint32_t>(group_index)};
+
+  if (groups_.size() * 2 > slots_.size()) {
+    Rehash(slots_.size() * 2);
+  }
+
+  return group_index;
+}
+
+void AggregationGroupTable::Rehash(size_t capacity) {
+  std::vector<Slot> slots(capacity, Slot{0, kEmptySlot});
+  size_t mask = capacity - 1;
+  for (const auto& slot : slots_) {
+    if (slot.group_index == kEmptySlot) {
+      continue;
+    }
+    size_t pos = slot.hash & mask;
+    while (slots[pos].group_index != kEmptySlot) {
+      pos = (pos + 1) & mask;
+    }
+    slots[pos] = slot;
+  }
+  slots_.swap(slots);
+}
+
+std::string_view AggregationGroupTable::CopyToArena(std::string_view key) {
+  if (key.empty()) {
+    return std::string_view();
+  }
+
+  char* data = nullptr;
+  if (key.size() > kArenaBlockSize / 4) {
+    // big key own a block, not waste the rest of current block
+    arena_blocks_.emplace_back(std::make_unique<char[]>(key.size()));
+    data = arena_blocks_.back().get();
+    arena_bytes_ += key.size();
+    if (arena_blocks_.size() > 1) {
+      // keep current block last for small keys
+      std::swap(arena_blocks_.back(), arena_blocks_[arena_blocks_.size() - 2]);
+    } else {
+      arena_block_used_ = kArenaBlockSize;
+    }
+  } else {
+    if (arena_block_used_ + key.size() > kArenaBlockSize) {
+      arena_blocks_.emplace_back(std::make_unique<char[]>(kArenaBlockSize));
+      arena_block_used_ = 0;
+      arena_bytes_ += kArenaBlockSize;
+    }
+    data = arena_blocks_.back().get() + arena_block_used_;
+    arena_block_used_ += key.size();
+  }
+
+  memcpy(data, key.data(), key.size());
+  return std::string_view(data, key.size());
+}
+
+int64_t AggregationGroupTable::MemoryBytes() const {
+  return static_cast<int64_t>(slots_.capacity() * sizeof(Slot) + groups_.capacity() * sizeof(Group)) + arena_bytes_;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,82 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COPROCESSOR_AGGREGATION_GROUP_TABLE_H_  // NOLINT
+#define DINGODB_COPROCESSOR_AGGREGATION_GROUP_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "coprocessor/aggregation.h"
+
+namespace dingodb {
+
+// Open addressing hash table (linear probing) of aggregation groups.
+// Group keys are serialized group by columns, copied into an arena of big blocks instead of a string per group.
+// Groups are kept in insertion order, iterating them does not depend on hashing.
+class AggregationGroupTable {
+ public:
+  struct Group {
+    // point into the arena, valid as long as the table
+    std::string_view key;
+    std::unique_ptr<Aggregation> aggregation;
+  };
+
+  AggregationGroupTable();
+  ~AggregationGroupTable() = default;
+
+  AggregationGroupTable(const AggregationGroupTable& rhs) = delete;
+  AggregationGroupTable& operator=(const AggregationGroupTable& rhs) = delete;
+  AggregationGroupTable(AggregationGroupTable&& rhs) = delete;
+  AggregationGroupTable& operator=(AggregationGroupTable&& rhs) = delete;
+
+  // Return the group index of key, a new group without aggregation is inserted if not exist.
+  size_t FindOrInsert(std::string_view key, bool& is_new);
+
+  Group& GetGroup(size_t index) { return groups_[index]; }
+  const Group& GetGroup(size_t index) const { return groups_[index]; }
+  size_t Size() const { return groups_.size(); }
+
+  // memory of slots, groups and arena, not include the aggregation results.
+  int64_t MemoryBytes() const;
+
+ private:
+  static constexpr uint32_t kEmptySlot = UINT32_MAX;
+  static constexpr size_t kInitCapacity = 64;
+  static constexpr size_t kArenaBlockSize = 64 * 1024;
+
+  struct Slot {
+    uint64_t hash;
+    uint32_t group_index;
+  };
+
+  void Rehash(size_t capacity);
+  std::string_view CopyToArena(std::string_view key);
+
+  // capacity is power of 2, load factor is at most 0.5
+  std::vector<Slot> slots_;
+  std::vector<Group> groups_;
+
+  std::vector<std::unique_ptr<char[]>> arena_blocks_;
+  size_t arena_block_used_{kArenaBlockSize};
+  int64_t arena_bytes_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COPROCESSOR_AGGREGATION_GROUP_TABLE_H_  // NOLINT
@@ -24,10 +24,15 @@
 
 #include "common/logging.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
 #include "proto/store.pb.h"
 
 namespace dingodb {
 
+DEFINE_int64(coprocessor_aggregation_max_memory_size, 0,
+             "max estimated memory bytes of aggregation groups in a coprocessor, 0 means unlimited");
+
 template <typename PARAM, typename RESULT>
 struct SUM {
   bool operator()(const std::any& param, std::any* result) {
@@ -314,35 +319,52 @@ butil::Status AggregationManager::Open(
     i++;
   }
 
+  // build the initial result of a group once, every new group copies it.
+  Aggregation init_aggregation;
+  status = init_aggregation.Open(result_serial_schemas_->size() - group_by_operator_serial_schemas_->size(),
+                                 result_serial_schemas_, aggregation_operators_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("Aggregation::Open failed");
+    return status;
+  }
+  init_result_record_ = *init_aggregation.GetResult();
+  group_memory_bytes_ = static_cast<int64_t>(sizeof(Aggregation) + sizeof(std::vector<std::any>) +
+                                             init_result_record_.size() * sizeof(std::any) * 2);
+
+  aggregations_ = std::make_shared<AggregationGroupTable>();
+
   return butil::Status();
 }
 
 butil::Status AggregationManager::Execute(const std::string& group_by_key,
                                           const std::vector<std::any>& group_by_operator_record) {
   butil::Status status;
-  std::shared_ptr<Aggregation> aggregation;
 
   if (!aggregations_) {
-    using MapType = std::map<std::string, std::shared_ptr<Aggregation>>;
-    aggregations_ = std::make_shared<MapType>();
+    aggregations_ = std::make_shared<AggregationGroupTable>();
   }
 
-  const auto& iter = aggregations_->find(group_by_key);
-  if (iter == aggregations_->end()) {
-    const auto& [iter_new, _] = aggregations_->emplace(group_by_key, std::make_shared<Aggregation>());
-    aggregation = iter_new->second;
-
-    status = aggregation->Open(result_serial_schemas_->size() - group_by_operator_serial_schemas_->size(),
-                               result_serial_schemas_, aggregation_operators_);
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("Aggregation::Open failed");
-      return status;
+  bool is_new = false;
+  size_t index = aggregations_->FindOrInsert(group_by_key, is_new);
+  auto& group = aggregations_->GetGroup(index);
+  if (is_new) {
+    group.aggregation = std::make_unique<Aggregation>();
+    group.aggregation->Open(init_result_record_);
+
+    if (FLAGS_coprocessor_aggregation_max_memory_size > 0) {
+      int64_t memory_bytes =
+          aggregations_->MemoryBytes() + static_cast<int64_t>(aggregations_->Size()) * group_memory_bytes_;
+      if (memory_bytes > FLAGS_coprocessor_aggregation_max_memory_size) {
+        std::string error_message =
+            fmt::format("aggregation groups : {} memory bytes : {} exceed limit : {}", aggregations_->Size(),
+                        memory_bytes, FLAGS_coprocessor_aggregation_max_memory_size);
+        DINGO_LOG(ERROR) << error_message;
+        return butil::Status(pb::error::EREQUEST_FULL, error_message);
+      }
     }
-  } else {
-    aggregation = iter->second;
   }
 
-  status = aggregation->Execute(aggregation_functions_, group_by_operator_record);
+  status = group.aggregation->Execute(aggregation_functions_, group_by_operator_record);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << fmt::format("Aggregation::Execute failed");
     return status;
@@ -364,6 +386,8 @@ void AggregationManager::Close() {
 
   aggregation_functions_.clear();
 
+  init_result_record_.clear();
+
   if (aggregations_) {
     aggregations_.reset();
   }
@@ -371,10 +395,9 @@ void AggregationManager::Close() {
 
 std::shared_ptr<AggregationIterator> AggregationManager::CreateIterator() {
   if (!aggregations_) {
-    using MapType = std::map<std::string, std::shared_ptr<Aggregation>>;
-    aggregations_ = std::make_shared<MapType>();
+    aggregations_ = std::make_shared<AggregationGroupTable>();
   }
-  DINGO_LOG(DEBUG) << "aggregations  size : " << aggregations_->size();
+  DINGO_LOG(DEBUG) << "aggregations  size : " << aggregations_->Size();
   return std::make_shared<AggregationIterator>(aggregations_);
 }
 
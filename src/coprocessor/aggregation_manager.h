@@ -22,31 +22,34 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "butil/status.h"
 #include "coprocessor/aggregation.h"
+#include "coprocessor/aggregation_group_table.h"
 #include "proto/store.pb.h"
 
 namespace dingodb {
 
+// Iterate groups in insertion order.
 class AggregationIterator {
  public:
-  explicit AggregationIterator(const std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>>& aggregations)
-      : aggregations_(aggregations) {
-    iter_ = aggregations_->begin();
-  }
+  explicit AggregationIterator(const std::shared_ptr<AggregationGroupTable>& aggregations)
+      : aggregations_(aggregations) {}
 
   ~AggregationIterator() { aggregations_.reset(); }
 
-  bool HasNext() { return (iter_ != aggregations_->end()); }
-  void Next() { ++iter_; }
-  const std::string& GetKey() const { return iter_->first; }
-  const std::shared_ptr<std::vector<std::any>>& GetValue() const { return iter_->second->GetResult(); }
+  bool HasNext() { return (index_ < aggregations_->Size()); }
+  void Next() { ++index_; }
+  std::string_view GetKey() const { return aggregations_->GetGroup(index_).key; }
+  const std::shared_ptr<std::vector<std::any>>& GetValue() const {
+    return aggregations_->GetGroup(index_).aggregation->GetResult();
+  }
 
  private:
-  std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>> aggregations_;
-  std::map<std::string, std::shared_ptr<Aggregation>>::iterator iter_;
+  std::shared_ptr<AggregationGroupTable> aggregations_;
+  size_t index_{0};
 };
 
 class AggregationManager {
@@ -80,7 +83,11 @@ class AggregationManager {
   ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator> aggregation_operators_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas_;
   std::vector<std::function<bool(const std::any&, std::any*)>> aggregation_functions_;
-  std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>> aggregations_;
+  std::shared_ptr<AggregationGroupTable> aggregations_;
+  // initial result record of every group
+  std::vector<std::any> init_result_record_;
+  // estimated memory of a group besides the key
+  int64_t group_memory_bytes_{0};
 };
 
 }  // namespace dingodb
@@ -518,7 +518,7 @@ butil::Status Coprocessor::GetKeyValueFromAggregation(bool key_only, size_t max_
 
     while (aggregation_iterator_->HasNext()) {
       Utils::DebugGroupByKey("", "Key Value pair");
-      const std::string& key = aggregation_iterator_->GetKey();
+      std::string key(aggregation_iterator_->GetKey());
       const std::shared_ptr<std::vector<std::any>>& value = aggregation_iterator_->GetValue();
 
       std::vector<std::any> result_key_record;
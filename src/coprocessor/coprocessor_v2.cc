@@ -26,19 +26,35 @@
 #include <vector>
 
 #include "common/logging.h"
+#include "common/threadpool.h"
+#include "coprocessor/coprocessor_v2_plan_cache.h"
 #include "coprocessor/utils.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/error.pb.h"
 #include "proto/store.pb.h"
 #include "scan/scan_filter.h"
 #include "serial/record_decoder.h"
 #include "serial/record_encoder.h"
+#include "serial/record_view_decoder.h"
 
 namespace dingodb {
 
 DECLARE_int64(max_scan_memory_size);
 DECLARE_int64(max_scan_line_limit);
 
+DEFINE_int32(coprocessor_v2_batch_size, 0, "decode and evaluate n rows at a time in coprocessor v2, 0 is row by row");
+DEFINE_int32(coprocessor_v2_decode_thread_num, 0,
+             "decode a batch of coprocessor v2 in parallel by n threads shared by all coprocessors, 0 or 1 is disable");
+DEFINE_int32(coprocessor_v2_decode_min_rows_per_thread, 256, "min rows of a batch decoded by one thread");
+
+// Created on first use, thread num is fixed by the flag value at that time.
+static ThreadPoolPtr GetDecodeThreadPool() {
+  static ThreadPoolPtr thread_pool =
+      std::make_shared<ThreadPool>("coprocessor_decode", FLAGS_coprocessor_v2_decode_thread_num);
+  return thread_pool;
+}
+
 bvar::Adder<uint64_t> CoprocessorV2::bvar_coprocessor_v2_object_running_num("dingo_coprocessor_v2_object_running_num");
 bvar::Adder<uint64_t> CoprocessorV2::bvar_coprocessor_v2_object_total_num("dingo_coprocessor_v2_object_total_num");
 bvar::LatencyRecorder CoprocessorV2::coprocessor_v2_latency("dingo_coprocessor_v2_latency");
@@ -138,6 +154,62 @@ butil::Status CoprocessorV2::Open(const std::any& coprocessor) {
 
   Utils::DebugCoprocessorV2(coprocessor_);
 
+  std::string plan_key;
+  std::shared_ptr<CoprocessorV2Plan> plan;
+  if (CoprocessorV2PlanCache::GetInstance().IsEnabled()) {
+    plan_key = coprocessor_.SerializeAsString();
+    plan = CoprocessorV2PlanCache::GetInstance().Get(plan_key);
+  }
+
+  if (plan != nullptr) {
+    LoadPlan(*plan);
+  } else {
+    status = BuildPlan();
+    if (!status.ok()) {
+      return status;
+    }
+    if (!plan_key.empty()) {
+      CoprocessorV2PlanCache::GetInstance().Put(plan_key, SavePlan());
+    }
+  }
+
+#if defined(TEST_COPROCESSOR_V2_MOCK)
+  rel_runner_ = std::make_shared<rel::mock::RelRunner>();
+#else
+  rel_runner_ = std::make_shared<rel::RelRunner>();
+#endif
+
+  try {
+    rel_runner_->Decode(reinterpret_cast<const expr::Byte*>(coprocessor_.rel_expr().c_str()),
+                        coprocessor_.rel_expr().length());
+  } catch (const std::exception& my_exception) {
+    std::string error_message = fmt::format("rel::RelRunner Decode failed. exception : {}", my_exception.what());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  if (coprocessor_.top_n().limit() > 0) {
+    if (coprocessor_.top_n().limit() > FLAGS_max_scan_line_limit) {
+      std::string error_message = fmt::format("top n limit {} exceed max_scan_line_limit {}",
+                                              coprocessor_.top_n().limit(), FLAGS_max_scan_line_limit);
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+
+    top_n_ = std::make_shared<TopNHeap>(coprocessor_.top_n(), result_serial_schemas_);
+    status = top_n_->Init();
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+  }
+
+  return status;
+}
+
+butil::Status CoprocessorV2::BuildPlan() {
+  butil::Status status;
+
   status = Utils::CheckPbSchema(coprocessor_.original_schema().schema());
   if (!status.ok()) {
     std::string error_message = fmt::format("original_schema check failed");
@@ -199,25 +271,40 @@ butil::Status CoprocessorV2::Open(const std::any& coprocessor) {
   original_record_decoder_ = std::make_shared<RecordDecoder>(coprocessor_.schema_version(), original_serial_schemas_,
                                                              coprocessor_.original_schema().common_id());
 
+  original_record_view_decoder_ = std::make_shared<RecordViewDecoder>(
+      coprocessor_.schema_version(), original_serial_schemas_, coprocessor_.original_schema().common_id());
+  if (!original_record_view_decoder_->Compile(selection_column_indexes_)) {
+    DINGO_LOG(DEBUG) << fmt::format("RecordViewDecoder not support selection columns, use RecordDecoder");
+  }
+
   result_record_encoder_ = std::make_shared<RecordEncoder>(coprocessor_.schema_version(), result_serial_schemas_,
                                                            coprocessor_.result_schema().common_id());
 
-#if defined(TEST_COPROCESSOR_V2_MOCK)
-  rel_runner_ = std::make_shared<rel::mock::RelRunner>();
-#else
-  rel_runner_ = std::make_shared<rel::RelRunner>();
-#endif
+  return status;
+}
 
-  try {
-    rel_runner_->Decode(reinterpret_cast<const expr::Byte*>(coprocessor_.rel_expr().c_str()),
-                        coprocessor_.rel_expr().length());
-  } catch (const std::exception& my_exception) {
-    std::string error_message = fmt::format("rel::RelRunner Decode failed. exception : {}", my_exception.what());
-    DINGO_LOG(ERROR) << error_message;
-    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
-  }
+void CoprocessorV2::LoadPlan(const CoprocessorV2Plan& plan) {
+  original_serial_schemas_ = plan.original_serial_schemas;
+  original_column_indexes_ = plan.original_column_indexes;
+  selection_column_indexes_ = plan.selection_column_indexes;
+  result_serial_schemas_ = plan.result_serial_schemas;
+  result_column_indexes_ = plan.result_column_indexes;
+  original_record_decoder_ = plan.original_record_decoder;
+  original_record_view_decoder_ = plan.original_record_view_decoder;
+  result_record_encoder_ = plan.result_record_encoder;
+}
 
-  return status;
+std::shared_ptr<CoprocessorV2Plan> CoprocessorV2::SavePlan() {
+  auto plan = std::make_shared<CoprocessorV2Plan>();
+  plan->original_serial_schemas = original_serial_schemas_;
+  plan->original_column_indexes = original_column_indexes_;
+  plan->selection_column_indexes = selection_column_indexes_;
+  plan->result_serial_schemas = result_serial_schemas_;
+  plan->result_column_indexes = result_column_indexes_;
+  plan->original_record_decoder = original_record_decoder_;
+  plan->original_record_view_decoder = original_record_view_decoder_;
+  plan->result_record_encoder = result_record_encoder_;
+  return plan;
 }
 
 butil::Status CoprocessorV2::Execute(IteratorPtr iter, bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
@@ -234,9 +321,16 @@ butil::Status CoprocessorV2::Execute(IteratorPtr iter, bool key_only, size_t max
   CoprocessorV2::bvar_coprocessor_v2_execute_total_num << 1;
   ON_SCOPE_EXIT([&]() { CoprocessorV2::bvar_coprocessor_v2_execute_running_num << -1; });
   DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::Execute IteratorPtr Enter");
-  ScanFilter scan_filter = ScanFilter(false, max_fetch_cnt, max_bytes_rpc);
+  // top n need evaluate the whole range, the output is bounded by top n limit.
+  ScanFilter scan_filter = top_n_ != nullptr
+                               ? ScanFilter(false, std::numeric_limits<size_t>::max(),
+                                            std::numeric_limits<int64_t>::max())
+                               : ScanFilter(false, max_fetch_cnt, max_bytes_rpc);
   butil::Status status;
   has_more = false;
+  size_t batch_size = FLAGS_coprocessor_v2_batch_size > 0 ? FLAGS_coprocessor_v2_batch_size : 0;
+  std::vector<pb::common::KeyValue> batch_kvs;
+  batch_kvs.reserve(batch_size);
   while (iter->Valid()) {
     pb::common::KeyValue kv;
 #if defined(ENABLE_COPROCESSOR_V2_STATISTICS_TIME_CONSUMPTION)
@@ -252,24 +346,37 @@ butil::Status CoprocessorV2::Execute(IteratorPtr iter, bool key_only, size_t max
 #if defined(ENABLE_COPROCESSOR_V2_STATISTICS_TIME_CONSUMPTION)
     }
 #endif
-    bool has_result_kv = false;
-    pb::common::KeyValue result_key_value;
-    DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::DoExecute Call");
-    status = DoExecute(kv.key(), kv.value(), &has_result_kv, &result_key_value);
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute failed");
-      return status;
-    }
-
-    if (has_result_kv) {
-      if (key_only) {
-        result_key_value.set_value("");
+    bool upto_limit = scan_filter.UptoLimit(kv);
+    if (batch_size > 0) {
+      batch_kvs.emplace_back(std::move(kv));
+      if (upto_limit || batch_kvs.size() >= batch_size) {
+        status = DoExecuteBatch(batch_kvs, key_only, kvs);
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute batch failed");
+          return status;
+        }
+        batch_kvs.clear();
+      }
+    } else {
+      bool has_result_kv = false;
+      pb::common::KeyValue result_key_value;
+      DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::DoExecute Call");
+      status = DoExecute(kv.key(), kv.value(), &has_result_kv, &result_key_value);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute failed");
+        return status;
       }
 
-      kvs->emplace_back(std::move(result_key_value));
+      if (has_result_kv) {
+        if (key_only) {
+          result_key_value.set_value("");
+        }
+
+        kvs->emplace_back(std::move(result_key_value));
+      }
     }
 
-    if (scan_filter.UptoLimit(kv)) {
+    if (upto_limit) {
       has_more = true;
       DINGO_LOG(WARNING) << fmt::format(
           "CoprocessorV2 UptoLimit. key_only : {} max_fetch_cnt : {} max_bytes_rpc : {} cur_fetch_cnt : {} "
@@ -303,7 +410,18 @@ butil::Status CoprocessorV2::Execute(IteratorPtr iter, bool key_only, size_t max
 #endif
   }
 
+  if (!batch_kvs.empty()) {
+    status = DoExecuteBatch(batch_kvs, key_only, kvs);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute batch failed");
+      return status;
+    }
+  }
+
   status = GetKvFromExprEndOfFinish(key_only, max_fetch_cnt, max_bytes_rpc, kvs);
+  if (status.ok() && top_n_ != nullptr) {
+    status = GetKvFromTopN(key_only, kvs);
+  }
 
   DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::Execute IteratorPtr Leave");
 
@@ -328,8 +446,13 @@ butil::Status CoprocessorV2::Execute(TxnIteratorPtr iter, int64_t limit, bool ke
 
   butil::Status status;
 
-  ScanFilter scan_filter =
-      ScanFilter(false, std::min(limit, FLAGS_max_scan_line_limit), std::numeric_limits<int64_t>::max());
+  // top n need evaluate the whole range, the output is bounded by top n limit.
+  int64_t scan_limit =
+      top_n_ != nullptr ? std::numeric_limits<int64_t>::max() : std::min(limit, FLAGS_max_scan_line_limit);
+  ScanFilter scan_filter = ScanFilter(false, scan_limit, std::numeric_limits<int64_t>::max());
+  size_t batch_size = FLAGS_coprocessor_v2_batch_size > 0 ? FLAGS_coprocessor_v2_batch_size : 0;
+  std::vector<pb::common::KeyValue> batch_kvs;
+  batch_kvs.reserve(batch_size);
 
   while (iter->Valid(txn_result_info)) {
     pb::common::KeyValue kv;
@@ -346,26 +469,39 @@ butil::Status CoprocessorV2::Execute(TxnIteratorPtr iter, int64_t limit, bool ke
 #if defined(ENABLE_COPROCESSOR_V2_STATISTICS_TIME_CONSUMPTION)
     }
 #endif
-    bool has_result_kv = false;
-    pb::common::KeyValue result_key_value;
-    DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::DoExecute Call");
-    status = DoExecute(kv.key(), kv.value(), &has_result_kv, &result_key_value);
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute failed");
-      return status;
-    }
+    bool upto_limit = scan_filter.UptoLimit(kv);
+    if (batch_size > 0) {
+      batch_kvs.emplace_back(std::move(kv));
+      if (upto_limit || batch_kvs.size() >= batch_size) {
+        status = DoExecuteBatch(batch_kvs, key_only, &kvs);
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute batch failed");
+          return status;
+        }
+        batch_kvs.clear();
+      }
+    } else {
+      bool has_result_kv = false;
+      pb::common::KeyValue result_key_value;
+      DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::DoExecute Call");
+      status = DoExecute(kv.key(), kv.value(), &has_result_kv, &result_key_value);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute failed");
+        return status;
+      }
 
-    end_key = iter->Key();
+      if (has_result_kv) {
+        if (key_only) {
+          result_key_value.set_value("");
+        }
 
-    if (has_result_kv) {
-      if (key_only) {
-        result_key_value.set_value("");
+        kvs.emplace_back(std::move(result_key_value));
       }
-
-      kvs.emplace_back(std::move(result_key_value));
     }
 
-    if (scan_filter.UptoLimit(kv)) {
+    end_key = iter->Key();
+
+    if (upto_limit) {
       has_more = true;
       DINGO_LOG(WARNING) << fmt::format(
           "CoprocessorV2 UptoLimit. key_only : {} max_fetch_cnt : {} max_bytes_rpc : {} cur_fetch_cnt : {} "
@@ -400,7 +536,18 @@ butil::Status CoprocessorV2::Execute(TxnIteratorPtr iter, int64_t limit, bool ke
 #endif
   }
 
+  if (!batch_kvs.empty()) {
+    status = DoExecuteBatch(batch_kvs, key_only, &kvs);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute batch failed");
+      return status;
+    }
+  }
+
   status = GetKvFromExprEndOfFinish(key_only, limit, FLAGS_max_scan_memory_size, &kvs);
+  if (status.ok() && top_n_ != nullptr) {
+    status = GetKvFromTopN(key_only, &kvs);
+  }
 
   DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::Execute TxnIteratorPtr Leave");
 
@@ -430,7 +577,10 @@ void CoprocessorV2::Close() {
   result_serial_schemas_.reset();
   result_record_encoder_.reset();
   original_record_decoder_.reset();
+  original_record_view_decoder_.reset();
   result_column_indexes_.clear();
+  batch_records_.clear();
+  top_n_.reset();
   rel_runner_.reset();
 }
 
@@ -491,6 +641,131 @@ butil::Status CoprocessorV2::DoExecute(const std::string& key, const std::string
   return status;
 }
 
+butil::Status CoprocessorV2::DecodeBatchRange(const std::vector<pb::common::KeyValue>& batch_kvs, size_t begin,
+                                              size_t end, RecordViewDecoder::Row& view_row) {
+  int ret = 0;
+  try {
+    // decode some column. not decode all
+    if (original_record_view_decoder_ != nullptr && original_record_view_decoder_->IsCompiled()) {
+      for (size_t i = begin; i < end && ret >= 0; ++i) {
+        ret = original_record_view_decoder_->Decode(batch_kvs[i].key(), batch_kvs[i].value(), view_row);
+        RecordViewDecoder::ToRecord(view_row, batch_records_[i]);
+      }
+    } else {
+      ret = original_record_decoder_->DecodeBatch(batch_kvs, begin, end, selection_column_indexes_, batch_records_);
+    }
+  } catch (const std::exception& my_exception) {
+    std::string error_message = fmt::format("serial::DecodeBatch failed exception : {}", my_exception.what());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  if (ret < 0) {
+    std::string error_message = fmt::format("serial::DecodeBatch failed");
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  return butil::Status();
+}
+
+butil::Status CoprocessorV2::DecodeBatch(const std::vector<pb::common::KeyValue>& batch_kvs) {
+  batch_records_.resize(batch_kvs.size());
+
+  auto thread_pool = FLAGS_coprocessor_v2_decode_thread_num > 1 ? GetDecodeThreadPool() : nullptr;
+  size_t min_rows = std::max(1, FLAGS_coprocessor_v2_decode_min_rows_per_thread);
+  size_t part_num = thread_pool == nullptr
+                        ? 1
+                        : std::min(static_cast<size_t>(FLAGS_coprocessor_v2_decode_thread_num),
+                                   std::max(static_cast<size_t>(1), batch_kvs.size() / min_rows));
+  if (part_num <= 1) {
+    return DecodeBatchRange(batch_kvs, 0, batch_kvs.size(), view_row_);
+  }
+
+  // Every part decode a continuous range of the batch, so records keep the order of batch_kvs.
+  // The first part is decoded by current thread.
+  size_t part_rows = (batch_kvs.size() + part_num - 1) / part_num;
+  std::vector<butil::Status> statuses(part_num);
+  std::vector<RecordViewDecoder::Row> view_rows(part_num);
+  std::vector<ThreadPool::TaskPtr> tasks;
+  for (size_t i = 1; i < part_num; ++i) {
+    auto decode_func = [&, i](void*) {
+      size_t begin = i * part_rows;
+      size_t end = std::min(batch_kvs.size(), begin + part_rows);
+      statuses[i] = DecodeBatchRange(batch_kvs, begin, end, view_rows[i]);
+    };
+    auto task = thread_pool->ExecuteTask(decode_func, nullptr);
+    if (task == nullptr) {
+      decode_func(nullptr);
+    } else {
+      tasks.push_back(task);
+    }
+  }
+  statuses[0] = DecodeBatchRange(batch_kvs, 0, std::min(batch_kvs.size(), part_rows), view_row_);
+
+  for (auto& task : tasks) {
+    task->Join();
+  }
+
+  for (const auto& status : statuses) {
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  return butil::Status();
+}
+
+butil::Status CoprocessorV2::DoExecuteBatch(const std::vector<pb::common::KeyValue>& batch_kvs, bool key_only,
+                                            std::vector<pb::common::KeyValue>* kvs) {
+  butil::Status status;
+
+  status = DecodeBatch(batch_kvs);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (const auto& original_record : batch_records_) {
+    std::unique_ptr<std::vector<expr::Operand>> result_operand_ptr;
+    status = DoRelExprCore(original_record, result_operand_ptr);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+
+    if (!result_operand_ptr) {
+      continue;
+    }
+
+    std::vector<std::any> result_record;
+    result_record.reserve(result_serial_schemas_->size());
+    status = RelExprHelper::TransFromOperandWrapper(result_operand_ptr, result_serial_schemas_, result_column_indexes_,
+                                                    result_record);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+
+    bool has_result_kv = false;
+    pb::common::KeyValue result_kv;
+    status = GetKvFromExpr(result_record, &has_result_kv, &result_kv);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+
+    if (has_result_kv) {
+      if (key_only) {
+        result_kv.set_value("");
+      }
+
+      kvs->emplace_back(std::move(result_kv));
+    }
+  }
+
+  return status;
+}
+
 butil::Status CoprocessorV2::DoFilter(const std::string& key, const std::string& value, bool* is_reserved) {
   butil::Status status;
 
@@ -697,6 +972,19 @@ butil::Status CoprocessorV2::GetKvFromExpr(const std::vector<std::any>& record,
   Utils::DebugPrintAnyArray(record, "From Expr");
 #endif
 
+  if (top_n_ != nullptr) {
+    top_n_->Add(record);
+    *has_result_kv = false;
+    return status;
+  }
+
+  return EncodeResultRecord(record, has_result_kv, result_kv);
+}
+
+butil::Status CoprocessorV2::EncodeResultRecord(const std::vector<std::any>& record, bool* has_result_kv,
+                                                pb::common::KeyValue* result_kv) {
+  butil::Status status;
+
   pb::common::KeyValue result_key_value;
   int ret = 0;
   try {
@@ -718,6 +1006,31 @@ butil::Status CoprocessorV2::GetKvFromExpr(const std::vector<std::any>& record,
   return butil::Status();
 }
 
+butil::Status CoprocessorV2::GetKvFromTopN(bool key_only, std::vector<pb::common::KeyValue>* kvs) {
+  butil::Status status;
+
+  auto rows = top_n_->Finish();
+  for (const auto& row : rows) {
+    bool has_result_kv = false;
+    pb::common::KeyValue result_kv;
+    status = EncodeResultRecord(row, &has_result_kv, &result_kv);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+
+    if (has_result_kv) {
+      if (key_only) {
+        result_kv.set_value("");
+      }
+
+      kvs->emplace_back(std::move(result_kv));
+    }
+  }
+
+  return status;
+}
+
 void CoprocessorV2::GetOriginalColumnIndexes() {
   original_column_indexes_.resize(original_serial_schemas_->size(), -1);
   int i = 0;
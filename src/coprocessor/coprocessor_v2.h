@@ -23,13 +23,16 @@
 #include <vector>
 
 #include "butil/status.h"
+#include "coprocessor/coprocessor_v2_plan_cache.h"
 #include "coprocessor/raw_coprocessor.h"
 #include "coprocessor/rel_expr_helper.h"  // IWYU pragma: keep
+#include "coprocessor/top_n.h"
 #include "engine/iterator.h"
 #include "libexpr/src/rel/rel_runner.h"  // IWYU pragma: keep
 #include "proto/common.pb.h"
 #include "serial/record_decoder.h"
 #include "serial/record_encoder.h"
+#include "serial/record_view_decoder.h"
 
 namespace dingodb {
 
@@ -66,8 +69,20 @@ class CoprocessorV2 : public RawCoprocessor {
   void Close() override;
 
  protected:
+  // Build schemas, column indexes, decoders and encoder from coprocessor_.
+  butil::Status BuildPlan();
+  void LoadPlan(const CoprocessorV2Plan& plan);
+  std::shared_ptr<CoprocessorV2Plan> SavePlan();
+
   butil::Status DoExecute(const std::string& key, const std::string& value, bool* has_result_kv,
                           pb::common::KeyValue* result_kv);
+  // Decode the whole batch first, then evaluate the decoded rows, amortize the per row overhead of DoExecute.
+  butil::Status DoExecuteBatch(const std::vector<pb::common::KeyValue>& batch_kvs, bool key_only,
+                               std::vector<pb::common::KeyValue>* kvs);
+  // Decode batch_kvs into batch_records_, in parallel by the decode thread pool if the batch is big enough.
+  butil::Status DecodeBatch(const std::vector<pb::common::KeyValue>& batch_kvs);
+  butil::Status DecodeBatchRange(const std::vector<pb::common::KeyValue>& batch_kvs, size_t begin, size_t end,
+                                 RecordViewDecoder::Row& view_row);  // NOLINT
   butil::Status DoFilter(const std::string& key, const std::string& value, bool* is_reserved);
   butil::Status DoRelExprCore(const std::vector<std::any>& original_record,
                               std::unique_ptr<std::vector<expr::Operand>>& result_operand_ptr);  // NOLINT
@@ -75,8 +90,13 @@ class CoprocessorV2 : public RawCoprocessor {
                                      std::unique_ptr<std::vector<expr::Operand>>& result_operand_ptr);  // NOLINT
   butil::Status GetKvFromExprEndOfFinish(bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
                                          std::vector<pb::common::KeyValue>* kvs);
+  // Encode the result record, or keep it in top_n_ if top n is enabled.
   butil::Status GetKvFromExpr(const std::vector<std::any>& record, bool* has_result_kv,
                               pb::common::KeyValue* result_kv);
+  butil::Status EncodeResultRecord(const std::vector<std::any>& record, bool* has_result_kv,
+                                   pb::common::KeyValue* result_kv);
+  // Encode the rows of top_n_ in order after the whole range is evaluated.
+  butil::Status GetKvFromTopN(bool key_only, std::vector<pb::common::KeyValue>* kvs);
 
   void GetOriginalColumnIndexes();
   void GetSelectionColumnIndexes();
@@ -95,8 +115,15 @@ class CoprocessorV2 : public RawCoprocessor {
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas_;  // NOLINT
   std::shared_ptr<RecordEncoder> result_record_encoder_;                             // NOLINT
   std::shared_ptr<RecordDecoder> original_record_decoder_;                           // NOLINT
+  // fast path of original_record_decoder_ in batch mode, used if selection columns are supported
+  std::shared_ptr<RecordViewDecoder> original_record_view_decoder_;  // NOLINT
+  RecordViewDecoder::Row view_row_;                                  // NOLINT
   // array index =  result schema member index field ; value = result schema array index
   std::vector<int> result_column_indexes_;  // NOLINT
+  // decoded records of current batch, reused between batches
+  std::vector<std::vector<std::any>> batch_records_;  // NOLINT
+  // only keep the first n result rows if top n is pushed down
+  std::shared_ptr<TopNHeap> top_n_;  // NOLINT
 
 #if defined(TEST_COPROCESSOR_V2_MOCK)
   std::shared_ptr<rel::mock::RelRunner> rel_runner_;  // NOLINT
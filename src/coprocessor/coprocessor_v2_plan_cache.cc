@@ -0,0 +1,77 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "coprocessor/coprocessor_v2_plan_cache.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "bvar/reducer.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_int32(coprocessor_v2_plan_cache_capacity, 0, "max cached plans of coprocessor v2, 0 is disable");
+
+static bvar::Adder<uint64_t> bvar_coprocessor_v2_plan_cache_hit("dingo_coprocessor_v2_plan_cache_hit");
+static bvar::Adder<uint64_t> bvar_coprocessor_v2_plan_cache_miss("dingo_coprocessor_v2_plan_cache_miss");
+
+CoprocessorV2PlanCache& CoprocessorV2PlanCache::GetInstance() {
+  static CoprocessorV2PlanCache instance;
+  return instance;
+}
+
+bool CoprocessorV2PlanCache::IsEnabled() { return FLAGS_coprocessor_v2_plan_cache_capacity > 0; }
+
+std::shared_ptr<CoprocessorV2Plan> CoprocessorV2PlanCache::Get(const std::string& key) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = plans_.find(key);
+  if (it == plans_.end()) {
+    bvar_coprocessor_v2_plan_cache_miss << 1;
+    return nullptr;
+  }
+
+  bvar_coprocessor_v2_plan_cache_hit << 1;
+  return it->second;
+}
+
+void CoprocessorV2PlanCache::Put(const std::string& key, std::shared_ptr<CoprocessorV2Plan> plan) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (!plans_.emplace(key, std::move(plan)).second) {
+    return;
+  }
+  keys_.push_back(key);
+
+  while (!keys_.empty() && static_cast<int64_t>(keys_.size()) > FLAGS_coprocessor_v2_plan_cache_capacity) {
+    plans_.erase(keys_.front());
+    keys_.pop_front();
+  }
+}
+
+size_t CoprocessorV2PlanCache::Size() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return plans_.size();
+}
+
+void CoprocessorV2PlanCache::Clear() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  plans_.clear();
+  keys_.clear();
+}
+
+}  // namespace dingodb
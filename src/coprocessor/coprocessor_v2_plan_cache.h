@@ -0,0 +1,72 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COPROCESSOR_COPROCESSOR_V2_PLAN_CACHE_H_  // NOLINT
+#define DINGODB_COPROCESSOR_COPROCESSOR_V2_PLAN_CACHE_H_
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "serial/record_decoder.h"
+#include "serial/record_encoder.h"
+#include "serial/record_view_decoder.h"
+#include "serial/schema/base_schema.h"
+
+namespace dingodb {
+
+// The part of CoprocessorV2::Open only depends on the pushed down pb, shared by requests of the same pb.
+// All members are read only after built, so they can be used by concurrent coprocessors.
+struct CoprocessorV2Plan {
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> original_serial_schemas;
+  std::vector<int> original_column_indexes;
+  std::vector<int> selection_column_indexes;
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas;
+  std::vector<int> result_column_indexes;
+  std::shared_ptr<RecordDecoder> original_record_decoder;
+  std::shared_ptr<RecordViewDecoder> original_record_view_decoder;
+  std::shared_ptr<RecordEncoder> result_record_encoder;
+};
+
+// Cache plans by the serialized CoprocessorV2 pb, the oldest plan is evicted when full.
+// Capacity is coprocessor_v2_plan_cache_capacity, 0 is disable.
+class CoprocessorV2PlanCache {
+ public:
+  static CoprocessorV2PlanCache& GetInstance();
+
+  bool IsEnabled();
+
+  std::shared_ptr<CoprocessorV2Plan> Get(const std::string& key);
+  void Put(const std::string& key, std::shared_ptr<CoprocessorV2Plan> plan);
+
+  size_t Size();
+  void Clear();
+
+ private:
+  CoprocessorV2PlanCache() = default;
+
+  bthread::Mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<CoprocessorV2Plan>> plans_;
+  // insert order of keys
+  std::deque<std::string> keys_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COPROCESSOR_COPROCESSOR_V2_PLAN_CACHE_H_  // NOLINT
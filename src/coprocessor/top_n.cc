@@ -0,0 +1,177 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "coprocessor/top_n.h"
+
+#include <algorithm>
+#include <any>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fmt/core.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+TopNHeap::TopNHeap(const pb::common::CoprocessorV2::TopN& top_n,
+                   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas)
+    : top_n_(top_n), result_serial_schemas_(result_serial_schemas) {}
+
+butil::Status TopNHeap::Init() {
+  if (top_n_.limit() <= 0) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, fmt::format("top n limit {} invalid", top_n_.limit()));
+  }
+  if (top_n_.sort_columns().empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "top n sort columns is empty");
+  }
+  if (result_serial_schemas_ == nullptr) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "top n result schema is empty");
+  }
+
+  for (const auto& sort_column : top_n_.sort_columns()) {
+    if (sort_column.index() < 0 || sort_column.index() >= static_cast<int>(result_serial_schemas_->size())) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                           fmt::format("top n sort column index {} out of result schema size {}", sort_column.index(),
+                                       result_serial_schemas_->size()));
+    }
+
+    auto type = (*result_serial_schemas_)[sort_column.index()]->GetType();
+    switch (type) {
+      case BaseSchema::kBool:
+      case BaseSchema::kInteger:
+      case BaseSchema::kFloat:
+      case BaseSchema::kLong:
+      case BaseSchema::kDouble:
+      case BaseSchema::kString:
+        break;
+      default:
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                             fmt::format("top n sort column index {} type {} not support", sort_column.index(),
+                                         static_cast<int>(type)));
+    }
+
+    sort_columns_.push_back(SortColumn{sort_column.index(), type, sort_column.desc()});
+  }
+
+  limit_ = top_n_.limit();
+  heap_.reserve(limit_);
+
+  return butil::Status();
+}
+
+template <typename T>
+static int CompareValue(const std::optional<T>& lhs, const std::optional<T>& rhs) {
+  if (!lhs.has_value()) {
+    return rhs.has_value() ? -1 : 0;
+  }
+  if (!rhs.has_value()) {
+    return 1;
+  }
+
+  if (lhs.value() < rhs.value()) {
+    return -1;
+  }
+  return rhs.value() < lhs.value() ? 1 : 0;
+}
+
+static int CompareValue(const std::optional<std::shared_ptr<std::string>>& lhs,
+                        const std::optional<std::shared_ptr<std::string>>& rhs) {
+  bool lhs_null = !lhs.has_value() || lhs.value() == nullptr;
+  bool rhs_null = !rhs.has_value() || rhs.value() == nullptr;
+  if (lhs_null) {
+    return rhs_null ? 0 : -1;
+  }
+  if (rhs_null) {
+    return 1;
+  }
+
+  return lhs.value()->compare(*rhs.value());
+}
+
+template <typename T>
+static int CompareColumn(const std::any& lhs, const std::any& rhs) {
+  return CompareValue(std::any_cast<const std::optional<T>&>(lhs), std::any_cast<const std::optional<T>&>(rhs));
+}
+
+bool TopNHeap::Ahead(const std::vector<std::any>& lhs, const std::vector<std::any>& rhs) const {
+  for (const auto& sort_column : sort_columns_) {
+    const auto& lhs_column = lhs[sort_column.index];
+    const auto& rhs_column = rhs[sort_column.index];
+
+    int ret = 0;
+    switch (sort_column.type) {
+      case BaseSchema::kBool:
+        ret = CompareColumn<bool>(lhs_column, rhs_column);
+        break;
+      case BaseSchema::kInteger:
+        ret = CompareColumn<int32_t>(lhs_column, rhs_column);
+        break;
+      case BaseSchema::kFloat:
+        ret = CompareColumn<float>(lhs_column, rhs_column);
+        break;
+      case BaseSchema::kLong:
+        ret = CompareColumn<int64_t>(lhs_column, rhs_column);
+        break;
+      case BaseSchema::kDouble:
+        ret = CompareColumn<double>(lhs_column, rhs_column);
+        break;
+      case BaseSchema::kString:
+        ret = CompareColumn<std::shared_ptr<std::string>>(lhs_column, rhs_column);
+        break;
+      default:
+        break;
+    }
+
+    if (ret != 0) {
+      return sort_column.desc ? ret > 0 : ret < 0;
+    }
+  }
+
+  return false;
+}
+
+void TopNHeap::Add(const std::vector<std::any>& record) {
+  auto ahead = [this](const std::vector<std::any>& lhs, const std::vector<std::any>& rhs) { return Ahead(lhs, rhs); };
+
+  if (heap_.size() < limit_) {
+    heap_.push_back(record);
+    std::push_heap(heap_.begin(), heap_.end(), ahead);
+    return;
+  }
+
+  // not ahead of the last row of current top n, drop it.
+  if (!Ahead(record, heap_.front())) {
+    return;
+  }
+
+  std::pop_heap(heap_.begin(), heap_.end(), ahead);
+  heap_.back() = record;
+  std::push_heap(heap_.begin(), heap_.end(), ahead);
+}
+
+std::vector<std::vector<std::any>> TopNHeap::Finish() {
+  auto ahead = [this](const std::vector<std::any>& lhs, const std::vector<std::any>& rhs) { return Ahead(lhs, rhs); };
+  std::sort_heap(heap_.begin(), heap_.end(), ahead);
+
+  std::vector<std::vector<std::any>> rows;
+  rows.swap(heap_);
+  return rows;
+}
+
+}  // namespace dingodb
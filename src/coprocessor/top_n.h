@@ -0,0 +1,72 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COPROCESSOR_TOP_N_H_  // NOLINT
+#define DINGODB_COPROCESSOR_TOP_N_H_
+
+#include <any>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "butil/status.h"
+#include "proto/common.pb.h"
+#include "serial/schema/base_schema.h"
+
+namespace dingodb {
+
+// Keep the first limit rows ordered by sort columns in a bounded max heap, the top of heap is the last row of them.
+// The memory is limit rows no matter how many rows are added.
+class TopNHeap {
+ public:
+  TopNHeap(const pb::common::CoprocessorV2::TopN& top_n,
+           std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas);
+  ~TopNHeap() = default;
+
+  TopNHeap(const TopNHeap& rhs) = delete;
+  TopNHeap& operator=(const TopNHeap& rhs) = delete;
+
+  // Check sort columns with result schemas, only scalar columns can be sorted.
+  butil::Status Init();
+
+  // record is in result schema order.
+  void Add(const std::vector<std::any>& record);
+
+  size_t Size() const { return heap_.size(); }
+
+  // Rows in order, the heap is empty after finish.
+  std::vector<std::vector<std::any>> Finish();
+
+ private:
+  struct SortColumn {
+    int index;
+    BaseSchema::Type type;
+    bool desc;
+  };
+
+  // lhs is ahead of rhs in result order.
+  bool Ahead(const std::vector<std::any>& lhs, const std::vector<std::any>& rhs) const;
+
+  pb::common::CoprocessorV2::TopN top_n_;
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas_;
+
+  size_t limit_{0};
+  std::vector<SortColumn> sort_columns_;
+  std::vector<std::vector<std::any>> heap_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COPROCESSOR_TOP_N_H_  // NOLINT
@@ -14,14 +14,39 @@
 
 #include "crontab/crontab.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "bthread/bthread.h"
 #include "bthread/unstable.h"
+#include "butil/fast_rand.h"
+#include "common/helper.h"
 #include "common/logging.h"
 #include "common/role.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 
 namespace dingodb {
 
+DEFINE_double(crontab_jitter_ratio, 0.0,
+              "random jitter ratio of crontab interval, spread the crontab which fire at the same time, 0 is disable");
+DEFINE_bool(crontab_skip_if_running, false, "skip the async crontab run if last run is still running");
+DEFINE_int32(crontab_max_running_background_job, 0,
+             "max concurrently running background crontab jobs, skip the run if exceed, 0 is no limit");
+
+// interval +/- interval * jitter_ratio
+static int64_t JitterInterval(int64_t interval) {
+  int64_t jitter = static_cast<int64_t>(interval * FLAGS_crontab_jitter_ratio);
+  if (jitter <= 0) {
+    return interval;
+  }
+
+  return std::max(static_cast<int64_t>(1),
+                  interval - jitter + static_cast<int64_t>(butil::fast_rand_less_than(jitter * 2 + 1)));
+}
+
 CrontabManager::CrontabManager() { bthread_mutex_init(&mutex_, nullptr); }
 
 CrontabManager::~CrontabManager() { bthread_mutex_destroy(&mutex_); }
@@ -44,7 +69,8 @@ void CrontabManager::Run(void* arg) {
   }
 
   if (crontab->max_times == 0 || crontab->run_count < crontab->max_times) {
-    bthread_timer_add(&crontab->timer_id, butil::milliseconds_from_now(crontab->interval), &Run, crontab);
+    bthread_timer_add(&crontab->timer_id, butil::milliseconds_from_now(JitterInterval(crontab->interval)), &Run,
+                      crontab);
   }
 }
 
@@ -69,18 +95,14 @@ void CrontabManager::AddCrontab(std::vector<CrontabConfig>& crontab_configs) {
     auto crontab = std::make_shared<Crontab>();
     crontab->name = crontab_config.name;
     crontab->interval = crontab_config.interval;
+    crontab->background = crontab_config.background;
     if (crontab_config.async) {
-      crontab->func = [&](void*) {
-        bthread_t tid;
-        const bthread_attr_t attr = BTHREAD_ATTR_NORMAL;
-        bthread_start_background(
-            &tid, &attr,
-            [](void* arg) -> void* {
-              CrontabConfig* crontab_config = static_cast<CrontabConfig*>(arg);
-              crontab_config->funcer(nullptr);
-              return nullptr;
-            },
-            &crontab_config);
+      std::weak_ptr<Crontab> weak_crontab = crontab;
+      crontab->func = [this, weak_crontab, funcer = crontab_config.funcer](void*) {
+        auto crontab = weak_crontab.lock();
+        if (crontab != nullptr) {
+          RunAsync(crontab, funcer);
+        }
       };
     } else {
       crontab->func = crontab_config.funcer;
@@ -92,6 +114,80 @@ void CrontabManager::AddCrontab(std::vector<CrontabConfig>& crontab_configs) {
   }
 }
 
+bool CrontabManager::AcquireBackgroundJob(Crontab* crontab) {
+  if (FLAGS_crontab_skip_if_running && crontab->running.exchange(true)) {
+    DINGO_LOG(INFO) << fmt::format("[crontab.run][id({}).name({})] skip crontab, last run is still running.",
+                                   crontab->id, crontab->name);
+    return false;
+  }
+  crontab->running.store(true);
+
+  if (crontab->background) {
+    int32_t running_num = running_background_job_num_.fetch_add(1) + 1;
+    if (FLAGS_crontab_max_running_background_job > 0 && running_num > FLAGS_crontab_max_running_background_job) {
+      running_background_job_num_.fetch_sub(1);
+      crontab->running.store(false);
+      DINGO_LOG(INFO) << fmt::format("[crontab.run][id({}).name({})] skip crontab, running background job({}).",
+                                     crontab->id, crontab->name, running_num - 1);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void CrontabManager::ReleaseBackgroundJob(Crontab* crontab) {
+  if (crontab->background) {
+    running_background_job_num_.fetch_sub(1);
+  }
+  crontab->running.store(false);
+}
+
+void CrontabManager::RunAsync(std::shared_ptr<Crontab> crontab, std::function<void(void*)> funcer) {
+  if (!AcquireBackgroundJob(crontab.get())) {
+    crontab->skip_count.fetch_add(1);
+    return;
+  }
+
+  struct Params {
+    CrontabManager* manager;
+    std::shared_ptr<Crontab> crontab;
+    std::function<void(void*)> funcer;
+  };
+  auto* params = new Params{this, crontab, std::move(funcer)};
+
+  bthread_t tid;
+  const bthread_attr_t attr = BTHREAD_ATTR_NORMAL;
+  int ret = bthread_start_background(
+      &tid, &attr,
+      [](void* arg) -> void* {
+        std::unique_ptr<Params> params(static_cast<Params*>(arg));
+        int64_t start_time = Helper::TimestampMs();
+        params->funcer(nullptr);
+        params->crontab->last_elapsed_ms.store(Helper::TimestampMs() - start_time);
+        params->manager->ReleaseBackgroundJob(params->crontab.get());
+        return nullptr;
+      },
+      params);
+  if (ret != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[crontab.run][id({}).name({})] start bthread failed.", crontab->id,
+                                    crontab->name);
+    ReleaseBackgroundJob(crontab.get());
+    delete params;
+  }
+}
+
+std::vector<std::shared_ptr<Crontab>> CrontabManager::GetCrontabs() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  std::vector<std::shared_ptr<Crontab>> crontabs;
+  crontabs.reserve(crontabs_.size());
+  for (auto& [_, crontab] : crontabs_) {
+    crontabs.push_back(crontab);
+  }
+  return crontabs;
+}
+
 uint32_t CrontabManager::AddAndRunCrontab(std::shared_ptr<Crontab> crontab) {
   uint32_t crontab_id = AddCrontab(crontab);
   StartCrontab(crontab_id);
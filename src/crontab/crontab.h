@@ -34,6 +34,8 @@ struct CrontabConfig {
   int32_t interval;
   bool async;
   std::function<void(void*)> funcer;
+  // Heavy background job, e.g. metrics collection and split check, it is limited by the background job budget.
+  bool background{false};
 };
 
 class Crontab {
@@ -56,6 +58,13 @@ class Crontab {
   std::function<void(void*)> func;
   // Delivery to func_'s argument
   void* arg{nullptr};
+
+  // Only for async crontab
+  bool background{false};
+  std::atomic<bool> running{false};
+  // Skipped run count, because last run is still running or out of background job budget.
+  std::atomic<int64_t> skip_count{0};
+  std::atomic<int64_t> last_elapsed_ms{0};
 };
 
 // Manage crontab use brpc::bthread_timer_add
@@ -77,12 +86,20 @@ class CrontabManager {
   void PauseCrontab(uint32_t crontab_id);
   void DeleteCrontab(uint32_t crontab_id);
 
+  std::vector<std::shared_ptr<Crontab>> GetCrontabs();
+  int32_t RunningBackgroundJobNum() const { return running_background_job_num_.load(std::memory_order_relaxed); }
+
   void Destroy();
 
  private:
   // Allocate crontab id by auto incremental.
   uint32_t AllocCrontabId();
 
+  // Run crontab function in a new bthread, skip it if last run is still running or out of budget.
+  void RunAsync(std::shared_ptr<Crontab> crontab, std::function<void(void*)> funcer);
+  bool AcquireBackgroundJob(Crontab* crontab);
+  void ReleaseBackgroundJob(Crontab* crontab);
+
   void InnerPauseCrontab(uint32_t crontab_id);
 
   // Atomic auto incremental variable
@@ -91,6 +108,9 @@ class CrontabManager {
   bthread_mutex_t mutex_;
   // Store all crontab, key(crontab_id) / value(Crontab)
   std::map<uint32_t, std::shared_ptr<Crontab> > crontabs_;
+
+  // Running background job num, shared budget of all background crontab.
+  std::atomic<int32_t> running_background_job_num_{0};
 };
 
 }  // namespace dingodb
@@ -17,6 +17,7 @@
 #include <gflags/gflags.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <cstdlib>
@@ -82,6 +83,11 @@ DEFINE_int32(bdb_stat_time_s, 60, "bdb stat time interval(s)");
 DEFINE_bool(bdb_use_db_pool, false, "bdb use db pool");
 DEFINE_int32(bdb_db_pool_size, 4096, "bdb db pool size, must bigger than bthread_connecurrency");
 
+DEFINE_int32(bdb_bulk_scan_buffer_size, 0,
+             "bdb scan and count use bulk cursor get with this buffer size(bytes), 0 is disable, multiple of 1024");
+DEFINE_bool(bdb_txn_write_nosync, false,
+            "bdb txn commit write log without fsync, so commits of concurrent txns share the log flush of os");
+
 namespace bdb {
 
 #define DB_MAXIMUM_PAGESIZE (64 * 1024) /* Maximum database page size */
@@ -723,6 +729,104 @@ butil::Status Reader::KvGet(const std::string& cf_name, dingodb::SnapshotPtr sna
   return butil::Status(pb::error::EBDB_UNKNOW, "unknow error.");
 }
 
+butil::Status Reader::KvBatchGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<pb::common::KeyValue>& kvs) {
+  return KvBatchGet(cf_name, GetSnapshot(), keys, kvs);
+}
+
+butil::Status Reader::KvBatchGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) {
+  CHECK(snapshot != nullptr);
+
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[bdb] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+  }
+
+  std::shared_ptr<bdb::BdbSnapshot> ss = std::dynamic_pointer_cast<bdb::BdbSnapshot>(snapshot);
+  if (ss == nullptr) {
+    DINGO_LOG(ERROR) << "[bdb] snapshot pointer cast error.";
+    return butil::Status(pb::error::EINTERNAL, "snapshot pointer cast error.");
+  }
+
+  // Visit keys in order with one cursor, so that adjacent keys share the btree pages.
+  std::vector<size_t> indexes(keys.size());
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    indexes[i] = i;
+  }
+  std::sort(indexes.begin(), indexes.end(), [&keys](size_t lhs, size_t rhs) { return keys[lhs] < keys[rhs]; });
+
+  Dbc* cursorp = nullptr;
+  // close cursorp
+  DEFER(  // FOR_CLANG_FORMAT
+      if (cursorp != nullptr) {
+        try {
+          cursorp->close();
+          cursorp = nullptr;
+        } catch (DbException& db_exception) {
+          BdbHelper::PrintEnvStat(GetRawEngine()->GetEnv());
+          LOG(WARNING) << fmt::format("[bdb] cursor close failed, exception: {} {}.", db_exception.get_errno(),
+                                      db_exception.what());
+        }
+      });
+
+  std::vector<std::string> values(keys.size());
+  std::vector<bool> founds(keys.size(), false);
+  try {
+    int ret = ss->GetDb()->cursor(ss->GetDbTxn(), &cursorp, DB_TXN_SNAPSHOT);
+    if (ret != 0) {
+      DINGO_LOG(ERROR) << fmt::format("[bdb] cursor create failed, ret: {}.", ret);
+      return butil::Status(pb::error::EINTERNAL, "Internal create cursor error.");
+    }
+
+    for (auto index : indexes) {
+      std::string store_key = BdbHelper::EncodeKey(cf_name, keys[index]);
+      Dbt bdb_key;
+      BdbHelper::StringToDbt(store_key, bdb_key);
+
+      Dbt bdb_value;
+      ret = cursorp->get(&bdb_key, &bdb_value, DB_SET);
+      if (ret == 0) {
+        BdbHelper::DbtToString(bdb_value, values[index]);
+        founds[index] = true;
+      } else if (ret != DB_NOTFOUND) {
+        DINGO_LOG(ERROR) << fmt::format("[bdb] cursor get failed, ret: {}.", ret);
+        return butil::Status(pb::error::EINTERNAL, "Internal batch get error.");
+      }
+    }
+  } catch (DbDeadlockException&) {
+    DINGO_LOG(ERROR) << fmt::format("[bdb] batch get, got deadlock.");
+    return butil::Status(pb::error::EBDB_DEADLOCK, "batch get, got deadlock.");
+  } catch (DbException& db_exception) {
+    BdbHelper::PrintEnvStat(GetRawEngine()->GetEnv());
+    DINGO_LOG(ERROR) << "[bdb] db exception: " << db_exception.get_errno() << " " << db_exception.what();
+    return butil::Status(pb::error::EBDB_EXCEPTION, "%s", db_exception.what());
+  } catch (std::exception& std_exception) {
+    DINGO_LOG(ERROR) << "[bdb] std exception: " << std_exception.what();
+    return butil::Status(pb::error::ESTD_EXCEPTION, "%s", std_exception.what());
+  }
+
+  kvs.reserve(kvs.size() + keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (!founds[i]) {
+      continue;
+    }
+
+    pb::common::KeyValue kv;
+    kv.set_key(keys[i]);
+    kv.set_value(std::move(values[i]));
+    kvs.push_back(std::move(kv));
+  }
+
+  return butil::Status();
+}
+
 butil::Status Reader::KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                              std::vector<pb::common::KeyValue>& kvs) {
   return KvScan(cf_name, GetSnapshot(), start_key, end_key, kvs);
@@ -744,6 +848,16 @@ butil::Status Reader::KvScan(const std::string& cf_name, dingodb::SnapshotPtr sn
     return butil::Status();
   }
 
+  if (FLAGS_bdb_bulk_scan_buffer_size > 0) {
+    return BulkScan(cf_name, snapshot, start_key, end_key, [&kvs](const Dbt& key, const Dbt& value) -> bool {
+      pb::common::KeyValue kv;
+      BdbHelper::DbtToUserKey(key, *kv.mutable_key());
+      BdbHelper::DbtToString(value, *kv.mutable_value());
+      kvs.push_back(std::move(kv));
+      return true;
+    });
+  }
+
   IteratorOptions options;
   options.lower_bound = start_key;
   options.upper_bound = end_key;
@@ -788,6 +902,13 @@ butil::Status Reader::KvCount(const std::string& cf_name, dingodb::SnapshotPtr s
     return butil::Status();
   }
 
+  if (FLAGS_bdb_bulk_scan_buffer_size > 0) {
+    return BulkScan(cf_name, snapshot, start_key, end_key, [&count](const Dbt&, const Dbt&) -> bool {
+      ++count;
+      return true;
+    });
+  }
+
   IteratorOptions options;
   options.lower_bound = start_key;
   options.upper_bound = end_key;
@@ -806,6 +927,99 @@ butil::Status Reader::KvCount(const std::string& cf_name, dingodb::SnapshotPtr s
   return butil::Status::OK();
 }
 
+// Bulk buffer length must be multiple of 1024.
+static uint32_t AlignBulkBufferSize(uint32_t size) { return (size + 1023) / 1024 * 1024; }
+
+butil::Status Reader::BulkScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                               const std::string& end_key, BulkScanHandler handler) {
+  auto bdb_snapshot = std::dynamic_pointer_cast<bdb::BdbSnapshot>(snapshot);
+  if (bdb_snapshot == nullptr) {
+    DINGO_LOG(ERROR) << "[bdb] snapshot pointer cast error.";
+    return butil::Status(pb::error::EINTERNAL, "Snapshot pointer cast error.");
+  }
+
+  std::string raw_start_key = BdbHelper::EncodeKey(cf_name, start_key);
+  std::string raw_end_key = BdbHelper::EncodeKey(cf_name, end_key);
+
+  // The key of DB_SET_RANGE is input and output, so it need a buffer too.
+  std::vector<char> key_buffer(std::max(raw_start_key.size(), static_cast<size_t>(1024)));
+  std::vector<char> data_buffer(AlignBulkBufferSize(FLAGS_bdb_bulk_scan_buffer_size));
+
+  Dbc* cursorp = nullptr;
+  try {
+    int ret = bdb_snapshot->GetDb()->cursor(bdb_snapshot->GetDbTxn(), &cursorp, DB_CURSOR_BULK | DB_TXN_SNAPSHOT);
+    if (ret != 0) {
+      DINGO_LOG(ERROR) << fmt::format("[bdb] cursor create failed, ret: {}.", ret);
+      return butil::Status(pb::error::EINTERNAL, "Internal create cursor error.");
+    }
+    DEFER(cursorp->close());
+
+    Dbt key;
+    uint32_t flags = DB_SET_RANGE | DB_MULTIPLE_KEY;
+    for (;;) {
+      if (flags & DB_SET_RANGE) {
+        std::memcpy(key_buffer.data(), raw_start_key.data(), raw_start_key.size());
+        key.set_size(raw_start_key.size());
+      }
+      key.set_data(key_buffer.data());
+      key.set_ulen(key_buffer.size());
+      key.set_flags(DB_DBT_USERMEM);
+      Dbt data;
+      data.set_data(data_buffer.data());
+      data.set_ulen(data_buffer.size());
+      data.set_flags(DB_DBT_USERMEM);
+
+      try {
+        ret = cursorp->get(&key, &data, flags);
+      } catch (DbMemoryException&) {
+        ret = DB_BUFFER_SMALL;
+      }
+
+      if (ret == DB_NOTFOUND) {
+        break;
+      }
+      if (ret == DB_BUFFER_SMALL) {
+        // A single key-value is bigger than buffer, grow the buffer and retry.
+        if (key.get_size() > key_buffer.size()) {
+          key_buffer.resize(key.get_size());
+        }
+        if (data.get_size() > data_buffer.size()) {
+          data_buffer.resize(AlignBulkBufferSize(data.get_size()));
+        }
+        continue;
+      }
+      if (ret != 0) {
+        DINGO_LOG(ERROR) << fmt::format("[bdb] bulk get failed, ret: {}.", ret);
+        return butil::Status(pb::error::EINTERNAL, "Internal cursor bulk get error.");
+      }
+
+      DbMultipleKeyDataIterator iter(data);
+      Dbt bdb_key, bdb_value;
+      while (iter.next(bdb_key, bdb_value)) {
+        std::string_view sv(static_cast<const char*>(bdb_key.get_data()), bdb_key.get_size());
+        if (raw_end_key.compare(sv) <= 0 || !handler(bdb_key, bdb_value)) {
+          return butil::Status::OK();
+        }
+      }
+
+      flags = DB_NEXT | DB_MULTIPLE_KEY;
+    }
+  } catch (DbDeadlockException&) {
+    DINGO_LOG(ERROR) << fmt::format("[bdb] got DeadLockException, giving up.");
+    return butil::Status(pb::error::EBDB_DEADLOCK, "Got DeadLockException, giving up.");
+  } catch (DbException& db_exception) {
+    BdbHelper::PrintEnvStat(GetRawEngine()->GetEnv());
+    DINGO_LOG(ERROR) << fmt::format("[bdb] bulk scan failed, exception: {} {}.", db_exception.get_errno(),
+                                    db_exception.what());
+    return butil::Status(pb::error::EBDB_EXCEPTION, fmt::format("bulk scan failed, {}.", db_exception.what()));
+  } catch (std::exception& std_exception) {
+    DINGO_LOG(ERROR) << fmt::format("[bdb] std exception, {}.", std_exception.what());
+    return butil::Status(pb::error::ESTD_EXCEPTION, fmt::format("std exception, {}.", std_exception.what()));
+  }
+
+  return butil::Status::OK();
+}
+
 std::shared_ptr<dingodb::Iterator> Reader::NewIterator(const std::string& cf_name, IteratorOptions options) {
   return NewIterator(cf_name, GetSnapshot(), options);
 }
@@ -2069,6 +2283,11 @@ bool BdbRawEngine::Init(std::shared_ptr<Config> config, const std::vector<std::s
     // set lock timeout to 5s, the first parameter is microsecond
     envp_->set_timeout(5 * 1000 * 1000, DB_SET_LOCK_TIMEOUT);
 
+    // Data is recoverable from the raft log, only the order of commits matters.
+    if (FLAGS_bdb_txn_write_nosync) {
+      envp_->set_flags(DB_TXN_WRITE_NOSYNC, 1);
+    }
+
     DINGO_LOG(INFO) << fmt::format("[bdb] set txn_max to: {}.", txn_max);
 
     envp_->open((const char*)bdb_path.c_str(), env_flags, 0);
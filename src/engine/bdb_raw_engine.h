@@ -19,6 +19,7 @@
 
 #include <atomic>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -168,6 +169,11 @@ class Reader : public RawEngine::Reader {
   butil::Status KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value) override;
 
+  butil::Status KvBatchGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                           std::vector<pb::common::KeyValue>& kvs) override;
+  butil::Status KvBatchGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) override;
+
   butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs) override;
   butil::Status KvScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
@@ -196,6 +202,12 @@ class Reader : public RawEngine::Reader {
   dingodb::SnapshotPtr GetSnapshot();
   butil::Status RetrieveByCursor(const std::string& cf_name, DbTxn* txn, const std::string& key, std::string& value);
 
+  // Scan [start_key, end_key) by bulk cursor get, one get fills many key-value pairs into a buffer.
+  // handler get the encoded key and value, return false to stop.
+  using BulkScanHandler = std::function<bool(const Dbt& key, const Dbt& value)>;
+  butil::Status BulkScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                         const std::string& end_key, BulkScanHandler handler);
+
   std::weak_ptr<BdbRawEngine> raw_engine_;
 };
 
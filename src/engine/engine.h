@@ -65,6 +65,8 @@ class Engine : public std::enable_shared_from_this<Engine> {
     virtual ~Reader() = default;
 
     virtual butil::Status KvGet(std::shared_ptr<Context> ctx, const std::string& key, std::string& value) = 0;
+    virtual butil::Status KvBatchGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
+                                     std::vector<pb::common::KeyValue>& kvs) = 0;
 
     virtual butil::Status KvScan(std::shared_ptr<Context> ctx, const std::string& start_key, const std::string& end_key,
                                  std::vector<pb::common::KeyValue>& kvs) = 0;
@@ -79,7 +81,8 @@ class Engine : public std::enable_shared_from_this<Engine> {
     Writer() = default;
     virtual ~Writer() = default;
 
-    virtual butil::Status KvPut(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs) = 0;
+    // the kvs are moved into the raft log
+    virtual butil::Status KvPut(std::shared_ptr<Context> ctx, std::vector<pb::common::KeyValue>&& kvs) = 0;
     virtual butil::Status KvDelete(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys) = 0;
     virtual butil::Status KvDeleteRange(std::shared_ptr<Context> ctx, const pb::common::Range& range) = 0;
     virtual butil::Status KvPutIfAbsent(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs,
@@ -100,6 +103,7 @@ class Engine : public std::enable_shared_from_this<Engine> {
       int64_t region_id{};
 
       pb::common::RawEngine raw_engine_type{pb::common::RAW_ENG_ROCKSDB};
+      pb::store::ReadMode read_mode{pb::store::ReadLeader};
 
       pb::common::Range region_range;
 
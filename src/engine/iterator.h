@@ -15,7 +15,9 @@
 #ifndef DINGODB_ENGINE_ITERATOR_H_
 #define DINGODB_ENGINE_ITERATOR_H_
 
+#include <cstddef>
 #include <memory>
+#include <string>
 #include <string_view>
 
 #include "butil/status.h"
@@ -36,6 +38,13 @@ enum class IteratorType {
 struct IteratorOptions {
   std::string lower_bound;
   std::string upper_bound;
+  // bytes of readahead for long sequential scan, 0 is default of engine.
+  size_t readahead_size{0};
+  // load value on the first Value() of an entry, key only scans do not read values separated into blob files.
+  bool lazy_value{false};
+  // only iterate the keys with the same prefix as the seek key, for point read of txn write cf whose prefix extractor
+  // is txn_user_key, then the prefix bloom filter skips the sst files without the user key. Ignored for other cf.
+  bool prefix_seek{false};
 };
 
 class Iterator {
@@ -0,0 +1,725 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/mem_raw_engine.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/compiler_specific.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "rocksdb/options.h"
+#include "rocksdb/sst_file_reader.h"
+
+namespace dingodb {
+
+// Read the latest version, not visible to any snapshot.
+static const int64_t kLatestSeq = INT64_MAX;
+static const size_t kIngestBatchPutCount = 4096;
+
+static int64_t VersionBytes(const mem::Version& version) {
+  return static_cast<int64_t>(sizeof(mem::Version) + version.value.size());
+}
+
+namespace mem {
+
+MemSnapshot::~MemSnapshot() {
+  auto raw_engine = raw_engine_.lock();
+  if (raw_engine != nullptr) {
+    raw_engine->ReleaseSnapshot(seq_);
+  }
+}
+
+bool Iterator::Valid() const { return valid_; }
+
+void Iterator::SeekToFirst() { SeekNext(options_.lower_bound, true); }
+
+void Iterator::SeekToLast() {
+  if (options_.upper_bound.empty()) {
+    SeekPrev("", false, true);
+  } else {
+    SeekPrev(options_.upper_bound, false, false);
+  }
+}
+
+void Iterator::Seek(const std::string& target) {
+  if (!options_.lower_bound.empty() && target < options_.lower_bound) {
+    SeekNext(options_.lower_bound, true);
+  } else {
+    SeekNext(target, true);
+  }
+}
+
+void Iterator::SeekForPrev(const std::string& target) {
+  if (!options_.upper_bound.empty() && target >= options_.upper_bound) {
+    SeekPrev(options_.upper_bound, false, false);
+  } else {
+    SeekPrev(target, true, false);
+  }
+}
+
+void Iterator::Next() {
+  if (valid_) {
+    SeekNext(key_, false);
+  }
+}
+
+void Iterator::Prev() {
+  if (valid_) {
+    SeekPrev(key_, false, false);
+  }
+}
+
+void Iterator::SeekNext(const std::string& target, bool inclusive) {
+  std::string key;
+  std::string value;
+  valid_ = raw_engine_->FindNext(cf_name_, snapshot_->Seq(), target, inclusive, options_.upper_bound, key, value);
+  key_.swap(key);
+  value_.swap(value);
+}
+
+void Iterator::SeekPrev(const std::string& target, bool inclusive, bool to_last) {
+  std::string key;
+  std::string value;
+  valid_ = raw_engine_->FindPrev(cf_name_, snapshot_->Seq(), target, inclusive, to_last, options_.lower_bound, key,
+                                 value);
+  key_.swap(key);
+  value_.swap(value);
+}
+
+std::shared_ptr<MemRawEngine> Reader::GetRawEngine() {
+  auto raw_engine = raw_engine_.lock();
+  if (raw_engine == nullptr) {
+    DINGO_LOG(FATAL) << "[mem] get raw engine failed.";
+  }
+
+  return raw_engine;
+}
+
+int64_t Reader::GetSnapshotSeq(dingodb::SnapshotPtr snapshot) {
+  if (snapshot == nullptr) {
+    return kLatestSeq;
+  }
+
+  auto mem_snapshot = std::dynamic_pointer_cast<MemSnapshot>(snapshot);
+  if (BAIDU_UNLIKELY(mem_snapshot == nullptr)) {
+    DINGO_LOG(ERROR) << "[mem] snapshot is not mem snapshot, read the latest data.";
+    return kLatestSeq;
+  }
+
+  return mem_snapshot->Seq();
+}
+
+butil::Status Reader::KvGet(const std::string& cf_name, const std::string& key, std::string& value) {
+  return KvGet(cf_name, nullptr, key, value);
+}
+
+butil::Status Reader::KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
+                            std::string& value) {
+  if (BAIDU_UNLIKELY(key.empty())) {
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  return GetRawEngine()->Get(cf_name, GetSnapshotSeq(snapshot), key, value);
+}
+
+butil::Status Reader::KvBatchGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<pb::common::KeyValue>& kvs) {
+  return KvBatchGet(cf_name, GetRawEngine()->GetSnapshot(), keys, kvs);
+}
+
+butil::Status Reader::KvBatchGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) {
+  auto raw_engine = GetRawEngine();
+  int64_t seq = GetSnapshotSeq(snapshot);
+  for (const auto& key : keys) {
+    std::string value;
+    auto status = raw_engine->Get(cf_name, seq, key, value);
+    if (status.error_code() == pb::error::EKEY_NOT_FOUND) {
+      continue;
+    } else if (!status.ok()) {
+      return status;
+    }
+
+    pb::common::KeyValue kv;
+    kv.set_key(key);
+    kv.set_value(std::move(value));
+    kvs.push_back(std::move(kv));
+  }
+
+  return butil::Status();
+}
+
+butil::Status Reader::KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
+                             std::vector<pb::common::KeyValue>& kvs) {
+  return KvScan(cf_name, nullptr, start_key, end_key, kvs);
+}
+
+butil::Status Reader::KvScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                             const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) {
+  if (BAIDU_UNLIKELY(start_key.empty())) {
+    return butil::Status(pb::error::EKEY_EMPTY, "Start key is empty");
+  }
+  if (BAIDU_UNLIKELY(end_key.empty())) {
+    return butil::Status(pb::error::EKEY_EMPTY, "End key is empty");
+  }
+
+  return GetRawEngine()->Scan(cf_name, GetSnapshotSeq(snapshot), start_key, end_key,
+                              [&kvs](const std::string& key, const std::string& value) {
+                                pb::common::KeyValue kv;
+                                kv.set_key(key);
+                                kv.set_value(value);
+                                kvs.push_back(std::move(kv));
+                                return true;
+                              });
+}
+
+butil::Status Reader::KvCount(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
+                              int64_t& count) {
+  return KvCount(cf_name, nullptr, start_key, end_key, count);
+}
+
+butil::Status Reader::KvCount(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                              const std::string& end_key, int64_t& count) {
+  if (BAIDU_UNLIKELY(start_key.empty())) {
+    return butil::Status(pb::error::EKEY_EMPTY, "Start key is empty");
+  }
+  if (BAIDU_UNLIKELY(end_key.empty())) {
+    return butil::Status(pb::error::EKEY_EMPTY, "End key is empty");
+  }
+
+  count = 0;
+  return GetRawEngine()->Scan(cf_name, GetSnapshotSeq(snapshot), start_key, end_key,
+                              [&count](const std::string&, const std::string&) {
+                                ++count;
+                                return true;
+                              });
+}
+
+dingodb::IteratorPtr Reader::NewIterator(const std::string& cf_name, IteratorOptions options) {
+  return NewIterator(cf_name, nullptr, options);
+}
+
+dingodb::IteratorPtr Reader::NewIterator(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                         IteratorOptions options) {
+  auto raw_engine = GetRawEngine();
+  if (!raw_engine->HasColumnFamily(cf_name)) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] not found column family {}.", cf_name);
+    return nullptr;
+  }
+
+  auto mem_snapshot = std::dynamic_pointer_cast<MemSnapshot>(snapshot);
+  if (mem_snapshot == nullptr) {
+    mem_snapshot = raw_engine->AcquireSnapshot();
+  }
+
+  return std::make_shared<Iterator>(raw_engine, cf_name, mem_snapshot, options);
+}
+
+std::shared_ptr<MemRawEngine> Writer::GetRawEngine() {
+  auto raw_engine = raw_engine_.lock();
+  if (raw_engine == nullptr) {
+    DINGO_LOG(FATAL) << "[mem] get raw engine failed.";
+  }
+
+  return raw_engine;
+}
+
+butil::Status Writer::KvPut(const std::string& cf_name, const pb::common::KeyValue& kv) {
+  if (BAIDU_UNLIKELY(kv.key().empty())) {
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  MemRawEngine::WriteBatch batch;
+  batch.puts[cf_name].push_back(kv);
+  return GetRawEngine()->Write(batch);
+}
+
+butil::Status Writer::KvDelete(const std::string& cf_name, const std::string& key) {
+  if (BAIDU_UNLIKELY(key.empty())) {
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  MemRawEngine::WriteBatch batch;
+  batch.deletes[cf_name].push_back(key);
+  return GetRawEngine()->Write(batch);
+}
+
+butil::Status Writer::KvBatchPutAndDelete(const std::string& cf_name,
+                                          const std::vector<pb::common::KeyValue>& kvs_to_put,
+                                          const std::vector<std::string>& keys_to_delete) {
+  MemRawEngine::WriteBatch batch;
+  if (!kvs_to_put.empty()) {
+    batch.puts[cf_name] = kvs_to_put;
+  }
+  if (!keys_to_delete.empty()) {
+    batch.deletes[cf_name] = keys_to_delete;
+  }
+  return GetRawEngine()->Write(batch);
+}
+
+butil::Status Writer::KvBatchPutAndDelete(
+    const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
+    const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) {
+  MemRawEngine::WriteBatch batch;
+  batch.puts = kv_puts_with_cf;
+  batch.deletes = kv_deletes_with_cf;
+  return GetRawEngine()->Write(batch);
+}
+
+butil::Status Writer::KvDeleteRange(const std::string& cf_name, const pb::common::Range& range) {
+  return KvBatchDeleteRange({{cf_name, {range}}});
+}
+
+butil::Status Writer::KvBatchDeleteRange(const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs) {
+  for (const auto& [cf_name, ranges] : range_with_cfs) {
+    for (const auto& range : ranges) {
+      if (BAIDU_UNLIKELY(range.start_key().empty() || range.end_key().empty())) {
+        return butil::Status(pb::error::EKEY_EMPTY, "Range key is empty");
+      }
+      if (BAIDU_UNLIKELY(range.start_key() >= range.end_key())) {
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Range is invalid");
+      }
+    }
+  }
+
+  MemRawEngine::WriteBatch batch;
+  batch.delete_ranges = range_with_cfs;
+  return GetRawEngine()->Write(batch);
+}
+
+}  // namespace mem
+
+bool MemRawEngine::Init(std::shared_ptr<Config> /*config*/, const std::vector<std::string>& cf_names) {
+  for (const auto& cf_name : cf_names) {
+    tables_[cf_name];
+  }
+
+  reader_ = std::make_shared<mem::Reader>(GetSelfPtr());
+  writer_ = std::make_shared<mem::Writer>(GetSelfPtr());
+
+  DINGO_LOG(INFO) << fmt::format("[mem] init mem raw engine, column family num: {}.", tables_.size());
+
+  return true;
+}
+
+void MemRawEngine::Close() {
+  RWLockWriteGuard guard(&rw_lock_);
+  for (auto& [_, table] : tables_) {
+    table.clear();
+  }
+  memory_bytes_.store(0, std::memory_order_relaxed);
+
+  DINGO_LOG(INFO) << "[mem] close mem raw engine.";
+}
+
+void MemRawEngine::Destroy() { Close(); }
+
+std::string MemRawEngine::GetName() { return pb::common::RawEngine_Name(pb::common::RAW_ENG_MEMORY); }
+
+pb::common::RawEngine MemRawEngine::GetRawEngineType() { return pb::common::RAW_ENG_MEMORY; }
+
+dingodb::SnapshotPtr MemRawEngine::GetSnapshot() { return AcquireSnapshot(); }
+
+mem::MemSnapshotPtr MemRawEngine::AcquireSnapshot() {
+  // No write is in progress, so all the versions of seq has been written.
+  RWLockReadGuard guard(&rw_lock_);
+  int64_t seq = LatestSeq();
+  {
+    BAIDU_SCOPED_LOCK(snapshot_mutex_);
+    snapshot_seqs_.insert(seq);
+  }
+
+  return std::make_shared<mem::MemSnapshot>(GetSelfPtr(), seq);
+}
+
+void MemRawEngine::ReleaseSnapshot(int64_t seq) {
+  BAIDU_SCOPED_LOCK(snapshot_mutex_);
+  auto it = snapshot_seqs_.find(seq);
+  if (it != snapshot_seqs_.end()) {
+    snapshot_seqs_.erase(it);
+  }
+}
+
+int64_t MemRawEngine::GetMinSnapshotSeq(int64_t seq) {
+  BAIDU_SCOPED_LOCK(snapshot_mutex_);
+  return snapshot_seqs_.empty() ? seq : std::min(seq, *snapshot_seqs_.begin());
+}
+
+RawEngine::CheckpointPtr MemRawEngine::NewCheckpoint() { return std::make_shared<RawEngine::Checkpoint>(); }
+
+butil::Status MemRawEngine::MergeCheckpointFiles(const std::string& /*path*/, const pb::common::Range& /*range*/,
+                                                 const std::vector<std::string>& /*cf_names*/,
+                                                 std::vector<std::string>& /*merge_sst_paths*/) {
+  return butil::Status(pb::error::ENOT_SUPPORT, "Not support merge checkpoint files.");
+}
+
+butil::Status MemRawEngine::IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files) {
+  if (!HasColumnFamily(cf_name)) {
+    return butil::Status(pb::error::EINTERNAL, "Not found column family %s", cf_name.c_str());
+  }
+
+  rocksdb::SstFileReader reader{rocksdb::Options()};
+  for (const auto& file : files) {
+    auto status = reader.Open(file);
+    if (BAIDU_UNLIKELY(!status.ok())) {
+      DINGO_LOG(ERROR) << fmt::format("[mem] open external file {} failed, error: {}", file, status.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Internal ingest external file error.");
+    }
+
+    WriteBatch batch;
+    auto& kvs = batch.puts[cf_name];
+    std::unique_ptr<rocksdb::Iterator> iter(reader.NewIterator(rocksdb::ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      pb::common::KeyValue kv;
+      kv.set_key(iter->key().data(), iter->key().size());
+      kv.set_value(iter->value().data(), iter->value().size());
+      kvs.push_back(std::move(kv));
+
+      if (kvs.size() >= kIngestBatchPutCount) {
+        auto write_status = Write(batch);
+        if (!write_status.ok()) {
+          return write_status;
+        }
+        kvs.clear();
+      }
+    }
+    if (!iter->status().ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[mem] read external file {} failed, error: {}", file,
+                                      iter->status().ToString());
+      return butil::Status(pb::error::EINTERNAL, "Internal ingest external file error.");
+    }
+
+    if (!kvs.empty()) {
+      auto write_status = Write(batch);
+      if (!write_status.ok()) {
+        return write_status;
+      }
+    }
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[mem] ingest external file done, cf_name: {} file num: {}.", cf_name, files.size());
+
+  return butil::Status();
+}
+
+butil::Status MemRawEngine::GetExternalFileKeyRange(const std::string& file, std::string& smallest_key,
+                                                    std::string& largest_key) {
+  rocksdb::SstFileReader reader{rocksdb::Options()};
+  auto status = reader.Open(file);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[mem] open external file {} failed, error: {}", file, status.ToString());
+    return butil::Status(pb::error::EINTERNAL, status.ToString());
+  }
+
+  std::unique_ptr<rocksdb::Iterator> iter(reader.NewIterator(rocksdb::ReadOptions()));
+  iter->SeekToFirst();
+  if (!iter->Valid()) {
+    return butil::Status(pb::error::EKEY_EMPTY, "External file is empty");
+  }
+  smallest_key = iter->key().ToString();
+
+  iter->SeekToLast();
+  if (!iter->Valid()) {
+    return butil::Status(pb::error::EINTERNAL, iter->status().ToString());
+  }
+  largest_key = iter->key().ToString();
+
+  return butil::Status();
+}
+
+std::vector<int64_t> MemRawEngine::GetApproximateSizes(const std::string& cf_name,
+                                                       std::vector<pb::common::Range>& ranges) {
+  std::vector<int64_t> sizes;
+  sizes.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    int64_t size = 0;
+    Scan(cf_name, kLatestSeq, range.start_key(), range.end_key(),
+         [&size](const std::string& key, const std::string& value) {
+           size += key.size() + value.size();
+           return true;
+         });
+    sizes.push_back(size);
+  }
+
+  return sizes;
+}
+
+butil::Status MemRawEngine::GetApproximateKeyCount(const std::string& cf_name, const pb::common::Range& range,
+                                                   int64_t& count) {
+  count = 0;
+  return Scan(cf_name, kLatestSeq, range.start_key(), range.end_key(),
+              [&count](const std::string&, const std::string&) {
+                ++count;
+                return true;
+              });
+}
+
+void MemRawEngine::GetMemoryUsage(int64_t& memtable_bytes, int64_t& block_cache_bytes) {
+  memtable_bytes = memory_bytes_.load(std::memory_order_relaxed);
+  block_cache_bytes = 0;
+}
+
+// Data is only in memory, nothing to flush.
+void MemRawEngine::Flush(const std::string& /*cf_name*/) {}
+
+// Reclaim the versions not visible to any snapshot of all keys.
+butil::Status MemRawEngine::Compact(const std::string& cf_name) {
+  auto it = tables_.find(cf_name);
+  if (it == tables_.end()) {
+    return butil::Status(pb::error::EINTERNAL, "Not found column family %s", cf_name.c_str());
+  }
+
+  RWLockWriteGuard guard(&rw_lock_);
+  auto& table = it->second;
+  int64_t min_snapshot_seq = GetMinSnapshotSeq(LatestSeq());
+  for (auto table_it = table.begin(); table_it != table.end();) {
+    if (ReclaimVersions(table_it->second, min_snapshot_seq)) {
+      memory_bytes_.fetch_sub(table_it->first.size(), std::memory_order_relaxed);
+      table_it = table.erase(table_it);
+    } else {
+      ++table_it;
+    }
+  }
+
+  return butil::Status();
+}
+
+butil::Status MemRawEngine::Write(const WriteBatch& batch) {
+  for (const auto& [cf_name, _] : batch.puts) {
+    if (BAIDU_UNLIKELY(!HasColumnFamily(cf_name))) {
+      return butil::Status(pb::error::EINTERNAL, "Not found column family %s", cf_name.c_str());
+    }
+  }
+  for (const auto& [cf_name, _] : batch.deletes) {
+    if (BAIDU_UNLIKELY(!HasColumnFamily(cf_name))) {
+      return butil::Status(pb::error::EINTERNAL, "Not found column family %s", cf_name.c_str());
+    }
+  }
+  for (const auto& [cf_name, _] : batch.delete_ranges) {
+    if (BAIDU_UNLIKELY(!HasColumnFamily(cf_name))) {
+      return butil::Status(pb::error::EINTERNAL, "Not found column family %s", cf_name.c_str());
+    }
+  }
+
+  RWLockWriteGuard guard(&rw_lock_);
+  int64_t seq = LatestSeq() + 1;
+  int64_t min_snapshot_seq = GetMinSnapshotSeq(seq);
+
+  for (const auto& [cf_name, ranges] : batch.delete_ranges) {
+    auto& table = tables_.at(cf_name);
+    for (const auto& range : ranges) {
+      for (auto it = table.lower_bound(range.start_key());
+           it != table.end() && (range.end_key().empty() || it->first < range.end_key());) {
+        if (GetVisibleVersion(it->second, kLatestSeq) == nullptr) {
+          ++it;
+          continue;
+        }
+        it = AddVersion(table, it, mem::Version{seq, true, ""}, min_snapshot_seq);
+      }
+    }
+  }
+
+  for (const auto& [cf_name, kvs] : batch.puts) {
+    auto& table = tables_.at(cf_name);
+    for (const auto& kv : kvs) {
+      AddVersion(table, kv.key(), mem::Version{seq, false, kv.value()}, min_snapshot_seq);
+    }
+  }
+
+  for (const auto& [cf_name, keys] : batch.deletes) {
+    auto& table = tables_.at(cf_name);
+    for (const auto& key : keys) {
+      AddVersion(table, key, mem::Version{seq, true, ""}, min_snapshot_seq);
+    }
+  }
+
+  seq_.store(seq, std::memory_order_release);
+
+  return butil::Status();
+}
+
+const mem::Version* MemRawEngine::GetVisibleVersion(const mem::VersionChain& chain, int64_t seq) {
+  for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+    if (it->seq <= seq) {
+      return it->is_deleted ? nullptr : &(*it);
+    }
+  }
+
+  return nullptr;
+}
+
+bool MemRawEngine::ReclaimVersions(mem::VersionChain& chain, int64_t min_snapshot_seq) {
+  // The newest version not greater than min snapshot seq is visible to all snapshots, the older ones are useless.
+  size_t pos = chain.size();
+  for (size_t i = chain.size(); i > 0; --i) {
+    if (chain[i - 1].seq <= min_snapshot_seq) {
+      pos = i - 1;
+      break;
+    }
+  }
+  if (pos == chain.size()) {
+    return false;
+  }
+
+  // A deleted version visible to all snapshots is same as not exist.
+  size_t reclaim_count = chain[pos].is_deleted ? pos + 1 : pos;
+  if (reclaim_count == 0) {
+    return false;
+  }
+
+  int64_t bytes = 0;
+  for (size_t i = 0; i < reclaim_count; ++i) {
+    bytes += VersionBytes(chain[i]);
+  }
+  memory_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+  chain.erase(chain.begin(), chain.begin() + reclaim_count);
+
+  return chain.empty();
+}
+
+void MemRawEngine::AddVersion(mem::Table& table, const std::string& key, mem::Version&& version,
+                              int64_t min_snapshot_seq) {
+  auto it = table.find(key);
+  if (it == table.end()) {
+    // Delete not exist key, nothing is visible to any snapshot.
+    if (version.is_deleted) {
+      return;
+    }
+    it = table.emplace(key, mem::VersionChain()).first;
+    memory_bytes_.fetch_add(key.size(), std::memory_order_relaxed);
+  }
+
+  AddVersion(table, it, std::move(version), min_snapshot_seq);
+}
+
+mem::Table::iterator MemRawEngine::AddVersion(mem::Table& table, mem::Table::iterator it, mem::Version&& version,
+                                              int64_t min_snapshot_seq) {
+  auto& chain = it->second;
+  memory_bytes_.fetch_add(VersionBytes(version), std::memory_order_relaxed);
+  // Write the same key more than once in a batch, the last one win.
+  if (!chain.empty() && chain.back().seq == version.seq) {
+    memory_bytes_.fetch_sub(VersionBytes(chain.back()), std::memory_order_relaxed);
+    chain.back() = std::move(version);
+  } else {
+    chain.push_back(std::move(version));
+  }
+
+  if (ReclaimVersions(chain, min_snapshot_seq)) {
+    memory_bytes_.fetch_sub(it->first.size(), std::memory_order_relaxed);
+    return table.erase(it);
+  }
+
+  return ++it;
+}
+
+butil::Status MemRawEngine::Get(const std::string& cf_name, int64_t seq, const std::string& key, std::string& value) {
+  auto table_it = tables_.find(cf_name);
+  if (BAIDU_UNLIKELY(table_it == tables_.end())) {
+    return butil::Status(pb::error::EINTERNAL, "Not found column family %s", cf_name.c_str());
+  }
+
+  RWLockReadGuard guard(&rw_lock_);
+  const auto& table = table_it->second;
+  auto it = table.find(key);
+  if (it == table.end()) {
+    return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
+  }
+
+  const auto* version = GetVisibleVersion(it->second, seq);
+  if (version == nullptr) {
+    return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
+  }
+  value = version->value;
+
+  return butil::Status();
+}
+
+butil::Status MemRawEngine::Scan(const std::string& cf_name, int64_t seq, const std::string& start_key,
+                                 const std::string& end_key,
+                                 const std::function<bool(const std::string& key, const std::string& value)>& handler) {
+  auto table_it = tables_.find(cf_name);
+  if (BAIDU_UNLIKELY(table_it == tables_.end())) {
+    return butil::Status(pb::error::EINTERNAL, "Not found column family %s", cf_name.c_str());
+  }
+
+  RWLockReadGuard guard(&rw_lock_);
+  const auto& table = table_it->second;
+  for (auto it = table.lower_bound(start_key); it != table.end() && (end_key.empty() || it->first < end_key); ++it) {
+    const auto* version = GetVisibleVersion(it->second, seq);
+    if (version != nullptr && !handler(it->first, version->value)) {
+      break;
+    }
+  }
+
+  return butil::Status();
+}
+
+bool MemRawEngine::FindNext(const std::string& cf_name, int64_t seq, const std::string& target, bool inclusive,
+                            const std::string& upper_bound, std::string& key, std::string& value) {
+  auto table_it = tables_.find(cf_name);
+  if (BAIDU_UNLIKELY(table_it == tables_.end())) {
+    return false;
+  }
+
+  RWLockReadGuard guard(&rw_lock_);
+  const auto& table = table_it->second;
+  auto it = inclusive ? table.lower_bound(target) : table.upper_bound(target);
+  for (; it != table.end() && (upper_bound.empty() || it->first < upper_bound); ++it) {
+    const auto* version = GetVisibleVersion(it->second, seq);
+    if (version != nullptr) {
+      key = it->first;
+      value = version->value;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool MemRawEngine::FindPrev(const std::string& cf_name, int64_t seq, const std::string& target, bool inclusive,
+                            bool to_last, const std::string& lower_bound, std::string& key, std::string& value) {
+  auto table_it = tables_.find(cf_name);
+  if (BAIDU_UNLIKELY(table_it == tables_.end())) {
+    return false;
+  }
+
+  RWLockReadGuard guard(&rw_lock_);
+  const auto& table = table_it->second;
+  auto it = to_last ? table.end() : (inclusive ? table.upper_bound(target) : table.lower_bound(target));
+  while (it != table.begin()) {
+    --it;
+    if (!lower_bound.empty() && it->first < lower_bound) {
+      break;
+    }
+
+    const auto* version = GetVisibleVersion(it->second, seq);
+    if (version != nullptr) {
+      key = it->first;
+      value = version->value;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+}  // namespace dingodb
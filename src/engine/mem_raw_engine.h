@@ -0,0 +1,275 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_MEM_RAW_ENGINE_H_  // NOLINT
+#define DINGODB_ENGINE_MEM_RAW_ENGINE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "common/synchronization.h"
+#include "config/config.h"
+#include "engine/iterator.h"
+#include "engine/raw_engine.h"
+#include "engine/snapshot.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+class MemRawEngine;
+
+namespace mem {
+
+// A version of key, every write batch has a increasing sequence.
+struct Version {
+  int64_t seq{0};
+  bool is_deleted{false};
+  std::string value;
+};
+
+// Versions of a key, order by seq asc.
+using VersionChain = std::vector<Version>;
+using Table = std::map<std::string, VersionChain>;
+
+// Snapshot read the newest version whose seq is not greater than the snapshot seq.
+// The versions visible to a live snapshot are not reclaimed.
+class MemSnapshot : public dingodb::Snapshot {
+ public:
+  MemSnapshot(std::shared_ptr<MemRawEngine> raw_engine, int64_t seq) : raw_engine_(raw_engine), seq_(seq) {}
+  ~MemSnapshot() override;
+
+  const void* Inner() override { return nullptr; }
+  int64_t Seq() const { return seq_; }
+
+ private:
+  std::weak_ptr<MemRawEngine> raw_engine_;
+  int64_t seq_;
+};
+using MemSnapshotPtr = std::shared_ptr<MemSnapshot>;
+
+// The iterator does not hold the lock of engine, every move re-seek the table by the current key,
+// so it is safe to write or reclaim versions while iterating.
+class Iterator : public dingodb::Iterator {
+ public:
+  Iterator(std::shared_ptr<MemRawEngine> raw_engine, const std::string& cf_name, MemSnapshotPtr snapshot,
+           IteratorOptions options)
+      : raw_engine_(raw_engine), cf_name_(cf_name), snapshot_(snapshot), options_(options) {}
+  ~Iterator() override = default;
+
+  std::string GetName() override { return "RawMem"; }
+  IteratorType GetID() override { return IteratorType::kMemEngine; }
+
+  bool Valid() const override;
+
+  void SeekToFirst() override;
+  void SeekToLast() override;
+
+  void Seek(const std::string& target) override;
+  void SeekForPrev(const std::string& target) override;
+
+  void Next() override;
+  void Prev() override;
+
+  std::string_view Key() const override { return key_; }
+  std::string_view Value() const override { return value_; }
+
+  butil::Status Status() const override { return status_; }
+
+ private:
+  void SeekNext(const std::string& target, bool inclusive);
+  void SeekPrev(const std::string& target, bool inclusive, bool to_last);
+
+  std::shared_ptr<MemRawEngine> raw_engine_;
+  std::string cf_name_;
+  MemSnapshotPtr snapshot_;
+  IteratorOptions options_;
+
+  bool valid_{false};
+  std::string key_;
+  std::string value_;
+  butil::Status status_;
+};
+
+class Reader : public RawEngine::Reader {
+ public:
+  Reader(std::shared_ptr<MemRawEngine> raw_engine) : raw_engine_(raw_engine) {}
+  ~Reader() override = default;
+
+  butil::Status KvGet(const std::string& cf_name, const std::string& key, std::string& value) override;
+  butil::Status KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
+                      std::string& value) override;
+
+  butil::Status KvBatchGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                           std::vector<pb::common::KeyValue>& kvs) override;
+  butil::Status KvBatchGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) override;
+
+  butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
+                       std::vector<pb::common::KeyValue>& kvs) override;
+  butil::Status KvScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                       const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) override;
+
+  butil::Status KvCount(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
+                        int64_t& count) override;
+  butil::Status KvCount(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                        const std::string& end_key, int64_t& count) override;
+
+  dingodb::IteratorPtr NewIterator(const std::string& cf_name, IteratorOptions options) override;
+  dingodb::IteratorPtr NewIterator(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                   IteratorOptions options) override;
+
+ private:
+  std::shared_ptr<MemRawEngine> GetRawEngine();
+  // Get the seq of snapshot, the latest seq if snapshot is nullptr.
+  int64_t GetSnapshotSeq(dingodb::SnapshotPtr snapshot);
+
+  std::weak_ptr<MemRawEngine> raw_engine_;
+};
+
+class Writer : public RawEngine::Writer {
+ public:
+  Writer(std::shared_ptr<MemRawEngine> raw_engine) : raw_engine_(raw_engine) {}
+  ~Writer() override = default;
+
+  butil::Status KvPut(const std::string& cf_name, const pb::common::KeyValue& kv) override;
+  butil::Status KvDelete(const std::string& cf_name, const std::string& key) override;
+
+  butil::Status KvBatchPutAndDelete(const std::string& cf_name, const std::vector<pb::common::KeyValue>& kvs_to_put,
+                                    const std::vector<std::string>& keys_to_delete) override;
+  butil::Status KvBatchPutAndDelete(const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
+                                    const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) override;
+
+  butil::Status KvDeleteRange(const std::string& cf_name, const pb::common::Range& range) override;
+  butil::Status KvBatchDeleteRange(
+      const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs) override;
+
+ private:
+  std::shared_ptr<MemRawEngine> GetRawEngine();
+
+  std::weak_ptr<MemRawEngine> raw_engine_;
+};
+
+}  // namespace mem
+
+// In-memory raw engine, keep multi version of every key for snapshot isolation.
+// Every write batch is atomic and get a increasing sequence, readers and writers are serialized by a bthread rwlock,
+// the old versions are reclaimed when rewriting the key or compacting once no live snapshot can see them.
+// Data is not persisted locally, a replica restarted is rebuilt by the raft snapshot of leader,
+// and the raft snapshot of memory region is generated and ingested by sst files as other engines.
+class MemRawEngine : public RawEngine {
+ public:
+  MemRawEngine() = default;
+  ~MemRawEngine() override = default;
+
+  MemRawEngine(const MemRawEngine& rhs) = delete;
+  MemRawEngine& operator=(const MemRawEngine& rhs) = delete;
+  MemRawEngine(MemRawEngine&& rhs) = delete;
+  MemRawEngine& operator=(MemRawEngine&& rhs) = delete;
+
+  std::shared_ptr<MemRawEngine> GetSelfPtr() { return std::dynamic_pointer_cast<MemRawEngine>(shared_from_this()); }
+
+  // override functions
+  bool Init(std::shared_ptr<Config> config, const std::vector<std::string>& cf_names) override;
+  void Close() override;
+  void Destroy() override;
+
+  std::string GetName() override;
+  pb::common::RawEngine GetRawEngineType() override;
+  dingodb::SnapshotPtr GetSnapshot() override;
+
+  RawEngine::ReaderPtr Reader() override { return reader_; }
+  RawEngine::WriterPtr Writer() override { return writer_; }
+  RawEngine::CheckpointPtr NewCheckpoint() override;
+
+  butil::Status MergeCheckpointFiles(const std::string& path, const pb::common::Range& range,
+                                     const std::vector<std::string>& cf_names,
+                                     std::vector<std::string>& merge_sst_paths) override;
+  butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files) override;
+  butil::Status GetExternalFileKeyRange(const std::string& file, std::string& smallest_key,
+                                        std::string& largest_key) override;
+
+  std::vector<int64_t> GetApproximateSizes(const std::string& cf_name, std::vector<pb::common::Range>& ranges) override;
+  butil::Status GetApproximateKeyCount(const std::string& cf_name, const pb::common::Range& range,
+                                       int64_t& count) override;
+  void GetMemoryUsage(int64_t& memtable_bytes, int64_t& block_cache_bytes) override;
+
+  void Flush(const std::string& cf_name) override;
+  butil::Status Compact(const std::string& cf_name) override;
+
+  // Inner interfaces for mem::Reader/Writer/Iterator
+  struct WriteBatch {
+    std::map<std::string, std::vector<pb::common::KeyValue>> puts;
+    std::map<std::string, std::vector<std::string>> deletes;
+    std::map<std::string, std::vector<pb::common::Range>> delete_ranges;
+  };
+  butil::Status Write(const WriteBatch& batch);
+
+  mem::MemSnapshotPtr AcquireSnapshot();
+  void ReleaseSnapshot(int64_t seq);
+  int64_t LatestSeq() const { return seq_.load(std::memory_order_acquire); }
+
+  butil::Status Get(const std::string& cf_name, int64_t seq, const std::string& key, std::string& value);
+  // Visit the visible kvs of [start_key, end_key) in order until handler return false. Empty end_key is unbounded.
+  butil::Status Scan(const std::string& cf_name, int64_t seq, const std::string& start_key, const std::string& end_key,
+                     const std::function<bool(const std::string& key, const std::string& value)>& handler);
+  // Find the first visible key after target(or equal if inclusive) and before upper_bound.
+  bool FindNext(const std::string& cf_name, int64_t seq, const std::string& target, bool inclusive,
+                const std::string& upper_bound, std::string& key, std::string& value);
+  // Find the last visible key before target(or equal if inclusive) and not before lower_bound.
+  // Empty target with to_last means seek from the end of table.
+  bool FindPrev(const std::string& cf_name, int64_t seq, const std::string& target, bool inclusive, bool to_last,
+                const std::string& lower_bound, std::string& key, std::string& value);
+
+  bool HasColumnFamily(const std::string& cf_name) { return tables_.find(cf_name) != tables_.end(); }
+
+ private:
+  static const mem::Version* GetVisibleVersion(const mem::VersionChain& chain, int64_t seq);
+
+  // Min seq of live snapshots and seq, versions older than the newest version not greater than it are useless.
+  int64_t GetMinSnapshotSeq(int64_t seq);
+  // Reclaim useless versions of chain, return true if the key can be removed.
+  bool ReclaimVersions(mem::VersionChain& chain, int64_t min_snapshot_seq);
+  void AddVersion(mem::Table& table, const std::string& key, mem::Version&& version, int64_t min_snapshot_seq);
+  // Add version to the key of it, return the next position of table.
+  mem::Table::iterator AddVersion(mem::Table& table, mem::Table::iterator it, mem::Version&& version,
+                                  int64_t min_snapshot_seq);
+
+  // The tables are created in Init and never changed, so find table without lock.
+  std::map<std::string, mem::Table> tables_;
+  RWLock rw_lock_;
+
+  std::atomic<int64_t> seq_{0};
+
+  bthread::Mutex snapshot_mutex_;
+  std::multiset<int64_t> snapshot_seqs_;
+
+  // Bytes of all keys and versions.
+  std::atomic<int64_t> memory_bytes_{0};
+
+  RawEngine::ReaderPtr reader_;
+  RawEngine::WriterPtr writer_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_MEM_RAW_ENGINE_H_  // NOLINT
@@ -19,6 +19,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -32,10 +33,13 @@
 #include "config/config_manager.h"
 #include "engine/engine.h"
 #include "engine/raw_engine.h"
+#include "engine/raw_kv_ttl.h"
 #include "engine/txn_engine_helper.h"
+#include "engine/txn_lock_table.h"
 #include "engine/write_data.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
@@ -49,9 +53,15 @@
 
 namespace dingodb {
 
-RaftStoreEngine::RaftStoreEngine(std::shared_ptr<RawEngine> rocks_engine, std::shared_ptr<RawEngine> bdb_engine)
+DEFINE_bool(enable_raft_apply_conditional_write, false,
+            "evaluate the condition of put if absent and compare and set at raft apply, instead of reading the old "
+            "value before propose, all replicas must support it");
+
+RaftStoreEngine::RaftStoreEngine(std::shared_ptr<RawEngine> rocks_engine, std::shared_ptr<RawEngine> bdb_engine,
+                                 std::shared_ptr<RawEngine> memory_engine)
     : raw_rocks_engine(rocks_engine),
       raw_bdb_engine(bdb_engine),
+      raw_memory_engine(memory_engine),
       raft_node_manager(std::move(std::make_unique<RaftNodeManager>())) {}
 
 RaftStoreEngine::~RaftStoreEngine() = default;
@@ -133,8 +143,12 @@ bool RaftStoreEngine::Recover() {
       parameter.listeners = listener_factory->Build();
 
       auto is_complete = IsCompleteRaftNode(region->Id(), parameter.raft_path, parameter.log_path);
-      if (!is_complete) {
-        DINGO_LOG(INFO) << fmt::format("[raft.engine][region({})] raft node is not complete.", region->Id());
+      // The data of memory region is lost after restart, the raft log before the last snapshot may be truncated,
+      // so rebuild a empty raft node, then the leader install snapshot to it.
+      bool is_memory = region->GetRawEngineType() == pb::common::RawEngine::RAW_ENG_MEMORY;
+      if (!is_complete || is_memory) {
+        DINGO_LOG(INFO) << fmt::format("[raft.engine][region({})] raft node is not complete or is memory region.",
+                                       region->Id());
         if (!CleanRaftDirectory(region->Id(), parameter.raft_path, parameter.log_path)) {
           DINGO_LOG(WARNING) << fmt::format("[raft.engine][region({})] clean region raft directory failed.",
                                             region->Id());
@@ -175,6 +189,8 @@ std::shared_ptr<RawEngine> RaftStoreEngine::GetRawEngine(pb::common::RawEngine t
     return raw_rocks_engine;
   } else if (type == pb::common::RawEngine::RAW_ENG_BDB) {
     return raw_bdb_engine;
+  } else if (type == pb::common::RawEngine::RAW_ENG_MEMORY && raw_memory_engine != nullptr) {
+    return raw_memory_engine;
   }
 
   DINGO_LOG(FATAL) << "[raft.engine] unknown raw engine type.";
@@ -204,14 +220,15 @@ butil::Status RaftStoreEngine::AddNode(store::RegionPtr region, const AddNodePar
   auto node = std::make_shared<RaftNode>(region->Id(), region->Name(), braft::PeerId(parameter.raft_endpoint),
                                          state_machine, log_storage);
 
-  if (node->Init(region, Helper::FormatPeers(Helper::ExtractLocations(region->Peers())), parameter.raft_path,
-                 parameter.election_timeout_ms) != 0) {
+  // Learners are not in the raft configuration, the node of learner never elects and pulls the log from voters.
+  auto init_conf = Helper::FormatPeers(Helper::ExtractLocations(region->Peers(pb::common::VOTER)));
+  if (node->Init(region, init_conf, parameter.raft_path, parameter.election_timeout_ms) != 0) {
     if (parameter.is_restart) {
       DINGO_LOG(FATAL) << fmt::format("[raft.engine][region({})] Raft init failed. Please check raft storage!",
                                       region->Id())
                        << ", raft_path: " << parameter.raft_path
                        << ", election_timeout_ms: " << parameter.election_timeout_ms
-                       << ", peers: " << Helper::FormatPeers(Helper::ExtractLocations(region->Peers()));
+                       << ", peers: " << init_conf;
     } else {
       node->Destroy();
     }
@@ -358,6 +375,8 @@ void RaftStoreEngine::DoSnapshotPeriodicity() {
   }
 }
 
+void RaftStoreEngine::DoHibernatePeriodicity() { raft_node_manager->CheckHibernate(); }
+
 butil::Status RaftStoreEngine::TransferLeader(int64_t region_id, const pb::common::Peer& peer) {
   auto node = raft_node_manager->GetNode(region_id);
   if (node == nullptr) {
@@ -384,6 +403,14 @@ std::shared_ptr<pb::raft::RaftCmdRequest> GenRaftCmdRequest(const std::shared_pt
   header->set_region_id(ctx->RegionId());
   *header->mutable_epoch() = ctx->RegionEpoch();
 
+  auto tracker = ctx->Tracker();
+  if (tracker != nullptr && tracker->IsTraced()) {
+    auto* trace = header->mutable_trace();
+    trace->set_trace_id(tracker->Span().trace_id);
+    trace->set_span_id(tracker->Span().span_id);
+    trace->set_sampled(true);
+  }
+
   auto* requests = raft_cmd->mutable_requests();
   for (auto& datum : write_data->Datums()) {
     requests->AddAllocated(datum->TransformToRaft());
@@ -447,6 +474,11 @@ butil::Status RaftStoreEngine::Reader::KvGet(std::shared_ptr<Context> ctx, const
   return reader_->KvGet(ctx->CfName(), key, value);
 }
 
+butil::Status RaftStoreEngine::Reader::KvBatchGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
+                                                  std::vector<pb::common::KeyValue>& kvs) {
+  return reader_->KvBatchGet(ctx->CfName(), keys, kvs);
+}
+
 butil::Status RaftStoreEngine::Reader::KvScan(std::shared_ptr<Context> ctx, const std::string& start_key,
                                               const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) {
   return reader_->KvScan(ctx->CfName(), start_key, end_key, kvs);
@@ -521,7 +553,8 @@ butil::Status RaftStoreEngine::TxnReader::TxnBatchGet(std::shared_ptr<Context> c
                                                       const std::set<int64_t>& resolved_locks,
                                                       pb::store::TxnResultInfo& txn_result_info) {
   return TxnEngineHelper::BatchGet(txn_reader_raw_engine_, ctx->IsolationLevel(), start_ts, keys, resolved_locks,
-                                   txn_result_info, kvs);
+                                   txn_result_info, kvs, TxnLockTableManager::GetInstance().Get(ctx->RegionId()),
+                                   ctx->Tracker());
 }
 
 butil::Status RaftStoreEngine::TxnReader::TxnScan(
@@ -531,7 +564,7 @@ butil::Status RaftStoreEngine::TxnReader::TxnScan(
     std::vector<pb::common::KeyValue>& kvs, bool& has_more, std::string& end_scan_key) {
   return TxnEngineHelper::Scan(txn_reader_raw_engine_, ctx->IsolationLevel(), start_ts, range, limit, key_only,
                                is_reverse, resolved_locks, disable_coprocessor, coprocessor, txn_result_info, kvs,
-                               has_more, end_scan_key);
+                               has_more, end_scan_key, ctx->Tracker());
 }
 
 butil::Status RaftStoreEngine::TxnReader::TxnScanLock(std::shared_ptr<Context> /*ctx*/, int64_t min_lock_ts,
@@ -610,9 +643,8 @@ std::shared_ptr<Engine::Writer> RaftStoreEngine::NewWriter(pb::common::RawEngine
   return std::make_shared<RaftStoreEngine::Writer>(GetRawEngine(type), GetSelfPtr());
 }
 
-butil::Status RaftStoreEngine::Writer::KvPut(std::shared_ptr<Context> ctx,
-                                             const std::vector<pb::common::KeyValue>& kvs) {
-  return raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), kvs));
+butil::Status RaftStoreEngine::Writer::KvPut(std::shared_ptr<Context> ctx, std::vector<pb::common::KeyValue>&& kvs) {
+  return raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), std::move(kvs)));
 }
 
 butil::Status RaftStoreEngine::Writer::KvDelete(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys) {
@@ -623,6 +655,16 @@ butil::Status RaftStoreEngine::Writer::KvDeleteRange(std::shared_ptr<Context> ct
   return raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), range));
 }
 
+// Strip the ttl header of the old value, the expired value is not found.
+static butil::Status DecodeRawKvTtlValue(std::string& value) {
+  std::string_view user_value;
+  if (!RawKvTtl::DecodeValue(value, Helper::TimestampMs(), user_value)) {
+    return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
+  }
+  value.erase(0, value.size() - user_value.size());
+  return butil::Status();
+}
+
 butil::Status RaftStoreEngine::Writer::KvPutIfAbsent(std::shared_ptr<Context> ctx,
                                                      const std::vector<pb::common::KeyValue>& kvs, bool is_atomic,
                                                      std::vector<bool>& key_states) {
@@ -632,6 +674,23 @@ butil::Status RaftStoreEngine::Writer::KvPutIfAbsent(std::shared_ptr<Context> ct
 
   key_states.resize(kvs.size(), false);
 
+  if (FLAGS_enable_raft_apply_conditional_write) {
+    for (const auto& kv : kvs) {
+      if (BAIDU_UNLIKELY(kv.key().empty())) {
+        return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+      }
+    }
+
+    auto status = raft_engine_->Write(
+        ctx, WriteDataBuilder::BuildPutIfAbsentWrite(ctx->CfName(), kvs, is_atomic, Helper::TimestampMs()));
+    if (!status.ok()) {
+      return status;
+    }
+
+    key_states = ctx->KeyStates();
+    return butil::Status();
+  }
+
   std::vector<bool> temp_key_states;
   temp_key_states.resize(kvs.size(), false);
 
@@ -647,6 +706,9 @@ butil::Status RaftStoreEngine::Writer::KvPutIfAbsent(std::shared_ptr<Context> ct
     if (!status.ok() && status.error_code() != pb::error::Errno::EKEY_NOT_FOUND) {
       return butil::Status(pb::error::EINTERNAL, "Internal get error");
     }
+    if (status.ok() && RawKvTtl::IsEnabled(ctx->CfName(), kv.key())) {
+      status = DecodeRawKvTtlValue(old_value);
+    }
 
     if (is_atomic) {
       if (status.ok()) {
@@ -689,6 +751,23 @@ butil::Status RaftStoreEngine::Writer::KvCompareAndSet(std::shared_ptr<Context>
 
   key_states.resize(kvs.size(), false);
 
+  if (FLAGS_enable_raft_apply_conditional_write) {
+    for (const auto& kv : kvs) {
+      if (BAIDU_UNLIKELY(kv.key().empty())) {
+        return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+      }
+    }
+
+    auto status = raft_engine_->Write(ctx, WriteDataBuilder::BuildCompareAndSetWrite(ctx->CfName(), kvs, expect_values,
+                                                                                     is_atomic, Helper::TimestampMs()));
+    if (!status.ok()) {
+      return status;
+    }
+
+    key_states = ctx->KeyStates();
+    return butil::Status();
+  }
+
   std::vector<bool> temp_key_states;
   temp_key_states.resize(kvs.size(), false);
 
@@ -705,6 +784,9 @@ butil::Status RaftStoreEngine::Writer::KvCompareAndSet(std::shared_ptr<Context>
     if (!status.ok() && status.error_code() != pb::error::Errno::EKEY_NOT_FOUND) {
       return butil::Status(pb::error::EINTERNAL, "Internal get error");
     }
+    if (status.ok() && RawKvTtl::IsEnabled(ctx->CfName(), kv.key())) {
+      status = DecodeRawKvTtlValue(old_value);
+    }
 
     if (is_atomic) {
       if (status.ok()) {
@@ -72,7 +72,8 @@ class RaftControlAble {
 
 class RaftStoreEngine : public Engine, public RaftControlAble {
  public:
-  RaftStoreEngine(std::shared_ptr<RawEngine> raw_rocks_engine, std::shared_ptr<RawEngine> raw_bdb_engine);
+  RaftStoreEngine(std::shared_ptr<RawEngine> raw_rocks_engine, std::shared_ptr<RawEngine> raw_bdb_engine,
+                  std::shared_ptr<RawEngine> raw_memory_engine = nullptr);
   ~RaftStoreEngine() override;
 
   std::shared_ptr<RaftStoreEngine> GetSelfPtr();
@@ -101,6 +102,7 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
   butil::Status SaveSnapshot(std::shared_ptr<Context> ctx, int64_t region_id, bool force) override;
   butil::Status AyncSaveSnapshot(std::shared_ptr<Context> ctx, int64_t region_id, bool force) override;
   void DoSnapshotPeriodicity();
+  void DoHibernatePeriodicity();
 
   butil::Status Write(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) override;
   butil::Status AsyncWrite(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) override;
@@ -112,6 +114,8 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
    public:
     Reader(RawEngine::ReaderPtr reader) : reader_(reader) {}
     butil::Status KvGet(std::shared_ptr<Context> ctx, const std::string& key, std::string& value) override;
+    butil::Status KvBatchGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
+                             std::vector<pb::common::KeyValue>& kvs) override;
 
     butil::Status KvScan(std::shared_ptr<Context> ctx, const std::string& start_key, const std::string& end_key,
                          std::vector<pb::common::KeyValue>& kvs) override;
@@ -127,7 +131,7 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
    public:
     Writer(std::shared_ptr<RawEngine> raw_engine, std::shared_ptr<RaftStoreEngine> raft_engine)
         : writer_raw_engine_(raw_engine), raft_engine_(raft_engine) {}
-    butil::Status KvPut(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs) override;
+    butil::Status KvPut(std::shared_ptr<Context> ctx, std::vector<pb::common::KeyValue>&& kvs) override;
     butil::Status KvDelete(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys) override;
     butil::Status KvDeleteRange(std::shared_ptr<Context> ctx, const pb::common::Range& range) override;
     butil::Status KvPutIfAbsent(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs,
@@ -231,8 +235,9 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
   std::shared_ptr<Engine::TxnWriter> NewTxnWriter(pb::common::RawEngine type) override;
 
  protected:
-  std::shared_ptr<RawEngine> raw_rocks_engine;  // RocksDB, the system engine, for meta and data
-  std::shared_ptr<RawEngine> raw_bdb_engine;    // BDB, the engine for data
+  std::shared_ptr<RawEngine> raw_rocks_engine;   // RocksDB, the system engine, for meta and data
+  std::shared_ptr<RawEngine> raw_bdb_engine;     // BDB, the engine for data
+  std::shared_ptr<RawEngine> raw_memory_engine;  // Memory, the engine for data only in memory
   std::unique_ptr<RaftNodeManager> raft_node_manager;
 };
 
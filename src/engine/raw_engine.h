@@ -44,6 +44,12 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
     virtual butil::Status KvGet(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
                                 const std::string& key, std::string& value) = 0;
 
+    // Get multiple keys in one call, not found keys are skipped, kvs keep the order of keys.
+    virtual butil::Status KvBatchGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                     std::vector<pb::common::KeyValue>& kvs) = 0;
+    virtual butil::Status KvBatchGet(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
+                                     const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) = 0;
+
     virtual butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                                  std::vector<pb::common::KeyValue>& kvs) = 0;
     virtual butil::Status KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
@@ -77,6 +83,14 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
         const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_put_with_cfs,
         const std::map<std::string, std::vector<std::string>>& kv_delete_with_cfs) = 0;
 
+    // Write data applied by raft, which can be recovered by replaying raft log from the persisted applied index,
+    // so the engine may skip its own wal.
+    virtual butil::Status KvBatchPutAndDeleteApplied(
+        const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_put_with_cfs,
+        const std::map<std::string, std::vector<std::string>>& kv_delete_with_cfs) {
+      return KvBatchPutAndDelete(kv_put_with_cfs, kv_delete_with_cfs);
+    }
+
     virtual butil::Status KvDeleteRange(const std::string& cf_name, const pb::common::Range& range) = 0;
     virtual butil::Status KvBatchDeleteRange(
         const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs) = 0;
@@ -105,6 +119,12 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
                                  std::vector<pb::store_internal::SstFileInfo>& /*sst_files*/) {
       return butil::Status(pb::error::ENOT_SUPPORT, "Not support checkpoint.");
     }
+    // Only link the live sst files overlap with range, not checkpoint the whole db.
+    virtual butil::Status Create(const std::string& /*dirpath*/, const std::vector<std::string>& /*cf_names*/,
+                                 const pb::common::Range& /*range*/,
+                                 std::vector<pb::store_internal::SstFileInfo>& /*sst_files*/) {
+      return butil::Status(pb::error::ENOT_SUPPORT, "Not support range checkpoint.");
+    }
   };
   using CheckpointPtr = std::shared_ptr<Checkpoint>;
 
@@ -127,12 +147,72 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
                                              const std::vector<std::string>& cf_names,
                                              std::vector<std::string>& merge_sst_paths) = 0;
   virtual butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files) = 0;
+  // Get the smallest and largest key of a external sst file, for checking before ingest.
+  virtual butil::Status GetExternalFileKeyRange(const std::string& /*file*/, std::string& /*smallest_key*/,
+                                                std::string& /*largest_key*/) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support get external file key range");
+  }
 
   virtual std::vector<int64_t> GetApproximateSizes(const std::string& cf_name,
                                                    std::vector<pb::common::Range>& ranges) = 0;
+  // Estimate key count of range by sst table properties and memtable stats, no data is read.
+  // Deleted and overwritten keys not compacted yet are counted too.
+  virtual butil::Status GetApproximateKeyCount(const std::string& /*cf_name*/, const pb::common::Range& /*range*/,
+                                               int64_t& /*count*/) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support get approximate key count");
+  }
+  // Entries and tombstones of range in sst files, estimated by table properties, no data is read.
+  struct DeletionStats {
+    int64_t entry_count{0};
+    // Point tombstones, include tombstones of deleted versions.
+    int64_t deletion_count{0};
+    int64_t range_deletion_count{0};
+    // Approximate bytes of range in sst files.
+    int64_t size{0};
+  };
+  virtual butil::Status GetApproximateDeletionStats(const std::string& /*cf_name*/,
+                                                    const pb::common::Range& /*range*/, DeletionStats& /*stats*/) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support get approximate deletion stats");
+  }
+  // Get the boundary keys of the live sst files inside range, sorted and unique, no data is read.
+  virtual butil::Status GetSstFileBoundaryKeys(const std::string& /*cf_name*/, const pb::common::Range& /*range*/,
+                                               std::vector<std::string>& /*keys*/) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support get sst file boundary keys");
+  }
+  // Memory of all memtables and block cache, for memory accounting.
+  virtual void GetMemoryUsage(int64_t& /*memtable_bytes*/, int64_t& /*block_cache_bytes*/) {}
+  // Change the block cache capacity of every column family at runtime.
+  virtual butil::Status SetBlockCacheCapacity(int64_t /*capacity_bytes*/) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support set block cache capacity");
+  }
+
+  // Compaction debt and write stall of a column family, limits are the engine thresholds of slowing or stopping writes.
+  struct CompactionStats {
+    std::string cf_name;
+    int64_t pending_compaction_bytes{0};
+    int64_t soft_pending_compaction_bytes_limit{0};
+    int64_t hard_pending_compaction_bytes_limit{0};
+    int64_t l0_file_num{0};
+    int64_t l0_slowdown_writes_trigger{0};
+    int64_t l0_stop_writes_trigger{0};
+    // Cumulative time of writes delayed or stopped by the engine.
+    int64_t stall_micros{0};
+    bool is_write_stopped{false};
+  };
+  virtual std::vector<CompactionStats> GetCompactionStats() { return {}; }
 
   virtual void Flush(const std::string& cf_name) = 0;
+  // Flush all column families, make the data written without wal durable.
+  virtual void FlushAll() {}
   virtual butil::Status Compact(const std::string& cf_name) = 0;
+  // Drop the files whose keys are all inside range, no tombstone is written, keys of other files are kept.
+  virtual butil::Status DeleteFilesInRange(const std::string& /*cf_name*/, const pb::common::Range& /*range*/) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support delete files in range");
+  }
+  // Compact range to reclaim deleted data and tombstones of it.
+  virtual butil::Status CompactRange(const std::string& /*cf_name*/, const pb::common::Range& /*range*/) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support compact range");
+  }
 
  protected:
   RawEngine() = default;
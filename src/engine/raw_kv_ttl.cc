@@ -0,0 +1,130 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/raw_kv_ttl.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bvar/reducer.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_raw_kv_ttl, false,
+            "enable ttl of client raw kv, it changes the value format and must be set before writing client raw kv");
+
+bvar::Adder<int64_t> g_raw_kv_ttl_compaction_filter_count("dingo_raw_kv_ttl_compaction_filter_count");
+
+bool RawKvTtl::IsEnabled() { return FLAGS_enable_raw_kv_ttl; }
+
+bool RawKvTtl::IsEnabled(const std::string& cf_name, const std::string& key) {
+  return FLAGS_enable_raw_kv_ttl && !key.empty() && Helper::IsClientRaw(key) && cf_name == Constant::kStoreDataCF;
+}
+
+void RawKvTtl::EncodeValue(int64_t ttl_ms, std::string& value) {
+  EncodeValueWithExpireTs(ttl_ms > 0 ? Helper::TimestampMs() + ttl_ms : 0, value);
+}
+
+void RawKvTtl::EncodeValueWithExpireTs(int64_t expire_ms, std::string& value) {
+  // empty value means delete for compare and set, keep it.
+  if (value.empty()) {
+    return;
+  }
+
+  char header[kHeaderSize];
+  uint64_t expire = static_cast<uint64_t>(expire_ms);
+  for (int i = kHeaderSize - 1; i >= 0; --i) {
+    header[i] = static_cast<char>(expire & 0xff);
+    expire >>= 8;
+  }
+  value.insert(0, header, kHeaderSize);
+}
+
+int64_t RawKvTtl::GetExpireTs(std::string_view value) {
+  if (value.size() < kHeaderSize) {
+    return 0;
+  }
+
+  uint64_t expire = 0;
+  for (size_t i = 0; i < kHeaderSize; ++i) {
+    expire = (expire << 8) | static_cast<uint8_t>(value[i]);
+  }
+  return static_cast<int64_t>(expire);
+}
+
+bool RawKvTtl::DecodeValue(std::string_view value, int64_t now_ms, std::string_view& user_value) {
+  if (value.size() < kHeaderSize) {
+    user_value = value;
+    return true;
+  }
+
+  int64_t expire_ms = GetExpireTs(value);
+  if (expire_ms > 0 && expire_ms <= now_ms) {
+    return false;
+  }
+
+  user_value = value.substr(kHeaderSize);
+  return true;
+}
+
+void RawKvTtl::DecodeKvs(std::vector<pb::common::KeyValue>& kvs) {
+  int64_t now_ms = Helper::TimestampMs();
+  size_t count = 0;
+  for (auto& kv : kvs) {
+    std::string_view user_value;
+    if (!DecodeValue(kv.value(), now_ms, user_value)) {
+      continue;
+    }
+    if (user_value.size() != kv.value().size()) {
+      kv.mutable_value()->erase(0, kHeaderSize);
+    }
+    if (&kv != &kvs[count]) {
+      kvs[count] = std::move(kv);
+    }
+    ++count;
+  }
+  kvs.resize(count);
+}
+
+bool RawKvTtlCompactionFilter::Filter(int /*level*/, const rocksdb::Slice& key, const rocksdb::Slice& existing_value,
+                                      std::string* /*new_value*/, bool* /*value_changed*/) const {
+  if (key.empty() || key[0] != Constant::kClientRaw) {
+    return false;
+  }
+
+  int64_t expire_ms = RawKvTtl::GetExpireTs(std::string_view(existing_value.data(), existing_value.size()));
+  if (expire_ms > 0 && expire_ms <= now_ms_) {
+    g_raw_kv_ttl_compaction_filter_count << 1;
+    return true;
+  }
+
+  return false;
+}
+
+std::unique_ptr<rocksdb::CompactionFilter> RawKvTtlCompactionFilterFactory::CreateCompactionFilter(
+    const rocksdb::CompactionFilter::Context& /*context*/) {
+  if (!RawKvTtl::IsEnabled()) {
+    return nullptr;
+  }
+
+  return std::make_unique<RawKvTtlCompactionFilter>(Helper::TimestampMs());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,83 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_RAW_KV_TTL_H_  // NOLINT
+#define DINGODB_ENGINE_RAW_KV_TTL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "proto/common.pb.h"
+#include "rocksdb/compaction_filter.h"
+
+namespace dingodb {
+
+// Per key ttl of client raw kv.
+// When enabled, every non-empty value of client raw kv in store data cf has a header of expire time:
+//   | expire_ms(8 bytes, big endian, 0 is never expire) | value |
+// The expire time is fixed by leader before raft, expired kvs are hidden on read and dropped by the compaction
+// filter of every replica, no delete raft log is generated.
+// The value format is changed by the flag, it must be set on all stores before any client raw kv is written.
+class RawKvTtl {
+ public:
+  static constexpr size_t kHeaderSize = 8;
+
+  static bool IsEnabled();
+  static bool IsEnabled(const std::string& cf_name, const std::string& key);
+
+  // Prepend the header to value, ttl_ms <= 0 is never expire, empty value is not changed.
+  static void EncodeValue(int64_t ttl_ms, std::string& value);
+  static void EncodeValueWithExpireTs(int64_t expire_ms, std::string& value);
+
+  // Return false if value is expired, otherwise user_value is the value without header.
+  static bool DecodeValue(std::string_view value, int64_t now_ms, std::string_view& user_value);
+  static int64_t GetExpireTs(std::string_view value);
+
+  // Strip the headers and remove the expired kvs.
+  static void DecodeKvs(std::vector<pb::common::KeyValue>& kvs);
+};
+
+// Drop the expired client raw kvs of store data cf during compaction.
+class RawKvTtlCompactionFilter : public rocksdb::CompactionFilter {
+ public:
+  explicit RawKvTtlCompactionFilter(int64_t now_ms) : now_ms_(now_ms) {}
+  ~RawKvTtlCompactionFilter() override = default;
+
+  bool Filter(int level, const rocksdb::Slice& key, const rocksdb::Slice& existing_value, std::string* new_value,
+              bool* value_changed) const override;
+
+  const char* Name() const override { return "dingodb.RawKvTtlCompactionFilter"; }
+
+ private:
+  int64_t now_ms_;
+};
+
+class RawKvTtlCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
+ public:
+  RawKvTtlCompactionFilterFactory() = default;
+  ~RawKvTtlCompactionFilterFactory() override = default;
+
+  std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
+      const rocksdb::CompactionFilter::Context& context) override;
+
+  const char* Name() const override { return "dingodb.RawKvTtlCompactionFilterFactory"; }
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_RAW_KV_TTL_H_  // NOLINT
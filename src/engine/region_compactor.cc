@@ -0,0 +1,238 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/region_compactor.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/helper.h"
+#include "common/logging.h"
+#include "engine/write_throttler.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "server/server.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_region_tombstone_compaction, false, "compact the range of region when its tombstones are dense");
+DEFINE_int64(region_compaction_check_interval_s, 60, "interval of checking tombstone density of regions");
+DEFINE_double(region_compaction_tombstone_ratio, 0.3, "compact region when tombstones / entries reach the ratio");
+DEFINE_int64(region_compaction_min_tombstone_num, 50000, "compact region only when it has more tombstones");
+DEFINE_int64(region_compaction_cooldown_s, 600, "min interval of compacting the same region");
+DEFINE_int64(region_compaction_max_bytes_per_check, 4L * 1024 * 1024 * 1024,
+             "max approximate bytes of regions queued for compaction by one check");
+DEFINE_int64(region_compaction_max_bytes_per_s, 32L * 1024 * 1024, "rate limit of region compaction, 0 is no limit");
+DEFINE_uint32(region_compaction_worker_num, 1, "worker num of region compaction");
+
+class RegionCompactTask : public TaskRunnable {
+ public:
+  using Handler = std::function<void()>;
+  explicit RegionCompactTask(Handler handler) : handler_(std::move(handler)) {}
+  ~RegionCompactTask() override = default;
+
+  std::string Type() override { return "REGION_COMPACT"; }
+
+  void Run() override { handler_(); }
+
+ private:
+  Handler handler_;
+};
+
+RegionCompactor::RegionCompactor()
+    : bvar_compact_count_("dingo_region_tombstone_compaction_count"),
+      bvar_compact_bytes_("dingo_region_tombstone_compaction_bytes") {}
+
+RegionCompactor& RegionCompactor::GetInstance() {
+  static RegionCompactor instance;
+  return instance;
+}
+
+bool RegionCompactor::Init() {
+  // Compaction blocks the worker for long, always use pthread.
+  worker_set_ = PriorWorkerSet::New("region_compact", FLAGS_region_compaction_worker_num, 0, true);
+  return worker_set_->Init();
+}
+
+void RegionCompactor::Destroy() {
+  if (worker_set_ != nullptr) {
+    worker_set_->Destroy();
+  }
+}
+
+void RegionCompactor::CheckHandler(void*) {
+  if (!FLAGS_enable_region_tombstone_compaction) {
+    return;
+  }
+
+  GetInstance().Check(Server::GetInstance().GetAllAliveRegion());
+}
+
+bool RegionCompactor::NeedCompact(const RawEngine::DeletionStats& stats, double tombstone_ratio,
+                                  int64_t min_tombstone_num) {
+  // Range tombstone makes every key of range a tombstone for scan.
+  if (stats.range_deletion_count > 0 && stats.entry_count > 0) {
+    return true;
+  }
+  if (stats.entry_count <= 0 || stats.deletion_count < min_tombstone_num) {
+    return false;
+  }
+
+  return static_cast<double>(stats.deletion_count) / stats.entry_count >= tombstone_ratio;
+}
+
+void RegionCompactor::Check(const std::vector<store::RegionPtr>& regions) {
+  if (worker_set_ == nullptr) {
+    return;
+  }
+
+  // Compaction debt is high, the engine compaction is already behind.
+  if (WriteThrottler::GetInstance().Pressure() > 0) {
+    DINGO_LOG(INFO) << fmt::format("[region_compact] skip check, write pressure {}",
+                                   WriteThrottler::GetInstance().Pressure());
+    return;
+  }
+
+  int64_t now_ms = Helper::TimestampMs();
+  int64_t budget_bytes = FLAGS_region_compaction_max_bytes_per_check;
+  for (const auto& region : regions) {
+    if (budget_bytes <= 0) {
+      break;
+    }
+    if (region->State() != pb::common::StoreRegionState::NORMAL) {
+      continue;
+    }
+
+    int64_t region_id = region->Id();
+    {
+      BAIDU_SCOPED_LOCK(mutex_);
+      if (pending_region_ids_.count(region_id) > 0) {
+        continue;
+      }
+      auto it = last_compact_time_ms_.find(region_id);
+      if (it != last_compact_time_ms_.end() && now_ms - it->second < FLAGS_region_compaction_cooldown_s * 1000) {
+        continue;
+      }
+    }
+
+    auto raw_engine = Server::GetInstance().GetRawEngine(region->GetRawEngineType());
+    auto range = region->Range();
+    if (raw_engine == nullptr || Helper::InvalidRange(range)) {
+      continue;
+    }
+
+    std::vector<CfRange> cf_ranges;
+    std::vector<std::string> raw_cf_names;
+    std::vector<std::string> txn_cf_names;
+    Helper::GetColumnFamilyNames(range.start_key(), raw_cf_names, txn_cf_names);
+    for (const auto& cf_name : raw_cf_names) {
+      cf_ranges.emplace_back(cf_name, range);
+    }
+    if (!txn_cf_names.empty()) {
+      auto txn_range = Helper::GetMemComparableRange(range);
+      for (const auto& cf_name : txn_cf_names) {
+        cf_ranges.emplace_back(cf_name, txn_range);
+      }
+    }
+
+    // Only compact the column families full of tombstones.
+    std::vector<CfRange> compact_cf_ranges;
+    int64_t size = 0;
+    for (const auto& [cf_name, cf_range] : cf_ranges) {
+      RawEngine::DeletionStats stats;
+      auto status = raw_engine->GetApproximateDeletionStats(cf_name, cf_range, stats);
+      if (!status.ok()) {
+        continue;
+      }
+
+      if (NeedCompact(stats, FLAGS_region_compaction_tombstone_ratio, FLAGS_region_compaction_min_tombstone_num)) {
+        DINGO_LOG(INFO) << fmt::format(
+            "[region_compact][region({})] tombstones are dense, cf: {} entries: {} deletions: {} "
+            "range_deletions: {} size: {}",
+            region_id, cf_name, stats.entry_count, stats.deletion_count, stats.range_deletion_count, stats.size);
+        compact_cf_ranges.emplace_back(cf_name, cf_range);
+        size += stats.size;
+      }
+    }
+    if (compact_cf_ranges.empty()) {
+      continue;
+    }
+
+    {
+      BAIDU_SCOPED_LOCK(mutex_);
+      pending_region_ids_.insert(region_id);
+    }
+    auto task = std::make_shared<RegionCompactTask>([this, raw_engine, region_id, compact_cf_ranges, size]() {
+      Compact(raw_engine, region_id, compact_cf_ranges, size);
+    });
+    task->SetLane(TaskLane::kBackground);
+    if (!worker_set_->Execute(task)) {
+      BAIDU_SCOPED_LOCK(mutex_);
+      pending_region_ids_.erase(region_id);
+      continue;
+    }
+    budget_bytes -= size;
+  }
+
+  // Drop the cooldown of regions compacted long ago, e.g. deleted or moved regions.
+  BAIDU_SCOPED_LOCK(mutex_);
+  for (auto it = last_compact_time_ms_.begin(); it != last_compact_time_ms_.end();) {
+    if (now_ms - it->second >= FLAGS_region_compaction_cooldown_s * 1000) {
+      it = last_compact_time_ms_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void RegionCompactor::Compact(RawEnginePtr raw_engine, int64_t region_id, const std::vector<CfRange>& cf_ranges,
+                              int64_t size) {
+  int64_t start_time = Helper::TimestampMs();
+  for (const auto& [cf_name, range] : cf_ranges) {
+    auto status = raw_engine->CompactRange(cf_name, range);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[region_compact][region({})] compact range failed, cf: {} error: {}",
+                                        region_id, cf_name, status.error_str());
+    }
+  }
+  int64_t elapsed_ms = Helper::TimestampMs() - start_time;
+
+  bvar_compact_count_ << 1;
+  bvar_compact_bytes_ << size;
+  DINGO_LOG(INFO) << fmt::format("[region_compact][region({})] compact finish, size: {} elapsed time {}ms", region_id,
+                                 size, elapsed_ms);
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    pending_region_ids_.erase(region_id);
+    last_compact_time_ms_[region_id] = Helper::TimestampMs();
+  }
+
+  // Compaction rewrites about size bytes, wait the next one to keep the average byte rate.
+  if (FLAGS_region_compaction_max_bytes_per_s > 0) {
+    int64_t expect_ms = size * 1000 / FLAGS_region_compaction_max_bytes_per_s;
+    if (expect_ms > elapsed_ms) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(expect_ms - elapsed_ms));
+    }
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,73 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_REGION_COMPACTOR_H_  // NOLINT
+#define DINGODB_ENGINE_REGION_COMPACTOR_H_
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bvar/reducer.h"
+#include "common/runnable.h"
+#include "engine/raw_engine.h"
+#include "meta/store_meta_manager.h"
+
+namespace dingodb {
+
+// Compact the range of one region when it is full of tombstones, e.g. after range delete or gc of old versions.
+// Scans skip the tombstones one by one until the global compaction reaches them, the region compaction cleans
+// them earlier without compacting the whole column family.
+// The tombstone density is estimated by the sst table properties of the region range, the compactions run on a
+// low priority pthread pool, limited by region_compaction_max_bytes_per_s and paused when compaction debt is high.
+class RegionCompactor {
+ public:
+  using CfRange = std::pair<std::string, pb::common::Range>;
+
+  static RegionCompactor& GetInstance();
+
+  bool Init();
+  void Destroy();
+
+  // Check the tombstone density of alive regions, called by crontab.
+  static void CheckHandler(void*);
+  void Check(const std::vector<store::RegionPtr>& regions);
+
+  static bool NeedCompact(const RawEngine::DeletionStats& stats, double tombstone_ratio, int64_t min_tombstone_num);
+
+ private:
+  RegionCompactor();
+
+  // Compact ranges of region, sleep after it to keep the compaction in byte rate limit.
+  void Compact(RawEnginePtr raw_engine, int64_t region_id, const std::vector<CfRange>& cf_ranges, int64_t size);
+
+  PriorWorkerSetPtr worker_set_;
+
+  bthread::Mutex mutex_;
+  // regions queued or running
+  std::set<int64_t> pending_region_ids_;
+  // region_id -> finish time of last compaction, the region is not compacted again within cooldown
+  std::map<int64_t, int64_t> last_compact_time_ms_;
+
+  bvar::Adder<int64_t> bvar_compact_count_;
+  bvar::Adder<int64_t> bvar_compact_bytes_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_REGION_COMPACTOR_H_  // NOLINT
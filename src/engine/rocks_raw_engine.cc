@@ -16,12 +16,17 @@
 
 #include <elf.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <exception>
+#include <fstream>
+#include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -36,8 +41,10 @@
 #include "common/logging.h"
 #include "config/config_helper.h"
 #include "engine/raw_engine.h"
+#include "engine/raw_kv_ttl.h"
 #include "engine/snapshot.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "rocksdb/advanced_options.h"
@@ -45,11 +52,27 @@
 #include "rocksdb/db.h"
 #include "rocksdb/filter_policy.h"
 #include "rocksdb/iterator.h"
+#include "rocksdb/slice_transform.h"
+#include "rocksdb/sst_file_reader.h"
+#include "rocksdb/statistics.h"
 #include "rocksdb/table.h"
+#include "rocksdb/table_properties.h"
 #include "rocksdb/write_batch.h"
 
 namespace dingodb {
 
+DEFINE_bool(rocks_multi_get_async_io, false, "rocksdb multi get use async io");
+DEFINE_bool(rocks_use_direct_io_for_flush_and_compaction, false,
+            "rocksdb flush and compaction bypass page cache, avoid evicting hot pages of read and raft log");
+DEFINE_int64(rocks_compaction_readahead_size_kb, 2048, "rocksdb compaction readahead size, need by direct io");
+DEFINE_int64(rocks_row_cache_capacity_mb, 0,
+             "rocksdb row cache capacity of point lookup, it is shared by all column families, 0 is disable");
+DEFINE_int64(rocks_block_cache_capacity_mb, 0,
+             "change rocksdb block cache capacity of every column family at runtime, 0 is the config value");
+DEFINE_bool(raft_apply_disable_wal, false,
+            "write raft applied data without rocksdb wal, it is recovered by replaying raft log from the flushed "
+            "applied index, need atomic flush");
+
 namespace rocks {
 
 ColumnFamily::ColumnFamily(const std::string& cf_name, const ColumnFamilyConfig& config,
@@ -289,6 +312,158 @@ butil::Status Checkpoint::Create(const std::string& dirpath, const std::vector<s
   return butil::Status();
 }
 
+// Copy the first size bytes of file, the live manifest is still appended by rocksdb.
+static bool CopyFilePrefix(const std::string& src_path, const std::string& dst_path, uint64_t size) {
+  std::ifstream ifile(src_path, std::ifstream::in | std::ifstream::binary);
+  std::ofstream ofile(dst_path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+  if (!ifile.is_open() || !ofile.is_open()) {
+    return false;
+  }
+
+  std::vector<char> buf(64 * 1024);
+  while (size > 0) {
+    auto read_size = std::min(size, static_cast<uint64_t>(buf.size()));
+    if (!ifile.read(buf.data(), read_size)) {
+      return false;
+    }
+    ofile.write(buf.data(), read_size);
+    size -= read_size;
+  }
+
+  ofile.close();
+  return !ofile.fail();
+}
+
+// Range checkpoint, link the overlapped live sst files of cf_names into dirpath, and a copy of CURRENT/MANIFEST/OPTIONS.
+// The other files of db are never touched, so the cost is proportional to the range size not the db size.
+// The receiver should repair db and trim the keys out of range, same as the whole db checkpoint.
+butil::Status Checkpoint::Create(const std::string& dirpath, const std::vector<std::string>& cf_names,
+                                 const pb::common::Range& range,
+                                 std::vector<pb::store_internal::SstFileInfo>& sst_files) {
+  auto db = GetDB();
+  auto column_families = GetColumnFamilies(cf_names);
+
+  // Persist memtable of the range cf, as the whole db checkpoint does.
+  std::vector<rocksdb::ColumnFamilyHandle*> handles;
+  handles.reserve(column_families.size());
+  for (const auto& column_family : column_families) {
+    handles.push_back(column_family->GetHandle());
+  }
+  rocksdb::FlushOptions flush_options;
+  auto status = db->Flush(flush_options, handles);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] flush column family failed, error: {}.", status.ToString());
+    return butil::Status(status.code(), status.ToString());
+  }
+
+  auto ret = Helper::CreateDirectories(dirpath);
+  if (!ret.ok()) {
+    return ret;
+  }
+
+  status = db->DisableFileDeletions();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] disable file deletion failed, error: {}.", status.ToString());
+    return butil::Status(status.code(), status.ToString());
+  }
+
+  std::string db_path = GetRawEngine()->DbPath();
+  auto save_files = [&]() -> butil::Status {
+    // CURRENT/MANIFEST/OPTIONS, sst files are taken from column family meta.
+    std::vector<std::string> live_files;
+    uint64_t manifest_file_size = 0;
+    auto status = db->GetLiveFiles(live_files, &manifest_file_size, false);
+    if (!status.ok()) {
+      return butil::Status(status.code(), status.ToString());
+    }
+
+    for (int i = 0; i < column_families.size(); ++i) {
+      rocksdb::ColumnFamilyMetaData meta_data;
+      db->GetColumnFamilyMetaData(handles[i], &meta_data);
+
+      for (auto& level : meta_data.levels) {
+        for (const auto& file : level.files) {
+          if (file.smallestkey >= range.end_key() || range.start_key() > file.largestkey) {
+            continue;
+          }
+
+          std::string filepath = dirpath + file.name;
+          if (!Helper::Link(file.db_path + file.name, filepath)) {
+            return butil::Status(pb::error::EINTERNAL, "Link sst file %s failed", file.name.c_str());
+          }
+
+          pb::store_internal::SstFileInfo sst_file;
+          sst_file.set_level(level.level);
+          sst_file.set_name(file.name);
+          sst_file.set_path(filepath);
+          sst_file.set_start_key(file.smallestkey);
+          sst_file.set_end_key(file.largestkey);
+          sst_file.set_cf_name(column_families[i]->Name());
+
+          DINGO_LOG(DEBUG) << "range checkpoint add sst_file: " << sst_file.ShortDebugString();
+
+          sst_files.emplace_back(std::move(sst_file));
+        }
+      }
+    }
+
+    for (const auto& live_file : live_files) {
+      // live file name is like /MANIFEST-000005
+      std::string name = live_file.substr(1);
+      std::string filepath = dirpath + live_file;
+      if (name.find("MANIFEST") == 0) {
+        if (!CopyFilePrefix(db_path + live_file, filepath, manifest_file_size)) {
+          return butil::Status(pb::error::EINTERNAL, "Copy file %s failed", name.c_str());
+        }
+        std::ofstream current_file(dirpath + "/CURRENT", std::ofstream::out | std::ofstream::trunc);
+        current_file << name << "\n";
+        current_file.close();
+        if (current_file.fail()) {
+          return butil::Status(pb::error::EINTERNAL, "Write file CURRENT failed");
+        }
+      } else if (name.find("OPTIONS") == 0) {
+        if (!Helper::Link(db_path + live_file, filepath)) {
+          return butil::Status(pb::error::EINTERNAL, "Link file %s failed", name.c_str());
+        }
+      }
+    }
+
+    return butil::Status();
+  };
+
+  ret = save_files();
+
+  status = db->EnableFileDeletions(false);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] enable file deletion failed, error: {}.", status.ToString());
+    return butil::Status(status.code(), status.ToString());
+  }
+  if (!ret.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] create range checkpoint failed, error: {}.", ret.error_str());
+    return ret;
+  }
+
+  pb::store_internal::SstFileInfo sst_file;
+  sst_file.set_level(-1);
+  sst_file.set_name("CURRENT");
+  sst_file.set_path(dirpath + "/CURRENT");
+  sst_files.push_back(sst_file);
+
+  std::string manifest_name = Helper::FindFileInDirectory(dirpath, "MANIFEST");
+  sst_file.set_level(-1);
+  sst_file.set_name(manifest_name);
+  sst_file.set_path(dirpath + "/" + manifest_name);
+  sst_files.push_back(sst_file);
+
+  std::string options_name = Helper::FindFileInDirectory(dirpath, "OPTIONS");
+  sst_file.set_level(-1);
+  sst_file.set_name(options_name);
+  sst_file.set_path(dirpath + "/" + options_name);
+  sst_files.push_back(sst_file);
+
+  return butil::Status();
+}
+
 std::shared_ptr<RocksRawEngine> Reader::GetRawEngine() {
   auto raw_engine = raw_engine_.lock();
   if (raw_engine == nullptr) {
@@ -337,6 +512,79 @@ butil::Status Reader::KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr
   return butil::Status();
 }
 
+butil::Status Reader::KvBatchGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<pb::common::KeyValue>& kvs) {
+  return KvBatchGet(GetColumnFamily(cf_name), GetSnapshot(), keys, kvs);
+}
+
+butil::Status Reader::KvBatchGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) {
+  return KvBatchGet(GetColumnFamily(cf_name), snapshot, keys, kvs);
+}
+
+butil::Status Reader::KvBatchGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) {
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+  }
+
+  // MultiGet with sorted input can coalesce index/filter block probes of adjacent keys.
+  std::vector<size_t> indexes(keys.size());
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    indexes[i] = i;
+  }
+  std::sort(indexes.begin(), indexes.end(), [&keys](size_t lhs, size_t rhs) { return keys[lhs] < keys[rhs]; });
+
+  std::vector<rocksdb::Slice> key_slices;
+  key_slices.reserve(keys.size());
+  for (auto index : indexes) {
+    key_slices.emplace_back(keys[index]);
+  }
+
+  std::vector<rocksdb::PinnableSlice> values(keys.size());
+  std::vector<rocksdb::Status> statuses(keys.size());
+
+  rocksdb::ReadOptions read_option;
+  read_option.snapshot = static_cast<const rocksdb::Snapshot*>(snapshot->Inner());
+  read_option.async_io = FLAGS_rocks_multi_get_async_io;
+  GetDB()->MultiGet(read_option, column_family->GetHandle(), key_slices.size(), key_slices.data(), values.data(),
+                    statuses.data(), true);
+
+  // Restore the origin order of keys.
+  std::vector<int> positions(keys.size(), -1);
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    const auto& s = statuses[i];
+    if (s.ok()) {
+      positions[indexes[i]] = i;
+    } else if (!s.IsNotFound()) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] multi get key failed, error: {}", s.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Internal multi get error");
+    }
+  }
+
+  kvs.reserve(kvs.size() + keys.size());
+  for (size_t i = 0; i < positions.size(); ++i) {
+    if (positions[i] < 0) {
+      continue;
+    }
+
+    const auto& value = values[positions[i]];
+    pb::common::KeyValue kv;
+    kv.set_key(keys[i]);
+    kv.set_value(value.data(), value.size());
+    kvs.push_back(std::move(kv));
+  }
+
+  return butil::Status();
+}
+
 butil::Status Reader::KvScan(ColumnFamilyPtr column_family, std::shared_ptr<dingodb::Snapshot> snapshot,
                              const std::string& start_key, const std::string& end_key,
                              std::vector<pb::common::KeyValue>& kvs) {
@@ -394,6 +642,10 @@ butil::Status Reader::KvCount(ColumnFamilyPtr column_family, dingodb::SnapshotPt
   rocksdb::ReadOptions read_options;
   read_options.auto_prefix_mode = true;
   read_options.snapshot = static_cast<const rocksdb::Snapshot*>(snapshot->Inner());
+#if defined(DINGO_ROCKSDB_LAZY_VALUE)
+  // only count keys, never read blob files
+  read_options.allow_unprepared_value = true;
+#endif
 
   std::string_view end_key_view(end_key.data(), end_key.size());
   rocksdb::Iterator* it = GetDB()->NewIterator(read_options, column_family->GetHandle());
@@ -424,6 +676,17 @@ dingodb::IteratorPtr Reader::NewIterator(ColumnFamilyPtr column_family, dingodb:
     read_options.snapshot = static_cast<const rocksdb::Snapshot*>(snapshot->Inner());
   }
   read_options.auto_prefix_mode = true;
+  if (options.prefix_seek &&
+      column_family->GetConfItem(Constant::kPrefixExtractor) == Constant::kPrefixExtractorTxnUserKey) {
+    read_options.auto_prefix_mode = false;
+    read_options.prefix_same_as_start = true;
+  }
+#if defined(DINGO_ROCKSDB_LAZY_VALUE)
+  read_options.allow_unprepared_value = options.lazy_value;
+#endif
+  if (options.readahead_size > 0) {
+    read_options.readahead_size = options.readahead_size;
+  }
 
   return std::make_shared<Iterator>(options, GetDB()->NewIterator(read_options, column_family->GetHandle()), snapshot);
 }
@@ -518,7 +781,24 @@ butil::Status Writer::KvBatchPutAndDelete(const std::string& cf_name,
 butil::Status Writer::KvBatchPutAndDelete(
     const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
     const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) {
-  DINGO_LOG(INFO) << fmt::format("[rocksdb] KvBatchPutAndDelete put kv size: {} delete kv size: {}",
+  return DoKvBatchPutAndDelete(kv_puts_with_cf, kv_deletes_with_cf, rocksdb::WriteOptions());
+}
+
+// The raft log is already durable, the data and the applied index in the same batch are persisted together
+// by atomic flush, and the data after the flushed applied index is recovered by replaying raft log.
+butil::Status Writer::KvBatchPutAndDeleteApplied(
+    const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
+    const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) {
+  rocksdb::WriteOptions write_options;
+  write_options.disableWAL = FLAGS_raft_apply_disable_wal;
+  return DoKvBatchPutAndDelete(kv_puts_with_cf, kv_deletes_with_cf, write_options);
+}
+
+butil::Status Writer::DoKvBatchPutAndDelete(
+    const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
+    const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf,
+    const rocksdb::WriteOptions& write_options) {
+  DINGO_LOG(DEBUG) << fmt::format("[rocksdb] KvBatchPutAndDelete put kv size: {} delete kv size: {}",
                                  kv_puts_with_cf.size(), kv_deletes_with_cf.size());
 
   rocksdb::WriteBatch batch;
@@ -564,7 +844,6 @@ butil::Status Writer::KvBatchPutAndDelete(
     }
   }
 
-  rocksdb::WriteOptions write_options;
   rocksdb::Status s = GetDB()->Write(write_options, &batch);
   if (!s.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] write failed, error: {}", s.ToString());
@@ -644,6 +923,40 @@ butil::Status Writer::KvBatchDeleteRange(const std::map<std::string, std::vector
   return butil::Status();
 }
 
+void WriteStallListener::OnStallConditionsChanged(const rocksdb::WriteStallInfo& info) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& state = stall_states_[info.cf_name];
+  int64_t now_us = Helper::TimestampUs();
+  if (state.condition != rocksdb::WriteStallCondition::kNormal) {
+    state.stall_micros += now_us - state.stall_start_us;
+  }
+  state.condition = info.condition.cur;
+  state.stall_start_us = now_us;
+
+  DINGO_LOG(WARNING) << fmt::format("[rocksdb] cf({}) write stall condition changed {} -> {}", info.cf_name,
+                                    static_cast<int>(info.condition.prev), static_cast<int>(info.condition.cur));
+}
+
+int64_t WriteStallListener::StallMicros(const std::string& cf_name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = stall_states_.find(cf_name);
+  if (it == stall_states_.end()) {
+    return 0;
+  }
+
+  const auto& state = it->second;
+  if (state.condition == rocksdb::WriteStallCondition::kNormal) {
+    return state.stall_micros;
+  }
+  return state.stall_micros + Helper::TimestampUs() - state.stall_start_us;
+}
+
+bool WriteStallListener::IsWriteStopped(const std::string& cf_name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = stall_states_.find(cf_name);
+  return it != stall_states_.end() && it->second.condition == rocksdb::WriteStallCondition::kStopped;
+}
+
 }  // namespace rocks
 
 RocksRawEngine::RocksRawEngine() : db_(nullptr), column_families_({}) {}
@@ -663,6 +976,20 @@ static rocks::ColumnFamilyMap GenColumnFamilyByDefaultConfig(const std::vector<s
   default_config.emplace(Constant::kMaxBytesForLevelBase, Constant::kMaxBytesForLevelBaseDefaultValue);
   default_config.emplace(Constant::kTargetFileSizeBase, Constant::kTargetFileSizeBaseDefaultValue);
   default_config.emplace(Constant::kMaxBytesForLevelMultiplier, Constant::kMaxBytesForLevelMultiplierDefaultValue);
+  default_config.emplace(Constant::kBlockCacheType, Constant::kBlockCacheTypeDefaultValue);
+  default_config.emplace(Constant::kFilterPolicy, Constant::kFilterPolicyDefaultValue);
+  default_config.emplace(Constant::kFilterBitsPerKey, Constant::kFilterBitsPerKeyDefaultValue);
+  default_config.emplace(Constant::kWholeKeyFiltering, Constant::kWholeKeyFilteringDefaultValue);
+  default_config.emplace(Constant::kPartitionedIndexFilter, Constant::kPartitionedIndexFilterDefaultValue);
+  default_config.emplace(Constant::kPinIndexFilterInCache, Constant::kPinIndexFilterInCacheDefaultValue);
+  default_config.emplace(Constant::kEnableBlobFiles, Constant::kEnableBlobFilesDefaultValue);
+  default_config.emplace(Constant::kMinBlobSize, Constant::kMinBlobSizeDefaultValue);
+  default_config.emplace(Constant::kBlobFileSize, Constant::kBlobFileSizeDefaultValue);
+  default_config.emplace(Constant::kEnableBlobGarbageCollection, Constant::kEnableBlobGarbageCollectionDefaultValue);
+  default_config.emplace(Constant::kColdPath, Constant::kColdPathDefaultValue);
+  default_config.emplace(Constant::kHotPathTargetSize, Constant::kHotPathTargetSizeDefaultValue);
+  default_config.emplace(Constant::kCompressionType, Constant::kCompressionTypeDefaultValue);
+  default_config.emplace(Constant::kZstdMaxDictBytes, Constant::kZstdMaxDictBytesDefaultValue);
 
   rocks::ColumnFamilyMap column_families;
   for (const auto& cf_name : column_family_names) {
@@ -702,6 +1029,19 @@ static void SetColumnFamilyCustomConfig(const std::shared_ptr<Config>& config,
   }
 }
 
+// Prefix of txn key is the padded user key, the last 8 bytes are ts.
+// The padded user key is prefix free, so keys of the same user key are adjacent.
+class TxnUserKeyTransform : public rocksdb::SliceTransform {
+ public:
+  const char* Name() const override { return "dingodb.TxnUserKey"; }
+
+  rocksdb::Slice Transform(const rocksdb::Slice& src) const override {
+    return rocksdb::Slice(src.data(), src.size() - 8);
+  }
+
+  bool InDomain(const rocksdb::Slice& src) const override { return src.size() > 8; }
+};
+
 template <typename T>
 static bool CastValue(std::string value, T& dst_value) {
   if (value.empty()) {
@@ -760,7 +1100,17 @@ static rocksdb::ColumnFamilyOptions GenRocksDBColumnFamilyOptions(rocks::ColumnF
     size_t option_value = 0;
     CastValue(column_family->GetConfItem(Constant::kBlockCache), option_value);
 
-    table_options.block_cache = rocksdb::NewLRUCache(option_value);  // LRUcache
+    std::string cache_type;
+    CastValue(column_family->GetConfItem(Constant::kBlockCacheType), cache_type);
+    if (cache_type == "hyper_clock") {
+      // estimated_entry_charge 0 means auto tune by block size.
+      table_options.block_cache = rocksdb::HyperClockCacheOptions(option_value, 0).MakeSharedCache();
+    } else {
+      if (cache_type != "lru") {
+        DINGO_LOG(WARNING) << fmt::format("[rocksdb] unknown block cache type {}, use lru.", cache_type);
+      }
+      table_options.block_cache = rocksdb::NewLRUCache(option_value);  // LRUcache
+    }
   }
 
   // arena_block_size
@@ -784,7 +1134,9 @@ static rocksdb::ColumnFamilyOptions GenRocksDBColumnFamilyOptions(rocks::ColumnF
             family_options.max_bytes_for_level_multiplier);
 
   // prefix_extractor
-  {
+  if (column_family->GetConfItem(Constant::kPrefixExtractor) == Constant::kPrefixExtractorTxnUserKey) {
+    family_options.prefix_extractor = std::make_shared<TxnUserKeyTransform>();
+  } else {
     size_t value = 0;
     CastValue(column_family->GetConfItem(Constant::kPrefixExtractor), value);
 
@@ -797,15 +1149,101 @@ static rocksdb::ColumnFamilyOptions GenRocksDBColumnFamilyOptions(rocks::ColumnF
   // target_file_size_base
   CastValue(column_family->GetConfItem(Constant::kTargetFileSizeBase), family_options.target_file_size_base);
 
-  family_options.compression_per_level = {
-      rocksdb::CompressionType::kNoCompression,  rocksdb::CompressionType::kNoCompression,
-      rocksdb::CompressionType::kLZ4Compression, rocksdb::CompressionType::kLZ4Compression,
-      rocksdb::CompressionType::kLZ4Compression, rocksdb::CompressionType::kZSTD,
-      rocksdb::CompressionType::kZSTD,
-  };
+  // blob files, big values (e.g. vector data) are kept out of sst, scan keys without reading them
+  {
+    std::string enable_blob_files;
+    CastValue(column_family->GetConfItem(Constant::kEnableBlobFiles), enable_blob_files);
+    family_options.enable_blob_files = (enable_blob_files == "true");
+    if (family_options.enable_blob_files) {
+      size_t min_blob_size = 0;
+      CastValue(column_family->GetConfItem(Constant::kMinBlobSize), min_blob_size);
+      family_options.min_blob_size = min_blob_size;
+      size_t blob_file_size = 0;
+      CastValue(column_family->GetConfItem(Constant::kBlobFileSize), blob_file_size);
+      family_options.blob_file_size = blob_file_size;
+      family_options.blob_compression_type = rocksdb::CompressionType::kLZ4Compression;
+
+      std::string enable_gc;
+      CastValue(column_family->GetConfItem(Constant::kEnableBlobGarbageCollection), enable_gc);
+      family_options.enable_blob_garbage_collection = (enable_gc == "true");
+    }
+  }
 
-  table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10.0, false));
-  table_options.whole_key_filtering = true;
+  // compression
+  {
+    std::string compression_type;
+    CastValue(column_family->GetConfItem(Constant::kCompressionType), compression_type);
+    if (compression_type == "none") {
+      family_options.compression = rocksdb::CompressionType::kNoCompression;
+    } else if (compression_type == "lz4") {
+      family_options.compression = rocksdb::CompressionType::kLZ4Compression;
+    } else if (compression_type == "zstd") {
+      family_options.compression = rocksdb::CompressionType::kZSTD;
+      family_options.bottommost_compression = rocksdb::CompressionType::kZSTD;
+      uint32_t max_dict_bytes = 0;
+      CastValue(column_family->GetConfItem(Constant::kZstdMaxDictBytes), max_dict_bytes);
+      if (max_dict_bytes > 0) {
+        // Train the dictionary by samples of 100x dictionary size, only for bottommost level which is most data.
+        family_options.bottommost_compression_opts.max_dict_bytes = max_dict_bytes;
+        family_options.bottommost_compression_opts.zstd_max_train_bytes = max_dict_bytes * 100;
+        family_options.bottommost_compression_opts.enabled = true;
+      }
+    } else {
+      if (compression_type != "default") {
+        DINGO_LOG(WARNING) << fmt::format("[rocksdb] unknown compression type {}, use default.", compression_type);
+      }
+      family_options.compression_per_level = {
+          rocksdb::CompressionType::kNoCompression,  rocksdb::CompressionType::kNoCompression,
+          rocksdb::CompressionType::kLZ4Compression, rocksdb::CompressionType::kLZ4Compression,
+          rocksdb::CompressionType::kLZ4Compression, rocksdb::CompressionType::kZSTD,
+          rocksdb::CompressionType::kZSTD,
+      };
+    }
+  }
+
+  // filter_policy
+  {
+    std::string filter_policy;
+    CastValue(column_family->GetConfItem(Constant::kFilterPolicy), filter_policy);
+    double bits_per_key = 0;
+    CastValue(column_family->GetConfItem(Constant::kFilterBitsPerKey), bits_per_key);
+
+    if (filter_policy == "ribbon") {
+      table_options.filter_policy.reset(rocksdb::NewRibbonFilterPolicy(bits_per_key));
+    } else if (filter_policy == "bloom") {
+      table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(bits_per_key, false));
+    } else if (filter_policy != "none") {
+      DINGO_LOG(WARNING) << fmt::format("[rocksdb] unknown filter policy {}, use bloom.", filter_policy);
+      table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(bits_per_key, false));
+    }
+
+    std::string whole_key_filtering;
+    CastValue(column_family->GetConfItem(Constant::kWholeKeyFiltering), whole_key_filtering);
+    table_options.whole_key_filtering = (whole_key_filtering == "true");
+  }
+
+  // partitioned index and filter, index/filter blocks live in block cache
+  {
+    std::string partitioned;
+    CastValue(column_family->GetConfItem(Constant::kPartitionedIndexFilter), partitioned);
+    if (partitioned == "true") {
+      table_options.index_type = rocksdb::BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+      table_options.partition_filters = (table_options.filter_policy != nullptr);
+      table_options.cache_index_and_filter_blocks = true;
+      table_options.cache_index_and_filter_blocks_with_high_priority = true;
+      table_options.pin_top_level_index_and_filter = true;
+    }
+
+    std::string pin_in_cache;
+    CastValue(column_family->GetConfItem(Constant::kPinIndexFilterInCache), pin_in_cache);
+    if (pin_in_cache == "true") {
+      table_options.cache_index_and_filter_blocks = true;
+      table_options.cache_index_and_filter_blocks_with_high_priority = true;
+      table_options.metadata_cache_options.top_level_index_pinning = rocksdb::PinningTier::kAll;
+      table_options.metadata_cache_options.partition_pinning = rocksdb::PinningTier::kAll;
+      table_options.metadata_cache_options.unpartitioned_pinning = rocksdb::PinningTier::kAll;
+    }
+  }
 
   rocksdb::TableFactory* table_factory = NewBlockBasedTableFactory(table_options);
   family_options.table_factory.reset(table_factory);
@@ -813,12 +1251,59 @@ static rocksdb::ColumnFamilyOptions GenRocksDBColumnFamilyOptions(rocks::ColumnF
   return family_options;
 }
 
-static rocksdb::DB* InitDB(const std::string& db_path, rocks::ColumnFamilyMap& column_families) {
+// Tiered storage, the sst files of upper levels are placed on db_path, the lower levels on cold path.
+// Rocksdb put a level on the first path which has room for the estimated size of it and all levels above,
+// so the hot path target size decide how many levels are hot.
+// Note: level_compaction_dynamic_level_bytes is ignored by rocksdb when multiple paths are specified.
+static void SetColumnFamilyPaths(const std::string& db_path, rocks::ColumnFamilyPtr column_family,
+                                 rocksdb::ColumnFamilyOptions& family_options) {
+  std::string cold_path;
+  CastValue(column_family->GetConfItem(Constant::kColdPath), cold_path);
+  if (cold_path.empty()) {
+    return;
+  }
+
+  auto status = Helper::CreateDirectories(cold_path);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] create cold path {} failed, error: {}, disable tiered storage.",
+                                    cold_path, status.error_str());
+    return;
+  }
+
+  size_t hot_path_target_size = 0;
+  CastValue(column_family->GetConfItem(Constant::kHotPathTargetSize), hot_path_target_size);
+  if (hot_path_target_size == 0) {
+    // Same estimate as rocksdb, L0 is as big as L1, all levels except the last one are hot.
+    size_t level_size = family_options.max_bytes_for_level_base;
+    hot_path_target_size = level_size;
+    for (int level = 1; level < family_options.num_levels - 1; ++level) {
+      hot_path_target_size += level_size;
+      level_size = static_cast<size_t>(level_size * family_options.max_bytes_for_level_multiplier);
+    }
+  }
+
+  family_options.cf_paths.emplace_back(db_path, hot_path_target_size);
+  family_options.cf_paths.emplace_back(cold_path, std::numeric_limits<uint64_t>::max());
+
+  DINGO_LOG(INFO) << fmt::format("[rocksdb] column family {} tiered storage, hot path {} target size {}, cold path {}",
+                                 column_family->Name(), db_path, hot_path_target_size, cold_path);
+}
+
+static rocksdb::DB* InitDB(const std::string& db_path, rocks::ColumnFamilyMap& column_families,
+                           TxnGcCompactionFilterFactoryPtr gc_compaction_filter_factory,
+                           rocks::WriteStallListenerPtr write_stall_listener,
+                           std::shared_ptr<rocksdb::Cache> row_cache, std::shared_ptr<rocksdb::Statistics> statistics) {
   // Cast ColumnFamily to rocksdb::ColumnFamilyOptions
   std::vector<rocksdb::ColumnFamilyDescriptor> column_family_descs;
   for (auto [cf_name, column_family] : column_families) {
     column_family->Dump();
     rocksdb::ColumnFamilyOptions family_options = GenRocksDBColumnFamilyOptions(column_family);
+    SetColumnFamilyPaths(db_path, column_family, family_options);
+    if (cf_name == Constant::kTxnWriteCF) {
+      family_options.compaction_filter_factory = gc_compaction_filter_factory;
+    } else if (cf_name == Constant::kStoreDataCF) {
+      family_options.compaction_filter_factory = std::make_shared<RawKvTtlCompactionFilterFactory>();
+    }
     column_family_descs.push_back(rocksdb::ColumnFamilyDescriptor(cf_name, family_options));
   }
 
@@ -828,6 +1313,15 @@ static rocksdb::DB* InitDB(const std::string& db_path, rocks::ColumnFamilyMap& c
   db_options.max_background_jobs = ConfigHelper::GetRocksDBBackgroundThreadNum();
   db_options.max_subcompactions = db_options.max_background_jobs / 4 * 3;
   db_options.stats_dump_period_sec = ConfigHelper::GetRocksDBStatsDumpPeriodSec();
+  // Background io of flush and compaction is large and read once, direct io keep it out of page cache.
+  db_options.use_direct_io_for_flush_and_compaction = FLAGS_rocks_use_direct_io_for_flush_and_compaction;
+  db_options.compaction_readahead_size = FLAGS_rocks_compaction_readahead_size_kb * 1024;
+  // Without wal, all column families must be flushed together to keep the applied index consistent with the data.
+  db_options.atomic_flush = FLAGS_raft_apply_disable_wal;
+  db_options.listeners.push_back(write_stall_listener);
+  // Row cache serves Get/MultiGet by key, the cached rows are invalidated by rocksdb itself.
+  db_options.row_cache = row_cache;
+  db_options.statistics = statistics;
   DINGO_LOG(INFO) << fmt::format("[rocksdb] config max_background_jobs({}) max_subcompactions({})",
                                  db_options.max_background_jobs, db_options.max_subcompactions);
 
@@ -869,14 +1363,36 @@ bool RocksRawEngine::Init(std::shared_ptr<Config> config, const std::vector<std:
   auto column_families = GenColumnFamilyByDefaultConfig(cf_names);
   SetColumnFamilyCustomConfig(config, column_families);
 
-  rocksdb::DB* db = InitDB(db_path_, column_families);
+  gc_compaction_filter_factory_ = std::make_shared<TxnGcCompactionFilterFactory>();
+  write_stall_listener_ = std::make_shared<rocks::WriteStallListener>();
+  if (FLAGS_rocks_row_cache_capacity_mb > 0) {
+    row_cache_ = rocksdb::NewLRUCache(FLAGS_rocks_row_cache_capacity_mb * 1024 * 1024);
+    // Only for row cache hit ratio, tickers are cheap without histograms and timers.
+    statistics_ = rocksdb::CreateDBStatistics();
+    statistics_->set_stats_level(rocksdb::StatsLevel::kExceptHistogramOrTimers);
+    DINGO_LOG(INFO) << fmt::format("[rocksdb] enable row cache, capacity({}MB)", FLAGS_rocks_row_cache_capacity_mb);
+  }
+  rocksdb::DB* db =
+      InitDB(db_path_, column_families, gc_compaction_filter_factory_, write_stall_listener_, row_cache_, statistics_);
   if (db == nullptr) {
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] open failed, path: {}", db_path_);
     return false;
   }
+
+  if (row_cache_ != nullptr) {
+    row_cache_hit_ratio_ = std::make_unique<bvar::PassiveStatus<double>>(
+        "dingo_rocksdb_row_cache_hit_ratio", &RocksRawEngine::GetRowCacheHitRatio, statistics_.get());
+    row_cache_usage_ = std::make_unique<bvar::PassiveStatus<int64_t>>(
+        "dingo_rocksdb_row_cache_usage", &RocksRawEngine::GetRowCacheUsage, row_cache_.get());
+  }
   column_families_ = column_families;
   db_.reset(db);
 
+  auto data_cf_it = column_families_.find(Constant::kTxnDataCF);
+  if (data_cf_it != column_families_.end()) {
+    gc_compaction_filter_factory_->SetDB(db, data_cf_it->second->GetHandle());
+  }
+
   reader_ = std::make_shared<rocks::Reader>(GetSelfPtr());
   writer_ = std::make_shared<rocks::Writer>(GetSelfPtr());
 
@@ -885,6 +1401,17 @@ bool RocksRawEngine::Init(std::shared_ptr<Config> config, const std::vector<std:
   return true;
 }
 
+double RocksRawEngine::GetRowCacheHitRatio(void* arg) {
+  auto* statistics = static_cast<rocksdb::Statistics*>(arg);
+  uint64_t hit = statistics->getTickerCount(rocksdb::Tickers::ROW_CACHE_HIT);
+  uint64_t miss = statistics->getTickerCount(rocksdb::Tickers::ROW_CACHE_MISS);
+  return (hit + miss) == 0 ? 0.0 : static_cast<double>(hit) / (hit + miss);
+}
+
+int64_t RocksRawEngine::GetRowCacheUsage(void* arg) {
+  return static_cast<int64_t>(static_cast<rocksdb::Cache*>(arg)->GetUsage());
+}
+
 std::shared_ptr<RocksRawEngine> RocksRawEngine::GetSelfPtr() {
   return std::dynamic_pointer_cast<RocksRawEngine>(shared_from_this());
 }
@@ -1061,6 +1588,31 @@ butil::Status RocksRawEngine::IngestExternalFile(const std::string& cf_name, con
   return butil::Status();
 }
 
+butil::Status RocksRawEngine::GetExternalFileKeyRange(const std::string& file, std::string& smallest_key,
+                                                      std::string& largest_key) {
+  rocksdb::SstFileReader reader{rocksdb::Options()};
+  auto status = reader.Open(file);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] open external file {} failed, error: {}", file, status.ToString());
+    return butil::Status(pb::error::EINTERNAL, status.ToString());
+  }
+
+  std::unique_ptr<rocksdb::Iterator> iter(reader.NewIterator(rocksdb::ReadOptions()));
+  iter->SeekToFirst();
+  if (!iter->Valid()) {
+    return butil::Status(pb::error::EKEY_EMPTY, "External file is empty");
+  }
+  smallest_key = iter->key().ToString();
+
+  iter->SeekToLast();
+  if (!iter->Valid()) {
+    return butil::Status(pb::error::EINTERNAL, iter->status().ToString());
+  }
+  largest_key = iter->key().ToString();
+
+  return butil::Status();
+}
+
 void RocksRawEngine::Flush(const std::string& cf_name) {
   if (db_) {
     rocksdb::FlushOptions flush_options;
@@ -1068,6 +1620,21 @@ void RocksRawEngine::Flush(const std::string& cf_name) {
   }
 }
 
+void RocksRawEngine::FlushAll() {
+  if (db_) {
+    std::vector<rocksdb::ColumnFamilyHandle*> column_family_handles;
+    for (auto& [_, column_family] : column_families_) {
+      column_family_handles.push_back(column_family->GetHandle());
+    }
+
+    rocksdb::FlushOptions flush_options;
+    auto status = db_->Flush(flush_options, column_family_handles);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] flush all column families failed, error: {}", status.ToString());
+    }
+  }
+}
+
 butil::Status RocksRawEngine::Compact(const std::string& cf_name) {
   DINGO_LOG(INFO) << fmt::format("[rocksdb] compact column family {}", cf_name);
   if (db_ != nullptr) {
@@ -1084,11 +1651,53 @@ butil::Status RocksRawEngine::Compact(const std::string& cf_name) {
   return butil::Status();
 }
 
+butil::Status RocksRawEngine::DeleteFilesInRange(const std::string& cf_name, const pb::common::Range& range) {
+  auto column_family = GetColumnFamily(cf_name);
+  if (column_family == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Not found column family %s", cf_name.c_str());
+  }
+
+  rocksdb::Slice begin(range.start_key());
+  rocksdb::Slice end(range.end_key());
+  auto status = rocksdb::DeleteFilesInRange(db_.get(), column_family->GetHandle(), &begin, &end, false);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] delete files in range failed, column family {} error: {}", cf_name,
+                                    status.ToString());
+    return butil::Status(pb::error::EINTERNAL, "Delete files in range failed, %s", status.ToString().c_str());
+  }
+
+  return butil::Status();
+}
+
+butil::Status RocksRawEngine::CompactRange(const std::string& cf_name, const pb::common::Range& range) {
+  auto column_family = GetColumnFamily(cf_name);
+  if (column_family == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Not found column family %s", cf_name.c_str());
+  }
+
+  rocksdb::CompactRangeOptions options;
+  options.exclusive_manual_compaction = false;
+  options.bottommost_level_compaction = rocksdb::BottommostLevelCompaction::kIfHaveCompactionFilter;
+  rocksdb::Slice begin(range.start_key());
+  rocksdb::Slice end(range.end_key());
+  auto status = db_->CompactRange(options, column_family->GetHandle(), &begin, &end);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] compact range failed, column family {} error: {}", cf_name,
+                                    status.ToString());
+    return butil::Status(pb::error::EINTERNAL, "Compact range failed, %s", status.ToString().c_str());
+  }
+
+  return butil::Status();
+}
+
 void RocksRawEngine::Destroy() { rocksdb::DestroyDB(db_path_, rocksdb::Options()); }
 
 void RocksRawEngine::Close() {
   if (db_) {
     CancelAllBackgroundWork(db_.get(), true);
+    if (gc_compaction_filter_factory_ != nullptr) {
+      gc_compaction_filter_factory_->SetDB(nullptr, nullptr);
+    }
 
     std::vector<rocksdb::ColumnFamilyHandle*> column_family_handles;
     for (auto& [_, column_family] : column_families_) {
@@ -1131,4 +1740,188 @@ std::vector<int64_t> RocksRawEngine::GetApproximateSizes(const std::string& cf_n
   return result;
 }
 
+butil::Status RocksRawEngine::GetApproximateKeyCount(const std::string& cf_name, const pb::common::Range& range,
+                                                     int64_t& count) {
+  auto column_family = GetColumnFamily(cf_name);
+  if (column_family == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Not found column family %s", cf_name.c_str());
+  }
+
+  rocksdb::Range inner_range(range.start_key(), range.end_key());
+
+  // Sst files overlapped with range, the entries are scaled by the size ratio of range in files.
+  rocksdb::TablePropertiesCollection props;
+  auto status = db_->GetPropertiesOfTablesInRange(column_family->GetHandle(), &inner_range, 1, &props);
+  if (!status.ok()) {
+    return butil::Status(pb::error::EINTERNAL, "Get properties of tables failed, error: %s",
+                         status.ToString().c_str());
+  }
+
+  uint64_t file_entries = 0;
+  uint64_t file_size = 0;
+  for (const auto& [_, prop] : props) {
+    file_entries += prop->num_entries > prop->num_deletions ? prop->num_entries - prop->num_deletions : 0;
+    file_size += prop->data_size + prop->index_size + prop->filter_size;
+  }
+
+  double sst_count = 0;
+  if (file_size > 0) {
+    rocksdb::SizeApproximationOptions options;
+    options.include_files = true;
+    options.include_memtables = false;
+    uint64_t range_size = 0;
+    db_->GetApproximateSizes(options, column_family->GetHandle(), &inner_range, 1, &range_size);
+    sst_count = static_cast<double>(file_entries) * std::min(1.0, static_cast<double>(range_size) / file_size);
+  }
+
+  uint64_t mem_count = 0;
+  uint64_t mem_size = 0;
+  db_->GetApproximateMemTableStats(column_family->GetHandle(), inner_range, &mem_count, &mem_size);
+
+  count = static_cast<int64_t>(sst_count) + static_cast<int64_t>(mem_count);
+
+  return butil::Status();
+}
+
+butil::Status RocksRawEngine::GetApproximateDeletionStats(const std::string& cf_name, const pb::common::Range& range,
+                                                          DeletionStats& stats) {
+  auto column_family = GetColumnFamily(cf_name);
+  if (column_family == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Not found column family %s", cf_name.c_str());
+  }
+
+  rocksdb::Range inner_range(range.start_key(), range.end_key());
+
+  rocksdb::TablePropertiesCollection props;
+  auto status = db_->GetPropertiesOfTablesInRange(column_family->GetHandle(), &inner_range, 1, &props);
+  if (!status.ok()) {
+    return butil::Status(pb::error::EINTERNAL, "Get properties of tables failed, error: %s",
+                         status.ToString().c_str());
+  }
+
+  uint64_t file_entries = 0;
+  uint64_t file_deletions = 0;
+  uint64_t file_range_deletions = 0;
+  uint64_t file_size = 0;
+  for (const auto& [_, prop] : props) {
+    file_entries += prop->num_entries;
+    file_deletions += prop->num_deletions;
+    file_range_deletions += prop->num_range_deletions;
+    file_size += prop->data_size + prop->index_size + prop->filter_size;
+  }
+
+  stats = DeletionStats();
+  if (file_size == 0) {
+    return butil::Status();
+  }
+
+  rocksdb::SizeApproximationOptions options;
+  options.include_files = true;
+  options.include_memtables = false;
+  uint64_t range_size = 0;
+  db_->GetApproximateSizes(options, column_family->GetHandle(), &inner_range, 1, &range_size);
+
+  // Same scale as GetApproximateKeyCount, range tombstones are not scaled, every one of them may cover the range.
+  double ratio = std::min(1.0, static_cast<double>(range_size) / file_size);
+  stats.entry_count = static_cast<int64_t>(static_cast<double>(file_entries) * ratio);
+  stats.deletion_count = static_cast<int64_t>(static_cast<double>(file_deletions) * ratio);
+  stats.range_deletion_count = static_cast<int64_t>(file_range_deletions);
+  stats.size = static_cast<int64_t>(range_size);
+
+  return butil::Status();
+}
+
+butil::Status RocksRawEngine::GetSstFileBoundaryKeys(const std::string& cf_name, const pb::common::Range& range,
+                                                     std::vector<std::string>& keys) {
+  auto column_family = GetColumnFamily(cf_name);
+  if (column_family == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Not found column family %s", cf_name.c_str());
+  }
+
+  rocksdb::ColumnFamilyMetaData meta_data;
+  db_->GetColumnFamilyMetaData(column_family->GetHandle(), &meta_data);
+
+  auto in_range = [&range](const std::string& key) -> bool {
+    return key > range.start_key() && key < range.end_key();
+  };
+  for (const auto& level : meta_data.levels) {
+    for (const auto& file : level.files) {
+      if (in_range(file.smallestkey)) {
+        keys.push_back(file.smallestkey);
+      }
+      if (in_range(file.largestkey)) {
+        keys.push_back(file.largestkey);
+      }
+    }
+  }
+
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+  return butil::Status();
+}
+
+void RocksRawEngine::GetMemoryUsage(int64_t& memtable_bytes, int64_t& block_cache_bytes) {
+  uint64_t value = 0;
+  memtable_bytes = db_->GetAggregatedIntProperty(rocksdb::DB::Properties::kCurSizeAllMemTables, &value) ? value : 0;
+
+  // Every column family has its own block cache.
+  value = 0;
+  block_cache_bytes = db_->GetAggregatedIntProperty(rocksdb::DB::Properties::kBlockCacheUsage, &value) ? value : 0;
+}
+
+butil::Status RocksRawEngine::SetBlockCacheCapacity(int64_t capacity_bytes) {
+  if (capacity_bytes <= 0) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "block cache capacity must be positive");
+  }
+
+  for (const auto& [cf_name, column_family] : column_families_) {
+    auto options = db_->GetOptions(column_family->GetHandle());
+    auto* table_options = options.table_factory->GetOptions<rocksdb::BlockBasedTableOptions>();
+    if (table_options == nullptr || table_options->block_cache == nullptr) {
+      continue;
+    }
+
+    // shrink evicts the unpinned blocks, pinned blocks are released when they are unreferenced.
+    DINGO_LOG(INFO) << fmt::format("[rocksdb] set block cache capacity of cf {} from {} to {}", cf_name,
+                                   table_options->block_cache->GetCapacity(), capacity_bytes);
+    table_options->block_cache->SetCapacity(capacity_bytes);
+  }
+
+  return butil::Status();
+}
+
+std::vector<RawEngine::CompactionStats> RocksRawEngine::GetCompactionStats() {
+  std::vector<CompactionStats> compaction_stats;
+  compaction_stats.reserve(column_families_.size());
+  for (const auto& [cf_name, column_family] : column_families_) {
+    auto* handle = column_family->GetHandle();
+
+    CompactionStats stats;
+    stats.cf_name = cf_name;
+
+    uint64_t value = 0;
+    if (db_->GetIntProperty(handle, rocksdb::DB::Properties::kEstimatePendingCompactionBytes, &value)) {
+      stats.pending_compaction_bytes = value;
+    }
+    std::string l0_file_num;
+    if (db_->GetProperty(handle, rocksdb::DB::Properties::kNumFilesAtLevelPrefix + "0", &l0_file_num)) {
+      stats.l0_file_num = std::strtoll(l0_file_num.c_str(), nullptr, 10);
+    }
+
+    auto options = db_->GetOptions(handle);
+    stats.soft_pending_compaction_bytes_limit = options.soft_pending_compaction_bytes_limit;
+    stats.hard_pending_compaction_bytes_limit = options.hard_pending_compaction_bytes_limit;
+    stats.l0_slowdown_writes_trigger = options.level0_slowdown_writes_trigger;
+    stats.l0_stop_writes_trigger = options.level0_stop_writes_trigger;
+
+    stats.stall_micros = write_stall_listener_->StallMicros(cf_name);
+    stats.is_write_stopped = write_stall_listener_->IsWriteStopped(cf_name);
+
+    compaction_stats.push_back(stats);
+  }
+
+  return compaction_stats;
+}
+
 }  // namespace dingodb
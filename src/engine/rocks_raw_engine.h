@@ -18,22 +18,33 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "bvar/passive_status.h"
 #include "config/config.h"
 #include "engine/iterator.h"
 #include "engine/raw_engine.h"
 #include "engine/snapshot.h"
+#include "engine/txn_gc_compaction_filter.h"
 #include "proto/common.pb.h"
 #include "proto/store_internal.pb.h"
+#include "rocksdb/cache.h"
 #include "rocksdb/convenience.h"
 #include "rocksdb/db.h"
 #include "rocksdb/listener.h"
 #include "rocksdb/options.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/slice_transform.h"
+#include "rocksdb/statistics.h"
 #include "rocksdb/utilities/checkpoint.h"
+#include "rocksdb/version.h"
+
+// ReadOptions::allow_unprepared_value with Iterator::PrepareValue load blob values lazily since rocksdb 9.4.
+#if ROCKSDB_MAJOR > 9 || (ROCKSDB_MAJOR == 9 && ROCKSDB_MINOR >= 4)
+#define DINGO_ROCKSDB_LAZY_VALUE
+#endif
 
 namespace dingodb {
 
@@ -101,7 +112,14 @@ class Iterator : public dingodb::Iterator {
   void Prev() override { iter_->Prev(); }
 
   std::string_view Key() const override { return std::string_view(iter_->key().data(), iter_->key().size()); }
-  std::string_view Value() const override { return std::string_view(iter_->value().data(), iter_->value().size()); }
+  std::string_view Value() const override {
+#if defined(DINGO_ROCKSDB_LAZY_VALUE)
+    if (options_.lazy_value && !iter_->PrepareValue()) {
+      return std::string_view();
+    }
+#endif
+    return std::string_view(iter_->value().data(), iter_->value().size());
+  }
 
   butil::Status Status() const override;
 
@@ -163,6 +181,9 @@ class Checkpoint : public RawEngine::Checkpoint {
   butil::Status Create(const std::string& dirpath) override;
   butil::Status Create(const std::string& dirpath, const std::vector<std::string>& cf_names,
                        std::vector<pb::store_internal::SstFileInfo>& sst_files) override;
+  butil::Status Create(const std::string& dirpath, const std::vector<std::string>& cf_names,
+                       const pb::common::Range& range,
+                       std::vector<pb::store_internal::SstFileInfo>& sst_files) override;
 
  private:
   std::shared_ptr<RocksRawEngine> GetRawEngine();
@@ -182,6 +203,11 @@ class Reader : public RawEngine::Reader {
   butil::Status KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value) override;
 
+  butil::Status KvBatchGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                           std::vector<pb::common::KeyValue>& kvs) override;
+  butil::Status KvBatchGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) override;
+
   butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs) override;
   butil::Status KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
@@ -206,6 +232,8 @@ class Reader : public RawEngine::Reader {
 
   butil::Status KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value);
+  butil::Status KvBatchGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs);
   butil::Status KvScan(ColumnFamilyPtr column_family, std::shared_ptr<dingodb::Snapshot> snapshot,
                        const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs);
@@ -229,12 +257,19 @@ class Writer : public RawEngine::Writer {
                                     const std::vector<std::string>& keys_to_delete) override;
   butil::Status KvBatchPutAndDelete(const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
                                     const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) override;
+  butil::Status KvBatchPutAndDeleteApplied(
+      const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
+      const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) override;
 
   butil::Status KvDeleteRange(const std::string& cf_name, const pb::common::Range& range) override;
   butil::Status KvBatchDeleteRange(
       const std::map<std::string, std::vector<pb::common::Range>>& range_with_cfs) override;
 
  private:
+  butil::Status DoKvBatchPutAndDelete(const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
+                                      const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf,
+                                      const rocksdb::WriteOptions& write_options);
+
   std::shared_ptr<RocksRawEngine> GetRawEngine();
   std::shared_ptr<rocksdb::DB> GetDB();
   ColumnFamilyPtr GetColumnFamily(const std::string& cf_name);
@@ -243,6 +278,27 @@ class Writer : public RawEngine::Writer {
   std::weak_ptr<RocksRawEngine> raw_engine_;
 };
 
+// Track write stall time of column families by the stall condition change events of rocksdb.
+class WriteStallListener : public rocksdb::EventListener {
+ public:
+  void OnStallConditionsChanged(const rocksdb::WriteStallInfo& info) override;
+
+  // Cumulative stall micros, include the current stall.
+  int64_t StallMicros(const std::string& cf_name);
+  bool IsWriteStopped(const std::string& cf_name);
+
+ private:
+  struct StallState {
+    rocksdb::WriteStallCondition condition{rocksdb::WriteStallCondition::kNormal};
+    int64_t stall_start_us{0};
+    int64_t stall_micros{0};
+  };
+
+  std::mutex mutex_;
+  std::map<std::string, StallState> stall_states_;
+};
+using WriteStallListenerPtr = std::shared_ptr<WriteStallListener>;
+
 }  // namespace rocks
 
 class RocksRawEngine : public RawEngine {
@@ -278,11 +334,25 @@ class RocksRawEngine : public RawEngine {
                                      std::vector<std::string>& merge_sst_paths) override;
 
   butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files) override;
+  butil::Status GetExternalFileKeyRange(const std::string& file, std::string& smallest_key,
+                                        std::string& largest_key) override;
 
   void Flush(const std::string& cf_name) override;
+  void FlushAll() override;
   butil::Status Compact(const std::string& cf_name) override;
+  butil::Status DeleteFilesInRange(const std::string& cf_name, const pb::common::Range& range) override;
+  butil::Status CompactRange(const std::string& cf_name, const pb::common::Range& range) override;
 
   std::vector<int64_t> GetApproximateSizes(const std::string& cf_name, std::vector<pb::common::Range>& ranges) override;
+  butil::Status GetApproximateKeyCount(const std::string& cf_name, const pb::common::Range& range,
+                                       int64_t& count) override;
+  butil::Status GetApproximateDeletionStats(const std::string& cf_name, const pb::common::Range& range,
+                                            DeletionStats& stats) override;
+  butil::Status GetSstFileBoundaryKeys(const std::string& cf_name, const pb::common::Range& range,
+                                       std::vector<std::string>& keys) override;
+  void GetMemoryUsage(int64_t& memtable_bytes, int64_t& block_cache_bytes) override;
+  butil::Status SetBlockCacheCapacity(int64_t capacity_bytes) override;
+  std::vector<CompactionStats> GetCompactionStats() override;
 
  private:
   friend rocks::Reader;
@@ -291,6 +361,9 @@ class RocksRawEngine : public RawEngine {
 
   std::shared_ptr<rocksdb::DB> GetDB();
 
+  static double GetRowCacheHitRatio(void* arg);
+  static int64_t GetRowCacheUsage(void* arg);
+
   rocks::ColumnFamilyPtr GetDefaultColumnFamily();
   rocks::ColumnFamilyPtr GetColumnFamily(const std::string& cf_name);
   std::vector<rocks::ColumnFamilyPtr> GetColumnFamilies(const std::vector<std::string>& cf_names);
@@ -298,6 +371,15 @@ class RocksRawEngine : public RawEngine {
   std::string db_path_;
   std::shared_ptr<rocksdb::DB> db_;
   rocks::ColumnFamilyMap column_families_;
+  // compaction filter factory of txn write cf
+  TxnGcCompactionFilterFactoryPtr gc_compaction_filter_factory_;
+  rocks::WriteStallListenerPtr write_stall_listener_;
+
+  // Row cache of point lookup, nullptr if rocks_row_cache_capacity_mb is 0.
+  std::shared_ptr<rocksdb::Cache> row_cache_;
+  std::shared_ptr<rocksdb::Statistics> statistics_;
+  std::unique_ptr<bvar::PassiveStatus<double>> row_cache_hit_ratio_;
+  std::unique_ptr<bvar::PassiveStatus<int64_t>> row_cache_usage_;
 
   RawEngine::ReaderPtr reader_;
   RawEngine::WriterPtr writer_;
@@ -17,17 +17,25 @@
 #include <cstdint>
 #include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "butil/compiler_specific.h"
+#include "bthread/bthread.h"
 #include "butil/status.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/memory_tracker.h"
+#include "common/service_access.h"
 #include "engine/raft_store_engine.h"
+#include "engine/raw_kv_ttl.h"
 #include "engine/snapshot.h"
+#include "engine/txn_engine_helper.h"
+#include "engine/txn_resolved_ts.h"
 #include "engine/write_data.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
@@ -36,10 +44,22 @@
 #include "proto/store.pb.h"
 #include "scan/scan.h"
 #include "scan/scan_manager.h"
+#include "server/server.h"
+#include "store/learner.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
 
+DEFINE_int64(follower_read_timeout_ms, 2000, "timeout of get read index and wait apply for follower read");
+DECLARE_bool(enable_txn_stale_read);
+
+static void AddEngineReadTime(std::shared_ptr<Context> ctx, int64_t start_time_ns) {
+  auto tracker = ctx->Tracker();
+  if (tracker != nullptr) {
+    tracker->AddEngineReadTime(Helper::TimestampNs() - start_time_ns);
+  }
+}
+
 Storage::Storage(std::shared_ptr<Engine> engine) : engine_(engine) {}
 
 std::shared_ptr<Engine> Storage::GetEngine() { return engine_; }
@@ -67,6 +87,84 @@ butil::Status Storage::ValidateLeader(int64_t region_id) {
   return butil::Status();
 }
 
+butil::Status Storage::ValidateRead(int64_t region_id, pb::store::ReadMode read_mode) {
+  if (read_mode == pb::store::ReadLeader || engine_->GetID() != pb::common::StorageEngine::STORE_ENG_RAFT_STORE) {
+    return ValidateLeader(region_id);
+  }
+
+  auto raft_kv_engine = std::dynamic_pointer_cast<RaftStoreEngine>(engine_);
+  auto node = raft_kv_engine->GetNode(region_id);
+  if (node == nullptr) {
+    return butil::Status(pb::error::ERAFT_NOT_FOUND, "Not found raft node");
+  }
+
+  // Learner is out of the raft configuration, it knows the leader and applies by pulling the log.
+  if (LearnerManager::IsLearner(Server::GetInstance().GetRegion(region_id))) {
+    if (read_mode == pb::store::ReadLeaderLease) {
+      return butil::Status(pb::error::ERAFT_NOTLEADER, "Learner is not leader");
+    }
+    return LearnerManager::GetInstance().ValidateRead(region_id, FLAGS_follower_read_timeout_ms);
+  }
+
+  // Leader lease guarantee no newer leader, read local without raft round trip.
+  if (node->IsLeader() && node->IsLeaderLeaseValid()) {
+    return butil::Status();
+  }
+  if (read_mode == pb::store::ReadLeaderLease || node->IsLeader()) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, node->GetLeaderId().to_string());
+  }
+
+  // Follower read, get read index from leader and wait apply.
+  if (!node->HasLeader()) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, node->GetLeaderId().to_string());
+  }
+
+  int64_t start_time = Helper::TimestampMs();
+  auto leader_id = node->GetLeaderId();
+  auto node_info =
+      Server::GetInstance().GetStoreMetaManager()->GetStoreServerMeta()->GetNodeInfoByRaftEndPoint(leader_id.addr);
+  if (node_info.id() == 0) {
+    Helper::GetNodeInfoByRaftLocation(Helper::EndPointToLocation(leader_id.addr), node_info);
+  }
+  if (node_info.server_location().host().empty()) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, leader_id.to_string());
+  }
+
+  int64_t read_index = 0;
+  auto status = ServiceAccess::ReadIndex(
+      region_id, Helper::LocationToEndPoint(node_info.server_location()), FLAGS_follower_read_timeout_ms,
+      read_index);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[follower_read][region({})] get read index from leader {} failed, error: {}",
+                                      region_id, leader_id.to_string(), Helper::PrintStatus(status));
+    return butil::Status(pb::error::ERAFT_NOTLEADER, leader_id.to_string());
+  }
+
+  auto state_machine = node->GetStateMachine();
+  while (state_machine->GetAppliedIndex() < read_index) {
+    if (Helper::TimestampMs() - start_time > FLAGS_follower_read_timeout_ms) {
+      return butil::Status(pb::error::ERAFT_NOTLEADER, leader_id.to_string());
+    }
+    bthread_usleep(1000);
+  }
+
+  return butil::Status();
+}
+
+butil::Status Storage::ValidateTxnRead(std::shared_ptr<Context> ctx, int64_t start_ts) {
+  if (ctx->ReadMode() != pb::store::ReadStale) {
+    return ValidateRead(ctx->RegionId(), ctx->ReadMode());
+  }
+
+  // Read committed read the latest version, can't be stale.
+  if (FLAGS_enable_txn_stale_read && ctx->IsolationLevel() == pb::store::SnapshotIsolation && start_ts > 0 &&
+      start_ts <= TxnResolvedTsManager::GetInstance().GetResolvedTs(ctx->RegionId())) {
+    return butil::Status();
+  }
+
+  return ValidateRead(ctx->RegionId(), pb::store::ReadFollower);
+}
+
 bool Storage::IsLeader(int64_t region_id) {
   if (engine_ == nullptr || engine_->GetID() != pb::common::StorageEngine::STORE_ENG_RAFT_STORE) {
     return false;
@@ -77,7 +175,7 @@ bool Storage::IsLeader(int64_t region_id) {
 
 butil::Status Storage::KvGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
                              std::vector<pb::common::KeyValue>& kvs) {
-  auto status = ValidateLeader(ctx->RegionId());
+  auto status = ValidateRead(ctx->RegionId(), ctx->ReadMode());
   if (!status.ok()) {
     return status;
   }
@@ -85,32 +183,26 @@ butil::Status Storage::KvGet(std::shared_ptr<Context> ctx, const std::vector<std
   if (reader == nullptr) {
     return butil::Status(pb::error::EENGINE_NOT_FOUND, "reader is nullptr");
   }
-  for (const auto& key : keys) {
-    std::string value;
-    auto status = reader->KvGet(ctx, key, value);
-    if (!status.ok()) {
-      if (pb::error::EKEY_NOT_FOUND == status.error_code()) {
-        continue;
-      }
-      kvs.clear();
-      return status;
-    }
-
-    pb::common::KeyValue kv;
-    kv.set_key(key);
-    kv.set_value(value);
-    kvs.emplace_back(kv);
+  int64_t start_time_ns = Helper::TimestampNs();
+  status = reader->KvBatchGet(ctx, keys, kvs);
+  AddEngineReadTime(ctx, start_time_ns);
+  if (!status.ok()) {
+    kvs.clear();
+    return status;
+  }
+  if (!keys.empty() && RawKvTtl::IsEnabled(ctx->CfName(), keys[0])) {
+    RawKvTtl::DecodeKvs(kvs);
   }
 
   return butil::Status();
 }
 
-butil::Status Storage::KvPut(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs) {
+butil::Status Storage::KvPut(std::shared_ptr<Context> ctx, std::vector<pb::common::KeyValue>&& kvs) {
   auto writer = engine_->NewWriter(ctx->RawEngineType());
   if (writer == nullptr) {
     return butil::Status(pb::error::EENGINE_NOT_FOUND, "writer is nullptr");
   }
-  auto status = writer->KvPut(ctx, kvs);
+  auto status = writer->KvPut(ctx, std::move(kvs));
   if (!status.ok()) {
     return status;
   }
@@ -158,6 +250,15 @@ butil::Status Storage::KvDeleteRange(std::shared_ptr<Context> ctx, const pb::com
   return butil::Status();
 }
 
+butil::Status Storage::KvIngestSst(std::shared_ptr<Context> ctx, const std::vector<std::string>& filenames) {
+  auto status = ValidateLeader(ctx->RegionId());
+  if (!status.ok()) {
+    return status;
+  }
+
+  return engine_->Write(ctx, WriteDataBuilder::BuildIngestSstWrite(ctx->CfName(), filenames));
+}
+
 butil::Status Storage::KvCompareAndSet(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs,
                                        const std::vector<std::string>& expect_values, bool is_atomic,
                                        std::vector<bool>& key_states) {
@@ -178,12 +279,16 @@ butil::Status Storage::KvScanBegin(std::shared_ptr<Context> ctx, const std::stri
                                    bool disable_auto_release, bool disable_coprocessor,
                                    const pb::store::Coprocessor& coprocessor, std::string* scan_id,
                                    std::vector<pb::common::KeyValue>* kvs) {
-  auto status = ValidateLeader(ctx->RegionId());
+  auto status = ValidateRead(ctx->RegionId(), ctx->ReadMode());
   if (!status.ok()) {
     return status;
   }
 
   ScanManager& manager = ScanManager::GetInstance();
+  status = MemoryTracker::GetInstance().CheckBudget(MemoryTracker::Type::kScanContext, manager.GetMaxBytesRpc());
+  if (!status.ok()) {
+    return status;
+  }
   std::shared_ptr<ScanContext> scan = manager.CreateScan(scan_id);
 
   auto raw_engine = engine_->GetRawEngine(ctx->RawEngineType());
@@ -256,12 +361,16 @@ butil::Status Storage::KvScanBeginV2(std::shared_ptr<Context> ctx, const std::st
                                      bool disable_auto_release, bool disable_coprocessor,
                                      const pb::common::CoprocessorV2& coprocessor, int64_t scan_id,
                                      std::vector<pb::common::KeyValue>* kvs) {
-  auto status = ValidateLeader(ctx->RegionId());
+  auto status = ValidateRead(ctx->RegionId(), ctx->ReadMode());
   if (!status.ok()) {
     return status;
   }
 
   ScanManagerV2& manager = ScanManagerV2::GetInstance();
+  status = MemoryTracker::GetInstance().CheckBudget(MemoryTracker::Type::kScanContext, manager.GetMaxBytesRpc());
+  if (!status.ok()) {
+    return status;
+  }
   std::shared_ptr<ScanContext> scan = manager.CreateScan(scan_id);
   if (!scan) {
     std::string s = fmt::format("ScanManagerV2::CreateScan failed, scan_id  {} repeated.", scan_id);
@@ -337,12 +446,12 @@ butil::Status Storage::KvScanReleaseV2(std::shared_ptr<Context> /*ctx*/, int64_t
 }
 
 butil::Status Storage::VectorAdd(std::shared_ptr<Context> ctx, bool is_sync,
-                                 const std::vector<pb::common::VectorWithId>& vectors) {
+                                 std::vector<pb::common::VectorWithId>&& vectors) {
   if (is_sync) {
-    return engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), vectors));
+    return engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), std::move(vectors)));
   }
 
-  return engine_->AsyncWrite(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), vectors),
+  return engine_->AsyncWrite(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), std::move(vectors)),
                              [](std::shared_ptr<Context> ctx, butil::Status status) {
                                if (!status.ok()) {
                                  Helper::SetPbMessageError(status, ctx->Response());
@@ -365,7 +474,7 @@ butil::Status Storage::VectorDelete(std::shared_ptr<Context> ctx, bool is_sync,
 
 butil::Status Storage::VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                         std::vector<pb::common::VectorWithId>& vector_with_ids) {
-  auto status = ValidateLeader(ctx->region_id);
+  auto status = ValidateRead(ctx->region_id, ctx->read_mode);
   if (!status.ok()) {
     return status;
   }
@@ -390,7 +499,7 @@ butil::Status Storage::VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Co
 
 butil::Status Storage::VectorBatchSearch(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                          std::vector<pb::index::VectorWithDistanceResult>& results) {
-  auto status = ValidateLeader(ctx->region_id);
+  auto status = ValidateRead(ctx->region_id, ctx->read_mode);
   if (!status.ok()) {
     return status;
   }
@@ -430,7 +539,7 @@ butil::Status Storage::VectorGetBorderId(store::RegionPtr region, bool get_min,
 
 butil::Status Storage::VectorScanQuery(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                        std::vector<pb::common::VectorWithId>& vector_with_ids) {
-  auto status = ValidateLeader(ctx->region_id);
+  auto status = ValidateRead(ctx->region_id, ctx->read_mode);
   if (!status.ok()) {
     return status;
   }
@@ -460,12 +569,22 @@ butil::Status Storage::VectorGetRegionMetrics(store::RegionPtr region, VectorInd
   return butil::Status();
 }
 
-butil::Status Storage::VectorCount(store::RegionPtr region, pb::common::Range range, int64_t& count) {
+butil::Status Storage::VectorCount(store::RegionPtr region, pb::common::Range range, bool& approximate,
+                                   int64_t& count) {
   auto status = ValidateLeader(region->Id());
   if (!status.ok()) {
     return status;
   }
 
+  if (approximate) {
+    auto raw_engine = engine_->GetRawEngine(region->GetRawEngineType());
+    status = raw_engine->GetApproximateKeyCount(Constant::kStoreDataCF, range, count);
+    if (status.ok() || status.error_code() != pb::error::ENOT_SUPPORT) {
+      return status;
+    }
+    approximate = false;
+  }
+
   auto vector_reader = engine_->NewVectorReader(region->GetRawEngineType());
   status = vector_reader->VectorCount(range, count);
   if (!status.ok()) {
@@ -511,6 +630,13 @@ butil::Status Storage::VectorCalcDistance(const ::dingodb::pb::index::VectorCalc
       size_t i = 0;
       for (const auto& vector : op_vector) {
         int64_t current_dimension = static_cast<int64_t>(vector.float_values().size());
+        if (vector.value_type() != pb::common::ValueType::FLOAT) {
+          // integer vectors are packed in binary_values, compare the packed size
+          current_dimension = 0;
+          for (const auto& value : vector.binary_values()) {
+            current_dimension += static_cast<int64_t>(value.size());
+          }
+        }
         if (0 == dimension) {
           dimension = current_dimension;
         }
@@ -579,7 +705,7 @@ butil::Status Storage::VectorBatchSearchDebug(std::shared_ptr<Engine::VectorRead
 butil::Status Storage::TxnBatchGet(std::shared_ptr<Context> ctx, int64_t start_ts, const std::vector<std::string>& keys,
                                    const std::set<int64_t>& resolved_locks, pb::store::TxnResultInfo& txn_result_info,
                                    std::vector<pb::common::KeyValue>& kvs) {
-  auto status = ValidateLeader(ctx->RegionId());
+  auto status = ValidateTxnRead(ctx, start_ts);
   if (!status.ok()) {
     return status;
   }
@@ -594,7 +720,9 @@ butil::Status Storage::TxnBatchGet(std::shared_ptr<Context> ctx, int64_t start_t
     return butil::Status(pb::error::EENGINE_NOT_FOUND, "reader is nullptr");
   }
 
+  int64_t start_time_ns = Helper::TimestampNs();
   status = reader->TxnBatchGet(ctx, start_ts, keys, kvs, resolved_locks, txn_result_info);
+  AddEngineReadTime(ctx, start_time_ns);
   if (!status.ok()) {
     if (pb::error::EKEY_NOT_FOUND == status.error_code()) {
       // return OK if not found
@@ -612,7 +740,7 @@ butil::Status Storage::TxnScan(std::shared_ptr<Context> ctx, int64_t start_ts, c
                                pb::store::TxnResultInfo& txn_result_info, std::vector<pb::common::KeyValue>& kvs,
                                bool& has_more, std::string& end_scan_key, bool disable_coprocessor,
                                const pb::common::CoprocessorV2& coprocessor) {
-  auto status = ValidateLeader(ctx->RegionId());
+  auto status = ValidateTxnRead(ctx, start_ts);
   if (!status.ok()) {
     return status;
   }
@@ -630,8 +758,10 @@ butil::Status Storage::TxnScan(std::shared_ptr<Context> ctx, int64_t start_ts, c
     DINGO_LOG(ERROR) << fmt::format("reader is nullptr, region_id : {}", ctx->RegionId());
     return butil::Status(pb::error::EENGINE_NOT_FOUND, "reader is nullptr");
   }
+  int64_t start_time_ns = Helper::TimestampNs();
   status = reader->TxnScan(ctx, start_ts, range, limit, key_only, is_reverse, resolved_locks, disable_coprocessor,
                            coprocessor, txn_result_info, kvs, has_more, end_scan_key);
+  AddEngineReadTime(ctx, start_time_ns);
   if (!status.ok()) {
     if (pb::error::EKEY_NOT_FOUND == status.error_code()) {
       // return OK if not found
@@ -644,6 +774,32 @@ butil::Status Storage::TxnScan(std::shared_ptr<Context> ctx, int64_t start_ts, c
   return butil::Status();
 }
 
+butil::Status Storage::TxnScanWithCursor(std::shared_ptr<Context> ctx, int64_t start_ts,
+                                         const pb::common::Range& range, int64_t limit, bool key_only,
+                                         const std::set<int64_t>& resolved_locks, int64_t& scan_id,
+                                         pb::store::TxnResultInfo& txn_result_info,
+                                         std::vector<pb::common::KeyValue>& kvs, bool& has_more,
+                                         std::string& end_scan_key) {
+  auto status = ValidateTxnRead(ctx, start_ts);
+  if (!status.ok()) {
+    return status;
+  }
+
+  DINGO_LOG(DEBUG) << "TxnScanWithCursor region_id: " << ctx->RegionId() << ", range: " << Helper::RangeToString(range)
+                   << ", limit: " << limit << ", start_ts: " << start_ts << ", key_only: " << key_only
+                   << ", scan_id: " << scan_id;
+
+  auto raw_engine = engine_->GetRawEngine(ctx->RawEngineType());
+  if (raw_engine == nullptr) {
+    DINGO_LOG(ERROR) << fmt::format("raw engine is nullptr, region_id : {}", ctx->RegionId());
+    return butil::Status(pb::error::EENGINE_NOT_FOUND, "raw engine is nullptr");
+  }
+
+  return TxnEngineHelper::ScanWithCursor(raw_engine, ctx->IsolationLevel(), start_ts, range, limit, key_only,
+                                         resolved_locks, ctx->RegionId(), ctx->RegionEpoch().version(), scan_id,
+                                         txn_result_info, kvs, has_more, end_scan_key);
+}
+
 butil::Status Storage::TxnPessimisticLock(std::shared_ptr<Context> ctx,
                                           const std::vector<pb::store::Mutation>& mutations,
                                           const std::string& primary_lock, int64_t start_ts, int64_t lock_ttl,
@@ -67,7 +67,8 @@ class Storage {
   static butil::Status KvScanReleaseV2(std::shared_ptr<Context> ctx, int64_t scan_id);
 
   // kv write
-  butil::Status KvPut(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs);
+  // the kvs and vectors of write are moved into the raft log
+  butil::Status KvPut(std::shared_ptr<Context> ctx, std::vector<pb::common::KeyValue>&& kvs);
 
   butil::Status KvPutIfAbsent(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs,
                               bool is_atomic, std::vector<bool>& key_states);
@@ -75,6 +76,8 @@ class Storage {
   butil::Status KvDelete(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys);
 
   butil::Status KvDeleteRange(std::shared_ptr<Context> ctx, const pb::common::Range& range);
+  // Ingest the sst files which already exist on every replica.
+  butil::Status KvIngestSst(std::shared_ptr<Context> ctx, const std::vector<std::string>& filenames);
 
   butil::Status KvCompareAndSet(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs,
                                 const std::vector<std::string>& expect_values, bool is_atomic,
@@ -89,6 +92,11 @@ class Storage {
                         pb::store::TxnResultInfo& txn_result_info, std::vector<pb::common::KeyValue>& kvs,
                         bool& has_more, std::string& end_scan_key, bool disable_coprocessor,
                         const pb::common::CoprocessorV2& coprocessor);
+  // Forward txn scan which continues from the cursor of last page, see TxnEngineHelper::ScanWithCursor.
+  butil::Status TxnScanWithCursor(std::shared_ptr<Context> ctx, int64_t start_ts, const pb::common::Range& range,
+                                  int64_t limit, bool key_only, const std::set<int64_t>& resolved_locks,
+                                  int64_t& scan_id, pb::store::TxnResultInfo& txn_result_info,
+                                  std::vector<pb::common::KeyValue>& kvs, bool& has_more, std::string& end_scan_key);
   butil::Status TxnScanLock(std::shared_ptr<Context> ctx, int64_t max_ts, const pb::common::Range& range, int64_t limit,
                             pb::store::TxnResultInfo& txn_result_info, std::vector<pb::store::LockInfo>& lock_infos,
                             bool& has_more, std::string& end_scan_key);
@@ -124,8 +132,7 @@ class Storage {
   butil::Status TxnDeleteRange(std::shared_ptr<Context> ctx, const std::string& start_key, const std::string& end_key);
 
   // vector index
-  butil::Status VectorAdd(std::shared_ptr<Context> ctx, bool is_sync,
-                          const std::vector<pb::common::VectorWithId>& vectors);
+  butil::Status VectorAdd(std::shared_ptr<Context> ctx, bool is_sync, std::vector<pb::common::VectorWithId>&& vectors);
   butil::Status VectorDelete(std::shared_ptr<Context> ctx, bool is_sync, const std::vector<int64_t>& ids);
 
   butil::Status VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Context> ctx,
@@ -138,7 +145,8 @@ class Storage {
   butil::Status VectorGetRegionMetrics(store::RegionPtr region, VectorIndexWrapperPtr vector_index_wrapper,
                                        pb::common::VectorIndexMetrics& region_metrics);
 
-  butil::Status VectorCount(store::RegionPtr region, pb::common::Range range, int64_t& count);
+  // If approximate is true, estimate count without iterating, approximate is set false if fall back to exact count.
+  butil::Status VectorCount(store::RegionPtr region, pb::common::Range range, bool& approximate, int64_t& count);
 
   static butil::Status VectorCalcDistance(
       const ::dingodb::pb::index::VectorCalcDistanceRequest& request,
@@ -153,6 +161,10 @@ class Storage {
                                        int64_t& search_time_us);
 
   butil::Status ValidateLeader(int64_t region_id);
+  // Validate the read of read_mode, maybe wait the read index for follower read.
+  butil::Status ValidateRead(int64_t region_id, pb::store::ReadMode read_mode);
+  // Validate the txn read at start_ts, stale read is served locally if start_ts <= resolved ts of region.
+  butil::Status ValidateTxnRead(std::shared_ptr<Context> ctx, int64_t start_ts);
   bool IsLeader(int64_t region_id);
 
   butil::Status PrepareMerge(std::shared_ptr<Context> ctx, int64_t job_id,
@@ -15,6 +15,7 @@
 #include "engine/txn_engine_helper.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstdint>
 #include <map>
@@ -26,13 +27,19 @@
 
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
+#include "bthread/bthread.h"
 #include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/synchronization.h"
 #include "coprocessor/coprocessor_v2.h"
+#include "engine/txn_gc_compaction_filter.h"
+#include "engine/txn_scan_cursor.h"
 #include "fmt/core.h"
 #include "meta/store_meta_manager.h"
+#include "metrics/store_metrics_manager.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/raft.pb.h"
@@ -54,6 +61,14 @@ DEFINE_int64(max_rollback_count, 1024, "max rollback count");
 DEFINE_int64(max_resolve_count, 1024, "max rollback count");
 DEFINE_int64(max_pessimistic_count, 1024, "max pessimistic count");
 DEFINE_int64(gc_delete_batch_count, 32768, "gc delete batch count");
+DECLARE_bool(enable_txn_gc_compaction_filter);
+DEFINE_bool(enable_txn_gc_by_garbage_ratio, false, "only gc regions whose garbage ratio reach threshold");
+DEFINE_double(txn_gc_garbage_ratio_threshold, 0.5, "gc region if versions written since last gc / key count reach it");
+DEFINE_int64(txn_gc_min_versions, 1000, "gc region only if versions written since last gc reach it");
+DEFINE_int64(txn_gc_max_regions_per_round, 64, "max regions gc by garbage ratio in one round, 0 means no limit");
+DEFINE_int64(txn_gc_full_interval_rounds, 10, "gc all regions every n rounds when gc by garbage ratio");
+DEFINE_int64(txn_gc_concurrency, 1, "concurrent regions of txn gc");
+DEFINE_int64(txn_gc_region_interval_ms, 0, "sleep ms after gc one region to limit gc io");
 
 DEFINE_bool(dingo_log_switch_txn_detail, false, "txn detail log");
 
@@ -141,6 +156,10 @@ butil::Status TxnIterator::Seek(const std::string &key) {
 }
 
 butil::Status TxnIterator::InnerSeek(const std::string &key) {
+  if (is_reverse_) {
+    return InnerSeekForPrev(key);
+  }
+
   key_.clear();
   value_.clear();
   last_lock_key_.clear();
@@ -225,6 +244,10 @@ butil::Status TxnIterator::Next() {
 }
 
 butil::Status TxnIterator::InnerNext() {
+  if (is_reverse_) {
+    return InnerPrev();
+  }
+
   if (key_.empty()) {
     DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
         << "[txn]Scan Next key_ is empty, scan is finished, start_ts: " << start_ts_ << ", seek_ts: " << seek_ts_;
@@ -545,6 +568,146 @@ butil::Status TxnIterator::GetCurrentValue() {
   return butil::Status::OK();
 }
 
+butil::Status TxnIterator::InnerSeekForPrev(const std::string &key) {
+  key_.clear();
+  value_.clear();
+  last_lock_key_.clear();
+  last_write_key_.clear();
+
+  // kMaxVer is the smallest encoding of key, so both iters stop at the entries of user keys <= key.
+  std::string seek_key = Helper::EncodeTxnKey(key, Constant::kMaxVer);
+  lock_iter_->SeekForPrev(seek_key);
+  if (GetUserKey(lock_iter_) == key) {
+    lock_iter_->Prev();
+  }
+  write_iter_->SeekForPrev(seek_key);
+  while (GetUserKey(write_iter_) == key) {
+    write_iter_->Prev();
+  }
+
+  return ReverseMoveToUserKey();
+}
+
+butil::Status TxnIterator::InnerPrev() {
+  if (key_.empty()) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+        << "[txn]Scan Prev key_ is empty, scan is finished, start_ts: " << start_ts_ << ", seek_ts: " << seek_ts_;
+    return butil::Status(pb::error::Errno::ETXN_SCAN_FINISH, "key_ is empty");
+  }
+
+  if (txn_result_info_.ByteSizeLong() > 0) {
+    DINGO_LOG(ERROR) << "[txn]Scan Prev txn_result_info_ is not empty, start_ts: " << start_ts_
+                     << ", seek_ts: " << seek_ts_;
+    return butil::Status(pb::error::Errno::ETXN_RESULT_INFO_NOT_NULL, "key_ is empty");
+  }
+
+  return ReverseMoveToUserKey();
+}
+
+butil::Status TxnIterator::ReverseMoveToUserKey() {
+  value_.clear();
+
+  // GetUserKey return empty if iter is invalid.
+  last_lock_key_ = GetUserKey(lock_iter_);
+  last_write_key_ = GetUserKey(write_iter_);
+  if (last_lock_key_.empty() && last_write_key_.empty()) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+        << "[txn]Scan lock_iter_ and write_iter_ are invalid, the reverse iterator is finished, start_ts: " << start_ts_
+        << ", seek_ts: " << seek_ts_;
+    key_.clear();
+    return butil::Status::OK();
+  }
+
+  key_ = std::max(last_lock_key_, last_write_key_);
+
+  if (last_lock_key_ == key_) {
+    pb::store::LockInfo lock_info;
+    auto lock_value = lock_iter_->Value();
+    if (!lock_info.ParseFromArray(lock_value.data(), lock_value.size())) {
+      DINGO_LOG(FATAL) << "[txn]Scan parse lock info failed, lock_key: " << Helper::StringToHex(lock_iter_->Key())
+                       << ", lock_value(hex): " << Helper::StringToHex(lock_value);
+    }
+
+    if (TxnEngineHelper::CheckLockConflict(lock_info, isolation_level_, start_ts_, resolved_locks_,
+                                           txn_result_info_)) {
+      DINGO_LOG(WARNING) << "[txn]Scan CheckLockConflict return conflict, key: " << Helper::StringToHex(lock_info.key())
+                         << ", isolation_level: " << isolation_level_ << ", start_ts: " << start_ts_
+                         << ", seek_ts: " << seek_ts_ << ", lock_info: " << lock_info.ShortDebugString();
+      key_.clear();
+      value_.clear();
+      return butil::Status(pb::error::Errno::ETXN_LOCK_CONFLICT, "lock conflict");
+    }
+
+    lock_iter_->Prev();
+  }
+
+  if (last_write_key_ == key_) {
+    return GetPrevUserValueInWriteIter();
+  }
+
+  // only lock and no write, there is no data
+  return butil::Status::OK();
+}
+
+butil::Status TxnIterator::GetPrevUserValueInWriteIter() {
+  // The writes of a user key are sorted by commit_ts desc, so the reverse write_iter_ meets the oldest one first,
+  // the newest visible Put or Delete is the value.
+  bool is_value_found = false;
+  pb::store::WriteInfo value_write_info;
+  while (write_iter_->Valid()) {
+    std::string user_key;
+    int64_t commit_ts = 0;
+    auto ret = Helper::DecodeTxnKey(write_iter_->Key(), user_key, commit_ts);
+    if (!ret.ok()) {
+      DINGO_LOG(FATAL) << "[txn]Scan DecodeTxnKey failed, write_iter->key: " << Helper::StringToHex(write_iter_->Key())
+                       << ", start_ts: " << start_ts_ << ", seek_ts: " << seek_ts_;
+    }
+    if (user_key != key_) {
+      break;
+    }
+
+    if (isolation_level_ == pb::store::IsolationLevel::SnapshotIsolation && commit_ts > start_ts_) {
+      // the remaining writes of key_ are newer, skip them all.
+      write_iter_->SeekForPrev(Helper::EncodeTxnKey(key_, Constant::kMaxVer));
+      break;
+    }
+
+    pb::store::WriteInfo write_info;
+    if (!write_info.ParseFromArray(write_iter_->Value().data(), write_iter_->Value().size())) {
+      DINGO_LOG(FATAL) << "[txn]Scan parse write info failed, write_key: " << Helper::StringToHex(write_iter_->Key())
+                       << ", write_value(hex): " << Helper::StringToHex(write_iter_->Value());
+    }
+    if (write_info.op() == pb::store::Op::Put || write_info.op() == pb::store::Op::Delete) {
+      value_write_info.Swap(&write_info);
+      is_value_found = true;
+    }
+
+    write_iter_->Prev();
+  }
+
+  if (!is_value_found || value_write_info.op() == pb::store::Op::Delete) {
+    return butil::Status::OK();
+  }
+
+  if (!value_write_info.short_value().empty()) {
+    value_ = value_write_info.short_value();
+    return butil::Status::OK();
+  }
+
+  auto ret = reader_->KvGet(Constant::kTxnDataCF, Helper::EncodeTxnKey(key_, value_write_info.start_ts()), value_);
+  if (ret.error_code() == pb::error::Errno::EKEY_NOT_FOUND) {
+    DINGO_LOG(ERROR) << "[txn]Scan read data failed, data is illegally not found, key: " << Helper::StringToHex(key_)
+                     << ", status: " << ret.error_str();
+    return butil::Status(pb::error::Errno::EINTERNAL, "data is illegally not found");
+  } else if (!ret.ok()) {
+    DINGO_LOG(ERROR) << "[txn]Scan read data failed, key: " << Helper::StringToHex(key_)
+                     << ", status: " << ret.error_str();
+    return butil::Status(pb::error::Errno::EINTERNAL, "read data failed");
+  }
+
+  return butil::Status::OK();
+}
+
 bool TxnIterator::Valid(pb::store::TxnResultInfo &txn_result_info) {
   if (txn_result_info_.ByteSizeLong() > 0) {
     txn_result_info = txn_result_info_;
@@ -646,6 +809,8 @@ bool TxnEngineHelper::CheckLockConflict(const pb::store::LockInfo &lock_info, pb
   return false;
 }
 
+bvar::Adder<int64_t> g_txn_lock_table_skip_count("dingo_txn_lock_table_skip_count");
+
 butil::Status TxnEngineHelper::GetLockInfo(RawEngine::ReaderPtr reader, const std::string &key,
                                            pb::store::LockInfo &lock_info) {
   std::string lock_value;
@@ -682,6 +847,16 @@ butil::Status TxnEngineHelper::GetLockInfo(RawEngine::ReaderPtr reader, const st
   return butil::Status::OK();
 }
 
+butil::Status TxnEngineHelper::GetLockInfo(TxnLockTablePtr lock_table, RawEngine::ReaderPtr reader,
+                                           const std::string &key, pb::store::LockInfo &lock_info) {
+  if (lock_table != nullptr && !lock_table->MaybeLocked(Helper::EncodeTxnKey(key, Constant::kLockVer))) {
+    g_txn_lock_table_skip_count << 1;
+    return butil::Status::OK();
+  }
+
+  return GetLockInfo(reader, key, lock_info);
+}
+
 bvar::LatencyRecorder g_txn_scan_lock_latency("dingo_txn_scan_lock");
 
 butil::Status TxnEngineHelper::ScanLockInfo(RawEnginePtr engine, int64_t min_lock_ts, int64_t max_lock_ts,
@@ -778,7 +953,8 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
                                         int64_t start_ts, const std::vector<std::string> &keys,
                                         const std::set<int64_t> &resolved_locks,
                                         pb::store::TxnResultInfo &txn_result_info,
-                                        std::vector<pb::common::KeyValue> &kvs) {
+                                        std::vector<pb::common::KeyValue> &kvs, TxnLockTablePtr lock_table,
+                                        TrackerPtr tracker) {
   BvarLatencyGuard bvar_guard(&g_txn_batch_get_latency);
 
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -815,59 +991,111 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
 
   auto reader = engine->Reader();
 
-  int64_t response_memory_size = 0;
-
-  // for every key in keys, get lock info, if lock_ts < start_ts, return LockInfo
-  // else find the latest write below our start_ts
-  // then read data from data_cf
+  // batch get lock info of all keys, lock_kvs keep the order of keys
+  std::vector<std::string> lock_keys;
+  lock_keys.reserve(keys.size());
   for (const auto &key : keys) {
-    pb::common::KeyValue kv;
-    kv.set_key(key);
+    lock_keys.push_back(Helper::EncodeTxnKey(key, Constant::kLockVer));
+  }
+
+  // only read the lock keys which may be locked
+  std::vector<std::string> maybe_locked_keys;
+  if (lock_table != nullptr) {
+    for (const auto &lock_key : lock_keys) {
+      if (lock_table->MaybeLocked(lock_key)) {
+        maybe_locked_keys.push_back(lock_key);
+      }
+    }
+    g_txn_lock_table_skip_count << (lock_keys.size() - maybe_locked_keys.size());
+  }
+
+  std::vector<pb::common::KeyValue> lock_kvs;
+  butil::Status ret;
+  int64_t lock_start_time_ns = Helper::TimestampNs();
+  if (lock_table == nullptr) {
+    ret = reader->KvBatchGet(Constant::kTxnLockCF, lock_keys, lock_kvs);
+  } else if (!maybe_locked_keys.empty()) {
+    ret = reader->KvBatchGet(Constant::kTxnLockCF, maybe_locked_keys, lock_kvs);
+  }
+  if (tracker != nullptr) {
+    tracker->AddLockCfTime(Helper::TimestampNs() - lock_start_time_ns);
+  }
+  if (!ret.ok()) {
+    DINGO_LOG(FATAL) << "[txn]BatchGet batch get lock info failed, keys_count: " << keys.size()
+                     << ", status: " << ret.error_str();
+  }
+
+  // find the first lock conflict key, only keys before it will be read
+  size_t key_count = keys.size();
+  for (size_t i = 0, j = 0; i < keys.size() && j < lock_kvs.size(); ++i) {
+    if (lock_kvs[j].key() != lock_keys[i]) {
+      continue;
+    }
+
+    const auto &lock_value = lock_kvs[j++].value();
+    if (lock_value.empty()) {
+      continue;
+    }
 
     pb::store::LockInfo lock_info;
-    auto ret = GetLockInfo(reader, key, lock_info);
-    if (!ret.ok()) {
-      DINGO_LOG(FATAL) << "[txn]BatchGet GetLockInfo failed, key: " << Helper::StringToHex(key)
-                       << ", status: " << ret.error_str();
+    if (!lock_info.ParseFromString(lock_value)) {
+      DINGO_LOG(FATAL) << "[txn]BatchGet parse lock info failed, lock_key: " << Helper::StringToHex(lock_keys[i])
+                       << ", lock_value: " << Helper::StringToHex(lock_value);
     }
 
     auto is_lock_conflict = CheckLockConflict(lock_info, isolation_level, start_ts, resolved_locks, txn_result_info);
     if (is_lock_conflict) {
-      DINGO_LOG(WARNING) << "[txn]BatchGet CheckLockConflict return conflict, key: " << Helper::StringToHex(key)
+      DINGO_LOG(WARNING) << "[txn]BatchGet CheckLockConflict return conflict, key: " << Helper::StringToHex(keys[i])
                          << ", isolation_level: " << isolation_level << ", start_ts: " << start_ts
                          << ", lock_info: " << lock_info.ShortDebugString();
-      return butil::Status::OK();
+      key_count = i;
+      break;
     }
+  }
 
-    int64_t iter_start_ts;
-    bool is_valid = false;
-    if (isolation_level == pb::store::IsolationLevel::SnapshotIsolation) {
-      iter_start_ts = start_ts;
-    } else if (isolation_level == pb::store::IsolationLevel::ReadCommitted) {
-      iter_start_ts = Constant::kMaxVer;
-    } else {
-      DINGO_LOG(ERROR) << "[txn]BatchGet invalid isolation_level: " << isolation_level;
-      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "invalid isolation_level");
-    }
+  int64_t iter_start_ts;
+  if (isolation_level == pb::store::IsolationLevel::SnapshotIsolation) {
+    iter_start_ts = start_ts;
+  } else {
+    iter_start_ts = Constant::kMaxVer;
+  }
 
-    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
-        << "key: " << Helper::StringToHex(key) << ", iter_start_ts: " << iter_start_ts;
+  // for every key before the conflict key, find the latest write below our start_ts,
+  // short value is taken from write_info directly, others are collected and read from data_cf in batch
+  std::vector<pb::common::KeyValue> result_kvs(key_count);
+  std::vector<std::string> data_keys;
+  std::vector<size_t> data_key_indexes;
 
-    IteratorOptions iter_options;
-    iter_options.lower_bound = Helper::EncodeTxnKey(key, iter_start_ts);
-    iter_options.upper_bound = Helper::EncodeTxnKey(key, 0);
-    auto iter = reader->NewIterator(Constant::kTxnWriteCF, iter_options);
-    if (iter == nullptr) {
-      DINGO_LOG(FATAL) << "[txn]BatchGet NewIterator failed, start_ts: " << start_ts;
-    }
+  // one write_cf iterator is shared by all keys, keys are visited in order so the iterator only moves forward,
+  // the range of every key is checked here instead of iterator bounds.
+  std::vector<size_t> key_indexes(key_count);
+  for (size_t i = 0; i < key_count; ++i) {
+    key_indexes[i] = i;
+  }
+  std::sort(key_indexes.begin(), key_indexes.end(), [&keys](size_t lhs, size_t rhs) { return keys[lhs] < keys[rhs]; });
+
+  IteratorOptions iter_options;
+  iter_options.prefix_seek = true;
+  auto iter = reader->NewIterator(Constant::kTxnWriteCF, iter_options);
+  if (iter == nullptr) {
+    DINGO_LOG(FATAL) << "[txn]BatchGet NewIterator failed, start_ts: " << start_ts;
+  }
+
+  for (auto i : key_indexes) {
+    const auto &key = keys[i];
+    auto &kv = result_kvs[i];
+    kv.set_key(key);
+
+    std::string lower_bound = Helper::EncodeTxnKey(key, iter_start_ts);
+    std::string upper_bound = Helper::EncodeTxnKey(key, 0);
 
     DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
-        << "iter_options.lower_bound: " << Helper::StringToHex(iter_options.lower_bound)
-        << ", iter_options.upper_bound: " << Helper::StringToHex(iter_options.upper_bound);
+        << "key: " << Helper::StringToHex(key) << ", iter_start_ts: " << iter_start_ts
+        << ", lower_bound: " << Helper::StringToHex(lower_bound) << ", upper_bound: " << Helper::StringToHex(upper_bound);
 
     // check isolation level and return value
-    iter->Seek(iter_options.lower_bound);
-    while (iter->Valid()) {
+    iter->Seek(lower_bound);
+    while (iter->Valid() && iter->Key() < upper_bound) {
       if (iter->Key().length() <= 8) {
         DINGO_LOG(ERROR) << ", invalid write_key, key: " << Helper::StringToHex(iter->Key())
                          << ", start_ts: " << start_ts
@@ -929,16 +1157,8 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
           break;
         }
 
-        auto ret1 =
-            reader->KvGet(Constant::kTxnDataCF, Helper::EncodeTxnKey(key, write_info.start_ts()), *kv.mutable_value());
-        if (!ret1.ok() && ret1.error_code() != pb::error::Errno::EKEY_NOT_FOUND) {
-          DINGO_LOG(FATAL) << "[txn]BatchGet read data failed, key: " << Helper::StringToHex(key)
-                           << ", status: " << ret1.error_str();
-        } else if (ret1.error_code() == pb::error::Errno::EKEY_NOT_FOUND) {
-          DINGO_LOG(ERROR) << "[txn]BatchGet read data failed, data is illegally not found, key: "
-                           << Helper::StringToHex(key) << ", status: " << ret1.error_str()
-                           << ", raw_key: " << Helper::EncodeTxnKey(key, write_info.start_ts());
-        }
+        data_keys.push_back(Helper::EncodeTxnKey(key, write_info.start_ts()));
+        data_key_indexes.push_back(i);
         break;
       } else {
         DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -948,9 +1168,32 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
 
       iter->Next();
     }
+  }
+
+  // read data from data_cf in one batch
+  if (!data_keys.empty()) {
+    std::vector<pb::common::KeyValue> data_kvs;
+    auto ret1 = reader->KvBatchGet(Constant::kTxnDataCF, data_keys, data_kvs);
+    if (!ret1.ok()) {
+      DINGO_LOG(FATAL) << "[txn]BatchGet read data failed, data_keys_count: " << data_keys.size()
+                       << ", status: " << ret1.error_str();
+    }
+
+    for (size_t i = 0, j = 0; i < data_keys.size(); ++i) {
+      if (j < data_kvs.size() && data_kvs[j].key() == data_keys[i]) {
+        result_kvs[data_key_indexes[i]].set_value(std::move(*data_kvs[j].mutable_value()));
+        ++j;
+      } else {
+        DINGO_LOG(ERROR) << "[txn]BatchGet read data failed, data is illegally not found, key: "
+                         << Helper::StringToHex(keys[data_key_indexes[i]]) << ", raw_key: " << data_keys[i];
+      }
+    }
+  }
 
-    kvs.emplace_back(kv);
+  int64_t response_memory_size = 0;
+  for (auto &kv : result_kvs) {
     response_memory_size += kv.ByteSizeLong();
+    kvs.push_back(std::move(kv));
 
     if (response_memory_size >= FLAGS_max_batch_get_memory_size) {
       DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -971,7 +1214,7 @@ butil::Status TxnEngineHelper::Scan(RawEnginePtr raw_engine, const pb::store::Is
                                     bool is_reverse, const std::set<int64_t> &resolved_locks, bool disable_coprocessor,
                                     const pb::common::CoprocessorV2 &coprocessor,
                                     pb::store::TxnResultInfo &txn_result_info, std::vector<pb::common::KeyValue> &kvs,
-                                    bool &has_more, std::string &end_scan_key) {
+                                    bool &has_more, std::string &end_scan_key, TrackerPtr tracker) {
   BvarLatencyGuard bvar_guard(&g_txn_scan_latency);
 
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -1012,7 +1255,7 @@ butil::Status TxnEngineHelper::Scan(RawEnginePtr raw_engine, const pb::store::Is
   }
 
   std::shared_ptr<TxnIterator> txn_iter =
-      std::make_shared<TxnIterator>(raw_engine, range, start_ts, isolation_level, resolved_locks);
+      std::make_shared<TxnIterator>(raw_engine, range, start_ts, isolation_level, resolved_locks, is_reverse);
   auto ret = txn_iter->Init();
   if (!ret.ok()) {
     DINGO_LOG(ERROR) << "[txn]Scan init txn_iter failed, start_ts: " << start_ts
@@ -1020,8 +1263,7 @@ butil::Status TxnEngineHelper::Scan(RawEnginePtr raw_engine, const pb::store::Is
     return ret;
   }
 
-  int64_t response_memory_size = 0;
-  txn_iter->Seek(range.start_key());
+  txn_iter->Seek(is_reverse ? range.end_key() : range.start_key());
 
   if (!disable_coprocessor) {
     std::shared_ptr<RawCoprocessor> txn_coprocessor = std::make_shared<CoprocessorV2>();
@@ -1032,8 +1274,12 @@ butil::Status TxnEngineHelper::Scan(RawEnginePtr raw_engine, const pb::store::Is
       return status;
     }
 
+    int64_t coprocessor_start_time_ns = Helper::TimestampNs();
     status =
         txn_coprocessor->Execute(txn_iter, limit, key_only, is_reverse, txn_result_info, kvs, has_more, end_scan_key);
+    if (tracker != nullptr) {
+      tracker->AddCoprocessorTime(Helper::TimestampNs() - coprocessor_start_time_ns);
+    }
     if (!status.ok()) {
       DINGO_LOG(ERROR) << "[txn]Scan coprocessor::Execute failed " << status.error_cstr();
       return status;
@@ -1045,6 +1291,14 @@ butil::Status TxnEngineHelper::Scan(RawEnginePtr raw_engine, const pb::store::Is
     return butil::Status::OK();
   }
 
+  return ScanNext(txn_iter, limit, key_only, txn_result_info, kvs, has_more, end_scan_key);
+}
+
+butil::Status TxnEngineHelper::ScanNext(std::shared_ptr<TxnIterator> txn_iter, int64_t limit, bool key_only,
+                                        pb::store::TxnResultInfo &txn_result_info,
+                                        std::vector<pb::common::KeyValue> &kvs, bool &has_more,
+                                        std::string &end_scan_key) {
+  int64_t response_memory_size = 0;
   while (txn_iter->Valid(txn_result_info)) {
     auto key = txn_iter->Key();
     auto value = txn_iter->Value();
@@ -1080,6 +1334,80 @@ butil::Status TxnEngineHelper::Scan(RawEnginePtr raw_engine, const pb::store::Is
   return butil::Status::OK();
 }
 
+butil::Status TxnEngineHelper::ScanWithCursor(RawEnginePtr raw_engine, const pb::store::IsolationLevel &isolation_level,
+                                              int64_t start_ts, const pb::common::Range &range, int64_t limit,
+                                              bool key_only, const std::set<int64_t> &resolved_locks,
+                                              int64_t region_id, int64_t epoch_version, int64_t &scan_id,
+                                              pb::store::TxnResultInfo &txn_result_info,
+                                              std::vector<pb::common::KeyValue> &kvs, bool &has_more,
+                                              std::string &end_scan_key) {
+  BvarLatencyGuard bvar_guard(&g_txn_scan_latency);
+
+  int64_t last_scan_id = scan_id;
+  scan_id = 0;
+
+  if (BAIDU_UNLIKELY(limit > FLAGS_max_scan_line_limit)) {
+    DINGO_LOG(ERROR) << "[txn]ScanWithCursor limit: " << limit
+                     << " is too large, max_scan_line_limit: " << FLAGS_max_scan_line_limit;
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "scan limit is too large");
+  }
+
+  // The snapshot kept by cursor is only consistent for snapshot isolation.
+  if (isolation_level != pb::store::SnapshotIsolation) {
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "invalid isolation_level");
+  }
+
+  if (limit == 0) {
+    if (last_scan_id > 0) {
+      TxnScanCursorManager::GetInstance().Take(last_scan_id);
+    }
+    return butil::Status::OK();
+  }
+
+  TxnScanCursorPtr cursor = nullptr;
+  if (last_scan_id > 0) {
+    cursor = TxnScanCursorManager::GetInstance().Take(last_scan_id);
+    if (cursor != nullptr && !cursor->IsNextPage(region_id, epoch_version, start_ts, key_only, range)) {
+      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+          << "[txn]ScanWithCursor cursor not match, scan_id: " << last_scan_id << ", region_id: " << region_id
+          << ", start_ts: " << start_ts << ", range: " << Helper::RangeToString(range);
+      cursor = nullptr;
+    }
+  }
+
+  if (cursor == nullptr) {
+    cursor = std::make_shared<TxnScanCursor>();
+    cursor->region_id = region_id;
+    cursor->epoch_version = epoch_version;
+    cursor->start_ts = start_ts;
+    cursor->key_only = key_only;
+    cursor->end_key = range.end_key();
+    cursor->txn_iter =
+        std::make_shared<TxnIterator>(raw_engine, range, start_ts, isolation_level, resolved_locks, false);
+    auto ret = cursor->txn_iter->Init();
+    if (!ret.ok()) {
+      DINGO_LOG(ERROR) << "[txn]ScanWithCursor init txn_iter failed, start_ts: " << start_ts
+                       << ", range: " << range.ShortDebugString() << ", status: " << ret.error_str();
+      return ret;
+    }
+    cursor->txn_iter->Seek(range.start_key());
+    last_scan_id = 0;
+  }
+
+  auto ret = ScanNext(cursor->txn_iter, limit, key_only, txn_result_info, kvs, has_more, end_scan_key);
+  if (!ret.ok()) {
+    return ret;
+  }
+
+  // The client resolves the lock and scans again without the cursor.
+  if (has_more && txn_result_info.ByteSizeLong() == 0) {
+    cursor->next_start_key = Helper::PrefixNext(end_scan_key);
+    scan_id = TxnScanCursorManager::GetInstance().Put(last_scan_id, cursor);
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status TxnEngineHelper::GetWriteInfo(RawEnginePtr engine, int64_t min_commit_ts, int64_t max_commit_ts,
                                             int64_t start_ts, const std::string &key, bool include_rollback,
                                             bool include_delete, bool include_put, pb::store::WriteInfo &write_info,
@@ -1250,6 +1578,7 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
   auto *error = response->mutable_error();
 
   auto reader = raw_engine->Reader();
+  auto lock_table = TxnLockTableManager::GetInstance().Get(region->Id());
   // for every mutation, check and do lock, if any one of the mutation is failed, the whole lock is failed
   // 1. check if a lock is exists:
   for (const auto &mutation : mutations) {
@@ -1264,7 +1593,7 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
     // 1.check if the key is locked
     //   if the key is locked, return LockInfo
     pb::store::LockInfo lock_info;
-    auto ret = GetLockInfo(reader, mutation.key(), lock_info);
+    auto ret = GetLockInfo(lock_table, reader, mutation.key(), lock_info);
     if (!ret.ok()) {
       // Now we need to fatal exit to prevent data inconsistency between raft peers
       DINGO_LOG(ERROR) << fmt::format("[txn][region({})] PessimisticLock, start_ts: {}", region->Id(), start_ts)
@@ -1714,6 +2043,7 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
   auto *error = response->mutable_error();
 
   auto reader = raw_engine->Reader();
+  auto lock_table = TxnLockTableManager::GetInstance().Get(region->Id());
   // for every mutation, check and do prewrite, if any one of the mutation is failed, the whole prewrite is failed
   for (int64_t i = 0; i < mutations.size(); i++) {
     const auto &mutation = mutations[i];
@@ -1721,7 +2051,7 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
     // 1.check if the key is locked
     //   if the key is locked, return LockInfo
     pb::store::LockInfo prev_lock_info;
-    auto ret = GetLockInfo(reader, mutation.key(), prev_lock_info);
+    auto ret = GetLockInfo(lock_table, reader, mutation.key(), prev_lock_info);
     if (!ret.ok()) {
       // TODO: do read before write to raft state machine
       // Now we need to fatal exit to prevent data inconsistency between raft peers
@@ -2487,6 +2817,9 @@ butil::Status TxnEngineHelper::DoTxnCommit(RawEnginePtr raw_engine, std::shared_
 
       kv_puts_write.push_back(kv);
 
+      // Only the vector index is derived from the committed row, its index is inside the region itself.
+      // Entries of scalar index belong to other regions and raft groups, they can not be written atomically here,
+      // so the executor still prewrites and commits them with the row in the same transaction.
       if (region->Type() == pb::common::INDEX_REGION &&
           region->Definition().index_parameter().has_vector_index_parameter()) {
         if (lock_info.lock_type() == pb::store::Op::Put) {
@@ -3835,6 +4168,7 @@ void TxnEngineHelper::RegularUpdateSafePointTsHandler(void * /*arg*/) {
   int64_t safe_point_ts = response.safe_point();
 
   gc_safe_point->SetGcFlagAndSafePointTs(gc_stop, safe_point_ts);
+  TxnGcCompactionFilterFactory::SetSafePointTs(gc_stop ? 0 : safe_point_ts);
 }
 
 // readme .
@@ -3851,6 +4185,140 @@ void TxnEngineHelper::RegularUpdateSafePointTsHandler(void * /*arg*/) {
 #endif
 #undef ENABLE_TXN_GC_REMEMBER_LAST_ACCOMPLISHED_SAFE_POINT_TS
 
+// Gc one leader region, return false if gc is stopped.
+static bool DoRegionTxnGc(std::shared_ptr<Storage> storage, std::shared_ptr<Engine> engine,
+                          std::shared_ptr<GCSafePoint> gc_safe_point, store::RegionPtr region_ptr,
+                          int64_t safe_point_ts) {
+  butil::Status status;
+  status = storage->ValidateLeader(region_ptr->Id());
+  if (!status.ok()) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << fmt::format(
+        "region_id : {} is not leader yet. start_key : {} end_key : {}. ignore.", region_ptr->Id(),
+        Helper::StringToHex(region_ptr->Range().start_key()), Helper::StringToHex(region_ptr->Range().end_key()));
+    return true;
+  } else {
+    if (pb::common::StoreRegionState::NORMAL != region_ptr->State()) {
+      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << fmt::format(
+          "region_id : {} is leader. but state is not normal : {}.  start_key : {} end_key : {}.  ignore.",
+          region_ptr->Id(), static_cast<int>(region_ptr->State()),
+          Helper::StringToHex(region_ptr->Range().start_key()), Helper::StringToHex(region_ptr->Range().end_key()));
+      return true;
+    }
+  }
+
+  auto [internal_gc_stop, internal_safe_point_ts] = gc_safe_point->GetGcFlagAndSafePointTs();
+
+  if (internal_gc_stop) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << fmt::format(
+        "set internal_gc_stop stop, region_id : {} .  start_key : {} end_key : {}. return", region_ptr->Id(),
+        Helper::StringToHex(region_ptr->Range().start_key()), Helper::StringToHex(region_ptr->Range().end_key()));
+    gc_safe_point->SetForceGcStop(true);
+    return false;
+  }
+
+  if (safe_point_ts < internal_safe_point_ts) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << fmt::format(
+        "current safe_point_ts : {}. newest safe_point_ts : {}. Don't worry, we'll deal with it next time. "
+        "ignore.",
+        safe_point_ts, internal_safe_point_ts);
+  }
+
+  dingodb::pb::store::TxnGcRequest request;
+  dingodb::pb::store::TxnGcResponse response;
+
+  std::shared_ptr<Context> ctx = std::make_shared<Context>(nullptr, nullptr, &request, &response);
+  ctx->SetRegionId(region_ptr->Id());
+  ctx->SetCfName(Constant::kStoreDataCF);
+  ctx->SetRegionEpoch(region_ptr->Epoch());
+  ctx->SetIsolationLevel(::dingodb::pb::store::IsolationLevel::ReadCommitted);
+  ctx->SetRawEngineType(region_ptr->GetRawEngineType());
+
+  std::shared_ptr<Engine::TxnWriter> writer = engine->NewTxnWriter(ctx->RawEngineType());
+  if (nullptr == writer) {
+    DINGO_LOG(ERROR) << fmt::format("writer is nullptr, region_id : {}.  start_key : {} end_key : {} ",
+                                    ctx->RegionId(), Helper::StringToHex(region_ptr->Range().start_key()),
+                                    Helper::StringToHex(region_ptr->Range().end_key()));
+    return false;
+  }
+
+  // versions written during gc are kept for next round
+  auto region_metrics = Server::GetInstance().GetStoreMetricsManager()->GetStoreRegionMetrics()->GetMetrics(
+      region_ptr->Id());
+  int64_t gc_versions = region_metrics != nullptr ? region_metrics->TxnGcVersions() : 0;
+
+  status = writer->TxnGc(ctx, safe_point_ts);
+  if (status.ok() && region_metrics != nullptr) {
+    region_metrics->SubTxnGcVersions(gc_versions);
+  }
+
+  if (gc_safe_point->GetForceGcStop()) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << fmt::format(
+        "gc_stop stopped, region_id : {}.  start_key : {} end_key : {}.  return", ctx->RegionId(),
+        Helper::StringToHex(region_ptr->Range().start_key()), Helper::StringToHex(region_ptr->Range().end_key()));
+    return false;
+  }
+
+  return true;
+}
+
+std::vector<int64_t> TxnEngineHelper::PickTxnGcRegionIds(const std::vector<TxnGcCandidate> &candidates) {
+  std::vector<TxnGcCandidate> picked;
+  for (const auto &candidate : candidates) {
+    double garbage_ratio =
+        static_cast<double>(candidate.versions) / std::max(static_cast<int64_t>(1), candidate.key_count);
+    if (candidate.versions >= FLAGS_txn_gc_min_versions && garbage_ratio >= FLAGS_txn_gc_garbage_ratio_threshold) {
+      picked.push_back(candidate);
+    }
+  }
+
+  // the most garbage first
+  std::sort(picked.begin(), picked.end(),
+            [](const TxnGcCandidate &lhs, const TxnGcCandidate &rhs) { return lhs.versions > rhs.versions; });
+  if (FLAGS_txn_gc_max_regions_per_round > 0 &&
+      static_cast<int64_t>(picked.size()) > FLAGS_txn_gc_max_regions_per_round) {
+    picked.resize(FLAGS_txn_gc_max_regions_per_round);
+  }
+
+  std::vector<int64_t> region_ids;
+  region_ids.reserve(picked.size());
+  for (const auto &candidate : picked) {
+    region_ids.push_back(candidate.region_id);
+  }
+  return region_ids;
+}
+
+std::vector<store::RegionPtr> TxnEngineHelper::PickTxnGcRegions(const std::vector<store::RegionPtr> &region_ptrs) {
+  // every region is gc in full round, for the versions not counted after restart and the versions protected by
+  // old safe point in last gc.
+  static std::atomic<int64_t> g_txn_gc_round(0);
+  int64_t round = g_txn_gc_round.fetch_add(1);
+  if (FLAGS_txn_gc_full_interval_rounds <= 1 || round % FLAGS_txn_gc_full_interval_rounds == 0) {
+    DINGO_LOG(INFO) << fmt::format("[txn_gc] full gc round, region count: {}", region_ptrs.size());
+    return region_ptrs;
+  }
+
+  auto store_region_metrics = Server::GetInstance().GetStoreMetricsManager()->GetStoreRegionMetrics();
+  std::map<int64_t, store::RegionPtr> id_to_region;
+  std::vector<TxnGcCandidate> candidates;
+  for (const auto &region_ptr : region_ptrs) {
+    auto region_metrics = store_region_metrics->GetMetrics(region_ptr->Id());
+    if (region_metrics == nullptr) {
+      continue;
+    }
+    id_to_region[region_ptr->Id()] = region_ptr;
+    candidates.push_back({region_ptr->Id(), region_metrics->TxnGcVersions(), region_metrics->KeyCount()});
+  }
+
+  std::vector<store::RegionPtr> picked;
+  for (auto region_id : PickTxnGcRegionIds(candidates)) {
+    picked.push_back(id_to_region[region_id]);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[txn_gc] pick {} regions to gc by garbage ratio, region count: {}", picked.size(),
+                                 region_ptrs.size());
+  return picked;
+}
+
 void TxnEngineHelper::RegularDoGcHandler(void * /*arg*/) {
   static std::atomic<bool> g_regular_do_gc_handler_running(false);
 
@@ -3861,6 +4329,13 @@ void TxnEngineHelper::RegularDoGcHandler(void * /*arg*/) {
   }
 
   AtomicGuard guard(g_regular_do_gc_handler_running);
+
+  // versions are dropped by compaction filter on every replica, only TxnGc request gc by raft.
+  if (FLAGS_enable_txn_gc_compaction_filter) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << "[txn_gc] gc by compaction filter, skip regular gc.";
+    return;
+  }
+
   std::shared_ptr<StoreMetaManager> store_meta_manager = Server::GetInstance().GetStoreMetaManager();
 
   std::shared_ptr<GCSafePoint> gc_safe_point = store_meta_manager->GetGCSafePoint();
@@ -3924,71 +4399,42 @@ void TxnEngineHelper::RegularDoGcHandler(void * /*arg*/) {
         Helper::StringToHex(region_ptr->Range().start_key()), Helper::StringToHex(region_ptr->Range().end_key()));
   }
 
+  if (FLAGS_enable_txn_gc_by_garbage_ratio) {
+    leader_region_ptrs = PickTxnGcRegions(leader_region_ptrs);
+  }
+
   std::shared_ptr<Engine> engine = storage->GetEngine();
 
   // Caution !!!
   // We will not use a snapshot globally because it will affect other region compaction.
-  for (const auto &region_ptr : leader_region_ptrs) {
-    butil::Status status;
-    status = storage->ValidateLeader(region_ptr->Id());
-    if (!status.ok()) {
-      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << fmt::format(
-          "region_id : {} is not leader yet. start_key : {} end_key : {}. ignore.", region_ptr->Id(),
-          Helper::StringToHex(region_ptr->Range().start_key()), Helper::StringToHex(region_ptr->Range().end_key()));
-      continue;
-    } else {
-      if (pb::common::StoreRegionState::NORMAL != region_ptr->State()) {
-        DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << fmt::format(
-            "region_id : {} is leader. but state is not normal : {}.  start_key : {} end_key : {}.  ignore.",
-            region_ptr->Id(), static_cast<int>(region_ptr->State()),
-            Helper::StringToHex(region_ptr->Range().start_key()), Helper::StringToHex(region_ptr->Range().end_key()));
-        continue;
+  int64_t concurrency = std::min(static_cast<int64_t>(leader_region_ptrs.size()),
+                                 std::max(static_cast<int64_t>(1), FLAGS_txn_gc_concurrency));
+  std::atomic<size_t> next_index{0};
+  std::atomic<bool> is_stop{false};
+  auto gc_func = [&]() {
+    for (size_t i = next_index.fetch_add(1); i < leader_region_ptrs.size() && !is_stop.load();
+         i = next_index.fetch_add(1)) {
+      if (!DoRegionTxnGc(storage, engine, gc_safe_point, leader_region_ptrs[i], safe_point_ts)) {
+        is_stop.store(true);
+        break;
+      }
+      if (FLAGS_txn_gc_region_interval_ms > 0) {
+        bthread_usleep(FLAGS_txn_gc_region_interval_ms * 1000);
       }
     }
+  };
 
-    auto [internal_gc_stop, internal_safe_point_ts] = gc_safe_point->GetGcFlagAndSafePointTs();
-
-    if (internal_gc_stop) {
-      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << fmt::format(
-          "set internal_gc_stop stop, region_id : {} .  start_key : {} end_key : {}. return", region_ptr->Id(),
-          Helper::StringToHex(region_ptr->Range().start_key()), Helper::StringToHex(region_ptr->Range().end_key()));
-      gc_safe_point->SetForceGcStop(true);
-      return;
-    }
-
-    if (safe_point_ts < internal_safe_point_ts) {
-      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << fmt::format(
-          "current safe_point_ts : {}. newest safe_point_ts : {}. Don't worry, we'll deal with it next time. "
-          "ignore.",
-          safe_point_ts, internal_safe_point_ts);
-    }
-
-    dingodb::pb::store::TxnGcRequest request;
-    dingodb::pb::store::TxnGcResponse response;
-
-    std::shared_ptr<Context> ctx = std::make_shared<Context>(nullptr, nullptr, &request, &response);
-    ctx->SetRegionId(region_ptr->Id());
-    ctx->SetCfName(Constant::kStoreDataCF);
-    ctx->SetRegionEpoch(region_ptr->Epoch());
-    ctx->SetIsolationLevel(::dingodb::pb::store::IsolationLevel::ReadCommitted);
-    ctx->SetRawEngineType(region_ptr->GetRawEngineType());
-
-    std::shared_ptr<Engine::TxnWriter> writer = engine->NewTxnWriter(ctx->RawEngineType());
-    if (nullptr == writer) {
-      DINGO_LOG(ERROR) << fmt::format("writer is nullptr, region_id : {}.  start_key : {} end_key : {} ",
-                                      ctx->RegionId(), Helper::StringToHex(region_ptr->Range().start_key()),
-                                      Helper::StringToHex(region_ptr->Range().end_key()));
-      return;
-    }
-
-    status = writer->TxnGc(ctx, safe_point_ts);
+  std::vector<Bthread> workers;
+  for (int64_t i = 1; i < concurrency; ++i) {
+    workers.emplace_back(gc_func);
+  }
+  gc_func();
+  for (auto &worker : workers) {
+    worker.Join();
+  }
 
-    if (gc_safe_point->GetForceGcStop()) {
-      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << fmt::format(
-          "gc_stop stopped, region_id : {}.  start_key : {} end_key : {}.  return", ctx->RegionId(),
-          Helper::StringToHex(region_ptr->Range().start_key()), Helper::StringToHex(region_ptr->Range().end_key()));
-      return;
-    }
+  if (is_stop.load()) {
+    return;
   }
 
 #if defined(ENABLE_TXN_GC_REMEMBER_LAST_ACCOMPLISHED_SAFE_POINT_TS)
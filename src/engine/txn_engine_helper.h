@@ -23,8 +23,10 @@
 
 #include "butil/status.h"
 #include "common/constant.h"
+#include "common/tracker.h"
 #include "engine/engine.h"
 #include "engine/raw_engine.h"
+#include "engine/txn_lock_table.h"
 #include "meta/store_meta_manager.h"
 #include "proto/store.pb.h"
 
@@ -33,12 +35,14 @@ namespace dingodb {
 class TxnIterator {
  public:
   TxnIterator(RawEnginePtr raw_engine, const pb::common::Range &range, int64_t start_ts,
-              pb::store::IsolationLevel isolation_level, const std::set<int64_t> &resolved_locks)
+              pb::store::IsolationLevel isolation_level, const std::set<int64_t> &resolved_locks,
+              bool is_reverse = false)
       : raw_engine_(raw_engine),
         range_(range),
         isolation_level_(isolation_level),
         start_ts_(start_ts),
-        resolved_locks_(resolved_locks) {
+        resolved_locks_(resolved_locks),
+        is_reverse_(is_reverse) {
     if (isolation_level == pb::store::IsolationLevel::ReadCommitted) {
       seek_ts_ = Constant::kMaxVer;
     } else {
@@ -48,6 +52,8 @@ class TxnIterator {
 
   ~TxnIterator() = default;
   butil::Status Init();
+  // Forward iterator seek to the first user key >= key,
+  // reverse iterator seek to the last user key < key, and Next() goes to the smaller user key.
   butil::Status Seek(const std::string &key);
   butil::Status InnerSeek(const std::string &key);
   butil::Status Next();
@@ -71,6 +77,12 @@ class TxnIterator {
  private:
   butil::Status GetCurrentValue();
 
+  // Reverse iteration, write_iter_ and lock_iter_ are positioned at the last entry of the next smaller user key.
+  butil::Status InnerSeekForPrev(const std::string &key);
+  butil::Status InnerPrev();
+  butil::Status ReverseMoveToUserKey();
+  butil::Status GetPrevUserValueInWriteIter();
+
   RawEnginePtr raw_engine_;
   pb::common::Range range_;
   int64_t start_ts_;
@@ -91,6 +103,8 @@ class TxnIterator {
   // The resolved locks are used to check the lock conflict.
   // If the lock is resolved, there will not be a conflict for provided resolved_locks.
   std::set<int64_t> resolved_locks_;
+
+  bool is_reverse_{false};
 };
 
 class TxnEngineHelper {
@@ -100,6 +114,9 @@ class TxnEngineHelper {
                                 pb::store::TxnResultInfo &txn_result_info);
 
   static butil::Status GetLockInfo(RawEngine::ReaderPtr reader, const std::string &key, pb::store::LockInfo &lock_info);
+  // Skip reading lock cf if the lock table of region says the key is not locked.
+  static butil::Status GetLockInfo(TxnLockTablePtr lock_table, RawEngine::ReaderPtr reader, const std::string &key,
+                                   pb::store::LockInfo &lock_info);
 
   static butil::Status ScanLockInfo(RawEnginePtr raw_engine, int64_t min_lock_ts, int64_t max_lock_ts,
                                     const pb::common::Range &range, int64_t limit,
@@ -109,13 +126,31 @@ class TxnEngineHelper {
   static butil::Status BatchGet(RawEnginePtr raw_engine, const pb::store::IsolationLevel &isolation_level,
                                 int64_t start_ts, const std::vector<std::string> &keys,
                                 const std::set<int64_t> &resolved_locks, pb::store::TxnResultInfo &txn_result_info,
-                                std::vector<pb::common::KeyValue> &kvs);
+                                std::vector<pb::common::KeyValue> &kvs, TxnLockTablePtr lock_table = nullptr,
+                                TrackerPtr tracker = nullptr);
 
   static butil::Status Scan(RawEnginePtr raw_engine, const pb::store::IsolationLevel &isolation_level, int64_t start_ts,
                             const pb::common::Range &range, int64_t limit, bool key_only, bool is_reverse,
                             const std::set<int64_t> &resolved_locks, bool disable_coprocessor,
                             const pb::common::CoprocessorV2 &coprocessor, pb::store::TxnResultInfo &txn_result_info,
-                            std::vector<pb::common::KeyValue> &kvs, bool &has_more, std::string &end_scan_key);
+                            std::vector<pb::common::KeyValue> &kvs, bool &has_more, std::string &end_scan_key,
+                            TrackerPtr tracker = nullptr);
+
+  // Iterate the next page from the current position of txn_iter.
+  static butil::Status ScanNext(std::shared_ptr<TxnIterator> txn_iter, int64_t limit, bool key_only,
+                                pb::store::TxnResultInfo &txn_result_info, std::vector<pb::common::KeyValue> &kvs,
+                                bool &has_more, std::string &end_scan_key);
+
+  // Forward scan without coprocessor which keeps the TxnIterator in a TxnScanCursor across pages.
+  // scan_id is the cursor of last page, 0 or a not matched cursor starts a new iterator.
+  // scan_id is set to the cursor of next page, 0 if there is no next page or the scan can not continue by cursor.
+  static butil::Status ScanWithCursor(RawEnginePtr raw_engine, const pb::store::IsolationLevel &isolation_level,
+                                      int64_t start_ts, const pb::common::Range &range, int64_t limit, bool key_only,
+                                      const std::set<int64_t> &resolved_locks, int64_t region_id,
+                                      int64_t epoch_version, int64_t &scan_id,
+                                      pb::store::TxnResultInfo &txn_result_info,
+                                      std::vector<pb::common::KeyValue> &kvs, bool &has_more,
+                                      std::string &end_scan_key);
 
   static butil::Status GetWriteInfo(RawEnginePtr raw_engine, int64_t min_commit_ts, int64_t max_commit_ts,
                                     int64_t start_ts, const std::string &key, bool include_rollback,
@@ -205,6 +240,20 @@ class TxnEngineHelper {
 
   static void RegularUpdateSafePointTsHandler(void *arg);
   static void RegularDoGcHandler(void *arg);
+
+  struct TxnGcCandidate {
+    int64_t region_id;
+    // versions written since last gc
+    int64_t versions;
+    int64_t key_count;
+  };
+
+  // Regions whose garbage ratio(versions / key_count) reach threshold are picked, the most garbage first,
+  // at most txn_gc_max_regions_per_round regions.
+  static std::vector<int64_t> PickTxnGcRegionIds(const std::vector<TxnGcCandidate> &candidates);
+
+  // Pick regions to gc of this round, all regions in full gc round.
+  static std::vector<store::RegionPtr> PickTxnGcRegions(const std::vector<store::RegionPtr> &region_ptrs);
 };
 
 }  // namespace dingodb
@@ -0,0 +1,156 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "engine/txn_gc_compaction_filter.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "bvar/reducer.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/store.pb.h"
+#include "rocksdb/write_batch.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_txn_gc_compaction_filter, false,
+            "gc txn write cf by compaction filter on every replica, instead of deleting by raft log");
+
+bvar::Adder<int64_t> g_txn_gc_compaction_filter_write_count("dingo_txn_gc_compaction_filter_write_count");
+bvar::Adder<int64_t> g_txn_gc_compaction_filter_data_count("dingo_txn_gc_compaction_filter_data_count");
+
+static std::atomic<int64_t> g_safe_point_ts{0};
+
+TxnGcCompactionFilter::TxnGcCompactionFilter(int64_t safe_point_ts, rocksdb::DB* db,
+                                             rocksdb::ColumnFamilyHandle* data_cf_handle)
+    : safe_point_ts_(safe_point_ts), db_(db), data_cf_handle_(data_cf_handle) {}
+
+TxnGcCompactionFilter::~TxnGcCompactionFilter() { FlushDataKeys(); }
+
+bool TxnGcCompactionFilter::Filter(int /*level*/, const rocksdb::Slice& key, const rocksdb::Slice& existing_value,
+                                   std::string* /*new_value*/, bool* /*value_changed*/) const {
+  if (key.size() <= 8) {
+    return false;
+  }
+
+  std::string_view write_key(key.data(), key.size());
+  std::string user_key;
+  int64_t write_ts = 0;
+  auto status = Helper::DecodeTxnKey(write_key, user_key, write_ts);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[txn_gc][compaction_filter] decode write key failed, key: {}",
+                                    Helper::StringToHex(write_key));
+    return false;
+  }
+
+  if (user_key != last_user_key_) {
+    last_user_key_ = user_key;
+    remove_older_ = false;
+  }
+
+  if (write_ts > safe_point_ts_) {
+    return false;
+  }
+
+  pb::store::WriteInfo write_info;
+  if (!write_info.ParseFromArray(existing_value.data(), existing_value.size())) {
+    DINGO_LOG(ERROR) << fmt::format("[txn_gc][compaction_filter] parse write info failed, key: {}",
+                                    Helper::StringToHex(write_key));
+    return false;
+  }
+
+  if (remove_older_) {
+    if (write_info.op() == pb::store::Op::Put && write_info.short_value().empty()) {
+      pending_data_keys_.push_back(Helper::EncodeTxnKey(user_key, write_info.start_ts()));
+    }
+    g_txn_gc_compaction_filter_write_count << 1;
+    return true;
+  }
+
+  switch (write_info.op()) {
+    case pb::store::Op::Put:
+    case pb::store::Op::Delete:
+      remove_older_ = true;
+      return false;
+    case pb::store::Op::Rollback:
+      g_txn_gc_compaction_filter_write_count << 1;
+      return true;
+    default:
+      return false;
+  }
+}
+
+void TxnGcCompactionFilter::FlushDataKeys() {
+  if (pending_data_keys_.empty() || db_ == nullptr || data_cf_handle_ == nullptr) {
+    return;
+  }
+
+  rocksdb::WriteBatch batch;
+  for (const auto& data_key : pending_data_keys_) {
+    batch.Delete(data_cf_handle_, data_key);
+  }
+
+  // Called in compaction thread, must not wait for write stall which waits for compaction.
+  rocksdb::WriteOptions write_options;
+  write_options.no_slowdown = true;
+  auto status = db_->Write(write_options, &batch);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[txn_gc][compaction_filter] delete data cf keys failed, count: {}, error: {}",
+                                    pending_data_keys_.size(), status.ToString());
+  } else {
+    g_txn_gc_compaction_filter_data_count << pending_data_keys_.size();
+  }
+
+  pending_data_keys_.clear();
+}
+
+void TxnGcCompactionFilterFactory::SetSafePointTs(int64_t safe_point_ts) {
+  g_safe_point_ts.store(safe_point_ts, std::memory_order_relaxed);
+}
+
+int64_t TxnGcCompactionFilterFactory::GetSafePointTs() { return g_safe_point_ts.load(std::memory_order_relaxed); }
+
+void TxnGcCompactionFilterFactory::SetDB(rocksdb::DB* db, rocksdb::ColumnFamilyHandle* data_cf_handle) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  db_ = db;
+  data_cf_handle_ = data_cf_handle;
+}
+
+std::unique_ptr<rocksdb::CompactionFilter> TxnGcCompactionFilterFactory::CreateCompactionFilter(
+    const rocksdb::CompactionFilter::Context& /*context*/) {
+  if (!FLAGS_enable_txn_gc_compaction_filter) {
+    return nullptr;
+  }
+
+  int64_t safe_point_ts = GetSafePointTs();
+  if (safe_point_ts <= 0) {
+    return nullptr;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (db_ == nullptr) {
+    return nullptr;
+  }
+
+  return std::make_unique<TxnGcCompactionFilter>(safe_point_ts, db_, data_cf_handle_);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,92 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ENGINE_TXN_GC_COMPACTION_FILTER_H_  // NOLINT
+#define DINGODB_ENGINE_TXN_GC_COMPACTION_FILTER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "rocksdb/compaction_filter.h"
+#include "rocksdb/db.h"
+
+namespace dingodb {
+
+// Drop the mvcc versions of txn write cf which are invisible at gc safe point during compaction.
+// Every replica gc its own data, no raft log is generated.
+// For a user key, the versions are visited from newer to older:
+//   1. write_ts > safe_point_ts, keep.
+//   2. the newest Put or Delete with write_ts <= safe_point_ts, keep, it is visible at safe point.
+//   3. all versions older than 2 are removed, the data cf value of removed Put is deleted too.
+//   4. Rollback before 2 is removed.
+// Only the versions in the compaction input are visible to the filter, so it is conservative:
+// the Delete of 2 is kept because older versions may be in the lower level.
+class TxnGcCompactionFilter : public rocksdb::CompactionFilter {
+ public:
+  // db and data_cf_handle are used to delete data cf values, nullptr means skip.
+  TxnGcCompactionFilter(int64_t safe_point_ts, rocksdb::DB* db, rocksdb::ColumnFamilyHandle* data_cf_handle);
+  ~TxnGcCompactionFilter() override;
+
+  bool Filter(int level, const rocksdb::Slice& key, const rocksdb::Slice& existing_value, std::string* new_value,
+              bool* value_changed) const override;
+
+  const char* Name() const override { return "dingodb.TxnGcCompactionFilter"; }
+
+  const std::vector<std::string>& PendingDataKeys() const { return pending_data_keys_; }
+
+  // Delete pending data cf keys, called at the end of compaction.
+  void FlushDataKeys();
+
+ private:
+  int64_t safe_point_ts_;
+  rocksdb::DB* db_;
+  rocksdb::ColumnFamilyHandle* data_cf_handle_;
+
+  // Filter is called by one compaction thread in key order.
+  mutable std::string last_user_key_;
+  mutable bool remove_older_{false};
+  mutable std::vector<std::string> pending_data_keys_;
+};
+
+class TxnGcCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
+ public:
+  TxnGcCompactionFilterFactory() = default;
+  ~TxnGcCompactionFilterFactory() override = default;
+
+  // Gc safe point of store, 0 means gc is stopped.
+  static void SetSafePointTs(int64_t safe_point_ts);
+  static int64_t GetSafePointTs();
+
+  // Set after db is opened, reset before db is closed.
+  void SetDB(rocksdb::DB* db, rocksdb::ColumnFamilyHandle* data_cf_handle);
+
+  std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
+      const rocksdb::CompactionFilter::Context& context) override;
+
+  const char* Name() const override { return "dingodb.TxnGcCompactionFilterFactory"; }
+
+ private:
+  bthread::Mutex mutex_;
+  rocksdb::DB* db_{nullptr};
+  rocksdb::ColumnFamilyHandle* data_cf_handle_{nullptr};
+};
+using TxnGcCompactionFilterFactoryPtr = std::shared_ptr<TxnGcCompactionFilterFactory>;
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TXN_GC_COMPACTION_FILTER_H_  // NOLINT
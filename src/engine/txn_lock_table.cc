@@ -0,0 +1,128 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "engine/txn_lock_table.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_txn_lock_table, false, "keep lock keys of txn region in memory on leader for skip lock cf lookup");
+DEFINE_int64(txn_lock_table_max_keys, 100000, "max lock keys of txn lock table, exceed it the table is not used");
+
+void TxnLockTable::Put(const std::string& lock_key) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (is_overflow_.load()) {
+    return;
+  }
+
+  lock_keys_.insert(lock_key);
+  size_.store(static_cast<int64_t>(lock_keys_.size()));
+  if (size_.load() > FLAGS_txn_lock_table_max_keys) {
+    is_overflow_.store(true);
+    lock_keys_.clear();
+  }
+}
+
+void TxnLockTable::Delete(const std::string& lock_key) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  lock_keys_.erase(lock_key);
+  size_.store(static_cast<int64_t>(lock_keys_.size()));
+}
+
+void TxnLockTable::DeleteRange(const std::string& start_lock_key, const std::string& end_lock_key) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  lock_keys_.erase(lock_keys_.lower_bound(start_lock_key), lock_keys_.lower_bound(end_lock_key));
+  size_.store(static_cast<int64_t>(lock_keys_.size()));
+}
+
+bool TxnLockTable::MaybeLocked(const std::string& lock_key) {
+  if (is_overflow_.load()) {
+    return true;
+  }
+  if (size_.load() == 0) {
+    return false;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  return is_overflow_.load() || lock_keys_.find(lock_key) != lock_keys_.end();
+}
+
+TxnLockTableManager& TxnLockTableManager::GetInstance() {
+  static TxnLockTableManager instance;
+  return instance;
+}
+
+void TxnLockTableManager::Load(store::RegionPtr region, RawEnginePtr raw_engine) {
+  if (!FLAGS_enable_txn_lock_table || region == nullptr || raw_engine == nullptr) {
+    return;
+  }
+
+  const auto& range = region->Range();
+  if (range.start_key().empty() ||
+      (!Helper::IsExecutorTxn(range.start_key()) && !Helper::IsClientTxn(range.start_key()))) {
+    return;
+  }
+
+  int64_t start_time = Helper::TimestampMs();
+
+  IteratorOptions iter_options;
+  iter_options.lower_bound = Helper::EncodeTxnKey(range.start_key(), Constant::kLockVer);
+  iter_options.upper_bound = Helper::EncodeTxnKey(range.end_key(), Constant::kLockVer);
+  auto iter = raw_engine->Reader()->NewIterator(Constant::kTxnLockCF, iter_options);
+  if (iter == nullptr) {
+    DINGO_LOG(ERROR) << fmt::format("[txn][region({})] load lock table failed, new iterator failed.", region->Id());
+    Remove(region->Id());
+    return;
+  }
+
+  auto lock_table = std::make_shared<TxnLockTable>();
+  for (iter->Seek(iter_options.lower_bound); iter->Valid() && !lock_table->IsOverflow(); iter->Next()) {
+    lock_table->Put(std::string(iter->Key()));
+  }
+
+  if (lock_table->IsOverflow()) {
+    DINGO_LOG(WARNING) << fmt::format("[txn][region({})] too many locks, not use lock table.", region->Id());
+    Remove(region->Id());
+    return;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[txn][region({})] load lock table finish, lock count: {} elapsed time: {}ms",
+                                 region->Id(), lock_table->Size(), Helper::TimestampMs() - start_time);
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  lock_tables_[region->Id()] = lock_table;
+}
+
+void TxnLockTableManager::Remove(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  lock_tables_.erase(region_id);
+}
+
+TxnLockTablePtr TxnLockTableManager::Get(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = lock_tables_.find(region_id);
+  return it == lock_tables_.end() ? nullptr : it->second;
+}
+
+}  // namespace dingodb
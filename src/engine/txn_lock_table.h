@@ -0,0 +1,87 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ENGINE_TXN_LOCK_TABLE_H_  // NOLINT
+#define DINGODB_ENGINE_TXN_LOCK_TABLE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "bthread/mutex.h"
+#include "engine/raw_engine.h"
+#include "meta/store_meta_manager.h"
+
+namespace dingodb {
+
+// In-memory lock keys of a txn region, only kept on leader.
+// Nearly all keys have no lock, so the lock cf lookup of reading or prewriting such keys can be skipped.
+// The table is always a superset of the lock cf, the lock key is added before written to engine when applying,
+// and removed after deleted from engine.
+class TxnLockTable {
+ public:
+  TxnLockTable() = default;
+  ~TxnLockTable() = default;
+
+  // The lock_key is the encoded key of lock cf.
+  void Put(const std::string& lock_key);
+  void Delete(const std::string& lock_key);
+  // Delete lock keys in [start_lock_key, end_lock_key).
+  void DeleteRange(const std::string& start_lock_key, const std::string& end_lock_key);
+
+  // False means the key is not locked for sure, true means lock cf need to be read.
+  bool MaybeLocked(const std::string& lock_key);
+
+  int64_t Size() { return size_.load(); }
+
+  // Too many locks, the table is not useful any more and always return true for MaybeLocked.
+  bool IsOverflow() { return is_overflow_.load(); }
+
+ private:
+  bthread::Mutex mutex_;
+  std::set<std::string> lock_keys_;
+  std::atomic<int64_t> size_{0};
+  std::atomic<bool> is_overflow_{false};
+};
+using TxnLockTablePtr = std::shared_ptr<TxnLockTable>;
+
+// Lock tables of all leader txn regions.
+class TxnLockTableManager {
+ public:
+  static TxnLockTableManager& GetInstance();
+
+  // Build lock table of region from lock cf when it becomes leader.
+  // Called in the state machine thread, so no lock cf is written by apply at the same time.
+  void Load(store::RegionPtr region, RawEnginePtr raw_engine);
+
+  // Called when leader stop, or lock cf is changed not by txn apply, e.g. install snapshot or merge region.
+  void Remove(int64_t region_id);
+
+  // Null if region has no lock table, then lock cf must be read.
+  TxnLockTablePtr Get(int64_t region_id);
+
+ private:
+  TxnLockTableManager() = default;
+
+  bthread::Mutex mutex_;
+  std::map<int64_t, TxnLockTablePtr> lock_tables_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TXN_LOCK_TABLE_H_  // NOLINT
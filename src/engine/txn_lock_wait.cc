@@ -0,0 +1,183 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "engine/txn_lock_wait.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bvar/reducer.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_txn_lock_wait, false, "pessimistic lock wait on store for the conflict lock to be removed");
+DEFINE_int64(txn_lock_wait_timeout_ms, 1000, "max wait time of pessimistic lock for the conflict lock");
+
+bvar::Adder<int64_t> g_txn_lock_wait_deadlock_count("dingo_txn_lock_wait_deadlock_count");
+bvar::Adder<int64_t> g_txn_lock_wait_timeout_count("dingo_txn_lock_wait_timeout_count");
+
+TxnLockWaitManager& TxnLockWaitManager::GetInstance() {
+  static TxnLockWaitManager instance;
+  return instance;
+}
+
+bool TxnLockWaitManager::Wait(const std::string& lock_key, int64_t waiter_ts, int64_t holder_ts, int64_t timeout_ms,
+                              WakeUpFunc func) {
+  auto waiter = std::make_shared<Waiter>();
+  waiter->lock_key = lock_key;
+  waiter->waiter_ts = waiter_ts;
+  waiter->holder_ts = holder_ts;
+  waiter->func = std::move(func);
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (waiter_ts == holder_ts || IsReachable(holder_ts, waiter_ts)) {
+      DINGO_LOG(INFO) << fmt::format("[txn_lock_wait] deadlock, waiter_ts: {} holder_ts: {} lock_key: {}", waiter_ts,
+                                     holder_ts, Helper::StringToHex(lock_key));
+      g_txn_lock_wait_deadlock_count << 1;
+      return false;
+    }
+
+    waiter->id = ++next_waiter_id_;
+    waiters_[waiter->id] = waiter;
+    key_waiters_[lock_key].push_back(waiter->id);
+    ++wait_for_[waiter_ts][holder_ts];
+    waiter_count_.fetch_add(1, std::memory_order_relaxed);
+
+    // the timer can not run before the waiter is added, it need mutex_.
+    bthread_timer_add(&waiter->timer_id, butil::milliseconds_from_now(timeout_ms), &TxnLockWaitManager::OnTimeout,
+                      reinterpret_cast<void*>(waiter->id));
+  }
+
+  return true;
+}
+
+void TxnLockWaitManager::OnTimeout(void* arg) {
+  int64_t waiter_id = reinterpret_cast<int64_t>(arg);
+  auto& self = GetInstance();
+
+  WaiterPtr waiter;
+  {
+    BAIDU_SCOPED_LOCK(self.mutex_);
+    auto it = self.waiters_.find(waiter_id);
+    if (it == self.waiters_.end()) {
+      // already woken up
+      return;
+    }
+    waiter = it->second;
+    self.RemoveWaiter(waiter);
+  }
+
+  g_txn_lock_wait_timeout_count << 1;
+  waiter->func(true);
+}
+
+void TxnLockWaitManager::WakeUp(const std::string& lock_key) { WakeUp(std::vector<std::string>{lock_key}); }
+
+void TxnLockWaitManager::WakeUp(const std::vector<std::string>& lock_keys) {
+  if (WaiterCount() == 0) {
+    return;
+  }
+
+  std::vector<WaiterPtr> woken_waiters;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    for (const auto& lock_key : lock_keys) {
+      auto it = key_waiters_.find(lock_key);
+      if (it == key_waiters_.end()) {
+        continue;
+      }
+
+      for (auto waiter_id : it->second) {
+        auto waiter_it = waiters_.find(waiter_id);
+        if (waiter_it != waiters_.end()) {
+          woken_waiters.push_back(waiter_it->second);
+        }
+      }
+    }
+
+    for (auto& waiter : woken_waiters) {
+      // if the timer is running, it will find the waiter is removed.
+      bthread_timer_del(waiter->timer_id);
+      RemoveWaiter(waiter);
+    }
+  }
+
+  for (auto& waiter : woken_waiters) {
+    waiter->func(false);
+  }
+}
+
+void TxnLockWaitManager::RemoveWaiter(const WaiterPtr& waiter) {
+  waiters_.erase(waiter->id);
+
+  auto key_it = key_waiters_.find(waiter->lock_key);
+  if (key_it != key_waiters_.end()) {
+    auto& ids = key_it->second;
+    ids.erase(std::remove(ids.begin(), ids.end(), waiter->id), ids.end());
+    if (ids.empty()) {
+      key_waiters_.erase(key_it);
+    }
+  }
+
+  auto wait_it = wait_for_.find(waiter->waiter_ts);
+  if (wait_it != wait_for_.end()) {
+    auto holder_it = wait_it->second.find(waiter->holder_ts);
+    if (holder_it != wait_it->second.end() && --holder_it->second <= 0) {
+      wait_it->second.erase(holder_it);
+    }
+    if (wait_it->second.empty()) {
+      wait_for_.erase(wait_it);
+    }
+  }
+
+  waiter_count_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool TxnLockWaitManager::IsReachable(int64_t from_ts, int64_t to_ts) {
+  std::set<int64_t> visited;
+  std::vector<int64_t> stack{from_ts};
+  while (!stack.empty()) {
+    int64_t ts = stack.back();
+    stack.pop_back();
+    if (ts == to_ts) {
+      return true;
+    }
+    if (!visited.insert(ts).second) {
+      continue;
+    }
+
+    auto it = wait_for_.find(ts);
+    if (it == wait_for_.end()) {
+      continue;
+    }
+    for (const auto& [holder_ts, _] : it->second) {
+      stack.push_back(holder_ts);
+    }
+  }
+
+  return false;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,85 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ENGINE_TXN_LOCK_WAIT_H_  // NOLINT
+#define DINGODB_ENGINE_TXN_LOCK_WAIT_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bthread/unstable.h"
+
+namespace dingodb {
+
+// Pessimistic lock requests which meet a lock wait here instead of returning the conflict to client,
+// they are woken up when the lock is removed by commit or rollback, or the wait is timeout.
+// A wait-for graph of txns is kept to detect deadlock, it covers all regions of this store.
+class TxnLockWaitManager {
+ public:
+  // is_timeout is false if the lock is removed.
+  // Called in the apply thread or timer thread, must not block.
+  using WakeUpFunc = std::function<void(bool is_timeout)>;
+
+  static TxnLockWaitManager& GetInstance();
+
+  // Wait for lock_key locked by holder_ts, lock_key is the encoded key of lock cf.
+  // Return false if the wait cause a deadlock, then func is never called.
+  bool Wait(const std::string& lock_key, int64_t waiter_ts, int64_t holder_ts, int64_t timeout_ms, WakeUpFunc func);
+
+  // Wake up all waiters of the lock keys.
+  void WakeUp(const std::vector<std::string>& lock_keys);
+  void WakeUp(const std::string& lock_key);
+
+  int64_t WaiterCount() { return waiter_count_.load(std::memory_order_relaxed); }
+
+ private:
+  TxnLockWaitManager() = default;
+
+  struct Waiter {
+    int64_t id;
+    std::string lock_key;
+    int64_t waiter_ts;
+    int64_t holder_ts;
+    WakeUpFunc func;
+    bthread_timer_t timer_id;
+  };
+  using WaiterPtr = std::shared_ptr<Waiter>;
+
+  static void OnTimeout(void* arg);
+
+  // from_ts waits for to_ts directly or indirectly.
+  bool IsReachable(int64_t from_ts, int64_t to_ts);
+
+  // Remove from all index, need hold mutex_.
+  void RemoveWaiter(const WaiterPtr& waiter);
+
+  bthread::Mutex mutex_;
+  int64_t next_waiter_id_{0};
+  std::map<int64_t, WaiterPtr> waiters_;
+  std::map<std::string, std::vector<int64_t>> key_waiters_;
+  // wait-for graph, waiter_ts -> holder_ts -> wait count
+  std::map<int64_t, std::map<int64_t, int64_t>> wait_for_;
+  std::atomic<int64_t> waiter_count_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TXN_LOCK_WAIT_H_  // NOLINT
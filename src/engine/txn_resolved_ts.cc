@@ -0,0 +1,178 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "engine/txn_resolved_ts.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/synchronization.h"
+#include "coordinator/coordinator_interaction.h"
+#include "coordinator/tso_control.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/meta.pb.h"
+#include "proto/store.pb.h"
+#include "server/server.h"
+
+DECLARE_string(coor_url);
+
+namespace dingodb {
+
+DEFINE_bool(enable_txn_stale_read, false, "advance resolved ts of txn regions for stale read on any replica");
+DEFINE_int64(txn_resolved_ts_interval_ms, 1000, "interval ms of advancing resolved ts of txn regions");
+
+TxnResolvedTsManager& TxnResolvedTsManager::GetInstance() {
+  static TxnResolvedTsManager instance;
+  return instance;
+}
+
+int64_t TxnResolvedTsManager::GetResolvedTs(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = resolved_ts_.find(region_id);
+  return it == resolved_ts_.end() ? 0 : it->second;
+}
+
+void TxnResolvedTsManager::AdvanceResolvedTs(int64_t region_id, int64_t resolved_ts, int64_t generation) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (generation != generation_.load()) {
+    return;
+  }
+
+  auto& ts = resolved_ts_[region_id];
+  ts = std::max(ts, resolved_ts);
+}
+
+void TxnResolvedTsManager::Remove(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  generation_.fetch_add(1);
+  resolved_ts_.erase(region_id);
+}
+
+int64_t TxnResolvedTsManager::CalcResolvedTs(int64_t tso_ts, int64_t min_lock_ts) {
+  if (min_lock_ts <= 0) {
+    return tso_ts;
+  }
+  return std::min(tso_ts, min_lock_ts - 1);
+}
+
+int64_t TxnResolvedTsManager::GetMinLockTs(RawEnginePtr raw_engine, const pb::common::Range& range) {
+  IteratorOptions iter_options;
+  iter_options.lower_bound = Helper::EncodeTxnKey(range.start_key(), Constant::kLockVer);
+  iter_options.upper_bound = Helper::EncodeTxnKey(range.end_key(), Constant::kLockVer);
+
+  auto iter = raw_engine->Reader()->NewIterator(Constant::kTxnLockCF, iter_options);
+  if (iter == nullptr) {
+    DINGO_LOG(ERROR) << fmt::format("[resolved_ts] new lock cf iterator failed, range: {}",
+                                    Helper::RangeToString(range));
+    return -1;
+  }
+
+  int64_t min_lock_ts = 0;
+  for (iter->Seek(iter_options.lower_bound); iter->Valid(); iter->Next()) {
+    pb::store::LockInfo lock_info;
+    if (!lock_info.ParseFromArray(iter->Value().data(), iter->Value().size())) {
+      DINGO_LOG(ERROR) << fmt::format("[resolved_ts] parse lock info failed, key: {}",
+                                      Helper::StringToHex(iter->Key()));
+      return -1;
+    }
+    if (lock_info.lock_ts() > 0 && (min_lock_ts == 0 || lock_info.lock_ts() < min_lock_ts)) {
+      min_lock_ts = lock_info.lock_ts();
+    }
+  }
+
+  return min_lock_ts;
+}
+
+static butil::Status GetTsoTs(int64_t& tso_ts) {
+  static std::once_flag init_flag;
+  static std::shared_ptr<CoordinatorInteraction> coordinator_interaction;
+  std::call_once(init_flag, []() {
+    auto interaction = std::make_shared<CoordinatorInteraction>();
+    if (interaction->InitByNameService(FLAGS_coor_url, pb::common::CoordinatorServiceType::ServiceTypeMeta)) {
+      coordinator_interaction = interaction;
+    }
+  });
+  if (coordinator_interaction == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Init coordinator interaction failed");
+  }
+
+  pb::meta::TsoRequest request;
+  pb::meta::TsoResponse response;
+  request.set_op_type(pb::meta::TsoOpType::OP_GEN_TSO);
+  request.set_count(1);
+  auto status = coordinator_interaction->SendRequest("TsoService", request, response);
+  if (!status.ok()) {
+    return status;
+  }
+  if (response.error().errcode() != pb::error::OK) {
+    return butil::Status(response.error().errcode(), response.error().errmsg());
+  }
+
+  tso_ts = (response.start_timestamp().physical() << kLogicalBits) + response.start_timestamp().logical();
+  return butil::Status();
+}
+
+void TxnResolvedTsManager::RegularUpdateResolvedTsHandler(void* /*arg*/) {
+  static std::atomic<bool> g_running(false);
+  if (!FLAGS_enable_txn_stale_read || g_running.load()) {
+    return;
+  }
+  AtomicGuard guard(g_running);
+
+  auto& manager = TxnResolvedTsManager::GetInstance();
+  // take generation before tso, regions removed after it are resolved next time.
+  int64_t generation = manager.Generation();
+
+  int64_t tso_ts = 0;
+  auto status = GetTsoTs(tso_ts);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[resolved_ts] get tso failed, error: {}", Helper::PrintStatus(status));
+    return;
+  }
+
+  auto storage = Server::GetInstance().GetStorage();
+  for (const auto& region : Server::GetInstance().GetAllAliveRegion()) {
+    if (region->State() != pb::common::StoreRegionState::NORMAL) {
+      continue;
+    }
+
+    // All locks prewrited before tso ts are applied after it.
+    status = storage->ValidateRead(region->Id(), pb::store::ReadFollower);
+    if (!status.ok()) {
+      DINGO_LOG(DEBUG) << fmt::format("[resolved_ts][region({})] wait read index failed, error: {}", region->Id(),
+                                      Helper::PrintStatus(status));
+      continue;
+    }
+
+    int64_t min_lock_ts =
+        GetMinLockTs(Server::GetInstance().GetRawEngine(region->GetRawEngineType()), region->Range());
+    if (min_lock_ts < 0) {
+      continue;
+    }
+
+    manager.AdvanceResolvedTs(region->Id(), CalcResolvedTs(tso_ts, min_lock_ts), generation);
+  }
+}
+
+}  // namespace dingodb
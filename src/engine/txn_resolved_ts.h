@@ -0,0 +1,69 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ENGINE_TXN_RESOLVED_TS_H_  // NOLINT
+#define DINGODB_ENGINE_TXN_RESOLVED_TS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+
+#include "bthread/mutex.h"
+#include "engine/raw_engine.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Resolved ts of txn regions on this replica, no lock with lock_ts <= resolved ts can become visible to reads any
+// more, so txn read at start_ts <= resolved ts can be served locally by any replica without raft, named stale read.
+// Resolved ts is advanced periodically on every replica:
+// 1. Get a tso ts from coordinator.
+// 2. Wait applied index reach the read index of leader, so every lock prewrited before the tso ts is applied.
+// 3. Resolved ts = min(tso ts, min lock ts - 1).
+// Txn prewrited after the tso ts gets a larger commit ts, so it is invisible to reads at start_ts <= resolved ts.
+class TxnResolvedTsManager {
+ public:
+  static TxnResolvedTsManager& GetInstance();
+
+  // 0 means not resolved yet.
+  int64_t GetResolvedTs(int64_t region_id);
+
+  // Resolved ts only advances, it is ignored if any region is removed after generation is taken.
+  void AdvanceResolvedTs(int64_t region_id, int64_t resolved_ts, int64_t generation);
+
+  // Called when the lock cf of region may have locks not seen by the last resolving, e.g. merge or install snapshot.
+  void Remove(int64_t region_id);
+
+  int64_t Generation() { return generation_.load(); }
+
+  // min_lock_ts 0 means no lock.
+  static int64_t CalcResolvedTs(int64_t tso_ts, int64_t min_lock_ts);
+
+  // Min lock_ts of lock cf in range, 0 means no lock.
+  static int64_t GetMinLockTs(RawEnginePtr raw_engine, const pb::common::Range& range);
+
+  static void RegularUpdateResolvedTsHandler(void* arg);
+
+ private:
+  TxnResolvedTsManager() = default;
+
+  bthread::Mutex mutex_;
+  std::map<int64_t, int64_t> resolved_ts_;
+  std::atomic<int64_t> generation_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TXN_RESOLVED_TS_H_  // NOLINT
@@ -0,0 +1,99 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "engine/txn_scan_cursor.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_txn_scan_cursor, false, "keep txn scan iterator alive across pages");
+DEFINE_int64(txn_scan_cursor_timeout_ms, 60000, "txn scan cursor is destroyed if not continued within it");
+DEFINE_int64(txn_scan_cursor_max_num, 1024, "max alive txn scan cursors of store");
+
+bool TxnScanCursor::IsNextPage(int64_t region_id, int64_t epoch_version, int64_t start_ts, bool key_only,
+                               const pb::common::Range& range) const {
+  return this->region_id == region_id && this->epoch_version == epoch_version && this->start_ts == start_ts &&
+         this->key_only == key_only && next_start_key == range.start_key() && end_key == range.end_key();
+}
+
+TxnScanCursorManager& TxnScanCursorManager::GetInstance() {
+  static TxnScanCursorManager instance;
+  return instance;
+}
+
+TxnScanCursorPtr TxnScanCursorManager::Take(int64_t scan_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = cursors_.find(scan_id);
+  if (it == cursors_.end()) {
+    return nullptr;
+  }
+
+  auto cursor = it->second;
+  cursors_.erase(it);
+  return cursor;
+}
+
+int64_t TxnScanCursorManager::Put(int64_t scan_id, TxnScanCursorPtr cursor) {
+  cursor->last_time_ms = Helper::TimestampMs();
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (static_cast<int64_t>(cursors_.size()) >= FLAGS_txn_scan_cursor_max_num) {
+    return 0;
+  }
+  if (scan_id == 0) {
+    scan_id = next_scan_id_.fetch_add(1);
+  }
+  cursors_[scan_id] = cursor;
+  return scan_id;
+}
+
+int64_t TxnScanCursorManager::Count() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return cursors_.size();
+}
+
+void TxnScanCursorManager::CleanExpired(int64_t now_ms, int64_t timeout_ms) {
+  // Destroy the iterators out of lock.
+  std::vector<TxnScanCursorPtr> expired_cursors;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    for (auto it = cursors_.begin(); it != cursors_.end();) {
+      if (now_ms - it->second->last_time_ms >= timeout_ms) {
+        expired_cursors.push_back(it->second);
+        it = cursors_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  if (!expired_cursors.empty()) {
+    DINGO_LOG(INFO) << fmt::format("[txn_scan_cursor] clean expired cursor count: {}", expired_cursors.size());
+  }
+}
+
+void TxnScanCursorManager::RegularCleaningHandler(void* /*arg*/) {
+  GetInstance().CleanExpired(Helper::TimestampMs(), FLAGS_txn_scan_cursor_timeout_ms);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,79 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ENGINE_TXN_SCAN_CURSOR_H_  // NOLINT
+#define DINGODB_ENGINE_TXN_SCAN_CURSOR_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "bthread/mutex.h"
+#include "engine/txn_engine_helper.h"
+
+namespace dingodb {
+
+// Server side state of a paged txn scan, the TxnIterator keeps the snapshot and the positions of write and lock
+// iterators, so the next page continues from where the last page stopped instead of seeking again.
+struct TxnScanCursor {
+  int64_t region_id{0};
+  int64_t epoch_version{0};
+  int64_t start_ts{0};
+  bool key_only{false};
+  std::string end_key;
+  // The start key of the next page request, PrefixNext of the last returned key.
+  std::string next_start_key;
+  std::shared_ptr<TxnIterator> txn_iter;
+  int64_t last_time_ms{0};
+
+  // The request is the next page of this cursor.
+  bool IsNextPage(int64_t region_id, int64_t epoch_version, int64_t start_ts, bool key_only,
+                  const pb::common::Range& range) const;
+};
+using TxnScanCursorPtr = std::shared_ptr<TxnScanCursor>;
+
+// Alive txn scan cursors of this store, like ScanManagerV2 the cursor is destroyed when the scan finishes or is not
+// continued within txn_scan_cursor_timeout_ms.
+class TxnScanCursorManager {
+ public:
+  static TxnScanCursorManager& GetInstance();
+
+  // Take away the cursor for exclusive use by a page request, nullptr if not exist.
+  TxnScanCursorPtr Take(int64_t scan_id);
+
+  // Put back the cursor after a page, a new scan_id is allocated if scan_id is 0.
+  // Return 0 if too many cursors are alive, the scan goes on without cursor.
+  int64_t Put(int64_t scan_id, TxnScanCursorPtr cursor);
+
+  int64_t Count();
+
+  // Remove the cursors not continued within timeout_ms.
+  void CleanExpired(int64_t now_ms, int64_t timeout_ms);
+
+  static void RegularCleaningHandler(void* arg);
+
+ private:
+  TxnScanCursorManager() = default;
+
+  bthread::Mutex mutex_;
+  std::map<int64_t, TxnScanCursorPtr> cursors_;
+  std::atomic<int64_t> next_scan_id_{1};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TXN_SCAN_CURSOR_H_  // NOLINT
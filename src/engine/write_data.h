@@ -19,6 +19,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/helper.h"
@@ -42,6 +43,9 @@ enum class DatumType {
   kRebuildVectorIndex = 11,
   kSaveRaftSnapshot = 12,
   kTxn = 13,
+  kIngestSst = 14,
+  kComputeHash = 15,
+  kChangeLearner = 16,
 };
 
 class DatumAble {
@@ -158,6 +162,64 @@ struct TxnDatum : public DatumAble {
   pb::raft::TxnRaftRequest txn_request_to_raft;
 };
 
+struct PutIfAbsentDatum : public DatumAble {
+  ~PutIfAbsentDatum() override = default;
+  DatumType GetType() override { return DatumType::kPutIfabsent; }
+
+  pb::raft::Request* TransformToRaft() override {
+    auto* request = new pb::raft::Request();
+
+    request->set_cmd_type(pb::raft::CmdType::PUTIFABSENT);
+    pb::raft::PutIfAbsentRequest* put_if_absent_request = request->mutable_put_if_absent();
+    put_if_absent_request->set_cf_name(cf_name);
+    for (auto& kv : kvs) {
+      put_if_absent_request->add_kvs()->Swap(&kv);
+    }
+    put_if_absent_request->set_is_atomic(is_atomic);
+    put_if_absent_request->set_now_ms(now_ms);
+
+    return request;
+  }
+
+  void TransformFromRaft(pb::raft::Response& resonse) override {}
+
+  std::string cf_name;
+  std::vector<pb::common::KeyValue> kvs;
+  bool is_atomic{false};
+  int64_t now_ms{0};
+};
+
+struct CompareAndSetDatum : public DatumAble {
+  ~CompareAndSetDatum() override = default;
+  DatumType GetType() override { return DatumType::kCompareAndSet; }
+
+  pb::raft::Request* TransformToRaft() override {
+    auto* request = new pb::raft::Request();
+
+    request->set_cmd_type(pb::raft::CmdType::COMPAREANDSET);
+    pb::raft::CompareAndSetRequest* compare_and_set_request = request->mutable_compare_and_set();
+    compare_and_set_request->set_cf_name(cf_name);
+    for (auto& kv : kvs) {
+      compare_and_set_request->add_kvs()->Swap(&kv);
+    }
+    for (auto& expect_value : expect_values) {
+      compare_and_set_request->add_expect_values()->swap(expect_value);
+    }
+    compare_and_set_request->set_is_atomic(is_atomic);
+    compare_and_set_request->set_now_ms(now_ms);
+
+    return request;
+  }
+
+  void TransformFromRaft(pb::raft::Response& resonse) override {}
+
+  std::string cf_name;
+  std::vector<pb::common::KeyValue> kvs;
+  std::vector<std::string> expect_values;
+  bool is_atomic{false};
+  int64_t now_ms{0};
+};
+
 struct DeleteBatchDatum : public DatumAble {
   ~DeleteBatchDatum() override = default;
   DatumType GetType() override { return DatumType::kDeleteBatch; }
@@ -319,6 +381,28 @@ struct RollbackMergeDatum : public DatumAble {
   pb::common::RegionEpoch target_region_epoch;
 };
 
+struct IngestSstDatum : public DatumAble {
+  DatumType GetType() override { return DatumType::kIngestSst; }
+
+  pb::raft::Request* TransformToRaft() override {
+    auto* request = new pb::raft::Request();
+
+    request->set_cmd_type(pb::raft::CmdType::INGEST_SST);
+    auto* ingest_request = request->mutable_ingest_sst();
+    ingest_request->set_cf_name(cf_name);
+    for (const auto& filename : filenames) {
+      ingest_request->add_filenames(filename);
+    }
+
+    return request;
+  };
+
+  void TransformFromRaft(pb::raft::Response& resonse) override {}
+
+  std::string cf_name;
+  std::vector<std::string> filenames;
+};
+
 struct RebuildVectorIndexDatum : public DatumAble {
   DatumType GetType() override { return DatumType::kRebuildVectorIndex; }
 
@@ -351,6 +435,48 @@ struct SaveRaftSnapshotDatum : public DatumAble {
   int64_t region_id;
 };
 
+struct ComputeHashDatum : public DatumAble {
+  DatumType GetType() override { return DatumType::kComputeHash; }
+
+  pb::raft::Request* TransformToRaft() override {
+    auto* request = new pb::raft::Request();
+
+    request->set_cmd_type(pb::raft::CmdType::COMPUTE_HASH);
+    auto* compute_hash_request = request->mutable_compute_hash();
+    for (const auto& bucket_key : bucket_keys) {
+      compute_hash_request->add_bucket_keys(bucket_key);
+    }
+    compute_hash_request->set_full(full);
+
+    return request;
+  };
+
+  void TransformFromRaft(pb::raft::Response& resonse) override {}
+
+  std::vector<std::string> bucket_keys;
+  bool full{false};
+};
+
+struct ChangeLearnerDatum : public DatumAble {
+  DatumType GetType() override { return DatumType::kChangeLearner; }
+
+  pb::raft::Request* TransformToRaft() override {
+    auto* request = new pb::raft::Request();
+
+    request->set_cmd_type(pb::raft::CmdType::CHANGE_LEARNER);
+    auto* change_learner_request = request->mutable_change_learner();
+    for (const auto& learner : learners) {
+      *change_learner_request->add_learners() = learner;
+    }
+
+    return request;
+  };
+
+  void TransformFromRaft(pb::raft::Response& resonse) override {}
+
+  std::vector<pb::common::Peer> learners;
+};
+
 class WriteData {
  public:
   std::vector<std::shared_ptr<DatumAble>> Datums() const { return datums_; }
@@ -376,6 +502,18 @@ class WriteDataBuilder {
     return write_data;
   }
 
+  // PutDatum, take the kvs without copy
+  static std::shared_ptr<WriteData> BuildWrite(const std::string& cf_name, std::vector<pb::common::KeyValue>&& kvs) {
+    auto datum = std::make_shared<PutDatum>();
+    datum->cf_name = cf_name;
+    datum->kvs = std::move(kvs);
+
+    auto write_data = std::make_shared<WriteData>();
+    write_data->AddDatums(std::static_pointer_cast<DatumAble>(datum));
+
+    return write_data;
+  }
+
   // VectorAddDatum
   static std::shared_ptr<WriteData> BuildWrite(const std::string& cf_name,
                                                const std::vector<pb::common::VectorWithId>& vectors) {
@@ -389,6 +527,19 @@ class WriteDataBuilder {
     return write_data;
   }
 
+  // VectorAddDatum, take the vectors without copy
+  static std::shared_ptr<WriteData> BuildWrite(const std::string& cf_name,
+                                               std::vector<pb::common::VectorWithId>&& vectors) {
+    auto datum = std::make_shared<VectorAddDatum>();
+    datum->cf_name = cf_name;
+    datum->vectors = std::move(vectors);
+
+    auto write_data = std::make_shared<WriteData>();
+    write_data->AddDatums(std::static_pointer_cast<DatumAble>(datum));
+
+    return write_data;
+  }
+
   // VectorDeleteDatum
   static std::shared_ptr<WriteData> BuildWrite(const std::string& cf_name, const std::vector<int64_t>& ids) {
     auto datum = std::make_shared<VectorDeleteDatum>();
@@ -401,6 +552,40 @@ class WriteDataBuilder {
     return write_data;
   }
 
+  // PutIfAbsentDatum
+  static std::shared_ptr<WriteData> BuildPutIfAbsentWrite(const std::string& cf_name,
+                                                          const std::vector<pb::common::KeyValue>& kvs, bool is_atomic,
+                                                          int64_t now_ms) {
+    auto datum = std::make_shared<PutIfAbsentDatum>();
+    datum->cf_name = cf_name;
+    datum->kvs = kvs;
+    datum->is_atomic = is_atomic;
+    datum->now_ms = now_ms;
+
+    auto write_data = std::make_shared<WriteData>();
+    write_data->AddDatums(std::static_pointer_cast<DatumAble>(datum));
+
+    return write_data;
+  }
+
+  // CompareAndSetDatum
+  static std::shared_ptr<WriteData> BuildCompareAndSetWrite(const std::string& cf_name,
+                                                            const std::vector<pb::common::KeyValue>& kvs,
+                                                            const std::vector<std::string>& expect_values,
+                                                            bool is_atomic, int64_t now_ms) {
+    auto datum = std::make_shared<CompareAndSetDatum>();
+    datum->cf_name = cf_name;
+    datum->kvs = kvs;
+    datum->expect_values = expect_values;
+    datum->is_atomic = is_atomic;
+    datum->now_ms = now_ms;
+
+    auto write_data = std::make_shared<WriteData>();
+    write_data->AddDatums(std::static_pointer_cast<DatumAble>(datum));
+
+    return write_data;
+  }
+
   // DeleteBatchDatum
   static std::shared_ptr<WriteData> BuildWrite(const std::string& cf_name, const std::vector<std::string>& keys) {
     auto datum = std::make_shared<DeleteBatchDatum>();
@@ -519,6 +704,42 @@ class WriteDataBuilder {
     return write_data;
   }
 
+  // IngestSstDatum, filenames is also vector of string, so not overload BuildWrite.
+  static std::shared_ptr<WriteData> BuildIngestSstWrite(const std::string& cf_name,
+                                                        const std::vector<std::string>& filenames) {
+    auto datum = std::make_shared<IngestSstDatum>();
+    datum->cf_name = cf_name;
+    datum->filenames = filenames;
+
+    auto write_data = std::make_shared<WriteData>();
+    write_data->AddDatums(std::static_pointer_cast<DatumAble>(datum));
+
+    return write_data;
+  }
+
+  // ComputeHashDatum
+  static std::shared_ptr<WriteData> BuildComputeHashWrite(const std::vector<std::string>& bucket_keys, bool full) {
+    auto datum = std::make_shared<ComputeHashDatum>();
+    datum->bucket_keys = bucket_keys;
+    datum->full = full;
+
+    auto write_data = std::make_shared<WriteData>();
+    write_data->AddDatums(std::static_pointer_cast<DatumAble>(datum));
+
+    return write_data;
+  }
+
+  // ChangeLearnerDatum
+  static std::shared_ptr<WriteData> BuildChangeLearnerWrite(const std::vector<pb::common::Peer>& learners) {
+    auto datum = std::make_shared<ChangeLearnerDatum>();
+    datum->learners = learners;
+
+    auto write_data = std::make_shared<WriteData>();
+    write_data->AddDatums(std::static_pointer_cast<DatumAble>(datum));
+
+    return write_data;
+  }
+
   // RebuildVectorIndexDatum
   static std::shared_ptr<WriteData> BuildWrite() {
     auto datum = std::make_shared<RebuildVectorIndexDatum>();
@@ -0,0 +1,133 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/write_throttler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "bthread/bthread.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "server/server.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_write_throttle, false, "delay and reject writes by compaction debt before rocksdb stops writes");
+DEFINE_int64(write_throttle_update_interval_ms, 500, "interval of refreshing compaction stats and write pressure");
+DEFINE_double(write_throttle_start_ratio, 0.5, "start delaying writes at the ratio of rocksdb slowdown thresholds");
+DEFINE_int64(write_throttle_max_delay_ms, 100, "write delay when write pressure is close to full");
+
+// Linear ratio of value in [start, end], clamped to [0, 1], 0 if end is not set.
+static double Ratio(double value, double start, double end) {
+  if (end <= 0 || value <= start) {
+    return 0;
+  }
+  if (value >= end || end <= start) {
+    return 1;
+  }
+  return (value - start) / (end - start);
+}
+
+WriteThrottler::CfMetrics::CfMetrics(const std::string& cf_name)
+    : pending_compaction_bytes(fmt::format("dingo_rocksdb_{}_pending_compaction_bytes", cf_name), 0),
+      l0_file_num(fmt::format("dingo_rocksdb_{}_l0_file_num", cf_name), 0),
+      stall_micros(fmt::format("dingo_rocksdb_{}_stall_micros", cf_name), 0) {}
+
+WriteThrottler::WriteThrottler()
+    : bvar_pressure_("dingo_write_throttle_pressure", 0),
+      bvar_delayed_count_("dingo_write_throttle_delayed_count"),
+      bvar_rejected_count_("dingo_write_throttle_rejected_count") {}
+
+WriteThrottler& WriteThrottler::GetInstance() {
+  static WriteThrottler instance;
+  return instance;
+}
+
+void WriteThrottler::UpdateHandler(void*) {
+  auto raw_engine = Server::GetInstance().GetRawEngine(pb::common::RAW_ENG_ROCKSDB);
+  if (raw_engine != nullptr) {
+    GetInstance().Update(raw_engine);
+  }
+}
+
+double WriteThrottler::CalculatePressure(const RawEngine::CompactionStats& stats, double start_ratio) {
+  if (stats.is_write_stopped) {
+    return 1;
+  }
+
+  double pending_pressure =
+      Ratio(stats.pending_compaction_bytes, stats.soft_pending_compaction_bytes_limit * start_ratio,
+            stats.hard_pending_compaction_bytes_limit);
+  double l0_pressure = Ratio(stats.l0_file_num, stats.l0_slowdown_writes_trigger * start_ratio,
+                             stats.l0_stop_writes_trigger);
+
+  return std::max(pending_pressure, l0_pressure);
+}
+
+void WriteThrottler::Update(RawEnginePtr raw_engine) {
+  double pressure = 0;
+  std::string pressure_cf_name;
+  for (const auto& stats : raw_engine->GetCompactionStats()) {
+    {
+      BAIDU_SCOPED_LOCK(mutex_);
+      auto& cf_metrics = cf_metrics_[stats.cf_name];
+      if (cf_metrics == nullptr) {
+        cf_metrics = std::make_unique<CfMetrics>(stats.cf_name);
+      }
+      cf_metrics->pending_compaction_bytes.set_value(stats.pending_compaction_bytes);
+      cf_metrics->l0_file_num.set_value(stats.l0_file_num);
+      cf_metrics->stall_micros.set_value(stats.stall_micros);
+    }
+
+    double cf_pressure = CalculatePressure(stats, FLAGS_write_throttle_start_ratio);
+    if (cf_pressure > pressure) {
+      pressure = cf_pressure;
+      pressure_cf_name = stats.cf_name;
+    }
+  }
+
+  double prev_pressure = pressure_.exchange(pressure, std::memory_order_relaxed);
+  bvar_pressure_.set_value(pressure);
+  if ((prev_pressure == 0) != (pressure == 0)) {
+    DINGO_LOG(WARNING) << fmt::format("[write_throttle] write pressure {:.2f} -> {:.2f}, cf({})", prev_pressure,
+                                      pressure, pressure_cf_name);
+  }
+}
+
+butil::Status WriteThrottler::Throttle() {
+  if (!FLAGS_enable_write_throttle) {
+    return butil::Status();
+  }
+
+  double pressure = Pressure();
+  if (pressure <= 0) {
+    return butil::Status();
+  }
+  if (pressure >= 1) {
+    bvar_rejected_count_ << 1;
+    return butil::Status(pb::error::EREQUEST_FULL, "Write stall by compaction debt, please wait and retry");
+  }
+
+  bvar_delayed_count_ << 1;
+  bthread_usleep(static_cast<int64_t>(pressure * FLAGS_write_throttle_max_delay_ms * 1000));
+
+  return butil::Status();
+}
+
+}  // namespace dingodb
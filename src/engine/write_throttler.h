@@ -0,0 +1,79 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_WRITE_THROTTLER_H_  // NOLINT
+#define DINGODB_ENGINE_WRITE_THROTTLER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "bvar/reducer.h"
+#include "bvar/status.h"
+#include "engine/raw_engine.h"
+
+namespace dingodb {
+
+// Adaptive write throttle by the compaction debt of raw engine.
+// Rocksdb slows writes at the soft limits and stops all writes of the store at the hard limits, a hard stall
+// freezes every region for seconds. The throttler starts delaying writes earlier, the delay grows with the
+// write pressure, and rejects writes just before the hard limits, so clients back off instead of hanging.
+// Write pressure is in [0, 1], it is the max of all column families:
+//   pending compaction bytes: 0 at soft_limit * start_ratio, 1 at hard_limit.
+//   L0 file num: 0 at slowdown_trigger * start_ratio, 1 at stop_trigger.
+//   write stopped: 1.
+class WriteThrottler {
+ public:
+  static WriteThrottler& GetInstance();
+
+  // Refresh compaction stats of raw engine and the write pressure, called by crontab.
+  static void UpdateHandler(void*);
+  void Update(RawEnginePtr raw_engine);
+
+  // Called in the write path, delay by write pressure, return EREQUEST_FULL when write pressure is full.
+  butil::Status Throttle();
+
+  double Pressure() const { return pressure_.load(std::memory_order_relaxed); }
+
+  static double CalculatePressure(const RawEngine::CompactionStats& stats, double start_ratio);
+
+ private:
+  WriteThrottler();
+
+  // Exported compaction stats of a column family.
+  struct CfMetrics {
+    explicit CfMetrics(const std::string& cf_name);
+
+    bvar::Status<int64_t> pending_compaction_bytes;
+    bvar::Status<int64_t> l0_file_num;
+    bvar::Status<int64_t> stall_micros;
+  };
+
+  std::atomic<double> pressure_{0};
+
+  bthread::Mutex mutex_;
+  std::map<std::string, std::unique_ptr<CfMetrics>> cf_metrics_;
+
+  bvar::Status<double> bvar_pressure_;
+  bvar::Adder<int64_t> bvar_delayed_count_;
+  bvar::Adder<int64_t> bvar_rejected_count_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_WRITE_THROTTLER_H_  // NOLINT
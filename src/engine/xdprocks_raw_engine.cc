@@ -43,6 +43,7 @@
 #include "engine/raw_engine.h"
 #include "engine/snapshot.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "xdprocks/advanced_options.h"
@@ -55,6 +56,11 @@
 
 namespace dingodb {
 
+DEFINE_bool(xdprocks_multi_get_async_io, false, "xdprocks multi get use async io");
+DEFINE_bool(xdprocks_use_direct_io_for_flush_and_compaction, false,
+            "xdprocks flush and compaction bypass page cache, avoid evicting hot pages of read and raft log");
+DEFINE_int64(xdprocks_compaction_readahead_size_kb, 2048, "xdprocks compaction readahead size, need by direct io");
+
 namespace xdp {
 
 ColumnFamily::ColumnFamily(const std::string& cf_name, const ColumnFamilyConfig& config,
@@ -342,6 +348,79 @@ butil::Status Reader::KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr
   return butil::Status();
 }
 
+butil::Status Reader::KvBatchGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<pb::common::KeyValue>& kvs) {
+  return KvBatchGet(GetColumnFamily(cf_name), GetSnapshot(), keys, kvs);
+}
+
+butil::Status Reader::KvBatchGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) {
+  return KvBatchGet(GetColumnFamily(cf_name), snapshot, keys, kvs);
+}
+
+butil::Status Reader::KvBatchGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) {
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[xdprocks] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+  }
+
+  // MultiGet with sorted input can coalesce index/filter block probes of adjacent keys.
+  std::vector<size_t> indexes(keys.size());
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    indexes[i] = i;
+  }
+  std::sort(indexes.begin(), indexes.end(), [&keys](size_t lhs, size_t rhs) { return keys[lhs] < keys[rhs]; });
+
+  std::vector<xdprocks::Slice> key_slices;
+  key_slices.reserve(keys.size());
+  for (auto index : indexes) {
+    key_slices.emplace_back(keys[index]);
+  }
+
+  std::vector<xdprocks::PinnableSlice> values(keys.size());
+  std::vector<xdprocks::Status> statuses(keys.size());
+
+  xdprocks::ReadOptions read_option;
+  read_option.snapshot = static_cast<const xdprocks::Snapshot*>(snapshot->Inner());
+  read_option.async_io = FLAGS_xdprocks_multi_get_async_io;
+  GetDB()->MultiGet(read_option, column_family->GetHandle(), key_slices.size(), key_slices.data(), values.data(),
+                    statuses.data(), true);
+
+  // Restore the origin order of keys.
+  std::vector<int> positions(keys.size(), -1);
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    const auto& s = statuses[i];
+    if (s.ok()) {
+      positions[indexes[i]] = i;
+    } else if (!s.IsNotFound()) {
+      DINGO_LOG(ERROR) << fmt::format("[xdprocks] multi get key failed, error: {}", s.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Internal multi get error");
+    }
+  }
+
+  kvs.reserve(kvs.size() + keys.size());
+  for (size_t i = 0; i < positions.size(); ++i) {
+    if (positions[i] < 0) {
+      continue;
+    }
+
+    const auto& value = values[positions[i]];
+    pb::common::KeyValue kv;
+    kv.set_key(keys[i]);
+    kv.set_value(value.data(), value.size());
+    kvs.push_back(std::move(kv));
+  }
+
+  return butil::Status();
+}
+
 butil::Status Reader::KvScan(ColumnFamilyPtr column_family, std::shared_ptr<dingodb::Snapshot> snapshot,
                              const std::string& start_key, const std::string& end_key,
                              std::vector<pb::common::KeyValue>& kvs) {
@@ -429,6 +508,9 @@ dingodb::IteratorPtr Reader::NewIterator(ColumnFamilyPtr column_family, dingodb:
     read_options.snapshot = static_cast<const xdprocks::Snapshot*>(snapshot->Inner());
   }
   read_options.auto_prefix_mode = true;
+  if (options.readahead_size > 0) {
+    read_options.readahead_size = options.readahead_size;
+  }
 
   return std::make_shared<Iterator>(options, GetDB()->NewIterator(read_options, column_family->GetHandle()), snapshot);
 }
@@ -668,6 +750,12 @@ static xdp::ColumnFamilyMap GenColumnFamilyByDefaultConfig(const std::vector<std
   default_config.emplace(Constant::kMaxBytesForLevelBase, Constant::kMaxBytesForLevelBaseDefaultValue);
   default_config.emplace(Constant::kTargetFileSizeBase, Constant::kTargetFileSizeBaseDefaultValue);
   default_config.emplace(Constant::kMaxBytesForLevelMultiplier, Constant::kMaxBytesForLevelMultiplierDefaultValue);
+  default_config.emplace(Constant::kBlockCacheType, Constant::kBlockCacheTypeDefaultValue);
+  default_config.emplace(Constant::kFilterPolicy, Constant::kFilterPolicyDefaultValue);
+  default_config.emplace(Constant::kFilterBitsPerKey, Constant::kFilterBitsPerKeyDefaultValue);
+  default_config.emplace(Constant::kWholeKeyFiltering, Constant::kWholeKeyFilteringDefaultValue);
+  default_config.emplace(Constant::kPartitionedIndexFilter, Constant::kPartitionedIndexFilterDefaultValue);
+  default_config.emplace(Constant::kPinIndexFilterInCache, Constant::kPinIndexFilterInCacheDefaultValue);
 
   xdp::ColumnFamilyMap column_families;
   for (const auto& cf_name : column_family_names) {
@@ -764,7 +852,17 @@ static xdprocks::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(xdp::ColumnFa
     size_t option_value = 0;
     CastValue(column_family->GetConfItem(Constant::kBlockCache), option_value);
 
-    table_options.block_cache = xdprocks::NewLRUCache(option_value);  // LRUcache
+    std::string cache_type;
+    CastValue(column_family->GetConfItem(Constant::kBlockCacheType), cache_type);
+    if (cache_type == "hyper_clock") {
+      // estimated_entry_charge 0 means auto tune by block size.
+      table_options.block_cache = xdprocks::HyperClockCacheOptions(option_value, 0).MakeSharedCache();
+    } else {
+      if (cache_type != "lru") {
+        DINGO_LOG(WARNING) << fmt::format("[xdprocks] unknown block cache type {}, use lru.", cache_type);
+      }
+      table_options.block_cache = xdprocks::NewLRUCache(option_value);  // LRUcache
+    }
   }
 
   // arena_block_size
@@ -808,8 +906,49 @@ static xdprocks::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(xdp::ColumnFa
       xdprocks::CompressionType::kZSTD,
   };
 
-  table_options.filter_policy.reset(xdprocks::NewBloomFilterPolicy(10.0, false));
-  table_options.whole_key_filtering = true;
+  // filter_policy
+  {
+    std::string filter_policy;
+    CastValue(column_family->GetConfItem(Constant::kFilterPolicy), filter_policy);
+    double bits_per_key = 0;
+    CastValue(column_family->GetConfItem(Constant::kFilterBitsPerKey), bits_per_key);
+
+    if (filter_policy == "ribbon") {
+      table_options.filter_policy.reset(xdprocks::NewRibbonFilterPolicy(bits_per_key));
+    } else if (filter_policy == "bloom") {
+      table_options.filter_policy.reset(xdprocks::NewBloomFilterPolicy(bits_per_key, false));
+    } else if (filter_policy != "none") {
+      DINGO_LOG(WARNING) << fmt::format("[xdprocks] unknown filter policy {}, use bloom.", filter_policy);
+      table_options.filter_policy.reset(xdprocks::NewBloomFilterPolicy(bits_per_key, false));
+    }
+
+    std::string whole_key_filtering;
+    CastValue(column_family->GetConfItem(Constant::kWholeKeyFiltering), whole_key_filtering);
+    table_options.whole_key_filtering = (whole_key_filtering == "true");
+  }
+
+  // partitioned index and filter, index/filter blocks live in block cache
+  {
+    std::string partitioned;
+    CastValue(column_family->GetConfItem(Constant::kPartitionedIndexFilter), partitioned);
+    if (partitioned == "true") {
+      table_options.index_type = xdprocks::BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+      table_options.partition_filters = (table_options.filter_policy != nullptr);
+      table_options.cache_index_and_filter_blocks = true;
+      table_options.cache_index_and_filter_blocks_with_high_priority = true;
+      table_options.pin_top_level_index_and_filter = true;
+    }
+
+    std::string pin_in_cache;
+    CastValue(column_family->GetConfItem(Constant::kPinIndexFilterInCache), pin_in_cache);
+    if (pin_in_cache == "true") {
+      table_options.cache_index_and_filter_blocks = true;
+      table_options.cache_index_and_filter_blocks_with_high_priority = true;
+      table_options.metadata_cache_options.top_level_index_pinning = xdprocks::PinningTier::kAll;
+      table_options.metadata_cache_options.partition_pinning = xdprocks::PinningTier::kAll;
+      table_options.metadata_cache_options.unpartitioned_pinning = xdprocks::PinningTier::kAll;
+    }
+  }
 
   xdprocks::TableFactory* table_factory = NewBlockBasedTableFactory(table_options);
   family_options.table_factory.reset(table_factory);
@@ -832,6 +971,9 @@ static xdprocks::DB* InitDB(const std::string& db_path, xdp::ColumnFamilyMap& co
   db_options.max_background_jobs = ConfigHelper::GetRocksDBBackgroundThreadNum();
   db_options.max_subcompactions = db_options.max_background_jobs / 4 * 3;
   db_options.stats_dump_period_sec = ConfigHelper::GetRocksDBStatsDumpPeriodSec();
+  // Background io of flush and compaction is large and read once, direct io keep it out of page cache.
+  db_options.use_direct_io_for_flush_and_compaction = FLAGS_xdprocks_use_direct_io_for_flush_and_compaction;
+  db_options.compaction_readahead_size = FLAGS_xdprocks_compaction_readahead_size_kb * 1024;
   DINGO_LOG(INFO) << fmt::format("[xdprocks] config max_background_jobs({}) max_subcompactions({})",
                                  db_options.max_background_jobs, db_options.max_subcompactions);
 
@@ -23,12 +23,15 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "config/config_helper.h"
+#include "engine/txn_lock_table.h"
+#include "engine/txn_resolved_ts.h"
 #include "fmt/core.h"
 #include "handler/raft_snapshot_handler.h"
 #include "handler/raft_vote_handler.h"
 #include "proto/common.pb.h"
 #include "proto/raft.pb.h"
 #include "server/server.h"
+#include "store/cdc.h"
 #include "store/heartbeat.h"
 
 namespace dingodb {
@@ -66,6 +69,11 @@ int SmSnapshotSaveEventListener::OnEvent(std::shared_ptr<Event> event) {
 int SmSnapshotLoadEventListener::OnEvent(std::shared_ptr<Event> event) {
   auto the_event = std::dynamic_pointer_cast<SmSnapshotLoadEvent>(event);
 
+  // lock cf is replaced by snapshot
+  TxnLockTableManager::GetInstance().Remove(the_event->region->Id());
+  TxnResolvedTsManager::GetInstance().Remove(the_event->region->Id());
+  CdcManager::GetInstance().Remove(the_event->region->Id());
+
   if (handler_) {
     int ret = handler_->Handle(the_event->region, the_event->engine, the_event->reader);
     if (ret != 0) {
@@ -98,6 +106,8 @@ int SmLeaderStartEventListener::OnEvent(std::shared_ptr<Event> event) {
   // trigger heartbeat
   Heartbeat::TriggerStoreHeartbeat({region->Id()});
 
+  TxnLockTableManager::GetInstance().Load(region, Server::GetInstance().GetRawEngine(region->GetRawEngineType()));
+
   // Invoke handler
   auto handlers = handler_collection_->GetHandlers();
   for (auto& handle : handlers) {
@@ -110,6 +120,10 @@ int SmLeaderStartEventListener::OnEvent(std::shared_ptr<Event> event) {
 int SmLeaderStopEventListener::OnEvent(std::shared_ptr<Event> event) {
   auto the_event = std::dynamic_pointer_cast<SmLeaderStopEvent>(event);
 
+  if (the_event->region != nullptr) {
+    TxnLockTableManager::GetInstance().Remove(the_event->region->Id());
+  }
+
   // Invoke handler
   auto handlers = handler_collection_->GetHandlers();
   for (auto& handle : handlers) {
@@ -131,7 +145,8 @@ int SmConfigurationCommittedEventListener::OnEvent(std::shared_ptr<Event> event)
   if (region == nullptr) {
     return 0;
   }
-  const auto& old_peers = region->Peers();
+  // Learners are not in braft configuration, keep them.
+  const auto old_peers = region->Peers(pb::common::VOTER);
 
   // Get last peer from braft configuration.
   std::vector<braft::PeerId> new_peers;
@@ -165,6 +180,9 @@ int SmConfigurationCommittedEventListener::OnEvent(std::shared_ptr<Event> event)
   if (get_changed_peers(changed_peers)) {
     DINGO_LOG(INFO) << fmt::format("[raft.sm][region({})] peers have changed, peers({})", region->Id(),
                                    Helper::PeersToString(changed_peers));
+    for (const auto& learner : region->Peers(pb::common::LEARNER)) {
+      changed_peers.push_back(learner);
+    }
     region->SetPeers(changed_peers);
     store_region_meta->UpdateEpochConfVersion(region, region->Epoch().conf_version());
     // Notify coordinator
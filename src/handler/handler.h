@@ -39,6 +39,9 @@ enum class HandlerType {
   kPrepareMerge = pb::raft::PREPARE_MERGE,
   kCommitMerge = pb::raft::COMMIT_MERGE,
   kRollbackMerge = pb::raft::ROLLBACK_MERGE,
+  kIngestSst = pb::raft::INGEST_SST,
+  kComputeHash = pb::raft::COMPUTE_HASH,
+  kChangeLearner = pb::raft::CHANGE_LEARNER,
   kMetaWrite = pb::raft::META_WRITE,
   kCompareAndSet = pb::raft::COMPAREANDSET,
   kSaveSnapshotInApply = pb::raft::SAVE_RAFT_SNAPSHOT,
@@ -14,12 +14,14 @@
 
 #include "handler/raft_apply_handler.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "bthread/bthread.h"
@@ -31,6 +33,9 @@
 #include "common/role.h"
 #include "config/config_manager.h"
 #include "engine/raw_engine.h"
+#include "engine/raw_kv_ttl.h"
+#include "engine/txn_lock_table.h"
+#include "engine/txn_resolved_ts.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
 #include "meta/store_meta_manager.h"
@@ -39,15 +44,23 @@
 #include "proto/index.pb.h"
 #include "proto/raft.pb.h"
 #include "server/server.h"
+#include "store/cdc.h"
+#include "store/region_hash.h"
+#include "store/sst_ingest.h"
 #include "vector/codec.h"
+#include "vector/vector_index_manager.h"
+#include "vector/vector_scalar_index.h"
 
 DECLARE_int32(init_election_timeout_ms);
 
 namespace dingodb {
 
+DEFINE_bool(enable_delete_range_files, false,
+            "drop the sst files inside range when delete range covers the whole region, it ignores the snapshots");
+
 int PutHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
                        const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t /*term_id*/,
-                       int64_t /*log_id*/) {
+                       int64_t log_id) {
   butil::Status status;
   const auto &request = req.put();
 
@@ -64,6 +77,9 @@ int PutHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, st
   if (status.error_code() == pb::error::Errno::EINTERNAL) {
     DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] put failed, error: {}", region->Id(), status.error_str());
   }
+  if (status.ok()) {
+    CdcManager::GetInstance().CapturePut(region->Id(), log_id, request.cf_name(), request.kvs());
+  }
 
   if (ctx) {
     ctx->SetStatus(status);
@@ -77,9 +93,79 @@ int PutHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, st
   return 0;
 }
 
-int DeleteRangeHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr /*region*/,
+void PutHandler::BatchHandle(const std::vector<std::shared_ptr<pb::raft::RaftCmdRequest>> &raft_cmds,
+                             const std::vector<std::shared_ptr<Context>> &ctxs, const std::vector<int64_t> &log_ids,
+                             std::shared_ptr<pb::common::KeyValue> raft_meta_kv, store::RegionPtr region,
+                             std::shared_ptr<RawEngine> engine, store::RegionMetricsPtr region_metrics) {
+  std::vector<bool> valids(raft_cmds.size(), true);
+  std::map<std::string, std::vector<pb::common::KeyValue>> kv_puts_with_cf;
+  for (size_t i = 0; i < raft_cmds.size(); ++i) {
+    for (const auto &req : raft_cmds[i]->requests()) {
+      const auto &request = req.put();
+      bool has_empty_key = std::any_of(request.kvs().begin(), request.kvs().end(),
+                                       [](const pb::common::KeyValue &kv) { return kv.key().empty(); });
+      if (request.kvs().empty() || has_empty_key) {
+        valids[i] = false;
+        break;
+      }
+    }
+
+    if (!valids[i]) {
+      if (ctxs[i]) {
+        ctxs[i]->SetStatus(butil::Status(pb::error::EKEY_EMPTY, "Key is empty"));
+      }
+      continue;
+    }
+
+    // keep the log order of the same cf, the later put overwrite the earlier.
+    for (const auto &req : raft_cmds[i]->requests()) {
+      auto &kvs = kv_puts_with_cf[req.put().cf_name()];
+      kvs.insert(kvs.end(), req.put().kvs().begin(), req.put().kvs().end());
+    }
+  }
+
+  butil::Status status;
+  if (!kv_puts_with_cf.empty()) {
+    if (raft_meta_kv != nullptr) {
+      kv_puts_with_cf[Constant::kStoreMetaCF].push_back(*raft_meta_kv);
+    }
+
+    auto writer = engine->Writer();
+    if (!writer) {
+      DINGO_LOG(FATAL) << "[raft.apply][region(" << region->Id() << ")] NewWriter failed";
+    }
+    status = writer->KvBatchPutAndDeleteApplied(kv_puts_with_cf, {});
+    if (status.error_code() == pb::error::Errno::EINTERNAL) {
+      DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] batch put failed, error: {}", region->Id(),
+                                      status.error_str());
+    }
+  }
+
+  for (size_t i = 0; i < raft_cmds.size(); ++i) {
+    if (!valids[i]) {
+      continue;
+    }
+    if (ctxs[i]) {
+      ctxs[i]->SetStatus(status);
+    }
+    if (status.ok()) {
+      for (const auto &req : raft_cmds[i]->requests()) {
+        CdcManager::GetInstance().CapturePut(region->Id(), log_ids[i], req.put().cf_name(), req.put().kvs());
+      }
+    }
+
+    // Update region metrics min/max key
+    if (region_metrics != nullptr) {
+      for (const auto &req : raft_cmds[i]->requests()) {
+        region_metrics->UpdateMaxAndMinKey(req.put().kvs());
+      }
+    }
+  }
+}
+
+int DeleteRangeHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region,
                                std::shared_ptr<RawEngine> engine, const pb::raft::Request &req,
-                               store::RegionMetricsPtr region_metrics, int64_t /*term_id*/, int64_t /*log_id*/) {
+                               store::RegionMetricsPtr region_metrics, int64_t /*term_id*/, int64_t log_id) {
   butil::Status status;
   const auto &request = req.delete_range();
 
@@ -94,6 +180,18 @@ int DeleteRangeHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr /*
       status = writer->KvDeleteRange(request.cf_name(), range);
     }
     delete_count = internal_delete_count;
+
+    // Truncate of table or index, the tombstone is written, drop the files fully inside range at once instead of
+    // waiting for compaction. Range of txn cf is encoded, not comparable with region range.
+    if (status.ok() && delete_count > 0 && FLAGS_enable_delete_range_files && region != nullptr &&
+        !Helper::IsTxnColumnFamilyName(request.cf_name()) && range.start_key() <= region->Range().start_key() &&
+        range.end_key() >= region->Range().end_key()) {
+      auto delete_status = engine->DeleteFilesInRange(request.cf_name(), range);
+      if (!delete_status.ok()) {
+        DINGO_LOG(WARNING) << fmt::format("[raft.apply][region({})] delete files in range failed, cf: {} error: {}",
+                                          region->Id(), request.cf_name(), delete_status.error_str());
+      }
+    }
   } else {
     auto snapshot = engine->GetSnapshot();
     for (const auto &range : request.ranges()) {
@@ -112,6 +210,9 @@ int DeleteRangeHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr /*
       status = writer->KvBatchDeleteRange(range_with_cfs);
     }
   }
+  if (status.ok() && delete_count > 0) {
+    CdcManager::GetInstance().CaptureDeleteRange(region->Id(), log_id, request.cf_name(), request.ranges());
+  }
 
   if (ctx && ctx->Response()) {
     auto *response = dynamic_cast<pb::store::KvDeleteRangeResponse *>(ctx->Response());
@@ -121,6 +222,11 @@ int DeleteRangeHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr /*
     }
   }
 
+  // Scalar data is deleted out of the apply of vector delete.
+  if (request.cf_name() == Constant::kVectorScalarCF && region != nullptr && region->VectorIndexWrapper() != nullptr) {
+    region->VectorIndexWrapper()->ScalarInvertedIndex()->Clear();
+  }
+
   // Update region metrics min/max key policy
   if (region_metrics != nullptr) {
     region_metrics->UpdateMaxAndMinKeyPolicy(request.ranges());
@@ -131,7 +237,7 @@ int DeleteRangeHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr /*
 
 int DeleteBatchHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
                                const pb::raft::Request &req, store::RegionMetricsPtr region_metrics,
-                               int64_t /*term_id*/, int64_t /*log_id*/) {
+                               int64_t /*term_id*/, int64_t log_id) {
   butil::Status status;
   const auto &request = req.delete_batch();
 
@@ -162,6 +268,9 @@ int DeleteBatchHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr re
     DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] delete failed, error: {}", region->Id(),
                                     status.error_str());
   }
+  if (status.ok()) {
+    CdcManager::GetInstance().CaptureDelete(region->Id(), log_id, request.cf_name(), request.keys());
+  }
 
   if (ctx && ctx->Response()) {
     auto *response = dynamic_cast<pb::store::KvBatchDeleteResponse *>(ctx->Response());
@@ -179,6 +288,164 @@ int DeleteBatchHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr re
   return 0;
 }
 
+// Get the old value of conditional write, the expired value is not found.
+// now_ms is from the leader, so all replicas get the same result.
+static butil::Status GetConditionValue(std::shared_ptr<RawEngine::Reader> reader, const std::string &cf_name,
+                                       const std::string &key, int64_t now_ms, std::string &value) {
+  auto status = reader->KvGet(cf_name, key, value);
+  if (status.ok() && RawKvTtl::IsEnabled(cf_name, key)) {
+    std::string_view user_value;
+    if (!RawKvTtl::DecodeValue(value, now_ms, user_value)) {
+      return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
+    }
+    value.erase(0, value.size() - user_value.size());
+  }
+
+  return status;
+}
+
+int PutIfAbsentHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                               const pb::raft::Request &req, store::RegionMetricsPtr region_metrics,
+                               int64_t /*term_id*/, int64_t log_id) {
+  const auto &request = req.put_if_absent();
+
+  auto reader = engine->Reader();
+  std::vector<bool> key_states(request.kvs().size(), false);
+  google::protobuf::RepeatedPtrField<pb::common::KeyValue> put_kvs;
+  for (int i = 0; i < request.kvs().size(); ++i) {
+    const auto &kv = request.kvs(i);
+    std::string old_value;
+    auto status = GetConditionValue(reader, request.cf_name(), kv.key(), request.now_ms(), old_value);
+    if (!status.ok() && status.error_code() != pb::error::EKEY_NOT_FOUND) {
+      DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] get failed, error: {}", region->Id(),
+                                      status.error_str());
+    }
+
+    if (status.ok()) {
+      if (request.is_atomic()) {
+        // any key exist, put nothing.
+        put_kvs.Clear();
+        std::fill(key_states.begin(), key_states.end(), false);
+        break;
+      }
+      continue;
+    }
+
+    *put_kvs.Add() = kv;
+    key_states[i] = true;
+  }
+
+  butil::Status status;
+  if (!put_kvs.empty()) {
+    auto writer = engine->Writer();
+    if (!writer) {
+      DINGO_LOG(FATAL) << "[raft.apply][region(" << region->Id() << ")] NewWriter failed";
+    }
+    status = writer->KvBatchPutAndDelete(request.cf_name(), Helper::PbRepeatedToVector(put_kvs), {});
+    if (status.error_code() == pb::error::Errno::EINTERNAL) {
+      DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] put if absent failed, error: {}", region->Id(),
+                                      status.error_str());
+    }
+    if (status.ok()) {
+      CdcManager::GetInstance().CapturePut(region->Id(), log_id, request.cf_name(), put_kvs);
+    }
+
+    if (region_metrics != nullptr) {
+      region_metrics->UpdateMaxAndMinKey(put_kvs);
+    }
+  }
+
+  if (ctx) {
+    ctx->SetKeyStates(key_states);
+    ctx->SetStatus(status);
+  }
+
+  return 0;
+}
+
+int CompareAndSetHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                                 std::shared_ptr<RawEngine> engine, const pb::raft::Request &req,
+                                 store::RegionMetricsPtr region_metrics, int64_t /*term_id*/, int64_t log_id) {
+  const auto &request = req.compare_and_set();
+
+  butil::Status status;
+  auto reader = engine->Reader();
+  std::vector<bool> key_states(request.kvs().size(), false);
+  google::protobuf::RepeatedPtrField<pb::common::KeyValue> put_kvs;
+  google::protobuf::RepeatedPtrField<std::string> delete_keys;
+  for (int i = 0; i < request.kvs().size() && i < request.expect_values().size(); ++i) {
+    const auto &kv = request.kvs(i);
+    const auto &expect_value = request.expect_values(i);
+    std::string old_value;
+    auto get_status = GetConditionValue(reader, request.cf_name(), kv.key(), request.now_ms(), old_value);
+    if (!get_status.ok() && get_status.error_code() != pb::error::EKEY_NOT_FOUND) {
+      DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] get failed, error: {}", region->Id(),
+                                      get_status.error_str());
+    }
+
+    // not exist key match empty expect value.
+    bool is_match = get_status.ok() ? old_value == expect_value : expect_value.empty();
+    if (!is_match) {
+      if (request.is_atomic()) {
+        // any key not match, set nothing.
+        if (!get_status.ok()) {
+          status = butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
+        }
+        put_kvs.Clear();
+        delete_keys.Clear();
+        std::fill(key_states.begin(), key_states.end(), false);
+        break;
+      }
+      continue;
+    }
+
+    // value empty means delete
+    if (kv.value().empty()) {
+      *delete_keys.Add() = kv.key();
+    } else {
+      *put_kvs.Add() = kv;
+    }
+    key_states[i] = true;
+  }
+
+  if (!put_kvs.empty() || !delete_keys.empty()) {
+    auto writer = engine->Writer();
+    if (!writer) {
+      DINGO_LOG(FATAL) << "[raft.apply][region(" << region->Id() << ")] NewWriter failed";
+    }
+    status = writer->KvBatchPutAndDelete(request.cf_name(), Helper::PbRepeatedToVector(put_kvs),
+                                         Helper::PbRepeatedToVector(delete_keys));
+    if (status.error_code() == pb::error::Errno::EINTERNAL) {
+      DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] compare and set failed, error: {}", region->Id(),
+                                      status.error_str());
+    }
+    if (status.ok()) {
+      if (!put_kvs.empty()) {
+        CdcManager::GetInstance().CapturePut(region->Id(), log_id, request.cf_name(), put_kvs);
+      }
+      if (!delete_keys.empty()) {
+        CdcManager::GetInstance().CaptureDelete(region->Id(), log_id, request.cf_name(), delete_keys);
+      }
+    }
+
+    if (region_metrics != nullptr) {
+      if (!put_kvs.empty()) {
+        region_metrics->UpdateMaxAndMinKey(put_kvs);
+      }
+      if (!delete_keys.empty()) {
+        region_metrics->UpdateMaxAndMinKeyPolicy(delete_keys);
+      }
+    }
+  }
+
+  if (ctx) {
+    ctx->SetKeyStates(key_states);
+    ctx->SetStatus(status);
+  }
+
+  return 0;
+}
+
 static void LaunchAyncSaveSnapshot(store::RegionPtr region) {  // NOLINT
   auto store_region_meta = GET_STORE_REGION_META;
   store_region_meta->UpdateNeedBootstrapDoSnapshot(region, true);
@@ -625,6 +892,9 @@ int SplitHandler::Handle(std::shared_ptr<Context>, store::RegionPtr from_region,
     store_raft_meata->SaveRaftMeta(from_region->Id());
   }
 
+  // The keys moved to the child region are not deleted in the change stream.
+  CdcManager::GetInstance().Remove(from_region->Id());
+
   // Update region metrics min/max key policy
   // Update region_size in next collect region metrics
   if (region_metrics != nullptr) {
@@ -848,6 +1118,14 @@ int CommitMergeHandler::Handle(std::shared_ptr<Context>, store::RegionPtr target
 
   FAIL_POINT("before_commit_merge_modify_epoch");
 
+  // Locks of source region are not in the lock table of target region, drop it before range is extended.
+  TxnLockTableManager::GetInstance().Remove(target_region->Id());
+  TxnLockTableManager::GetInstance().Remove(source_region->Id());
+  TxnResolvedTsManager::GetInstance().Remove(target_region->Id());
+  TxnResolvedTsManager::GetInstance().Remove(source_region->Id());
+  CdcManager::GetInstance().Remove(target_region->Id());
+  CdcManager::GetInstance().Remove(source_region->Id());
+
   store_region_meta->UpdateState(source_region, pb::common::StoreRegionState::MERGING);
   store_region_meta->UpdateState(target_region, pb::common::StoreRegionState::MERGING);
 
@@ -955,6 +1233,82 @@ int RollbackMergeHandler::Handle(std::shared_ptr<Context>, store::RegionPtr /*so
   return 0;
 }
 
+int IngestSstHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                             const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t /*term_id*/,
+                             int64_t log_id) {
+  const auto &request = req.ingest_sst();
+
+  if (request.cf_name() == Constant::kTxnLockCF) {
+    TxnLockTableManager::GetInstance().Remove(region->Id());
+    TxnResolvedTsManager::GetInstance().Remove(region->Id());
+  }
+  // The ingested kvs are not in the change stream.
+  CdcManager::GetInstance().Remove(region->Id());
+
+  auto status = SstIngestManager::IngestFiles(region->Id(), engine, request.cf_name(),
+                                              Helper::PbRepeatedToVector(request.filenames()));
+  if (request.cf_name() == Constant::kVectorScalarCF && region->VectorIndexWrapper() != nullptr) {
+    region->VectorIndexWrapper()->ScalarInvertedIndex()->Clear();
+  }
+  if (!status.ok()) {
+    // The files of follower are downloaded before proposing, missing file means the replica diverge.
+    DINGO_LOG(ERROR) << fmt::format("[raft.apply][region({})] ingest sst failed, log_id({}) files({}) error: {}",
+                                    region->Id(), log_id, request.filenames_size(), Helper::PrintStatus(status));
+  } else {
+    DINGO_LOG(INFO) << fmt::format("[raft.apply][region({})] ingest sst finish, log_id({}) files({})", region->Id(),
+                                   log_id, request.filenames_size());
+  }
+
+  if (ctx) {
+    ctx->SetStatus(status);
+  }
+
+  // Update region metrics min/max key policy
+  if (region_metrics != nullptr) {
+    region_metrics->UpdateMaxAndMinKeyPolicy();
+    region_metrics->SetNeedUpdateKeyCount(true);
+  }
+
+  return 0;
+}
+
+int ComputeHashHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                               std::shared_ptr<RawEngine> engine, const pb::raft::Request &req,
+                               store::RegionMetricsPtr /*region_metrics*/, int64_t /*term_id*/, int64_t log_id) {
+  RegionHashManager::GetInstance().Checkpoint(region, engine, req.compute_hash(), log_id);
+
+  if (ctx) {
+    ctx->SetStatus(butil::Status());
+  }
+
+  return 0;
+}
+
+int ChangeLearnerHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                                 std::shared_ptr<RawEngine> /*engine*/, const pb::raft::Request &req,
+                                 store::RegionMetricsPtr /*region_metrics*/, int64_t /*term_id*/, int64_t log_id) {
+  // Keep the voters, replace all learners.
+  auto peers = region->Peers(pb::common::VOTER);
+  for (const auto &learner : req.change_learner().learners()) {
+    auto peer = learner;
+    peer.set_role(pb::common::LEARNER);
+    peers.push_back(peer);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.apply][region({})] change learner, log_id({}) peers({})", region->Id(), log_id,
+                                 Helper::PeersToString(peers));
+  GET_STORE_REGION_META->UpdatePeers(region, peers);
+
+  if (ctx) {
+    ctx->SetStatus(butil::Status());
+  }
+
+  // Notify coordinator
+  Heartbeat::TriggerStoreHeartbeat({region->Id()});
+
+  return 0;
+}
+
 int SaveRaftSnapshotHandler::Handle(std::shared_ptr<Context>, store::RegionPtr region, std::shared_ptr<RawEngine>,
                                     const pb::raft::Request &, store::RegionMetricsPtr, int64_t term_id,
                                     int64_t log_id) {
@@ -1002,7 +1356,7 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
       VectorCodec::EncodeVectorKey(region_start_key[0], region_part_id, vector.id(), key);
 
       kv.mutable_key()->swap(key);
-      kv.set_value(vector.vector().SerializeAsString());
+      VectorCodec::EncodeVectorValue(vector.vector(), *kv.mutable_value());
       kvs_default.push_back(kv);
     }
     // vector scalar data
@@ -1041,6 +1395,13 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
     }
   }
 
+  if (status.ok() && VectorScalarInvertedIndex::IsEnabled()) {
+    auto scalar_inverted_index = region->VectorIndexWrapper()->ScalarInvertedIndex();
+    for (const auto &vector : request.vectors()) {
+      scalar_inverted_index->Upsert(vector.id(), vector.scalar_data());
+    }
+  }
+
   if (ctx) {
     if (ctx->Response()) {
       bool key_state = status.ok();
@@ -1072,6 +1433,11 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
           vector_with_ids.push_back(vector_with_id);
         }
 
+        std::vector<int64_t> delete_ids;
+        if (VectorIndexManager::AsyncApplyVectorIndex(vector_index_wrapper, vector_with_ids, delete_ids, log_id)) {
+          return 0;
+        }
+
         auto start_time = Helper::TimestampNs();
         auto status = vector_index_wrapper->Upsert(vector_with_ids);
         DINGO_LOG(DEBUG) << fmt::format("[raft.apply][region({})] upsert vector, count: {} cost: {}us", vector_index_id,
@@ -1163,6 +1529,13 @@ int VectorDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr r
     }
   }
 
+  if (status.ok() && VectorScalarInvertedIndex::IsEnabled()) {
+    auto scalar_inverted_index = region->VectorIndexWrapper()->ScalarInvertedIndex();
+    for (auto delete_id : delete_ids) {
+      scalar_inverted_index->Delete(delete_id);
+    }
+  }
+
   if (ctx) {
     if (ctx->Response()) {
       auto *response = dynamic_cast<pb::index::VectorDeleteResponse *>(ctx->Response());
@@ -1184,6 +1557,11 @@ int VectorDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr r
   if (is_ready && !delete_ids.empty()) {
     if (log_id > vector_index_wrapper->ApplyLogId()) {
       try {
+        std::vector<pb::common::VectorWithId> vector_with_ids;
+        if (VectorIndexManager::AsyncApplyVectorIndex(vector_index_wrapper, vector_with_ids, delete_ids, log_id)) {
+          return 0;
+        }
+
         auto status = vector_index_wrapper->Delete(delete_ids);
         if (status.ok()) {
           vector_index_wrapper->SetApplyLogId(log_id);
@@ -1222,10 +1600,15 @@ std::shared_ptr<HandlerCollection> RaftApplyHandlerFactory::Build() {
   handler_collection->Register(std::make_shared<PutHandler>());
   handler_collection->Register(std::make_shared<DeleteRangeHandler>());
   handler_collection->Register(std::make_shared<DeleteBatchHandler>());
+  handler_collection->Register(std::make_shared<PutIfAbsentHandler>());
+  handler_collection->Register(std::make_shared<CompareAndSetHandler>());
   handler_collection->Register(std::make_shared<SplitHandler>());
   handler_collection->Register(std::make_shared<PrepareMergeHandler>());
   handler_collection->Register(std::make_shared<CommitMergeHandler>());
   handler_collection->Register(std::make_shared<RollbackMergeHandler>());
+  handler_collection->Register(std::make_shared<IngestSstHandler>());
+  handler_collection->Register(std::make_shared<ComputeHashHandler>());
+  handler_collection->Register(std::make_shared<ChangeLearnerHandler>());
   handler_collection->Register(std::make_shared<VectorAddHandler>());
   handler_collection->Register(std::make_shared<VectorDeleteHandler>());
   handler_collection->Register(std::make_shared<RebuildVectorIndexHandler>());
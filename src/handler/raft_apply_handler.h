@@ -17,6 +17,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "common/context.h"
 #include "engine/raw_engine.h"
@@ -32,6 +33,14 @@ class PutHandler : public BaseHandler {
   int Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
              const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
              int64_t log_id) override;
+
+  // Put requests of consecutive raft logs in one write batch, ctxs[i] and log_ids[i] are of raft_cmds[i].
+  // The raft cmd with invalid kvs is failed alone, not affect the others.
+  // raft_meta_kv is the applied index written in the same batch, maybe nullptr.
+  static void BatchHandle(const std::vector<std::shared_ptr<pb::raft::RaftCmdRequest>> &raft_cmds,
+                          const std::vector<std::shared_ptr<Context>> &ctxs, const std::vector<int64_t> &log_ids,
+                          std::shared_ptr<pb::common::KeyValue> raft_meta_kv, store::RegionPtr region,
+                          std::shared_ptr<RawEngine> engine, store::RegionMetricsPtr region_metrics);
 };
 
 // DeleteRangeRequest
@@ -52,6 +61,24 @@ class DeleteBatchHandler : public BaseHandler {
              int64_t log_id) override;
 };
 
+// PutIfAbsentRequest, the old value is read at apply, so the condition is evaluated in log order.
+class PutIfAbsentHandler : public BaseHandler {
+ public:
+  HandlerType GetType() override { return HandlerType::kPutIfabsent; }
+  int Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+             const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+             int64_t log_id) override;
+};
+
+// CompareAndSetRequest, the old value is read at apply, so the condition is evaluated in log order.
+class CompareAndSetHandler : public BaseHandler {
+ public:
+  HandlerType GetType() override { return HandlerType::kCompareAndSet; }
+  int Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+             const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+             int64_t log_id) override;
+};
+
 // SplitHandler
 class SplitHandler : public BaseHandler {
  public:
@@ -101,6 +128,33 @@ class RollbackMergeHandler : public BaseHandler {
              int64_t log_id) override;
 };
 
+// Handle raft command IngestSstRequest
+class IngestSstHandler : public BaseHandler {
+ public:
+  HandlerType GetType() override { return HandlerType::kIngestSst; }
+  int Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+             const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+             int64_t log_id) override;
+};
+
+// Handle raft command ComputeHashRequest
+class ComputeHashHandler : public BaseHandler {
+ public:
+  HandlerType GetType() override { return HandlerType::kComputeHash; }
+  int Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+             const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+             int64_t log_id) override;
+};
+
+// Handle raft command ChangeLearnerRequest
+class ChangeLearnerHandler : public BaseHandler {
+ public:
+  HandlerType GetType() override { return HandlerType::kChangeLearner; }
+  int Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+             const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+             int64_t log_id) override;
+};
+
 // SaveRaftSnapshotHandler
 class SaveRaftSnapshotHandler : public BaseHandler {
  public:
@@ -24,6 +24,8 @@
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "engine/txn_lock_table.h"
+#include "engine/txn_lock_wait.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "handler/raft_apply_handler.h"
@@ -31,6 +33,7 @@
 #include "proto/common.pb.h"
 #include "proto/raft.pb.h"
 #include "proto/store.pb.h"
+#include "store/cdc.h"
 
 namespace dingodb {
 
@@ -39,7 +42,7 @@ DECLARE_bool(dingo_log_switch_txn_detail);
 void TxnHandler::HandleMultiCfPutAndDeleteRequest(std::shared_ptr<Context> ctx, store::RegionPtr region,
                                                   std::shared_ptr<RawEngine> engine,
                                                   const pb::raft::MultiCfPutAndDeleteRequest &request,
-                                                  [[maybe_unused]] store::RegionMetricsPtr region_metrics,
+                                                  store::RegionMetricsPtr region_metrics,
                                                   int64_t term_id, int64_t log_id) {
   DINGO_LOG(DEBUG) << fmt::format("[txn][region({})] HandleMultiCfPutAndDelete, term: {} apply_log_id: {}",
                                   region->Id(), term_id, log_id)
@@ -90,6 +93,15 @@ void TxnHandler::HandleMultiCfPutAndDeleteRequest(std::shared_ptr<Context> ctx,
     kv_deletes_with_cf.insert_or_assign(dels.cf_name(), kv_deletes);
   }
 
+  // lock table must be a superset of lock cf, add lock before write and delete lock after write
+  auto lock_table = TxnLockTableManager::GetInstance().Get(region->Id());
+  auto lock_puts = kv_puts_with_cf.find(Constant::kTxnLockCF);
+  if (lock_table != nullptr && lock_puts != kv_puts_with_cf.end()) {
+    for (const auto &kv : lock_puts->second) {
+      lock_table->Put(kv.key());
+    }
+  }
+
   auto writer = engine->Writer();
   auto status = writer->KvBatchPutAndDelete(kv_puts_with_cf, kv_deletes_with_cf);
   if (!status.ok()) {
@@ -98,6 +110,27 @@ void TxnHandler::HandleMultiCfPutAndDeleteRequest(std::shared_ptr<Context> ctx,
                      << ", write failed, request: " << request.ShortDebugString();
   }
 
+  auto lock_deletes = kv_deletes_with_cf.find(Constant::kTxnLockCF);
+  if (lock_table != nullptr && lock_deletes != kv_deletes_with_cf.end()) {
+    for (const auto &key : lock_deletes->second) {
+      lock_table->Delete(key);
+    }
+  }
+
+  // every write cf put is a new version, old versions of the key may become garbage
+  auto write_puts = kv_puts_with_cf.find(Constant::kTxnWriteCF);
+  if (region_metrics != nullptr && write_puts != kv_puts_with_cf.end()) {
+    region_metrics->IncTxnGcVersions(write_puts->second.size());
+  }
+  if (write_puts != kv_puts_with_cf.end()) {
+    CdcManager::GetInstance().CaptureTxnCommit(region->Id(), log_id, engine, write_puts->second);
+  }
+
+  // wake up pessimistic lock waiters of the removed locks
+  if (lock_deletes != kv_deletes_with_cf.end()) {
+    TxnLockWaitManager::GetInstance().WakeUp(lock_deletes->second);
+  }
+
   // check if need to commit to vector index
   const auto &vector_add = request.vector_add();
   if (vector_add.vectors_size() > 0) {
@@ -209,6 +242,13 @@ void TxnHandler::HandleTxnDeleteRangeRequest(std::shared_ptr<Context> ctx, store
                                     term_id, log_id)
                      << ", write failed, request: " << request.ShortDebugString() << ", status: " << status.error_str();
   }
+
+  auto lock_table = TxnLockTableManager::GetInstance().Get(region->Id());
+  if (lock_table != nullptr) {
+    lock_table->DeleteRange(range.start_key(), range.end_key());
+  }
+
+  CdcManager::GetInstance().CaptureTxnDeleteRange(region->Id(), log_id, request.start_key(), request.end_key());
 }
 
 int TxnHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
@@ -38,6 +38,8 @@
 namespace dingodb {
 
 DEFINE_string(raft_snapshot_policy, "dingo", "raft snapshot policy, checkpoint or scan");
+DEFINE_bool(raft_snapshot_range_checkpoint, true,
+            "checkpoint snapshot only link the sst files overlap with region range, not checkpoint the whole db");
 
 struct SaveRaftSnapshotArg {
   store::RegionPtr region;
@@ -75,9 +77,26 @@ butil::Status RaftSnapshot::GenSnapshotFileByCheckpoint(const std::string& check
                                                         std::vector<pb::store_internal::SstFileInfo>& sst_files) {
   auto checkpoint = engine_->NewCheckpoint();
 
+  auto cf_names = Helper::GetColumnFamilyNames(region->Range().start_key());
+  if (FLAGS_raft_snapshot_range_checkpoint) {
+    auto status = checkpoint->Create(checkpoint_path, cf_names, region->Range(), sst_files);
+    if (status.ok()) {
+      for (const auto& sst_file : sst_files) {
+        DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] sst file info: {}", region->Id(),
+                                       sst_file.ShortDebugString());
+      }
+      return butil::Status();
+    }
+
+    DINGO_LOG(WARNING) << fmt::format(
+        "[raft.snapshot][region({})] Create range checkpoint failed, fallback to whole checkpoint, error: {} {}",
+        region->Id(), status.error_code(), status.error_str());
+    sst_files.clear();
+    Helper::RemoveAllFileOrDirectory(checkpoint_path);
+  }
+
   std::vector<pb::store_internal::SstFileInfo> tmp_sst_files;
-  auto status =
-      checkpoint->Create(checkpoint_path, Helper::GetColumnFamilyNames(region->Range().start_key()), tmp_sst_files);
+  auto status = checkpoint->Create(checkpoint_path, cf_names, tmp_sst_files);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] Create checkpoint failed, path: {} error: {} {}",
                                     region->Id(), checkpoint_path, status.error_code(), status.error_str());
@@ -548,6 +567,9 @@ int RaftLoadSnapshotHandler::Handle(store::RegionPtr region, std::shared_ptr<Raw
       return -1;
     }
 
+    // Scalar data is replaced by snapshot.
+    vector_index_wrapper->ScalarInvertedIndex()->Clear();
+
     if (!vector_index_wrapper->IsPermanentHoldVectorIndex(vector_index_wrapper->Id()) &&
         !vector_index_wrapper->IsTempHoldVectorIndex()) {
       DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] vector index is not hold, skip load.", region->Id());
@@ -0,0 +1,201 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "log/log_entry_cache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "braft/log_entry.h"
+#include "bvar/reducer.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_int64(dingo_raft_log_cache_capacity_mb, 0,
+             "Capacity of recently appended raft log entries cache shared by all regions(MB), 0 means disable");
+DEFINE_int32(dingo_raft_log_cache_shard_num, 32, "Shard num of raft log entries cache");
+
+static bvar::Adder<int64_t> g_log_entry_cache_hit("dingo_log_entry_cache_hit");
+static bvar::Adder<int64_t> g_log_entry_cache_miss("dingo_log_entry_cache_miss");
+static bvar::Adder<int64_t> g_log_entry_cache_bytes("dingo_log_entry_cache_bytes");
+
+LogEntryCache::LogEntryCache(size_t shard_num) {
+  shard_num = std::max(shard_num, static_cast<size_t>(1));
+  shards_.reserve(shard_num);
+  for (size_t i = 0; i < shard_num; ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+LogEntryCache::~LogEntryCache() {
+  for (auto& shard : shards_) {
+    EvictUnlocked(*shard, 0);
+  }
+}
+
+LogEntryCache& LogEntryCache::GetInstance() {
+  static LogEntryCache instance(FLAGS_dingo_raft_log_cache_shard_num);
+  return instance;
+}
+
+bool LogEntryCache::IsEnable() { return FLAGS_dingo_raft_log_cache_capacity_mb > 0; }
+
+int64_t LogEntryCache::ShardCapacity() const {
+  int64_t capacity = capacity_ > 0 ? capacity_ : FLAGS_dingo_raft_log_cache_capacity_mb * 1024 * 1024;
+  return capacity / static_cast<int64_t>(shards_.size());
+}
+
+void LogEntryCache::EraseNode(Shard& shard, NodeList::iterator it) {
+  auto region_it = shard.regions.find(it->region_id);
+  if (region_it != shard.regions.end()) {
+    region_it->second.erase(it->index);
+    if (region_it->second.empty()) {
+      shard.regions.erase(region_it);
+    }
+  }
+
+  shard.bytes -= it->bytes;
+  g_log_entry_cache_bytes << -it->bytes;
+  it->entry->Release();
+  shard.lru.erase(it);
+}
+
+void LogEntryCache::EvictUnlocked(Shard& shard, int64_t capacity) {
+  while (shard.bytes > capacity && !shard.lru.empty()) {
+    EraseNode(shard, std::prev(shard.lru.end()));
+  }
+}
+
+void LogEntryCache::Put(int64_t region_id, const braft::LogEntry* const* entries, size_t count) {
+  int64_t capacity = ShardCapacity();
+  auto& shard = GetShard(region_id);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+  if (capacity > 0) {
+    auto& indexes = shard.regions[region_id];
+    for (size_t i = 0; i < count; ++i) {
+      auto* entry = const_cast<braft::LogEntry*>(entries[i]);
+      int64_t bytes = static_cast<int64_t>(sizeof(braft::LogEntry) + entry->data.length());
+      // a single entry exceeding capacity is not cached
+      if (bytes > capacity) {
+        continue;
+      }
+
+      auto it = indexes.find(entry->id.index);
+      if (it != indexes.end()) {
+        auto node_it = it->second;
+        shard.bytes -= node_it->bytes;
+        g_log_entry_cache_bytes << -node_it->bytes;
+        node_it->entry->Release();
+        shard.lru.erase(node_it);
+        indexes.erase(it);
+      }
+
+      entry->AddRef();
+      shard.lru.push_front(Node{region_id, entry->id.index, entry, bytes});
+      indexes.emplace(entry->id.index, shard.lru.begin());
+      shard.bytes += bytes;
+      g_log_entry_cache_bytes << bytes;
+    }
+    if (indexes.empty()) {
+      shard.regions.erase(region_id);
+    }
+  }
+
+  EvictUnlocked(shard, capacity);
+}
+
+braft::LogEntry* LogEntryCache::Get(int64_t region_id, int64_t index) {
+  auto& shard = GetShard(region_id);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+  auto region_it = shard.regions.find(region_id);
+  if (region_it != shard.regions.end()) {
+    auto it = region_it->second.find(index);
+    if (it != region_it->second.end()) {
+      shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+      g_log_entry_cache_hit << 1;
+
+      auto* entry = it->second->entry;
+      entry->AddRef();
+      return entry;
+    }
+  }
+
+  g_log_entry_cache_miss << 1;
+  return nullptr;
+}
+
+void LogEntryCache::TruncatePrefix(int64_t region_id, int64_t first_index_kept) {
+  auto& shard = GetShard(region_id);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+  auto region_it = shard.regions.find(region_id);
+  if (region_it == shard.regions.end()) {
+    return;
+  }
+
+  std::vector<NodeList::iterator> erased;
+  for (auto it = region_it->second.begin(); it != region_it->second.end() && it->first < first_index_kept; ++it) {
+    erased.push_back(it->second);
+  }
+  for (auto& it : erased) {
+    EraseNode(shard, it);
+  }
+}
+
+void LogEntryCache::TruncateSuffix(int64_t region_id, int64_t last_index_kept) {
+  auto& shard = GetShard(region_id);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+  auto region_it = shard.regions.find(region_id);
+  if (region_it == shard.regions.end()) {
+    return;
+  }
+
+  std::vector<NodeList::iterator> erased;
+  for (auto it = region_it->second.upper_bound(last_index_kept); it != region_it->second.end(); ++it) {
+    erased.push_back(it->second);
+  }
+  for (auto& it : erased) {
+    EraseNode(shard, it);
+  }
+}
+
+void LogEntryCache::EraseRegion(int64_t region_id) { TruncateSuffix(region_id, 0); }
+
+int64_t LogEntryCache::Bytes() {
+  int64_t bytes = 0;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard->mutex);
+    bytes += shard->bytes;
+  }
+  return bytes;
+}
+
+int64_t LogEntryCache::Count() {
+  int64_t count = 0;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard->mutex);
+    count += shard->lru.size();
+  }
+  return count;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,93 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_LOG_ENTRY_CACHE_H_
+#define DINGODB_LOG_ENTRY_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "braft/log_entry.h"
+#include "bthread/mutex.h"
+
+namespace dingodb {
+
+// LRU cache of the recently appended log entries, shared by all regions of the store.
+// The lagging followers and the apply path mostly read log entry from memory instead of the log disk.
+// The entries are sharded by region id, every shard owns capacity / shard_num bytes,
+// the capacity is read from flag on every put, 0 means disable cache.
+class LogEntryCache {
+ public:
+  explicit LogEntryCache(size_t shard_num);
+  ~LogEntryCache();
+
+  LogEntryCache(const LogEntryCache&) = delete;
+  LogEntryCache& operator=(const LogEntryCache&) = delete;
+
+  static LogEntryCache& GetInstance();
+
+  static bool IsEnable();
+
+  // put entries with consecutive index, replace the cached entry of same index.
+  void Put(int64_t region_id, const braft::LogEntry* const* entries, size_t count);
+  // return entry with a reference held by caller, nullptr if not found.
+  braft::LogEntry* Get(int64_t region_id, int64_t index);
+
+  // discard entries of [1, first_index_kept)
+  void TruncatePrefix(int64_t region_id, int64_t first_index_kept);
+  // discard entries of (last_index_kept, infinity)
+  void TruncateSuffix(int64_t region_id, int64_t last_index_kept);
+  void EraseRegion(int64_t region_id);
+
+  int64_t Bytes();
+  int64_t Count();
+
+  // for test, it's 0 means read capacity from flag.
+  void SetCapacity(int64_t capacity) { capacity_ = capacity; }
+
+ private:
+  struct Node {
+    int64_t region_id;
+    int64_t index;
+    braft::LogEntry* entry;
+    int64_t bytes;
+  };
+  using NodeList = std::list<Node>;
+
+  struct Shard {
+    bthread::Mutex mutex;
+    // front is most recently used
+    NodeList lru;
+    std::unordered_map<int64_t, std::map<int64_t, NodeList::iterator>> regions;
+    int64_t bytes{0};
+  };
+
+  Shard& GetShard(int64_t region_id) { return *shards_[static_cast<uint64_t>(region_id) % shards_.size()]; }
+  int64_t ShardCapacity() const;
+
+  static void EraseNode(Shard& shard, NodeList::iterator it);
+  static void EvictUnlocked(Shard& shard, int64_t capacity);
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  int64_t capacity_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_LOG_ENTRY_CACHE_H_
@@ -14,11 +14,17 @@
 
 #include "log/segment_log_storage.h"
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <filesystem>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -29,6 +35,7 @@
 #include "braft/log_entry.h"
 #include "braft/protobuf_file.h"
 #include "braft/util.h"
+#include "bthread/bthread.h"
 #include "butil/atomicops.h"
 #include "butil/errno.h"
 #include "butil/fd_utility.h"              // butil::make_close_on_exec
@@ -38,11 +45,19 @@
 #include "butil/string_printf.h"           // butil::string_appendf
 #include "butil/time.h"
 #include "bvar/latency_recorder.h"
+#include "bvar/recorder.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
+#include "common/failpoint.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/threadpool.h"
 #include "fmt/core.h"
+#include "lz4.h"
+#include "log/log_entry_cache.h"
+#include "log/shared_log_engine.h"
 #include "proto/store_internal.pb.h"
+#include "zstd.h"
 
 #define SEGMENT_OPEN_PATTERN "log_inprogress_%020" PRId64
 #define SEGMENT_CLOSED_PATTERN "log_%020" PRId64 "_%020" PRId64
@@ -52,6 +67,16 @@ namespace dingodb {
 
 DEFINE_bool(dingo_raft_sync_log, true, "Sync log to disk or not");
 DEFINE_bool(dingo_trace_append_entry_latency, false, "Trace append entry latency");
+DEFINE_bool(dingo_raft_log_group_commit, false, "Group sync log of regions sharing a disk");
+DEFINE_int32(dingo_raft_log_group_commit_linger_us, 100, "Group commit wait time for more sync requests(us)");
+DEFINE_bool(dingo_raft_log_group_commit_use_syncfs, false, "Group commit use syncfs instead of fdatasync every fd");
+DEFINE_bool(dingo_raft_log_mmap_closed_segment, false, "Read closed segment by mmap instead of pread");
+DEFINE_int32(dingo_raft_log_load_thread_num, 8, "Thread num of loading closed segments at startup");
+DEFINE_bool(dingo_raft_use_shared_log, false, "Store raft log of all regions in a shared log per disk");
+DEFINE_string(dingo_raft_log_compress_type, "none", "Compress data entry of raft log, none/lz4/zstd");
+DEFINE_int32(dingo_raft_log_compress_min_size, 4096, "Only compress data entry not less than this size(bytes)");
+DEFINE_int32(dingo_raft_log_zstd_level, 1, "Compress level of zstd");
+DEFINE_bool(dingo_raft_log_async_remove, false, "Remove log directory of destroyed region in background");
 
 using ::butil::RawPacker;
 using ::butil::RawUnpacker;
@@ -59,6 +84,11 @@ using ::butil::RawUnpacker;
 static bvar::LatencyRecorder g_segment_log_open_segment_latency("dingo_segment_log_open_segment");
 static bvar::LatencyRecorder g_segment_log_append_entry_latency("dingo_segment_log_append_entry");
 static bvar::LatencyRecorder g_segment_log_sync_segment_latency("dingo_segment_log_sync_segment");
+static bvar::IntRecorder g_segment_log_write_batch_size("dingo_segment_log_write_batch_size");
+static bvar::IntRecorder g_segment_log_group_commit_batch_size("dingo_segment_log_group_commit_batch_size");
+static bvar::LatencyRecorder g_segment_log_group_commit_latency("dingo_segment_log_group_commit");
+static bvar::Adder<int64_t> g_segment_log_compress_raw_bytes("dingo_segment_log_compress_raw_bytes");
+static bvar::Adder<int64_t> g_segment_log_compress_bytes("dingo_segment_log_compress_bytes");
 
 int FtruncateUninterrupted(int fd, off_t length) {
   int rc = 0;
@@ -73,6 +103,87 @@ enum class CheckSumType {
   kCrc32 = 1,
 };
 
+enum class CompressType {
+  kNone = 0,
+  kLz4 = 1,
+  kZstd = 2,
+};
+
+static CompressType GetCompressType() {
+  if (FLAGS_dingo_raft_log_compress_type == "lz4") {
+    return CompressType::kLz4;
+  } else if (FLAGS_dingo_raft_log_compress_type == "zstd") {
+    return CompressType::kZstd;
+  }
+  return CompressType::kNone;
+}
+
+// Compressed data is | raw data len (32bits) | compressed data |
+// Return false if compress failed or not smaller, the data should be kept raw.
+static bool CompressData(CompressType compress_type, const butil::IOBuf& data, butil::IOBuf& out) {
+  const std::string raw = data.to_string();
+  size_t bound = compress_type == CompressType::kLz4 ? LZ4_compressBound(raw.size()) : ZSTD_compressBound(raw.size());
+  std::string buf(sizeof(uint32_t) + bound, '\0');
+  RawPacker(buf.data()).pack32(static_cast<uint32_t>(raw.size()));
+
+  char* dst = buf.data() + sizeof(uint32_t);
+  size_t compressed_size = 0;
+  if (compress_type == CompressType::kLz4) {
+    int n = LZ4_compress_default(raw.data(), dst, static_cast<int>(raw.size()), static_cast<int>(bound));
+    if (n <= 0) {
+      return false;
+    }
+    compressed_size = n;
+  } else {
+    size_t n = ZSTD_compress(dst, bound, raw.data(), raw.size(), FLAGS_dingo_raft_log_zstd_level);
+    if (ZSTD_isError(n)) {
+      return false;
+    }
+    compressed_size = n;
+  }
+
+  if (sizeof(uint32_t) + compressed_size >= raw.size()) {
+    return false;
+  }
+
+  out.clear();
+  out.append(buf.data(), sizeof(uint32_t) + compressed_size);
+  return true;
+}
+
+static bool DecompressData(int compress_type, const butil::IOBuf& data, butil::IOBuf& out) {
+  if (data.length() < sizeof(uint32_t)) {
+    return false;
+  }
+  const std::string buf = data.to_string();
+  uint32_t raw_size = 0;
+  RawUnpacker(buf.data()).unpack32(raw_size);
+
+  const char* src = buf.data() + sizeof(uint32_t);
+  const size_t src_size = buf.size() - sizeof(uint32_t);
+  std::string raw(raw_size, '\0');
+  switch (static_cast<CompressType>(compress_type)) {
+    case CompressType::kLz4: {
+      int n = LZ4_decompress_safe(src, raw.data(), static_cast<int>(src_size), static_cast<int>(raw_size));
+      if (n < 0 || static_cast<uint32_t>(n) != raw_size) {
+        return false;
+      }
+    } break;
+    case CompressType::kZstd: {
+      size_t n = ZSTD_decompress(raw.data(), raw_size, src, src_size);
+      if (ZSTD_isError(n) || n != raw_size) {
+        return false;
+      }
+    } break;
+    default:
+      return false;
+  }
+
+  out.clear();
+  out.append(raw);
+  return true;
+}
+
 enum class SyncPolicy {
   kImmediately = 0,
   kByBytes = 1,
@@ -82,7 +193,7 @@ static const SyncPolicy kSegmentLogSyncPolicy = SyncPolicy::kImmediately;
 
 // Format of Header, all fields are in network order
 // | -------------------- term (64bits) -------------------------  |
-// | entry-type (8bits) | checksum_type (8bits) | reserved(16bits) |
+// | entry-type (8bits) | checksum_type (8bits) | compress_type(8bits) | reserved(8bits) |
 // | ------------------ data len (32bits) -----------------------  |
 // | data_checksum (32bits) | header checksum (32bits)             |
 
@@ -92,18 +203,20 @@ struct Segment::EntryHeader {
   int64_t term;
   int type;
   int checksum_type;
+  int compress_type;
   uint32_t data_len;
   uint32_t data_checksum;
 };
 
 std::string ToString(const Segment::EntryHeader& h) {
-  return fmt::format("(term={}, type={}, data_len={}, checksum_type={}, data_checksum={})", h.term, h.type, h.data_len,
-                     h.checksum_type, h.data_checksum);
+  return fmt::format("(term={}, type={}, data_len={}, checksum_type={}, compress_type={}, data_checksum={})", h.term,
+                     h.type, h.data_len, h.checksum_type, h.compress_type, h.data_checksum);
 }
 
 std::ostream& operator<<(std::ostream& os, const Segment::EntryHeader& h) {
   os << "{term=" << h.term << ", type=" << h.type << ", data_len=" << h.data_len
-     << ", checksum_type=" << h.checksum_type << ", data_checksum=" << h.data_checksum << '}';
+     << ", checksum_type=" << h.checksum_type << ", compress_type=" << h.compress_type
+     << ", data_checksum=" << h.data_checksum << '}';
   return os;
 }
 
@@ -157,6 +270,77 @@ inline uint32_t GetChecksum(int checksum_type, const butil::IOBuf& data) {
   }
 }
 
+std::shared_ptr<LogSyncGroup> LogSyncGroup::GetInstance(dev_t dev) {
+  static bthread::Mutex mutex;
+  static std::map<dev_t, std::shared_ptr<LogSyncGroup>> groups;
+
+  BAIDU_SCOPED_LOCK(mutex);
+  auto it = groups.find(dev);
+  if (it != groups.end()) {
+    return it->second;
+  }
+
+  auto group = std::make_shared<LogSyncGroup>(dev);
+  groups.emplace(dev, group);
+  return group;
+}
+
+int LogSyncGroup::Sync(int fd) {
+  SyncRequest request;
+  request.fd = fd;
+
+  std::unique_lock<bthread::Mutex> lock(mutex_);
+  pending_requests_.push_back(&request);
+  // wait the leader sync for us, or become leader when no one is syncing
+  while (!request.done && is_syncing_) {
+    cond_.wait(lock);
+  }
+  if (request.done) {
+    return request.ret;
+  }
+
+  is_syncing_ = true;
+  if (FLAGS_dingo_raft_log_group_commit_linger_us > 0) {
+    // linger for more sync requests from other regions
+    lock.unlock();
+    bthread_usleep(FLAGS_dingo_raft_log_group_commit_linger_us);
+    lock.lock();
+  }
+
+  std::vector<SyncRequest*> requests;
+  requests.swap(pending_requests_);
+  lock.unlock();
+
+  int64_t start_time = butil::gettimeofday_us();
+  if (FLAGS_dingo_raft_log_group_commit_use_syncfs) {
+    // one syncfs cover all fds on the same file system
+    int ret = ::syncfs(fd);
+    for (auto* req : requests) {
+      req->ret = ret;
+    }
+  } else {
+    std::map<int, int> fd_rets;
+    for (auto* req : requests) {
+      auto it = fd_rets.find(req->fd);
+      if (it == fd_rets.end()) {
+        it = fd_rets.emplace(req->fd, braft::raft_fsync(req->fd)).first;
+      }
+      req->ret = it->second;
+    }
+  }
+  g_segment_log_group_commit_latency << (butil::gettimeofday_us() - start_time);
+  g_segment_log_group_commit_batch_size << requests.size();
+
+  lock.lock();
+  for (auto* req : requests) {
+    req->done = true;
+  }
+  is_syncing_ = false;
+  cond_.notify_all();
+
+  return request.ret;
+}
+
 int Segment::Create() {
   if (!is_open_) {
     CHECK(false) << fmt::format("[raft.log][region({}).index({}_{})] create on a closed segment, path: {}", region_id_,
@@ -169,21 +353,47 @@ int Segment::Create() {
   fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
   if (fd_ >= 0) {
     butil::make_close_on_exec(fd_);
+    struct stat st_buf;
+    if (fstat(fd_, &st_buf) == 0) {
+      dev_ = st_buf.st_dev;
+    }
   }
   DINGO_LOG(INFO) << fmt::format("[raft.log][region({}).index({}_{})] created new segment, fd:{} path: {}", region_id_,
                                  FirstIndex(), LastIndex(), fd_, path_);
+  if (fd_ >= 0) {
+    BAIDU_SCOPED_LOCK(mutex_);
+    is_loaded_ = true;
+  }
   return fd_ >= 0 ? 0 : -1;
 }
 
-int Segment::LoadEntry(off_t offset, EntryHeader* head, butil::IOBuf* data, size_t size_hint) const {
-  butil::IOPortal buf;
-  size_t to_read = std::max(size_hint, kEntryHeaderSize);
-  const ssize_t n = braft::file_pread(&buf, fd_, offset, to_read);
-  if (n != (ssize_t)to_read) {
-    return n < 0 ? -1 : 1;
+Segment::MmapFile::~MmapFile() {
+  if (addr != nullptr) {
+    ::munmap(addr, size);
+    addr = nullptr;
   }
-  char header_buf[kEntryHeaderSize];
-  const char* p = (const char*)buf.fetch(header_buf, kEntryHeaderSize);
+}
+
+int Segment::Mmap(int64_t file_size, int advice) {
+  if (file_size <= 0) {
+    return 0;
+  }
+
+  void* addr = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd_, 0);
+  if (addr == MAP_FAILED) {
+    DINGO_LOG(WARNING) << fmt::format("[raft.log][region({}).index({}_{})] mmap failed, path: {} error: {}",
+                                      region_id_, FirstIndex(), LastIndex(), path_, berror());
+    return -1;
+  }
+  ::madvise(addr, file_size, advice);
+
+  auto mmap_file = std::make_shared<MmapFile>(static_cast<char*>(addr), file_size);
+  BAIDU_SCOPED_LOCK(mutex_);
+  mmap_file_ = mmap_file;
+  return 0;
+}
+
+int Segment::ParseEntryHeader(const char* p, off_t offset, EntryHeader* head) const {
   int64_t term = 0;
   uint32_t meta_field;
   uint32_t data_len = 0;
@@ -199,6 +409,7 @@ int Segment::LoadEntry(off_t offset, EntryHeader* head, butil::IOBuf* data, size
   tmp.term = term;
   tmp.type = meta_field >> 24;
   tmp.checksum_type = (meta_field << 8) >> 24;
+  tmp.compress_type = (meta_field << 16) >> 24;
   tmp.data_len = data_len;
   tmp.data_checksum = data_checksum;
   if (!VerifyChecksum(tmp.checksum_type, p, kEntryHeaderSize - 4, header_checksum)) {
@@ -207,6 +418,76 @@ int Segment::LoadEntry(off_t offset, EntryHeader* head, butil::IOBuf* data, size
         FirstIndex(), LastIndex(), ToString(tmp), offset, path_);
     return -1;
   }
+  *head = tmp;
+  return 0;
+}
+
+int Segment::LoadEntryFromMmap(std::shared_ptr<MmapFile> mmap_file, off_t offset, EntryHeader* head,
+                               butil::IOBuf* data) const {
+  if (offset + kEntryHeaderSize > mmap_file->size) {
+    return 1;
+  }
+  const char* p = mmap_file->addr + offset;
+  EntryHeader tmp;
+  if (ParseEntryHeader(p, offset, &tmp) != 0) {
+    return -1;
+  }
+  if (head != nullptr) {
+    *head = tmp;
+  }
+  if (data != nullptr) {
+    if (offset + kEntryHeaderSize + tmp.data_len > mmap_file->size) {
+      return 1;
+    }
+    butil::IOBuf buf;
+    if (tmp.data_len > 0) {
+      // zero copy, the mapping is released after all IOBuf referencing it are destroyed.
+      buf.append_user_data(const_cast<char*>(p + kEntryHeaderSize), tmp.data_len, [mmap_file](void*) {});
+    }
+    if (!VerifyChecksum(tmp.checksum_type, buf, tmp.data_checksum)) {
+      DINGO_LOG(ERROR) << fmt::format(
+          "[raft.log][region({}).index({}_{})] found corrupted data at offset: {} header: {} path:{}", region_id_,
+          FirstIndex(), LastIndex(), offset + kEntryHeaderSize, ToString(tmp), path_);
+      return -1;
+    }
+    if (tmp.compress_type != static_cast<int>(CompressType::kNone)) {
+      butil::IOBuf raw;
+      if (!DecompressData(tmp.compress_type, buf, raw)) {
+        DINGO_LOG(ERROR) << fmt::format(
+            "[raft.log][region({}).index({}_{})] decompress data failed at offset: {} header: {} path:{}", region_id_,
+            FirstIndex(), LastIndex(), offset + kEntryHeaderSize, ToString(tmp), path_);
+        return -1;
+      }
+      buf.swap(raw);
+    }
+    data->swap(buf);
+  }
+  return 0;
+}
+
+int Segment::LoadEntry(off_t offset, EntryHeader* head, butil::IOBuf* data, size_t size_hint) const {
+  std::shared_ptr<MmapFile> mmap_file;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    mmap_file = mmap_file_;
+  }
+  if (mmap_file != nullptr) {
+    return LoadEntryFromMmap(mmap_file, offset, head, data);
+  }
+
+  butil::IOPortal buf;
+  size_t to_read = std::max(size_hint, kEntryHeaderSize);
+  const ssize_t n = braft::file_pread(&buf, fd_, offset, to_read);
+  if (n != (ssize_t)to_read) {
+    return n < 0 ? -1 : 1;
+  }
+  char header_buf[kEntryHeaderSize];
+  const char* p = (const char*)buf.fetch(header_buf, kEntryHeaderSize);
+  EntryHeader tmp;
+  if (ParseEntryHeader(p, offset, &tmp) != 0) {
+    return -1;
+  }
+  const uint32_t data_len = tmp.data_len;
   if (head != nullptr) {
     *head = tmp;
   }
@@ -229,6 +510,16 @@ int Segment::LoadEntry(off_t offset, EntryHeader* head, butil::IOBuf* data, size
       // TODO: abort()?
       return -1;
     }
+    if (tmp.compress_type != static_cast<int>(CompressType::kNone)) {
+      butil::IOBuf raw;
+      if (!DecompressData(tmp.compress_type, buf, raw)) {
+        DINGO_LOG(ERROR) << fmt::format(
+            "[raft.log][region({}).index({}_{})] decompress data failed at offset: {} header: {} path:{}", region_id_,
+            FirstIndex(), LastIndex(), offset + kEntryHeaderSize, ToString(tmp), path_);
+        return -1;
+      }
+      buf.swap(raw);
+    }
     data->swap(buf);
   }
   return 0;
@@ -236,6 +527,11 @@ int Segment::LoadEntry(off_t offset, EntryHeader* head, butil::IOBuf* data, size
 
 int Segment::GetMeta(int64_t index, LogMeta* meta) const {
   BAIDU_SCOPED_LOCK(mutex_);
+  if (!is_loaded_) {
+    DINGO_LOG(DEBUG) << fmt::format("[raft.log][region({}).index({}_{})] segment is not loaded, index: {}.", region_id_,
+                                    FirstIndex(), LastIndex(), index);
+    return -1;
+  }
   if (index > last_index_.load(butil::memory_order_relaxed) || index < first_index_) {
     // out of range
     DINGO_LOG(DEBUG) << fmt::format("[raft.log][region({}).index({}_{})] index: {}.", region_id_, FirstIndex(),
@@ -259,6 +555,39 @@ int Segment::GetMeta(int64_t index, LogMeta* meta) const {
 }
 
 int Segment::Load(braft::ConfigurationManager* configuration_manager) {
+  std::vector<braft::ConfigurationEntry> conf_entries;
+  int ret = Load(&conf_entries);
+  for (auto& conf_entry : conf_entries) {
+    configuration_manager->add(conf_entry);
+  }
+  return ret;
+}
+
+int Segment::LoadIfNeed() {
+  BAIDU_SCOPED_LOCK(load_mutex_);
+  if (IsLoaded()) {
+    return 0;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.log][region({}).index({}_{})] lazy load segment, path: {}", region_id_,
+                                 FirstIndex(), LastIndex(), path_);
+  std::vector<braft::ConfigurationEntry>* conf_entries = nullptr;
+  return Load(conf_entries);
+}
+
+void Segment::Unload() {
+  BAIDU_SCOPED_LOCK(load_mutex_);
+  if (is_open_ || !IsLoaded()) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  is_loaded_ = false;
+  std::vector<std::pair<int64_t, int64_t>>().swap(offset_and_term_);
+  mmap_file_ = nullptr;
+}
+
+int Segment::Load(std::vector<braft::ConfigurationEntry>* conf_entries) {
   int ret = 0;
 
   std::string path(path_);
@@ -268,13 +597,16 @@ int Segment::Load(braft::ConfigurationManager* configuration_manager) {
   } else {
     butil::string_appendf(&path, "/" SEGMENT_CLOSED_PATTERN, first_index_, last_index_.load());
   }
-  fd_ = ::open(path.c_str(), O_RDWR);
+  // unloaded segment keep the fd, which maybe is used by concurrent read.
   if (fd_ < 0) {
-    DINGO_LOG(ERROR) << fmt::format("[raft.log][region({}).index({}_{})] open failed, path: {} error: {}", region_id_,
-                                    FirstIndex(), LastIndex(), path, berror());
-    return -1;
+    fd_ = ::open(path.c_str(), O_RDWR);
+    if (fd_ < 0) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.log][region({}).index({}_{})] open failed, path: {} error: {}",
+                                      region_id_, FirstIndex(), LastIndex(), path, berror());
+      return -1;
+    }
+    butil::make_close_on_exec(fd_);
   }
-  butil::make_close_on_exec(fd_);
 
   // get file size
   struct stat st_buf;
@@ -286,8 +618,14 @@ int Segment::Load(braft::ConfigurationManager* configuration_manager) {
     return -1;
   }
 
+  dev_ = st_buf.st_dev;
+
   // load entry index
   int64_t file_size = st_buf.st_size;
+  if (!is_open_ && FLAGS_dingo_raft_log_mmap_closed_segment) {
+    // scan the closed segment through the mapping, fall back to pread if failed.
+    Mmap(file_size, MADV_SEQUENTIAL);
+  }
   int64_t entry_off = 0;
   int64_t actual_last_index = first_index_ - 1;
   for (int64_t i = first_index_; entry_off < file_size; i++) {
@@ -308,7 +646,7 @@ int Segment::Load(braft::ConfigurationManager* configuration_manager) {
       // truncated
       break;
     }
-    if (header.type == braft::ENTRY_TYPE_CONFIGURATION) {
+    if (header.type == braft::ENTRY_TYPE_CONFIGURATION && conf_entries != nullptr) {
       butil::IOBuf data;
       // Header will be parsed again but it's fine as configuration
       // changing is rare
@@ -320,8 +658,7 @@ int Segment::Load(braft::ConfigurationManager* configuration_manager) {
       entry->id.term = header.term;
       butil::Status status = parse_configuration_meta(data, entry);
       if (status.ok()) {
-        braft::ConfigurationEntry conf_entry(*entry);
-        configuration_manager->add(conf_entry);
+        conf_entries->emplace_back(*entry);
       } else {
         DINGO_LOG(ERROR) << fmt::format(
             "[raft.log][region({}).index({}_{})] parse configuration meta failed, path: {} entry_off:{}", region_id_,
@@ -370,57 +707,99 @@ int Segment::Load(braft::ConfigurationManager* configuration_manager) {
   // seek to end, for opening segment
   ::lseek(fd_, entry_off, SEEK_SET);
 
+  if (mmap_file_ != nullptr) {
+    ::madvise(mmap_file_->addr, mmap_file_->size, MADV_NORMAL);
+  }
+
   bytes_ = entry_off;
+  if (ret == 0) {
+    BAIDU_SCOPED_LOCK(mutex_);
+    is_loaded_ = true;
+  }
   return ret;
 }
 
-int Segment::Append(const braft::LogEntry* entry) {
-  if (BAIDU_UNLIKELY(!entry || !is_open_)) {
+int Segment::Append(const braft::LogEntry* entry) { return Append(&entry, 1); }
+
+int Segment::Append(const braft::LogEntry* const* entries, size_t count) {
+  if (BAIDU_UNLIKELY(entries == nullptr || count == 0 || !is_open_)) {
     return EINVAL;
-  } else if (entry->id.index != last_index_.load(butil::memory_order_consume) + 1) {
-    CHECK(false) << fmt::format("[raft.log][region({}).index({}_{})] append entry failed, index: {}, ", region_id_,
-                                FirstIndex(), LastIndex(), entry->id.index);
-    return ERANGE;
   }
 
-  butil::IOBuf data;
-  switch (entry->type) {
-    case braft::ENTRY_TYPE_DATA:
-      data.append(entry->data);
-      break;
-    case braft::ENTRY_TYPE_NO_OP:
-      break;
-    case braft::ENTRY_TYPE_CONFIGURATION: {
-      butil::Status status = serialize_configuration_meta(entry, data);
-      if (!status.ok()) {
-        DINGO_LOG(ERROR) << fmt::format(
-            "[raft.log][region({}).index({}_{})] serialize ConfigurationPBMeta failed, path: {}", region_id_,
-            FirstIndex(), LastIndex(), path_);
+  // serialize entries, every entry is header + data
+  std::vector<butil::IOBuf> bufs(count);
+  size_t to_write = 0;
+  const int64_t last_index = last_index_.load(butil::memory_order_consume);
+  const CompressType compress_type = GetCompressType();
+  for (size_t i = 0; i < count; ++i) {
+    const auto* entry = entries[i];
+    if (BAIDU_UNLIKELY(entry == nullptr)) {
+      return EINVAL;
+    } else if (entry->id.index != last_index + 1 + static_cast<int64_t>(i)) {
+      CHECK(false) << fmt::format("[raft.log][region({}).index({}_{})] append entry failed, index: {}, ", region_id_,
+                                  FirstIndex(), LastIndex(), entry->id.index);
+      return ERANGE;
+    }
+
+    butil::IOBuf data;
+    switch (entry->type) {
+      case braft::ENTRY_TYPE_DATA:
+        data.append(entry->data);
+        break;
+      case braft::ENTRY_TYPE_NO_OP:
+        break;
+      case braft::ENTRY_TYPE_CONFIGURATION: {
+        butil::Status status = serialize_configuration_meta(entry, data);
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << fmt::format(
+              "[raft.log][region({}).index({}_{})] serialize ConfigurationPBMeta failed, path: {}", region_id_,
+              FirstIndex(), LastIndex(), path_);
+          return -1;
+        }
+      } break;
+      default:
+        DINGO_LOG(FATAL) << fmt::format("[raft.log][region({}).index({}_{})] unknown entry type: {} path: {}",
+                                        region_id_, FirstIndex(), LastIndex(), static_cast<int>(entry->type), path_);
         return -1;
+    }
+    CHECK_LE(data.length(), 1ul << 56ul);
+    CompressType entry_compress_type = CompressType::kNone;
+    if (compress_type != CompressType::kNone && entry->type == braft::ENTRY_TYPE_DATA &&
+        data.length() >= static_cast<size_t>(FLAGS_dingo_raft_log_compress_min_size)) {
+      butil::IOBuf compressed_data;
+      if (CompressData(compress_type, data, compressed_data)) {
+        g_segment_log_compress_raw_bytes << data.length();
+        g_segment_log_compress_bytes << compressed_data.length();
+        data.swap(compressed_data);
+        entry_compress_type = compress_type;
       }
-    } break;
-    default:
-      DINGO_LOG(FATAL) << fmt::format("[raft.log][region({}).index({}_{})] unknown entry type: {} path: {}", region_id_,
-                                      FirstIndex(), LastIndex(), static_cast<int>(entry->type), path_);
-      return -1;
-  }
-  CHECK_LE(data.length(), 1ul << 56ul);
-  char header_buf[kEntryHeaderSize];
-  const uint32_t meta_field = (entry->type << 24) | (checksum_type_ << 16);
-  RawPacker packer(header_buf);
-  packer.pack64(entry->id.term)
-      .pack32(meta_field)
-      .pack32((uint32_t)data.length())
-      .pack32(GetChecksum(checksum_type_, data));
-  packer.pack32(GetChecksum(checksum_type_, header_buf, kEntryHeaderSize - 4));
-  butil::IOBuf header;
-  header.append(header_buf, kEntryHeaderSize);
-  const size_t to_write = header.length() + data.length();
-  butil::IOBuf* pieces[2] = {&header, &data};
+    }
+    char header_buf[kEntryHeaderSize];
+    const uint32_t meta_field =
+        (entry->type << 24) | (checksum_type_ << 16) | (static_cast<uint32_t>(entry_compress_type) << 8);
+    RawPacker packer(header_buf);
+    packer.pack64(entry->id.term)
+        .pack32(meta_field)
+        .pack32((uint32_t)data.length())
+        .pack32(GetChecksum(checksum_type_, data));
+    packer.pack32(GetChecksum(checksum_type_, header_buf, kEntryHeaderSize - 4));
+    bufs[i].append(header_buf, kEntryHeaderSize);
+    bufs[i].append(data);
+    to_write += bufs[i].length();
+  }
+
+  std::vector<size_t> entry_sizes(count);
+  std::vector<butil::IOBuf*> pieces(count);
+  for (size_t i = 0; i < count; ++i) {
+    entry_sizes[i] = bufs[i].length();
+    pieces[i] = &bufs[i];
+  }
+
+  // write all entries with writev
   size_t start = 0;
   ssize_t written = 0;
   while (written < (ssize_t)to_write) {
-    const ssize_t n = butil::IOBuf::cut_multiple_into_file_descriptor(fd_, pieces + start, ARRAY_SIZE(pieces) - start);
+    const ssize_t n = butil::IOBuf::cut_multiple_into_file_descriptor(fd_, pieces.data() + start, pieces.size() - start);
     if (n < 0) {
       DINGO_LOG(ERROR) << fmt::format(
           "[raft.log][region({}).index({}_{})] write file failed, fd: {}, path: {} first_index: {} error: {}",
@@ -428,13 +807,17 @@ int Segment::Append(const braft::LogEntry* entry) {
       return -1;
     }
     written += n;
-    for (; start < ARRAY_SIZE(pieces) && pieces[start]->empty(); ++start) {
+    for (; start < pieces.size() && pieces[start]->empty(); ++start) {
     }
   }
+  g_segment_log_write_batch_size << count;
+
   BAIDU_SCOPED_LOCK(mutex_);
-  offset_and_term_.push_back(std::make_pair(bytes_, entry->id.term));
-  last_index_.fetch_add(1, butil::memory_order_relaxed);
-  bytes_ += to_write;
+  for (size_t i = 0; i < count; ++i) {
+    offset_and_term_.push_back(std::make_pair(bytes_, entries[i]->id.term));
+    bytes_ += entry_sizes[i];
+  }
+  last_index_.fetch_add(count, butil::memory_order_relaxed);
   unsynced_bytes_ += to_write;
 
   return 0;
@@ -450,6 +833,10 @@ int Segment::Sync(bool will_sync) {
       return 0;
     }
     unsynced_bytes_ = 0;
+    FAIL_POINT("segment_log_sync");
+    if (FLAGS_dingo_raft_log_group_commit) {
+      return LogSyncGroup::GetInstance(dev_)->Sync(fd_);
+    }
     return braft::raft_fsync(fd_);
   }
   return 0;
@@ -546,6 +933,8 @@ int Segment::Close(bool will_sync) {
       DINGO_LOG(ERROR) << fmt::format(
           "[raft.log][region({}).index({}_{})] rename failed, old_path: {} new_path: {} error: {}", region_id_,
           FirstIndex(), LastIndex(), old_path, new_path, berror());
+    } else if (FLAGS_dingo_raft_log_mmap_closed_segment) {
+      Mmap(bytes_, MADV_NORMAL);
     }
 
     return rc;
@@ -625,6 +1014,11 @@ int Segment::Truncate(int64_t last_index_kept) {
   // Truncate on a full segment need to rename back to inprogess segment again,
   // because the node may crash before truncate.
   if (!is_open_) {
+    // the truncated entries are uncommitted, they are not referenced by the mapping readers.
+    lck.lock();
+    mmap_file_ = nullptr;
+    lck.unlock();
+
     std::string old_path(path_);
     butil::string_appendf(&old_path, "/" SEGMENT_CLOSED_PATTERN, first_index_, last_index_.load());
 
@@ -696,8 +1090,33 @@ SegmentLogStorage::SegmentLogStorage()
   DINGO_LOG(DEBUG) << fmt::format("[new.SegmentLogStorage][id({})]", region_id_);
 }
 
+static void* RunRemoveDirectory(void* arg) {
+  std::unique_ptr<std::string> path(static_cast<std::string*>(arg));
+  butil::Timer timer;
+  timer.start();
+  Helper::RemoveAllFileOrDirectory(*path);
+  timer.stop();
+  DINGO_LOG(INFO) << fmt::format("[raft.log] remove directory, path: {} time: {}us", *path, timer.u_elapsed());
+
+  return nullptr;
+}
+
 SegmentLogStorage::~SegmentLogStorage() {
-  Helper::RemoveAllFileOrDirectory(path_);
+  LogEntryCache::GetInstance().EraseRegion(region_id_);
+  if (shared_log_ != nullptr) {
+    shared_log_->RemoveRegion(region_id_);
+  }
+  // Rename first, so the region can be created again at once, a large directory is removed in background.
+  std::string* removing_path = new std::string(fmt::format("{}.removing", path_));
+  bthread_t tid;
+  if (FLAGS_dingo_raft_log_async_remove && ::rename(path_.c_str(), removing_path->c_str()) == 0) {
+    if (bthread_start_background(&tid, &BTHREAD_ATTR_NORMAL, RunRemoveDirectory, removing_path) != 0) {
+      RunRemoveDirectory(removing_path);
+    }
+  } else {
+    delete removing_path;
+    Helper::RemoveAllFileOrDirectory(path_);
+  }
   DINGO_LOG(DEBUG) << fmt::format("[delete.SegmentLogStorage][id({})]", region_id_);
 }
 
@@ -732,6 +1151,11 @@ int SegmentLogStorage::Init(braft::ConfigurationManager* configuration_manager)
       break;
     }
 
+    if (FLAGS_dingo_raft_use_shared_log) {
+      ret = InitSharedLog(configuration_manager);
+      break;
+    }
+
     ret = ListSegments(is_empty);
     if (ret != 0) {
       break;
@@ -751,6 +1175,40 @@ int SegmentLogStorage::Init(braft::ConfigurationManager* configuration_manager)
   return ret;
 }
 
+// The shared log is located at the parent of region log path, which is the raft log path of the disk.
+int SegmentLogStorage::InitSharedLog(braft::ConfigurationManager* configuration_manager) {
+  std::string shared_log_path = std::filesystem::path(path_).parent_path().string() + "/shared_log";
+  shared_log_ = SharedLogEngine::GetInstance(shared_log_path);
+  if (shared_log_ == nullptr) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.log][region({})] get shared log failed, path: {}", region_id_,
+                                    shared_log_path);
+    return -1;
+  }
+
+  shared_log_->InitRegion(region_id_, first_log_index_.load());
+  // the prefix log maybe not truncated before restart, the shared log only keep first index in memory.
+  shared_log_->TruncatePrefix(region_id_, GetMinFirstLogIndex());
+
+  int64_t first_log_index = 0;
+  int64_t last_log_index = 0;
+  shared_log_->GetRegionLogIndex(region_id_, first_log_index, last_log_index);
+  if (last_log_index < first_log_index_.load() - 1) {
+    // discard the stale logs, otherwise there is gap when append next entry.
+    shared_log_->TruncatePrefix(region_id_, first_log_index_.load());
+    last_log_index = first_log_index_.load() - 1;
+  }
+  last_log_index_.store(std::max(last_log_index, first_log_index_.load() - 1), butil::memory_order_release);
+
+  int ret = shared_log_->LoadConfiguration(region_id_, configuration_manager);
+  if (ret != 0) {
+    return ret;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.log][region({}).index({}_{})] init shared log finish, path: {}", region_id_,
+                                 FirstLogIndex(), LastLogIndex(), shared_log_path);
+  return 0;
+}
+
 int64_t SegmentLogStorage::InitVectorIndexFirstLogIndex() const { return init_vector_index_first_log_index_; }
 
 int64_t SegmentLogStorage::FirstLogIndex() { return first_log_index_.load(butil::memory_order_acquire); };
@@ -780,12 +1238,30 @@ int SegmentLogStorage::AppendEntries(const std::vector<braft::LogEntry*>& entrie
         entries.front()->id.term, entries.front()->id.index);
     return -1;
   }
+
+  if (shared_log_ != nullptr) {
+    int64_t start_time_us = butil::cpuwide_time_us();
+    if (shared_log_->Append(region_id_, entries.data(), entries.size(), enable_sync_) != 0) {
+      return 0;
+    }
+    if (FLAGS_dingo_trace_append_entry_latency && metric) {
+      int64_t delta_time_us = butil::cpuwide_time_us() - start_time_us;
+      metric->append_entry_time_us += delta_time_us;
+      g_segment_log_append_entry_latency << delta_time_us;
+    }
+    last_log_index_.fetch_add(entries.size(), butil::memory_order_release);
+    if (LogEntryCache::IsEnable()) {
+      LogEntryCache::GetInstance().Put(region_id_, entries.data(), entries.size());
+    }
+    return entries.size();
+  }
+
   std::shared_ptr<Segment> last_segment;
   int64_t now = 0;
   int64_t delta_time_us = 0;
-  for (size_t i = 0; i < entries.size(); i++) {
+  size_t i = 0;
+  while (i < entries.size()) {
     now = butil::cpuwide_time_us();
-    braft::LogEntry* entry = entries[i];
 
     auto segment = OpenSegment();
     if (FLAGS_dingo_trace_append_entry_latency && metric) {
@@ -796,7 +1272,16 @@ int SegmentLogStorage::AppendEntries(const std::vector<braft::LogEntry*>& entrie
     if (nullptr == segment) {
       return i;
     }
-    int ret = segment->Append(entry);
+
+    // collect entries into the open segment as many as possible, write them at once.
+    size_t end = i;
+    int64_t segment_bytes = segment->Bytes();
+    do {
+      segment_bytes += kEntryHeaderSize + entries[end]->data.length();
+      ++end;
+    } while (end < entries.size() && segment_bytes <= static_cast<int64_t>(max_segment_size_));
+
+    int ret = segment->Append(entries.data() + i, end - i);
     if (0 != ret) {
       return i;
     }
@@ -805,8 +1290,9 @@ int SegmentLogStorage::AppendEntries(const std::vector<braft::LogEntry*>& entrie
       metric->append_entry_time_us += delta_time_us;
       g_segment_log_append_entry_latency << delta_time_us;
     }
-    last_log_index_.fetch_add(1, butil::memory_order_release);
+    last_log_index_.fetch_add(end - i, butil::memory_order_release);
     last_segment = segment;
+    i = end;
   }
   now = butil::cpuwide_time_us();
   last_segment->Sync(enable_sync_);
@@ -815,6 +1301,9 @@ int SegmentLogStorage::AppendEntries(const std::vector<braft::LogEntry*>& entrie
     metric->sync_segment_time_us += delta_time_us;
     g_segment_log_sync_segment_latency << delta_time_us;
   }
+  if (LogEntryCache::IsEnable()) {
+    LogEntryCache::GetInstance().Put(region_id_, entries.data(), entries.size());
+  }
   return entries.size();
 }
 
@@ -822,6 +1311,18 @@ int SegmentLogStorage::AppendEntry(const braft::LogEntry* entry) {
   DINGO_LOG(DEBUG) << fmt::format("[raft.log][region({}).index({}_{})] append entry, entry index: {}", region_id_,
                                   FirstLogIndex(), LastLogIndex(), entry->id.index);
 
+  if (shared_log_ != nullptr) {
+    int ret = shared_log_->Append(region_id_, &entry, 1, enable_sync_);
+    if (ret != 0) {
+      return ret;
+    }
+    last_log_index_.fetch_add(1, butil::memory_order_release);
+    if (LogEntryCache::IsEnable()) {
+      LogEntryCache::GetInstance().Put(region_id_, &entry, 1);
+    }
+    return 0;
+  }
+
   auto segment = OpenSegment();
   if (nullptr == segment) {
     return EIO;
@@ -834,19 +1335,59 @@ int SegmentLogStorage::AppendEntry(const braft::LogEntry* entry) {
     return EINVAL;
   }
   last_log_index_.fetch_add(1, butil::memory_order_release);
+  if (LogEntryCache::IsEnable()) {
+    LogEntryCache::GetInstance().Put(region_id_, &entry, 1);
+  }
 
   return segment->Sync(enable_sync_);
 }
 
 braft::LogEntry* SegmentLogStorage::GetEntry(const int64_t index) {
+  if (LogEntryCache::IsEnable()) {
+    auto* entry = LogEntryCache::GetInstance().Get(region_id_, index);
+    if (entry != nullptr) {
+      return entry;
+    }
+  }
+
+  if (shared_log_ != nullptr) {
+    return shared_log_->Get(region_id_, index);
+  }
+
   std::shared_ptr<Segment> segment = GetSegment(index);
-  if (segment == nullptr) {
+  if (segment == nullptr || segment->LoadIfNeed() != 0) {
     return nullptr;
   }
   return segment->Get(index);
 }
 
 std::vector<std::shared_ptr<LogEntry>> SegmentLogStorage::GetEntrys(uint64_t begin_index, uint64_t end_index) {
+  if (shared_log_ != nullptr) {
+    std::vector<std::shared_ptr<LogEntry>> log_entrys;
+    int64_t first_log_index = 0;
+    int64_t last_log_index = 0;
+    if (!shared_log_->GetRegionLogIndex(region_id_, first_log_index, last_log_index)) {
+      return {};
+    }
+    first_log_index = std::max(first_log_index, static_cast<int64_t>(begin_index));
+    last_log_index = std::min(last_log_index, static_cast<int64_t>(end_index));
+    for (int64_t i = first_log_index; i <= last_log_index; ++i) {
+      auto* log_entry = shared_log_->Get(region_id_, i);
+      if (log_entry == nullptr) {
+        continue;
+      }
+      if (log_entry->type == braft::ENTRY_TYPE_DATA) {
+        auto tmp_log_entry = std::make_shared<LogEntry>();
+        tmp_log_entry->term = log_entry->id.term;
+        tmp_log_entry->index = log_entry->id.index;
+        tmp_log_entry->data.swap(log_entry->data);
+        log_entrys.push_back(tmp_log_entry);
+      }
+      log_entry->Release();
+    }
+    return log_entrys;
+  }
+
   auto segments = GetSegments(begin_index, end_index);
   if (segments.empty()) {
     return {};
@@ -875,6 +1416,39 @@ std::vector<std::shared_ptr<LogEntry>> SegmentLogStorage::GetEntrys(uint64_t beg
 }
 
 bool SegmentLogStorage::HasSpecificLog(uint64_t begin_index, uint64_t end_index, MatchFuncer matcher) {
+  if (shared_log_ != nullptr) {
+    int64_t first_log_index = 0;
+    int64_t last_log_index = 0;
+    if (!shared_log_->GetRegionLogIndex(region_id_, first_log_index, last_log_index)) {
+      return false;
+    }
+    first_log_index = std::max(first_log_index, static_cast<int64_t>(begin_index));
+    last_log_index = std::min(last_log_index, static_cast<int64_t>(end_index));
+    for (int64_t i = first_log_index; i <= last_log_index; ++i) {
+      auto* log_entry = shared_log_->Get(region_id_, i);
+      if (log_entry == nullptr) {
+        continue;
+      }
+      LogEntry tmp_log_entry;
+      tmp_log_entry.term = log_entry->id.term;
+      tmp_log_entry.index = log_entry->id.index;
+      bool matched = false;
+      if (log_entry->type == braft::ENTRY_TYPE_DATA) {
+        tmp_log_entry.type = LogEntryType::kEntryTypeData;
+        tmp_log_entry.data.swap(log_entry->data);
+        matched = matcher(tmp_log_entry);
+      } else if (log_entry->type == braft::ENTRY_TYPE_CONFIGURATION) {
+        tmp_log_entry.type = LogEntryType::kEntryTypeConfiguration;
+        matched = matcher(tmp_log_entry);
+      }
+      log_entry->Release();
+      if (matched) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   auto segments = GetSegments(begin_index, end_index);
   if (segments.empty()) {
     return false;
@@ -913,8 +1487,12 @@ bool SegmentLogStorage::HasSpecificLog(uint64_t begin_index, uint64_t end_index,
 }
 
 int64_t SegmentLogStorage::GetTerm(const int64_t index) {
+  if (shared_log_ != nullptr) {
+    return shared_log_->GetTerm(region_id_, index);
+  }
+
   std::shared_ptr<Segment> segment = GetSegment(index);
-  return (segment == nullptr) ? 0 : segment->GetTerm(index);
+  return (segment == nullptr || segment->LoadIfNeed() != 0) ? 0 : segment->GetTerm(index);
 }
 
 void SegmentLogStorage::PopSegments(int64_t first_index_kept, std::vector<std::shared_ptr<Segment>>& poppeds) {
@@ -944,7 +1522,7 @@ void SegmentLogStorage::SetFirstAndLastLogIndex(int64_t first_index_kept) {
   BAIDU_SCOPED_LOCK(mutex_);
 
   first_log_index_.store(first_index_kept, butil::memory_order_release);
-  if (!open_segment_) {
+  if (shared_log_ != nullptr ? LastLogIndex() < first_index_kept : !open_segment_) {
     last_log_index_.store(FirstLogIndex() - 1);
   }
 }
@@ -968,6 +1546,7 @@ int SegmentLogStorage::TruncatePrefix(int64_t first_index_kept) {
     return -1;
   }
   SetFirstAndLastLogIndex(first_index_kept);
+  LogEntryCache::GetInstance().TruncatePrefix(region_id_, first_index_kept);
 
   DINGO_LOG(INFO) << fmt::format("[raft.log][region({}).index({}_{})] truncate prefix, first_index_kept: {}",
                                  region_id_, FirstLogIndex(), LastLogIndex(), first_index_kept);
@@ -1009,6 +1588,13 @@ int64_t SegmentLogStorage::GetMinFirstLogIndex() {
 void SegmentLogStorage::TruncateActualPrefixLog() {
   int64_t truncate_log_index = GetMinFirstLogIndex();
 
+  if (shared_log_ != nullptr) {
+    shared_log_->TruncatePrefix(region_id_, truncate_log_index);
+    DINGO_LOG(INFO) << fmt::format("[raft.log][region({}).index({}_{})] truncate shared prefix log, min_log_index: {}",
+                                   region_id_, FirstLogIndex(), LastLogIndex(), truncate_log_index);
+    return;
+  }
+
   std::vector<std::shared_ptr<Segment>> poppeds;
   PopSegments(truncate_log_index, poppeds);
   DINGO_LOG(INFO) << fmt::format(
@@ -1063,6 +1649,20 @@ std::shared_ptr<Segment> SegmentLogStorage::PopSegmentsFromBack(int64_t last_ind
 int SegmentLogStorage::TruncateSuffix(int64_t last_index_kept) {
   DINGO_LOG(INFO) << fmt::format("[raft.log][region({}).index({}_{})] truncate suffix last_index_kept: {}", region_id_,
                                  FirstLogIndex(), LastLogIndex(), last_index_kept);
+  // discard the cached entries first, they are overwritten by the entries of new leader.
+  LogEntryCache::GetInstance().TruncateSuffix(region_id_, last_index_kept);
+  if (shared_log_ != nullptr) {
+    int ret = shared_log_->TruncateSuffix(region_id_, last_index_kept);
+    if (ret != 0) {
+      return ret;
+    }
+    last_log_index_.store(last_index_kept, butil::memory_order_release);
+    if (first_log_index_.load(butil::memory_order_relaxed) > last_index_kept) {
+      first_log_index_.store(last_index_kept + 1, butil::memory_order_release);
+    }
+    return 0;
+  }
+
   // segment files
   std::vector<std::shared_ptr<Segment>> poppeds;
   std::shared_ptr<Segment> last_segment = PopSegmentsFromBack(last_index_kept, poppeds);
@@ -1115,6 +1715,12 @@ int SegmentLogStorage::Reset(int64_t next_log_index) {
                                     region_id_, FirstLogIndex(), LastLogIndex(), next_log_index, path_);
     return EINVAL;
   }
+  LogEntryCache::GetInstance().EraseRegion(region_id_);
+  if (shared_log_ != nullptr && shared_log_->Reset(region_id_, next_log_index) != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.log][region({}).index({}_{})] reset shared log failed, path: {}", region_id_,
+                                    FirstLogIndex(), LastLogIndex(), path_);
+    return -1;
+  }
   std::vector<std::shared_ptr<Segment>> poppeds;
   std::unique_lock<bthread::Mutex> lck(mutex_);
   poppeds.reserve(segments_.size());
@@ -1241,23 +1847,74 @@ int SegmentLogStorage::ListSegments(bool is_empty) {
   return 0;
 }
 
+static ThreadPoolPtr GetSegmentLoadThreadPool() {
+  static ThreadPoolPtr thread_pool =
+      FLAGS_dingo_raft_log_load_thread_num > 1
+          ? std::make_shared<ThreadPool>("segment_load", FLAGS_dingo_raft_log_load_thread_num)
+          : nullptr;
+  return thread_pool;
+}
+
+int SegmentLogStorage::ParallelLoadSegments(std::vector<std::shared_ptr<Segment>>& segments,
+                                            std::vector<std::vector<braft::ConfigurationEntry>>& conf_entries) {
+  conf_entries.resize(segments.size());
+  std::vector<int> rets(segments.size(), 0);
+
+  auto thread_pool = GetSegmentLoadThreadPool();
+  std::vector<ThreadPool::TaskPtr> tasks;
+  for (size_t i = 0; i < segments.size(); ++i) {
+    auto load_func = [&, i](void*) {
+      DINGO_LOG(INFO) << fmt::format("[raft.log][region({}).index({}_{})] load closed segment, path: {}", region_id_,
+                                     segments[i]->FirstIndex(), segments[i]->LastIndex(), path_);
+      rets[i] = segments[i]->Load(&conf_entries[i]);
+    };
+
+    ThreadPool::TaskPtr task = (thread_pool != nullptr && segments.size() > 1)
+                                   ? thread_pool->ExecuteTask(load_func, nullptr)
+                                   : nullptr;
+    if (task == nullptr) {
+      load_func(nullptr);
+    } else {
+      tasks.push_back(task);
+    }
+  }
+
+  for (auto& task : tasks) {
+    task->Join();
+  }
+
+  for (auto ret : rets) {
+    if (ret != 0) {
+      return ret;
+    }
+  }
+  return 0;
+}
+
 int SegmentLogStorage::LoadSegments(braft::ConfigurationManager* configuration_manager) {
   int ret = 0;
 
-  // closed segments
-  SegmentMap::iterator it;
-  for (it = segments_.begin(); it != segments_.end(); ++it) {
-    Segment* segment = it->second.get();
+  // closed segments, the segments before first_log_index_ are only used by vector index replay,
+  // they are loaded on first access.
+  std::vector<std::shared_ptr<Segment>> segments;
+  for (auto& [_, segment] : segments_) {
     if (segment->LastIndex() < first_log_index_.load(std::memory_order_relaxed)) {
       continue;
     }
-    DINGO_LOG(INFO) << fmt::format("[raft.log][region({}).index({}_{})] load closed segment, path: {}", region_id_,
-                                   segment->FirstIndex(), segment->LastIndex(), path_);
-    ret = segment->Load(configuration_manager);
-    if (ret != 0) {
-      return ret;
+    segments.push_back(segment);
+  }
+
+  std::vector<std::vector<braft::ConfigurationEntry>> conf_entries;
+  ret = ParallelLoadSegments(segments, conf_entries);
+  if (ret != 0) {
+    return ret;
+  }
+  // add configuration in log order
+  for (size_t i = 0; i < segments.size(); ++i) {
+    for (auto& conf_entry : conf_entries[i]) {
+      configuration_manager->add(conf_entry);
     }
-    last_log_index_.store(segment->LastIndex(), butil::memory_order_release);
+    last_log_index_.store(segments[i]->LastIndex(), butil::memory_order_release);
   }
 
   // open segment
@@ -1418,7 +2075,7 @@ std::shared_ptr<Segment> SegmentLogStorage::GetSegment(int64_t index) {
 }
 
 std::vector<std::shared_ptr<Segment>> SegmentLogStorage::GetSegments(uint64_t begin_index, uint64_t end_index) {
-  BAIDU_SCOPED_LOCK(mutex_);
+  std::unique_lock<bthread::Mutex> lck(mutex_);
   uint64_t first_index = FirstLogIndex();
   uint64_t last_index = LastLogIndex();
   if (first_index == last_index + 1) {
@@ -1434,18 +2091,41 @@ std::vector<std::shared_ptr<Segment>> SegmentLogStorage::GetSegments(uint64_t be
 
   std::vector<std::shared_ptr<Segment>> segments;
   for (auto& [_, segment] : segments_) {
-    if (begin_index <= segment->LastIndex() || segment->FirstIndex() <= end_index) {
+    if (begin_index <= segment->LastIndex() && segment->FirstIndex() <= end_index) {
       segments.push_back(segment);
     }
   }
 
-  if (begin_index <= open_segment_->LastIndex() || open_segment_->FirstIndex() <= end_index) {
+  if (open_segment_ != nullptr && begin_index <= open_segment_->LastIndex() &&
+      open_segment_->FirstIndex() <= end_index) {
     segments.push_back(open_segment_);
   }
+  lck.unlock();
+
+  for (auto& segment : segments) {
+    if (segment->LoadIfNeed() != 0) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.log][region({}).index({}_{})] load segment({}_{}) failed, path: {}",
+                                      region_id_, FirstLogIndex(), LastLogIndex(), segment->FirstIndex(),
+                                      segment->LastIndex(), path_);
+      return {};
+    }
+  }
 
   return segments;
 }
 
+void SegmentLogStorage::UnloadSegments() {
+  SegmentMap segments;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    segments = segments_;
+  }
+
+  for (auto& [_, segment] : segments) {
+    segment->Unload();
+  }
+}
+
 void SegmentLogStorage::ListFiles(std::vector<std::string>* seg_files) {
   BAIDU_SCOPED_LOCK(mutex_);
   seg_files->push_back(SEGMENT_META_FILE);
@@ -1458,6 +2138,11 @@ void SegmentLogStorage::ListFiles(std::vector<std::string>* seg_files) {
 }
 
 void SegmentLogStorage::Sync() {
+  if (shared_log_ != nullptr) {
+    shared_log_->Sync();
+    return;
+  }
+
   std::vector<std::shared_ptr<Segment>> segments;
   {
     BAIDU_SCOPED_LOCK(mutex_);
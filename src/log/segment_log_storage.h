@@ -15,6 +15,8 @@
 #ifndef DINGODB_SEGMENT_LOG_STORAGE_H_
 #define DINGODB_SEGMENT_LOG_STORAGE_H_
 
+#include <sys/types.h>
+
 #include <atomic>
 #include <cstdint>
 #include <functional>
@@ -22,8 +24,11 @@
 #include <memory>
 #include <vector>
 
+#include "braft/configuration_manager.h"
 #include "braft/log_entry.h"
 #include "braft/storage.h"
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
 #include "butil/atomicops.h"
 #include "butil/iobuf.h"
 #include "common/logging.h"
@@ -32,6 +37,8 @@ namespace dingodb {
 
 enum class LogEntryType { kEntryTypeUnknown = 0, kEntryTypeNoOp = 1, kEntryTypeData = 2, kEntryTypeConfiguration = 3 };
 
+class SharedLogEngine;
+
 struct LogEntry {
   LogEntryType type;
   int64_t index;
@@ -39,6 +46,32 @@ struct LogEntry {
   butil::IOBuf data;
 };
 
+// Group commit sync request of segments on the same disk,
+// the first waiter become leader and sync all pending fds at once, others wait for it.
+class LogSyncGroup {
+ public:
+  explicit LogSyncGroup(dev_t dev) : dev_(dev) {}
+  ~LogSyncGroup() = default;
+
+  static std::shared_ptr<LogSyncGroup> GetInstance(dev_t dev);
+
+  // sync fd, return 0 if success
+  int Sync(int fd);
+
+ private:
+  struct SyncRequest {
+    int fd{-1};
+    int ret{0};
+    bool done{false};
+  };
+
+  dev_t dev_;
+  bthread::Mutex mutex_;
+  bthread::ConditionVariable cond_;
+  bool is_syncing_{false};
+  std::vector<SyncRequest*> pending_requests_;
+};
+
 class BAIDU_CACHELINE_ALIGNMENT Segment {
  public:
   Segment(int64_t region_id, const std::string& path, const int64_t first_index, int checksum_type)
@@ -63,6 +96,7 @@ class BAIDU_CACHELINE_ALIGNMENT Segment {
         last_index_(last_index),
         checksum_type_(checksum_type) {}
   ~Segment() {
+    mmap_file_ = nullptr;
     if (fd_ >= 0) {
       ::close(fd_);
       fd_ = -1;
@@ -77,9 +111,17 @@ class BAIDU_CACHELINE_ALIGNMENT Segment {
   // load open or closed segment
   // open fd, load index, truncate uncompleted entry
   int Load(braft::ConfigurationManager* configuration_manager);
+  // same as above, collect configuration entries instead, it's nullptr when not care.
+  int Load(std::vector<braft::ConfigurationEntry>* conf_entries);
+  // load closed segment on first access, which is skipped at startup
+  int LoadIfNeed();
+  // release entry index and mapping of closed segment, loaded again on next access, the fd is kept.
+  void Unload();
 
   // serialize entry, and append to open segment
   int Append(const braft::LogEntry* entry);
+  // serialize entries, and append to open segment with one write
+  int Append(const braft::LogEntry* const* entries, size_t count);
 
   // get entry by index
   braft::LogEntry* Get(int64_t index) const;
@@ -101,6 +143,11 @@ class BAIDU_CACHELINE_ALIGNMENT Segment {
 
   bool IsOpen() const { return is_open_; }
 
+  bool IsLoaded() const {
+    BAIDU_SCOPED_LOCK(mutex_);
+    return is_loaded_;
+  }
+
   int64_t Bytes() const { return bytes_; }
 
   int64_t FirstIndex() const { return first_index_; }
@@ -116,7 +163,20 @@ class BAIDU_CACHELINE_ALIGNMENT Segment {
     int64_t term;
   };
 
+  // mapping of closed segment, IOBuf of entry data hold a reference to it.
+  struct MmapFile {
+    MmapFile(char* addr, size_t size) : addr(addr), size(size) {}
+    ~MmapFile();
+
+    char* addr;
+    size_t size;
+  };
+
+  int Mmap(int64_t file_size, int advice);
+  int ParseEntryHeader(const char* p, off_t offset, EntryHeader* head) const;
   int LoadEntry(off_t offset, EntryHeader* head, butil::IOBuf* data, size_t size_hint) const;
+  int LoadEntryFromMmap(std::shared_ptr<MmapFile> mmap_file, off_t offset, EntryHeader* head,
+                        butil::IOBuf* data) const;
   int GetMeta(int64_t index, LogMeta* meta) const;
   int TruncateMetaAndGetLast(int64_t last);
 
@@ -128,11 +188,16 @@ class BAIDU_CACHELINE_ALIGNMENT Segment {
   mutable bthread::Mutex mutex_;
 
   int fd_;
+  dev_t dev_{0};
   bool is_open_;
+  // offset index is built
+  bool is_loaded_{false};
+  bthread::Mutex load_mutex_;
   const int64_t first_index_;
   butil::atomic<int64_t> last_index_;
   int checksum_type_;
   std::vector<std::pair<int64_t /*offset*/, int64_t /*term*/>> offset_and_term_;
+  std::shared_ptr<MmapFile> mmap_file_;
 };
 
 // LogStorage use segmented append-only file, all data in disk, all index in memory.
@@ -207,14 +272,20 @@ class SegmentLogStorage {
 
   void Sync();
 
+  // release memory of closed segments, e.g. the region is hibernated.
+  void UnloadSegments();
+
   uint64_t MaxSegmentSize() const { return max_segment_size_; }
 
  private:
+  int InitSharedLog(braft::ConfigurationManager* configuration_manager);
   std::shared_ptr<Segment> OpenSegment();
   int SaveMeta(int64_t log_index);
   int LoadMeta();
   int ListSegments(bool is_empty);
   int LoadSegments(braft::ConfigurationManager* configuration_manager);
+  int ParallelLoadSegments(std::vector<std::shared_ptr<Segment>>& segments,
+                           std::vector<std::vector<braft::ConfigurationEntry>>& conf_entries);
   std::shared_ptr<Segment> GetSegment(int64_t log_index);
   std::vector<std::shared_ptr<Segment>> GetSegments(uint64_t begin_index, uint64_t end_index);
   void PopSegments(int64_t first_index_kept, std::vector<std::shared_ptr<Segment>>& poppeds);
@@ -243,6 +314,10 @@ class SegmentLogStorage {
   bool enable_sync_;
 
   uint64_t max_segment_size_;
+
+  // not null when the log of region is stored in the shared log of the disk,
+  // the segments are not used in this case, only log_meta is kept in path_.
+  std::shared_ptr<SharedLogEngine> shared_log_;
 };
 
 // NOLINTBEGIN
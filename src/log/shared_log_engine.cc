@@ -0,0 +1,739 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "log/shared_log_engine.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "braft/fsync.h"
+#include "braft/util.h"
+#include "butil/crc32c.h"
+#include "butil/fd_utility.h"
+#include "butil/raw_pack.h"
+#include "butil/string_printf.h"
+#include "butil/time.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/recorder.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "log/segment_log_storage.h"
+
+#define SHARED_LOG_FILE_PATTERN "shared_log_%020" PRId64
+
+namespace dingodb {
+
+DEFINE_int64(dingo_raft_shared_log_file_size, 256 * 1024 * 1024, "Shared log file size");
+
+DECLARE_bool(dingo_raft_log_group_commit);
+
+using ::butil::RawPacker;
+using ::butil::RawUnpacker;
+
+static bvar::LatencyRecorder g_shared_log_append_latency("dingo_shared_log_append");
+static bvar::IntRecorder g_shared_log_append_batch_size("dingo_shared_log_append_batch_size");
+
+const static size_t kRecordHeaderSize = 40;
+
+enum class SharedLogCheckSumType {
+  kMurmurhash32 = 0,
+  kCrc32 = 1,
+};
+
+struct SharedLogEngine::RecordHeader {
+  int64_t region_id;
+  int64_t index;
+  int64_t term;
+  uint8_t record_type;
+  uint8_t entry_type;
+  uint8_t checksum_type;
+  uint32_t data_len;
+  uint32_t data_checksum;
+};
+
+static uint32_t GetChecksum(int checksum_type, const char* data, size_t len) {
+  return static_cast<SharedLogCheckSumType>(checksum_type) == SharedLogCheckSumType::kCrc32
+             ? braft::crc32(data, len)
+             : braft::murmurhash32(data, len);
+}
+
+static uint32_t GetChecksum(int checksum_type, const butil::IOBuf& data) {
+  return static_cast<SharedLogCheckSumType>(checksum_type) == SharedLogCheckSumType::kCrc32
+             ? braft::crc32(data)
+             : braft::murmurhash32(data);
+}
+
+SharedLogEngine::LogFile::~LogFile() {
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+}
+
+SharedLogEngine::SharedLogEngine(const std::string& path)
+    : path_(path),
+      checksum_type_(butil::crc32c::IsFastCrc32Supported() ? static_cast<int>(SharedLogCheckSumType::kCrc32)
+                                                           : static_cast<int>(SharedLogCheckSumType::kMurmurhash32)) {}
+
+SharedLogEngine::~SharedLogEngine() = default;
+
+std::shared_ptr<SharedLogEngine> SharedLogEngine::GetInstance(const std::string& path) {
+  static bthread::Mutex mutex;
+  static std::map<std::string, std::shared_ptr<SharedLogEngine>> engines;
+
+  BAIDU_SCOPED_LOCK(mutex);
+  auto it = engines.find(path);
+  if (it != engines.end()) {
+    return it->second;
+  }
+
+  auto engine = std::make_shared<SharedLogEngine>(path);
+  if (engine->Init() != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] init failed, path: {}", path);
+    return nullptr;
+  }
+  engines.emplace(path, engine);
+  return engine;
+}
+
+std::string SharedLogEngine::FilePath(int64_t file_id) const {
+  std::string path(path_);
+  butil::string_appendf(&path, "/" SHARED_LOG_FILE_PATTERN, file_id);
+  return path;
+}
+
+SharedLogEngine::LogFilePtr SharedLogEngine::OpenFile(int64_t file_id, bool create) {
+  std::string path = FilePath(file_id);
+  int fd = create ? ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644) : ::open(path.c_str(), O_RDWR);
+  if (fd < 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] open file failed, path: {} error: {}", path, berror());
+    return nullptr;
+  }
+  butil::make_close_on_exec(fd);
+
+  auto file = std::make_shared<LogFile>(file_id, path, fd);
+  struct stat st_buf;
+  if (fstat(fd, &st_buf) != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] get file stat failed, path: {} error: {}", path, berror());
+    return nullptr;
+  }
+  file->size = st_buf.st_size;
+  file->dev = st_buf.st_dev;
+
+  return file;
+}
+
+int SharedLogEngine::Init() {
+  if (!Helper::IsExistPath(path_) && !Helper::CreateDirectories(path_).ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] create directory failed, path: {}", path_);
+    return -1;
+  }
+
+  std::vector<int64_t> file_ids;
+  for (const auto& dir_entry : std::filesystem::directory_iterator(path_)) {
+    std::string filename = dir_entry.path().filename().string();
+    int64_t file_id = 0;
+    if (sscanf(filename.c_str(), SHARED_LOG_FILE_PATTERN, &file_id) == 1) {
+      file_ids.push_back(file_id);
+    }
+  }
+  std::sort(file_ids.begin(), file_ids.end());
+
+  for (auto file_id : file_ids) {
+    auto file = OpenFile(file_id, false);
+    if (file == nullptr) {
+      return -1;
+    }
+    if (LoadFile(file) != 0) {
+      return -1;
+    }
+    files_[file_id] = file;
+  }
+
+  int64_t active_file_id = file_ids.empty() ? 1 : file_ids.back() + 1;
+  active_file_ = OpenFile(active_file_id, true);
+  if (active_file_ == nullptr) {
+    return -1;
+  }
+  files_[active_file_id] = active_file_;
+
+  DINGO_LOG(INFO) << fmt::format("[raft.shared_log] init finish, path: {} file count: {} region count: {}", path_,
+                                 files_.size(), regions_.size());
+
+  return 0;
+}
+
+int SharedLogEngine::LoadFile(LogFilePtr file) {
+  int64_t offset = 0;
+  while (offset + static_cast<int64_t>(kRecordHeaderSize) <= file->size) {
+    char header_buf[kRecordHeaderSize];
+    ssize_t n = ::pread(file->fd, header_buf, kRecordHeaderSize, offset);
+    if (n != static_cast<ssize_t>(kRecordHeaderSize)) {
+      break;
+    }
+
+    RecordHeader header;
+    uint32_t meta_field;
+    uint32_t header_checksum;
+    RawUnpacker(header_buf)
+        .unpack64((uint64_t&)header.region_id)
+        .unpack64((uint64_t&)header.index)
+        .unpack64((uint64_t&)header.term)
+        .unpack32(meta_field)
+        .unpack32(header.data_len)
+        .unpack32(header.data_checksum)
+        .unpack32(header_checksum);
+    header.record_type = meta_field >> 24;
+    header.entry_type = (meta_field >> 16) & 0xff;
+    header.checksum_type = (meta_field >> 8) & 0xff;
+    if (header_checksum != GetChecksum(header.checksum_type, header_buf, kRecordHeaderSize - 4)) {
+      DINGO_LOG(WARNING) << fmt::format("[raft.shared_log] found corrupted header, path: {} offset: {}", file->path,
+                                        offset);
+      break;
+    }
+
+    const int64_t record_len = kRecordHeaderSize + header.data_len;
+    if (offset + record_len > file->size) {
+      // the last record was not completely written
+      break;
+    }
+
+    ApplyRecord(header, file->id, offset, record_len);
+    offset += record_len;
+  }
+
+  if (offset != file->size) {
+    DINGO_LOG(WARNING) << fmt::format("[raft.shared_log] truncate uncompleted record, path: {} old_size: {} new_size: {}",
+                                      file->path, file->size, offset);
+    if (::ftruncate(file->fd, offset) != 0) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] truncate file failed, path: {} error: {}", file->path,
+                                      berror());
+      return -1;
+    }
+    file->size = offset;
+  }
+
+  return 0;
+}
+
+void SharedLogEngine::TruncateRegionSuffix(RegionLog& region_log, int64_t last_index_kept) {
+  while (!region_log.metas.empty() && region_log.LastIndex() > last_index_kept) {
+    region_log.metas.pop_back();
+  }
+  if (region_log.metas.empty() && region_log.first_index > last_index_kept + 1) {
+    region_log.first_index = last_index_kept + 1;
+  }
+}
+
+void SharedLogEngine::ApplyRecord(const RecordHeader& header, int64_t file_id, int64_t offset, uint32_t length) {
+  switch (static_cast<RecordType>(header.record_type)) {
+    case RecordType::kEntry: {
+      auto it = regions_.find(header.region_id);
+      if (it == regions_.end()) {
+        it = regions_.emplace(header.region_id, RegionLog()).first;
+        it->second.first_index = header.index;
+      }
+
+      auto& region_log = it->second;
+      if (header.index <= region_log.LastIndex()) {
+        // overwrite the conflict entries
+        TruncateRegionSuffix(region_log, header.index - 1);
+      }
+      if (header.index != region_log.LastIndex() + 1) {
+        // the previous entries have been discarded
+        region_log.metas.clear();
+        region_log.first_index = header.index;
+      }
+
+      region_log.metas.push_back(EntryMeta{file_id, offset, length, header.term, header.entry_type});
+    } break;
+    case RecordType::kTruncateSuffix: {
+      auto it = regions_.find(header.region_id);
+      if (it != regions_.end()) {
+        TruncateRegionSuffix(it->second, header.index);
+      }
+    } break;
+    case RecordType::kReset: {
+      auto& region_log = regions_[header.region_id];
+      region_log.metas.clear();
+      region_log.first_index = header.index;
+    } break;
+    case RecordType::kRemoveRegion:
+      regions_.erase(header.region_id);
+      break;
+    default:
+      DINGO_LOG(FATAL) << fmt::format("[raft.shared_log] unknown record type: {}", header.record_type);
+  }
+}
+
+void SharedLogEngine::InitRegion(int64_t region_id, int64_t next_log_index) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = regions_.find(region_id);
+  if (it == regions_.end()) {
+    regions_[region_id].first_index = next_log_index;
+  }
+}
+
+bool SharedLogEngine::GetRegionLogIndex(int64_t region_id, int64_t& first_log_index, int64_t& last_log_index) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = regions_.find(region_id);
+  if (it == regions_.end()) {
+    return false;
+  }
+
+  first_log_index = it->second.first_index;
+  last_log_index = it->second.LastIndex();
+  return true;
+}
+
+int SharedLogEngine::RotateFileIfNeed() {
+  if (active_file_->size < FLAGS_dingo_raft_shared_log_file_size) {
+    return 0;
+  }
+
+  // the old active file is synced at every append if need, just switch to the new one.
+  auto file = OpenFile(active_file_->id + 1, true);
+  if (file == nullptr) {
+    return -1;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  files_[file->id] = file;
+  active_file_ = file;
+  return 0;
+}
+
+int SharedLogEngine::WriteRecords(std::vector<butil::IOBuf>& records, bool sync, LogFilePtr& file, int64_t& offset) {
+  {
+    BAIDU_SCOPED_LOCK(write_mutex_);
+    if (RotateFileIfNeed() != 0) {
+      return -1;
+    }
+
+    file = active_file_;
+    offset = file->size;
+
+    size_t to_write = 0;
+    std::vector<butil::IOBuf*> pieces;
+    pieces.reserve(records.size());
+    for (auto& record : records) {
+      to_write += record.length();
+      pieces.push_back(&record);
+    }
+
+    size_t start = 0;
+    ssize_t written = 0;
+    while (written < (ssize_t)to_write) {
+      const ssize_t n =
+          butil::IOBuf::cut_multiple_into_file_descriptor(file->fd, pieces.data() + start, pieces.size() - start);
+      if (n < 0) {
+        DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] write file failed, path: {} error: {}", file->path,
+                                        berror());
+        // drop the partial records, keep the file offset consistent with size
+        if (::ftruncate(file->fd, offset) != 0 || ::lseek(file->fd, offset, SEEK_SET) != offset) {
+          DINGO_LOG(FATAL) << fmt::format("[raft.shared_log] rollback file failed, path: {} error: {}", file->path,
+                                          berror());
+        }
+        return -1;
+      }
+      written += n;
+      for (; start < pieces.size() && pieces[start]->empty(); ++start) {
+      }
+    }
+    file->size += to_write;
+  }
+
+  if (sync) {
+    // concurrent regions share one sync of the active file
+    int ret = FLAGS_dingo_raft_log_group_commit ? LogSyncGroup::GetInstance(file->dev)->Sync(file->fd)
+                                                : braft::raft_fsync(file->fd);
+    if (ret != 0) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] sync file failed, path: {} error: {}", file->path, berror());
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+static butil::IOBuf EncodeRecord(int checksum_type, uint8_t record_type, int64_t region_id, int64_t index,
+                                 int64_t term, uint8_t entry_type, const butil::IOBuf& data) {
+  char header_buf[kRecordHeaderSize];
+  const uint32_t meta_field = (record_type << 24) | (entry_type << 16) | (checksum_type << 8);
+  RawPacker packer(header_buf);
+  packer.pack64(region_id)
+      .pack64(index)
+      .pack64(term)
+      .pack32(meta_field)
+      .pack32((uint32_t)data.length())
+      .pack32(GetChecksum(checksum_type, data));
+  packer.pack32(GetChecksum(checksum_type, header_buf, kRecordHeaderSize - 4));
+
+  butil::IOBuf record;
+  record.append(header_buf, kRecordHeaderSize);
+  record.append(data);
+  return record;
+}
+
+int SharedLogEngine::Append(int64_t region_id, const braft::LogEntry* const* entries, size_t count, bool sync) {
+  if (entries == nullptr || count == 0) {
+    return EINVAL;
+  }
+
+  int64_t start_time = butil::gettimeofday_us();
+
+  std::vector<butil::IOBuf> records;
+  records.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    const auto* entry = entries[i];
+    butil::IOBuf data;
+    switch (entry->type) {
+      case braft::ENTRY_TYPE_DATA:
+        data.append(entry->data);
+        break;
+      case braft::ENTRY_TYPE_NO_OP:
+        break;
+      case braft::ENTRY_TYPE_CONFIGURATION: {
+        butil::Status status = braft::serialize_configuration_meta(entry, data);
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << fmt::format("[raft.shared_log][region({})] serialize ConfigurationPBMeta failed.",
+                                          region_id);
+          return -1;
+        }
+      } break;
+      default:
+        DINGO_LOG(FATAL) << fmt::format("[raft.shared_log][region({})] unknown entry type: {}", region_id,
+                                        static_cast<int>(entry->type));
+        return -1;
+    }
+    CHECK_LE(data.length(), 1ul << 32ul);
+
+    records.push_back(EncodeRecord(checksum_type_, static_cast<uint8_t>(RecordType::kEntry), region_id,
+                                   entry->id.index, entry->id.term, entry->type, data));
+  }
+
+  std::vector<uint32_t> lengths;
+  lengths.reserve(count);
+  for (const auto& record : records) {
+    lengths.push_back(record.length());
+  }
+
+  LogFilePtr file;
+  int64_t offset = 0;
+  if (WriteRecords(records, sync, file, offset) != 0) {
+    return -1;
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto& region_log = regions_[region_id];
+    if (region_log.metas.empty()) {
+      region_log.first_index = entries[0]->id.index;
+    } else if (entries[0]->id.index != region_log.LastIndex() + 1) {
+      DINGO_LOG(FATAL) << fmt::format("[raft.shared_log][region({})] append entry gap, last_index: {} index: {}",
+                                      region_id, region_log.LastIndex(), entries[0]->id.index);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      region_log.metas.push_back(EntryMeta{file->id, offset, lengths[i], entries[i]->id.term,
+                                           static_cast<uint8_t>(entries[i]->type)});
+      offset += lengths[i];
+    }
+  }
+
+  g_shared_log_append_batch_size << count;
+  g_shared_log_append_latency << (butil::gettimeofday_us() - start_time);
+
+  return 0;
+}
+
+bool SharedLogEngine::GetEntryMeta(int64_t region_id, int64_t index, EntryMeta& meta, LogFilePtr& file) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = regions_.find(region_id);
+  if (it == regions_.end()) {
+    return false;
+  }
+
+  const auto& region_log = it->second;
+  if (index < region_log.first_index || index > region_log.LastIndex()) {
+    return false;
+  }
+
+  meta = region_log.metas[index - region_log.first_index];
+  auto file_it = files_.find(meta.file_id);
+  if (file_it == files_.end()) {
+    return false;
+  }
+  file = file_it->second;
+
+  return true;
+}
+
+int SharedLogEngine::ReadEntry(LogFilePtr file, const EntryMeta& meta, RecordHeader* header, butil::IOBuf* data) {
+  butil::IOPortal buf;
+  ssize_t n = braft::file_pread(&buf, file->fd, meta.offset, meta.length);
+  if (n != static_cast<ssize_t>(meta.length)) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] read file failed, path: {} offset: {} error: {}", file->path,
+                                    meta.offset, berror());
+    return -1;
+  }
+
+  char header_buf[kRecordHeaderSize];
+  buf.cutn(header_buf, kRecordHeaderSize);
+
+  uint32_t meta_field;
+  uint32_t header_checksum;
+  RawUnpacker(header_buf)
+      .unpack64((uint64_t&)header->region_id)
+      .unpack64((uint64_t&)header->index)
+      .unpack64((uint64_t&)header->term)
+      .unpack32(meta_field)
+      .unpack32(header->data_len)
+      .unpack32(header->data_checksum)
+      .unpack32(header_checksum);
+  header->record_type = meta_field >> 24;
+  header->entry_type = (meta_field >> 16) & 0xff;
+  header->checksum_type = (meta_field >> 8) & 0xff;
+  if (header_checksum != GetChecksum(header->checksum_type, header_buf, kRecordHeaderSize - 4) ||
+      header->data_checksum != GetChecksum(header->checksum_type, buf)) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] found corrupted record, path: {} offset: {}", file->path,
+                                    meta.offset);
+    return -1;
+  }
+
+  data->swap(buf);
+  return 0;
+}
+
+braft::LogEntry* SharedLogEngine::Get(int64_t region_id, int64_t index) {
+  EntryMeta meta;
+  LogFilePtr file;
+  if (!GetEntryMeta(region_id, index, meta, file)) {
+    return nullptr;
+  }
+
+  RecordHeader header;
+  butil::IOBuf data;
+  if (ReadEntry(file, meta, &header, &data) != 0) {
+    return nullptr;
+  }
+  CHECK_EQ(header.region_id, region_id);
+  CHECK_EQ(header.index, index);
+
+  auto* entry = new braft::LogEntry();
+  entry->AddRef();
+  entry->id.index = index;
+  entry->id.term = header.term;
+  entry->type = static_cast<braft::EntryType>(header.entry_type);
+  switch (entry->type) {
+    case braft::ENTRY_TYPE_DATA:
+      entry->data.swap(data);
+      break;
+    case braft::ENTRY_TYPE_NO_OP:
+      break;
+    case braft::ENTRY_TYPE_CONFIGURATION: {
+      butil::Status status = braft::parse_configuration_meta(data, entry);
+      if (!status.ok()) {
+        DINGO_LOG(WARNING) << fmt::format("[raft.shared_log][region({})] parse ConfigurationPBMeta failed, index: {}",
+                                          region_id, index);
+        entry->Release();
+        return nullptr;
+      }
+    } break;
+    default:
+      CHECK(false) << fmt::format("[raft.shared_log][region({})] unknown entry type: {}", region_id,
+                                  static_cast<int>(entry->type));
+  }
+
+  return entry;
+}
+
+int64_t SharedLogEngine::GetTerm(int64_t region_id, int64_t index) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = regions_.find(region_id);
+  if (it == regions_.end()) {
+    return 0;
+  }
+
+  const auto& region_log = it->second;
+  if (index < region_log.first_index || index > region_log.LastIndex()) {
+    return 0;
+  }
+  return region_log.metas[index - region_log.first_index].term;
+}
+
+int SharedLogEngine::LoadConfiguration(int64_t region_id, braft::ConfigurationManager* configuration_manager) {
+  std::vector<int64_t> indexes;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = regions_.find(region_id);
+    if (it == regions_.end()) {
+      return 0;
+    }
+
+    const auto& region_log = it->second;
+    for (size_t i = 0; i < region_log.metas.size(); ++i) {
+      if (region_log.metas[i].type == braft::ENTRY_TYPE_CONFIGURATION) {
+        indexes.push_back(region_log.first_index + i);
+      }
+    }
+  }
+
+  for (auto index : indexes) {
+    auto* entry = Get(region_id, index);
+    if (entry == nullptr) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.shared_log][region({})] load configuration failed, index: {}", region_id,
+                                      index);
+      return -1;
+    }
+    braft::ConfigurationEntry conf_entry(*entry);
+    configuration_manager->add(conf_entry);
+    entry->Release();
+  }
+
+  return 0;
+}
+
+int SharedLogEngine::WriteControlRecord(RecordType type, int64_t region_id, int64_t index) {
+  std::vector<butil::IOBuf> records;
+  records.push_back(
+      EncodeRecord(checksum_type_, static_cast<uint8_t>(type), region_id, index, 0, 0, butil::IOBuf()));
+
+  LogFilePtr file;
+  int64_t offset = 0;
+  return WriteRecords(records, true, file, offset);
+}
+
+int SharedLogEngine::TruncatePrefix(int64_t region_id, int64_t first_index_kept) {
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = regions_.find(region_id);
+    if (it == regions_.end()) {
+      return 0;
+    }
+
+    auto& region_log = it->second;
+    while (!region_log.metas.empty() && region_log.first_index < first_index_kept) {
+      region_log.metas.pop_front();
+      ++region_log.first_index;
+    }
+    if (region_log.metas.empty()) {
+      region_log.first_index = std::max(region_log.first_index, first_index_kept);
+    }
+  }
+
+  Gc();
+  return 0;
+}
+
+int SharedLogEngine::TruncateSuffix(int64_t region_id, int64_t last_index_kept) {
+  // record must be durable before memory change, keep the log matching property after restart.
+  int ret = WriteControlRecord(RecordType::kTruncateSuffix, region_id, last_index_kept);
+  if (ret != 0) {
+    return ret;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = regions_.find(region_id);
+  if (it != regions_.end()) {
+    TruncateRegionSuffix(it->second, last_index_kept);
+  }
+  return 0;
+}
+
+int SharedLogEngine::Reset(int64_t region_id, int64_t next_log_index) {
+  int ret = WriteControlRecord(RecordType::kReset, region_id, next_log_index);
+  if (ret != 0) {
+    return ret;
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto& region_log = regions_[region_id];
+    region_log.metas.clear();
+    region_log.first_index = next_log_index;
+  }
+
+  Gc();
+  return 0;
+}
+
+int SharedLogEngine::RemoveRegion(int64_t region_id) {
+  int ret = WriteControlRecord(RecordType::kRemoveRegion, region_id, 0);
+  if (ret != 0) {
+    return ret;
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    regions_.erase(region_id);
+  }
+
+  Gc();
+  return 0;
+}
+
+void SharedLogEngine::Sync() {
+  LogFilePtr file;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    file = active_file_;
+  }
+
+  if (braft::raft_fsync(file->fd) != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.shared_log] sync file failed, path: {} error: {}", file->path, berror());
+  }
+}
+
+void SharedLogEngine::Gc() {
+  // control records only affect the entries written before them, so a file can be deleted
+  // once all older files are deleted and no region reference it.
+  std::vector<LogFilePtr> deleted_files;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    int64_t min_file_id = active_file_->id;
+    for (const auto& [_, region_log] : regions_) {
+      if (!region_log.metas.empty()) {
+        min_file_id = std::min(min_file_id, region_log.metas.front().file_id);
+      }
+    }
+
+    for (auto it = files_.begin(); it != files_.end() && it->first < min_file_id;) {
+      deleted_files.push_back(it->second);
+      it = files_.erase(it);
+    }
+  }
+
+  for (auto& file : deleted_files) {
+    DINGO_LOG(INFO) << fmt::format("[raft.shared_log] delete file, path: {}", file->path);
+    if (::unlink(file->path.c_str()) != 0) {
+      DINGO_LOG(WARNING) << fmt::format("[raft.shared_log] delete file failed, path: {} error: {}", file->path,
+                                        berror());
+    }
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,157 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SHARED_LOG_ENGINE_H_
+#define DINGODB_SHARED_LOG_ENGINE_H_
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "braft/configuration_manager.h"
+#include "braft/log_entry.h"
+#include "bthread/mutex.h"
+#include "butil/iobuf.h"
+
+namespace dingodb {
+
+// SharedLogEngine put the raft log of all regions on a disk into one append stream,
+// the per-region index is kept in memory and rebuilt by scanning the stream at startup.
+// Appends of different regions turn into sequential writes of the same file.
+//
+// SharedLog layout:
+//      shared_log_00000000000000000001: closed file
+//      shared_log_00000000000000000002: active file
+//
+// Record format, all fields are in network order:
+// | ------------------------- region_id (64bits) ------------------------ |
+// | ---------------------------- index (64bits) ------------------------- |
+// | ---------------------------- term (64bits) -------------------------- |
+// | record-type (8bits) | entry-type (8bits) | checksum_type(8bits) | reserved(8bits) |
+// | data len (32bits) | data_checksum (32bits) | header checksum (32bits) |
+class SharedLogEngine {
+ public:
+  explicit SharedLogEngine(const std::string& path);
+  ~SharedLogEngine();
+
+  SharedLogEngine(const SharedLogEngine&) = delete;
+  SharedLogEngine& operator=(const SharedLogEngine&) = delete;
+
+  // get or create engine of the path, the engine is inited.
+  static std::shared_ptr<SharedLogEngine> GetInstance(const std::string& path);
+
+  // load all log files and rebuild region index
+  int Init();
+
+  // create region index in memory if not exist, next_log_index is used for empty region.
+  void InitRegion(int64_t region_id, int64_t next_log_index);
+
+  // return false if region not exist
+  bool GetRegionLogIndex(int64_t region_id, int64_t& first_log_index, int64_t& last_log_index);
+
+  // append entries of region, entries index must be continuous.
+  int Append(int64_t region_id, const braft::LogEntry* const* entries, size_t count, bool sync);
+
+  braft::LogEntry* Get(int64_t region_id, int64_t index);
+  int64_t GetTerm(int64_t region_id, int64_t index);
+
+  // add configuration entries of region to configuration_manager
+  int LoadConfiguration(int64_t region_id, braft::ConfigurationManager* configuration_manager);
+
+  // in memory only, the first log index is persisted by region log meta.
+  int TruncatePrefix(int64_t region_id, int64_t first_index_kept);
+  int TruncateSuffix(int64_t region_id, int64_t last_index_kept);
+  int Reset(int64_t region_id, int64_t next_log_index);
+  int RemoveRegion(int64_t region_id);
+
+  // sync the active file
+  void Sync();
+
+  // delete the files which are not referenced by any region
+  void Gc();
+
+  const std::string& Path() const { return path_; }
+
+ private:
+  enum class RecordType : uint8_t {
+    kEntry = 1,
+    kTruncateSuffix = 2,
+    kReset = 3,
+    kRemoveRegion = 4,
+  };
+
+  struct RecordHeader;
+
+  struct LogFile {
+    LogFile(int64_t id, const std::string& path, int fd) : id(id), path(path), fd(fd) {}
+    ~LogFile();
+
+    int64_t id;
+    std::string path;
+    int fd;
+    int64_t size{0};
+    dev_t dev{0};
+  };
+  using LogFilePtr = std::shared_ptr<LogFile>;
+
+  struct EntryMeta {
+    int64_t file_id;
+    int64_t offset;
+    uint32_t length;
+    int64_t term;
+    uint8_t type;
+  };
+
+  struct RegionLog {
+    int64_t first_index{1};
+    std::deque<EntryMeta> metas;
+
+    int64_t LastIndex() const { return first_index + static_cast<int64_t>(metas.size()) - 1; }
+  };
+
+  std::string FilePath(int64_t file_id) const;
+  LogFilePtr OpenFile(int64_t file_id, bool create);
+  int LoadFile(LogFilePtr file);
+  int RotateFileIfNeed();
+
+  int WriteRecords(std::vector<butil::IOBuf>& records, bool sync, LogFilePtr& file, int64_t& offset);
+  int WriteControlRecord(RecordType type, int64_t region_id, int64_t index);
+
+  void ApplyRecord(const RecordHeader& header, int64_t file_id, int64_t offset, uint32_t length);
+  static void TruncateRegionSuffix(RegionLog& region_log, int64_t last_index_kept);
+
+  static int ReadEntry(LogFilePtr file, const EntryMeta& meta, RecordHeader* header, butil::IOBuf* data);
+  bool GetEntryMeta(int64_t region_id, int64_t index, EntryMeta& meta, LogFilePtr& file);
+
+  std::string path_;
+  int checksum_type_;
+
+  // protect write order of active file
+  bthread::Mutex write_mutex_;
+
+  // protect files_ and regions_
+  bthread::Mutex mutex_;
+  std::map<int64_t, LogFilePtr> files_;
+  LogFilePtr active_file_;
+  std::map<int64_t, RegionLog> regions_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_SHARED_LOG_ENGINE_H_
@@ -38,6 +38,22 @@ bool MetaWriter::Put(const std::shared_ptr<pb::common::KeyValue> kv) {
   return true;
 }
 
+bool MetaWriter::PutApplied(const std::shared_ptr<pb::common::KeyValue> kv) {
+  if (kv == nullptr) return true;
+  DINGO_LOG(DEBUG) << "Put applied meta data, key: " << kv->key();
+  auto status = engine_->Writer()->KvBatchPutAndDeleteApplied({{Constant::kStoreMetaCF, {*kv}}}, {});
+  if (status.error_code() == pb::error::Errno::EINTERNAL) {
+    DINGO_LOG(FATAL) << "KvBatchPutAndDeleteApplied failed, errcode: " << status.error_code() << " "
+                     << status.error_str() << ", key(hex): " << Helper::StringToHex(kv->key());
+  }
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << "Meta write failed, errcode: " << status.error_code() << " " << status.error_str();
+    return false;
+  }
+
+  return true;
+}
+
 bool MetaWriter::Put(const std::vector<pb::common::KeyValue> kvs) {
   DINGO_LOG(DEBUG) << "Put meta data, key nums: " << kvs.size();
   if (kvs.empty()) return true;
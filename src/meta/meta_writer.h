@@ -33,6 +33,8 @@ class MetaWriter {
 
   bool Put(std::shared_ptr<pb::common::KeyValue> kv);
   bool Put(std::vector<pb::common::KeyValue> kvs);
+  // Put meta which go along with the raft applied data, e.g. applied index, see KvBatchPutAndDeleteApplied.
+  bool PutApplied(std::shared_ptr<pb::common::KeyValue> kv);
   bool PutAndDelete(std::vector<pb::common::KeyValue> kvs_to_put, std::vector<std::string> keys_to_delete);
   bool Delete(const std::string &key);
   bool DeleteRange(const std::string &start_key, const std::string &end_key);
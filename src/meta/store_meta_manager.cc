@@ -30,12 +30,17 @@
 #include "common/role.h"
 #include "common/synchronization.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
 #include "server/server.h"
 
 namespace dingodb {
 
+DEFINE_bool(enable_region_meta_write_behind, false,
+            "defer the not correctness critical region meta write and write them in batch");
+DEFINE_int64(region_meta_flush_interval_ms, 100, "flush deferred region meta interval milliseconds");
+
 namespace store {
 
 Region::Region(int64_t region_id) {
@@ -173,6 +178,18 @@ std::vector<pb::common::Peer> Region::Peers() {
   return peers;
 }
 
+std::vector<pb::common::Peer> Region::Peers(pb::common::PeerRole role) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  std::vector<pb::common::Peer> peers;
+  for (const auto& peer : inner_region_.definition().peers()) {
+    if (peer.role() == role) {
+      peers.push_back(peer);
+    }
+  }
+  return peers;
+}
+
 void Region::SetPeers(std::vector<pb::common::Peer>& peers) {
   google::protobuf::RepeatedPtrField<pb::common::Peer> tmp_peers;
   tmp_peers.Add(peers.begin(), peers.end());
@@ -256,6 +273,11 @@ int64_t Region::PartitionId() {
   return inner_region_.definition().part_id();
 }
 
+int64_t Region::TenantId() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return inner_region_.definition().tenant_id();
+}
+
 int64_t Region::SnapshotEpochVersion() {
   BAIDU_SCOPED_LOCK(mutex_);
   return inner_region_.snapshot_epoch_version();
@@ -290,7 +312,15 @@ bool Region::LatchesAcquire(Lock* lock, uint64_t who) {
   CHECK(lock != nullptr);
   CHECK(who != 0);
 
-  return this->latches_.Acquire(lock, who);
+  std::vector<uint64_t> wakeup;
+  bool acquired = this->latches_.Acquire(lock, who, &wakeup);
+  for (const auto& cid : wakeup) {
+    CHECK(cid != 0);
+    BthreadCond* cond = (BthreadCond*)cid;
+    cond->DecreaseSignal();
+  }
+
+  return acquired;
 }
 
 void Region::LatchesRelease(Lock* lock, uint64_t who,
@@ -303,6 +333,8 @@ void Region::LatchesRelease(Lock* lock, uint64_t who,
   }
 }
 
+std::vector<SlotStat> Region::LatchesHotSlots(size_t top_n) { return this->latches_.GetHotSlots(top_n); }
+
 RaftMeta::RaftMeta(int64_t region_id) {
   raft_meta_.set_region_id(region_id);
   raft_meta_.set_term(0);
@@ -749,15 +781,15 @@ void StoreRegionMeta::AddRegion(store::RegionPtr region) {
   region->AppendHistoryState(pb::common::StoreRegionState::NEW);
   regions_.Put(region->Id(), region);
 
-  if (meta_writer_ != nullptr) {
-    meta_writer_->Put(TransformToKv(region));
-  }
+  PersistRegion(region, true);
 }
 
 void StoreRegionMeta::DeleteRegion(int64_t region_id) {
   regions_.Erase(region_id);
 
   if (meta_writer_ != nullptr) {
+    BAIDU_SCOPED_LOCK(persist_mutex_);
+    dirty_regions_.erase(region_id);
     meta_writer_->Delete(GenKey(region_id));
   }
 }
@@ -765,8 +797,44 @@ void StoreRegionMeta::DeleteRegion(int64_t region_id) {
 void StoreRegionMeta::UpdateRegion(store::RegionPtr region) {
   regions_.Put(region->Id(), region);
 
-  if (meta_writer_ != nullptr) {
-    meta_writer_->Put(TransformToKv(region));
+  PersistRegion(region, true);
+}
+
+void StoreRegionMeta::PersistRegion(store::RegionPtr region, bool sync) {
+  if (meta_writer_ == nullptr) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(persist_mutex_);
+  if (!sync && FLAGS_enable_region_meta_write_behind) {
+    dirty_regions_[region->Id()] = region;
+    return;
+  }
+
+  // The whole region is serialized, so the deferred changes are written too.
+  dirty_regions_.erase(region->Id());
+  meta_writer_->Put(TransformToKv(region));
+}
+
+void StoreRegionMeta::FlushRegions() {
+  if (meta_writer_ == nullptr) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(persist_mutex_);
+  if (dirty_regions_.empty()) {
+    return;
+  }
+
+  std::vector<pb::common::KeyValue> kvs;
+  kvs.reserve(dirty_regions_.size());
+  for (auto& [region_id, region] : dirty_regions_) {
+    kvs.push_back(std::move(*TransformToKv(region)));
+  }
+
+  if (meta_writer_->Put(kvs)) {
+    DINGO_LOG(DEBUG) << fmt::format("[region.meta] flush region meta num: {}", kvs.size());
+    dirty_regions_.clear();
   }
 }
 
@@ -827,7 +895,7 @@ void StoreRegionMeta::UpdateState(store::RegionPtr region, pb::common::StoreRegi
   if (successed) {
     region->AppendHistoryState(new_state);
     if (meta_writer_ != nullptr) {
-      meta_writer_->Put(TransformToKv(region));
+      PersistRegion(region, true);
     } else {
       DINGO_LOG(WARNING) << fmt::format(
           "[region.meta][region({})] update region state persistence failed, state {} to {}", region->Id(),
@@ -863,7 +931,7 @@ void StoreRegionMeta::UpdateLeaderId(int64_t region_id, int64_t leader_id) {
 void StoreRegionMeta::UpdatePeers(store::RegionPtr region, std::vector<pb::common::Peer>& peers) {
   assert(region != nullptr);
   region->SetPeers(peers);
-  meta_writer_->Put(TransformToKv(region));
+  PersistRegion(region, true);
 }
 
 void StoreRegionMeta::UpdatePeers(int64_t region_id, std::vector<pb::common::Peer>& peers) {
@@ -884,7 +952,7 @@ void StoreRegionMeta::UpdateEpochVersionAndRange(store::RegionPtr region, int64_
                                  trace, version, Helper::RangeToString(range));
 
   region->SetEpochVersionAndRange(version, range);
-  meta_writer_->Put(TransformToKv(region));
+  PersistRegion(region, true);
 }
 
 void StoreRegionMeta::UpdateSnapshotEpochVersion(store::RegionPtr region, int64_t version, const std::string& trace) {
@@ -896,7 +964,7 @@ void StoreRegionMeta::UpdateSnapshotEpochVersion(store::RegionPtr region, int64_
   DINGO_LOG(INFO) << fmt::format("[region.meta][region({})][trace({})] update epoch({})", region->Id(), trace, version);
 
   region->SetSnapshotEpochVersion(version);
-  meta_writer_->Put(TransformToKv(region));
+  PersistRegion(region, true);
 }
 
 void StoreRegionMeta::UpdateEpochVersionAndRange(int64_t region_id, int64_t version, const pb::common::Range& range,
@@ -914,7 +982,7 @@ void StoreRegionMeta::UpdateEpochConfVersion(store::RegionPtr region, int64_t ve
   }
 
   region->SetEpochConfVersion(version);
-  meta_writer_->Put(TransformToKv(region));
+  PersistRegion(region, true);
 }
 
 void StoreRegionMeta::UpdateEpochConfVersion(int64_t region_id, int64_t version) {
@@ -928,28 +996,28 @@ void StoreRegionMeta::UpdateNeedBootstrapDoSnapshot(store::RegionPtr region, boo
   assert(region != nullptr);
 
   region->SetNeedBootstrapDoSnapshot(need_do_snapshot);
-  meta_writer_->Put(TransformToKv(region));
+  PersistRegion(region, true);
 }
 
 void StoreRegionMeta::UpdateDisableChange(store::RegionPtr region, bool disable_change) {
   assert(region != nullptr);
 
   region->SetDisableChange(disable_change);
-  meta_writer_->Put(TransformToKv(region));
+  PersistRegion(region, false);
 }
 
 void StoreRegionMeta::UpdateTemporaryDisableChange(store::RegionPtr region, bool disable_change) {
   assert(region != nullptr);
 
   region->SetTemporaryDisableChange(disable_change);
-  meta_writer_->Put(TransformToKv(region));
+  PersistRegion(region, false);
 }
 
 void StoreRegionMeta::UpdateLastChangeJobId(store::RegionPtr region, int64_t job_id) {
   assert(region != nullptr);
 
   region->SetLastChangeJobId(job_id);
-  meta_writer_->Put(TransformToKv(region));
+  PersistRegion(region, false);
 }
 
 bool StoreRegionMeta::IsExistRegion(int64_t region_id) { return GetRegion(region_id) != nullptr; }
@@ -1063,6 +1131,22 @@ void StoreRaftMeta::UpdateRaftMeta(store::RaftMetaPtr raft_meta) {
   meta_writer_->Put(TransformToKv(raft_meta));
 }
 
+void StoreRaftMeta::UpdateAppliedRaftMeta(store::RaftMetaPtr raft_meta) {
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    raft_metas_.insert_or_assign(raft_meta->RegionId(), raft_meta);
+  }
+
+  meta_writer_->PutApplied(TransformToKv(raft_meta));
+}
+
+std::shared_ptr<pb::common::KeyValue> StoreRaftMeta::GenAppliedRaftMetaKv(int64_t region_id, int64_t term,
+                                                                         int64_t applied_index) {
+  auto raft_meta = store::RaftMeta::New(region_id);
+  raft_meta->SetTermAndAppliedId(term, applied_index);
+  return TransformToKv(raft_meta);
+}
+
 void StoreRaftMeta::SaveRaftMeta(int64_t region_id) {
   auto raft_meta = GetRaftMeta(region_id);
   if (raft_meta != nullptr) {
@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "braft/file_system_adaptor.h"
+#include "bthread/mutex.h"
 #include "bthread/types.h"
 #include "butil/endpoint.h"
 #include "common/constant.h"
@@ -88,6 +89,8 @@ class Region {
   void SetIndexParameter(const pb::common::IndexParameter& index_parameter);
 
   std::vector<pb::common::Peer> Peers();
+  // Voters are in the raft configuration, learners only pull the log from voters.
+  std::vector<pb::common::Peer> Peers(pb::common::PeerRole role);
   void SetPeers(std::vector<pb::common::Peer>& peers);
 
   pb::common::StoreRegionState State() const;
@@ -113,6 +116,7 @@ class Region {
   void SetParentId(int64_t region_id);
 
   int64_t PartitionId();
+  int64_t TenantId();
 
   int64_t SnapshotEpochVersion();
 
@@ -133,6 +137,8 @@ class Region {
   void LatchesRelease(Lock* lock, uint64_t who,
                       std::optional<std::pair<uint64_t, Lock*>> keep_latches_for_next_cmd = std::nullopt);
 
+  std::vector<SlotStat> LatchesHotSlots(size_t top_n);
+
  private:
   bthread_mutex_t mutex_;
   pb::store_internal::Region inner_region_;
@@ -292,18 +298,32 @@ class StoreRegionMeta : public TransformKvAble {
   std::vector<store::RegionPtr> GetAllAliveRegion();
   std::vector<store::RegionPtr> GetAllMetricsRegion();
 
+  // Write the deferred region meta in one batch, called periodically and before shutdown.
+  void FlushRegions();
+
  private:
   std::shared_ptr<pb::common::KeyValue> TransformToKv(std::any obj) override;
   void TransformFromKv(const std::vector<pb::common::KeyValue>& kvs) override;
 
+  // Persist region meta, sync is for the correctness critical changes, e.g. state, epoch, range and peers.
+  // When enable_region_meta_write_behind, the other changes only mark region dirty, multiple changes of
+  // a region are coalesced and written by FlushRegions.
+  void PersistRegion(store::RegionPtr region, bool sync);
+
   // Read meta data from persistence storage.
   std::shared_ptr<MetaReader> meta_reader_;
   // Write meta data to persistence storage.
   std::shared_ptr<MetaWriter> meta_writer_;
 
   // Store all region meta data in this server.
-  using RegionMap = DingoSafeMap<int64_t, store::RegionPtr>;
+  // Region is looked up on every request, so shard the map to keep lookups away from split/merge writers.
+  using RegionMap = DingoShardedSafeMap<int64_t, store::RegionPtr>;
   RegionMap regions_;
+
+  // Region meta is serialized when written, so writes of region must be in order under write behind,
+  // otherwise a flush may overwrite a newer sync write or recreate a deleted region meta.
+  bthread::Mutex persist_mutex_;
+  std::map<int64_t, store::RegionPtr> dirty_regions_;
 };
 
 class StoreRaftMeta : public TransformKvAble {
@@ -321,6 +341,10 @@ class StoreRaftMeta : public TransformKvAble {
 
   void AddRaftMeta(store::RaftMetaPtr raft_meta);
   void UpdateRaftMeta(store::RaftMetaPtr raft_meta);
+  // Persist the applied index of raft apply, it is not persisted before the applied data.
+  void UpdateAppliedRaftMeta(store::RaftMetaPtr raft_meta);
+  // Kv of the applied index, which is written with the applied data in one batch.
+  std::shared_ptr<pb::common::KeyValue> GenAppliedRaftMetaKv(int64_t region_id, int64_t term, int64_t applied_index);
   void SaveRaftMeta(int64_t region_id);
   void DeleteRaftMeta(int64_t region_id);
   store::RaftMetaPtr GetRaftMeta(int64_t region_id);
@@ -24,11 +24,14 @@
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/memory_tracker.h"
 #include "config/config_manager.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "server/server.h"
+#include "split/load_split.h"
+#include "vector/vector_scan_kernel.h"
 
 namespace dingodb {
 
@@ -147,6 +150,11 @@ bool StoreMetrics::CollectMetrics() {
 
   metrics_->mutable_store_own_metrics()->set_process_used_memory(output["process_used_memory"]);
 
+  CollectMemoryUsage();
+
+  // for vector aware placement on coordinator
+  metrics_->mutable_store_own_metrics()->set_simd_name(VectorScanKernel::SimdName());
+
   // calc is_read_only for self store
   bool self_store_is_read_only = false;
   int64_t free_capacity = metrics_->store_own_metrics().system_free_capacity();
@@ -178,6 +186,32 @@ bool StoreMetrics::CollectMetrics() {
   return true;
 }
 
+// Refresh the usage of subsystems owned by others, the usage tracked when consuming is corrected too.
+void StoreMetrics::CollectMemoryUsage() {
+  int64_t memtable_bytes = 0;
+  int64_t block_cache_bytes = 0;
+  auto raw_engine = Server::GetInstance().GetRawEngine(pb::common::RAW_ENG_ROCKSDB);
+  if (raw_engine != nullptr) {
+    raw_engine->GetMemoryUsage(memtable_bytes, block_cache_bytes);
+  }
+
+  int64_t vector_index_bytes = 0;
+  for (const auto& region : Server::GetInstance().GetAllAliveRegion()) {
+    auto vector_index_wrapper = region->VectorIndexWrapper();
+    if (vector_index_wrapper == nullptr || !vector_index_wrapper->IsReady()) {
+      continue;
+    }
+    int64_t memory_size = 0;
+    vector_index_wrapper->GetMemorySize(memory_size);
+    vector_index_bytes += memory_size;
+  }
+
+  auto& memory_tracker = MemoryTracker::GetInstance();
+  memory_tracker.Set(MemoryTracker::Type::kMemtable, memtable_bytes);
+  memory_tracker.Set(MemoryTracker::Type::kBlockCache, block_cache_bytes);
+  memory_tracker.Set(MemoryTracker::Type::kVectorIndex, vector_index_bytes);
+}
+
 bool StoreRegionMetrics::Init() {
   std::vector<pb::common::KeyValue> kvs;
   if (!meta_reader_->Scan(Prefix(), kvs)) {
@@ -228,9 +262,21 @@ std::string StoreRegionMetrics::GetRegionMaxKey(store::RegionPtr region) {
   return std::string(max_key.data(), max_key.size());
 }
 
+DEFINE_bool(enable_region_approximate_key_count, false,
+            "estimate region key count by table properties and memtable stats instead of iterating keys");
+
 int64_t StoreRegionMetrics::GetRegionKeyCount(store::RegionPtr region) {
   int64_t count = 0;
   auto raw_engine = Server::GetInstance().GetRawEngine(region->GetRawEngineType());
+  if (FLAGS_enable_region_approximate_key_count) {
+    auto status = raw_engine->GetApproximateKeyCount(Constant::kStoreDataCF, region->Range(), count);
+    if (status.ok()) {
+      return count;
+    }
+    DINGO_LOG(DEBUG) << fmt::format("[metrics.region][region({})] get approximate key count failed, error: {}",
+                                    region->Id(), Helper::PrintStatus(status));
+  }
+
   raw_engine->Reader()->KvCount(Constant::kStoreDataCF, region->Range().start_key(), region->Range().end_key(), count);
 
   return count;
@@ -267,10 +313,10 @@ std::vector<std::pair<int64_t, int64_t>> StoreRegionMetrics::GetRegionApproximat
   for (const auto& range : ranges) {
     pb::common::Range txn_range = Helper::GetMemComparableRange(range);
     txn_ranges.push_back(txn_range);
-    DINGO_LOG(INFO) << "[metrics.region] txn range: " << Helper::StringToHex(txn_range.start_key()) << " "
-                    << Helper::StringToHex(txn_range.end_key());
-    DINGO_LOG(INFO) << "[metrics.region] raw range: " << Helper::StringToHex(range.start_key()) << " "
-                    << Helper::StringToHex(range.end_key());
+    DINGO_LOG(DEBUG) << "[metrics.region] txn range: " << Helper::StringToHex(txn_range.start_key()) << " "
+                     << Helper::StringToHex(txn_range.end_key());
+    DINGO_LOG(DEBUG) << "[metrics.region] raw range: " << Helper::StringToHex(range.start_key()) << " "
+                     << Helper::StringToHex(range.end_key());
   }
 
   // for raw cf, use region's range to get approximate size
@@ -280,15 +326,15 @@ std::vector<std::pair<int64_t, int64_t>> StoreRegionMetrics::GetRegionApproximat
       auto sizes = raw_engine->GetApproximateSizes(cf_name, txn_ranges);
       for (int i = 0; i < sizes.size(); ++i) {
         region_sizes[i].second += sizes[i];
-        DINGO_LOG(INFO) << "[metrics.region] txn region_size: " << sizes[i] << " region_id: " << valid_regions[i]->Id()
-                        << " cf_name: " << cf_name;
+        DINGO_LOG(DEBUG) << "[metrics.region] txn region_size: " << sizes[i]
+                         << " region_id: " << valid_regions[i]->Id() << " cf_name: " << cf_name;
       }
     } else {
       auto sizes = raw_engine->GetApproximateSizes(cf_name, ranges);
       for (int i = 0; i < sizes.size(); ++i) {
         region_sizes[i].second += sizes[i];
-        DINGO_LOG(INFO) << "[metrics.region] raw region_size: " << sizes[i] << " region_id: " << valid_regions[i]->Id()
-                        << " cf_name: " << cf_name;
+        DINGO_LOG(DEBUG) << "[metrics.region] raw region_size: " << sizes[i]
+                         << " region_id: " << valid_regions[i]->Id() << " cf_name: " << cf_name;
       }
     }
   }
@@ -329,6 +375,7 @@ bool StoreRegionMetrics::CollectApproximateSizeMetrics() {
 
   std::vector<store::RegionPtr> need_collect_rocks_regions;
   std::vector<store::RegionPtr> need_collect_bdb_regions;
+  std::vector<store::RegionPtr> need_collect_memory_regions;
 
   for (const auto& region_metrics : region_metricses) {
     DINGO_LOG(DEBUG) << fmt::format(
@@ -384,6 +431,8 @@ bool StoreRegionMetrics::CollectApproximateSizeMetrics() {
       need_collect_rocks_regions.push_back(region);
     } else if (region->GetRawEngineType() == pb::common::RAW_ENG_BDB) {
       need_collect_bdb_regions.push_back(region);
+    } else if (region->GetRawEngineType() == pb::common::RAW_ENG_MEMORY) {
+      need_collect_memory_regions.push_back(region);
     }
   }
 
@@ -441,6 +490,25 @@ bool StoreRegionMetrics::CollectApproximateSizeMetrics() {
         need_collect_bdb_regions.size(), batch_regions.size(), Helper::TimestampMs() - start_time);
   }
 
+  // Get size of memory regions, it is the exact size of the latest data.
+  if (!need_collect_memory_regions.empty()) {
+    int64_t start_time = Helper::TimestampMs();
+    auto batch_regions = GenBatchRegion(need_collect_memory_regions);
+    for (auto& regions : batch_regions) {
+      for (auto& item : GetRegionApproximateSize(regions)) {
+        auto region_metrics = GetMetrics(item.first);
+        if (region_metrics != nullptr) {
+          region_metrics->SetRegionSize(item.second);
+          region_metrics->UpdateLastUpdateMetricsLogIndex();
+        }
+      }
+    }
+
+    DINGO_LOG(INFO) << fmt::format(
+        "[metrics.region] get memory region size total size({}) batch size({}) elapsed time[{} ms]",
+        need_collect_memory_regions.size(), batch_regions.size(), Helper::TimestampMs() - start_time);
+  }
+
   return true;
 }
 
@@ -449,6 +517,25 @@ bool StoreRegionMetrics::CollectMetrics() {
   auto store_raft_meta = Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta();
   auto region_metricses = GetAllMetrics();
 
+  // Load is collected for all regions, including the regions without write.
+  std::vector<int64_t> region_ids;
+  region_ids.reserve(region_metricses.size());
+  for (const auto& region_metrics : region_metricses) {
+    region_ids.push_back(region_metrics->Id());
+  }
+  RegionLoadStatistics::GetInstance().Statistic(region_ids);
+  for (const auto& region_metrics : region_metricses) {
+    auto region_load = RegionLoadStatistics::GetInstance().GetRegionLoad(region_metrics->Id());
+    if (region_load != nullptr) {
+      region_metrics->SetLoad(region_load->ReadQps(), region_load->WriteQps(), region_load->Buckets());
+      region_metrics->SetTraffic(region_load->ReadBytesPerSecond(), region_load->WriteBytesPerSecond(),
+                                 region_load->HotKeys());
+    } else {
+      region_metrics->SetLoad(0, 0, {});
+      region_metrics->SetTraffic(0, 0, {});
+    }
+  }
+
   std::vector<store::RegionPtr> need_collect_regions;
   for (const auto& region_metrics : region_metricses) {
     auto raft_meta = store_raft_meta->GetRaftMeta(region_metrics->Id());
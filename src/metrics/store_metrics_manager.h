@@ -17,6 +17,7 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <memory>
@@ -60,6 +61,10 @@ class RegionMetrics {
     // UpdateMaxAndMinKeyPolicy
     need_update_min_key_ = true;
     need_update_max_key_ = true;
+
+    // data of region changed, sample again.
+    vector_scalar_samples_ = nullptr;
+    vector_scalar_sample_timestamp_ms_ = 0;
   }
 
   int64_t LastLogIndex() {
@@ -260,6 +265,57 @@ class RegionMetrics {
 
   // vector index end
 
+  void SetLoad(int64_t read_qps, int64_t write_qps, const std::vector<pb::common::RegionLoadBucket>& buckets) {
+    BAIDU_SCOPED_LOCK(mutex_);
+    inner_region_metrics_.set_read_qps(read_qps);
+    inner_region_metrics_.set_write_qps(write_qps);
+    inner_region_metrics_.clear_load_buckets();
+    for (const auto& bucket : buckets) {
+      *inner_region_metrics_.add_load_buckets() = bucket;
+    }
+  }
+
+  void SetTraffic(int64_t read_bytes_per_second, int64_t write_bytes_per_second,
+                  const std::vector<pb::common::RegionHotKey>& hot_keys) {
+    BAIDU_SCOPED_LOCK(mutex_);
+    inner_region_metrics_.set_read_bytes_per_second(read_bytes_per_second);
+    inner_region_metrics_.set_write_bytes_per_second(write_bytes_per_second);
+    inner_region_metrics_.clear_hot_keys();
+    for (const auto& hot_key : hot_keys) {
+      *inner_region_metrics_.add_hot_keys() = hot_key;
+    }
+  }
+
+  // txn versions written to write cf since last gc of region, only in memory.
+  void IncTxnGcVersions(int64_t count) {
+    BAIDU_SCOPED_LOCK(mutex_);
+    txn_gc_versions_ += count;
+  }
+
+  int64_t TxnGcVersions() {
+    BAIDU_SCOPED_LOCK(mutex_);
+    return txn_gc_versions_;
+  }
+
+  // count is the versions before gc, versions written during gc are kept for next gc.
+  void SubTxnGcVersions(int64_t count) {
+    BAIDU_SCOPED_LOCK(mutex_);
+    txn_gc_versions_ = std::max(static_cast<int64_t>(0), txn_gc_versions_ - count);
+  }
+
+  // scalar data sampled for estimating the selectivity of scalar filter, only in memory.
+  std::shared_ptr<const std::vector<pb::common::VectorScalardata>> GetVectorScalarSamples(int64_t& timestamp_ms) {
+    BAIDU_SCOPED_LOCK(mutex_);
+    timestamp_ms = vector_scalar_sample_timestamp_ms_;
+    return vector_scalar_samples_;
+  }
+
+  void SetVectorScalarSamples(std::shared_ptr<const std::vector<pb::common::VectorScalardata>> samples) {
+    BAIDU_SCOPED_LOCK(mutex_);
+    vector_scalar_samples_ = samples;
+    vector_scalar_sample_timestamp_ms_ = butil::gettimeofday_ms();
+  }
+
   const pb::common::RegionMetrics& InnerRegionMetrics() {
     BAIDU_SCOPED_LOCK(mutex_);
     return inner_region_metrics_;
@@ -287,6 +343,11 @@ class RegionMetrics {
   bool need_update_key_count_{true};
 
   pb::common::RegionMetrics inner_region_metrics_;
+  // not serialized, sampled again after restart.
+  std::shared_ptr<const std::vector<pb::common::VectorScalardata>> vector_scalar_samples_;
+  int64_t vector_scalar_sample_timestamp_ms_{0};
+  // not serialized, every region is gc by full gc round after restart.
+  int64_t txn_gc_versions_{0};
   // protect inner_region_metrics_
   bthread_mutex_t mutex_;
 };
@@ -310,6 +371,8 @@ class StoreMetrics {
   std::shared_ptr<pb::common::StoreMetrics> Metrics() { return metrics_; }
 
  private:
+  static void CollectMemoryUsage();
+
   std::shared_ptr<pb::common::StoreMetrics> metrics_;
 };
 
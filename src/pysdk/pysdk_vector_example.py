@@ -2,6 +2,7 @@
 
 from os.path import dirname, abspath
 import argparse
+from array import array
 import time
 
 import dingosdk
@@ -228,6 +229,25 @@ def vector_count(use_index_name=False):
     if tmp.ok():
         assert result == len(g_vector_ids) - 1
 
+def vector_buffer_add_search():
+    # any c contiguous buffer works, e.g. numpy.asarray(..., dtype=numpy.float32)
+    ids = array('q', [100, 101, 102])
+    vectors = array('f', [1.0, 1.0, 2.0, 2.0, 3.0, 3.0])
+    tmp = g_vector_client.AddByIndexIdFromBuffer(g_index_id, ids, vectors)
+    print(f"buffer add vector status: {tmp.ToString()}")
+
+    param = dingosdk.SearchParam()
+    param.topk = 2
+    targets = array('f', [1.1, 1.1, 2.9, 2.9])
+    tmp, out_ids, out_distances, out_counts = g_vector_client.SearchByIndexIdFromBuffer(g_index_id, param, targets)
+    print(f"buffer search vector status: {tmp.ToString()}, ids: {out_ids.tolist()}, "
+          f"distances: {out_distances.tolist()}, counts: {out_counts.tolist()}")
+    if tmp.ok():
+        assert len(out_counts) == 2
+
+    tmp, result = g_vector_client.DeleteByIndexId(g_index_id, list(ids))
+    print(f"buffer delete vector status: {tmp.ToString()}")
+
 def vector_delete(use_index_name=False):
     if use_index_name:
         tmp, result = g_vector_client.DeleteByIndexName(g_schema_id, g_index_name, g_vector_ids)
@@ -246,6 +266,7 @@ if __name__ == "__main__":
     prepare_vector_index()
     vector_add()
     vector_search()
+    vector_buffer_add_search()
     vector_query()
     vector_get_border()
     vector_scan_query()
@@ -18,13 +18,16 @@
 #include <string>
 #include <utility>
 
+#include "braft/snapshot_throttle.h"
 #include "bthread/bthread.h"
 #include "butil/memory/ref_counted.h"
 #include "butil/status.h"
 #include "common/failpoint.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "config/config_helper.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "log/segment_log_storage.h"
 #include "metrics/store_bvar_metrics.h"
 #include "proto/common.pb.h"
@@ -32,9 +35,40 @@
 #include "raft/store_state_machine.h"
 
 DEFINE_int32(node_destroy_wait_time_ms, 3000, "wait time on node destroy");
+DEFINE_int64(raft_snapshot_throttle_throughput_mb, 100,
+             "max disk and network throughput of all snapshot transfer in the store, 0 means no throttle");
+DEFINE_int64(raft_snapshot_throttle_check_cycle, 10, "check cycle per second of snapshot throttle");
+DEFINE_int32(raft_snapshot_max_concurrent_tasks, 4, "max concurrent snapshot install tasks in the store");
 
 namespace dingodb {
 
+// All regions of the store share one throttle, so the token bucket and the task slots are per store.
+// The throttle limits both the leader reading snapshot files and the follower copying them.
+static scoped_refptr<braft::SnapshotThrottle>* GetSnapshotThrottle() {
+  static scoped_refptr<braft::SnapshotThrottle>* snapshot_throttle = []() {
+    auto* throttle = new scoped_refptr<braft::SnapshotThrottle>();
+    if (FLAGS_raft_snapshot_throttle_throughput_mb <= 0) {
+      return throttle;
+    }
+
+    if (google::SetCommandLineOption("raft_max_install_snapshot_tasks_num",
+                                     std::to_string(FLAGS_raft_snapshot_max_concurrent_tasks).c_str())
+            .empty()) {
+      DINGO_LOG(ERROR) << "[raft.node] set raft_max_install_snapshot_tasks_num failed.";
+    }
+
+    throttle->reset(new braft::ThroughputSnapshotThrottle(FLAGS_raft_snapshot_throttle_throughput_mb * 1024 * 1024,
+                                                          FLAGS_raft_snapshot_throttle_check_cycle));
+    DINGO_LOG(INFO) << fmt::format("[raft.node] snapshot throttle throughput: {}MB/s, max concurrent tasks: {}",
+                                   FLAGS_raft_snapshot_throttle_throughput_mb, FLAGS_raft_snapshot_max_concurrent_tasks);
+    return throttle;
+  }();
+
+  return snapshot_throttle;
+}
+
+braft::SnapshotThrottle* RaftNode::GetSharedSnapshotThrottle() { return GetSnapshotThrottle()->get(); }
+
 RaftNode::RaftNode(int64_t node_id, const std::string& raft_group_name, braft::PeerId peer_id,
                    std::shared_ptr<BaseStateMachine> fsm, std::shared_ptr<SegmentLogStorage> log_storage)
     : node_id_(node_id),
@@ -79,6 +113,10 @@ int RaftNode::Init(store::RegionPtr region, const std::string& init_conf, const
   if (region != nullptr) {
     region->snapshot_adaptor = new DingoFileSystemAdaptor(region->Id());
     node_options.snapshot_file_system_adaptor = &region->snapshot_adaptor;
+    auto* snapshot_throttle = GetSnapshotThrottle();
+    if (snapshot_throttle->get() != nullptr) {
+      node_options.snapshot_throttle = snapshot_throttle;
+    }
   }
 
   if (node_->init(node_options) != 0) {
@@ -121,6 +159,9 @@ butil::Status RaftNode::Commit(std::shared_ptr<Context> ctx, std::shared_ptr<pb:
   if (!IsLeader()) {
     return butil::Status(pb::error::ERAFT_NOTLEADER, GetLeaderId().to_string());
   }
+  WakeUp();
+
+  int64_t start_time_ns = Helper::TimestampNs();
   butil::IOBuf data;
   butil::IOBufAsZeroCopyOutputStream wrapper(&data);
   raft_cmd->SerializeToZeroCopyStream(&wrapper);
@@ -129,6 +170,7 @@ butil::Status RaftNode::Commit(std::shared_ptr<Context> ctx, std::shared_ptr<pb:
 
   auto tracker = ctx->Tracker();
   if (tracker) {
+    tracker->AddSerializationTime(Helper::TimestampNs() - start_time_ns);
     tracker->SetPrepairCommitTime();
   }
 
@@ -161,6 +203,61 @@ void RaftNode::ResetElectionTimeout(int election_timeout_ms, int max_clock_drift
     election_timeout_ms_ = election_timeout_ms;
     node_->reset_election_timeout_ms(election_timeout_ms, max_clock_drift_ms);
   }
+  hibernated_.store(false);
+}
+
+void RaftNode::CheckHibernate(int election_timeout_ms, int hibernate_election_timeout_ms, int64_t idle_ms) {
+  int64_t now_ms = Helper::TimestampMs();
+  int64_t applied_index = fsm_->GetAppliedIndex();
+  if (hibernate_election_timeout_ms <= election_timeout_ms) {
+    // hibernate is disabled
+    if (hibernated_.load()) {
+      ResetElectionTimeout(election_timeout_ms, 1000);
+    }
+    return;
+  }
+  if (applied_index != last_active_applied_index_ || last_active_time_ms_ == 0) {
+    last_active_applied_index_ = applied_index;
+    last_active_time_ms_ = now_ms;
+    if (hibernated_.load()) {
+      DINGO_LOG(INFO) << fmt::format("[raft.node][node_id({})] wake up from hibernate, applied_index({})", node_id_,
+                                     applied_index);
+      ResetElectionTimeout(election_timeout_ms, 1000);
+    }
+    return;
+  }
+
+  // Follower hibernate before leader, the follower must not timeout by the longer heartbeat interval of leader.
+  // And leaderless region never hibernate, election must go on.
+  if (hibernated_.load() || !HasLeader()) {
+    return;
+  }
+  if (IsLeader()) {
+    idle_ms *= 2;
+  }
+  if (now_ms - last_active_time_ms_ < idle_ms) {
+    return;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.node][node_id({})] hibernate, applied_index({}) election_timeout({})",
+                                 node_id_, applied_index, hibernate_election_timeout_ms);
+  ResetElectionTimeout(hibernate_election_timeout_ms, 1000);
+  hibernated_.store(true);
+
+  // Closed log segments are loaded again on access.
+  if (log_storage_ != nullptr) {
+    log_storage_->UnloadSegments();
+  }
+}
+
+void RaftNode::WakeUp() {
+  if (!hibernated_.load()) {
+    return;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.node][node_id({})] wake up from hibernate by request", node_id_);
+  last_active_time_ms_ = Helper::TimestampMs();
+  ResetElectionTimeout(ConfigHelper::GetElectionTimeout() * 1000, 1000);
 }
 
 void RaftNode::Shutdown(braft::Closure* done) { node_->shutdown(done); }
@@ -227,6 +324,7 @@ std::shared_ptr<pb::common::BRaftStatus> RaftNode::GetStatus() {
   braft_status->set_first_index(status.first_index);
   braft_status->set_last_index(status.last_index);
   braft_status->set_disk_index(status.disk_index);
+  braft_status->set_last_snapshot_index(fsm_->GetLastSnapshotIndex());
 
   auto* stable_follower = braft_status->mutable_stable_followers();
   for (auto [peer_id, peer_status] : status.stable_followers) {
@@ -46,6 +46,9 @@ class RaftNode {
   void Stop();
   void Destroy();
 
+  // The snapshot throttle shared by all regions of the store, nullptr means no throttle.
+  static braft::SnapshotThrottle* GetSharedSnapshotThrottle();
+
   std::string GetRaftGroupName() const { return raft_group_name_; }
   int64_t GetNodeId() const { return node_id_; }
 
@@ -60,6 +63,13 @@ class RaftNode {
   uint32_t ElectionTimeout() const;
   void ResetElectionTimeout(int election_timeout_ms, int max_clock_drift_ms);
 
+  // Enlarge election timeout of region without applied log for idle_ms, the heartbeat interval of braft
+  // is proportional to it, restore to election_timeout_ms when region is active again.
+  void CheckHibernate(int election_timeout_ms, int hibernate_election_timeout_ms, int64_t idle_ms);
+  bool IsHibernated() const { return hibernated_.load(); }
+  // Wake up hibernated region at once, e.g. write or read index.
+  void WakeUp();
+
   void Shutdown(braft::Closure* done);
   void Join();
 
@@ -89,6 +99,11 @@ class RaftNode {
 
   uint32_t election_timeout_ms_;
 
+  // For hibernate, the applied index and time of last activity.
+  int64_t last_active_applied_index_{0};
+  int64_t last_active_time_ms_{0};
+  std::atomic<bool> hibernated_{false};
+
   std::shared_ptr<BaseStateMachine> fsm_;
   std::shared_ptr<SegmentLogStorage> log_storage_;
   std::unique_ptr<braft::Node> node_;
@@ -14,11 +14,21 @@
 
 #include "raft/raft_node_manager.h"
 
+#include "bvar/status.h"
 #include "common/logging.h"
+#include "config/config_helper.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 
 namespace dingodb {
 
+DEFINE_bool(raft_enable_hibernate, false, "enlarge election timeout of idle region to reduce raft heartbeat");
+DEFINE_int32(raft_hibernate_check_interval_s, 5, "check interval seconds of raft hibernate");
+DEFINE_int64(raft_hibernate_idle_time_s, 60, "region without applied log for this time will hibernate");
+DEFINE_int32(raft_hibernate_election_timeout_s, 60, "election timeout seconds of hibernated region");
+
+bvar::Status<int64_t> g_raft_hibernate_region_count("dingo_raft_hibernate_region_count", 0);
+
 RaftNodeManager::RaftNodeManager() { bthread_mutex_init(&mutex_, nullptr); }
 
 RaftNodeManager::~RaftNodeManager() { bthread_mutex_destroy(&mutex_); }
@@ -66,4 +76,22 @@ void RaftNodeManager::DeleteNode(int64_t node_id) {
   nodes_.erase(node_id);
 }
 
+void RaftNodeManager::CheckHibernate() {
+  int election_timeout_ms = ConfigHelper::GetElectionTimeout() * 1000;
+  int hibernate_election_timeout_ms = FLAGS_raft_hibernate_election_timeout_s * 1000;
+  if (!FLAGS_raft_enable_hibernate) {
+    hibernate_election_timeout_ms = 0;
+  }
+
+  int64_t hibernate_count = 0;
+  for (auto& node : GetAllNode()) {
+    node->CheckHibernate(election_timeout_ms, hibernate_election_timeout_ms, FLAGS_raft_hibernate_idle_time_s * 1000);
+    if (node->IsHibernated()) {
+      ++hibernate_count;
+    }
+  }
+
+  g_raft_hibernate_region_count.set_value(hibernate_count);
+}
+
 }  // namespace dingodb
\ No newline at end of file
@@ -39,6 +39,9 @@ class RaftNodeManager {
   void AddNode(int64_t node_id, std::shared_ptr<RaftNode> node);
   void DeleteNode(int64_t node_id);
 
+  // Quiesce heartbeat of idle regions, called periodically.
+  void CheckHibernate();
+
  private:
   bthread_mutex_t mutex_;
 
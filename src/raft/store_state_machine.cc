@@ -14,6 +14,7 @@
 
 #include "raft/store_state_machine.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -21,11 +22,15 @@
 #include "braft/util.h"
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
+#include "bvar/reducer.h"
+#include "common/failpoint.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "handler/raft_apply_handler.h"
 #include "meta/store_meta_manager.h"
 #include "metrics/store_bvar_metrics.h"
 #include "proto/common.pb.h"
@@ -33,11 +38,22 @@
 #include "proto/raft.pb.h"
 #include "raft/dingo_filesystem_adaptor.h"
 #include "server/server.h"
+#include "store/region_hash.h"
 
 const int kSaveAppliedIndexStep = 10;
 
 namespace dingodb {
 
+DEFINE_bool(enable_raft_apply_batch, true, "write consecutive put logs of one apply in one write batch");
+DEFINE_int64(raft_apply_batch_max_kv_count, 4096, "max kv count of one apply write batch");
+DEFINE_int64(raft_apply_arena_block_size, 4096,
+             "start block size of the arena parsing raft log not proposed by self, 0 means not use arena");
+
+DECLARE_bool(raft_apply_disable_wal);
+
+bvar::Adder<int64_t> g_raft_apply_batch_count("dingo_raft_apply_batch_count");
+bvar::Adder<int64_t> g_raft_apply_batch_log_count("dingo_raft_apply_batch_log_count");
+
 StoreStateMachine::StoreStateMachine(std::shared_ptr<RawEngine> engine, store::RegionPtr region,
                                      store::RaftMetaPtr raft_meta, store::RegionMetricsPtr region_metrics,
                                      std::shared_ptr<EventListenerCollection> listeners,
@@ -95,6 +111,9 @@ int StoreStateMachine::DispatchEvent(dingodb::EventType event_type, std::shared_
 void StoreStateMachine::on_apply(braft::Iterator& iter) {
   BAIDU_SCOPED_LOCK(apply_mutex_);
 
+  FAIL_POINT("before_raft_apply");
+
+  ApplyBatch batch;
   for (; iter.valid(); iter.next()) {
     braft::AsyncClosureGuard done_guard(iter.done());
 
@@ -110,22 +129,38 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
     }
 
     // Region is STANDBY state, wait to apply.
+    if (BAIDU_UNLIKELY(region_->State() == pb::common::StoreRegionState::STANDBY)) {
+      FlushApplyBatch(batch);
+    }
     while (region_->State() == pb::common::StoreRegionState::STANDBY) {
       DINGO_LOG(WARNING) << fmt::format("[raft.sm][region({})] region is standby for spliting, waiting...",
                                         region_->Id());
       bthread_usleep(1000 * 1000);
     }
 
-    // Parse raft command
-    auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
+    // Parse raft command, the log proposed by self reuse the request of closure.
+    std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd;
     if (iter.done()) {
       BaseClosure* store_closure = dynamic_cast<BaseClosure*>(iter.done());
       raft_cmd = store_closure->GetRequest();
     } else {
+      raft_cmd = FLAGS_raft_apply_arena_block_size > 0
+                     ? Helper::NewArenaMessage<pb::raft::RaftCmdRequest>(FLAGS_raft_apply_arena_block_size)
+                     : std::make_shared<pb::raft::RaftCmdRequest>();
       butil::IOBufAsZeroCopyInputStream wrapper(iter.data());
       CHECK(raft_cmd->ParseFromZeroCopyStream(&wrapper));
     }
 
+    // Every replica prints an apply span for the sampled log.
+    TraceSpan apply_span;
+    const auto& trace = raft_cmd->header().trace();
+    if (BAIDU_UNLIKELY(trace.sampled() && trace.trace_id() != 0)) {
+      Trace::StartSpan(apply_span, trace.trace_id(), trace.span_id(), "raft_apply", "internal");
+      apply_span.attributes["region_id"] = std::to_string(region_->Id());
+      apply_span.attributes["log_index"] = std::to_string(iter.index());
+      apply_span.attributes["local_proposal"] = ctx != nullptr ? "true" : "false";
+    }
+
     bool need_apply = true;
     // Check region state
     auto region_state = region_->State();
@@ -158,6 +193,41 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
         iter.index(), applied_index_,
         raft_cmd->requests().empty() ? "" : pb::raft::CmdType_Name(raft_cmd->requests().at(0).cmd_type()));
 
+    // Mark the written buckets before apply, checkpoint of region hash only scans them.
+    if (need_apply) {
+      RegionHashManager::GetInstance().MarkDirty(region_->Id(), *raft_cmd);
+    }
+
+    // Put logs are written at the next boundary, e.g. split/merge/delete log, size limit or the end of this apply.
+    if (need_apply && FLAGS_enable_raft_apply_batch && IsBatchable(*raft_cmd)) {
+      for (const auto& req : raft_cmd->requests()) {
+        batch.kv_count += req.put().kvs_size();
+      }
+      batch.raft_cmds.push_back(raft_cmd);
+      batch.ctxs.push_back(ctx);
+      batch.log_ids.push_back(iter.index());
+      batch.trackers.push_back(tracker);
+      if (apply_span.IsSampled()) {
+        batch.trace_spans.push_back(apply_span);
+      }
+      batch.dones.push_back(done_guard.release());
+      batch.last_term = iter.term();
+      batch.last_index = iter.index();
+
+      if (batch.kv_count >= FLAGS_raft_apply_batch_max_kv_count) {
+        FlushApplyBatch(batch);
+      }
+      continue;
+    }
+
+    FlushApplyBatch(batch);
+
+    // The epoch change of region meta is persisted with wal, the data without wal before it must be flushed,
+    // otherwise these logs are replayed after restart and rejected by the new epoch.
+    if (need_apply && FLAGS_raft_apply_disable_wal && IsChangeRegionEpoch(*raft_cmd)) {
+      raw_engine_->FlushAll();
+    }
+
     if (need_apply) {
       // Build event
       auto event = std::make_shared<SmApplyEvent>();
@@ -196,20 +266,114 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
     if (tracker != nullptr) {
       tracker->SetRaftApplyTime();
     }
+    Trace::FinishSpan(apply_span);
 
-    applied_term_ = iter.term();
-    applied_index_ = iter.index();
-    raft_meta_->SetTermAndAppliedId(applied_term_, applied_index_);
+    AdvanceAppliedIndex(iter.term(), iter.index());
 
     // bvar metrics
     StoreBvarMetrics::GetInstance().IncApplyCountPerSecond(str_node_id_);
+  }
 
-    // Persistence applied index
-    // If operation is idempotent, it's ok.
-    // If not, must be stored with the data.
-    if (applied_index_ % kSaveAppliedIndexStep == 0) {
-      Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
+  FlushApplyBatch(batch);
+}
+
+bool StoreStateMachine::IsBatchable(const pb::raft::RaftCmdRequest& raft_cmd) {
+  if (raft_cmd.requests().empty()) {
+    return false;
+  }
+
+  return std::all_of(raft_cmd.requests().begin(), raft_cmd.requests().end(),
+                     [](const pb::raft::Request& req) { return req.cmd_type() == pb::raft::CmdType::PUT; });
+}
+
+bool StoreStateMachine::IsChangeRegionEpoch(const pb::raft::RaftCmdRequest& raft_cmd) {
+  return std::any_of(raft_cmd.requests().begin(), raft_cmd.requests().end(), [](const pb::raft::Request& req) {
+    return req.cmd_type() == pb::raft::CmdType::SPLIT || req.cmd_type() == pb::raft::CmdType::PREPARE_MERGE ||
+           req.cmd_type() == pb::raft::CmdType::COMMIT_MERGE || req.cmd_type() == pb::raft::CmdType::ROLLBACK_MERGE;
+  });
+}
+
+void StoreStateMachine::FlushApplyBatch(ApplyBatch& batch) {
+  if (batch.raft_cmds.empty()) {
+    return;
+  }
+
+  // Persist the applied index in the same write batch.
+  std::shared_ptr<pb::common::KeyValue> raft_meta_kv;
+  if (FLAGS_raft_apply_disable_wal) {
+    raft_meta_kv = Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->GenAppliedRaftMetaKv(
+        region_->Id(), batch.last_term, batch.last_index);
+  }
+
+  auto handle = [this, &batch, raft_meta_kv]() {
+    for (auto& tracker : batch.trackers) {
+      if (tracker != nullptr) {
+        tracker->SetRaftQueueWaitTime();
+      }
     }
+    PutHandler::BatchHandle(batch.raft_cmds, batch.ctxs, batch.log_ids, raft_meta_kv, region_, raw_engine_,
+                            region_metrics_);
+  };
+
+  if (BAIDU_LIKELY(raft_apply_worker_set_ != nullptr)) {
+    // Run in queue, the batch is alive until signaled.
+    auto cond = std::make_shared<BthreadCond>();
+    auto task = std::make_shared<DispatchEventTask>([&handle, cond]() {
+      handle();
+      cond->DecreaseSignal();
+    });
+
+    bool ret = raft_apply_worker_set_->ExecuteRR(task);
+    if (BAIDU_UNLIKELY(!ret)) {
+      DINGO_LOG(FATAL) << fmt::format(
+          "[raft.sm][region({})] execute apply batch task failed, downgrade to in_place execute", region_->Id());
+      handle();
+    } else {
+      cond->IncreaseWait();
+    }
+  } else {
+    handle();
+  }
+
+  for (auto& tracker : batch.trackers) {
+    if (tracker != nullptr) {
+      tracker->SetRaftApplyTime();
+    }
+  }
+  for (auto& trace_span : batch.trace_spans) {
+    Trace::FinishSpan(trace_span);
+  }
+
+  AdvanceAppliedIndex(batch.last_term, batch.last_index);
+
+  // bvar metrics
+  for (size_t i = 0; i < batch.raft_cmds.size(); ++i) {
+    StoreBvarMetrics::GetInstance().IncApplyCountPerSecond(str_node_id_);
+  }
+  g_raft_apply_batch_count << 1;
+  g_raft_apply_batch_log_count << batch.raft_cmds.size();
+
+  for (auto* done : batch.dones) {
+    if (done != nullptr) {
+      braft::run_closure_in_bthread(done);
+    }
+  }
+
+  batch = ApplyBatch();
+}
+
+void StoreStateMachine::AdvanceAppliedIndex(int64_t term, int64_t index) {
+  int64_t prev_applied_index = applied_index_;
+  applied_term_ = term;
+  applied_index_ = index;
+  raft_meta_->SetTermAndAppliedId(applied_term_, applied_index_);
+
+  // Persistence applied index
+  // If operation is idempotent, it's ok.
+  // If not, must be stored with the data.
+  // A write batch may cover more than one step.
+  if (applied_index_ / kSaveAppliedIndexStep != prev_applied_index / kSaveAppliedIndexStep) {
+    Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateAppliedRaftMeta(raft_meta_);
   }
 }
 
@@ -261,7 +425,7 @@ int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>
       StoreBvarMetrics::GetInstance().IncApplyCountPerSecond(str_node_id_);
 
       if (applied_index_ % kSaveAppliedIndexStep == 0) {
-        Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
+        Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateAppliedRaftMeta(raft_meta_);
       }
 
       ++actual_apply_log_count;
@@ -276,6 +440,69 @@ int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>
   return actual_apply_log_count;
 }
 
+bool StoreStateMachine::ApplyLearnerLog(const std::vector<pb::raft::LogEntry>& entries, int64_t end_term,
+                                        int64_t end_index) {
+  BAIDU_SCOPED_LOCK(apply_mutex_);
+
+  for (const auto& entry : entries) {
+    if (entry.index() <= applied_index_) {
+      continue;
+    }
+
+    auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
+    CHECK(raft_cmd->ParsePartialFromArray(entry.data().data(), entry.data().size()));
+
+    if (BAIDU_UNLIKELY(IsChangeRegionEpoch(*raft_cmd))) {
+      DINGO_LOG(INFO) << fmt::format("[raft.sm][region({})] learner stop at log {}:{} cmd_type({})", region_->Id(),
+                                     entry.term(), entry.index(),
+                                     pb::raft::CmdType_Name(raft_cmd->requests().at(0).cmd_type()));
+      return false;
+    }
+
+    // Same check with on_apply, every replica gets the same result.
+    auto region_state = region_->State();
+    bool need_apply = region_state != pb::common::StoreRegionState::DELETING &&
+                      region_state != pb::common::StoreRegionState::DELETED &&
+                      region_state != pb::common::StoreRegionState::TOMBSTONE &&
+                      Helper::IsEqualRegionEpoch(raft_cmd->header().epoch(), region_->Epoch());
+    if (need_apply) {
+      RegionHashManager::GetInstance().MarkDirty(region_->Id(), *raft_cmd);
+
+      auto event = std::make_shared<SmApplyEvent>();
+      event->region = region_;
+      event->engine = raw_engine_;
+      event->raft_cmd = raft_cmd;
+      event->region_metrics = region_metrics_;
+      event->term_id = entry.term();
+      event->log_id = entry.index();
+
+      DispatchEvent(EventType::kSmApply, event);
+    }
+
+    AdvanceAppliedIndex(entry.term(), entry.index());
+
+    // bvar metrics
+    StoreBvarMetrics::GetInstance().IncApplyCountPerSecond(str_node_id_);
+  }
+
+  if (end_index > applied_index_) {
+    AdvanceAppliedIndex(end_term, end_index);
+  }
+
+  return true;
+}
+
+void StoreStateMachine::ResetAppliedIndex(int64_t term, int64_t index) {
+  BAIDU_SCOPED_LOCK(apply_mutex_);
+
+  DINGO_LOG(INFO) << fmt::format("[raft.sm][region({})] reset applied index {}:{} -> {}:{}", region_->Id(),
+                                 applied_term_, applied_index_, term, index);
+  applied_term_ = term;
+  applied_index_ = index;
+  raft_meta_->SetTermAndAppliedId(applied_term_, applied_index_);
+  Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateAppliedRaftMeta(raft_meta_);
+}
+
 std::shared_ptr<SnapshotContext> StoreStateMachine::MakeSnapshotContext() {
   BAIDU_SCOPED_LOCK(apply_mutex_);
 
@@ -377,6 +604,9 @@ int StoreStateMachine::on_snapshot_load(braft::SnapshotReader* reader) {
   }
 
   if (business_meta.log_index() > applied_index_) {
+    // Data is replaced by the snapshot, the hashes of buckets are stale.
+    RegionHashManager::GetInstance().Reset(region_->Id());
+
     auto event = std::make_shared<SmSnapshotLoadEvent>();
     event->engine = raw_engine_;
     event->reader = reader;
@@ -441,6 +671,11 @@ void StoreStateMachine::on_configuration_committed(const braft::Configuration& c
   DINGO_LOG(INFO) << fmt::format("[raft.sm][region({})] on_configuration_committed, peers: {}", region_->Id(),
                                  Helper::FormatPeers(conf));
 
+  // Same as split/merge, flush the data without wal before the conf version change.
+  if (FLAGS_raft_apply_disable_wal) {
+    raw_engine_->FlushAll();
+  }
+
   auto event = std::make_shared<SmConfigurationCommittedEvent>();
   event->node_id = region_->Id();
   event->conf = conf;
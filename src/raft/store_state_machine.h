@@ -20,7 +20,9 @@
 #include <vector>
 
 #include "braft/raft.h"
+#include "common/context.h"
 #include "common/runnable.h"
+#include "common/trace.h"
 #include "engine/raw_engine.h"
 #include "event/event.h"
 #include "meta/store_meta_manager.h"
@@ -77,9 +79,37 @@ class StoreStateMachine : public BaseStateMachine {
 
   int32_t CatchUpApplyLog(const std::vector<pb::raft::LogEntry>& entries);
 
+  // Learner apply the log pulled from voters, the applied index advances to end_index after all entries applied,
+  // the configuration entries are skipped by voters. Stop before the log changing region epoch and return false,
+  // learner bootstraps from voters again after it, e.g. split and merge.
+  bool ApplyLearnerLog(const std::vector<pb::raft::LogEntry>& entries, int64_t end_term, int64_t end_index);
+  // Learner bootstrapped by the data of voter at the applied index.
+  void ResetAppliedIndex(int64_t term, int64_t index);
+
   std::shared_ptr<SnapshotContext> MakeSnapshotContext();
 
  private:
+  // Consecutive put logs of one on_apply, written in one write batch.
+  struct ApplyBatch {
+    std::vector<std::shared_ptr<pb::raft::RaftCmdRequest>> raft_cmds;
+    std::vector<std::shared_ptr<Context>> ctxs;
+    std::vector<int64_t> log_ids;
+    std::vector<TrackerPtr> trackers;
+    // raft apply spans of the sampled logs
+    std::vector<TraceSpan> trace_spans;
+    // run after the batch is written
+    std::vector<google::protobuf::Closure*> dones;
+    int64_t kv_count{0};
+    int64_t last_term{0};
+    int64_t last_index{0};
+  };
+
+  static bool IsBatchable(const pb::raft::RaftCmdRequest& raft_cmd);
+  static bool IsChangeRegionEpoch(const pb::raft::RaftCmdRequest& raft_cmd);
+  void FlushApplyBatch(ApplyBatch& batch);
+
+  void AdvanceAppliedIndex(int64_t term, int64_t index);
+
   int DispatchEvent(dingodb::EventType, std::shared_ptr<dingodb::Event> event);
 
   store::RegionPtr region_;
@@ -20,6 +20,8 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "bthread/mutex.h"
@@ -30,8 +32,11 @@
 #include "common/logging.h"
 #include "coprocessor/coprocessor.h"
 #include "coprocessor/coprocessor_v2.h"
+#include "common/synchronization.h"
 #include "coprocessor/utils.h"
+#include "engine/raw_kv_ttl.h"
 #include "engine/write_data.h"  // IWYU pragma: keep
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "scan/scan_filter.h"
@@ -41,10 +46,16 @@
 
 namespace dingodb {
 
+DEFINE_bool(enable_scan_prefetch, false, "prefetch the next batch of scan in background after a response");
+DEFINE_int64(scan_readahead_size, 0, "readahead bytes of scan iterator for big range, 0 is disable");
+DEFINE_int64(scan_readahead_min_range_size, 64 * 1024 * 1024,
+             "enable readahead if approximate size of scan range reach it");
+
 ScanContext::ScanContext(bvar::LatencyRecorder* scan_latency)
     : region_id_(0),
       max_fetch_cnt_(0),
       key_only_(false),
+      raw_kv_ttl_(false),
       disable_auto_release_(false),
       state_(ScanState::kUninit),
       engine_(nullptr),
@@ -109,12 +120,16 @@ void ScanContext::Close() {
   range_.Clear();
   max_fetch_cnt_ = 0;
   key_only_ = false;
+  raw_kv_ttl_ = false;
   disable_auto_release_ = false;
   state_ = ScanState::kUninit;
   engine_ = nullptr;
   cf_name_.clear();
   iter_ = nullptr;
   last_time_ms_.zero();
+  ++prefetch_seq_;
+  prefetch_ready_ = false;
+  prefetch_kvs_.clear();
   coprocessor_.reset();
   bthread_mutex_destroy(&mutex_);
 }
@@ -141,20 +156,30 @@ butil::Status ScanContext::GetKeyValue(std::vector<pb::common::KeyValue>& kvs, b
   ScanFilter scan_filter = ScanFilter(key_only_, std::min(max_fetch_cnt_, max_fetch_cnt_by_server_), max_bytes_rpc_);
 
   has_more = false;
+  int64_t now_ms = raw_kv_ttl_ ? Helper::TimestampMs() : 0;
   while (iter_->Valid()) {
     pb::common::KeyValue kv;
-    *kv.mutable_key() = iter_->Key();
-    if (!key_only_) {
+    if (raw_kv_ttl_) {
+      // expired kvs are skipped, they are not counted by the limit.
+      std::string_view value;
+      if (!RawKvTtl::DecodeValue(iter_->Value(), now_ms, value)) {
+        iter_->Next();
+        continue;
+      }
+      if (!key_only_) {
+        kv.set_value(value.data(), value.size());
+      }
+    } else if (!key_only_) {
       *kv.mutable_value() = iter_->Value();
     }
+    *kv.mutable_key() = iter_->Key();
 
-    kvs.emplace_back(kv);
-    if (scan_filter.UptoLimit(kv)) {
+    kvs.push_back(std::move(kv));
+    if (scan_filter.UptoLimit(kvs.back())) {
       has_more = true;
       iter_->Next();
       break;
     }
-    kv.Clear();
 
     iter_->Next();
   }
@@ -385,6 +410,7 @@ butil::Status ScanHandler::ScanBegin(std::shared_ptr<ScanContext> context, int64
   context->range_ = range;
   context->max_fetch_cnt_ = max_fetch_cnt;
   context->key_only_ = key_only;
+  context->raw_kv_ttl_ = RawKvTtl::IsEnabled(context->cf_name_, range.start_key());
   context->disable_auto_release_ = disable_auto_release;
 
   // opt if coprocessor all empty. set disable_coprocessor = true
@@ -416,10 +442,23 @@ butil::Status ScanHandler::ScanBegin(std::shared_ptr<ScanContext> context, int64
     }
   }
 
+  // the coprocessor decodes the values without ttl header.
+  if (context->raw_kv_ttl_ && !context->disable_coprocessor_) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Coprocessor is not supported with raw kv ttl");
+  }
+
   auto reader = context->engine_->Reader();
 
   IteratorOptions options;
   options.upper_bound = context->range_.end_key();
+  options.lazy_value = context->key_only_ && context->disable_coprocessor_ && !context->raw_kv_ttl_;
+  if (FLAGS_scan_readahead_size > 0) {
+    std::vector<pb::common::Range> ranges = {context->range_};
+    auto sizes = context->engine_->GetApproximateSizes(context->cf_name_, ranges);
+    if (!sizes.empty() && sizes[0] >= FLAGS_scan_readahead_min_range_size) {
+      options.readahead_size = FLAGS_scan_readahead_size;
+    }
+  }
 
   context->iter_ = reader->NewIterator(context->cf_name_, options);
   if (!context->iter_) {
@@ -442,6 +481,9 @@ butil::Status ScanHandler::ScanBegin(std::shared_ptr<ScanContext> context, int64
     context->seek_state_ = ScanContext::SeekState::kInitted;
 #endif
 
+    if (has_more) {
+      StartPrefetch(context);
+    }
   }
 #if defined(ENABLE_SCAN_OPTIMIZATION)
   else {  // NOLINT
@@ -498,7 +540,17 @@ butil::Status ScanHandler::ScanContinue(std::shared_ptr<ScanContext> context, co
 
   context->state_ = ScanState::kContinuing;
 
-  s = context->GetKeyValue(*kvs, has_more);
+  if (context->prefetch_ready_) {
+    // the iterator is already after the prefetched batch, so it is returned even if max_fetch_cnt changed.
+    context->prefetch_ready_ = false;
+    s = context->prefetch_status_;
+    kvs->swap(context->prefetch_kvs_);
+    context->prefetch_kvs_.clear();
+    has_more = context->prefetch_has_more_;
+  } else {
+    ++context->prefetch_seq_;
+    s = context->GetKeyValue(*kvs, has_more);
+  }
   if (!s.ok()) {
     context->state_ = ScanState::kError;
     DINGO_LOG(ERROR) << fmt::format("ScanContext::GetKeyValue failed");
@@ -508,9 +560,35 @@ butil::Status ScanHandler::ScanContinue(std::shared_ptr<ScanContext> context, co
   context->state_ = ScanState::kContinued;
   context->last_time_ms_ = context->GetCurrentTime();
 
+  if (has_more) {
+    StartPrefetch(context);
+  }
+
   return butil::Status();
 }
 
+void ScanHandler::StartPrefetch(std::shared_ptr<ScanContext> context) {
+  if (!FLAGS_enable_scan_prefetch || context->prefetch_ready_) {
+    return;
+  }
+
+  uint64_t seq = ++context->prefetch_seq_;
+  Bthread bth(&BTHREAD_ATTR_NORMAL);
+  bth.Run([context, seq]() {
+    BAIDU_SCOPED_LOCK(context->mutex_);
+    // canceled by a continue or release which came first
+    if (seq != context->prefetch_seq_ ||
+        (ScanState::kContinued != context->state_ && ScanState::kBegun != context->state_)) {
+      return;
+    }
+
+    context->prefetch_kvs_.clear();
+    context->prefetch_has_more_ = false;
+    context->prefetch_status_ = context->GetKeyValue(context->prefetch_kvs_, context->prefetch_has_more_);
+    context->prefetch_ready_ = true;
+  });
+}
+
 butil::Status ScanHandler::ScanRelease(std::shared_ptr<ScanContext> context,
                                        [[maybe_unused]] const std::string& scan_id) {
   if (BAIDU_UNLIKELY(scan_id.empty() || scan_id != context->scan_id_)) {
@@ -543,6 +621,10 @@ butil::Status ScanHandler::ScanRelease(std::shared_ptr<ScanContext> context,
 
   context->state_ = ScanState::kReleasing;
 
+  ++context->prefetch_seq_;
+  context->prefetch_ready_ = false;
+  context->prefetch_kvs_.clear();
+
   if (!context->disable_auto_release_) {
     context->state_ = ScanState::kAllowImmediateRecycling;
   } else {
@@ -99,6 +99,9 @@ class ScanContext {
 
   bool key_only_;
 
+  // the values have ttl header
+  bool raw_kv_ttl_;
+
   bool disable_auto_release_;
 
   ScanState state_;
@@ -128,6 +131,14 @@ class ScanContext {
 
   bool disable_coprocessor_;
 
+  // The next batch prefetched in background after a response, at most one batch is buffered.
+  // prefetch_seq_ is increased to cancel the prefetch not started yet.
+  uint64_t prefetch_seq_{0};
+  bool prefetch_ready_{false};
+  butil::Status prefetch_status_;
+  std::vector<pb::common::KeyValue> prefetch_kvs_;
+  bool prefetch_has_more_{false};
+
   // coprocessor
   std::shared_ptr<RawCoprocessor> coprocessor_;
 
@@ -184,6 +195,11 @@ class ScanHandler {
                                     int64_t max_fetch_cnt, std::vector<pb::common::KeyValue>* kvs, bool& has_more);
 
   static butil::Status ScanRelease(std::shared_ptr<ScanContext> context, [[maybe_unused]] const std::string& scan_id);
+
+ private:
+  // Prefetch the next batch in background, overlap the engine read with the network transfer of current batch.
+  // Caller must hold the mutex of context.
+  static void StartPrefetch(std::shared_ptr<ScanContext> context);
 };
 
 }  // namespace dingodb
@@ -14,10 +14,13 @@
 #include "scan/scan_manager.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "butil/guid.h"
 #include "common/constant.h"
 #include "common/logging.h"
+#include "common/memory_tracker.h"
 #include "fmt/core.h"
 
 namespace dingodb {
@@ -54,9 +57,11 @@ void RawScanManager::TryDeleteScan(int64_t scan_id) {}
 
 ScanManager::ScanManager()
     : bvar_scan_v1_object_running_num_("dingo_scan_v1_object_running_num"),
-      bvar_scan_v1_object_total_num_("dingo_scan_v1_object_total_num") {}
+      bvar_scan_v1_object_total_num_("dingo_scan_v1_object_total_num") {
+  alive_scans_.Init(Constant::kScanManagerInitCapacity);
+}
 ScanManager::~ScanManager() {
-  alive_scans_.clear();
+  alive_scans_.Clear();
   waiting_destroyed_scans_.clear();
 }
 
@@ -104,7 +109,7 @@ std::shared_ptr<ScanContext> ScanManager::CreateScan(std::string* scan_id) {
     // retry
     if (!scan_id->empty()) {
       // carefully consider. whether the test is repeated
-      if (auto iter = alive_scans_.find(*scan_id); iter == alive_scans_.end()) {
+      if (!alive_scans_.Exists(*scan_id)) {
         break;
       }
     }
@@ -112,44 +117,36 @@ std::shared_ptr<ScanContext> ScanManager::CreateScan(std::string* scan_id) {
 
   auto scan = std::make_shared<ScanContextV1>(ScanContextV1::GetScanLatency());
   scan->Init(timeout_ms, max_bytes_rpc, max_fetch_cnt_by_server);
-  alive_scans_[*scan_id] = scan;
+  alive_scans_.Put(*scan_id, scan);
   bvar_scan_v1_object_running_num_ << 1;
+  // Every scan holds at most max_bytes_rpc of kvs.
+  MemoryTracker::GetInstance().Add(MemoryTracker::Type::kScanContext, max_bytes_rpc);
   bvar_scan_v1_object_total_num_ << 1;
 
   return scan;
 }
 
 std::shared_ptr<ScanContext> ScanManager::FindScan(const std::string& scan_id) {
-  BAIDU_SCOPED_LOCK(mutex);
-  auto iter = alive_scans_.find(scan_id);
-  if (iter != alive_scans_.end()) {
-    return iter->second;
-  }
-  return nullptr;
+  // read from the sharded safe map, no need to hold mutex
+  return alive_scans_.Get(scan_id);
 }
 
 void ScanManager::DeleteScan(const std::string& scan_id) {
   BAIDU_SCOPED_LOCK(mutex);
-  auto iter = alive_scans_.find(scan_id);
-  if (iter != alive_scans_.end()) {
-    // free memory directly
-    iter->second.reset();
-    alive_scans_.erase(iter);
+  if (alive_scans_.Exists(scan_id)) {
+    alive_scans_.Erase(scan_id);
     bvar_scan_v1_object_running_num_ << -1;
-    return;
+    MemoryTracker::GetInstance().Add(MemoryTracker::Type::kScanContext, -max_bytes_rpc);
   }
 }
 
 void ScanManager::TryDeleteScan(const std::string& scan_id) {
   BAIDU_SCOPED_LOCK(mutex);
-  auto iter = alive_scans_.find(scan_id);
-  if (iter != alive_scans_.end()) {
-    if (iter->second->IsRecyclable()) {
-      // free memory directly
-      iter->second.reset();
-      alive_scans_.erase(iter);
-      bvar_scan_v1_object_running_num_ << -1;
-    }
+  auto scan = alive_scans_.Get(scan_id);
+  if (scan != nullptr && scan->IsRecyclable()) {
+    alive_scans_.Erase(scan_id);
+    bvar_scan_v1_object_running_num_ << -1;
+    MemoryTracker::GetInstance().Add(MemoryTracker::Type::kScanContext, -max_bytes_rpc);
   }
 }
 
@@ -167,23 +164,25 @@ void ScanManager::RegularCleaningHandler(void*) {
   ScanManager& manager = ScanManager::GetInstance();
 
   BAIDU_SCOPED_LOCK(manager.mutex);
-  for (auto iter = manager.alive_scans_.begin(); iter != manager.alive_scans_.end();) {
-    if (iter->second->IsRecyclable()) {
-      manager.waiting_destroyed_scans_[iter->first] = iter->second;
-      manager.alive_scans_.erase(iter++);
-      manager.bvar_scan_v1_object_running_num_ << -1;
-    } else {
-      iter++;
-    }
+  std::vector<std::string> scan_ids;
+  manager.alive_scans_.GetAllKeyValues(scan_ids, manager.waiting_destroyed_scans_,
+                                       [](std::shared_ptr<ScanContext> scan) { return scan->IsRecyclable(); });
+  if (!scan_ids.empty()) {
+    manager.alive_scans_.MultiErase(scan_ids);
+    manager.bvar_scan_v1_object_running_num_ << -static_cast<int64_t>(scan_ids.size());
+    MemoryTracker::GetInstance().Add(MemoryTracker::Type::kScanContext,
+                                     -manager.max_bytes_rpc * static_cast<int64_t>(scan_ids.size()));
   }
   manager.waiting_destroyed_scans_.clear();
 }
 
 ScanManagerV2::ScanManagerV2()
     : bvar_scan_v2_object_running_num_("dingo_scan_v2_object_running_num"),
-      bvar_scan_v2_object_total_num_("dingo_scan_v2_object_total_num") {}
+      bvar_scan_v2_object_total_num_("dingo_scan_v2_object_total_num") {
+  alive_scans_.Init(Constant::kScanManagerInitCapacity);
+}
 ScanManagerV2::~ScanManagerV2() {
-  alive_scans_.clear();
+  alive_scans_.Clear();
   waiting_destroyed_scans_.clear();
 }
 
@@ -225,52 +224,43 @@ bool ScanManagerV2::Init(std::shared_ptr<Config> config) {
 std::shared_ptr<ScanContext> ScanManagerV2::CreateScan(int64_t scan_id) {
   BAIDU_SCOPED_LOCK(mutex);
 
-  auto iter = alive_scans_.find(scan_id);
-  if (iter != alive_scans_.end()) {
+  if (alive_scans_.Exists(scan_id)) {
     DINGO_LOG(ERROR) << fmt::format("ScanManagerV2::CreateScan failed,  exist same scan_id : {}", scan_id);
     return nullptr;
   }
 
   auto scan = std::make_shared<ScanContextV2>(ScanContextV2::GetScanLatency());
   scan->Init(timeout_ms, max_bytes_rpc, max_fetch_cnt_by_server);
-  alive_scans_[scan_id] = scan;
+  alive_scans_.Put(scan_id, scan);
   bvar_scan_v2_object_running_num_ << 1;
+  // Every scan holds at most max_bytes_rpc of kvs.
+  MemoryTracker::GetInstance().Add(MemoryTracker::Type::kScanContext, max_bytes_rpc);
   bvar_scan_v2_object_total_num_ << 1;
 
   return scan;
 }
 
 std::shared_ptr<ScanContext> ScanManagerV2::FindScan(int64_t scan_id) {
-  BAIDU_SCOPED_LOCK(mutex);
-  auto iter = alive_scans_.find(scan_id);
-  if (iter != alive_scans_.end()) {
-    return iter->second;
-  }
-  return nullptr;
+  // read from the sharded safe map, no need to hold mutex
+  return alive_scans_.Get(scan_id);
 }
 
 void ScanManagerV2::DeleteScan(int64_t scan_id) {
   BAIDU_SCOPED_LOCK(mutex);
-  auto iter = alive_scans_.find(scan_id);
-  if (iter != alive_scans_.end()) {
-    // free memory directly
-    iter->second.reset();
-    alive_scans_.erase(iter);
+  if (alive_scans_.Exists(scan_id)) {
+    alive_scans_.Erase(scan_id);
     bvar_scan_v2_object_running_num_ << -1;
-    return;
+    MemoryTracker::GetInstance().Add(MemoryTracker::Type::kScanContext, -max_bytes_rpc);
   }
 }
 
 void ScanManagerV2::TryDeleteScan(int64_t scan_id) {
   BAIDU_SCOPED_LOCK(mutex);
-  auto iter = alive_scans_.find(scan_id);
-  if (iter != alive_scans_.end()) {
-    if (iter->second->IsRecyclable()) {
-      // free memory directly
-      iter->second.reset();
-      alive_scans_.erase(iter);
-      bvar_scan_v2_object_running_num_ << -1;
-    }
+  auto scan = alive_scans_.Get(scan_id);
+  if (scan != nullptr && scan->IsRecyclable()) {
+    alive_scans_.Erase(scan_id);
+    bvar_scan_v2_object_running_num_ << -1;
+    MemoryTracker::GetInstance().Add(MemoryTracker::Type::kScanContext, -max_bytes_rpc);
   }
 }
 
@@ -288,14 +278,14 @@ void ScanManagerV2::RegularCleaningHandler(void* /*arg*/) {
   ScanManagerV2& manager = ScanManagerV2::GetInstance();
 
   BAIDU_SCOPED_LOCK(manager.mutex);
-  for (auto iter = manager.alive_scans_.begin(); iter != manager.alive_scans_.end();) {
-    if (iter->second->IsRecyclable()) {
-      manager.waiting_destroyed_scans_[iter->first] = iter->second;
-      manager.alive_scans_.erase(iter++);
-      manager.bvar_scan_v2_object_running_num_ << -1;
-    } else {
-      iter++;
-    }
+  std::vector<int64_t> scan_ids;
+  manager.alive_scans_.GetAllKeyValues(scan_ids, manager.waiting_destroyed_scans_,
+                                       [](std::shared_ptr<ScanContext> scan) { return scan->IsRecyclable(); });
+  if (!scan_ids.empty()) {
+    manager.alive_scans_.MultiErase(scan_ids);
+    manager.bvar_scan_v2_object_running_num_ << -static_cast<int64_t>(scan_ids.size());
+    MemoryTracker::GetInstance().Add(MemoryTracker::Type::kScanContext,
+                                     -manager.max_bytes_rpc * static_cast<int64_t>(scan_ids.size()));
   }
   manager.waiting_destroyed_scans_.clear();
 }
@@ -18,7 +18,9 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "common/safe_map.h"
 #include "scan/scan.h"
 
 namespace dingodb {
@@ -95,8 +97,9 @@ class ScanManager : public RawScanManager, public RawScanManagerSingleton<ScanMa
   ~ScanManager() override;
 
  private:
-  std::map<std::string, std::shared_ptr<ScanContext>> alive_scans_;
-  std::map<std::string, std::shared_ptr<ScanContext>> waiting_destroyed_scans_;
+  // FindScan is lock free, mutex only serializes create and delete.
+  DingoShardedSafeMap<std::string, std::shared_ptr<ScanContext>> alive_scans_;
+  std::vector<std::shared_ptr<ScanContext>> waiting_destroyed_scans_;
   bvar::Adder<uint64_t> bvar_scan_v1_object_running_num_;
   bvar::Adder<uint64_t> bvar_scan_v1_object_total_num_;
 };
@@ -121,8 +124,9 @@ class ScanManagerV2 : public RawScanManager, public RawScanManagerSingleton<Scan
   ~ScanManagerV2() override;
 
  private:
-  std::map<int64_t, std::shared_ptr<ScanContext>> alive_scans_;
-  std::map<int64_t, std::shared_ptr<ScanContext>> waiting_destroyed_scans_;
+  // FindScan is lock free, mutex only serializes create and delete.
+  DingoShardedSafeMap<int64_t, std::shared_ptr<ScanContext>> alive_scans_;
+  std::vector<std::shared_ptr<ScanContext>> waiting_destroyed_scans_;
   bvar::Adder<uint64_t> bvar_scan_v2_object_running_num_;
   bvar::Adder<uint64_t> bvar_scan_v2_object_total_num_;
 };
@@ -0,0 +1,169 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "scan/scan_stream.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/iobuf.h"
+#include "butil/time.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/synchronization.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "scan/scan.h"
+#include "scan/scan_manager.h"
+
+namespace dingodb {
+
+DEFINE_int64(scan_stream_max_buf_size, 4 * 1024 * 1024, "flow control window bytes of scan stream");
+DEFINE_int64(scan_stream_write_timeout_ms, 60000, "scan stream is closed if not writable in the time");
+
+class ScanStream::Handler : public brpc::StreamInputHandler {
+ public:
+  explicit Handler(TaskPtr task) : task_(task) {}
+
+  int on_received_messages(brpc::StreamId /*id*/, butil::IOBuf* const /*messages*/[], size_t /*size*/) override {
+    return 0;
+  }
+
+  void on_idle_timeout(brpc::StreamId /*id*/) override {}
+
+  void on_closed(brpc::StreamId /*id*/) override {
+    task_->closed.store(true, std::memory_order_relaxed);
+    delete this;
+  }
+
+ private:
+  TaskPtr task_;
+};
+
+butil::Status ScanStream::Start(int64_t scan_id, int64_t max_fetch_cnt, brpc::Controller* cntl) {
+  if (ScanManagerV2::GetInstance().FindScan(scan_id) == nullptr) {
+    std::string s = fmt::format("scan_id: {} not found", scan_id);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::ESCAN_NOTFOUND, s);
+  }
+
+  auto task = std::make_shared<Task>();
+  task->scan_id = scan_id;
+  task->max_fetch_cnt = max_fetch_cnt;
+
+  auto* handler = new Handler(task);
+  brpc::StreamOptions options;
+  options.handler = handler;
+  options.max_buf_size = FLAGS_scan_stream_max_buf_size;
+  if (brpc::StreamAccept(&task->stream_id, *cntl, &options) != 0) {
+    delete handler;
+    DINGO_LOG(ERROR) << fmt::format("[scan_stream][scan_id({})] accept stream failed.", scan_id);
+    return butil::Status(pb::error::EINTERNAL, "accept stream failed");
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[scan_stream][scan_id({})] start, stream_id: {} max_fetch_cnt: {}", scan_id,
+                                 task->stream_id, max_fetch_cnt);
+
+  // the stream is usable after the response of the rpc is sent.
+  Bthread bth(&BTHREAD_ATTR_NORMAL);
+  bth.Run([task]() { Run(task); });
+
+  return butil::Status();
+}
+
+void ScanStream::Run(TaskPtr task) {
+  auto& manager = ScanManagerV2::GetInstance();
+  bool failed = false;
+  int64_t send_count = 0;
+  int64_t start_time = Helper::TimestampMs();
+
+  while (!task->closed.load(std::memory_order_relaxed)) {
+    pb::store::KvScanContinueResponseV2 response;
+    std::vector<pb::common::KeyValue> kvs;
+    bool has_more = false;
+
+    butil::Status status;
+    auto scan = manager.FindScan(task->scan_id);
+    if (scan == nullptr) {
+      status = butil::Status(pb::error::ESCAN_NOTFOUND, fmt::format("scan_id: {} not found", task->scan_id));
+    } else {
+      status = ScanHandler::ScanContinue(scan, std::to_string(task->scan_id), task->max_fetch_cnt, &kvs, has_more);
+    }
+
+    if (!status.ok()) {
+      failed = true;
+      response.mutable_error()->set_errcode(static_cast<pb::error::Errno>(status.error_code()));
+      response.mutable_error()->set_errmsg(status.error_str());
+      Write(task, response);
+      break;
+    }
+
+    send_count += kvs.size();
+    Helper::VectorToPbRepeated(kvs, response.mutable_kvs());
+    response.set_has_more(has_more);
+    if (!Write(task, response)) {
+      failed = true;
+      break;
+    }
+
+    if (!has_more) {
+      break;
+    }
+  }
+
+  brpc::StreamClose(task->stream_id);
+
+  if (failed) {
+    manager.DeleteScan(task->scan_id);
+  } else {
+    manager.TryDeleteScan(task->scan_id);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[scan_stream][scan_id({})] finish, failed: {} closed: {} kvs: {} elapsed time {}ms",
+                                 task->scan_id, failed, task->closed.load(), send_count,
+                                 Helper::TimestampMs() - start_time);
+}
+
+bool ScanStream::Write(TaskPtr task, const pb::store::KvScanContinueResponseV2& response) {
+  butil::IOBuf buf;
+  butil::IOBufAsZeroCopyOutputStream wrapper(&buf);
+  response.SerializeToZeroCopyStream(&wrapper);
+
+  for (;;) {
+    int ret = brpc::StreamWrite(task->stream_id, buf);
+    if (ret == 0) {
+      return true;
+    }
+    if (ret != EAGAIN || task->closed.load(std::memory_order_relaxed)) {
+      DINGO_LOG(WARNING) << fmt::format("[scan_stream][scan_id({})] write stream failed, ret: {}", task->scan_id, ret);
+      return false;
+    }
+
+    // the window is full, wait the client consume.
+    timespec due_time = butil::milliseconds_from_now(FLAGS_scan_stream_write_timeout_ms);
+    ret = brpc::StreamWait(task->stream_id, &due_time);
+    if (ret != 0) {
+      DINGO_LOG(WARNING) << fmt::format("[scan_stream][scan_id({})] wait stream writable failed, ret: {}",
+                                        task->scan_id, ret);
+      return false;
+    }
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,58 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_SCAN_SCAN_STREAM_H_  // NOLINT
+#define DINGODB_SCAN_SCAN_STREAM_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "brpc/controller.h"
+#include "brpc/stream.h"
+#include "butil/status.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+// Push the results of a scan v2 to the client by brpc stream.
+// The scan keeps running in a background bthread, every KvScanContinueResponseV2 of max_fetch_cnt kvs is written
+// to the stream as soon as it is ready, the stream buffer size is the flow control window. The stream is closed
+// by the server after the last response (has_more is false) or an error response.
+class ScanStream {
+ public:
+  // The client must create the brpc stream with the request.
+  static butil::Status Start(int64_t scan_id, int64_t max_fetch_cnt, brpc::Controller* cntl);
+
+ private:
+  struct Task {
+    int64_t scan_id{0};
+    int64_t max_fetch_cnt{0};
+    brpc::StreamId stream_id{brpc::INVALID_STREAM_ID};
+    // set when the stream is closed by the client
+    std::atomic<bool> closed{false};
+  };
+  using TaskPtr = std::shared_ptr<Task>;
+
+  class Handler;
+
+  static void Run(TaskPtr task);
+  // Write the response, wait the stream writable if the window is full.
+  static bool Write(TaskPtr task, const pb::store::KvScanContinueResponseV2& response);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_SCAN_SCAN_STREAM_H_  // NOLINT
@@ -23,26 +23,11 @@
 namespace dingodb {
 namespace sdk {
 
-AdminTool::AdminTool(std::shared_ptr<CoordinatorProxy> coordinator_proxy) : coordinator_proxy_(coordinator_proxy) {}
-
-Status AdminTool::GetCurrentTsoTimeStamp(pb::meta::TsoTimestamp& timestamp) {
-  pb::meta::TsoRequest request;
-  pb::meta::TsoResponse response;
-
-  request.set_op_type(pb::meta::TsoOpType::OP_GEN_TSO);
-  request.set_count(1);
-
-  auto status = coordinator_proxy_->TsoService(request, response);
-  if (!status.IsOK()) {
-    DINGO_LOG(WARNING) << "Fail tsoService request fail, status:" << status.ToString()
-                       << ", response:" << response.DebugString();
-  } else {
-    CHECK(response.has_start_timestamp());
-    timestamp = response.start_timestamp();
-    DINGO_LOG(DEBUG) << "tso timestamp: " << timestamp.DebugString();
-  }
+AdminTool::AdminTool(std::shared_ptr<CoordinatorProxy> coordinator_proxy)
+    : coordinator_proxy_(coordinator_proxy), tso_provider_(new TsoProvider(coordinator_proxy)) {}
 
-  return status;
+Status AdminTool::GetCurrentTsoTimeStamp(pb::meta::TsoTimestamp& timestamp, bool allow_prefetched) {
+  return tso_provider_->GenTso(timestamp, allow_prefetched);
 }
 
 Status AdminTool::GetCurrentTimeStamp(int64_t& timestamp) {
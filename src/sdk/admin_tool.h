@@ -15,8 +15,11 @@
 #ifndef DINGODB_SDK_ADMIN_TOOL_H_
 #define DINGODB_SDK_ADMIN_TOOL_H_
 
+#include <memory>
+
 #include "sdk/coordinator_proxy.h"
 #include "sdk/status.h"
+#include "sdk/tso_provider.h"
 
 namespace dingodb {
 namespace sdk {
@@ -30,7 +33,8 @@ class AdminTool {
 
   ~AdminTool() = default;
 
-  Status GetCurrentTsoTimeStamp(pb::meta::TsoTimestamp& tso_timestamp);
+  // allow_prefetched: see TsoProvider::GenTso
+  Status GetCurrentTsoTimeStamp(pb::meta::TsoTimestamp& tso_timestamp, bool allow_prefetched = false);
 
   Status GetCurrentTimeStamp(int64_t& timestamp);
 
@@ -44,6 +48,7 @@ class AdminTool {
 
  private:
   std::shared_ptr<CoordinatorProxy> coordinator_proxy_;
+  std::unique_ptr<TsoProvider> tso_provider_;
 };
 
 }  // namespace sdk
@@ -40,12 +40,15 @@
 #include "sdk/rawkv/raw_kv_delete_task.h"
 #include "sdk/rawkv/raw_kv_get_task.h"
 #include "sdk/rawkv/raw_kv_internal_data.h"
+#include "sdk/rawkv/raw_kv_parallel_delete_range_task.h"
+#include "sdk/rawkv/raw_kv_parallel_scan_task.h"
 #include "sdk/rawkv/raw_kv_put_if_absent_task.h"
 #include "sdk/rawkv/raw_kv_put_task.h"
 #include "sdk/rawkv/raw_kv_scan_task.h"
 #include "sdk/region_creator_internal_data.h"
 #include "sdk/status.h"
 #include "sdk/transaction/txn_impl.h"
+#include "sdk/utils/async_util.h"
 #include "sdk/vector.h"
 #include "sdk/vector/vector_index_cache.h"
 #include "sdk/vector/vector_index_creator_internal_data.h"
@@ -120,6 +123,18 @@ Status Client::DropRegion(int64_t region_id) {
   return data_->stub->GetAdminTool()->DropRegion(region_id);
 }
 
+Status Client::WarmUp(const std::string& start_key, const std::string& end_key) {
+  if (start_key.empty() || end_key.empty()) {
+    return Status::InvalidArgument("start_key and end_key must not empty, check params");
+  }
+
+  if (start_key >= end_key) {
+    return Status::InvalidArgument("end_key must greater than start_key, check params");
+  }
+
+  return data_->stub->GetMetaCache()->WarmUp(start_key, end_key);
+}
+
 Status Client::NewVectorClient(VectorClient** client) {
   *client = new VectorClient(*data_->stub);
   return Status::OK();
@@ -154,6 +169,10 @@ RawKV::RawKV(Data* data) : data_(data) {}
 RawKV::~RawKV() { delete data_; }
 
 Status RawKV::Get(const std::string& key, std::string& out_value) {
+  if (FLAGS_enable_raw_kv_coalesce && data_->stub.GetRawKvCoalescer()->TryGet(key, out_value)) {
+    return Status::OK();
+  }
+
   RawKvGetTask task(data_->stub, key, out_value);
   return task.Run();
 }
@@ -164,6 +183,10 @@ Status RawKV::BatchGet(const std::vector<std::string>& keys, std::vector<KVPair>
 }
 
 Status RawKV::Put(const std::string& key, const std::string& value) {
+  if (FLAGS_enable_raw_kv_coalesce && data_->stub.GetRawKvCoalescer()->TryPut(key, value)) {
+    return Status::OK();
+  }
+
   RawKvPutTask task(data_->stub, key, value);
   return task.Run();
 }
@@ -193,6 +216,30 @@ Status RawKV::BatchDelete(const std::vector<std::string>& keys) {
   return task.Run();
 }
 
+void RawKV::AsyncGet(const std::string& key, std::string& out_value, StatusCallback cb) {
+  AsyncRunTask(new RawKvGetTask(data_->stub, key, out_value), std::move(cb));
+}
+
+void RawKV::AsyncBatchGet(const std::vector<std::string>& keys, std::vector<KVPair>& out_kvs, StatusCallback cb) {
+  AsyncRunTask(new RawKvBatchGetTask(data_->stub, keys, out_kvs), std::move(cb));
+}
+
+void RawKV::AsyncPut(const std::string& key, const std::string& value, StatusCallback cb) {
+  AsyncRunTask(new RawKvPutTask(data_->stub, key, value), std::move(cb));
+}
+
+void RawKV::AsyncBatchPut(const std::vector<KVPair>& kvs, StatusCallback cb) {
+  AsyncRunTask(new RawKvBatchPutTask(data_->stub, kvs), std::move(cb));
+}
+
+void RawKV::AsyncDelete(const std::string& key, StatusCallback cb) {
+  AsyncRunTask(new RawKvDeleteTask(data_->stub, key), std::move(cb));
+}
+
+void RawKV::AsyncBatchDelete(const std::vector<std::string>& keys, StatusCallback cb) {
+  AsyncRunTask(new RawKvBatchDeleteTask(data_->stub, keys), std::move(cb));
+}
+
 Status RawKV::DeleteRangeNonContinuous(const std::string& start_key, const std::string& end_key,
                                        int64_t& out_delete_count) {
   if (start_key.empty() || end_key.empty()) {
@@ -203,6 +250,11 @@ Status RawKV::DeleteRangeNonContinuous(const std::string& start_key, const std::
     return Status::InvalidArgument("end_key must greater than start_key, check params");
   }
 
+  if (FLAGS_raw_kv_delete_range_parallel_regions > 1) {
+    RawKvParallelDeleteRangeTask task(data_->stub, start_key, end_key, false, out_delete_count);
+    return task.Run();
+  }
+
   RawKvDeleteRangeTask task(data_->stub, start_key, end_key, false, out_delete_count);
   return task.Run();
 }
@@ -216,6 +268,11 @@ Status RawKV::DeleteRange(const std::string& start_key, const std::string& end_k
     return Status::InvalidArgument("end_key must greater than start_key, check params");
   }
 
+  if (FLAGS_raw_kv_delete_range_parallel_regions > 1) {
+    RawKvParallelDeleteRangeTask task(data_->stub, start_key, end_key, true, out_delete_count);
+    return task.Run();
+  }
+
   RawKvDeleteRangeTask task(data_->stub, start_key, end_key, true, out_delete_count);
   return task.Run();
 }
@@ -246,6 +303,11 @@ Status RawKV::Scan(const std::string& start_key, const std::string& end_key, uin
     return Status::InvalidArgument("end_key must greater than start_key, check params");
   }
 
+  if (FLAGS_raw_kv_scan_parallel_regions > 1) {
+    RawKvParallelScanTask task(data_->stub, start_key, end_key, limit, kvs);
+    return task.Run();
+  }
+
   RawKvScanTask task(data_->stub, start_key, end_key, limit, kvs);
   return task.Run();
 }
@@ -262,6 +324,8 @@ Status Transaction::BatchGet(const std::vector<std::string>& keys, std::vector<K
   return impl_->BatchGet(keys, kvs);
 }
 
+Status Transaction::Prefetch(const std::vector<std::string>& keys) { return impl_->Prefetch(keys); }
+
 Status Transaction::Put(const std::string& key, const std::string& value) { return impl_->Put(key, value); }
 
 Status Transaction::BatchPut(const std::vector<KVPair>& kvs) { return impl_->BatchPut(kvs); }
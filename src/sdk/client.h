@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "sdk/status.h"
+#include "sdk/utils/callback.h"
 #include "sdk/vector.h"
 
 namespace dingodb {
@@ -61,6 +62,9 @@ class Client {
 
   Status DropRegion(int64_t region_id);
 
+  // Preload the routes of all regions between [start_key, end_key), e.g. the range of a table before traffic starts.
+  Status WarmUp(const std::string& start_key, const std::string& end_key);
+
   // NOTE:: Caller must delete *client when it is no longer needed.
   Status NewVectorClient(VectorClient** client);
 
@@ -140,6 +144,20 @@ class RawKV {
   // limit: 0 means no limit, will scan all key in [start_key, end_key)
   Status Scan(const std::string& start_key, const std::string& end_key, uint64_t limit, std::vector<KVPair>& out_kvs);
 
+  // Non-blocking variants, cb is called in sdk thread when the operation is done.
+  // NOTE: The params and out params are referenced until cb is called, caller must keep them valid.
+  void AsyncGet(const std::string& key, std::string& out_value, StatusCallback cb);
+
+  void AsyncBatchGet(const std::vector<std::string>& keys, std::vector<KVPair>& out_kvs, StatusCallback cb);
+
+  void AsyncPut(const std::string& key, const std::string& value, StatusCallback cb);
+
+  void AsyncBatchPut(const std::vector<KVPair>& kvs, StatusCallback cb);
+
+  void AsyncDelete(const std::string& key, StatusCallback cb);
+
+  void AsyncBatchDelete(const std::vector<std::string>& keys, StatusCallback cb);
+
  private:
   friend class Client;
 
@@ -158,6 +176,9 @@ struct TransactionOptions {
   TransactionKind kind;
   TransactionIsolation isolation;
   uint32_t keep_alive_ms;
+  // Read only txn reads the data of stale_read_ms ago, the reads can be served by any replica, 0 means disable.
+  // Only for snapshot isolation, the txn can't write.
+  uint32_t stale_read_ms{0};
 };
 
 class Transaction {
@@ -171,6 +192,10 @@ class Transaction {
 
   Status BatchGet(const std::vector<std::string>& keys, std::vector<KVPair>& kvs);
 
+  // Read keys by one batch get rpc per region and cache them in txn, later Get and BatchGet of the keys don't
+  // send rpc. Only snapshot isolation txn caches reads, it's a no-op for read committed txn.
+  Status Prefetch(const std::vector<std::string>& keys);
+
   Status Put(const std::string& key, const std::string& value);
 
   Status BatchPut(const std::vector<KVPair>& kvs);
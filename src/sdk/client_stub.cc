@@ -39,10 +39,18 @@ Status ClientStub::Open(std::string naming_service_url) {
   brpc::ChannelOptions options;
   options.timeout_ms = FLAGS_rpc_channel_timeout_ms;
   options.connect_timeout_ms = FLAGS_rpc_channel_connect_timeout_ms;
+  options.connection_type = FLAGS_store_rpc_connection_type.c_str();
   store_rpc_interaction_.reset(new RpcInteraction(options));
 
+  store_rpc_retry_budget_.reset(new StoreRpcRetryBudget());
+
   meta_cache_.reset(new MetaCache(coordinator_proxy_));
 
+  if (FLAGS_enable_region_watch) {
+    region_watcher_ = std::make_unique<RegionWatcher>(coordinator_proxy_, meta_cache_);
+    region_watcher_->Start();
+  }
+
   raw_kv_region_scanner_factory_.reset(new RawKvRegionScannerFactoryImpl());
 
   txn_region_scanner_factory_.reset(new TxnRegionScannerFactoryImpl());
@@ -51,6 +59,10 @@ Status ClientStub::Open(std::string naming_service_url) {
 
   txn_lock_resolver_.reset(new TxnLockResolver(*(this)));
 
+  txn_batch_get_coalescer_.reset(new TxnBatchGetCoalescer(*(this)));
+
+  raw_kv_coalescer_.reset(new RawKvCoalescer(*(this)));
+
   actuator_.reset(new ThreadPoolActuator());
   actuator_->Start(FLAGS_actuator_thread_num);
 
@@ -21,8 +21,12 @@
 #include "sdk/admin_tool.h"
 #include "sdk/coordinator_proxy.h"
 #include "sdk/meta_cache.h"
+#include "sdk/rawkv/raw_kv_coalescer.h"
 #include "sdk/region_scanner.h"
+#include "sdk/region_watcher.h"
 #include "sdk/rpc/rpc_interaction.h"
+#include "sdk/store/store_rpc_retry_budget.h"
+#include "sdk/transaction/txn_batch_get_coalescer.h"
 #include "sdk/transaction/txn_lock_resolver.h"
 #include "sdk/vector/vector_index_cache.h"
 #include "utils/actuator.h"
@@ -53,6 +57,11 @@ class ClientStub {
     return store_rpc_interaction_;
   }
 
+  virtual std::shared_ptr<StoreRpcRetryBudget> GetStoreRpcRetryBudget() const {
+    DCHECK_NOTNULL(store_rpc_retry_budget_.get());
+    return store_rpc_retry_budget_;
+  }
+
   virtual std::shared_ptr<RegionScannerFactory> GetRawKvRegionScannerFactory() const {
     DCHECK_NOTNULL(raw_kv_region_scanner_factory_.get());
     return raw_kv_region_scanner_factory_;
@@ -73,6 +82,16 @@ class ClientStub {
     return txn_lock_resolver_;
   }
 
+  virtual std::shared_ptr<TxnBatchGetCoalescer> GetTxnBatchGetCoalescer() const {
+    DCHECK_NOTNULL(txn_batch_get_coalescer_.get());
+    return txn_batch_get_coalescer_;
+  }
+
+  virtual std::shared_ptr<RawKvCoalescer> GetRawKvCoalescer() const {
+    DCHECK_NOTNULL(raw_kv_coalescer_.get());
+    return raw_kv_coalescer_;
+  }
+
   virtual std::shared_ptr<Actuator> GetActuator() const {
     DCHECK_NOTNULL(actuator_.get());
     return actuator_;
@@ -88,12 +107,16 @@ class ClientStub {
   std::shared_ptr<CoordinatorProxy> coordinator_proxy_;
   std::shared_ptr<MetaCache> meta_cache_;
   std::shared_ptr<RpcInteraction> store_rpc_interaction_;
+  std::shared_ptr<StoreRpcRetryBudget> store_rpc_retry_budget_;
   std::shared_ptr<RegionScannerFactory> raw_kv_region_scanner_factory_;
   std::shared_ptr<RegionScannerFactory> txn_region_scanner_factory_;
   std::shared_ptr<AdminTool> admin_tool_;
   std::shared_ptr<TxnLockResolver> txn_lock_resolver_;
+  std::shared_ptr<TxnBatchGetCoalescer> txn_batch_get_coalescer_;
+  std::shared_ptr<RawKvCoalescer> raw_kv_coalescer_;
   std::shared_ptr<Actuator> actuator_;
   std::shared_ptr<VectorIndexCache> vector_index_cache_;
+  std::unique_ptr<RegionWatcher> region_watcher_;
 };
 
 }  // namespace sdk
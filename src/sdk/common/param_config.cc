@@ -22,21 +22,88 @@ DEFINE_int64(rpc_channel_connect_timeout_ms, 3000, "rpc channel connect timeout
 DEFINE_int64(rpc_max_retry, 3, "rpc call max retry times");
 DEFINE_int64(rpc_time_out_ms, 500000, "rpc call timeout ms");
 
+DEFINE_double(trace_sample_rate, 0, "sample rate of request trace in [0, 1], 0 means no trace");
+
+DEFINE_string(store_rpc_connection_type, "single", "connection type of store rpc channel, single/pooled/short");
+DEFINE_int64(store_rpc_channel_num, 1,
+             "channels of every store, each has its own connection, rpc is sent by the one with least inflight rpcs");
+
 DEFINE_int64(store_rpc_max_retry, 5, "store rpc max retry times, use case: wrong leader or request range invalid");
-DEFINE_int64(store_rpc_retry_delay_ms, 1000, "store rpc retry delay ms");
+DEFINE_int64(store_rpc_retry_delay_ms, 1000, "store rpc max retry backoff delay ms");
+DEFINE_int64(store_rpc_retry_base_delay_ms, 10,
+             "store rpc first retry backoff delay ms on busy or no leader, doubled with jitter for each retry");
+DEFINE_int64(store_rpc_retry_budget_percent, 0,
+             "store rpc retries a client allowed per 100 new store rpcs, 0 means no limit");
+DEFINE_int64(store_rpc_retry_budget_burst, 100, "max store rpc retries a client can save for burst");
+DEFINE_bool(enable_store_rpc_hedge, false,
+            "send a backup request of stale read to another replica if no response after the p95 latency");
+DEFINE_int64(store_rpc_hedge_min_delay_ms, 10, "min delay ms before sending the backup request of hedged rpc");
+DEFINE_int64(store_rpc_hedge_budget_percent, 10, "rpcs allowed to be hedged per 100 stale reads, 0 means no limit");
+DEFINE_int64(store_rpc_hedge_budget_burst, 100, "max hedged rpcs can be saved for burst");
 
 DEFINE_int64(scan_batch_size, 10, "scan batch size, use for region scanner");
 
+DEFINE_int64(meta_cache_prefetch_region_count, 1,
+             "regions fetched from the key on meta cache miss, the adjacent regions are cached too, 1 means no prefetch");
+
 DEFINE_int64(coordinator_interaction_delay_ms, 200, "coordinator interaction delay ms");
 DEFINE_int64(coordinator_interaction_max_retry, 300, "coordinator interaction max retry");
 
+DEFINE_int64(tso_prefetch_count, 64, "tso prefetched for txn start ts, 0 means no prefetch");
+DEFINE_int64(tso_prefetch_max_age_ms, 5, "prefetched tso older than it is not used");
+
+DEFINE_bool(enable_region_watch, false, "watch region change events from coordinator to refresh meta cache");
+DEFINE_int64(region_watch_timeout_ms, 10000, "region watch progress long poll timeout ms");
+DEFINE_int64(region_watch_retry_delay_ms, 1000, "region watch retry delay ms after failure");
+
+DEFINE_bool(enable_read_from_coordinator_follower, false,
+            "send meta read requests to any coordinator, need coordinator follower read enabled");
+
 DEFINE_int64(txn_op_delay_ms, 200, "txn op delay ms");
 DEFINE_int64(txn_op_max_retry, 2, "txn op max retry times");
+DEFINE_bool(enable_txn_single_region_commit, false,
+            "prewrite and commit all keys by one rpc each if the mutations of txn are in one region");
+DEFINE_int64(txn_single_region_commit_max_keys, 1024, "max keys of txn for single region commit");
+DEFINE_int64(txn_pipelined_flush_mutations, 0,
+             "prewrite buffered mutations in background when txn buffer reach it, 0 means disable, flushed keys are "
+             "not visible to reads of the txn itself and should not be written again by the txn");
+DEFINE_int64(txn_pipelined_flush_batch_size, 1024, "max mutations of one prewrite rpc when flushing txn buffer");
+DEFINE_bool(enable_txn_async_commit_secondary, false,
+            "return after primary key is committed, secondary keys are committed in background, readers resolve the "
+            "locks if they are not committed yet");
+DEFINE_int64(txn_async_commit_secondary_max_inflight, 1024,
+             "max in flight async secondary commit rpcs, commit synchronously if exceed");
+DEFINE_int64(txn_status_cache_capacity, 4096, "max txn status cached by lock resolver, 0 means disable cache");
+DEFINE_bool(enable_txn_batch_get_coalesce, false,
+            "coalesce concurrent point gets of txns to the same region into one batch get rpc");
+DEFINE_int64(txn_batch_get_coalesce_window_us, 200, "max time the first get waits for others to coalesce");
+DEFINE_int64(txn_batch_get_coalesce_max_keys, 128, "max keys of one coalesced batch get rpc");
+DEFINE_bool(txn_scan_use_cursor, false, "ask store to keep the txn scan iterator across pages by scan_id");
+DEFINE_int64(txn_read_cache_max_keys, 4096,
+             "max keys cached by the reads of one snapshot isolation txn, 0 means disable cache");
 
 DEFINE_int64(actuator_thread_num, 8, "actuator thread num");
 
 DEFINE_int64(raw_kv_delay_ms, 200, "raw kv backoff delay ms");
 DEFINE_int64(raw_kv_max_retry, 5, "raw kv max retry times");
+DEFINE_bool(enable_raw_kv_coalesce, false, "coalesce concurrent single key puts/gets to the same region into one rpc");
+DEFINE_int64(raw_kv_coalesce_window_us, 200, "max time the first put/get waits for others to coalesce");
+DEFINE_int64(raw_kv_coalesce_max_keys, 128, "max keys of one coalesced raw kv rpc");
+DEFINE_int64(raw_kv_scan_parallel_regions, 1, "regions scanned concurrently by raw kv scan, 1 means scan one by one");
+DEFINE_int64(raw_kv_scan_region_prefetch_max_kvs, 1024,
+             "max kvs prefetched by every region of parallel raw kv scan except the first one");
+DEFINE_int64(raw_kv_scan_batch_bytes, 1024 * 1024,
+             "expected bytes of one batch of parallel raw kv scan, batch size adapts to row size, 0 means fixed");
+DEFINE_int64(raw_kv_delete_range_parallel_regions, 1,
+             "regions deleted concurrently by raw kv delete range, 1 means delete one by one");
+DEFINE_int64(raw_kv_delete_range_progress_regions, 100,
+             "log progress of parallel raw kv delete range every this regions, 0 means no progress log");
 
 DEFINE_int64(vector_op_delay_ms, 500, "raw kv backoff delay ms");
-DEFINE_int64(vector_op_max_retry, 10, "raw kv max retry times");
\ No newline at end of file
+DEFINE_int64(vector_op_max_retry, 10, "raw kv max retry times");
+DEFINE_int64(vector_add_batch_max_count, 1024,
+             "max vectors of one vector add rpc, should not exceed vector_max_batch_count of store");
+DEFINE_int64(vector_add_batch_max_bytes, 4 * 1024 * 1024,
+             "max bytes of one vector add rpc, should be less than vector_max_request_size of store");
+DEFINE_string(vector_add_compress_type, "none", "compress type of vector add request, none/snappy/gzip/zlib");
+DEFINE_int64(vector_bulk_add_max_inflight_per_region, 4, "max in flight vector add rpcs of every region in bulk add");
\ No newline at end of file
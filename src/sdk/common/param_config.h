@@ -31,9 +31,23 @@ DECLARE_int64(rpc_channel_connect_timeout_ms);
 DECLARE_int64(rpc_max_retry);
 DECLARE_int64(rpc_time_out_ms);
 
+// trace of the sampled rpcs and tasks are propagated to store and printed as spans
+DECLARE_double(trace_sample_rate);
+
+// store rpc channels of every store
+DECLARE_string(store_rpc_connection_type);
+DECLARE_int64(store_rpc_channel_num);
+
 // each store rpc params, used for store rpc controller
 DECLARE_int64(store_rpc_max_retry);
 DECLARE_int64(store_rpc_retry_delay_ms);
+DECLARE_int64(store_rpc_retry_base_delay_ms);
+DECLARE_int64(store_rpc_retry_budget_percent);
+DECLARE_int64(store_rpc_retry_budget_burst);
+DECLARE_bool(enable_store_rpc_hedge);
+DECLARE_int64(store_rpc_hedge_min_delay_ms);
+DECLARE_int64(store_rpc_hedge_budget_percent);
+DECLARE_int64(store_rpc_hedge_budget_burst);
 
 // start: use for region scanner
 DECLARE_int64(scan_batch_size);
@@ -42,6 +56,7 @@ const int64_t kMaxScanBatchSize = 100;
 // end: use for region scanner
 
 const int64_t kPrefetchRegionCount = 3;
+DECLARE_int64(meta_cache_prefetch_region_count);
 
 DECLARE_int64(coordinator_interaction_delay_ms);
 DECLARE_int64(coordinator_interaction_max_retry);
@@ -50,11 +65,46 @@ DECLARE_int64(actuator_thread_num);
 
 DECLARE_int64(raw_kv_delay_ms);
 DECLARE_int64(raw_kv_max_retry);
+DECLARE_bool(enable_raw_kv_coalesce);
+DECLARE_int64(raw_kv_coalesce_window_us);
+DECLARE_int64(raw_kv_coalesce_max_keys);
+DECLARE_int64(raw_kv_scan_parallel_regions);
+DECLARE_int64(raw_kv_scan_region_prefetch_max_kvs);
+DECLARE_int64(raw_kv_scan_batch_bytes);
+DECLARE_int64(raw_kv_delete_range_parallel_regions);
+DECLARE_int64(raw_kv_delete_range_progress_regions);
+
+// use for tso provider
+DECLARE_int64(tso_prefetch_count);
+DECLARE_int64(tso_prefetch_max_age_ms);
+
+// use for region watcher
+DECLARE_bool(enable_region_watch);
+DECLARE_int64(region_watch_timeout_ms);
+DECLARE_int64(region_watch_retry_delay_ms);
+
+DECLARE_bool(enable_read_from_coordinator_follower);
 
 DECLARE_int64(txn_op_delay_ms);
 DECLARE_int64(txn_op_max_retry);
+DECLARE_bool(enable_txn_single_region_commit);
+DECLARE_int64(txn_single_region_commit_max_keys);
+DECLARE_int64(txn_pipelined_flush_mutations);
+DECLARE_int64(txn_pipelined_flush_batch_size);
+DECLARE_int64(txn_status_cache_capacity);
+DECLARE_bool(enable_txn_async_commit_secondary);
+DECLARE_int64(txn_async_commit_secondary_max_inflight);
+DECLARE_bool(enable_txn_batch_get_coalesce);
+DECLARE_int64(txn_batch_get_coalesce_window_us);
+DECLARE_int64(txn_batch_get_coalesce_max_keys);
+DECLARE_bool(txn_scan_use_cursor);
+DECLARE_int64(txn_read_cache_max_keys);
 
 DECLARE_int64(vector_op_delay_ms);
 DECLARE_int64(vector_op_max_retry);
+DECLARE_int64(vector_add_batch_max_count);
+DECLARE_int64(vector_add_batch_max_bytes);
+DECLARE_string(vector_add_compress_type);
+DECLARE_int64(vector_bulk_add_max_inflight_per_region);
 
 #endif  // DINGODB_SDK_PARAM_CONFIG_H_
\ No newline at end of file
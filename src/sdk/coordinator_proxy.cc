@@ -18,6 +18,7 @@
 #include "fmt/core.h"
 #include "proto/coordinator.pb.h"
 #include "proto/error.pb.h"
+#include "sdk/common/param_config.h"
 
 namespace dingodb {
 namespace sdk {
@@ -74,7 +75,9 @@ Status CoordinatorProxy::Hello(const pb::coordinator::HelloRequest& request, pb:
 
 Status CoordinatorProxy::QueryRegion(const pb::coordinator::QueryRegionRequest& request,
                                      pb::coordinator::QueryRegionResponse& response) {
-  butil::Status rpc_status = coordinator_interaction_->SendRequest("QueryRegion", request, response);
+  butil::Status rpc_status = FLAGS_enable_read_from_coordinator_follower
+                                  ? coordinator_interaction_->SendReadRequest("QueryRegion", request, response)
+                                  : coordinator_interaction_->SendRequest("QueryRegion", request, response);
   if (!rpc_status.ok()) {
     if (rpc_status.error_code() == pb::error::Errno::EREGION_NOT_FOUND) {
       return Status::NotFound(rpc_status.error_code(), rpc_status.error_cstr());
@@ -117,7 +120,9 @@ Status CoordinatorProxy::DropRegion(const pb::coordinator::DropRegionRequest& re
 
 Status CoordinatorProxy::ScanRegions(const pb::coordinator::ScanRegionsRequest& request,
                                      pb::coordinator::ScanRegionsResponse& response) {
-  butil::Status rpc_status = coordinator_interaction_->SendRequest("ScanRegions", request, response);
+  butil::Status rpc_status = FLAGS_enable_read_from_coordinator_follower
+                                  ? coordinator_interaction_->SendReadRequest("ScanRegions", request, response)
+                                  : coordinator_interaction_->SendRequest("ScanRegions", request, response);
   if (!rpc_status.ok()) {
     DINGO_LOG(INFO) << fmt::format("Fail scan regions {}", COORDINATOR_RPC_MSG(rpc_status, request, response));
     return Status::RemoteError(rpc_status.error_code(), rpc_status.error_cstr());
@@ -138,6 +143,18 @@ Status CoordinatorProxy::TsoService(const pb::meta::TsoRequest& request, pb::met
   }
 }
 
+Status CoordinatorProxy::Watch(const pb::meta::WatchRequest& request, pb::meta::WatchResponse& response,
+                               int64_t timeout_ms) {
+  butil::Status rpc_status = coordinator_interaction_meta_->SendRequest("Watch", request, response, timeout_ms);
+  if (!rpc_status.ok()) {
+    DINGO_LOG(INFO) << fmt::format("Fail watch {}", COORDINATOR_RPC_MSG(rpc_status, request, response));
+    return Status::RemoteError(rpc_status.error_code(), rpc_status.error_cstr());
+  } else {
+    DINGO_LOG(DEBUG) << COORDINATOR_RPC_MSG(rpc_status, request, response);
+    return Status::OK();
+  }
+}
+
 Status CoordinatorProxy::CreateIndex(const pb::meta::CreateIndexRequest& request,
                                      pb::meta::CreateIndexResponse& response) {
   butil::Status rpc_status = coordinator_interaction_meta_->SendRequest("CreateIndex", request, response);
@@ -152,7 +169,9 @@ Status CoordinatorProxy::CreateIndex(const pb::meta::CreateIndexRequest& request
 
 Status CoordinatorProxy::GetIndexByName(const pb::meta::GetIndexByNameRequest& request,
                                         pb::meta::GetIndexByNameResponse& response) {
-  butil::Status rpc_status = coordinator_interaction_meta_->SendRequest("GetIndexByName", request, response);
+  butil::Status rpc_status = FLAGS_enable_read_from_coordinator_follower
+                                  ? coordinator_interaction_meta_->SendReadRequest("GetIndexByName", request, response)
+                                  : coordinator_interaction_meta_->SendRequest("GetIndexByName", request, response);
   if (!rpc_status.ok()) {
     DINGO_LOG(INFO) << fmt::format("Fail get index by name {}", COORDINATOR_RPC_MSG(rpc_status, request, response));
     return Status::RemoteError(rpc_status.error_code(), rpc_status.error_cstr());
@@ -163,7 +182,9 @@ Status CoordinatorProxy::GetIndexByName(const pb::meta::GetIndexByNameRequest& r
 }
 
 Status CoordinatorProxy::GetIndexById(const pb::meta::GetIndexRequest& request, pb::meta::GetIndexResponse& response) {
-  butil::Status rpc_status = coordinator_interaction_meta_->SendRequest("GetIndex", request, response);
+  butil::Status rpc_status = FLAGS_enable_read_from_coordinator_follower
+                                  ? coordinator_interaction_meta_->SendReadRequest("GetIndex", request, response)
+                                  : coordinator_interaction_meta_->SendRequest("GetIndex", request, response);
   if (!rpc_status.ok()) {
     DINGO_LOG(INFO) << fmt::format("Fail get index by id {}", COORDINATOR_RPC_MSG(rpc_status, request, response));
     return Status::RemoteError(rpc_status.error_code(), rpc_status.error_cstr());
@@ -16,6 +16,8 @@
 #ifndef DINGODB_SDK_COORDINATOR_PROXY_H_
 #define DINGODB_SDK_COORDINATOR_PROXY_H_
 
+#include <cstdint>
+
 #include "coordinator/coordinator_interaction.h"
 #include "proto/coordinator.pb.h"
 #include "proto/meta.pb.h"
@@ -50,6 +52,9 @@ class CoordinatorProxy {
   // Meta Service
   virtual Status TsoService(const pb::meta::TsoRequest& request, pb::meta::TsoResponse& response);
 
+  // progress request is a long poll, return when events arrive or timeout
+  virtual Status Watch(const pb::meta::WatchRequest& request, pb::meta::WatchResponse& response, int64_t timeout_ms);
+
   virtual Status CreateIndex(const pb::meta::CreateIndexRequest& request, pb::meta::CreateIndexResponse& response);
   virtual Status GetIndexByName(const pb::meta::GetIndexByNameRequest& request,
                                 pb::meta::GetIndexByNameResponse& response);
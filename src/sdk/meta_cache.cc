@@ -14,7 +14,10 @@
 
 #include "sdk/meta_cache.h"
 
+#include <atomic>
+#include <cstdint>
 #include <string_view>
+#include <vector>
 
 #include "common/logging.h"
 #include "glog/logging.h"
@@ -27,14 +30,23 @@ namespace sdk {
 
 using pb::coordinator::ScanRegionInfo;
 
+static std::atomic<int64_t> g_meta_cache_id{0};
+
 MetaCache::MetaCache(std::shared_ptr<CoordinatorProxy> coordinator_proxy)
-    : coordinator_proxy_(std::move(coordinator_proxy)) {}
+    : coordinator_proxy_(std::move(coordinator_proxy)),
+      cache_id_(g_meta_cache_id.fetch_add(1) + 1),
+      snapshot_(std::make_shared<RegionKeyMap>()) {}
 
 MetaCache::~MetaCache() = default;
 
 Status MetaCache::LookupRegionByKey(std::string_view key, std::shared_ptr<Region>& region) {
   CHECK(!key.empty()) << "key should not empty";
-  Status s;
+  auto snapshot = GetSnapshot();
+  Status s = FindRegionByKey(*snapshot, key, true, region);
+  if (s.IsOK()) {
+    return s;
+  }
+
   {
     std::shared_lock<std::shared_mutex> r(rw_lock_);
     s = FastLookUpRegionByKeyUnlocked(key, region);
@@ -47,6 +59,36 @@ Status MetaCache::LookupRegionByKey(std::string_view key, std::shared_ptr<Region
   return s;
 }
 
+Status MetaCache::LookupRegionsByKeys(const std::vector<std::string_view>& sorted_keys,
+                                      std::vector<std::shared_ptr<Region>>& regions) {
+  std::vector<std::shared_ptr<Region>> tmp_regions(sorted_keys.size());
+
+  // keys in the same region share one search of the snapshot
+  auto snapshot = GetSnapshot();
+  std::shared_ptr<Region> last_region;
+  for (size_t i = 0; i < sorted_keys.size(); ++i) {
+    const auto& key = sorted_keys[i];
+    CHECK(!key.empty()) << "key should not empty";
+    CHECK(i == 0 || sorted_keys[i - 1] <= key) << "keys should be sorted";
+    if (last_region != nullptr && !last_region->IsStale() && key < last_region->Range().end_key()) {
+      tmp_regions[i] = last_region;
+      continue;
+    }
+
+    Status s = FindRegionByKey(*snapshot, key, true, tmp_regions[i]);
+    if (!s.IsOK()) {
+      s = LookupRegionByKey(key, tmp_regions[i]);
+      if (!s.IsOK()) {
+        return s;
+      }
+    }
+    last_region = tmp_regions[i];
+  }
+
+  regions = std::move(tmp_regions);
+  return Status::OK();
+}
+
 Status MetaCache::LookupRegionBetweenRange(std::string_view start_key, std::string_view end_key,
                                            std::shared_ptr<Region>& region) {
   CHECK(!start_key.empty()) << "start_key should not empty";
@@ -189,12 +231,26 @@ void MetaCache::ClearRange(const std::shared_ptr<Region>& region) {
   } else {
     CHECK(iter != region_by_id_.end());
     RemoveRegionUnlocked(region->RegionId());
+    PublishSnapshotUnlocked();
   }
 }
 
 void MetaCache::RemoveRegion(int64_t region_id) {
   std::unique_lock<std::shared_mutex> w(rw_lock_);
   RemoveRegionIfPresentUnlocked(region_id);
+  PublishSnapshotUnlocked();
+}
+
+bool MetaCache::RemoveRegionIfStale(int64_t region_id, const pb::common::RegionEpoch& epoch) {
+  std::unique_lock<std::shared_mutex> w(rw_lock_);
+  auto iter = region_by_id_.find(region_id);
+  if (iter == region_by_id_.end() || EpochCompare(iter->second->Epoch(), epoch) <= 0) {
+    return false;
+  }
+
+  RemoveRegionUnlocked(region_id);
+  PublishSnapshotUnlocked();
+  return true;
 }
 
 void MetaCache::RemoveRegionIfPresentUnlocked(int64_t region_id) {
@@ -210,11 +266,14 @@ void MetaCache::ClearCache() {
   }
   region_by_key_.clear();
   region_by_id_.clear();
+  snapshot_dirty_ = true;
+  PublishSnapshotUnlocked();
 }
 
 void MetaCache::MaybeAddRegion(const std::shared_ptr<Region>& new_region) {
   std::unique_lock<std::shared_mutex> w(rw_lock_);
   MaybeAddRegionUnlocked(new_region);
+  PublishSnapshotUnlocked();
 }
 
 void MetaCache::MaybeAddRegionUnlocked(const std::shared_ptr<Region>& new_region) {
@@ -235,15 +294,55 @@ void MetaCache::MaybeAddRegionUnlocked(const std::shared_ptr<Region>& new_region
   AddRangeToCacheUnlocked(new_region);
 }
 
+std::shared_ptr<const MetaCache::RegionKeyMap> MetaCache::GetSnapshot() {
+  struct CachedSnapshot {
+    int64_t cache_id{0};
+    int64_t version{-1};
+    std::shared_ptr<const RegionKeyMap> snapshot;
+  };
+  static thread_local CachedSnapshot cached;
+
+  int64_t version = snapshot_version_.load(std::memory_order_acquire);
+  if (cached.cache_id != cache_id_ || cached.version != version) {
+    std::shared_lock<std::shared_mutex> r(rw_lock_);
+    cached.cache_id = cache_id_;
+    cached.version = snapshot_version_.load(std::memory_order_relaxed);
+    cached.snapshot = snapshot_;
+  }
+
+  return cached.snapshot;
+}
+
+void MetaCache::PublishSnapshotUnlocked() {
+  if (!snapshot_dirty_) {
+    return;
+  }
+
+  snapshot_ = std::make_shared<const RegionKeyMap>(region_by_key_);
+  snapshot_dirty_ = false;
+  snapshot_version_.fetch_add(1, std::memory_order_release);
+}
+
 Status MetaCache::FastLookUpRegionByKeyUnlocked(std::string_view key, std::shared_ptr<Region>& region) {
-  auto iter = region_by_key_.upper_bound(key);
-  if (iter == region_by_key_.begin()) {
+  return FindRegionByKey(region_by_key_, key, false, region);
+}
+
+Status MetaCache::FindRegionByKey(const RegionKeyMap& region_by_key, std::string_view key, bool check_stale,
+                                  std::shared_ptr<Region>& region) {
+  auto iter = region_by_key.upper_bound(key);
+  if (iter == region_by_key.begin()) {
     return Status::NotFound(fmt::format("not found region for key:{}", key));
   }
 
   iter--;
   auto found_region = iter->second;
-  CHECK(!found_region->IsStale());
+  if (check_stale) {
+    if (found_region->IsStale()) {
+      return Status::NotFound(fmt::format("found stale region:{} for key:{}", found_region->RegionId(), key));
+    }
+  } else {
+    CHECK(!found_region->IsStale());
+  }
 
   auto range = found_region->Range();
   CHECK(key >= range.start_key());
@@ -263,6 +362,10 @@ Status MetaCache::FastLookUpRegionByKeyUnlocked(std::string_view key, std::share
 }
 
 Status MetaCache::SlowLookUpRegionByKey(std::string_view key, std::shared_ptr<Region>& region) {
+  if (FLAGS_meta_cache_prefetch_region_count > 1) {
+    return PrefetchLookUpRegionByKey(key, region);
+  }
+
   pb::coordinator::ScanRegionsRequest request;
   pb::coordinator::ScanRegionsResponse response;
   request.set_key(std::string(key));
@@ -274,6 +377,39 @@ Status MetaCache::SlowLookUpRegionByKey(std::string_view key, std::shared_ptr<Re
   return ProcessScanRegionsByKeyResponse(response, region);
 }
 
+Status MetaCache::PrefetchLookUpRegionByKey(std::string_view key, std::shared_ptr<Region>& region) {
+  pb::coordinator::ScanRegionsRequest request;
+  pb::coordinator::ScanRegionsResponse response;
+  request.set_key(std::string(key));
+  // '\0' means all keys >= key
+  request.set_range_end(std::string(1, '\0'));
+  request.set_limit(FLAGS_meta_cache_prefetch_region_count);
+  Status send = SendScanRegionsRequest(request, response);
+  if (!send.IsOK()) {
+    return send;
+  }
+
+  std::vector<std::shared_ptr<Region>> regions;
+  Status s = ProcessScanRegionsBetweenRangeResponse(response, regions);
+  if (!s.IsOK()) {
+    return s;
+  }
+
+  for (auto& tmp : regions) {
+    if (tmp->Range().start_key() <= key && key < tmp->Range().end_key()) {
+      region = std::move(tmp);
+      return Status::OK();
+    }
+  }
+
+  return Status::NotFound(fmt::format("not found region for key:{}", key));
+}
+
+Status MetaCache::WarmUp(std::string_view start_key, std::string_view end_key) {
+  std::vector<std::shared_ptr<Region>> regions;
+  return ScanRegionsBetweenRange(start_key, end_key, 0, regions);
+}
+
 Status MetaCache::SendScanRegionsRequest(const pb::coordinator::ScanRegionsRequest& request,
                                          pb::coordinator::ScanRegionsResponse& response) {
   return coordinator_proxy_->ScanRegions(request, response);
@@ -290,6 +426,7 @@ Status MetaCache::ProcessScanRegionsByKeyResponse(const pb::coordinator::ScanReg
     {
       std::unique_lock<std::shared_mutex> w(rw_lock_);
       MaybeAddRegionUnlocked(new_region);
+      PublishSnapshotUnlocked();
       auto iter = region_by_id_.find(scan_region_info.region_id());
       CHECK(iter != region_by_id_.end());
       CHECK(iter->second.get() != nullptr);
@@ -307,17 +444,19 @@ Status MetaCache::ProcessScanRegionsBetweenRangeResponse(const pb::coordinator::
   if (response.regions_size() > 0) {
     std::vector<std::shared_ptr<Region>> tmp_regions;
 
-    for (const auto& scan_region_info : response.regions()) {
-      std::shared_ptr<Region> new_region;
-      ProcessScanRegionInfo(scan_region_info, new_region);
-      {
-        std::unique_lock<std::shared_mutex> w(rw_lock_);
+    {
+      std::unique_lock<std::shared_mutex> w(rw_lock_);
+      for (const auto& scan_region_info : response.regions()) {
+        std::shared_ptr<Region> new_region;
+        ProcessScanRegionInfo(scan_region_info, new_region);
         MaybeAddRegionUnlocked(new_region);
         auto iter = region_by_id_.find(scan_region_info.region_id());
         CHECK(iter != region_by_id_.end());
         CHECK(iter->second.get() != nullptr);
         tmp_regions.push_back(iter->second);
       }
+      // publish once for all regions of the response
+      PublishSnapshotUnlocked();
     }
 
     CHECK(!tmp_regions.empty());
@@ -383,6 +522,7 @@ void MetaCache::RemoveRegionUnlocked(int64_t region_id) {
   region_by_id_.erase(iter);
 
   CHECK(region_by_key_.erase(region->Range().start_key()) == 1);
+  snapshot_dirty_ = true;
 
   DINGO_LOG(DEBUG) << "remove region and mark stale, region_id:" << region_id << ", region: " << region->ToString();
 }
@@ -420,6 +560,7 @@ void MetaCache::AddRangeToCacheUnlocked(const std::shared_ptr<Region>& region) {
   // add region to cache
   CHECK(region_by_id_.insert(std::make_pair(region->RegionId(), region)).second);
   CHECK(region_by_key_.insert(std::make_pair(region->Range().start_key(), region)).second);
+  snapshot_dirty_ = true;
 
   region->UnMarkStale();
 
@@ -15,10 +15,13 @@
 #ifndef DINGODB_SDK_META_CACHE_H_
 #define DINGODB_SDK_META_CACHE_H_
 
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -39,8 +42,14 @@ class MetaCache {
 
   ~MetaCache();
 
+  // Lookup cached regions from a copy-on-write snapshot without lock, only cache miss takes the lock.
   Status LookupRegionByKey(std::string_view key, std::shared_ptr<Region>& region);
 
+  // sorted_keys must be in ascending order, regions[i] is the region of sorted_keys[i].
+  // Cached regions are found by walking the snapshot once, return the first error of cache missing keys.
+  Status LookupRegionsByKeys(const std::vector<std::string_view>& sorted_keys,
+                             std::vector<std::shared_ptr<Region>>& regions);
+
   // return first region between [start_key, end_key), this will prefetch regions and put into cache
   Status LookupRegionBetweenRange(std::string_view start_key, std::string_view end_key,
                                   std::shared_ptr<Region>& region);
@@ -57,10 +66,16 @@ class MetaCache {
   //  return all regions between [start_key, end_key), used for get partion regions
   Status ScanRegionsBetweenContinuousRange(std::string_view start_key, std::string_view end_key, std::vector<std::shared_ptr<Region>>& regions);
 
+  // Fetch and cache all regions between [start_key, end_key).
+  Status WarmUp(std::string_view start_key, std::string_view end_key);
+
   void ClearRange(const std::shared_ptr<Region>& region);
 
   void RemoveRegion(int64_t region_id);
 
+  // remove region if cached epoch is older than epoch, return true if removed
+  bool RemoveRegionIfStale(int64_t region_id, const pb::common::RegionEpoch& epoch);
+
   void ClearCache();
 
   // be sure new_region will not destroy when call this func
@@ -74,9 +89,25 @@ class MetaCache {
   void Dump();
 
  private:
+  // start-key -> region
+  using RegionKeyMap = std::map<std::string, std::shared_ptr<Region>, std::less<void>>;
+
+  // The snapshot of region_by_key_, every thread caches it until version changes.
+  std::shared_ptr<const RegionKeyMap> GetSnapshot();
+
+  // Publish region_by_key_ as a new snapshot if it is changed, must be called in write lock after changing it.
+  void PublishSnapshotUnlocked();
+
+  // check_stale: a stale region in snapshot means it is removed after the snapshot, treat as not found.
+  static Status FindRegionByKey(const RegionKeyMap& region_by_key, std::string_view key, bool check_stale,
+                                std::shared_ptr<Region>& region);
+
   // TODO: backoff when region not ready
   Status SlowLookUpRegionByKey(std::string_view key, std::shared_ptr<Region>& region);
 
+  // Fetch meta_cache_prefetch_region_count regions from key, all of them are cached.
+  Status PrefetchLookUpRegionByKey(std::string_view key, std::shared_ptr<Region>& region);
+
   Status FastLookUpRegionByKeyUnlocked(std::string_view key, std::shared_ptr<Region>& region);
 
   Status SendScanRegionsRequest(const pb::coordinator::ScanRegionsRequest& request,
@@ -108,8 +139,14 @@ class MetaCache {
 
   mutable std::shared_mutex rw_lock_;
   std::unordered_map<int64_t, std::shared_ptr<Region>> region_by_id_;
-  // start-key -> region
-  std::map<std::string, std::shared_ptr<Region>, std::less<void>> region_by_key_;
+  RegionKeyMap region_by_key_;
+
+  // Unique in process, identify snapshot cached by threads.
+  const int64_t cache_id_;
+  std::atomic<int64_t> snapshot_version_{0};
+  bool snapshot_dirty_{false};
+  // protected by rw_lock_
+  std::shared_ptr<const RegionKeyMap> snapshot_;
 };
 
 }  // namespace sdk
@@ -17,6 +17,7 @@
 #include <mutex>
 #include <shared_mutex>
 #include <string_view>
+#include <vector>
 
 #include "glog/logging.h"
 #include "sdk/common/common.h"
@@ -56,14 +57,18 @@ void RawKvBatchGetTask::DoAsync() {
   std::unordered_map<int64_t, std::vector<std::string_view>> region_keys;
 
   auto meta_cache = stub.GetMetaCache();
-  for (const auto& key : next_batch) {
-    std::shared_ptr<Region> tmp;
-    Status s = meta_cache->LookupRegionByKey(key, tmp);
-    if (!s.ok()) {
-      // TODO: continue
-      DoAsyncDone(s);
-      return;
-    }
+  std::vector<std::string_view> sorted_keys(next_batch.begin(), next_batch.end());
+  std::vector<std::shared_ptr<Region>> regions;
+  Status s = meta_cache->LookupRegionsByKeys(sorted_keys, regions);
+  if (!s.ok()) {
+    // TODO: continue
+    DoAsyncDone(s);
+    return;
+  }
+
+  for (size_t i = 0; i < sorted_keys.size(); ++i) {
+    const auto& key = sorted_keys[i];
+    const auto& tmp = regions[i];
     auto iter = region_id_to_region.find(tmp->RegionId());
     if (iter == region_id_to_region.end()) {
       region_id_to_region.emplace(std::make_pair(tmp->RegionId(), tmp));
@@ -83,6 +88,7 @@ void RawKvBatchGetTask::DoAsync() {
     auto region = iter->second;
 
     auto rpc = std::make_unique<KvBatchGetRpc>();
+    rpc->SetTraceParent(trace_span);
     FillRpcContext(*rpc->MutableRequest()->mutable_context(), region_id, region->Epoch());
     for (const auto& key : entry.second) {
       auto* fill = rpc->MutableRequest()->add_keys();
@@ -120,11 +126,12 @@ void RawKvBatchGetTask::BatchGetRpcCallback(const Status& status, KvBatchGetRpc*
     }
   } else {
     std::vector<KVPair> result;
-    for (const auto& kv : rpc->Response()->kvs()) {
-      result.push_back({kv.key(), kv.value()});
+    result.reserve(rpc->Response()->kvs_size());
+    for (auto& kv : *rpc->MutableResponse()->mutable_kvs()) {
       if (kv.value().empty()) {
         DINGO_LOG(DEBUG) << "Ignore kv key:" << kv.key() << " because value is empty";
       }
+      result.push_back({std::move(*kv.mutable_key()), std::move(*kv.mutable_value())});
     }
 
     std::unique_lock<std::shared_mutex> w(rw_lock_);
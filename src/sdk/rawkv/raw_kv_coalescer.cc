@@ -0,0 +1,158 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "sdk/rawkv/raw_kv_coalescer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "common/logging.h"
+#include "glog/logging.h"
+#include "sdk/client_stub.h"
+#include "sdk/common/common.h"
+#include "sdk/common/helper.h"
+#include "sdk/common/param_config.h"
+#include "sdk/status.h"
+#include "sdk/store/store_rpc.h"
+
+namespace dingodb {
+namespace sdk {
+
+RawKvCoalescer::RawKvCoalescer(const ClientStub& stub) : stub_(stub) {}
+
+bool RawKvCoalescer::TryGet(const std::string& key, std::string& value) { return TryCoalesce(false, key, "", value); }
+
+bool RawKvCoalescer::TryPut(const std::string& key, const std::string& value) {
+  std::string unused;
+  return TryCoalesce(true, key, value, unused);
+}
+
+bool RawKvCoalescer::TryCoalesce(bool is_put, const std::string& key, const std::string& put_value,
+                                 std::string& get_value) {
+  std::shared_ptr<Region> region;
+  if (!stub_.GetMetaCache()->LookupRegionByKey(key, region).ok()) {
+    return false;
+  }
+
+  auto batch_key = std::make_pair(region->RegionId(), is_put);
+  int64_t max_keys = std::max(static_cast<int64_t>(2), FLAGS_raw_kv_coalesce_max_keys);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  BatchPtr batch;
+  bool is_leader = false;
+  auto it = pending_batches_.find(batch_key);
+  // region changed, batch is full or key is already in the batch, start a new batch
+  if (it != pending_batches_.end() && it->second->region == region &&
+      static_cast<int64_t>(it->second->keys.size()) < max_keys &&
+      std::find(it->second->keys.begin(), it->second->keys.end(), key) == it->second->keys.end()) {
+    batch = it->second;
+  } else {
+    batch = std::make_shared<Batch>();
+    batch->region = region;
+    batch->is_put = is_put;
+    pending_batches_[batch_key] = batch;
+    is_leader = true;
+  }
+
+  batch->keys.push_back(key);
+  if (is_put) {
+    batch->values.push_back(put_value);
+  }
+
+  if (is_leader) {
+    cond_.wait_for(lock, std::chrono::microseconds(FLAGS_raw_kv_coalesce_window_us),
+                   [&]() { return static_cast<int64_t>(batch->keys.size()) >= max_keys; });
+    it = pending_batches_.find(batch_key);
+    if (it != pending_batches_.end() && it->second == batch) {
+      pending_batches_.erase(it);
+    }
+
+    if (batch->keys.size() == 1) {
+      // nobody joined, no need to coalesce
+      return false;
+    }
+
+    lock.unlock();
+    SendBatch(batch);
+    lock.lock();
+
+    batch->done = true;
+    cond_.notify_all();
+  } else {
+    if (static_cast<int64_t>(batch->keys.size()) >= max_keys) {
+      cond_.notify_all();
+    }
+    cond_.wait(lock, [&]() { return batch->done; });
+  }
+
+  if (!batch->ok) {
+    return false;
+  }
+
+  if (!is_put) {
+    auto value_it = batch->get_values.find(key);
+    if (value_it != batch->get_values.end()) {
+      get_value = value_it->second;
+    }
+  }
+  return true;
+}
+
+void RawKvCoalescer::SendBatch(const BatchPtr& batch) {
+  Status ret;
+  if (batch->is_put) {
+    KvBatchPutRpc rpc;
+    FillRpcContext(*rpc.MutableRequest()->mutable_context(), batch->region->RegionId(), batch->region->Epoch());
+    for (size_t i = 0; i < batch->keys.size(); ++i) {
+      auto* kv = rpc.MutableRequest()->add_kvs();
+      kv->set_key(batch->keys[i]);
+      kv->set_value(batch->values[i]);
+    }
+
+    ret = LogAndSendRpc(stub_, rpc, batch->region);
+  } else {
+    KvBatchGetRpc rpc;
+    FillRpcContext(*rpc.MutableRequest()->mutable_context(), batch->region->RegionId(), batch->region->Epoch());
+    for (const auto& key : batch->keys) {
+      rpc.MutableRequest()->add_keys(key);
+    }
+
+    ret = LogAndSendRpc(stub_, rpc, batch->region);
+    if (ret.ok()) {
+      for (const auto& kv : rpc.Response()->kvs()) {
+        if (!kv.value().empty()) {
+          batch->get_values[kv.key()] = kv.value();
+        }
+      }
+    }
+  }
+
+  if (!ret.ok()) {
+    DINGO_LOG(DEBUG) << "coalesced raw kv " << (batch->is_put ? "put" : "get")
+                     << " fail, region:" << batch->region->RegionId() << " keys:" << batch->keys.size()
+                     << " status:" << ret.ToString();
+    return;
+  }
+
+  batch->ok = true;
+}
+
+}  // namespace sdk
+}  // namespace dingodb
@@ -0,0 +1,83 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_SDK_RAW_KV_COALESCER_H_
+#define DINGODB_SDK_RAW_KV_COALESCER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sdk/region.h"
+
+namespace dingodb {
+namespace sdk {
+
+class ClientStub;
+
+// Coalesce concurrent single key puts/gets to the same region into one KvBatchPut/KvBatchGet rpc.
+// The first op of a region waits raw_kv_coalesce_window_us for others then sends the rpc.
+// Any error of the coalesced rpc is not handled here, the caller fallback to its own task which retries.
+class RawKvCoalescer {
+ public:
+  explicit RawKvCoalescer(const ClientStub& stub);
+
+  virtual ~RawKvCoalescer() = default;
+
+  // Return true if the get is done by coalesced rpc, value is not changed if key not found.
+  // Return false if the caller should do the get by itself.
+  virtual bool TryGet(const std::string& key, std::string& value);
+
+  // Return true if the put is done by coalesced rpc.
+  // Return false if the caller should do the put by itself.
+  virtual bool TryPut(const std::string& key, const std::string& value);
+
+ private:
+  struct Batch {
+    std::shared_ptr<Region> region;
+    bool is_put{false};
+    std::vector<std::string> keys;
+    // put values, same index with keys
+    std::vector<std::string> values;
+    // key -> value of get, only valid when done and ok
+    std::unordered_map<std::string, std::string> get_values;
+    bool done{false};
+    bool ok{false};
+  };
+  using BatchPtr = std::shared_ptr<Batch>;
+
+  bool TryCoalesce(bool is_put, const std::string& key, const std::string& put_value, std::string& get_value);
+
+  // Send the rpc of batch, the batch is not visible to new ops any more.
+  void SendBatch(const BatchPtr& batch);
+
+  const ClientStub& stub_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  // (region_id, is_put) -> batch accepting new keys
+  std::map<std::pair<int64_t, bool>, BatchPtr> pending_batches_;
+};
+
+}  // namespace sdk
+}  // namespace dingodb
+
+#endif  // DINGODB_SDK_RAW_KV_COALESCER_H_
@@ -44,7 +44,7 @@ void RawKvGetTask::DoAsync() {
 
 void RawKvGetTask::KvGetRpcCallback(Status status) {
   if (status.ok()) {
-    result_ = rpc_.Response()->value();
+    result_ = std::move(*rpc_.MutableResponse()->mutable_value());
   }
 
   DoAsyncDone(status);
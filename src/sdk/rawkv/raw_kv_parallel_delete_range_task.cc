@@ -0,0 +1,213 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sdk/rawkv/raw_kv_parallel_delete_range_task.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "glog/logging.h"
+#include "sdk/common/common.h"
+#include "sdk/common/param_config.h"
+#include "sdk/rawkv/raw_kv_task.h"
+#include "sdk/store/store_rpc.h"
+
+namespace dingodb {
+namespace sdk {
+
+RawKvParallelDeleteRangeTask::RawKvParallelDeleteRangeTask(const ClientStub& stub, const std::string& start_key,
+                                                           const std::string& end_key, bool continuous,
+                                                           int64_t& out_delete_count)
+    : RawKvTask(stub),
+      start_key_(start_key),
+      end_key_(end_key),
+      continuous_(continuous),
+      out_delete_count_(out_delete_count) {}
+
+Status RawKvParallelDeleteRangeTask::Init() {
+  auto meta_cache = stub.GetMetaCache();
+
+  std::vector<std::shared_ptr<Region>> regions;
+  Status ret = meta_cache->ScanRegionsBetweenRange(start_key_, end_key_, 0, regions);
+  if (!ret.ok()) {
+    if (ret.IsNotFound()) {
+      DINGO_LOG(WARNING) << fmt::format("region not found between [{},{}), no need retry, status:{}", start_key_,
+                                        end_key_, ret.ToString());
+    } else {
+      DINGO_LOG(WARNING) << fmt::format("lookup region fail between [{},{}), need retry, status:{}", start_key_,
+                                        end_key_, ret.ToString());
+    }
+
+    return ret;
+  }
+
+  CHECK(!regions.empty()) << "regions must not empty";
+
+  if (continuous_) {
+    for (int i = 0; i < regions.size() - 1; i++) {
+      auto cur = regions[i];
+      auto next = regions[i + 1];
+      if (cur->Range().end_key() != next->Range().start_key()) {
+        std::string msg = fmt::format("regions bewteen [{}, {}) not continuous", start_key_, end_key_);
+        DINGO_LOG(WARNING) << msg
+                           << fmt::format(", cur region:{} ({}-{}), next region:{} ({}-{})", cur->RegionId(),
+                                          cur->Range().start_key(), cur->Range().end_key(), next->RegionId(),
+                                          next->Range().start_key(), next->Range().end_key());
+
+        return Status::Aborted(msg);
+      }
+    }
+  }
+
+  total_region_count_ = regions.size();
+  todo_ranges_.emplace_back(start_key_, end_key_);
+  return Status::OK();
+}
+
+void RawKvParallelDeleteRangeTask::DoAsync() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    CHECK_EQ(inflight_, 0) << "delete range is in progress";
+    // delete the failed ranges first when retry
+    todo_ranges_.insert(todo_ranges_.begin(), failed_ranges_.begin(), failed_ranges_.end());
+    failed_ranges_.clear();
+    stopped_ = false;
+    done_ = false;
+    status_ = Status::OK();
+  }
+
+  Schedule();
+}
+
+void RawKvParallelDeleteRangeTask::Schedule() {
+  std::vector<std::pair<KvDeleteRangeRpc*, StoreRpcController*>> to_send;
+  bool done = false;
+  Status done_status;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto meta_cache = stub.GetMetaCache();
+    int64_t parallel_regions = std::max(static_cast<int64_t>(1), FLAGS_raw_kv_delete_range_parallel_regions);
+    while (!stopped_ && inflight_ < parallel_regions && !todo_ranges_.empty()) {
+      auto& todo_range = todo_ranges_.front();
+
+      std::shared_ptr<Region> region;
+      Status s = meta_cache->LookupRegionBetweenRange(todo_range.first, todo_range.second, region);
+      if (s.IsNotFound()) {
+        DINGO_LOG(INFO) << fmt::format("region not found between [{},{}), start_key:{} status:{}", todo_range.first,
+                                       todo_range.second, start_key_, s.ToString());
+        todo_ranges_.pop_front();
+        continue;
+      }
+
+      if (!s.ok()) {
+        DINGO_LOG(WARNING) << fmt::format("region look fail between [{},{}), start_key:{} status:{}",
+                                          todo_range.first, todo_range.second, start_key_, s.ToString());
+        StopUnlocked(s);
+        break;
+      }
+
+      CHECK_NOTNULL(region.get());
+      const auto& range = region->Range();
+      std::string start = std::max(todo_range.first, range.start_key());
+      std::string end = std::min(todo_range.second, range.end_key());
+      if (end < todo_range.second) {
+        todo_range.first = end;
+      } else {
+        todo_ranges_.pop_front();
+      }
+
+      //  fill rpc
+      auto rpc = std::make_unique<KvDeleteRangeRpc>();
+      FillRpcContext(*rpc->MutableRequest()->mutable_context(), region->RegionId(), region->Epoch());
+      auto* range_with_option = rpc->MutableRequest()->mutable_range();
+      auto* to_fill_range = range_with_option->mutable_range();
+      to_fill_range->set_start_key(start);
+      to_fill_range->set_end_key(end);
+      range_with_option->set_with_start(true);
+      range_with_option->set_with_end(false);
+
+      auto controller = std::make_unique<StoreRpcController>(stub, *rpc.get(), region);
+      inflight_++;
+      to_send.emplace_back(rpc.release(), controller.release());
+    }
+
+    if (!done_ && inflight_ == 0 && (stopped_ || todo_ranges_.empty())) {
+      done_ = true;
+      done = true;
+      done_status = status_;
+    }
+  }
+
+  for (auto& [rpc, controller] : to_send) {
+    controller->AsyncCall([this, r = rpc, c = controller](auto&& s) {
+      KvDeleteRangeRpcCallback(std::forward<decltype(s)>(s), r, c);
+    });
+  }
+
+  if (done) {
+    DINGO_LOG(INFO) << fmt::format("delete range end between [{},{}), regions:{}/{}, delete_cnt:{}, status:{}",
+                                   start_key_, end_key_, done_region_count_, total_region_count_,
+                                   tmp_out_delete_count_, done_status.ToString());
+    DoAsyncDone(done_status);
+  }
+}
+
+void RawKvParallelDeleteRangeTask::KvDeleteRangeRpcCallback(const Status& status, KvDeleteRangeRpc* rpc,
+                                                            StoreRpcController* controller) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    inflight_--;
+    const auto& range = rpc->Request()->range().range();
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << "rpc: " << rpc->Method() << " send to region: " << rpc->Request()->context().region_id()
+                         << " fail: " << status.ToString() << ", rpc req:" << rpc->Request()->DebugString()
+                         << " rpc resp:" << rpc->Response()->DebugString();
+      failed_ranges_.emplace_back(range.start_key(), range.end_key());
+      StopUnlocked(status);
+    } else {
+      tmp_out_delete_count_ += rpc->Response()->delete_count();
+      done_region_count_++;
+      if (FLAGS_raw_kv_delete_range_progress_regions > 0 &&
+          done_region_count_ % FLAGS_raw_kv_delete_range_progress_regions == 0) {
+        DINGO_LOG(INFO) << fmt::format("delete range progress between [{},{}), regions:{}/{}, delete_cnt:{}",
+                                       start_key_, end_key_, done_region_count_, total_region_count_,
+                                       tmp_out_delete_count_);
+      }
+    }
+  }
+
+  delete controller;
+  delete rpc;
+
+  stub.GetActuator()->Execute([this] { Schedule(); });
+}
+
+void RawKvParallelDeleteRangeTask::StopUnlocked(const Status& status) {
+  // keep the first error
+  if (status_.ok()) {
+    status_ = status;
+  }
+  stopped_ = true;
+}
+
+void RawKvParallelDeleteRangeTask::PostProcess() { out_delete_count_ = tmp_out_delete_count_; }
+
+}  // namespace sdk
+}  // namespace dingodb
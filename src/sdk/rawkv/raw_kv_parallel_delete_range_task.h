@@ -0,0 +1,81 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SDK_RAW_KV_PARALLEL_DELETE_RANGE_TASK_H_
+#define DINGODB_SDK_RAW_KV_PARALLEL_DELETE_RANGE_TASK_H_
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sdk/client_stub.h"
+#include "sdk/rawkv/raw_kv_task.h"
+#include "sdk/status.h"
+#include "sdk/store/store_rpc.h"
+#include "sdk/store/store_rpc_controller.h"
+
+namespace dingodb {
+namespace sdk {
+
+// Delete range of raw_kv_delete_range_parallel_regions regions concurrently, one rpc per region.
+// Only the failed ranges are deleted again when retry, the progress is logged every
+// raw_kv_delete_range_progress_regions regions.
+class RawKvParallelDeleteRangeTask : public RawKvTask {
+ public:
+  RawKvParallelDeleteRangeTask(const ClientStub& stub, const std::string& start_key, const std::string& end_key,
+                               bool continuous, int64_t& out_delete_count);
+
+  ~RawKvParallelDeleteRangeTask() override = default;
+
+ private:
+  using KeyRange = std::pair<std::string, std::string>;
+
+  Status Init() override;
+  void DoAsync() override;
+  void PostProcess() override;
+
+  // Send rpc of next regions until the max concurrency, finish the task when no rpc in flight.
+  void Schedule();
+  void KvDeleteRangeRpcCallback(const Status& status, KvDeleteRangeRpc* rpc, StoreRpcController* controller);
+  void StopUnlocked(const Status& status);
+
+  std::string Name() const override { return "RawKvParallelDeleteRangeTask"; }
+  std::string ErrorMsg() const override { return fmt::format("start_key: {}, end_key:{}", start_key_, end_key_); }
+
+  const std::string& start_key_;
+  const std::string& end_key_;
+  const bool continuous_;
+  int64_t& out_delete_count_;
+
+  std::mutex mutex_;
+  // ranges not deleted yet, not split by region
+  std::deque<KeyRange> todo_ranges_;
+  // ranges of failed rpc, deleted again when retry
+  std::vector<KeyRange> failed_ranges_;
+  int inflight_{0};
+  bool stopped_{false};
+  bool done_{false};
+  Status status_;
+  // regions between range when init, only for progress
+  int64_t total_region_count_{0};
+  int64_t done_region_count_{0};
+  int64_t tmp_out_delete_count_{0};
+};
+
+}  // namespace sdk
+}  // namespace dingodb
+#endif  // DINGODB_SDK_RAW_KV_PARALLEL_DELETE_RANGE_TASK_H_
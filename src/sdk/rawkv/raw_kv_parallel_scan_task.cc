@@ -0,0 +1,251 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sdk/rawkv/raw_kv_parallel_scan_task.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "glog/logging.h"
+#include "sdk/common/param_config.h"
+#include "sdk/rawkv/raw_kv_task.h"
+#include "sdk/region_scanner.h"
+
+namespace dingodb {
+namespace sdk {
+
+RawKvParallelScanTask::RawKvParallelScanTask(const ClientStub& stub, const std::string& start_key,
+                                             const std::string& end_key, uint64_t limit, std::vector<KVPair>& out_kvs)
+    : RawKvTask(stub), start_key_(start_key), end_key_(end_key), limit_(limit), out_kvs_(out_kvs) {}
+
+Status RawKvParallelScanTask::Init() {
+  auto meta_cache = stub.GetMetaCache();
+
+  // precheck: return not found if no region in [start, end_key)
+  std::shared_ptr<Region> region;
+  Status ret = meta_cache->LookupRegionBetweenRange(start_key_, end_key_, region);
+  if (!ret.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("lookup region fail between [{},{}), status:{}", start_key_, end_key_,
+                                      ret.ToString());
+    return ret;
+  }
+
+  next_start_key_ = start_key_;
+  return Status::OK();
+}
+
+void RawKvParallelScanTask::DoAsync() {
+  std::deque<RegionSlotPtr> released;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    CHECK_EQ(inflight_, 0) << "scan is in progress";
+    released.swap(slots_);
+    next_region_start_key_ = next_start_key_;
+    stopped_ = false;
+    done_ = false;
+    status_ = Status::OK();
+  }
+
+  Schedule();
+}
+
+void RawKvParallelScanTask::Schedule() {
+  std::vector<RegionSlotPtr> to_open;
+  std::vector<RegionSlotPtr> to_fetch;
+  std::deque<RegionSlotPtr> released;
+  bool done = false;
+  Status done_status;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    DrainUnlocked();
+    if (!stopped_) {
+      OpenRegionsUnlocked(to_open);
+    }
+
+    if (!stopped_) {
+      for (size_t i = 0; i < slots_.size(); ++i) {
+        auto& slot = slots_[i];
+        if (!slot->opened || slot->fetching || slot->finished) {
+          continue;
+        }
+        if (i > 0 && static_cast<int64_t>(slot->kvs.size()) >= FLAGS_raw_kv_scan_region_prefetch_max_kvs) {
+          continue;
+        }
+
+        slot->fetching = true;
+        slot->batch_kvs.clear();
+        inflight_++;
+        to_fetch.push_back(slot);
+      }
+    }
+
+    if (!done_ && inflight_ == 0 && (stopped_ || slots_.empty())) {
+      done_ = true;
+      done = true;
+      done_status = status_;
+      released.swap(slots_);
+    }
+  }
+
+  for (auto& slot : to_open) {
+    slot->scanner->AsyncOpen([this, slot](auto&& s) { ScannerOpenCallback(std::forward<decltype(s)>(s), slot); });
+  }
+
+  for (auto& slot : to_fetch) {
+    slot->scanner->AsyncNextBatch(slot->batch_kvs,
+                                  [this, slot](auto&& s) { NextBatchCallback(std::forward<decltype(s)>(s), slot); });
+  }
+
+  if (done) {
+    DINGO_LOG(INFO) << fmt::format("scan end between [{},{}), next_start:{}, limit:{}, scan_cnt:{}, status:{}",
+                                   start_key_, end_key_, next_start_key_, limit_, tmp_out_kvs_.size(),
+                                   done_status.ToString());
+    released.clear();
+    DoAsyncDone(done_status);
+  }
+}
+
+void RawKvParallelScanTask::DrainUnlocked() {
+  while (!slots_.empty() && !ReachLimit()) {
+    auto& head = slots_.front();
+    if (!head->kvs.empty()) {
+      next_start_key_ = head->kvs.back().key + '\0';
+      tmp_out_kvs_.insert(tmp_out_kvs_.end(), std::make_move_iterator(head->kvs.begin()),
+                          std::make_move_iterator(head->kvs.end()));
+      head->kvs.clear();
+    }
+
+    if (!head->finished) {
+      break;
+    }
+
+    next_start_key_ = head->region->Range().end_key();
+    DINGO_LOG(INFO) << fmt::format("region:{} scan finished, continue to scan between [{},{}), next_start:{}",
+                                   head->region->RegionId(), start_key_, end_key_, next_start_key_);
+    slots_.pop_front();
+  }
+
+  if (ReachLimit()) {
+    tmp_out_kvs_.resize(limit_);
+    stopped_ = true;
+  }
+}
+
+void RawKvParallelScanTask::OpenRegionsUnlocked(std::vector<RegionSlotPtr>& to_open) {
+  auto meta_cache = stub.GetMetaCache();
+  int64_t parallel_regions = std::max(static_cast<int64_t>(1), FLAGS_raw_kv_scan_parallel_regions);
+  while (static_cast<int64_t>(slots_.size()) < parallel_regions && next_region_start_key_ < end_key_) {
+    std::shared_ptr<Region> region;
+    Status s = meta_cache->LookupRegionBetweenRange(next_region_start_key_, end_key_, region);
+    if (s.IsNotFound()) {
+      DINGO_LOG(INFO) << fmt::format("region not found between [{},{}), start_key:{} status:{}",
+                                     next_region_start_key_, end_key_, start_key_, s.ToString());
+      next_region_start_key_ = end_key_;
+      break;
+    }
+
+    if (!s.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("region look fail between [{},{}), start_key:{} status:{}",
+                                        next_region_start_key_, end_key_, start_key_, s.ToString());
+      StopUnlocked(s);
+      break;
+    }
+
+    std::string scanner_start_key = std::max(next_region_start_key_, region->Range().start_key());
+    std::string scanner_end_key = std::min(end_key_, region->Range().end_key());
+    ScannerOptions options(stub, region, scanner_start_key, scanner_end_key);
+
+    auto slot = std::make_shared<RegionSlot>();
+    slot->region = region;
+    CHECK(stub.GetRawKvRegionScannerFactory()->NewRegionScanner(options, slot->scanner).IsOK());
+
+    slots_.push_back(slot);
+    inflight_++;
+    to_open.push_back(slot);
+    next_region_start_key_ = region->Range().end_key();
+  }
+}
+
+void RawKvParallelScanTask::ScannerOpenCallback(const Status& status, RegionSlotPtr slot) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    inflight_--;
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("region scanner open fail, region:{}, status:{}", slot->region->RegionId(),
+                                        status.ToString());
+      StopUnlocked(status);
+    } else {
+      slot->opened = true;
+      slot->finished = !slot->scanner->HasMore();
+    }
+  }
+
+  Schedule();
+}
+
+void RawKvParallelScanTask::NextBatchCallback(const Status& status, RegionSlotPtr slot) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    inflight_--;
+    slot->fetching = false;
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("region scanner NextBatch fail, region:{}, status:{}",
+                                        slot->region->RegionId(), status.ToString());
+      StopUnlocked(status);
+    } else {
+      AdaptBatchSize(*slot);
+      slot->kvs.insert(slot->kvs.end(), std::make_move_iterator(slot->batch_kvs.begin()),
+                       std::make_move_iterator(slot->batch_kvs.end()));
+      slot->batch_kvs.clear();
+      slot->finished = !slot->scanner->HasMore();
+    }
+  }
+
+  Schedule();
+}
+
+void RawKvParallelScanTask::StopUnlocked(const Status& status) {
+  // keep the first error
+  if (status_.ok()) {
+    status_ = status;
+  }
+  stopped_ = true;
+}
+
+void RawKvParallelScanTask::AdaptBatchSize(RegionSlot& slot) {
+  if (FLAGS_raw_kv_scan_batch_bytes <= 0 || slot.batch_kvs.empty()) {
+    return;
+  }
+
+  int64_t bytes = 0;
+  for (const auto& kv : slot.batch_kvs) {
+    bytes += kv.key.size() + kv.value.size();
+  }
+  int64_t row_size = std::max(static_cast<int64_t>(1), bytes / static_cast<int64_t>(slot.batch_kvs.size()));
+  slot.scanner->SetBatchSize(FLAGS_raw_kv_scan_batch_bytes / row_size);
+}
+
+bool RawKvParallelScanTask::ReachLimit() const { return limit_ != 0 && (tmp_out_kvs_.size() >= limit_); }
+
+void RawKvParallelScanTask::PostProcess() { out_kvs_ = std::move(tmp_out_kvs_); }
+
+}  // namespace sdk
+}  // namespace dingodb
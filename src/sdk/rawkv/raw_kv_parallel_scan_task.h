@@ -0,0 +1,100 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SDK_RAW_KV_PARALLEL_SCAN_TASK_H_
+#define DINGODB_SDK_RAW_KV_PARALLEL_SCAN_TASK_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "sdk/client_stub.h"
+#include "sdk/rawkv/raw_kv_task.h"
+#include "sdk/region_scanner.h"
+#include "sdk/status.h"
+
+namespace dingodb {
+namespace sdk {
+
+// Scan raw_kv_scan_parallel_regions regions concurrently, the kvs are returned in key order.
+// The first region is always fetched, the others prefetch at most raw_kv_scan_region_prefetch_max_kvs kvs.
+// Batch size of every region scanner adapts to the row size, so one batch is about raw_kv_scan_batch_bytes.
+class RawKvParallelScanTask : public RawKvTask {
+ public:
+  RawKvParallelScanTask(const ClientStub& stub, const std::string& start_key, const std::string& end_key,
+                        uint64_t limit, std::vector<KVPair>& out_kvs);
+
+  ~RawKvParallelScanTask() override = default;
+
+ private:
+  struct RegionSlot {
+    std::shared_ptr<Region> region;
+    std::shared_ptr<RegionScanner> scanner;
+    // filled by scanner AsyncNextBatch
+    std::vector<KVPair> batch_kvs;
+    // fetched but not returned yet
+    std::vector<KVPair> kvs;
+    bool opened{false};
+    bool fetching{false};
+    bool finished{false};
+  };
+  using RegionSlotPtr = std::shared_ptr<RegionSlot>;
+
+  Status Init() override;
+  void DoAsync() override;
+  void PostProcess() override;
+
+  // Move the kvs of slots to output, open scanners of next regions and fetch batches,
+  // finish the task when no rpc in flight.
+  void Schedule();
+  void DrainUnlocked();
+  void OpenRegionsUnlocked(std::vector<RegionSlotPtr>& to_open);
+
+  void ScannerOpenCallback(const Status& status, RegionSlotPtr slot);
+  void NextBatchCallback(const Status& status, RegionSlotPtr slot);
+  void StopUnlocked(const Status& status);
+
+  static void AdaptBatchSize(RegionSlot& slot);
+
+  bool ReachLimit() const;
+
+  std::string Name() const override { return "RawKvParallelScanTask"; }
+  std::string ErrorMsg() const override {
+    return fmt::format("start_key: {}, end_key:{}, limit:{}", start_key_, end_key_, limit_);
+  }
+
+  const std::string& start_key_;
+  const std::string& end_key_;
+  const uint64_t limit_;
+  std::vector<KVPair>& out_kvs_;
+
+  std::mutex mutex_;
+  std::deque<RegionSlotPtr> slots_;
+  // kvs before it are in tmp_out_kvs_, retry from it
+  std::string next_start_key_;
+  // regions before it are opened
+  std::string next_region_start_key_;
+  int inflight_{0};
+  bool stopped_{false};
+  bool done_{false};
+  Status status_;
+  std::vector<KVPair> tmp_out_kvs_;
+};
+
+}  // namespace sdk
+}  // namespace dingodb
+#endif  // DINGODB_SDK_RAW_KV_PARALLEL_SCAN_TASK_H_
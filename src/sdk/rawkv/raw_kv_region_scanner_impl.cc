@@ -170,15 +170,17 @@ void RawKvRegionScannerImpl::KvScanContinueRpcCallback(Status status, StoreRpcCo
   });
 
   if (status.ok()) {
-    const auto* response = rpc->Response();
+    auto* response = rpc->MutableResponse();
     std::vector<KVPair> tmp_kvs;
     if (response->kvs_size() == 0) {
       // scan to region end_key
       has_more_ = false;
     } else {
-      for (const auto& kv : response->kvs()) {
+      tmp_kvs.reserve(response->kvs_size());
+      // move out of response, avoid copying large values
+      for (auto& kv : *response->mutable_kvs()) {
         if (kv.key() < end_key_) {
-          tmp_kvs.push_back({kv.key(), kv.value()});
+          tmp_kvs.push_back({std::move(*kv.mutable_key()), std::move(*kv.mutable_value())});
         } else {
           has_more_ = false;
         }
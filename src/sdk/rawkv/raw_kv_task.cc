@@ -34,6 +34,11 @@ void RawKvTask::AsyncRun(StatusCallback cb) {
     std::unique_lock<std::shared_mutex> w(rw_lock_);
     call_back_.swap(cb);
   }
+
+  if (Trace::ShouldSample(FLAGS_trace_sample_rate)) {
+    Trace::StartSpan(trace_span, 0, 0, Name(), "internal");
+  }
+
   Status status = Init();
   if (status.ok()) {
     DoAsync();
@@ -101,6 +106,7 @@ void RawKvTask::FireCallback() {
     call_back_.swap(cb);
   }
 
+  Trace::FinishSpan(trace_span, status_.Errno());
   cb(status_);
 }
 
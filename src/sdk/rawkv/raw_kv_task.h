@@ -15,6 +15,7 @@
 #ifndef DINGODB_SDK_RAW_KV_TASK_H_
 #define DINGODB_SDK_RAW_KV_TASK_H_
 
+#include "common/trace.h"
 #include "sdk/client_stub.h"
 #include "sdk/status.h"
 #include "sdk/utils/callback.h"
@@ -41,6 +42,9 @@ class RawKvTask {
 
   const ClientStub& stub;
 
+  // Span of the whole task when sampled, the parent of its rpc spans.
+  TraceSpan trace_span;
+
  private:
   void FailOrRetry();
   bool NeedRetry();
@@ -0,0 +1,157 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "sdk/region_watcher.h"
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "proto/error.pb.h"
+#include "sdk/common/param_config.h"
+
+namespace dingodb {
+namespace sdk {
+
+RegionWatcher::RegionWatcher(std::shared_ptr<CoordinatorProxy> coordinator_proxy,
+                             std::shared_ptr<MetaCache> meta_cache)
+    : coordinator_proxy_(std::move(coordinator_proxy)), meta_cache_(std::move(meta_cache)) {}
+
+RegionWatcher::~RegionWatcher() { Stop(); }
+
+void RegionWatcher::Start() {
+  bool expected = false;
+  if (!running_.compare_exchange_strong(expected, true)) {
+    return;
+  }
+
+  thread_ = std::thread([this]() { Run(); });
+}
+
+void RegionWatcher::Stop() {
+  bool expected = true;
+  if (!running_.compare_exchange_strong(expected, false)) {
+    return;
+  }
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void RegionWatcher::Run() {
+  while (running_.load()) {
+    Status s = (watch_id_ == 0) ? CreateWatch() : ProgressWatch();
+    if (!s.IsOK() && running_.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(FLAGS_region_watch_retry_delay_ms));
+    }
+  }
+
+  CancelWatch();
+}
+
+Status RegionWatcher::CreateWatch() {
+  pb::meta::WatchRequest request;
+  pb::meta::WatchResponse response;
+  auto* create_request = request.mutable_create_request();
+  create_request->add_event_types(pb::meta::MetaEventType::META_EVENT_REGION_UPDATE);
+  create_request->add_event_types(pb::meta::MetaEventType::META_EVENT_REGION_DELETE);
+
+  Status s = coordinator_proxy_->Watch(request, response, FLAGS_region_watch_timeout_ms);
+  if (!s.IsOK()) {
+    return s;
+  }
+
+  watch_id_ = response.watch_id();
+  DINGO_LOG(INFO) << fmt::format("[sdk.region_watcher] create watch {}", watch_id_);
+  return Status::OK();
+}
+
+Status RegionWatcher::ProgressWatch() {
+  pb::meta::WatchRequest request;
+  pb::meta::WatchResponse response;
+  request.mutable_progress_request()->set_watch_id(watch_id_);
+
+  Status s = coordinator_proxy_->Watch(request, response, FLAGS_region_watch_timeout_ms);
+  if (!s.IsOK()) {
+    if (s.Errno() == pb::error::EWATCH_NOT_EXIST) {
+      // recycled by coordinator, events between may be lost, they are still handled by store response
+      DINGO_LOG(WARNING) << fmt::format("[sdk.region_watcher] watch {} not exist, recreate it", watch_id_);
+      watch_id_ = 0;
+    }
+    return s;
+  }
+
+  for (const auto& event : response.events()) {
+    ProcessEvent(event);
+  }
+
+  if (response.canceled() || response.compact_revision() > 0) {
+    DINGO_LOG(WARNING) << fmt::format("[sdk.region_watcher] watch {} canceled, reason: {}, recreate it", watch_id_,
+                                      response.cancel_reason());
+    watch_id_ = 0;
+  }
+
+  return Status::OK();
+}
+
+void RegionWatcher::CancelWatch() {
+  if (watch_id_ == 0) {
+    return;
+  }
+
+  pb::meta::WatchRequest request;
+  pb::meta::WatchResponse response;
+  request.mutable_cancel_request()->set_watch_id(watch_id_);
+  coordinator_proxy_->Watch(request, response, FLAGS_region_watch_timeout_ms);
+  watch_id_ = 0;
+}
+
+void RegionWatcher::ProcessEvent(const pb::meta::MetaEvent& event) {
+  if (!event.has_region()) {
+    return;
+  }
+
+  const auto& region = event.region();
+  if (event.event_type() == pb::meta::MetaEventType::META_EVENT_REGION_DELETE) {
+    meta_cache_->RemoveRegion(region.id());
+    return;
+  }
+
+  if (event.event_type() != pb::meta::MetaEventType::META_EVENT_REGION_UPDATE) {
+    return;
+  }
+
+  if (!meta_cache_->RemoveRegionIfStale(region.id(), region.definition().epoch())) {
+    return;
+  }
+
+  // look up again to get the new range and leader, failure is ok, it will be looked up by the next request
+  const auto& range = region.definition().range();
+  if (range.start_key().empty() || range.end_key().empty()) {
+    return;
+  }
+  std::shared_ptr<Region> new_region;
+  Status s = meta_cache_->LookupRegionBetweenRangeNoPrefetch(range.start_key(), range.end_key(), new_region);
+  DINGO_LOG(DEBUG) << fmt::format("[sdk.region_watcher] refresh region {} epoch {}_{}, status: {}", region.id(),
+                                  region.definition().epoch().conf_version(), region.definition().epoch().version(),
+                                  s.ToString());
+}
+
+}  // namespace sdk
+}  // namespace dingodb
@@ -0,0 +1,70 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_SDK_REGION_WATCHER_H_
+#define DINGODB_SDK_REGION_WATCHER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "proto/meta.pb.h"
+#include "sdk/coordinator_proxy.h"
+#include "sdk/meta_cache.h"
+#include "sdk/status.h"
+
+namespace dingodb {
+namespace sdk {
+
+// Watch region events from coordinator and refresh the regions in meta cache before requests hit them.
+// Only the cached regions are handled, a region with newer epoch is removed and looked up again,
+// a deleted region is removed. Leader change is not a meta event, it is still learned from store response.
+class RegionWatcher {
+ public:
+  RegionWatcher(const RegionWatcher&) = delete;
+  const RegionWatcher& operator=(const RegionWatcher&) = delete;
+
+  RegionWatcher(std::shared_ptr<CoordinatorProxy> coordinator_proxy, std::shared_ptr<MetaCache> meta_cache);
+
+  ~RegionWatcher();
+
+  void Start();
+
+  // wait at most region_watch_timeout_ms for the inflight progress request
+  void Stop();
+
+ private:
+  void Run();
+
+  Status CreateWatch();
+
+  Status ProgressWatch();
+
+  void CancelWatch();
+
+  void ProcessEvent(const pb::meta::MetaEvent& event);
+
+  std::shared_ptr<CoordinatorProxy> coordinator_proxy_;
+  std::shared_ptr<MetaCache> meta_cache_;
+
+  std::atomic<bool> running_{false};
+  std::thread thread_;
+  int64_t watch_id_{0};
+};
+
+}  // namespace sdk
+}  // namespace dingodb
+#endif  // DINGODB_SDK_REGION_WATCHER_H_
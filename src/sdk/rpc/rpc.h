@@ -16,6 +16,7 @@
 #define DINGODB_SDK_RPC_H_
 
 #include <string>
+#include <vector>
 
 #include "brpc/callback.h"
 #include "brpc/channel.h"
@@ -23,6 +24,8 @@
 #include "butil/endpoint.h"
 #include "butil/fast_rand.h"
 #include "common/logging.h"
+#include "common/trace.h"
+#include "google/protobuf/arena.h"
 #include "google/protobuf/message.h"
 #include "sdk/common/param_config.h"
 #include "sdk/status.h"
@@ -43,12 +46,31 @@ class Rpc {
 
   void SetEndPoint(const butil::EndPoint& p_end_point) { end_point = p_end_point; }
 
+  // Not empty means the rpc is hedged, sent to one of them and a backup request is sent to another one
+  // after controller backup_request_ms, the first response is taken.
+  const std::vector<butil::EndPoint>& GetHedgeEndPoints() const { return hedge_end_points; }
+
+  void SetHedgeEndPoints(std::vector<butil::EndPoint> p_end_points) { hedge_end_points = std::move(p_end_points); }
+
   const brpc::Controller* Controller() const { return &controller; }
 
   Status GetStatus() { return status; }
 
   void SetStatus(const Status& s) { status = s; }
 
+  // Kept across Reset, applied to controller of every attempt.
+  void SetRequestCompressType(brpc::CompressType type) { request_compress_type = type; }
+
+  // Kept across Reset, the rpc span belongs to the trace of the task which sends it.
+  void SetTraceParent(const TraceSpan& parent) {
+    trace_id = parent.trace_id;
+    parent_span_id = parent.span_id;
+  }
+
+  int64_t TraceId() const { return trace_id; }
+
+  int64_t ParentSpanId() const { return parent_span_id; }
+
   virtual google::protobuf::Message* RawMutableRequest() = 0;
 
   virtual const google::protobuf::Message* RawRequest() const = 0;
@@ -71,21 +93,23 @@ class Rpc {
   std::string cmd;
   brpc::Controller controller;
   butil::EndPoint end_point;
+  std::vector<butil::EndPoint> hedge_end_points;
+  brpc::CompressType request_compress_type{brpc::COMPRESS_TYPE_NONE};
+  int64_t trace_id{0};
+  int64_t parent_span_id{0};
   Status status;
 };
 
 template <class RequestType, class ResponseType, class ServiceType, class StubType>
 class ClientRpc : public Rpc {
  public:
+  // request and response are allocated on arena, so all their sub messages are freed at once
   ClientRpc(const std::string& cmd) : Rpc(cmd) {
-    request = new RequestType;
-    response = new ResponseType;
+    request = google::protobuf::Arena::CreateMessage<RequestType>(&arena);
+    response = google::protobuf::Arena::CreateMessage<ResponseType>(&arena);
   }
 
-  ~ClientRpc() override {
-    delete request;
-    delete response;
-  }
+  ~ClientRpc() override = default;
 
   RequestType* MutableRequest() { return request; }
 
@@ -131,6 +155,7 @@ class ClientRpc : public Rpc {
     controller.set_log_id(butil::fast_rand());
     controller.set_timeout_ms(FLAGS_rpc_time_out_ms);
     controller.set_max_retry(FLAGS_rpc_max_retry);
+    controller.set_request_compress_type(request_compress_type);
     status = Status::OK();
   }
 
@@ -142,6 +167,7 @@ class ClientRpc : public Rpc {
   virtual void Send(StubType& stub, google::protobuf::Closure* done) = 0;
 
  protected:
+  google::protobuf::Arena arena;
   RequestType* request;
   ResponseType* response;
 };
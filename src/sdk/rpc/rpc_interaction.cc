@@ -14,13 +14,20 @@
 
 #include "sdk/rpc/rpc_interaction.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "brpc/channel.h"
 #include "butil/endpoint.h"
+#include "fmt/core.h"
+#include "common/trace.h"
 #include "glog/logging.h"
+#include "sdk/common/param_config.h"
 
 namespace dingodb {
 namespace sdk {
@@ -30,21 +37,95 @@ void RpcInteraction::SendRpc(Rpc& rpc, RpcCallback cb) {
   CHECK(endpoint.ip != butil::IP_ANY) << "rpc endpoint not set";
   CHECK(endpoint.port != 0) << "rpc endpoint port should not 0";
 
-  std::shared_ptr<brpc::Channel> channel = std::make_shared<brpc::Channel>();
-  {
-    std::lock_guard<std::mutex> guard(lock_);
-    auto ch = channel_map_.find(endpoint);
-    if (ch == channel_map_.end()) {
-      int ret = channel->Init(endpoint, &options_);
-      CHECK_EQ(ret, 0) << "Fail init channel endpoint:" << butil::endpoint2str(endpoint).c_str();
-      channel_map_.insert(std::make_pair(endpoint, channel));
-    } else {
-      channel = CHECK_NOTNULL(ch->second);
+  // Rpc of a traced task or sampled by itself, every attempt has its own span.
+  if (rpc.TraceId() != 0 || Trace::ShouldSample(FLAGS_trace_sample_rate)) {
+    auto span = std::make_shared<TraceSpan>();
+    Trace::StartSpan(*span, rpc.TraceId(), rpc.ParentSpanId(), rpc.Method(), "client");
+    span->attributes["endpoint"] = butil::endpoint2str(endpoint).c_str();
+    Trace::SetRequestTrace(rpc.RawMutableRequest(), *span);
+    cb = [&rpc, span, cb = std::move(cb)]() {
+      Trace::FinishSpan(*span, rpc.Controller()->ErrorCode());
+      cb();
+    };
+  }
+
+  if (!rpc.GetHedgeEndPoints().empty()) {
+    auto hedge_channel = GetHedgeChannel(rpc.GetHedgeEndPoints());
+    rpc.Call(hedge_channel.get(), std::move(cb));
+    return;
+  }
+
+  auto endpoint_channels = GetEndPointChannels(endpoint);
+  auto* pooled_channel = PickChannel(*endpoint_channels);
+  pooled_channel->inflight.fetch_add(1, std::memory_order_relaxed);
+  endpoint_channels->inflight << 1;
+  rpc.Call(pooled_channel->channel.get(), [&rpc, endpoint_channels, pooled_channel, cb = std::move(cb)]() {
+    pooled_channel->inflight.fetch_sub(1, std::memory_order_relaxed);
+    endpoint_channels->inflight << -1;
+    endpoint_channels->latency << rpc.Controller()->latency_us();
+    cb();
+  });
+}
+
+std::shared_ptr<RpcInteraction::EndPointChannels> RpcInteraction::GetEndPointChannels(
+    const butil::EndPoint& endpoint) {
+  std::lock_guard<std::mutex> guard(lock_);
+  auto& endpoint_channels = channel_map_[endpoint];
+  if (endpoint_channels != nullptr) {
+    return endpoint_channels;
+  }
+
+  endpoint_channels = std::make_shared<EndPointChannels>();
+  int64_t channel_num = std::max(static_cast<int64_t>(1), FLAGS_store_rpc_channel_num);
+  for (int64_t i = 0; i < channel_num; ++i) {
+    brpc::ChannelOptions options = options_;
+    options.connection_group = fmt::format("dingo_sdk_{}", i);
+
+    auto pooled_channel = std::make_unique<PooledChannel>();
+    pooled_channel->channel = std::make_shared<brpc::Channel>();
+    int ret = pooled_channel->channel->Init(endpoint, &options);
+    CHECK_EQ(ret, 0) << "Fail init channel endpoint:" << butil::endpoint2str(endpoint).c_str();
+    endpoint_channels->channels.push_back(std::move(pooled_channel));
+  }
+
+  std::string prefix = fmt::format("dingo_sdk_store_rpc_{}", butil::endpoint2str(endpoint).c_str());
+  endpoint_channels->latency.expose(prefix);
+  endpoint_channels->inflight.expose(prefix + "_inflight");
+
+  return endpoint_channels;
+}
+
+RpcInteraction::PooledChannel* RpcInteraction::PickChannel(EndPointChannels& endpoint_channels) {
+  auto& channels = endpoint_channels.channels;
+  PooledChannel* picked = channels[0].get();
+  for (size_t i = 1; i < channels.size(); ++i) {
+    if (channels[i]->inflight.load(std::memory_order_relaxed) < picked->inflight.load(std::memory_order_relaxed)) {
+      picked = channels[i].get();
+    }
+  }
+
+  return picked;
+}
+
+std::shared_ptr<brpc::Channel> RpcInteraction::GetHedgeChannel(const std::vector<butil::EndPoint>& endpoints) {
+  std::string url = "list://";
+  for (size_t i = 0; i < endpoints.size(); ++i) {
+    if (i > 0) {
+      url += ",";
     }
+    url += butil::endpoint2str(endpoints[i]).c_str();
+  }
+
+  std::lock_guard<std::mutex> guard(lock_);
+  auto& channel = hedge_channel_map_[url];
+  if (channel == nullptr) {
+    channel = std::make_shared<brpc::Channel>();
+    // locality aware, prefer the replica with lower latency
+    int ret = channel->Init(url.c_str(), "la", &options_);
+    CHECK_EQ(ret, 0) << "Fail init hedge channel url:" << url;
   }
 
-  CHECK_NOTNULL(channel.get());
-  rpc.Call(channel.get(), std::move(cb));
+  return channel;
 }
 
 }  // namespace sdk
@@ -15,12 +15,18 @@
 #ifndef DINGODB_SDK_RPC_INTERACTION_H_
 #define DINGODB_SDK_RPC_INTERACTION_H_
 
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <vector>
 
 #include "brpc/channel.h"
 #include "butil/endpoint.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
 #include "rpc.h"
 #include "sdk/utils/callback.h"
 
@@ -39,10 +45,32 @@ class RpcInteraction {
   virtual void SendRpc(Rpc &rpc, RpcCallback cb);
 
  private:
+  struct PooledChannel {
+    std::shared_ptr<brpc::Channel> channel;
+    std::atomic<int64_t> inflight{0};
+  };
+
+  // store_rpc_channel_num channels of an endpoint, every channel has its own connection group,
+  // so it has its own connection for single connection type.
+  struct EndPointChannels {
+    std::vector<std::unique_ptr<PooledChannel>> channels;
+    bvar::LatencyRecorder latency;
+    bvar::Adder<int64_t> inflight;
+  };
+
+  std::shared_ptr<EndPointChannels> GetEndPointChannels(const butil::EndPoint &endpoint);
+
+  // Channel with least inflight rpcs.
+  static PooledChannel *PickChannel(EndPointChannels &endpoint_channels);
+
+  // Channel load balanced over the endpoints, brpc sends the backup request to another endpoint.
+  std::shared_ptr<brpc::Channel> GetHedgeChannel(const std::vector<butil::EndPoint> &endpoints);
+
   brpc::ChannelOptions options_;
 
   std::mutex lock_;
-  std::map<butil::EndPoint, std::shared_ptr<brpc::Channel>> channel_map_;
+  std::map<butil::EndPoint, std::shared_ptr<EndPointChannels>> channel_map_;
+  std::map<std::string, std::shared_ptr<brpc::Channel>> hedge_channel_map_;
 };
 
 }  // namespace sdk
@@ -13,11 +13,15 @@
 // limitations under the License.
 #include "sdk/store/store_rpc_controller.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
 #include <utility>
 
 #include "brpc/controller.h"
 #include "butil/endpoint.h"
+#include "butil/fast_rand.h"
+#include "bvar/latency_recorder.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "fmt/core.h"
@@ -25,10 +29,12 @@
 #include "google/protobuf/message.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
+#include "proto/store.pb.h"
 #include "sdk/client_stub.h"
 #include "sdk/common/common.h"
 #include "sdk/common/param_config.h"
 #include "sdk/status.h"
+#include "sdk/store/store_rpc_retry_budget.h"
 #include "sdk/utils/async_util.h"
 
 namespace dingodb {
@@ -36,11 +42,26 @@ namespace sdk {
 
 using google::protobuf::DynamicCastToGenerated;
 
+static bvar::LatencyRecorder& StaleReadLatency() {
+  static bvar::LatencyRecorder latency;
+  return latency;
+}
+
+static StoreRpcRetryBudget& HedgeBudget() {
+  static StoreRpcRetryBudget budget(FLAGS_store_rpc_hedge_budget_percent, FLAGS_store_rpc_hedge_budget_burst);
+  return budget;
+}
+
 StoreRpcController::StoreRpcController(const ClientStub& stub, Rpc& rpc, std::shared_ptr<Region> region)
-    : stub_(stub), rpc_(rpc), region_(std::move(region)), rpc_retry_times_(0), next_replica_index_(0) {}
+    : stub_(stub),
+      rpc_(rpc),
+      region_(std::move(region)),
+      rpc_retry_times_(0),
+      next_replica_index_(0),
+      backoff_times_(0) {}
 
 StoreRpcController::StoreRpcController(const ClientStub& stub, Rpc& rpc)
-    : stub_(stub), rpc_(rpc), region_(nullptr), rpc_retry_times_(0), next_replica_index_(0) {}
+    : stub_(stub), rpc_(rpc), region_(nullptr), rpc_retry_times_(0), next_replica_index_(0), backoff_times_(0) {}
 
 StoreRpcController::~StoreRpcController() = default;
 
@@ -55,6 +76,7 @@ Status StoreRpcController::Call() {
 
 void StoreRpcController::AsyncCall(StatusCallback cb) {
   call_back_.swap(cb);
+  stub_.GetStoreRpcRetryBudget()->Deposit();
   DoAsyncCall();
 }
 
@@ -85,7 +107,9 @@ bool StoreRpcController::PreCheck() {
 bool StoreRpcController::PrepareRpc() {
   if (NeedPickLeader()) {
     butil::EndPoint next_leader;
-    if (!PickNextLeader(next_leader)) {
+    // stale read can be served by any replica, try the local one first
+    bool picked = rpc_retry_times_ == 0 && IsStaleRead(rpc_) && PickLocalReplica(next_leader);
+    if (!picked && !PickNextLeader(next_leader)) {
       std::string msg = fmt::format("rpc:{} no valid endpoint, region:{}", rpc_.Method(), region_->RegionId());
       status_ = Status::Aborted(msg);
       return false;
@@ -97,10 +121,29 @@ bool StoreRpcController::PrepareRpc() {
   }
 
   rpc_.Reset();
+  MaybeHedge();
 
   return true;
 }
 
+void StoreRpcController::MaybeHedge() {
+  rpc_.SetHedgeEndPoints({});
+  if (!FLAGS_enable_store_rpc_hedge || !IsStaleRead(rpc_)) {
+    return;
+  }
+
+  auto endpoints = region_->ReplicaEndPoint();
+  auto& budget = HedgeBudget();
+  budget.Deposit();
+  if (endpoints.size() < 2 || !budget.TryWithdraw()) {
+    return;
+  }
+
+  int64_t delay_ms = std::max(FLAGS_store_rpc_hedge_min_delay_ms, StaleReadLatency().latency_percentile(0.95) / 1000);
+  rpc_.MutableController()->set_backup_request_ms(delay_ms);
+  rpc_.SetHedgeEndPoints(std::move(endpoints));
+}
+
 void StoreRpcController::SendStoreRpc() {
   CHECK(region_.get() != nullptr) << "region should not nullptr, please check";
   MaybeDelay();
@@ -109,11 +152,25 @@ void StoreRpcController::SendStoreRpc() {
 
 void StoreRpcController::MaybeDelay() {
   if (NeedDelay()) {
-    DINGO_LOG(INFO) << "try to delay:" << FLAGS_store_rpc_retry_delay_ms << "ms";
-    (void)usleep(FLAGS_store_rpc_retry_delay_ms);
+    int64_t delay_ms = BackoffDelayMs();
+    backoff_times_++;
+    DINGO_LOG(INFO) << fmt::format("region:{} try to delay:{}ms, backoff_times:{}", region_->RegionId(), delay_ms,
+                                   backoff_times_);
+    (void)usleep(delay_ms * 1000);
   }
 }
 
+int64_t StoreRpcController::BackoffDelayMs() const {
+  int64_t max_delay_ms = std::max(static_cast<int64_t>(1), FLAGS_store_rpc_retry_delay_ms);
+  int64_t delay_ms = std::clamp(FLAGS_store_rpc_retry_base_delay_ms, static_cast<int64_t>(1), max_delay_ms);
+  for (int i = 0; i < backoff_times_ && delay_ms < max_delay_ms; ++i) {
+    delay_ms = std::min(max_delay_ms, delay_ms * 2);
+  }
+
+  // equal jitter, avoid all clients retry at the same time
+  return delay_ms / 2 + static_cast<int64_t>(butil::fast_rand_less_than(delay_ms / 2 + 1));
+}
+
 void StoreRpcController::SendStoreRpcCallBack() {
   Status sent = rpc_.GetStatus();
   if (!sent.ok()) {
@@ -124,6 +181,9 @@ void StoreRpcController::SendStoreRpcCallBack() {
     auto error = GetResponseError(rpc_);
     if (error.errcode() == pb::error::Errno::OK) {
       status_ = Status::OK();
+      if (FLAGS_enable_store_rpc_hedge && IsStaleRead(rpc_)) {
+        StaleReadLatency() << rpc_.Controller()->latency_us();
+      }
     } else {
       std::string base_msg = fmt::format("log_id:{} region:{} method:{} endpoint:{}, error_code:{}, error_msg:{}",
                                          rpc_.Controller()->log_id(), region_->RegionId(), rpc_.Method(),
@@ -185,6 +245,11 @@ void StoreRpcController::RetrySendRpcOrFireCallback() {
 
   if (status_.IsNetworkError() || status_.IsRemoteError() || status_.IsNotLeader()) {
     if (NeedRetry()) {
+      if (!stub_.GetStoreRpcRetryBudget()->TryWithdraw()) {
+        status_ = Status::Aborted("store rpc retry budget exhausted");
+        FireCallback();
+        return;
+      }
       rpc_retry_times_++;
       DoAsyncCall();
     } else {
@@ -229,6 +294,28 @@ bool StoreRpcController::PickNextLeader(butil::EndPoint& leader) {
   return true;
 }
 
+bool StoreRpcController::PickLocalReplica(butil::EndPoint& replica) {
+  for (const auto& endpoint : region_->ReplicaEndPoint()) {
+    if (endpoint.ip == butil::my_ip()) {
+      replica = endpoint;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool StoreRpcController::IsStaleRead(Rpc& rpc) {
+  const auto* request = rpc.RawRequest();
+  const auto* context_field = request->GetDescriptor()->FindFieldByName("context");
+  if (context_field == nullptr || context_field->type() != google::protobuf::FieldDescriptor::TYPE_MESSAGE) {
+    return false;
+  }
+
+  const auto& msg = request->GetReflection()->GetMessage(*request, context_field);
+  const auto* context = DynamicCastToGenerated<pb::store::Context>(&msg);
+  return context != nullptr && context->read_mode() == pb::store::ReadStale;
+}
+
 void StoreRpcController::ResetRegion(std::shared_ptr<Region> region) {
   if (region_) {
     if (!(EpochCompare(region_->Epoch(), region->Epoch()) > 0)) {
@@ -270,7 +357,15 @@ std::shared_ptr<Region> StoreRpcController::ProcessStoreRegionInfo(
 
 bool StoreRpcController::NeedRetry() const { return this->rpc_retry_times_ < FLAGS_store_rpc_max_retry; }
 
-bool StoreRpcController::NeedDelay() const { return status_.IsRemoteError(); }
+bool StoreRpcController::NeedDelay() const {
+  if (status_.IsRemoteError()) {
+    return true;
+  }
+
+  // no leader hint, maybe leader election in progress
+  butil::EndPoint leader;
+  return status_.IsNotLeader() && !region_->GetLeader(leader).IsOK();
+}
 
 bool StoreRpcController::NeedPickLeader() const { return !status_.IsRemoteError(); }
 
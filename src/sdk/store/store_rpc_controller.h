@@ -15,6 +15,7 @@
 #ifndef DINGODB_SDK_STORE_RPC_CONTROLLER_H_
 #define DINGODB_SDK_STORE_RPC_CONTROLLER_H_
 
+#include <cstdint>
 #include <memory>
 
 #include "butil/endpoint.h"
@@ -26,7 +27,12 @@
 namespace dingodb {
 namespace sdk {
 class DingoStub;
-// TODO: support backoff strategy
+// Retry policy:
+// 1. not leader with leader hint or network error, retry the next leader immediately.
+// 2. busy(request full) or not leader without hint, retry after exponential backoff with jitter.
+// 3. every retry costs the retry budget of client, give up when budget exhausted.
+// Stale read can be hedged, a backup request is sent to another replica if the chosen one
+// does not respond in the p95 latency of stale reads, limited by a global hedge budget.
 class StoreRpcController {
  public:
   explicit StoreRpcController(const ClientStub& stub, Rpc& rpc);
@@ -56,9 +62,17 @@ class StoreRpcController {
   // backoff
   void MaybeDelay();
   bool NeedDelay() const;
+  int64_t BackoffDelayMs() const;
 
   bool PickNextLeader(butil::EndPoint& leader);
 
+  // Replica on the same host, for stale read.
+  bool PickLocalReplica(butil::EndPoint& replica);
+
+  static bool IsStaleRead(Rpc& rpc);
+
+  void MaybeHedge();
+
   std::shared_ptr<Region> ProcessStoreRegionInfo(const dingodb::pb::error::StoreRegionInfo& store_region_info);
 
   bool NeedRetry() const;
@@ -72,6 +86,7 @@ class StoreRpcController {
   std::shared_ptr<Region> region_;
   int rpc_retry_times_;
   int next_replica_index_;
+  int backoff_times_;
   Status status_;
   StatusCallback call_back_;
 };
@@ -0,0 +1,63 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sdk/store/store_rpc_retry_budget.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "sdk/common/param_config.h"
+
+namespace dingodb {
+namespace sdk {
+
+static constexpr int64_t kTokenUnit = 100;
+
+StoreRpcRetryBudget::StoreRpcRetryBudget()
+    : StoreRpcRetryBudget(FLAGS_store_rpc_retry_budget_percent, FLAGS_store_rpc_retry_budget_burst) {}
+
+StoreRpcRetryBudget::StoreRpcRetryBudget(const int64_t& percent, const int64_t& burst)
+    : percent_(percent), burst_(burst), balance_(burst * kTokenUnit) {}
+
+void StoreRpcRetryBudget::Deposit() {
+  if (percent_ <= 0) {
+    return;
+  }
+
+  int64_t max_balance = burst_ * kTokenUnit;
+  int64_t balance = balance_.load(std::memory_order_relaxed);
+  while (balance < max_balance) {
+    int64_t next = std::min(max_balance, balance + percent_);
+    if (balance_.compare_exchange_weak(balance, next, std::memory_order_relaxed)) {
+      return;
+    }
+  }
+}
+
+bool StoreRpcRetryBudget::TryWithdraw() {
+  if (percent_ <= 0) {
+    return true;
+  }
+
+  int64_t balance = balance_.load(std::memory_order_relaxed);
+  while (balance >= kTokenUnit) {
+    if (balance_.compare_exchange_weak(balance, balance - kTokenUnit, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace sdk
+}  // namespace dingodb
@@ -0,0 +1,50 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SDK_STORE_RPC_RETRY_BUDGET_H_
+#define DINGODB_SDK_STORE_RPC_RETRY_BUDGET_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace dingodb {
+namespace sdk {
+
+// Limit the store rpc retries of a client to avoid retry storms when the cluster is overloaded.
+// Every new rpc earns percent/100 token, every retry costs one token, retry is refused when no token left.
+// The budget starts full and holds at most burst tokens, 0 percent means no limit.
+// percent and burst refer to flags, so they can be changed at runtime.
+class StoreRpcRetryBudget {
+ public:
+  // use store_rpc_retry_budget_percent and store_rpc_retry_budget_burst
+  StoreRpcRetryBudget();
+
+  StoreRpcRetryBudget(const int64_t& percent, const int64_t& burst);
+
+  ~StoreRpcRetryBudget() = default;
+
+  void Deposit();
+
+  bool TryWithdraw();
+
+ private:
+  const int64_t& percent_;
+  const int64_t& burst_;
+  // in unit of 1/100 token
+  std::atomic<int64_t> balance_;
+};
+
+}  // namespace sdk
+}  // namespace dingodb
+#endif  // DINGODB_SDK_STORE_RPC_RETRY_BUDGET_H_
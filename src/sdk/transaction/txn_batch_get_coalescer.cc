@@ -0,0 +1,131 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "sdk/transaction/txn_batch_get_coalescer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "common/logging.h"
+#include "glog/logging.h"
+#include "proto/store.pb.h"
+#include "sdk/client_stub.h"
+#include "sdk/common/common.h"
+#include "sdk/common/helper.h"
+#include "sdk/common/param_config.h"
+#include "sdk/status.h"
+#include "sdk/store/store_rpc.h"
+#include "sdk/transaction/txn_common.h"
+
+namespace dingodb {
+namespace sdk {
+
+TxnBatchGetCoalescer::TxnBatchGetCoalescer(const ClientStub& stub) : stub_(stub) {}
+
+bool TxnBatchGetCoalescer::TryGet(const std::shared_ptr<Region>& region, pb::store::IsolationLevel isolation_level,
+                                  int64_t start_ts, const std::string& key, std::string& value) {
+  auto batch_key = std::make_pair(region->RegionId(), static_cast<int>(isolation_level));
+  int64_t max_keys = std::max(static_cast<int64_t>(2), FLAGS_txn_batch_get_coalesce_max_keys);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  BatchPtr batch;
+  bool is_leader = false;
+  auto it = pending_batches_.find(batch_key);
+  // region changed, batch is full or key is read by another txn of the batch, start a new batch
+  if (it != pending_batches_.end() && it->second->region == region &&
+      static_cast<int64_t>(it->second->keys.size()) < max_keys &&
+      std::find(it->second->keys.begin(), it->second->keys.end(), key) == it->second->keys.end()) {
+    batch = it->second;
+  } else {
+    batch = std::make_shared<Batch>();
+    batch->region = region;
+    batch->isolation_level = isolation_level;
+    pending_batches_[batch_key] = batch;
+    is_leader = true;
+  }
+
+  batch->keys.push_back(key);
+  batch->start_ts.push_back(start_ts);
+
+  if (is_leader) {
+    cond_.wait_for(lock, std::chrono::microseconds(FLAGS_txn_batch_get_coalesce_window_us),
+                   [&]() { return static_cast<int64_t>(batch->keys.size()) >= max_keys; });
+    it = pending_batches_.find(batch_key);
+    if (it != pending_batches_.end() && it->second == batch) {
+      pending_batches_.erase(it);
+    }
+
+    if (batch->keys.size() == 1) {
+      // nobody joined, no need to coalesce
+      return false;
+    }
+
+    lock.unlock();
+    SendBatch(batch);
+    lock.lock();
+
+    batch->done = true;
+    cond_.notify_all();
+  } else {
+    if (static_cast<int64_t>(batch->keys.size()) >= max_keys) {
+      cond_.notify_all();
+    }
+    cond_.wait(lock, [&]() { return batch->done; });
+  }
+
+  if (!batch->ok) {
+    return false;
+  }
+
+  auto value_it = batch->values.find(key);
+  value = (value_it != batch->values.end()) ? value_it->second : "";
+  return true;
+}
+
+void TxnBatchGetCoalescer::SendBatch(const BatchPtr& batch) {
+  TxnBatchGetRpc rpc;
+  auto* request = rpc.MutableRequest();
+  request->set_start_ts(batch->start_ts.front());
+  FillRpcContext(*request->mutable_context(), batch->region->RegionId(), batch->region->Epoch(),
+                 batch->isolation_level);
+  for (size_t i = 0; i < batch->keys.size(); ++i) {
+    request->add_keys(batch->keys[i]);
+    request->add_key_start_ts(batch->start_ts[i]);
+  }
+
+  Status ret = LogAndSendRpc(stub_, rpc, batch->region);
+  if (ret.ok() && rpc.Response()->has_txn_result()) {
+    ret = CheckTxnResultInfo(rpc.Response()->txn_result());
+  }
+
+  if (!ret.ok()) {
+    DINGO_LOG(DEBUG) << "coalesced txn batch get fail, region:" << batch->region->RegionId()
+                     << " keys:" << batch->keys.size() << " status:" << ret.ToString();
+    return;
+  }
+
+  for (const auto& kv : rpc.Response()->kvs()) {
+    batch->values[kv.key()] = kv.value();
+  }
+  batch->ok = true;
+}
+
+}  // namespace sdk
+}  // namespace dingodb
@@ -0,0 +1,80 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_SDK_TRANSACTION_BATCH_GET_COALESCER_H_
+#define DINGODB_SDK_TRANSACTION_BATCH_GET_COALESCER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "proto/store.pb.h"
+#include "sdk/region.h"
+
+namespace dingodb {
+namespace sdk {
+
+class ClientStub;
+
+// Coalesce concurrent point gets of different txns to the same region into one TxnBatchGet rpc,
+// every key carries the start_ts of its txn.
+// The first get of a region waits txn_batch_get_coalesce_window_us for others then sends the rpc.
+// Any error of the coalesced rpc, including lock conflict, is not handled here,
+// the caller fallback to its own get which resolves locks and retries.
+class TxnBatchGetCoalescer {
+ public:
+  explicit TxnBatchGetCoalescer(const ClientStub& stub);
+
+  virtual ~TxnBatchGetCoalescer() = default;
+
+  // Return true if the get is done by coalesced rpc, value is empty if key not found.
+  // Return false if the caller should do the get by itself.
+  virtual bool TryGet(const std::shared_ptr<Region>& region, pb::store::IsolationLevel isolation_level,
+                      int64_t start_ts, const std::string& key, std::string& value);
+
+ private:
+  struct Batch {
+    std::shared_ptr<Region> region;
+    pb::store::IsolationLevel isolation_level;
+    std::vector<std::string> keys;
+    std::vector<int64_t> start_ts;
+    // key -> value, only valid when done and ok
+    std::unordered_map<std::string, std::string> values;
+    bool done{false};
+    bool ok{false};
+  };
+  using BatchPtr = std::shared_ptr<Batch>;
+
+  // Send the rpc of batch, the batch is not visible to new gets any more.
+  void SendBatch(const BatchPtr& batch);
+
+  const ClientStub& stub_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  // (region_id, isolation_level) -> batch accepting new keys
+  std::map<std::pair<int64_t, int>, BatchPtr> pending_batches_;
+};
+
+}  // namespace sdk
+}  // namespace dingodb
+
+#endif  // DINGODB_SDK_TRANSACTION_BATCH_GET_COALESCER_H_
@@ -117,8 +117,18 @@ std::string TxnBuffer::GetPrimaryKey() {
   return primary_key_;
 }
 
+std::map<std::string, TxnMutation> TxnBuffer::TakeMutations() {
+  if (!primary_key_.empty()) {
+    primary_key_fixed_ = true;
+  }
+
+  std::map<std::string, TxnMutation> mutations;
+  mutations.swap(mutation_map_);
+  return mutations;
+}
+
 void TxnBuffer::Erase(const std::string& key) {
-  if (key == primary_key_) {
+  if (key == primary_key_ && !primary_key_fixed_) {
     primary_key_.clear();
   }
 
@@ -104,12 +104,16 @@ class TxnBuffer {
 
   const std::map<std::string, TxnMutation>& Mutations() { return mutation_map_; }
 
+  // Move out all mutations to flush for pipelined txn, the primary key is kept and fixed since then.
+  std::map<std::string, TxnMutation> TakeMutations();
+
  private:
   void Erase(const std::string& key);
 
   void Emplace(const std::string& key, TxnMutation&& mutation);
 
   std::string primary_key_;
+  bool primary_key_fixed_{false};
   std::map<std::string, TxnMutation> mutation_map_;
 };
 
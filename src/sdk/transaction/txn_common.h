@@ -33,6 +33,13 @@ static pb::store::IsolationLevel TransactionIsolation2IsolationLevel(Transaction
   }
 }
 
+// Stale read is served by any replica without raft round trip if the data is resolved.
+static void MaybeSetStaleRead(pb::store::Context& context, const TransactionOptions& options) {
+  if (options.stale_read_ms > 0) {
+    context.set_read_mode(pb::store::ReadStale);
+  }
+}
+
 static Status CheckTxnResultInfo(const pb::store::TxnResultInfo& txn_result_info) {
   if (txn_result_info.has_locked()) {
     return Status::TxnLockConflict(txn_result_info.locked().DebugString());
@@ -14,8 +14,14 @@
 
 #include "sdk/transaction/txn_impl.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -40,10 +46,22 @@ namespace sdk {
 Transaction::TxnImpl::TxnImpl(const ClientStub& stub, const TransactionOptions& options)
     : stub_(stub), options_(options), state_(kInit), buffer_(new TxnBuffer()) {}
 
+Transaction::TxnImpl::~TxnImpl() {
+  if (flush_thread_.joinable()) {
+    flush_thread_.join();
+  }
+}
+
 Status Transaction::TxnImpl::Begin() {
   pb::meta::TsoTimestamp tso;
-  Status ret = stub_.GetAdminTool()->GetCurrentTsoTimeStamp(tso);
+  // start ts can be a little stale, use the prefetched one
+  Status ret = stub_.GetAdminTool()->GetCurrentTsoTimeStamp(tso, true);
   if (ret.ok()) {
+    if (options_.stale_read_ms > 0) {
+      // physical of tso is ms
+      tso.set_physical(tso.physical() - options_.stale_read_ms);
+      tso.set_logical(0);
+    }
     start_tso_ = tso;
     start_ts_ = Tso2Timestamp(start_tso_);
     state_ = kActive;
@@ -56,6 +74,7 @@ std::unique_ptr<TxnGetRpc> Transaction::TxnImpl::PrepareTxnGetRpc(const std::sha
   rpc->MutableRequest()->set_start_ts(start_ts_);
   FillRpcContext(*rpc->MutableRequest()->mutable_context(), region->RegionId(), region->Epoch(),
                  TransactionIsolation2IsolationLevel(options_.isolation));
+  MaybeSetStaleRead(*rpc->MutableRequest()->mutable_context(), options_);
   return std::move(rpc);
 }
 
@@ -66,6 +85,12 @@ Status Transaction::TxnImpl::DoTxnGet(const std::string& key, std::string& value
     return ret;
   }
 
+  if (FLAGS_enable_txn_batch_get_coalesce && options_.stale_read_ms == 0 &&
+      stub_.GetTxnBatchGetCoalescer()->TryGet(region, TransactionIsolation2IsolationLevel(options_.isolation),
+                                              start_ts_, key, value)) {
+    return value.empty() ? Status::NotFound(fmt::format("key:{} not found", key)) : Status::OK();
+  }
+
   std::unique_ptr<TxnGetRpc> rpc = PrepareTxnGetRpc(region);
   rpc->MutableRequest()->set_key(key);
 
@@ -131,7 +156,23 @@ Status Transaction::TxnImpl::Get(const std::string& key, std::string& value) {
     }
   }
 
-  return DoTxnGet(key, value);
+  std::string cached_value;
+  if (GetReadCache(key, cached_value)) {
+    if (cached_value.empty()) {
+      return Status::NotFound(fmt::format("key:{} not found", key));
+    }
+    value = std::move(cached_value);
+    return Status::OK();
+  }
+
+  ret = DoTxnGet(key, value);
+  if (ret.ok()) {
+    PutReadCache(key, value);
+  } else if (ret.IsNotFound()) {
+    PutReadCache(key, "");
+  }
+
+  return ret;
 }
 
 void Transaction::TxnImpl::ProcessTxnBatchGetSubTask(TxnSubTask* sub_task) {
@@ -174,9 +215,9 @@ void Transaction::TxnImpl::ProcessTxnBatchGetSubTask(TxnSubTask* sub_task) {
   }
 
   if (res.ok()) {
-    for (const auto& kv : rpc->Response()->kvs()) {
+    for (auto& kv : *rpc->MutableResponse()->mutable_kvs()) {
       if (!kv.value().empty()) {
-        sub_task->result_kvs.push_back({kv.key(), kv.value()});
+        sub_task->result_kvs.push_back({std::move(*kv.mutable_key()), std::move(*kv.mutable_value())});
       } else {
         DINGO_LOG(DEBUG) << "Ignore kv key:" << kv.key() << " because value is empty";
       }
@@ -192,6 +233,7 @@ std::unique_ptr<TxnBatchGetRpc> Transaction::TxnImpl::PrepareTxnBatchGetRpc(
   rpc->MutableRequest()->set_start_ts(start_ts_);
   FillRpcContext(*rpc->MutableRequest()->mutable_context(), region->RegionId(), region->Epoch(),
                  TransactionIsolation2IsolationLevel(options_.isolation));
+  MaybeSetStaleRead(*rpc->MutableRequest()->mutable_context(), options_);
   return std::move(rpc);
 }
 
@@ -292,13 +334,23 @@ Status Transaction::TxnImpl::BatchGet(const std::vector<std::string>& keys, std:
       }
     } else {
       CHECK(ret.IsNotFound());
+      std::string cached_value;
+      if (GetReadCache(key, cached_value)) {
+        if (!cached_value.empty()) {
+          to_return.push_back({key, std::move(cached_value)});
+        }
+        continue;
+      }
       not_found.push_back(key);
     }
   }
 
+  // not found of buffer is not the result
+  ret = Status::OK();
   if (!not_found.empty()) {
     std::vector<KVPair> batch_get;
     ret = DoTxnBatchGet(not_found, batch_get);
+    PutReadCache(not_found, batch_get, ret.ok());
     to_return.insert(to_return.end(), std::make_move_iterator(batch_get.begin()),
                      std::make_move_iterator(batch_get.end()));
   }
@@ -308,19 +360,116 @@ Status Transaction::TxnImpl::BatchGet(const std::vector<std::string>& keys, std:
   return ret;
 }
 
-Status Transaction::TxnImpl::Put(const std::string& key, const std::string& value) { return buffer_->Put(key, value); }
+Status Transaction::TxnImpl::Prefetch(const std::vector<std::string>& keys) {
+  if (!IsReadCacheEnabled()) {
+    return Status::OK();
+  }
+
+  std::set<std::string> to_fetch;
+  for (const auto& key : keys) {
+    TxnMutation mutation;
+    std::string cached_value;
+    if (buffer_->Get(key, mutation).ok() || GetReadCache(key, cached_value)) {
+      continue;
+    }
+    to_fetch.insert(key);
+  }
+  if (to_fetch.empty()) {
+    return Status::OK();
+  }
 
-Status Transaction::TxnImpl::BatchPut(const std::vector<KVPair>& kvs) { return buffer_->BatchPut(kvs); }
+  // one batch get rpc per region
+  std::vector<std::string> fetch_keys(to_fetch.begin(), to_fetch.end());
+  std::vector<KVPair> kvs;
+  Status ret = DoTxnBatchGet(fetch_keys, kvs);
+  PutReadCache(fetch_keys, kvs, ret.ok());
+
+  return ret;
+}
+
+bool Transaction::TxnImpl::IsReadCacheEnabled() const {
+  return options_.isolation == kSnapshotIsolation && FLAGS_txn_read_cache_max_keys > 0;
+}
+
+bool Transaction::TxnImpl::GetReadCache(const std::string& key, std::string& value) const {
+  if (!IsReadCacheEnabled()) {
+    return false;
+  }
+
+  auto iter = read_cache_.find(key);
+  if (iter == read_cache_.end()) {
+    return false;
+  }
+
+  value = iter->second;
+  return true;
+}
+
+void Transaction::TxnImpl::PutReadCache(const std::string& key, const std::string& value) {
+  if (!IsReadCacheEnabled()) {
+    return;
+  }
+
+  // when full, the cached keys are kept and the others are always read from store
+  if (static_cast<int64_t>(read_cache_.size()) >= FLAGS_txn_read_cache_max_keys &&
+      read_cache_.find(key) == read_cache_.end()) {
+    return;
+  }
+
+  read_cache_[key] = value;
+}
+
+void Transaction::TxnImpl::PutReadCache(const std::vector<std::string>& keys, const std::vector<KVPair>& kvs,
+                                        bool is_complete) {
+  if (!IsReadCacheEnabled()) {
+    return;
+  }
+
+  std::set<std::string> found_keys;
+  for (const auto& kv : kvs) {
+    PutReadCache(kv.key, kv.value);
+    found_keys.insert(kv.key);
+  }
+
+  // the failed sub task returns no kvs, its keys may exist
+  if (is_complete) {
+    for (const auto& key : keys) {
+      if (found_keys.count(key) == 0) {
+        PutReadCache(key, "");
+      }
+    }
+  }
+}
+
+Status Transaction::TxnImpl::Put(const std::string& key, const std::string& value) {
+  DINGO_RETURN_NOT_OK(buffer_->Put(key, value));
+  return MaybeFlushBuffer();
+}
+
+Status Transaction::TxnImpl::BatchPut(const std::vector<KVPair>& kvs) {
+  DINGO_RETURN_NOT_OK(buffer_->BatchPut(kvs));
+  return MaybeFlushBuffer();
+}
 
 Status Transaction::TxnImpl::PutIfAbsent(const std::string& key, const std::string& value) {
-  return buffer_->PutIfAbsent(key, value);
+  DINGO_RETURN_NOT_OK(buffer_->PutIfAbsent(key, value));
+  return MaybeFlushBuffer();
 }
 
-Status Transaction::TxnImpl::BatchPutIfAbsent(const std::vector<KVPair>& kvs) { return buffer_->BatchPutIfAbsent(kvs); }
+Status Transaction::TxnImpl::BatchPutIfAbsent(const std::vector<KVPair>& kvs) {
+  DINGO_RETURN_NOT_OK(buffer_->BatchPutIfAbsent(kvs));
+  return MaybeFlushBuffer();
+}
 
-Status Transaction::TxnImpl::Delete(const std::string& key) { return buffer_->Delete(key); }
+Status Transaction::TxnImpl::Delete(const std::string& key) {
+  DINGO_RETURN_NOT_OK(buffer_->Delete(key));
+  return MaybeFlushBuffer();
+}
 
-Status Transaction::TxnImpl::BatchDelete(const std::vector<std::string>& keys) { return buffer_->BatchDelete(keys); }
+Status Transaction::TxnImpl::BatchDelete(const std::vector<std::string>& keys) {
+  DINGO_RETURN_NOT_OK(buffer_->BatchDelete(keys));
+  return MaybeFlushBuffer();
+}
 
 Status Transaction::TxnImpl::Scan(const std::string& start_key, const std::string& end_key, uint64_t limit,
                                   std::vector<KVPair>& kvs) {
@@ -504,18 +653,14 @@ void Transaction::TxnImpl::CheckAndLogPreCommitPrimaryKeyResponse(
 Status Transaction::TxnImpl::TryResolveTxnPrewriteLockConflict(const pb::store::TxnPrewriteResponse* response) const {
   Status ret;
   std::string pk = buffer_->GetPrimaryKey();
+  std::vector<pb::store::LockInfo> lock_infos;
   for (const auto& txn_result : response->txn_result()) {
     ret = CheckTxnResultInfo(txn_result);
 
     if (ret.ok()) {
       continue;
     } else if (ret.IsTxnLockConflict()) {
-      Status resolve = stub_.GetTxnLockResolver()->ResolveLock(txn_result.locked(), start_ts_);
-      if (!resolve.ok()) {
-        DINGO_LOG(WARNING) << "fail resolve lock pk:" << pk << ", status:" << ret.ToString()
-                           << " txn_result:" << txn_result.DebugString();
-        ret = resolve;
-      }
+      lock_infos.push_back(txn_result.locked());
     } else if (ret.IsTxnWriteConflict()) {
       DINGO_LOG(WARNING) << "write conflict pk:" << pk << ", status:" << ret.ToString()
                          << " txn_result:" << txn_result.DebugString();
@@ -526,6 +671,16 @@ Status Transaction::TxnImpl::TryResolveTxnPrewriteLockConflict(const pb::store::
     }
   }
 
+  // resolve all conflict locks together, the locks of same txn are resolved by one check
+  if (!lock_infos.empty()) {
+    Status resolve = stub_.GetTxnLockResolver()->ResolveLocks(lock_infos, start_ts_);
+    if (!resolve.ok()) {
+      DINGO_LOG(WARNING) << "fail resolve locks pk:" << pk << ", lock_count:" << lock_infos.size()
+                         << ", status:" << resolve.ToString();
+      ret = resolve;
+    }
+  }
+
   return ret;
 }
 
@@ -612,11 +767,33 @@ void Transaction::TxnImpl::ProcessTxnPrewriteSubTask(TxnSubTask* sub_task) {
 Status Transaction::TxnImpl::PreCommit() {
   state_ = kPreCommitting;
 
+  if (is_flushed_) {
+    // pipelined txn, primary key is prewritten in the first flush, just flush the rest mutations
+    DINGO_RETURN_NOT_OK(WaitFlushBuffer());
+    auto mutations = buffer_->TakeMutations();
+    DINGO_RETURN_NOT_OK(PrepareFlushSubTasks(mutations, false));
+    ProcessFlushSubTasks(false);
+    DINGO_RETURN_NOT_OK(WaitFlushBuffer());
+    state_ = kPreCommitted;
+    return Status::OK();
+  }
+
   if (buffer_->IsEmpty()) {
     state_ = kPreCommitted;
     return Status::OK();
   }
 
+  if (options_.stale_read_ms > 0) {
+    return Status::IllegalState("stale read txn is read only");
+  }
+
+  std::shared_ptr<Region> single_region;
+  if (LookupSingleRegion(single_region)) {
+    DINGO_RETURN_NOT_OK(PreCommitSingleRegion(single_region));
+    state_ = kPreCommitted;
+    return Status::OK();
+  }
+
   DINGO_RETURN_NOT_OK(PreCommitPrimaryKey());
 
   // TODO: start heartbeat
@@ -775,13 +952,52 @@ void Transaction::TxnImpl::ProcessTxnCommitSubTask(TxnSubTask* sub_task) {
   sub_task->status = ret;
 }
 
+// async secondary commit rpcs of all txns
+static std::atomic<int64_t> g_async_commit_secondary_inflight{0};
+
+bool Transaction::TxnImpl::AsyncCommitSecondaries(const std::vector<TxnSubTask>& sub_tasks,
+                                                  std::vector<std::unique_ptr<TxnCommitRpc>>& rpcs) {
+  auto count = static_cast<int64_t>(rpcs.size());
+  if (g_async_commit_secondary_inflight.fetch_add(count) + count > FLAGS_txn_async_commit_secondary_max_inflight) {
+    g_async_commit_secondary_inflight.fetch_sub(count);
+    DINGO_LOG(DEBUG) << "too many async commit secondary rpcs, commit synchronously, start_ts:" << start_ts_;
+    return false;
+  }
+
+  auto actuator = stub_.GetActuator();
+  const ClientStub& stub = stub_;
+  int64_t start_ts = start_ts_;
+  for (size_t i = 0; i < rpcs.size(); ++i) {
+    // the txn may be destroyed before rpc done, so only the stub is referred.
+    std::shared_ptr<TxnCommitRpc> rpc(std::move(rpcs[i]));
+    std::shared_ptr<Region> region = sub_tasks[i].region;
+    bool scheduled = actuator->Execute([&stub, rpc, region, start_ts]() {
+      Status ret = LogAndSendRpc(stub, *rpc, region);
+      if (!ret.ok() || rpc->Response()->has_txn_result()) {
+        DINGO_LOG(INFO) << "Fail async txn_commit_sub_task but ignore, start_ts:" << start_ts
+                        << " region: " << region->RegionId() << " status: " << ret.ToString()
+                        << " response: " << rpc->Response()->ShortDebugString();
+      }
+      g_async_commit_secondary_inflight.fetch_sub(1);
+    });
+    if (!scheduled) {
+      DINGO_LOG(INFO) << "Fail schedule async txn_commit_sub_task but ignore, start_ts:" << start_ts
+                      << " region: " << region->RegionId();
+      g_async_commit_secondary_inflight.fetch_sub(1);
+    }
+  }
+
+  rpcs.clear();
+  return true;
+}
+
 Status Transaction::TxnImpl::Commit() {
   if (state_ != kPreCommitted) {
     return Status::IllegalState(fmt::format("forbid commit, txn state is:{}, expect:{}", TransactionState2Str(state_),
                                             TransactionState2Str(kPreCommitted)));
   }
 
-  if (buffer_->IsEmpty()) {
+  if (buffer_->IsEmpty() && !is_flushed_) {
     state_ = kCommitted;
     return Status::OK();
   }
@@ -795,6 +1011,20 @@ Status Transaction::TxnImpl::Commit() {
   CHECK(commit_ts_ > start_ts_) << "commit_ts:" << commit_ts_ << " must greater than start_ts:" << start_ts_
                                 << ", commit_tso:" << commit_tso_.DebugString()
                                 << ", start_tso:" << start_tso_.DebugString();
+  // region may be split after prewrite, then fall back to commit primary key first.
+  std::shared_ptr<Region> single_region;
+  if (LookupSingleRegion(single_region)) {
+    Status ret = CommitSingleRegion(single_region);
+    if (ret.ok()) {
+      state_ = kCommitted;
+    } else if (ret.IsTxnRolledBack()) {
+      state_ = kRollbackted;
+    } else {
+      DINGO_LOG(INFO) << "unexpect commit single region status:" << ret.ToString();
+    }
+    return ret;
+  }
+
   // TODO: if commit primary key and find txn is rolled back, should we rollback all the mutation?
   Status ret = CommitPrimaryKey();
   if (!ret.ok()) {
@@ -852,6 +1082,11 @@ Status Transaction::TxnImpl::Commit() {
       DCHECK_EQ(rpcs.size(), region_commit_keys.size());
       DCHECK_EQ(rpcs.size(), sub_tasks.size());
 
+      // flushed ranges are resolved after secondary keys committed, so not async for pipelined txn
+      if (FLAGS_enable_txn_async_commit_secondary && !is_flushed_ && AsyncCommitSecondaries(sub_tasks, rpcs)) {
+        return ret;
+      }
+
       std::vector<std::thread> thread_pool;
       thread_pool.reserve(sub_tasks.size());
       for (auto& sub_task : sub_tasks) {
@@ -870,11 +1105,68 @@ Status Transaction::TxnImpl::Commit() {
         }
       }
     }
+
+    if (is_flushed_) {
+      ResolveFlushedRanges(commit_ts_);
+    }
   }
 
   return ret;
 }
 
+bool Transaction::TxnImpl::LookupSingleRegion(std::shared_ptr<Region>& region) const {
+  if (!FLAGS_enable_txn_single_region_commit || buffer_->MutationsSize() > FLAGS_txn_single_region_commit_max_keys) {
+    return false;
+  }
+
+  auto meta_cache = stub_.GetMetaCache();
+  for (const auto& mutaion_entry : buffer_->Mutations()) {
+    std::shared_ptr<Region> tmp;
+    Status got = meta_cache->LookupRegionByKey(mutaion_entry.first, tmp);
+    if (!got.IsOK()) {
+      return false;
+    }
+
+    if (region == nullptr) {
+      region = tmp;
+    } else if (region->RegionId() != tmp->RegionId()) {
+      region.reset();
+      return false;
+    }
+  }
+
+  return region != nullptr;
+}
+
+Status Transaction::TxnImpl::PreCommitSingleRegion(const std::shared_ptr<Region>& region) {
+  std::unique_ptr<TxnPrewriteRpc> rpc = PrepareTxnPrewriteRpc(region);
+  for (const auto& mutaion_entry : buffer_->Mutations()) {
+    TxnMutation2MutationPB(mutaion_entry.second, rpc->MutableRequest()->add_mutations());
+  }
+
+  TxnSubTask sub_task(rpc.get(), region);
+  ProcessTxnPrewriteSubTask(&sub_task);
+
+  return sub_task.status;
+}
+
+Status Transaction::TxnImpl::CommitSingleRegion(const std::shared_ptr<Region>& region) {
+  std::string pk = buffer_->GetPrimaryKey();
+
+  std::unique_ptr<TxnCommitRpc> rpc = PrepareTxnCommitRpc(region);
+  *rpc->MutableRequest()->add_keys() = pk;
+  for (const auto& mutaion_entry : buffer_->Mutations()) {
+    if (mutaion_entry.first != pk) {
+      *rpc->MutableRequest()->add_keys() = mutaion_entry.second.key;
+    }
+  }
+
+  DINGO_RETURN_NOT_OK(LogAndSendRpc(stub_, *rpc, region));
+
+  const auto* response = rpc->Response();
+  return ProcessTxnCommitResponse(response, true);
+}
+
 std::unique_ptr<TxnBatchRollbackRpc> Transaction::TxnImpl::PrepareTxnBatchRollbackRpc(
     const std::shared_ptr<Region>& region) const {
   auto rpc = std::make_unique<TxnBatchRollbackRpc>();
@@ -927,6 +1219,14 @@ Status Transaction::TxnImpl::Rollback() {
   }
 
   state_ = kRollbacking;
+  if (is_flushed_) {
+    // locks of failed flush are rolled back too
+    Status flushed = WaitFlushBuffer();
+    if (!flushed.ok()) {
+      DINGO_LOG(INFO) << "flush txn buffer fail, start_ts:" << start_ts_ << ", status:" << flushed.ToString();
+    }
+  }
+
   {
     // rollback primary key
     std::string pk = buffer_->GetPrimaryKey();
@@ -1005,7 +1305,9 @@ Status Transaction::TxnImpl::Rollback() {
       thread_pool.emplace_back(&Transaction::TxnImpl::ProcessBatchRollbackSubTask, this, &sub_tasks[i]);
     }
 
-    ProcessBatchRollbackSubTask(sub_tasks.data());
+    if (!sub_tasks.empty()) {
+      ProcessBatchRollbackSubTask(sub_tasks.data());
+    }
 
     for (auto& thread : thread_pool) {
       thread.join();
@@ -1018,11 +1320,204 @@ Status Transaction::TxnImpl::Rollback() {
                         << " send to region: " << state.region->RegionId() << " status: " << state.status.ToString();
       }
     }
+
+    if (is_flushed_) {
+      ResolveFlushedRanges(0);
+    }
   }
 
   return Status::OK();
 }
 
+Status Transaction::TxnImpl::MaybeFlushBuffer() {
+  if (options_.stale_read_ms > 0) {
+    return Status::IllegalState("stale read txn is read only");
+  }
+
+  if (FLAGS_txn_pipelined_flush_mutations <= 0 || buffer_->MutationsSize() < FLAGS_txn_pipelined_flush_mutations) {
+    return Status::OK();
+  }
+
+  // only one flush is in flight, so at most two batches of mutations are in memory
+  DINGO_RETURN_NOT_OK(WaitFlushBuffer());
+
+  bool is_first_flush = !is_flushed_;
+  is_flushed_ = true;
+  auto mutations = buffer_->TakeMutations();
+  // flushed keys are not in buffer anymore, don't read the values cached before they are written
+  for (const auto& [key, mutation] : mutations) {
+    read_cache_.erase(key);
+  }
+  Status ret = PrepareFlushSubTasks(mutations, is_first_flush);
+  if (!ret.ok()) {
+    // mutations are lost, txn can only be rolled back
+    flush_status_ = ret;
+    return ret;
+  }
+
+  flush_thread_ = std::thread(&Transaction::TxnImpl::ProcessFlushSubTasks, this, is_first_flush);
+  return Status::OK();
+}
+
+Status Transaction::TxnImpl::WaitFlushBuffer() {
+  if (flush_thread_.joinable()) {
+    flush_thread_.join();
+  }
+
+  flush_sub_tasks_.clear();
+  flush_rpcs_.clear();
+  return flush_status_;
+}
+
+Status Transaction::TxnImpl::PrepareFlushSubTasks(const std::map<std::string, TxnMutation>& mutations,
+                                                  bool is_first_flush) {
+  auto meta_cache = stub_.GetMetaCache();
+  std::string pk = buffer_->GetPrimaryKey();
+
+  auto add_rpc = [&](const std::shared_ptr<Region>& region) {
+    flush_rpcs_.push_back(PrepareTxnPrewriteRpc(region));
+    flush_sub_tasks_.emplace_back(flush_rpcs_.back().get(), region);
+    return flush_rpcs_.back().get();
+  };
+
+  if (is_first_flush) {
+    auto iter = mutations.find(pk);
+    if (iter != mutations.end()) {
+      std::shared_ptr<Region> region;
+      DINGO_RETURN_NOT_OK(meta_cache->LookupRegionByKey(pk, region));
+      TxnMutation2MutationPB(iter->second, add_rpc(region)->MutableRequest()->add_mutations());
+      AddFlushedRange(pk, pk + '\0');
+    }
+  }
+
+  // keys are in order, so the mutations of a region are adjacent
+  TxnPrewriteRpc* rpc = nullptr;
+  std::shared_ptr<Region> region;
+  std::string start_key;
+  std::string last_key;
+  for (const auto& mutaion_entry : mutations) {
+    if (is_first_flush && mutaion_entry.first == pk) {
+      continue;
+    }
+
+    std::shared_ptr<Region> tmp;
+    DINGO_RETURN_NOT_OK(meta_cache->LookupRegionByKey(mutaion_entry.first, tmp));
+
+    if (rpc == nullptr || tmp->RegionId() != region->RegionId() ||
+        rpc->Request()->mutations_size() >= FLAGS_txn_pipelined_flush_batch_size) {
+      if (rpc != nullptr) {
+        AddFlushedRange(start_key, last_key + '\0');
+      }
+      region = tmp;
+      rpc = add_rpc(region);
+      start_key = mutaion_entry.first;
+    }
+
+    TxnMutation2MutationPB(mutaion_entry.second, rpc->MutableRequest()->add_mutations());
+    last_key = mutaion_entry.first;
+  }
+
+  if (rpc != nullptr) {
+    AddFlushedRange(start_key, last_key + '\0');
+  }
+
+  return Status::OK();
+}
+
+void Transaction::TxnImpl::ProcessFlushSubTasks(bool is_first_flush) {
+  size_t begin = 0;
+  if (is_first_flush && !flush_sub_tasks_.empty()) {
+    // prewrite primary key before secondary keys, like PreCommitPrimaryKey
+    ProcessTxnPrewriteSubTask(flush_sub_tasks_.data());
+    if (!flush_sub_tasks_[0].status.ok()) {
+      flush_status_ = flush_sub_tasks_[0].status;
+      return;
+    }
+    begin = 1;
+  }
+
+  std::vector<std::thread> thread_pool;
+  thread_pool.reserve(flush_sub_tasks_.size() - begin);
+  for (size_t i = begin; i < flush_sub_tasks_.size(); i++) {
+    thread_pool.emplace_back(&Transaction::TxnImpl::ProcessTxnPrewriteSubTask, this, &flush_sub_tasks_[i]);
+  }
+
+  for (auto& thread : thread_pool) {
+    thread.join();
+  }
+
+  for (auto& state : flush_sub_tasks_) {
+    if (!state.status.IsOK()) {
+      DINGO_LOG(WARNING) << "fail txn_flush_sub_task, rpc: " << state.rpc->Method()
+                         << " send to region: " << state.region->RegionId() << " status: " << state.status.ToString();
+      if (flush_status_.ok()) {
+        // only keep first fail status
+        flush_status_ = state.status;
+      }
+    }
+  }
+}
+
+void Transaction::TxnImpl::AddFlushedRange(const std::string& start_key, const std::string& end_key) {
+  std::string new_start_key = start_key;
+  std::string new_end_key = end_key;
+
+  auto iter = flushed_ranges_.upper_bound(new_start_key);
+  if (iter != flushed_ranges_.begin()) {
+    auto prev = std::prev(iter);
+    if (prev->second >= new_start_key) {
+      new_start_key = prev->first;
+      new_end_key = std::max(new_end_key, prev->second);
+      flushed_ranges_.erase(prev);
+    }
+  }
+
+  while (iter != flushed_ranges_.end() && iter->first <= new_end_key) {
+    new_end_key = std::max(new_end_key, iter->second);
+    iter = flushed_ranges_.erase(iter);
+  }
+
+  flushed_ranges_.emplace(new_start_key, new_end_key);
+}
+
+void Transaction::TxnImpl::ResolveFlushedRanges(int64_t commit_ts) {
+  // try best to resolve, the locks left are resolved by others with primary key
+  auto meta_cache = stub_.GetMetaCache();
+  std::set<int64_t> resolved_region_ids;
+  for (const auto& range : flushed_ranges_) {
+    std::string key = range.first;
+    while (key < range.second) {
+      std::shared_ptr<Region> region;
+      Status ret = meta_cache->LookupRegionByKey(key, region);
+      if (!ret.ok()) {
+        DINGO_LOG(INFO) << "lookup region fail but ignore, key:" << key << ", status:" << ret.ToString();
+        break;
+      }
+
+      if (resolved_region_ids.insert(region->RegionId()).second) {
+        // no keys means all locks of the txn in region
+        TxnResolveLockRpc rpc;
+        FillRpcContext(*rpc.MutableRequest()->mutable_context(), region->RegionId(), region->Epoch(),
+                       TransactionIsolation2IsolationLevel(options_.isolation));
+        rpc.MutableRequest()->set_start_ts(start_ts_);
+        rpc.MutableRequest()->set_commit_ts(commit_ts);
+
+        ret = LogAndSendRpc(stub_, rpc, region);
+        if (!ret.ok()) {
+          DINGO_LOG(INFO) << "Fail txn_resolve_lock but ignore, region: " << region->RegionId()
+                          << " status: " << ret.ToString();
+        }
+      }
+
+      const auto& region_end_key = region->Range().end_key();
+      if (region_end_key <= key) {
+        break;
+      }
+      key = region_end_key;
+    }
+  }
+}
+
 bool Transaction::TxnImpl::NeedRetryAndInc(int& times) {
   bool retry = times < FLAGS_txn_op_max_retry;
   times++;
@@ -16,7 +16,12 @@
 #define DINGODB_SDK_TRANSACTION_IMPL_H_
 
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include "proto/meta.pb.h"
 #include "proto/store.pb.h"
@@ -71,7 +76,7 @@ class Transaction::TxnImpl {
 
   explicit TxnImpl(const ClientStub& stub, const TransactionOptions& options);
 
-  ~TxnImpl() = default;
+  ~TxnImpl();
 
   Status Begin();
 
@@ -79,6 +84,8 @@ class Transaction::TxnImpl {
 
   Status BatchGet(const std::vector<std::string>& keys, std::vector<KVPair>& kvs);
 
+  Status Prefetch(const std::vector<std::string>& keys);
+
   Status Put(const std::string& key, const std::string& value);
 
   Status BatchPut(const std::vector<KVPair>& kvs);
@@ -103,6 +110,7 @@ class Transaction::TxnImpl {
   int64_t TEST_GetStartTs() { return start_ts_; }                        // NOLINT
   int64_t TEST_GetCommitTs() { return commit_ts_; }                      // NOLINT
   int64_t TEST_MutationsSize() { return buffer_->MutationsSize(); }      // NOLINT
+  int64_t TEST_ReadCacheSize() { return read_cache_.size(); }            // NOLINT
   std::string TEST_GetPrimaryKey() { return buffer_->GetPrimaryKey(); }  // NOLINT
 
  private:
@@ -124,6 +132,15 @@ class Transaction::TxnImpl {
   void ProcessTxnBatchGetSubTask(TxnSubTask* sub_task);
   Status DoTxnBatchGet(const std::vector<std::string>& keys, std::vector<KVPair>& kvs);
 
+  // Snapshot isolation txn reads the same value of a key at start_ts, so the reads from store are cached.
+  // Keys in buffer are always read from buffer, the cache is only for the keys not written by txn.
+  bool IsReadCacheEnabled() const;
+  // Return true if the key is cached, empty value means the key is not found.
+  bool GetReadCache(const std::string& key, std::string& value) const;
+  void PutReadCache(const std::string& key, const std::string& value);
+  // Cache the batch get result, the keys not in kvs are cached as not found only if all sub tasks succeeded.
+  void PutReadCache(const std::vector<std::string>& keys, const std::vector<KVPair>& kvs, bool is_complete);
+
   // txn commit
   std::unique_ptr<TxnPrewriteRpc> PrepareTxnPrewriteRpc(const std::shared_ptr<Region>& region) const;
   void CheckAndLogPreCommitPrimaryKeyResponse(const pb::store::TxnPrewriteResponse* response) const;
@@ -135,6 +152,27 @@ class Transaction::TxnImpl {
   Status ProcessTxnCommitResponse(const pb::store::TxnCommitResponse* response, bool is_primary) const;
   Status CommitPrimaryKey();
   void ProcessTxnCommitSubTask(TxnSubTask* sub_task);
+  // Commit secondary keys in actuator without waiting, see FLAGS_enable_txn_async_commit_secondary.
+  // Return false if too many async commit rpcs are in flight, then the caller commits them synchronously.
+  bool AsyncCommitSecondaries(const std::vector<TxnSubTask>& sub_tasks,
+                              std::vector<std::unique_ptr<TxnCommitRpc>>& rpcs);
+
+  // If all mutations are in one region, the primary and secondary keys are prewritten by one rpc and committed
+  // atomically by one rpc, saving the separate primary key round trips.
+  bool LookupSingleRegion(std::shared_ptr<Region>& region) const;
+  Status PreCommitSingleRegion(const std::shared_ptr<Region>& region);
+  Status CommitSingleRegion(const std::shared_ptr<Region>& region);
+
+  // Pipelined txn, see FLAGS_txn_pipelined_flush_mutations.
+  // When the buffer is large, its mutations are taken out and prewritten by a background thread, the primary key is
+  // prewritten before others in the first flush. The key ranges of flushed mutations are kept instead of the keys,
+  // their locks are committed or rolled back at last by resolving all locks of the txn in the ranges.
+  Status MaybeFlushBuffer();
+  Status WaitFlushBuffer();
+  Status PrepareFlushSubTasks(const std::map<std::string, TxnMutation>& mutations, bool is_first_flush);
+  void ProcessFlushSubTasks(bool is_first_flush);
+  void AddFlushedRange(const std::string& start_key, const std::string& end_key);
+  void ResolveFlushedRanges(int64_t commit_ts);
 
   // txn rollback
   std::unique_ptr<TxnBatchRollbackRpc> PrepareTxnBatchRollbackRpc(const std::shared_ptr<Region>& region) const;
@@ -157,6 +195,17 @@ class Transaction::TxnImpl {
 
   pb::meta::TsoTimestamp commit_tso_;
   int64_t commit_ts_;
+
+  // key -> value read at start_ts, empty value means not found
+  std::unordered_map<std::string, std::string> read_cache_;
+
+  bool is_flushed_{false};
+  std::thread flush_thread_;
+  Status flush_status_;
+  std::vector<std::unique_ptr<TxnPrewriteRpc>> flush_rpcs_;
+  std::vector<TxnSubTask> flush_sub_tasks_;
+  // start_key -> end_key, not overlapped
+  std::map<std::string, std::string> flushed_ranges_;
 };
 
 }  // namespace sdk
@@ -15,12 +15,19 @@
 #include "sdk/transaction/txn_lock_resolver.h"
 
 #include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "common/logging.h"
 #include "glog/logging.h"
 #include "proto/store.pb.h"
 #include "sdk/client_stub.h"
 #include "sdk/common/common.h"
+#include "sdk/common/param_config.h"
 #include "sdk/region.h"
 #include "sdk/status.h"
 #include "sdk/store/store_rpc.h"
@@ -33,37 +40,74 @@ TxnLockResolver::TxnLockResolver(const ClientStub& stub) : stub_(stub) {}
 
 // TODO: maybe support retry
 Status TxnLockResolver::ResolveLock(const pb::store::LockInfo& lock_info, int64_t caller_start_ts) {
-  DINGO_LOG(DEBUG) << "lock_info:" << lock_info.DebugString();
+  return ResolveLocks({lock_info}, caller_start_ts);
+}
+
+Status TxnLockResolver::ResolveLocks(const std::vector<pb::store::LockInfo>& lock_infos, int64_t caller_start_ts) {
+  std::map<int64_t, std::vector<const pb::store::LockInfo*>> txn_locks;
+  for (const auto& lock_info : lock_infos) {
+    txn_locks[lock_info.lock_ts()].push_back(&lock_info);
+  }
+
+  Status result;
+  for (const auto& [txn_start_ts, locks] : txn_locks) {
+    Status ret = ResolveTxnLocks(txn_start_ts, locks, caller_start_ts);
+    if (!ret.ok()) {
+      result = ret;
+    }
+  }
+
+  return result;
+}
+
+Status TxnLockResolver::ResolveTxnLocks(int64_t txn_start_ts, const std::vector<const pb::store::LockInfo*>& lock_infos,
+                                        int64_t caller_start_ts) {
+  const auto& primary_key = lock_infos.front()->primary_lock();
+  DINGO_LOG(DEBUG) << "resolve txn:" << txn_start_ts << " primary_key:" << primary_key
+                   << " lock_count:" << lock_infos.size();
+
   TxnStatus txn_status;
-  Status ret = CheckTxnStatus(lock_info.lock_ts(), lock_info.primary_lock(), caller_start_ts, txn_status);
-  if (!ret.ok()) {
-    if (ret.IsNotFound()) {
-      DINGO_LOG(DEBUG) << "txn not exist when check txn status, status:" << ret.ToString()
-                       << ", lock_info:" << lock_info.DebugString();
-      return Status::OK();
-    } else {
+  if (!GetCachedTxnStatus(txn_start_ts, txn_status)) {
+    Status ret = CheckTxnStatus(txn_start_ts, primary_key, caller_start_ts, txn_status);
+    if (!ret.ok()) {
+      if (ret.IsNotFound()) {
+        DINGO_LOG(DEBUG) << "txn not exist when check txn status, status:" << ret.ToString()
+                         << ", lock_info:" << lock_infos.front()->DebugString();
+        return Status::OK();
+      } else {
+        return ret;
+      }
+    }
+
+    if (txn_status.IsLocked()) {
+      return Status::TxnLockConflict(ret.ToString());
+    }
+
+    CHECK(txn_status.IsCommitted() || txn_status.IsRollbacked()) << "unexpected txn_status:" << txn_status.ToString();
+
+    // resolve primary key
+    ret = ResolveLockKey(txn_start_ts, primary_key, txn_status.commit_ts);
+    if (!ret.IsOK()) {
+      DINGO_LOG(WARNING) << "resolve txn:" << txn_start_ts << " primary_key:" << primary_key
+                         << " txn_status:" << txn_status.ToString() << " fail, status:" << ret.ToString();
       return ret;
     }
-  }
 
-  if (txn_status.IsLocked()) {
-    return Status::TxnLockConflict(ret.ToString());
+    CacheTxnStatus(txn_start_ts, txn_status);
   }
 
-  CHECK(txn_status.IsCommitted() || txn_status.IsRollbacked()) << "unexpected txn_status:" << txn_status.ToString();
-
-  // resolve primary key
-  ret = ResolveLockKey(lock_info.lock_ts(), lock_info.primary_lock(), txn_status.commit_ts);
-  if (!ret.IsOK()) {
-    DINGO_LOG(WARNING) << "resolve txn:" << lock_info.lock_ts() << " primary_key:" << lock_info.primary_lock()
-                       << " txn_status:" << txn_status.ToString() << " fail, status:" << ret.ToString();
-    return ret;
+  // resolve conflict keys
+  std::vector<std::string> keys;
+  keys.reserve(lock_infos.size());
+  for (const auto* lock_info : lock_infos) {
+    if (lock_info->key() != primary_key) {
+      keys.push_back(lock_info->key());
+    }
   }
 
-  // resolve conflict key
-  ret = ResolveLockKey(lock_info.lock_ts(), lock_info.key(), txn_status.commit_ts);
+  Status ret = ResolveLockKeys(txn_start_ts, keys, txn_status.commit_ts);
   if (!ret.IsOK()) {
-    DINGO_LOG(WARNING) << "resolve txn:" << lock_info.lock_ts() << " key:" << lock_info.key()
+    DINGO_LOG(WARNING) << "resolve txn:" << txn_start_ts << " keys:" << keys.size()
                        << " txn_status:" << txn_status.ToString() << " fail, status:" << ret.ToString();
     return ret;
   }
@@ -71,7 +115,36 @@ Status TxnLockResolver::ResolveLock(const pb::store::LockInfo& lock_info, int64_
   return Status::OK();
 }
 
-// TODO: use txn status cache
+bool TxnLockResolver::GetCachedTxnStatus(int64_t txn_start_ts, TxnStatus& txn_status) {
+  std::unique_lock<std::mutex> lg(cache_mutex_);
+  auto it = txn_status_cache_.find(txn_start_ts);
+  if (it == txn_status_cache_.end()) {
+    return false;
+  }
+
+  txn_status_list_.splice(txn_status_list_.begin(), txn_status_list_, it->second);
+  txn_status = it->second->second;
+  return true;
+}
+
+void TxnLockResolver::CacheTxnStatus(int64_t txn_start_ts, const TxnStatus& txn_status) {
+  if (FLAGS_txn_status_cache_capacity <= 0) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lg(cache_mutex_);
+  if (txn_status_cache_.find(txn_start_ts) != txn_status_cache_.end()) {
+    return;
+  }
+
+  txn_status_list_.emplace_front(txn_start_ts, txn_status);
+  txn_status_cache_[txn_start_ts] = txn_status_list_.begin();
+  while (static_cast<int64_t>(txn_status_list_.size()) > FLAGS_txn_status_cache_capacity) {
+    txn_status_cache_.erase(txn_status_list_.back().first);
+    txn_status_list_.pop_back();
+  }
+}
+
 Status TxnLockResolver::CheckTxnStatus(int64_t txn_start_ts, const std::string& txn_primary_key,
                                        int64_t caller_start_ts, TxnStatus& txn_status) {
   std::shared_ptr<Region> region;
@@ -141,6 +214,38 @@ Status TxnLockResolver::ResolveLockKey(int64_t txn_start_ts, const std::string&
   return ProcessTxnResolveLockResponse(response);
 }
 
+Status TxnLockResolver::ResolveLockKeys(int64_t txn_start_ts, const std::vector<std::string>& keys,
+                                        int64_t commit_ts) {
+  std::map<int64_t, std::pair<std::shared_ptr<Region>, std::vector<std::string>>> region_keys;
+  for (const auto& key : keys) {
+    std::shared_ptr<Region> region;
+    DINGO_RETURN_NOT_OK(stub_.GetMetaCache()->LookupRegionByKey(key, region));
+
+    auto& entry = region_keys[region->RegionId()];
+    entry.first = region;
+    entry.second.push_back(key);
+  }
+
+  for (const auto& [region_id, entry] : region_keys) {
+    const auto& region = entry.first;
+
+    TxnResolveLockRpc rpc;
+    FillRpcContext(*rpc.MutableRequest()->mutable_context(), region->RegionId(), region->Epoch(),
+                   pb::store::IsolationLevel::SnapshotIsolation);
+    rpc.MutableRequest()->set_start_ts(txn_start_ts);
+    rpc.MutableRequest()->set_commit_ts(commit_ts);
+    for (const auto& key : entry.second) {
+      rpc.MutableRequest()->add_keys(key);
+    }
+
+    StoreRpcController controller(stub_, rpc, region);
+    DINGO_RETURN_NOT_OK(controller.Call());
+    DINGO_RETURN_NOT_OK(ProcessTxnResolveLockResponse(*rpc.Response()));
+  }
+
+  return Status::OK();
+}
+
 Status TxnLockResolver::ProcessTxnResolveLockResponse(const pb::store::TxnResolveLockResponse& response) {
   // TODO: need to process lockinfo when support permissive txn
   DINGO_LOG(INFO) << "txn_resolve_lock_response:" << response.DebugString();
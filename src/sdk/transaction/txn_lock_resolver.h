@@ -16,6 +16,13 @@
 #define DINGODB_SDK_TRANSACTION_LOCK_RESOLVER_H_
 
 #include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "fmt/core.h"
 #include "proto/store.pb.h"
 #include "sdk/status.h"
@@ -50,17 +57,38 @@ class TxnLockResolver {
 
   virtual Status ResolveLock(const pb::store::LockInfo& lock_info, int64_t caller_start_ts);
 
+  // Locks are grouped by txn, the primary of every txn is checked once,
+  // then conflict keys of the same region are resolved by one rpc.
+  // Return TxnLockConflict if any txn is still alive, other txns are resolved anyway.
+  virtual Status ResolveLocks(const std::vector<pb::store::LockInfo>& lock_infos, int64_t caller_start_ts);
+
  private:
-  Status CheckTxnStatus(int64_t txn_start_ts, const std::string& txn_primary_key, int64_t caller_start_ts, TxnStatus& txn_status);
+  Status ResolveTxnLocks(int64_t txn_start_ts, const std::vector<const pb::store::LockInfo*>& lock_infos,
+                         int64_t caller_start_ts);
+
+  Status CheckTxnStatus(int64_t txn_start_ts, const std::string& txn_primary_key, int64_t caller_start_ts,
+                        TxnStatus& txn_status);
 
   static Status ProcessTxnCheckStatusResponse(const pb::store::TxnCheckTxnStatusResponse& response,
                                               TxnStatus& txn_status);
 
   Status ResolveLockKey(int64_t txn_start_ts, const std::string& key, int64_t commit_ts);
 
+  // keys are grouped by region, one rpc per region
+  Status ResolveLockKeys(int64_t txn_start_ts, const std::vector<std::string>& keys, int64_t commit_ts);
+
+  // Only committed or rollbacked txn whose primary key is resolved is cached, the status never change.
+  bool GetCachedTxnStatus(int64_t txn_start_ts, TxnStatus& txn_status);
+  void CacheTxnStatus(int64_t txn_start_ts, const TxnStatus& txn_status);
+
   static Status ProcessTxnResolveLockResponse(const pb::store::TxnResolveLockResponse& response);
 
   const ClientStub& stub_;
+
+  // lru cache of txn status, front is the most recently used
+  std::mutex cache_mutex_;
+  std::list<std::pair<int64_t, TxnStatus>> txn_status_list_;
+  std::unordered_map<int64_t, std::list<std::pair<int64_t, TxnStatus>>::iterator> txn_status_cache_;
 };
 }  // namespace sdk
 }  // namespace dingodb
@@ -63,6 +63,7 @@ std::unique_ptr<TxnScanRpc> TxnRegionScannerImpl::PrepareTxnScanRpc() {
   rpc->MutableRequest()->set_start_ts(txn_start_ts_);
   FillRpcContext(*rpc->MutableRequest()->mutable_context(), region->RegionId(), region->Epoch(),
                  TransactionIsolation2IsolationLevel(txn_options_.isolation));
+  MaybeSetStaleRead(*rpc->MutableRequest()->mutable_context(), txn_options_);
   rpc->MutableRequest()->set_limit(batch_size_);
   auto* range_with_option = rpc->MutableRequest()->mutable_range();
   auto* range = range_with_option->mutable_range();
@@ -72,6 +73,12 @@ std::unique_ptr<TxnScanRpc> TxnRegionScannerImpl::PrepareTxnScanRpc() {
   range_with_option->set_with_start(include_next_key_);
   range_with_option->set_with_end(false);
 
+  // Only snapshot isolation can read all pages from the snapshot kept by the cursor.
+  if (FLAGS_txn_scan_use_cursor && txn_options_.isolation == kSnapshotIsolation) {
+    rpc->MutableRequest()->set_use_cursor(true);
+    rpc->MutableRequest()->set_scan_id(scan_id_);
+  }
+
   return std::move(rpc);
 }
 
@@ -112,7 +119,7 @@ Status TxnRegionScannerImpl::NextBatch(std::vector<KVPair>& kvs) {
   }
 
   if (ret.ok()) {
-    const auto* response = rpc->Response();
+    auto* response = rpc->MutableResponse();
     std::vector<KVPair> tmp_kvs;
     if (response->end_key().empty()) {
       CHECK_EQ(response->kvs_size(), 0);
@@ -121,11 +128,13 @@ Status TxnRegionScannerImpl::NextBatch(std::vector<KVPair>& kvs) {
       CHECK_NE(response->kvs_size(), 0);
       next_key_ = response->end_key();
       include_next_key_ = false;
-      for (const auto& kv : response->kvs()) {
+      scan_id_ = response->scan_id();
+      tmp_kvs.reserve(response->kvs_size());
+      for (auto& kv : *response->mutable_kvs()) {
         DINGO_LOG(DEBUG) << "Success scan, key:" << kv.key() << ", value:" << kv.value() << ", next_key:" << next_key_
                          << ", end_key:" << end_key_;
         if (kv.key() < end_key_) {
-          tmp_kvs.push_back({kv.key(), kv.value()});
+          tmp_kvs.push_back({std::move(*kv.mutable_key()), std::move(*kv.mutable_value())});
         } else {
           has_more_ = false;
           break;
@@ -77,6 +77,8 @@ class TxnRegionScannerImpl : public RegionScanner {
   bool has_more_;
   std::string next_key_;
   bool include_next_key_;
+  // The cursor kept by store for next page, 0 means no cursor.
+  int64_t scan_id_{0};
 };
 
 class TxnRegionScannerFactoryImpl final : public RegionScannerFactory {
@@ -0,0 +1,108 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sdk/tso_provider.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "butil/time.h"
+#include "common/logging.h"
+#include "glog/logging.h"
+#include "sdk/common/param_config.h"
+
+namespace dingodb {
+namespace sdk {
+
+TsoProvider::TsoProvider(std::shared_ptr<CoordinatorProxy> coordinator_proxy)
+    : coordinator_proxy_(std::move(coordinator_proxy)) {}
+
+bool TsoProvider::TakePrefetched(pb::meta::TsoTimestamp& tso) {
+  if (prefetched_count_ <= 0 || butil::monotonic_time_ms() - prefetched_time_ms_ > FLAGS_tso_prefetch_max_age_ms) {
+    return false;
+  }
+
+  tso = prefetched_tso_;
+  prefetched_tso_.set_logical(prefetched_tso_.logical() + 1);
+  --prefetched_count_;
+  return true;
+}
+
+Status TsoProvider::GenTso(pb::meta::TsoTimestamp& tso, bool allow_prefetched) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (allow_prefetched && TakePrefetched(tso)) {
+    return Status::OK();
+  }
+
+  Waiter waiter;
+  waiter.allow_prefetched = allow_prefetched;
+  waiters_.push_back(&waiter);
+  while (!waiter.done) {
+    if (fetching_) {
+      cv_.wait(lock);
+      continue;
+    }
+
+    // become the fetcher of all waiting requests
+    fetching_ = true;
+    std::vector<Waiter*> waiters;
+    waiters.swap(waiters_);
+    bool prefetch = false;
+    for (auto* w : waiters) {
+      prefetch = prefetch || w->allow_prefetched;
+    }
+    int64_t prefetch_count = prefetch ? FLAGS_tso_prefetch_count : 0;
+    lock.unlock();
+
+    pb::meta::TsoRequest request;
+    pb::meta::TsoResponse response;
+    request.set_op_type(pb::meta::TsoOpType::OP_GEN_TSO);
+    request.set_count(waiters.size() + prefetch_count);
+
+    Status status = coordinator_proxy_->TsoService(request, response);
+    if (!status.IsOK()) {
+      DINGO_LOG(WARNING) << "Fail tsoService request fail, status:" << status.ToString()
+                         << ", response:" << response.DebugString();
+    } else {
+      CHECK(response.has_start_timestamp());
+      DINGO_LOG(DEBUG) << "tso timestamp: " << response.start_timestamp().DebugString()
+                       << ", count: " << request.count();
+    }
+
+    lock.lock();
+    pb::meta::TsoTimestamp next = response.start_timestamp();
+    for (auto* w : waiters) {
+      w->status = status;
+      w->tso = next;
+      w->done = true;
+      next.set_logical(next.logical() + 1);
+    }
+    if (status.IsOK() && prefetch_count > 0) {
+      prefetched_tso_ = next;
+      prefetched_count_ = prefetch_count;
+      prefetched_time_ms_ = butil::monotonic_time_ms();
+    }
+    fetching_ = false;
+    cv_.notify_all();
+  }
+
+  tso = waiter.tso;
+  return waiter.status;
+}
+
+}  // namespace sdk
+}  // namespace dingodb
@@ -0,0 +1,71 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SDK_TSO_PROVIDER_H_
+#define DINGODB_SDK_TSO_PROVIDER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "proto/meta.pb.h"
+#include "sdk/coordinator_proxy.h"
+#include "sdk/status.h"
+
+namespace dingodb {
+namespace sdk {
+
+// Get tso from coordinator, concurrent requests are merged into one TsoService rpc.
+// A merged rpc is always sent after all its requests arrive, so the tso is newer than any tso got before the request.
+// Extra tso can be prefetched for requests which accept a little stale tso, e.g. the start ts of transaction.
+class TsoProvider {
+ public:
+  TsoProvider(const TsoProvider&) = delete;
+  const TsoProvider& operator=(const TsoProvider&) = delete;
+
+  explicit TsoProvider(std::shared_ptr<CoordinatorProxy> coordinator_proxy);
+
+  ~TsoProvider() = default;
+
+  // allow_prefetched: tso can be from prefetched range, must be false for commit ts.
+  Status GenTso(pb::meta::TsoTimestamp& tso, bool allow_prefetched = false);
+
+ private:
+  struct Waiter {
+    bool allow_prefetched{false};
+    bool done{false};
+    Status status;
+    pb::meta::TsoTimestamp tso;
+  };
+
+  bool TakePrefetched(pb::meta::TsoTimestamp& tso);
+
+  std::shared_ptr<CoordinatorProxy> coordinator_proxy_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool fetching_{false};
+  std::vector<Waiter*> waiters_;
+
+  // prefetched range [prefetched_tso_, prefetched_tso_ + prefetched_count_)
+  pb::meta::TsoTimestamp prefetched_tso_;
+  int64_t prefetched_count_{0};
+  int64_t prefetched_time_ms_{0};
+};
+
+}  // namespace sdk
+}  // namespace dingodb
+#endif  // DINGODB_SDK_TSO_PROVIDER_H_
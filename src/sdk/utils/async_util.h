@@ -17,6 +17,7 @@
 
 #include <condition_variable>
 #include <mutex>
+#include <utility>
 
 #include "sdk/status.h"
 #include "sdk/utils/callback.h"
@@ -58,6 +59,15 @@ class Synchronizer {
   bool fire_{false};
 };
 
+// Run a heap allocated task asynchronously, the task is deleted before cb is called.
+template <class Task>
+void AsyncRunTask(Task* task, StatusCallback cb) {
+  task->AsyncRun([task, cb = std::move(cb)](Status s) {
+    delete task;
+    cb(s);
+  });
+}
+
 }  // namespace sdk
 
 }  // namespace dingodb
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "sdk/status.h"
+#include "sdk/utils/callback.h"
 
 namespace dingodb {
 namespace sdk {
@@ -30,7 +31,8 @@ enum VectorIndexType : uint8_t { kNoneIndexType, kFlat, kIvfFlat, kIvfPq, kHnsw,
 
 std::string VectorIndexTypeToString(VectorIndexType type);
 
-enum MetricType : uint8_t { kNoneMetricType, kL2, kInnerProduct, kCosine };
+// kHamming is for binary vectors, only flat, hnsw and brute force index support it
+enum MetricType : uint8_t { kNoneMetricType, kL2, kInnerProduct, kCosine, kHamming };
 
 std::string MetricTypeToString(MetricType type);
 
@@ -119,7 +121,9 @@ struct BruteForceParam {
   static VectorIndexType Type() { return VectorIndexType::kBruteForce; }
 };
 
-enum ValueType : uint8_t { kNoneValueType, kFloat, kUint8 };
+// kUint8 is binary vector with one bit per dimension, kInt8 is one signed byte per dimension,
+// both are packed in binary_values
+enum ValueType : uint8_t { kNoneValueType, kFloat, kUint8, kInt8 };
 
 std::string ValueTypeToString(ValueType type);
 
@@ -351,6 +355,16 @@ struct DeleteResult {
   std::string ToString() const;
 };
 
+struct BulkAddStats {
+  int64_t vector_count{0};
+  // rpc count and request bytes, include retries
+  int64_t rpc_count{0};
+  int64_t bytes{0};
+  int64_t elapsed_ms{0};
+
+  std::string ToString() const;
+};
+
 struct QueryParam {
   std::vector<int64_t> vector_ids;
   // If true, response with vector data
@@ -486,6 +500,12 @@ class VectorClient {
   Status AddByIndexName(int64_t schema_id, const std::string& index_name, const std::vector<VectorWithId>& vectors,
                         bool replace_deleted = false, bool is_update = false);
 
+  // Bulk load variant of AddByIndexId, vectors are chunked by vector_add_batch_max_count and
+  // vector_add_batch_max_bytes, every region has at most vector_bulk_add_max_inflight_per_region rpcs in flight.
+  // The rpc payload is compressed by vector_add_compress_type.
+  Status BulkAddByIndexId(int64_t index_id, const std::vector<VectorWithId>& vectors,
+                          BulkAddStats* out_stats = nullptr, bool replace_deleted = false, bool is_update = false);
+
   Status SearchByIndexId(int64_t index_id, const SearchParam& search_param,
                          const std::vector<VectorWithId>& target_vectors, std::vector<SearchResult>& out_result);
   Status SearchByIndexName(int64_t schema_id, const std::string& index_name, const SearchParam& search_param,
@@ -496,6 +516,16 @@ class VectorClient {
   Status DeleteByIndexName(int64_t schema_id, const std::string& index_name, const std::vector<int64_t>& vector_ids,
                            std::vector<DeleteResult>& out_result);
 
+  // Non-blocking variants, cb is called in sdk thread when the operation is done.
+  // NOTE: The params and out params are referenced until cb is called, caller must keep them valid.
+  void AsyncAddByIndexId(int64_t index_id, const std::vector<VectorWithId>& vectors, StatusCallback cb,
+                         bool replace_deleted = false, bool is_update = false);
+  void AsyncSearchByIndexId(int64_t index_id, const SearchParam& search_param,
+                            const std::vector<VectorWithId>& target_vectors, std::vector<SearchResult>& out_result,
+                            StatusCallback cb);
+  void AsyncDeleteByIndexId(int64_t index_id, const std::vector<int64_t>& vector_ids,
+                            std::vector<DeleteResult>& out_result, StatusCallback cb);
+
   Status BatchQueryByIndexId(int64_t index_id, const QueryParam& query_param, QueryResult& out_result);
   Status BatchQueryByIndexName(int64_t schema_id, const std::string& index_name, const QueryParam& query_param,
                                QueryResult& out_result);
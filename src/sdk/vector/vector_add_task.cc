@@ -15,10 +15,16 @@
 #include "sdk/vector/vector_add_task.h"
 
 #include <cstdint>
+#include <deque>
+#include <memory>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "brpc/controller.h"
 #include "glog/logging.h"
 #include "sdk/common/common.h"
+#include "sdk/common/param_config.h"
 #include "sdk/status.h"
 #include "sdk/vector/index_service_rpc.h"
 #include "sdk/vector/vector_common.h"
@@ -28,6 +34,17 @@
 namespace dingodb {
 namespace sdk {
 
+static brpc::CompressType VectorAddCompressType() {
+  if (FLAGS_vector_add_compress_type == "snappy") {
+    return brpc::COMPRESS_TYPE_SNAPPY;
+  } else if (FLAGS_vector_add_compress_type == "gzip") {
+    return brpc::COMPRESS_TYPE_GZIP;
+  } else if (FLAGS_vector_add_compress_type == "zlib") {
+    return brpc::COMPRESS_TYPE_ZLIB;
+  }
+  return brpc::COMPRESS_TYPE_NONE;
+}
+
 Status VectorAddTask::Init() {
   std::shared_ptr<VectorIndex> tmp;
   DINGO_RETURN_NOT_OK(stub.GetVectorIndexCache()->GetVectorIndexById(index_id_, tmp));
@@ -83,6 +100,10 @@ void VectorAddTask::DoAsync() {
 
   controllers_.clear();
   rpcs_.clear();
+  {
+    std::unique_lock<std::shared_mutex> w(rw_lock_);
+    region_pending_rpcs_.clear();
+  }
 
   for (const auto& entry : region_vectors_to_ids) {
     auto region_id = entry.first;
@@ -91,35 +112,76 @@ void VectorAddTask::DoAsync() {
     CHECK(iter != region_id_to_region.end());
     auto region = iter->second;
 
-    auto rpc = std::make_unique<VectorAddRpc>();
-    FillRpcContext(*rpc->MutableRequest()->mutable_context(), region_id, region->Epoch());
-    rpc->MutableRequest()->set_is_update(is_update_);
-    rpc->MutableRequest()->set_replace_deleted(replace_deleted_);
-
+    std::unique_ptr<VectorAddRpc> rpc;
+    int64_t rpc_bytes = 0;
     for (const auto& id : entry.second) {
+      if (rpc == nullptr) {
+        rpc = NewVectorAddRpc(region);
+        rpc_bytes = 0;
+      }
+
       int64_t idx = vector_id_to_idx_[id];
-      FillVectorWithIdPB(rpc->MutableRequest()->add_vectors(), vectors_[idx]);
+      auto* vector_pb = rpc->MutableRequest()->add_vectors();
+      FillVectorWithIdPB(vector_pb, vectors_[idx]);
+      rpc_bytes += vector_pb->ByteSizeLong();
+
+      if (rpc->Request()->vectors_size() >= FLAGS_vector_add_batch_max_count ||
+          rpc_bytes >= FLAGS_vector_add_batch_max_bytes) {
+        AddRpc(region, std::move(rpc), rpc_bytes);
+      }
     }
 
-    StoreRpcController controller(stub, *rpc, region);
-    controllers_.push_back(controller);
-
-    rpcs_.push_back(std::move(rpc));
+    if (rpc != nullptr) {
+      AddRpc(region, std::move(rpc), rpc_bytes);
+    }
   }
 
-  DCHECK_EQ(rpcs_.size(), region_vectors_to_ids.size());
   DCHECK_EQ(rpcs_.size(), controllers_.size());
 
-  sub_tasks_count_.store(region_vectors_to_ids.size());
+  sub_tasks_count_.store(rpcs_.size());
 
-  for (auto i = 0; i < region_vectors_to_ids.size(); i++) {
-    auto& controller = controllers_[i];
+  std::vector<size_t> to_send;
+  {
+    std::unique_lock<std::shared_mutex> w(rw_lock_);
+    for (auto& [region_id, pending] : region_pending_rpcs_) {
+      int64_t count = 0;
+      while (!pending.empty() && (max_inflight_per_region_ <= 0 || count < max_inflight_per_region_)) {
+        to_send.push_back(pending.front());
+        pending.pop_front();
+        count++;
+      }
+    }
+  }
 
-    controller.AsyncCall(
-        [this, rpc = rpcs_[i].get()](auto&& s) { VectorAddRpcCallback(std::forward<decltype(s)>(s), rpc); });
+  for (auto idx : to_send) {
+    SendRpc(idx);
   }
 }
 
+std::unique_ptr<VectorAddRpc> VectorAddTask::NewVectorAddRpc(const std::shared_ptr<Region>& region) const {
+  auto rpc = std::make_unique<VectorAddRpc>();
+  FillRpcContext(*rpc->MutableRequest()->mutable_context(), region->RegionId(), region->Epoch());
+  rpc->MutableRequest()->set_is_update(is_update_);
+  rpc->MutableRequest()->set_replace_deleted(replace_deleted_);
+  rpc->SetRequestCompressType(VectorAddCompressType());
+  return std::move(rpc);
+}
+
+void VectorAddTask::AddRpc(const std::shared_ptr<Region>& region, std::unique_ptr<VectorAddRpc> rpc, int64_t bytes) {
+  controllers_.emplace_back(stub, *rpc, region);
+  rpcs_.push_back(std::move(rpc));
+  sent_bytes_.fetch_add(bytes);
+
+  std::unique_lock<std::shared_mutex> w(rw_lock_);
+  region_pending_rpcs_[region->RegionId()].push_back(rpcs_.size() - 1);
+}
+
+void VectorAddTask::SendRpc(size_t idx) {
+  sent_rpcs_.fetch_add(1);
+  controllers_[idx].AsyncCall(
+      [this, rpc = rpcs_[idx].get()](auto&& s) { VectorAddRpcCallback(std::forward<decltype(s)>(s), rpc); });
+}
+
 void VectorAddTask::VectorAddRpcCallback(const Status& status, VectorAddRpc* rpc) {
   if (!status.ok()) {
     DINGO_LOG(WARNING) << "rpc: " << rpc->Method() << " send to region: " << rpc->Request()->context().region_id()
@@ -137,6 +199,22 @@ void VectorAddTask::VectorAddRpcCallback(const Status& status, VectorAddRpc* rpc
     }
   }
 
+  // send next rpc of the region
+  bool has_next = false;
+  size_t next_idx = 0;
+  {
+    std::unique_lock<std::shared_mutex> w(rw_lock_);
+    auto& pending = region_pending_rpcs_[rpc->Request()->context().region_id()];
+    if (!pending.empty()) {
+      has_next = true;
+      next_idx = pending.front();
+      pending.pop_front();
+    }
+  }
+  if (has_next) {
+    SendRpc(next_idx);
+  }
+
   if (sub_tasks_count_.fetch_sub(1) == 1) {
     Status tmp;
     {
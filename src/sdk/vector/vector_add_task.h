@@ -15,7 +15,9 @@
 #ifndef DINGODB_SDK_VECTOR_ADD_TASK_H_
 #define DINGODB_SDK_VECTOR_ADD_TASK_H_
 
+#include <atomic>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <unordered_map>
 
@@ -28,30 +30,42 @@
 namespace dingodb {
 namespace sdk {
 
+// Vectors of a region are chunked to rpcs by vector_add_batch_max_count and vector_add_batch_max_bytes.
+// max_inflight_per_region limits the in flight rpcs of every region, 0 means no limit.
 class VectorAddTask : public VectorTask {
  public:
   VectorAddTask(const ClientStub& stub, int64_t index_id, const std::vector<VectorWithId>& vectors,
-                bool replace_deleted = false, bool is_update = false)
+                bool replace_deleted = false, bool is_update = false, int64_t max_inflight_per_region = 0)
       : VectorTask(stub),
         index_id_(index_id),
         vectors_(vectors),
         replace_deleted_(replace_deleted),
-        is_update_(is_update) {}
+        is_update_(is_update),
+        max_inflight_per_region_(max_inflight_per_region) {}
 
   ~VectorAddTask() override = default;
 
+  // Request bytes and rpcs sent, include retries.
+  int64_t SentBytes() const { return sent_bytes_.load(); }
+  int64_t SentRpcs() const { return sent_rpcs_.load(); }
+
  private:
   Status Init() override;
   void DoAsync() override;
 
   std::string Name() const override { return fmt::format("VectorAddTask-{}", index_id_); }
 
+  std::unique_ptr<VectorAddRpc> NewVectorAddRpc(const std::shared_ptr<Region>& region) const;
+  void AddRpc(const std::shared_ptr<Region>& region, std::unique_ptr<VectorAddRpc> rpc, int64_t bytes);
+  void SendRpc(size_t idx);
+
   void VectorAddRpcCallback(const Status& status, VectorAddRpc* rpc);
 
   const int64_t index_id_;
   const std::vector<VectorWithId>& vectors_;
   const bool replace_deleted_;
   const bool is_update_;
+  const int64_t max_inflight_per_region_;
 
   std::shared_ptr<VectorIndex> vector_index_;
 
@@ -60,8 +74,13 @@ class VectorAddTask : public VectorTask {
 
   std::shared_mutex rw_lock_;
   std::unordered_map<int64_t, int64_t> vector_id_to_idx_;
+  // region id to not sent rpc idx
+  std::unordered_map<int64_t, std::deque<size_t>> region_pending_rpcs_;
   Status status_;
 
+  std::atomic<int64_t> sent_bytes_{0};
+  std::atomic<int64_t> sent_rpcs_{0};
+
   std::atomic<int> sub_tasks_count_{0};
 };
 }  // namespace sdk
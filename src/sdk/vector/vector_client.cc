@@ -12,10 +12,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <cstdint>
+#include <utility>
 
+#include "butil/time.h"
+#include "common/logging.h"
+#include "fmt/core.h"
 #include "sdk/client_stub.h"
+#include "sdk/common/param_config.h"
 #include "sdk/status.h"
+#include "sdk/utils/async_util.h"
 #include "sdk/vector.h"
 #include "sdk/vector/vector_add_task.h"
 #include "sdk/vector/vector_batch_query_task.h"
@@ -48,6 +55,30 @@ Status VectorClient::AddByIndexName(int64_t schema_id, const std::string& index_
   return task.Run();
 }
 
+Status VectorClient::BulkAddByIndexId(int64_t index_id, const std::vector<VectorWithId>& vectors,
+                                      BulkAddStats* out_stats, bool replace_deleted, bool is_update) {
+  int64_t start_ms = butil::monotonic_time_ms();
+  VectorAddTask task(stub_, index_id, vectors, replace_deleted, is_update,
+                     FLAGS_vector_bulk_add_max_inflight_per_region);
+  Status s = task.Run();
+
+  BulkAddStats stats;
+  stats.vector_count = vectors.size();
+  stats.rpc_count = task.SentRpcs();
+  stats.bytes = task.SentBytes();
+  stats.elapsed_ms = butil::monotonic_time_ms() - start_ms;
+
+  int64_t elapsed_ms = std::max(stats.elapsed_ms, static_cast<int64_t>(1));
+  DINGO_LOG(INFO) << fmt::format("[sdk.vector] bulk add index({}) {}, {} vectors/s, {:.2f} MB/s, status: {}", index_id,
+                                 stats.ToString(), stats.vector_count * 1000 / elapsed_ms,
+                                 static_cast<double>(stats.bytes) * 1000 / elapsed_ms / 1024 / 1024, s.ToString());
+
+  if (out_stats != nullptr) {
+    *out_stats = stats;
+  }
+  return s;
+}
+
 Status VectorClient::SearchByIndexId(int64_t index_id, const SearchParam& search_param,
                                      const std::vector<VectorWithId>& target_vectors,
                                      std::vector<SearchResult>& out_result) {
@@ -72,6 +103,22 @@ Status VectorClient::DeleteByIndexId(int64_t index_id, const std::vector<int64_t
   return task.Run();
 }
 
+void VectorClient::AsyncAddByIndexId(int64_t index_id, const std::vector<VectorWithId>& vectors, StatusCallback cb,
+                                     bool replace_deleted, bool is_update) {
+  AsyncRunTask(new VectorAddTask(stub_, index_id, vectors, replace_deleted, is_update), std::move(cb));
+}
+
+void VectorClient::AsyncSearchByIndexId(int64_t index_id, const SearchParam& search_param,
+                                        const std::vector<VectorWithId>& target_vectors,
+                                        std::vector<SearchResult>& out_result, StatusCallback cb) {
+  AsyncRunTask(new VectorSearchTask(stub_, index_id, search_param, target_vectors, out_result), std::move(cb));
+}
+
+void VectorClient::AsyncDeleteByIndexId(int64_t index_id, const std::vector<int64_t>& vector_ids,
+                                        std::vector<DeleteResult>& out_result, StatusCallback cb) {
+  AsyncRunTask(new VectorDeleteTask(stub_, index_id, vector_ids, out_result), std::move(cb));
+}
+
 Status VectorClient::DeleteByIndexName(int64_t schema_id, const std::string& index_name,
                                        const std::vector<int64_t>& vector_ids, std::vector<DeleteResult>& out_result) {
   int64_t index_id{0};
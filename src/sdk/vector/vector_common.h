@@ -38,6 +38,8 @@ static pb::common::MetricType MetricType2InternalMetricTypePB(MetricType metric_
       return pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT;
     case MetricType::kCosine:
       return pb::common::MetricType::METRIC_TYPE_COSINE;
+    case MetricType::kHamming:
+      return pb::common::MetricType::METRIC_TYPE_HAMMING;
     default:
       CHECK(false) << "unsupported metric type:" << metric_type;
   }
@@ -53,6 +55,8 @@ static MetricType InternalMetricTypePB2MetricType(pb::common::MetricType metric_
       return MetricType::kInnerProduct;
     case pb::common::MetricType::METRIC_TYPE_COSINE:
       return MetricType::kCosine;
+    case pb::common::MetricType::METRIC_TYPE_HAMMING:
+      return MetricType::kHamming;
     default:
       CHECK(false) << "unsupported metric type:" << pb::common::MetricType_Name(metric_type);
   }
@@ -174,11 +178,26 @@ static pb::common::ValueType ValueType2InternalValueTypePB(ValueType value_type)
       return pb::common::ValueType::FLOAT;
     case ValueType::kUint8:
       return pb::common::ValueType::UINT8;
+    case ValueType::kInt8:
+      return pb::common::ValueType::SINT8;
     default:
       CHECK(false) << "unsupported value type:" << value_type;
   }
 }
 
+static ValueType InternalValueTypePB2ValueType(pb::common::ValueType value_type) {
+  switch (value_type) {
+    case pb::common::ValueType::FLOAT:
+      return ValueType::kFloat;
+    case pb::common::ValueType::UINT8:
+      return ValueType::kUint8;
+    case pb::common::ValueType::SINT8:
+      return ValueType::kInt8;
+    default:
+      CHECK(false) << "unsupported value type:" << pb::common::ValueType_Name(value_type);
+  }
+}
+
 static pb::common::ScalarValue TransformScalarValue(const sdk::ScalarValue& scalar_value) {
   pb::common::ScalarValue result;
   if (scalar_value.type == sdk::ScalarFieldType::kBool) {
@@ -239,10 +258,12 @@ static void FillVectorWithIdPB(pb::common::VectorWithId* pb, const VectorWithId&
   const auto& vector = vector_with_id.vector;
   vector_pb->set_dimension(vector.dimension);
   vector_pb->set_value_type(ValueType2InternalValueTypePB(vector.value_type));
-  // TODO: support uint
   for (const auto& float_value : vector.float_values) {
     vector_pb->add_float_values(float_value);
   }
+  if (!vector.binary_values.empty()) {
+    vector_pb->add_binary_values(vector.binary_values.data(), vector.binary_values.size());
+  }
 
   auto* scalar_data = pb->mutable_scalar_data();
   for (const auto& [key, value] : vector_with_id.scalar_data) {
@@ -256,10 +277,11 @@ static VectorWithId InternalVectorIdPB2VectorWithId(const pb::common::VectorWith
 
   const auto& vector_pb = pb.vector();
   to_return.vector.dimension = vector_pb.dimension();
-  to_return.vector.value_type = ValueType::kFloat;
-  // TODO: support uint
-  for (const auto& float_value : vector_pb.float_values()) {
-    to_return.vector.float_values.push_back(float_value);
+  to_return.vector.value_type = InternalValueTypePB2ValueType(vector_pb.value_type());
+  to_return.vector.float_values.assign(vector_pb.float_values().begin(), vector_pb.float_values().end());
+  for (const auto& binary_value : vector_pb.binary_values()) {
+    to_return.vector.binary_values.insert(to_return.vector.binary_values.end(), binary_value.begin(),
+                                          binary_value.end());
   }
   return std::move(to_return);
 }
@@ -71,6 +71,11 @@ std::string DeleteResult::ToString() const {
   return fmt::format("DeleteResult {{ vector_id: {}, deleted: {} }}", vector_id, (deleted ? "true" : "false"));
 }
 
+std::string BulkAddStats::ToString() const {
+  return fmt::format("BulkAddStats {{ vector_count: {}, rpc_count: {}, bytes: {}, elapsed_ms: {} }}", vector_count,
+                     rpc_count, bytes, elapsed_ms);
+}
+
 std::string QueryResult::ToString() const {
   std::ostringstream oss;
   oss << "QueryResult: {";
@@ -126,6 +131,8 @@ std::string MetricTypeToString(MetricType type) {
       return "InnerProduct";
     case MetricType::kCosine:
       return "Cosine";
+    case MetricType::kHamming:
+      return "Hamming";
     default:
       return "Unknown";
   }
@@ -139,6 +146,8 @@ std::string ValueTypeToString(ValueType type) {
       return "Float";
     case ValueType::kUint8:
       return "UinT8";
+    case ValueType::kInt8:
+      return "Int8";
     default:
       return "Unknown";
   }
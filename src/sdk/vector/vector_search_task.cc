@@ -14,9 +14,12 @@
 
 #include "sdk/vector/vector_search_task.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <iterator>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "common/logging.h"
 #include "common/synchronization.h"
@@ -32,6 +35,30 @@
 namespace dingodb {
 namespace sdk {
 
+// Merge sorted from into sorted to, keep only the top k if topk search.
+// from is sorted here, results of region are usually sorted already.
+static void MergeTopK(std::vector<VectorWithDistance>& to, std::vector<VectorWithDistance>& from,
+                      const SearchParam& search_param) {
+  auto less = [](const VectorWithDistance& a, const VectorWithDistance& b) { return a.distance < b.distance; };
+  if (!std::is_sorted(from.begin(), from.end(), less)) {
+    std::sort(from.begin(), from.end(), less);
+  }
+
+  std::vector<VectorWithDistance> merged;
+  merged.reserve(to.size() + from.size());
+  std::merge(std::make_move_iterator(to.begin()), std::make_move_iterator(to.end()),
+             std::make_move_iterator(from.begin()), std::make_move_iterator(from.end()), std::back_inserter(merged),
+             less);
+
+  bool is_topk = !search_param.enable_range_search && search_param.topk > 0;
+  if (is_topk && static_cast<size_t>(search_param.topk) < merged.size()) {
+    merged.resize(search_param.topk);
+  }
+
+  to.swap(merged);
+  from.clear();
+}
+
 Status VectorSearchTask::Init() {
   if (target_vectors_.empty()) {
     return Status::InvalidArgument("target_vectors is empty");
@@ -71,6 +98,7 @@ void VectorSearchTask::DoAsync() {
 
   for (const auto& part_id : next_part_ids) {
     auto* sub_task = new VectorSearchPartTask(stub, index_id_, part_id, search_param_, target_vectors_);
+    sub_task->SetTraceParent(trace_span);
     sub_task->AsyncRun([this, sub_task](auto&& s) { SubTaskCallback(std::forward<decltype(s)>(s), sub_task); });
   }
 }
@@ -89,17 +117,9 @@ void VectorSearchTask::SubTaskCallback(Status status, VectorSearchPartTask* sub_
   } else {
     std::unique_lock<std::shared_mutex> w(rw_lock_);
     std::unordered_map<int64_t, std::vector<VectorWithDistance>>& sub_results = sub_task->GetSearchResult();
-    // merge
+    // merge as sub task done, only the top k of every target vector is kept
     for (auto& result : sub_results) {
-      auto iter = tmp_out_result_.find(result.first);
-      if (iter != tmp_out_result_.cend()) {
-        auto& origin = iter->second;
-        auto& to_put = result.second;
-        origin.reserve(origin.size() + to_put.size());
-        std::move(to_put.begin(), to_put.end(), std::back_inserter(origin));
-      } else {
-        CHECK(tmp_out_result_.insert({result.first, std::move(result.second)}).second);
-      }
+      MergeTopK(tmp_out_result_[result.first], result.second, search_param_);
     }
 
     next_part_ids_.erase(sub_task->part_id_);
@@ -133,20 +153,9 @@ void VectorSearchTask::ConstructResultUnlocked() {
     out_result_.push_back(std::move(search));
   }
 
+  // tmp_out_result_ is sorted and cut to top k when merging
   for (auto& iter : tmp_out_result_) {
-    auto& vec = iter.second;
-    std::sort(vec.begin(), vec.end(),
-              [](const VectorWithDistance& a, const VectorWithDistance& b) { return a.distance < b.distance; });
-  }
-
-  for (auto& iter : tmp_out_result_) {
-    int64_t idx = iter.first;
-    auto& vec_distance = iter.second;
-    if (!search_param_.enable_range_search && search_param_.topk > 0 && search_param_.topk < vec_distance.size()) {
-      vec_distance.resize(search_param_.topk);
-    }
-
-    out_result_[idx].vector_datas = std::move(vec_distance);
+    out_result_[iter.first].vector_datas = std::move(iter.second);
   }
 }
 
@@ -178,6 +187,7 @@ void VectorSearchPartTask::DoAsync() {
 
   for (const auto& region : regions) {
     auto rpc = std::make_unique<VectorSearchRpc>();
+    rpc->SetTraceParent(trace_span);
     FillVectorSearchRpcRequest(rpc->MutableRequest(), region);
 
     StoreRpcController controller(stub, *rpc, region);
@@ -229,14 +239,16 @@ void VectorSearchPartTask::VectorSearchRpcCallback(const Status& status, VectorS
                       << " response batch_results_size: " << rpc->Response()->batch_results_size();
     }
 
-    {
-      std::unique_lock<std::shared_mutex> w(rw_lock_);
-      for (auto i = 0; i < rpc->Response()->batch_results_size(); i++) {
-        for (const auto& distancepb : rpc->Response()->batch_results(i).vector_with_distances()) {
-          VectorWithDistance distance = InternalVectorWithDistance2VectorWithDistance(distancepb);
-          search_result_[i].push_back(std::move(distance));
-        }
+    for (auto i = 0; i < rpc->Response()->batch_results_size(); i++) {
+      std::vector<VectorWithDistance> region_result;
+      region_result.reserve(rpc->Response()->batch_results(i).vector_with_distances_size());
+      for (const auto& distancepb : rpc->Response()->batch_results(i).vector_with_distances()) {
+        region_result.push_back(InternalVectorWithDistance2VectorWithDistance(distancepb));
       }
+
+      // merge as region rpc done, only the top k is kept
+      std::unique_lock<std::shared_mutex> w(rw_lock_);
+      MergeTopK(search_result_[i], region_result, search_param_);
     }
   }
 
@@ -35,6 +35,10 @@ void VectorTask::AsyncRun(StatusCallback cb) {
     call_back_.swap(cb);
   }
 
+  if (trace_parent_id_ != 0 || Trace::ShouldSample(FLAGS_trace_sample_rate)) {
+    Trace::StartSpan(trace_span, trace_parent_id_, trace_parent_span_id_, Name(), "internal");
+  }
+
   Status status = Init();
   if (status.ok()) {
     DoAsync();
@@ -102,6 +106,7 @@ void VectorTask::FireCallback() {
     call_back_.swap(cb);
   }
 
+  Trace::FinishSpan(trace_span, status_.Errno());
   cb(status_);
 }
 
@@ -15,6 +15,7 @@
 #ifndef DINGODB_SDK_VECTOR_TASK_H_
 #define DINGODB_SDK_VECTOR_TASK_H_
 
+#include "common/trace.h"
 #include "sdk/client_stub.h"
 #include "sdk/status.h"
 #include "sdk/utils/callback.h"
@@ -29,6 +30,12 @@ class VectorTask {
   Status Run();
   void AsyncRun(StatusCallback cb);
 
+  // Sub task of a traced task is traced as its child, must be called before run.
+  void SetTraceParent(const TraceSpan& parent) {
+    trace_parent_id_ = parent.trace_id;
+    trace_parent_span_id_ = parent.span_id;
+  }
+
  protected:
   virtual Status Init();
   virtual void PostProcess();
@@ -41,6 +48,9 @@ class VectorTask {
 
   const ClientStub& stub;
 
+  // Span of the whole task when sampled, the parent of its rpc spans.
+  TraceSpan trace_span;
+
  private:
   void FailOrRetry();
   bool NeedRetry();
@@ -51,6 +61,8 @@ class VectorTask {
   mutable std::shared_mutex rw_lock_;
   StatusCallback call_back_;
   int retry_count_{0};
+  int64_t trace_parent_id_{0};
+  int64_t trace_parent_span_id_{0};
 };
 
 }  // namespace sdk
@@ -69,6 +69,8 @@ void Buf::Init(const std::string& buf) {
 
 void Buf::SetForwardPos(int fp) { this->forward_pos_ = fp; }
 
+int Buf::GetForwardPos() const { return this->forward_pos_; }
+
 void Buf::SetReversePos(int rp) { this->reverse_pos_ = rp; }
 
 void Buf::Write(uint8_t b) { buf_.at(forward_pos_++) = b; }
@@ -42,6 +42,7 @@ class Buf {
   void Init(std::string* buf);
   void Init(const std::string& buf);
   void SetForwardPos(int fp);
+  int GetForwardPos() const;
   void SetReversePos(int rp);
   void Write(uint8_t b);
   void WriteWithNegation(uint8_t b);
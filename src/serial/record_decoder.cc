@@ -14,7 +14,9 @@
 
 #include "record_decoder.h"
 
+#include <algorithm>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "common/logging.h"
@@ -114,7 +116,20 @@ bool RecordDecoder::CheckReverseTag(Buf* buf) const {
 }
 
 bool RecordDecoder::CheckSchemaVersion(Buf* buf) const {
-  return buf->ReadInt() <= schema_version_;
+  int offset_count = -1;
+  return CheckValueHeader(buf, offset_count);
+}
+
+bool RecordDecoder::CheckValueHeader(Buf* buf, int& offset_count) const {
+  int32_t header = buf->ReadInt();
+  offset_count = -1;
+  if (((header >> kValueCodecVersionShift) & 0xFF) == kValueCodecVersionOffsetTable) {
+    // sequential decoding skip the offset table
+    offset_count = buf->ReadInt();
+    buf->Skip(offset_count * 4);
+    header &= kValueSchemaVersionMask;
+  }
+  return header <= schema_version_;
 }
 
 void DecodeOrSkip(
@@ -194,6 +209,17 @@ int RecordDecoder::DecodeKey(const std::string& key, std::vector<std::any>& reco
   return 0;
 }
 
+int RecordDecoder::DecodeBatch(const std::vector<pb::common::KeyValue>& key_values, size_t begin, size_t end,
+                               const std::vector<int>& column_indexes, std::vector<std::vector<std::any>>& records) {
+  auto col_index_mapping = SortedColumnMapping(column_indexes);
+  for (size_t i = begin; i < end; ++i) {
+    if (DecodeWithMapping(key_values[i].key(), key_values[i].value(), col_index_mapping, records[i]) < 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
 int RecordDecoder::Decode(const KeyValue& key_value, std::vector<std::any>& record) {
   return Decode(*key_value.GetKey(), *key_value.GetValue(), record);
 }
@@ -223,49 +249,78 @@ inline bool IsSkipOnly(
 }
 
 
-int RecordDecoder::Decode(
-    const std::string& key, 
-    const std::string& value, 
-    const std::vector<int>& column_indexes,
-    std::vector<std::any>& record
-) {
+static std::vector<std::pair<int, int>> SortedColumnMapping(const std::vector<int>& column_indexes) {
+  std::vector<std::pair<int, int>> col_index_mapping;
+  col_index_mapping.reserve(column_indexes.size());
+  for (int i = 0; i < column_indexes.size(); i++) {
+    col_index_mapping.push_back(std::make_pair(column_indexes[i], i));
+  }
+  std::sort(col_index_mapping.begin(), col_index_mapping.end());
+  return col_index_mapping;
+}
 
+int RecordDecoder::DecodeWithMapping(const std::string& key, const std::string& value,
+                                     const std::vector<std::pair<int, int>>& col_index_mapping,
+                                     std::vector<std::any>& record) {
   Buf key_buf(key, this->le_);
   Buf value_buf(value, this->le_);
-  if (!CheckPrefix(&key_buf) || !CheckReverseTag(&key_buf) || !CheckSchemaVersion(&value_buf)) {
+  int offset_count = -1;
+  if (!CheckPrefix(&key_buf) || !CheckReverseTag(&key_buf) || !CheckValueHeader(&value_buf, offset_count)) {
     return -1;
   }
 
-  record.resize(column_indexes.size());
+  record.resize(col_index_mapping.size());
   int n = 0;
   int m = 0;
 
-  std::vector<std::pair<int, int>> col_index_mapping;
-
-  // index
-  for (int i = 0; i < column_indexes.size(); i++) {
-    col_index_mapping.push_back(std::make_pair(column_indexes[i], i));
-  }
-
-  // sort indexed_mapping_index
-  std::sort(col_index_mapping.begin(), col_index_mapping.end());
-
-  // sort end indexed_mapping_index and mapping_index
-  DINGO_LOG(DEBUG) << "indexed_mapping_index: ";  
-  for (auto p : col_index_mapping) {
-    DINGO_LOG(DEBUG) << "(" << p.first << ", " << p.second << ") ";
-  }
-
   int record_index = 0;
+  int value_ordinal = 0;
   for (auto iter = schemas_->begin(); iter != schemas_->end(); ++iter) {
-
-    if (column_indexes.size() == n) {
+    if (col_index_mapping.size() == n) {
       return 0;
     }
     const auto& bs = *iter;
     if (bs) {
+      bool skip = IsSkipOnly(col_index_mapping, n, m, record_index);
+      if (offset_count < 0 || bs->IsKey()) {
+        DecodeOrSkip(bs, &key_buf, &value_buf, record, record_index, skip);
+        continue;
+      }
+
+      // jump to the value column by offset table, not selected value column need not skip.
+      int ordinal = value_ordinal++;
+      if (skip) {
+        continue;
+      }
+      int offset = static_cast<int>(value.size());
+      if (ordinal < offset_count) {
+        value_buf.SetForwardPos(kValueOffsetTablePos + ordinal * 4);
+        offset = value_buf.ReadInt();
+        if (offset < kValueOffsetTablePos || offset > static_cast<int>(value.size())) {
+          return -1;
+        }
+      }
+      // column not in offset table is added after the record was written, decoded as null at the end.
+      value_buf.SetForwardPos(offset);
+      DecodeOrSkip(bs, &key_buf, &value_buf, record, record_index, false);
+    }
+  }
+  return 0;
+}
+
+int RecordDecoder::Decode(const std::string& key, const std::string& value, const std::vector<int>& column_indexes,
+                          std::vector<std::any>& record) {
+  return DecodeWithMapping(key, value, SortedColumnMapping(column_indexes), record);
+}
 
-      DecodeOrSkip(bs, &key_buf, &value_buf, record, record_index, IsSkipOnly(col_index_mapping, n, m, record_index));
+int RecordDecoder::DecodeBatch(const std::vector<pb::common::KeyValue>& key_values,
+                               const std::vector<int>& column_indexes, std::vector<std::vector<std::any>>& records) {
+  auto col_index_mapping = SortedColumnMapping(column_indexes);
+  records.resize(key_values.size());
+  for (size_t i = 0; i < key_values.size(); ++i) {
+    if (DecodeWithMapping(key_values[i].key(), key_values[i].value(), col_index_mapping, records[i]) < 0) {
+      records.resize(i);
+      return -1;
     }
   }
   return 0;
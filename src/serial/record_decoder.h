@@ -43,6 +43,11 @@ class RecordDecoder {
   bool CheckPrefix(Buf* buf) const;
   bool CheckReverseTag(Buf* buf) const;
   bool CheckSchemaVersion(Buf* buf) const;
+  // offset_count is the value column count of offset table, -1 if no offset table.
+  bool CheckValueHeader(Buf* buf, int& offset_count) const;
+  int DecodeWithMapping(const std::string& key, const std::string& value,
+                        const std::vector<std::pair<int, int>>& col_index_mapping,
+                        std::vector<std::any>& record /*output*/);
 
   int codec_version_ = 1;
   int schema_version_;
@@ -68,6 +73,16 @@ class RecordDecoder {
              std::vector<std::any>& record /*output*/);
   int Decode(const std::string& key, const std::string& value, const std::vector<int>& column_indexes,
              std::vector<std::any>& record /*output*/);
+
+  // Decode a batch of key values, the sorted column mapping is built once for the whole batch.
+  // Return -1 if any key value is invalid, records of the valid prefix are kept.
+  int DecodeBatch(const std::vector<pb::common::KeyValue>& key_values, const std::vector<int>& column_indexes,
+                  std::vector<std::vector<std::any>>& records /*output*/);
+
+  // Decode key_values[begin, end) into records[begin, end), records must be sized by caller.
+  // Different ranges of the same batch can be decoded concurrently.
+  int DecodeBatch(const std::vector<pb::common::KeyValue>& key_values, size_t begin, size_t end,
+                  const std::vector<int>& column_indexes, std::vector<std::vector<std::any>>& records /*output*/);
 };
 
 }  // namespace dingodb
@@ -17,6 +17,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "proto/common.pb.h"
 #include "serial/keyvalue.h"  // IWYU pragma: keep
@@ -46,6 +47,13 @@ void RecordEncoder::Init(int schema_version, std::shared_ptr<std::vector<std::sh
   this->key_buf_size_ = size[0];
   this->value_buf_size_ = size[1];
   delete[] size;
+
+  this->value_column_count_ = 0;
+  for (const auto& bs : *schemas) {
+    if (bs && !bs->IsKey()) {
+      this->value_column_count_++;
+    }
+  }
 }
 
 void RecordEncoder::EncodePrefix(Buf* buf) const {
@@ -157,11 +165,25 @@ int RecordEncoder::EncodeKey(const std::vector<std::any>& record, std::string& o
 
 int RecordEncoder::EncodeValue(const std::vector<std::any>& record, std::string& output) {
   Buf* value_buf = new Buf(value_buf_size_, this->le_);
-  value_buf->EnsureRemainder(4);
-  EncodeSchemaVersion(value_buf);
+  bool with_offset_table = value_offset_table_ && schema_version_ >= 0 && schema_version_ <= kValueSchemaVersionMask;
+  std::vector<int> offsets;
+  if (with_offset_table) {
+    // |header|count|offsets|, offsets are filled after all columns are encoded.
+    value_buf->EnsureRemainder(kValueOffsetTablePos + value_column_count_ * 4);
+    value_buf->WriteInt(schema_version_ | (kValueCodecVersionOffsetTable << kValueCodecVersionShift));
+    value_buf->WriteInt(value_column_count_);
+    value_buf->Skip(value_column_count_ * 4);
+    offsets.reserve(value_column_count_);
+  } else {
+    value_buf->EnsureRemainder(4);
+    EncodeSchemaVersion(value_buf);
+  }
   int index = 0;
   for (const auto& bs : *schemas_) {
     if (bs) {
+      if (with_offset_table && !bs->IsKey()) {
+        offsets.push_back(value_buf->GetForwardPos());
+      }
       BaseSchema::Type type = bs->GetType();
       switch (type) {
         case BaseSchema::kBool: {
@@ -264,6 +286,15 @@ int RecordEncoder::EncodeValue(const std::vector<std::any>& record, std::string&
     index++;
   }
 
+  if (with_offset_table) {
+    int end_pos = value_buf->GetForwardPos();
+    value_buf->SetForwardPos(kValueOffsetTablePos);
+    for (int offset : offsets) {
+      value_buf->WriteInt(offset);
+    }
+    value_buf->SetForwardPos(end_pos);
+  }
+
   int ret = value_buf->GetBytes(output);
   delete value_buf;
 
@@ -50,6 +50,9 @@ class RecordEncoder {
   int key_buf_size_;
   int value_buf_size_;
   bool le_;
+  // see kValueCodecVersionOffsetTable
+  bool value_offset_table_ = false;
+  int value_column_count_ = 0;
 
  public:
   RecordEncoder(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas, long common_id);
@@ -58,6 +61,9 @@ class RecordEncoder {
 
   void Init(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas, long common_id);
 
+  // Encode value with offset table, all readers of the value must support value codec version 2.
+  void SetValueOffsetTable(bool enable) { value_offset_table_ = enable; }
+
   int Encode(const std::vector<std::any>& record, pb::common::KeyValue& key_value /*output*/);
   int Encode(const std::vector<std::any>& record, std::string& key, std::string& value);
 
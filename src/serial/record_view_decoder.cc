@@ -0,0 +1,340 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "record_view_decoder.h"
+
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "serial/utils.h"
+
+namespace dingodb {
+
+namespace {
+
+constexpr uint8_t kNull = 0;
+
+template <int kLength>
+inline uint64_t ReadBigEndian(const uint8_t* p) {
+  uint64_t v = 0;
+  for (int i = 0; i < kLength; ++i) {
+    v = (v << 8) | p[i];
+  }
+  return v;
+}
+
+template <BaseSchema::Type kType>
+constexpr int FixedLength() {
+  if constexpr (kType == BaseSchema::kBool) {
+    return 1;
+  } else if constexpr (kType == BaseSchema::kInteger || kType == BaseSchema::kFloat) {
+    return 4;
+  } else {
+    return 8;
+  }
+}
+
+// Fixed length column, null column is a null tag followed by zero data, so skip never parse data.
+// Key encoding flips the sign bit to keep order, negative float and double are encoded by inverting all bits.
+template <BaseSchema::Type kType, bool kIsKey>
+bool FixedStep(RecordViewDecoder::Cursor& cursor, bool allow_null, RecordViewDecoder::Column* column) {
+  constexpr int kLength = FixedLength<kType>();
+  size_t length = allow_null ? kLength + 1 : kLength;
+  if (cursor.pos + length > cursor.end) {
+    return false;
+  }
+  const uint8_t* p = cursor.data + cursor.pos;
+  cursor.pos += length;
+  if (column == nullptr) {
+    return true;
+  }
+
+  if (allow_null && *p++ == kNull) {
+    column->is_null = true;
+    return true;
+  }
+  column->is_null = false;
+
+  uint64_t bits = ReadBigEndian<kLength>(p);
+  if constexpr (kType == BaseSchema::kBool) {
+    column->bool_value = bits != 0;
+  } else if constexpr (kType == BaseSchema::kInteger) {
+    if constexpr (kIsKey) {
+      bits ^= 0x80000000;
+    }
+    column->int_value = static_cast<int32_t>(static_cast<uint32_t>(bits));
+  } else if constexpr (kType == BaseSchema::kLong) {
+    if constexpr (kIsKey) {
+      bits ^= 0x8000000000000000ULL;
+    }
+    column->long_value = static_cast<int64_t>(bits);
+  } else if constexpr (kType == BaseSchema::kFloat) {
+    if constexpr (kIsKey) {
+      bits = (bits & 0x80000000) ? bits ^ 0x80000000 : ~bits;
+    }
+    uint32_t bits32 = static_cast<uint32_t>(bits);
+    memcpy(&column->float_value, &bits32, 4);
+  } else {
+    if constexpr (kIsKey) {
+      bits = (bits & 0x8000000000000000ULL) ? bits ^ 0x8000000000000000ULL : ~bits;
+    }
+    memcpy(&column->double_value, &bits, 8);
+  }
+  return true;
+}
+
+// [null tag] length(4 bytes) data
+bool StringValueStep(RecordViewDecoder::Cursor& cursor, bool allow_null, RecordViewDecoder::Column* column) {
+  if (allow_null) {
+    if (cursor.pos + 1 > cursor.end) {
+      return false;
+    }
+    if (cursor.data[cursor.pos++] == kNull) {
+      if (column != nullptr) {
+        column->is_null = true;
+      }
+      return true;
+    }
+  }
+
+  if (cursor.pos + 4 > cursor.end) {
+    return false;
+  }
+  size_t length = ReadBigEndian<4>(cursor.data + cursor.pos);
+  cursor.pos += 4;
+  if (cursor.pos + length > cursor.end) {
+    return false;
+  }
+  if (column != nullptr) {
+    column->is_null = false;
+    column->string_value = std::string_view(reinterpret_cast<const char*>(cursor.data + cursor.pos), length);
+  }
+  cursor.pos += length;
+  return true;
+}
+
+// String key is group encoded for order, the encoded length is saved backward at the key tail.
+bool StringKeySkipStep(RecordViewDecoder::Cursor& cursor, bool allow_null, RecordViewDecoder::Column* /*column*/) {
+  if (cursor.end < cursor.pos + 4) {
+    return false;
+  }
+  const uint8_t* p = cursor.data + cursor.end;
+  size_t length = (static_cast<uint32_t>(p[-1]) << 24) | (static_cast<uint32_t>(p[-2]) << 16) |
+                  (static_cast<uint32_t>(p[-3]) << 8) | static_cast<uint32_t>(p[-4]);
+  cursor.end -= 4;
+  if (allow_null) {
+    length += 1;
+  }
+  if (cursor.pos + length > cursor.end) {
+    return false;
+  }
+  cursor.pos += length;
+  return true;
+}
+
+template <BaseSchema::Type kType>
+RecordViewDecoder::StepFunc FixedStepFunc(bool is_key) {
+  return is_key ? FixedStep<kType, true> : FixedStep<kType, false>;
+}
+
+RecordViewDecoder::StepFunc GetStepFunc(BaseSchema::Type type, bool is_key, bool is_decode) {
+  switch (type) {
+    case BaseSchema::kBool:
+      return FixedStepFunc<BaseSchema::kBool>(is_key);
+    case BaseSchema::kInteger:
+      return FixedStepFunc<BaseSchema::kInteger>(is_key);
+    case BaseSchema::kFloat:
+      return FixedStepFunc<BaseSchema::kFloat>(is_key);
+    case BaseSchema::kLong:
+      return FixedStepFunc<BaseSchema::kLong>(is_key);
+    case BaseSchema::kDouble:
+      return FixedStepFunc<BaseSchema::kDouble>(is_key);
+    case BaseSchema::kString:
+      if (is_key) {
+        return is_decode ? nullptr : StringKeySkipStep;
+      }
+      return StringValueStep;
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace
+
+RecordViewDecoder::RecordViewDecoder(int schema_version,
+                                     std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas,
+                                     long common_id)
+    : RecordViewDecoder(schema_version, schemas, common_id, IsLE()) {}
+
+RecordViewDecoder::RecordViewDecoder(int schema_version,
+                                     std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas,
+                                     long common_id, bool le)
+    : schema_version_(schema_version), schemas_(schemas), common_id_(common_id), le_(le) {
+  FormatSchema(schemas_, le_);
+}
+
+bool RecordViewDecoder::Compile(const std::vector<int>& column_indexes) {
+  compiled_ = false;
+  steps_.clear();
+  column_count_ = column_indexes.size();
+  if (!le_ || schemas_ == nullptr) {
+    return false;
+  }
+
+  // value = position in column_indexes
+  std::vector<int> outputs(schemas_->size(), -1);
+  for (size_t i = 0; i < column_indexes.size(); ++i) {
+    int index = column_indexes[i];
+    if (index < 0 || index >= static_cast<int>(outputs.size()) || outputs[index] != -1) {
+      return false;
+    }
+    outputs[index] = static_cast<int>(i);
+  }
+
+  // same as RecordDecoder, column index is the position in not null schemas, stop after the last selected column.
+  size_t remain = column_indexes.size();
+  int position = 0;
+  int value_ordinal = 0;
+  for (const auto& schema : *schemas_) {
+    if (remain == 0) {
+      break;
+    }
+    if (schema == nullptr) {
+      continue;
+    }
+
+    int output = outputs[position++];
+    auto func = GetStepFunc(schema->GetType(), schema->IsKey(), output >= 0);
+    if (func == nullptr) {
+      steps_.clear();
+      return false;
+    }
+    steps_.push_back(Step{func, schema->GetType(), schema->IsKey(), schema->AllowNull(), output,
+                          schema->IsKey() ? -1 : value_ordinal++});
+    if (output >= 0) {
+      --remain;
+    }
+  }
+
+  if (remain != 0) {
+    steps_.clear();
+    return false;
+  }
+
+  compiled_ = true;
+  return true;
+}
+
+int RecordViewDecoder::Decode(std::string_view key, std::string_view value, Row& row) const {
+  // key: namespace(1) common_id(8) ... codec_version at tail(4), value: schema_version(4) ...
+  if (!compiled_ || key.size() < 13 || value.size() < 4) {
+    return -1;
+  }
+
+  Cursor key_cursor{reinterpret_cast<const uint8_t*>(key.data()), 9, key.size() - 4};
+  if (static_cast<int64_t>(ReadBigEndian<8>(key_cursor.data + 1)) != common_id_ ||
+      key_cursor.data[key.size() - 1] > codec_version_) {
+    return -1;
+  }
+  Cursor value_cursor{reinterpret_cast<const uint8_t*>(value.data()), 4, value.size()};
+  int32_t header = static_cast<int32_t>(ReadBigEndian<4>(value_cursor.data));
+  int64_t offset_count = -1;
+  if (((header >> kValueCodecVersionShift) & 0xFF) == kValueCodecVersionOffsetTable) {
+    if (value.size() < kValueOffsetTablePos) {
+      return -1;
+    }
+    offset_count = ReadBigEndian<4>(value_cursor.data + 4);
+    if (kValueOffsetTablePos + offset_count * 4 > static_cast<int64_t>(value.size())) {
+      return -1;
+    }
+    header &= kValueSchemaVersionMask;
+  }
+  if (header > schema_version_) {
+    return -1;
+  }
+
+  row.resize(column_count_);
+  for (const auto& step : steps_) {
+    Column* column = step.output >= 0 ? &row[step.output] : nullptr;
+    if (column != nullptr) {
+      column->type = step.type;
+    }
+
+    if (step.is_key) {
+      if (!step.func(key_cursor, step.allow_null, column)) {
+        return -1;
+      }
+    } else if (offset_count >= 0) {
+      // jump by offset table, not selected value column need not skip.
+      if (column == nullptr) {
+        continue;
+      }
+      if (step.value_ordinal >= offset_count) {
+        column->is_null = true;
+        continue;
+      }
+      value_cursor.pos = ReadBigEndian<4>(value_cursor.data + kValueOffsetTablePos + step.value_ordinal * 4);
+      if (!step.func(value_cursor, step.allow_null, column)) {
+        return -1;
+      }
+    } else if (value_cursor.pos >= value_cursor.end) {
+      // column added after the record was written
+      if (column != nullptr) {
+        column->is_null = true;
+      }
+    } else if (!step.func(value_cursor, step.allow_null, column)) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+void RecordViewDecoder::ToRecord(const Row& row, std::vector<std::any>& record) {
+  record.resize(row.size());
+  for (size_t i = 0; i < row.size(); ++i) {
+    const auto& column = row[i];
+    switch (column.type) {
+      case BaseSchema::kBool:
+        record[i] = column.is_null ? std::optional<bool>() : std::optional<bool>(column.bool_value);
+        break;
+      case BaseSchema::kInteger:
+        record[i] = column.is_null ? std::optional<int32_t>() : std::optional<int32_t>(column.int_value);
+        break;
+      case BaseSchema::kFloat:
+        record[i] = column.is_null ? std::optional<float>() : std::optional<float>(column.float_value);
+        break;
+      case BaseSchema::kLong:
+        record[i] = column.is_null ? std::optional<int64_t>() : std::optional<int64_t>(column.long_value);
+        break;
+      case BaseSchema::kDouble:
+        record[i] = column.is_null ? std::optional<double>() : std::optional<double>(column.double_value);
+        break;
+      case BaseSchema::kString:
+        record[i] = column.is_null ? std::optional<std::shared_ptr<std::string>>()
+                                   : std::optional<std::shared_ptr<std::string>>(
+                                         std::make_shared<std::string>(column.string_value));
+        break;
+      default:
+        record[i] = std::any();
+        break;
+    }
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,100 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGO_SERIAL_RECORD_VIEW_DECODER_H_
+#define DINGO_SERIAL_RECORD_VIEW_DECODER_H_
+
+#include <any>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "schema/base_schema.h"
+
+namespace dingodb {
+
+// Fast path of RecordDecoder for projections over a few columns.
+// The decode plan is compiled once from the schemas and the selected columns, every column is decoded by a step
+// specialized for its type and key/value place, without std::any, dynamic_cast or copying the key value into Buf.
+// Only scalar columns of little endian codec are supported, string key columns can be skipped but not decoded.
+// Compile fails for other schemas, the caller should fall back to RecordDecoder then.
+// Value with offset table jumps to the selected value columns directly, see kValueCodecVersionOffsetTable.
+class RecordViewDecoder {
+ public:
+  struct Column {
+    BaseSchema::Type type{BaseSchema::kBool};
+    bool is_null{true};
+    union {
+      bool bool_value;
+      int32_t int_value;
+      float float_value;
+      int64_t long_value{0};
+      double double_value;
+    };
+    // point into the decoded value, valid as long as the value.
+    std::string_view string_value;
+  };
+  // array index = position in column_indexes of Compile
+  using Row = std::vector<Column>;
+
+  RecordViewDecoder(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas,
+                    long common_id);
+  RecordViewDecoder(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas,
+                    long common_id, bool le);
+
+  // column_indexes same as RecordDecoder::Decode, return false if not supported.
+  bool Compile(const std::vector<int>& column_indexes);
+  bool IsCompiled() const { return compiled_; }
+
+  int Decode(std::string_view key, std::string_view value, Row& row /*output*/) const;
+
+  // Box the row in the same std::any types of RecordDecoder output.
+  static void ToRecord(const Row& row, std::vector<std::any>& record /*output*/);
+
+  struct Cursor {
+    const uint8_t* data;
+    size_t pos;
+    // exclusive, the key tail is consumed backward by string key length.
+    size_t end;
+  };
+  using StepFunc = bool (*)(Cursor& cursor, bool allow_null, Column* column);
+
+ private:
+  struct Step {
+    StepFunc func;
+    BaseSchema::Type type;
+    bool is_key;
+    bool allow_null;
+    // -1 means skip
+    int output;
+    // position in value columns for offset table, -1 for key column
+    int value_ordinal;
+  };
+
+  int codec_version_ = 1;
+  int schema_version_;
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas_;
+  long common_id_;
+  bool le_;
+
+  bool compiled_{false};
+  size_t column_count_{0};
+  std::vector<Step> steps_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGO_SERIAL_RECORD_VIEW_DECODER_H_
@@ -16,6 +16,7 @@
 #define DINGO_SERIAL_UTILS_H_
 
 #include <any>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -35,6 +36,15 @@
 
 namespace dingodb {
 
+// The high byte of value header is the value codec version, the low 3 bytes is schema version.
+// Value of version 2 has a offset table after the header: |header(4)|count(4)|offset(4) * count|columns...|,
+// offset is the position of every value column in schema order, so projection jumps to the column directly.
+// Version 0 value has no offset table, old decoders reject version 2 value for a bigger schema version.
+constexpr int kValueCodecVersionShift = 24;
+constexpr int32_t kValueSchemaVersionMask = 0x00FFFFFF;
+constexpr int kValueCodecVersionOffsetTable = 2;
+constexpr int kValueOffsetTablePos = 8;
+
 void SortSchema(std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas);
 void FormatSchema(std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas, bool le);
 int* GetApproPerRecordSize(std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas);
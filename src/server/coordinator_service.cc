@@ -18,6 +18,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -671,7 +672,9 @@ void DoStoreHeartbeat(google::protobuf::RpcController * /*controller*/,
 
   // update store metrics
   if (request->has_store_metrics()) {
-    coordinator_control->UpdateStoreMetrics(request->store_metrics(), meta_increment);
+    bool need_full_region_metrics = false;
+    coordinator_control->UpdateStoreMetrics(request->store_metrics(), meta_increment, need_full_region_metrics);
+    response->set_need_full_region_metrics(need_full_region_metrics);
 
     // update is_read_only
     auto is_read_only_from_store = request->store_metrics().store_own_metrics().is_ready_only();
@@ -708,6 +711,11 @@ void DoStoreHeartbeat(google::protobuf::RpcController * /*controller*/,
     }
   }
 
+  // the store sends heartbeat at once after region cmd done, the region of task pre check maybe changed.
+  if (request->has_store_metrics()) {
+    coordinator_control->TriggerProcessTaskList();
+  }
+
   auto *new_storemap = response->mutable_storemap();
   coordinator_control->GetStoreMap(*new_storemap);
 
@@ -725,7 +733,7 @@ void DoGetStoreMap(google::protobuf::RpcController * /*controller*/, const pb::c
   DINGO_LOG(DEBUG) << "Receive Get StoreMap Request, IsLeader:" << is_leader
                    << ", Request:" << request->ShortDebugString();
 
-  if (!is_leader) {
+  if (!is_leader && !coordinator_control->CheckFollowerRead().ok()) {
     coordinator_control->RedirectResponse(response);
     return;
   }
@@ -869,16 +877,21 @@ void DoGetRegionMap(google::protobuf::RpcController * /*controller*/,
   DINGO_LOG(DEBUG) << "Receive Get RegionMap Request, IsLeader:" << is_leader
                    << ", Request:" << request->ShortDebugString();
 
-  if (!is_leader) {
+  if (!is_leader && !coordinator_control->CheckFollowerRead().ok()) {
     coordinator_control->RedirectResponse(response);
     return;
   }
 
-  pb::common::RegionMap regionmap;
-  coordinator_control->GetRegionMap(regionmap);
+  auto *regionmap = response->mutable_regionmap();
+  if (request->limit() > 0) {
+    std::string next_start_key;
+    coordinator_control->GetRegionMap(request->start_key(), request->limit(), *regionmap, next_start_key);
+    response->set_next_start_key(next_start_key);
+  } else {
+    coordinator_control->GetRegionMap(*regionmap);
+  }
 
-  *(response->mutable_regionmap()) = regionmap;
-  response->set_epoch(regionmap.epoch());
+  response->set_epoch(regionmap->epoch());
 }
 
 void DoGetDeletedRegionMap(google::protobuf::RpcController * /*controller*/,
@@ -1137,7 +1150,7 @@ void DoQueryRegion(google::protobuf::RpcController * /*controller*/, const pb::c
   tracker->SetServiceQueueWaitTime();
 
   auto is_leader = coordinator_control->IsLeader();
-  if (!is_leader) {
+  if (!is_leader && !coordinator_control->CheckFollowerRead().ok()) {
     return coordinator_control->RedirectResponse(response);
   }
 
@@ -1467,11 +1480,44 @@ void DoChangePeerRegion(google::protobuf::RpcController * /*controller*/,
   }
 
   std::vector<int64_t> new_store_ids;
+  std::vector<int64_t> new_learner_store_ids;
   for (const auto &it : region_definition.peers()) {
-    new_store_ids.push_back(it.store_id());
+    if (it.role() == pb::common::PeerRole::LEARNER) {
+      new_learner_store_ids.push_back(it.store_id());
+    } else {
+      new_store_ids.push_back(it.store_id());
+    }
+  }
+
+  // change learners or voters, not both at once
+  pb::common::Region region;
+  auto ret = coordinator_control->QueryRegion(region_definition.id(), region);
+  if (!ret.ok()) {
+    response->mutable_error()->set_errcode(static_cast<pb::error::Errno>(ret.error_code()));
+    response->mutable_error()->set_errmsg(ret.error_str());
+    return;
+  }
+  std::set<int64_t> old_store_ids;
+  std::set<int64_t> old_learner_store_ids;
+  for (const auto &it : region.definition().peers()) {
+    if (it.role() == pb::common::PeerRole::LEARNER) {
+      old_learner_store_ids.insert(it.store_id());
+    } else {
+      old_store_ids.insert(it.store_id());
+    }
   }
 
-  auto ret = coordinator_control->ChangePeerRegionWithTaskList(region_definition.id(), new_store_ids, meta_increment);
+  if (old_learner_store_ids != std::set<int64_t>(new_learner_store_ids.begin(), new_learner_store_ids.end())) {
+    if (old_store_ids != std::set<int64_t>(new_store_ids.begin(), new_store_ids.end())) {
+      response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
+      response->mutable_error()->set_errmsg("Change voters and learners at the same time");
+      return;
+    }
+    ret = coordinator_control->ChangeLearnerRegionWithTaskList(region_definition.id(), new_learner_store_ids,
+                                                               meta_increment);
+  } else {
+    ret = coordinator_control->ChangePeerRegionWithTaskList(region_definition.id(), new_store_ids, meta_increment);
+  }
 
   if (!ret.ok()) {
     response->mutable_error()->set_errcode(static_cast<pb::error::Errno>(ret.error_code()));
@@ -2036,7 +2082,7 @@ void DoScanRegions(google::protobuf::RpcController * /*controller*/, const pb::c
   }
 
   auto is_leader = coordinator_control->IsLeader();
-  if (!is_leader) {
+  if (!is_leader && !coordinator_control->CheckFollowerRead().ok()) {
     return coordinator_control->RedirectResponse(response);
   }
 
@@ -2278,6 +2324,8 @@ void DoUpdateRegionCmdStatus(google::protobuf::RpcController * /*controller*/,
     ServiceHelper::SetError(response->mutable_error(), ret2.error_code(), ret2.error_str());
     return;
   }
+
+  coordinator_control->TriggerProcessTaskList();
 }
 
 void CoordinatorServiceImpl::CreateExecutor(google::protobuf::RpcController *controller,
@@ -2613,7 +2661,7 @@ void CoordinatorServiceImpl::GetStoreMap(google::protobuf::RpcController *contro
   DINGO_LOG(DEBUG) << "Receive Get StoreMap Request, IsLeader:" << is_leader
                    << ", Request:" << request->ShortDebugString();
 
-  if (!is_leader) {
+  if (!is_leader && !CoordinatorControl::IsFollowerReadEnabled()) {
     RedirectResponse(response);
     return;
   }
@@ -2767,7 +2815,7 @@ void CoordinatorServiceImpl::GetRegionMap(google::protobuf::RpcController *contr
   DINGO_LOG(DEBUG) << "Receive Get RegionMap Request, IsLeader:" << is_leader
                    << ", Request:" << request->ShortDebugString();
 
-  if (!is_leader) {
+  if (!is_leader && !CoordinatorControl::IsFollowerReadEnabled()) {
     RedirectResponse(response);
     return;
   }
@@ -2970,7 +3018,7 @@ void CoordinatorServiceImpl::QueryRegion(google::protobuf::RpcController *contro
   DINGO_LOG(DEBUG) << "Receive Query Region Request:" << request->ShortDebugString();
 
   auto is_leader = coordinator_control_->IsLeader();
-  if (!is_leader) {
+  if (!is_leader && !CoordinatorControl::IsFollowerReadEnabled()) {
     return coordinator_control_->RedirectResponse(response);
   }
 
@@ -3422,7 +3470,7 @@ void CoordinatorServiceImpl::ScanRegions(google::protobuf::RpcController *contro
   }
 
   auto is_leader = coordinator_control_->IsLeader();
-  if (!is_leader) {
+  if (!is_leader && !CoordinatorControl::IsFollowerReadEnabled()) {
     return coordinator_control_->RedirectResponse(response);
   }
 
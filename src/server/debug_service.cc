@@ -28,7 +28,12 @@
 #include "common/context.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/memory_tracker.h"
+#include "common/profiler.h"
+#include "common/slow_log.h"
+#include "crontab/crontab.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
@@ -48,6 +53,8 @@ using dingodb::pb::error::Errno;
 
 namespace dingodb {
 
+DEFINE_uint32(debug_latch_hot_slot_num, 16, "the number of hottest latch slots of every region in debug dump");
+
 void DebugServiceImpl::AddRegion(google::protobuf::RpcController* controller,
                                  const dingodb::pb::debug::AddRegionRequest* request,
                                  dingodb::pb::debug::AddRegionResponse* response, google::protobuf::Closure* done) {
@@ -484,6 +491,57 @@ void DebugServiceImpl::Debug(google::protobuf::RpcController* controller,
 
     Helper::VectorToPbRepeated(records, response->mutable_region_change_record()->mutable_records());
 
+  } else if (request->type() == pb::debug::DebugType::STORE_REGION_LATCHES) {
+    auto store_region_meta = GET_STORE_REGION_META;
+    std::vector<store::RegionPtr> regions;
+    if (request->region_ids().empty()) {
+      regions = store_region_meta->GetAllRegion();
+    } else {
+      for (auto region_id : request->region_ids()) {
+        auto region = store_region_meta->GetRegion(region_id);
+        if (region != nullptr) {
+          regions.push_back(region);
+        }
+      }
+    }
+
+    for (auto& region : regions) {
+      auto slot_stats = region->LatchesHotSlots(FLAGS_debug_latch_hot_slot_num);
+      if (slot_stats.empty()) {
+        continue;
+      }
+
+      auto* region_latch = response->mutable_region_latches()->add_region_latches();
+      region_latch->set_region_id(region->Id());
+      for (const auto& slot_stat : slot_stats) {
+        auto* slot = region_latch->add_slots();
+        slot->set_index(slot_stat.index);
+        slot->set_acquire_count(slot_stat.acquire_count);
+        slot->set_wait_count(slot_stat.wait_count);
+        slot->set_total_wait_us(slot_stat.total_wait_us);
+        slot->set_max_wait_us(slot_stat.max_wait_us);
+        slot->set_waiting_num(slot_stat.waiting_num);
+      }
+    }
+
+  } else if (request->type() == pb::debug::DebugType::STORE_CRONTAB) {
+    auto crontab_manager = Server::GetInstance().GetCrontabManager();
+    if (crontab_manager != nullptr) {
+      auto* mut_crontabs = response->mutable_crontabs();
+      mut_crontabs->set_running_background_job_num(crontab_manager->RunningBackgroundJobNum());
+      for (auto& crontab : crontab_manager->GetCrontabs()) {
+        auto* entry = mut_crontabs->add_crontabs();
+        entry->set_id(crontab->id);
+        entry->set_name(crontab->name);
+        entry->set_interval_ms(crontab->interval);
+        entry->set_run_count(crontab->run_count);
+        entry->set_skip_count(crontab->skip_count.load());
+        entry->set_running(crontab->running.load());
+        entry->set_background(crontab->background);
+        entry->set_last_elapsed_ms(crontab->last_elapsed_ms.load());
+      }
+    }
+
   } else if (request->type() == pb::debug::DebugType::INDEX_VECTOR_INDEX_METRICS) {
     auto store_region_meta = GET_STORE_REGION_META;
     std::vector<store::RegionPtr> regions;
@@ -617,6 +675,19 @@ void DebugServiceImpl::GetMemoryStats(google::protobuf::RpcController* controlle
   brpc::Controller* cntl = (brpc::Controller*)controller;
   brpc::ClosureGuard done_guard(svr_done);
 
+  auto& memory_tracker = MemoryTracker::GetInstance();
+  auto* total_memory = response->add_subsystem_memories();
+  total_memory->set_name("total");
+  total_memory->set_usage_bytes(memory_tracker.TotalUsage());
+  total_memory->set_budget_bytes(MemoryTracker::TotalBudget());
+  for (int i = 0; i < static_cast<int>(MemoryTracker::Type::kMax); ++i) {
+    auto type = static_cast<MemoryTracker::Type>(i);
+    auto* subsystem_memory = response->add_subsystem_memories();
+    subsystem_memory->set_name(MemoryTracker::TypeName(type));
+    subsystem_memory->set_usage_bytes(memory_tracker.Usage(type));
+    subsystem_memory->set_budget_bytes(MemoryTracker::Budget(type));
+  }
+
 #ifdef LINK_TCMALLOC
   std::string stat_buf(4096, '\0');
   MallocExtension::instance()->GetStats(stat_buf.data(), stat_buf.size());
@@ -648,6 +719,53 @@ void DebugServiceImpl::ReleaseFreeMemory(google::protobuf::RpcController* contro
 #endif
 }
 
+static Profiler::Type ToProfilerType(pb::debug::ProfileType type) {
+  switch (type) {
+    case pb::debug::PROFILE_HEAP:
+      return Profiler::Type::kHeap;
+    case pb::debug::PROFILE_CONTENTION:
+      return Profiler::Type::kContention;
+    default:
+      return Profiler::Type::kCpu;
+  }
+}
+
+void DebugServiceImpl::Profile(google::protobuf::RpcController* controller,
+                               const ::dingodb::pb::debug::ProfileRequest* request,
+                               ::dingodb::pb::debug::ProfileResponse* response, ::google::protobuf::Closure* done) {
+  auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
+  brpc::ClosureGuard done_guard(svr_done);
+
+  auto type = ToProfilerType(request->type());
+  auto& profiler = Profiler::GetInstance();
+  if (!request->is_list()) {
+    std::string filepath;
+    auto status = profiler.StartProfile(type, request->duration_s(), filepath);
+    if (!status.ok()) {
+      ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+      return;
+    }
+    response->set_filepath(filepath);
+  }
+
+  for (const auto& filename : profiler.ListProfiles(type)) {
+    response->add_filenames(filename);
+  }
+}
+
+void DebugServiceImpl::GetSlowRequests(google::protobuf::RpcController* controller,
+                                       const ::dingodb::pb::debug::GetSlowRequestsRequest* request,
+                                       ::dingodb::pb::debug::GetSlowRequestsResponse* response,
+                                       ::google::protobuf::Closure* done) {
+  auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
+  brpc::Controller* cntl = (brpc::Controller*)controller;
+  brpc::ClosureGuard done_guard(svr_done);
+
+  auto slow_requests =
+      SlowLog::GetInstance().GetSlowRequests(request->method(), request->min_elapsed_us(), request->limit());
+  Helper::VectorToPbRepeated(slow_requests, response->mutable_slow_requests());
+}
+
 void DebugServiceImpl::TraceWorkQueue(google::protobuf::RpcController* controller,
                                       const ::dingodb::pb::debug::TraceWorkQueueRequest* request,
                                       ::dingodb::pb::debug::TraceWorkQueueResponse* response,
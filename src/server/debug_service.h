@@ -66,6 +66,14 @@ class DebugServiceImpl : public pb::debug::DebugService {
                          ::dingodb::pb::debug::ReleaseFreeMemoryResponse* response,
                          ::google::protobuf::Closure* done) override;
 
+  void Profile(google::protobuf::RpcController* controller, const ::dingodb::pb::debug::ProfileRequest* request,
+               ::dingodb::pb::debug::ProfileResponse* response, ::google::protobuf::Closure* done) override;
+
+  void GetSlowRequests(google::protobuf::RpcController* controller,
+                       const ::dingodb::pb::debug::GetSlowRequestsRequest* request,
+                       ::dingodb::pb::debug::GetSlowRequestsResponse* response,
+                       ::google::protobuf::Closure* done) override;
+
   void TraceWorkQueue(google::protobuf::RpcController* controller,
                       const ::dingodb::pb::debug::TraceWorkQueueRequest* request,
                       ::dingodb::pb::debug::TraceWorkQueueResponse* response,
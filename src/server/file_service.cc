@@ -17,6 +17,7 @@
 #include <cstdint>
 #include <vector>
 
+#include "common/helper.h"
 #include "fmt/core.h"
 #include "server/service_helper.h"
 
@@ -61,6 +62,8 @@ void FileServiceImpl::GetFile(google::protobuf::RpcController* controller,
     return;
   }
 
+  response->set_has_checksum(true);
+  response->set_checksum(Helper::Crc32c(buf));
   cntl->response_attachment().swap(buf);
 }
 
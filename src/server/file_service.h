@@ -44,7 +44,11 @@ class FileReaderWrapper {
  public:
   FileReaderWrapper(vector_index::SnapshotMetaPtr snapshot)
       : snapshot_(snapshot),
+        path_(snapshot->Path()),
         file_reader_(std::make_shared<LocalDirReader>(new braft::PosixFileSystemAdaptor(), snapshot->Path())) {}
+  // Read the files of a plain directory, e.g. sst files of bulk load.
+  FileReaderWrapper(const std::string& path)
+      : path_(path), file_reader_(std::make_shared<LocalDirReader>(new braft::PosixFileSystemAdaptor(), path)) {}
   ~FileReaderWrapper() = default;
 
   int ReadFile(butil::IOBuf* out, const std::string& filename, off_t offset, size_t max_count, size_t* read_count,
@@ -52,10 +56,11 @@ class FileReaderWrapper {
     return file_reader_->ReadFile(out, filename, offset, max_count, read_count, is_eof);
   }
 
-  std::string Path() { return snapshot_->Path(); }
+  std::string Path() { return path_; }
 
  private:
   vector_index::SnapshotMetaPtr snapshot_;
+  std::string path_;
   std::shared_ptr<FileReader> file_reader_;
 };
 
@@ -26,6 +26,7 @@
 #include "common/context.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/numa.h"
 #include "common/synchronization.h"
 #include "common/version.h"
 #include "engine/storage.h"
@@ -40,6 +41,9 @@
 #include "server/server.h"
 #include "server/service_helper.h"
 #include "vector/codec.h"
+#include "vector/vector_index_manager.h"
+#include "vector/vector_search_batcher.h"
+#include "vector/vector_search_cache.h"
 
 using dingodb::pb::error::Errno;
 
@@ -52,6 +56,9 @@ DEFINE_int64(vector_max_request_size, 8388608, "vector max batch count in one re
 DEFINE_bool(enable_async_vector_search, true, "enable async vector search");
 DEFINE_bool(enable_async_vector_count, true, "enable async vector count");
 DEFINE_bool(enable_async_vector_operation, true, "enable async vector operation");
+DEFINE_bool(enable_vector_bruteforce_search_when_loading, false,
+            "search by scanning vector data when the vector index is loading, so the region serve search at once, "
+            "mind the cost for large region");
 
 extern bvar::LatencyRecorder g_txn_latches_recorder;
 
@@ -100,9 +107,12 @@ static butil::Status ValidateVectorBatchQueryRequest(StoragePtr storage,
                                      request->vector_ids().size(), FLAGS_vector_max_batch_count));
   }
 
-  status = storage->ValidateLeader(request->context().region_id());
-  if (!status.ok()) {
-    return status;
+  // non leader read is validated by storage.
+  if (request->context().read_mode() == pb::store::ReadLeader) {
+    status = storage->ValidateLeader(request->context().region_id());
+    if (!status.ok()) {
+      return status;
+    }
   }
 
   return ServiceHelper::ValidateIndexRegion(region, Helper::PbRepeatedToVector(request->vector_ids()));
@@ -135,6 +145,7 @@ void DoVectorBatchQuery(StoragePtr storage, google::protobuf::RpcController* con
   ctx->partition_id = region->PartitionId();
   ctx->region_id = region->Id();
   ctx->region_range = region->Range();
+  ctx->read_mode = request->context().read_mode();
   ctx->vector_ids = Helper::PbRepeatedToVector(request->vector_ids());
   ctx->selected_scalar_keys = Helper::PbRepeatedToVector(request->selected_keys());
   ctx->with_vector_data = !request->without_vector_data();
@@ -160,6 +171,11 @@ void IndexServiceImpl::VectorBatchQuery(google::protobuf::RpcController* control
                                         google::protobuf::Closure* done) {
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
 
+  int32_t tenant_priority = 0;
+  if (!ServiceHelper::AdmitTenantRequest(request, response, svr_done, tenant_priority)) {
+    return;
+  }
+
   if (!FLAGS_enable_async_vector_operation) {
     return DoVectorBatchQuery(storage_, controller, request, response, svr_done);
   }
@@ -168,6 +184,8 @@ void IndexServiceImpl::VectorBatchQuery(google::protobuf::RpcController* control
   StoragePtr storage = storage_;
   auto task =
       std::make_shared<ServiceTask>([=]() { DoVectorBatchQuery(storage, controller, request, response, svr_done); });
+  task->SetPriority(tenant_priority);
+  ServiceHelper::SetTaskLane(task, TaskLane::kPointRead, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -176,6 +194,38 @@ void IndexServiceImpl::VectorBatchQuery(google::protobuf::RpcController* control
   }
 }
 
+// Loading vector index is searched by brute force when enable_vector_bruteforce_search_when_loading,
+// offloaded vector index is always searched by brute force.
+static butil::Status ValidateVectorIndexSearchable(store::RegionPtr region) {
+  auto vector_index_wrapper = region->VectorIndexWrapper();
+  if (vector_index_wrapper->IsReady()) {
+    return butil::Status();
+  }
+
+  if (vector_index_wrapper->IsBuildError()) {
+    return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR,
+                         fmt::format("Vector index {} build error, please wait for recover.", region->Id()));
+  }
+  // offloaded vector index is searched by brute force, and reloaded when the searches are sustained.
+  if (vector_index_wrapper->IsOffloaded()) {
+    if (vector_index_wrapper->CountOffloadedSearch() && vector_index_wrapper->LoadorbuildingNum() == 0) {
+      DINGO_LOG(INFO) << fmt::format("[vector_index.offload][index_id({})] reload offloaded vector index.",
+                                     region->Id());
+      VectorIndexManager::LaunchLoadAsyncBuildVectorIndex(vector_index_wrapper, false, false, 0, "reload offloaded");
+    }
+    return butil::Status();
+  }
+
+  // load failed is followed by a build.
+  if (FLAGS_enable_vector_bruteforce_search_when_loading &&
+      (vector_index_wrapper->LoadorbuildingNum() > 0 || vector_index_wrapper->RebuildingNum() > 0)) {
+    return butil::Status();
+  }
+
+  return butil::Status(pb::error::EVECTOR_INDEX_NOT_READY,
+                       fmt::format("Vector index {} not ready, please retry.", region->Id()));
+}
+
 static butil::Status ValidateVectorSearchRequest(StoragePtr storage, const pb::index::VectorSearchRequest* request,
                                                  store::RegionPtr region) {
   if (region == nullptr) {
@@ -217,18 +267,17 @@ static butil::Status ValidateVectorSearchRequest(StoragePtr storage, const pb::i
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param vector_with_ids is empty");
   }
 
-  status = storage->ValidateLeader(request->context().region_id());
-  if (!status.ok()) {
-    return status;
+  // non leader read is validated by storage.
+  if (request->context().read_mode() == pb::store::ReadLeader) {
+    status = storage->ValidateLeader(request->context().region_id());
+    if (!status.ok()) {
+      return status;
+    }
   }
 
-  if (!region->VectorIndexWrapper()->IsReady()) {
-    if (region->VectorIndexWrapper()->IsBuildError()) {
-      return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR,
-                           fmt::format("Vector index {} build error, please wait for recover.", region->Id()));
-    }
-    return butil::Status(pb::error::EVECTOR_INDEX_NOT_READY,
-                         fmt::format("Vector index {} not ready, please retry.", region->Id()));
+  status = ValidateVectorIndexSearchable(region);
+  if (!status.ok()) {
+    return status;
   }
 
   std::vector<int64_t> vector_ids;
@@ -245,6 +294,25 @@ static butil::Status ValidateVectorSearchRequest(StoragePtr storage, const pb::i
   return ServiceHelper::ValidateIndexRegion(region, vector_ids);
 }
 
+static VectorSearchBatcher& GetVectorSearchBatcher(StoragePtr storage) {
+  // storage is the same one for all requests of the server.
+  static VectorSearchBatcher batcher(
+      [storage](std::shared_ptr<Engine::VectorReader::Context> ctx,
+                std::vector<pb::index::VectorWithDistanceResult>& results) -> butil::Status {
+        return storage->VectorBatchSearch(ctx, results);
+      });
+  return batcher;
+}
+
+static VectorSearchCache& GetVectorSearchCache(StoragePtr storage) {
+  static VectorSearchCache cache(
+      [storage](std::shared_ptr<Engine::VectorReader::Context> ctx,
+                std::vector<pb::index::VectorWithDistanceResult>& results) -> butil::Status {
+        return GetVectorSearchBatcher(storage).Search(ctx, results);
+      });
+  return cache;
+}
+
 void DoVectorSearch(StoragePtr storage, google::protobuf::RpcController* controller,
                     const pb::index::VectorSearchRequest* request, pb::index::VectorSearchResponse* response,
                     TrackClosure* done) {
@@ -273,6 +341,7 @@ void DoVectorSearch(StoragePtr storage, google::protobuf::RpcController* control
   ctx->region_id = region->Id();
   ctx->vector_index = region->VectorIndexWrapper();
   ctx->region_range = region->Range();
+  ctx->read_mode = request->context().read_mode();
   ctx->parameter = request->parameter();
   ctx->raw_engine_type = region->GetRawEngineType();
 
@@ -287,16 +356,24 @@ void DoVectorSearch(StoragePtr storage, google::protobuf::RpcController* control
     }
   }
 
+  // Get applied index before search, the result is not older than it.
+  auto raft_meta = Server::GetInstance().GetRaftMeta(region_id);
+  int64_t applied_index = raft_meta != nullptr ? raft_meta->AppliedId() : -1;
+
   std::vector<pb::index::VectorWithDistanceResult> vector_results;
-  status = storage->VectorBatchSearch(ctx, vector_results);
+  int64_t start_time_ns = Helper::TimestampNs();
+  status = GetVectorSearchCache(storage).Search(ctx, applied_index, vector_results);
+  tracker->AddVectorSearchTime(Helper::TimestampNs() - start_time_ns);
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
     return;
   }
 
+  start_time_ns = Helper::TimestampNs();
   for (auto& vector_result : vector_results) {
     *(response->add_batch_results()) = vector_result;
   }
+  tracker->AddSerializationTime(Helper::TimestampNs() - start_time_ns);
 }
 
 void IndexServiceImpl::VectorSearch(google::protobuf::RpcController* controller,
@@ -304,6 +381,11 @@ void IndexServiceImpl::VectorSearch(google::protobuf::RpcController* controller,
                                     pb::index::VectorSearchResponse* response, google::protobuf::Closure* done) {
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
 
+  int32_t tenant_priority = 0;
+  if (!ServiceHelper::AdmitTenantRequest(request, response, svr_done, tenant_priority)) {
+    return;
+  }
+
   if (!FLAGS_enable_async_vector_search) {
     return DoVectorSearch(storage_, controller, request, response, svr_done);
   }
@@ -312,7 +394,13 @@ void IndexServiceImpl::VectorSearch(google::protobuf::RpcController* controller,
   StoragePtr storage = storage_;
   auto task =
       std::make_shared<ServiceTask>([=]() { DoVectorSearch(storage, controller, request, response, svr_done); });
-  bool ret = read_worker_set_->ExecuteLeastQueue(task);
+  task->SetPriority(tenant_priority);
+  ServiceHelper::SetTaskLane(task, TaskLane::kVectorSearch, controller, response, svr_done);
+  auto worker_set = read_worker_set_;
+  if (!numa_search_worker_sets_.empty()) {
+    worker_set = numa_search_worker_sets_[Numa::NodeOfRegion(request->context().region_id())];
+  }
+  bool ret = worker_set->ExecuteLeastQueue(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
     ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
@@ -373,7 +461,7 @@ static butil::Status ValidateVectorAddRequest(StoragePtr storage, const pb::inde
                            "Param vector id is not allowed to be zero, INT64_MAX or negative");
     }
 
-    if (BAIDU_UNLIKELY(vector.vector().float_values().empty())) {
+    if (BAIDU_UNLIKELY(vector.vector().float_values().empty() && vector.vector().binary_values().empty())) {
       return butil::Status(pb::error::EVECTOR_EMPTY, "Vector is empty");
     }
   }
@@ -382,9 +470,15 @@ static butil::Status ValidateVectorAddRequest(StoragePtr storage, const pb::inde
   for (const auto& vector : request->vectors()) {
     if (vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW ||
         vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT ||
-        vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_BRUTEFORCE ||
-        vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_FLAT ||
-        vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ) {
+        vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_BRUTEFORCE) {
+      // binary and int8 vectors are packed in binary_values
+      if (!VectorCodec::CheckVectorDimension(vector.vector(), dimension)) {
+        return butil::Status(
+            pb::error::EILLEGAL_PARAMTETERS,
+            "Param vector dimension is error, correct dimension is " + std::to_string(dimension));
+      }
+    } else if (vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_FLAT ||
+               vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ) {
       if (vector.vector().float_values().size() != dimension) {
         return butil::Status(
             pb::error::EILLEGAL_PARAMTETERS,
@@ -442,12 +536,9 @@ void DoVectorAdd(StoragePtr storage, google::protobuf::RpcController* controller
   ctx->SetRegionEpoch(request->context().region_epoch());
   ctx->SetRawEngineType(region->GetRawEngineType());
 
-  std::vector<pb::common::VectorWithId> vectors;
-  for (const auto& vector : request->vectors()) {
-    vectors.push_back(vector);
-  }
-
-  status = storage->VectorAdd(ctx, is_sync, vectors);
+  // move the vectors of request into raft log, avoid copy the large payload
+  auto* mut_request = const_cast<pb::index::VectorAddRequest*>(request);
+  status = storage->VectorAdd(ctx, is_sync, Helper::PbRepeatedToVector(mut_request->mutable_vectors()));
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
 
@@ -460,6 +551,11 @@ void IndexServiceImpl::VectorAdd(google::protobuf::RpcController* controller,
                                  google::protobuf::Closure* done) {
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
 
+  int32_t tenant_priority = 0;
+  if (!ServiceHelper::AdmitTenantRequest(request, response, svr_done, tenant_priority)) {
+    return;
+  }
+
   if (IsRaftApplyPendingExceed()) {
     brpc::ClosureGuard done_guard(svr_done);
     ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
@@ -478,6 +574,7 @@ void IndexServiceImpl::VectorAdd(google::protobuf::RpcController* controller,
   StoragePtr storage = storage_;
   auto task =
       std::make_shared<ServiceTask>([=]() { DoVectorAdd(storage, controller, request, response, svr_done, true); });
+  task->SetPriority(tenant_priority);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -688,9 +785,12 @@ static butil::Status ValidateVectorScanQueryRequest(StoragePtr storage,
                          FLAGS_vector_max_batch_count);
   }
 
-  status = storage->ValidateLeader(request->context().region_id());
-  if (!status.ok()) {
-    return status;
+  // non leader read is validated by storage.
+  if (request->context().read_mode() == pb::store::ReadLeader) {
+    status = storage->ValidateLeader(request->context().region_id());
+    if (!status.ok()) {
+      return status;
+    }
   }
 
   // for VectorScanQuery, client can do scan from any id, so we don't need to check vector id
@@ -725,6 +825,7 @@ void DoVectorScanQuery(StoragePtr storage, google::protobuf::RpcController* cont
   ctx->partition_id = region->PartitionId();
   ctx->region_id = region->Id();
   ctx->region_range = region->Range();
+  ctx->read_mode = request->context().read_mode();
   ctx->selected_scalar_keys = Helper::PbRepeatedToVector(request->selected_keys());
   ctx->with_vector_data = !request->without_vector_data();
   ctx->with_scalar_data = !request->without_scalar_data();
@@ -763,6 +864,7 @@ void IndexServiceImpl::VectorScanQuery(google::protobuf::RpcController* controll
   StoragePtr storage = storage_;
   auto task =
       std::make_shared<ServiceTask>([=]() { DoVectorScanQuery(storage, controller, request, response, svr_done); });
+  ServiceHelper::SetTaskLane(task, TaskLane::kScan, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -937,8 +1039,9 @@ void DoVectorCount(StoragePtr storage, google::protobuf::RpcController* controll
   }
 
   int64_t count = 0;
-  status =
-      storage->VectorCount(region, GenCountRange(region, request->vector_id_start(), request->vector_id_end()), count);
+  bool approximate = request->approximate();
+  status = storage->VectorCount(region, GenCountRange(region, request->vector_id_start(), request->vector_id_end()),
+                                approximate, count);
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
 
@@ -946,6 +1049,7 @@ void DoVectorCount(StoragePtr storage, google::protobuf::RpcController* controll
   }
 
   response->set_count(count);
+  response->set_approximate(approximate);
 }
 
 void IndexServiceImpl::VectorCount(google::protobuf::RpcController* controller,
@@ -960,6 +1064,7 @@ void IndexServiceImpl::VectorCount(google::protobuf::RpcController* controller,
   // Run in queue.
   StoragePtr storage = storage_;
   auto task = std::make_shared<ServiceTask>([=]() { DoVectorCount(storage, controller, request, response, svr_done); });
+  ServiceHelper::SetTaskLane(task, TaskLane::kScan, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1015,14 +1120,9 @@ static butil::Status ValidateVectorSearchDebugRequest(StoragePtr storage,
     return status;
   }
 
-  auto vector_index_wrapper = region->VectorIndexWrapper();
-  if (!vector_index_wrapper->IsReady()) {
-    if (region->VectorIndexWrapper()->IsBuildError()) {
-      return butil::Status(pb::error::EVECTOR_INDEX_BUILD_ERROR,
-                           fmt::format("Vector index {} build error, please wait for recover.", region->Id()));
-    }
-    return butil::Status(pb::error::EVECTOR_INDEX_NOT_READY,
-                         fmt::format("Vector index {} not ready, please retry.", region->Id()));
+  status = ValidateVectorIndexSearchable(region);
+  if (!status.ok()) {
+    return status;
   }
 
   std::vector<int64_t> vector_ids;
@@ -1115,6 +1215,7 @@ void IndexServiceImpl::VectorSearchDebug(google::protobuf::RpcController* contro
   StoragePtr storage = storage_;
   auto task =
       std::make_shared<ServiceTask>([=]() { DoVectorSearchDebug(storage, controller, request, response, svr_done); });
+  ServiceHelper::SetTaskLane(task, TaskLane::kVectorSearch, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1221,6 +1322,7 @@ void IndexServiceImpl::TxnGet(google::protobuf::RpcController* controller, const
   StoragePtr storage = storage_;
   auto task =
       std::make_shared<ServiceTask>([=]() { DoTxnGetVector(storage, controller, request, response, svr_done); });
+  ServiceHelper::SetTaskLane(task, TaskLane::kPointRead, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1351,6 +1453,7 @@ void IndexServiceImpl::TxnScan(google::protobuf::RpcController* controller, cons
   StoragePtr storage = storage_;
   auto task =
       std::make_shared<ServiceTask>([=]() { DoTxnScanVector(storage, controller, request, response, svr_done); });
+  ServiceHelper::SetTaskLane(task, TaskLane::kScan, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1535,16 +1638,21 @@ static butil::Status ValidateIndexTxnPrewriteRequest(StoragePtr storage, const p
                              "the mutation key and VectorWithId");
       }
 
-      if (BAIDU_UNLIKELY(vector.vector().float_values().empty())) {
+      if (BAIDU_UNLIKELY(vector.vector().float_values().empty() && vector.vector().binary_values().empty())) {
         return butil::Status(pb::error::EVECTOR_EMPTY, "Vector is empty");
       }
 
       // check vector dimension
       if (vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW ||
           vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT ||
-          vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_BRUTEFORCE ||
-          vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_FLAT ||
-          vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ) {
+          vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_BRUTEFORCE) {
+        if (BAIDU_UNLIKELY(!VectorCodec::CheckVectorDimension(vector.vector(), dimension))) {
+          return butil::Status(
+              pb::error::EILLEGAL_PARAMTETERS,
+              "Param vector dimension is error, correct dimension is " + std::to_string(dimension));
+        }
+      } else if (vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_FLAT ||
+                 vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ) {
         if (BAIDU_UNLIKELY(vector.vector().float_values().size() != dimension)) {
           return butil::Status(
               pb::error::EILLEGAL_PARAMTETERS,
@@ -2119,6 +2227,7 @@ void IndexServiceImpl::TxnBatchGet(google::protobuf::RpcController* controller,
   StoragePtr storage = storage_;
   auto task =
       std::make_shared<ServiceTask>([=]() { DoTxnBatchGetVector(storage, controller, request, response, svr_done); });
+  ServiceHelper::SetTaskLane(task, TaskLane::kPointRead, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2247,6 +2356,7 @@ void IndexServiceImpl::TxnScanLock(google::protobuf::RpcController* controller,
   // Run in queue.
   StoragePtr storage = storage_;
   auto task = std::make_shared<ServiceTask>([=]() { DoTxnScanLock(storage, controller, request, response, svr_done); });
+  ServiceHelper::SetTaskLane(task, TaskLane::kScan, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2472,6 +2582,7 @@ void IndexServiceImpl::TxnDump(google::protobuf::RpcController* controller, cons
   // Run in queue.
   StoragePtr storage = storage_;
   auto task = std::make_shared<ServiceTask>([=]() { DoTxnDump(storage, controller, request, response, svr_done); });
+  ServiceHelper::SetTaskLane(task, TaskLane::kBackground, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
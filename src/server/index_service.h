@@ -15,6 +15,8 @@
 #ifndef DINGODB_INDEX_SERVICE_H_
 #define DINGODB_INDEX_SERVICE_H_
 
+#include <vector>
+
 #include "engine/storage.h"
 #include "proto/index.pb.h"
 #include "vector/vector_index_manager.h"
@@ -97,6 +99,10 @@ class IndexServiceImpl : public pb::index::IndexService {
 
   void SetStorage(StoragePtr storage) { storage_ = storage; }
   void SetReadWorkSet(PriorWorkerSetPtr worker_set) { read_worker_set_ = worker_set; }
+  // One worker set per numa node, the vector search of region run in the worker set of its node.
+  void SetNumaSearchWorkSets(const std::vector<PriorWorkerSetPtr>& worker_sets) {
+    numa_search_worker_sets_ = worker_sets;
+  }
   void SetWriteWorkSet(PriorWorkerSetPtr worker_set) { write_worker_set_ = worker_set; }
   void SetRaftApplyWorkSet(PriorWorkerSetPtr worker_set) { raft_apply_worker_set_ = worker_set; }
   void SetVectorIndexManager(VectorIndexManagerPtr vector_index_manager) {
@@ -110,6 +116,7 @@ class IndexServiceImpl : public pb::index::IndexService {
   StoragePtr storage_;
   // Run service request.
   PriorWorkerSetPtr read_worker_set_;
+  std::vector<PriorWorkerSetPtr> numa_search_worker_sets_;
   PriorWorkerSetPtr write_worker_set_;
   PriorWorkerSetPtr raft_apply_worker_set_;
   VectorIndexManagerPtr vector_index_manager_;
@@ -37,16 +37,20 @@
 #include <libunwind.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <csignal>
 #include <cstdlib>  // Replace stdlib.h with cstdlib
 #include <filesystem>
 #include <iostream>
+#include <vector>
 
 #include "brpc/server.h"
 #include "butil/endpoint.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/numa.h"
 #include "common/role.h"
 #include "common/syscheck.h"
 #include "common/version.h"
@@ -115,6 +119,63 @@ DECLARE_int32(vector_background_worker_num);
 DECLARE_int32(vector_fast_background_worker_num);
 DECLARE_int64(vector_max_background_task_count);
 DECLARE_int32(vector_operation_parallel_thread_num);
+DECLARE_int64(rocks_block_cache_capacity_mb);
+}  // namespace dingodb
+
+// The worker nums and cache capacity can be changed at runtime by /flags of brpc builtin service after the
+// server started, the validator applies the change, the flag is not changed if it fails.
+static std::atomic<bool> is_runtime_flags_enabled{false};
+
+static bool ValidateReadWorkerNum(const char *, int32_t value) {
+  if (!is_runtime_flags_enabled.load()) {
+    return true;
+  }
+  return value > 0 && dingodb::Server::GetInstance().ResizeReadWorkerSet(value);
+}
+DEFINE_validator(read_worker_num, &ValidateReadWorkerNum);
+
+static bool ValidateWriteWorkerNum(const char *, int32_t value) {
+  if (!is_runtime_flags_enabled.load()) {
+    return true;
+  }
+  return value > 0 && dingodb::Server::GetInstance().ResizeWriteWorkerSet(value);
+}
+DEFINE_validator(write_worker_num, &ValidateWriteWorkerNum);
+
+static bool ValidateRaftApplyWorkerNum(const char *, int32_t value) {
+  if (!is_runtime_flags_enabled.load()) {
+    return true;
+  }
+  // 0 means apply in raft thread, it can't be switched at runtime.
+  return value > 0 && dingodb::Server::GetInstance().ResizeRaftApplyWorkerSet(value);
+}
+DEFINE_validator(raft_apply_worker_num, &ValidateRaftApplyWorkerNum);
+
+namespace dingodb {
+
+static bool ValidateVectorBackgroundWorkerNum(const char *, int32_t value) {
+  if (!is_runtime_flags_enabled.load()) {
+    return true;
+  }
+  return value > 0 && Server::GetInstance().ResizeVectorIndexBackgroundWorkerSet(value);
+}
+DEFINE_validator(vector_background_worker_num, &ValidateVectorBackgroundWorkerNum);
+
+static bool ValidateVectorMaxBackgroundTaskCount(const char *, int64_t value) { return value >= 0; }
+DEFINE_validator(vector_max_background_task_count, &ValidateVectorMaxBackgroundTaskCount);
+
+static bool ValidateRocksBlockCacheCapacity(const char *, int64_t value) {
+  if (!is_runtime_flags_enabled.load() || value == 0) {
+    return true;
+  }
+  auto raw_engine = Server::GetInstance().GetRawEngine(pb::common::RAW_ENG_ROCKSDB);
+  if (value < 0 || raw_engine == nullptr) {
+    return false;
+  }
+  return raw_engine->SetBlockCacheCapacity(value * 1024 * 1024).ok();
+}
+DEFINE_validator(rocks_block_cache_capacity_mb, &ValidateRocksBlockCacheCapacity);
+
 }  // namespace dingodb
 
 // Get server endpoint from config
@@ -1261,6 +1322,24 @@ int main(int argc, char *argv[]) {
       return -1;
     }
     index_service.SetReadWorkSet(read_worker_set);
+
+    // Searches of a region run by the workers pinned on the numa node of its index memory.
+    if (dingodb::Numa::IsEnabled() && FLAGS_use_pthread_prior_worker_set) {
+      int node_num = dingodb::Numa::NodeNum();
+      std::vector<dingodb::PriorWorkerSetPtr> search_worker_sets;
+      for (int node = 0; node < node_num; ++node) {
+        int worker_num = std::max(1, FLAGS_read_worker_num / node_num);
+        auto search_worker_set = dingodb::PriorWorkerSet::New(fmt::format("search_wkr_{}", node), worker_num,
+                                                              FLAGS_read_worker_max_pending_num, true);
+        search_worker_set->SetNumaNode(node);
+        if (!search_worker_set->Init()) {
+          DINGO_LOG(ERROR) << "Init IndexServiceSearch PriorWorkerSet failed!";
+          return -1;
+        }
+        search_worker_sets.push_back(search_worker_set);
+      }
+      index_service.SetNumaSearchWorkSets(search_worker_sets);
+    }
     util_service.SetReadWorkSet(read_worker_set);
     dingo_server.SetIndexServiceReadWorkerSet(read_worker_set);
 
@@ -1402,6 +1481,7 @@ int main(int argc, char *argv[]) {
     return -1;
   }
   DINGO_LOG(INFO) << "Server is running on " << brpc_server.listen_address();
+  is_runtime_flags_enabled.store(true);
 
   // Wait until 'CTRL-C' is pressed. then Stop() and Join() the service
   while (!brpc::IsAskedToQuit()) {
@@ -217,7 +217,7 @@ void DoGetTable(google::protobuf::RpcController * /*controller*/, const pb::meta
                 std::shared_ptr<CoordinatorControl> coordinator_control, std::shared_ptr<Engine> /*raft_engine*/) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!coordinator_control->IsLeader()) {
+  if (!coordinator_control->IsLeader() && !coordinator_control->CheckFollowerRead().ok()) {
     return coordinator_control->RedirectResponse(response);
   }
 
@@ -286,7 +286,7 @@ void DoGetTableRange(google::protobuf::RpcController * /*controller*/, const pb:
                      std::shared_ptr<CoordinatorControl> coordinator_control, std::shared_ptr<Engine> /*raft_engine*/) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!coordinator_control->IsLeader()) {
+  if (!coordinator_control->IsLeader() && !coordinator_control->CheckFollowerRead().ok()) {
     return coordinator_control->RedirectResponse(response);
   }
 
@@ -846,6 +846,16 @@ void DoGenerateAutoIncrement(google::protobuf::RpcController *controller,
   DINGO_LOG(INFO) << request->ShortDebugString();
 
   int64_t table_id = request->table_id().entity_id();
+  int64_t start_id = 0;
+  int64_t end_id = 0;
+  if (auto_increment_control->GenerateAutoIncrementFromLease(table_id, request->count(),
+                                                             request->auto_increment_increment(),
+                                                             request->auto_increment_offset(), start_id, end_id)) {
+    response->set_start_id(start_id);
+    response->set_end_id(end_id);
+    return;
+  }
+
   pb::coordinator_internal::MetaIncrement meta_increment;
   auto ret =
       auto_increment_control->GenerateAutoIncrement(table_id, request->count(), request->auto_increment_increment(),
@@ -987,7 +997,7 @@ void DoGetIndex(google::protobuf::RpcController * /*controller*/, const pb::meta
                 std::shared_ptr<CoordinatorControl> coordinator_control, std::shared_ptr<Engine> /*raft_engine*/) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!coordinator_control->IsLeader()) {
+  if (!coordinator_control->IsLeader() && !coordinator_control->CheckFollowerRead().ok()) {
     return coordinator_control->RedirectResponse(response);
   }
 
@@ -1019,7 +1029,7 @@ void DoGetIndexByName(google::protobuf::RpcController * /*controller*/, const pb
                       std::shared_ptr<Engine> /*raft_engine*/) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!coordinator_control->IsLeader()) {
+  if (!coordinator_control->IsLeader() && !coordinator_control->CheckFollowerRead().ok()) {
     return coordinator_control->RedirectResponse(response);
   }
 
@@ -1051,7 +1061,7 @@ void DoGetIndexRange(google::protobuf::RpcController * /*controller*/, const pb:
                      std::shared_ptr<CoordinatorControl> coordinator_control, std::shared_ptr<Engine> /*raft_engine*/) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!coordinator_control->IsLeader()) {
+  if (!coordinator_control->IsLeader() && !coordinator_control->CheckFollowerRead().ok()) {
     return coordinator_control->RedirectResponse(response);
   }
 
@@ -2244,7 +2254,7 @@ void MetaServiceImpl::GetTable(google::protobuf::RpcController *controller, cons
                                pb::meta::GetTableResponse *response, google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!this->coordinator_control_->IsLeader()) {
+  if (!this->coordinator_control_->IsLeader() && !CoordinatorControl::IsFollowerReadEnabled()) {
     return RedirectResponse(response);
   }
 
@@ -2301,7 +2311,7 @@ void MetaServiceImpl::GetTableRange(google::protobuf::RpcController *controller,
                                     pb::meta::GetTableRangeResponse *response, google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!this->coordinator_control_->IsLeader()) {
+  if (!this->coordinator_control_->IsLeader() && !CoordinatorControl::IsFollowerReadEnabled()) {
     return RedirectResponse(response);
   }
 
@@ -2730,7 +2740,7 @@ void MetaServiceImpl::GetIndex(google::protobuf::RpcController *controller, cons
                                pb::meta::GetIndexResponse *response, google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!this->coordinator_control_->IsLeader()) {
+  if (!this->coordinator_control_->IsLeader() && !CoordinatorControl::IsFollowerReadEnabled()) {
     return RedirectResponse(response);
   }
 
@@ -2758,7 +2768,7 @@ void MetaServiceImpl::GetIndexByName(google::protobuf::RpcController *controller
                                      pb::meta::GetIndexByNameResponse *response, google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!this->coordinator_control_->IsLeader()) {
+  if (!this->coordinator_control_->IsLeader() && !CoordinatorControl::IsFollowerReadEnabled()) {
     return RedirectResponse(response);
   }
 
@@ -2787,7 +2797,7 @@ void MetaServiceImpl::GetIndexRange(google::protobuf::RpcController *controller,
                                     pb::meta::GetIndexRangeResponse *response, google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!this->coordinator_control_->IsLeader()) {
+  if (!this->coordinator_control_->IsLeader() && !CoordinatorControl::IsFollowerReadEnabled()) {
     return RedirectResponse(response);
   }
 
@@ -33,6 +33,9 @@
 #include "proto/node.pb.h"
 #include "server/server.h"
 #include "server/service_helper.h"
+#include "store/learner.h"
+#include "store/region_hash.h"
+#include "store/sst_ingest.h"
 #include "vector/vector_index_snapshot_manager.h"
 
 #ifdef LINK_TCMALLOC
@@ -120,6 +123,35 @@ void NodeServiceImpl::GetRaftStatus(google::protobuf::RpcController* /*controlle
   }
 }
 
+// Only leader with valid lease answer, no newer leader can commit log, so the committed index is the read index.
+void NodeServiceImpl::ReadIndex(google::protobuf::RpcController* /*controller*/,
+                                const pb::node::ReadIndexRequest* request, pb::node::ReadIndexResponse* response,
+                                google::protobuf::Closure* done) {
+  auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
+  brpc::ClosureGuard const done_guard(svr_done);
+
+  auto engine = Server::GetInstance().GetRaftStoreEngine();
+  if (engine == nullptr) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EENGINE_NOT_FOUND, "Not found raft store engine");
+    return;
+  }
+
+  auto node = engine->GetNode(request->region_id());
+  if (node == nullptr) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::ERAFT_NOT_FOUND,
+                            fmt::format("Not found raft node {}", request->region_id()));
+    return;
+  }
+
+  if (!node->IsLeader() || !node->IsLeaderLeaseValid()) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::ERAFT_NOTLEADER, node->GetLeaderId().to_string());
+    return;
+  }
+
+  node->WakeUp();
+  response->set_read_index(node->GetStatus()->committed_index());
+}
+
 void NodeServiceImpl::GetLogLevel(google::protobuf::RpcController* /*controller*/,
                                   const pb::node::GetLogLevelRequest* request, pb::node::GetLogLevelResponse* response,
                                   google::protobuf::Closure* done) {
@@ -477,6 +509,30 @@ void NodeServiceImpl::GetVectorIndexSnapshot(google::protobuf::RpcController* co
                                  response->ShortDebugString());
 }
 
+void NodeServiceImpl::PrepareIngestSst(google::protobuf::RpcController* /*controller*/,
+                                       const pb::node::PrepareIngestSstRequest* request,
+                                       pb::node::PrepareIngestSstResponse* response, google::protobuf::Closure* done) {
+  auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
+  brpc::ClosureGuard done_guard(svr_done);
+
+  auto store_region_meta = GET_STORE_REGION_META;
+  auto region = store_region_meta->GetRegion(request->region_id());
+  if (region == nullptr) {
+    ServiceHelper::SetError(response->mutable_error(), Errno::EREGION_NOT_FOUND,
+                            fmt::format("Not found region {}.", request->region_id()));
+    return;
+  }
+
+  auto status = SstIngestManager::DownloadFiles(request->region_id(), request->uri(),
+                                                Helper::PbRepeatedToVector(request->filenames()));
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+  }
+
+  DINGO_LOG(INFO) << fmt::format("PrepareIngestSst request: {} response: {}", request->ShortDebugString(),
+                                 response->ShortDebugString());
+}
+
 void NodeServiceImpl::CheckVectorIndex(google::protobuf::RpcController* /*controller*/,
                                        const pb::node::CheckVectorIndexRequest* request,
                                        pb::node::CheckVectorIndexResponse* response, google::protobuf::Closure* done) {
@@ -510,6 +566,55 @@ void NodeServiceImpl::CheckVectorIndex(google::protobuf::RpcController* /*contro
   }
 }
 
+void NodeServiceImpl::GetRegionHash(google::protobuf::RpcController* /*controller*/,
+                                    const pb::node::GetRegionHashRequest* request,
+                                    pb::node::GetRegionHashResponse* response, google::protobuf::Closure* done) {
+  auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
+  brpc::ClosureGuard done_guard(svr_done);
+
+  RegionHashManager::HashCheckpoint checkpoint;
+  if (!RegionHashManager::GetInstance().GetCheckpoint(request->region_id(), checkpoint)) {
+    ServiceHelper::SetError(response->mutable_error(), Errno::EREGION_NOT_FOUND,
+                            fmt::format("Not found hash checkpoint of region {}.", request->region_id()));
+    return;
+  }
+
+  response->set_log_id(checkpoint.log_id);
+  *response->mutable_epoch() = checkpoint.epoch;
+  *response->mutable_range() = checkpoint.range;
+  for (const auto& bucket_key : checkpoint.bucket_keys) {
+    response->add_bucket_keys(bucket_key);
+  }
+  for (auto hash : checkpoint.hashes) {
+    response->add_bucket_hashes(hash);
+  }
+}
+
+void NodeServiceImpl::PullRaftLog(google::protobuf::RpcController* /*controller*/,
+                                  const pb::node::PullRaftLogRequest* request, pb::node::PullRaftLogResponse* response,
+                                  google::protobuf::Closure* done) {
+  auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
+  brpc::ClosureGuard done_guard(svr_done);
+
+  auto status = LearnerManager::PullRaftLog(*request, *response);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+  }
+}
+
+void NodeServiceImpl::GetLearnerSnapshot(google::protobuf::RpcController* /*controller*/,
+                                         const pb::node::GetLearnerSnapshotRequest* request,
+                                         pb::node::GetLearnerSnapshotResponse* response,
+                                         google::protobuf::Closure* done) {
+  auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
+  brpc::ClosureGuard done_guard(svr_done);
+
+  auto status = LearnerManager::GetInstance().GetSnapshot(*request, *response);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+  }
+}
+
 butil::Status ValidateCommitMergeRequest(const pb::node::CommitMergeRequest* request) {
   if (request->source_region_id() == 0) {
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param source_region_id is empty");
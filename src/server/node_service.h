@@ -29,6 +29,9 @@ class NodeServiceImpl : public pb::node::NodeService {
                      pb::node::GetRegionInfoResponse* response, google::protobuf::Closure* done) override;
   void GetRaftStatus(google::protobuf::RpcController* controller, const pb::node::GetRaftStatusRequest* request,
                      pb::node::GetRaftStatusResponse* response, google::protobuf::Closure* done) override;
+
+  void ReadIndex(google::protobuf::RpcController* controller, const pb::node::ReadIndexRequest* request,
+                 pb::node::ReadIndexResponse* response, google::protobuf::Closure* done) override;
   void GetLogLevel(google::protobuf::RpcController* controller, const pb::node::GetLogLevelRequest* request,
                    pb::node::GetLogLevelResponse* response, google::protobuf::Closure* done) override;
   void ChangeLogLevel(google::protobuf::RpcController* controller, const pb::node::ChangeLogLevelRequest* request,
@@ -52,9 +55,21 @@ class NodeServiceImpl : public pb::node::NodeService {
                               pb::node::GetVectorIndexSnapshotResponse* response,
                               google::protobuf::Closure* done) override;
 
+  void PrepareIngestSst(google::protobuf::RpcController* controller, const pb::node::PrepareIngestSstRequest* request,
+                        pb::node::PrepareIngestSstResponse* response, google::protobuf::Closure* done) override;
+
   void CheckVectorIndex(google::protobuf::RpcController* controller, const pb::node::CheckVectorIndexRequest* request,
                         pb::node::CheckVectorIndexResponse* response, google::protobuf::Closure* done) override;
 
+  void GetRegionHash(google::protobuf::RpcController* controller, const pb::node::GetRegionHashRequest* request,
+                     pb::node::GetRegionHashResponse* response, google::protobuf::Closure* done) override;
+
+  void PullRaftLog(google::protobuf::RpcController* controller, const pb::node::PullRaftLogRequest* request,
+                   pb::node::PullRaftLogResponse* response, google::protobuf::Closure* done) override;
+  void GetLearnerSnapshot(google::protobuf::RpcController* controller,
+                          const pb::node::GetLearnerSnapshotRequest* request,
+                          pb::node::GetLearnerSnapshotResponse* response, google::protobuf::Closure* done) override;
+
   void CommitMerge(google::protobuf::RpcController* controller, const pb::node::CommitMergeRequest* request,
                    pb::node::CommitMergeResponse* response, google::protobuf::Closure* done) override;
 
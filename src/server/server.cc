@@ -24,6 +24,7 @@
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/profiler.h"
 #include "common/role.h"
 #include "common/version.h"
 #include "config/config.h"
@@ -32,13 +33,18 @@
 #include "coordinator/coordinator_control.h"
 #include "engine/bdb_raw_engine.h"
 #include "engine/engine.h"
+#include "engine/mem_raw_engine.h"
 #include "engine/raft_store_engine.h"
+#include "engine/region_compactor.h"
 #include "engine/rocks_raw_engine.h"
 #include "fmt/core.h"
 #ifdef ENABLE_XDPROCKS
 #include "engine/xdprocks_raw_engine.h"
 #endif
 #include "engine/txn_engine_helper.h"
+#include "engine/txn_resolved_ts.h"
+#include "engine/txn_scan_cursor.h"
+#include "engine/write_throttler.h"
 #include "gflags/gflags.h"
 #include "glog/logging.h"
 #include "meta/meta_reader.h"
@@ -47,7 +53,9 @@
 #include "proto/node.pb.h"
 #include "scan/scan_manager.h"
 #include "store/heartbeat.h"
+#include "store/learner.h"
 #include "store/region_controller.h"
+#include "store/region_hash.h"
 
 DEFINE_string(coor_url, "",
               "coor service name, e.g. file://<path>, list://<addr1>,<addr2>..., bns://<bns-name>, "
@@ -57,6 +65,14 @@ namespace dingodb {
 
 DECLARE_int64(compaction_retention_rev_count);
 DECLARE_bool(auto_compaction);
+DECLARE_int32(raft_hibernate_check_interval_s);
+DECLARE_int64(txn_resolved_ts_interval_ms);
+DECLARE_int64(continuous_profiling_interval_s);
+DECLARE_int64(write_throttle_update_interval_ms);
+DECLARE_int64(region_meta_flush_interval_ms);
+DECLARE_int64(region_compaction_check_interval_s);
+DECLARE_int64(region_hash_check_interval_s);
+DECLARE_int64(learner_sync_interval_ms);
 
 DEFINE_bool(ip2hostname, false, "resolve ip to hostname for get map api");
 DEFINE_bool(enable_ip2hostname_cache, true, "enable ip2hostname cache");
@@ -224,6 +240,13 @@ bool Server::InitEngine() {
     return false;
   }
 
+  // init memory engine
+  auto raw_memory_engine = std::make_shared<MemRawEngine>();
+  if (!raw_memory_engine->Init(config, Helper::GetColumnFamilyNamesByRole())) {
+    DINGO_LOG(ERROR) << "Init MemRawEngine Failed with Config[" << config->ToString();
+    return false;
+  }
+
   // cooridnator
   if (GetRole() == pb::common::ClusterRole::COORDINATOR) {
     // 1.init CoordinatorController
@@ -241,7 +264,7 @@ bool Server::InitEngine() {
     }
 
     // init raft_meta_engine
-    raft_engine_ = std::make_shared<RaftStoreEngine>(raw_rocks_engine, raw_bdb_engine);
+    raft_engine_ = std::make_shared<RaftStoreEngine>(raw_rocks_engine, raw_bdb_engine, raw_memory_engine);
 
     // set raft_meta_engine to coordinator_control
     coordinator_control_->SetKvEngine(raft_engine_);
@@ -291,7 +314,7 @@ bool Server::InitEngine() {
     tso_control_->SetKvEngine(raft_engine_);
 
   } else {
-    raft_engine_ = std::make_shared<RaftStoreEngine>(raw_rocks_engine, raw_bdb_engine);
+    raft_engine_ = std::make_shared<RaftStoreEngine>(raw_rocks_engine, raw_bdb_engine, raw_memory_engine);
     if (!raft_engine_->Init(config)) {
       DINGO_LOG(ERROR) << "Init RaftStoreEngine failed with Config[" << config->ToString() << "]";
       return false;
@@ -402,6 +425,8 @@ DEFINE_int32(coordinator_update_state_interval_s, 10, "coordinator update state
 DEFINE_int32(coordinator_task_list_interval_s, 1, "coordinator task list interval seconds");
 DEFINE_int32(coordinator_calc_metrics_interval_s, 60, "coordinator calc metrics interval seconds");
 DEFINE_int32(coordinator_recycle_orphan_interval_s, 60, "coordinator recycle orphan interval seconds");
+DEFINE_int32(coordinator_balance_interval_s, 60, "coordinator balance leader and region interval seconds");
+DEFINE_int32(coordinator_merge_interval_s, 60, "coordinator merge small region interval seconds");
 DEFINE_int32(coordinator_meta_watch_clean_interval_s, 60, "coordinator meta watch clean interval seconds");
 DEFINE_int32(coordinator_remove_watch_interval_s, 10, "coordinator remove watch interval seconds");
 DEFINE_int32(coordinator_lease_interval_s, 1, "coordinator lease interval seconds");
@@ -435,6 +460,7 @@ bool Server::InitCrontabManager() {
       FLAGS_server_metrics_collect_interval_s * 1000,
       true,
       [](void*) { Server::GetInstance().GetStoreMetricsManager()->CollectStoreRegionMetrics(); },
+      true,
   });
 
   // Add store metrics crontab
@@ -446,6 +472,7 @@ bool Server::InitCrontabManager() {
       FLAGS_server_store_metrics_collect_interval_s * 1000,
       true,
       [](void*) { Server::GetInstance().GetStoreMetricsManager()->CollectStoreMetrics(); },
+      true,
   });
 
   // Add store approximate size metrics crontab
@@ -458,6 +485,7 @@ bool Server::InitCrontabManager() {
       FLAGS_server_approximate_size_metrics_collect_interval_s * 1000,
       true,
       [](void*) { Server::GetInstance().GetStoreMetricsManager()->CollectApproximateSizeMetrics(); },
+      true,
   });
 
   // Add scan crontab
@@ -488,6 +516,17 @@ bool Server::InitCrontabManager() {
     });
   }
 
+  // Add txn scan cursor crontab
+  if (GetRole() == pb::common::STORE) {
+    crontab_configs_.push_back({
+        "TXN_SCAN_CURSOR",
+        {pb::common::STORE},
+        FLAGS_scanv2_scan_interval_s * 1000,
+        true,
+        [](void*) { TxnScanCursorManager::RegularCleaningHandler(nullptr); },
+    });
+  }
+
   // Add split checker crontab
   if (GetRole() == pb::common::STORE || GetRole() == pb::common::INDEX) {
     FLAGS_region_enable_auto_split = config->GetBool("region.enable_auto_split");
@@ -500,6 +539,7 @@ bool Server::InitCrontabManager() {
           FLAGS_region_split_check_interval_s * 1000,
           true,
           [](void*) { PreSplitChecker::TriggerPreSplitCheck(nullptr); },
+          true,
       });
     }
   }
@@ -559,6 +599,28 @@ bool Server::InitCrontabManager() {
       [](void*) { Heartbeat::TriggerCoordinatorRecycleOrphan(nullptr); },
   });
 
+  // Add balance crontab
+  FLAGS_coordinator_balance_interval_s =
+      GetInterval(config, "coordinator.balance_interval_s", FLAGS_coordinator_balance_interval_s);
+  crontab_configs_.push_back({
+      "BALANCE",
+      {pb::common::COORDINATOR},
+      FLAGS_coordinator_balance_interval_s * 1000,
+      true,
+      [](void*) { Heartbeat::TriggerCoordinatorBalance(nullptr); },
+  });
+
+  // Add merge crontab
+  FLAGS_coordinator_merge_interval_s =
+      GetInterval(config, "coordinator.merge_interval_s", FLAGS_coordinator_merge_interval_s);
+  crontab_configs_.push_back({
+      "MERGE",
+      {pb::common::COORDINATOR},
+      FLAGS_coordinator_merge_interval_s * 1000,
+      true,
+      [](void*) { Heartbeat::TriggerCoordinatorMerge(nullptr); },
+  });
+
   // Add meta_watch_clean orphan crontab
   FLAGS_coordinator_meta_watch_clean_interval_s =
       GetInterval(config, "coordinator.meta_watch_clean_interval_s", FLAGS_coordinator_meta_watch_clean_interval_s);
@@ -625,6 +687,7 @@ bool Server::InitCrontabManager() {
       FLAGS_server_scrub_vector_index_interval_s * 1000,
       true,
       [](void*) { Heartbeat::TriggerScrubVectorIndex(nullptr); },
+      true,
   });
 
   auto raft_store_engine = GetRaftStoreEngine();
@@ -637,6 +700,16 @@ bool Server::InitCrontabManager() {
         FLAGS_raft_snapshot_interval_s * 1000,
         true,
         [](void*) { Server::GetInstance().GetRaftStoreEngine()->DoSnapshotPeriodicity(); },
+        true,
+    });
+
+    // Add raft hibernate crontab
+    crontab_configs_.push_back({
+        "RAFT_HIBERNATE",
+        {pb::common::STORE, pb::common::INDEX},
+        FLAGS_raft_hibernate_check_interval_s * 1000,
+        true,
+        [](void*) { Server::GetInstance().GetRaftStoreEngine()->DoHibernatePeriodicity(); },
     });
   }
 
@@ -659,8 +732,98 @@ bool Server::InitCrontabManager() {
       FLAGS_gc_do_gc_interval_s * 1000,
       true,
       [](void*) { TxnEngineHelper::RegularDoGcHandler(nullptr); },
+      true,
+  });
+
+  // Add txn resolved ts crontab for stale read
+  crontab_configs_.push_back({
+      "TXN_RESOLVED_TS",
+      {pb::common::STORE},
+      FLAGS_txn_resolved_ts_interval_ms,
+      true,
+      [](void*) { TxnResolvedTsManager::RegularUpdateResolvedTsHandler(nullptr); },
+  });
+
+  // Add continuous profiling crontab, it does nothing until enable_continuous_profiling is set.
+  crontab_configs_.push_back({
+      "CONTINUOUS_PROFILING",
+      {pb::common::STORE, pb::common::INDEX, pb::common::COORDINATOR},
+      FLAGS_continuous_profiling_interval_s * 1000,
+      false,
+      [](void*) { Profiler::ContinuousProfilingHandler(nullptr); },
   });
 
+  // Add write throttle crontab, compaction stats are always refreshed for metrics.
+  // Index node only use the write pressure to slow down vector index loading.
+  if (GetRole() == pb::common::STORE || GetRole() == pb::common::INDEX) {
+    crontab_configs_.push_back({
+        "WRITE_THROTTLE",
+        {pb::common::STORE, pb::common::INDEX},
+        FLAGS_write_throttle_update_interval_ms,
+        true,
+        [](void*) { WriteThrottler::UpdateHandler(nullptr); },
+    });
+  }
+
+  // Add region compaction crontab, it does nothing until enable_region_tombstone_compaction is set.
+  if (GetRole() == pb::common::STORE || GetRole() == pb::common::INDEX) {
+    if (!RegionCompactor::GetInstance().Init()) {
+      DINGO_LOG(ERROR) << "Init region compactor failed.";
+      return false;
+    }
+    crontab_configs_.push_back({
+        "REGION_COMPACTION",
+        {pb::common::STORE, pb::common::INDEX},
+        FLAGS_region_compaction_check_interval_s * 1000,
+        true,
+        [](void*) { RegionCompactor::CheckHandler(nullptr); },
+        true,
+    });
+  }
+
+  // Add region hash check crontab, it does nothing until enable_region_hash_check is set.
+  if (GetRole() == pb::common::STORE || GetRole() == pb::common::INDEX) {
+    if (!RegionHashManager::GetInstance().Init()) {
+      DINGO_LOG(ERROR) << "Init region hash manager failed.";
+      return false;
+    }
+    crontab_configs_.push_back({
+        "REGION_HASH_CHECK",
+        {pb::common::STORE, pb::common::INDEX},
+        FLAGS_region_hash_check_interval_s * 1000,
+        true,
+        [](void*) { RegionHashManager::CheckHandler(nullptr); },
+        true,
+    });
+  }
+
+  // Add learner sync crontab, learners pull the log from voters.
+  if (GetRole() == pb::common::STORE) {
+    if (!LearnerManager::GetInstance().Init()) {
+      DINGO_LOG(ERROR) << "Init learner manager failed.";
+      return false;
+    }
+    crontab_configs_.push_back({
+        "LEARNER_SYNC",
+        {pb::common::STORE},
+        FLAGS_learner_sync_interval_ms,
+        true,
+        [](void*) { LearnerManager::SyncHandler(nullptr); },
+        false,
+    });
+  }
+
+  // Add flush region meta crontab, it does nothing until enable_region_meta_write_behind is set.
+  if (GetRole() == pb::common::STORE || GetRole() == pb::common::INDEX) {
+    crontab_configs_.push_back({
+        "FLUSH_REGION_META",
+        {pb::common::STORE, pb::common::INDEX},
+        FLAGS_region_meta_flush_interval_ms,
+        true,
+        [](void*) { Server::GetInstance().GetStoreMetaManager()->GetStoreRegionMeta()->FlushRegions(); },
+    });
+  }
+
   crontab_manager_->AddCrontab(crontab_configs_);
 
   return true;
@@ -753,11 +916,22 @@ void Server::Destroy() {
   if (store_controller_) {
     store_controller_->Destroy();
   }
+  if (GetRole() == pb::common::STORE || GetRole() == pb::common::INDEX) {
+    RegionCompactor::GetInstance().Destroy();
+    RegionHashManager::GetInstance().Destroy();
+  }
+  if (GetRole() == pb::common::STORE) {
+    LearnerManager::GetInstance().Destroy();
+  }
 
   if (GetRole() == pb::common::INDEX && vector_index_manager_) {
     vector_index_manager_->Destroy();
   }
 
+  if ((GetRole() == pb::common::STORE || GetRole() == pb::common::INDEX) && store_meta_manager_) {
+    store_meta_manager_->GetStoreRegionMeta()->FlushRegions();
+  }
+
   google::ShutdownGoogleLogging();
 }
 
@@ -983,6 +1157,54 @@ void Server::SetRaftApplyWorkerSet(PriorWorkerSetPtr worker_set) { raft_apply_wo
 
 PriorWorkerSetPtr Server::GetRaftApplyWorkerSet() { return raft_apply_worker_set_; }
 
+bool Server::ResizeReadWorkerSet(uint32_t worker_num) {
+  if (store_service_read_worker_set_ == nullptr && index_service_read_worker_set_ == nullptr) {
+    return false;
+  }
+
+  bool ret = true;
+  if (store_service_read_worker_set_ != nullptr) {
+    ret = store_service_read_worker_set_->Resize(worker_num) && ret;
+  }
+  if (index_service_read_worker_set_ != nullptr) {
+    ret = index_service_read_worker_set_->Resize(worker_num) && ret;
+  }
+
+  return ret;
+}
+
+bool Server::ResizeWriteWorkerSet(uint32_t worker_num) {
+  if (store_service_write_worker_set_ == nullptr && index_service_write_worker_set_ == nullptr) {
+    return false;
+  }
+
+  bool ret = true;
+  if (store_service_write_worker_set_ != nullptr) {
+    ret = store_service_write_worker_set_->Resize(worker_num) && ret;
+  }
+  if (index_service_write_worker_set_ != nullptr) {
+    ret = index_service_write_worker_set_->Resize(worker_num) && ret;
+  }
+
+  return ret;
+}
+
+bool Server::ResizeRaftApplyWorkerSet(uint32_t worker_num) {
+  if (raft_apply_worker_set_ == nullptr) {
+    return false;
+  }
+
+  return raft_apply_worker_set_->Resize(worker_num);
+}
+
+bool Server::ResizeVectorIndexBackgroundWorkerSet(uint32_t worker_num) {
+  if (vector_index_manager_ == nullptr) {
+    return false;
+  }
+
+  return vector_index_manager_->ResizeBackgroundWorkers(worker_num);
+}
+
 std::vector<std::vector<std::string>> Server::GetStoreServiceReadWorkerSetTrace() {
   if (store_service_read_worker_set_ == nullptr) {
     return {};
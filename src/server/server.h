@@ -184,6 +184,12 @@ class Server {
   void SetRaftApplyWorkerSet(PriorWorkerSetPtr worker_set);
   PriorWorkerSetPtr GetRaftApplyWorkerSet();
 
+  // Resize the worker sets of store or index service at runtime, false if the worker set not exist.
+  bool ResizeReadWorkerSet(uint32_t worker_num);
+  bool ResizeWriteWorkerSet(uint32_t worker_num);
+  bool ResizeRaftApplyWorkerSet(uint32_t worker_num);
+  bool ResizeVectorIndexBackgroundWorkerSet(uint32_t worker_num);
+
   std::vector<std::vector<std::string>> GetStoreServiceReadWorkerSetTrace();
   std::vector<std::vector<std::string>> GetStoreServiceWriteWorkerSetTrace();
   std::vector<std::vector<std::string>> GetIndexServiceReadWorkerSetTrace();
@@ -233,7 +239,7 @@ class Server {
   std::shared_ptr<CoordinatorInteraction> coordinator_interaction_;
   std::shared_ptr<CoordinatorInteraction> coordinator_interaction_incr_;
 
-  // All store engine, include MemEngine/RaftStoreEngine/RocksEngine
+  // All store engine, include RaftStoreEngine/RocksEngine
   std::shared_ptr<Engine> raft_engine_;
 
   // Meta reader
@@ -32,6 +32,8 @@ namespace dingodb {
 DEFINE_int64(service_helper_store_min_log_elapse, 100L * 1000L * 1000L, "min log elapse time");
 DEFINE_int64(service_helper_coordinator_min_log_elapse, 100L * 1000L * 1000L, "min log elapse time");
 
+DEFINE_bool(enable_response_time_info, true, "attach tracker stage time to response_info of response");
+
 void ServiceHelper::SetError(pb::error::Error* error, int errcode, const std::string& errmsg) {
   error->set_errcode(static_cast<pb::error::Errno>(errcode));
   error->set_errmsg(errmsg);
@@ -19,11 +19,16 @@
 #include <string>
 #include <string_view>
 
+#include "brpc/closure_guard.h"
+#include "brpc/controller.h"
 #include "butil/compiler_specific.h"
 #include "butil/endpoint.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/runnable.h"
+#include "common/slow_log.h"
+#include "common/tenant_quota.h"
 #include "common/tracker.h"
 #include "fmt/core.h"
 #include "meta/store_meta_manager.h"
@@ -34,6 +39,9 @@ namespace dingodb {
 
 DECLARE_int64(service_helper_store_min_log_elapse);
 DECLARE_int64(service_helper_coordinator_min_log_elapse);
+DECLARE_bool(enable_response_time_info);
+
+class ServiceTask;
 
 class ServiceHelper {
  public:
@@ -55,6 +63,17 @@ class ServiceHelper {
   static butil::Status ValidateRegion(store::RegionPtr region, const std::vector<std::string_view>& keys);
   static butil::Status ValidateIndexRegion(store::RegionPtr region, const std::vector<int64_t>& vector_ids);
   static butil::Status ValidateClusterReadOnly();
+
+  // Put the task into lane, the deadline is taken from the rpc timeout.
+  // When the deadline passed while queued, the task is dropped and respond timeout error.
+  template <typename T, typename C>
+  static void SetTaskLane(std::shared_ptr<ServiceTask> task, TaskLane lane, google::protobuf::RpcController* controller,
+                          T* response, C* done);
+
+  // Admit request by the quota of the region tenant, output the priority of tenant.
+  // When exceeding quota, respond ETENANT_QUOTA_EXCEEDED and return false.
+  template <typename T, typename U, typename C>
+  static bool AdmitTenantRequest(const T* request, U* response, C* done, int32_t& priority);
 };
 
 template <typename T>
@@ -105,8 +124,17 @@ class ServiceTask : public TaskRunnable {
 
   void Run() override { handle_(); }
 
+  void Expire() override {
+    if (expire_handle_ != nullptr) {
+      expire_handle_();
+    }
+  }
+
+  void SetExpireHandler(Handler expire_handle) { expire_handle_ = expire_handle; }
+
  private:
   Handler handle_;
+  Handler expire_handle_;
 };
 
 class TrackClosure : public google::protobuf::Closure {
@@ -120,6 +148,48 @@ class TrackClosure : public google::protobuf::Closure {
   TrackerPtr tracker;
 };
 
+template <typename T, typename C>
+void ServiceHelper::SetTaskLane(std::shared_ptr<ServiceTask> task, TaskLane lane,
+                                google::protobuf::RpcController* controller, T* response, C* done) {
+  task->SetLane(lane);
+
+  auto* cntl = static_cast<brpc::Controller*>(controller);
+  if (cntl == nullptr || cntl->deadline_us() <= 0) {
+    return;
+  }
+
+  task->SetDeadlineUs(cntl->deadline_us());
+  task->SetExpireHandler([response, done]() {
+    brpc::ClosureGuard done_guard(done);
+    done->Tracker()->SetServiceQueueWaitTime();
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_TIMEOUT,
+                            "Request deadline exceeded while waiting in queue");
+  });
+}
+
+template <typename T, typename U, typename C>
+bool ServiceHelper::AdmitTenantRequest(const T* request, U* response, C* done, int32_t& priority) {
+  priority = 0;
+  if (!TenantQuota::IsEnabled()) {
+    return true;
+  }
+
+  auto region = Server::GetInstance().GetRegion(request->context().region_id());
+  if (region == nullptr) {
+    // validate region later.
+    return true;
+  }
+
+  auto status = TenantQuota::GetInstance().Acquire(region->TenantId(), request->ByteSizeLong(), priority);
+  if (!status.ok()) {
+    brpc::ClosureGuard done_guard(done);
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    return false;
+  }
+
+  return true;
+}
+
 // Wrapper brpc service closure for log.
 template <typename T, typename U>
 class ServiceClosure : public TrackClosure {
@@ -146,7 +216,7 @@ class ServiceClosure : public TrackClosure {
 };
 
 inline void SetPbMessageResponseInfo(google::protobuf::Message* message, TrackerPtr tracker) {
-  if (BAIDU_UNLIKELY(message == nullptr || tracker == nullptr)) {
+  if (BAIDU_UNLIKELY(message == nullptr || tracker == nullptr || !FLAGS_enable_response_time_info)) {
     return;
   }
   const google::protobuf::Reflection* reflection = message->GetReflection();
@@ -165,13 +235,7 @@ inline void SetPbMessageResponseInfo(google::protobuf::Message* message, Tracker
   }
   pb::common::ResponseInfo* response_info =
       dynamic_cast<pb::common::ResponseInfo*>(reflection->MutableMessage(message, response_info_field));
-  auto* time_info = response_info->mutable_time_info();
-  time_info->set_total_rpc_time_ns(tracker->TotalRpcTime());
-  time_info->set_service_queue_wait_time_ns(tracker->ServiceQueueWaitTime());
-  time_info->set_prepair_commit_time_ns(tracker->PrepairCommitTime());
-  time_info->set_raft_commit_time_ns(tracker->RaftCommitTime());
-  time_info->set_raft_queue_wait_time_ns(tracker->RaftQueueWaitTime());
-  time_info->set_raft_apply_time_ns(tracker->RaftApplyTime());
+  tracker->FillTimeInfo(response_info->mutable_time_info());
 }
 
 template <typename T, typename U>
@@ -182,6 +246,9 @@ void ServiceClosure<T, U>::Run() {
   tracker->SetTotalRpcTime();
   uint64_t elapsed_time = tracker->TotalRpcTime();
   SetPbMessageResponseInfo(response_, tracker);
+  TrackerMetrics::GetInstance().Record(method_name_, tracker);
+  tracker->FinishSpan(method_name_, response_->error().errcode());
+  SlowLog::GetInstance().Record(method_name_, elapsed_time, *request_, response_->error().errcode(), tracker);
 
   if (response_->error().errcode() != 0) {
     // Set leader redirect info(pb.Error.leader_location).
@@ -226,6 +293,9 @@ inline void ServiceClosure<pb::index::VectorCalcDistanceRequest, pb::index::Vect
   tracker->SetTotalRpcTime();
   uint64_t elapsed_time = tracker->TotalRpcTime();
   SetPbMessageResponseInfo(response_, tracker);
+  TrackerMetrics::GetInstance().Record(method_name_, tracker);
+  tracker->FinishSpan(method_name_, response_->error().errcode());
+  SlowLog::GetInstance().Record(method_name_, elapsed_time, *request_, response_->error().errcode(), tracker);
 
   if (response_->error().errcode() != 0) {
     DINGO_LOG(ERROR) << fmt::format(
@@ -284,6 +354,8 @@ void CoordinatorServiceClosure<T, U>::Run() {
   tracker->SetTotalRpcTime();
   uint64_t elapsed_time = tracker->TotalRpcTime();
   SetPbMessageResponseInfo(response_, tracker);
+  TrackerMetrics::GetInstance().Record(method_name_, tracker);
+  tracker->FinishSpan(method_name_, response_->error().errcode());
 
   if (response_->error().errcode() != 0) {
     // Set leader redirect info(pb.Error.leader_location).
@@ -348,6 +420,8 @@ void NoContextServiceClosure<T, U>::Run() {
   tracker->SetTotalRpcTime();
   uint64_t elapsed_time = tracker->TotalRpcTime();
   SetPbMessageResponseInfo(response_, tracker);
+  TrackerMetrics::GetInstance().Record(method_name_, tracker);
+  tracker->FinishSpan(method_name_, response_->error().errcode());
 
   if (response_->error().errcode() != 0) {
     // Set leader redirect info(pb.Error.leader_location).
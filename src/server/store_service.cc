@@ -14,13 +14,18 @@
 
 #include "server/store_service.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <iterator>
+#include <map>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "butil/compiler_specific.h"
+#include "butil/fast_rand.h"
 #include "butil/status.h"
 #include "butil/time.h"
 #include "common/constant.h"
@@ -29,14 +34,23 @@
 #include "common/synchronization.h"
 #include "common/tracker.h"
 #include "common/version.h"
+#include "engine/raw_kv_ttl.h"
+#include "engine/txn_lock_wait.h"
+#include "engine/write_throttler.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/store.pb.h"
+#include "scan/scan_stream.h"
 #include "server/server.h"
 #include "server/service_helper.h"
+#include "split/load_split.h"
+#include "store/backup.h"
+#include "store/cdc.h"
+#include "store/region_export.h"
+#include "store/sst_ingest.h"
 
 DEFINE_int32(raft_apply_worker_max_pending_num, 0, "raft apply worker num");
 
@@ -44,14 +58,26 @@ namespace dingodb {
 
 DEFINE_bool(enable_async_store_kvscan, true, "enable async store kvscan");
 DEFINE_bool(enable_async_store_operation, true, "enable async store operation");
+DECLARE_bool(enable_raft_apply_conditional_write);
 DECLARE_int64(max_scan_lock_limit);
 DECLARE_int64(max_prewrite_count);
+DECLARE_bool(enable_txn_lock_wait);
+DECLARE_int64(txn_lock_wait_timeout_ms);
+DECLARE_bool(enable_txn_scan_cursor);
 
 bvar::LatencyRecorder g_raw_latches_recorder("dingo_latches_raw");
 bvar::LatencyRecorder g_txn_latches_recorder("dingo_latches_txn");
 
 static void StoreRpcDone(BthreadCond* cond) { cond->DecreaseSignal(); }
 
+static int64_t KvsBytes(const std::vector<pb::common::KeyValue>& kvs) {
+  int64_t bytes = 0;
+  for (const auto& kv : kvs) {
+    bytes += kv.key().size() + kv.value().size();
+  }
+  return bytes;
+}
+
 StoreServiceImpl::StoreServiceImpl() = default;
 
 bool StoreServiceImpl::IsRaftApplyPendingExceed() {
@@ -108,11 +134,14 @@ void DoKvGet(StoragePtr storage, google::protobuf::RpcController* controller,
     return;
   }
 
+  RegionLoadStatistics::GetInstance().RecordRead(region_id, request->key());
+
   std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
   ctx->SetRegionEpoch(request->context().region_epoch());
+  ctx->SetReadMode(request->context().read_mode());
   ctx->SetRawEngineType(region->GetRawEngineType());
 
   std::vector<std::string> keys;
@@ -128,6 +157,7 @@ void DoKvGet(StoragePtr storage, google::protobuf::RpcController* controller,
 
   if (!kvs.empty()) {
     response->set_value(kvs[0].value());
+    RegionLoadStatistics::GetInstance().RecordReadBytes(region_id, kvs[0].key().size() + kvs[0].value().size());
   }
 }
 
@@ -136,6 +166,11 @@ void StoreServiceImpl::KvGet(google::protobuf::RpcController* controller,
                              dingodb::pb::store::KvGetResponse* response, google::protobuf::Closure* done) {
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
 
+  int32_t tenant_priority = 0;
+  if (!ServiceHelper::AdmitTenantRequest(request, response, svr_done, tenant_priority)) {
+    return;
+  }
+
   if (!FLAGS_enable_async_store_operation) {
     return DoKvGet(storage_, controller, request, response, svr_done);
   }
@@ -143,6 +178,8 @@ void StoreServiceImpl::KvGet(google::protobuf::RpcController* controller,
   // Run in queue.
   StoragePtr storage = storage_;
   auto task = std::make_shared<ServiceTask>([=]() { DoKvGet(storage, controller, request, response, svr_done); });
+  task->SetPriority(tenant_priority);
+  ServiceHelper::SetTaskLane(task, TaskLane::kPointRead, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -199,11 +236,17 @@ void DoKvBatchGet(StoragePtr storage, google::protobuf::RpcController* controlle
     return;
   }
 
+  if (request->keys_size() > 0) {
+    RegionLoadStatistics::GetInstance().RecordRead(
+        region_id, request->keys(butil::fast_rand_less_than(request->keys_size())), request->keys_size());
+  }
+
   auto ctx = std::make_shared<Context>(cntl, done);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
   ctx->SetRegionEpoch(request->context().region_epoch());
+  ctx->SetReadMode(request->context().read_mode());
   ctx->SetRawEngineType(region->GetRawEngineType());
 
   std::vector<pb::common::KeyValue> kvs;
@@ -214,7 +257,8 @@ void DoKvBatchGet(StoragePtr storage, google::protobuf::RpcController* controlle
     return;
   }
 
-  Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+  RegionLoadStatistics::GetInstance().RecordReadBytes(region_id, KvsBytes(kvs));
+  Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
 }
 
 void StoreServiceImpl::KvBatchGet(google::protobuf::RpcController* controller,
@@ -222,6 +266,11 @@ void StoreServiceImpl::KvBatchGet(google::protobuf::RpcController* controller,
                                   google::protobuf::Closure* done) {
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
 
+  int32_t tenant_priority = 0;
+  if (!ServiceHelper::AdmitTenantRequest(request, response, svr_done, tenant_priority)) {
+    return;
+  }
+
   if (request->keys().empty()) {
     return;
   }
@@ -233,6 +282,8 @@ void StoreServiceImpl::KvBatchGet(google::protobuf::RpcController* controller,
   // Run in queue.
   StoragePtr storage = storage_;
   auto task = std::make_shared<ServiceTask>([=]() { DoKvBatchGet(storage, controller, request, response, svr_done); });
+  task->SetPriority(tenant_priority);
+  ServiceHelper::SetTaskLane(task, TaskLane::kPointRead, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -263,6 +314,24 @@ static butil::Status ValidateKvPutRequest(const dingodb::pb::store::KvPutRequest
     return status;
   }
 
+  status = WriteThrottler::GetInstance().Throttle();
+  if (!status.ok()) {
+    return status;
+  }
+
+  return butil::Status();
+}
+
+// Prepend the ttl header to the value of client raw kv, the expire time is fixed by leader before raft.
+static butil::Status EncodeRawKvTtl(int64_t ttl_ms, pb::common::KeyValue& kv) {
+  if (!RawKvTtl::IsEnabled(Constant::kStoreDataCF, kv.key())) {
+    if (ttl_ms > 0) {
+      return butil::Status(pb::error::ENOT_SUPPORT, "Not enable raw kv ttl");
+    }
+    return butil::Status();
+  }
+
+  RawKvTtl::EncodeValue(ttl_ms, *kv.mutable_value());
   return butil::Status();
 }
 
@@ -289,6 +358,16 @@ void DoKvPut(StoragePtr storage, google::protobuf::RpcController* controller,
     return;
   }
 
+  auto* mut_request = const_cast<dingodb::pb::store::KvPutRequest*>(request);
+  status = EncodeRawKvTtl(request->ttl(), *mut_request->mutable_kv());
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    return;
+  }
+
+  RegionLoadStatistics::GetInstance().RecordWrite(region_id, request->kv().key(), 1,
+                                                  request->kv().key().size() + request->kv().value().size());
+
   // check latches
   auto start_time_us = butil::gettimeofday_us();
   std::vector<std::string> keys_for_lock;
@@ -318,9 +397,8 @@ void DoKvPut(StoragePtr storage, google::protobuf::RpcController* controller,
   ctx->SetRawEngineType(region->GetRawEngineType());
 
   std::vector<pb::common::KeyValue> kvs;
-  auto* mut_request = const_cast<dingodb::pb::store::KvPutRequest*>(request);
   kvs.emplace_back(std::move(*mut_request->release_kv()));
-  status = storage->KvPut(ctx, kvs);
+  status = storage->KvPut(ctx, std::move(kvs));
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
 
@@ -333,6 +411,11 @@ void StoreServiceImpl::KvPut(google::protobuf::RpcController* controller,
                              dingodb::pb::store::KvPutResponse* response, google::protobuf::Closure* done) {
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
 
+  int32_t tenant_priority = 0;
+  if (!ServiceHelper::AdmitTenantRequest(request, response, svr_done, tenant_priority)) {
+    return;
+  }
+
   if (IsRaftApplyPendingExceed()) {
     brpc::ClosureGuard done_guard(svr_done);
     ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
@@ -343,6 +426,7 @@ void StoreServiceImpl::KvPut(google::protobuf::RpcController* controller,
   // Run in queue.
   StoragePtr storage = storage_;
   auto task = std::make_shared<ServiceTask>([=]() { DoKvPut(storage, controller, request, response, svr_done, true); });
+  task->SetPriority(tenant_priority);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -378,6 +462,11 @@ static butil::Status ValidateKvBatchPutRequest(const dingodb::pb::store::KvBatch
     return status;
   }
 
+  status = WriteThrottler::GetInstance().Throttle();
+  if (!status.ok()) {
+    return status;
+  }
+
   return butil::Status();
 }
 
@@ -404,6 +493,21 @@ void DoKvBatchPut(StoragePtr storage, google::protobuf::RpcController* controlle
     return;
   }
 
+  auto* mut_request = const_cast<dingodb::pb::store::KvBatchPutRequest*>(request);
+  for (auto& kv : *mut_request->mutable_kvs()) {
+    status = EncodeRawKvTtl(request->ttl(), kv);
+    if (!status.ok()) {
+      ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+      return;
+    }
+  }
+
+  if (request->kvs_size() > 0) {
+    const auto& kv = request->kvs(butil::fast_rand_less_than(request->kvs_size()));
+    RegionLoadStatistics::GetInstance().RecordWrite(region_id, kv.key(), request->kvs_size(),
+                                                    (kv.key().size() + kv.value().size()) * request->kvs_size());
+  }
+
   // check latches
   auto start_time_us = butil::gettimeofday_us();
   std::vector<std::string> keys_for_lock;
@@ -434,7 +538,6 @@ void DoKvBatchPut(StoragePtr storage, google::protobuf::RpcController* controlle
   ctx->SetRegionEpoch(request->context().region_epoch());
   ctx->SetRawEngineType(region->GetRawEngineType());
 
-  auto* mut_request = const_cast<dingodb::pb::store::KvBatchPutRequest*>(request);
   status = storage->KvPut(ctx, Helper::PbRepeatedToVector(mut_request->mutable_kvs()));
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
@@ -448,6 +551,11 @@ void StoreServiceImpl::KvBatchPut(google::protobuf::RpcController* controller,
                                   google::protobuf::Closure* done) {
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
 
+  int32_t tenant_priority = 0;
+  if (!ServiceHelper::AdmitTenantRequest(request, response, svr_done, tenant_priority)) {
+    return;
+  }
+
   if (IsRaftApplyPendingExceed()) {
     brpc::ClosureGuard done_guard(svr_done);
     ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
@@ -463,6 +571,7 @@ void StoreServiceImpl::KvBatchPut(google::protobuf::RpcController* controller,
   StoragePtr storage = storage_;
   auto task =
       std::make_shared<ServiceTask>([=]() { DoKvBatchPut(storage, controller, request, response, svr_done, true); });
+  task->SetPriority(tenant_priority);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -494,6 +603,11 @@ static butil::Status ValidateKvPutIfAbsentRequest(const dingodb::pb::store::KvPu
     return status;
   }
 
+  status = WriteThrottler::GetInstance().Throttle();
+  if (!status.ok()) {
+    return status;
+  }
+
   return butil::Status();
 }
 
@@ -520,6 +634,16 @@ void DoKvPutIfAbsent(StoragePtr storage, google::protobuf::RpcController* contro
     return;
   }
 
+  auto* mut_request = const_cast<dingodb::pb::store::KvPutIfAbsentRequest*>(request);
+  status = EncodeRawKvTtl(0, *mut_request->mutable_kv());
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    return;
+  }
+
+  RegionLoadStatistics::GetInstance().RecordWrite(region_id, request->kv().key(), 1,
+                                                  request->kv().key().size() + request->kv().value().size());
+
   // check latches
   auto start_time_us = butil::gettimeofday_us();
   std::vector<std::string> keys_for_lock;
@@ -528,7 +652,9 @@ void DoKvPutIfAbsent(StoragePtr storage, google::protobuf::RpcController* contro
   BthreadCond sync_cond;
   uint64_t cid = (uint64_t)(&sync_cond);
 
-  bool latch_got = false;
+  // the condition is evaluated at raft apply in log order, not need latches.
+  bool need_latch = !FLAGS_enable_raft_apply_conditional_write;
+  bool latch_got = !need_latch;
   while (!latch_got) {
     latch_got = region->LatchesAcquire(&lock, cid);
     if (!latch_got) {
@@ -539,7 +665,7 @@ void DoKvPutIfAbsent(StoragePtr storage, google::protobuf::RpcController* contro
   g_raw_latches_recorder << butil::gettimeofday_us() - start_time_us;
 
   // release latches after done
-  DEFER(region->LatchesRelease(&lock, cid));
+  DEFER(if (need_latch) region->LatchesRelease(&lock, cid));
 
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
@@ -549,7 +675,6 @@ void DoKvPutIfAbsent(StoragePtr storage, google::protobuf::RpcController* contro
   ctx->SetRawEngineType(region->GetRawEngineType());
 
   std::vector<bool> key_states;
-  auto* mut_request = const_cast<dingodb::pb::store::KvPutIfAbsentRequest*>(request);
   std::vector<pb::common::KeyValue> kvs;
   kvs.emplace_back(std::move(*mut_request->release_kv()));
   status = storage->KvPutIfAbsent(ctx, kvs, true, key_states);
@@ -615,6 +740,11 @@ static butil::Status ValidateKvBatchPutIfAbsentRequest(const dingodb::pb::store:
     return status;
   }
 
+  status = WriteThrottler::GetInstance().Throttle();
+  if (!status.ok()) {
+    return status;
+  }
+
   return butil::Status();
 }
 
@@ -641,6 +771,21 @@ void DoKvBatchPutIfAbsent(StoragePtr storage, google::protobuf::RpcController* c
     return;
   }
 
+  auto* mut_request = const_cast<dingodb::pb::store::KvBatchPutIfAbsentRequest*>(request);
+  for (auto& kv : *mut_request->mutable_kvs()) {
+    status = EncodeRawKvTtl(0, kv);
+    if (!status.ok()) {
+      ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+      return;
+    }
+  }
+
+  if (request->kvs_size() > 0) {
+    const auto& kv = request->kvs(butil::fast_rand_less_than(request->kvs_size()));
+    RegionLoadStatistics::GetInstance().RecordWrite(region_id, kv.key(), request->kvs_size(),
+                                                    (kv.key().size() + kv.value().size()) * request->kvs_size());
+  }
+
   // check latches
   auto start_time_us = butil::gettimeofday_us();
   std::vector<std::string> keys_for_lock;
@@ -651,7 +796,9 @@ void DoKvBatchPutIfAbsent(StoragePtr storage, google::protobuf::RpcController* c
   BthreadCond sync_cond;
   uint64_t cid = (uint64_t)(&sync_cond);
 
-  bool latch_got = false;
+  // the condition is evaluated at raft apply in log order, not need latches.
+  bool need_latch = !FLAGS_enable_raft_apply_conditional_write;
+  bool latch_got = !need_latch;
   while (!latch_got) {
     latch_got = region->LatchesAcquire(&lock, cid);
     if (!latch_got) {
@@ -662,7 +809,7 @@ void DoKvBatchPutIfAbsent(StoragePtr storage, google::protobuf::RpcController* c
   g_raw_latches_recorder << butil::gettimeofday_us() - start_time_us;
 
   // release latches after done
-  DEFER(region->LatchesRelease(&lock, cid));
+  DEFER(if (need_latch) region->LatchesRelease(&lock, cid));
 
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
@@ -672,7 +819,6 @@ void DoKvBatchPutIfAbsent(StoragePtr storage, google::protobuf::RpcController* c
   ctx->SetRawEngineType(region->GetRawEngineType());
 
   std::vector<bool> key_states;
-  auto* mut_request = const_cast<dingodb::pb::store::KvBatchPutIfAbsentRequest*>(request);
   status = storage->KvPutIfAbsent(ctx, Helper::PbRepeatedToVector(mut_request->mutable_kvs()), request->is_atomic(),
                                   key_states);
   if (!status.ok()) {
@@ -965,6 +1111,13 @@ void DoKvCompareAndSet(StoragePtr storage, google::protobuf::RpcController* cont
     return;
   }
 
+  auto* mut_request = const_cast<dingodb::pb::store::KvCompareAndSetRequest*>(request);
+  status = EncodeRawKvTtl(0, *mut_request->mutable_kv());
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    return;
+  }
+
   // check latches
   auto start_time_us = butil::gettimeofday_us();
   std::vector<std::string> keys_for_lock;
@@ -973,7 +1126,9 @@ void DoKvCompareAndSet(StoragePtr storage, google::protobuf::RpcController* cont
   BthreadCond sync_cond;
   uint64_t cid = (uint64_t)(&sync_cond);
 
-  bool latch_got = false;
+  // the condition is evaluated at raft apply in log order, not need latches.
+  bool need_latch = !FLAGS_enable_raft_apply_conditional_write;
+  bool latch_got = !need_latch;
   while (!latch_got) {
     latch_got = region->LatchesAcquire(&lock, cid);
     if (!latch_got) {
@@ -984,7 +1139,7 @@ void DoKvCompareAndSet(StoragePtr storage, google::protobuf::RpcController* cont
   g_raw_latches_recorder << butil::gettimeofday_us() - start_time_us;
 
   // release latches after done
-  DEFER(region->LatchesRelease(&lock, cid));
+  DEFER(if (need_latch) region->LatchesRelease(&lock, cid));
 
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
@@ -1048,22 +1203,414 @@ static butil::Status ValidateKvBatchCompareAndSetRequest(const dingodb::pb::stor
     return butil::Status(pb::error::EKEY_EMPTY, "expect_values size !=  kvs size");
   }
 
-  std::vector<std::string_view> keys;
-  for (const auto& kv : request->kvs()) {
-    keys.push_back(kv.key());
-  }
-  status = ServiceHelper::ValidateRegion(region, keys);
+  std::vector<std::string_view> keys;
+  for (const auto& kv : request->kvs()) {
+    keys.push_back(kv.key());
+  }
+  status = ServiceHelper::ValidateRegion(region, keys);
+  if (!status.ok()) {
+    return status;
+  }
+
+  return butil::Status();
+}
+
+void DoKvBatchCompareAndSet(StoragePtr storage, google::protobuf::RpcController* controller,
+                            const dingodb::pb::store::KvBatchCompareAndSetRequest* request,
+                            dingodb::pb::store::KvBatchCompareAndSetResponse* response, TrackClosure* done,
+                            bool is_sync) {
+  brpc::Controller* cntl = (brpc::Controller*)controller;
+  brpc::ClosureGuard done_guard(done);
+  auto tracker = done->Tracker();
+  tracker->SetServiceQueueWaitTime();
+
+  int64_t region_id = request->context().region_id();
+  auto region = Server::GetInstance().GetRegion(region_id);
+  if (region == nullptr) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREGION_NOT_FOUND,
+                            fmt::format("Not found region {} at server {}", region_id, Server::GetInstance().Id()));
+    return;
+  }
+
+  auto status = ValidateKvBatchCompareAndSetRequest(request, region);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    ServiceHelper::GetStoreRegionInfo(region, response->mutable_error());
+    return;
+  }
+
+  auto* mut_request = const_cast<dingodb::pb::store::KvBatchCompareAndSetRequest*>(request);
+  for (auto& kv : *mut_request->mutable_kvs()) {
+    status = EncodeRawKvTtl(0, kv);
+    if (!status.ok()) {
+      ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+      return;
+    }
+  }
+
+  // check latches
+  auto start_time_us = butil::gettimeofday_us();
+  std::vector<std::string> keys_for_lock;
+  for (const auto& kv : request->kvs()) {
+    keys_for_lock.push_back(kv.key());
+  }
+  Lock lock(keys_for_lock);
+  BthreadCond sync_cond;
+  uint64_t cid = (uint64_t)(&sync_cond);
+
+  // the condition is evaluated at raft apply in log order, not need latches.
+  bool need_latch = !FLAGS_enable_raft_apply_conditional_write;
+  bool latch_got = !need_latch;
+  while (!latch_got) {
+    latch_got = region->LatchesAcquire(&lock, cid);
+    if (!latch_got) {
+      sync_cond.IncreaseWait();
+    }
+  }
+
+  g_raw_latches_recorder << butil::gettimeofday_us() - start_time_us;
+
+  // release latches after done
+  DEFER(if (need_latch) region->LatchesRelease(&lock, cid));
+
+  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  ctx->SetRegionId(region_id);
+  ctx->SetTracker(tracker);
+  ctx->SetCfName(Constant::kStoreDataCF);
+  ctx->SetRegionEpoch(request->context().region_epoch());
+  ctx->SetRawEngineType(region->GetRawEngineType());
+
+  std::vector<bool> key_states;
+  status = storage->KvCompareAndSet(ctx, Helper::PbRepeatedToVector(mut_request->kvs()),
+                                    Helper::PbRepeatedToVector(mut_request->expect_values()), request->is_atomic(),
+                                    key_states);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+
+    if (!is_sync) done->Run();
+  }
+
+  for (const auto& key_state : key_states) {
+    response->add_key_states(key_state);
+  }
+}
+
+void StoreServiceImpl::KvBatchCompareAndSet(google::protobuf::RpcController* controller,
+                                            const pb::store::KvBatchCompareAndSetRequest* request,
+                                            pb::store::KvBatchCompareAndSetResponse* response,
+                                            google::protobuf::Closure* done) {
+  auto* svr_done = new ServiceClosure(__func__, done, request, response);
+
+  if (IsRaftApplyPendingExceed()) {
+    brpc::ClosureGuard done_guard(svr_done);
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
+                            "Raft apply queue is full, please wait and retry");
+    return;
+  }
+
+  if (request->kvs().empty()) {
+    return;
+  }
+
+  // Run in queue.
+  StoragePtr storage = storage_;
+  auto task = std::make_shared<ServiceTask>(
+      [=]() { DoKvBatchCompareAndSet(storage, controller, request, response, svr_done, true); });
+  bool ret = write_worker_set_->ExecuteRR(task);
+  if (!ret) {
+    brpc::ClosureGuard done_guard(svr_done);
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
+                            "WorkerSet queue is full, please wait and retry");
+  }
+}
+
+static butil::Status ValidateKvIngestSstRequest(StoragePtr storage, const pb::store::Context& context,
+                                                store::RegionPtr region) {
+  // check if region_epoch is match
+  auto status = ServiceHelper::ValidateRegionEpoch(context.region_epoch(), region);
+  if (!status.ok()) {
+    return status;
+  }
+
+  status = ServiceHelper::ValidateRegionState(region);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // the keys of txn region and the vector index is not built from the files.
+  if (region->Type() != pb::common::STORE_REGION || Helper::IsExecutorTxn(region->Range().start_key()) ||
+      Helper::IsClientTxn(region->Range().start_key())) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Only raw store region support ingest sst");
+  }
+
+  return storage->ValidateLeader(region->Id());
+}
+
+void DoKvUploadSst(StoragePtr storage, google::protobuf::RpcController* controller,
+                   const dingodb::pb::store::KvUploadSstRequest* request,
+                   dingodb::pb::store::KvUploadSstResponse* response, TrackClosure* done) {
+  brpc::Controller* cntl = (brpc::Controller*)controller;
+  brpc::ClosureGuard done_guard(done);
+  auto tracker = done->Tracker();
+  tracker->SetServiceQueueWaitTime();
+
+  int64_t region_id = request->context().region_id();
+  auto region = Server::GetInstance().GetRegion(region_id);
+  if (region == nullptr) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREGION_NOT_FOUND,
+                            fmt::format("Not found region {} at server {}", region_id, Server::GetInstance().Id()));
+    return;
+  }
+
+  auto status = ValidateKvIngestSstRequest(storage, request->context(), region);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    ServiceHelper::GetStoreRegionInfo(region, response->mutable_error());
+    return;
+  }
+
+  status = SstIngestManager::SaveFile(region_id, request->filename(), request->offset(), cntl->request_attachment());
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+  }
+}
+
+void StoreServiceImpl::KvUploadSst(google::protobuf::RpcController* controller,
+                                   const pb::store::KvUploadSstRequest* request,
+                                   pb::store::KvUploadSstResponse* response, google::protobuf::Closure* done) {
+  auto* svr_done = new ServiceClosure(__func__, done, request, response);
+
+  // Run in queue.
+  StoragePtr storage = storage_;
+  auto task =
+      std::make_shared<ServiceTask>([=]() { DoKvUploadSst(storage, controller, request, response, svr_done); });
+  bool ret = write_worker_set_->ExecuteRR(task);
+  if (!ret) {
+    brpc::ClosureGuard done_guard(svr_done);
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
+                            "WorkerSet queue is full, please wait and retry");
+  }
+}
+
+void DoKvIngestSst(StoragePtr storage, google::protobuf::RpcController* controller,
+                   const dingodb::pb::store::KvIngestSstRequest* request,
+                   dingodb::pb::store::KvIngestSstResponse* response, TrackClosure* done) {
+  brpc::Controller* cntl = (brpc::Controller*)controller;
+  brpc::ClosureGuard done_guard(done);
+  auto tracker = done->Tracker();
+  tracker->SetServiceQueueWaitTime();
+
+  int64_t region_id = request->context().region_id();
+  auto region = Server::GetInstance().GetRegion(region_id);
+  if (region == nullptr) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREGION_NOT_FOUND,
+                            fmt::format("Not found region {} at server {}", region_id, Server::GetInstance().Id()));
+    return;
+  }
+
+  if (request->filenames().empty()) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EILLEGAL_PARAMTETERS, "Param filenames is empty");
+    return;
+  }
+
+  auto status = ValidateKvIngestSstRequest(storage, request->context(), region);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    ServiceHelper::GetStoreRegionInfo(region, response->mutable_error());
+    return;
+  }
+
+  std::string cf_name = request->cf_name().empty() ? Constant::kStoreDataCF : request->cf_name();
+  auto cf_names = Helper::GetColumnFamilyNames(region->Range().start_key());
+  if (std::find(cf_names.begin(), cf_names.end(), cf_name) == cf_names.end()) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EILLEGAL_PARAMTETERS,
+                            fmt::format("Param cf_name {} is not the cf of region", cf_name));
+    return;
+  }
+
+  auto filenames = Helper::PbRepeatedToVector(request->filenames());
+  status = SstIngestManager::ValidateFiles(region, Server::GetInstance().GetRawEngine(region->GetRawEngineType()),
+                                           cf_name, filenames);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    return;
+  }
+
+  // Followers download the files before the raft log, so applying the log just ingest local files.
+  status = SstIngestManager::PrepareFollowers(region, filenames);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    return;
+  }
+
+  auto ctx = std::make_shared<Context>(cntl, nullptr, request, response);
+  ctx->SetRegionId(region_id);
+  ctx->SetTracker(tracker);
+  ctx->SetCfName(cf_name);
+  ctx->SetRegionEpoch(request->context().region_epoch());
+  ctx->SetRawEngineType(region->GetRawEngineType());
+
+  status = storage->KvIngestSst(ctx, filenames);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+  }
+}
+
+void StoreServiceImpl::KvIngestSst(google::protobuf::RpcController* controller,
+                                   const pb::store::KvIngestSstRequest* request,
+                                   pb::store::KvIngestSstResponse* response, google::protobuf::Closure* done) {
+  auto* svr_done = new ServiceClosure(__func__, done, request, response);
+
+  if (IsRaftApplyPendingExceed()) {
+    brpc::ClosureGuard done_guard(svr_done);
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
+                            "Raft apply queue is full, please wait and retry");
+    return;
+  }
+
+  // Run in queue.
+  StoragePtr storage = storage_;
+  auto task =
+      std::make_shared<ServiceTask>([=]() { DoKvIngestSst(storage, controller, request, response, svr_done); });
+  bool ret = write_worker_set_->ExecuteRR(task);
+  if (!ret) {
+    brpc::ClosureGuard done_guard(svr_done);
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
+                            "WorkerSet queue is full, please wait and retry");
+  }
+}
+
+static butil::Status ValidateBackupRegionRequest(StoragePtr storage, const pb::store::Context& context,
+                                                 store::RegionPtr region) {
+  auto status = ServiceHelper::ValidateRegionEpoch(context.region_epoch(), region);
+  if (!status.ok()) {
+    return status;
+  }
+
+  status = ServiceHelper::ValidateRegionState(region);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // the vector index is not built from the files when restoring.
+  if (region->Type() != pb::common::STORE_REGION) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Only store region support backup and restore");
+  }
+
+  return storage->ValidateLeader(region->Id());
+}
+
+void DoBackupRegion(StoragePtr storage, google::protobuf::RpcController* /*controller*/,
+                    const dingodb::pb::store::BackupRegionRequest* request,
+                    dingodb::pb::store::BackupRegionResponse* response, TrackClosure* done) {
+  brpc::ClosureGuard done_guard(done);
+  auto tracker = done->Tracker();
+  tracker->SetServiceQueueWaitTime();
+
+  int64_t region_id = request->context().region_id();
+  auto region = Server::GetInstance().GetRegion(region_id);
+  if (region == nullptr) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREGION_NOT_FOUND,
+                            fmt::format("Not found region {} at server {}", region_id, Server::GetInstance().Id()));
+    return;
+  }
+
+  if (request->backup_path().empty()) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EILLEGAL_PARAMTETERS, "Param backup_path is empty");
+    return;
+  }
+
+  auto status = ValidateBackupRegionRequest(storage, request->context(), region);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    ServiceHelper::GetStoreRegionInfo(region, response->mutable_error());
+    return;
+  }
+
+  RegionBackup::TaskGuard task_guard;
+  if (!task_guard.IsAcquired()) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
+                            "Backup and restore tasks are full, please wait and retry");
+    return;
+  }
+
+  status = RegionBackup::Backup(region, Server::GetInstance().GetRawEngine(region->GetRawEngineType()),
+                                request->backup_ts(), request->backup_path(), *response->mutable_meta());
+  if (!status.ok()) {
+    response->clear_meta();
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+  }
+}
+
+void StoreServiceImpl::BackupRegion(google::protobuf::RpcController* controller,
+                                    const pb::store::BackupRegionRequest* request,
+                                    pb::store::BackupRegionResponse* response, google::protobuf::Closure* done) {
+  auto* svr_done = new ServiceClosure(__func__, done, request, response);
+
+  // Run in bthread, copying files is too long to occupy the worker.
+  StoragePtr storage = storage_;
+  Bthread bth(&BTHREAD_ATTR_NORMAL);
+  bth.Run([=]() { DoBackupRegion(storage, controller, request, response, svr_done); });
+}
+
+void DoExportRegion(StoragePtr storage, google::protobuf::RpcController* /*controller*/,
+                    const dingodb::pb::store::ExportRegionRequest* request,
+                    dingodb::pb::store::ExportRegionResponse* response, TrackClosure* done) {
+  brpc::ClosureGuard done_guard(done);
+  auto tracker = done->Tracker();
+  tracker->SetServiceQueueWaitTime();
+
+  int64_t region_id = request->context().region_id();
+  auto region = Server::GetInstance().GetRegion(region_id);
+  if (region == nullptr) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREGION_NOT_FOUND,
+                            fmt::format("Not found region {} at server {}", region_id, Server::GetInstance().Id()));
+    return;
+  }
+
+  if (request->export_path().empty()) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EILLEGAL_PARAMTETERS, "Param export_path is empty");
+    return;
+  }
+
+  auto status = ValidateBackupRegionRequest(storage, request->context(), region);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    ServiceHelper::GetStoreRegionInfo(region, response->mutable_error());
+    return;
+  }
+
+  // export shares the task limit with backup and restore.
+  RegionBackup::TaskGuard task_guard;
+  if (!task_guard.IsAcquired()) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
+                            "Backup and restore tasks are full, please wait and retry");
+    return;
+  }
+
+  status = RegionExport::Export(region, Server::GetInstance().GetRawEngine(region->GetRawEngineType()),
+                                request->export_ts(), request->coprocessor(), request->export_path(),
+                                request->batch_rows(), *response->mutable_meta());
   if (!status.ok()) {
-    return status;
+    response->clear_meta();
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
   }
+}
 
-  return butil::Status();
+void StoreServiceImpl::ExportRegion(google::protobuf::RpcController* controller,
+                                    const pb::store::ExportRegionRequest* request,
+                                    pb::store::ExportRegionResponse* response, google::protobuf::Closure* done) {
+  auto* svr_done = new ServiceClosure(__func__, done, request, response);
+
+  // Run in bthread, scanning the whole region is too long to occupy the worker.
+  StoragePtr storage = storage_;
+  Bthread bth(&BTHREAD_ATTR_NORMAL);
+  bth.Run([=]() { DoExportRegion(storage, controller, request, response, svr_done); });
 }
 
-void DoKvBatchCompareAndSet(StoragePtr storage, google::protobuf::RpcController* controller,
-                            const dingodb::pb::store::KvBatchCompareAndSetRequest* request,
-                            dingodb::pb::store::KvBatchCompareAndSetResponse* response, TrackClosure* done,
-                            bool is_sync) {
+void DoRestoreRegion(StoragePtr storage, google::protobuf::RpcController* controller,
+                     const dingodb::pb::store::RestoreRegionRequest* request,
+                     dingodb::pb::store::RestoreRegionResponse* response, TrackClosure* done) {
   brpc::Controller* cntl = (brpc::Controller*)controller;
   brpc::ClosureGuard done_guard(done);
   auto tracker = done->Tracker();
@@ -1077,64 +1624,72 @@ void DoKvBatchCompareAndSet(StoragePtr storage, google::protobuf::RpcController*
     return;
   }
 
-  auto status = ValidateKvBatchCompareAndSetRequest(request, region);
+  if (request->backup_path().empty()) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EILLEGAL_PARAMTETERS, "Param backup_path is empty");
+    return;
+  }
+
+  auto status = ValidateBackupRegionRequest(storage, request->context(), region);
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
     ServiceHelper::GetStoreRegionInfo(region, response->mutable_error());
     return;
   }
 
-  // check latches
-  auto start_time_us = butil::gettimeofday_us();
-  std::vector<std::string> keys_for_lock;
-  for (const auto& kv : request->kvs()) {
-    keys_for_lock.push_back(kv.key());
+  RegionBackup::TaskGuard task_guard;
+  if (!task_guard.IsAcquired()) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
+                            "Backup and restore tasks are full, please wait and retry");
+    return;
   }
-  Lock lock(keys_for_lock);
-  BthreadCond sync_cond;
-  uint64_t cid = (uint64_t)(&sync_cond);
 
-  bool latch_got = false;
-  while (!latch_got) {
-    latch_got = region->LatchesAcquire(&lock, cid);
-    if (!latch_got) {
-      sync_cond.IncreaseWait();
+  // the files not ingested are removed, the ingested files are removed by ingest.
+  std::map<std::string, std::vector<std::string>> cf_filenames;
+  auto clean_files = [&]() {
+    for (const auto& [_, filenames] : cf_filenames) {
+      for (const auto& filename : filenames) {
+        Helper::RemoveFileOrDirectory(SstIngestManager::GetIngestFilePath(region_id, filename));
+      }
     }
-  }
-
-  g_raw_latches_recorder << butil::gettimeofday_us() - start_time_us;
-
-  // release latches after done
-  DEFER(region->LatchesRelease(&lock, cid));
-
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
-  ctx->SetRegionId(region_id);
-  ctx->SetTracker(tracker);
-  ctx->SetCfName(Constant::kStoreDataCF);
-  ctx->SetRegionEpoch(request->context().region_epoch());
-  ctx->SetRawEngineType(region->GetRawEngineType());
-
-  auto* mut_request = const_cast<dingodb::pb::store::KvBatchCompareAndSetRequest*>(request);
+  };
 
-  std::vector<bool> key_states;
-  status = storage->KvCompareAndSet(ctx, Helper::PbRepeatedToVector(mut_request->kvs()),
-                                    Helper::PbRepeatedToVector(mut_request->expect_values()), request->is_atomic(),
-                                    key_states);
+  status = RegionBackup::PrepareRestore(region, request->backup_path(), request->backup_region_id(), cf_filenames);
   if (!status.ok()) {
+    clean_files();
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
-
-    if (!is_sync) done->Run();
+    return;
   }
 
-  for (const auto& key_state : key_states) {
-    response->add_key_states(key_state);
+  auto raw_engine = Server::GetInstance().GetRawEngine(region->GetRawEngineType());
+  for (auto& [cf_name, filenames] : cf_filenames) {
+    status = SstIngestManager::ValidateFiles(region, raw_engine, cf_name, filenames);
+    if (status.ok()) {
+      status = SstIngestManager::PrepareFollowers(region, filenames);
+    }
+    if (status.ok()) {
+      auto ctx = std::make_shared<Context>(cntl, nullptr, request, response);
+      ctx->SetRegionId(region_id);
+      ctx->SetTracker(tracker);
+      ctx->SetCfName(cf_name);
+      ctx->SetRegionEpoch(request->context().region_epoch());
+      ctx->SetRawEngineType(region->GetRawEngineType());
+
+      status = storage->KvIngestSst(ctx, filenames);
+    }
+    if (!status.ok()) {
+      clean_files();
+      ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+      return;
+    }
+
+    response->set_restore_file_count(response->restore_file_count() + filenames.size());
+    filenames.clear();
   }
 }
 
-void StoreServiceImpl::KvBatchCompareAndSet(google::protobuf::RpcController* controller,
-                                            const pb::store::KvBatchCompareAndSetRequest* request,
-                                            pb::store::KvBatchCompareAndSetResponse* response,
-                                            google::protobuf::Closure* done) {
+void StoreServiceImpl::RestoreRegion(google::protobuf::RpcController* controller,
+                                     const pb::store::RestoreRegionRequest* request,
+                                     pb::store::RestoreRegionResponse* response, google::protobuf::Closure* done) {
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
 
   if (IsRaftApplyPendingExceed()) {
@@ -1144,20 +1699,10 @@ void StoreServiceImpl::KvBatchCompareAndSet(google::protobuf::RpcController* con
     return;
   }
 
-  if (request->kvs().empty()) {
-    return;
-  }
-
-  // Run in queue.
+  // Run in bthread, copying files is too long to occupy the worker.
   StoragePtr storage = storage_;
-  auto task = std::make_shared<ServiceTask>(
-      [=]() { DoKvBatchCompareAndSet(storage, controller, request, response, svr_done, true); });
-  bool ret = write_worker_set_->ExecuteRR(task);
-  if (!ret) {
-    brpc::ClosureGuard done_guard(svr_done);
-    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
-                            "WorkerSet queue is full, please wait and retry");
-  }
+  Bthread bth(&BTHREAD_ATTR_NORMAL);
+  bth.Run([=]() { DoRestoreRegion(storage, controller, request, response, svr_done); });
 }
 
 static butil::Status ValidateKvScanBeginRequest(const dingodb::pb::store::KvScanBeginRequest* request,
@@ -1216,6 +1761,7 @@ void DoKvScanBegin(StoragePtr storage, google::protobuf::RpcController* controll
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
   ctx->SetRegionEpoch(request->context().region_epoch());
+  ctx->SetReadMode(request->context().read_mode());
   ctx->SetRawEngineType(region->GetRawEngineType());
 
   auto correction_range = Helper::IntersectRange(region->Range(), uniform_range);
@@ -1232,7 +1778,7 @@ void DoKvScanBegin(StoragePtr storage, google::protobuf::RpcController* controll
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 
   *response->mutable_scan_id() = scan_id;
@@ -1251,6 +1797,7 @@ void StoreServiceImpl::KvScanBegin(google::protobuf::RpcController* controller,
   // Run in queue.
   StoragePtr storage = storage_;
   auto task = std::make_shared<ServiceTask>([=]() { DoKvScanBegin(storage, controller, request, response, svr_done); });
+  ServiceHelper::SetTaskLane(task, TaskLane::kScan, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1319,7 +1866,7 @@ void DoKvScanContinue(StoragePtr storage, google::protobuf::RpcController* contr
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 }
 
@@ -1337,6 +1884,7 @@ void StoreServiceImpl::KvScanContinue(google::protobuf::RpcController* controlle
   StoragePtr storage = storage_;
   auto task =
       std::make_shared<ServiceTask>([=]() { DoKvScanContinue(storage, controller, request, response, svr_done); });
+  ServiceHelper::SetTaskLane(task, TaskLane::kScan, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1499,6 +2047,7 @@ void DoKvScanBeginV2(StoragePtr storage, google::protobuf::RpcController* contro
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
   ctx->SetRegionEpoch(request->context().region_epoch());
+  ctx->SetReadMode(request->context().read_mode());
   ctx->SetRawEngineType(region->GetRawEngineType());
 
   auto correction_range = Helper::IntersectRange(region->Range(), uniform_range);
@@ -1515,7 +2064,7 @@ void DoKvScanBeginV2(StoragePtr storage, google::protobuf::RpcController* contro
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 
   response->set_scan_id(scan_id);
@@ -1527,6 +2076,11 @@ void StoreServiceImpl::KvScanBeginV2(google::protobuf::RpcController* controller
                                      ::google::protobuf::Closure* done) {
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
 
+  int32_t tenant_priority = 0;
+  if (!ServiceHelper::AdmitTenantRequest(request, response, svr_done, tenant_priority)) {
+    return;
+  }
+
   if (!FLAGS_enable_async_store_operation) {
     return DoKvScanBeginV2(storage_, controller, request, response, svr_done);
   }
@@ -1535,6 +2089,7 @@ void StoreServiceImpl::KvScanBeginV2(google::protobuf::RpcController* controller
   StoragePtr storage = storage_;
   auto task =
       std::make_shared<ServiceTask>([=]() { DoKvScanBeginV2(storage, controller, request, response, svr_done); });
+  task->SetPriority(tenant_priority);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1604,7 +2159,7 @@ void DoKvScanContinueV2(StoragePtr storage, google::protobuf::RpcController* con
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 
   response->set_has_more(has_more);
@@ -1632,6 +2187,106 @@ void StoreServiceImpl::KvScanContinueV2(::google::protobuf::RpcController* contr
   }
 }
 
+void DoKvScanStreamV2(google::protobuf::RpcController* controller,
+                      const dingodb::pb::store::KvScanContinueRequestV2* request,
+                      dingodb::pb::store::KvScanContinueResponseV2* response, TrackClosure* done) {
+  brpc::Controller* cntl = (brpc::Controller*)controller;
+  brpc::ClosureGuard done_guard(done);
+  auto tracker = done->Tracker();
+  tracker->SetServiceQueueWaitTime();
+
+  int64_t region_id = request->context().region_id();
+  auto region = Server::GetInstance().GetRegion(region_id);
+  if (region == nullptr) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREGION_NOT_FOUND,
+                            fmt::format("Not found region {} at server {}", region_id, Server::GetInstance().Id()));
+    return;
+  }
+
+  butil::Status status = ValidateKvScanContinueRequestV2(request, region);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    ServiceHelper::GetStoreRegionInfo(region, response->mutable_error());
+    return;
+  }
+
+  status = ScanStream::Start(request->scan_id(), request->max_fetch_cnt(), cntl);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    return;
+  }
+
+  response->set_has_more(true);
+}
+
+void StoreServiceImpl::KvScanStreamV2(::google::protobuf::RpcController* controller,
+                                      const ::dingodb::pb::store::KvScanContinueRequestV2* request,
+                                      ::dingodb::pb::store::KvScanContinueResponseV2* response,
+                                      ::google::protobuf::Closure* done) {
+  auto* svr_done = new ServiceClosure(__func__, done, request, response);
+
+  if (!FLAGS_enable_async_store_operation) {
+    return DoKvScanStreamV2(controller, request, response, svr_done);
+  }
+
+  // Run in queue.
+  auto task = std::make_shared<ServiceTask>([=]() { DoKvScanStreamV2(controller, request, response, svr_done); });
+  bool ret = read_worker_set_->ExecuteRR(task);
+  if (!ret) {
+    brpc::ClosureGuard done_guard(svr_done);
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
+                            "WorkerSet queue is full, please wait and retry");
+  }
+}
+
+void DoKvCdcStream(google::protobuf::RpcController* controller, const dingodb::pb::store::KvCdcRequest* request,
+                   dingodb::pb::store::KvCdcResponse* response, TrackClosure* done) {
+  brpc::Controller* cntl = (brpc::Controller*)controller;
+  brpc::ClosureGuard done_guard(done);
+  auto tracker = done->Tracker();
+  tracker->SetServiceQueueWaitTime();
+
+  int64_t region_id = request->context().region_id();
+  auto region = Server::GetInstance().GetRegion(region_id);
+  if (region == nullptr) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREGION_NOT_FOUND,
+                            fmt::format("Not found region {} at server {}", region_id, Server::GetInstance().Id()));
+    return;
+  }
+
+  butil::Status status = ServiceHelper::ValidateRegionEpoch(request->context().region_epoch(), region);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    ServiceHelper::GetStoreRegionInfo(region, response->mutable_error());
+    return;
+  }
+
+  status = CdcManager::GetInstance().Subscribe(*request, cntl);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    return;
+  }
+}
+
+void StoreServiceImpl::KvCdcStream(::google::protobuf::RpcController* controller,
+                                   const ::dingodb::pb::store::KvCdcRequest* request,
+                                   ::dingodb::pb::store::KvCdcResponse* response, ::google::protobuf::Closure* done) {
+  auto* svr_done = new ServiceClosure(__func__, done, request, response);
+
+  if (!FLAGS_enable_async_store_operation) {
+    return DoKvCdcStream(controller, request, response, svr_done);
+  }
+
+  // Run in queue.
+  auto task = std::make_shared<ServiceTask>([=]() { DoKvCdcStream(controller, request, response, svr_done); });
+  bool ret = read_worker_set_->ExecuteRR(task);
+  if (!ret) {
+    brpc::ClosureGuard done_guard(svr_done);
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
+                            "WorkerSet queue is full, please wait and retry");
+  }
+}
+
 static butil::Status ValidateKvScanReleaseRequestV2(const dingodb::pb::store::KvScanReleaseRequestV2* request,
                                                     store::RegionPtr region) {
   // check if region_epoch is match
@@ -1729,11 +2384,14 @@ void DoTxnGet(StoragePtr storage, google::protobuf::RpcController* controller,
     return;
   }
 
+  RegionLoadStatistics::GetInstance().RecordRead(region_id, request->key());
+
   std::shared_ptr<Context> ctx = std::make_shared<Context>();
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
   ctx->SetRegionEpoch(request->context().region_epoch());
+  ctx->SetReadMode(request->context().read_mode());
   ctx->SetIsolationLevel(request->context().isolation_level());
   ctx->SetRawEngineType(region->GetRawEngineType());
 
@@ -1757,6 +2415,7 @@ void DoTxnGet(StoragePtr storage, google::protobuf::RpcController* controller,
 
   if (!kvs.empty()) {
     response->set_value(kvs[0].value());
+    RegionLoadStatistics::GetInstance().RecordReadBytes(region_id, kvs[0].key().size() + kvs[0].value().size());
   }
   *response->mutable_txn_result() = txn_result_info;
 }
@@ -1765,9 +2424,16 @@ void StoreServiceImpl::TxnGet(google::protobuf::RpcController* controller, const
                               pb::store::TxnGetResponse* response, google::protobuf::Closure* done) {
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
 
+  int32_t tenant_priority = 0;
+  if (!ServiceHelper::AdmitTenantRequest(request, response, svr_done, tenant_priority)) {
+    return;
+  }
+
   // Run in queue.
   StoragePtr storage = storage_;
   auto task = std::make_shared<ServiceTask>([=]() { DoTxnGet(storage, controller, request, response, svr_done); });
+  task->SetPriority(tenant_priority);
+  ServiceHelper::SetTaskLane(task, TaskLane::kPointRead, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1832,6 +2498,7 @@ void DoTxnScan(StoragePtr storage, google::protobuf::RpcController* controller,
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
   ctx->SetRegionEpoch(request->context().region_epoch());
+  ctx->SetReadMode(request->context().read_mode());
   ctx->SetIsolationLevel(request->context().isolation_level());
   ctx->SetRawEngineType(region->GetRawEngineType());
 
@@ -1846,9 +2513,18 @@ void DoTxnScan(StoragePtr storage, google::protobuf::RpcController* controller,
   std::string end_key{};
 
   auto correction_range = Helper::IntersectRange(region->Range(), uniform_range);
-  status = storage->TxnScan(ctx, request->start_ts(), correction_range, request->limit(), request->key_only(),
-                            request->is_reverse(), resolved_locks, txn_result_info, kvs, has_more, end_key,
-                            !request->has_coprocessor(), request->coprocessor());
+  int64_t scan_id = request->scan_id();
+  if (FLAGS_enable_txn_scan_cursor && request->use_cursor() && !request->is_reverse() && !request->has_coprocessor() &&
+      request->context().isolation_level() == pb::store::SnapshotIsolation) {
+    status = storage->TxnScanWithCursor(ctx, request->start_ts(), correction_range, request->limit(),
+                                        request->key_only(), resolved_locks, scan_id, txn_result_info, kvs, has_more,
+                                        end_key);
+  } else {
+    scan_id = 0;
+    status = storage->TxnScan(ctx, request->start_ts(), correction_range, request->limit(), request->key_only(),
+                              request->is_reverse(), resolved_locks, txn_result_info, kvs, has_more, end_key,
+                              !request->has_coprocessor(), request->coprocessor());
+  }
 
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
@@ -1856,7 +2532,7 @@ void DoTxnScan(StoragePtr storage, google::protobuf::RpcController* controller,
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 
   if (txn_result_info.ByteSizeLong() > 0) {
@@ -1864,15 +2540,23 @@ void DoTxnScan(StoragePtr storage, google::protobuf::RpcController* controller,
   }
   response->set_end_key(end_key);
   response->set_has_more(has_more);
+  response->set_scan_id(scan_id);
 }
 
 void StoreServiceImpl::TxnScan(google::protobuf::RpcController* controller, const pb::store::TxnScanRequest* request,
                                pb::store::TxnScanResponse* response, google::protobuf::Closure* done) {
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
 
+  int32_t tenant_priority = 0;
+  if (!ServiceHelper::AdmitTenantRequest(request, response, svr_done, tenant_priority)) {
+    return;
+  }
+
   // Run in queue.
   StoragePtr storage = storage_;
   auto task = std::make_shared<ServiceTask>([=]() { DoTxnScan(storage, controller, request, response, svr_done); });
+  task->SetPriority(tenant_priority);
+  ServiceHelper::SetTaskLane(task, TaskLane::kScan, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1918,6 +2602,11 @@ static butil::Status ValidateTxnPessimisticLockRequest(const dingodb::pb::store:
     return status;
   }
 
+  status = WriteThrottler::GetInstance().Throttle();
+  if (!status.ok()) {
+    return status;
+  }
+
   std::vector<std::string_view> keys;
   for (const auto& mutation : request->mutations()) {
     if (mutation.key().empty()) {
@@ -1941,9 +2630,85 @@ static butil::Status ValidateTxnPessimisticLockRequest(const dingodb::pb::store:
   return butil::Status();
 }
 
+static void DoTxnPessimisticLockWithWait(StoragePtr storage, google::protobuf::RpcController* controller,
+                                         const dingodb::pb::store::TxnPessimisticLockRequest* request,
+                                         dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done,
+                                         bool is_sync, int64_t wait_deadline_ms);
+
+// Wait for the conflict lock if all keys are only conflict with locks of other txns.
+// Return true if waiting, the request is done by the waiter, it is retried when the lock is removed, or the lock
+// conflict is returned when timeout.
+static bool WaitTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* controller,
+                                   const dingodb::pb::store::TxnPessimisticLockRequest* request,
+                                   dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done,
+                                   store::RegionPtr region, int64_t wait_deadline_ms) {
+  int64_t timeout_ms = wait_deadline_ms - Helper::TimestampMs();
+  if (timeout_ms <= 0 || response->error().errcode() != pb::error::OK) {
+    return false;
+  }
+
+  pb::store::LockInfo conflict_lock;
+  for (const auto& txn_result : response->txn_result()) {
+    if (!txn_result.has_locked() || txn_result.locked().lock_ts() == static_cast<int64_t>(request->start_ts())) {
+      return false;
+    }
+    if (conflict_lock.key().empty()) {
+      conflict_lock = txn_result.locked();
+    }
+  }
+  if (conflict_lock.key().empty()) {
+    return false;
+  }
+
+  std::string lock_key = Helper::EncodeTxnKey(conflict_lock.key(), Constant::kLockVer);
+  bool is_waiting = TxnLockWaitManager::GetInstance().Wait(
+      lock_key, request->start_ts(), conflict_lock.lock_ts(), timeout_ms,
+      [storage, controller, request, response, done, wait_deadline_ms](bool is_timeout) {
+        Bthread bth([=]() {
+          if (is_timeout) {
+            // return the lock conflict
+            brpc::ClosureGuard done_guard(done);
+            return;
+          }
+          response->clear_txn_result();
+          DoTxnPessimisticLockWithWait(storage, controller, request, response, done, true, wait_deadline_ms);
+        });
+      });
+  if (!is_waiting) {
+    response->clear_txn_result();
+    auto* write_conflict = response->add_txn_result()->mutable_write_conflict();
+    write_conflict->set_reason(pb::store::WriteConflict::Deadlock);
+    write_conflict->set_start_ts(request->start_ts());
+    write_conflict->set_conflict_ts(conflict_lock.lock_ts());
+    write_conflict->set_key(conflict_lock.key());
+    write_conflict->set_primary_key(conflict_lock.primary_lock());
+    return false;
+  }
+
+  // the lock may be removed before waiting, check it again to avoid missing the wake up.
+  std::string lock_value;
+  pb::store::LockInfo current_lock;
+  auto raw_engine = Server::GetInstance().GetRawEngine(region->GetRawEngineType());
+  auto status = raw_engine->Reader()->KvGet(Constant::kTxnLockCF, lock_key, lock_value);
+  if (!status.ok() || !current_lock.ParseFromString(lock_value) || current_lock.lock_ts() != conflict_lock.lock_ts()) {
+    TxnLockWaitManager::GetInstance().WakeUp(lock_key);
+  }
+
+  return true;
+}
+
 void DoTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* controller,
                           const dingodb::pb::store::TxnPessimisticLockRequest* request,
                           dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done, bool is_sync) {
+  int64_t wait_deadline_ms =
+      (FLAGS_enable_txn_lock_wait && is_sync) ? Helper::TimestampMs() + FLAGS_txn_lock_wait_timeout_ms : 0;
+  DoTxnPessimisticLockWithWait(storage, controller, request, response, done, is_sync, wait_deadline_ms);
+}
+
+static void DoTxnPessimisticLockWithWait(StoragePtr storage, google::protobuf::RpcController* controller,
+                                         const dingodb::pb::store::TxnPessimisticLockRequest* request,
+                                         dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done,
+                                         bool is_sync, int64_t wait_deadline_ms) {
   brpc::Controller* cntl = (brpc::Controller*)controller;
   brpc::ClosureGuard done_guard(done);
   auto tracker = done->Tracker();
@@ -2007,6 +2772,12 @@ void DoTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* c
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
 
     if (!is_sync) done->Run();
+    return;
+  }
+
+  if (is_sync && wait_deadline_ms > 0 &&
+      WaitTxnPessimisticLock(storage, controller, request, response, done, region, wait_deadline_ms)) {
+    done_guard.release();
   }
 }
 
@@ -2205,6 +2976,11 @@ static butil::Status ValidateTxnPrewriteRequest(const dingodb::pb::store::TxnPre
     return status;
   }
 
+  status = WriteThrottler::GetInstance().Throttle();
+  if (!status.ok()) {
+    return status;
+  }
+
   std::vector<std::string_view> keys;
   for (const auto& mutation : request->mutations()) {
     if (mutation.key().empty()) {
@@ -2243,6 +3019,13 @@ void DoTxnPrewrite(StoragePtr storage, google::protobuf::RpcController* controll
     return;
   }
 
+  if (request->mutations_size() > 0) {
+    const auto& mutation = request->mutations(butil::fast_rand_less_than(request->mutations_size()));
+    RegionLoadStatistics::GetInstance().RecordWrite(
+        region_id, mutation.key(), request->mutations_size(),
+        (mutation.key().size() + mutation.value().size()) * request->mutations_size());
+  }
+
   // check latches
   auto start_time_us = butil::gettimeofday_us();
   std::vector<std::string> keys_for_lock;
@@ -2310,6 +3093,11 @@ void StoreServiceImpl::TxnPrewrite(google::protobuf::RpcController* controller,
                                    pb::store::TxnPrewriteResponse* response, google::protobuf::Closure* done) {
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
 
+  int32_t tenant_priority = 0;
+  if (!ServiceHelper::AdmitTenantRequest(request, response, svr_done, tenant_priority)) {
+    return;
+  }
+
   if (IsRaftApplyPendingExceed()) {
     brpc::ClosureGuard done_guard(svr_done);
     ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
@@ -2321,6 +3109,7 @@ void StoreServiceImpl::TxnPrewrite(google::protobuf::RpcController* controller,
   StoragePtr storage = storage_;
   auto task =
       std::make_shared<ServiceTask>([=]() { DoTxnPrewrite(storage, controller, request, response, svr_done, true); });
+  task->SetPriority(tenant_priority);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2443,6 +3232,11 @@ void StoreServiceImpl::TxnCommit(google::protobuf::RpcController* controller,
                                  google::protobuf::Closure* done) {
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
 
+  int32_t tenant_priority = 0;
+  if (!ServiceHelper::AdmitTenantRequest(request, response, svr_done, tenant_priority)) {
+    return;
+  }
+
   if (IsRaftApplyPendingExceed()) {
     brpc::ClosureGuard done_guard(svr_done);
     ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
@@ -2454,6 +3248,7 @@ void StoreServiceImpl::TxnCommit(google::protobuf::RpcController* controller,
   StoragePtr storage = storage_;
   auto task =
       std::make_shared<ServiceTask>([=]() { DoTxnCommit(storage, controller, request, response, svr_done, true); });
+  task->SetPriority(tenant_priority);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2715,6 +3510,17 @@ static butil::Status ValidateTxnBatchGetRequest(const dingodb::pb::store::TxnBat
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "start_ts is 0");
   }
 
+  if (request->key_start_ts_size() > 0) {
+    if (request->key_start_ts_size() != request->keys_size()) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "key_start_ts size not match keys size");
+    }
+    for (const auto& start_ts : request->key_start_ts()) {
+      if (start_ts == 0) {
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "key_start_ts is 0");
+      }
+    }
+  }
+
   std::vector<std::string_view> keys;
   for (const auto& key : request->keys()) {
     if (key.empty()) {
@@ -2753,17 +3559,25 @@ void DoTxnBatchGet(StoragePtr storage, google::protobuf::RpcController* controll
     return;
   }
 
+  if (request->keys_size() > 0) {
+    RegionLoadStatistics::GetInstance().RecordRead(
+        region_id, request->keys(butil::fast_rand_less_than(request->keys_size())), request->keys_size());
+  }
+
   std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
   ctx->SetRegionEpoch(request->context().region_epoch());
+  ctx->SetReadMode(request->context().read_mode());
   ctx->SetIsolationLevel(request->context().isolation_level());
   ctx->SetRawEngineType(region->GetRawEngineType());
 
-  std::vector<std::string> keys;
-  for (const auto& key : request->keys()) {
-    keys.emplace_back(key);
+  // Keys of coalesced request are grouped by start_ts, every group is read at its own start_ts.
+  std::map<int64_t, std::vector<std::string>> ts_keys;
+  for (int i = 0; i < request->keys_size(); ++i) {
+    int64_t start_ts = request->key_start_ts_size() > 0 ? request->key_start_ts(i) : request->start_ts();
+    ts_keys[start_ts].emplace_back(request->keys(i));
   }
 
   std::set<int64_t> resolved_locks;
@@ -2774,14 +3588,25 @@ void DoTxnBatchGet(StoragePtr storage, google::protobuf::RpcController* controll
   pb::store::TxnResultInfo txn_result_info;
 
   std::vector<pb::common::KeyValue> kvs;
-  status = storage->TxnBatchGet(ctx, request->start_ts(), keys, resolved_locks, txn_result_info, kvs);
-  if (!status.ok()) {
-    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+  for (const auto& [start_ts, keys] : ts_keys) {
+    std::vector<pb::common::KeyValue> ts_kvs;
+    status = storage->TxnBatchGet(ctx, start_ts, keys, resolved_locks, txn_result_info, ts_kvs);
+    if (!status.ok()) {
+      ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
 
-    return;
+      return;
+    }
+
+    if (txn_result_info.ByteSizeLong() > 0) {
+      // Client should redo the request after resolving the lock, no kvs are returned.
+      kvs.clear();
+      break;
+    }
+    kvs.insert(kvs.end(), std::make_move_iterator(ts_kvs.begin()), std::make_move_iterator(ts_kvs.end()));
   }
 
   if (!kvs.empty()) {
+    RegionLoadStatistics::GetInstance().RecordReadBytes(region_id, KvsBytes(kvs));
     for (const auto& kv : kvs) {
       *response->add_kvs() = kv;
     }
@@ -2794,9 +3619,16 @@ void StoreServiceImpl::TxnBatchGet(google::protobuf::RpcController* controller,
                                    pb::store::TxnBatchGetResponse* response, google::protobuf::Closure* done) {
   auto* svr_done = new ServiceClosure(__func__, done, request, response);
 
+  int32_t tenant_priority = 0;
+  if (!ServiceHelper::AdmitTenantRequest(request, response, svr_done, tenant_priority)) {
+    return;
+  }
+
   // Run in queue.
   StoragePtr storage = storage_;
   auto task = std::make_shared<ServiceTask>([=]() { DoTxnBatchGet(storage, controller, request, response, svr_done); });
+  task->SetPriority(tenant_priority);
+  ServiceHelper::SetTaskLane(task, TaskLane::kPointRead, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3045,6 +3877,7 @@ void StoreServiceImpl::TxnScanLock(google::protobuf::RpcController* controller,
   // Run in queue.
   StoragePtr storage = storage_;
   auto task = std::make_shared<ServiceTask>([=]() { DoTxnScanLock(storage, controller, request, response, svr_done); });
+  ServiceHelper::SetTaskLane(task, TaskLane::kScan, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3312,6 +4145,25 @@ void DoTxnDeleteRange(StoragePtr storage, google::protobuf::RpcController* contr
     return;
   }
 
+  // check latches, range latch is exclusive with the key latches of region
+  auto start_time_us = butil::gettimeofday_us();
+  Lock lock(request->start_key(), request->end_key());
+  BthreadCond sync_cond;
+  uint64_t cid = (uint64_t)(&sync_cond);
+
+  bool latch_got = false;
+  while (!latch_got) {
+    latch_got = region->LatchesAcquire(&lock, cid);
+    if (!latch_got) {
+      sync_cond.IncreaseWait();
+    }
+  }
+
+  g_txn_latches_recorder << butil::gettimeofday_us() - start_time_us;
+
+  // release latches after done
+  DEFER(region->LatchesRelease(&lock, cid));
+
   auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
@@ -3457,6 +4309,7 @@ void StoreServiceImpl::TxnDump(google::protobuf::RpcController* controller, cons
   // Run in queue.
   StoragePtr storage = storage_;
   auto task = std::make_shared<ServiceTask>([=]() { DoTxnDump(storage, controller, request, response, svr_done); });
+  ServiceHelper::SetTaskLane(task, TaskLane::kBackground, controller, response, svr_done);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -58,6 +58,14 @@ class StoreServiceImpl : public pb::store::StoreService {
                         ::dingodb::pb::store::KvScanContinueResponseV2* response,
                         ::google::protobuf::Closure* done) override;
 
+  void KvScanStreamV2(::google::protobuf::RpcController* controller,
+                      const ::dingodb::pb::store::KvScanContinueRequestV2* request,
+                      ::dingodb::pb::store::KvScanContinueResponseV2* response,
+                      ::google::protobuf::Closure* done) override;
+
+  void KvCdcStream(::google::protobuf::RpcController* controller, const ::dingodb::pb::store::KvCdcRequest* request,
+                   ::dingodb::pb::store::KvCdcResponse* response, ::google::protobuf::Closure* done) override;
+
   void KvScanReleaseV2(::google::protobuf::RpcController* controller,
                        const ::dingodb::pb::store::KvScanReleaseRequestV2* request,
                        ::dingodb::pb::store::KvScanReleaseResponseV2* response,
@@ -91,6 +99,20 @@ class StoreServiceImpl : public pb::store::StoreService {
                             pb::store::KvBatchCompareAndSetResponse* response,
                             google::protobuf::Closure* done) override;
 
+  // bulk load
+  void KvUploadSst(google::protobuf::RpcController* controller, const pb::store::KvUploadSstRequest* request,
+                   pb::store::KvUploadSstResponse* response, google::protobuf::Closure* done) override;
+  void KvIngestSst(google::protobuf::RpcController* controller, const pb::store::KvIngestSstRequest* request,
+                   pb::store::KvIngestSstResponse* response, google::protobuf::Closure* done) override;
+
+  // backup and restore
+  void BackupRegion(google::protobuf::RpcController* controller, const pb::store::BackupRegionRequest* request,
+                    pb::store::BackupRegionResponse* response, google::protobuf::Closure* done) override;
+  void RestoreRegion(google::protobuf::RpcController* controller, const pb::store::RestoreRegionRequest* request,
+                     pb::store::RestoreRegionResponse* response, google::protobuf::Closure* done) override;
+  void ExportRegion(google::protobuf::RpcController* controller, const pb::store::ExportRegionRequest* request,
+                    pb::store::ExportRegionResponse* response, google::protobuf::Closure* done) override;
+
   // txn read
   void TxnGet(google::protobuf::RpcController* controller, const pb::store::TxnGetRequest* request,
               pb::store::TxnGetResponse* response, google::protobuf::Closure* done) override;
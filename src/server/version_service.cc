@@ -667,9 +667,30 @@ void DoWatch(google::protobuf::RpcController* controller, const pb::version::Wat
 
   DINGO_LOG(INFO) << "Receive Watch Request: " << request->ShortDebugString();
 
+  if (request->has_create_request()) {
+    auto ret = kv_control->CreateStreamWatch(request->create_request(), static_cast<brpc::Controller*>(controller),
+                                             response);
+    if (!ret.ok()) {
+      response->mutable_error()->set_errcode(static_cast<pb::error::Errno>(ret.error_code()));
+      response->mutable_error()->set_errmsg(ret.error_str());
+    }
+    return;
+  }
+
+  if (request->has_cancel_request()) {
+    auto ret = kv_control->CancelStreamWatch(request->cancel_request().watch_id());
+    if (!ret.ok()) {
+      response->mutable_error()->set_errcode(static_cast<pb::error::Errno>(ret.error_code()));
+      response->mutable_error()->set_errmsg(ret.error_str());
+    }
+    response->set_watch_id(request->cancel_request().watch_id());
+    response->set_canceled(ret.ok());
+    return;
+  }
+
   if (!request->has_one_time_request()) {
     response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
-    response->mutable_error()->set_errmsg("only one_time_request is supported now");
+    response->mutable_error()->set_errmsg("only one_time_request, create_request and cancel_request are supported");
     return;
   }
 
@@ -1050,16 +1071,24 @@ void VersionServiceProtoImpl::Watch(google::protobuf::RpcController* controller,
     return RedirectResponse(response);
   }
 
-  if (!request->has_one_time_request()) {
-    response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
-    response->mutable_error()->set_errmsg("only one_time_request is supported now");
-    return;
-  }
+  if (request->has_create_request()) {
+    if (request->create_request().key().empty()) {
+      response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
+      response->mutable_error()->set_errmsg("key is empty");
+      return;
+    }
+  } else if (!request->has_cancel_request()) {
+    if (!request->has_one_time_request()) {
+      response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
+      response->mutable_error()->set_errmsg("only one_time_request, create_request and cancel_request are supported");
+      return;
+    }
 
-  if (request->one_time_request().key().empty()) {
-    response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
-    response->mutable_error()->set_errmsg("key is empty");
-    return;
+    if (request->one_time_request().key().empty()) {
+      response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
+      response->mutable_error()->set_errmsg("key is empty");
+      return;
+    }
   }
 
   auto* svr_done = new CoordinatorServiceClosure("Watch", done_guard.release(), request, response);
@@ -0,0 +1,309 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "split/load_split.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "butil/fast_rand.h"
+#include "common/helper.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_load_split, false, "split hot region by read/write qps");
+DEFINE_int64(load_split_sample_rate_inverse, 16, "record one of every n requests for load statistic");
+DEFINE_int32(load_split_max_sample_keys, 1024, "max sampled keys of region in a statistic window");
+DEFINE_int32(load_split_bucket_num, 8, "load bucket num of region reported to coordinator");
+DEFINE_int64(load_split_qps_threshold, 3000, "region read and write qps reach it is hot");
+DEFINE_int32(load_split_hot_window_count, 3, "split region after it is hot for continuous statistic windows");
+DEFINE_int32(load_split_hot_key_num, 8, "top hot key num of region reported to coordinator");
+
+int64_t CountMinSketch::Add(const std::string& key, int64_t count) {
+  // Double hashing, the i-th hash is h1 + i * h2.
+  uint64_t hash = std::hash<std::string>{}(key);
+  uint64_t h1 = hash & 0xffffffff;
+  uint64_t h2 = (hash >> 32) | 1;
+  int64_t estimate = INT64_MAX;
+  for (int i = 0; i < kDepth; ++i) {
+    auto& counter = counters_[i][(h1 + i * h2) % kWidth];
+    counter += count;
+    estimate = std::min(estimate, counter);
+  }
+  return estimate;
+}
+
+int64_t CountMinSketch::Estimate(const std::string& key) const {
+  uint64_t hash = std::hash<std::string>{}(key);
+  uint64_t h1 = hash & 0xffffffff;
+  uint64_t h2 = (hash >> 32) | 1;
+  int64_t estimate = INT64_MAX;
+  for (int i = 0; i < kDepth; ++i) {
+    estimate = std::min(estimate, counters_[i][(h1 + i * h2) % kWidth]);
+  }
+  return estimate;
+}
+
+void CountMinSketch::Clear() {
+  for (auto& row : counters_) {
+    row.fill(0);
+  }
+}
+
+void RegionLoad::Record(const std::string& key, bool is_write, int64_t count, int64_t bytes) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (is_write) {
+    write_count_ += count;
+    write_bytes_ += bytes;
+  } else {
+    read_count_ += count;
+    read_bytes_ += bytes;
+  }
+
+  if (FLAGS_load_split_hot_key_num > 0) {
+    UpdateHotKeys(key, sketch_.Add(key, count));
+  }
+
+  // reservoir sampling
+  ++sample_count_;
+  if (static_cast<int64_t>(samples_.size()) < FLAGS_load_split_max_sample_keys) {
+    samples_.push_back(Sample{key, is_write});
+    return;
+  }
+  int64_t pos = std::uniform_int_distribution<int64_t>(0, sample_count_ - 1)(rng_);
+  if (pos < static_cast<int64_t>(samples_.size())) {
+    samples_[pos] = Sample{key, is_write};
+  }
+}
+
+void RegionLoad::RecordBytes(bool is_write, int64_t bytes) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (is_write) {
+    write_bytes_ += bytes;
+  } else {
+    read_bytes_ += bytes;
+  }
+}
+
+// Keep the top n keys by estimated count, the key with min count is replaced by a hotter one.
+void RegionLoad::UpdateHotKeys(const std::string& key, int64_t estimate_count) {
+  auto it = hot_key_counts_.find(key);
+  if (it != hot_key_counts_.end()) {
+    it->second = estimate_count;
+    return;
+  }
+  if (static_cast<int32_t>(hot_key_counts_.size()) < FLAGS_load_split_hot_key_num) {
+    hot_key_counts_.emplace(key, estimate_count);
+    return;
+  }
+
+  auto min_it = std::min_element(hot_key_counts_.begin(), hot_key_counts_.end(),
+                                 [](const auto& lhs, const auto& rhs) { return lhs.second < rhs.second; });
+  if (estimate_count > min_it->second) {
+    hot_key_counts_.erase(min_it);
+    hot_key_counts_.emplace(key, estimate_count);
+  }
+}
+
+void RegionLoad::Statistic(int64_t now_ms, int64_t sample_rate_inverse, int32_t bucket_num, int64_t hot_qps) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  int64_t elapsed_ms = now_ms - window_start_ms_;
+  if (window_start_ms_ == 0 || elapsed_ms <= 0) {
+    window_start_ms_ = now_ms;
+    return;
+  }
+
+  read_qps_ = read_count_ * sample_rate_inverse * 1000 / elapsed_ms;
+  write_qps_ = write_count_ * sample_rate_inverse * 1000 / elapsed_ms;
+  read_bytes_per_second_ = read_bytes_ * sample_rate_inverse * 1000 / elapsed_ms;
+  write_bytes_per_second_ = write_bytes_ * sample_rate_inverse * 1000 / elapsed_ms;
+
+  hot_keys_.clear();
+  for (const auto& [key, count] : hot_key_counts_) {
+    pb::common::RegionHotKey hot_key;
+    hot_key.set_key(key);
+    hot_key.set_qps(count * sample_rate_inverse * 1000 / elapsed_ms);
+    hot_keys_.push_back(hot_key);
+  }
+  std::sort(hot_keys_.begin(), hot_keys_.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.qps() > rhs.qps(); });
+
+  std::sort(samples_.begin(), samples_.end(), [](const Sample& lhs, const Sample& rhs) { return lhs.key < rhs.key; });
+  median_key_ = samples_.empty() ? "" : samples_[samples_.size() / 2].key;
+  hot_count_ = (read_qps_ + write_qps_ >= hot_qps) ? hot_count_ + 1 : 0;
+
+  // Every bucket has the same sample count, so the same load.
+  buckets_.clear();
+  int64_t total_qps = read_qps_ + write_qps_;
+  size_t bucket_size = std::max(static_cast<size_t>(1), samples_.size() / std::max(1, bucket_num));
+  for (size_t i = 0; i < samples_.size(); i += bucket_size) {
+    size_t end = std::min(samples_.size(), i + bucket_size);
+    int64_t write_samples = std::count_if(samples_.begin() + i, samples_.begin() + end,
+                                          [](const Sample& sample) { return sample.is_write; });
+
+    pb::common::RegionLoadBucket bucket;
+    bucket.set_start_key(samples_[i].key);
+    if (end < samples_.size()) {
+      bucket.set_end_key(samples_[end].key);
+    }
+    bucket.set_write_qps(total_qps * write_samples / samples_.size());
+    bucket.set_read_qps(total_qps * (end - i - write_samples) / samples_.size());
+    buckets_.push_back(bucket);
+  }
+
+  window_start_ms_ = now_ms;
+  read_count_ = 0;
+  write_count_ = 0;
+  read_bytes_ = 0;
+  write_bytes_ = 0;
+  sample_count_ = 0;
+  samples_.clear();
+  sketch_.Clear();
+  hot_key_counts_.clear();
+}
+
+int64_t RegionLoad::ReadQps() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return read_qps_;
+}
+
+int64_t RegionLoad::WriteQps() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return write_qps_;
+}
+
+int64_t RegionLoad::ReadBytesPerSecond() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return read_bytes_per_second_;
+}
+
+int64_t RegionLoad::WriteBytesPerSecond() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return write_bytes_per_second_;
+}
+
+std::string RegionLoad::MedianKey() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return median_key_;
+}
+
+int32_t RegionLoad::HotCount() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return hot_count_;
+}
+
+void RegionLoad::SetHotCount(int32_t hot_count) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  hot_count_ = hot_count;
+}
+
+std::vector<pb::common::RegionLoadBucket> RegionLoad::Buckets() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return buckets_;
+}
+
+std::vector<pb::common::RegionHotKey> RegionLoad::HotKeys() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return hot_keys_;
+}
+
+RegionLoadStatistics& RegionLoadStatistics::GetInstance() {
+  static RegionLoadStatistics instance;
+  return instance;
+}
+
+void RegionLoadStatistics::RecordRead(int64_t region_id, const std::string& key, int64_t count) {
+  Record(region_id, key, false, count, 0);
+}
+
+void RegionLoadStatistics::RecordWrite(int64_t region_id, const std::string& key, int64_t count, int64_t bytes) {
+  Record(region_id, key, true, count, bytes);
+}
+
+void RegionLoadStatistics::RecordReadBytes(int64_t region_id, int64_t bytes) {
+  if (!FLAGS_enable_load_split || !ShouldSample()) {
+    return;
+  }
+
+  GetOrCreateRegionLoad(region_id)->RecordBytes(false, bytes);
+}
+
+bool RegionLoadStatistics::ShouldSample() {
+  return FLAGS_load_split_sample_rate_inverse <= 1 ||
+         butil::fast_rand_less_than(FLAGS_load_split_sample_rate_inverse) == 0;
+}
+
+RegionLoadPtr RegionLoadStatistics::GetOrCreateRegionLoad(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto& load = region_loads_[region_id];
+  if (load == nullptr) {
+    load = std::make_shared<RegionLoad>();
+  }
+  return load;
+}
+
+void RegionLoadStatistics::Record(int64_t region_id, const std::string& key, bool is_write, int64_t count,
+                                  int64_t bytes) {
+  if (!FLAGS_enable_load_split || !ShouldSample()) {
+    return;
+  }
+
+  GetOrCreateRegionLoad(region_id)->Record(key, is_write, count, bytes);
+}
+
+void RegionLoadStatistics::Statistic(const std::vector<int64_t>& alive_region_ids) {
+  std::set<int64_t> alive_ids(alive_region_ids.begin(), alive_region_ids.end());
+  std::vector<RegionLoadPtr> region_loads;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    for (auto it = region_loads_.begin(); it != region_loads_.end();) {
+      if (alive_ids.find(it->first) == alive_ids.end()) {
+        it = region_loads_.erase(it);
+      } else {
+        region_loads.push_back(it->second);
+        ++it;
+      }
+    }
+  }
+
+  int64_t now_ms = Helper::TimestampMs();
+  int64_t sample_rate_inverse = std::max(static_cast<int64_t>(1), FLAGS_load_split_sample_rate_inverse);
+  for (auto& region_load : region_loads) {
+    region_load->Statistic(now_ms, sample_rate_inverse, FLAGS_load_split_bucket_num, FLAGS_load_split_qps_threshold);
+  }
+}
+
+bool RegionLoadStatistics::IsHot(int64_t region_id) {
+  if (!FLAGS_enable_load_split) {
+    return false;
+  }
+
+  auto region_load = GetRegionLoad(region_id);
+  return region_load != nullptr && region_load->HotCount() >= FLAGS_load_split_hot_window_count;
+}
+
+RegionLoadPtr RegionLoadStatistics::GetRegionLoad(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = region_loads_.find(region_id);
+  return it == region_loads_.end() ? nullptr : it->second;
+}
+
+}  // namespace dingodb
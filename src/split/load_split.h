@@ -0,0 +1,144 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SPLIT_LOAD_SPLIT_H_  // NOLINT
+#define DINGODB_SPLIT_LOAD_SPLIT_H_
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Count-min sketch for estimating the frequency of keys with fixed memory.
+// The estimate is never less than the real count, and exceeds it by a small error with high probability.
+class CountMinSketch {
+ public:
+  CountMinSketch() { Clear(); }
+  ~CountMinSketch() = default;
+
+  // Add count to key and return the estimated count of key.
+  int64_t Add(const std::string& key, int64_t count);
+  int64_t Estimate(const std::string& key) const;
+  void Clear();
+
+ private:
+  static constexpr int kDepth = 4;
+  static constexpr int kWidth = 256;
+
+  std::array<std::array<int64_t, kWidth>, kDepth> counters_;
+};
+
+// Read/write load of a region in a statistic window.
+// The requests are sampled, keys of sampled requests are kept by reservoir sampling.
+class RegionLoad {
+ public:
+  RegionLoad() : rng_(std::random_device{}()) {}
+  ~RegionLoad() = default;
+
+  void Record(const std::string& key, bool is_write, int64_t count, int64_t bytes);
+  void RecordBytes(bool is_write, int64_t bytes);
+
+  // Finish the window, compute qps and load buckets, then start a new window.
+  // The window is hot if qps reach hot_qps.
+  void Statistic(int64_t now_ms, int64_t sample_rate_inverse, int32_t bucket_num, int64_t hot_qps);
+
+  int64_t ReadQps();
+  int64_t WriteQps();
+  int64_t ReadBytesPerSecond();
+  int64_t WriteBytesPerSecond();
+  // The key which split the load of region half and half, empty if no load.
+  std::string MedianKey();
+  // Continuous hot window count.
+  int32_t HotCount();
+  void SetHotCount(int32_t hot_count);
+
+  std::vector<pb::common::RegionLoadBucket> Buckets();
+  // Top hot keys of last window, order by qps desc.
+  std::vector<pb::common::RegionHotKey> HotKeys();
+
+ private:
+  void UpdateHotKeys(const std::string& key, int64_t estimate_count);
+
+  struct Sample {
+    std::string key;
+    bool is_write;
+  };
+
+  bthread::Mutex mutex_;
+  int64_t window_start_ms_{0};
+  int64_t read_count_{0};
+  int64_t write_count_{0};
+  int64_t read_bytes_{0};
+  int64_t write_bytes_{0};
+  int64_t sample_count_{0};
+  std::vector<Sample> samples_;
+  std::mt19937_64 rng_;
+  // Candidates of hot keys and their estimated sampled count.
+  CountMinSketch sketch_;
+  std::map<std::string, int64_t> hot_key_counts_;
+
+  // Result of last window.
+  int64_t read_qps_{0};
+  int64_t write_qps_{0};
+  int64_t read_bytes_per_second_{0};
+  int64_t write_bytes_per_second_{0};
+  std::string median_key_;
+  int32_t hot_count_{0};
+  std::vector<pb::common::RegionLoadBucket> buckets_;
+  std::vector<pb::common::RegionHotKey> hot_keys_;
+};
+using RegionLoadPtr = std::shared_ptr<RegionLoad>;
+
+// Load statistics of all regions, for load based split and reporting load buckets to coordinator.
+class RegionLoadStatistics {
+ public:
+  static RegionLoadStatistics& GetInstance();
+
+  // Called in the service hot path, only 1/load_split_sample_rate_inverse requests are recorded.
+  void RecordRead(int64_t region_id, const std::string& key, int64_t count = 1);
+  // bytes is the estimated total bytes of the request, usually the sampled kv size multiply count.
+  void RecordWrite(int64_t region_id, const std::string& key, int64_t count = 1, int64_t bytes = 0);
+  // Read bytes are only known after reading, so recorded separately.
+  void RecordReadBytes(int64_t region_id, int64_t bytes);
+
+  // Statistic all region loads, not exist region is removed.
+  void Statistic(const std::vector<int64_t>& alive_region_ids);
+
+  RegionLoadPtr GetRegionLoad(int64_t region_id);
+
+  // Region is hot for load_split_hot_window_count continuous windows.
+  bool IsHot(int64_t region_id);
+
+ private:
+  RegionLoadStatistics() = default;
+
+  static bool ShouldSample();
+  RegionLoadPtr GetOrCreateRegionLoad(int64_t region_id);
+  void Record(int64_t region_id, const std::string& key, bool is_write, int64_t count, int64_t bytes);
+
+  bthread::Mutex mutex_;
+  std::map<int64_t, RegionLoadPtr> region_loads_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_SPLIT_LOAD_SPLIT_H_  // NOLINT
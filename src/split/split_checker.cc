@@ -23,21 +23,35 @@
 #include <string_view>
 #include <vector>
 
+#include "bthread/bthread.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "config/config_helper.h"
 #include "engine/iterator.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
 #include "proto/raft.pb.h"
 #include "server/server.h"
 #include "server/service_helper.h"
+#include "split/load_split.h"
+#include "vector/codec.h"
 #include "vector/vector_index_manager.h"
 
 namespace dingodb {
 
+DEFINE_int64(split_check_scan_rate_limit_mb, 0, "max scan rate(MB/s) of every region split check, 0 means no limit");
+DEFINE_int32(split_check_approximate_min_boundary_keys, 4,
+             "APPROXIMATE split policy fallback to scan when region has less sst boundary keys");
+DEFINE_bool(enable_split_index_region_by_vector_index, false,
+            "split index region when vector index exceed memory or element limit, regardless of data size");
+DEFINE_double(split_index_region_memory_ratio, 0.8,
+              "split index region when vector index memory exceed ratio of max_hnsw_memory_size_of_region");
+
+DECLARE_int64(max_hnsw_memory_size_of_region);
+
 MergedIterator::MergedIterator(RawEnginePtr raw_engine, const std::vector<std::string>& cf_names,
                                const std::string& end_key)
     : raw_engine_(raw_engine) {
@@ -88,11 +102,35 @@ void MergedIterator::Next(IteratorPtr iter, int iter_pos) {
     entry.iter_pos = iter_pos;
     entry.key = iter->Key();
     entry.value_size = iter->Value().size();
+    Throttle(entry.key.size() + entry.value_size);
     min_heap_.push(entry);
     iter->Next();
   }
 }
 
+void MergedIterator::Throttle(uint32_t size) {
+  if (FLAGS_split_check_scan_rate_limit_mb <= 0) {
+    return;
+  }
+
+  if (start_time_ms_ == 0) {
+    start_time_ms_ = Helper::TimestampMs();
+  }
+  scanned_size_ += size;
+  unchecked_size_ += size;
+  // check every 1MB
+  if (unchecked_size_ < 1024 * 1024) {
+    return;
+  }
+  unchecked_size_ = 0;
+
+  int64_t expect_time_ms = scanned_size_ * 1000 / (FLAGS_split_check_scan_rate_limit_mb * 1024 * 1024);
+  int64_t elapsed_time_ms = Helper::TimestampMs() - start_time_ms_;
+  if (expect_time_ms > elapsed_time_ms) {
+    bthread_usleep((expect_time_ms - elapsed_time_ms) * 1000);
+  }
+}
+
 // base physics key, contain key of multi version.
 std::string HalfSplitChecker::SplitKey(store::RegionPtr region, const pb::common::Range& physical_range,
                                        const std::vector<std::string>& cf_names, uint32_t& count) {
@@ -225,6 +263,164 @@ std::string KeysSplitChecker::SplitKey(store::RegionPtr region, const pb::common
   return is_split ? split_key : "";
 }
 
+int64_t ApproximateSplitChecker::ApproximateSize(const std::vector<std::string>& cf_names,
+                                                 const std::string& start_key, const std::string& end_key) {
+  std::vector<pb::common::Range> ranges(1);
+  ranges[0].set_start_key(start_key);
+  ranges[0].set_end_key(end_key);
+
+  int64_t size = 0;
+  for (const auto& cf_name : cf_names) {
+    auto sizes = raw_engine_->GetApproximateSizes(cf_name, ranges);
+    if (!sizes.empty()) {
+      size += sizes[0];
+    }
+  }
+
+  return size;
+}
+
+std::string ApproximateSplitChecker::SplitKey(store::RegionPtr region, const pb::common::Range& physical_range,
+                                              const std::vector<std::string>& cf_names, uint32_t& count) {
+  if (cf_names.empty()) {
+    return "";
+  }
+
+  int64_t total_size = ApproximateSize(cf_names, physical_range.start_key(), physical_range.end_key());
+  if (total_size < split_size_) {
+    DINGO_LOG(INFO) << fmt::format(
+        "[split.check][region({})] policy(APPROXIMATE) split_size({}) split_ratio({}) approximate_size({})",
+        region->Id(), split_size_, split_ratio_, total_size);
+    return "";
+  }
+
+  // The first column family is the data column family, whose key can be the split key.
+  std::vector<std::string> keys;
+  auto status = raw_engine_->GetSstFileBoundaryKeys(cf_names[0], physical_range, keys);
+  if (!status.ok() || static_cast<int32_t>(keys.size()) < FLAGS_split_check_approximate_min_boundary_keys) {
+    DINGO_LOG(INFO) << fmt::format(
+        "[split.check][region({})] policy(APPROXIMATE) boundary keys({}) too few or error({}), fallback to scan.",
+        region->Id(), keys.size(), status.error_str());
+    SizeSplitChecker checker(raw_engine_, split_size_, split_ratio_);
+    return checker.SplitKey(region, physical_range, cf_names, count);
+  }
+
+  // The first boundary key that the size before it reach the split position.
+  int64_t split_pos = total_size * split_ratio_;
+  size_t left = 0;
+  size_t right = keys.size() - 1;
+  while (left < right) {
+    size_t mid = left + (right - left) / 2;
+    if (ApproximateSize(cf_names, physical_range.start_key(), keys[mid]) >= split_pos) {
+      right = mid;
+    } else {
+      left = mid + 1;
+    }
+  }
+  std::string split_key = keys[left];
+
+  // Is transaction, truncate key ts.
+  if (Helper::IsClientTxn(region->Range().start_key()) || Helper::IsExecutorTxn(region->Range().start_key())) {
+    split_key = Helper::GetUserKeyFromTxnKey(split_key);
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[split.check][region({})] policy(APPROXIMATE) split_size({}) split_ratio({}) approximate_size({}) "
+      "boundary_keys({}) split_key({})",
+      region->Id(), split_size_, split_ratio_, total_size, keys.size(), Helper::StringToHex(split_key));
+
+  return split_key;
+}
+
+std::string LoadSplitChecker::SplitKey(store::RegionPtr region, const pb::common::Range& /*physical_range*/,
+                                       const std::vector<std::string>& /*cf_names*/, uint32_t& /*count*/) {
+  auto region_load = RegionLoadStatistics::GetInstance().GetRegionLoad(region->Id());
+  if (region_load == nullptr) {
+    return "";
+  }
+
+  std::string split_key = region_load->MedianKey();
+  // Split at the start key make a empty region.
+  if (split_key == region->Range().start_key()) {
+    split_key.clear();
+  }
+  // Wait for the next hot windows, the load of children is different.
+  region_load->SetHotCount(0);
+
+  DINGO_LOG(INFO) << fmt::format("[split.check][region({})] policy(LOAD) read_qps({}) write_qps({}) split_key({})",
+                                 region->Id(), region_load->ReadQps(), region_load->WriteQps(),
+                                 Helper::StringToHex(split_key));
+
+  return split_key;
+}
+
+static bool IsVectorIndexBusy(VectorIndexWrapperPtr vector_index_wrapper) {
+  return !vector_index_wrapper->IsReady() || vector_index_wrapper->RebuildingNum() > 0 ||
+         vector_index_wrapper->IsSwitchingVectorIndex();
+}
+
+bool IndexSplitChecker::IsExceedsLimit(store::RegionPtr region) {
+  if (!FLAGS_enable_split_index_region_by_vector_index || region->Type() != pb::common::INDEX_REGION) {
+    return false;
+  }
+
+  auto vector_index_wrapper = region->VectorIndexWrapper();
+  if (vector_index_wrapper == nullptr || IsVectorIndexBusy(vector_index_wrapper)) {
+    return false;
+  }
+
+  if (vector_index_wrapper->IsExceedsMaxElements()) {
+    return true;
+  }
+
+  int64_t memory_size = 0;
+  auto status = vector_index_wrapper->GetMemorySize(memory_size);
+  if (!status.ok()) {
+    return false;
+  }
+
+  return memory_size >= FLAGS_max_hnsw_memory_size_of_region * FLAGS_split_index_region_memory_ratio;
+}
+
+std::string IndexSplitChecker::SplitKey(store::RegionPtr region, const pb::common::Range& /*physical_range*/,
+                                        const std::vector<std::string>& /*cf_names*/, uint32_t& /*count*/) {
+  auto vector_index_wrapper = region->VectorIndexWrapper();
+  if (vector_index_wrapper == nullptr || IsVectorIndexBusy(vector_index_wrapper)) {
+    return "";
+  }
+
+  auto storage = Server::GetInstance().GetStorage();
+  int64_t min_vector_id = 0;
+  int64_t max_vector_id = 0;
+  auto status = storage->VectorGetBorderId(region, true, min_vector_id);
+  if (!status.ok()) {
+    return "";
+  }
+  status = storage->VectorGetBorderId(region, false, max_vector_id);
+  if (!status.ok()) {
+    return "";
+  }
+  const auto& start_key = region->Range().start_key();
+  if (max_vector_id <= min_vector_id || start_key.empty()) {
+    return "";
+  }
+
+  // left child has [min, mid), right child has [mid, max].
+  int64_t mid_vector_id = min_vector_id + (max_vector_id - min_vector_id) / 2 + 1;
+  std::string split_key;
+  VectorCodec::EncodeVectorKey(start_key[0], VectorCodec::DecodePartitionId(start_key), mid_vector_id, split_key);
+
+  int64_t memory_size = 0;
+  vector_index_wrapper->GetMemorySize(memory_size);
+  DINGO_LOG(INFO) << fmt::format(
+      "[split.check][region({})] policy(INDEX) memory_size({}/{}) exceeds_max_elements({}) vector_id([{}-{}]) "
+      "split_key({})",
+      region->Id(), memory_size, FLAGS_max_hnsw_memory_size_of_region, vector_index_wrapper->IsExceedsMaxElements(),
+      min_vector_id, max_vector_id, Helper::StringToHex(split_key));
+
+  return split_key;
+}
+
 static bool CheckLeaderAndFollowerStatus(int64_t region_id) {
   auto raft_store_engine = Server::GetInstance().GetRaftStoreEngine();
   if (raft_store_engine == nullptr) {
@@ -436,6 +632,11 @@ static std::shared_ptr<SplitChecker> BuildSplitChecker(std::shared_ptr<RawEngine
     uint32_t split_key_number = ConfigHelper::GetSplitKeysNumber();
     float split_keys_ratio = ConfigHelper::GetSplitKeysRatio();
     return std::make_shared<KeysSplitChecker>(raw_engine, split_key_number, split_keys_ratio);
+
+  } else if (policy == "APPROXIMATE") {
+    int64_t split_threshold_size = ConfigHelper::GetRegionMaxSize();
+    float split_ratio = ConfigHelper::GetSplitSizeRatio();
+    return std::make_shared<ApproximateSplitChecker>(raw_engine, split_threshold_size, split_ratio);
   }
 
   DINGO_LOG(ERROR) << fmt::format("[split.check] build split checker failed, policy {}", policy);
@@ -458,6 +659,8 @@ void PreSplitCheckTask::PreSplitCheck() {
   for (auto& region : regions) {
     auto region_metric = metrics->GetMetrics(region->Id());
     bool need_scan_check = true;
+    bool is_load_split = false;
+    bool is_index_split = false;
     std::string reason;
     do {
       if (region_metric == nullptr) {
@@ -495,10 +698,17 @@ void PreSplitCheckTask::PreSplitCheck() {
         reason = "not leader or follower abnormal";
         break;
       }
-      if (region_metric->InnerRegionMetrics().region_size() < split_check_approximate_size) {
-        need_scan_check = false;
-        reason = "region approximate size too small";
-        break;
+      if (IndexSplitChecker::IsExceedsLimit(region)) {
+        // Index region is limited by vector index before data size, writes are rejected when exceed max elements.
+        is_index_split = true;
+      } else if (region_metric->InnerRegionMetrics().region_size() < split_check_approximate_size) {
+        // Small but hot region split by load.
+        if (!RegionLoadStatistics::GetInstance().IsHot(region->Id())) {
+          need_scan_check = false;
+          reason = "region approximate size too small";
+          break;
+        }
+        is_load_split = true;
       }
       int runing_num = VectorIndexManager::GetVectorIndexTaskRunningNum();
       if (runing_num > Constant::kVectorIndexTaskRunningNumExpectValue) {
@@ -524,7 +734,14 @@ void PreSplitCheckTask::PreSplitCheck() {
       continue;
     }
 
-    auto split_checker = BuildSplitChecker(raw_engine);
+    std::shared_ptr<SplitChecker> split_checker;
+    if (is_index_split) {
+      split_checker = std::make_shared<IndexSplitChecker>();
+    } else if (is_load_split) {
+      split_checker = std::make_shared<LoadSplitChecker>();
+    } else {
+      split_checker = BuildSplitChecker(raw_engine);
+    }
     if (split_checker == nullptr) {
       continue;
     }
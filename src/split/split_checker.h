@@ -53,8 +53,13 @@ class MergedIterator {
 
  private:
   void Next(IteratorPtr iter, int iter_pos);
+  // Limit the scan rate by split_check_scan_rate_limit_mb.
+  void Throttle(uint32_t size);
 
   RawEnginePtr raw_engine_;
+  int64_t start_time_ms_{0};
+  int64_t scanned_size_{0};
+  int64_t unchecked_size_{0};
   std::vector<IteratorPtr> iters_;
   std::priority_queue<Entry, std::vector<Entry>, Entry> min_heap_;
 };
@@ -65,6 +70,9 @@ class SplitChecker {
     kHalf = 0,
     kSize = 1,
     kKeys = 2,
+    kApproximate = 3,
+    kLoad = 4,
+    kIndex = 5,
   };
 
   SplitChecker(Policy policy) : policy_(policy) {}
@@ -79,6 +87,12 @@ class SplitChecker {
       return "SIZE";
     } else if (policy_ == Policy::kKeys) {
       return "KEYS";
+    } else if (policy_ == Policy::kApproximate) {
+      return "APPROXIMATE";
+    } else if (policy_ == Policy::kLoad) {
+      return "LOAD";
+    } else if (policy_ == Policy::kIndex) {
+      return "INDEX";
     }
     return "";
   };
@@ -157,6 +171,59 @@ class KeysSplitChecker : public SplitChecker {
   std::shared_ptr<RawEngine> raw_engine_;
 };
 
+// Split region based approximate size, the split key is one of the sst file boundary keys,
+// found by binary search with the approximate size of rocksdb, no data is scanned.
+// Fallback to SizeSplitChecker when the region has too few sst files, which means the region is small.
+class ApproximateSplitChecker : public SplitChecker {
+ public:
+  ApproximateSplitChecker(std::shared_ptr<RawEngine> raw_engine, int64_t split_size, float split_ratio)
+      : SplitChecker(SplitChecker::Policy::kApproximate),
+        raw_engine_(raw_engine),
+        split_size_(split_size),
+        split_ratio_(split_ratio) {}
+  ~ApproximateSplitChecker() override = default;
+
+  std::string SplitKey(store::RegionPtr region, const pb::common::Range& physical_range,
+                       const std::vector<std::string>& cf_names, uint32_t& count) override;
+
+ private:
+  int64_t ApproximateSize(const std::vector<std::string>& cf_names, const std::string& start_key,
+                          const std::string& end_key);
+
+  // Split when region exceed the split_size.
+  int64_t split_size_;
+  // Split key position.
+  float split_ratio_;
+  std::shared_ptr<RawEngine> raw_engine_;
+};
+
+// Split hot region based read/write load, the split key is the load median key of sampled requests.
+// Used for the hot region whose size is small, no data is scanned.
+class LoadSplitChecker : public SplitChecker {
+ public:
+  LoadSplitChecker() : SplitChecker(SplitChecker::Policy::kLoad) {}
+  ~LoadSplitChecker() override = default;
+
+  // base user key of requests.
+  std::string SplitKey(store::RegionPtr region, const pb::common::Range& physical_range,
+                       const std::vector<std::string>& cf_names, uint32_t& count) override;
+};
+
+// Split index region whose vector index is near the memory or element limit, the split key is the median vector id
+// of the region id range, no data is scanned. Skip when the vector index is rebuilding or switching.
+class IndexSplitChecker : public SplitChecker {
+ public:
+  IndexSplitChecker() : SplitChecker(SplitChecker::Policy::kIndex) {}
+  ~IndexSplitChecker() override = default;
+
+  // Check whether the vector index of region exceed the memory or element limit.
+  static bool IsExceedsLimit(store::RegionPtr region);
+
+  // base vector key.
+  std::string SplitKey(store::RegionPtr region, const pb::common::Range& physical_range,
+                       const std::vector<std::string>& cf_names, uint32_t& count) override;
+};
+
 // Multiple worker run split check task.
 class SplitCheckWorkers {
  public:
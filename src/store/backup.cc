@@ -0,0 +1,287 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "store/backup.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "engine/txn_resolved_ts.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "server/server.h"
+#include "store/sst_ingest.h"
+
+namespace dingodb {
+
+DEFINE_int64(backup_rate_limit_mb, 100, "max MB per second of copying backup and restore files, 0 is no limit");
+DEFINE_int32(backup_max_concurrency, 4, "max running backup and restore region tasks of store");
+
+static const std::string kBackupMetaFileName = "backupmeta";
+static constexpr int64_t kCopyChunkSize = 1024 * 1024;
+
+static std::atomic<int32_t> running_task_count{0};
+
+static bthread::Mutex throttle_mutex;
+// the time the next copied bytes are allowed
+static int64_t throttle_next_time_us = 0;
+
+RegionBackup::TaskGuard::TaskGuard() {
+  if (running_task_count.fetch_add(1) < FLAGS_backup_max_concurrency) {
+    acquired_ = true;
+  } else {
+    running_task_count.fetch_sub(1);
+  }
+}
+
+RegionBackup::TaskGuard::~TaskGuard() {
+  if (acquired_) {
+    running_task_count.fetch_sub(1);
+  }
+}
+
+std::string RegionBackup::GetBackupRegionPath(const std::string& backup_path, int64_t region_id) {
+  return fmt::format("{}/{}", backup_path, region_id);
+}
+
+void RegionBackup::Throttle(int64_t bytes) {
+  if (FLAGS_backup_rate_limit_mb <= 0) {
+    return;
+  }
+
+  int64_t wait_us = 0;
+  {
+    BAIDU_SCOPED_LOCK(throttle_mutex);
+    int64_t now_us = Helper::TimestampUs();
+    throttle_next_time_us =
+        std::max(throttle_next_time_us, now_us) + bytes * 1000000 / (FLAGS_backup_rate_limit_mb * 1024 * 1024);
+    wait_us = throttle_next_time_us - now_us;
+  }
+  if (wait_us > 0) {
+    bthread_usleep(wait_us);
+  }
+}
+
+butil::Status RegionBackup::CopyFile(const std::string& src_path, const std::string& dst_path, int64_t& size) {
+  std::ifstream ifile(src_path, std::ifstream::in | std::ifstream::binary);
+  if (!ifile.is_open()) {
+    return butil::Status(pb::error::EINTERNAL, "Open file %s failed", src_path.c_str());
+  }
+
+  std::string tmp_path = dst_path + ".tmp";
+  std::ofstream ofile(tmp_path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+  if (!ofile.is_open()) {
+    return butil::Status(pb::error::EINTERNAL, "Open file %s failed", tmp_path.c_str());
+  }
+
+  size = 0;
+  std::vector<char> buf(kCopyChunkSize);
+  while (ifile) {
+    ifile.read(buf.data(), buf.size());
+    int64_t read_size = ifile.gcount();
+    if (read_size <= 0) {
+      break;
+    }
+    Throttle(read_size);
+    ofile.write(buf.data(), read_size);
+    if (ofile.fail()) {
+      return butil::Status(pb::error::EINTERNAL, "Write file %s failed", tmp_path.c_str());
+    }
+    size += read_size;
+  }
+  if (ifile.bad()) {
+    return butil::Status(pb::error::EINTERNAL, "Read file %s failed", src_path.c_str());
+  }
+
+  ofile.close();
+  if (ofile.fail()) {
+    return butil::Status(pb::error::EINTERNAL, "Write file %s failed", tmp_path.c_str());
+  }
+
+  return Helper::Rename(tmp_path, dst_path);
+}
+
+butil::Status RegionBackup::BackupCfs(store::RegionPtr region, RawEnginePtr raw_engine,
+                                      const std::vector<std::string>& cf_names, const pb::common::Range& range,
+                                      const std::string& region_backup_path, pb::store::BackupRegionMeta& meta) {
+  std::string checkpoint_path =
+      fmt::format("{}/backup_{}_{}", Server::GetInstance().GetCheckpointPath(), region->Id(), Helper::TimestampNs());
+
+  std::vector<std::string> merge_sst_paths;
+  merge_sst_paths.reserve(cf_names.size());
+  for (const auto& cf_name : cf_names) {
+    merge_sst_paths.push_back(fmt::format("{}/merge_{}.sst", checkpoint_path, cf_name));
+  }
+
+  auto checkpoint = raw_engine->NewCheckpoint();
+  std::vector<pb::store_internal::SstFileInfo> sst_files;
+  auto status = checkpoint->Create(checkpoint_path, cf_names, range, sst_files);
+  if (status.ok()) {
+    // the checkpoint files also have keys out of range, only keys in range are merged.
+    status = raw_engine->MergeCheckpointFiles(checkpoint_path, range, cf_names, merge_sst_paths);
+  }
+
+  for (size_t i = 0; status.ok() && i < cf_names.size(); ++i) {
+    // empty path means no key of the cf in range
+    if (merge_sst_paths[i].empty()) {
+      continue;
+    }
+
+    auto* file = meta.add_files();
+    file->set_cf_name(cf_names[i]);
+    file->set_filename(fmt::format("{}.sst", cf_names[i]));
+    int64_t size = 0;
+    status = CopyFile(merge_sst_paths[i], fmt::format("{}/{}", region_backup_path, file->filename()), size);
+    file->set_size(size);
+  }
+
+  Helper::RemoveAllFileOrDirectory(checkpoint_path);
+  return status;
+}
+
+butil::Status RegionBackup::Backup(store::RegionPtr region, RawEnginePtr raw_engine, int64_t backup_ts,
+                                   const std::string& backup_path, pb::store::BackupRegionMeta& meta) {
+  int64_t start_time = Helper::TimestampMs();
+
+  std::vector<std::string> raw_cf_names;
+  std::vector<std::string> txn_cf_names;
+  Helper::GetColumnFamilyNames(region->Range().start_key(), raw_cf_names, txn_cf_names);
+  // The lock cf is not backed up, every lock with lock_ts <= resolved ts is committed or rolled back.
+  txn_cf_names.erase(std::remove(txn_cf_names.begin(), txn_cf_names.end(), Constant::kTxnLockCF), txn_cf_names.end());
+
+  if (!txn_cf_names.empty()) {
+    int64_t resolved_ts = TxnResolvedTsManager::GetInstance().GetResolvedTs(region->Id());
+    if (resolved_ts < backup_ts) {
+      return butil::Status(pb::error::EBACKUP_TS_NOT_RESOLVED, "Resolved ts %ld is behind backup ts %ld, retry later",
+                           resolved_ts, backup_ts);
+    }
+  }
+
+  std::string region_backup_path = GetBackupRegionPath(backup_path, region->Id());
+  Helper::RemoveAllFileOrDirectory(region_backup_path);
+  auto status = Helper::CreateDirectories(region_backup_path);
+  if (!status.ok()) {
+    return status;
+  }
+
+  meta.set_region_id(region->Id());
+  *meta.mutable_range() = region->Range();
+  *meta.mutable_epoch() = region->Epoch();
+  meta.set_backup_ts(backup_ts);
+
+  if (!raw_cf_names.empty()) {
+    status = BackupCfs(region, raw_engine, raw_cf_names, region->Range(), region_backup_path, meta);
+  }
+  if (status.ok() && !txn_cf_names.empty()) {
+    status = BackupCfs(region, raw_engine, txn_cf_names, Helper::GetMemComparableRange(region->Range()),
+                       region_backup_path, meta);
+  }
+
+  // The epoch may be changed by split or merge while checkpointing.
+  if (status.ok() && !Helper::IsEqualRegionEpoch(meta.epoch(), region->Epoch())) {
+    status = butil::Status(pb::error::EREGION_VERSION, "Region epoch changed while backup, retry later");
+  }
+
+  if (status.ok()) {
+    std::ofstream file(fmt::format("{}/{}", region_backup_path, kBackupMetaFileName),
+                       std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    if (!file.is_open() || !meta.SerializeToOstream(&file)) {
+      status = butil::Status(pb::error::EINTERNAL, "Write backup meta file failed");
+    }
+  }
+
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[backup][region({})] backup failed, path: {} error: {}", region->Id(),
+                                    region_backup_path, Helper::PrintStatus(status));
+    Helper::RemoveAllFileOrDirectory(region_backup_path);
+    return status;
+  }
+
+  int64_t total_size = 0;
+  for (const auto& file : meta.files()) {
+    total_size += file.size();
+  }
+  DINGO_LOG(INFO) << fmt::format("[backup][region({})] backup finish, path: {} backup_ts: {} files: {} size: {}",
+                                 region->Id(), region_backup_path, backup_ts, meta.files_size(), total_size)
+                  << fmt::format(" elapsed time {}ms", Helper::TimestampMs() - start_time);
+
+  return butil::Status();
+}
+
+butil::Status RegionBackup::PrepareRestore(store::RegionPtr region, const std::string& backup_path,
+                                           int64_t backup_region_id,
+                                           std::map<std::string, std::vector<std::string>>& cf_filenames) {
+  std::string region_backup_path = GetBackupRegionPath(backup_path, backup_region_id);
+  std::ifstream file(fmt::format("{}/{}", region_backup_path, kBackupMetaFileName),
+                     std::ifstream::in | std::ifstream::binary);
+  pb::store::BackupRegionMeta meta;
+  if (!file.is_open() || !meta.ParseFromIstream(&file)) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Not found complete backup of region %ld in %s",
+                         backup_region_id, backup_path.c_str());
+  }
+
+  const auto& range = region->Range();
+  if (meta.range().start_key() < range.start_key() || meta.range().end_key() > range.end_key()) {
+    return butil::Status(pb::error::EKEY_OUT_OF_RANGE, "Backup range [%s, %s) is out of region range [%s, %s)",
+                         Helper::StringToHex(meta.range().start_key()).c_str(),
+                         Helper::StringToHex(meta.range().end_key()).c_str(),
+                         Helper::StringToHex(range.start_key()).c_str(), Helper::StringToHex(range.end_key()).c_str());
+  }
+
+  auto status = Helper::CreateDirectories(SstIngestManager::GetIngestPath(region->Id()));
+  if (!status.ok()) {
+    return status;
+  }
+
+  auto cf_names = Helper::GetColumnFamilyNames(range.start_key());
+  for (const auto& backup_file : meta.files()) {
+    if (std::find(cf_names.begin(), cf_names.end(), backup_file.cf_name()) == cf_names.end()) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Backup cf %s is not the cf of region",
+                           backup_file.cf_name().c_str());
+    }
+
+    std::string filename = fmt::format("restore_{}_{}.sst", backup_region_id, backup_file.cf_name());
+    int64_t size = 0;
+    status = CopyFile(fmt::format("{}/{}", region_backup_path, backup_file.filename()),
+                      SstIngestManager::GetIngestFilePath(region->Id(), filename), size);
+    if (!status.ok()) {
+      return status;
+    }
+    if (size != backup_file.size()) {
+      return butil::Status(pb::error::EINTERNAL, "Backup file %s size %ld not match %ld",
+                           backup_file.filename().c_str(), size, backup_file.size());
+    }
+
+    cf_filenames[backup_file.cf_name()].push_back(filename);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[backup][region({})] prepare restore from region {} finish, files: {}",
+                                 region->Id(), backup_region_id, meta.files_size());
+
+  return butil::Status();
+}
+
+}  // namespace dingodb
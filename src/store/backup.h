@@ -0,0 +1,77 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_STORE_BACKUP_H_  // NOLINT
+#define DINGODB_STORE_BACKUP_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "engine/raw_engine.h"
+#include "meta/store_meta_manager.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+// Backup and restore of region by sst files, not by scan.
+// Backup: the leader creates a range checkpoint of region, merges the checkpoint files into one sst per cf which
+// only has the keys of region range, and copies them to backup_path/region_id with rate limit. The meta file is
+// written at last.
+// Restore: the leader copies the backup files into the ingest path of the new region, then they are ingested by
+// raft like the bulk load of SstIngestManager.
+// The tasks of store share the rate limit of copying files and the max concurrency.
+class RegionBackup {
+ public:
+  static std::string GetBackupRegionPath(const std::string& backup_path, int64_t region_id);
+
+  static butil::Status Backup(store::RegionPtr region, RawEnginePtr raw_engine, int64_t backup_ts,
+                              const std::string& backup_path, pb::store::BackupRegionMeta& meta);
+
+  // Copy the backup files to the ingest path of region, the ingest filenames are grouped by cf.
+  static butil::Status PrepareRestore(store::RegionPtr region, const std::string& backup_path,
+                                      int64_t backup_region_id,
+                                      std::map<std::string, std::vector<std::string>>& cf_filenames);
+
+  // Limit the running backup and restore tasks of store.
+  class TaskGuard {
+   public:
+    TaskGuard();
+    ~TaskGuard();
+
+    TaskGuard(const TaskGuard&) = delete;
+    TaskGuard& operator=(const TaskGuard&) = delete;
+
+    bool IsAcquired() const { return acquired_; }
+
+   private:
+    bool acquired_{false};
+  };
+
+ private:
+  // Checkpoint the cfs of the same range encoding and save the merged sst files of them.
+  static butil::Status BackupCfs(store::RegionPtr region, RawEnginePtr raw_engine,
+                                 const std::vector<std::string>& cf_names, const pb::common::Range& range,
+                                 const std::string& region_backup_path, pb::store::BackupRegionMeta& meta);
+
+  // Copy with the rate limit, write to a temp file and rename it.
+  static butil::Status CopyFile(const std::string& src_path, const std::string& dst_path, int64_t& size);
+  static void Throttle(int64_t bytes);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_STORE_BACKUP_H_  // NOLINT
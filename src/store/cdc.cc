@@ -0,0 +1,427 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "store/cdc.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "butil/iobuf.h"
+#include "butil/time.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/synchronization.h"
+#include "engine/txn_resolved_ts.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "server/server.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_cdc, false, "enable change data capture stream of region");
+DEFINE_int64(cdc_region_buffer_max_events, 100000, "max buffered change events of region, the oldest are evicted");
+DEFINE_int64(cdc_stream_max_events_per_response, 1024, "max change events of a cdc stream response");
+DEFINE_int64(cdc_stream_heartbeat_interval_ms, 1000, "interval of cdc stream watermark heartbeat without change");
+DEFINE_int64(cdc_stream_max_buf_size, 4 * 1024 * 1024, "flow control window bytes of cdc stream");
+DEFINE_int64(cdc_stream_write_timeout_ms, 60000, "cdc stream is closed if not writable in the time");
+
+class CdcManager::Handler : public brpc::StreamInputHandler {
+ public:
+  explicit Handler(SubscriberPtr subscriber) : subscriber_(subscriber) {}
+
+  int on_received_messages(brpc::StreamId /*id*/, butil::IOBuf* const /*messages*/[], size_t /*size*/) override {
+    return 0;
+  }
+
+  void on_idle_timeout(brpc::StreamId /*id*/) override {}
+
+  void on_closed(brpc::StreamId /*id*/) override {
+    subscriber_->closed.store(true, std::memory_order_relaxed);
+    subscriber_->buffer->cond.notify_all();
+    delete this;
+  }
+
+ private:
+  SubscriberPtr subscriber_;
+};
+
+CdcManager& CdcManager::GetInstance() {
+  static CdcManager instance;
+  return instance;
+}
+
+bool CdcManager::IsCaptured(int64_t region_id) { return GetBuffer(region_id) != nullptr; }
+
+CdcManager::BufferPtr CdcManager::GetBuffer(int64_t region_id) {
+  if (buffer_count_.load(std::memory_order_relaxed) == 0) {
+    return nullptr;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = buffers_.find(region_id);
+  return it == buffers_.end() ? nullptr : it->second;
+}
+
+CdcManager::BufferPtr CdcManager::GetOrCreateBuffer(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = buffers_.find(region_id);
+  if (it != buffers_.end()) {
+    return it->second;
+  }
+
+  auto buffer = std::make_shared<Buffer>();
+  buffer->region_id = region_id;
+  // the logs applied before are not captured.
+  auto raft_meta = Server::GetInstance().GetRaftMeta(region_id);
+  buffer->complete_log_id = (raft_meta != nullptr ? raft_meta->AppliedId() : 0) + 1;
+
+  buffers_.emplace(region_id, buffer);
+  buffer_count_.store(buffers_.size(), std::memory_order_relaxed);
+
+  DINGO_LOG(INFO) << fmt::format("[cdc][region({})] start capture from log {}.", region_id, buffer->complete_log_id);
+  return buffer;
+}
+
+void CdcManager::Remove(int64_t region_id) {
+  BufferPtr buffer;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = buffers_.find(region_id);
+    if (it == buffers_.end()) {
+      return;
+    }
+    buffer = it->second;
+    buffers_.erase(it);
+    buffer_count_.store(buffers_.size(), std::memory_order_relaxed);
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(buffer->mutex);
+    buffer->removed = true;
+    buffer->events.clear();
+  }
+  buffer->cond.notify_all();
+
+  DINGO_LOG(INFO) << fmt::format("[cdc][region({})] stop capture.", region_id);
+}
+
+void CdcManager::Append(int64_t region_id, std::vector<pb::store::CdcEvent>& events) {
+  if (events.empty()) {
+    return;
+  }
+  auto buffer = GetBuffer(region_id);
+  if (buffer == nullptr) {
+    return;
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(buffer->mutex);
+    if (buffer->removed) {
+      return;
+    }
+    for (auto& event : events) {
+      buffer->events.push_back(std::move(event));
+    }
+    while (static_cast<int64_t>(buffer->events.size()) > FLAGS_cdc_region_buffer_max_events) {
+      // the log may still have events in buffer, but it is not complete.
+      buffer->complete_log_id = buffer->events.front().log_id() + 1;
+      buffer->events.pop_front();
+      ++buffer->first_seq;
+    }
+  }
+  buffer->cond.notify_all();
+}
+
+void CdcManager::CapturePut(int64_t region_id, int64_t log_id, const std::string& cf_name,
+                            const google::protobuf::RepeatedPtrField<pb::common::KeyValue>& kvs) {
+  if (cf_name != Constant::kStoreDataCF || !IsCaptured(region_id)) {
+    return;
+  }
+
+  std::vector<pb::store::CdcEvent> events;
+  events.reserve(kvs.size());
+  for (const auto& kv : kvs) {
+    auto& event = events.emplace_back();
+    event.set_type(pb::store::CdcEvent::PUT);
+    event.set_log_id(log_id);
+    event.set_key(kv.key());
+    event.set_value(kv.value());
+  }
+  Append(region_id, events);
+}
+
+void CdcManager::CaptureDelete(int64_t region_id, int64_t log_id, const std::string& cf_name,
+                               const google::protobuf::RepeatedPtrField<std::string>& keys) {
+  if (cf_name != Constant::kStoreDataCF || !IsCaptured(region_id)) {
+    return;
+  }
+
+  std::vector<pb::store::CdcEvent> events;
+  events.reserve(keys.size());
+  for (const auto& key : keys) {
+    auto& event = events.emplace_back();
+    event.set_type(pb::store::CdcEvent::DELETE);
+    event.set_log_id(log_id);
+    event.set_key(key);
+  }
+  Append(region_id, events);
+}
+
+void CdcManager::CaptureDeleteRange(int64_t region_id, int64_t log_id, const std::string& cf_name,
+                                    const google::protobuf::RepeatedPtrField<pb::common::Range>& ranges) {
+  if (cf_name != Constant::kStoreDataCF || !IsCaptured(region_id)) {
+    return;
+  }
+
+  std::vector<pb::store::CdcEvent> events;
+  events.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    auto& event = events.emplace_back();
+    event.set_type(pb::store::CdcEvent::DELETE_RANGE);
+    event.set_log_id(log_id);
+    event.set_key(range.start_key());
+    event.set_end_key(range.end_key());
+  }
+  Append(region_id, events);
+}
+
+void CdcManager::CaptureTxnCommit(int64_t region_id, int64_t log_id, RawEnginePtr engine,
+                                  const std::vector<pb::common::KeyValue>& write_kvs) {
+  if (!IsCaptured(region_id)) {
+    return;
+  }
+
+  std::vector<pb::store::CdcEvent> events;
+  auto reader = engine->Reader();
+  for (const auto& kv : write_kvs) {
+    pb::store::WriteInfo write_info;
+    if (!write_info.ParseFromString(kv.value())) {
+      DINGO_LOG(ERROR) << fmt::format("[cdc][region({})] parse write info failed, key: {}", region_id,
+                                      Helper::StringToHex(kv.key()));
+      continue;
+    }
+    // rollback and lock are not data change.
+    if (write_info.op() != pb::store::Op::Put && write_info.op() != pb::store::Op::PutIfAbsent &&
+        write_info.op() != pb::store::Op::Delete) {
+      continue;
+    }
+
+    std::string key;
+    int64_t commit_ts = 0;
+    auto status = Helper::DecodeTxnKey(kv.key(), key, commit_ts);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[cdc][region({})] decode write key failed, key: {}", region_id,
+                                      Helper::StringToHex(kv.key()));
+      continue;
+    }
+
+    auto& event = events.emplace_back();
+    event.set_log_id(log_id);
+    event.set_start_ts(write_info.start_ts());
+    event.set_commit_ts(commit_ts);
+    if (write_info.op() == pb::store::Op::Delete) {
+      event.set_type(pb::store::CdcEvent::DELETE);
+    } else {
+      event.set_type(pb::store::CdcEvent::PUT);
+      if (!write_info.short_value().empty()) {
+        event.set_value(write_info.short_value());
+      } else {
+        std::string value;
+        status = reader->KvGet(Constant::kTxnDataCF, Helper::EncodeTxnKey(key, write_info.start_ts()), value);
+        if (!status.ok()) {
+          DINGO_LOG(WARNING) << fmt::format("[cdc][region({})] get txn data failed, key: {} start_ts: {} error: {}",
+                                            region_id, Helper::StringToHex(key), write_info.start_ts(),
+                                            status.error_str());
+        }
+        event.set_value(std::move(value));
+      }
+    }
+    event.set_key(std::move(key));
+  }
+  Append(region_id, events);
+}
+
+void CdcManager::CaptureTxnDeleteRange(int64_t region_id, int64_t log_id, const std::string& start_key,
+                                       const std::string& end_key) {
+  if (!IsCaptured(region_id)) {
+    return;
+  }
+
+  std::vector<pb::store::CdcEvent> events(1);
+  events[0].set_type(pb::store::CdcEvent::DELETE_RANGE);
+  events[0].set_log_id(log_id);
+  events[0].set_key(start_key);
+  events[0].set_end_key(end_key);
+  Append(region_id, events);
+}
+
+butil::Status CdcManager::Subscribe(const pb::store::KvCdcRequest& request, brpc::Controller* cntl) {
+  int64_t region_id = request.context().region_id();
+  if (!FLAGS_enable_cdc) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "cdc is disabled");
+  }
+
+  auto subscriber = std::make_shared<Subscriber>();
+  subscriber->buffer = GetOrCreateBuffer(region_id);
+  subscriber->start_ts = request.start_ts();
+
+  {
+    auto& buffer = subscriber->buffer;
+    BAIDU_SCOPED_LOCK(buffer->mutex);
+    int64_t next_seq = buffer->first_seq + buffer->events.size();
+    if (request.start_log_id() <= 0) {
+      subscriber->cursor = next_seq;
+    } else if (request.start_log_id() < buffer->complete_log_id) {
+      std::string s = fmt::format("events from log {} are not available, the buffer is complete from log {}",
+                                  request.start_log_id(), buffer->complete_log_id);
+      DINGO_LOG(WARNING) << fmt::format("[cdc][region({})] {}", region_id, s);
+      return butil::Status(pb::error::ECDC_EVENT_COMPACTED, s);
+    } else {
+      auto it = std::lower_bound(
+          buffer->events.begin(), buffer->events.end(), request.start_log_id(),
+          [](const pb::store::CdcEvent& event, int64_t log_id) { return event.log_id() < log_id; });
+      subscriber->cursor = buffer->first_seq + (it - buffer->events.begin());
+    }
+  }
+
+  auto* handler = new Handler(subscriber);
+  brpc::StreamOptions options;
+  options.handler = handler;
+  options.max_buf_size = FLAGS_cdc_stream_max_buf_size;
+  if (brpc::StreamAccept(&subscriber->stream_id, *cntl, &options) != 0) {
+    delete handler;
+    DINGO_LOG(ERROR) << fmt::format("[cdc][region({})] accept stream failed.", region_id);
+    return butil::Status(pb::error::EINTERNAL, "accept stream failed");
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[cdc][region({})] subscribe, stream_id: {} start_log_id: {} start_ts: {}", region_id,
+                                 subscriber->stream_id, request.start_log_id(), request.start_ts());
+
+  // the stream is usable after the response of the rpc is sent.
+  Bthread bth(&BTHREAD_ATTR_NORMAL);
+  bth.Run([subscriber]() { Run(subscriber); });
+
+  return butil::Status();
+}
+
+void CdcManager::Run(SubscriberPtr subscriber) {
+  auto& buffer = subscriber->buffer;
+  int64_t region_id = buffer->region_id;
+  int64_t send_count = 0;
+  int64_t last_send_time = 0;
+
+  while (!subscriber->closed.load(std::memory_order_relaxed)) {
+    pb::store::KvCdcResponse response;
+
+    // Take the watermarks before copying events, every event under them is already in the buffer.
+    auto raft_meta = Server::GetInstance().GetRaftMeta(region_id);
+    int64_t applied_log_id = raft_meta != nullptr ? raft_meta->AppliedId() : 0;
+    int64_t resolved_ts = TxnResolvedTsManager::GetInstance().GetResolvedTs(region_id);
+
+    bool caught_up = false;
+    {
+      std::unique_lock<bthread::Mutex> lock(buffer->mutex);
+      int64_t next_seq = buffer->first_seq + buffer->events.size();
+      if (!buffer->removed && subscriber->cursor == next_seq) {
+        buffer->cond.wait_for(lock, FLAGS_cdc_stream_heartbeat_interval_ms * 1000);
+        next_seq = buffer->first_seq + buffer->events.size();
+      }
+
+      if (buffer->removed) {
+        response.mutable_error()->set_errcode(pb::error::EREGION_VERSION);
+        response.mutable_error()->set_errmsg("region changes are not continuous, e.g. split, merge or load snapshot");
+      } else if (subscriber->cursor < buffer->first_seq) {
+        response.mutable_error()->set_errcode(pb::error::ECDC_EVENT_COMPACTED);
+        response.mutable_error()->set_errmsg("subscriber is too slow, events are evicted");
+      } else {
+        int64_t end_seq = std::min(next_seq, subscriber->cursor + FLAGS_cdc_stream_max_events_per_response);
+        for (int64_t seq = subscriber->cursor; seq < end_seq; ++seq) {
+          const auto& event = buffer->events[seq - buffer->first_seq];
+          if (event.commit_ts() > 0 && event.commit_ts() <= subscriber->start_ts) {
+            continue;
+          }
+          *response.add_events() = event;
+        }
+        subscriber->cursor = end_seq;
+        caught_up = end_seq == next_seq;
+      }
+    }
+
+    if (response.has_error()) {
+      DINGO_LOG(WARNING) << fmt::format("[cdc][region({})] close stream {}, error: {}", region_id,
+                                        subscriber->stream_id, response.error().errmsg());
+      Write(subscriber, response);
+      break;
+    }
+
+    // The newly applied events may be after the watermarks, only caught up subscriber gets them.
+    if (caught_up) {
+      response.set_applied_log_id(applied_log_id);
+      response.set_resolved_ts(resolved_ts);
+    }
+
+    int64_t now = Helper::TimestampMs();
+    if (response.events().empty() && now - last_send_time < FLAGS_cdc_stream_heartbeat_interval_ms) {
+      continue;
+    }
+
+    send_count += response.events_size();
+    if (!Write(subscriber, response)) {
+      break;
+    }
+    last_send_time = now;
+  }
+
+  brpc::StreamClose(subscriber->stream_id);
+
+  DINGO_LOG(INFO) << fmt::format("[cdc][region({})] finish stream {}, closed: {} events: {}", region_id,
+                                 subscriber->stream_id, subscriber->closed.load(), send_count);
+}
+
+bool CdcManager::Write(SubscriberPtr subscriber, const pb::store::KvCdcResponse& response) {
+  butil::IOBuf buf;
+  butil::IOBufAsZeroCopyOutputStream wrapper(&buf);
+  response.SerializeToZeroCopyStream(&wrapper);
+
+  for (;;) {
+    int ret = brpc::StreamWrite(subscriber->stream_id, buf);
+    if (ret == 0) {
+      return true;
+    }
+    if (ret != EAGAIN || subscriber->closed.load(std::memory_order_relaxed)) {
+      DINGO_LOG(WARNING) << fmt::format("[cdc][region({})] write stream failed, ret: {}", subscriber->buffer->region_id,
+                                        ret);
+      return false;
+    }
+
+    // the window is full, wait the client consume.
+    timespec due_time = butil::milliseconds_from_now(FLAGS_cdc_stream_write_timeout_ms);
+    ret = brpc::StreamWait(subscriber->stream_id, &due_time);
+    if (ret != 0) {
+      DINGO_LOG(WARNING) << fmt::format("[cdc][region({})] wait stream writable failed, ret: {}",
+                                        subscriber->buffer->region_id, ret);
+      return false;
+    }
+  }
+}
+
+}  // namespace dingodb
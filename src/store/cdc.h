@@ -0,0 +1,113 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_STORE_CDC_H_  // NOLINT
+#define DINGODB_STORE_CDC_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "brpc/controller.h"
+#include "brpc/stream.h"
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "engine/raw_engine.h"
+#include "google/protobuf/repeated_field.h"
+#include "proto/common.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+// Change data capture of regions on this replica.
+// The apply path taps the committed changes into a bounded buffer of region in log order, raw kv changes of data cf
+// and txn commits of write cf. A region is captured from its first subscribe, the buffer is kept for resuming
+// until the region is removed.
+// Every subscriber is a brpc stream fed by a background bthread from its cursor of the buffer.
+class CdcManager {
+ public:
+  static CdcManager& GetInstance();
+
+  // Called by the apply handlers after the changes are written, nothing is done if region is not captured.
+  void CapturePut(int64_t region_id, int64_t log_id, const std::string& cf_name,
+                  const google::protobuf::RepeatedPtrField<pb::common::KeyValue>& kvs);
+  void CaptureDelete(int64_t region_id, int64_t log_id, const std::string& cf_name,
+                     const google::protobuf::RepeatedPtrField<std::string>& keys);
+  void CaptureDeleteRange(int64_t region_id, int64_t log_id, const std::string& cf_name,
+                          const google::protobuf::RepeatedPtrField<pb::common::Range>& ranges);
+  // write_kvs are the puts of write cf, the value not in write info is read from data cf.
+  void CaptureTxnCommit(int64_t region_id, int64_t log_id, RawEnginePtr engine,
+                        const std::vector<pb::common::KeyValue>& write_kvs);
+  void CaptureTxnDeleteRange(int64_t region_id, int64_t log_id, const std::string& start_key,
+                             const std::string& end_key);
+
+  // The changes of region are not continuous any more, e.g. split, merge or load snapshot.
+  // The buffer is dropped and the subscribers are closed with error.
+  void Remove(int64_t region_id);
+
+  // The client must create the brpc stream with the request.
+  butil::Status Subscribe(const pb::store::KvCdcRequest& request, brpc::Controller* cntl);
+
+  bool IsCaptured(int64_t region_id);
+
+ private:
+  CdcManager() = default;
+
+  struct Buffer {
+    int64_t region_id{0};
+    bthread::Mutex mutex;
+    bthread::ConditionVariable cond;
+    // events[i] has the seq first_seq + i
+    std::deque<pb::store::CdcEvent> events;
+    int64_t first_seq{0};
+    // all events of the logs >= complete_log_id are in the buffer
+    int64_t complete_log_id{0};
+    bool removed{false};
+  };
+  using BufferPtr = std::shared_ptr<Buffer>;
+
+  struct Subscriber {
+    BufferPtr buffer;
+    int64_t start_ts{0};
+    int64_t cursor{0};
+    brpc::StreamId stream_id{brpc::INVALID_STREAM_ID};
+    // set when the stream is closed by the client
+    std::atomic<bool> closed{false};
+  };
+  using SubscriberPtr = std::shared_ptr<Subscriber>;
+
+  class Handler;
+
+  BufferPtr GetBuffer(int64_t region_id);
+  BufferPtr GetOrCreateBuffer(int64_t region_id);
+  void Append(int64_t region_id, std::vector<pb::store::CdcEvent>& events);
+
+  static void Run(SubscriberPtr subscriber);
+  // Write the response, wait the stream writable if the window is full.
+  static bool Write(SubscriberPtr subscriber, const pb::store::KvCdcResponse& response);
+
+  bthread::Mutex mutex_;
+  std::map<int64_t, BufferPtr> buffers_;
+  // fast path of the apply without captured region
+  std::atomic<int64_t> buffer_count_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_STORE_CDC_H_  // NOLINT
@@ -16,16 +16,20 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
 #include "butil/time.h"
+#include "common/failpoint.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "coordinator/coordinator_control.h"
@@ -53,10 +57,68 @@ DEFINE_int64(store_heartbeat_report_region_multiple, 10,
              "store heartbeat report region multiple, this defines how many times of heartbeat will report "
              "region_metrics once to coordinator");
 
+DEFINE_bool(store_heartbeat_enable_delta_region_metrics, false,
+            "store heartbeat only report changed region_metrics, coordinator must support delta region metrics");
+DEFINE_int64(store_heartbeat_full_region_metrics_multiple, 10,
+             "when enable delta region metrics, this defines how many times of region_metrics report will report "
+             "full region_metrics once to coordinator");
+
 std::atomic<uint64_t> HeartbeatTask::heartbeat_counter = 0;
 
+DeltaRegionMetricsTracker& DeltaRegionMetricsTracker::GetInstance() {
+  static DeltaRegionMetricsTracker instance;
+  return instance;
+}
+
+bool DeltaRegionMetricsTracker::CanDelta(int64_t& base_version) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  base_version = accepted_version_;
+  return !need_full_;
+}
+
+bool DeltaRegionMetricsTracker::IsChanged(int64_t region_id, uint64_t digest) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = accepted_digests_.find(region_id);
+  return it == accepted_digests_.end() || it->second != digest;
+}
+
+std::vector<int64_t> DeltaRegionMetricsTracker::GetRemovedRegionIds(const std::set<int64_t>& alive_region_ids) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  std::vector<int64_t> removed_region_ids;
+  for (const auto& [region_id, _] : accepted_digests_) {
+    if (alive_region_ids.find(region_id) == alive_region_ids.end()) {
+      removed_region_ids.push_back(region_id);
+    }
+  }
+  return removed_region_ids;
+}
+
+void DeltaRegionMetricsTracker::Accept(bool is_delta, int64_t version, const std::map<int64_t, uint64_t>& digests,
+                                       const std::vector<int64_t>& removed_region_ids) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (is_delta) {
+    for (auto region_id : removed_region_ids) {
+      accepted_digests_.erase(region_id);
+    }
+    for (const auto& [region_id, digest] : digests) {
+      accepted_digests_[region_id] = digest;
+    }
+  } else {
+    accepted_digests_ = digests;
+  }
+  accepted_version_ = version;
+  need_full_ = false;
+}
+
+void DeltaRegionMetricsTracker::Reject() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  need_full_ = true;
+}
+
 void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> coordinator_interaction,
                                        std::vector<int64_t> region_ids, bool is_update_epoch_version) {
+  FAIL_POINT("before_store_heartbeat");
+
   auto start_time = Helper::TimestampMs();
   auto first_start_time = start_time;
   auto engine = Server::GetInstance().GetEngine();
@@ -104,9 +166,26 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
     request.mutable_store_metrics()->set_id(Server::GetInstance().Id());
   }
 
+  // delta region metrics only for periodic heartbeat, partial heartbeat carries the specified regions.
+  bool enable_delta = FLAGS_store_heartbeat_enable_delta_region_metrics && region_ids.empty();
+  bool is_delta = false;
+  int64_t region_metrics_base_version = 0;
+  std::map<int64_t, uint64_t> region_metrics_digests;
+  std::vector<int64_t> removed_region_ids;
+  if (need_report_region_metrics && enable_delta) {
+    uint64_t report_count = temp_heartbeat_count / std::max(FLAGS_store_heartbeat_report_region_multiple, 1L);
+    is_delta = DeltaRegionMetricsTracker::GetInstance().CanDelta(region_metrics_base_version) &&
+               report_count % std::max(FLAGS_store_heartbeat_full_region_metrics_multiple, 1L) != 0;
+    auto* mut_store_metrics = request.mutable_store_metrics();
+    mut_store_metrics->set_is_delta_region_metrics(is_delta);
+    mut_store_metrics->set_region_metrics_base_version(region_metrics_base_version);
+    // version restart from 1 for full region metrics
+    mut_store_metrics->set_region_metrics_version(is_delta ? region_metrics_base_version + 1 : 1);
+  }
+
   if (need_report_region_metrics) {
-    DINGO_LOG(INFO) << fmt::format("[heartbeat.store] start_time({}) heartbeat_counter: {}", first_start_time,
-                                   temp_heartbeat_count);
+    DINGO_LOG(INFO) << fmt::format("[heartbeat.store] start_time({}) heartbeat_counter: {} is_delta: {}",
+                                   first_start_time, temp_heartbeat_count, is_delta);
 
     auto* mut_region_metrics_map = request.mutable_store_metrics()->mutable_region_metrics_map();
     auto region_metrics = store_metrics_manager->GetStoreRegionMetrics();
@@ -174,9 +253,28 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
         vector_index_status->set_last_build_epoch_version(vector_index_wrapper->LastBuildEpochVersion());
       }
 
+      if (enable_delta) {
+        uint64_t digest = std::hash<std::string>{}(tmp_region_metrics.SerializeAsString());
+        region_metrics_digests[inner_region.id()] = digest;
+        if (is_delta && !DeltaRegionMetricsTracker::GetInstance().IsChanged(inner_region.id(), digest)) {
+          continue;
+        }
+      }
+
       mut_region_metrics_map->insert({inner_region.id(), tmp_region_metrics});
     }
 
+    if (is_delta) {
+      std::set<int64_t> alive_region_ids;
+      for (const auto& region_meta : region_metas) {
+        alive_region_ids.insert(region_meta->Id());
+      }
+      removed_region_ids = DeltaRegionMetricsTracker::GetInstance().GetRemovedRegionIds(alive_region_ids);
+      for (auto region_id : removed_region_ids) {
+        request.mutable_store_metrics()->add_removed_region_ids(region_id);
+      }
+    }
+
     DINGO_LOG(INFO) << fmt::format(
         "[heartbeat.store] start_time({}) request region count({}) size({}) region_ids_count({}), elapsed time({} ms)",
         first_start_time, mut_region_metrics_map->size(), request.ByteSizeLong(), region_ids.size(),
@@ -200,9 +298,24 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
   if (!status.ok()) {
     DINGO_LOG(WARNING) << fmt::format("[heartbeat.store] start_time({}) store heartbeat failed, error: {}",
                                       first_start_time, Helper::PrintStatus(status));
+    if (need_report_region_metrics && enable_delta) {
+      DeltaRegionMetricsTracker::GetInstance().Reject();
+    }
     return;
   }
 
+  if (need_report_region_metrics && enable_delta) {
+    if (response.need_full_region_metrics() ||
+        (response.has_error() && response.error().errcode() != pb::error::OK)) {
+      DINGO_LOG(INFO) << fmt::format("[heartbeat.store] start_time({}) delta region metrics rejected, need full.",
+                                     first_start_time);
+      DeltaRegionMetricsTracker::GetInstance().Reject();
+    } else {
+      DeltaRegionMetricsTracker::GetInstance().Accept(is_delta, request.store_metrics().region_metrics_version(),
+                                                      region_metrics_digests, removed_region_ids);
+    }
+  }
+
   DINGO_LOG(INFO) << fmt::format("[heartbeat.store] start_time({}) response size({}) elapsed time({} ms)",
                                  first_start_time, response.ByteSizeLong(), Helper::TimestampMs() - start_time);
 
@@ -322,6 +435,30 @@ void CoordinatorRecycleOrphanTask::CoordinatorRecycleOrphan(std::shared_ptr<Coor
   coordinator_control->RecycleOutdatedStoreMetrics();
 }
 
+static std::atomic<bool> g_coordinator_balance_running(false);
+void CoordinatorBalanceTask::CoordinatorBalance(std::shared_ptr<CoordinatorControl> coordinator_control) {
+  if (g_coordinator_balance_running.load(std::memory_order_relaxed)) {
+    DINGO_LOG(INFO) << "CoordinatorBalance... g_coordinator_balance_running is true, return";
+    return;
+  }
+
+  AtomicGuard guard(g_coordinator_balance_running);
+
+  coordinator_control->BalanceLeaderAndRegion();
+}
+
+static std::atomic<bool> g_coordinator_merge_running(false);
+void CoordinatorMergeTask::CoordinatorMerge(std::shared_ptr<CoordinatorControl> coordinator_control) {
+  if (g_coordinator_merge_running.load(std::memory_order_relaxed)) {
+    DINGO_LOG(INFO) << "CoordinatorMerge... g_coordinator_merge_running is true, return";
+    return;
+  }
+
+  AtomicGuard guard(g_coordinator_merge_running);
+
+  coordinator_control->MergeSmallRegions();
+}
+
 static std::atomic<bool> g_store_meta_watch_clean_running(false);
 void CoordinatorMetaWatchCleanTask::CoordinatorMetaWatchClean(std::shared_ptr<CoordinatorControl> coordinator_control) {
   if (g_store_meta_watch_clean_running.load(std::memory_order_relaxed)) {
@@ -578,6 +715,18 @@ void Heartbeat::TriggerCoordinatorMetaWatchClean(void*) {
   Server::GetInstance().GetHeartbeat()->Execute(task);
 }
 
+void Heartbeat::TriggerCoordinatorBalance(void*) {
+  // Free at ExecuteRoutine()
+  auto task = std::make_shared<CoordinatorBalanceTask>(Server::GetInstance().GetCoordinatorControl());
+  Server::GetInstance().GetHeartbeat()->Execute(task);
+}
+
+void Heartbeat::TriggerCoordinatorMerge(void*) {
+  // Free at ExecuteRoutine()
+  auto task = std::make_shared<CoordinatorMergeTask>(Server::GetInstance().GetCoordinatorControl());
+  Server::GetInstance().GetHeartbeat()->Execute(task);
+}
+
 void Heartbeat::TriggerKvRemoveOneTimeWatch(void*) {
   // Free at ExecuteRoutine()
   auto task = std::make_shared<KvRemoveOneTimeWatchTask>(Server::GetInstance().GetKvControl());
@@ -16,8 +16,12 @@
 #define DINGODB_SERVER_HEARTBEAT_H_
 
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <set>
+#include <vector>
 
+#include "bthread/mutex.h"
 #include "common/logging.h"
 #include "common/runnable.h"
 #include "coordinator/coordinator_control.h"
@@ -28,6 +32,32 @@
 
 namespace dingodb {
 
+// Track region metrics accepted by coordinator for delta heartbeat.
+// Delta heartbeat only carries regions whose metrics changed since the last accepted version,
+// a full heartbeat is sent periodically or after coordinator rejects a delta.
+class DeltaRegionMetricsTracker {
+ public:
+  static DeltaRegionMetricsTracker& GetInstance();
+
+  // Return false if need a full heartbeat, base_version is the last accepted version.
+  bool CanDelta(int64_t& base_version);
+  bool IsChanged(int64_t region_id, uint64_t digest);
+  // Accepted regions which not exist in alive_region_ids.
+  std::vector<int64_t> GetRemovedRegionIds(const std::set<int64_t>& alive_region_ids);
+
+  void Accept(bool is_delta, int64_t version, const std::map<int64_t, uint64_t>& digests,
+              const std::vector<int64_t>& removed_region_ids);
+  void Reject();
+
+ private:
+  DeltaRegionMetricsTracker() = default;
+
+  bthread::Mutex mutex_;
+  bool need_full_{true};
+  int64_t accepted_version_{0};
+  std::map<int64_t, uint64_t> accepted_digests_;
+};
+
 class HeartbeatTask : public TaskRunnable {
  public:
   HeartbeatTask(std::shared_ptr<CoordinatorInteraction> coordinator_interaction)
@@ -128,6 +158,42 @@ class CoordinatorRecycleOrphanTask : public TaskRunnable {
   std::shared_ptr<CoordinatorControl> coordinator_control_;
 };
 
+class CoordinatorBalanceTask : public TaskRunnable {
+ public:
+  CoordinatorBalanceTask(std::shared_ptr<CoordinatorControl> coordinator_control)
+      : coordinator_control_(coordinator_control) {}
+  ~CoordinatorBalanceTask() override = default;
+
+  std::string Type() override { return "COORDINATOR_BALANCE"; }
+
+  void Run() override {
+    DINGO_LOG(DEBUG) << "start process CoordinatorBalance";
+    CoordinatorBalance(coordinator_control_);
+  }
+
+ private:
+  static void CoordinatorBalance(std::shared_ptr<CoordinatorControl> coordinator_control);
+  std::shared_ptr<CoordinatorControl> coordinator_control_;
+};
+
+class CoordinatorMergeTask : public TaskRunnable {
+ public:
+  CoordinatorMergeTask(std::shared_ptr<CoordinatorControl> coordinator_control)
+      : coordinator_control_(coordinator_control) {}
+  ~CoordinatorMergeTask() override = default;
+
+  std::string Type() override { return "COORDINATOR_MERGE"; }
+
+  void Run() override {
+    DINGO_LOG(DEBUG) << "start process CoordinatorMerge";
+    CoordinatorMerge(coordinator_control_);
+  }
+
+ private:
+  static void CoordinatorMerge(std::shared_ptr<CoordinatorControl> coordinator_control);
+  std::shared_ptr<CoordinatorControl> coordinator_control_;
+};
+
 class CoordinatorMetaWatchCleanTask : public TaskRunnable {
  public:
   CoordinatorMetaWatchCleanTask(std::shared_ptr<CoordinatorControl> coordinator_control)
@@ -244,6 +310,8 @@ class Heartbeat {
   static void TriggerCoordinatorTaskListProcess(void*);
   static void TriggerCoordinatorRecycleOrphan(void*);
   static void TriggerCoordinatorMetaWatchClean(void*);
+  static void TriggerCoordinatorBalance(void*);
+  static void TriggerCoordinatorMerge(void*);
   static void TriggerKvRemoveOneTimeWatch(void*);
   static void TriggerCalculateTableMetrics(void*);
   static void TriggerScrubVectorIndex(void*);
@@ -0,0 +1,611 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "store/learner.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/service_access.h"
+#include "engine/iterator.h"
+#include "engine/raft_store_engine.h"
+#include "engine/txn_resolved_ts.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "server/server.h"
+#include "store/region_hash.h"
+
+namespace dingodb {
+
+DEFINE_int64(learner_sync_interval_ms, 100, "interval of learners pulling the log from voters");
+DEFINE_int32(learner_pull_log_max_count, 1024, "max log entries of one pull");
+DEFINE_int64(learner_pull_log_max_bytes, 8L * 1024 * 1024, "max bytes of log entries of one pull");
+DEFINE_int32(learner_pull_log_max_rounds, 16, "max pulls of one region in one sync, the others wait the next sync");
+DEFINE_int32(learner_snapshot_batch_size, 4096, "max kvs of one page of learner snapshot");
+DEFINE_int64(learner_snapshot_session_timeout_s, 60, "learner snapshot session is released when not accessed");
+DEFINE_int32(learner_snapshot_max_session_num, 8, "max learner snapshot sessions served by one store");
+DEFINE_uint32(learner_worker_num, 4, "worker num of learner sync");
+
+class LearnerSyncTask : public TaskRunnable {
+ public:
+  using Handler = std::function<void()>;
+  explicit LearnerSyncTask(Handler handler) : handler_(std::move(handler)) {}
+  ~LearnerSyncTask() override = default;
+
+  std::string Type() override { return "LEARNER_SYNC"; }
+
+  void Run() override { handler_(); }
+
+ private:
+  Handler handler_;
+};
+
+static bool IsSameStores(const std::vector<pb::common::Peer>& lhs, const std::vector<pb::common::Peer>& rhs) {
+  std::set<int64_t> lhs_store_ids;
+  std::set<int64_t> rhs_store_ids;
+  for (const auto& peer : lhs) lhs_store_ids.insert(peer.store_id());
+  for (const auto& peer : rhs) rhs_store_ids.insert(peer.store_id());
+  return lhs_store_ids == rhs_store_ids;
+}
+
+// Column families of region and their ranges, txn column families use the mem comparable range.
+static std::vector<std::pair<std::string, pb::common::Range>> GetCfRanges(const pb::common::Range& range) {
+  std::vector<std::string> raw_cf_names;
+  std::vector<std::string> txn_cf_names;
+  Helper::GetColumnFamilyNames(range.start_key(), raw_cf_names, txn_cf_names);
+
+  std::vector<std::pair<std::string, pb::common::Range>> cf_ranges;
+  for (const auto& cf_name : raw_cf_names) {
+    cf_ranges.emplace_back(cf_name, range);
+  }
+  if (!txn_cf_names.empty()) {
+    auto txn_range = Helper::GetMemComparableRange(range);
+    for (const auto& cf_name : txn_cf_names) {
+      cf_ranges.emplace_back(cf_name, txn_range);
+    }
+  }
+
+  return cf_ranges;
+}
+
+static std::shared_ptr<StoreStateMachine> GetStateMachine(int64_t region_id) {
+  auto raft_store_engine = Server::GetInstance().GetRaftStoreEngine();
+  if (raft_store_engine == nullptr) {
+    return nullptr;
+  }
+  auto node = raft_store_engine->GetNode(region_id);
+  if (node == nullptr) {
+    return nullptr;
+  }
+
+  return std::dynamic_pointer_cast<StoreStateMachine>(node->GetStateMachine());
+}
+
+LearnerManager::LearnerManager()
+    : bvar_apply_log_count_("dingo_learner_apply_log_count"),
+      bvar_bootstrap_count_("dingo_learner_bootstrap_count"),
+      bvar_bootstrap_bytes_("dingo_learner_bootstrap_bytes") {}
+
+LearnerManager& LearnerManager::GetInstance() {
+  static LearnerManager instance;
+  return instance;
+}
+
+bool LearnerManager::Init() {
+  worker_set_ = PriorWorkerSet::New("learner_sync", FLAGS_learner_worker_num, 0, false);
+  return worker_set_->Init();
+}
+
+void LearnerManager::Destroy() {
+  if (worker_set_ != nullptr) {
+    worker_set_->Destroy();
+  }
+}
+
+bool LearnerManager::IsLearner(const std::vector<pb::common::Peer>& peers, int64_t store_id) {
+  return std::any_of(peers.begin(), peers.end(), [store_id](const pb::common::Peer& peer) {
+    return peer.store_id() == store_id && peer.role() == pb::common::LEARNER;
+  });
+}
+
+bool LearnerManager::IsLearner(store::RegionPtr region) {
+  return region != nullptr && IsLearner(region->Peers(pb::common::LEARNER), Server::GetInstance().Id());
+}
+
+void LearnerManager::SyncHandler(void*) { GetInstance().Sync(); }
+
+LearnerManager::LearnerStatePtr LearnerManager::GetOrCreateState(store::RegionPtr region,
+                                                                 std::shared_ptr<StoreStateMachine> state_machine) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = learner_states_.find(region->Id());
+  if (it != learner_states_.end()) {
+    return it->second;
+  }
+
+  // The data and applied index of learner are persisted, only the new learner bootstraps.
+  auto state = std::make_shared<LearnerState>();
+  state->ready = state_machine->GetAppliedIndex() > 0;
+  state->need_bootstrap = !state->ready;
+  learner_states_[region->Id()] = state;
+  return state;
+}
+
+void LearnerManager::Sync() {
+  CleanExpiredSessions();
+
+  if (worker_set_ == nullptr) {
+    return;
+  }
+
+  std::set<int64_t> learner_region_ids;
+  for (const auto& region : Server::GetInstance().GetAllAliveRegion()) {
+    if (!IsLearner(region)) {
+      continue;
+    }
+    learner_region_ids.insert(region->Id());
+    if (region->State() != pb::common::StoreRegionState::NORMAL) {
+      continue;
+    }
+
+    auto state_machine = GetStateMachine(region->Id());
+    if (state_machine == nullptr) {
+      continue;
+    }
+
+    auto state = GetOrCreateState(region, state_machine);
+    {
+      BAIDU_SCOPED_LOCK(mutex_);
+      if (state->is_syncing) {
+        continue;
+      }
+      state->is_syncing = true;
+    }
+
+    auto task = std::make_shared<LearnerSyncTask>([this, region, state_machine, state]() {
+      SyncRegion(region, state_machine);
+
+      BAIDU_SCOPED_LOCK(mutex_);
+      state->is_syncing = false;
+    });
+    if (!worker_set_->Execute(task)) {
+      BAIDU_SCOPED_LOCK(mutex_);
+      state->is_syncing = false;
+    }
+  }
+
+  // Drop the state of regions which are not learner here anymore, e.g. deleted or promoted.
+  BAIDU_SCOPED_LOCK(mutex_);
+  for (auto it = learner_states_.begin(); it != learner_states_.end();) {
+    if (learner_region_ids.count(it->first) == 0 && !it->second->is_syncing) {
+      it = learner_states_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void LearnerManager::SyncRegion(store::RegionPtr region, std::shared_ptr<StoreStateMachine> state_machine) {
+  auto voters = region->Peers(pb::common::VOTER);
+  if (voters.empty()) {
+    return;
+  }
+
+  LearnerStatePtr state;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    state = learner_states_[region->Id()];
+  }
+  if (state == nullptr) {
+    return;
+  }
+
+  auto endpoint = Helper::LocationToEndPoint(voters[state->source_index % voters.size()].server_location());
+
+  butil::Status status;
+  if (state->need_bootstrap) {
+    status = Bootstrap(region, state_machine, endpoint, state->min_bootstrap_index);
+    if (status.ok()) {
+      BAIDU_SCOPED_LOCK(mutex_);
+      state->ready = true;
+      state->need_bootstrap = false;
+      state->min_bootstrap_index = 0;
+    }
+  }
+  if (status.ok() && !state->need_bootstrap) {
+    status = PullAndApply(region, state_machine, endpoint, state);
+  }
+
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[learner][region({})] sync from {} failed, error: {}", region->Id(),
+                                      Helper::EndPointToStr(endpoint), Helper::PrintStatus(status));
+    // Try the next voter.
+    ++state->source_index;
+  }
+}
+
+butil::Status LearnerManager::PullAndApply(store::RegionPtr region, std::shared_ptr<StoreStateMachine> state_machine,
+                                           const butil::EndPoint& endpoint, LearnerStatePtr state) {
+  for (int round = 0; round < FLAGS_learner_pull_log_max_rounds; ++round) {
+    pb::node::PullRaftLogRequest request;
+    pb::node::PullRaftLogResponse response;
+    request.set_region_id(region->Id());
+    request.set_start_index(state_machine->GetAppliedIndex() + 1);
+    request.set_max_count(FLAGS_learner_pull_log_max_count);
+    request.set_max_bytes(FLAGS_learner_pull_log_max_bytes);
+
+    auto status = ServiceAccess::PullRaftLog(request, endpoint, response);
+    if (status.error_code() == pb::error::ERAFT_LOG_COMPACTED) {
+      DINGO_LOG(INFO) << fmt::format("[learner][region({})] log {} is compacted, bootstrap again", region->Id(),
+                                     request.start_index());
+      BAIDU_SCOPED_LOCK(mutex_);
+      state->need_bootstrap = true;
+      return butil::Status();
+    }
+    if (!status.ok()) {
+      return status;
+    }
+
+    {
+      BAIDU_SCOPED_LOCK(mutex_);
+      state->leader_location = response.leader_location();
+    }
+
+    // Raft configuration changes are not in the data entries, follow the voters of the voter.
+    auto voters = Helper::PbRepeatedToVector(response.voters());
+    if (!voters.empty() && !IsSameStores(voters, region->Peers(pb::common::VOTER))) {
+      auto peers = voters;
+      for (const auto& learner : region->Peers(pb::common::LEARNER)) {
+        peers.push_back(learner);
+      }
+      DINGO_LOG(INFO) << fmt::format("[learner][region({})] voters have changed, peers({})", region->Id(),
+                                     Helper::PeersToString(peers));
+      Server::GetInstance().GetStoreMetaManager()->GetStoreRegionMeta()->UpdatePeers(region, peers);
+    }
+
+    if (response.end_index() < request.start_index()) {
+      break;
+    }
+
+    auto entries = Helper::PbRepeatedToVector(response.entries());
+    if (!state_machine->ApplyLearnerLog(entries, response.end_term(), response.end_index())) {
+      BAIDU_SCOPED_LOCK(mutex_);
+      state->need_bootstrap = true;
+      state->min_bootstrap_index = state_machine->GetAppliedIndex() + 1;
+      return butil::Status();
+    }
+    bvar_apply_log_count_ << entries.size();
+
+    if (response.end_index() >= response.applied_index()) {
+      break;
+    }
+  }
+
+  return butil::Status();
+}
+
+butil::Status LearnerManager::Bootstrap(store::RegionPtr region, std::shared_ptr<StoreStateMachine> state_machine,
+                                        const butil::EndPoint& endpoint, int64_t min_index) {
+  int64_t start_time = Helper::TimestampMs();
+
+  pb::node::GetLearnerSnapshotRequest request;
+  pb::node::GetLearnerSnapshotResponse response;
+  request.set_region_id(region->Id());
+  auto status = ServiceAccess::GetLearnerSnapshot(request, endpoint, response);
+  if (!status.ok()) {
+    return status;
+  }
+  if (response.applied_index() < min_index) {
+    return butil::Status(pb::error::EREGION_UNAVAILABLE, "Voter applied index %ld is behind %ld",
+                         response.applied_index(), min_index);
+  }
+
+  int64_t session_id = response.session_id();
+  auto applied_term = response.applied_term();
+  auto applied_index = response.applied_index();
+  auto epoch = response.epoch();
+  auto range = response.range();
+  DINGO_LOG(INFO) << fmt::format("[learner][region({})] bootstrap from {}, applied index {}:{} epoch({}) range({})",
+                                 region->Id(), Helper::EndPointToStr(endpoint), applied_term, applied_index,
+                                 Helper::RegionEpochToString(epoch), Helper::RangeToString(range));
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    learner_states_[region->Id()]->ready = false;
+  }
+
+  auto raw_engine = Server::GetInstance().GetRawEngine(region->GetRawEngineType());
+  if (raw_engine == nullptr) {
+    return butil::Status(pb::error::EENGINE_NOT_FOUND, "Not found raw engine");
+  }
+  auto writer = raw_engine->Writer();
+
+  // Clean the old data, the range may be changed by split or merge.
+  for (const auto& old_range : {region->Range(), range}) {
+    for (const auto& [cf_name, cf_range] : GetCfRanges(old_range)) {
+      status = writer->KvDeleteRange(cf_name, cf_range);
+      if (!status.ok()) {
+        return status;
+      }
+    }
+  }
+
+  int64_t bytes = 0;
+  for (const auto& [cf_name, cf_range] : GetCfRanges(range)) {
+    std::string start_key;
+    bool has_more = true;
+    while (has_more) {
+      pb::node::GetLearnerSnapshotRequest page_request;
+      pb::node::GetLearnerSnapshotResponse page_response;
+      page_request.set_region_id(region->Id());
+      page_request.set_session_id(session_id);
+      page_request.set_cf_name(cf_name);
+      page_request.set_start_key(start_key);
+      page_request.set_limit(FLAGS_learner_snapshot_batch_size);
+      status = ServiceAccess::GetLearnerSnapshot(page_request, endpoint, page_response);
+      if (!status.ok()) {
+        return status;
+      }
+
+      auto kvs = Helper::PbRepeatedToVector(page_response.kvs());
+      if (!kvs.empty()) {
+        for (const auto& kv : kvs) {
+          bytes += kv.key().size() + kv.value().size();
+        }
+        status = writer->KvBatchPutAndDelete(cf_name, kvs, {});
+        if (!status.ok()) {
+          return status;
+        }
+        // The next page starts after the last key.
+        start_key = kvs.back().key() + std::string(1, '\0');
+      }
+      has_more = page_response.has_more() && !kvs.empty();
+    }
+  }
+
+  auto store_region_meta = Server::GetInstance().GetStoreMetaManager()->GetStoreRegionMeta();
+  store_region_meta->UpdateEpochVersionAndRange(region, epoch.version(), range, "learner bootstrap");
+  store_region_meta->UpdateEpochConfVersion(region, epoch.conf_version());
+  state_machine->ResetAppliedIndex(applied_term, applied_index);
+
+  // The locks and buckets are replaced by the snapshot.
+  TxnResolvedTsManager::GetInstance().Remove(region->Id());
+  RegionHashManager::GetInstance().Reset(region->Id());
+
+  bvar_bootstrap_count_ << 1;
+  bvar_bootstrap_bytes_ << bytes;
+  DINGO_LOG(INFO) << fmt::format("[learner][region({})] bootstrap finish, bytes: {} elapsed time {}ms", region->Id(),
+                                 bytes, Helper::TimestampMs() - start_time);
+
+  return butil::Status();
+}
+
+butil::Status LearnerManager::ValidateRead(int64_t region_id, int64_t timeout_ms) {
+  pb::common::Location leader_location;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = learner_states_.find(region_id);
+    if (it == learner_states_.end() || !it->second->ready) {
+      return butil::Status(pb::error::EREGION_UNAVAILABLE, "Learner of region(%ld) is not ready", region_id);
+    }
+    leader_location = it->second->leader_location;
+  }
+  if (leader_location.host().empty()) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, "Learner not found leader");
+  }
+
+  auto state_machine = GetStateMachine(region_id);
+  if (state_machine == nullptr) {
+    return butil::Status(pb::error::ERAFT_NOT_FOUND, "Not found raft node");
+  }
+
+  int64_t start_time = Helper::TimestampMs();
+  int64_t read_index = 0;
+  auto status =
+      ServiceAccess::ReadIndex(region_id, Helper::LocationToEndPoint(leader_location), timeout_ms, read_index);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[learner][region({})] get read index from leader {} failed, error: {}",
+                                      region_id, Helper::LocationToString(leader_location),
+                                      Helper::PrintStatus(status));
+    return butil::Status(pb::error::ERAFT_NOTLEADER, Helper::LocationToString(leader_location));
+  }
+
+  while (state_machine->GetAppliedIndex() < read_index) {
+    if (Helper::TimestampMs() - start_time > timeout_ms) {
+      return butil::Status(pb::error::ERAFT_NOTLEADER, Helper::LocationToString(leader_location));
+    }
+    bthread_usleep(1000);
+  }
+
+  return butil::Status();
+}
+
+butil::Status LearnerManager::PullRaftLog(const pb::node::PullRaftLogRequest& request,
+                                          pb::node::PullRaftLogResponse& response) {
+  int64_t region_id = request.region_id();
+  auto region = Server::GetInstance().GetRegion(region_id);
+  if (region == nullptr) {
+    return butil::Status(pb::error::EREGION_NOT_FOUND, "Not found region %ld", region_id);
+  }
+  if (IsLearner(region)) {
+    return butil::Status(pb::error::EREGION_UNAVAILABLE, "Learner not serve the log");
+  }
+
+  auto raft_store_engine = Server::GetInstance().GetRaftStoreEngine();
+  auto node = raft_store_engine != nullptr ? raft_store_engine->GetNode(region_id) : nullptr;
+  if (node == nullptr) {
+    return butil::Status(pb::error::ERAFT_NOT_FOUND, "Not found raft node");
+  }
+  auto log_storage = Server::GetInstance().GetLogStorageManager()->GetLogStorage(region_id);
+  if (log_storage == nullptr) {
+    return butil::Status(pb::error::ERAFT_NOT_FOUND_LOG_STORAGE, "Not found log storage");
+  }
+
+  for (const auto& peer : region->Peers(pb::common::VOTER)) {
+    *response.add_voters() = peer;
+  }
+  if (node->HasLeader()) {
+    auto leader_id = node->GetLeaderId();
+    auto node_info =
+        Server::GetInstance().GetStoreMetaManager()->GetStoreServerMeta()->GetNodeInfoByRaftEndPoint(leader_id.addr);
+    if (node_info.id() == 0) {
+      Helper::GetNodeInfoByRaftLocation(Helper::EndPointToLocation(leader_id.addr), node_info);
+    }
+    *response.mutable_leader_location() = node_info.server_location();
+  }
+
+  // Only the applied log is served, learner never sees the log which may be rejected.
+  int64_t applied_index = node->GetStateMachine()->GetAppliedIndex();
+  int64_t start_index = request.start_index();
+  response.set_applied_index(applied_index);
+  response.set_end_index(start_index - 1);
+  if (start_index < log_storage->FirstLogIndex()) {
+    return butil::Status(pb::error::ERAFT_LOG_COMPACTED, "Log %ld is compacted", start_index);
+  }
+
+  int64_t end_index = std::min(applied_index, start_index + std::max(request.max_count(), 1) - 1);
+  if (end_index < start_index) {
+    return butil::Status();
+  }
+
+  int64_t bytes = 0;
+  for (const auto& log_entry : log_storage->GetEntrys(start_index, end_index)) {
+    auto* entry = response.add_entries();
+    entry->set_index(log_entry->index);
+    entry->set_term(log_entry->term);
+    log_entry->data.copy_to(entry->mutable_data());
+    bytes += log_entry->data.size();
+    if (request.max_bytes() > 0 && bytes >= request.max_bytes()) {
+      end_index = log_entry->index;
+      break;
+    }
+  }
+
+  // Log may be truncated while reading.
+  if (start_index < log_storage->FirstLogIndex()) {
+    response.clear_entries();
+    return butil::Status(pb::error::ERAFT_LOG_COMPACTED, "Log %ld is compacted", start_index);
+  }
+
+  response.set_end_index(end_index);
+  response.set_end_term(log_storage->GetTerm(end_index));
+
+  return butil::Status();
+}
+
+butil::Status LearnerManager::GetSnapshot(const pb::node::GetLearnerSnapshotRequest& request,
+                                          pb::node::GetLearnerSnapshotResponse& response) {
+  int64_t region_id = request.region_id();
+  SnapshotSessionPtr session;
+  if (request.session_id() == 0) {
+    auto region = Server::GetInstance().GetRegion(region_id);
+    if (region == nullptr) {
+      return butil::Status(pb::error::EREGION_NOT_FOUND, "Not found region %ld", region_id);
+    }
+    if (IsLearner(region)) {
+      return butil::Status(pb::error::EREGION_UNAVAILABLE, "Learner not serve the snapshot");
+    }
+    auto state_machine = GetStateMachine(region_id);
+    if (state_machine == nullptr) {
+      return butil::Status(pb::error::ERAFT_NOT_FOUND, "Not found raft node");
+    }
+
+    CleanExpiredSessions();
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (snapshot_sessions_.size() >= FLAGS_learner_snapshot_max_session_num) {
+      return butil::Status(pb::error::EREQUEST_FULL, "Too many learner snapshot sessions");
+    }
+    session = std::make_shared<SnapshotSession>();
+    session->region_id = region_id;
+    // Applied index, epoch, range and the engine snapshot are taken atomically.
+    session->snapshot_ctx = state_machine->MakeSnapshotContext();
+    session->last_access_ms = Helper::TimestampMs();
+    int64_t session_id = next_session_id_.fetch_add(1);
+    snapshot_sessions_[session_id] = session;
+
+    response.set_session_id(session_id);
+    response.set_applied_term(session->snapshot_ctx->applied_term);
+    response.set_applied_index(session->snapshot_ctx->applied_index);
+    *response.mutable_epoch() = session->snapshot_ctx->region_epoch;
+    *response.mutable_range() = session->snapshot_ctx->range;
+    return butil::Status();
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = snapshot_sessions_.find(request.session_id());
+    if (it == snapshot_sessions_.end() || it->second->region_id != region_id) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Not found learner snapshot session %ld",
+                           request.session_id());
+    }
+    session = it->second;
+    session->last_access_ms = Helper::TimestampMs();
+  }
+
+  const auto& snapshot_ctx = session->snapshot_ctx;
+  auto cf_ranges = GetCfRanges(snapshot_ctx->range);
+  auto cf_it = std::find_if(cf_ranges.begin(), cf_ranges.end(),
+                            [&request](const auto& cf_range) { return cf_range.first == request.cf_name(); });
+  if (cf_it == cf_ranges.end()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Column family %s not in region",
+                         request.cf_name().c_str());
+  }
+  const auto& range = cf_it->second;
+
+  IteratorOptions options;
+  options.lower_bound = range.start_key();
+  options.upper_bound = range.end_key();
+  auto iter = snapshot_ctx->raw_engine->Reader()->NewIterator(request.cf_name(), snapshot_ctx->snapshot, options);
+  if (iter == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "New iterator failed, cf: %s", request.cf_name().c_str());
+  }
+
+  int32_t limit = request.limit() > 0 ? std::min(request.limit(), FLAGS_learner_snapshot_batch_size)
+                                      : FLAGS_learner_snapshot_batch_size;
+  iter->Seek(std::max(request.start_key(), range.start_key()));
+  for (; iter->Valid() && response.kvs_size() < limit; iter->Next()) {
+    auto* kv = response.add_kvs();
+    kv->set_key(iter->Key().data(), iter->Key().size());
+    kv->set_value(iter->Value().data(), iter->Value().size());
+  }
+  if (!iter->Status().ok()) {
+    return iter->Status();
+  }
+  response.set_has_more(iter->Valid());
+
+  return butil::Status();
+}
+
+void LearnerManager::CleanExpiredSessions() {
+  int64_t now_ms = Helper::TimestampMs();
+  BAIDU_SCOPED_LOCK(mutex_);
+  for (auto it = snapshot_sessions_.begin(); it != snapshot_sessions_.end();) {
+    if (now_ms - it->second->last_access_ms > FLAGS_learner_snapshot_session_timeout_s * 1000) {
+      it = snapshot_sessions_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,114 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_STORE_LEARNER_H_
+#define DINGODB_STORE_LEARNER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "bvar/reducer.h"
+#include "common/runnable.h"
+#include "meta/store_meta_manager.h"
+#include "proto/common.pb.h"
+#include "proto/node.pb.h"
+#include "raft/dingo_filesystem_adaptor.h"
+#include "raft/store_state_machine.h"
+
+namespace dingodb {
+
+// Non-voting learner replicas, e.g. on the analytic stores, they serve follower/stale reads and coprocessor scans
+// without joining the quorum, so the heavy scans never slow the commits of leaders.
+// Learners are in the peers of region definition with LEARNER role but not in the raft configuration, the raft node
+// of learner never elects. Learner pulls the committed and applied data entries from a voter by PullRaftLog and
+// applies them in log order, a new learner or a learner behind the truncated log bootstraps by the data snapshot of
+// a voter first. The log changing region epoch, e.g. split and merge, is not applied by learner, it bootstraps again.
+class LearnerManager {
+ public:
+  static LearnerManager& GetInstance();
+
+  bool Init();
+  void Destroy();
+
+  // Region is the learner on this store.
+  static bool IsLearner(store::RegionPtr region);
+  static bool IsLearner(const std::vector<pb::common::Peer>& peers, int64_t store_id);
+
+  // Pull the log of learner regions, called by crontab.
+  static void SyncHandler(void*);
+  void Sync();
+
+  // Read index from leader and wait learner apply, like follower read.
+  butil::Status ValidateRead(int64_t region_id, int64_t timeout_ms);
+
+  // Voter serves the log of region.
+  static butil::Status PullRaftLog(const pb::node::PullRaftLogRequest& request,
+                                   pb::node::PullRaftLogResponse& response);
+  // Voter serves the data snapshot of region.
+  butil::Status GetSnapshot(const pb::node::GetLearnerSnapshotRequest& request,
+                            pb::node::GetLearnerSnapshotResponse& response);
+
+ private:
+  LearnerManager();
+
+  struct LearnerState {
+    // data is bootstrapped, reads are served.
+    bool ready{false};
+    bool need_bootstrap{false};
+    // bootstrap by the snapshot at or after the index, e.g. the stopped split log.
+    int64_t min_bootstrap_index{0};
+    bool is_syncing{false};
+    // index of voter to pull from, changed on failure.
+    size_t source_index{0};
+    pb::common::Location leader_location;
+  };
+  using LearnerStatePtr = std::shared_ptr<LearnerState>;
+
+  struct SnapshotSession {
+    int64_t region_id{0};
+    std::shared_ptr<SnapshotContext> snapshot_ctx;
+    int64_t last_access_ms{0};
+  };
+  using SnapshotSessionPtr = std::shared_ptr<SnapshotSession>;
+
+  LearnerStatePtr GetOrCreateState(store::RegionPtr region, std::shared_ptr<StoreStateMachine> state_machine);
+
+  void SyncRegion(store::RegionPtr region, std::shared_ptr<StoreStateMachine> state_machine);
+  butil::Status Bootstrap(store::RegionPtr region, std::shared_ptr<StoreStateMachine> state_machine,
+                          const butil::EndPoint& endpoint, int64_t min_index);
+  butil::Status PullAndApply(store::RegionPtr region, std::shared_ptr<StoreStateMachine> state_machine,
+                             const butil::EndPoint& endpoint, LearnerStatePtr state);
+
+  void CleanExpiredSessions();
+
+  PriorWorkerSetPtr worker_set_;
+
+  bthread::Mutex mutex_;
+  std::map<int64_t, LearnerStatePtr> learner_states_;
+  std::map<int64_t, SnapshotSessionPtr> snapshot_sessions_;
+  std::atomic<int64_t> next_session_id_{1};
+
+  bvar::Adder<int64_t> bvar_apply_log_count_;
+  bvar::Adder<int64_t> bvar_bootstrap_count_;
+  bvar::Adder<int64_t> bvar_bootstrap_bytes_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_STORE_LEARNER_H_
@@ -18,9 +18,12 @@
 #include <cassert>
 #include <cstdint>
 #include <memory>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "bthread/bthread.h"
 #include "butil/status.h"
 #include "common/helper.h"
 #include "common/logging.h"
@@ -39,15 +42,25 @@
 #include "proto/error.pb.h"
 #include "proto/raft.pb.h"
 #include "server/server.h"
+#include "store/cdc.h"
 #include "store/heartbeat.h"
+#include "store/region_hash.h"
+#include "store/sst_ingest.h"
 #include "vector/codec.h"
 #include "vector/vector_index_hnsw.h"
 
 DEFINE_int64(merge_committed_log_gap, 16, "merge commited log gap");
 DEFINE_int32(init_election_timeout_ms, 1000, "init election timeout");
+DEFINE_int32(region_control_share_executor_num, 4, "share region control executor num, e.g. for PURGE");
+DEFINE_bool(enable_region_delete_files_in_range, false,
+            "delete region drop the sst files fully covered by region range, then compact the range in background");
+DEFINE_bool(enable_create_region_first_peer_leader, false,
+            "the first peer of new region is preferred to be leader, so coordinator can scatter the leaders");
 
 namespace dingodb {
 
+DECLARE_int32(vector_index_warm_follower_num);
+
 // Notify coordinator region command execute result.
 static void NotifyRegionCmdStatus(RegionCmdPtr region_cmd, butil::Status status) {
   auto coordinatro_interaction = Server::GetInstance().GetCoordinatorInteraction();
@@ -148,6 +161,11 @@ butil::Status CreateRegionTask::CreateRegion(const pb::common::RegionDefinition&
   auto config = ConfigManager::GetInstance().GetRoleConfig();
   parameter.raft_path = config->GetString("raft.path");
   parameter.election_timeout_ms = FLAGS_init_election_timeout_ms;
+  // like the child of split prefers the leader of parent, the other peers wait longer to elect.
+  if (FLAGS_enable_create_region_first_peer_leader && parent_region_id == 0 && definition.peers_size() > 1 &&
+      definition.peers(0).store_id() != Server::GetInstance().Id()) {
+    parameter.election_timeout_ms = 3 * FLAGS_init_election_timeout_ms;
+  }
   parameter.log_max_segment_size = config->GetInt64("raft.segmentlog_max_segment_size");
   parameter.log_path = config->GetString("raft.log_path");
 
@@ -252,6 +270,9 @@ butil::Status DeleteRegionTask::DeleteRegion(std::shared_ptr<Context> ctx, int64
     Server::GetInstance().GetLogStorageManager()->DeleteStorage(region_id);
   }
 
+  // Close change streams
+  CdcManager::GetInstance().Remove(region_id);
+
   // Update state
   DINGO_LOG(DEBUG) << fmt::format("[control.region][region({})] delete region, update region state DELETED", region_id);
   store_region_meta->UpdateState(region, pb::common::StoreRegionState::DELETED);
@@ -278,6 +299,9 @@ butil::Status DeleteRegionTask::DeleteRegion(std::shared_ptr<Context> ctx, int64
         DINGO_LOG(FATAL) << fmt::format("[control.region][region({})] delete region data raw failed, error: {}",
                                         region->Id(), status.error_str());
       }
+      if (FLAGS_enable_region_delete_files_in_range) {
+        DeleteRegionFiles(region_raw_engine, region_id, raw_cf_names, region->Range());
+      }
     }
 
     if (!txn_cf_names.empty()) {
@@ -287,9 +311,17 @@ butil::Status DeleteRegionTask::DeleteRegion(std::shared_ptr<Context> ctx, int64
         DINGO_LOG(FATAL) << fmt::format("[control.region][region({})] delete region data txn failed, error: {}",
                                         region->Id(), status.error_str());
       }
+      if (FLAGS_enable_region_delete_files_in_range) {
+        DeleteRegionFiles(region_raw_engine, region_id, txn_cf_names, txn_range);
+      }
     }
   }
 
+  // Delete not ingested sst files of bulk load
+  SstIngestManager::CleanFiles(region_id);
+
+  RegionHashManager::GetInstance().Reset(region_id);
+
   // Index region
   if (GetRole() == pb::common::ClusterRole::INDEX) {
     auto vector_index_wrapper = region->VectorIndexWrapper();
@@ -324,6 +356,47 @@ butil::Status DeleteRegionTask::DeleteRegion(std::shared_ptr<Context> ctx, int64
   return butil::Status();
 }
 
+struct CompactRangeArg {
+  RawEnginePtr raw_engine;
+  int64_t region_id;
+  std::vector<std::pair<std::string, pb::common::Range>> cf_ranges;
+};
+
+static void* RunCompactRange(void* arg) {
+  std::unique_ptr<CompactRangeArg> compact_arg(static_cast<CompactRangeArg*>(arg));
+  int64_t start_time = Helper::TimestampMs();
+  for (const auto& [cf_name, range] : compact_arg->cf_ranges) {
+    compact_arg->raw_engine->CompactRange(cf_name, range);
+  }
+  DINGO_LOG(INFO) << fmt::format("[control.region][region({})] compact deleted range finish, elapsed time {}ms",
+                                 compact_arg->region_id, Helper::TimestampMs() - start_time);
+
+  return nullptr;
+}
+
+// Range delete only write tombstones, scan of neighbor regions skip them until compacted.
+// Drop the files fully inside range at once, the left tombstones and partially covered files are compacted
+// in background.
+static void DeleteRegionFiles(RawEnginePtr raw_engine, int64_t region_id, const std::vector<std::string>& cf_names,
+                              const pb::common::Range& range) {
+  auto* compact_arg = new CompactRangeArg{raw_engine, region_id, {}};
+  for (const auto& cf_name : cf_names) {
+    auto status = raw_engine->DeleteFilesInRange(cf_name, range);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[control.region][region({})] delete files in range failed, cf: {} error: {}",
+                                        region_id, cf_name, status.error_str());
+      continue;
+    }
+    compact_arg->cf_ranges.emplace_back(cf_name, range);
+  }
+
+  bthread_t tid;
+  if (compact_arg->cf_ranges.empty() ||
+      bthread_start_background(&tid, &BTHREAD_ATTR_NORMAL, RunCompactRange, compact_arg) != 0) {
+    delete compact_arg;
+  }
+}
+
 void DeleteRegionTask::Run() {
   auto status = DeleteRegion(ctx_, region_cmd_->delete_request().region_id());
   if (!status.ok()) {
@@ -866,9 +939,31 @@ butil::Status ChangeRegionTask::ChangeRegion(std::shared_ptr<Context> ctx, Regio
     return peers;
   };
 
+  auto region = store_meta_manager->GetStoreRegionMeta()->GetRegion(region_definition.id());
+  auto is_same_peers = [](const std::vector<pb::common::Peer>& lhs, const std::vector<pb::common::Peer>& rhs) {
+    std::set<int64_t> lhs_store_ids;
+    std::set<int64_t> rhs_store_ids;
+    for (const auto& peer : lhs) lhs_store_ids.insert(peer.store_id());
+    for (const auto& peer : rhs) rhs_store_ids.insert(peer.store_id());
+    return lhs_store_ids == rhs_store_ids;
+  };
+
+  // Learners are not in raft configuration, replicate them by raft log to every replica.
+  auto learners = filter_peers_by_role(pb::common::LEARNER);
+  if (!is_same_peers(learners, region->Peers(pb::common::LEARNER))) {
+    auto write_ctx = std::make_shared<Context>();
+    write_ctx->SetRegionId(region->Id());
+    write_ctx->SetRegionEpoch(region->Epoch());
+    status = Server::GetInstance().GetEngine()->Write(write_ctx, WriteDataBuilder::BuildChangeLearnerWrite(learners));
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  auto voters = filter_peers_by_role(pb::common::VOTER);
   auto raft_store_engine = Server::GetInstance().GetRaftStoreEngine();
-  if (raft_store_engine != nullptr) {
-    return raft_store_engine->ChangeNode(ctx, region_definition.id(), filter_peers_by_role(pb::common::VOTER));
+  if (raft_store_engine != nullptr && !is_same_peers(voters, region->Peers(pb::common::VOTER))) {
+    return raft_store_engine->ChangeNode(ctx, region_definition.id(), voters);
   }
 
   return butil::Status();
@@ -916,6 +1011,12 @@ butil::Status TransferLeaderTask::ValidateTransferLeader(std::shared_ptr<StoreMe
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Raft location is invalid.");
   }
 
+  // The vector index of cold follower is not loaded, search fallback to brute force after transfer.
+  if (region->Type() == pb::common::INDEX_REGION && FLAGS_vector_index_warm_follower_num > 0 &&
+      !Helper::IsVectorIndexWarmPeer(region->Definition(), peer.store_id(), FLAGS_vector_index_warm_follower_num)) {
+    return butil::Status(pb::error::ERAFT_TRANSFER_LEADER, "The peer is not warm vector index follower.");
+  }
+
   return butil::Status();
 }
 
@@ -1552,10 +1653,14 @@ void RegionCommandManager::TransformFromKv(const std::vector<pb::common::KeyValu
 }
 
 bool RegionController::Init() {
-  share_executor_ = std::make_shared<ControlExecutor>();
-  if (!share_executor_->Init()) {
-    DINGO_LOG(ERROR) << "[control.region] share executor init failed.";
-    return false;
+  int32_t share_executor_num = std::max(1, FLAGS_region_control_share_executor_num);
+  for (int32_t i = 0; i < share_executor_num; ++i) {
+    auto share_executor = std::make_shared<ControlExecutor>();
+    if (!share_executor->Init()) {
+      DINGO_LOG(ERROR) << "[control.region] share executor init failed.";
+      return false;
+    }
+    share_executors_.push_back(share_executor);
   }
 
   auto regions = Server::GetInstance().GetAllAliveRegion();
@@ -1593,7 +1698,9 @@ void RegionController::Destroy() {
     executor->Stop();
   }
 
-  share_executor_->Stop();
+  for (auto& share_executor : share_executors_) {
+    share_executor->Stop();
+  }
 }
 
 std::vector<int64_t> RegionController::GetAllRegion() {
@@ -1647,6 +1754,14 @@ std::shared_ptr<RegionControlExecutor> RegionController::GetRegionControlExecuto
   return it->second;
 }
 
+std::shared_ptr<ControlExecutor> RegionController::GetShareExecutor(int64_t region_id) {
+  if (share_executors_.empty()) {
+    return nullptr;
+  }
+
+  return share_executors_[static_cast<uint64_t>(region_id) % share_executors_.size()];
+}
+
 butil::Status RegionController::InnerDispatchRegionControlCommand(std::shared_ptr<Context> ctx, RegionCmdPtr command) {
   DINGO_LOG(DEBUG) << fmt::format("[control.region][region({})] dispatch region control command, commad id: {} {}",
                                   command->region_id(), command->id(),
@@ -1659,7 +1774,7 @@ butil::Status RegionController::InnerDispatchRegionControlCommand(std::shared_pt
 
   auto executor = (command->region_cmd_type() == pb::coordinator::RegionCmdType::CMD_PURGE ||
                    command->region_cmd_type() == pb::coordinator::RegionCmdType::CMD_DESTROY_EXECUTOR)
-                      ? share_executor_
+                      ? GetShareExecutor(command->region_id())
                       : GetRegionControlExecutor(command->region_id());
   if (executor == nullptr) {
     DINGO_LOG(ERROR) << fmt::format("[control.region][region({})] not find region control executor.",
@@ -406,13 +406,15 @@ class RegionController {
 
  private:
   std::shared_ptr<RegionControlExecutor> GetRegionControlExecutor(int64_t region_id);
+  std::shared_ptr<ControlExecutor> GetShareExecutor(int64_t region_id);
   butil::Status InnerDispatchRegionControlCommand(std::shared_ptr<Context> ctx, RegionCmdPtr command);
 
   bthread_mutex_t mutex_;
   std::unordered_map<int64_t, std::shared_ptr<RegionControlExecutor>> executors_;
 
   // When have no regoin executor, used this executorm, like PURGE.
-  std::shared_ptr<ControlExecutor> share_executor_;
+  // Region is hashed to one of them, so commands of a region keep order and different regions run in parallel.
+  std::vector<std::shared_ptr<ControlExecutor>> share_executors_;
 
   // task builder
   using TaskBuildFunc = std::function<TaskRunnablePtr(std::shared_ptr<Context>, RegionCmdPtr)>;
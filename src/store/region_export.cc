@@ -0,0 +1,310 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "store/region_export.h"
+
+#include <any>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "coprocessor/coprocessor_v2.h"
+#include "coprocessor/utils.h"
+#include "engine/txn_engine_helper.h"
+#include "engine/txn_resolved_ts.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "google/protobuf/util/delimited_message_util.h"
+#include "proto/error.pb.h"
+#include "serial/record_decoder.h"
+
+namespace dingodb {
+
+DEFINE_int64(export_batch_rows, 8192, "default max scanned rows of one export batch");
+
+static const std::string kExportMetaFileName = "exportmeta";
+static const std::string kExportDataFileName = "data";
+
+template <typename T>
+static bool GetColumnValue(const std::any& column, std::optional<T>& value) {
+  const auto* ptr = std::any_cast<std::optional<T>>(&column);
+  if (ptr == nullptr) {
+    return false;
+  }
+  value = *ptr;
+  return true;
+}
+
+butil::Status RegionExport::InitBatch(const google::protobuf::RepeatedPtrField<pb::common::Schema>& schemas,
+                                      pb::store::ExportBatch& batch) {
+  batch.Clear();
+  for (const auto& schema : schemas) {
+    switch (schema.type()) {
+      case pb::common::Schema::BOOL:
+      case pb::common::Schema::INTEGER:
+      case pb::common::Schema::FLOAT:
+      case pb::common::Schema::LONG:
+      case pb::common::Schema::DOUBLE:
+      case pb::common::Schema::STRING:
+        break;
+      default:
+        return butil::Status(pb::error::ENOT_SUPPORT, "Not support export column %s of type %s",
+                             schema.name().c_str(), pb::common::Schema::Type_Name(schema.type()).c_str());
+    }
+
+    auto* column = batch.add_columns();
+    column->set_name(schema.name());
+    column->set_type(schema.type());
+  }
+
+  return butil::Status();
+}
+
+butil::Status RegionExport::AppendRecord(const std::vector<std::any>& record, pb::store::ExportBatch& batch) {
+  if (record.size() != static_cast<size_t>(batch.columns_size())) {
+    return butil::Status(pb::error::EINTERNAL, "Record size %zu not match column size %d", record.size(),
+                         batch.columns_size());
+  }
+
+  for (int i = 0; i < batch.columns_size(); ++i) {
+    auto* column = batch.mutable_columns(i);
+    bool ok = false;
+    bool is_null = true;
+    switch (column->type()) {
+      case pb::common::Schema::BOOL: {
+        std::optional<bool> value;
+        ok = GetColumnValue(record[i], value);
+        if (ok && value.has_value()) {
+          is_null = false;
+          column->add_long_values(value.value() ? 1 : 0);
+        }
+        break;
+      }
+      case pb::common::Schema::INTEGER: {
+        std::optional<int32_t> value;
+        ok = GetColumnValue(record[i], value);
+        if (ok && value.has_value()) {
+          is_null = false;
+          column->add_long_values(value.value());
+        }
+        break;
+      }
+      case pb::common::Schema::FLOAT: {
+        std::optional<float> value;
+        ok = GetColumnValue(record[i], value);
+        if (ok && value.has_value()) {
+          is_null = false;
+          column->add_double_values(value.value());
+        }
+        break;
+      }
+      case pb::common::Schema::LONG: {
+        std::optional<int64_t> value;
+        ok = GetColumnValue(record[i], value);
+        if (ok && value.has_value()) {
+          is_null = false;
+          column->add_long_values(value.value());
+        }
+        break;
+      }
+      case pb::common::Schema::DOUBLE: {
+        std::optional<double> value;
+        ok = GetColumnValue(record[i], value);
+        if (ok && value.has_value()) {
+          is_null = false;
+          column->add_double_values(value.value());
+        }
+        break;
+      }
+      case pb::common::Schema::STRING: {
+        std::optional<std::shared_ptr<std::string>> value;
+        ok = GetColumnValue(record[i], value);
+        if (ok && value.has_value() && value.value() != nullptr) {
+          is_null = false;
+          column->add_string_values(*value.value());
+        }
+        break;
+      }
+      default:
+        break;
+    }
+
+    if (!ok) {
+      return butil::Status(pb::error::EINTERNAL, "Column %s value not match type %s", column->name().c_str(),
+                           pb::common::Schema::Type_Name(column->type()).c_str());
+    }
+    column->add_is_null(is_null);
+  }
+
+  batch.set_row_count(batch.row_count() + 1);
+  return butil::Status();
+}
+
+butil::Status RegionExport::Export(store::RegionPtr region, RawEnginePtr raw_engine, int64_t export_ts,
+                                   const pb::common::CoprocessorV2& coprocessor, const std::string& export_path,
+                                   int64_t batch_rows, pb::store::ExportRegionMeta& meta) {
+  int64_t start_time = Helper::TimestampMs();
+
+  std::vector<std::string> raw_cf_names;
+  std::vector<std::string> txn_cf_names;
+  Helper::GetColumnFamilyNames(region->Range().start_key(), raw_cf_names, txn_cf_names);
+  if (txn_cf_names.empty()) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Only txn region support export");
+  }
+
+  // every lock with lock_ts <= resolved ts is committed or rolled back, no lock is met when scanning.
+  int64_t resolved_ts = TxnResolvedTsManager::GetInstance().GetResolvedTs(region->Id());
+  if (resolved_ts < export_ts) {
+    return butil::Status(pb::error::EBACKUP_TS_NOT_RESOLVED, "Resolved ts %ld is behind export ts %ld, retry later",
+                         resolved_ts, export_ts);
+  }
+
+  pb::store::ExportBatch empty_batch;
+  auto status = InitBatch(coprocessor.result_schema().schema(), empty_batch);
+  if (!status.ok()) {
+    return status;
+  }
+
+  auto result_serial_schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+  status = Utils::TransToSerialSchema(coprocessor.result_schema().schema(), &result_serial_schemas);
+  if (!status.ok()) {
+    return status;
+  }
+  RecordDecoder result_decoder(coprocessor.schema_version(), result_serial_schemas,
+                               coprocessor.result_schema().common_id());
+
+  auto txn_coprocessor = std::make_shared<CoprocessorV2>();
+  status = txn_coprocessor->Open(CoprocessorPbWrapper{coprocessor});
+  if (!status.ok()) {
+    return status;
+  }
+
+  auto txn_iter = std::make_shared<TxnIterator>(raw_engine, region->Range(), export_ts, pb::store::SnapshotIsolation,
+                                                std::set<int64_t>());
+  status = txn_iter->Init();
+  if (!status.ok()) {
+    return status;
+  }
+  txn_iter->Seek(region->Range().start_key());
+
+  std::string region_export_path = fmt::format("{}/{}", export_path, region->Id());
+  Helper::RemoveAllFileOrDirectory(region_export_path);
+  status = Helper::CreateDirectories(region_export_path);
+  if (!status.ok()) {
+    return status;
+  }
+
+  meta.set_region_id(region->Id());
+  *meta.mutable_range() = region->Range();
+  *meta.mutable_epoch() = region->Epoch();
+  meta.set_export_ts(export_ts);
+  *meta.mutable_schema() = coprocessor.result_schema().schema();
+  auto* file = meta.add_files();
+  file->set_filename(kExportDataFileName);
+
+  std::string data_path = fmt::format("{}/{}", region_export_path, kExportDataFileName);
+  std::string tmp_data_path = data_path + ".tmp";
+  std::ofstream data_file(tmp_data_path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+  if (!data_file.is_open()) {
+    status = butil::Status(pb::error::EINTERNAL, "Open file %s failed", tmp_data_path.c_str());
+  }
+
+  batch_rows = batch_rows > 0 ? batch_rows : FLAGS_export_batch_rows;
+  bool has_more = true;
+  while (status.ok() && has_more) {
+    pb::store::TxnResultInfo txn_result_info;
+    std::vector<pb::common::KeyValue> kvs;
+    std::string end_key;
+    has_more = false;
+    status = txn_coprocessor->Execute(txn_iter, batch_rows, false, false, txn_result_info, kvs, has_more, end_key);
+    if (!status.ok()) {
+      break;
+    }
+    if (txn_result_info.ByteSizeLong() > 0) {
+      status = butil::Status(pb::error::EBACKUP_TS_NOT_RESOLVED, "Meet txn error %s, retry later",
+                             txn_result_info.ShortDebugString().c_str());
+      break;
+    }
+    if (kvs.empty()) {
+      continue;
+    }
+
+    pb::store::ExportBatch batch = empty_batch;
+    std::vector<std::any> record;
+    for (const auto& kv : kvs) {
+      record.clear();
+      if (result_decoder.Decode(kv.key(), kv.value(), record) != 0) {
+        status = butil::Status(pb::error::EINTERNAL, "Decode result record failed");
+        break;
+      }
+      status = AppendRecord(record, batch);
+      if (!status.ok()) {
+        break;
+      }
+    }
+
+    if (status.ok() && !google::protobuf::util::SerializeDelimitedToOstream(batch, &data_file)) {
+      status = butil::Status(pb::error::EINTERNAL, "Write file %s failed", tmp_data_path.c_str());
+    }
+    file->set_batch_count(file->batch_count() + 1);
+    file->set_row_count(file->row_count() + batch.row_count());
+  }
+  txn_coprocessor->Close();
+
+  if (status.ok()) {
+    data_file.close();
+    if (data_file.fail()) {
+      status = butil::Status(pb::error::EINTERNAL, "Write file %s failed", tmp_data_path.c_str());
+    }
+  }
+  if (status.ok()) {
+    file->set_size(Helper::GetFileSize(tmp_data_path));
+    status = Helper::Rename(tmp_data_path, data_path);
+  }
+
+  // The epoch may be changed by split or merge while scanning.
+  if (status.ok() && !Helper::IsEqualRegionEpoch(meta.epoch(), region->Epoch())) {
+    status = butil::Status(pb::error::EREGION_VERSION, "Region epoch changed while export, retry later");
+  }
+
+  if (status.ok()) {
+    std::ofstream meta_file(fmt::format("{}/{}", region_export_path, kExportMetaFileName),
+                            std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    if (!meta_file.is_open() || !meta.SerializeToOstream(&meta_file)) {
+      status = butil::Status(pb::error::EINTERNAL, "Write export meta file failed");
+    }
+  }
+
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[export][region({})] export failed, path: {} error: {}", region->Id(),
+                                    region_export_path, Helper::PrintStatus(status));
+    Helper::RemoveAllFileOrDirectory(region_export_path);
+    return status;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[export][region({})] export finish, path: {} export_ts: {} batches: {} rows: {}",
+                                 region->Id(), region_export_path, export_ts, file->batch_count(), file->row_count())
+                  << fmt::format(" size: {} elapsed time {}ms", file->size(), Helper::TimestampMs() - start_time);
+
+  return butil::Status();
+}
+
+}  // namespace dingodb
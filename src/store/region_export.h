@@ -0,0 +1,50 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_STORE_REGION_EXPORT_H_  // NOLINT
+#define DINGODB_STORE_REGION_EXPORT_H_
+
+#include <any>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "engine/raw_engine.h"
+#include "meta/store_meta_manager.h"
+#include "proto/common.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+// Export the rows of txn region column major for analytic jobs, instead of decoding rows by the executor.
+// The leader scans the region at export_ts by the coprocessor v2, which projects and filters the rows, and converts
+// every scanned batch of rows to ExportBatch by the result schema. The batches are written length delimited to
+// export_path/region_id/data, and the meta file is written at last.
+class RegionExport {
+ public:
+  static butil::Status Export(store::RegionPtr region, RawEnginePtr raw_engine, int64_t export_ts,
+                              const pb::common::CoprocessorV2& coprocessor, const std::string& export_path,
+                              int64_t batch_rows, pb::store::ExportRegionMeta& meta);
+
+  // Create the empty columns of batch by the schemas, the list type is not supported.
+  static butil::Status InitBatch(const google::protobuf::RepeatedPtrField<pb::common::Schema>& schemas,
+                                 pb::store::ExportBatch& batch);
+  // Append the record decoded by serial to the columns of batch.
+  static butil::Status AppendRecord(const std::vector<std::any>& record, pb::store::ExportBatch& batch);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_STORE_REGION_EXPORT_H_  // NOLINT
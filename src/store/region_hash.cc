@@ -0,0 +1,530 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "store/region_hash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "butil/crc32c.h"
+#include "common/constant.h"
+#include "common/context.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/service_access.h"
+#include "engine/iterator.h"
+#include "engine/raft_store_engine.h"
+#include "engine/write_data.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "proto/node.pb.h"
+#include "server/server.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_region_hash_check, false, "check the consistency of region replicas by bucket hashes");
+DEFINE_int64(region_hash_check_interval_s, 3600, "interval of region hash checkpoint and comparing replicas");
+DEFINE_int32(region_hash_bucket_num, 64, "bucket num of region hash");
+DEFINE_int32(region_hash_full_check_rounds, 24, "scan all buckets every rounds, 0 is never");
+DEFINE_int64(region_hash_max_bytes_per_s, 16L * 1024 * 1024, "rate limit of scanning buckets, 0 is no limit");
+DEFINE_uint32(region_hash_worker_num, 1, "worker num of computing region hash");
+
+class RegionHashTask : public TaskRunnable {
+ public:
+  using Handler = std::function<void()>;
+  explicit RegionHashTask(Handler handler) : handler_(std::move(handler)) {}
+  ~RegionHashTask() override = default;
+
+  std::string Type() override { return "REGION_HASH"; }
+
+  void Run() override { handler_(); }
+
+ private:
+  Handler handler_;
+};
+
+static bool IsTxnColumnFamily(const std::string& cf_name) {
+  return cf_name == Constant::kTxnDataCF || cf_name == Constant::kTxnLockCF || cf_name == Constant::kTxnWriteCF;
+}
+
+static bool IsEqualRange(const pb::common::Range& a, const pb::common::Range& b) {
+  return a.start_key() == b.start_key() && a.end_key() == b.end_key();
+}
+
+RegionHashManager::RegionHashManager()
+    : bvar_checkpoint_count_("dingo_region_hash_checkpoint_count"),
+      bvar_scan_bucket_count_("dingo_region_hash_scan_bucket_count"),
+      bvar_mismatch_count_("dingo_region_hash_mismatch_count") {}
+
+RegionHashManager& RegionHashManager::GetInstance() {
+  static RegionHashManager instance;
+  return instance;
+}
+
+bool RegionHashManager::Init() {
+  // Scan blocks the worker for long, always use pthread.
+  worker_set_ = PriorWorkerSet::New("region_hash", FLAGS_region_hash_worker_num, 0, true);
+  return worker_set_->Init();
+}
+
+void RegionHashManager::Destroy() {
+  if (worker_set_ != nullptr) {
+    worker_set_->Destroy();
+  }
+}
+
+size_t RegionHashManager::BucketIndex(const std::vector<std::string>& bucket_keys, const std::string& key) {
+  return std::upper_bound(bucket_keys.begin(), bucket_keys.end(), key) - bucket_keys.begin();
+}
+
+std::vector<pb::common::Range> RegionHashManager::BucketRanges(const pb::common::Range& range,
+                                                               const std::vector<std::string>& bucket_keys) {
+  std::vector<pb::common::Range> ranges;
+  ranges.reserve(bucket_keys.size() + 1);
+  for (size_t i = 0; i <= bucket_keys.size(); ++i) {
+    pb::common::Range bucket_range;
+    bucket_range.set_start_key(i == 0 ? range.start_key() : bucket_keys[i - 1]);
+    bucket_range.set_end_key(i == bucket_keys.size() ? range.end_key() : bucket_keys[i]);
+    ranges.push_back(std::move(bucket_range));
+  }
+
+  return ranges;
+}
+
+std::vector<size_t> RegionHashManager::CompareCheckpoint(const HashCheckpoint& local, const HashCheckpoint& remote) {
+  std::vector<size_t> mismatches;
+  if (!IsEqualRange(local.range, remote.range) || local.bucket_keys != remote.bucket_keys ||
+      local.hashes.size() != remote.hashes.size()) {
+    for (size_t i = 0; i < local.hashes.size(); ++i) {
+      mismatches.push_back(i);
+    }
+    return mismatches;
+  }
+
+  for (size_t i = 0; i < local.hashes.size(); ++i) {
+    if (local.hashes[i] != remote.hashes[i]) {
+      mismatches.push_back(i);
+    }
+  }
+
+  return mismatches;
+}
+
+void RegionHashManager::MarkDirtyRange(RegionState& state, const std::string& start_key, const std::string& end_key) {
+  if (state.all_dirty) {
+    return;
+  }
+
+  size_t start = BucketIndex(state.bucket_keys, start_key);
+  // end key is exclusive, the bucket starting at end key is not written.
+  size_t end = end_key.empty()
+                   ? state.bucket_keys.size()
+                   : std::lower_bound(state.bucket_keys.begin(), state.bucket_keys.end(), end_key) -
+                         state.bucket_keys.begin();
+  for (size_t i = start; i <= end && i < state.dirty.size(); ++i) {
+    state.dirty[i] = true;
+  }
+}
+
+void RegionHashManager::MarkDirty(int64_t region_id, const pb::raft::RaftCmdRequest& raft_cmd) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = region_states_.find(region_id);
+  if (it == region_states_.end()) {
+    return;
+  }
+
+  auto& state = *it->second;
+  for (const auto& req : raft_cmd.requests()) {
+    if (state.all_dirty) {
+      return;
+    }
+
+    switch (req.cmd_type()) {
+      case pb::raft::CmdType::PUT:
+        for (const auto& kv : req.put().kvs()) {
+          state.dirty[BucketIndex(state.bucket_keys, kv.key())] = true;
+        }
+        break;
+      case pb::raft::CmdType::PUTIFABSENT:
+        for (const auto& kv : req.put_if_absent().kvs()) {
+          state.dirty[BucketIndex(state.bucket_keys, kv.key())] = true;
+        }
+        break;
+      case pb::raft::CmdType::COMPAREANDSET:
+        for (const auto& kv : req.compare_and_set().kvs()) {
+          state.dirty[BucketIndex(state.bucket_keys, kv.key())] = true;
+        }
+        break;
+      case pb::raft::CmdType::DELETEBATCH:
+        for (const auto& key : req.delete_batch().keys()) {
+          state.dirty[BucketIndex(state.bucket_keys, key)] = true;
+        }
+        break;
+      case pb::raft::CmdType::DELETERANGE:
+        // Keys of txn column families are encoded, not comparable with the bucket keys.
+        if (IsTxnColumnFamily(req.delete_range().cf_name())) {
+          state.all_dirty = true;
+          break;
+        }
+        for (const auto& range : req.delete_range().ranges()) {
+          MarkDirtyRange(state, range.start_key(), range.end_key());
+        }
+        break;
+      case pb::raft::CmdType::COMPUTE_HASH:
+      case pb::raft::CmdType::CHANGE_LEARNER:
+      case pb::raft::CmdType::SAVE_RAFT_SNAPSHOT:
+      case pb::raft::CmdType::NONE:
+        break;
+      default:
+        // txn, vector, ingest sst and region change, not worth tracking the keys of them.
+        state.all_dirty = true;
+        break;
+    }
+  }
+}
+
+void RegionHashManager::Reset(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  region_states_.erase(region_id);
+}
+
+bool RegionHashManager::GetCheckpoint(int64_t region_id, HashCheckpoint& checkpoint) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = region_states_.find(region_id);
+  if (it == region_states_.end() || !it->second->has_checkpoint) {
+    return false;
+  }
+
+  checkpoint = it->second->checkpoint;
+  return true;
+}
+
+butil::Status RegionHashManager::HashBuckets(RawEnginePtr raw_engine, SnapshotPtr snapshot,
+                                             const HashCheckpoint& checkpoint, const std::vector<bool>& need_scans,
+                                             std::vector<uint32_t>& hashes) {
+  std::vector<std::string> raw_cf_names;
+  std::vector<std::string> txn_cf_names;
+  Helper::GetColumnFamilyNames(checkpoint.range.start_key(), raw_cf_names, txn_cf_names);
+
+  auto reader = raw_engine->Reader();
+  auto bucket_ranges = BucketRanges(checkpoint.range, checkpoint.bucket_keys);
+  int64_t start_time = Helper::TimestampMs();
+  int64_t scan_bytes = 0;
+  for (size_t i = 0; i < bucket_ranges.size(); ++i) {
+    if (!need_scans[i]) {
+      continue;
+    }
+
+    std::vector<std::pair<std::string, pb::common::Range>> cf_ranges;
+    for (const auto& cf_name : raw_cf_names) {
+      cf_ranges.emplace_back(cf_name, bucket_ranges[i]);
+    }
+    if (!txn_cf_names.empty()) {
+      auto txn_range = Helper::GetMemComparableRange(bucket_ranges[i]);
+      for (const auto& cf_name : txn_cf_names) {
+        cf_ranges.emplace_back(cf_name, txn_range);
+      }
+    }
+
+    // Length prefixed key and value in key order, the hash differs when any key or value differs.
+    uint32_t hash = 0;
+    for (const auto& [cf_name, range] : cf_ranges) {
+      IteratorOptions options;
+      options.lower_bound = range.start_key();
+      options.upper_bound = range.end_key();
+      auto iter = reader->NewIterator(cf_name, snapshot, options);
+      if (iter == nullptr) {
+        return butil::Status(pb::error::EINTERNAL, "New iterator failed, cf: %s", cf_name.c_str());
+      }
+
+      for (iter->Seek(range.start_key()); iter->Valid(); iter->Next()) {
+        auto key = iter->Key();
+        auto value = iter->Value();
+        uint32_t key_size = key.size();
+        uint32_t value_size = value.size();
+        hash = butil::crc32c::Extend(hash, reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+        hash = butil::crc32c::Extend(hash, key.data(), key.size());
+        hash = butil::crc32c::Extend(hash, reinterpret_cast<const char*>(&value_size), sizeof(value_size));
+        hash = butil::crc32c::Extend(hash, value.data(), value.size());
+        scan_bytes += key.size() + value.size();
+      }
+      if (!iter->Status().ok()) {
+        return iter->Status();
+      }
+    }
+    hashes[i] = hash;
+
+    // Keep the average scan byte rate.
+    if (FLAGS_region_hash_max_bytes_per_s > 0) {
+      int64_t expect_ms = scan_bytes * 1000 / FLAGS_region_hash_max_bytes_per_s;
+      int64_t elapsed_ms = Helper::TimestampMs() - start_time;
+      if (expect_ms > elapsed_ms) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(expect_ms - elapsed_ms));
+      }
+    }
+  }
+
+  return butil::Status();
+}
+
+void RegionHashManager::Checkpoint(store::RegionPtr region, RawEnginePtr raw_engine,
+                                   const pb::raft::ComputeHashRequest& request, int64_t log_id) {
+  if (!FLAGS_enable_region_hash_check || worker_set_ == nullptr) {
+    return;
+  }
+
+  int64_t region_id = region->Id();
+  HashCheckpoint checkpoint;
+  checkpoint.log_id = log_id;
+  checkpoint.epoch = region->Epoch();
+  checkpoint.range = region->Range();
+  checkpoint.bucket_keys = Helper::PbRepeatedToVector(request.bucket_keys());
+
+  // Bucket keys must be sorted and inside range, all replicas reject the same illegal request.
+  const auto& bucket_keys = checkpoint.bucket_keys;
+  for (size_t i = 0; i < bucket_keys.size(); ++i) {
+    if (bucket_keys[i] <= checkpoint.range.start_key() || bucket_keys[i] >= checkpoint.range.end_key() ||
+        (i > 0 && bucket_keys[i] <= bucket_keys[i - 1])) {
+      DINGO_LOG(WARNING) << fmt::format("[region_hash][region({})] bucket keys are illegal, log_id({})", region_id,
+                                        log_id);
+      return;
+    }
+  }
+
+  size_t bucket_num = bucket_keys.size() + 1;
+  std::vector<bool> need_scans(bucket_num, true);
+  std::vector<uint32_t> hashes(bucket_num, 0);
+  RegionStatePtr state;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto& region_state = region_states_[region_id];
+    if (region_state == nullptr) {
+      region_state = std::make_shared<RegionState>();
+    }
+    state = region_state;
+
+    // Keep the dirty marks, the next checkpoint scans them.
+    if (state->is_computing) {
+      DINGO_LOG(INFO) << fmt::format("[region_hash][region({})] last checkpoint is computing, skip log_id({})",
+                                     region_id, log_id);
+      return;
+    }
+
+    bool is_reuse = !request.full() && state->has_checkpoint && !state->all_dirty &&
+                    IsEqualRange(state->checkpoint.range, checkpoint.range) &&
+                    state->checkpoint.bucket_keys == bucket_keys;
+    if (is_reuse) {
+      need_scans = state->dirty;
+      hashes = state->checkpoint.hashes;
+    }
+
+    state->range = checkpoint.range;
+    state->bucket_keys = bucket_keys;
+    state->dirty.assign(bucket_num, false);
+    state->all_dirty = false;
+    state->is_computing = true;
+  }
+
+  // Apply is serial, the snapshot is exactly the data at log_id.
+  auto snapshot = raw_engine->GetSnapshot();
+  auto task = std::make_shared<RegionHashTask>([this, region_id, raw_engine, snapshot, state, checkpoint, need_scans,
+                                                hashes]() mutable {
+    int64_t start_time = Helper::TimestampMs();
+    auto status = HashBuckets(raw_engine, snapshot, checkpoint, need_scans, hashes);
+    int64_t scan_count = std::count(need_scans.begin(), need_scans.end(), true);
+
+    BAIDU_SCOPED_LOCK(mutex_);
+    state->is_computing = false;
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[region_hash][region({})] compute hash failed, log_id({}) error: {}",
+                                        region_id, checkpoint.log_id, status.error_str());
+      state->all_dirty = true;
+      return;
+    }
+
+    checkpoint.hashes = std::move(hashes);
+    state->checkpoint = std::move(checkpoint);
+    state->has_checkpoint = true;
+    ++state->checkpoint_count;
+    bvar_checkpoint_count_ << 1;
+    bvar_scan_bucket_count_ << scan_count;
+    DINGO_LOG(INFO) << fmt::format(
+        "[region_hash][region({})] compute hash finish, log_id({}) scan buckets({}/{}) elapsed time {}ms", region_id,
+        state->checkpoint.log_id, scan_count, need_scans.size(), Helper::TimestampMs() - start_time);
+  });
+  task->SetLane(TaskLane::kBackground);
+
+  if (!worker_set_->Execute(task)) {
+    BAIDU_SCOPED_LOCK(mutex_);
+    state->is_computing = false;
+    state->all_dirty = true;
+  }
+}
+
+void RegionHashManager::CheckHandler(void*) {
+  if (!FLAGS_enable_region_hash_check) {
+    return;
+  }
+
+  GetInstance().Check();
+}
+
+void RegionHashManager::Check() {
+  auto raft_store_engine = Server::GetInstance().GetRaftStoreEngine();
+  if (raft_store_engine == nullptr) {
+    return;
+  }
+
+  for (auto& region : Server::GetInstance().GetAllAliveRegion()) {
+    if (region->State() != pb::common::StoreRegionState::NORMAL) {
+      continue;
+    }
+    auto node = raft_store_engine->GetNode(region->Id());
+    if (node == nullptr || !node->IsLeader()) {
+      continue;
+    }
+
+    // The checkpoint proposed by last round is finished on peers now.
+    CompareWithPeers(region);
+    ProposeCheckpoint(region);
+  }
+}
+
+void RegionHashManager::CompareWithPeers(store::RegionPtr region) {
+  int64_t region_id = region->Id();
+  HashCheckpoint local;
+  if (!GetCheckpoint(region_id, local)) {
+    return;
+  }
+
+  auto node = Server::GetInstance().GetRaftStoreEngine()->GetNode(region_id);
+  if (node == nullptr) {
+    return;
+  }
+
+  auto self_peer = node->GetPeerId();
+  std::vector<braft::PeerId> peers;
+  node->ListPeers(&peers);
+  for (const auto& peer : peers) {
+    if (peer == self_peer) {
+      continue;
+    }
+
+    pb::node::GetRegionHashRequest request;
+    request.set_region_id(region_id);
+    pb::node::GetRegionHashResponse response;
+    auto status = ServiceAccess::GetRegionHash(request, peer.addr, response);
+    if (!status.ok()) {
+      DINGO_LOG(INFO) << fmt::format("[region_hash][region({})] get hash of peer {} failed, error: {}", region_id,
+                                     Helper::EndPointToStr(peer.addr), status.error_str());
+      continue;
+    }
+    // Not the same checkpoint, e.g. the peer is computing or skipped it.
+    if (response.log_id() != local.log_id) {
+      DINGO_LOG(INFO) << fmt::format("[region_hash][region({})] log_id of peer {} is not match, {} vs {}", region_id,
+                                     Helper::EndPointToStr(peer.addr), local.log_id, response.log_id());
+      continue;
+    }
+
+    HashCheckpoint remote;
+    remote.log_id = response.log_id();
+    remote.epoch = response.epoch();
+    remote.range = response.range();
+    remote.bucket_keys = Helper::PbRepeatedToVector(response.bucket_keys());
+    remote.hashes = Helper::PbRepeatedToVector(response.bucket_hashes());
+
+    auto mismatches = CompareCheckpoint(local, remote);
+    if (mismatches.empty()) {
+      continue;
+    }
+
+    bvar_mismatch_count_ << 1;
+    auto bucket_ranges = BucketRanges(local.range, local.bucket_keys);
+    for (auto i : mismatches) {
+      DINGO_LOG(ERROR) << fmt::format(
+          "[region_hash][region({})] replica is inconsistent with peer {}, log_id({}) bucket({}) range({}) "
+          "hash({} vs {})",
+          region_id, Helper::EndPointToStr(peer.addr), local.log_id, i,
+          i < bucket_ranges.size() ? Helper::RangeToString(bucket_ranges[i]) : "",
+          i < local.hashes.size() ? local.hashes[i] : 0, i < remote.hashes.size() ? remote.hashes[i] : 0);
+    }
+  }
+}
+
+void RegionHashManager::ProposeCheckpoint(store::RegionPtr region) {
+  int64_t region_id = region->Id();
+  auto range = region->Range();
+  if (Helper::InvalidRange(range)) {
+    return;
+  }
+
+  // Reuse the buckets of last checkpoint, then only the dirty buckets are scanned.
+  std::vector<std::string> bucket_keys;
+  bool full = false;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = region_states_.find(region_id);
+    if (it != region_states_.end()) {
+      const auto& state = *it->second;
+      if (state.is_computing) {
+        return;
+      }
+      if (IsEqualRange(state.range, range) &&
+          static_cast<int32_t>(state.bucket_keys.size()) + 1 == FLAGS_region_hash_bucket_num) {
+        bucket_keys = state.bucket_keys;
+      }
+      full = FLAGS_region_hash_full_check_rounds > 0 && state.checkpoint_count > 0 &&
+             state.checkpoint_count % FLAGS_region_hash_full_check_rounds == 0;
+    }
+  }
+
+  // New buckets of about the same data size by the sst file boundaries, txn keys are encoded, split evenly.
+  if (bucket_keys.empty()) {
+    std::vector<std::string> raw_cf_names;
+    std::vector<std::string> txn_cf_names;
+    Helper::GetColumnFamilyNames(range.start_key(), raw_cf_names, txn_cf_names);
+
+    auto raw_engine = Server::GetInstance().GetRawEngine(region->GetRawEngineType());
+    std::vector<std::string> sample_keys;
+    if (raw_engine != nullptr && !raw_cf_names.empty()) {
+      raw_engine->GetSstFileBoundaryKeys(raw_cf_names[0], range, sample_keys);
+    }
+    if (!sample_keys.empty()) {
+      bucket_keys = Helper::CalculateSampleSplitKeys(range.start_key(), range.end_key(), sample_keys,
+                                                     FLAGS_region_hash_bucket_num);
+    } else {
+      bucket_keys = Helper::CalculateUniformSplitKeys(range.start_key(), range.end_key(), FLAGS_region_hash_bucket_num);
+    }
+  }
+
+  auto ctx = std::make_shared<Context>();
+  ctx->SetRegionId(region_id);
+  ctx->SetRegionEpoch(region->Epoch());
+  auto status =
+      Server::GetInstance().GetEngine()->AsyncWrite(ctx, WriteDataBuilder::BuildComputeHashWrite(bucket_keys, full));
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[region_hash][region({})] propose compute hash failed, error: {}", region_id,
+                                      status.error_str());
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,118 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_STORE_REGION_HASH_H_
+#define DINGODB_STORE_REGION_HASH_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "bvar/reducer.h"
+#include "common/runnable.h"
+#include "engine/raw_engine.h"
+#include "engine/snapshot.h"
+#include "meta/store_meta_manager.h"
+#include "proto/common.pb.h"
+#include "proto/raft.pb.h"
+
+namespace dingodb {
+
+// Incremental replica consistency check by the hashes of region buckets.
+// The leader proposes COMPUTE_HASH with the bucket keys, so every replica hashes the same buckets at the same
+// log index. The apply path marks the buckets of written keys dirty, a checkpoint only scans the dirty buckets
+// from the snapshot taken at its log index, the hashes of clean buckets are reused from the last checkpoint.
+// The leader compares the checkpoints of peers at the same log index, only the mismatched buckets need to be
+// scanned again for the diverged keys.
+class RegionHashManager {
+ public:
+  struct HashCheckpoint {
+    int64_t log_id{0};
+    pb::common::RegionEpoch epoch;
+    pb::common::Range range;
+    std::vector<std::string> bucket_keys;
+    std::vector<uint32_t> hashes;
+  };
+
+  static RegionHashManager& GetInstance();
+
+  bool Init();
+  void Destroy();
+
+  // Mark the buckets written by the raft command dirty, called by apply in log order.
+  void MarkDirty(int64_t region_id, const pb::raft::RaftCmdRequest& raft_cmd);
+  // Drop the hashes of region, e.g. data is replaced by snapshot, the next checkpoint scans all buckets.
+  void Reset(int64_t region_id);
+
+  // Apply of COMPUTE_HASH, take the snapshot at log_id and hash the buckets in background.
+  void Checkpoint(store::RegionPtr region, RawEnginePtr raw_engine, const pb::raft::ComputeHashRequest& request,
+                  int64_t log_id);
+  // The last finished checkpoint.
+  bool GetCheckpoint(int64_t region_id, HashCheckpoint& checkpoint);
+
+  // Leaders compare the last checkpoint of peers and propose the next one, called by crontab.
+  static void CheckHandler(void*);
+  void Check();
+
+  // Bucket of key, keys less than bucket_keys[i] and not less than bucket_keys[i - 1] are in bucket i.
+  static size_t BucketIndex(const std::vector<std::string>& bucket_keys, const std::string& key);
+  // Bucket ranges in [start_key, end_key), bucket_keys.size() + 1 ranges.
+  static std::vector<pb::common::Range> BucketRanges(const pb::common::Range& range,
+                                                     const std::vector<std::string>& bucket_keys);
+  // Index of the buckets with different hashes, all buckets if the buckets are different.
+  static std::vector<size_t> CompareCheckpoint(const HashCheckpoint& local, const HashCheckpoint& remote);
+
+ private:
+  RegionHashManager();
+
+  struct RegionState {
+    // buckets of the last checkpoint, dirty marks are relative to its log index.
+    pb::common::Range range;
+    std::vector<std::string> bucket_keys;
+    std::vector<bool> dirty;
+    bool all_dirty{false};
+
+    bool is_computing{false};
+    bool has_checkpoint{false};
+    HashCheckpoint checkpoint;
+    int64_t checkpoint_count{0};
+  };
+  using RegionStatePtr = std::shared_ptr<RegionState>;
+
+  void MarkDirtyRange(RegionState& state, const std::string& start_key, const std::string& end_key);
+
+  // Hash the buckets which need scan, keep the others of hashes.
+  static butil::Status HashBuckets(RawEnginePtr raw_engine, SnapshotPtr snapshot, const HashCheckpoint& checkpoint,
+                                   const std::vector<bool>& need_scans, std::vector<uint32_t>& hashes);
+
+  void ProposeCheckpoint(store::RegionPtr region);
+  void CompareWithPeers(store::RegionPtr region);
+
+  PriorWorkerSetPtr worker_set_;
+
+  bthread::Mutex mutex_;
+  std::map<int64_t, RegionStatePtr> region_states_;
+
+  bvar::Adder<int64_t> bvar_checkpoint_count_;
+  bvar::Adder<int64_t> bvar_scan_bucket_count_;
+  bvar::Adder<int64_t> bvar_mismatch_count_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_STORE_REGION_HASH_H_
@@ -0,0 +1,294 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "store/sst_ingest.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/endpoint.h"
+#include "butil/status.h"
+#include "butil/strings/string_split.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/service_access.h"
+#include "config/config_manager.h"
+#include "fmt/core.h"
+#include "proto/error.pb.h"
+#include "proto/file_service.pb.h"
+#include "proto/node.pb.h"
+#include "server/file_service.h"
+#include "server/server.h"
+
+namespace dingodb {
+
+static const std::string kSstFileSuffix = ".sst";
+
+std::string SstIngestManager::GetIngestPath(int64_t region_id) {
+  return fmt::format("{}/ingest_{}", Server::GetInstance().GetCheckpointPath(), region_id);
+}
+
+std::string SstIngestManager::GetIngestFilePath(int64_t region_id, const std::string& filename) {
+  return fmt::format("{}/{}", GetIngestPath(region_id), filename);
+}
+
+butil::Status SstIngestManager::ValidateFilename(const std::string& filename) {
+  if (filename.size() <= kSstFileSuffix.size() ||
+      filename.compare(filename.size() - kSstFileSuffix.size(), kSstFileSuffix.size(), kSstFileSuffix) != 0) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param filename must be end with .sst");
+  }
+  if (filename.find('/') != std::string::npos) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param filename cant contain /");
+  }
+
+  return butil::Status();
+}
+
+butil::Status SstIngestManager::SaveFile(int64_t region_id, const std::string& filename, int64_t offset,
+                                         const butil::IOBuf& data) {
+  auto status = ValidateFilename(filename);
+  if (!status.ok()) {
+    return status;
+  }
+
+  status = Helper::CreateDirectories(GetIngestPath(region_id));
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::string filepath = GetIngestFilePath(region_id, filename);
+  std::ofstream ofile;
+  if (offset == 0) {
+    ofile.open(filepath, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+  } else {
+    std::error_code ec;
+    auto file_size = std::filesystem::file_size(filepath, ec);
+    if (ec || static_cast<int64_t>(file_size) != offset) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param offset %ld not match file size %ld", offset,
+                           ec ? -1L : static_cast<int64_t>(file_size));
+    }
+    ofile.open(filepath, std::ofstream::out | std::ofstream::binary | std::ofstream::app);
+  }
+  if (!ofile.is_open()) {
+    return butil::Status(pb::error::EINTERNAL, "Open file %s failed", filepath.c_str());
+  }
+
+  ofile << data;
+  ofile.close();
+  if (ofile.fail()) {
+    return butil::Status(pb::error::EINTERNAL, "Write file %s failed", filepath.c_str());
+  }
+
+  return butil::Status();
+}
+
+butil::Status SstIngestManager::ValidateFiles(store::RegionPtr region, RawEnginePtr raw_engine,
+                                              const std::string& cf_name, const std::vector<std::string>& filenames) {
+  const auto range =
+      Helper::IsTxnColumnFamilyName(cf_name) ? Helper::GetMemComparableRange(region->Range()) : region->Range();
+  for (const auto& filename : filenames) {
+    auto status = ValidateFilename(filename);
+    if (!status.ok()) {
+      return status;
+    }
+
+    std::string filepath = GetIngestFilePath(region->Id(), filename);
+    if (!Helper::IsExistPath(filepath)) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Not found uploaded file %s", filename.c_str());
+    }
+
+    std::string smallest_key, largest_key;
+    status = raw_engine->GetExternalFileKeyRange(filepath, smallest_key, largest_key);
+    if (!status.ok()) {
+      return status;
+    }
+
+    if (smallest_key < range.start_key() || largest_key >= range.end_key()) {
+      return butil::Status(pb::error::EKEY_OUT_OF_RANGE, "File %s key [%s, %s] out of region range [%s, %s)",
+                           filename.c_str(), Helper::StringToHex(smallest_key).c_str(),
+                           Helper::StringToHex(largest_key).c_str(), Helper::StringToHex(range.start_key()).c_str(),
+                           Helper::StringToHex(range.end_key()).c_str());
+    }
+  }
+
+  return butil::Status();
+}
+
+butil::Status SstIngestManager::PrepareFollowers(store::RegionPtr region, const std::vector<std::string>& filenames) {
+  auto raft_store_engine = Server::GetInstance().GetRaftStoreEngine();
+  if (raft_store_engine == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Not raft store engine.");
+  }
+  auto raft_node = raft_store_engine->GetNode(region->Id());
+  if (raft_node == nullptr) {
+    return butil::Status(pb::error::ERAFT_NOT_FOUND, "Not found raft node.");
+  }
+
+  auto config = ConfigManager::GetInstance().GetRoleConfig();
+  auto host = config->GetString("server.host");
+  int port = config->GetInt("server.port");
+  if (host.empty() || port == 0) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Parse server host or port error.");
+  }
+
+  auto reader = std::make_shared<FileReaderWrapper>(GetIngestPath(region->Id()));
+  int64_t reader_id = FileServiceReaderManager::GetInstance().AddReader(reader);
+
+  pb::node::PrepareIngestSstRequest request;
+  request.set_region_id(region->Id());
+  request.set_uri(fmt::format("remote://{}:{}/{}", host, port, reader_id));
+  for (const auto& filename : filenames) {
+    request.add_filenames(filename);
+  }
+
+  butil::Status status;
+  auto self_peer = raft_node->GetPeerId();
+  std::vector<braft::PeerId> peers;
+  raft_node->ListPeers(&peers);
+  for (const auto& peer : peers) {
+    if (peer == self_peer) {
+      continue;
+    }
+
+    int64_t start_time = Helper::TimestampMs();
+    status = ServiceAccess::PrepareIngestSst(request, peer.addr);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[sst_ingest][region({})] prepare follower {} failed, error: {}", region->Id(),
+                                      Helper::EndPointToStr(peer.addr), Helper::PrintStatus(status));
+      break;
+    }
+
+    DINGO_LOG(INFO) << fmt::format("[sst_ingest][region({})] prepare follower {} finish, elapsed time {}ms",
+                                   region->Id(), Helper::EndPointToStr(peer.addr), Helper::TimestampMs() - start_time);
+  }
+
+  FileServiceReaderManager::GetInstance().DeleteReader(reader_id);
+
+  return status;
+}
+
+// uri: remote://host:port/reader_id
+static butil::Status ParseUri(const std::string& uri, butil::EndPoint& endpoint, int64_t& reader_id) {
+  std::vector<std::string> strs;
+  butil::SplitString(uri, '/', &strs);
+  if (strs.size() < 4 || butil::str2endpoint(strs[2].c_str(), &endpoint) != 0) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Parse uri %s failed", uri.c_str());
+  }
+
+  char* end = nullptr;
+  reader_id = std::strtoll(strs[3].c_str(), &end, 10);
+  if (reader_id <= 0 || *end != '\0') {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Parse uri %s failed", uri.c_str());
+  }
+
+  return butil::Status();
+}
+
+butil::Status SstIngestManager::DownloadFiles(int64_t region_id, const std::string& uri,
+                                              const std::vector<std::string>& filenames) {
+  butil::EndPoint endpoint;
+  int64_t reader_id = 0;
+  auto status = ParseUri(uri, endpoint, reader_id);
+  if (!status.ok()) {
+    return status;
+  }
+
+  status = Helper::CreateDirectories(GetIngestPath(region_id));
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (const auto& filename : filenames) {
+    status = ValidateFilename(filename);
+    if (!status.ok()) {
+      return status;
+    }
+
+    std::string filepath = GetIngestFilePath(region_id, filename);
+    std::ofstream ofile(filepath, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    if (!ofile.is_open()) {
+      return butil::Status(pb::error::EINTERNAL, "Open file %s failed", filepath.c_str());
+    }
+
+    int64_t offset = 0;
+    for (;;) {
+      pb::fileservice::GetFileRequest request;
+      request.set_reader_id(reader_id);
+      request.set_filename(filename);
+      request.set_offset(offset);
+      request.set_size(Constant::kFileTransportChunkSize);
+
+      butil::IOBuf buf;
+      auto response = ServiceAccess::GetFile(request, endpoint, &buf);
+      if (response == nullptr || response->error().errcode() != pb::error::OK) {
+        return butil::Status(pb::error::EINTERNAL, "Get file %s failed", filename.c_str());
+      }
+
+      ofile << buf;
+      if (response->eof()) {
+        break;
+      }
+
+      offset += response->read_size();
+    }
+
+    ofile.close();
+    if (ofile.fail()) {
+      return butil::Status(pb::error::EINTERNAL, "Write file %s failed", filepath.c_str());
+    }
+
+    DINGO_LOG(INFO) << fmt::format("[sst_ingest][region({})] download file {} finish.", region_id, filepath);
+  }
+
+  return butil::Status();
+}
+
+butil::Status SstIngestManager::IngestFiles(int64_t region_id, RawEnginePtr raw_engine, const std::string& cf_name,
+                                            const std::vector<std::string>& filenames) {
+  std::vector<std::string> filepaths;
+  filepaths.reserve(filenames.size());
+  for (const auto& filename : filenames) {
+    std::string filepath = GetIngestFilePath(region_id, filename);
+    if (!Helper::IsExistPath(filepath)) {
+      return butil::Status(pb::error::EINTERNAL, "Not found ingest file %s", filepath.c_str());
+    }
+    filepaths.push_back(filepath);
+  }
+
+  auto status = raw_engine->IngestExternalFile(cf_name, filepaths);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (const auto& filepath : filepaths) {
+    Helper::RemoveFileOrDirectory(filepath);
+  }
+
+  return butil::Status();
+}
+
+void SstIngestManager::CleanFiles(int64_t region_id) {
+  std::string path = GetIngestPath(region_id);
+  if (Helper::IsExistPath(path)) {
+    Helper::RemoveAllFileOrDirectory(path);
+  }
+}
+
+}  // namespace dingodb
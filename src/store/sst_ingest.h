@@ -0,0 +1,67 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_STORE_SST_INGEST_H_  // NOLINT
+#define DINGODB_STORE_SST_INGEST_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/iobuf.h"
+#include "butil/status.h"
+#include "engine/raw_engine.h"
+#include "meta/store_meta_manager.h"
+
+namespace dingodb {
+
+// Bulk load of client built sst files.
+// 1. The client uploads sst files of a region to the leader by KvUploadSst.
+// 2. KvIngestSst checks the files, every follower downloads them from the leader by the file service.
+// 3. The leader proposes a INGEST_SST raft log, every replica ingests its local files when applying it.
+// Only file content is transferred out of raft, the raft log just carries the file names.
+class SstIngestManager {
+ public:
+  // Directory of the sst files of region, under checkpoint path for hard link when ingesting.
+  static std::string GetIngestPath(int64_t region_id);
+  static std::string GetIngestFilePath(int64_t region_id, const std::string& filename);
+
+  static butil::Status ValidateFilename(const std::string& filename);
+
+  // Append a chunk of uploaded file, offset must be the current file size, offset 0 means a new file.
+  static butil::Status SaveFile(int64_t region_id, const std::string& filename, int64_t offset,
+                                const butil::IOBuf& data);
+
+  // Leader check the uploaded files of cf, all keys must be in region range, the encoded range for txn cf.
+  static butil::Status ValidateFiles(store::RegionPtr region, RawEnginePtr raw_engine, const std::string& cf_name,
+                                     const std::vector<std::string>& filenames);
+
+  // Leader let all followers download the files, fail if any follower fail.
+  static butil::Status PrepareFollowers(store::RegionPtr region, const std::vector<std::string>& filenames);
+
+  // Follower download the files from leader.
+  static butil::Status DownloadFiles(int64_t region_id, const std::string& uri,
+                                     const std::vector<std::string>& filenames);
+
+  // Ingest local files when applying raft log, the files are removed after ingest.
+  static butil::Status IngestFiles(int64_t region_id, RawEnginePtr raw_engine, const std::string& cf_name,
+                                   const std::vector<std::string>& filenames);
+
+  static void CleanFiles(int64_t region_id);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_STORE_SST_INGEST_H_  // NOLINT
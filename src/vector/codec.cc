@@ -15,17 +15,32 @@
 #include "vector/codec.h"
 
 #include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
 
 #include "butil/compiler_specific.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "serial/buf.h"
 #include "serial/schema/long_schema.h"
 
 namespace dingodb {
 
+DEFINE_string(vector_value_encoding, "protobuf",
+              "encoding of vector data value, protobuf, packed_float or packed_fp16(lossy). "
+              "All encodings are always decodable, use packed only after all nodes upgraded");
+
+// The low 3 bits of protobuf tag is wire type, 6 is invalid.
+static const uint8_t kPackedVectorMagic = 0xFE;
+static const uint8_t kPackedVectorVersion = 1;
+static const uint8_t kPackedFormatFloat = 0;
+static const uint8_t kPackedFormatFp16 = 1;
+static const size_t kPackedVectorHeaderSize = 7;
+
 // TODO: refact
 void VectorCodec::EncodeVectorKey(char prefix, int64_t partition_id, std::string& result) {
   if (BAIDU_UNLIKELY(prefix == 0)) {
@@ -115,4 +130,237 @@ bool VectorCodec::IsValidKey(const std::string& key) {
 
 bool VectorCodec::IsLegalVectorId(int64_t vector_id) { return vector_id > 0 && vector_id != INT64_MAX; }
 
+void VectorCodec::EncodeVectorValue(const pb::common::Vector& vector, std::string& result) {
+  const auto& encoding = FLAGS_vector_value_encoding;
+  bool can_pack = vector.value_type() == pb::common::ValueType::FLOAT && vector.binary_values().empty() &&
+                  vector.float_values_size() == vector.dimension();
+  if (!can_pack || (encoding != "packed_float" && encoding != "packed_fp16")) {
+    vector.SerializeToString(&result);
+    return;
+  }
+
+  bool is_fp16 = (encoding == "packed_fp16");
+  uint32_t dimension = vector.dimension();
+  result.resize(kPackedVectorHeaderSize + dimension * (is_fp16 ? sizeof(uint16_t) : sizeof(float)));
+  char* buf = result.data();
+  buf[0] = static_cast<char>(kPackedVectorMagic);
+  buf[1] = static_cast<char>(kPackedVectorVersion);
+  buf[2] = static_cast<char>(is_fp16 ? kPackedFormatFp16 : kPackedFormatFloat);
+  memcpy(buf + 3, &dimension, sizeof(dimension));
+
+  char* payload = buf + kPackedVectorHeaderSize;
+  if (is_fp16) {
+    for (uint32_t i = 0; i < dimension; ++i) {
+      uint16_t half = VectorCodec::FloatToHalf(vector.float_values(i));
+      memcpy(payload + i * sizeof(half), &half, sizeof(half));
+    }
+  } else {
+    memcpy(payload, vector.float_values().data(), dimension * sizeof(float));
+  }
+}
+
+bool VectorCodec::IsPackedVectorValue(std::string_view value) {
+  return !value.empty() && static_cast<uint8_t>(value[0]) == kPackedVectorMagic;
+}
+
+// Parse packed header, return false if it is broken.
+static bool ParsePackedHeader(std::string_view value, uint8_t& format, uint32_t& dimension) {
+  if (value.size() < kPackedVectorHeaderSize || static_cast<uint8_t>(value[1]) != kPackedVectorVersion) {
+    return false;
+  }
+
+  format = static_cast<uint8_t>(value[2]);
+  memcpy(&dimension, value.data() + 3, sizeof(dimension));
+  size_t value_size = (format == kPackedFormatFp16) ? sizeof(uint16_t) : sizeof(float);
+  if (format != kPackedFormatFloat && format != kPackedFormatFp16) {
+    return false;
+  }
+
+  return value.size() == kPackedVectorHeaderSize + dimension * value_size;
+}
+
+bool VectorCodec::DecodeVectorValue(std::string_view value, pb::common::Vector& vector) {
+  if (!IsPackedVectorValue(value)) {
+    return vector.ParseFromArray(value.data(), value.size());
+  }
+
+  uint8_t format = 0;
+  uint32_t dimension = 0;
+  if (!ParsePackedHeader(value, format, dimension)) {
+    return false;
+  }
+
+  vector.Clear();
+  vector.set_dimension(dimension);
+  vector.set_value_type(pb::common::ValueType::FLOAT);
+  vector.mutable_float_values()->Resize(dimension, 0.0f);
+  DecodeVectorValueToFloat(value, dimension, vector.mutable_float_values()->mutable_data());
+
+  return true;
+}
+
+const float* VectorCodec::DecodeVectorValueToFloat(std::string_view value, int32_t dimension, float* dst) {
+  if (!IsPackedVectorValue(value)) {
+    pb::common::Vector vector;
+    if (!vector.ParseFromArray(value.data(), value.size()) || !VectorToFloat(vector, dimension, dst)) {
+      return nullptr;
+    }
+    return dst;
+  }
+
+  uint8_t format = 0;
+  uint32_t packed_dimension = 0;
+  if (!ParsePackedHeader(value, format, packed_dimension) || static_cast<int32_t>(packed_dimension) != dimension) {
+    return nullptr;
+  }
+
+  const char* payload = value.data() + kPackedVectorHeaderSize;
+  if (format == kPackedFormatFloat) {
+    // The payload may be not aligned, only return it directly when aligned.
+    if (reinterpret_cast<uintptr_t>(payload) % alignof(float) == 0) {
+      return reinterpret_cast<const float*>(payload);
+    }
+    memcpy(dst, payload, dimension * sizeof(float));
+    return dst;
+  }
+
+  for (int32_t i = 0; i < dimension; ++i) {
+    uint16_t half = 0;
+    memcpy(&half, payload + i * sizeof(half), sizeof(half));
+    dst[i] = VectorCodec::HalfToFloat(half);
+  }
+  return dst;
+}
+
+size_t VectorCodec::IntegerVectorSize(pb::common::ValueType value_type, int32_t dimension) {
+  switch (value_type) {
+    case pb::common::ValueType::UINT8:
+      return (dimension + 7) / 8;
+    case pb::common::ValueType::SINT8:
+      return dimension;
+    default:
+      return 0;
+  }
+}
+
+static size_t BinaryValuesSize(const pb::common::Vector& vector) {
+  size_t size = 0;
+  for (const auto& value : vector.binary_values()) {
+    size += value.size();
+  }
+  return size;
+}
+
+bool VectorCodec::CheckVectorDimension(const pb::common::Vector& vector, int32_t dimension) {
+  if (vector.value_type() == pb::common::ValueType::FLOAT) {
+    return vector.float_values_size() == dimension;
+  }
+
+  size_t size = IntegerVectorSize(vector.value_type(), dimension);
+  return size > 0 && BinaryValuesSize(vector) == size;
+}
+
+bool VectorCodec::VectorToFloat(const pb::common::Vector& vector, int32_t dimension, float* dst) {
+  if (!CheckVectorDimension(vector, dimension)) {
+    return false;
+  }
+
+  if (vector.value_type() == pb::common::ValueType::FLOAT) {
+    memcpy(dst, vector.float_values().data(), dimension * sizeof(float));
+    return true;
+  }
+
+  // bit i of binary vector is the (i % 8) bit of byte i / 8, from the lowest bit.
+  bool is_binary = (vector.value_type() == pb::common::ValueType::UINT8);
+  int32_t pos = 0;
+  for (const auto& value : vector.binary_values()) {
+    for (char byte : value) {
+      if (is_binary) {
+        for (int bit = 0; bit < 8 && pos < dimension; ++bit) {
+          dst[pos++] = static_cast<float>((static_cast<uint8_t>(byte) >> bit) & 1);
+        }
+      } else {
+        dst[pos++] = static_cast<float>(static_cast<int8_t>(byte));
+      }
+    }
+  }
+
+  return true;
+}
+
+// round to nearest even
+uint16_t VectorCodec::FloatToHalf(float value) {
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+
+  uint32_t sign = (bits >> 16) & 0x8000;
+  uint32_t float_exp = (bits >> 23) & 0xff;
+  uint32_t mantissa = bits & 0x7fffff;
+
+  // inf or nan
+  if (float_exp == 0xff) {
+    return sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0);
+  }
+
+  int32_t exp = static_cast<int32_t>(float_exp) - 127 + 15;
+  // overflow to inf
+  if (exp >= 31) {
+    return sign | 0x7c00;
+  }
+
+  // subnormal or zero
+  if (exp <= 0) {
+    if (exp < -10) {
+      return sign;
+    }
+    mantissa |= 0x800000;
+    uint32_t shift = 14 - exp;
+    uint32_t half = mantissa >> shift;
+    uint32_t remainder = mantissa & ((1U << shift) - 1);
+    uint32_t halfway = 1U << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (half & 1) != 0)) {
+      ++half;
+    }
+    return sign | half;
+  }
+
+  uint32_t half = sign | (static_cast<uint32_t>(exp) << 10) | (mantissa >> 13);
+  uint32_t remainder = mantissa & 0x1fff;
+  // carry into exponent is expected, it rounds up to the next power of two or inf.
+  if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1) != 0)) {
+    ++half;
+  }
+  return half;
+}
+
+float VectorCodec::HalfToFloat(uint16_t value) {
+  uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+  int32_t exp = (value >> 10) & 0x1f;
+  uint32_t mantissa = value & 0x3ff;
+
+  uint32_t bits = 0;
+  if (exp == 0) {
+    if (mantissa == 0) {
+      bits = sign;
+    } else {
+      // normalize subnormal
+      exp = 1;
+      while ((mantissa & 0x400) == 0) {
+        mantissa <<= 1;
+        --exp;
+      }
+      mantissa &= 0x3ff;
+      bits = sign | (static_cast<uint32_t>(exp + 127 - 15) << 23) | (mantissa << 13);
+    }
+  } else if (exp == 31) {
+    bits = sign | 0x7f800000 | (mantissa << 13);
+  } else {
+    bits = sign | (static_cast<uint32_t>(exp + 127 - 15) << 23) | (mantissa << 13);
+  }
+
+  float result = 0.0f;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
 }  // namespace dingodb
\ No newline at end of file
@@ -15,8 +15,10 @@
 #ifndef DINGODB_VECTOR_CODEC_H_
 #define DINGODB_VECTOR_CODEC_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <string_view>
 
 #include "proto/common.pb.h"
 
@@ -38,6 +40,30 @@ class VectorCodec {
   static bool IsValidKey(const std::string& key);
 
   static bool IsLegalVectorId(int64_t vector_id);
+
+  // Value of vector data cf, encoded by flag vector_value_encoding.
+  // protobuf: serialized pb::common::Vector.
+  // packed: magic(1) | version(1) | format(1) | dimension(4) | float32 or fp16 values, little endian.
+  // The magic is a invalid protobuf tag, so both are decoded without knowing the encoding.
+  static void EncodeVectorValue(const pb::common::Vector& vector, std::string& result);
+  static bool DecodeVectorValue(std::string_view value, pb::common::Vector& vector);
+  // Decode float values for distance computing, dst must have room for dimension floats.
+  // Return nullptr if decode failed or dimension not match, aligned packed float32 values are returned without copy.
+  static const float* DecodeVectorValueToFloat(std::string_view value, int32_t dimension, float* dst);
+  static bool IsPackedVectorValue(std::string_view value);
+
+  // Integer vector values are the concatenated bytes of binary_values.
+  // Byte count of integer vector, binary(UINT8) has one bit per dimension, SINT8 has one byte, 0 for float.
+  static size_t IntegerVectorSize(pb::common::ValueType value_type, int32_t dimension);
+  // Values of vector match the dimension, float_values for float vector, binary_values for integer vector.
+  static bool CheckVectorDimension(const pb::common::Vector& vector, int32_t dimension);
+  // Widen vector values to float, binary bits are unpacked into 0 or 1, dst must have room for dimension floats.
+  // Return false if values not match dimension.
+  static bool VectorToFloat(const pb::common::Vector& vector, int32_t dimension, float* dst);
+
+  // IEEE 754 half precision conversion, round to nearest even.
+  static uint16_t FloatToHalf(float value);
+  static float HalfToFloat(uint16_t value);
 };
 
 }  // namespace dingodb
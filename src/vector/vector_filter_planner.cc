@@ -0,0 +1,103 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_filter_planner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_vector_filter_planner, true, "choose scalar filter search plan by the estimated selectivity");
+DEFINE_double(vector_filter_planner_post_filter_selectivity, 0.3,
+              "use post filter when the selectivity of scalar filter is not less than it");
+DEFINE_double(vector_filter_planner_topk_inflation, 2.0,
+              "post filter search topk / selectivity * inflation candidates from index");
+DEFINE_int32(vector_filter_planner_max_topk_inflation, 20, "max times of topk searched from index for post filter");
+DEFINE_int64(vector_filter_planner_brute_force_count, 4096,
+             "use brute force when the matched count of scalar filter is not greater than it");
+
+bool VectorFilterPlanner::IsApplicable(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                       const pb::common::VectorSearchParameter& parameter) {
+  if (!FLAGS_enable_vector_filter_planner) {
+    return false;
+  }
+
+  if (parameter.vector_filter() != pb::common::VectorFilter::SCALAR_FILTER) {
+    return false;
+  }
+
+  if (parameter.enable_range_search() || parameter.use_brute_force() || parameter.top_n() == 0) {
+    return false;
+  }
+
+  // no filter condition, it is a normal search.
+  return parameter.has_vector_coprocessor() ||
+         (!vector_with_ids.empty() && vector_with_ids[0].scalar_data().scalar_data_size() > 0);
+}
+
+double VectorFilterPlanner::EstimateSelectivity(const std::vector<pb::common::VectorScalardata>& samples,
+                                                const ScalarFilterFunc& filter_func) {
+  if (samples.empty()) {
+    return 1.0;
+  }
+
+  int64_t match_count = 0;
+  for (const auto& sample : samples) {
+    if (filter_func(sample)) {
+      ++match_count;
+    }
+  }
+
+  return static_cast<double>(match_count) / samples.size();
+}
+
+VectorFilterPlanner::Decision VectorFilterPlanner::Choose(double selectivity, int64_t vector_count, uint32_t top_n) {
+  double estimate_count = selectivity * vector_count;
+  if (estimate_count <= FLAGS_vector_filter_planner_brute_force_count) {
+    return {Plan::kBruteForce, top_n};
+  }
+
+  if (selectivity >= FLAGS_vector_filter_planner_post_filter_selectivity) {
+    double topk = std::ceil(top_n * FLAGS_vector_filter_planner_topk_inflation / selectivity);
+    double max_topk = static_cast<double>(top_n) * std::max(FLAGS_vector_filter_planner_max_topk_inflation, 1);
+    return {Plan::kPostFilter, static_cast<uint32_t>(std::clamp(topk, static_cast<double>(top_n), max_topk))};
+  }
+
+  return {Plan::kPreFilter, top_n};
+}
+
+bool VectorFilterPlanner::IsBruteForceCount(int64_t filter_count) {
+  return filter_count <= FLAGS_vector_filter_planner_brute_force_count;
+}
+
+const char* VectorFilterPlanner::PlanName(Plan plan) {
+  switch (plan) {
+    case Plan::kPostFilter:
+      return "post_filter";
+    case Plan::kPreFilter:
+      return "pre_filter";
+    case Plan::kBruteForce:
+      return "brute_force";
+    default:
+      return "unknown";
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,65 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_FILTER_PLANNER_H_  // NOLINT
+#define DINGODB_VECTOR_FILTER_PLANNER_H_
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Choose the execution plan of scalar filtered search by the estimated selectivity,
+// instead of the filter type of request.
+//   post filter: search index with inflated topk, then filter the candidates, good at loose filter.
+//   pre filter: scan scalar data to get the matched ids, then search index with the id filter.
+//   brute force: scan scalar data to get the matched ids, then compute distance of them, good at strict filter.
+class VectorFilterPlanner {
+ public:
+  enum class Plan {
+    kPostFilter = 0,
+    kPreFilter = 1,
+    kBruteForce = 2,
+  };
+
+  struct Decision {
+    Plan plan;
+    // topk of searching index, inflated for post filter.
+    uint32_t topk;
+  };
+
+  using ScalarFilterFunc = std::function<bool(const pb::common::VectorScalardata&)>;
+
+  // Whether the search is planned by planner, range search and explicit brute force keep the old way.
+  static bool IsApplicable(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                           const pb::common::VectorSearchParameter& parameter);
+
+  // The fraction of samples passing filter, 1.0 if no sample.
+  static double EstimateSelectivity(const std::vector<pb::common::VectorScalardata>& samples,
+                                    const ScalarFilterFunc& filter_func);
+
+  static Decision Choose(double selectivity, int64_t vector_count, uint32_t top_n);
+
+  // The exact matched count is known after scanning scalar data.
+  static bool IsBruteForceCount(int64_t filter_count);
+
+  static const char* PlanName(Plan plan);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_FILTER_PLANNER_H_  // NOLINT
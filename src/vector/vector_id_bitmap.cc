@@ -0,0 +1,133 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_id_bitmap.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dingodb {
+
+VectorIdBitmap::VectorIdBitmap(const std::vector<int64_t>& vector_ids) {
+  if (std::is_sorted(vector_ids.begin(), vector_ids.end())) {
+    for (auto vector_id : vector_ids) {
+      Add(vector_id);
+    }
+    return;
+  }
+
+  // ascending order make add append only.
+  std::vector<int64_t> sorted_ids(vector_ids);
+  std::sort(sorted_ids.begin(), sorted_ids.end());
+  for (auto vector_id : sorted_ids) {
+    Add(vector_id);
+  }
+}
+
+void VectorIdBitmap::Add(int64_t vector_id) {
+  uint64_t value = static_cast<uint64_t>(vector_id);
+  auto& container = GetOrCreateContainer(value >> 16);
+  if (AddToContainer(container, static_cast<uint16_t>(value & 0xffff))) {
+    ++count_;
+  }
+}
+
+bool VectorIdBitmap::Contains(int64_t vector_id) const {
+  uint64_t value = static_cast<uint64_t>(vector_id);
+  const auto* container = FindContainer(value >> 16);
+  if (container == nullptr) {
+    return false;
+  }
+
+  auto low = static_cast<uint16_t>(value & 0xffff);
+  if (container->IsBitmap()) {
+    return (container->bitmap[low >> 6] >> (low & 63)) & 1;
+  }
+  return std::binary_search(container->array.begin(), container->array.end(), low);
+}
+
+size_t VectorIdBitmap::MemorySize() const {
+  size_t size = sizeof(VectorIdBitmap) + containers_.capacity() * sizeof(Container);
+  for (const auto& container : containers_) {
+    size += container.array.capacity() * sizeof(uint16_t) + container.bitmap.capacity() * sizeof(uint64_t);
+  }
+  return size;
+}
+
+VectorIdBitmap::Container& VectorIdBitmap::GetOrCreateContainer(uint64_t high) {
+  // fast path for ascending ids
+  if (!containers_.empty() && containers_.back().high == high) {
+    return containers_.back();
+  }
+  if (containers_.empty() || containers_.back().high < high) {
+    containers_.emplace_back();
+    containers_.back().high = high;
+    return containers_.back();
+  }
+
+  auto it = std::lower_bound(containers_.begin(), containers_.end(), high,
+                             [](const Container& container, uint64_t high) { return container.high < high; });
+  if (it == containers_.end() || it->high != high) {
+    it = containers_.emplace(it);
+    it->high = high;
+  }
+  return *it;
+}
+
+const VectorIdBitmap::Container* VectorIdBitmap::FindContainer(uint64_t high) const {
+  // ids of a region are usually in a few containers.
+  auto it = std::lower_bound(containers_.begin(), containers_.end(), high,
+                             [](const Container& container, uint64_t high) { return container.high < high; });
+  if (it == containers_.end() || it->high != high) {
+    return nullptr;
+  }
+  return &(*it);
+}
+
+bool VectorIdBitmap::AddToContainer(Container& container, uint16_t low) {
+  if (container.IsBitmap()) {
+    uint64_t& word = container.bitmap[low >> 6];
+    uint64_t mask = 1ULL << (low & 63);
+    if ((word & mask) != 0) {
+      return false;
+    }
+    word |= mask;
+    return true;
+  }
+
+  auto& array = container.array;
+  if (array.empty() || array.back() < low) {
+    array.push_back(low);
+  } else {
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (*it == low) {
+      return false;
+    }
+    array.insert(it, low);
+  }
+
+  if (array.size() > kMaxArraySize) {
+    container.bitmap.assign(kBitmapWordCount, 0);
+    for (auto value : array) {
+      container.bitmap[value >> 6] |= 1ULL << (value & 63);
+    }
+    std::vector<uint16_t>().swap(array);
+  }
+
+  return true;
+}
+
+}  // namespace dingodb
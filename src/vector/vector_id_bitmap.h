@@ -0,0 +1,72 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_ID_BITMAP_H_  // NOLINT
+#define DINGODB_VECTOR_ID_BITMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dingodb {
+
+// Compressed bitmap of vector ids, the layout is the same as roaring bitmap.
+// Ids are partitioned by the high 48 bits, each partition keeps the low 16 bits
+// in a sorted array when sparse, or in a 8KB bitmap when dense.
+// Add is amortized O(1) when ids are added in ascending order, e.g. from a scan.
+// Contains is thread safe after built.
+class VectorIdBitmap {
+ public:
+  VectorIdBitmap() = default;
+  explicit VectorIdBitmap(const std::vector<int64_t>& vector_ids);
+  ~VectorIdBitmap() = default;
+
+  VectorIdBitmap(const VectorIdBitmap&) = default;
+  VectorIdBitmap& operator=(const VectorIdBitmap&) = default;
+  VectorIdBitmap(VectorIdBitmap&&) = default;
+  VectorIdBitmap& operator=(VectorIdBitmap&&) = default;
+
+  void Add(int64_t vector_id);
+  bool Contains(int64_t vector_id) const;
+
+  int64_t Count() const { return count_; }
+  size_t MemorySize() const;
+
+ private:
+  // array container is converted to bitmap container when exceed.
+  static constexpr uint32_t kMaxArraySize = 4096;
+  static constexpr uint32_t kBitmapWordCount = 65536 / 64;
+
+  struct Container {
+    uint64_t high{0};
+    std::vector<uint16_t> array;
+    std::vector<uint64_t> bitmap;
+
+    bool IsBitmap() const { return !bitmap.empty(); }
+  };
+
+  Container& GetOrCreateContainer(uint64_t high);
+  const Container* FindContainer(uint64_t high) const;
+
+  // return true if the value is new.
+  static bool AddToContainer(Container& container, uint16_t low);
+
+  // sorted by high
+  std::vector<Container> containers_;
+  int64_t count_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_ID_BITMAP_H_  // NOLINT
@@ -38,6 +38,10 @@ namespace dingodb {
 
 DEFINE_uint32(vector_write_batch_size_per_task, 16, "vector write batch size per task");
 DEFINE_uint32(vector_read_batch_size_per_task, 1, "vector read batch size per task");
+DEFINE_int64(vector_index_reload_search_count, 100, "offloaded vector index is reloaded after the searches in window");
+DEFINE_int64(vector_index_reload_window_s, 60, "window seconds of counting searches of offloaded vector index");
+DEFINE_int32(vector_index_warm_follower_num, 0,
+             "followers keep vector index warm for leader transfer when not enable_follower_hold_index, 0 is disable");
 
 // split VectorWithId set to multi batch
 static void SplitVectorWithId(const std::vector<pb::common::VectorWithId>& vector_with_ids, int batch_size,
@@ -126,6 +130,12 @@ void VectorIndex::SetEpochAndRange(const pb::common::RegionEpoch& epoch, const p
   this->range = range;
 }
 
+void VectorIndex::GetSearchStats(pb::common::VectorSearchStats& stats) {
+  stats.set_distance_computations(distance_computations_.load(std::memory_order_relaxed));
+  stats.set_visited_nodes(visited_nodes_.load(std::memory_order_relaxed));
+  stats.set_probed_lists(probed_lists_.load(std::memory_order_relaxed));
+}
+
 butil::Status VectorIndex::Add(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool) {
   return Add(vector_with_ids);
 }
@@ -265,6 +275,7 @@ VectorIndexWrapper::VectorIndexWrapper(int64_t id, pb::common::VectorIndexParame
       saving_num_(0),
       save_snapshot_threshold_write_key_num_(save_snapshot_threshold_write_key_num) {
   snapshot_set_ = vector_index::SnapshotMetaSet::New(id);
+  scalar_inverted_index_ = std::make_shared<VectorScalarInvertedIndex>();
   bthread_mutex_init(&vector_index_mutex_, nullptr);
   DINGO_LOG(DEBUG) << fmt::format("[new.VectorIndexWrapper][id({})]", id_);
 }
@@ -470,6 +481,8 @@ void VectorIndexWrapper::UpdateVectorIndex(VectorIndexPtr vector_index, const st
     ++version_;
 
     ready_.store(true);
+    is_offloaded_.store(false);
+    last_search_time_ms_.store(Helper::TimestampMs(), std::memory_order_relaxed);
 
     int64_t apply_log_id = ApplyLogId();
     int64_t snapshot_log_id = SnapshotLogId();
@@ -543,6 +556,10 @@ int32_t VectorIndexWrapper::PendingTaskNum() { return pending_task_num_.load(std
 void VectorIndexWrapper::IncPendingTaskNum() { pending_task_num_.fetch_add(1, std::memory_order_relaxed); }
 void VectorIndexWrapper::DecPendingTaskNum() { pending_task_num_.fetch_sub(1, std::memory_order_relaxed); }
 
+int32_t VectorIndexWrapper::PendingApplyNum() { return pending_apply_num_.load(std::memory_order_acquire); }
+void VectorIndexWrapper::IncPendingApplyNum() { pending_apply_num_.fetch_add(1, std::memory_order_release); }
+void VectorIndexWrapper::DecPendingApplyNum() { pending_apply_num_.fetch_sub(1, std::memory_order_release); }
+
 int32_t VectorIndexWrapper::LoadorbuildingNum() { return loadorbuilding_num_.load(std::memory_order_relaxed); }
 void VectorIndexWrapper::IncLoadoruildingNum() { loadorbuilding_num_.fetch_add(1, std::memory_order_relaxed); }
 void VectorIndexWrapper::DecLoadoruildingNum() { loadorbuilding_num_.fetch_sub(1, std::memory_order_relaxed); }
@@ -555,10 +572,49 @@ int32_t VectorIndexWrapper::SavingNum() { return saving_num_.load(std::memory_or
 void VectorIndexWrapper::IncSavingNum() { saving_num_.fetch_add(1, std::memory_order_relaxed); }
 void VectorIndexWrapper::DecSavingNum() { saving_num_.fetch_sub(1, std::memory_order_relaxed); }
 
+// Dimension and metric type of the parameter, for searching by brute force before vector index is loaded.
+static int32_t GetDimensionFromParameter(const pb::common::VectorIndexParameter& parameter) {
+  switch (parameter.vector_index_type()) {
+    case pb::common::VECTOR_INDEX_TYPE_FLAT:
+      return parameter.flat_parameter().dimension();
+    case pb::common::VECTOR_INDEX_TYPE_IVF_FLAT:
+      return parameter.ivf_flat_parameter().dimension();
+    case pb::common::VECTOR_INDEX_TYPE_IVF_PQ:
+      return parameter.ivf_pq_parameter().dimension();
+    case pb::common::VECTOR_INDEX_TYPE_HNSW:
+      return parameter.hnsw_parameter().dimension();
+    case pb::common::VECTOR_INDEX_TYPE_DISKANN:
+      return parameter.diskann_parameter().dimension();
+    case pb::common::VECTOR_INDEX_TYPE_BRUTEFORCE:
+      return parameter.bruteforce_parameter().dimension();
+    default:
+      return 0;
+  }
+}
+
+static pb::common::MetricType GetMetricTypeFromParameter(const pb::common::VectorIndexParameter& parameter) {
+  switch (parameter.vector_index_type()) {
+    case pb::common::VECTOR_INDEX_TYPE_FLAT:
+      return parameter.flat_parameter().metric_type();
+    case pb::common::VECTOR_INDEX_TYPE_IVF_FLAT:
+      return parameter.ivf_flat_parameter().metric_type();
+    case pb::common::VECTOR_INDEX_TYPE_IVF_PQ:
+      return parameter.ivf_pq_parameter().metric_type();
+    case pb::common::VECTOR_INDEX_TYPE_HNSW:
+      return parameter.hnsw_parameter().metric_type();
+    case pb::common::VECTOR_INDEX_TYPE_DISKANN:
+      return parameter.diskann_parameter().metric_type();
+    case pb::common::VECTOR_INDEX_TYPE_BRUTEFORCE:
+      return parameter.bruteforce_parameter().metric_type();
+    default:
+      return pb::common::MetricType::METRIC_TYPE_L2;
+  }
+}
+
 int32_t VectorIndexWrapper::GetDimension() {
   auto vector_index = GetVectorIndex();
   if (vector_index == nullptr) {
-    return 0;
+    return GetDimensionFromParameter(index_parameter_);
   }
   return vector_index->GetDimension();
 }
@@ -566,7 +622,7 @@ int32_t VectorIndexWrapper::GetDimension() {
 pb::common::MetricType VectorIndexWrapper::GetMetricType() {
   auto vector_index = GetVectorIndex();
   if (vector_index == nullptr) {
-    return pb::common::MetricType::METRIC_TYPE_L2;
+    return GetMetricTypeFromParameter(index_parameter_);
   }
   return vector_index->GetMetricType();
 }
@@ -622,6 +678,35 @@ butil::Status VectorIndexWrapper::GetDeletedCount(int64_t& deleted_count) {
   return status;
 }
 
+void VectorIndexWrapper::IncSearchQueryCount(int64_t count) {
+  search_query_count_.fetch_add(count, std::memory_order_relaxed);
+  last_search_time_ms_.store(Helper::TimestampMs(), std::memory_order_relaxed);
+}
+
+bool VectorIndexWrapper::CountOffloadedSearch() {
+  int64_t now_ms = Helper::TimestampMs();
+  int64_t window_start_ms = offloaded_search_window_start_ms_.load();
+  if (now_ms - window_start_ms > FLAGS_vector_index_reload_window_s * 1000 &&
+      offloaded_search_window_start_ms_.compare_exchange_strong(window_start_ms, now_ms)) {
+    offloaded_search_count_.store(0);
+  }
+
+  // only one search of the window triggers the reload
+  return offloaded_search_count_.fetch_add(1) + 1 == FLAGS_vector_index_reload_search_count;
+}
+
+void VectorIndexWrapper::GetSearchStats(pb::common::VectorSearchStats& stats) {
+  auto vector_index = GetOwnVectorIndex();
+  if (vector_index != nullptr) {
+    vector_index->GetSearchStats(stats);
+  }
+
+  stats.set_query_count(search_query_count_.load(std::memory_order_relaxed));
+  stats.set_filter_checked_count(filter_checked_count_.load(std::memory_order_relaxed));
+  stats.set_filter_passed_count(filter_passed_count_.load(std::memory_order_relaxed));
+  stats.set_brute_force_count(brute_force_count_.load(std::memory_order_relaxed));
+}
+
 butil::Status VectorIndexWrapper::GetMemorySize(int64_t& memory_size) {
   auto vector_index = GetOwnVectorIndex();
   if (vector_index == nullptr) {
@@ -682,6 +767,24 @@ bool VectorIndexWrapper::SupportSave() {
   return vector_index->SupportSave();
 }
 
+bool VectorIndexWrapper::NeedToRepair() {
+  auto vector_index = GetOwnVectorIndex();
+  if (vector_index == nullptr) {
+    return false;
+  }
+
+  return vector_index->NeedToRepair();
+}
+
+butil::Status VectorIndexWrapper::Repair() {
+  auto vector_index = GetOwnVectorIndex();
+  if (vector_index == nullptr) {
+    return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
+  }
+
+  return vector_index->Repair();
+}
+
 bool VectorIndexWrapper::NeedToSave(std::string& reason) {
   auto vector_index = GetOwnVectorIndex();
   if (vector_index == nullptr) {
@@ -1085,9 +1188,14 @@ bool VectorIndexWrapper::IsPermanentHoldVectorIndex(int64_t region_id) {
   }
 
   if (!config->GetBool("vector.enable_follower_hold_index")) {
-    // If follower, delete vector index.
+    // If follower, delete vector index, except warm follower.
     if (!Server::GetInstance().IsLeader(region_id)) {
-      return false;
+      if (FLAGS_vector_index_warm_follower_num <= 0) {
+        return false;
+      }
+      auto region = Server::GetInstance().GetRegion(region_id);
+      return region != nullptr && Helper::IsVectorIndexWarmPeer(region->Definition(), Server::GetInstance().Id(),
+                                                                FLAGS_vector_index_warm_follower_num);
     }
   }
   return true;
@@ -30,7 +30,9 @@
 #include "faiss/impl/IDSelector.h"
 #include "proto/common.pb.h"
 #include "proto/index.pb.h"
+#include "vector/vector_id_bitmap.h"
 #include "vector/vector_index_snapshot.h"
+#include "vector/vector_scalar_index.h"
 
 namespace dingodb {
 
@@ -82,6 +84,21 @@ class VectorIndex {
     bool Check(int64_t vector_id) override { return is_member(vector_id); }
   };
 
+  // Compressed bitmap filter, the bitmap can be shared by the filters of a batch.
+  class BitmapFilterFunctor : public FilterFunctor {
+   public:
+    explicit BitmapFilterFunctor(std::shared_ptr<const VectorIdBitmap> bitmap) : bitmap_(bitmap) {}
+    explicit BitmapFilterFunctor(const std::vector<int64_t>& vector_ids)
+        : bitmap_(std::make_shared<VectorIdBitmap>(vector_ids)) {}
+
+    ~BitmapFilterFunctor() override = default;
+
+    bool Check(int64_t vector_id) override { return bitmap_->Contains(vector_id); }
+
+   private:
+    std::shared_ptr<const VectorIdBitmap> bitmap_;
+  };
+
   virtual int32_t GetDimension() = 0;
   virtual pb::common::MetricType GetMetricType() = 0;
   virtual butil::Status GetCount(int64_t& count);
@@ -132,8 +149,15 @@ class VectorIndex {
   virtual bool NeedToRebuild() = 0;
   virtual bool NeedTrain() { return false; }
   virtual bool IsTrained() { return true; }
+  // Max count of vectors for train, the more are sampled. 0 means all.
+  virtual int64_t TrainSampleSize() { return 0; }
   virtual bool NeedToSave(int64_t last_save_log_behind) = 0;
   virtual bool SupportSave() { return false; }
+  // Repair index in place for deleted elements, cheaper than rebuild.
+  virtual bool NeedToRepair() { return false; }
+  virtual butil::Status Repair() { return butil::Status::OK(); }
+  // Optimize memory layout for search locality, invoke after build and before serving.
+  virtual butil::Status OptimizeLayout() { return butil::Status::OK(); }
 
   virtual uint32_t WriteOpParallelNum() { return 1; }
 
@@ -160,7 +184,16 @@ class VectorIndex {
   pb::common::Range Range() const;
   void SetEpochAndRange(const pb::common::RegionEpoch& epoch, const pb::common::Range& range);
 
+  // Fill distance computations, visited nodes and probed lists of searches.
+  virtual void GetSearchStats(pb::common::VectorSearchStats& stats);
+
  protected:
+  void AddSearchStats(int64_t distance_computations, int64_t visited_nodes, int64_t probed_lists) {
+    distance_computations_.fetch_add(distance_computations, std::memory_order_relaxed);
+    visited_nodes_.fetch_add(visited_nodes, std::memory_order_relaxed);
+    probed_lists_.fetch_add(probed_lists, std::memory_order_relaxed);
+  }
+
   // vector index id
   int64_t id;
   // vector index type, e.g. hnsw/flat
@@ -178,6 +211,10 @@ class VectorIndex {
 
   // vector index thread pool
   ThreadPoolPtr thread_pool;
+
+  std::atomic<int64_t> distance_computations_{0};
+  std::atomic<int64_t> visited_nodes_{0};
+  std::atomic<int64_t> probed_lists_{0};
 };
 
 using VectorIndexPtr = std::shared_ptr<VectorIndex>;
@@ -271,6 +308,9 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
     return snapshot_set_;
   }
 
+  // Inverted index of scalar data for pre filter, always not null.
+  VectorScalarInvertedIndexPtr ScalarInvertedIndex() const { return scalar_inverted_index_; }
+
   void UpdateVectorIndex(VectorIndexPtr vector_index, const std::string& trace);
   void ClearVectorIndex(const std::string& trace);
 
@@ -289,6 +329,11 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   void IncPendingTaskNum();
   void DecPendingTaskNum();
 
+  // pending async apply task of vector add/delete log
+  int32_t PendingApplyNum();
+  void IncPendingApplyNum();
+  void DecPendingApplyNum();
+
   int32_t LoadorbuildingNum();
   void IncLoadoruildingNum();
   void DecLoadoruildingNum();
@@ -308,9 +353,29 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   butil::Status GetMemorySize(int64_t& memory_size);
   bool IsExceedsMaxElements();
 
+  // Search stats of region, the index counters are from the own vector index.
+  void IncSearchQueryCount(int64_t count);
+  void AddFilterStats(int64_t checked_count, int64_t passed_count) {
+    filter_checked_count_.fetch_add(checked_count, std::memory_order_relaxed);
+    filter_passed_count_.fetch_add(passed_count, std::memory_order_relaxed);
+  }
+  void IncBruteForceCount() { brute_force_count_.fetch_add(1, std::memory_order_relaxed); }
+  void GetSearchStats(pb::common::VectorSearchStats& stats);
+
+  // Cold vector index is offloaded under memory pressure, and searched by brute force until reloaded.
+  bool IsOffloaded() const { return is_offloaded_.load(); }
+  void SetOffloaded(bool is_offloaded) { is_offloaded_.store(is_offloaded); }
+  // Last time of search or load, for choosing the least recently used vector index to offload.
+  int64_t LastSearchTimeMs() const { return last_search_time_ms_.load(std::memory_order_relaxed); }
+  // Return true at the vector_index_reload_search_count search in vector_index_reload_window_s,
+  // then the offloaded vector index need reload.
+  bool CountOffloadedSearch();
+
   bool NeedToRebuild();
   bool NeedToSave(std::string& reason);
   bool SupportSave();
+  bool NeedToRepair();
+  butil::Status Repair();
 
   butil::Status Add(const std::vector<pb::common::VectorWithId>& vector_with_ids);
   butil::Status Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids);
@@ -374,7 +439,11 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   // Snapshot set
   vector_index::SnapshotMetaSetPtr snapshot_set_;
 
+  VectorScalarInvertedIndexPtr scalar_inverted_index_;
+
   std::atomic<int32_t> pending_task_num_;
+  // async apply task num
+  std::atomic<int32_t> pending_apply_num_{0};
   // vector index loadorbuilding num
   std::atomic<int32_t> loadorbuilding_num_;
   // vector index rebuilding num
@@ -390,6 +459,17 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
 
   // need hold vector index
   std::atomic<bool> is_hold_vector_index_;
+
+  std::atomic<int64_t> search_query_count_{0};
+  std::atomic<int64_t> filter_checked_count_{0};
+  std::atomic<int64_t> filter_passed_count_{0};
+  std::atomic<int64_t> brute_force_count_{0};
+
+  std::atomic<bool> is_offloaded_{false};
+  std::atomic<int64_t> last_search_time_ms_{0};
+  // search count of offloaded vector index in the window
+  std::atomic<int64_t> offloaded_search_count_{0};
+  std::atomic<int64_t> offloaded_search_window_start_ms_{0};
 };
 
 using VectorIndexWrapperPtr = std::shared_ptr<VectorIndexWrapper>;
@@ -0,0 +1,866 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_index_diskann.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/compiler_specific.h"
+#include "butil/status.h"
+#include "bvar/latency_recorder.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/synchronization.h"
+#include "faiss/Index.h"
+#include "faiss/IndexFlat.h"
+#include "faiss/MetricType.h"
+#include "faiss/impl/AuxIndexStructures.h"
+#include "faiss/index_io.h"
+#include "faiss/utils/distances.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index_mmap_reader.h"
+#include "vector/vector_index_raw_ivf_pq.h"
+#include "vector/vector_index_utils.h"
+
+namespace dingodb {
+
+DEFINE_string(diskann_vector_file_path, "./data/diskann", "the directory of diskann full precision vector files");
+DEFINE_int64(diskann_need_save_count, 10000, "diskann need save count");
+DEFINE_int32(diskann_default_rerank_factor, 4, "diskann default rerank factor");
+
+bvar::LatencyRecorder g_diskann_search_latency("dingo_diskann_search_latency");
+bvar::LatencyRecorder g_diskann_rerank_latency("dingo_diskann_rerank_latency");
+
+static bool PwriteFull(int fd, const char* data, size_t size, off_t offset) {
+  while (size > 0) {
+    ssize_t n = ::pwrite(fd, data, size, offset);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += n;
+    size -= n;
+    offset += n;
+  }
+  return true;
+}
+
+static bool PreadFull(int fd, char* data, size_t size, off_t offset) {
+  while (size > 0) {
+    ssize_t n = ::pread(fd, data, size, offset);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    if (n == 0) {
+      return false;
+    }
+    data += n;
+    size -= n;
+    offset += n;
+  }
+  return true;
+}
+
+DiskAnnVectorFile::DiskAnnVectorFile(const std::string& path, int32_t dimension) : path_(path), dimension_(dimension) {}
+
+DiskAnnVectorFile::~DiskAnnVectorFile() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  Helper::RemoveFileOrDirectory(path_);
+}
+
+butil::Status DiskAnnVectorFile::Open() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+
+  fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open diskann vector file {} failed, error: {}", path_,
+                                                           strerror(errno)));
+  }
+
+  file_size_ = 0;
+  offsets_.clear();
+  return butil::Status::OK();
+}
+
+butil::Status DiskAnnVectorFile::LoadFrom(const std::string& path) {
+  int src_fd = ::open(path.c_str(), O_RDONLY);
+  if (src_fd < 0) {
+    return butil::Status(pb::error::EINTERNAL,
+                         fmt::format("open diskann vector file {} failed, error: {}", path, strerror(errno)));
+  }
+
+  auto status = Open();
+  if (!status.ok()) {
+    ::close(src_fd);
+    return status;
+  }
+
+  // copy the file, the source file belongs to vector index snapshot which may be deleted.
+  std::vector<char> buffer(RecordSize() * 1024);
+  int64_t offset = 0;
+  while (true) {
+    ssize_t n = ::pread(src_fd, buffer.data(), buffer.size(), offset);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      ::close(src_fd);
+      return butil::Status(pb::error::EINTERNAL,
+                           fmt::format("read diskann vector file {} failed, error: {}", path, strerror(errno)));
+    }
+    if (n == 0) {
+      break;
+    }
+    if (n % RecordSize() != 0 && static_cast<size_t>(n) < buffer.size()) {
+      ::close(src_fd);
+      return butil::Status(pb::error::EINTERNAL, fmt::format("diskann vector file {} is corrupted", path));
+    }
+
+    size_t record_num = n / RecordSize();
+    if (!PwriteFull(fd_, buffer.data(), record_num * RecordSize(), file_size_)) {
+      ::close(src_fd);
+      return butil::Status(pb::error::EINTERNAL,
+                           fmt::format("write diskann vector file {} failed, error: {}", path_, strerror(errno)));
+    }
+    for (size_t i = 0; i < record_num; ++i) {
+      int64_t vector_id = 0;
+      memcpy(&vector_id, buffer.data() + i * RecordSize(), sizeof(vector_id));
+      offsets_[vector_id] = file_size_ + i * RecordSize();
+    }
+    file_size_ += record_num * RecordSize();
+    offset += record_num * RecordSize();
+  }
+
+  ::close(src_fd);
+  return butil::Status::OK();
+}
+
+butil::Status DiskAnnVectorFile::SaveTo(const std::string& path) const {
+  int dst_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (dst_fd < 0) {
+    return butil::Status(pb::error::EINTERNAL,
+                         fmt::format("open diskann vector file {} failed, error: {}", path, strerror(errno)));
+  }
+
+  // write alive records in file order, so the dead records are compacted.
+  std::vector<int64_t> offsets;
+  offsets.reserve(offsets_.size());
+  for (const auto& [_, offset] : offsets_) {
+    offsets.push_back(offset);
+  }
+  std::sort(offsets.begin(), offsets.end());
+
+  std::vector<char> record(RecordSize());
+  int64_t dst_offset = 0;
+  for (auto offset : offsets) {
+    if (!PreadFull(fd_, record.data(), record.size(), offset) ||
+        !PwriteFull(dst_fd, record.data(), record.size(), dst_offset)) {
+      ::close(dst_fd);
+      return butil::Status(pb::error::EINTERNAL, fmt::format("save diskann vector file {} failed, error: {}", path,
+                                                             strerror(errno)));
+    }
+    dst_offset += record.size();
+  }
+
+  if (::fsync(dst_fd) != 0) {
+    ::close(dst_fd);
+    return butil::Status(pb::error::EINTERNAL,
+                         fmt::format("sync diskann vector file {} failed, error: {}", path, strerror(errno)));
+  }
+
+  ::close(dst_fd);
+  return butil::Status::OK();
+}
+
+butil::Status DiskAnnVectorFile::Append(const int64_t* ids, const float* vectors, size_t count) {
+  if (count == 0) {
+    return butil::Status::OK();
+  }
+
+  std::vector<char> buffer(RecordSize() * count);
+  for (size_t i = 0; i < count; ++i) {
+    char* record = buffer.data() + i * RecordSize();
+    memcpy(record, &ids[i], sizeof(int64_t));
+    memcpy(record + sizeof(int64_t), vectors + i * dimension_, dimension_ * sizeof(float));
+  }
+
+  if (!PwriteFull(fd_, buffer.data(), buffer.size(), file_size_)) {
+    return butil::Status(pb::error::EINTERNAL,
+                         fmt::format("write diskann vector file {} failed, error: {}", path_, strerror(errno)));
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    offsets_[ids[i]] = file_size_ + i * RecordSize();
+  }
+  file_size_ += buffer.size();
+
+  return butil::Status::OK();
+}
+
+void DiskAnnVectorFile::Remove(const int64_t* ids, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    offsets_.erase(ids[i]);
+  }
+}
+
+void DiskAnnVectorFile::Clear() {
+  offsets_.clear();
+  file_size_ = 0;
+  if (fd_ >= 0 && ::ftruncate(fd_, 0) != 0) {
+    DINGO_LOG(ERROR) << fmt::format("truncate diskann vector file {} failed, error: {}", path_, strerror(errno));
+  }
+}
+
+bool DiskAnnVectorFile::Read(int64_t id, float* vector) const {
+  auto it = offsets_.find(id);
+  if (it == offsets_.end()) {
+    return false;
+  }
+
+  return PreadFull(fd_, reinterpret_cast<char*>(vector), dimension_ * sizeof(float), it->second + sizeof(int64_t));
+}
+
+size_t DiskAnnVectorFile::MemorySize() const {
+  return offsets_.size() * (sizeof(int64_t) + sizeof(int64_t)) + offsets_.bucket_count() * sizeof(void*);
+}
+
+VectorIndexDiskAnn::VectorIndexDiskAnn(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
+                                       const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
+                                       ThreadPoolPtr thread_pool)
+    : VectorIndex(id, vector_index_parameter, epoch, range, thread_pool) {
+  bthread_mutex_init(&mutex_, nullptr);
+
+  const auto& diskann_parameter = vector_index_parameter.diskann_parameter();
+  metric_type_ = diskann_parameter.metric_type();
+  dimension_ = diskann_parameter.dimension();
+
+  nlist_ = diskann_parameter.ncentroids() > 0 ? diskann_parameter.ncentroids() : Constant::kCreateIvfPqParamNcentroids;
+  nsubvector_ =
+      diskann_parameter.nsubvector() > 0 ? diskann_parameter.nsubvector() : Constant::kCreateIvfPqParamNsubvector;
+  nbits_per_idx_ = diskann_parameter.nbits_per_idx() % 64;
+  if (0 == nbits_per_idx_) {
+    nbits_per_idx_ = Constant::kCreateIvfPqParamNbitsPerIdx;
+  }
+
+  normalize_ = (pb::common::MetricType::METRIC_TYPE_COSINE == metric_type_);
+
+  train_data_size_ = 0;
+  // Delay object creation.
+}
+
+VectorIndexDiskAnn::~VectorIndexDiskAnn() { bthread_mutex_destroy(&mutex_); }
+
+butil::Status VectorIndexDiskAnn::AddOrUpsert(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                              bool is_upsert) {
+  if (vector_with_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  const auto& [ids, status_ids] = VectorIndexUtils::CheckAndCopyVectorId(vector_with_ids, dimension_);
+  if (!status_ids.ok()) {
+    DINGO_LOG(ERROR) << status_ids.error_cstr();
+    return status_ids;
+  }
+
+  const auto& [vectors, status] = VectorIndexUtils::CopyVectorData(vector_with_ids, dimension_, normalize_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (BAIDU_UNLIKELY(!DoIsTrained())) {
+    std::string s = fmt::format("diskann not train. train first.");
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_TRAIN, s);
+  }
+
+  if (is_upsert) {
+    faiss::IDSelectorArray sel(vector_with_ids.size(), ids.get());
+    index_->remove_ids(sel);
+  }
+
+  // write SSD first, a vector searched from PQ index must be able to re-rank.
+  auto ret = vector_file_->Append(ids.get(), vectors.get(), vector_with_ids.size());
+  if (!ret.ok()) {
+    DINGO_LOG(ERROR) << ret.error_cstr();
+    return ret;
+  }
+  index_->add_with_ids(vector_with_ids.size(), vectors.get(), ids.get());
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::AddOrUpsertWrapper(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                                     bool is_upsert) {
+  auto status = AddOrUpsert(vector_with_ids, is_upsert);
+  if (BAIDU_UNLIKELY(pb::error::Errno::EVECTOR_NOT_TRAIN == status.error_code())) {
+    status = Train(vector_with_ids);
+    if (BAIDU_LIKELY(status.ok())) {
+      // try again
+      status = AddOrUpsert(vector_with_ids, is_upsert);
+      if (BAIDU_LIKELY(!status.ok())) {
+        DINGO_LOG(ERROR) << status;
+        return status;
+      }
+    } else {
+      DINGO_LOG(ERROR) << status;
+      return status;
+    }
+  }
+
+  return status;
+}
+
+butil::Status VectorIndexDiskAnn::Add(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  return AddOrUpsertWrapper(vector_with_ids, false);
+}
+
+butil::Status VectorIndexDiskAnn::Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  return AddOrUpsertWrapper(vector_with_ids, true);
+}
+
+butil::Status VectorIndexDiskAnn::Delete(const std::vector<int64_t>& delete_ids) {
+  if (delete_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  const auto& [ids, status] = VectorIndexUtils::CopyVectorId(delete_ids);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  faiss::IDSelectorArray sel(delete_ids.size(), ids.get());
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (BAIDU_UNLIKELY(!DoIsTrained())) {
+    DINGO_LOG(WARNING) << "diskann not train. train first. ignored";
+    return butil::Status::OK();
+  }
+
+  index_->remove_ids(sel);
+  vector_file_->Remove(delete_ids.data(), delete_ids.size());
+
+  return butil::Status::OK();
+}
+
+float VectorIndexDiskAnn::Distance(const float* x, const float* y) const {
+  if (index_->metric_type == faiss::METRIC_INNER_PRODUCT) {
+    return faiss::fvec_inner_product(x, y, dimension_);
+  }
+  return faiss::fvec_L2sqr(x, y, dimension_);
+}
+
+butil::Status VectorIndexDiskAnn::Search(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                         const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                                         bool /*reconstruct*/, const pb::common::VectorSearchParameter& parameter,
+                                         std::vector<pb::index::VectorWithDistanceResult>& results) {  // NOLINT
+  if (vector_with_ids.empty()) {
+    DINGO_LOG(WARNING) << "vector_with_ids is empty";
+    return butil::Status::OK();
+  }
+
+  if (topk == 0) {
+    DINGO_LOG(WARNING) << "topk is invalid";
+    return butil::Status::OK();
+  }
+
+  BvarLatencyGuard bvar_guard(&g_diskann_search_latency);
+
+  int32_t nprobe = parameter.diskann().nprobe();
+  if (nprobe <= 0) {
+    nprobe = Constant::kSearchIvfPqParamNprobe;
+  }
+  int32_t rerank_factor = parameter.diskann().rerank_factor();
+  if (rerank_factor <= 0) {
+    rerank_factor = FLAGS_diskann_default_rerank_factor;
+  }
+
+  const auto& [vectors, status] = VectorIndexUtils::CheckAndViewVectorData(vector_with_ids, dimension_, normalize_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  size_t candidate_num = static_cast<size_t>(topk) * rerank_factor;
+  std::vector<faiss::Index::distance_t> candidate_distances(candidate_num * vector_with_ids.size(), 0.0f);
+  std::vector<faiss::idx_t> candidate_labels(candidate_num * vector_with_ids.size(), -1);
+
+  std::vector<faiss::Index::distance_t> distances(topk * vector_with_ids.size(), 0.0f);
+  std::vector<faiss::idx_t> labels(topk * vector_with_ids.size(), -1);
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (BAIDU_UNLIKELY(!DoIsTrained())) {
+      DINGO_LOG(WARNING) << "diskann not train. train first. ignored";
+      for (size_t row = 0; row < vector_with_ids.size(); ++row) {
+        results.emplace_back();
+      }
+      return butil::Status::OK();
+    }
+
+    faiss::IVFSearchParameters ivf_search_parameters;
+    ivf_search_parameters.nprobe = std::min(nprobe, static_cast<int32_t>(index_->nlist));
+    ivf_search_parameters.max_codes = 0;
+    ivf_search_parameters.quantizer_params = nullptr;
+
+    // search candidates from PQ compressed vectors in memory
+    std::shared_ptr<RawIvfPqIDSelector> filter = filters.empty() ? nullptr : std::make_shared<RawIvfPqIDSelector>(filters);
+    ivf_search_parameters.sel = filter.get();
+    try {
+      index_->search(vector_with_ids.size(), vectors.get(), candidate_num, candidate_distances.data(),
+                     candidate_labels.data(), &ivf_search_parameters);
+    } catch (std::exception& e) {
+      std::string s = fmt::format("VectorIndexDiskAnn::Search failed. error : {}", e.what());
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EINTERNAL, s);
+    }
+
+    // re-rank candidates by full precision vectors on SSD
+    BvarLatencyGuard rerank_guard(&g_diskann_rerank_latency);
+    bool is_ip = (index_->metric_type == faiss::METRIC_INNER_PRODUCT);
+    std::vector<float> full_vector(dimension_);
+    std::vector<std::pair<float, faiss::idx_t>> reranked;
+    reranked.reserve(candidate_num);
+    for (size_t row = 0; row < vector_with_ids.size(); ++row) {
+      reranked.clear();
+      const float* query = vectors.get() + row * dimension_;
+      for (size_t i = 0; i < candidate_num; ++i) {
+        auto label = candidate_labels[row * candidate_num + i];
+        if (label < 0) {
+          continue;
+        }
+        if (vector_file_->Read(label, full_vector.data())) {
+          reranked.emplace_back(Distance(query, full_vector.data()), label);
+        } else {
+          // not found on SSD, fallback to PQ distance.
+          reranked.emplace_back(candidate_distances[row * candidate_num + i], label);
+        }
+      }
+
+      size_t result_num = std::min(static_cast<size_t>(topk), reranked.size());
+      std::partial_sort(reranked.begin(), reranked.begin() + result_num, reranked.end(),
+                        [is_ip](const auto& a, const auto& b) { return is_ip ? a.first > b.first : a.first < b.first; });
+      for (size_t i = 0; i < result_num; ++i) {
+        distances[row * topk + i] = reranked[i].first;
+        labels[row * topk + i] = reranked[i].second;
+      }
+    }
+  }
+
+  VectorIndexUtils::FillSearchResult(vector_with_ids, topk, distances, labels, metric_type_, dimension_, results);
+
+  DINGO_LOG(DEBUG) << "result.size() = " << results.size();
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::RangeSearch(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                              float radius,
+                                              const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
+                                              bool /*reconstruct*/, const pb::common::VectorSearchParameter& parameter,
+                                              std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (vector_with_ids.empty()) {
+    DINGO_LOG(WARNING) << "vector_with_ids is empty";
+    return butil::Status::OK();
+  }
+
+  int32_t nprobe = parameter.diskann().nprobe();
+  if (nprobe <= 0) {
+    nprobe = Constant::kSearchIvfPqParamNprobe;
+  }
+
+  const auto& [vectors, status] = VectorIndexUtils::CheckAndViewVectorData(vector_with_ids, dimension_, normalize_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  std::unique_ptr<faiss::RangeSearchResult> range_search_result =
+      std::make_unique<faiss::RangeSearchResult>(vector_with_ids.size());
+
+  if (metric_type_ == pb::common::MetricType::METRIC_TYPE_COSINE ||
+      metric_type_ == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT) {
+    radius = 1.0F - radius;
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (BAIDU_UNLIKELY(!DoIsTrained())) {
+      DINGO_LOG(WARNING) << "diskann not train. train first. ignored";
+      for (size_t row = 0; row < vector_with_ids.size(); ++row) {
+        results.emplace_back();
+      }
+      return butil::Status::OK();
+    }
+
+    faiss::IVFSearchParameters ivf_search_parameters;
+    ivf_search_parameters.nprobe = std::min(nprobe, static_cast<int32_t>(index_->nlist));
+    ivf_search_parameters.max_codes = 0;
+    ivf_search_parameters.quantizer_params = nullptr;
+
+    std::shared_ptr<RawIvfPqIDSelector> filter = filters.empty() ? nullptr : std::make_shared<RawIvfPqIDSelector>(filters);
+    ivf_search_parameters.sel = filter.get();
+    try {
+      index_->range_search(vector_with_ids.size(), vectors.get(), radius, range_search_result.get(),
+                           &ivf_search_parameters);
+    } catch (std::exception& e) {
+      std::string s = fmt::format("VectorIndexDiskAnn::RangeSearch failed. error : {}", e.what());
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EINTERNAL, s);
+    }
+
+    // correct the distances by full precision vectors on SSD
+    std::vector<float> full_vector(dimension_);
+    for (size_t row = 0; row < range_search_result->nq; ++row) {
+      const float* query = vectors.get() + row * dimension_;
+      for (size_t i = range_search_result->lims[row]; i < range_search_result->lims[row + 1]; ++i) {
+        if (vector_file_->Read(range_search_result->labels[i], full_vector.data())) {
+          range_search_result->distances[i] = Distance(query, full_vector.data());
+        }
+      }
+    }
+  }
+
+  VectorIndexUtils::FillRangeSearchResult(range_search_result, metric_type_, dimension_, results);
+
+  DINGO_LOG(DEBUG) << "result.size() = " << results.size();
+
+  return butil::Status::OK();
+}
+
+void VectorIndexDiskAnn::LockWrite() { bthread_mutex_lock(&mutex_); }
+
+void VectorIndexDiskAnn::UnlockWrite() { bthread_mutex_unlock(&mutex_); }
+
+bool VectorIndexDiskAnn::SupportSave() { return true; }
+
+butil::Status VectorIndexDiskAnn::Save(const std::string& path) {
+  // Warning : the save function is executed in the fork child process, don't call glog here.
+  if (BAIDU_UNLIKELY(path.empty())) {
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "path empty. not support");
+  }
+
+  if (BAIDU_UNLIKELY(!DoIsTrained())) {
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_TRAIN, "diskann not train. not support save");
+  }
+
+  // The outside has been locked. Remove the locking operation here.
+  try {
+    faiss::write_index(index_.get(), path.c_str());
+  } catch (std::exception& e) {
+    return butil::Status(pb::error::Errno::EINTERNAL,
+                         fmt::format("VectorIndexDiskAnn::Save faiss::write_index failed. path : {} error : {}", path,
+                                     e.what()));
+  }
+
+  return vector_file_->SaveTo(VectorFilePath(path));
+}
+
+butil::Status VectorIndexDiskAnn::Load(const std::string& path) {
+  if (BAIDU_UNLIKELY(path.empty())) {
+    std::string s = fmt::format("path empty. not support");
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+  }
+
+  // The outside has been locked. Remove the locking operation here.
+  faiss::Index* internal_raw_index = nullptr;
+  try {
+    internal_raw_index = MmapIndexReader::ReadIndex(path);
+  } catch (std::exception& e) {
+    delete internal_raw_index;
+    std::string s =
+        fmt::format("VectorIndexDiskAnn::Load faiss::read_index failed. path : {} error : {}", path, e.what());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  std::unique_ptr<faiss::IndexIVFPQ> internal_index(dynamic_cast<faiss::IndexIVFPQ*>(internal_raw_index));
+  if (BAIDU_UNLIKELY(internal_index == nullptr)) {
+    delete internal_raw_index;
+    std::string s = fmt::format("VectorIndexDiskAnn::Load maybe not IndexIVFPQ. path : {}", path);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  if (BAIDU_UNLIKELY(internal_index->d != dimension_ || !internal_index->is_trained ||
+                     internal_index->nlist != nlist_ || internal_index->pq.M != nsubvector_ ||
+                     internal_index->pq.nbits != nbits_per_idx_)) {
+    std::string s = fmt::format(
+        "VectorIndexDiskAnn::Load index not match, dimension : {}/{} nlist : {}/{} M : {}/{} nbits : {}/{} path : {}",
+        internal_index->d, dimension_, internal_index->nlist, nlist_, internal_index->pq.M, nsubvector_,
+        internal_index->pq.nbits, nbits_per_idx_, path);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  faiss::MetricType expect_metric_type = (metric_type_ == pb::common::METRIC_TYPE_INNER_PRODUCT ||
+                                          metric_type_ == pb::common::METRIC_TYPE_COSINE)
+                                             ? faiss::METRIC_INNER_PRODUCT
+                                             : faiss::METRIC_L2;
+  if (BAIDU_UNLIKELY(internal_index->metric_type != expect_metric_type)) {
+    std::string s = fmt::format("VectorIndexDiskAnn::Load load from path type : {} != local type : {}. path : {}",
+                                static_cast<int>(internal_index->metric_type), static_cast<int>(metric_type_), path);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  auto vector_file = std::make_unique<DiskAnnVectorFile>(
+      fmt::format("{}/{}_{}.vectors", FLAGS_diskann_vector_file_path, Id(), Helper::TimestampNs()), dimension_);
+  auto status = vector_file->LoadFrom(VectorFilePath(path));
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("VectorIndexDiskAnn::Load load vector file failed, error: {}", status.error_str());
+    return status;
+  }
+
+  quantizer_.reset();
+  index_ = std::move(internal_index);
+  vector_file_ = std::move(vector_file);
+  train_data_size_ = index_->ntotal;
+
+  DINGO_LOG(INFO) << fmt::format("VectorIndexDiskAnn::Load success. path : {} count : {}", path,
+                                 vector_file_->Count());
+
+  return butil::Status::OK();
+}
+
+int32_t VectorIndexDiskAnn::GetDimension() { return this->dimension_; }
+
+pb::common::MetricType VectorIndexDiskAnn::GetMetricType() { return this->metric_type_; }
+
+butil::Status VectorIndexDiskAnn::GetCount(int64_t& count) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  count = DoIsTrained() ? index_->ntotal : 0;
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::GetDeletedCount(int64_t& deleted_count) {
+  deleted_count = 0;
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::GetMemorySize(int64_t& memory_size) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  memory_size = 0;
+  if (BAIDU_UNLIKELY(!DoIsTrained()) || index_->ntotal == 0) {
+    return butil::Status::OK();
+  }
+
+  // only PQ codes and the offset map are resident in memory, full precision vectors are on SSD.
+  auto capacity = index_->ntotal * index_->code_size + index_->ntotal * sizeof(faiss::idx_t) +
+                  index_->nlist * index_->d * sizeof(float);
+  auto centroid_table = index_->pq.M * index_->pq.ksub * index_->pq.dsub * sizeof(float);
+  memory_size += capacity + centroid_table + vector_file_->MemorySize();
+
+  if (faiss::METRIC_L2 == index_->metric_type) {
+    memory_size += index_->nlist * index_->pq.M * index_->pq.ksub * sizeof(float);
+  }
+
+  return butil::Status::OK();
+}
+
+bool VectorIndexDiskAnn::IsExceedsMaxElements() { return false; }
+
+butil::Status VectorIndexDiskAnn::Train(const std::vector<float>& train_datas) {
+  size_t data_size = train_datas.size() / dimension_;
+
+  if (BAIDU_UNLIKELY(0 != train_datas.size() % dimension_)) {
+    std::string s =
+        fmt::format("train_datas float size : {} , dimension : {}, Not divisible ", train_datas.size(), dimension_);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  if (BAIDU_UNLIKELY(0 == data_size)) {
+    std::string s = fmt::format("train_datas zero not support ");
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (BAIDU_UNLIKELY(DoIsTrained())) {
+    DINGO_LOG(WARNING) << "already trained . ignore";
+    return butil::Status::OK();
+  }
+
+  auto status = Helper::CreateDirectories(FLAGS_diskann_vector_file_path);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("create diskann vector file path {} failed, error: {}",
+                                    FLAGS_diskann_vector_file_path, status.error_str());
+    return status;
+  }
+
+  // init index
+  Init();
+
+  status = vector_file_->Open();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    Reset();
+    return status;
+  }
+
+  train_data_size_ = 0;
+
+  const float* train_datas_ptr = train_datas.data();
+  std::vector<float> train_datas_for_normalize;
+  if (normalize_) {
+    train_datas_for_normalize = train_datas;
+    for (size_t i = 0; i < data_size; i++) {
+      VectorIndexUtils::NormalizeVectorForFaiss(train_datas_for_normalize.data() + i * dimension_, dimension_);
+    }
+    train_datas_ptr = train_datas_for_normalize.data();
+  }
+
+  try {
+    index_->train(data_size, train_datas_ptr);
+  } catch (std::exception& e) {
+    Reset();
+    std::string s =
+        fmt::format("diskann train failed data size : {} dimension : {} exception {}", data_size, dimension_, e.what());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  if (BAIDU_UNLIKELY(!index_->is_trained)) {
+    Reset();
+    std::string s =
+        fmt::format("diskann train failed. data size : {} dimension : {}. internal error", data_size, dimension_);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  train_data_size_ = data_size;
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::Train(const std::vector<pb::common::VectorWithId>& vectors) {
+  std::vector<float> train_datas;
+  train_datas.reserve(dimension_ * vectors.size());
+  for (const auto& vector : vectors) {
+    if (BAIDU_UNLIKELY(dimension_ != vector.vector().float_values().size())) {
+      std::string s = fmt::format("diskann train failed. float_values size : {} unequal dimension : {}.",
+                                  vector.vector().float_values().size(), dimension_);
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EINTERNAL, s);
+    }
+    train_datas.insert(train_datas.end(), vector.vector().float_values().begin(), vector.vector().float_values().end());
+  }
+
+  return VectorIndexDiskAnn::Train(train_datas);
+}
+
+bool VectorIndexDiskAnn::NeedToRebuild() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  if (BAIDU_UNLIKELY(!DoIsTrained())) {
+    return false;
+  }
+
+  return (index_->ntotal / 2) >= train_data_size_;
+}
+
+bool VectorIndexDiskAnn::IsTrained() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return DoIsTrained();
+}
+
+bool VectorIndexDiskAnn::NeedToSave(int64_t last_save_log_behind) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (BAIDU_UNLIKELY(!DoIsTrained())) {
+    return false;
+  }
+
+  if (index_->ntotal == 0) {
+    return false;
+  }
+
+  return last_save_log_behind > FLAGS_diskann_need_save_count;
+}
+
+void VectorIndexDiskAnn::Init() {
+  if (pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT == metric_type_ ||
+      pb::common::MetricType::METRIC_TYPE_COSINE == metric_type_) {
+    quantizer_ = std::make_unique<faiss::IndexFlatIP>(dimension_);
+    index_ = std::make_unique<faiss::IndexIVFPQ>(quantizer_.get(), dimension_, nlist_, nsubvector_, nbits_per_idx_,
+                                                 faiss::MetricType::METRIC_INNER_PRODUCT);
+  } else {
+    if (pb::common::MetricType::METRIC_TYPE_L2 != metric_type_) {
+      DINGO_LOG(WARNING) << fmt::format("diskann : not support metric type : {} use L2 default",
+                                        static_cast<int>(metric_type_));
+    }
+    quantizer_ = std::make_unique<faiss::IndexFlatL2>(dimension_);
+    index_ = std::make_unique<faiss::IndexIVFPQ>(quantizer_.get(), dimension_, nlist_, nsubvector_, nbits_per_idx_,
+                                                 faiss::MetricType::METRIC_L2);
+  }
+
+  vector_file_ = std::make_unique<DiskAnnVectorFile>(
+      fmt::format("{}/{}_{}.vectors", FLAGS_diskann_vector_file_path, Id(), Helper::TimestampNs()), dimension_);
+}
+
+bool VectorIndexDiskAnn::DoIsTrained() {
+  if (vector_file_ == nullptr) {
+    return false;
+  }
+  if ((index_ && !quantizer_ && index_->own_fields) || (quantizer_ && index_ && !index_->own_fields)) {
+    return index_->is_trained;
+  }
+  return false;
+}
+
+void VectorIndexDiskAnn::Reset() {
+  if (quantizer_ != nullptr) {
+    quantizer_->reset();
+  }
+  if (index_ != nullptr) {
+    index_->reset();
+  }
+  if (vector_file_ != nullptr) {
+    vector_file_->Clear();
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,167 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_INDEX_DISKANN_H_  // NOLINT
+#define DINGODB_VECTOR_INDEX_DISKANN_H_
+
+#include <faiss/IndexIVFPQ.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "faiss/Index.h"
+#include "faiss/MetricType.h"
+#include "proto/common.pb.h"
+#include "vector/vector_index.h"
+
+namespace dingodb {
+
+// Full precision vectors resident on SSD.
+// File format: | vector_id (int64) | float * dimension | ...
+// The file is append only, upsert append a new record and delete only remove the id from memory offset map,
+// the file is compacted when save.
+class DiskAnnVectorFile {
+ public:
+  DiskAnnVectorFile(const std::string& path, int32_t dimension);
+  ~DiskAnnVectorFile();
+
+  DiskAnnVectorFile(const DiskAnnVectorFile& rhs) = delete;
+  DiskAnnVectorFile& operator=(const DiskAnnVectorFile& rhs) = delete;
+
+  // create a empty file, if exist then truncate.
+  butil::Status Open();
+  // replace by the file of path, and rebuild offset map.
+  butil::Status LoadFrom(const std::string& path);
+  // write alive vectors to the file of path.
+  butil::Status SaveTo(const std::string& path) const;
+
+  butil::Status Append(const int64_t* ids, const float* vectors, size_t count);
+  void Remove(const int64_t* ids, size_t count);
+  void Clear();
+
+  // read vector from SSD, return false if not exist.
+  bool Read(int64_t id, float* vector) const;
+
+  size_t Count() const { return offsets_.size(); }
+  size_t MemorySize() const;
+  const std::string& Path() const { return path_; }
+
+ private:
+  size_t RecordSize() const { return sizeof(int64_t) + dimension_ * sizeof(float); }
+
+  std::string path_;
+  int32_t dimension_;
+  int fd_{-1};
+  int64_t file_size_{0};
+  // vector_id -> record offset
+  std::unordered_map<int64_t, int64_t> offsets_;
+};
+
+// DiskANN style vector index.
+// Keep the PQ compressed vectors in memory for candidates searching,
+// and keep the full precision vectors on SSD for re-ranking the candidates.
+class VectorIndexDiskAnn : public VectorIndex {
+ public:
+  explicit VectorIndexDiskAnn(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
+                              const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
+                              ThreadPoolPtr thread_pool);
+
+  ~VectorIndexDiskAnn() override;
+
+  VectorIndexDiskAnn(const VectorIndexDiskAnn& rhs) = delete;
+  VectorIndexDiskAnn& operator=(const VectorIndexDiskAnn& rhs) = delete;
+  VectorIndexDiskAnn(VectorIndexDiskAnn&& rhs) = delete;
+  VectorIndexDiskAnn& operator=(VectorIndexDiskAnn&& rhs) = delete;
+
+  // save PQ index to path and full precision vectors to path.vectors
+  butil::Status Save(const std::string& path) override;
+  butil::Status Load(const std::string& path) override;
+  bool SupportSave() override;
+
+  butil::Status Add(const std::vector<pb::common::VectorWithId>& vector_with_ids) override;
+  butil::Status Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids) override;
+  butil::Status Delete(const std::vector<int64_t>& delete_ids) override;
+
+  butil::Status Search(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                       const std::vector<std::shared_ptr<FilterFunctor>>& filters, bool reconstruct,
+                       const pb::common::VectorSearchParameter& parameter,
+                       std::vector<pb::index::VectorWithDistanceResult>& results) override;
+
+  butil::Status RangeSearch(const std::vector<pb::common::VectorWithId>& vector_with_ids, float radius,
+                            const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters, bool reconstruct,
+                            const pb::common::VectorSearchParameter& parameter,
+                            std::vector<pb::index::VectorWithDistanceResult>& results) override;
+
+  void LockWrite() override;
+  void UnlockWrite() override;
+
+  int32_t GetDimension() override;
+  pb::common::MetricType GetMetricType() override;
+  butil::Status GetCount(int64_t& count) override;
+  butil::Status GetDeletedCount(int64_t& deleted_count) override;
+  butil::Status GetMemorySize(int64_t& memory_size) override;
+  bool IsExceedsMaxElements() override;
+
+  butil::Status Train(const std::vector<float>& train_datas) override;
+  butil::Status Train(const std::vector<pb::common::VectorWithId>& vectors) override;
+  bool NeedToRebuild() override;
+  bool NeedTrain() override { return true; }
+  bool IsTrained() override;
+  bool NeedToSave(int64_t last_save_log_behind) override;
+
+  static std::string VectorFilePath(const std::string& index_path) { return index_path + ".vectors"; }
+
+ private:
+  void Init();
+  bool DoIsTrained();
+  void Reset();
+
+  butil::Status AddOrUpsert(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool is_upsert);
+  butil::Status AddOrUpsertWrapper(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool is_upsert);
+
+  // exact distance, the same semantics as faiss, L2 is squared distance and IP is similarity.
+  float Distance(const float* x, const float* y) const;
+
+  // Dimension of the elements
+  faiss::idx_t dimension_;
+
+  // only support L2 and IP
+  pb::common::MetricType metric_type_;
+
+  bthread_mutex_t mutex_;
+
+  size_t nlist_;
+  size_t nsubvector_;
+  int32_t nbits_per_idx_;
+
+  std::unique_ptr<faiss::Index> quantizer_;
+  std::unique_ptr<faiss::IndexIVFPQ> index_;
+
+  std::unique_ptr<DiskAnnVectorFile> vector_file_;
+
+  // normalize vector
+  bool normalize_;
+
+  // first train data size
+  faiss::idx_t train_data_size_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_INDEX_DISKANN_H_  // NOLINT
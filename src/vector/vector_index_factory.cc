@@ -22,6 +22,7 @@
 #include "server/server.h"
 #include "vector/vector_index.h"
 #include "vector/vector_index_bruteforce.h"
+#include "vector/vector_index_diskann.h"
 #include "vector/vector_index_flat.h"
 #include "vector/vector_index_hnsw.h"
 #include "vector/vector_index_ivf_flat.h"
@@ -59,8 +60,7 @@ std::shared_ptr<VectorIndex> VectorIndexFactory::New(int64_t id,
       break;
     }
     case pb::common::VECTOR_INDEX_TYPE_DISKANN: {
-      DINGO_LOG(ERROR) << "vector_index_parameter = diskann not implement, type=" << index_parameter.vector_index_type()
-                       << ", id=" << id << ", parameter=" << index_parameter.ShortDebugString();
+      vector_index = NewDiskAnn(id, index_parameter, epoch, range, thread_pool);
       break;
     }
     case pb::common::VectorIndexType_INT_MIN_SENTINEL_DO_NOT_USE_:
@@ -320,4 +320,54 @@ std::shared_ptr<VectorIndex> VectorIndexFactory::NewIvfPq(int64_t id,
   }
 }
 
+std::shared_ptr<VectorIndex> VectorIndexFactory::NewDiskAnn(int64_t id,
+                                                            const pb::common::VectorIndexParameter& index_parameter,
+                                                            const pb::common::RegionEpoch& epoch,
+                                                            const pb::common::Range& range, ThreadPoolPtr thread_pool) {
+  const auto& diskann_parameter = index_parameter.diskann_parameter();
+
+  uint32_t dimension = diskann_parameter.dimension();
+  if (dimension <= 0) {
+    DINGO_LOG(ERROR) << fmt::format("vector_index_parameter is illegal, dimension : {} <= 0 : ", dimension);
+    return nullptr;
+  }
+  if (diskann_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_NONE) {
+    DINGO_LOG(ERROR) << "vector_index_parameter is illegal, METRIC_TYPE_NONE";
+    return nullptr;
+  }
+  if (diskann_parameter.ncentroids() < 0 || diskann_parameter.nsubvector() < 0 ||
+      diskann_parameter.nbits_per_idx() < 0) {
+    DINGO_LOG(ERROR) << fmt::format(
+        "vector_index_parameter is illegal, ncentroids : {} nsubvector : {} nbits_per_idx : {} must >= 0",
+        diskann_parameter.ncentroids(), diskann_parameter.nsubvector(), diskann_parameter.nbits_per_idx());
+    return nullptr;
+  }
+
+  int32_t nsubvector = diskann_parameter.nsubvector() > 0 ? diskann_parameter.nsubvector()
+                                                          : Constant::kCreateIvfPqParamNsubvector;
+  if (0 != (dimension % nsubvector)) {
+    DINGO_LOG(ERROR) << fmt::format("vector_index_parameter is illegal, dimension:{} / nsubvector:{} not divisible ",
+                                    dimension, nsubvector);
+    return nullptr;
+  }
+
+  // create index may throw exeception, so we need to catch it
+  try {
+    auto new_diskann_index = std::make_shared<VectorIndexDiskAnn>(id, index_parameter, epoch, range, thread_pool);
+    if (new_diskann_index == nullptr) {
+      DINGO_LOG(ERROR) << "create diskann index failed of new_diskann_index is nullptr"
+                       << ", id=" << id << ", parameter=" << index_parameter.ShortDebugString();
+      return nullptr;
+    } else {
+      DINGO_LOG(INFO) << "create diskann index success, id=" << id
+                      << ", parameter=" << index_parameter.ShortDebugString();
+    }
+    return new_diskann_index;
+  } catch (std::exception& e) {
+    DINGO_LOG(ERROR) << "create diskann index failed of exception occured, " << e.what() << ", id=" << id
+                     << ", parameter=" << index_parameter.ShortDebugString();
+    return nullptr;
+  }
+}
+
 }  // namespace dingodb
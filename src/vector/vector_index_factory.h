@@ -53,6 +53,10 @@ class VectorIndexFactory {
                                                const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
                                                ThreadPoolPtr thread_pool);
 
+  static std::shared_ptr<VectorIndex> NewDiskAnn(int64_t id, const pb::common::VectorIndexParameter& index_parameter,
+                                                 const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
+                                                 ThreadPoolPtr thread_pool);
+
   static std::shared_ptr<VectorIndex> NewBruteForce(int64_t id, const pb::common::VectorIndexParameter& index_parameter,
                                                     const pb::common::RegionEpoch& epoch,
                                                     const pb::common::Range& range, ThreadPoolPtr thread_pool);
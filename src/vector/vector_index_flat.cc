@@ -36,6 +36,7 @@
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
+#include "vector/vector_index_mmap_reader.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
@@ -56,6 +57,7 @@ VectorIndexFlat::VectorIndexFlat(int64_t id, const pb::common::VectorIndexParame
   dimension_ = vector_index_parameter.flat_parameter().dimension();
 
   normalize_ = false;
+  binarize_ = false;
 
   if (pb::common::MetricType::METRIC_TYPE_L2 == metric_type_) {
     raw_index_ = std::make_unique<faiss::IndexFlatL2>(dimension_);
@@ -64,6 +66,10 @@ VectorIndexFlat::VectorIndexFlat(int64_t id, const pb::common::VectorIndexParame
   } else if (pb::common::MetricType::METRIC_TYPE_COSINE == metric_type_) {
     normalize_ = true;
     raw_index_ = std::make_unique<faiss::IndexFlatIP>(dimension_);
+  } else if (pb::common::MetricType::METRIC_TYPE_HAMMING == metric_type_) {
+    // squared L2 distance of bits is hamming distance.
+    binarize_ = true;
+    raw_index_ = std::make_unique<faiss::IndexFlatL2>(dimension_);
   } else {
     DINGO_LOG(WARNING) << fmt::format("Flat : not support metric type : {} use L2 default",
                                       static_cast<int>(metric_type_));
@@ -71,6 +77,10 @@ VectorIndexFlat::VectorIndexFlat(int64_t id, const pb::common::VectorIndexParame
   }
 
   index_id_map2_ = std::make_unique<faiss::IndexIDMap2>(raw_index_.get());
+
+  if (vector_index_parameter.flat_parameter().use_gpu()) {
+    gpu_replica_ = std::make_unique<GpuIndexReplica>(id);
+  }
 }
 
 VectorIndexFlat::~VectorIndexFlat() { index_id_map2_->reset(); }
@@ -109,6 +119,9 @@ butil::Status VectorIndexFlat::AddOrUpsert(const std::vector<pb::common::VectorW
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
   }
+  if (binarize_) {
+    VectorIndexUtils::BinarizeVector(vectors.get(), vector_with_ids.size() * dimension_);
+  }
 
   BvarLatencyGuard bvar_guard(&g_flat_upsert_latency);
   RWLockWriteGuard guard(&rw_lock_);
@@ -118,6 +131,9 @@ butil::Status VectorIndexFlat::AddOrUpsert(const std::vector<pb::common::VectorW
     index_id_map2_->remove_ids(sel);
   }
   index_id_map2_->add_with_ids(vector_with_ids.size(), vectors.get(), ids.get());
+  if (gpu_replica_ != nullptr) {
+    gpu_replica_->MarkStale();
+  }
 
   return butil::Status::OK();
 }
@@ -147,6 +163,9 @@ butil::Status VectorIndexFlat::Delete(const std::vector<int64_t>& delete_ids) {
     BvarLatencyGuard bvar_guard(&g_flat_delete_latency);
     RWLockWriteGuard guard(&rw_lock_);
     auto remove_count = index_id_map2_->remove_ids(sel);
+    if (gpu_replica_ != nullptr) {
+      gpu_replica_->MarkStale();
+    }
     if (0 == remove_count) {
       DINGO_LOG(ERROR) << fmt::format("not found id : {}", id);
       return butil::Status(pb::error::Errno::EVECTOR_INVALID, fmt::format("not found : {}", id));
@@ -180,10 +199,14 @@ butil::Status VectorIndexFlat::Search(const std::vector<pb::common::VectorWithId
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
   }
+  if (binarize_) {
+    VectorIndexUtils::BinarizeVector(vectors.get(), vector_with_ids.size() * dimension_);
+  }
 
   {
     BvarLatencyGuard bvar_guard(&g_flat_search_latency);
     RWLockReadGuard guard(&rw_lock_);
+    SearchThreadGuard thread_guard;
 
     if (!filters.empty()) {
       // use faiss's search_param to do pre-filter
@@ -192,9 +215,13 @@ butil::Status VectorIndexFlat::Search(const std::vector<pb::common::VectorWithId
       flat_search_parameters.sel = flat_filter.get();
       index_id_map2_->search(vector_with_ids.size(), vectors.get(), topk, distances.data(), labels.data(),
                              &flat_search_parameters);
-    } else {
+    } else if (gpu_replica_ == nullptr || !gpu_replica_->Search(vector_with_ids.size(), vectors.get(), topk,
+                                                                 distances.data(), labels.data(), 0)) {
       index_id_map2_->search(vector_with_ids.size(), vectors.get(), topk, distances.data(), labels.data());
     }
+
+    // Flat compare with all vectors, filtered vectors are skipped before computing, so it is the upper bound.
+    AddSearchStats(static_cast<int64_t>(vector_with_ids.size()) * index_id_map2_->ntotal, 0, 0);
   }
 
   VectorIndexUtils::FillSearchResult(vector_with_ids, topk, distances, labels, metric_type_, dimension_, results);
@@ -218,6 +245,9 @@ butil::Status VectorIndexFlat::RangeSearch(const std::vector<pb::common::VectorW
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
   }
+  if (binarize_) {
+    VectorIndexUtils::BinarizeVector(vectors.get(), vector_with_ids.size() * dimension_);
+  }
 
   std::unique_ptr<faiss::RangeSearchResult> range_search_result =
       std::make_unique<faiss::RangeSearchResult>(vector_with_ids.size());
@@ -230,6 +260,7 @@ butil::Status VectorIndexFlat::RangeSearch(const std::vector<pb::common::VectorW
   {
     BvarLatencyGuard bvar_guard(&g_flat_range_search_latency);
     RWLockReadGuard guard(&rw_lock_);
+    SearchThreadGuard thread_guard;
 
     try {
       std::unique_ptr<faiss::SearchParameters> params;
@@ -296,7 +327,7 @@ butil::Status VectorIndexFlat::Load(const std::string& path) {
   // The outside has been locked. Remove the locking operation here.
   faiss::Index* internal_raw_index = nullptr;
   try {
-    internal_raw_index = faiss::read_index(path.c_str(), 0);
+    internal_raw_index = MmapIndexReader::ReadIndex(path);
   } catch (std::exception& e) {
     std::string s = fmt::format("VectorIndexFlat::Load faiss::read_index failed. path : {} error : {}", path, e.what());
     DINGO_LOG(ERROR) << s;
@@ -336,6 +367,8 @@ butil::Status VectorIndexFlat::Load(const std::string& path) {
   switch (metric_type_) {
     case pb::common::METRIC_TYPE_NONE:
       [[fallthrough]];
+    case pb::common::METRIC_TYPE_HAMMING:
+      [[fallthrough]];
     case pb::common::METRIC_TYPE_L2: {
       if (BAIDU_UNLIKELY(internal_index->metric_type != faiss::MetricType::METRIC_L2)) {
         std::string s =
@@ -372,6 +405,9 @@ butil::Status VectorIndexFlat::Load(const std::string& path) {
 
   raw_index_.reset();
   index_id_map2_ = std::move(internal_index_id_map2);
+  if (gpu_replica_ != nullptr) {
+    gpu_replica_->MarkStale();
+  }
 
   if (pb::common::MetricType::METRIC_TYPE_COSINE == metric_type_) {
     normalize_ = true;
@@ -446,6 +482,17 @@ bool VectorIndexFlat::NeedToSave(int64_t last_save_log_behind) {
   return false;
 }
 
+bool VectorIndexFlat::NeedToRepair() { return gpu_replica_ != nullptr && gpu_replica_->NeedToSync(); }
+
+butil::Status VectorIndexFlat::Repair() {
+  if (gpu_replica_ == nullptr) {
+    return butil::Status::OK();
+  }
+
+  RWLockReadGuard guard(&rw_lock_);
+  return gpu_replica_->Sync(index_id_map2_.get());
+}
+
 void VectorIndexFlat::DoRangeSearch(faiss::idx_t n, const faiss::Index::component_t* x, faiss::Index::distance_t radius,
                                     faiss::RangeSearchResult* result,
                                     std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters) {
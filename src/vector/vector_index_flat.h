@@ -29,6 +29,7 @@
 #include "faiss/utils/distances.h"
 #include "proto/common.pb.h"
 #include "vector/vector_index.h"
+#include "vector/vector_index_gpu.h"
 
 namespace dingodb {
 
@@ -111,6 +112,10 @@ class VectorIndexFlat : public VectorIndex {
 
   bool NeedToSave(int64_t last_save_log_behind) override;
 
+  // sync the stale gpu replica
+  bool NeedToRepair() override;
+  butil::Status Repair() override;
+
  private:
   [[deprecated("faiss fix bug. never use.")]] void SearchWithParam(faiss::idx_t n, const faiss::Index::component_t* x,
                                                                    faiss::idx_t k, faiss::Index::distance_t* distances,
@@ -124,7 +129,7 @@ class VectorIndexFlat : public VectorIndex {
   // Dimension of the elements
   faiss::idx_t dimension_;
 
-  // only support L2 and IP
+  // support L2, IP, COSINE and HAMMING
   pb::common::MetricType metric_type_;
 
   std::unique_ptr<faiss::Index> raw_index_;
@@ -135,6 +140,12 @@ class VectorIndexFlat : public VectorIndex {
 
   // normalize vector
   bool normalize_;
+
+  // map values to bits for hamming distance
+  bool binarize_;
+
+  // only set when use_gpu
+  std::unique_ptr<GpuIndexReplica> gpu_replica_;
 };
 
 }  // namespace dingodb
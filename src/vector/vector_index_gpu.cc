@@ -0,0 +1,255 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_index_gpu.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
+#include "common/logging.h"
+#include "common/synchronization.h"
+#include "faiss/Index.h"
+#include "faiss/IndexIVF.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+#ifdef ENABLE_GPU
+#include "faiss/gpu/GpuCloner.h"
+#include "faiss/gpu/GpuClonerOptions.h"
+#include "faiss/gpu/StandardGpuResources.h"
+#include "faiss/gpu/utils/DeviceUtils.h"
+#endif
+
+namespace dingodb {
+
+DEFINE_bool(enable_vector_index_gpu, true, "search on gpu replica of vector index which set use_gpu");
+DEFINE_int64(vector_index_gpu_memory_budget_mb, 8192, "max memory of vector index replicas on each gpu device");
+
+bvar::LatencyRecorder g_gpu_index_sync_latency("dingo_vector_index_gpu_sync_latency");
+bvar::LatencyRecorder g_gpu_index_search_latency("dingo_vector_index_gpu_search_latency");
+bvar::Adder<int64_t> g_gpu_index_memory_bytes("dingo_vector_index_gpu_memory_bytes");
+
+#ifdef ENABLE_GPU
+
+// Memory of the replica on device, vectors/codes and ids, plus centroids for ivf.
+static int64_t EstimateGpuMemory(const faiss::Index* index) {
+  const auto* ivf_index = dynamic_cast<const faiss::IndexIVF*>(index);
+  if (ivf_index != nullptr) {
+    return ivf_index->ntotal * (ivf_index->code_size + sizeof(faiss::idx_t)) +
+           ivf_index->nlist * ivf_index->d * sizeof(float);
+  }
+
+  return index->ntotal * (index->d * sizeof(float) + sizeof(faiss::idx_t));
+}
+
+// Resources of all gpu devices, shared by all replicas.
+class GpuDeviceManager {
+ public:
+  struct Device {
+    faiss::gpu::StandardGpuResources resources;
+    // StandardGpuResources is not thread safe, the kernels of a device are serialized.
+    bthread::Mutex mutex;
+    int64_t used_bytes{0};
+  };
+
+  static GpuDeviceManager& GetInstance() {
+    static GpuDeviceManager instance;
+    return instance;
+  }
+
+  int32_t DeviceCount() const { return devices_.size(); }
+
+  Device* GetDevice(int32_t device) { return devices_[device].get(); }
+
+  // Reserve memory on the device with most free budget, return -1 if no device can hold it.
+  int32_t Reserve(int64_t memory_bytes) {
+    BAIDU_SCOPED_LOCK(mutex_);
+    int64_t budget_bytes = FLAGS_vector_index_gpu_memory_budget_mb * 1024 * 1024;
+    int32_t best_device = -1;
+    int64_t best_free_bytes = 0;
+    for (int32_t i = 0; i < DeviceCount(); ++i) {
+      int64_t free_bytes = budget_bytes - devices_[i]->used_bytes;
+      if (free_bytes >= memory_bytes && free_bytes > best_free_bytes) {
+        best_device = i;
+        best_free_bytes = free_bytes;
+      }
+    }
+
+    if (best_device >= 0) {
+      devices_[best_device]->used_bytes += memory_bytes;
+    }
+    return best_device;
+  }
+
+  void Release(int32_t device, int64_t memory_bytes) {
+    BAIDU_SCOPED_LOCK(mutex_);
+    devices_[device]->used_bytes -= memory_bytes;
+  }
+
+ private:
+  GpuDeviceManager() {
+    try {
+      int32_t device_count = faiss::gpu::getNumDevices();
+      for (int32_t i = 0; i < device_count; ++i) {
+        devices_.push_back(std::make_unique<Device>());
+      }
+      DINGO_LOG(INFO) << fmt::format("[vector_index.gpu] found {} gpu devices", device_count);
+    } catch (std::exception& e) {
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.gpu] get gpu devices failed, error: {}", e.what());
+      devices_.clear();
+    }
+  }
+
+  // protect used_bytes of devices
+  bthread::Mutex mutex_;
+  std::vector<std::unique_ptr<Device>> devices_;
+};
+
+#endif
+
+GpuIndexReplica::GpuIndexReplica(int64_t id) : id_(id) {}
+
+GpuIndexReplica::~GpuIndexReplica() { Clear(); }
+
+bool GpuIndexReplica::IsAvailable() {
+#ifdef ENABLE_GPU
+  return FLAGS_enable_vector_index_gpu && GpuDeviceManager::GetInstance().DeviceCount() > 0;
+#else
+  return false;
+#endif
+}
+
+void GpuIndexReplica::Clear() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (gpu_index_ == nullptr) {
+    return;
+  }
+
+#ifdef ENABLE_GPU
+  auto* device = GpuDeviceManager::GetInstance().GetDevice(device_);
+  {
+    BAIDU_SCOPED_LOCK(device->mutex);
+    gpu_index_.reset();
+  }
+  GpuDeviceManager::GetInstance().Release(device_, memory_bytes_);
+#endif
+
+  g_gpu_index_memory_bytes << -memory_bytes_;
+  device_ = -1;
+  memory_bytes_ = 0;
+}
+
+butil::Status GpuIndexReplica::Sync(const faiss::Index* cpu_index) {
+  // a failed sync is not retried until next write, the search go to cpu.
+  stale_.store(false, std::memory_order_release);
+  Clear();
+
+  if (!IsAvailable()) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "not support gpu");
+  }
+
+  if (cpu_index == nullptr || !cpu_index->is_trained || cpu_index->ntotal == 0) {
+    return butil::Status::OK();
+  }
+
+#ifdef ENABLE_GPU
+  BvarLatencyGuard bvar_guard(&g_gpu_index_sync_latency);
+
+  int64_t memory_bytes = EstimateGpuMemory(cpu_index);
+  int32_t device_id = GpuDeviceManager::GetInstance().Reserve(memory_bytes);
+  if (device_id < 0) {
+    std::string s = fmt::format("[vector_index.gpu][id({})] exceed gpu memory budget, memory_bytes: {}", id_,
+                                memory_bytes);
+    DINGO_LOG(WARNING) << s;
+    return butil::Status(pb::error::EINTERNAL, s);
+  }
+
+  auto* device = GpuDeviceManager::GetInstance().GetDevice(device_id);
+  std::unique_ptr<faiss::Index> gpu_index;
+  try {
+    faiss::gpu::GpuClonerOptions options;
+    BAIDU_SCOPED_LOCK(device->mutex);
+    gpu_index.reset(faiss::gpu::index_cpu_to_gpu(&device->resources, device_id, cpu_index, &options));
+  } catch (std::exception& e) {
+    GpuDeviceManager::GetInstance().Release(device_id, memory_bytes);
+    std::string s = fmt::format("[vector_index.gpu][id({})] clone index to gpu failed, error: {}", id_, e.what());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::EINTERNAL, s);
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  gpu_index_ = std::move(gpu_index);
+  device_ = device_id;
+  memory_bytes_ = memory_bytes;
+  is_ivf_ = dynamic_cast<const faiss::IndexIVF*>(cpu_index) != nullptr;
+  g_gpu_index_memory_bytes << memory_bytes;
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.gpu][id({})] sync to gpu {}, ntotal: {} memory_bytes: {}", id_,
+                                 device_id, cpu_index->ntotal, memory_bytes);
+#endif
+
+  return butil::Status::OK();
+}
+
+bool GpuIndexReplica::Search([[maybe_unused]] faiss::idx_t n, [[maybe_unused]] const float* x,
+                             [[maybe_unused]] faiss::idx_t k, [[maybe_unused]] float* distances,
+                             [[maybe_unused]] faiss::idx_t* labels, [[maybe_unused]] int32_t nprobe) {
+  if (!FLAGS_enable_vector_index_gpu || stale_.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+#ifdef ENABLE_GPU
+  // gpu k-selection has a max k, larger topk go to cpu.
+  if (k > faiss::gpu::getMaxKSelection()) {
+    return false;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (gpu_index_ == nullptr) {
+    return false;
+  }
+
+  BvarLatencyGuard bvar_guard(&g_gpu_index_search_latency);
+  auto* device = GpuDeviceManager::GetInstance().GetDevice(device_);
+  try {
+    BAIDU_SCOPED_LOCK(device->mutex);
+    if (is_ivf_) {
+      faiss::IVFSearchParameters ivf_search_parameters;
+      ivf_search_parameters.nprobe = std::min(nprobe, faiss::gpu::getMaxKSelection());
+      ivf_search_parameters.max_codes = 0;
+      gpu_index_->search(n, x, k, distances, labels, &ivf_search_parameters);
+    } else {
+      gpu_index_->search(n, x, k, distances, labels);
+    }
+  } catch (std::exception& e) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.gpu][id({})] search on gpu failed, error: {}", id_, e.what());
+    return false;
+  }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+}  // namespace dingodb
@@ -0,0 +1,75 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_INDEX_GPU_H_  // NOLINT
+#define DINGODB_VECTOR_INDEX_GPU_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "faiss/Index.h"
+
+namespace dingodb {
+
+// Read only replica of a faiss cpu index(flat/ivf flat/ivf pq) on gpu, for the compute bound unfiltered search.
+// The cpu index is still the primary, it serves filtered search, range search and save/load.
+// Any write makes the replica stale, stale replica is not used, and is cloned again by repair task of scrub.
+// Without ENABLE_GPU or gpu device, the replica is never usable and all search go to cpu.
+class GpuIndexReplica {
+ public:
+  explicit GpuIndexReplica(int64_t id);
+  ~GpuIndexReplica();
+
+  GpuIndexReplica(const GpuIndexReplica& rhs) = delete;
+  GpuIndexReplica& operator=(const GpuIndexReplica& rhs) = delete;
+  GpuIndexReplica(GpuIndexReplica&& rhs) = delete;
+  GpuIndexReplica& operator=(GpuIndexReplica&& rhs) = delete;
+
+  // Built with gpu and has at least one device.
+  static bool IsAvailable();
+
+  // The cpu index is changed.
+  void MarkStale() { stale_.store(true, std::memory_order_release); }
+
+  bool NeedToSync() const { return IsAvailable() && stale_.load(std::memory_order_acquire); }
+
+  // Clone cpu index to the gpu device with most free memory budget, the caller must block write of cpu index.
+  butil::Status Sync(const faiss::Index* cpu_index);
+
+  // Return false if replica is not usable, then the caller search on cpu.
+  // nprobe is ignored by flat index.
+  bool Search(faiss::idx_t n, const float* x, faiss::idx_t k, float* distances, faiss::idx_t* labels,
+              int32_t nprobe);
+
+ private:
+  void Clear();
+
+  int64_t id_;
+
+  std::atomic<bool> stale_{true};
+
+  // protect gpu index
+  bthread::Mutex mutex_;
+  std::unique_ptr<faiss::Index> gpu_index_;
+  int32_t device_{-1};
+  int64_t memory_bytes_{0};
+  bool is_ivf_{false};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_INDEX_GPU_H_  // NOLINT
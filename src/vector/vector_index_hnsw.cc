@@ -18,9 +18,15 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <queue>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "butil/status.h"
@@ -28,13 +34,17 @@
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/numa.h"
 #include "common/synchronization.h"
 #include "common/threadpool.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
+#include "vector/codec.h"
 #include "vector/vector_index.h"
+#include "vector/vector_index_hnsw_space.h"
+#include "vector/vector_index_mmap_reader.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
@@ -44,6 +54,9 @@ DEFINE_int32(max_hnsw_nlinks_of_region, 4096, "max nlinks of region in HSNW");
 
 DEFINE_int64(hnsw_need_save_count, 10000, "hnsw need save count");
 DEFINE_uint32(hnsw_max_init_max_elements, 100000, "hnsw max init max elements");
+DEFINE_double(hnsw_resize_ahead_ratio, 0.75, "hnsw resize ahead when element count exceed max elements * ratio");
+DEFINE_double(hnsw_resize_growth_factor, 2.0, "hnsw max elements growth factor when resize");
+DEFINE_double(hnsw_repair_deleted_ratio, 0.1, "hnsw repair neighbors of deleted elements when deleted ratio exceed");
 
 DECLARE_int64(vector_max_batch_count);
 
@@ -55,6 +68,9 @@ bvar::LatencyRecorder g_hnsw_search_latency("dingo_hnsw_search_latency");
 bvar::LatencyRecorder g_hnsw_range_search_latency("dingo_hnsw_range_search_latency");
 bvar::LatencyRecorder g_hnsw_delete_latency("dingo_hnsw_delete_latency");
 bvar::LatencyRecorder g_hnsw_load_latency("dingo_hnsw_load_latency");
+bvar::LatencyRecorder g_hnsw_resize_latency("dingo_hnsw_resize_latency");
+bvar::LatencyRecorder g_hnsw_repair_latency("dingo_hnsw_repair_latency");
+bvar::LatencyRecorder g_hnsw_optimize_layout_latency("dingo_hnsw_optimize_layout_latency");
 
 // Filter vecotr id used by region range.
 class HnswRangeFilterFunctor : public hnswlib::BaseFilterFunctor {
@@ -143,7 +159,16 @@ VectorIndexHnsw::VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParame
 
     normalize_ = false;
 
-    if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT) {
+    // hamming distance is computed on bits, so the vectors are always stored as bits.
+    auto quantizer_type = hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_HAMMING
+                              ? pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_BINARY
+                              : hnsw_parameter.quantizer_type();
+    if (quantizer_type != pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_NONE) {
+      normalize_ = (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_COSINE);
+      bool is_ip = (hnsw_parameter.metric_type() != pb::common::MetricType::METRIC_TYPE_L2);
+      quantized_space_ = HnswQuantizedSpace::New(quantizer_type, hnsw_parameter.dimension(), is_ip);
+      hnsw_space_ = quantized_space_;
+    } else if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT) {
       hnsw_space_ = new hnswlib::InnerProductSpace(hnsw_parameter.dimension());
     } else if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_COSINE) {
       normalize_ = true;
@@ -159,14 +184,18 @@ VectorIndexHnsw::VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParame
     DINGO_LOG(INFO) << fmt::format(
         "[vector_index.hnsw][id({})] create index, init_max_elements={} max_element_limit={} nlinks={} "
         "efconstruction={} "
-        "metric_type={} dimension={}",
+        "metric_type={} dimension={} quantizer_type={}",
         Id(), FLAGS_hnsw_max_init_max_elements, max_element_limit_, hnsw_parameter.nlinks(),
         hnsw_parameter.efconstruction(), pb::common::MetricType_Name(hnsw_parameter.metric_type()),
-        hnsw_parameter.dimension());
+        hnsw_parameter.dimension(), pb::common::HnswQuantizerType_Name(hnsw_parameter.quantizer_type()));
 
+    // allow replace deleted, new vector reuse the slot of deleted vector.
     hnsw_index_ =
         new hnswlib::HierarchicalNSW<float>(hnsw_space_, FLAGS_hnsw_max_init_max_elements, hnsw_parameter.nlinks(),
-                                            hnsw_parameter.efconstruction(), 100, false);
+                                            hnsw_parameter.efconstruction(), 100, true);
+    BindNumaNode();
+
+    deleted_ratio_metrics_.expose(fmt::format("dingo_hnsw_deleted_ratio_{}", Id()));
   }
 }
 
@@ -193,44 +222,60 @@ butil::Status VectorIndexHnsw::Upsert(const std::vector<pb::common::VectorWithId
     return butil::Status::OK();
   }
 
-  // check
-  uint32_t input_dimension = vector_with_ids[0].vector().float_values_size();
-  if (input_dimension != static_cast<size_t>(dimension_)) {
-    std::string s = fmt::format("dimension is invalid, expect({}) input({})", dimension_, input_dimension);
-    DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
-    return butil::Status(pb::error::Errno::EVECTOR_INVALID, s);
+  // check, integer vectors are widened to float when adding.
+  for (const auto& vector_with_id : vector_with_ids) {
+    if (!VectorCodec::CheckVectorDimension(vector_with_id.vector(), dimension_)) {
+      std::string s = fmt::format("dimension is invalid, expect({}) input float({}) binary({})", dimension_,
+                                  vector_with_id.vector().float_values_size(),
+                                  vector_with_id.vector().binary_values_size());
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+      return butil::Status(pb::error::Errno::EVECTOR_INVALID, s);
+    }
   }
 
   BvarLatencyGuard bvar_guard(&g_hnsw_upsert_latency);
-  RWLockWriteGuard guard(&rw_lock_);
+
+  // grow capacity before insert, the write lock is only held by resize.
+  auto status = ReserveCapacity(vector_with_ids.size());
+  if (!status.ok()) {
+    return status;
+  }
+  DEFER(inflight_upsert_count_.fetch_sub(vector_with_ids.size(), std::memory_order_relaxed));
+
+  // hnswlib support concurrent addPoint/markDelete/searchKnn by its label and link list lock stripes,
+  // so upsert share the read lock with search.
+  RWLockReadGuard guard(&rw_lock_);
 
   // Add data to index
   try {
-    // check if we need to expand the max_elements
-    auto batch_count = std::max(FLAGS_vector_max_batch_count, static_cast<int64_t>(vector_with_ids.size()));
-    if (hnsw_index_->cur_element_count + batch_count * 2 > hnsw_index_->max_elements_) {
-      auto new_max_elements = hnsw_index_->max_elements_ * 2;
-      DINGO_LOG(INFO) << fmt::format("[vector_index.hnsw][id({})] expand max element, {} -> {}.", Id(),
-                                     hnsw_index_->max_elements_, new_max_elements);
-
-      hnsw_index_->resizeIndex(new_max_elements);
-    }
+    if (quantized_space_ != nullptr) {
+      ParallelFor(thread_pool, 0, vector_with_ids.size(), FLAGS_vector_write_batch_size_per_task, is_priority,
+                  [&](size_t row) {
+                    std::vector<float> buffer;
+                    std::vector<uint8_t> code(quantized_space_->CodeSize());
+                    EncodeVector(VectorIndexUtils::GetFloatValues(vector_with_ids[row].vector(), dimension_, buffer),
+                                 code.data());
 
-    if (!normalize_) {
+                    AddPoint(code.data(), vector_with_ids[row].id());
+                  });
+    } else if (!normalize_) {
       ParallelFor(thread_pool, 0, vector_with_ids.size(), FLAGS_vector_write_batch_size_per_task, is_priority,
                   [&](size_t row) {
-                    this->hnsw_index_->addPoint((void*)vector_with_ids[row].vector().float_values().data(),
-                                                vector_with_ids[row].id(), false);
+                    std::vector<float> buffer;
+                    AddPoint(VectorIndexUtils::GetFloatValues(vector_with_ids[row].vector(), dimension_, buffer),
+                             vector_with_ids[row].id());
                   });
     } else {
       ParallelFor(thread_pool, 0, vector_with_ids.size(), FLAGS_vector_write_batch_size_per_task, is_priority,
                   [&](size_t row) {
                     // normalize vector
+                    std::vector<float> buffer;
                     std::vector<float> norm_array(dimension_);
                     VectorIndexUtils::NormalizeVectorForHnsw(
-                        (float*)vector_with_ids[row].vector().float_values().data(), dimension_, norm_array.data());
+                        VectorIndexUtils::GetFloatValues(vector_with_ids[row].vector(), dimension_, buffer),
+                        dimension_, norm_array.data());
 
-                    this->hnsw_index_->addPoint((void*)norm_array.data(), vector_with_ids[row].id(), false);
+                    AddPoint(norm_array.data(), vector_with_ids[row].id());
                   });
     }
     return butil::Status();
@@ -244,6 +289,34 @@ butil::Status VectorIndexHnsw::Upsert(const std::vector<pb::common::VectorWithId
   }
 }
 
+void VectorIndexHnsw::AddPoint(const void* data, int64_t label) {
+  BAIDU_SCOPED_LOCK(label_mutexes_[static_cast<uint64_t>(label) % label_mutexes_.size()]);
+
+  bool is_exist = false;
+  bool is_deleted = false;
+  {
+    std::unique_lock<std::mutex> lock(hnsw_index_->label_lookup_lock);
+    auto it = hnsw_index_->label_lookup_.find(label);
+    if (it != hnsw_index_->label_lookup_.end()) {
+      is_exist = true;
+      is_deleted = hnsw_index_->isMarkedDeleted(it->second);
+    }
+  }
+
+  if (is_deleted) {
+    // addPoint refuse to update deleted element when allow replace deleted.
+    try {
+      hnsw_index_->unmarkDelete(label);
+    } catch (std::runtime_error& e) {
+      // the slot is reused by other label in the meantime, add as new label.
+      is_exist = false;
+    }
+  }
+
+  // replace deleted only for new label, otherwise the label would be duplicated.
+  hnsw_index_->addPoint(data, label, !is_exist);
+}
+
 butil::Status VectorIndexHnsw::Delete(const std::vector<int64_t>& delete_ids) { return Delete(delete_ids, true); }
 
 butil::Status VectorIndexHnsw::Delete(const std::vector<int64_t>& delete_ids, bool is_priority) {
@@ -254,7 +327,7 @@ butil::Status VectorIndexHnsw::Delete(const std::vector<int64_t>& delete_ids, bo
   butil::Status ret;
 
   BvarLatencyGuard bvar_guard(&g_hnsw_delete_latency);
-  RWLockWriteGuard guard(&rw_lock_);
+  RWLockReadGuard guard(&rw_lock_);
 
   // Add data to index
   try {
@@ -290,7 +363,10 @@ butil::Status VectorIndexHnsw::Load(const std::string& path) {
     auto* old_hnsw_index = hnsw_index_;
     uint32_t actual_max_elements =
         vector_index_parameter.hnsw_parameter().max_elements() + Constant::kHnswMaxElementsExpandNum;
+    // hnswlib read the file by ifstream twice, check and load, read ahead keep both from page cache.
+    MmapIndexReader::Prefetch(path);
     hnsw_index_ = new hnswlib::HierarchicalNSW<float>(hnsw_space_, path, false, actual_max_elements, true);
+    BindNumaNode();
     delete old_hnsw_index;
     return butil::Status::OK();
   } else {
@@ -318,7 +394,7 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
     return butil::Status::OK();
   }
 
-  if (vector_with_ids[0].vector().float_values_size() != this->dimension_) {
+  if (!VectorCodec::CheckVectorDimension(vector_with_ids[0].vector(), this->dimension_)) {
     return butil::Status(pb::error::Errno::EINTERNAL, "vector dimension is not match, input=%d, index=%d",
                          vector_with_ids[0].vector().float_values_size(), this->dimension_);
   }
@@ -331,24 +407,44 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
 
   butil::Status ret;
 
+  // float vectors are searched in the protobuf storage, only integer vectors are widened into the buffer.
+  size_t integer_vector_count = 0;
+  for (const auto& vector_with_id : vector_with_ids) {
+    if (vector_with_id.vector().value_type() != pb::common::ValueType::FLOAT) {
+      ++integer_vector_count;
+    }
+  }
+
   std::unique_ptr<float[]> data;
-  try {
-    data.reset(new float[this->dimension_ * vector_with_ids.size()]);
-  } catch (std::bad_alloc& e) {
-    std::string s = fmt::format("upsert vector failed, error: {}", e.what());
-    DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
-    ret = butil::Status(pb::error::Errno::EINTERNAL, s);
-    return ret;
+  if (integer_vector_count > 0) {
+    try {
+      data.reset(new float[this->dimension_ * integer_vector_count]);
+    } catch (std::bad_alloc& e) {
+      std::string s = fmt::format("upsert vector failed, error: {}", e.what());
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+      ret = butil::Status(pb::error::Errno::EINTERNAL, s);
+      return ret;
+    }
   }
 
+  std::vector<const float*> query_datas(vector_with_ids.size(), nullptr);
+  size_t integer_vector_offset = 0;
   for (size_t row = 0; row < vector_with_ids.size(); ++row) {
-    if (vector_with_ids[row].vector().float_values_size() != this->dimension_) {
+    const auto& vector = vector_with_ids[row].vector();
+    if (!VectorCodec::CheckVectorDimension(vector, this->dimension_)) {
       return butil::Status(pb::error::Errno::EVECTOR_INVALID, "vector dimension is not match, input=%d, index=%d",
-                           vector_with_ids[row].vector().float_values_size(), this->dimension_);
+                           vector.float_values_size(), this->dimension_);
     }
-    for (size_t col = 0; col < this->dimension_; ++col) {
-      data.get()[row * this->dimension_ + col] = vector_with_ids[row].vector().float_values().at(col);
+
+    if (vector.value_type() == pb::common::ValueType::FLOAT) {
+      query_datas[row] = vector.float_values().data();
+      continue;
     }
+
+    float* widened = data.get() + integer_vector_offset * this->dimension_;
+    VectorCodec::VectorToFloat(vector, this->dimension_, widened);
+    query_datas[row] = widened;
+    ++integer_vector_offset;
   }
 
   // Query the elements for themselves and measure recall
@@ -384,7 +480,15 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
 
       if (reconstruct) {
         try {
-          std::vector<float> data = hnsw_index_->getDataByLabel<float>(data_label[row * topk + i]);
+          std::vector<float> data;
+          if (quantized_space_ != nullptr) {
+            // the element count of getDataByLabel is the code size of quantized space.
+            std::vector<uint8_t> code = hnsw_index_->getDataByLabel<uint8_t>(data_label[row * topk + i]);
+            data.resize(dimension_);
+            quantized_space_->Decode(code.data(), data.data());
+          } else {
+            data = hnsw_index_->getDataByLabel<float>(data_label[row * topk + i]);
+          }
           for (auto& value : data) {
             vector_with_id->mutable_vector()->add_float_values(value);
           }
@@ -429,12 +533,37 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
     hnsw_index_->setEf(search_parameter.hnsw().efsearch());
   }
 
-  if (!normalize_) {
-    ParallelFor(thread_pool, 0, vector_with_ids.size(), FLAGS_vector_read_batch_size_per_task, true, [&](size_t row) {
+  // Split the batch to thread pool only when the search thread budget has free threads.
+  SearchThreadGuard thread_guard;
+  auto search_pool = thread_guard.IsParallel() ? thread_pool : nullptr;
+
+  if (quantized_space_ != nullptr) {
+    ParallelFor(search_pool, 0, vector_with_ids.size(), FLAGS_vector_read_batch_size_per_task, true, [&](size_t row) {
+      std::vector<uint8_t> code(quantized_space_->CodeSize());
+      EncodeVector(query_datas[row], code.data());
+
+      std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
+
+      try {
+        result = hnsw_index_->searchKnn(code.data(), topk, hnsw_filter.get());
+      } catch (std::runtime_error& e) {
+        std::string s = fmt::format("parallel search vector failed, error: {}", e.what());
+        LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+        statuses[row] = butil::Status(pb::error::Errno::EINTERNAL, s);
+        return;
+      }
+
+      statuses[row] = lambda_reverse_rse_result_function(result, row, topk);
+      if (statuses[row].ok()) {
+        statuses[row] = lambda_fill_results_function(row, topk, reconstruct && !normalize_);
+      }
+    });
+  } else if (!normalize_) {
+    ParallelFor(search_pool, 0, vector_with_ids.size(), FLAGS_vector_read_batch_size_per_task, true, [&](size_t row) {
       std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
 
       try {
-        result = hnsw_index_->searchKnn(data.get() + dimension_ * row, topk, hnsw_filter.get());
+        result = hnsw_index_->searchKnn(query_datas[row], topk, hnsw_filter.get());
       } catch (std::runtime_error& e) {
         std::string s = fmt::format("parallel search vector failed, error: {}", e.what());
         LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
@@ -448,10 +577,9 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
       }
     });
   } else {  // normalize_
-    ParallelFor(thread_pool, 0, vector_with_ids.size(), FLAGS_vector_read_batch_size_per_task, true, [&](size_t row) {
+    ParallelFor(search_pool, 0, vector_with_ids.size(), FLAGS_vector_read_batch_size_per_task, true, [&](size_t row) {
       std::vector<float> norm_array(dimension_);
-      VectorIndexUtils::NormalizeVectorForHnsw((float*)(data.get() + dimension_ * row), dimension_,  // NOLINT
-                                               norm_array.data());
+      VectorIndexUtils::NormalizeVectorForHnsw(query_datas[row], dimension_, norm_array.data());
 
       std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
 
@@ -494,14 +622,74 @@ butil::Status VectorIndexHnsw::RangeSearch(const std::vector<pb::common::VectorW
 
 void VectorIndexHnsw::LockWrite() { rw_lock_.LockWrite(); }
 
+butil::Status VectorIndexHnsw::ReserveCapacity(int64_t count) {
+  // the vectors of the concurrent upserts are counted in, they share the read lock.
+  int64_t inflight_count = inflight_upsert_count_.fetch_add(count, std::memory_order_relaxed) + count;
+
+  int64_t max_elements = 0;
+  int64_t need_elements = 0;
+  {
+    RWLockReadGuard guard(&rw_lock_);
+    max_elements = hnsw_index_->getMaxElements();
+    // deleted slots are reused by new vectors
+    need_elements = hnsw_index_->getCurrentElementCount() - hnsw_index_->getDeletedCount() + inflight_count +
+                    FLAGS_vector_max_batch_count;
+  }
+
+  // resize ahead of time, so insert never hit the limit in the middle of a batch.
+  if (need_elements <= static_cast<int64_t>(max_elements * FLAGS_hnsw_resize_ahead_ratio)) {
+    return butil::Status::OK();
+  }
+
+  BAIDU_SCOPED_LOCK(resize_mutex_);
+  BvarLatencyGuard bvar_guard(&g_hnsw_resize_latency);
+  RWLockWriteGuard guard(&rw_lock_);
+
+  // double check, other upsert may be resized.
+  max_elements = hnsw_index_->getMaxElements();
+  need_elements = hnsw_index_->getCurrentElementCount() - hnsw_index_->getDeletedCount() +
+                  inflight_upsert_count_.load(std::memory_order_relaxed) + FLAGS_vector_max_batch_count;
+  if (need_elements <= static_cast<int64_t>(max_elements * FLAGS_hnsw_resize_ahead_ratio)) {
+    return butil::Status::OK();
+  }
+
+  // geometric growth and keep the watermark, the count of resize is log(n).
+  int64_t new_max_elements = std::max(static_cast<int64_t>(max_elements * FLAGS_hnsw_resize_growth_factor),
+                                      static_cast<int64_t>(need_elements / FLAGS_hnsw_resize_ahead_ratio) + 1);
+  DINGO_LOG(INFO) << fmt::format("[vector_index.hnsw][id({})] expand max element, {} -> {}.", Id(), max_elements,
+                                 new_max_elements);
+  try {
+    hnsw_index_->resizeIndex(new_max_elements);
+    BindNumaNode();
+  } catch (std::exception& e) {
+    inflight_upsert_count_.fetch_sub(count, std::memory_order_relaxed);
+    std::string s = fmt::format("resize index failed, {} -> {} error: {}", max_elements, new_max_elements, e.what());
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+
+  return butil::Status::OK();
+}
+
 void VectorIndexHnsw::UnlockWrite() { rw_lock_.UnlockWrite(); }
 
+// Level 0 block holds the vectors and links of all elements, almost all memory reads of search.
+void VectorIndexHnsw::BindNumaNode() {
+  if (!Numa::IsEnabled()) {
+    return;
+  }
+
+  Numa::BindMemory(hnsw_index_->data_level0_memory_,
+                   hnsw_index_->max_elements_ * hnsw_index_->size_data_per_element_, Numa::NodeOfRegion(Id()));
+}
+
 butil::Status VectorIndexHnsw::ResizeMaxElements(int64_t new_max_elements) {
   RWLockWriteGuard guard(&rw_lock_);
 
   try {
     if (vector_index_type == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
       hnsw_index_->resizeIndex(new_max_elements);
+      BindNumaNode();
       return butil::Status::OK();
     } else {
       return butil::Status(pb::error::Errno::EINTERNAL, "vector index type is not supported");
@@ -538,6 +726,16 @@ bool VectorIndexHnsw::IsExceedsMaxElements() {
 
 hnswlib::HierarchicalNSW<float>* VectorIndexHnsw::GetHnswIndex() { return this->hnsw_index_; }
 
+void VectorIndexHnsw::EncodeVector(const float* vector, void* code) const {
+  if (normalize_) {
+    std::vector<float> norm_array(dimension_);
+    VectorIndexUtils::NormalizeVectorForHnsw(vector, dimension_, norm_array.data());
+    quantized_space_->Encode(norm_array.data(), code);
+  } else {
+    quantized_space_->Encode(vector, code);
+  }
+}
+
 int32_t VectorIndexHnsw::GetDimension() { return this->dimension_; }
 
 pb::common::MetricType VectorIndexHnsw::GetMetricType() {
@@ -563,6 +761,13 @@ butil::Status VectorIndexHnsw::GetMemorySize(int64_t& memory_size) {
   return butil::Status::OK();
 }
 
+// hnswlib counts the distance computations and hops of every search itself.
+void VectorIndexHnsw::GetSearchStats(pb::common::VectorSearchStats& stats) {
+  VectorIndex::GetSearchStats(stats);
+  stats.set_distance_computations(hnsw_index_->metric_distance_computations.load());
+  stats.set_visited_nodes(hnsw_index_->metric_hops.load());
+}
+
 bool VectorIndexHnsw::NeedToRebuild() {
   int64_t element_count = 0, deleted_count = 0;
 
@@ -577,6 +782,244 @@ bool VectorIndexHnsw::NeedToRebuild() {
   return (deleted_count > 0 && deleted_count > element_count / 2);
 }
 
+double VectorIndexHnsw::DeletedRatio() {
+  int64_t element_count = hnsw_index_->getCurrentElementCount();
+  if (element_count == 0) {
+    return 0.0;
+  }
+
+  return static_cast<double>(hnsw_index_->getDeletedCount()) / element_count;
+}
+
+bool VectorIndexHnsw::NeedToRepair() {
+  RWLockReadGuard guard(&rw_lock_);
+
+  double deleted_ratio = DeletedRatio();
+  deleted_ratio_metrics_.set_value(deleted_ratio);
+  if (deleted_ratio < FLAGS_hnsw_repair_deleted_ratio) {
+    return false;
+  }
+
+  return hnsw_index_->getDeletedCount() != last_repair_deleted_count_.load(std::memory_order_relaxed);
+}
+
+butil::Status VectorIndexHnsw::Repair() {
+  BAIDU_SCOPED_LOCK(repair_mutex_);
+  BvarLatencyGuard bvar_guard(&g_hnsw_repair_latency);
+  RWLockReadGuard guard(&rw_lock_);
+
+  int64_t deleted_count = hnsw_index_->getDeletedCount();
+  int64_t repair_count = RepairDeletedNeighbors();
+  last_repair_deleted_count_.store(deleted_count, std::memory_order_relaxed);
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.hnsw][id({})] repair deleted neighbors, deleted_count={} repair_count={}", Id(), deleted_count,
+      repair_count);
+
+  return butil::Status::OK();
+}
+
+// Deleted node still be traversed by search until its slot is reused, the neighbor list of each alive node
+// pointed to a deleted node is rebuilt from its alive neighbors and the alive neighbors of the deleted node,
+// pruned by the same heuristic of insert. Only level 0 is repaired, the upper levels are sparse.
+// The caller must hold read lock, hnswlib link list lock guard the concurrent insert.
+int64_t VectorIndexHnsw::RepairDeletedNeighbors() {
+  using CandidateQueue = std::priority_queue<std::pair<float, hnswlib::tableint>,
+                                             std::vector<std::pair<float, hnswlib::tableint>>,
+                                             hnswlib::HierarchicalNSW<float>::CompareByFirst>;
+
+  std::vector<hnswlib::tableint> deleted_ids;
+  {
+    std::unique_lock<std::mutex> lock(hnsw_index_->deleted_elements_lock);
+    deleted_ids.assign(hnsw_index_->deleted_elements.begin(), hnsw_index_->deleted_elements.end());
+  }
+
+  int64_t repair_count = 0;
+  for (auto deleted_id : deleted_ids) {
+    std::vector<hnswlib::tableint> deleted_neighbors;
+    {
+      std::unique_lock<std::mutex> lock(hnsw_index_->link_list_locks_[deleted_id]);
+      auto* link_list = hnsw_index_->get_linklist0(deleted_id);
+      auto* neighbors = reinterpret_cast<hnswlib::tableint*>(link_list + 1);
+      deleted_neighbors.assign(neighbors, neighbors + hnsw_index_->getListCount(link_list));
+    }
+
+    for (auto neighbor_id : deleted_neighbors) {
+      if (hnsw_index_->isMarkedDeleted(neighbor_id)) {
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(hnsw_index_->link_list_locks_[neighbor_id]);
+      // the slot is reused by a new vector, it is connected by insert.
+      if (!hnsw_index_->isMarkedDeleted(deleted_id)) {
+        break;
+      }
+
+      auto* link_list = hnsw_index_->get_linklist0(neighbor_id);
+      auto* neighbors = reinterpret_cast<hnswlib::tableint*>(link_list + 1);
+      size_t size = hnsw_index_->getListCount(link_list);
+      if (std::find(neighbors, neighbors + size, deleted_id) == neighbors + size) {
+        continue;
+      }
+
+      const char* data = hnsw_index_->getDataByInternalId(neighbor_id);
+      CandidateQueue candidates;
+      std::unordered_set<hnswlib::tableint> visited = {neighbor_id};
+      auto add_candidate = [&](hnswlib::tableint candidate_id) {
+        if (hnsw_index_->isMarkedDeleted(candidate_id) || !visited.insert(candidate_id).second) {
+          return;
+        }
+        float distance = hnsw_index_->fstdistfunc_(data, hnsw_index_->getDataByInternalId(candidate_id),
+                                                   hnsw_index_->dist_func_param_);
+        candidates.emplace(distance, candidate_id);
+      };
+
+      for (size_t i = 0; i < size; ++i) {
+        add_candidate(neighbors[i]);
+      }
+      for (auto candidate_id : deleted_neighbors) {
+        add_candidate(candidate_id);
+      }
+
+      hnsw_index_->getNeighborsByHeuristic2(candidates, hnsw_index_->maxM0_);
+
+      size = 0;
+      while (!candidates.empty()) {
+        neighbors[size++] = candidates.top().second;
+        candidates.pop();
+      }
+      hnsw_index_->setListCount(link_list, static_cast<uint16_t>(size));
+      ++repair_count;
+    }
+  }
+
+  return repair_count;
+}
+
+// Move element inverse_ids[i] to i in place by following cycles, only one element is buffered.
+template <typename SaveFunc, typename MoveFunc, typename RestoreFunc>
+static void PermuteInPlace(const std::vector<hnswlib::tableint>& inverse_ids, SaveFunc save, MoveFunc move,
+                           RestoreFunc restore) {
+  std::vector<bool> done(inverse_ids.size(), false);
+  for (hnswlib::tableint start = 0; start < inverse_ids.size(); ++start) {
+    if (done[start] || inverse_ids[start] == start) {
+      continue;
+    }
+
+    save(start);
+    hnswlib::tableint pos = start;
+    for (;;) {
+      done[pos] = true;
+      hnswlib::tableint from = inverse_ids[pos];
+      if (from == start) {
+        restore(pos);
+        break;
+      }
+      move(pos, from);
+      pos = from;
+    }
+  }
+}
+
+butil::Status VectorIndexHnsw::OptimizeLayout() {
+  BvarLatencyGuard bvar_guard(&g_hnsw_optimize_layout_latency);
+  RWLockWriteGuard guard(&rw_lock_);
+
+  size_t count = hnsw_index_->getCurrentElementCount();
+  if (count < 2) {
+    return butil::Status::OK();
+  }
+
+  int64_t start_time = Helper::TimestampMs();
+
+  // Bfs from enter point, the unreachable elements are placed at the end.
+  constexpr hnswlib::tableint kNotVisited = std::numeric_limits<hnswlib::tableint>::max();
+  std::vector<hnswlib::tableint> new_ids(count, kNotVisited);
+  std::vector<hnswlib::tableint> inverse_ids;
+  inverse_ids.reserve(count);
+  auto bfs = [&](hnswlib::tableint root) {
+    new_ids[root] = inverse_ids.size();
+    inverse_ids.push_back(root);
+    for (size_t head = inverse_ids.size() - 1; head < inverse_ids.size(); ++head) {
+      auto* link_list = hnsw_index_->get_linklist0(inverse_ids[head]);
+      auto* neighbors = reinterpret_cast<hnswlib::tableint*>(link_list + 1);
+      size_t size = hnsw_index_->getListCount(link_list);
+      for (size_t i = 0; i < size; ++i) {
+        if (new_ids[neighbors[i]] == kNotVisited) {
+          new_ids[neighbors[i]] = inverse_ids.size();
+          inverse_ids.push_back(neighbors[i]);
+        }
+      }
+    }
+  };
+  bfs(hnsw_index_->enterpoint_node_);
+  for (hnswlib::tableint id = 0; id < count; ++id) {
+    if (new_ids[id] == kNotVisited) {
+      bfs(id);
+    }
+  }
+
+  // Renumber neighbors of all levels.
+  auto renumber = [&](hnswlib::linklistsizeint* link_list) {
+    auto* neighbors = reinterpret_cast<hnswlib::tableint*>(link_list + 1);
+    size_t size = hnsw_index_->getListCount(link_list);
+    for (size_t i = 0; i < size; ++i) {
+      neighbors[i] = new_ids[neighbors[i]];
+    }
+  };
+  for (hnswlib::tableint id = 0; id < count; ++id) {
+    renumber(hnsw_index_->get_linklist0(id));
+    for (int level = 1; level <= hnsw_index_->element_levels_[id]; ++level) {
+      renumber(hnsw_index_->get_linklist(id, level));
+    }
+  }
+
+  // Move level 0 block(links, data and label), upper level links and level of elements.
+  size_t block_size = hnsw_index_->size_data_per_element_;
+  char* level0_memory = hnsw_index_->data_level0_memory_;
+  std::vector<char> block(block_size);
+  char* link_lists = nullptr;
+  int element_level = 0;
+  PermuteInPlace(
+      inverse_ids,
+      [&](hnswlib::tableint pos) {
+        memcpy(block.data(), level0_memory + pos * block_size, block_size);
+        link_lists = hnsw_index_->linkLists_[pos];
+        element_level = hnsw_index_->element_levels_[pos];
+      },
+      [&](hnswlib::tableint pos, hnswlib::tableint from) {
+        memcpy(level0_memory + pos * block_size, level0_memory + from * block_size, block_size);
+        hnsw_index_->linkLists_[pos] = hnsw_index_->linkLists_[from];
+        hnsw_index_->element_levels_[pos] = hnsw_index_->element_levels_[from];
+      },
+      [&](hnswlib::tableint pos) {
+        memcpy(level0_memory + pos * block_size, block.data(), block_size);
+        hnsw_index_->linkLists_[pos] = link_lists;
+        hnsw_index_->element_levels_[pos] = element_level;
+      });
+
+  {
+    std::unique_lock<std::mutex> lock(hnsw_index_->label_lookup_lock);
+    for (auto& [label, id] : hnsw_index_->label_lookup_) {
+      id = new_ids[id];
+    }
+  }
+  {
+    std::unique_lock<std::mutex> lock(hnsw_index_->deleted_elements_lock);
+    std::unordered_set<hnswlib::tableint> deleted_elements;
+    for (auto id : hnsw_index_->deleted_elements) {
+      deleted_elements.insert(new_ids[id]);
+    }
+    hnsw_index_->deleted_elements.swap(deleted_elements);
+  }
+  hnsw_index_->enterpoint_node_ = new_ids[hnsw_index_->enterpoint_node_];
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.hnsw][id({})] optimize layout, count={} elapsed time({}ms)", Id(),
+                                 count, Helper::TimestampMs() - start_time);
+
+  return butil::Status::OK();
+}
+
 bool VectorIndexHnsw::NeedToSave(int64_t last_save_log_behind) {
   RWLockReadGuard guard(&rw_lock_);
 
@@ -597,12 +1040,14 @@ bool VectorIndexHnsw::NeedToSave(int64_t last_save_log_behind) {
 }
 
 // calc hnsw count from memory
-uint32_t VectorIndexHnsw::CalcHnswCountFromMemory(int64_t memory_size_limit, int64_t dimension, int64_t nlinks) {
+uint32_t VectorIndexHnsw::CalcHnswCountFromMemory(int64_t memory_size_limit, int64_t dimension, int64_t nlinks,
+                                                  pb::common::HnswQuantizerType quantizer_type) {
   // size_links_level0_ = maxM0_ * sizeof(tableint) + sizeof(linklistsizeint);
   int64_t size_links_level0 = nlinks * 2 + sizeof(int64_t) + sizeof(int64_t);
 
   // int64_t size_data_per_element_ = size_links_level0_ + data_size_ + sizeof(labeltype);
-  int64_t size_data_per_element = size_links_level0 + sizeof(float_t) * dimension + sizeof(int64_t);
+  int64_t size_data_per_element =
+      size_links_level0 + HnswQuantizedSpace::CodeSize(quantizer_type, dimension) + sizeof(int64_t);
 
   // int64_t size_link_list_per_element =  sizeof(void*);
   int64_t size_link_list_per_element = sizeof(int64_t);
@@ -623,6 +1068,11 @@ butil::Status VectorIndexHnsw::CheckAndSetHnswParameter(pb::common::CreateHnswPa
     return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "hnsw dimension is too small");
   }
 
+  // hamming distance is computed on bits, the memory of vector is dimension / 8 bytes.
+  if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_HAMMING) {
+    hnsw_parameter.set_quantizer_type(pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_BINARY);
+  }
+
   if (hnsw_parameter.nlinks() > FLAGS_max_hnsw_nlinks_of_region) {
     DINGO_LOG(WARNING) << fmt::format("[vector_index.hnsw] nlinks is too big, nlinks({}) max_nlinks({}).",
                                       hnsw_parameter.nlinks(), FLAGS_max_hnsw_nlinks_of_region);
@@ -630,7 +1080,7 @@ butil::Status VectorIndexHnsw::CheckAndSetHnswParameter(pb::common::CreateHnswPa
   }
 
   auto max_element_limit = CalcHnswCountFromMemory(FLAGS_max_hnsw_memory_size_of_region, hnsw_parameter.dimension(),
-                                                   hnsw_parameter.nlinks());
+                                                   hnsw_parameter.nlinks(), hnsw_parameter.quantizer_type());
   hnsw_parameter.set_max_elements(max_element_limit);
   DINGO_LOG(INFO) << fmt::format(
       "[vector_index.hnsw] calc max element limit is {}, paramiter max_hnsw_memory_size_of_region({}) dimension({}) "
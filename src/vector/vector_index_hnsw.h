@@ -15,16 +15,21 @@
 #ifndef DINGODB_VECTOR_INDEX_HNSW_H_  // NOLINT
 #define DINGODB_VECTOR_INDEX_HNSW_H_
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "bthread/mutex.h"
 #include "butil/status.h"
+#include "bvar/status.h"
 #include "common/synchronization.h"
 #include "hnswlib/hnswlib.h"
 #include "proto/common.pb.h"
 #include "vector/vector_index.h"
+#include "vector/vector_index_hnsw_space.h"
 
 namespace dingodb {
 
@@ -36,7 +41,9 @@ class VectorIndexHnsw : public VectorIndex {
 
   ~VectorIndexHnsw() override;
 
-  static uint32_t CalcHnswCountFromMemory(int64_t memory_size_limit, int64_t dimension, int64_t nlinks);
+  static uint32_t CalcHnswCountFromMemory(
+      int64_t memory_size_limit, int64_t dimension, int64_t nlinks,
+      pb::common::HnswQuantizerType quantizer_type = pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_NONE);
   static butil::Status CheckAndSetHnswParameter(pb::common::CreateHnswParam& hnsw_parameter);
 
   VectorIndexHnsw(const VectorIndexHnsw& rhs) = delete;
@@ -74,6 +81,7 @@ class VectorIndexHnsw : public VectorIndex {
   butil::Status GetCount(int64_t& count) override;
   butil::Status GetDeletedCount(int64_t& deleted_count) override;
   butil::Status GetMemorySize(int64_t& memory_size) override;
+  void GetSearchStats(pb::common::VectorSearchStats& stats) override;
 
   butil::Status ResizeMaxElements(int64_t new_max_elements);
   butil::Status GetMaxElements(int64_t& max_elements);
@@ -88,21 +96,63 @@ class VectorIndexHnsw : public VectorIndex {
   bool NeedToSave(int64_t last_save_log_behind) override;
   bool SupportSave() override;
 
+  bool NeedToRepair() override;
+  butil::Status Repair() override;
+  // Renumber internal ids by bfs order of level 0 graph, the neighbors of a node are close in memory.
+  butil::Status OptimizeLayout() override;
+
   hnswlib::HierarchicalNSW<float>* GetHnswIndex();
 
   // void NormalizeVector(const float* data, float* norm_array) const;
 
+  bool IsQuantized() const { return quantized_space_ != nullptr; }
+
+  // deleted count / element count
+  double DeletedRatio();
+
  private:
+  // reconnect the alive neighbors of deleted nodes at level 0, skip deleted nodes in traversal.
+  // return the count of repaired nodes.
+  int64_t RepairDeletedNeighbors();
+
+  // new label reuse the slot of deleted element, exist label update in place.
+  void AddPoint(const void* data, int64_t label);
+  // normalize if need and encode to quantized code
+  void EncodeVector(const float* vector, void* code) const;
+
+  // resize ahead if the element count will exceed the watermark of max elements.
+  butil::Status ReserveCapacity(int64_t count);
+
+  // bind the level 0 memory to the numa node of region, called after it is allocated.
+  void BindNumaNode();
+
   // hnsw members
   hnswlib::HierarchicalNSW<float>* hnsw_index_;
   hnswlib::SpaceInterface<float>* hnsw_space_;
+  // same object as hnsw_space_ if quantized, otherwise nullptr
+  HnswQuantizedSpace* quantized_space_{nullptr};
 
   // Dimension of the elements
   uint32_t dimension_;
 
   // bthread_mutex_t mutex_;
+  // upsert/delete/search hold read lock, resize hold write lock.
   RWLock rw_lock_;
 
+  // serialize resize
+  bthread::Mutex resize_mutex_;
+  // vector count of the upserts which are reserved capacity but not finished
+  std::atomic<int64_t> inflight_upsert_count_{0};
+
+  // serialize the operations of the same label, unmark delete and update must be atomic.
+  std::array<bthread::Mutex, 64> label_mutexes_;
+
+  // serialize repair
+  bthread::Mutex repair_mutex_;
+  // deleted count at the last repair, avoid repair again when no new delete.
+  std::atomic<int64_t> last_repair_deleted_count_{0};
+  bvar::Status<double> deleted_ratio_metrics_;
+
   uint32_t max_element_limit_;
 
   // normalize vector
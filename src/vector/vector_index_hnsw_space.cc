@@ -0,0 +1,307 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_index_hnsw_space.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "hnswlib/hnswlib.h"
+#include "proto/common.pb.h"
+#include "vector/codec.h"
+
+namespace dingodb {
+
+struct Sq8Header {
+  float min;
+  float scale;
+  float code_sum;
+  float norm2;
+};
+
+size_t HnswQuantizedSpace::CodeSize(pb::common::HnswQuantizerType quantizer_type, size_t dimension) {
+  switch (quantizer_type) {
+    case pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_SQ8:
+      return sizeof(Sq8Header) + dimension;
+    case pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_FP16:
+      return sizeof(uint16_t) * dimension;
+    case pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_INT8:
+      return dimension;
+    case pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_BINARY:
+      return (dimension + 7) / 8;
+    default:
+      return sizeof(float) * dimension;
+  }
+}
+
+HnswQuantizedSpace* HnswQuantizedSpace::New(pb::common::HnswQuantizerType quantizer_type, size_t dimension,
+                                            bool is_ip) {
+  switch (quantizer_type) {
+    case pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_SQ8:
+      return new HnswSq8Space(dimension, is_ip);
+    case pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_FP16:
+      return new HnswFp16Space(dimension, is_ip);
+    case pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_INT8:
+      return new HnswInt8Space(dimension, is_ip);
+    case pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_BINARY:
+      return new HnswBinarySpace(dimension);
+    default:
+      return nullptr;
+  }
+}
+
+// sq8
+// x = min + scale * c, so the inner product of two vectors is
+// d * a.min * b.min + a.min * b.scale * sum(b.c) + b.min * a.scale * sum(a.c) + a.scale * b.scale * sum(a.c * b.c)
+// only the integer dot product is computed per dimension.
+static float Sq8InnerProduct(const void* x, const void* y, const void* param) {
+  const auto* space_param = static_cast<const HnswQuantizedSpace::Param*>(param);
+  size_t dimension = space_param->dimension;
+
+  const auto* header_x = static_cast<const Sq8Header*>(x);
+  const auto* header_y = static_cast<const Sq8Header*>(y);
+  const auto* code_x = reinterpret_cast<const uint8_t*>(header_x + 1);
+  const auto* code_y = reinterpret_cast<const uint8_t*>(header_y + 1);
+
+  uint32_t dot = 0;
+  for (size_t i = 0; i < dimension; ++i) {
+    dot += static_cast<uint32_t>(code_x[i]) * static_cast<uint32_t>(code_y[i]);
+  }
+
+  return dimension * header_x->min * header_y->min + header_x->min * header_y->scale * header_y->code_sum +
+         header_y->min * header_x->scale * header_x->code_sum +
+         header_x->scale * header_y->scale * static_cast<float>(dot);
+}
+
+static float Sq8InnerProductDistance(const void* x, const void* y, const void* param) {
+  return 1.0f - Sq8InnerProduct(x, y, param);
+}
+
+static float Sq8L2Distance(const void* x, const void* y, const void* param) {
+  const auto* header_x = static_cast<const Sq8Header*>(x);
+  const auto* header_y = static_cast<const Sq8Header*>(y);
+  float distance = header_x->norm2 + header_y->norm2 - 2.0f * Sq8InnerProduct(x, y, param);
+  return std::max(distance, 0.0f);
+}
+
+HnswSq8Space::HnswSq8Space(size_t dimension, bool is_ip)
+    : HnswQuantizedSpace(dimension, sizeof(Sq8Header) + dimension), is_ip_(is_ip) {}
+
+hnswlib::DISTFUNC<float> HnswSq8Space::get_dist_func() {
+  return is_ip_ ? Sq8InnerProductDistance : Sq8L2Distance;
+}
+
+void HnswSq8Space::Encode(const float* vector, void* code) const {
+  size_t dimension = Dimension();
+  auto* header = static_cast<Sq8Header*>(code);
+  auto* codes = reinterpret_cast<uint8_t*>(header + 1);
+
+  float min_value = vector[0];
+  float max_value = vector[0];
+  for (size_t i = 1; i < dimension; ++i) {
+    min_value = std::min(min_value, vector[i]);
+    max_value = std::max(max_value, vector[i]);
+  }
+
+  float scale = (max_value - min_value) / 255.0f;
+  uint32_t code_sum = 0;
+  float norm2 = 0.0f;
+  for (size_t i = 0; i < dimension; ++i) {
+    int32_t value = scale > 0.0f ? static_cast<int32_t>(std::lround((vector[i] - min_value) / scale)) : 0;
+    codes[i] = static_cast<uint8_t>(std::clamp(value, 0, 255));
+    code_sum += codes[i];
+
+    float dequantized = min_value + scale * codes[i];
+    norm2 += dequantized * dequantized;
+  }
+
+  header->min = min_value;
+  header->scale = scale;
+  header->code_sum = static_cast<float>(code_sum);
+  header->norm2 = norm2;
+}
+
+void HnswSq8Space::Decode(const void* code, float* vector) const {
+  const auto* header = static_cast<const Sq8Header*>(code);
+  const auto* codes = reinterpret_cast<const uint8_t*>(header + 1);
+  for (size_t i = 0; i < Dimension(); ++i) {
+    vector[i] = header->min + header->scale * codes[i];
+  }
+}
+
+// fp16
+static const float* HalfTable() {
+  static const std::vector<float> kHalfTable = []() {
+    std::vector<float> table(65536);
+    for (uint32_t i = 0; i < table.size(); ++i) {
+      table[i] = HnswFp16Space::HalfToFloat(static_cast<uint16_t>(i));
+    }
+    return table;
+  }();
+  return kHalfTable.data();
+}
+
+static float Fp16InnerProduct(const void* x, const void* y, const void* param) {
+  size_t dimension = static_cast<const HnswQuantizedSpace::Param*>(param)->dimension;
+  const auto* half_x = static_cast<const uint16_t*>(x);
+  const auto* half_y = static_cast<const uint16_t*>(y);
+  const float* table = HalfTable();
+
+  float sum = 0.0f;
+  for (size_t i = 0; i < dimension; ++i) {
+    sum += table[half_x[i]] * table[half_y[i]];
+  }
+  return sum;
+}
+
+static float Fp16InnerProductDistance(const void* x, const void* y, const void* param) {
+  return 1.0f - Fp16InnerProduct(x, y, param);
+}
+
+static float Fp16L2Distance(const void* x, const void* y, const void* param) {
+  size_t dimension = static_cast<const HnswQuantizedSpace::Param*>(param)->dimension;
+  const auto* half_x = static_cast<const uint16_t*>(x);
+  const auto* half_y = static_cast<const uint16_t*>(y);
+  const float* table = HalfTable();
+
+  float sum = 0.0f;
+  for (size_t i = 0; i < dimension; ++i) {
+    float diff = table[half_x[i]] - table[half_y[i]];
+    sum += diff * diff;
+  }
+  return sum;
+}
+
+HnswFp16Space::HnswFp16Space(size_t dimension, bool is_ip)
+    : HnswQuantizedSpace(dimension, sizeof(uint16_t) * dimension), is_ip_(is_ip) {
+  // build table at create, avoid the first search pay for it.
+  HalfTable();
+}
+
+hnswlib::DISTFUNC<float> HnswFp16Space::get_dist_func() {
+  return is_ip_ ? Fp16InnerProductDistance : Fp16L2Distance;
+}
+
+void HnswFp16Space::Encode(const float* vector, void* code) const {
+  auto* halfs = static_cast<uint16_t*>(code);
+  for (size_t i = 0; i < Dimension(); ++i) {
+    halfs[i] = FloatToHalf(vector[i]);
+  }
+}
+
+void HnswFp16Space::Decode(const void* code, float* vector) const {
+  const auto* halfs = static_cast<const uint16_t*>(code);
+  const float* table = HalfTable();
+  for (size_t i = 0; i < Dimension(); ++i) {
+    vector[i] = table[halfs[i]];
+  }
+}
+
+// int8
+static float Int8InnerProductDistance(const void* x, const void* y, const void* param) {
+  size_t dimension = static_cast<const HnswQuantizedSpace::Param*>(param)->dimension;
+  const auto* code_x = static_cast<const int8_t*>(x);
+  const auto* code_y = static_cast<const int8_t*>(y);
+
+  int32_t dot = 0;
+  for (size_t i = 0; i < dimension; ++i) {
+    dot += static_cast<int32_t>(code_x[i]) * static_cast<int32_t>(code_y[i]);
+  }
+  return 1.0f - static_cast<float>(dot);
+}
+
+static float Int8L2Distance(const void* x, const void* y, const void* param) {
+  size_t dimension = static_cast<const HnswQuantizedSpace::Param*>(param)->dimension;
+  const auto* code_x = static_cast<const int8_t*>(x);
+  const auto* code_y = static_cast<const int8_t*>(y);
+
+  int32_t sum = 0;
+  for (size_t i = 0; i < dimension; ++i) {
+    int32_t diff = static_cast<int32_t>(code_x[i]) - static_cast<int32_t>(code_y[i]);
+    sum += diff * diff;
+  }
+  return static_cast<float>(sum);
+}
+
+HnswInt8Space::HnswInt8Space(size_t dimension, bool is_ip) : HnswQuantizedSpace(dimension, dimension), is_ip_(is_ip) {}
+
+hnswlib::DISTFUNC<float> HnswInt8Space::get_dist_func() {
+  return is_ip_ ? Int8InnerProductDistance : Int8L2Distance;
+}
+
+void HnswInt8Space::Encode(const float* vector, void* code) const {
+  auto* codes = static_cast<int8_t*>(code);
+  for (size_t i = 0; i < Dimension(); ++i) {
+    codes[i] = static_cast<int8_t>(std::clamp(static_cast<int32_t>(std::lround(vector[i])), -128, 127));
+  }
+}
+
+void HnswInt8Space::Decode(const void* code, float* vector) const {
+  const auto* codes = static_cast<const int8_t*>(code);
+  for (size_t i = 0; i < Dimension(); ++i) {
+    vector[i] = static_cast<float>(codes[i]);
+  }
+}
+
+// binary
+static float HammingDistance(const void* x, const void* y, const void* param) {
+  size_t code_size = static_cast<const HnswQuantizedSpace::Param*>(param)->data_size;
+  const auto* code_x = static_cast<const uint8_t*>(x);
+  const auto* code_y = static_cast<const uint8_t*>(y);
+
+  uint32_t count = 0;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= code_size; i += sizeof(uint64_t)) {
+    uint64_t word_x = 0;
+    uint64_t word_y = 0;
+    memcpy(&word_x, code_x + i, sizeof(word_x));
+    memcpy(&word_y, code_y + i, sizeof(word_y));
+    count += __builtin_popcountll(word_x ^ word_y);
+  }
+  for (; i < code_size; ++i) {
+    count += __builtin_popcount(code_x[i] ^ code_y[i]);
+  }
+  return static_cast<float>(count);
+}
+
+HnswBinarySpace::HnswBinarySpace(size_t dimension) : HnswQuantizedSpace(dimension, (dimension + 7) / 8) {}
+
+hnswlib::DISTFUNC<float> HnswBinarySpace::get_dist_func() { return HammingDistance; }
+
+void HnswBinarySpace::Encode(const float* vector, void* code) const {
+  auto* codes = static_cast<uint8_t*>(code);
+  memset(codes, 0, CodeSize());
+  for (size_t i = 0; i < Dimension(); ++i) {
+    if (vector[i] != 0.0f) {
+      codes[i / 8] |= static_cast<uint8_t>(1U << (i % 8));
+    }
+  }
+}
+
+void HnswBinarySpace::Decode(const void* code, float* vector) const {
+  const auto* codes = static_cast<const uint8_t*>(code);
+  for (size_t i = 0; i < Dimension(); ++i) {
+    vector[i] = static_cast<float>((codes[i / 8] >> (i % 8)) & 1);
+  }
+}
+
+uint16_t HnswFp16Space::FloatToHalf(float value) { return VectorCodec::FloatToHalf(value); }
+
+float HnswFp16Space::HalfToFloat(uint16_t value) { return VectorCodec::HalfToFloat(value); }
+
+}  // namespace dingodb
@@ -0,0 +1,119 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_INDEX_HNSW_SPACE_H_  // NOLINT
+#define DINGODB_VECTOR_INDEX_HNSW_SPACE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "hnswlib/hnswlib.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Scalar quantized hnswlib space, the graph is built and traversed on the quantized codes.
+// Both the stored vectors and the queries are encoded by Encode before passed to hnswlib.
+// The distance has the same semantics as hnswlib, L2 is squared distance, IP is 1 - inner product.
+class HnswQuantizedSpace : public hnswlib::SpaceInterface<float> {
+ public:
+  HnswQuantizedSpace(size_t dimension, size_t data_size) : param_{data_size, dimension} {}
+  ~HnswQuantizedSpace() override = default;
+
+  size_t get_data_size() override { return param_.data_size; }
+  void* get_dist_func_param() override { return &param_; }
+
+  virtual void Encode(const float* vector, void* code) const = 0;
+  virtual void Decode(const void* code, float* vector) const = 0;
+
+  size_t Dimension() const { return param_.dimension; }
+  size_t CodeSize() const { return param_.data_size; }
+
+  // bytes per vector of the quantizer type.
+  static size_t CodeSize(pb::common::HnswQuantizerType quantizer_type, size_t dimension);
+
+  // return nullptr if quantizer type is none.
+  static HnswQuantizedSpace* New(pb::common::HnswQuantizerType quantizer_type, size_t dimension, bool is_ip);
+
+  struct Param {
+    // must be the first member, hnswlib getDataByLabel read it as element count.
+    size_t data_size;
+    size_t dimension;
+  };
+
+ protected:
+  Param param_;
+};
+
+// 8 bits per dimension, each vector has its own min and scale.
+// Code layout: | min (float) | scale (float) | sum of codes (float) | squared norm (float) | uint8 * dimension |
+class HnswSq8Space : public HnswQuantizedSpace {
+ public:
+  HnswSq8Space(size_t dimension, bool is_ip);
+
+  hnswlib::DISTFUNC<float> get_dist_func() override;
+
+  void Encode(const float* vector, void* code) const override;
+  void Decode(const void* code, float* vector) const override;
+
+ private:
+  bool is_ip_;
+};
+
+// IEEE 754 half precision per dimension.
+class HnswFp16Space : public HnswQuantizedSpace {
+ public:
+  HnswFp16Space(size_t dimension, bool is_ip);
+
+  hnswlib::DISTFUNC<float> get_dist_func() override;
+
+  void Encode(const float* vector, void* code) const override;
+  void Decode(const void* code, float* vector) const override;
+
+  static uint16_t FloatToHalf(float value);
+  static float HalfToFloat(uint16_t value);
+
+ private:
+  bool is_ip_;
+};
+
+// One signed byte per dimension, values are rounded and clamped to int8, so it is exact for int8 vectors.
+class HnswInt8Space : public HnswQuantizedSpace {
+ public:
+  HnswInt8Space(size_t dimension, bool is_ip);
+
+  hnswlib::DISTFUNC<float> get_dist_func() override;
+
+  void Encode(const float* vector, void* code) const override;
+  void Decode(const void* code, float* vector) const override;
+
+ private:
+  bool is_ip_;
+};
+
+// One bit per dimension, non zero value is bit 1, the distance is hamming distance.
+// bit i is the (i % 8) bit of byte i / 8 from the lowest bit, same as binary vector values.
+class HnswBinarySpace : public HnswQuantizedSpace {
+ public:
+  explicit HnswBinarySpace(size_t dimension);
+
+  hnswlib::DISTFUNC<float> get_dist_func() override;
+
+  void Encode(const float* vector, void* code) const override;
+  void Decode(const void* code, float* vector) const override;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_INDEX_HNSW_SPACE_H_  // NOLINT
@@ -38,6 +38,8 @@
 #include "proto/debug.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
+#include "vector/vector_index_mmap_reader.h"
+#include "vector/vector_index_train.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
@@ -72,6 +74,10 @@ VectorIndexIvfFlat::VectorIndexIvfFlat(int64_t id, const pb::common::VectorIndex
 
   train_data_size_ = 0;
   // Delay object creation.
+
+  if (vector_index_parameter.ivf_flat_parameter().use_gpu()) {
+    gpu_replica_ = std::make_unique<GpuIndexReplica>(id);
+  }
 }
 
 VectorIndexIvfFlat::~VectorIndexIvfFlat() = default;
@@ -107,6 +113,9 @@ butil::Status VectorIndexIvfFlat::AddOrUpsert(const std::vector<pb::common::Vect
     index_->remove_ids(sel);
   }
   index_->add_with_ids(vector_with_ids.size(), vectors.get(), ids.get());
+  if (gpu_replica_ != nullptr) {
+    gpu_replica_->MarkStale();
+  }
 
   return butil::Status::OK();
 }
@@ -163,6 +172,9 @@ butil::Status VectorIndexIvfFlat::Delete(const std::vector<int64_t>& delete_ids)
     }
 
     auto remove_count = index_->remove_ids(sel);
+    if (gpu_replica_ != nullptr) {
+      gpu_replica_->MarkStale();
+    }
     if (0 == remove_count) {
       DINGO_LOG(ERROR) << fmt::format("not found id : {}", id);
       return butil::Status(pb::error::Errno::EVECTOR_INVALID, fmt::format("not found : {}", id));
@@ -198,7 +210,7 @@ butil::Status VectorIndexIvfFlat::Search(const std::vector<pb::common::VectorWit
   std::vector<faiss::idx_t> labels;
   labels.resize(topk * vector_with_ids.size(), -1);
 
-  const auto& [vectors, status] = VectorIndexUtils::CheckAndCopyVectorData(vector_with_ids, dimension_, normalize_);
+  const auto& [vectors, status] = VectorIndexUtils::CheckAndViewVectorData(vector_with_ids, dimension_, normalize_);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
@@ -230,15 +242,22 @@ butil::Status VectorIndexIvfFlat::Search(const std::vector<pb::common::VectorWit
     ivf_search_parameters.max_codes = 0;
     ivf_search_parameters.quantizer_params = nullptr;  // search for nlist . ignore
 
+    SearchThreadGuard thread_guard;
     if (!filters.empty()) {
       auto ivf_flat_filter = filters.empty() ? nullptr : std::make_shared<IvfFlatIDSelector>(filters);
       ivf_search_parameters.sel = ivf_flat_filter.get();
       index_->search(vector_with_ids.size(), vectors.get(), topk, distances.data(), labels.data(),
                      &ivf_search_parameters);
-    } else {
+    } else if (gpu_replica_ == nullptr || !gpu_replica_->Search(vector_with_ids.size(), vectors.get(), topk,
+                                                                 distances.data(), labels.data(), nprobe)) {
       index_->search(vector_with_ids.size(), vectors.get(), topk, distances.data(), labels.data(),
                      &ivf_search_parameters);
     }
+
+    // Estimated by the average list size.
+    int64_t probed_lists = static_cast<int64_t>(vector_with_ids.size()) * nprobe;
+    AddSearchStats(index_->nlist > 0 ? probed_lists * index_->ntotal / static_cast<int64_t>(index_->nlist) : 0, 0,
+                   probed_lists);
   }
 
   VectorIndexUtils::FillSearchResult(vector_with_ids, topk, distances, labels, metric_type_, dimension_, results);
@@ -265,7 +284,7 @@ butil::Status VectorIndexIvfFlat::RangeSearch(const std::vector<pb::common::Vect
     nprobe = Constant::kSearchIvfFlatParamNprobe;
   }
 
-  const auto& [vectors, status] = VectorIndexUtils::CheckAndCopyVectorData(vector_with_ids, dimension_, normalize_);
+  const auto& [vectors, status] = VectorIndexUtils::CheckAndViewVectorData(vector_with_ids, dimension_, normalize_);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
@@ -305,6 +324,7 @@ butil::Status VectorIndexIvfFlat::RangeSearch(const std::vector<pb::common::Vect
     ivf_search_parameters.max_codes = 0;
     ivf_search_parameters.quantizer_params = nullptr;  // search for nlist . ignore
 
+    SearchThreadGuard thread_guard;
     try {
       if (!filters.empty()) {
         auto ivf_flat_filter = filters.empty() ? nullptr : std::make_shared<IvfFlatIDSelector>(filters);
@@ -369,7 +389,7 @@ butil::Status VectorIndexIvfFlat::Load(const std::string& path) {
 
   faiss::Index* internal_raw_index = nullptr;
   try {
-    internal_raw_index = faiss::read_index(path.c_str(), 0);
+    internal_raw_index = MmapIndexReader::ReadIndex(path);
 
   } catch (std::exception& e) {
     std::string s =
@@ -449,6 +469,9 @@ butil::Status VectorIndexIvfFlat::Load(const std::string& path) {
   }
 
   quantizer_.reset();
+  if (gpu_replica_ != nullptr) {
+    gpu_replica_->MarkStale();
+  }
   index_ = std::move(internal_index_ivf_flat);
 
   nlist_ = index_->nlist;
@@ -551,6 +574,15 @@ butil::Status VectorIndexIvfFlat::Train(const std::vector<float>& train_datas) {
   // init index
   Init();
 
+  // reuse the centroids of the same partition, faiss skip clustering the quantizer which is full.
+  auto centroid_key = CentroidCache::GenKey(Range(), vector_index_parameter, nlist_);
+  std::vector<float> centroids;
+  bool reuse_centroids = CentroidCache::GetInstance().Get(centroid_key, data_size, centroids) &&
+                         centroids.size() == static_cast<size_t>(nlist_ * dimension_);
+  if (reuse_centroids) {
+    quantizer_->add(nlist_, centroids.data());
+  }
+
   train_data_size_ = 0;
 
   float* train_datas_ptr = const_cast<float*>(train_datas.data());
@@ -574,6 +606,7 @@ butil::Status VectorIndexIvfFlat::Train(const std::vector<float>& train_datas) {
   }
 
   try {
+    TrainThreadGuard thread_guard;
     index_->train(data_size, train_datas_ptr);
 
   } catch (std::exception& e) {
@@ -596,6 +629,14 @@ butil::Status VectorIndexIvfFlat::Train(const std::vector<float>& train_datas) {
 
   train_data_size_ = data_size;
 
+  if (!reuse_centroids) {
+    auto* flat_quantizer = dynamic_cast<faiss::IndexFlat*>(quantizer_.get());
+    if (flat_quantizer != nullptr && flat_quantizer->ntotal == static_cast<faiss::idx_t>(nlist_)) {
+      const float* xb = flat_quantizer->get_xb();
+      CentroidCache::GetInstance().Put(centroid_key, data_size, std::vector<float>(xb, xb + nlist_ * dimension_));
+    }
+  }
+
   return butil::Status::OK();
 }
 
@@ -616,6 +657,12 @@ butil::Status VectorIndexIvfFlat::Train([[maybe_unused]] const std::vector<pb::c
   return VectorIndexIvfFlat::Train(train_datas);
 }
 
+// faiss k-means use at most max_points_per_centroid points for each centroid.
+int64_t VectorIndexIvfFlat::TrainSampleSize() {
+  faiss::ClusteringParameters clustering_parameters;
+  return static_cast<int64_t>(clustering_parameters.max_points_per_centroid) * nlist_org_;
+}
+
 bool VectorIndexIvfFlat::NeedToRebuild() {
   RWLockReadGuard guard(&rw_lock_);
 
@@ -639,7 +686,9 @@ bool VectorIndexIvfFlat::NeedToRebuild() {
 
   if (BAIDU_UNLIKELY(nlist_ == nlist_org_ && 1 != nlist_ &&
                      index_->ntotal >= clustering_parameters.max_points_per_centroid * nlist_org_)) {
-    return train_data_size_ <= (index_->ntotal / 2);
+    // the train data is sampled up to max_points_per_centroid * nlist, more data not change the training.
+    return train_data_size_ <= (index_->ntotal / 2) &&
+           train_data_size_ < clustering_parameters.max_points_per_centroid * nlist_org_;
   }
 
   return false;
@@ -673,6 +722,17 @@ bool VectorIndexIvfFlat::NeedToSave(int64_t last_save_log_behind) {
   return false;
 }
 
+bool VectorIndexIvfFlat::NeedToRepair() { return gpu_replica_ != nullptr && gpu_replica_->NeedToSync(); }
+
+butil::Status VectorIndexIvfFlat::Repair() {
+  if (gpu_replica_ == nullptr) {
+    return butil::Status::OK();
+  }
+
+  RWLockReadGuard guard(&rw_lock_);
+  return gpu_replica_->Sync(DoIsTrained() ? index_.get() : nullptr);
+}
+
 void VectorIndexIvfFlat::Init() {
   if (pb::common::MetricType::METRIC_TYPE_L2 == metric_type_) {
     quantizer_ = std::make_unique<faiss::IndexFlatL2>(dimension_);
@@ -29,6 +29,7 @@
 #include "faiss/utils/distances.h"
 #include "proto/common.pb.h"
 #include "vector/vector_index.h"
+#include "vector/vector_index_gpu.h"
 
 namespace dingodb {
 
@@ -105,9 +106,14 @@ class VectorIndexIvfFlat : public VectorIndex {
   butil::Status Train([[maybe_unused]] const std::vector<pb::common::VectorWithId>& vectors) override;
   bool NeedToRebuild() override;
   bool NeedTrain() override { return true; }
+  int64_t TrainSampleSize() override;
   bool IsTrained() override;
   bool NeedToSave(int64_t last_save_log_behind) override;
 
+  // sync the stale gpu replica
+  bool NeedToRepair() override;
+  butil::Status Repair() override;
+
  private:
   void Init();
 
@@ -142,6 +148,9 @@ class VectorIndexIvfFlat : public VectorIndex {
 
   // first  train data size
   faiss::idx_t train_data_size_;
+
+  // only set when use_gpu
+  std::unique_ptr<GpuIndexReplica> gpu_replica_;
 };
 
 }  // namespace dingodb
@@ -73,6 +73,10 @@ VectorIndexIvfPq::VectorIndexIvfPq(int64_t id, const pb::common::VectorIndexPara
     nbits_per_idx_ = Constant::kCreateIvfPqParamNbitsPerIdx;
   }
 
+  if (vector_index_parameter.ivf_pq_parameter().use_fast_scan()) {
+    nbits_per_idx_ = Constant::kCreateIvfPqParamFastScanNbitsPerIdx;
+  }
+
   // Delay object creation.
 }
 
@@ -252,6 +256,7 @@ butil::Status VectorIndexIvfPq::Load(const std::string& path) {
   ::dingodb::pb::common::CreateFlatParam* flat_parameter = index_parameter_flat.mutable_flat_parameter();
   flat_parameter->set_metric_type(vector_index_parameter.ivf_pq_parameter().metric_type());
   flat_parameter->set_dimension(vector_index_parameter.ivf_pq_parameter().dimension());
+  flat_parameter->set_use_gpu(vector_index_parameter.ivf_pq_parameter().use_gpu());
   auto internal_index_flat = std::make_unique<VectorIndexFlat>(id, index_parameter_flat, epoch, range, thread_pool);
 
   status = internal_index_flat->Load(path);
@@ -302,6 +307,27 @@ butil::Status VectorIndexIvfPq::GetDeletedCount(int64_t& deleted_count) {
   return butil::Status::OK();
 }
 
+void VectorIndexIvfPq::GetSearchStats(pb::common::VectorSearchStats& stats) {
+  RWLockReadGuard guard(&rw_lock_);
+
+  switch (index_type_in_ivf_pq_) {
+    case IndexTypeInIvfPq::kFlat: {
+      if (index_flat_ != nullptr) {
+        index_flat_->GetSearchStats(stats);
+      }
+      break;
+    }
+    case IndexTypeInIvfPq::kIvfPq: {
+      if (index_raw_ivf_pq_ != nullptr) {
+        index_raw_ivf_pq_->GetSearchStats(stats);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
 butil::Status VectorIndexIvfPq::GetMemorySize(int64_t& memory_size) {
   RWLockReadGuard guard(&rw_lock_);
 
@@ -456,6 +482,14 @@ butil::Status VectorIndexIvfPq::Train([[maybe_unused]] const std::vector<pb::com
   return VectorIndexIvfPq::Train(train_datas);
 }
 
+// Not less than the size of choosing ivf pq in train, faiss use at most that for k-means.
+int64_t VectorIndexIvfPq::TrainSampleSize() {
+  faiss::ClusteringParameters clustering_parameters;
+  faiss::ProductQuantizer pq = faiss::ProductQuantizer(dimension_, nsubvector_, nbits_per_idx_);
+  return std::max(static_cast<int64_t>(clustering_parameters.max_points_per_centroid) * static_cast<int64_t>(nlist_),
+                  static_cast<int64_t>(pq.cp.max_points_per_centroid) * (1LL << nbits_per_idx_));
+}
+
 bool VectorIndexIvfPq::NeedToRebuild() {
   RWLockReadGuard guard(&rw_lock_);
 
@@ -524,6 +558,28 @@ bool VectorIndexIvfPq::NeedToSave(int64_t last_save_log_behind) {
   return false;
 }
 
+bool VectorIndexIvfPq::NeedToRepair() {
+  RWLockReadGuard guard(&rw_lock_);
+  switch (index_type_in_ivf_pq_) {
+    case IndexTypeInIvfPq::kFlat: {
+      return index_flat_->NeedToRepair();
+    }
+    case IndexTypeInIvfPq::kIvfPq: {
+      return index_raw_ivf_pq_->NeedToRepair();
+    }
+    case IndexTypeInIvfPq::kUnknow:
+      [[fallthrough]];
+    default: {
+      return false;
+    }
+  }
+}
+
+butil::Status VectorIndexIvfPq::Repair() {
+  RWLockReadGuard guard(&rw_lock_);
+  return InvokeConcreteFunction("Repair", &VectorIndexFlat::Repair, &VectorIndexRawIvfPq::Repair, false);
+}
+
 pb::common::VectorIndexType VectorIndexIvfPq::VectorIndexSubType() {
   RWLockReadGuard guard(&rw_lock_);
   if (BAIDU_UNLIKELY(!DoIsTrained())) {
@@ -556,6 +612,8 @@ void VectorIndexIvfPq::Init() {
     ::dingodb::pb::common::CreateFlatParam* flat_parameter = index_parameter_flat.mutable_flat_parameter();
     flat_parameter->set_metric_type(vector_index_parameter.ivf_pq_parameter().metric_type());
     flat_parameter->set_dimension(vector_index_parameter.ivf_pq_parameter().dimension());
+    flat_parameter->set_use_gpu(vector_index_parameter.ivf_pq_parameter().use_gpu());
+  flat_parameter->set_use_gpu(vector_index_parameter.ivf_pq_parameter().use_gpu());
     index_flat_ = std::make_unique<VectorIndexFlat>(id, index_parameter_flat, epoch, range, thread_pool);
 
   } else if (IndexTypeInIvfPq::kIvfPq == index_type_in_ivf_pq_) {
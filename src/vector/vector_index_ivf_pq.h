@@ -75,15 +75,21 @@ class VectorIndexIvfPq : public VectorIndex {
   butil::Status GetCount([[maybe_unused]] int64_t& count) override;
   butil::Status GetDeletedCount([[maybe_unused]] int64_t& deleted_count) override;
   butil::Status GetMemorySize([[maybe_unused]] int64_t& memory_size) override;
+  void GetSearchStats(pb::common::VectorSearchStats& stats) override;
   bool IsExceedsMaxElements() override;
 
   butil::Status Train(const std::vector<float>& train_datas) override;
   butil::Status Train([[maybe_unused]] const std::vector<pb::common::VectorWithId>& vectors) override;
   bool NeedToRebuild() override;
   bool NeedTrain() override { return true; }
+  int64_t TrainSampleSize() override;
   bool IsTrained() override;
   bool NeedToSave(int64_t last_save_log_behind) override;
 
+  // sync the stale gpu replica of concrete index
+  bool NeedToRepair() override;
+  butil::Status Repair() override;
+
   pb::common::VectorIndexType VectorIndexSubType() override;
 
  private:
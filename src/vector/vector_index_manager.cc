@@ -14,11 +14,13 @@
 
 #include "vector/vector_index_manager.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "bthread/bthread.h"
@@ -27,7 +29,9 @@
 #include "bvar/reducer.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/memory_tracker.h"
 #include "common/synchronization.h"
+#include "engine/write_throttler.h"
 #include "fmt/core.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
@@ -36,20 +40,49 @@
 #include "proto/node.pb.h"
 #include "proto/raft.pb.h"
 #include "server/server.h"
+#include "split/load_split.h"
 #include "vector/codec.h"
 #include "vector/vector_index.h"
 #include "vector/vector_index_factory.h"
 #include "vector/vector_index_snapshot.h"
 #include "vector/vector_index_snapshot_manager.h"
+#include "vector/vector_index_train.h"
 
 namespace dingodb {
 
 DEFINE_int64(catchup_log_min_gap, 8, "catch up log min gap");
 DEFINE_int32(vector_background_worker_num, 16, "vector index background worker num");
 DEFINE_int32(vector_fast_background_worker_num, 8, "vector index fast background worker num");
+DEFINE_int32(vector_load_worker_num, 0,
+             "vector index load worker num, slow load tasks are run by priority when > 0, otherwise run on the "
+             "background workers");
+DEFINE_int32(vector_load_wait_interval_ms, 100, "interval of load task waiting for concurrency under write pressure");
+DEFINE_bool(enable_vector_index_shared_build, false,
+            "follower pull the vector index snapshot built by leader instead of building by itself");
+DEFINE_int32(vector_index_shared_build_wait_s, 600, "max time of follower waiting for the snapshot built by leader");
+DEFINE_int32(vector_index_shared_build_pull_interval_ms, 5000, "interval of follower pulling the leader snapshot");
+DEFINE_bool(enable_vector_index_split_clone, false,
+            "after split, hnsw and flat vector index is cloned from the index before split and filtered by range "
+            "instead of building from original data");
+DEFINE_bool(enable_vector_build_pipeline, false,
+            "build vector index from original data by pipelining, add a batch while scanning the next batch");
+DEFINE_int64(vector_build_readahead_size, 0, "readahead bytes of scanning vector data when build, 0 is engine default");
+DEFINE_bool(enable_vector_index_optimize_layout, false,
+            "optimize memory layout of vector index for search locality after build from original data");
 DEFINE_int64(vector_fast_build_log_gap, 50, "vector index fast build log gap");
 DEFINE_int64(vector_pull_snapshot_min_log_gap, 66, "vector index pull snapshot min log gap");
 DEFINE_int64(vector_max_background_task_count, 32, "vector index max background task count");
+DEFINE_bool(enable_async_vector_index_apply, false,
+            "apply vector add/delete log to vector index out of raft apply thread, the vector is searchable a little "
+            "later than the write response");
+DEFINE_int32(vector_apply_worker_num, 8, "vector index async apply worker num");
+DEFINE_int32(vector_max_pending_apply_task_count, 64, "max pending async apply task count of one vector index");
+DEFINE_int64(vector_index_offload_memory_mb, 0,
+             "offload the least recently searched vector indexes when the memory of loaded vector indexes exceeds it, "
+             "0 is disable");
+DEFINE_int64(vector_index_offload_idle_s, 600, "only the vector index not searched for the seconds is offloaded");
+
+bvar::Adder<uint64_t> g_vector_index_offload_count("dingo_vector_index_offload_count");
 
 std::string RebuildVectorIndexTask::Trace() {
   return fmt::format("[vector_index.rebuild][id({}).start_time({}).job_id({})] {}", vector_index_wrapper_->Id(),
@@ -142,23 +175,34 @@ void RebuildVectorIndexTask::Run() {
   ADD_REGION_CHANGE_RECORD_TIMEPOINT(job_id_, fmt::format("Rebuilding vector index {}", region->Id()));
 
   vector_index_wrapper_->SetIsTempHoldVectorIndex(true);
-  auto status = VectorIndexManager::RebuildVectorIndex(vector_index_wrapper_, fmt::format("REBUILD-{}", trace_));
-  if (!status.ok()) {
-    ADD_REGION_CHANGE_RECORD_TIMEPOINT(job_id_, fmt::format("Rebuilded vector index {}", region->Id()));
-    DINGO_LOG(ERROR) << fmt::format(
-        "[vector_index.rebuild][index_id({}_v{})][trace({})] rebuild vector index failed, error: {}.",
-        vector_index_wrapper_->Id(), vector_index_wrapper_->Version(), trace_, Helper::PrintStatus(status));
-    return;
+
+  // Follower use the snapshot built by leader, the follower not hold vector index only need the snapshot.
+  bool is_shared_build = VectorIndexManager::PullSharedBuildSnapshot(vector_index_wrapper_, region->Epoch(), trace_);
+  if (is_shared_build && (!force_ || VectorIndexWrapper::IsPermanentHoldVectorIndex(vector_index_wrapper_->Id()))) {
+    is_shared_build = VectorIndexManager::LoadVectorIndexOnly(vector_index_wrapper_, region->Epoch(), trace_).ok();
   }
 
-  ADD_REGION_CHANGE_RECORD_TIMEPOINT(job_id_, fmt::format("Saving vector index {}", region->Id()));
+  if (is_shared_build) {
+    ADD_REGION_CHANGE_RECORD_TIMEPOINT(job_id_, fmt::format("Pulled vector index {} snapshot", region->Id()));
+  } else {
+    auto status = VectorIndexManager::RebuildVectorIndex(vector_index_wrapper_, fmt::format("REBUILD-{}", trace_));
+    if (!status.ok()) {
+      ADD_REGION_CHANGE_RECORD_TIMEPOINT(job_id_, fmt::format("Rebuilded vector index {}", region->Id()));
+      DINGO_LOG(ERROR) << fmt::format(
+          "[vector_index.rebuild][index_id({}_v{})][trace({})] rebuild vector index failed, error: {}.",
+          vector_index_wrapper_->Id(), vector_index_wrapper_->Version(), trace_, Helper::PrintStatus(status));
+      return;
+    }
 
-  status = VectorIndexManager::SaveVectorIndex(vector_index_wrapper_, trace_);
-  if (!status.ok()) {
-    ADD_REGION_CHANGE_RECORD_TIMEPOINT(job_id_, fmt::format("Saved vector index {} failed", region->Id()));
-    DINGO_LOG(ERROR) << fmt::format(
-        "[vector_index.save][index_id({}_v{})][trace({})] save vector index failed, error: {}.",
-        vector_index_wrapper_->Id(), vector_index_wrapper_->Version(), trace_, Helper::PrintStatus(status));
+    ADD_REGION_CHANGE_RECORD_TIMEPOINT(job_id_, fmt::format("Saving vector index {}", region->Id()));
+
+    status = VectorIndexManager::SaveVectorIndex(vector_index_wrapper_, trace_);
+    if (!status.ok()) {
+      ADD_REGION_CHANGE_RECORD_TIMEPOINT(job_id_, fmt::format("Saved vector index {} failed", region->Id()));
+      DINGO_LOG(ERROR) << fmt::format(
+          "[vector_index.save][index_id({}_v{})][trace({})] save vector index failed, error: {}.",
+          vector_index_wrapper_->Id(), vector_index_wrapper_->Version(), trace_, Helper::PrintStatus(status));
+    }
   }
 
   vector_index_wrapper_->SetIsTempHoldVectorIndex(false);
@@ -174,6 +218,41 @@ void RebuildVectorIndexTask::Run() {
   }
 }
 
+std::string RepairVectorIndexTask::Trace() {
+  return fmt::format("[vector_index.repair][id({}).start_time({})] {}", vector_index_wrapper_->Id(),
+                     Helper::FormatMsTime(start_time_), trace_);
+}
+
+void RepairVectorIndexTask::Run() {
+  int64_t start_time = Helper::TimestampMs();
+  ON_SCOPE_EXIT([&]() {
+    vector_index_wrapper_->DecPendingTaskNum();
+
+    LOG(INFO) << fmt::format("[vector_index.repair][index_id({})][trace({})] run finish, run_time({}).",
+                             vector_index_wrapper_->Id(), trace_, Helper::TimestampMs() - start_time);
+  });
+
+  if (vector_index_wrapper_->IsStop()) {
+    DINGO_LOG(INFO) << fmt::format(
+        "[vector_index.repair][index_id({})][trace({})] vector index is stop, gave up repair vector index.",
+        vector_index_wrapper_->Id(), trace_);
+    return;
+  }
+  if (!vector_index_wrapper_->IsOwnReady()) {
+    DINGO_LOG(INFO) << fmt::format(
+        "[vector_index.repair][index_id({})][trace({})] vector index is not ready, gave up repair vector index.",
+        vector_index_wrapper_->Id(), trace_);
+    return;
+  }
+
+  auto status = vector_index_wrapper_->Repair();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format(
+        "[vector_index.repair][index_id({})][trace({})] repair vector index failed, error {}",
+        vector_index_wrapper_->Id(), trace_, status.error_str());
+  }
+}
+
 std::string SaveVectorIndexTask::Trace() {
   return fmt::format("[vector_index.save][id({}).start_time({})] {}", vector_index_wrapper_->Id(),
                      Helper::FormatMsTime(start_time_), trace_);
@@ -225,6 +304,44 @@ void SaveVectorIndexTask::Run() {
   }
 }
 
+std::string ApplyVectorIndexTask::Trace() {
+  return fmt::format("[vector_index.apply][id({}).start_time({}).log_id({})] upsert({}) delete({})",
+                     vector_index_wrapper_->Id(), Helper::FormatMsTime(start_time_), log_id_, vector_with_ids_.size(),
+                     delete_ids_.size());
+}
+
+void ApplyVectorIndexTask::Run() {
+  ON_SCOPE_EXIT([&]() { vector_index_wrapper_->DecPendingApplyNum(); });
+
+  int64_t vector_index_id = vector_index_wrapper_->Id();
+  // Not ready vector index catch up the log when load or build.
+  if (vector_index_wrapper_->IsStop() || !vector_index_wrapper_->IsReady()) {
+    return;
+  }
+  // Maybe already applied by replay, e.g. rebuild.
+  if (log_id_ <= vector_index_wrapper_->ApplyLogId()) {
+    return;
+  }
+
+  try {
+    int64_t start_time = Helper::TimestampNs();
+    auto status = !vector_with_ids_.empty() ? vector_index_wrapper_->Upsert(vector_with_ids_)
+                                            : vector_index_wrapper_->Delete(delete_ids_);
+    DINGO_LOG(DEBUG) << fmt::format("[vector_index.apply][index_id({})] apply log({}), upsert({}) delete({}) cost: {}us",
+                                    vector_index_id, log_id_, vector_with_ids_.size(), delete_ids_.size(),
+                                    (Helper::TimestampNs() - start_time) / 1000);
+    if (status.ok()) {
+      vector_index_wrapper_->SetApplyLogId(log_id_);
+    } else {
+      DINGO_LOG(WARNING) << fmt::format("[vector_index.apply][index_id({})] apply log({}) failed, error: {}",
+                                        vector_index_id, log_id_, Helper::PrintStatus(status));
+    }
+  } catch (const std::exception& e) {
+    DINGO_LOG(FATAL) << fmt::format("[vector_index.apply][index_id({})] apply log({}) exception, error: {}",
+                                    vector_index_id, log_id_, e.what());
+  }
+}
+
 std::string LoadOrBuildVectorIndexTask::Trace() {
   return fmt::format("[vector_index.loadorbuild][id({}).start_time({}).job_id({})] {}", vector_index_wrapper_->Id(),
                      Helper::FormatMsTime(start_time_), job_id_, trace_);
@@ -335,6 +452,10 @@ void LoadAsyncBuildVectorIndexTask::Run() {
       vector_index_wrapper_->PendingTaskNum(), VectorIndexManager::GetVectorIndexLoadorbuildTaskRunningNum(),
       VectorIndexManager::GetVectorIndexTaskRunningNum(), Helper::TimestampMs() - start_time_, is_fast_load_);
 
+  if (!is_fast_load_) {
+    VectorIndexManager::WaitLoadConcurrency(vector_index_wrapper_);
+  }
+
   int64_t start_time = Helper::TimestampMs();
   VectorIndexManager::IncVectorIndexTaskRunningNum();
   if (is_fast_load_) {
@@ -524,6 +645,13 @@ void BuildVectorIndexTask::Run() {
     return;
   }
 
+  // Follower load the snapshot built by leader rather than build it again.
+  if (VectorIndexManager::PullSharedBuildSnapshot(vector_index_wrapper_, region->Epoch(), trace_) &&
+      VectorIndexManager::LoadVectorIndexOnly(vector_index_wrapper_, region->Epoch(), trace_).ok()) {
+    ADD_REGION_CHANGE_RECORD_TIMEPOINT(job_id_, fmt::format("Pulled vector index {} snapshot", region->Id()));
+    return;
+  }
+
   auto status = VectorIndexManager::BuildVectorIndexOnly(vector_index_wrapper_, region->Epoch(), trace_);
   if (!status.ok()) {
     ADD_REGION_CHANGE_RECORD_TIMEPOINT(job_id_, fmt::format("builded vector index {} failed", region->Id()));
@@ -576,6 +704,11 @@ bvar::Adder<uint64_t> VectorIndexManager::bvar_vector_index_load_catchup_total_n
 bvar::Adder<uint64_t> VectorIndexManager::bvar_vector_index_rebuild_catchup_total_num(
     "dingo_vector_index_rebuild_catchup_task_total_num");
 
+bvar::Adder<uint64_t> VectorIndexManager::bvar_vector_index_build_scan_vector_num(
+    "dingo_vector_index_build_scan_vector_num");
+bvar::Adder<uint64_t> VectorIndexManager::bvar_vector_index_build_add_vector_num(
+    "dingo_vector_index_build_add_vector_num");
+
 bvar::LatencyRecorder VectorIndexManager::bvar_vector_index_catchup_latency_first_rounds(
     "dingo_vector_index_catchup_latency_first_rounds");
 bvar::LatencyRecorder VectorIndexManager::bvar_vector_index_catchup_latency_last_round(
@@ -717,6 +850,20 @@ bool VectorIndexManager::Init() {
     return false;
   }
 
+  apply_workers_ = WorkerSet::New("vector_mgr_apply", FLAGS_vector_apply_worker_num, 0);
+  if (!apply_workers_->Init()) {
+    DINGO_LOG(ERROR) << "Init vector index manager apply worker set failed!";
+    return false;
+  }
+
+  if (FLAGS_vector_load_worker_num > 0) {
+    load_workers_ = PriorWorkerSet::New("vector_mgr_load", FLAGS_vector_load_worker_num, 0, false);
+    if (!load_workers_->Init()) {
+      DINGO_LOG(ERROR) << "Init vector index manager load worker set failed!";
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -727,10 +874,33 @@ void VectorIndexManager::Destroy() {
   if (fast_background_workers_ != nullptr) {
     fast_background_workers_->Destroy();
   }
+  if (apply_workers_ != nullptr) {
+    apply_workers_->Destroy();
+  }
+  if (load_workers_ != nullptr) {
+    load_workers_->Destroy();
+  }
 }
 
 // Load vector index for already exist vector index at bootstrap.
 // Priority load from snapshot, if snapshot not exist then load from original data.
+// Reject loading new vector index when memory exceed budget, instead of OOM.
+static butil::Status CheckVectorIndexMemoryBudget(int64_t vector_index_id, const std::string& trace) {
+  auto status = MemoryTracker::GetInstance().CheckBudget(MemoryTracker::Type::kVectorIndex, 0);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.load][index_id({})][trace({})] reject load, {}", vector_index_id,
+                                      trace, status.error_str());
+  }
+  return status;
+}
+
+// Account the loaded vector index at once, so the following loads see it before the periodic refresh.
+static void TrackVectorIndexMemory(VectorIndexWrapperPtr vector_index_wrapper) {
+  int64_t memory_size = 0;
+  vector_index_wrapper->GetMemorySize(memory_size);
+  MemoryTracker::GetInstance().Add(MemoryTracker::Type::kVectorIndex, memory_size);
+}
+
 butil::Status VectorIndexManager::LoadOrBuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
                                                          const pb::common::RegionEpoch& epoch,
                                                          const std::string& trace) {
@@ -739,13 +909,19 @@ butil::Status VectorIndexManager::LoadOrBuildVectorIndex(VectorIndexWrapperPtr v
   int64_t start_time = Helper::TimestampMs();
   int64_t vector_index_id = vector_index_wrapper->Id();
 
+  auto status = CheckVectorIndexMemoryBudget(vector_index_id, trace);
+  if (!status.ok()) {
+    return status;
+  }
+
   // try to load vector index from snapshot
-  auto status = LoadVectorIndex(vector_index_wrapper, epoch, fmt::format("LOAD.SNAPSHOT-{}", trace));
+  status = LoadVectorIndex(vector_index_wrapper, epoch, fmt::format("LOAD.SNAPSHOT-{}", trace));
   if (status.ok()) {
     DINGO_LOG(INFO) << fmt::format(
         "[vector_index.loadorbuild][index_id({})][trace({})] Load vector index from snapshot success, elapsed "
         "time({}ms)",
         vector_index_id, trace, Helper::TimestampMs() - start_time);
+    TrackVectorIndexMemory(vector_index_wrapper);
     return butil::Status();
   }
 
@@ -773,6 +949,7 @@ butil::Status VectorIndexManager::LoadOrBuildVectorIndex(VectorIndexWrapperPtr v
         vector_index_wrapper->Id(), trace, Helper::PrintStatus(status));
   }
 
+  TrackVectorIndexMemory(vector_index_wrapper);
   return butil::Status();
 }
 
@@ -786,13 +963,19 @@ butil::Status VectorIndexManager::LoadVectorIndexOnly(VectorIndexWrapperPtr vect
   int64_t start_time = Helper::TimestampMs();
   int64_t vector_index_id = vector_index_wrapper->Id();
 
+  auto status = CheckVectorIndexMemoryBudget(vector_index_id, trace);
+  if (!status.ok()) {
+    return status;
+  }
+
   // try to load vector index from snapshot
-  auto status = LoadVectorIndex(vector_index_wrapper, epoch, fmt::format("LOAD.SNAPSHOT-{}", trace));
+  status = LoadVectorIndex(vector_index_wrapper, epoch, fmt::format("LOAD.SNAPSHOT-{}", trace));
   if (status.ok()) {
     DINGO_LOG(INFO) << fmt::format(
         "[vector_index.loadorbuild][index_id({})][trace({})] Load vector index from snapshot success, elapsed "
         "time({}ms)",
         vector_index_id, trace, Helper::TimestampMs() - start_time);
+    TrackVectorIndexMemory(vector_index_wrapper);
     return butil::Status();
   }
 
@@ -816,8 +999,13 @@ butil::Status VectorIndexManager::BuildVectorIndexOnly(VectorIndexWrapperPtr vec
   DINGO_LOG(INFO) << fmt::format("[vector_index.buildonly][index_id({})][trace({})] build_vector_index_only start.",
                                  vector_index_id, trace);
 
+  auto status = CheckVectorIndexMemoryBudget(vector_index_id, trace);
+  if (!status.ok()) {
+    return status;
+  }
+
   // Build a new vector index from original data
-  auto status = RebuildVectorIndex(vector_index_wrapper, fmt::format("LOAD.REBUILD-{}", trace));
+  status = RebuildVectorIndex(vector_index_wrapper, fmt::format("LOAD.REBUILD-{}", trace));
   if (!status.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[vector_index.buildonly][index_id({})][trace({})] Rebuild vector index failed.",
                                     vector_index_id, trace);
@@ -839,6 +1027,7 @@ butil::Status VectorIndexManager::BuildVectorIndexOnly(VectorIndexWrapperPtr vec
   DINGO_LOG(INFO) << fmt::format("[vector_index.buildonly][index_id({})][trace({})] build_vector_index_only done.",
                                  vector_index_id, trace);
 
+  TrackVectorIndexMemory(vector_index_wrapper);
   return butil::Status();
 }
 
@@ -905,7 +1094,8 @@ void VectorIndexManager::LaunchLoadAsyncBuildVectorIndex(VectorIndexWrapperPtr v
   if (is_fast_load) {
     ret = Server::GetInstance().GetVectorIndexManager()->ExecuteTaskFast(vector_index_wrapper->Id(), task);
   } else {
-    ret = Server::GetInstance().GetVectorIndexManager()->ExecuteTask(vector_index_wrapper->Id(), task);
+    task->SetPriority(CalcLoadPriority(vector_index_wrapper));
+    ret = Server::GetInstance().GetVectorIndexManager()->ExecuteLoadTask(vector_index_wrapper->Id(), task);
   }
 
   if (!ret) {
@@ -929,6 +1119,17 @@ butil::Status VectorIndexManager::ParallelLoadOrBuildVectorIndex(std::vector<sto
     std::string trace;
   };
 
+  std::vector<std::pair<int32_t, store::RegionPtr>> prior_regions;
+  prior_regions.reserve(regions.size());
+  for (auto& region : regions) {
+    prior_regions.emplace_back(CalcLoadPriority(region->VectorIndexWrapper()), region);
+  }
+  std::stable_sort(prior_regions.begin(), prior_regions.end(),
+                   [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+  for (size_t i = 0; i < regions.size(); ++i) {
+    regions[i] = prior_regions[i].second;
+  }
+
   auto param = std::make_shared<Parameter>();
   param->regions = regions;
   param->offset = 0;
@@ -1136,6 +1337,7 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
   // load vector data to vector index
   IteratorOptions options;
   options.upper_bound = end_key;
+  options.readahead_size = FLAGS_vector_build_readahead_size;
 
   auto raw_engine = Server::GetInstance().GetRawEngine(region->GetRawEngineType());
   auto iter = raw_engine->Reader()->NewIterator(Constant::kVectorDataCF, options);
@@ -1162,7 +1364,30 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
   }
 
   int64_t count = 0;
-  int64_t upsert_use_time = 0;
+  std::atomic<int64_t> add_count = 0;
+  std::atomic<int64_t> upsert_use_time = 0;
+  auto add_batch = [&](const std::vector<pb::common::VectorWithId>& batch) {
+    int64_t upsert_start_time = Helper::TimestampMs();
+
+    vector_index->AddByParallel(batch, false);
+
+    int64_t this_upsert_time = Helper::TimestampMs() - upsert_start_time;
+    upsert_use_time.fetch_add(this_upsert_time);
+    add_count.fetch_add(batch.size());
+    bvar_vector_index_build_add_vector_num << batch.size();
+
+    DINGO_LOG(INFO) << fmt::format(
+        "[vector_index.build][index_id({})][trace({})] Build vector index progress, speed({:.3}) count({}) elapsed "
+        "time({}/{}ms)",
+        vector_index_id, trace, static_cast<double>(this_upsert_time) / batch.size(), add_count.load(),
+        upsert_use_time.load(), Helper::TimestampMs() - start_time);
+  };
+
+  // Pipeline scan and add, the full batch is added in a bthread while scanning the next batch.
+  bool is_pipeline = FLAGS_enable_vector_build_pipeline;
+  Bthread add_bthread;
+  bool is_adding = false;
+  std::vector<pb::common::VectorWithId> adding_vectors;
   std::vector<pb::common::VectorWithId> vectors;
   vectors.reserve(Constant::kBuildVectorIndexBatchSize);
   for (iter->Seek(start_key); iter->Valid(); iter->Next()) {
@@ -1171,47 +1396,56 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
     std::string key(iter->Key());
     vector.set_id(VectorCodec::DecodeVectorId(key));
 
-    std::string value(iter->Value());
-    if (!vector.mutable_vector()->ParseFromString(value)) {
+    if (!VectorCodec::DecodeVectorValue(iter->Value(), *vector.mutable_vector())) {
       DINGO_LOG(WARNING) << fmt::format(
           "[vector_index.build][index_id({})][trace({})] vector with id ParseFromString failed.", vector_index_id,
           trace);
       continue;
     }
 
-    if (vector.vector().float_values_size() <= 0) {
+    if (vector.vector().float_values_size() <= 0 && vector.vector().binary_values_size() <= 0) {
       DINGO_LOG(WARNING) << fmt::format("[vector_index.build][index_id({})][trace({})] vector values_size error.",
                                         vector_index_id, trace);
       continue;
     }
 
     ++count;
+    bvar_vector_index_build_scan_vector_num << 1;
 
-    vectors.push_back(vector);
-    if ((count + 1) % Constant::kBuildVectorIndexBatchSize == 0) {
-      int64_t upsert_start_time = Helper::TimestampMs();
-
-      vector_index->AddByParallel(vectors, false);
-
-      int32_t this_upsert_time = Helper::TimestampMs() - upsert_start_time;
-      upsert_use_time += this_upsert_time;
-
-      DINGO_LOG(INFO) << fmt::format(
-          "[vector_index.build][index_id({})][trace({})] Build vector index progress, speed({:.3}) count({}) elapsed "
-          "time({}/{}ms)",
-          vector_index_id, trace, static_cast<double>(this_upsert_time) / vectors.size(), count, upsert_use_time,
-          Helper::TimestampMs() - start_time);
+    vectors.push_back(std::move(vector));
+    if (vectors.size() >= Constant::kBuildVectorIndexBatchSize) {
+      if (is_pipeline) {
+        if (is_adding) {
+          add_bthread.Join();
+        }
+        adding_vectors.swap(vectors);
+        add_bthread.Run([&]() { add_batch(adding_vectors); });
+        is_adding = true;
+      } else {
+        add_batch(vectors);
+      }
 
       vectors.clear();
+      vectors.reserve(Constant::kBuildVectorIndexBatchSize);
       // yield, for other bthread run.
       bthread_yield();
     }
   }
 
+  if (is_adding) {
+    add_bthread.Join();
+  }
   if (!vectors.empty()) {
-    int64_t upsert_start_time = Helper::TimestampMs();
-    vector_index->AddByParallel(vectors, false);
-    upsert_use_time += (Helper::TimestampMs() - upsert_start_time);
+    add_batch(vectors);
+  }
+
+  if (FLAGS_enable_vector_index_optimize_layout) {
+    auto status = vector_index->OptimizeLayout();
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format(
+          "[vector_index.build][index_id({})][trace({})] optimize layout failed, error: {}", vector_index_id, trace,
+          Helper::PrintStatus(status));
+    }
   }
 
   DINGO_LOG(INFO) << fmt::format(
@@ -1220,7 +1454,121 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
       "elapsed time({}/{}ms)",
       vector_index_id, trace, vector_index->WriteOpParallelNum(), count,
       Helper::RegionEpochToString(vector_index->Epoch()), VectorCodec::DecodeRangeToString(vector_index->Range()),
-      upsert_use_time, Helper::TimestampMs() - start_time);
+      upsert_use_time.load(), Helper::TimestampMs() - start_time);
+
+  return vector_index;
+}
+
+// Get vector ids of kVectorDataCF in [start_key, end_key).
+static std::vector<int64_t> ScanVectorIds(RawEnginePtr raw_engine, const std::string& start_key,
+                                          const std::string& end_key) {
+  std::vector<int64_t> vector_ids;
+  if (start_key >= end_key) {
+    return vector_ids;
+  }
+
+  IteratorOptions options;
+  options.upper_bound = end_key;
+  auto iter = raw_engine->Reader()->NewIterator(Constant::kVectorDataCF, options);
+  if (iter == nullptr) {
+    return vector_ids;
+  }
+
+  for (iter->Seek(start_key); iter->Valid(); iter->Next()) {
+    vector_ids.push_back(VectorCodec::DecodeVectorId(std::string(iter->Key())));
+  }
+
+  return vector_ids;
+}
+
+std::shared_ptr<VectorIndex> VectorIndexManager::CloneSplitVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
+                                                                       const std::string& trace) {
+  int64_t vector_index_id = vector_index_wrapper->Id();
+
+  auto region = Server::GetInstance().GetRegion(vector_index_id);
+  if (region == nullptr) {
+    return nullptr;
+  }
+
+  // Child share the parent vector index, parent still own the vector index of before split.
+  auto source_vector_index = vector_index_wrapper->ShareVectorIndex();
+  if (source_vector_index == nullptr) {
+    source_vector_index = vector_index_wrapper->GetOwnVectorIndex();
+  }
+  if (source_vector_index == nullptr) {
+    return nullptr;
+  }
+
+  auto index_type = source_vector_index->VectorIndexType();
+  if (index_type != pb::common::VECTOR_INDEX_TYPE_HNSW && index_type != pb::common::VECTOR_INDEX_TYPE_FLAT) {
+    return nullptr;
+  }
+
+  const auto& range = region->Range();
+  const auto& source_range = source_vector_index->Range();
+  // Not split or source not cover the region range, e.g. rebuild for deleted ratio.
+  if ((source_range.start_key() == range.start_key() && source_range.end_key() == range.end_key()) ||
+      source_range.start_key() > range.start_key() || source_range.end_key() < range.end_key()) {
+    return nullptr;
+  }
+
+  int64_t start_time = Helper::TimestampMs();
+  std::string tmp_path = VectorIndexSnapshotManager::GetSnapshotTmpPath(vector_index_id);
+  auto status = Helper::CreateDirectories(tmp_path);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.clone][index_id({})][trace({})] create tmp path failed, error: {}",
+                                      vector_index_id, trace, Helper::PrintStatus(status));
+    return nullptr;
+  }
+  DEFER(Helper::RemoveAllFileOrDirectory(tmp_path););
+
+  // The vectors applied before apply log id are all in the source vector index, replay log after it is idempotent.
+  std::string index_filepath = fmt::format("{}/index_{}.idx", tmp_path, vector_index_id);
+  source_vector_index->LockWrite();
+  int64_t apply_log_id = vector_index_wrapper->ApplyLogId();
+  status = source_vector_index->Save(index_filepath);
+  source_vector_index->UnlockWrite();
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.clone][index_id({})][trace({})] save source failed, error: {}",
+                                      vector_index_id, trace, Helper::PrintStatus(status));
+    return nullptr;
+  }
+
+  auto vector_index =
+      VectorIndexFactory::New(vector_index_id, vector_index_wrapper->IndexParameter(), region->Epoch(), range);
+  if (vector_index == nullptr) {
+    return nullptr;
+  }
+  status = vector_index->Load(index_filepath);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.clone][index_id({})][trace({})] load clone failed, error: {}",
+                                      vector_index_id, trace, Helper::PrintStatus(status));
+    return nullptr;
+  }
+  vector_index->SetApplyLogId(apply_log_id);
+
+  // Vectors out of range belong to the sibling region, they are still in the local raw engine after split.
+  // The deleted slots are reclaimed by the background rebuild when deleted ratio is high.
+  auto raw_engine = Server::GetInstance().GetRawEngine(region->GetRawEngineType());
+  auto delete_ids = ScanVectorIds(raw_engine, source_range.start_key(), range.start_key());
+  auto right_ids = ScanVectorIds(raw_engine, range.end_key(), source_range.end_key());
+  delete_ids.insert(delete_ids.end(), right_ids.begin(), right_ids.end());
+  for (size_t i = 0; i < delete_ids.size(); i += Constant::kBuildVectorIndexBatchSize) {
+    size_t end = std::min(delete_ids.size(), i + Constant::kBuildVectorIndexBatchSize);
+    status = vector_index->Delete(std::vector<int64_t>(delete_ids.begin() + i, delete_ids.begin() + end), false);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[vector_index.clone][index_id({})][trace({})] delete failed, error: {}",
+                                        vector_index_id, trace, Helper::PrintStatus(status));
+      return nullptr;
+    }
+    bthread_yield();
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.clone][index_id({})][trace({})] Clone split vector index finish, log_id({}) delete count({}) "
+      "epoch({}) range({}) elapsed time({}ms)",
+      vector_index_id, trace, apply_log_id, delete_ids.size(), Helper::RegionEpochToString(region->Epoch()),
+      VectorCodec::DecodeRangeToString(range), Helper::TimestampMs() - start_time);
 
   return vector_index;
 }
@@ -1287,8 +1635,12 @@ butil::Status VectorIndexManager::RebuildVectorIndex(VectorIndexWrapperPtr vecto
                                  vector_index_id, vector_index_wrapper->Version(), trace);
 
   int64_t start_time = Helper::TimestampMs();
-  // Build vector index with original data.
-  auto vector_index = BuildVectorIndex(vector_index_wrapper, trace);
+  // Clone vector index of before split, otherwise build vector index with original data.
+  auto vector_index = FLAGS_enable_vector_index_split_clone ? CloneSplitVectorIndex(vector_index_wrapper, trace)
+                                                            : nullptr;
+  if (vector_index == nullptr) {
+    vector_index = BuildVectorIndex(vector_index_wrapper, trace);
+  }
   if (vector_index == nullptr) {
     DINGO_LOG(WARNING) << fmt::format("[vector_index.rebuild][index_id({})][trace({})] Build vector index failed.",
                                       vector_index_id, trace);
@@ -1501,6 +1853,19 @@ void VectorIndexManager::LaunchSaveVectorIndex(VectorIndexWrapperPtr vector_inde
   }
 }
 
+void VectorIndexManager::LaunchRepairVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
+                                                 const std::string& trace) {
+  assert(vector_index_wrapper != nullptr);
+
+  auto task = std::make_shared<RepairVectorIndexTask>(vector_index_wrapper, trace);
+  if (!Server::GetInstance().GetVectorIndexManager()->ExecuteTask(vector_index_wrapper->Id(), task)) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.launch][index_id({})][trace({})] Launch repair vector index failed",
+                                    vector_index_wrapper->Id(), trace);
+  } else {
+    vector_index_wrapper->IncPendingTaskNum();
+  }
+}
+
 butil::Status VectorIndexManager::ScrubVectorIndex() {
   auto regions = Server::GetInstance().GetAllAliveRegion();
   if (regions.empty()) {
@@ -1538,6 +1903,13 @@ butil::Status VectorIndexManager::ScrubVectorIndex() {
       continue;
     }
 
+    // repair in place reclaim the deleted vectors before the deleted ratio is high enough to rebuild.
+    if (vector_index_wrapper->PendingTaskNum() == 0 && vector_index_wrapper->NeedToRepair()) {
+      DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] need repair, do repair vector index.",
+                                     vector_index_id);
+      LaunchRepairVectorIndex(vector_index_wrapper, "from scrub");
+    }
+
     std::string trace;
     bool need_save = vector_index_wrapper->NeedToSave(trace);
     if (need_save && vector_index_wrapper->RebuildingNum() == 0 && vector_index_wrapper->SavingNum() == 0) {
@@ -1548,20 +1920,96 @@ butil::Status VectorIndexManager::ScrubVectorIndex() {
     }
   }
 
+  OffloadColdVectorIndex(regions);
+
   return butil::Status::OK();
 }
 
+void VectorIndexManager::OffloadColdVectorIndex(const std::vector<store::RegionPtr>& regions) {
+  if (FLAGS_vector_index_offload_memory_mb <= 0) {
+    return;
+  }
+
+  struct Candidate {
+    VectorIndexWrapperPtr vector_index_wrapper;
+    int64_t last_search_time_ms;
+    int64_t memory_size;
+  };
+
+  int64_t now_ms = Helper::TimestampMs();
+  int64_t total_memory_size = 0;
+  std::vector<Candidate> candidates;
+  for (const auto& region : regions) {
+    auto vector_index_wrapper = region->VectorIndexWrapper();
+    if (vector_index_wrapper == nullptr || !vector_index_wrapper->IsReady() || vector_index_wrapper->IsStop()) {
+      continue;
+    }
+
+    int64_t memory_size = 0;
+    if (!vector_index_wrapper->GetMemorySize(memory_size).ok()) {
+      continue;
+    }
+    total_memory_size += memory_size;
+
+    if (region->State() != pb::common::NORMAL ||
+        now_ms - vector_index_wrapper->LastSearchTimeMs() < FLAGS_vector_index_offload_idle_s * 1000) {
+      continue;
+    }
+    // the shared or sibling vector index is not in snapshot.
+    if (vector_index_wrapper->ShareVectorIndex() != nullptr || vector_index_wrapper->SiblingVectorIndex() != nullptr) {
+      continue;
+    }
+    if (vector_index_wrapper->PendingTaskNum() > 0 || vector_index_wrapper->PendingApplyNum() > 0 ||
+        vector_index_wrapper->LoadorbuildingNum() > 0 || vector_index_wrapper->RebuildingNum() > 0 ||
+        vector_index_wrapper->SavingNum() > 0) {
+      continue;
+    }
+    // need an up to date snapshot, otherwise reload is building from original data.
+    std::string reason;
+    auto snapshot_set = vector_index_wrapper->SnapshotSet();
+    if (!vector_index_wrapper->SupportSave() || snapshot_set == nullptr || snapshot_set->GetLastSnapshot() == nullptr ||
+        vector_index_wrapper->NeedToSave(reason)) {
+      continue;
+    }
+
+    candidates.push_back({vector_index_wrapper, vector_index_wrapper->LastSearchTimeMs(), memory_size});
+  }
+
+  int64_t memory_limit = FLAGS_vector_index_offload_memory_mb * 1024 * 1024;
+  if (total_memory_size <= memory_limit) {
+    return;
+  }
+
+  std::sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+    return lhs.last_search_time_ms < rhs.last_search_time_ms;
+  });
+
+  for (const auto& candidate : candidates) {
+    if (total_memory_size <= memory_limit) {
+      break;
+    }
+
+    DINGO_LOG(INFO) << fmt::format(
+        "[vector_index.offload][index_id({})] offload cold vector index, memory({}) total_memory({}) idle({}s).",
+        candidate.vector_index_wrapper->Id(), candidate.memory_size, total_memory_size,
+        (now_ms - candidate.last_search_time_ms) / 1000);
+
+    candidate.vector_index_wrapper->SetOffloaded(true);
+    candidate.vector_index_wrapper->ClearVectorIndex("offload cold");
+    total_memory_size -= candidate.memory_size;
+    g_vector_index_offload_count << 1;
+  }
+}
+
 butil::Status VectorIndexManager::TrainForBuild(std::shared_ptr<VectorIndex> vector_index,
                                                 std::shared_ptr<Iterator> iter, const std::string& start_key,
                                                 [[maybe_unused]] const std::string& end_key) {
-  int64_t count = 0;
-  std::vector<float> train_vectors;
-  train_vectors.reserve(100000 * vector_index->GetDimension());  // todo opt
+  // sample while scan, the train only need limited vectors.
+  TrainDataSampler sampler(vector_index->GetDimension(), vector_index->TrainSampleSize());
   for (iter->Seek(start_key); iter->Valid(); iter->Next()) {
     pb::common::VectorWithId vector;
 
-    std::string value(iter->Value());
-    if (!vector.mutable_vector()->ParseFromString(value)) {
+    if (!VectorCodec::DecodeVectorValue(iter->Value(), *vector.mutable_vector())) {
       std::string s =
           fmt::format("[vector_index.build][index_id({})] vector with id ParseFromString failed.", vector.id());
       DINGO_LOG(WARNING) << s;
@@ -1574,10 +2022,13 @@ butil::Status VectorIndexManager::TrainForBuild(std::shared_ptr<VectorIndex> vec
       continue;
     }
 
-    train_vectors.insert(train_vectors.end(), vector.vector().float_values().begin(),
-                         vector.vector().float_values().end());
+    sampler.Add(vector.vector());
   }
 
+  auto& train_vectors = sampler.Datas();
+  DINGO_LOG(INFO) << fmt::format("[vector_index.build][index_id({})] train sample count({}/{}).", vector_index->Id(),
+                                 train_vectors.size() / std::max(vector_index->GetDimension(), 1), sampler.Count());
+
   // if empty. ignore
   if (!train_vectors.empty()) {
     auto status = vector_index->Train(train_vectors);
@@ -1599,6 +2050,14 @@ bool VectorIndexManager::ExecuteTask(int64_t region_id, TaskRunnablePtr task) {
   return background_workers_->ExecuteHashByRegionId(region_id, task);
 }
 
+bool VectorIndexManager::ResizeBackgroundWorkers(uint32_t worker_num) {
+  if (background_workers_ == nullptr) {
+    return false;
+  }
+
+  return background_workers_->Resize(worker_num);
+}
+
 bool VectorIndexManager::ExecuteTaskFast(int64_t region_id, TaskRunnablePtr task) {
   if (fast_background_workers_ == nullptr) {
     return false;
@@ -1607,12 +2066,145 @@ bool VectorIndexManager::ExecuteTaskFast(int64_t region_id, TaskRunnablePtr task
   return fast_background_workers_->ExecuteHashByRegionId(region_id, task);
 }
 
+bool VectorIndexManager::PullSharedBuildSnapshot(VectorIndexWrapperPtr vector_index_wrapper,
+                                                 const pb::common::RegionEpoch& epoch, const std::string& trace) {
+  if (!FLAGS_enable_vector_index_shared_build) {
+    return false;
+  }
+
+  int64_t vector_index_id = vector_index_wrapper->Id();
+  auto snapshot_set = vector_index_wrapper->SnapshotSet();
+  int64_t start_time = Helper::TimestampMs();
+  for (;;) {
+    // leader is elected or changed during waiting, build by itself.
+    if (vector_index_wrapper->IsStop() || Server::GetInstance().IsLeader(vector_index_id)) {
+      return false;
+    }
+
+    auto last_snapshot = snapshot_set->GetLastSnapshot();
+    if (last_snapshot != nullptr && last_snapshot->Epoch().version() >= epoch.version()) {
+      break;
+    }
+
+    // the snapshot of leader is not match epoch until leader finish building.
+    auto status = VectorIndexSnapshotManager::PullLastSnapshotFromPeers(snapshot_set, epoch);
+    if (status.ok()) {
+      break;
+    }
+
+    if (Helper::TimestampMs() - start_time >= FLAGS_vector_index_shared_build_wait_s * 1000L) {
+      DINGO_LOG(WARNING) << fmt::format(
+          "[vector_index.sharedbuild][index_id({})][trace({})] wait leader snapshot timeout, build by itself, "
+          "error: {}",
+          vector_index_id, trace, Helper::PrintStatus(status));
+      return false;
+    }
+    bthread_usleep(FLAGS_vector_index_shared_build_pull_interval_ms * 1000L);
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.sharedbuild][index_id({})][trace({})] pull leader snapshot done, elapsed time({}ms).",
+      vector_index_id, trace, Helper::TimestampMs() - start_time);
+  return true;
+}
+
+bool VectorIndexManager::ExecuteLoadTask(int64_t region_id, TaskRunnablePtr task) {
+  if (load_workers_ == nullptr) {
+    return ExecuteTask(region_id, task);
+  }
+
+  return load_workers_->Execute(task);
+}
+
+int32_t VectorIndexManager::CalcLoadPriority(VectorIndexWrapperPtr vector_index_wrapper) {
+  int64_t region_id = vector_index_wrapper->Id();
+  int32_t priority = 0;
+  // leader serve the search.
+  if (Server::GetInstance().IsLeader(region_id)) {
+    priority += 4;
+  }
+  // load statistic is kept only when enable_load_split.
+  auto region_load = RegionLoadStatistics::GetInstance().GetRegionLoad(region_id);
+  if (region_load != nullptr && region_load->ReadQps() > 0) {
+    priority += 2;
+  }
+  // load snapshot is much faster than rebuild.
+  auto snapshot_set = vector_index_wrapper->SnapshotSet();
+  if (snapshot_set != nullptr && snapshot_set->GetLastSnapshot() != nullptr) {
+    priority += 1;
+  }
+
+  return priority;
+}
+
+void VectorIndexManager::WaitLoadConcurrency(VectorIndexWrapperPtr vector_index_wrapper) {
+  if (FLAGS_vector_load_worker_num <= 0) {
+    return;
+  }
+
+  // Loading reads snapshot files or scans vector data, give way to compaction when raw engine is under pressure.
+  int64_t start_time = Helper::TimestampMs();
+  for (;;) {
+    double pressure = WriteThrottler::GetInstance().Pressure();
+    int concurrency = std::max(1, static_cast<int>(FLAGS_vector_load_worker_num * (1.0 - pressure)));
+    if (GetVectorIndexSlowLoadTaskRunningNum() < concurrency || vector_index_wrapper->IsStop()) {
+      break;
+    }
+    bthread_usleep(FLAGS_vector_load_wait_interval_ms * 1000L);
+  }
+
+  int64_t elapsed_time = Helper::TimestampMs() - start_time;
+  if (elapsed_time > FLAGS_vector_load_wait_interval_ms) {
+    DINGO_LOG(INFO) << fmt::format("[vector_index.load][index_id({})] wait load concurrency {}ms.",
+                                   vector_index_wrapper->Id(), elapsed_time);
+  }
+}
+
+bool VectorIndexManager::AsyncApplyVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
+                                               std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                               std::vector<int64_t>& delete_ids, int64_t log_id) {
+  // The in place apply must be after all pending apply, e.g. disable async at runtime.
+  auto wait_pending_apply = [&](int32_t max_pending_count) {
+    while (vector_index_wrapper->PendingApplyNum() > max_pending_count) {
+      bthread_usleep(1000);
+    }
+  };
+
+  auto vector_index_manager = Server::GetInstance().GetVectorIndexManager();
+  if (!FLAGS_enable_async_vector_index_apply || vector_index_manager == nullptr ||
+      vector_index_manager->apply_workers_ == nullptr) {
+    wait_pending_apply(0);
+    return false;
+  }
+
+  // Backpressure of raft apply.
+  wait_pending_apply(std::max(FLAGS_vector_max_pending_apply_task_count - 1, 0));
+
+  vector_index_wrapper->IncPendingApplyNum();
+  auto task = std::make_shared<ApplyVectorIndexTask>(vector_index_wrapper, std::move(vector_with_ids),
+                                                     std::move(delete_ids), log_id);
+  if (!vector_index_manager->apply_workers_->ExecuteHashByRegionId(vector_index_wrapper->Id(), task)) {
+    DINGO_LOG(ERROR) << fmt::format(
+        "[vector_index.apply][index_id({})] execute apply task failed, downgrade to in_place execute, log_id: {}",
+        vector_index_wrapper->Id(), log_id);
+    task->Run();
+  }
+
+  return true;
+}
+
 std::vector<std::vector<std::string>> VectorIndexManager::GetPendingTaskTrace() {
   if (background_workers_ == nullptr) {
     return {};
   }
 
-  return background_workers_->GetPendingTaskTrace();
+  auto traces = background_workers_->GetPendingTaskTrace();
+  if (load_workers_ != nullptr) {
+    auto load_traces = load_workers_->GetPendingTaskTrace();
+    traces.insert(traces.end(), load_traces.begin(), load_traces.end());
+  }
+
+  return traces;
 }
 
 uint64_t VectorIndexManager::GetBackgroundPendingTaskCount() {
@@ -1620,7 +2212,12 @@ uint64_t VectorIndexManager::GetBackgroundPendingTaskCount() {
     return 0;
   }
 
-  return background_workers_->PendingTaskCount();
+  uint64_t count = background_workers_->PendingTaskCount();
+  if (load_workers_ != nullptr) {
+    count += load_workers_->PendingTaskCount();
+  }
+
+  return count;
 }
 
 }  // namespace dingodb
@@ -19,6 +19,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "butil/status.h"
@@ -74,6 +75,55 @@ class SaveVectorIndexTask : public TaskRunnable {
   int64_t start_time_;
 };
 
+// Repair vector index task, reconnect the neighbors of deleted vectors in place.
+class RepairVectorIndexTask : public TaskRunnable {
+ public:
+  RepairVectorIndexTask(VectorIndexWrapperPtr vector_index_wrapper, const std::string& trace)
+      : vector_index_wrapper_(vector_index_wrapper), trace_(trace) {
+    start_time_ = Helper::TimestampMs();
+  }
+  ~RepairVectorIndexTask() override = default;
+
+  std::string Type() override { return "REPAIR_VECTOR_INDEX"; }
+
+  void Run() override;
+
+  std::string Trace() override;
+
+ private:
+  VectorIndexWrapperPtr vector_index_wrapper_;
+  std::string trace_;
+  int64_t start_time_;
+};
+
+// Apply vector add/delete of raft log to vector index, the tasks of one vector index run in log order.
+class ApplyVectorIndexTask : public TaskRunnable {
+ public:
+  ApplyVectorIndexTask(VectorIndexWrapperPtr vector_index_wrapper,
+                       std::vector<pb::common::VectorWithId> vector_with_ids, std::vector<int64_t> delete_ids,
+                       int64_t log_id)
+      : vector_index_wrapper_(vector_index_wrapper),
+        vector_with_ids_(std::move(vector_with_ids)),
+        delete_ids_(std::move(delete_ids)),
+        log_id_(log_id) {
+    start_time_ = Helper::TimestampMs();
+  }
+  ~ApplyVectorIndexTask() override = default;
+
+  std::string Type() override { return "APPLY_VECTOR_INDEX"; }
+
+  void Run() override;
+
+  std::string Trace() override;
+
+ private:
+  VectorIndexWrapperPtr vector_index_wrapper_;
+  std::vector<pb::common::VectorWithId> vector_with_ids_;
+  std::vector<int64_t> delete_ids_;
+  int64_t log_id_;
+  int64_t start_time_;
+};
+
 // Load or build vector index task
 class LoadOrBuildVectorIndexTask : public TaskRunnable {
  public:
@@ -184,7 +234,7 @@ class VectorIndexManager {
                                               bool is_temp_hold_vector_index, bool is_fast_load, int64_t job_id,
                                               const std::string& trace);
 
-  // Parallel load or build vector index at server bootstrap.
+  // Parallel load or build vector index at server bootstrap, regions are loaded by priority.
   static butil::Status ParallelLoadOrBuildVectorIndex(std::vector<store::RegionPtr> regions, int concurrency,
                                                       const std::string& trace);
 
@@ -193,6 +243,9 @@ class VectorIndexManager {
   // Launch save vector index at execute queue.
   static void LaunchSaveVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, const std::string& trace);
 
+  // Launch repair vector index at execute queue.
+  static void LaunchRepairVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, const std::string& trace);
+
   // Invoke when server running.
   static butil::Status RebuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, const std::string& trace);
   // Launch rebuild vector index at execute queue.
@@ -203,6 +256,17 @@ class VectorIndexManager {
 
   static butil::Status ScrubVectorIndex();
 
+  // Offload the least recently searched vector indexes until the memory of loaded vector indexes is under
+  // vector_index_offload_memory_mb. Only the cold vector index with an up to date snapshot is offloaded, so reload is
+  // loading the snapshot and replaying the few logs.
+  static void OffloadColdVectorIndex(const std::vector<store::RegionPtr>& regions);
+
+  // Follower wait the leader to build and save the vector index of epoch, and pull the snapshot,
+  // so only leader spend cpu on building. Return false if need build by itself, e.g. it is leader,
+  // not enable_vector_index_shared_build or timeout.
+  static bool PullSharedBuildSnapshot(VectorIndexWrapperPtr vector_index_wrapper, const pb::common::RegionEpoch& epoch,
+                                      const std::string& trace);
+
   static bvar::Adder<uint64_t> bvar_vector_index_task_running_num;
   static bvar::Adder<uint64_t> bvar_vector_index_rebuild_task_running_num;
   static bvar::Adder<uint64_t> bvar_vector_index_save_task_running_num;
@@ -224,6 +288,9 @@ class VectorIndexManager {
   static bvar::Adder<uint64_t> bvar_vector_index_slow_build_task_total_num;
   static bvar::Adder<uint64_t> bvar_vector_index_load_catchup_total_num;
   static bvar::Adder<uint64_t> bvar_vector_index_rebuild_catchup_total_num;
+  // Progress of building vector index from original data.
+  static bvar::Adder<uint64_t> bvar_vector_index_build_scan_vector_num;
+  static bvar::Adder<uint64_t> bvar_vector_index_build_add_vector_num;
   static bvar::LatencyRecorder bvar_vector_index_catchup_latency_first_rounds;
   static bvar::LatencyRecorder bvar_vector_index_catchup_latency_last_round;
 
@@ -270,11 +337,28 @@ class VectorIndexManager {
 
   bool ExecuteTask(int64_t region_id, TaskRunnablePtr task);
   bool ExecuteTaskFast(int64_t region_id, TaskRunnablePtr task);
+  // Execute load task by priority when vector_load_worker_num > 0, otherwise same as ExecuteTask.
+  bool ExecuteLoadTask(int64_t region_id, TaskRunnablePtr task);
+
+  // Load priority of vector index, leader first, then hot region, then region with snapshot.
+  static int32_t CalcLoadPriority(VectorIndexWrapperPtr vector_index_wrapper);
+  // Wait until the running load tasks less than the concurrency allowed by write pressure of raw engine.
+  static void WaitLoadConcurrency(VectorIndexWrapperPtr vector_index_wrapper);
+
+  // Apply vector add(vector_with_ids) or delete(delete_ids) of raft log to vector index out of raft apply thread,
+  // when enable_async_vector_index_apply. Too many pending apply tasks of the vector index block the caller,
+  // which slow down raft apply. Return false if not applied async, then the caller apply in place.
+  static bool AsyncApplyVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
+                                    std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                    std::vector<int64_t>& delete_ids, int64_t log_id);
 
   std::vector<std::vector<std::string>> GetPendingTaskTrace();
 
   uint64_t GetBackgroundPendingTaskCount();
 
+  // Change the background worker num at runtime.
+  bool ResizeBackgroundWorkers(uint32_t worker_num);
+
  private:
   static butil::Status LoadVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, const pb::common::RegionEpoch& epoch,
                                        const std::string& trace);
@@ -282,6 +366,10 @@ class VectorIndexManager {
   // Invoke when server starting.
   static std::shared_ptr<VectorIndex> BuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
                                                        const std::string& trace);
+  // Clone the vector index of before split and delete the vectors out of region range, only hnsw and flat.
+  // Return nullptr if not split or clone fail, the caller should build from original data.
+  static std::shared_ptr<VectorIndex> CloneSplitVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
+                                                            const std::string& trace);
   // Catch up vector index.
   static butil::Status CatchUpLogToVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
                                                std::shared_ptr<VectorIndex> vector_index, const std::string& trace);
@@ -295,6 +383,10 @@ class VectorIndexManager {
   // Execute all vector index load/build/rebuild/save task.
   WorkerSetPtr background_workers_;
   WorkerSetPtr fast_background_workers_;
+  // Execute vector index slow load task by priority, only when vector_load_worker_num > 0.
+  PriorWorkerSetPtr load_workers_;
+  // Execute vector index apply task, hash by vector index id to keep log order.
+  WorkerSetPtr apply_workers_;
 };
 
 using VectorIndexManagerPtr = std::shared_ptr<VectorIndexManager>;
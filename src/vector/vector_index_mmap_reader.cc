@@ -0,0 +1,122 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_index_mmap_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include "faiss/impl/FaissAssert.h"
+#include "faiss/index_io.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(vector_index_load_use_mmap, true, "load vector index file by mmap");
+DEFINE_int64(vector_index_load_mmap_release_size, 64L * 1024L * 1024L,
+             "release the consumed pages of mmap every this size when load vector index");
+
+MmapIndexReader::MmapIndexReader(const std::string& path) {
+  name = path;
+
+  fd_ = open(path.c_str(), O_RDONLY);
+  FAISS_THROW_IF_NOT_FMT(fd_ >= 0, "could not open %s for reading: %s", path.c_str(), strerror(errno));
+
+  struct stat st;
+  if (fstat(fd_, &st) != 0) {
+    close(fd_);
+    FAISS_THROW_FMT("could not stat %s: %s", path.c_str(), strerror(errno));
+  }
+  size_ = st.st_size;
+  if (size_ == 0) {
+    return;
+  }
+
+  void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+  if (data == MAP_FAILED) {
+    close(fd_);
+    FAISS_THROW_FMT("could not mmap %s: %s", path.c_str(), strerror(errno));
+  }
+  data_ = static_cast<char*>(data);
+
+  // index file is read once from head to tail
+  madvise(data_, size_, MADV_SEQUENTIAL);
+  madvise(data_, size_, MADV_WILLNEED);
+}
+
+MmapIndexReader::~MmapIndexReader() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+size_t MmapIndexReader::operator()(void* ptr, size_t size, size_t nitems) {
+  if (size == 0 || nitems == 0) {
+    return 0;
+  }
+
+  nitems = std::min(nitems, (size_ - offset_) / size);
+  if (nitems == 0) {
+    return 0;
+  }
+  size_t bytes = size * nitems;
+  memcpy(ptr, data_ + offset_, bytes);
+  offset_ += bytes;
+
+  // drop the consumed pages from mapping, the page cache is kept.
+  size_t page_size = sysconf(_SC_PAGESIZE);
+  size_t release_end = offset_ / page_size * page_size;
+  if (release_end - released_offset_ >= static_cast<size_t>(FLAGS_vector_index_load_mmap_release_size)) {
+    madvise(data_ + released_offset_, release_end - released_offset_, MADV_DONTNEED);
+    released_offset_ = release_end;
+  }
+
+  return nitems;
+}
+
+faiss::Index* MmapIndexReader::ReadIndex(const std::string& path, int io_flags) {
+  if (!FLAGS_vector_index_load_use_mmap) {
+    return faiss::read_index(path.c_str(), io_flags);
+  }
+
+  MmapIndexReader reader(path);
+  return faiss::read_index(&reader, io_flags);
+}
+
+void MmapIndexReader::Prefetch(const std::string& path) {
+  if (!FLAGS_vector_index_load_use_mmap) {
+    return;
+  }
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  close(fd);
+}
+
+}  // namespace dingodb
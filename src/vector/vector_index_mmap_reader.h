@@ -0,0 +1,61 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_INDEX_MMAP_READER_H_  // NOLINT
+#define DINGODB_VECTOR_INDEX_MMAP_READER_H_
+
+#include <cstddef>
+#include <string>
+
+#include "faiss/Index.h"
+#include "faiss/impl/io.h"
+
+namespace dingodb {
+
+// Read vector index file through mmap instead of stdio.
+// The pages come from page cache directly, a snapshot file read by the last start or by other replicas
+// on the same node is not read from disk again, and there is no stdio buffer copy.
+// The consumed pages are dropped from the mapping, so the load does not hold the file and the index twice.
+class MmapIndexReader : public faiss::IOReader {
+ public:
+  explicit MmapIndexReader(const std::string& path);
+  ~MmapIndexReader() override;
+
+  MmapIndexReader(const MmapIndexReader& rhs) = delete;
+  MmapIndexReader& operator=(const MmapIndexReader& rhs) = delete;
+
+  // same semantics as fread
+  size_t operator()(void* ptr, size_t size, size_t nitems) override;
+
+  size_t Size() const { return size_; }
+
+  // Read faiss index, use mmap if FLAGS_vector_index_load_use_mmap, otherwise faiss::read_index.
+  // Throw faiss::FaissException when failed, same as faiss::read_index.
+  static faiss::Index* ReadIndex(const std::string& path, int io_flags = 0);
+
+  // Hint the kernel to read ahead the whole file, for the loaders not go through faiss IOReader, e.g. hnswlib.
+  static void Prefetch(const std::string& path);
+
+ private:
+  int fd_{-1};
+  char* data_{nullptr};
+  size_t size_{0};
+  size_t offset_{0};
+  // the pages before it are released
+  size_t released_offset_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_INDEX_MMAP_READER_H_  // NOLINT
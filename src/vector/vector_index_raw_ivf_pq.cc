@@ -29,22 +29,36 @@
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
 #include "common/constant.h"
+#include "common/helper.h"
 #include "common/logging.h"
+#include "faiss/Clustering.h"
 #include "faiss/Index.h"
 #include "faiss/IndexFlat.h"
+#include "faiss/IndexIVFPQFastScan.h"
 #include "faiss/MetricType.h"
 #include "faiss/impl/AuxIndexStructures.h"
+#include "faiss/impl/ProductQuantizer.h"
 #include "faiss/index_io.h"
 #include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "proto/debug.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
+#include "vector/vector_index_mmap_reader.h"
+#include "vector/vector_index_train.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
 
 DEFINE_int64(ivf_pq_need_save_count, 10000, "ivf pq need save count");
+DEFINE_int64(ivf_pq_fast_scan_filter_candidate_ratio, 8,
+             "ivf pq fast scan search topk * ratio candidates and filter them when search with filter");
+DEFINE_bool(ivf_pq_enable_rebalance, true, "rebalance the skewed inverted lists of ivf pq in background");
+DEFINE_double(ivf_pq_rebalance_split_ratio, 4.0, "split the inverted list larger than average list size * ratio");
+DEFINE_double(ivf_pq_rebalance_merge_ratio, 0.1, "merge the inverted list smaller than average list size * ratio");
+DEFINE_int64(ivf_pq_rebalance_min_split_size, 1000, "not split the inverted list smaller than it");
+DEFINE_int64(ivf_pq_rebalance_max_move_count, 200000, "max count of vectors re-encoded by one rebalance");
+DEFINE_int64(ivf_pq_rebalance_interval_s, 600, "min interval of rebalancing the same ivf pq index");
 
 VectorIndexRawIvfPq::VectorIndexRawIvfPq(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
                                          const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
@@ -75,6 +89,11 @@ VectorIndexRawIvfPq::VectorIndexRawIvfPq(int64_t id, const pb::common::VectorInd
     nbits_per_idx_ = Constant::kCreateIvfPqParamNbitsPerIdx;
   }
 
+  use_fast_scan_ = vector_index_parameter.ivf_pq_parameter().use_fast_scan();
+  if (use_fast_scan_) {
+    nbits_per_idx_ = Constant::kCreateIvfPqParamFastScanNbitsPerIdx;
+  }
+
   normalize_ = false;
 
   if (pb::common::MetricType::METRIC_TYPE_COSINE == metric_type_) {
@@ -82,7 +101,13 @@ VectorIndexRawIvfPq::VectorIndexRawIvfPq(int64_t id, const pb::common::VectorInd
   }
 
   train_data_size_ = 0;
+  last_rebalance_time_ms_ = 0;
   // Delay object creation.
+
+  // faiss gpu has no fast scan index
+  if (vector_index_parameter.ivf_pq_parameter().use_gpu() && !use_fast_scan_) {
+    gpu_replica_ = std::make_unique<GpuIndexReplica>(id);
+  }
 }
 
 VectorIndexRawIvfPq::~VectorIndexRawIvfPq() { bthread_mutex_destroy(&mutex_); }
@@ -117,6 +142,9 @@ butil::Status VectorIndexRawIvfPq::AddOrUpsert(const std::vector<pb::common::Vec
     index_->remove_ids(sel);
   }
   index_->add_with_ids(vector_with_ids.size(), vectors.get(), ids.get());
+  if (gpu_replica_ != nullptr) {
+    gpu_replica_->MarkStale();
+  }
 
   return butil::Status::OK();
 }
@@ -172,6 +200,9 @@ butil::Status VectorIndexRawIvfPq::Delete(const std::vector<int64_t>& delete_ids
     }
 
     auto remove_count = index_->remove_ids(sel);
+    if (gpu_replica_ != nullptr) {
+      gpu_replica_->MarkStale();
+    }
     if (0 == remove_count) {
       DINGO_LOG(ERROR) << fmt::format("not found id : {}", id);
       return butil::Status(pb::error::Errno::EVECTOR_INVALID, fmt::format("not found : {}", id));
@@ -206,7 +237,7 @@ butil::Status VectorIndexRawIvfPq::Search(const std::vector<pb::common::VectorWi
   std::vector<faiss::idx_t> labels;
   labels.resize(topk * vector_with_ids.size(), -1);
 
-  const auto& [vectors, status] = VectorIndexUtils::CheckAndCopyVectorData(vector_with_ids, dimension_, normalize_);
+  const auto& [vectors, status] = VectorIndexUtils::CheckAndViewVectorData(vector_with_ids, dimension_, normalize_);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
@@ -235,15 +266,26 @@ butil::Status VectorIndexRawIvfPq::Search(const std::vector<pb::common::VectorWi
     ivf_search_parameters.max_codes = 0;
     ivf_search_parameters.quantizer_params = nullptr;  // search for nlist . ignore
 
-    if (!filters.empty()) {
+    SearchThreadGuard thread_guard;
+    if (use_fast_scan_) {
+      auto ivf_pq_filter = filters.empty() ? nullptr : std::make_shared<RawIvfPqIDSelector>(filters);
+      FastScanSearch(vector_with_ids.size(), vectors.get(), topk, nprobe, ivf_pq_filter.get(), distances.data(),
+                     labels.data());
+    } else if (!filters.empty()) {
       auto ivf_pq_filter = filters.empty() ? nullptr : std::make_shared<RawIvfPqIDSelector>(filters);
       ivf_search_parameters.sel = ivf_pq_filter.get();
       index_->search(vector_with_ids.size(), vectors.get(), topk, distances.data(), labels.data(),
                      &ivf_search_parameters);
-    } else {
+    } else if (gpu_replica_ == nullptr || !gpu_replica_->Search(vector_with_ids.size(), vectors.get(), topk,
+                                                                 distances.data(), labels.data(), nprobe)) {
       index_->search(vector_with_ids.size(), vectors.get(), topk, distances.data(), labels.data(),
                      &ivf_search_parameters);
     }
+
+    // Estimated by the average list size.
+    int64_t probed_lists = static_cast<int64_t>(vector_with_ids.size()) * nprobe;
+    AddSearchStats(index_->nlist > 0 ? probed_lists * index_->ntotal / static_cast<int64_t>(index_->nlist) : 0, 0,
+                   probed_lists);
   }
 
   VectorIndexUtils::FillSearchResult(vector_with_ids, topk, distances, labels, metric_type_, dimension_, results);
@@ -263,13 +305,19 @@ butil::Status VectorIndexRawIvfPq::RangeSearch(const std::vector<pb::common::Vec
     return butil::Status::OK();
   }
 
+  if (use_fast_scan_) {
+    std::string s = fmt::format("ivf pq fast scan not support range search");
+    DINGO_LOG(WARNING) << s;
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, s);
+  }
+
   int32_t nprobe = parameter.ivf_pq().nprobe();
   if (BAIDU_UNLIKELY(nprobe <= 0)) {
     DINGO_LOG(WARNING) << fmt::format("pb::common::VectorSearchParameter ivf_pq nprobe : {} <=0. use default", nprobe);
     nprobe = Constant::kSearchIvfPqParamNprobe;
   }
 
-  const auto& [vectors, status] = VectorIndexUtils::CheckAndCopyVectorData(vector_with_ids, dimension_, normalize_);
+  const auto& [vectors, status] = VectorIndexUtils::CheckAndViewVectorData(vector_with_ids, dimension_, normalize_);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
@@ -277,7 +325,7 @@ butil::Status VectorIndexRawIvfPq::RangeSearch(const std::vector<pb::common::Vec
 
   // fix lambda can not capture rvalue. change rvalue -> lvalue.
   // c++ 20 fix this bug.
-  const std::unique_ptr<float[]>& vectors2 = vectors;
+  const VectorDataView& vectors2 = vectors;
 
   std::unique_ptr<faiss::RangeSearchResult> range_search_result =
       std::make_unique<faiss::RangeSearchResult>(vector_with_ids.size());
@@ -312,6 +360,7 @@ butil::Status VectorIndexRawIvfPq::RangeSearch(const std::vector<pb::common::Vec
     ivf_search_parameters.max_codes = 0;
     ivf_search_parameters.quantizer_params = nullptr;  // search for nlist . ignore
 
+    SearchThreadGuard thread_guard;
     try {
       if (!filters.empty()) {
         auto ivf_pq_filter = filters.empty() ? nullptr : std::make_shared<RawIvfPqIDSelector>(filters);
@@ -377,7 +426,7 @@ butil::Status VectorIndexRawIvfPq::Load(const std::string& path) {
   // The outside has been locked. Remove the locking operation here.
   faiss::Index* internal_raw_index = nullptr;
   try {
-    internal_raw_index = faiss::read_index(path.c_str(), 0);
+    internal_raw_index = MmapIndexReader::ReadIndex(path);
 
   } catch (std::exception& e) {
     std::string s =
@@ -387,20 +436,35 @@ butil::Status VectorIndexRawIvfPq::Load(const std::string& path) {
     return butil::Status(pb::error::Errno::EINTERNAL, s);
   }
 
-  faiss::IndexIVFPQ* internal_index = dynamic_cast<faiss::IndexIVFPQ*>(internal_raw_index);
+  faiss::IndexIVF* internal_index = nullptr;
+  const faiss::ProductQuantizer* internal_pq = nullptr;
+  if (use_fast_scan_) {
+    auto* fast_scan_index = dynamic_cast<faiss::IndexIVFPQFastScan*>(internal_raw_index);
+    if (fast_scan_index != nullptr) {
+      internal_index = fast_scan_index;
+      internal_pq = &fast_scan_index->pq;
+    }
+  } else {
+    auto* ivf_pq_index = dynamic_cast<faiss::IndexIVFPQ*>(internal_raw_index);
+    if (ivf_pq_index != nullptr) {
+      internal_index = ivf_pq_index;
+      internal_pq = &ivf_pq_index->pq;
+    }
+  }
   if (BAIDU_UNLIKELY(!internal_index)) {
     if (internal_raw_index) {
       delete internal_raw_index;
       internal_raw_index = nullptr;
     }
     std::string s =
-        fmt::format("VectorIndexRawIvfPq::Load faiss::read_index failed. Maybe not IndexIVFPq.  path : {} ", path);
+        fmt::format("VectorIndexRawIvfPq::Load faiss::read_index failed. Maybe not IndexIVFPq{}.  path : {} ",
+                    use_fast_scan_ ? "FastScan" : "", path);
     DINGO_LOG(ERROR) << s;
     return butil::Status(pb::error::Errno::EINTERNAL, s);
   }
 
   // avoid mem leak!!!
-  std::unique_ptr<faiss::IndexIVFPQ> internal_index_ivf_pq(internal_index);
+  std::unique_ptr<faiss::IndexIVF> internal_index_ivf_pq(internal_index);
 
   // double check
   if (BAIDU_UNLIKELY(internal_index->d != dimension_)) {
@@ -460,21 +524,24 @@ butil::Status VectorIndexRawIvfPq::Load(const std::string& path) {
     return butil::Status(pb::error::Errno::EINTERNAL, s);
   }
 
-  if (BAIDU_UNLIKELY(internal_index->pq.M != nsubvector_)) {
+  if (BAIDU_UNLIKELY(internal_pq->M != nsubvector_)) {
     std::string s = fmt::format("VectorIndexRawIvfPq::Load load pq.M : {} !=  (nsubvector_:{}). path : {}",
-                                internal_index->pq.M, nsubvector_, path);
+                                internal_pq->M, nsubvector_, path);
     DINGO_LOG(ERROR) << s;
     return butil::Status(pb::error::Errno::EINTERNAL, s);
   }
 
-  if (BAIDU_UNLIKELY(internal_index->pq.nbits != nbits_per_idx_)) {
+  if (BAIDU_UNLIKELY(internal_pq->nbits != nbits_per_idx_)) {
     std::string s = fmt::format("VectorIndexRawIvfPq::Load load pq.nbits : {} !=  (nbits_per_idx_:{}). path : {}",
-                                internal_index->pq.nbits, nbits_per_idx_, path);
+                                internal_pq->nbits, nbits_per_idx_, path);
     DINGO_LOG(ERROR) << s;
     return butil::Status(pb::error::Errno::EINTERNAL, s);
   }
 
   quantizer_.reset();
+  if (gpu_replica_ != nullptr) {
+    gpu_replica_->MarkStale();
+  }
   index_ = std::move(internal_index_ivf_pq);
 
   train_data_size_ = index_->ntotal;
@@ -525,12 +592,13 @@ butil::Status VectorIndexRawIvfPq::GetMemorySize(int64_t& memory_size) {
 
   auto capacity = index_->ntotal * index_->code_size + index_->ntotal * sizeof(faiss::idx_t) +
                   index_->nlist * index_->d * sizeof(float);
-  auto centroid_table = index_->pq.M * index_->pq.ksub * index_->pq.dsub * sizeof(float);
+  const auto* pq = GetProductQuantizer();
+  auto centroid_table = pq->M * pq->ksub * pq->dsub * sizeof(float);
 
   memory_size += (capacity + centroid_table);
 
   if (faiss::METRIC_L2 == index_->metric_type) {
-    auto precomputed_table = index_->nlist * index_->pq.M * index_->pq.ksub * sizeof(float);
+    auto precomputed_table = index_->nlist * pq->M * pq->ksub * sizeof(float);
     memory_size += precomputed_table;
   }
 
@@ -566,6 +634,15 @@ butil::Status VectorIndexRawIvfPq::Train(const std::vector<float>& train_datas)
   // init index
   Init();
 
+  // reuse the centroids of the same partition, faiss skip clustering the quantizer which is full.
+  auto centroid_key = CentroidCache::GenKey(Range(), vector_index_parameter, nlist_);
+  std::vector<float> centroids;
+  bool reuse_centroids = CentroidCache::GetInstance().Get(centroid_key, data_size, centroids) &&
+                         centroids.size() == static_cast<size_t>(nlist_ * dimension_);
+  if (reuse_centroids) {
+    quantizer_->add(nlist_, centroids.data());
+  }
+
   train_data_size_ = 0;
 
   float* train_datas_ptr = const_cast<float*>(train_datas.data());
@@ -589,6 +666,7 @@ butil::Status VectorIndexRawIvfPq::Train(const std::vector<float>& train_datas)
   }
 
   try {
+    TrainThreadGuard thread_guard;
     index_->train(data_size, train_datas_ptr);
   } catch (std::exception& e) {
     Reset();
@@ -610,6 +688,14 @@ butil::Status VectorIndexRawIvfPq::Train(const std::vector<float>& train_datas)
 
   train_data_size_ = data_size;
 
+  if (!reuse_centroids) {
+    auto* flat_quantizer = dynamic_cast<faiss::IndexFlat*>(quantizer_.get());
+    if (flat_quantizer != nullptr && flat_quantizer->ntotal == static_cast<faiss::idx_t>(nlist_)) {
+      const float* xb = flat_quantizer->get_xb();
+      CentroidCache::GetInstance().Put(centroid_key, data_size, std::vector<float>(xb, xb + nlist_ * dimension_));
+    }
+  }
+
   return butil::Status::OK();
 }
 
@@ -638,7 +724,14 @@ bool VectorIndexRawIvfPq::NeedToRebuild() {
     return false;
   }
 
-  return (index_->ntotal / 2) >= train_data_size_;
+  // the train data is sampled up to the size of k-means used, more data not change the training.
+  faiss::ClusteringParameters clustering_parameters;
+  faiss::idx_t train_nlist_size = clustering_parameters.max_points_per_centroid * nlist_;
+  faiss::ProductQuantizer pq = faiss::ProductQuantizer(dimension_, nsubvector_, nbits_per_idx_);
+  faiss::idx_t train_subvector_size = pq.cp.max_points_per_centroid * (1 << nbits_per_idx_);
+
+  return (index_->ntotal / 2) >= train_data_size_ &&
+         train_data_size_ < std::max(train_nlist_size, train_subvector_size);
 }
 
 bool VectorIndexRawIvfPq::IsTrained() {
@@ -669,26 +762,104 @@ bool VectorIndexRawIvfPq::NeedToSave(int64_t last_save_log_behind) {
   return false;
 }
 
+bool VectorIndexRawIvfPq::NeedToRepair() {
+  if (gpu_replica_ != nullptr && gpu_replica_->NeedToSync()) {
+    return true;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  return DoNeedToRebalance();
+}
+
+butil::Status VectorIndexRawIvfPq::Repair() {
+  bool need_to_rebalance = false;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    need_to_rebalance = DoNeedToRebalance();
+  }
+  if (need_to_rebalance) {
+    auto status = Rebalance();
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.raw_ivf_pq][id({})] rebalance failed, {}", Id(),
+                                      status.error_cstr());
+    }
+  }
+
+  if (gpu_replica_ == nullptr) {
+    return butil::Status::OK();
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  return gpu_replica_->Sync(DoIsTrained() ? index_.get() : nullptr);
+}
+
+std::vector<std::pair<size_t, size_t>> VectorIndexRawIvfPq::PlanRebalance(const std::vector<size_t>& list_sizes,
+                                                                          double split_ratio, double merge_ratio,
+                                                                          size_t min_split_size,
+                                                                          int64_t max_move_count) {
+  std::vector<std::pair<size_t, size_t>> plans;
+  if (list_sizes.size() < 2) {
+    return plans;
+  }
+
+  size_t total = 0;
+  for (auto list_size : list_sizes) {
+    total += list_size;
+  }
+  double average = static_cast<double>(total) / list_sizes.size();
+
+  std::vector<size_t> split_lists;
+  std::vector<size_t> merge_lists;
+  for (size_t i = 0; i < list_sizes.size(); ++i) {
+    if (list_sizes[i] >= min_split_size && list_sizes[i] > average * split_ratio) {
+      split_lists.push_back(i);
+    } else if (list_sizes[i] < average * merge_ratio) {
+      merge_lists.push_back(i);
+    }
+  }
+
+  // the largest lists are split by the smallest lists first
+  std::sort(split_lists.begin(), split_lists.end(),
+            [&](size_t lhs, size_t rhs) { return list_sizes[lhs] > list_sizes[rhs]; });
+  std::sort(merge_lists.begin(), merge_lists.end(),
+            [&](size_t lhs, size_t rhs) { return list_sizes[lhs] < list_sizes[rhs]; });
+
+  int64_t move_count = 0;
+  for (size_t i = 0; i < split_lists.size() && i < merge_lists.size(); ++i) {
+    move_count += list_sizes[split_lists[i]] + list_sizes[merge_lists[i]];
+    // the first one is always planned, otherwise a list larger than the budget is never split.
+    if (!plans.empty() && move_count > max_move_count) {
+      break;
+    }
+    plans.emplace_back(split_lists[i], merge_lists[i]);
+  }
+
+  return plans;
+}
+
 void VectorIndexRawIvfPq::Init() {
+  faiss::MetricType metric_type = faiss::MetricType::METRIC_L2;
   if (pb::common::MetricType::METRIC_TYPE_L2 == metric_type_) {
     quantizer_ = std::make_unique<faiss::IndexFlatL2>(dimension_);
-    index_ = std::make_unique<faiss::IndexIVFPQ>(quantizer_.get(), dimension_, nlist_, nsubvector_, nbits_per_idx_,
-                                                 faiss::METRIC_L2);
   } else if (pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT == metric_type_) {
     quantizer_ = std::make_unique<faiss::IndexFlatIP>(dimension_);
-    index_ = std::make_unique<faiss::IndexIVFPQ>(quantizer_.get(), dimension_, nlist_, nsubvector_, nbits_per_idx_,
-                                                 faiss::MetricType::METRIC_INNER_PRODUCT);
+    metric_type = faiss::MetricType::METRIC_INNER_PRODUCT;
   } else if (pb::common::MetricType::METRIC_TYPE_COSINE == metric_type_) {
     normalize_ = true;
     quantizer_ = std::make_unique<faiss::IndexFlatIP>(dimension_);
-    index_ = std::make_unique<faiss::IndexIVFPQ>(quantizer_.get(), dimension_, nlist_, nsubvector_, nbits_per_idx_,
-                                                 faiss::MetricType::METRIC_INNER_PRODUCT);
+    metric_type = faiss::MetricType::METRIC_INNER_PRODUCT;
   } else {
     DINGO_LOG(WARNING) << fmt::format("ivf pq : not support metric type : {} use L2 default",
                                       static_cast<int>(metric_type_));
     quantizer_ = std::make_unique<faiss::IndexFlatL2>(dimension_);
+  }
+
+  if (use_fast_scan_) {
+    index_ = std::make_unique<faiss::IndexIVFPQFastScan>(quantizer_.get(), dimension_, nlist_, nsubvector_,
+                                                         nbits_per_idx_, metric_type);
+  } else {
     index_ = std::make_unique<faiss::IndexIVFPQ>(quantizer_.get(), dimension_, nlist_, nsubvector_, nbits_per_idx_,
-                                                 faiss::MetricType::METRIC_L2);
+                                                 metric_type);
   }
 }
 
@@ -704,4 +875,175 @@ void VectorIndexRawIvfPq::Reset() {
   index_->reset();
 }
 
+std::vector<size_t> VectorIndexRawIvfPq::ListSizes() const {
+  std::vector<size_t> list_sizes(index_->nlist);
+  for (size_t i = 0; i < index_->nlist; ++i) {
+    list_sizes[i] = index_->invlists->list_size(i);
+  }
+  return list_sizes;
+}
+
+bool VectorIndexRawIvfPq::DoNeedToRebalance() {
+  if (!FLAGS_ivf_pq_enable_rebalance || BAIDU_UNLIKELY(!DoIsTrained())) {
+    return false;
+  }
+  if (Helper::TimestampMs() - last_rebalance_time_ms_ < FLAGS_ivf_pq_rebalance_interval_s * 1000) {
+    return false;
+  }
+
+  return !PlanRebalance(ListSizes(), FLAGS_ivf_pq_rebalance_split_ratio, FLAGS_ivf_pq_rebalance_merge_ratio,
+                        FLAGS_ivf_pq_rebalance_min_split_size, FLAGS_ivf_pq_rebalance_max_move_count)
+              .empty();
+}
+
+butil::Status VectorIndexRawIvfPq::Rebalance() {
+  int64_t start_time = Helper::TimestampMs();
+
+  std::vector<std::pair<size_t, size_t>> plans;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (BAIDU_UNLIKELY(!DoIsTrained())) {
+      return butil::Status::OK();
+    }
+    last_rebalance_time_ms_ = start_time;
+    plans = PlanRebalance(ListSizes(), FLAGS_ivf_pq_rebalance_split_ratio, FLAGS_ivf_pq_rebalance_merge_ratio,
+                          FLAGS_ivf_pq_rebalance_min_split_size, FLAGS_ivf_pq_rebalance_max_move_count);
+  }
+
+  // lock per list pair, search and write wait for one pair at most.
+  int64_t move_count = 0;
+  for (const auto& [split_list, merge_list] : plans) {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (BAIDU_UNLIKELY(!DoIsTrained())) {
+      break;
+    }
+
+    auto status = RebalanceList(split_list, merge_list, move_count);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.raw_ivf_pq][id({})] rebalance finish, list_pairs({}) move_count({}) elapsed_time({}ms)", Id(),
+      plans.size(), move_count, Helper::TimestampMs() - start_time);
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexRawIvfPq::RebalanceList(size_t split_list, size_t merge_list, int64_t& move_count) {
+  auto* flat_quantizer = dynamic_cast<faiss::IndexFlat*>(index_->quantizer);
+  if (BAIDU_UNLIKELY(flat_quantizer == nullptr || flat_quantizer->ntotal != static_cast<faiss::idx_t>(nlist_))) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "quantizer is not flat, not support rebalance");
+  }
+
+  size_t split_size = index_->invlists->list_size(split_list);
+  size_t merge_size = index_->invlists->list_size(merge_list);
+  if (split_size < 2) {
+    return butil::Status::OK();
+  }
+
+  // the codes are residuals to the current centroids, decode before the centroids are changed.
+  size_t n = split_size + merge_size;
+  std::vector<faiss::idx_t> ids(n);
+  std::vector<float> vectors(n * dimension_);
+  try {
+    size_t i = 0;
+    for (auto list_no : {split_list, merge_list}) {
+      for (size_t offset = 0; offset < index_->invlists->list_size(list_no); ++offset, ++i) {
+        ids[i] = index_->invlists->get_single_id(list_no, offset);
+        index_->reconstruct_from_offset(list_no, offset, vectors.data() + i * dimension_);
+      }
+    }
+  } catch (std::exception& e) {
+    return butil::Status(pb::error::Errno::EINTERNAL, fmt::format("decode inverted list exception : {}", e.what()));
+  }
+
+  faiss::IndexFlat assign_index(dimension_, index_->metric_type);
+  faiss::Clustering clustering(dimension_, 2);
+  try {
+    TrainThreadGuard thread_guard;
+    clustering.train(split_size, vectors.data(), assign_index);
+  } catch (std::exception& e) {
+    return butil::Status(pb::error::Errno::EINTERNAL, fmt::format("split inverted list exception : {}", e.what()));
+  }
+  if (BAIDU_UNLIKELY(clustering.centroids.size() != static_cast<size_t>(2 * dimension_))) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "split inverted list failed, centroids size mismatch");
+  }
+
+  float* xb = flat_quantizer->get_xb();
+  std::copy_n(clustering.centroids.data(), dimension_, xb + split_list * dimension_);
+  std::copy_n(clustering.centroids.data() + dimension_, dimension_, xb + merge_list * dimension_);
+
+  index_->invlists->resize(split_list, 0);
+  index_->invlists->resize(merge_list, 0);
+  index_->ntotal -= static_cast<faiss::idx_t>(n);
+
+  // precomputed table depends on the centroids
+  if (use_fast_scan_) {
+    static_cast<faiss::IndexIVFPQFastScan*>(index_.get())->precompute_table();
+  } else {
+    static_cast<faiss::IndexIVFPQ*>(index_.get())->precompute_table();
+  }
+
+  // assign by the new centroids, the vectors of the merged list go to the nearest other lists.
+  try {
+    index_->add_with_ids(n, vectors.data(), ids.data());
+  } catch (std::exception& e) {
+    return butil::Status(pb::error::Errno::EINTERNAL,
+                         fmt::format("add rebalanced vectors exception : {}, need rebuild", e.what()));
+  }
+  if (gpu_replica_ != nullptr) {
+    gpu_replica_->MarkStale();
+  }
+  move_count += static_cast<int64_t>(n);
+
+  return butil::Status::OK();
+}
+
+const faiss::ProductQuantizer* VectorIndexRawIvfPq::GetProductQuantizer() const {
+  if (use_fast_scan_) {
+    return &static_cast<const faiss::IndexIVFPQFastScan*>(index_.get())->pq;
+  }
+  return &static_cast<const faiss::IndexIVFPQ*>(index_.get())->pq;
+}
+
+void VectorIndexRawIvfPq::FastScanSearch(faiss::idx_t n, const float* vectors, faiss::idx_t topk, int32_t nprobe,
+                                         const faiss::IDSelector* sel, float* distances, faiss::idx_t* labels) {
+  // the outside has been locked, restore the default nprobe after search.
+  auto default_nprobe = index_->nprobe;
+  index_->nprobe = nprobe;
+
+  if (sel == nullptr) {
+    index_->search(n, vectors, topk, distances, labels);
+    index_->nprobe = default_nprobe;
+    return;
+  }
+
+  faiss::idx_t candidate_k =
+      std::max(topk, std::min(index_->ntotal, topk * std::max(FLAGS_ivf_pq_fast_scan_filter_candidate_ratio, 1L)));
+  std::vector<float> candidate_distances(n * candidate_k);
+  std::vector<faiss::idx_t> candidate_labels(n * candidate_k);
+  index_->search(n, vectors, candidate_k, candidate_distances.data(), candidate_labels.data());
+  index_->nprobe = default_nprobe;
+
+  for (faiss::idx_t row = 0; row < n; ++row) {
+    faiss::idx_t count = 0;
+    for (faiss::idx_t i = row * candidate_k; i < (row + 1) * candidate_k && count < topk; ++i) {
+      // the labels of not enough candidates are -1, and at the tail
+      if (candidate_labels[i] < 0) {
+        break;
+      }
+      if (sel->is_member(candidate_labels[i])) {
+        distances[row * topk + count] = candidate_distances[i];
+        labels[row * topk + count] = candidate_labels[i];
+        ++count;
+      }
+    }
+    for (; count < topk; ++count) {
+      labels[row * topk + count] = -1;
+    }
+  }
+}
+
 }  // namespace dingodb
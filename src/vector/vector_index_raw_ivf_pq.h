@@ -15,20 +15,24 @@
 #ifndef DINGODB_VECTOR_INDEX_RAW_IVF_PQ_H_  // NOLINT
 #define DINGODB_VECTOR_INDEX_RAW_IVF_PQ_H_
 
+#include <faiss/IndexIVF.h>
 #include <faiss/IndexIVFPQ.h>
 
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "butil/status.h"
 #include "faiss/Index.h"
 #include "faiss/MetricType.h"
 #include "faiss/impl/IDSelector.h"
+#include "faiss/impl/ProductQuantizer.h"
 #include "faiss/utils/distances.h"
 #include "proto/common.pb.h"
 #include "vector/vector_index.h"
+#include "vector/vector_index_gpu.h"
 
 namespace dingodb {
 
@@ -54,6 +58,8 @@ class RawIvfPqIDSelector : public faiss::IDSelector {
   std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters_;
 };
 
+// The index is faiss::IndexIVFPQFastScan when ivf_pq_parameter.use_fast_scan, the 4-bit pq codes are
+// scanned by simd lookup table, otherwise faiss::IndexIVFPQ.
 class VectorIndexRawIvfPq : public VectorIndex {
  public:
   explicit VectorIndexRawIvfPq(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
@@ -108,6 +114,16 @@ class VectorIndexRawIvfPq : public VectorIndex {
   bool IsTrained() override;
   bool NeedToSave(int64_t last_save_log_behind) override;
 
+  // sync the stale gpu replica, and rebalance the skewed inverted lists
+  bool NeedToRepair() override;
+  butil::Status Repair() override;
+
+  // Pair the oversized lists with the tiny lists, the tiny list is merged into its neighbors and its centroid is
+  // reused to split the oversized list, so nlist is not changed. Empty when the lists are balanced.
+  static std::vector<std::pair<size_t, size_t>> PlanRebalance(const std::vector<size_t>& list_sizes,
+                                                              double split_ratio, double merge_ratio,
+                                                              size_t min_split_size, int64_t max_move_count);
+
  private:
   void Init();
 
@@ -118,6 +134,20 @@ class VectorIndexRawIvfPq : public VectorIndex {
 
   butil::Status AddOrUpsert(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool is_upsert);
 
+  const faiss::ProductQuantizer* GetProductQuantizer() const;
+
+  std::vector<size_t> ListSizes() const;
+  bool DoNeedToRebalance();
+  butil::Status Rebalance();
+  // Split split_list by 2-means, one centroid replaces the centroid of merge_list, the vectors of both lists are
+  // decoded and added again by the new centroids.
+  butil::Status RebalanceList(size_t split_list, size_t merge_list, int64_t& move_count);
+
+  // IndexIVFPQFastScan does not take search parameters, so set nprobe on the index, and filter the
+  // results of more candidates.
+  void FastScanSearch(faiss::idx_t n, const float* vectors, faiss::idx_t topk, int32_t nprobe,
+                      const faiss::IDSelector* sel, float* distances, faiss::idx_t* labels);
+
   // Dimension of the elements
   faiss::idx_t dimension_;
 
@@ -132,15 +162,22 @@ class VectorIndexRawIvfPq : public VectorIndex {
 
   int32_t nbits_per_idx_;
 
+  bool use_fast_scan_;
+
   std::unique_ptr<faiss::Index> quantizer_;
 
-  std::unique_ptr<faiss::IndexIVFPQ> index_;
+  std::unique_ptr<faiss::IndexIVF> index_;
 
   // normalize vector
   bool normalize_;
 
   // first  train data size
   faiss::idx_t train_data_size_;
+
+  // only set when use_gpu
+  std::unique_ptr<GpuIndexReplica> gpu_replica_;
+
+  int64_t last_rebalance_time_ms_;
 };
 
 }  // namespace dingodb
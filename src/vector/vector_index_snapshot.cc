@@ -14,7 +14,9 @@
 
 #include "vector/vector_index_snapshot.h"
 
+#include <fcntl.h>
 #include <sys/wait.h>  // Add this include
+#include <unistd.h>
 
 #include <cstdint>
 #include <cstdlib>
@@ -79,6 +81,8 @@ bool SnapshotMeta::Init() {
 
   epoch_ = meta.epoch();
   range_ = meta.range();
+  base_snapshot_log_id_ = meta.base_snapshot_log_id() > 0 ? meta.base_snapshot_log_id() : snapshot_log_id_;
+  delta_file_names_ = std::vector<std::string>(meta.delta_file_names().begin(), meta.delta_file_names().end());
 
   DINGO_LOG(INFO) << fmt::format(
       "[vector_index.snapshot][index_id({})] Load snapshot meta, epoch: {} snapshot_index_id: {}, path: {}",
@@ -90,7 +94,18 @@ bool SnapshotMeta::Init() {
 std::string SnapshotMeta::MetaPath() { return fmt::format("{}/meta", path_); }
 
 std::string SnapshotMeta::IndexDataPath() {
-  return fmt::format("{}/index_{}_{}.idx", path_, vector_index_id_, snapshot_log_id_);
+  int64_t log_id = base_snapshot_log_id_ > 0 ? base_snapshot_log_id_ : snapshot_log_id_;
+  return fmt::format("{}/index_{}_{}.idx", path_, vector_index_id_, log_id);
+}
+
+std::vector<std::string> SnapshotMeta::DeltaFilePaths() {
+  std::vector<std::string> paths;
+  paths.reserve(delta_file_names_.size());
+  for (const auto& file_name : delta_file_names_) {
+    paths.push_back(fmt::format("{}/{}", path_, file_name));
+  }
+
+  return paths;
 }
 
 std::vector<std::string> SnapshotMeta::ListFileNames() { return Helper::TraverseDirectory(path_); }
@@ -160,6 +175,84 @@ bool SnapshotMetaSet::IsExistSnapshot(int64_t snapshot_log_id) {
 
 bool SnapshotMetaSet::IsExistLastSnapshot() { return GetLastSnapshot() != nullptr; }
 
+bool SnapshotDeltaWriter::Open() {
+  file_.open(path_, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+  if (!file_.is_open()) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.snapshot] Open delta file failed, path: {}", path_);
+    return false;
+  }
+
+  return true;
+}
+
+bool SnapshotDeltaWriter::Append(const pb::store_internal::VectorIndexSnapshotDelta& delta) {
+  std::string buf;
+  if (!delta.SerializeToString(&buf)) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.snapshot] Serialize delta failed, path: {}", path_);
+    return false;
+  }
+
+  uint32_t record_size = buf.size();
+  file_.write(reinterpret_cast<const char*>(&record_size), sizeof(record_size));
+  file_.write(buf.data(), buf.size());
+  if (!file_.good()) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.snapshot] Write delta file failed, path: {}", path_);
+    return false;
+  }
+
+  size_ += sizeof(record_size) + buf.size();
+  return true;
+}
+
+bool SnapshotDeltaWriter::Close() {
+  file_.close();
+  if (file_.fail()) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.snapshot] Close delta file failed, path: {}", path_);
+    return false;
+  }
+
+  int fd = open(path_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  int ret = fsync(fd);
+  close(fd);
+
+  return ret == 0;
+}
+
+bool SnapshotDeltaWriter::Read(
+    const std::string& path, const std::function<bool(const pb::store_internal::VectorIndexSnapshotDelta&)>& handler) {
+  std::ifstream file(path, std::ifstream::in | std::ifstream::binary);
+  if (!file.is_open()) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.snapshot] Open delta file failed, path: {}", path);
+    return false;
+  }
+
+  std::string buf;
+  uint32_t record_size = 0;
+  while (file.read(reinterpret_cast<char*>(&record_size), sizeof(record_size))) {
+    buf.resize(record_size);
+    if (!file.read(buf.data(), record_size)) {
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.snapshot] Delta file is truncated, path: {}", path);
+      return false;
+    }
+
+    pb::store_internal::VectorIndexSnapshotDelta delta;
+    if (!delta.ParseFromString(buf)) {
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.snapshot] Parse delta failed, path: {}", path);
+      return false;
+    }
+
+    if (!handler(delta)) {
+      return false;
+    }
+  }
+
+  // partial size header
+  return file.gcount() == 0;
+}
+
 }  // namespace vector_index
 
 }  // namespace dingodb
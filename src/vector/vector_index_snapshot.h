@@ -16,12 +16,15 @@
 #define DINGODB_VECTOR_INDEX_SNAPSHOT_H_
 
 #include <cstdint>
+#include <fstream>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "bthread/types.h"
 #include "proto/common.pb.h"
+#include "proto/store_internal.pb.h"
 
 namespace dingodb {
 
@@ -46,12 +49,20 @@ class SnapshotMeta {
   std::string IndexDataPath();
   std::vector<std::string> ListFileNames();
 
+  // delta snapshot share the index file of base snapshot.
+  bool IsDelta() const { return base_snapshot_log_id_ != snapshot_log_id_; }
+  int64_t BaseSnapshotLogId() const { return base_snapshot_log_id_; }
+  std::vector<std::string> DeltaFilePaths();
+  const std::vector<std::string>& DeltaFileNames() const { return delta_file_names_; }
+
   pb::common::RegionEpoch Epoch() const { return epoch_; }
   pb::common::Range Range() const { return range_; }
 
  private:
   int64_t vector_index_id_;
   int64_t snapshot_log_id_;
+  int64_t base_snapshot_log_id_{0};
+  std::vector<std::string> delta_file_names_;
   std::string path_;
 
   pb::common::RegionEpoch epoch_;
@@ -86,6 +97,30 @@ class SnapshotMetaSet {
 
 using SnapshotMetaSetPtr = std::shared_ptr<SnapshotMetaSet>;
 
+// The changes of vector index since base snapshot, append only.
+// Record layout: | size(uint32) | VectorIndexSnapshotDelta |
+class SnapshotDeltaWriter {
+ public:
+  explicit SnapshotDeltaWriter(const std::string& path) : path_(path) {}
+  ~SnapshotDeltaWriter() = default;
+
+  bool Open();
+  bool Append(const pb::store_internal::VectorIndexSnapshotDelta& delta);
+  // flush and sync to disk
+  bool Close();
+
+  int64_t Size() const { return size_; }
+
+  // Read all records by order, stop when handler return false.
+  static bool Read(const std::string& path,
+                   const std::function<bool(const pb::store_internal::VectorIndexSnapshotDelta&)>& handler);
+
+ private:
+  std::string path_;
+  std::ofstream file_;
+  int64_t size_{0};
+};
+
 }  // namespace vector_index
 
 }  // namespace dingodb
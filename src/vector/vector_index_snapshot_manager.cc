@@ -14,9 +14,12 @@
 
 #include "vector/vector_index_snapshot_manager.h"
 
+#include <fcntl.h>
 #include <sys/wait.h>  // Add this include
+#include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -27,10 +30,14 @@
 #include <vector>
 
 #include "braft/protobuf_file.h"
+#include "braft/snapshot_throttle.h"
+#include "bthread/bthread.h"
+#include "bthread/mutex.h"
 #include "butil/endpoint.h"
 #include "butil/iobuf.h"
 #include "butil/status.h"
 #include "butil/strings/string_split.h"
+#include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/service_access.h"
@@ -40,14 +47,26 @@
 #include "proto/error.pb.h"
 #include "proto/file_service.pb.h"
 #include "proto/node.pb.h"
+#include "proto/raft.pb.h"
 #include "proto/store_internal.pb.h"
+#include "raft/raft_node.h"
 #include "server/file_service.h"
 #include "server/server.h"
+#include "vector/codec.h"
 #include "vector/vector_index_factory.h"
+#include "vector/vector_index_snapshot.h"
 
 namespace dingodb {
 
 DEFINE_bool(vector_index_snapshot_use_fork, true, "Use fork to save vector index snapshot.");
+DEFINE_bool(vector_index_snapshot_use_delta, true,
+            "Use delta snapshot to save vector index changes since last snapshot.");
+DEFINE_int32(vector_index_snapshot_max_delta_count, 16, "Max delta file count of snapshot, exceed do full snapshot.");
+DEFINE_double(vector_index_snapshot_max_delta_ratio, 0.5,
+              "Max ratio of delta files size to index file size, exceed do full snapshot.");
+DEFINE_int32(vector_index_snapshot_delta_read_log_batch, 1024, "Read wal log entry batch size when save delta.");
+DEFINE_int32(vector_index_snapshot_download_concurrency, 4, "In-flight chunk num of downloading one snapshot file.");
+DEFINE_int32(vector_index_snapshot_download_retry_times, 3, "Retry times of downloading one snapshot file chunk.");
 
 // Get all snapshot path, except tmp dir.
 static std::vector<std::string> GetSnapshotPaths(std::string path) {
@@ -399,6 +418,176 @@ butil::Status VectorIndexSnapshotManager::PullLastSnapshotFromPeers(vector_index
   return butil::Status();
 }
 
+// Download one snapshot file by chunks, the workers take the next chunk offset until the end of file,
+// so the file size is not needed. Every chunk is verified by crc32c, and only the failed chunk is fetched again.
+// The throughput is limited by the snapshot throttle shared with raft snapshot.
+struct DownloadFileContext {
+  int64_t vector_index_id{0};
+  int64_t reader_id{0};
+  butil::EndPoint endpoint;
+  std::string filename;
+  int fd{-1};
+  braft::SnapshotThrottle* throttle{nullptr};
+
+  std::atomic<int64_t> next_offset{0};
+  // the min end offset reported by eof response
+  std::atomic<int64_t> eof_offset{INT64_MAX};
+  std::atomic<bool> is_failed{false};
+
+  bthread::Mutex mutex;
+  butil::Status status;
+};
+
+static void SetDownloadEofOffset(DownloadFileContext* ctx, int64_t end_offset) {
+  int64_t eof_offset = ctx->eof_offset.load();
+  while (end_offset < eof_offset && !ctx->eof_offset.compare_exchange_weak(eof_offset, end_offset)) {
+  }
+}
+
+static butil::Status GetFileChunk(DownloadFileContext* ctx, int64_t offset, int64_t size,
+                                  std::shared_ptr<pb::fileservice::GetFileResponse>& response, butil::IOBuf& buf) {
+  pb::fileservice::GetFileRequest request;
+  request.set_reader_id(ctx->reader_id);
+  request.set_filename(ctx->filename);
+  request.set_offset(offset);
+  request.set_size(size);
+
+  butil::Status status;
+  for (int i = 0; i <= FLAGS_vector_index_snapshot_download_retry_times; ++i) {
+    if (i > 0) {
+      bthread_usleep(100 * 1000 * i);
+    }
+
+    buf.clear();
+    response = ServiceAccess::GetFile(request, ctx->endpoint, &buf);
+    if (response == nullptr) {
+      status = butil::Status(pb::error::EINTERNAL, "Get file failed");
+      continue;
+    }
+    if (response->has_checksum() && response->checksum() != Helper::Crc32c(buf)) {
+      status = butil::Status(pb::error::EINTERNAL, "Get file checksum mismatch");
+      continue;
+    }
+    if (static_cast<int64_t>(buf.size()) != response->read_size()) {
+      status = butil::Status(pb::error::EINTERNAL, "Get file size mismatch");
+      continue;
+    }
+
+    return butil::Status();
+  }
+
+  DINGO_LOG(ERROR) << fmt::format("[vector_index.snapshot][index({})] get file {} chunk failed, offset: {} error: {}",
+                                  ctx->vector_index_id, ctx->filename, offset, status.error_str());
+  return status;
+}
+
+static butil::Status DownloadFileChunk(DownloadFileContext* ctx, int64_t offset, int64_t size) {
+  while (size > 0 && !ctx->is_failed.load()) {
+    int64_t request_size = size;
+    if (ctx->throttle != nullptr) {
+      request_size = static_cast<int64_t>(ctx->throttle->throttled_by_throughput(size));
+      if (request_size == 0) {
+        bthread_usleep(ctx->throttle->get_retry_interval_ms() * 1000);
+        continue;
+      }
+    }
+
+    std::shared_ptr<pb::fileservice::GetFileResponse> response;
+    butil::IOBuf buf;
+    auto status = GetFileChunk(ctx, offset, request_size, response, buf);
+    if (!status.ok()) {
+      return status;
+    }
+
+    // Write local file at the offset of chunk.
+    int64_t write_offset = offset;
+    while (!buf.empty()) {
+      ssize_t written = buf.pcut_into_file_descriptor(ctx->fd, write_offset);
+      if (written < 0) {
+        return butil::Status(pb::error::EINTERNAL, "Write file failed, error: %s", berror());
+      }
+      write_offset += written;
+    }
+
+    if (response->eof()) {
+      SetDownloadEofOffset(ctx, offset + response->read_size());
+      break;
+    }
+    if (response->read_size() <= 0) {
+      return butil::Status(pb::error::EINTERNAL, "Get file read nothing before eof");
+    }
+
+    offset += response->read_size();
+    size -= response->read_size();
+  }
+
+  return butil::Status();
+}
+
+static void* DownloadFileChunks(void* arg) {
+  auto* ctx = static_cast<DownloadFileContext*>(arg);
+  while (!ctx->is_failed.load()) {
+    int64_t offset = ctx->next_offset.fetch_add(Constant::kFileTransportChunkSize);
+    if (offset >= ctx->eof_offset.load()) {
+      break;
+    }
+
+    auto status = DownloadFileChunk(ctx, offset, Constant::kFileTransportChunkSize);
+    if (!status.ok()) {
+      BAIDU_SCOPED_LOCK(ctx->mutex);
+      ctx->status = status;
+      ctx->is_failed.store(true);
+      break;
+    }
+  }
+
+  return nullptr;
+}
+
+static butil::Status DownloadFile(int64_t vector_index_id, int64_t reader_id, const butil::EndPoint& endpoint,
+                                  const std::string& filename, const std::string& filepath) {
+  int fd = ::open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return butil::Status(pb::error::EINTERNAL, "Open file %s failed, error: %s", filepath.c_str(), berror());
+  }
+
+  DownloadFileContext ctx;
+  ctx.vector_index_id = vector_index_id;
+  ctx.reader_id = reader_id;
+  ctx.endpoint = endpoint;
+  ctx.filename = filename;
+  ctx.fd = fd;
+  ctx.throttle = RaftNode::GetSharedSnapshotThrottle();
+
+  // the current bthread is one of workers, go on with the started workers if start bthread failed.
+  std::vector<bthread_t> tids;
+  for (int i = 1; i < FLAGS_vector_index_snapshot_download_concurrency; ++i) {
+    bthread_t tid;
+    if (bthread_start_background(&tid, nullptr, DownloadFileChunks, &ctx) != 0) {
+      DINGO_LOG(WARNING) << fmt::format("[vector_index.snapshot][index({})] start download bthread failed",
+                                        vector_index_id);
+      break;
+    }
+    tids.push_back(tid);
+  }
+  DownloadFileChunks(&ctx);
+  for (auto tid : tids) {
+    bthread_join(tid, nullptr);
+  }
+  ::close(fd);
+
+  if (ctx.is_failed.load()) {
+    return ctx.status;
+  }
+  if (ctx.eof_offset.load() == INT64_MAX) {
+    return butil::Status(pb::error::EINTERNAL, "Download file not reach eof");
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.snapshot][index({})] download vector index snapshot file {} size {}",
+                                 vector_index_id, filepath, ctx.eof_offset.load());
+  return butil::Status();
+}
+
 butil::Status VectorIndexSnapshotManager::DownloadSnapshotFile(const std::string& uri,
                                                                const pb::node::VectorIndexSnapshotMeta& meta,
                                                                vector_index::SnapshotMetaSetPtr snapshot_set) {
@@ -426,44 +615,14 @@ butil::Status VectorIndexSnapshotManager::DownloadSnapshotFile(const std::string
   }
 
   for (const auto& filename : meta.filenames()) {
-    int64_t offset = 0;
-    std::ofstream ofile;
-
     std::string filepath = fmt::format("{}/{}", tmp_snapshot_path, filename);
-    ofile.open(filepath, std::ofstream::out | std::ofstream::binary);
     DINGO_LOG(INFO) << fmt::format("[vector_index.snapshot][index({})] get vector index snapshot file: {}",
                                    meta.vector_index_id(), filepath);
 
-    for (;;) {
-      pb::fileservice::GetFileRequest request;
-      request.set_reader_id(reader_id);
-      request.set_filename(filename);
-      request.set_offset(offset);
-      request.set_size(Constant::kFileTransportChunkSize);
-
-      DINGO_LOG(DEBUG) << fmt::format("[vector_index.snapshot][index({})] GetFileRequest: {}", meta.vector_index_id(),
-                                      request.ShortDebugString());
-
-      butil::IOBuf buf;
-      auto response = ServiceAccess::GetFile(request, endpoint, &buf);
-      if (response == nullptr) {
-        return butil::Status(pb::error::EINTERNAL, "Get file failed");
-      }
-
-      DINGO_LOG(DEBUG) << fmt::format("[vector_index.snapshot][index({})] GetFileResponse: {}", meta.vector_index_id(),
-                                      response->ShortDebugString());
-
-      // Write local file.
-      ofile << buf;
-
-      if (response->eof()) {
-        break;
-      }
-
-      offset += response->read_size();
+    auto status = DownloadFile(meta.vector_index_id(), reader_id, endpoint, filename, filepath);
+    if (!status.ok()) {
+      return status;
     }
-
-    ofile.close();
   }
 
   if (snapshot_set->IsExistSnapshot(meta.snapshot_log_index())) {
@@ -531,6 +690,18 @@ butil::Status VectorIndexSnapshotManager::SaveVectorIndexSnapshot(VectorIndexWra
 
   int64_t vector_index_id = vector_index_wrapper->Id();
 
+  // The cost of delta snapshot is proportional to the changes, full snapshot is the compaction of deltas.
+  auto last_snapshot = vector_index_wrapper->SnapshotSet()->GetLastSnapshot();
+  if (CanSaveDeltaSnapshot(vector_index, last_snapshot)) {
+    auto status = SaveVectorIndexDeltaSnapshot(vector_index_wrapper, last_snapshot, snapshot_log_index);
+    if (status.ok()) {
+      return status;
+    }
+    DINGO_LOG(WARNING) << fmt::format(
+        "[vector_index.save_snapshot][index_id({})] Save delta snapshot failed, try full snapshot, error: {}",
+        vector_index_id, status.error_str());
+  }
+
   int64_t start_time = Helper::TimestampMs();
 
   // lock write for atomic ops
@@ -821,6 +992,7 @@ butil::Status VectorIndexSnapshotManager::SaveVectorIndexSnapshot(VectorIndexWra
     log_storage->TruncateVectorIndexPrefix(apply_log_index);
   }
 
+  vector_index->SetSnapshotLogId(apply_log_index);
   snapshot_log_index = apply_log_index;
 
   DINGO_LOG(INFO) << fmt::format(
@@ -830,6 +1002,267 @@ butil::Status VectorIndexSnapshotManager::SaveVectorIndexSnapshot(VectorIndexWra
   return butil::Status::OK();
 }
 
+bool VectorIndexSnapshotManager::CanSaveDeltaSnapshot(VectorIndexPtr vector_index,
+                                                      vector_index::SnapshotMetaPtr last_snapshot) {
+  if (!FLAGS_vector_index_snapshot_use_delta || last_snapshot == nullptr) {
+    return false;
+  }
+
+  // built or rebuilt vector index is not derived from last snapshot, save full snapshot.
+  if (vector_index->SnapshotLogId() != last_snapshot->SnapshotLogId()) {
+    return false;
+  }
+
+  // split/merge change the range, the base snapshot is stale.
+  if (last_snapshot->Epoch().version() != vector_index->Epoch().version() ||
+      last_snapshot->Range().start_key() != vector_index->Range().start_key() ||
+      last_snapshot->Range().end_key() != vector_index->Range().end_key()) {
+    return false;
+  }
+
+  if (static_cast<int32_t>(last_snapshot->DeltaFileNames().size()) >= FLAGS_vector_index_snapshot_max_delta_count) {
+    return false;
+  }
+
+  std::error_code ec;
+  int64_t index_file_size = std::filesystem::file_size(last_snapshot->IndexDataPath(), ec);
+  if (ec) {
+    return false;
+  }
+  int64_t delta_file_size = 0;
+  for (const auto& path : last_snapshot->DeltaFilePaths()) {
+    delta_file_size += std::filesystem::file_size(path, ec);
+    if (ec) {
+      return false;
+    }
+  }
+  if (delta_file_size > index_file_size * FLAGS_vector_index_snapshot_max_delta_ratio) {
+    return false;
+  }
+
+  // the wal since last snapshot must be kept.
+  auto log_storage = Server::GetInstance().GetLogStorageManager()->GetLogStorage(vector_index->Id());
+  if (log_storage == nullptr) {
+    return false;
+  }
+
+  return log_storage->FirstLogIndex() <= last_snapshot->SnapshotLogId() + 1;
+}
+
+butil::Status VectorIndexSnapshotManager::WriteDeltaFile(VectorIndexPtr vector_index, int64_t start_log_id,
+                                                         int64_t end_log_id, const std::string& path) {
+  auto log_storage = Server::GetInstance().GetLogStorageManager()->GetLogStorage(vector_index->Id());
+  if (log_storage == nullptr) {
+    return butil::Status(pb::error::Errno::EINTERNAL, fmt::format("Not found log stroage {}", vector_index->Id()));
+  }
+
+  vector_index::SnapshotDeltaWriter writer(path);
+  if (!writer.Open()) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "Open delta file failed");
+  }
+
+  int64_t min_vector_id = 0, max_vector_id = 0;
+  VectorCodec::DecodeRangeToVectorId(vector_index->Range(), min_vector_id, max_vector_id);
+
+  // keep the order of upsert and delete, a record only hold one kind of change.
+  pb::store_internal::VectorIndexSnapshotDelta delta;
+  auto flush_delta = [&]() -> bool {
+    if (delta.vectors().empty() && delta.delete_ids().empty()) {
+      return true;
+    }
+    bool ret = writer.Append(delta);
+    delta.Clear();
+    return ret;
+  };
+
+  for (int64_t begin_log_id = start_log_id; begin_log_id <= end_log_id;
+       begin_log_id += FLAGS_vector_index_snapshot_delta_read_log_batch) {
+    int64_t batch_end_log_id =
+        std::min(begin_log_id + FLAGS_vector_index_snapshot_delta_read_log_batch - 1, end_log_id);
+    auto log_entrys = log_storage->GetEntrys(begin_log_id, batch_end_log_id);
+    for (const auto& log_entry : log_entrys) {
+      pb::raft::RaftCmdRequest raft_cmd;
+      butil::IOBufAsZeroCopyInputStream wrapper(log_entry->data);
+      if (!raft_cmd.ParseFromZeroCopyStream(&wrapper)) {
+        return butil::Status(pb::error::Errno::EINTERNAL,
+                             fmt::format("Parse raft cmd failed, log_id: {}", log_entry->index));
+      }
+
+      for (auto& request : *raft_cmd.mutable_requests()) {
+        if (request.cmd_type() == pb::raft::VECTOR_ADD) {
+          if (!delta.delete_ids().empty() && !flush_delta()) {
+            return butil::Status(pb::error::Errno::EINTERNAL, "Write delta file failed");
+          }
+          for (auto& vector : *request.mutable_vector_add()->mutable_vectors()) {
+            if (vector.id() >= min_vector_id && vector.id() < max_vector_id) {
+              delta.add_vectors()->Swap(&vector);
+            }
+          }
+        } else if (request.cmd_type() == pb::raft::VECTOR_DELETE) {
+          if (!delta.vectors().empty() && !flush_delta()) {
+            return butil::Status(pb::error::Errno::EINTERNAL, "Write delta file failed");
+          }
+          for (auto vector_id : request.vector_delete().ids()) {
+            if (vector_id >= min_vector_id && vector_id < max_vector_id) {
+              delta.add_delete_ids(vector_id);
+            }
+          }
+        }
+
+        if (delta.vectors_size() + delta.delete_ids_size() >= static_cast<int>(Constant::kBuildVectorIndexBatchSize) &&
+            !flush_delta()) {
+          return butil::Status(pb::error::Errno::EINTERNAL, "Write delta file failed");
+        }
+      }
+    }
+  }
+
+  if (!flush_delta() || !writer.Close()) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "Write delta file failed");
+  }
+
+  return butil::Status::OK();
+}
+
+// Save delta snapshot, no fork and no lock of vector index, the changes are read from wal.
+// The base index file and the former delta files are hard linked, each snapshot directory is self-contained,
+// so install/pull snapshot and clean stale snapshot work as the full snapshot.
+butil::Status VectorIndexSnapshotManager::SaveVectorIndexDeltaSnapshot(VectorIndexWrapperPtr vector_index_wrapper,
+                                                                       vector_index::SnapshotMetaPtr last_snapshot,
+                                                                       int64_t& snapshot_log_index) {
+  auto vector_index = vector_index_wrapper->GetOwnVectorIndex();
+  if (vector_index == nullptr) {
+    return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "Not found vector index.");
+  }
+
+  int64_t vector_index_id = vector_index_wrapper->Id();
+  int64_t start_time = Helper::TimestampMs();
+
+  int64_t apply_log_index = vector_index_wrapper->ApplyLogId();
+  auto snapshot_set = vector_index_wrapper->SnapshotSet();
+  if (snapshot_set->IsExistSnapshot(apply_log_index)) {
+    snapshot_log_index = apply_log_index;
+    DINGO_LOG(INFO) << fmt::format(
+        "[vector_index.save_snapshot][index_id({})] VectorIndex Snapshot already exist, cannot do save, log_id: {}",
+        vector_index_id, apply_log_index);
+    return butil::Status();
+  }
+
+  std::string tmp_snapshot_path = GetSnapshotTmpPath(vector_index_id);
+  if (!Helper::CreateDirectory(tmp_snapshot_path)) {
+    DINGO_LOG(ERROR) << fmt::format(
+        "[vector_index.save_snapshot][index_id({})] Create tmp snapshot path failed, path: {}", vector_index_id,
+        tmp_snapshot_path);
+    return butil::Status(pb::error::EINTERNAL, "Create tmp snapshot path failed");
+  }
+
+  // hard link the base index file and former delta files.
+  std::vector<std::string> src_paths = last_snapshot->DeltaFilePaths();
+  src_paths.push_back(last_snapshot->IndexDataPath());
+  for (const auto& src_path : src_paths) {
+    std::error_code ec;
+    std::string dst_path =
+        fmt::format("{}/{}", tmp_snapshot_path, std::filesystem::path(src_path).filename().string());
+    std::filesystem::create_hard_link(src_path, dst_path, ec);
+    if (ec) {
+      DINGO_LOG(ERROR) << fmt::format(
+          "[vector_index.save_snapshot][index_id({})] Hard link snapshot file failed, {} -> {} error: {}",
+          vector_index_id, src_path, dst_path, ec.message());
+      Helper::RemoveAllFileOrDirectory(tmp_snapshot_path);
+      return butil::Status(pb::error::EINTERNAL, "Hard link snapshot file failed");
+    }
+  }
+
+  int64_t start_log_id = last_snapshot->SnapshotLogId() + 1;
+  std::string delta_file_name = fmt::format("delta_{:020}_{:020}.log", start_log_id, apply_log_index);
+  auto status = WriteDeltaFile(vector_index, start_log_id, apply_log_index,
+                               fmt::format("{}/{}", tmp_snapshot_path, delta_file_name));
+  if (!status.ok()) {
+    Helper::RemoveAllFileOrDirectory(tmp_snapshot_path);
+    return status;
+  }
+
+  pb::store_internal::VectorIndexSnapshotMeta meta;
+  meta.set_vector_index_id(vector_index_id);
+  meta.set_snapshot_log_id(apply_log_index);
+  *(meta.mutable_range()) = vector_index->Range();
+  *(meta.mutable_epoch()) = vector_index->Epoch();
+  meta.set_base_snapshot_log_id(last_snapshot->BaseSnapshotLogId());
+  for (const auto& file_name : last_snapshot->DeltaFileNames()) {
+    meta.add_delta_file_names(file_name);
+  }
+  meta.add_delta_file_names(delta_file_name);
+
+  braft::ProtoBufFile pb_file_meta(fmt::format("{}/meta", tmp_snapshot_path));
+  if (pb_file_meta.save(&meta, true) != 0) {
+    Helper::RemoveAllFileOrDirectory(tmp_snapshot_path);
+    return butil::Status(pb::error::Errno::EINTERNAL, "Save delta snapshot meta failed");
+  }
+
+  // Rename
+  std::string new_snapshot_path = GetSnapshotNewPath(vector_index_id, apply_log_index);
+  status = Helper::Rename(tmp_snapshot_path, new_snapshot_path);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format(
+        "[vector_index.save_snapshot][index_id({})] Rename vector index snapshot failed, {} -> {} error: {}",
+        vector_index_id, tmp_snapshot_path, new_snapshot_path, status.error_str());
+    return status;
+  }
+
+  auto new_snapshot = vector_index::SnapshotMeta::New(vector_index_id, new_snapshot_path);
+  if (!new_snapshot->Init()) {
+    return butil::Status(pb::error::EINTERNAL, "Init snapshot failed, path: %s", new_snapshot_path.c_str());
+  }
+
+  if (!snapshot_set->AddSnapshot(new_snapshot)) {
+    return butil::Status(pb::error::EVECTOR_SNAPSHOT_EXIST, "Already exist vector index snapshot, path: %s",
+                         new_snapshot_path.c_str());
+  }
+
+  // Set truncate wal log index.
+  auto log_storage = Server::GetInstance().GetLogStorageManager()->GetLogStorage(vector_index_id);
+  if (log_storage != nullptr) {
+    log_storage->TruncateVectorIndexPrefix(apply_log_index);
+  }
+
+  vector_index->SetSnapshotLogId(apply_log_index);
+  snapshot_log_index = apply_log_index;
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.save_snapshot][index_id({})] Save vector index delta snapshot snapshot_{:020} base({}) "
+      "delta_count({}) elapsed time {}ms",
+      vector_index_id, apply_log_index, meta.base_snapshot_log_id(), meta.delta_file_names_size(),
+      Helper::TimestampMs() - start_time);
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexSnapshotManager::ReplayDeltaToVectorIndex(VectorIndexPtr vector_index,
+                                                                   vector_index::SnapshotMetaPtr snapshot) {
+  butil::Status status;
+  for (const auto& path : snapshot->DeltaFilePaths()) {
+    bool ret = vector_index::SnapshotDeltaWriter::Read(
+        path, [&](const pb::store_internal::VectorIndexSnapshotDelta& delta) -> bool {
+          if (!delta.vectors().empty()) {
+            status = vector_index->Upsert(
+                std::vector<pb::common::VectorWithId>(delta.vectors().begin(), delta.vectors().end()), false);
+          } else if (!delta.delete_ids().empty()) {
+            // delete not exist id is not an error, just ignore the status like wal replay.
+            vector_index->Delete(std::vector<int64_t>(delta.delete_ids().begin(), delta.delete_ids().end()), false);
+          }
+          return status.ok();
+        });
+    if (!status.ok()) {
+      return status;
+    }
+    if (!ret) {
+      return butil::Status(pb::error::Errno::EINTERNAL, "Read delta file failed, path: %s", path.c_str());
+    }
+  }
+
+  return butil::Status::OK();
+}
+
 // Load vector index for already exist vector index at bootstrap.
 std::shared_ptr<VectorIndex> VectorIndexSnapshotManager::LoadVectorIndexSnapshot(
     VectorIndexWrapperPtr vector_index_wrapper, const pb::common::RegionEpoch& epoch) {
@@ -900,6 +1333,17 @@ std::shared_ptr<VectorIndex> VectorIndexSnapshotManager::LoadVectorIndexSnapshot
     return nullptr;
   }
 
+  if (last_snapshot->IsDelta()) {
+    status = ReplayDeltaToVectorIndex(vector_index, last_snapshot);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format(
+          "[vector_index.load_snapshot][index_id({}).snapshot_log_id({})] load snapshot failed, replay delta "
+          "error: {}.",
+          vector_index_id, last_snapshot->SnapshotLogId(), Helper::PrintStatus(status));
+      return nullptr;
+    }
+  }
+
   // set vector_index apply log id
   vector_index->SetSnapshotLogId(last_snapshot->SnapshotLogId());
   vector_index->SetApplyLogId(last_snapshot->SnapshotLogId());
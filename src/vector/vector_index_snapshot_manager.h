@@ -66,6 +66,17 @@ class VectorIndexSnapshotManager {
  private:
   static std::string GetSnapshotTmpPath(int64_t vector_index_id);
   static std::string GetSnapshotNewPath(int64_t vector_index_id, int64_t snapshot_log_id);
+
+  // Delta snapshot, hard link the files of last snapshot and append the changes in wal since last snapshot.
+  static bool CanSaveDeltaSnapshot(VectorIndexPtr vector_index, vector_index::SnapshotMetaPtr last_snapshot);
+  static butil::Status SaveVectorIndexDeltaSnapshot(VectorIndexWrapperPtr vector_index_wrapper,
+                                                    vector_index::SnapshotMetaPtr last_snapshot,
+                                                    int64_t& snapshot_log_index);
+  // Write vector changes of wal log(start_log_id, end_log_id) to delta file.
+  static butil::Status WriteDeltaFile(VectorIndexPtr vector_index, int64_t start_log_id, int64_t end_log_id,
+                                      const std::string& path);
+  // Apply delta files of snapshot to vector index.
+  static butil::Status ReplayDeltaToVectorIndex(VectorIndexPtr vector_index, vector_index::SnapshotMetaPtr snapshot);
   static butil::Status DownloadSnapshotFile(const std::string& uri, const pb::node::VectorIndexSnapshotMeta& meta,
                                             vector_index::SnapshotMetaSetPtr snapshot_set);
 };
@@ -0,0 +1,155 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_index_train.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bvar/reducer.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "vector/codec.h"
+
+extern "C" {
+extern void omp_set_num_threads(int) noexcept;  // NOLINT
+extern int omp_get_max_threads(void) noexcept;  // NOLINT
+}
+
+namespace dingodb {
+
+DEFINE_int32(vector_index_train_thread_num, 4, "max omp threads of all concurrent vector index training");
+DEFINE_bool(enable_vector_index_centroid_cache, true, "reuse trained ivf centroids in the same partition");
+DEFINE_int32(vector_index_centroid_cache_max_count, 64, "max count of cached ivf centroids");
+DEFINE_int64(vector_index_centroid_cache_ttl_s, 3600, "ttl seconds of cached ivf centroids");
+
+bvar::Adder<int64_t> g_centroid_cache_hit_count("dingo_vector_index_centroid_cache_hit_count");
+bvar::Adder<int64_t> g_centroid_cache_miss_count("dingo_vector_index_centroid_cache_miss_count");
+
+TrainDataSampler::TrainDataSampler(int32_t dimension, int64_t sample_size)
+    : dimension_(dimension), sample_size_(sample_size), rng_(std::random_device{}()) {
+  if (sample_size_ > 0) {
+    datas_.reserve(sample_size_ * dimension_);
+  }
+}
+
+// reservoir sampling, the i-th vector replaces a random sample with probability sample_size/i.
+void TrainDataSampler::Add(const pb::common::Vector& vector) {
+  const auto& values = vector.float_values();
+  if (values.size() != dimension_) {
+    return;
+  }
+
+  ++count_;
+  if (sample_size_ <= 0 || count_ <= sample_size_) {
+    datas_.insert(datas_.end(), values.begin(), values.end());
+    return;
+  }
+
+  int64_t pos = std::uniform_int_distribution<int64_t>(0, count_ - 1)(rng_);
+  if (pos < sample_size_) {
+    std::copy(values.begin(), values.end(), datas_.begin() + pos * dimension_);
+  }
+}
+
+// the budget is shared by all concurrent training, at least one thread for each.
+static bthread::Mutex train_thread_mutex;
+static int32_t train_thread_used_num = 0;
+
+TrainThreadGuard::TrainThreadGuard() : origin_thread_num_(omp_get_max_threads()) {
+  {
+    BAIDU_SCOPED_LOCK(train_thread_mutex);
+    thread_num_ = std::max(1, FLAGS_vector_index_train_thread_num - train_thread_used_num);
+    train_thread_used_num += thread_num_;
+  }
+
+  omp_set_num_threads(thread_num_);
+}
+
+TrainThreadGuard::~TrainThreadGuard() {
+  omp_set_num_threads(origin_thread_num_);
+
+  BAIDU_SCOPED_LOCK(train_thread_mutex);
+  train_thread_used_num -= thread_num_;
+}
+
+CentroidCache& CentroidCache::GetInstance() {
+  static CentroidCache instance;
+  return instance;
+}
+
+std::string CentroidCache::GenKey(const pb::common::Range& range, const pb::common::VectorIndexParameter& parameter,
+                                  int64_t nlist) {
+  return fmt::format("{}_{}_{}", VectorCodec::DecodePartitionId(range.start_key()), nlist,
+                     parameter.SerializeAsString());
+}
+
+bool CentroidCache::Get(const std::string& key, int64_t train_data_size, std::vector<float>& centroids) {
+  if (!FLAGS_enable_vector_index_centroid_cache) {
+    return false;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end() || it->second.train_data_size < train_data_size ||
+      Helper::Timestamp() - it->second.create_time_s > FLAGS_vector_index_centroid_cache_ttl_s) {
+    g_centroid_cache_miss_count << 1;
+    return false;
+  }
+
+  g_centroid_cache_hit_count << 1;
+  centroids = it->second.centroids;
+  return true;
+}
+
+void CentroidCache::Put(const std::string& key, int64_t train_data_size, const std::vector<float>& centroids) {
+  if (!FLAGS_enable_vector_index_centroid_cache || centroids.empty()) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  // evict the oldest
+  if (entries_.find(key) == entries_.end() &&
+      static_cast<int64_t>(entries_.size()) >= FLAGS_vector_index_centroid_cache_max_count) {
+    auto oldest = std::min_element(entries_.begin(), entries_.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.second.create_time_s < rhs.second.create_time_s;
+    });
+    if (oldest != entries_.end()) {
+      entries_.erase(oldest);
+    }
+  }
+
+  if (FLAGS_vector_index_centroid_cache_max_count > 0) {
+    entries_[key] = Entry{train_data_size, Helper::Timestamp(), centroids};
+  }
+}
+
+int64_t CentroidCache::Size() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return entries_.size();
+}
+
+void CentroidCache::Clear() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  entries_.clear();
+}
+
+}  // namespace dingodb
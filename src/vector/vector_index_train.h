@@ -0,0 +1,100 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_INDEX_TRAIN_H_  // NOLINT
+#define DINGODB_VECTOR_INDEX_TRAIN_H_
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Uniform sample of train vectors with fixed memory, the vectors is scanned only once.
+class TrainDataSampler {
+ public:
+  // sample_size is the max count of vectors, 0 means keep all.
+  TrainDataSampler(int32_t dimension, int64_t sample_size);
+  ~TrainDataSampler() = default;
+
+  void Add(const pb::common::Vector& vector);
+
+  // total count of added vectors
+  int64_t Count() const { return count_; }
+
+  std::vector<float>& Datas() { return datas_; }
+
+ private:
+  int32_t dimension_;
+  int64_t sample_size_;
+  int64_t count_{0};
+  std::vector<float> datas_;
+  std::mt19937_64 rng_;
+};
+
+// Set omp threads of training in current thread by the shared train thread budget, restore when destroy.
+// Training of faiss run omp parallel region in the calling thread.
+class TrainThreadGuard {
+ public:
+  TrainThreadGuard();
+  ~TrainThreadGuard();
+
+  TrainThreadGuard(const TrainThreadGuard&) = delete;
+  TrainThreadGuard& operator=(const TrainThreadGuard&) = delete;
+
+  int32_t ThreadNum() const { return thread_num_; }
+
+ private:
+  int32_t thread_num_;
+  int32_t origin_thread_num_;
+};
+
+// Trained coarse centroids of ivf index, reused by the regions of the same partition,
+// e.g. the children of split, to skip the clustering of quantizer.
+class CentroidCache {
+ public:
+  static CentroidCache& GetInstance();
+
+  // Cache key of the index, the same partition and parameter.
+  static std::string GenKey(const pb::common::Range& range, const pb::common::VectorIndexParameter& parameter,
+                            int64_t nlist);
+
+  // Only the centroids trained by not less data are reused.
+  bool Get(const std::string& key, int64_t train_data_size, std::vector<float>& centroids);
+  void Put(const std::string& key, int64_t train_data_size, const std::vector<float>& centroids);
+
+  int64_t Size();
+  void Clear();
+
+ private:
+  CentroidCache() = default;
+
+  struct Entry {
+    int64_t train_data_size;
+    int64_t create_time_s;
+    std::vector<float> centroids;
+  };
+
+  bthread::Mutex mutex_;
+  std::map<std::string, Entry> entries_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_INDEX_TRAIN_H_  // NOLINT
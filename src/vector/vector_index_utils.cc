@@ -14,26 +14,69 @@
 
 #include "vector/vector_index_utils.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "bthread/mutex.h"
 #include "butil/status.h"
 #include "common/constant.h"
 #include "common/logging.h"
 #include "faiss/MetricType.h"
 #include "faiss/utils/extra_distances-inl.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "hnswlib/hnswlib.h"
 #include "hnswlib/space_ip.h"
 #include "hnswlib/space_l2.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
+#include "vector/codec.h"
+
+extern "C" {
+extern void omp_set_num_threads(int) noexcept;  // NOLINT
+extern int omp_get_max_threads(void) noexcept;  // NOLINT
+}
 
 namespace dingodb {
 
+DEFINE_int32(vector_search_thread_num, 0, "max threads of all concurrent vector search, 0 is not limit");
+DEFINE_int32(vector_search_max_thread_per_query, 4, "max threads of one vector search when threads are free");
+
+// the budget is shared by all concurrent search, at least one thread for each.
+static bthread::Mutex search_thread_mutex;
+static int32_t search_thread_used_num = 0;
+
+SearchThreadGuard::SearchThreadGuard() {
+  if (FLAGS_vector_search_thread_num <= 0) {
+    return;
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(search_thread_mutex);
+    int32_t free_num = FLAGS_vector_search_thread_num - search_thread_used_num;
+    thread_num_ = std::clamp(free_num, 1, std::max(1, FLAGS_vector_search_max_thread_per_query));
+    search_thread_used_num += thread_num_;
+  }
+
+  origin_thread_num_ = omp_get_max_threads();
+  omp_set_num_threads(thread_num_);
+}
+
+SearchThreadGuard::~SearchThreadGuard() {
+  if (thread_num_ == 0) {
+    return;
+  }
+
+  omp_set_num_threads(origin_thread_num_);
+
+  BAIDU_SCOPED_LOCK(search_thread_mutex);
+  search_thread_used_num -= thread_num_;
+}
+
 butil::Status VectorIndexUtils::CalcDistanceEntry(
     const ::dingodb::pb::index::VectorCalcDistanceRequest& request,
     std::vector<std::vector<float>>& distances,                             // NOLINT
@@ -48,6 +91,12 @@ butil::Status VectorIndexUtils::CalcDistanceEntry(
 
   bool is_return_normlize = request.is_return_normlize();
 
+  // hamming distance is counted directly, not depend on algorithm.
+  if (metric_type == pb::common::METRIC_TYPE_HAMMING) {
+    return CalcDistanceCore(op_left_vectors, op_right_vectors, is_return_normlize, distances, result_op_left_vectors,
+                            result_op_right_vectors, DoCalcHammingDistance);
+  }
+
   switch (algorithm_type) {
     case pb::index::ALGORITHM_FAISS: {
       return CalcDistanceByFaiss(metric_type, op_left_vectors, op_right_vectors, is_return_normlize, distances,
@@ -69,6 +118,37 @@ butil::Status VectorIndexUtils::CalcDistanceEntry(
   return butil::Status();
 }
 
+butil::Status VectorIndexUtils::WidenIntegerVectors(
+    const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& vectors,
+    google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& result) {
+  bool has_integer = std::any_of(vectors.begin(), vectors.end(), [](const auto& vector) {
+    return vector.value_type() != ::dingodb::pb::common::ValueType::FLOAT;
+  });
+  if (!has_integer) {
+    return butil::Status();
+  }
+
+  for (const auto& vector : vectors) {
+    auto* widened = result.Add();
+    if (vector.value_type() == ::dingodb::pb::common::ValueType::FLOAT) {
+      *widened = vector;
+      continue;
+    }
+
+    widened->set_dimension(vector.dimension());
+    widened->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+    widened->mutable_float_values()->Resize(vector.dimension(), 0.0f);
+    if (!VectorCodec::VectorToFloat(vector, vector.dimension(), widened->mutable_float_values()->mutable_data())) {
+      std::string s = fmt::format("integer vector values not match dimension {}, value_type: {}", vector.dimension(),
+                                  ::dingodb::pb::common::ValueType_Name(vector.value_type()));
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, s);
+    }
+  }
+
+  return butil::Status();
+}
+
 butil::Status VectorIndexUtils::CalcDistanceCore(
     const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& op_left_vectors,
     const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& op_right_vectors, bool is_return_normlize,
@@ -76,24 +156,38 @@ butil::Status VectorIndexUtils::CalcDistanceCore(
     std::vector<::dingodb::pb::common::Vector>& result_op_left_vectors,   // NOLINT
     std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors,  // NOLINT
     DoCalcDistanceFunc do_calc_distance_func) {
+  // integer vectors are widened to float once, the distance functions only compute float values.
+  google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector> widened_left_vectors;
+  google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector> widened_right_vectors;
+  auto status = WidenIntegerVectors(op_left_vectors, widened_left_vectors);
+  if (!status.ok()) {
+    return status;
+  }
+  status = WidenIntegerVectors(op_right_vectors, widened_right_vectors);
+  if (!status.ok()) {
+    return status;
+  }
+  const auto& left_vectors = widened_left_vectors.empty() ? op_left_vectors : widened_left_vectors;
+  const auto& right_vectors = widened_right_vectors.empty() ? op_right_vectors : widened_right_vectors;
+
   distances.clear();
-  distances.resize(op_left_vectors.size());
+  distances.resize(left_vectors.size());
   size_t i = 0;
   size_t j = 0;
 
   if (is_return_normlize) {
-    result_op_left_vectors.clear();
-    result_op_right_vectors.clear();
-    result_op_left_vectors.resize(op_left_vectors.size());
-    result_op_right_vectors.resize(op_right_vectors.size());
+    result_left_vectors.clear();
+    result_right_vectors.clear();
+    result_left_vectors.resize(left_vectors.size());
+    result_right_vectors.resize(right_vectors.size());
   }
 
-  for (const auto& left_vector : op_left_vectors) {
+  for (const auto& left_vector : left_vectors) {
     std::vector<float> distance;
-    distance.resize(op_right_vectors.size());
+    distance.resize(right_vectors.size());
     ::dingodb::pb::common::Vector result_op_left_vector;
     j = 0;
-    for (const auto& right_vector : op_right_vectors) {
+    for (const auto& right_vector : right_vectors) {
       float dis = 0.0f;
       ::dingodb::pb::common::Vector result_op_right_vector;
       do_calc_distance_func(left_vector, right_vector, is_return_normlize,
@@ -101,11 +195,11 @@ butil::Status VectorIndexUtils::CalcDistanceCore(
                             result_op_left_vector,  // NOLINT
                             result_op_right_vector);
       distance[j] = dis;
-      if (is_return_normlize) result_op_right_vectors[j] = std::move(result_op_right_vector);
+      if (is_return_normlize) result_right_vectors[j] = std::move(result_op_right_vector);
       j++;
     }
     distances[i] = std::move(distance);
-    if (is_return_normlize) result_op_left_vectors[i] = std::move(result_op_left_vector);
+    if (is_return_normlize) result_left_vectors[i] = std::move(result_op_left_vector);
     i++;
   }
 
@@ -132,6 +226,7 @@ butil::Status VectorIndexUtils::CalcDistanceByFaiss(
       return CalcCosineDistanceByFaiss(op_left_vectors, op_right_vectors, is_return_normlize, distances,
                                        result_op_left_vectors, result_op_right_vectors);
     }
+    case pb::common::METRIC_TYPE_HAMMING:
     case pb::common::METRIC_TYPE_NONE:
     case pb::common::MetricType_INT_MIN_SENTINEL_DO_NOT_USE_:
     case pb::common::MetricType_INT_MAX_SENTINEL_DO_NOT_USE_: {
@@ -163,6 +258,7 @@ butil::Status VectorIndexUtils::CalcDistanceByHnswlib(
       return CalcCosineDistanceByHnswlib(op_left_vectors, op_right_vectors, is_return_normlize, distances,
                                          result_op_left_vectors, result_op_right_vectors);
     }
+    case pb::common::METRIC_TYPE_HAMMING:
     case pb::common::METRIC_TYPE_NONE:
     case pb::common::MetricType_INT_MIN_SENTINEL_DO_NOT_USE_:
     case pb::common::MetricType_INT_MAX_SENTINEL_DO_NOT_USE_: {
@@ -372,6 +468,29 @@ butil::Status VectorIndexUtils::DoCalcCosineDistanceByHnswlib(
   return butil::Status();
 }
 
+butil::Status VectorIndexUtils::DoCalcHammingDistance(const ::dingodb::pb::common::Vector& op_left_vectors,
+                                                      const ::dingodb::pb::common::Vector& op_right_vectors,
+                                                      bool is_return_normlize,
+                                                      float& distance,                                       // NOLINT
+                                                      dingodb::pb::common::Vector& result_op_left_vectors,   // NOLINT
+                                                      dingodb::pb::common::Vector& result_op_right_vectors)  // NOLINT
+{                                                                                                            // NOLINT
+  size_t dimension = std::min(op_left_vectors.float_values_size(), op_right_vectors.float_values_size());
+  const float* left = op_left_vectors.float_values().data();
+  const float* right = op_right_vectors.float_values().data();
+
+  uint32_t count = 0;
+  for (size_t i = 0; i < dimension; ++i) {
+    count += ((left[i] != 0.0f) != (right[i] != 0.0f)) ? 1 : 0;
+  }
+  distance = static_cast<float>(count);
+
+  ResultOpVectorAssignmentWrapper(op_left_vectors, op_right_vectors, is_return_normlize, result_op_left_vectors,
+                                  result_op_right_vectors);
+
+  return butil::Status();
+}
+
 void VectorIndexUtils::ResultOpVectorAssignment(dingodb::pb::common::Vector& result_op_vectors,
                                                 const ::dingodb::pb::common::Vector& op_vectors) {
   result_op_vectors = op_vectors;
@@ -418,6 +537,22 @@ void VectorIndexUtils::NormalizeVectorForHnsw(const float* data, uint32_t dimens
   for (int i = 0; i < dimension; i++) norm_array[i] = data[i] * norm;
 }
 
+void VectorIndexUtils::BinarizeVector(float* x, size_t d) {
+  for (size_t i = 0; i < d; i++) {
+    x[i] = (x[i] != 0.0f) ? 1.0f : 0.0f;
+  }
+}
+
+const float* VectorIndexUtils::GetFloatValues(const pb::common::Vector& vector, int32_t dimension,
+                                              std::vector<float>& buffer) {
+  if (vector.value_type() == pb::common::ValueType::FLOAT) {
+    return vector.float_values_size() == dimension ? vector.float_values().data() : nullptr;
+  }
+
+  buffer.resize(dimension);
+  return VectorCodec::VectorToFloat(vector, dimension, buffer.data()) ? buffer.data() : nullptr;
+}
+
 std::pair<std::unique_ptr<faiss::idx_t[]>, butil::Status> VectorIndexUtils::CopyVectorId(
     const std::vector<int64_t>& delete_ids) {
   std::unique_ptr<faiss::idx_t[]> ids;
@@ -442,10 +577,10 @@ std::pair<std::unique_ptr<faiss::idx_t[]>, butil::Status> VectorIndexUtils::Chec
   {
     size_t i = 0;
     for (const auto& vector_with_id : vector_with_ids) {
-      uint32_t input_dimension = vector_with_id.vector().float_values_size();
-      if (input_dimension != static_cast<size_t>(dimension)) {
-        std::string s = fmt::format("id.no : {}: float size : {} not equal to  dimension(create) : {}", i,
-                                    input_dimension, dimension);
+      if (!VectorCodec::CheckVectorDimension(vector_with_id.vector(), dimension)) {
+        std::string s = fmt::format("id.no : {}: float size : {} binary size : {} not match dimension(create) : {}", i,
+                                    vector_with_id.vector().float_values_size(),
+                                    vector_with_id.vector().binary_values_size(), dimension);
         DINGO_LOG(ERROR) << s;
         return {nullptr, butil::Status(pb::error::Errno::EVECTOR_INVALID, s)};
       }
@@ -482,8 +617,7 @@ std::pair<std::unique_ptr<float[]>, butil::Status> VectorIndexUtils::CopyVectorD
   }
 
   for (size_t i = 0; i < vector_with_ids.size(); ++i) {
-    const auto& vector = vector_with_ids[i].vector().float_values();
-    memcpy(vectors.get() + i * dimension, vector.data(), dimension * sizeof(float));
+    VectorCodec::VectorToFloat(vector_with_ids[i].vector(), dimension, vectors.get() + i * dimension);
 
     if (normalize) {
       VectorIndexUtils::NormalizeVectorForFaiss(vectors.get() + i * dimension, dimension);
@@ -506,17 +640,17 @@ std::pair<std::unique_ptr<float[]>, butil::Status> VectorIndexUtils::CheckAndCop
   }
 
   for (size_t i = 0; i < vector_with_ids.size(); ++i) {
-    if (vector_with_ids[i].vector().float_values_size() != dimension) {
+    // integer vectors are widened to float.
+    if (!VectorCodec::VectorToFloat(vector_with_ids[i].vector(), dimension, vectors.get() + i * dimension)) {
       std::string s = fmt::format(
-          "vector dimension is not equal to index dimension, vector id : {}, float_value_size: {}, index dimension: {}",
-          vector_with_ids[i].id(), vector_with_ids[i].vector().float_values_size(), dimension);
+          "vector dimension is not equal to index dimension, vector id : {}, float_value_size: {}, binary_value_size: "
+          "{}, index dimension: {}",
+          vector_with_ids[i].id(), vector_with_ids[i].vector().float_values_size(),
+          vector_with_ids[i].vector().binary_values_size(), dimension);
 
       DINGO_LOG(ERROR) << s;
       return {nullptr, butil::Status(pb::error::Errno::EVECTOR_INVALID, s)};
     } else {
-      const auto& vector = vector_with_ids[i].vector().float_values();
-      memcpy(vectors.get() + i * dimension, vector.data(), dimension * sizeof(float));
-
       if (normalize) {
         VectorIndexUtils::NormalizeVectorForFaiss(vectors.get() + i * dimension, dimension);
       }
@@ -526,6 +660,22 @@ std::pair<std::unique_ptr<float[]>, butil::Status> VectorIndexUtils::CheckAndCop
   return {std::move(vectors), butil::Status::OK()};
 }
 
+std::pair<VectorDataView, butil::Status> VectorIndexUtils::CheckAndViewVectorData(
+    const std::vector<pb::common::VectorWithId>& vector_with_ids, faiss::idx_t dimension, bool normalize) {
+  if (vector_with_ids.size() == 1 && !normalize) {
+    const auto& vector = vector_with_ids[0].vector();
+    if (vector.value_type() == pb::common::ValueType::FLOAT && VectorCodec::CheckVectorDimension(vector, dimension)) {
+      return {VectorDataView(vector.float_values().data()), butil::Status::OK()};
+    }
+  }
+
+  auto [vectors, status] = CheckAndCopyVectorData(vector_with_ids, dimension, normalize);
+  if (!status.ok()) {
+    return {VectorDataView(), status};
+  }
+  return {VectorDataView(std::move(vectors)), butil::Status::OK()};
+}
+
 butil::Status VectorIndexUtils::FillSearchResult(const std::vector<pb::common::VectorWithId>& vector_with_ids,
                                                  uint32_t topk, const std::vector<faiss::Index::distance_t>& distances,
                                                  const std::vector<faiss::idx_t>& labels,
@@ -681,6 +831,15 @@ butil::Status VectorIndexUtils::ValidateVectorIndexParameter(
     return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "vector_index_parameter.index_type is NONE");
   }
 
+  // hamming distance is only supported by the index which computes exact distance of each vector.
+  if (vector_index_parameter.ivf_flat_parameter().metric_type() == pb::common::METRIC_TYPE_HAMMING ||
+      vector_index_parameter.ivf_pq_parameter().metric_type() == pb::common::METRIC_TYPE_HAMMING ||
+      vector_index_parameter.diskann_parameter().metric_type() == pb::common::METRIC_TYPE_HAMMING) {
+    DINGO_LOG(ERROR) << "metric_type HAMMING only support FLAT, HNSW and BRUTEFORCE";
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS,
+                         "metric_type HAMMING only support FLAT, HNSW and BRUTEFORCE");
+  }
+
   // if vector_index_type is HNSW, check hnsw_parameter is set
   if (vector_index_parameter.vector_index_type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
     if (!vector_index_parameter.has_hnsw_parameter()) {
@@ -708,6 +867,22 @@ butil::Status VectorIndexUtils::ValidateVectorIndexParameter(
                            "hnsw_parameter.metric_type is illegal " + std::to_string(hnsw_parameter.metric_type()));
     }
 
+    // the quantizer must match the metric, hamming distance is computed on bits.
+    bool is_hamming = (hnsw_parameter.metric_type() == pb::common::METRIC_TYPE_HAMMING);
+    bool is_binary = (hnsw_parameter.quantizer_type() == pb::common::HNSW_QUANTIZER_TYPE_BINARY);
+    if ((is_hamming && !is_binary && hnsw_parameter.quantizer_type() != pb::common::HNSW_QUANTIZER_TYPE_NONE) ||
+        (is_binary && !is_hamming)) {
+      DINGO_LOG(ERROR) << "hnsw quantizer_type BINARY is only and always for metric_type HAMMING";
+      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS,
+                           "hnsw quantizer_type BINARY is only and always for metric_type HAMMING");
+    }
+    if (hnsw_parameter.quantizer_type() == pb::common::HNSW_QUANTIZER_TYPE_INT8 &&
+        hnsw_parameter.metric_type() == pb::common::METRIC_TYPE_COSINE) {
+      DINGO_LOG(ERROR) << "hnsw quantizer_type INT8 not support metric_type COSINE";
+      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS,
+                           "hnsw quantizer_type INT8 not support metric_type COSINE");
+    }
+
     // check hnsw_parameter.ef_construction
     // The size of the dynamic list for the nearest neighbors during the construction of the graph. This parameter
     // affects the quality of the graph and the construction time. A larger value leads to a higher quality graph
@@ -891,6 +1066,13 @@ butil::Status VectorIndexUtils::ValidateVectorIndexParameter(
       return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
     }
 
+    if (ivf_pq_parameter.use_fast_scan() && nbits_per_idx != Constant::kCreateIvfPqParamFastScanNbitsPerIdx) {
+      std::string s = fmt::format("ivf_pq_parameter.nbits_per_idx is illegal : {} fast scan nbits_per_idx must be {}",
+                                  nbits_per_idx, Constant::kCreateIvfPqParamFastScanNbitsPerIdx);
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+    }
+
     // If all checks pass, return a butil::Status object with no error.
     return butil::Status::OK();
   }
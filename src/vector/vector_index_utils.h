@@ -27,6 +27,22 @@
 
 namespace dingodb {
 
+// Read only float values of query vectors. One float vector without normalization is viewed in the protobuf
+// storage without copy, others are copied into the owned buffer.
+class VectorDataView {
+ public:
+  VectorDataView() = default;
+  explicit VectorDataView(const float* data) : data_(data) {}
+  explicit VectorDataView(std::unique_ptr<float[]> buffer) : buffer_(std::move(buffer)), data_(buffer_.get()) {}
+
+  const float* get() const { return data_; }
+  bool IsView() const { return buffer_ == nullptr && data_ != nullptr; }
+
+ private:
+  std::unique_ptr<float[]> buffer_;
+  const float* data_{nullptr};
+};
+
 class VectorIndexUtils {
  public:
   VectorIndexUtils() = delete;
@@ -45,6 +61,11 @@ class VectorIndexUtils {
   using DoCalcDistanceFunc =
       std::function<butil::Status(const ::dingodb::pb::common::Vector&, const ::dingodb::pb::common::Vector&, bool,
                                   float&, dingodb::pb::common::Vector&, dingodb::pb::common::Vector&)>;
+  // Integer vectors are widened to float values, result is empty if all vectors are float.
+  static butil::Status WidenIntegerVectors(
+      const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& vectors,
+      google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& result);
+
   static butil::Status CalcDistanceCore(
       const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& op_left_vectors,
       const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& op_right_vectors,
@@ -147,6 +168,13 @@ class VectorIndexUtils {
                                                      dingodb::pb::common::Vector& result_op_left_vectors,
                                                      dingodb::pb::common::Vector& result_op_right_vectors);
 
+  // count of different bits, non zero value is bit 1.
+  static butil::Status DoCalcHammingDistance(const ::dingodb::pb::common::Vector& op_left_vectors,
+                                             const ::dingodb::pb::common::Vector& op_right_vectors,
+                                             bool is_return_normlize, float& distance,
+                                             dingodb::pb::common::Vector& result_op_left_vectors,
+                                             dingodb::pb::common::Vector& result_op_right_vectors);
+
   static void ResultOpVectorAssignment(dingodb::pb::common::Vector& result_op_vectors,
                                        const ::dingodb::pb::common::Vector& op_vectors);
 
@@ -159,6 +187,13 @@ class VectorIndexUtils {
   static void NormalizeVectorForFaiss(float* x, int32_t d);
   static void NormalizeVectorForHnsw(const float* data, uint32_t dimension, float* norm_array);
 
+  // Map values to bit 0 or 1 for hamming distance, hamming distance of bits is the squared L2 distance.
+  static void BinarizeVector(float* x, size_t d);
+
+  // Float values of vector for index, integer vector is widened into buffer.
+  // Return nullptr if values not match dimension.
+  static const float* GetFloatValues(const pb::common::Vector& vector, int32_t dimension, std::vector<float>& buffer);
+
   static std::pair<std::unique_ptr<faiss::idx_t[]>, butil::Status> CopyVectorId(const std::vector<int64_t>& delete_ids);
 
   static std::pair<std::unique_ptr<faiss::idx_t[]>, butil::Status> CheckAndCopyVectorId(
@@ -170,6 +205,10 @@ class VectorIndexUtils {
   static std::pair<std::unique_ptr<float[]>, butil::Status> CheckAndCopyVectorData(
       const std::vector<pb::common::VectorWithId>& vector_with_ids, faiss::idx_t dimension, bool normalize);
 
+  // Same as CheckAndCopyVectorData, but the values are not copied when they are contiguous in protobuf already.
+  static std::pair<VectorDataView, butil::Status> CheckAndViewVectorData(
+      const std::vector<pb::common::VectorWithId>& vector_with_ids, faiss::idx_t dimension, bool normalize);
+
   static butil::Status FillSearchResult(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
                                         const std::vector<faiss::Index::distance_t>& distances,
                                         const std::vector<faiss::idx_t>& labels, pb::common::MetricType metric_type,
@@ -184,6 +223,27 @@ class VectorIndexUtils {
   static butil::Status ValidateVectorIndexParameter(const pb::common::VectorIndexParameter& vector_index_parameter);
 };
 
+// Intra-query threads of search from the budget shared by all concurrent searches, restore when destroy.
+// A query runs parallel only when the budget has free threads, so the parallelism of single query
+// does not oversubscribe the cores under high concurrency.
+// It sets the omp threads of faiss in current thread, and tells hnsw whether to split the batch to thread pool.
+// Disabled when vector_search_thread_num is 0, nothing is changed.
+class SearchThreadGuard {
+ public:
+  SearchThreadGuard();
+  ~SearchThreadGuard();
+
+  SearchThreadGuard(const SearchThreadGuard&) = delete;
+  SearchThreadGuard& operator=(const SearchThreadGuard&) = delete;
+
+  bool IsParallel() const { return thread_num_ != 1; }
+
+ private:
+  // 0 is disabled
+  int32_t thread_num_{0};
+  int32_t origin_thread_num_{0};
+};
+
 }  // namespace dingodb
 
 #endif  // DINGODB_VECTOR_INDEX_UTILS_H_
@@ -14,27 +14,37 @@
 
 #include "vector/vector_reader.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <deque>
 #include <memory>
+#include <random>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "butil/status.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "coprocessor/coprocessor_scalar.h"
 #include "coprocessor/coprocessor_v2.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
+#include "metrics/store_metrics_manager.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "server/server.h"
 #include "vector/codec.h"
+#include "vector/vector_filter_planner.h"
 #include "vector/vector_index.h"
 #include "vector/vector_index_factory.h"
 #include "vector/vector_index_flat.h"
+#include "vector/vector_index_utils.h"
+#include "vector/vector_scalar_index.h"
+#include "vector/vector_scan_kernel.h"
 
 namespace dingodb {
 
@@ -45,10 +55,17 @@ namespace dingodb {
 
 DEFINE_int64(vector_index_max_range_search_result_count, 1024, "max range search result count");
 DEFINE_int64(vector_index_bruteforce_batch_count, 2048, "bruteforce batch count");
+DEFINE_int64(vector_filter_planner_sample_count, 1024, "scalar data sample count of region for filter planner");
+DEFINE_int64(vector_filter_planner_sample_interval_s, 60, "interval of sampling region scalar data again");
 
 bvar::LatencyRecorder g_bruteforce_search_latency("dingo_bruteforce_search_latency");
 bvar::LatencyRecorder g_bruteforce_range_search_latency("dingo_bruteforce_range_search_latency");
 
+bvar::Adder<int64_t> g_vector_filter_plan_post_filter_count("dingo_vector_filter_plan_post_filter_count");
+bvar::Adder<int64_t> g_vector_filter_plan_pre_filter_count("dingo_vector_filter_plan_pre_filter_count");
+bvar::Adder<int64_t> g_vector_filter_plan_brute_force_count("dingo_vector_filter_plan_brute_force_count");
+bvar::Adder<int64_t> g_vector_filter_plan_fallback_count("dingo_vector_filter_plan_fallback_count");
+
 butil::Status VectorReader::QueryVectorWithId(const pb::common::Range& region_range, int64_t partition_id,
                                               int64_t vector_id, bool with_vector_data,
                                               pb::common::VectorWithId& vector_with_id) {
@@ -63,7 +80,7 @@ butil::Status VectorReader::QueryVectorWithId(const pb::common::Range& region_ra
 
   if (with_vector_data) {
     pb::common::Vector vector;
-    if (!vector.ParseFromString(value)) {
+    if (!VectorCodec::DecodeVectorValue(value, vector)) {
       return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
     }
     vector_with_id.mutable_vector()->Swap(&vector);
@@ -89,9 +106,17 @@ butil::Status VectorReader::SearchVector(
   bool with_vector_data = !(parameter.without_vector_data());
   std::vector<pb::index::VectorWithDistanceResult> tmp_results;
 
-  // scalar post filter
-  if (dingodb::pb::common::VectorFilter::SCALAR_FILTER == vector_filter &&
-      dingodb::pb::common::VectorFilterType::QUERY_POST == vector_filter_type) {
+  vector_index->IncSearchQueryCount(vector_with_ids.size());
+
+  if (VectorFilterPlanner::IsApplicable(vector_with_ids, parameter)) {  // scalar filter chosen by planner
+    butil::Status status = DoVectorSearchByFilterPlanner(partition_id, vector_index, region_range, vector_with_ids,
+                                                         parameter, vector_with_distance_results);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("DoVectorSearchByFilterPlanner failed");
+      return status;
+    }
+  } else if (dingodb::pb::common::VectorFilter::SCALAR_FILTER == vector_filter &&
+             dingodb::pb::common::VectorFilterType::QUERY_POST == vector_filter_type) {  // scalar post filter
     uint32_t top_n = parameter.top_n();
     bool enable_range_search = parameter.enable_range_search();
 
@@ -123,19 +148,31 @@ butil::Status VectorReader::SearchVector(
         return status;
       }
 
+      int64_t filter_checked_count = 0;
+      int64_t filter_passed_count = 0;
+      std::unordered_map<int64_t, bool> compare_results;
       for (auto& vector_with_distance_result : tmp_results) {
         pb::index::VectorWithDistanceResult new_vector_with_distance_result;
 
         for (auto& temp_vector_with_distance : *vector_with_distance_result.mutable_vector_with_distances()) {
           int64_t temp_id = temp_vector_with_distance.vector_with_id().id();
-          bool compare_result = false;
-          butil::Status status = CompareVectorScalarDataWithCoprocessor(region_range, partition_id, temp_id,
-                                                                        scalar_coprocessor, compare_result);
-          if (!status.ok()) {
-            return status;
-          }
+          // The queries of batch share the candidates, every candidate only compare once.
+          auto it = compare_results.find(temp_id);
+          if (it == compare_results.end()) {
+            bool compare_result = false;
+            butil::Status status = CompareVectorScalarDataWithCoprocessor(region_range, partition_id, temp_id,
+                                                                          scalar_coprocessor, compare_result);
+            if (!status.ok()) {
+              return status;
+            }
 
-          if (!compare_result) {
+            ++filter_checked_count;
+            if (compare_result) {
+              ++filter_passed_count;
+            }
+            it = compare_results.emplace(temp_id, compare_result).first;
+          }
+          if (!it->second) {
             continue;
           }
 
@@ -149,6 +186,7 @@ butil::Status VectorReader::SearchVector(
         }
         vector_with_distance_results.emplace_back(std::move(new_vector_with_distance_result));
       }
+      vector_index->AddFilterStats(filter_checked_count, filter_passed_count);
 
     } else {  //! parameter.has_vector_coprocessor() && vector_with_ids[0].scalar_data().scalar_data_size() != 0
       top_n *= 10;
@@ -159,18 +197,29 @@ butil::Status VectorReader::SearchVector(
         return status;
       }
 
+      int64_t filter_checked_count = 0;
+      int64_t filter_passed_count = 0;
+      std::unordered_map<int64_t, bool> compare_results;
       for (auto& vector_with_distance_result : tmp_results) {
         pb::index::VectorWithDistanceResult new_vector_with_distance_result;
 
         for (auto& temp_vector_with_distance : *vector_with_distance_result.mutable_vector_with_distances()) {
           int64_t temp_id = temp_vector_with_distance.vector_with_id().id();
-          bool compare_result = false;
-          butil::Status status = CompareVectorScalarData(region_range, partition_id, temp_id,
-                                                         vector_with_ids[0].scalar_data(), compare_result);
-          if (!status.ok()) {
-            return status;
+          auto it = compare_results.find(temp_id);
+          if (it == compare_results.end()) {
+            bool compare_result = false;
+            butil::Status status = CompareVectorScalarData(region_range, partition_id, temp_id,
+                                                           vector_with_ids[0].scalar_data(), compare_result);
+            if (!status.ok()) {
+              return status;
+            }
+            ++filter_checked_count;
+            if (compare_result) {
+              ++filter_passed_count;
+            }
+            it = compare_results.emplace(temp_id, compare_result).first;
           }
-          if (!compare_result) {
+          if (!it->second) {
             continue;
           }
 
@@ -184,6 +233,7 @@ butil::Status VectorReader::SearchVector(
         }
         vector_with_distance_results.emplace_back(std::move(new_vector_with_distance_result));
       }
+      vector_index->AddFilterStats(filter_checked_count, filter_passed_count);
     }
   } else if (dingodb::pb::common::VectorFilter::VECTOR_ID_FILTER == vector_filter) {  // vector id array search
     butil::Status status = DoVectorSearchForVectorIdPreFilter(vector_index, vector_with_ids, parameter, region_range,
@@ -213,22 +263,21 @@ butil::Status VectorReader::SearchVector(
 
   // if vector index does not support restruct vector ,we restruct it using RocksDB
   if (with_vector_data) {
+    std::vector<pb::common::VectorWithId*> no_data_vector_with_ids;
     for (auto& result : vector_with_distance_results) {
       for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
         if (vector_with_distance.vector_with_id().vector().float_values_size() > 0 ||
             vector_with_distance.vector_with_id().vector().binary_values_size() > 0) {
           continue;
         }
-
-        pb::common::VectorWithId vector_with_id;
-        auto status = QueryVectorWithId(region_range, partition_id, vector_with_distance.vector_with_id().id(), true,
-                                        vector_with_id);
-        if (!status.ok()) {
-          return status;
-        }
-        vector_with_distance.mutable_vector_with_id()->Swap(&vector_with_id);
+        no_data_vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
       }
     }
+
+    auto status = BatchQueryVectorData(region_range, partition_id, no_data_vector_with_ids);
+    if (!status.ok()) {
+      return status;
+    }
   }
 
   return butil::Status();
@@ -257,25 +306,26 @@ butil::Status VectorReader::QueryVectorTableData(const pb::common::Range& region
 butil::Status VectorReader::QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
                                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& result : results) {
     for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
-      pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-      QueryVectorTableData(region_range, partition_id, vector_with_id);
+      vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
     }
   }
 
-  return butil::Status();
+  return BatchQueryVectorTableData(region_range, partition_id, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
                                                  std::vector<pb::common::VectorWithDistance>& vector_with_distances) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
+  vector_with_ids.reserve(vector_with_distances.size());
   for (auto& vector_with_distance : vector_with_distances) {
-    pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-    QueryVectorTableData(region_range, partition_id, vector_with_id);
+    vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
   }
 
-  return butil::Status();
+  return BatchQueryVectorTableData(region_range, partition_id, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
@@ -312,23 +362,144 @@ butil::Status VectorReader::QueryVectorScalarData(const pb::common::Range& regio
                                                   std::vector<std::string> selected_scalar_keys,
                                                   std::vector<pb::index::VectorWithDistanceResult>& results) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& result : results) {
     for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
-      pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-      QueryVectorScalarData(region_range, partition_id, selected_scalar_keys, vector_with_id);
+      vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
     }
   }
 
-  return butil::Status();
+  return BatchQueryVectorScalarData(region_range, partition_id, selected_scalar_keys, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
                                                   std::vector<std::string> selected_scalar_keys,
                                                   std::vector<pb::common::VectorWithDistance>& vector_with_distances) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
+  vector_with_ids.reserve(vector_with_distances.size());
   for (auto& vector_with_distance : vector_with_distances) {
-    pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-    QueryVectorScalarData(region_range, partition_id, selected_scalar_keys, vector_with_id);
+    vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
+  }
+
+  return BatchQueryVectorScalarData(region_range, partition_id, selected_scalar_keys, vector_with_ids);
+}
+
+butil::Status VectorReader::BatchGetVectorValues(const std::string& cf_name, const pb::common::Range& region_range,
+                                                 int64_t partition_id,
+                                                 const std::vector<pb::common::VectorWithId*>& vector_with_ids,
+                                                 std::unordered_map<int64_t, std::string>& values) {
+  std::vector<std::string> keys;
+  keys.reserve(vector_with_ids.size());
+  std::unordered_set<int64_t> vector_ids;
+  for (const auto* vector_with_id : vector_with_ids) {
+    if (vector_ids.insert(vector_with_id->id()).second) {
+      std::string key;
+      VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, vector_with_id->id(), key);
+      keys.push_back(std::move(key));
+    }
+  }
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  std::vector<pb::common::KeyValue> kvs;
+  auto status = reader_->KvBatchGet(cf_name, keys, kvs);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("Batch get {} vectors from {} failed, error: {}", keys.size(), cf_name,
+                                    status.error_str());
+    return status;
+  }
+
+  values.reserve(kvs.size());
+  for (auto& kv : kvs) {
+    values.emplace(VectorCodec::DecodeVectorId(kv.key()), std::move(*kv.mutable_value()));
+  }
+
+  return butil::Status();
+}
+
+butil::Status VectorReader::BatchQueryVectorData(const pb::common::Range& region_range, int64_t partition_id,
+                                                 const std::vector<pb::common::VectorWithId*>& vector_with_ids) {
+  std::unordered_map<int64_t, std::string> values;
+  auto status = BatchGetVectorValues(Constant::kStoreDataCF, region_range, partition_id, vector_with_ids, values);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (auto* vector_with_id : vector_with_ids) {
+    auto it = values.find(vector_with_id->id());
+    if (it == values.end()) {
+      return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found vector %ld", vector_with_id->id());
+    }
+
+    if (!VectorCodec::DecodeVectorValue(it->second, *vector_with_id->mutable_vector())) {
+      return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
+    }
+  }
+
+  return butil::Status();
+}
+
+butil::Status VectorReader::BatchQueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
+                                                       const std::vector<std::string>& selected_scalar_keys,
+                                                       const std::vector<pb::common::VectorWithId*>& vector_with_ids) {
+  std::unordered_map<int64_t, std::string> values;
+  auto status = BatchGetVectorValues(Constant::kVectorScalarCF, region_range, partition_id, vector_with_ids, values);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // parse once for the same vector id of the queries of batch
+  std::unordered_map<int64_t, pb::common::VectorScalardata> vector_scalars;
+  for (auto* vector_with_id : vector_with_ids) {
+    auto value_it = values.find(vector_with_id->id());
+    if (value_it == values.end()) {
+      continue;
+    }
+
+    auto scalar_it = vector_scalars.find(vector_with_id->id());
+    if (scalar_it == vector_scalars.end()) {
+      pb::common::VectorScalardata vector_scalar;
+      if (!vector_scalar.ParseFromString(value_it->second)) {
+        DINGO_LOG(WARNING) << fmt::format("Decode vector scalar data failed, vector_id: {}", vector_with_id->id());
+        continue;
+      }
+      scalar_it = vector_scalars.emplace(vector_with_id->id(), std::move(vector_scalar)).first;
+    }
+
+    auto* scalar = vector_with_id->mutable_scalar_data()->mutable_scalar_data();
+    for (const auto& [key, value] : scalar_it->second.scalar_data()) {
+      if (!selected_scalar_keys.empty() &&
+          std::find(selected_scalar_keys.begin(), selected_scalar_keys.end(), key) == selected_scalar_keys.end()) {
+        continue;
+      }
+
+      scalar->insert({key, value});
+    }
+  }
+
+  return butil::Status();
+}
+
+butil::Status VectorReader::BatchQueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
+                                                      const std::vector<pb::common::VectorWithId*>& vector_with_ids) {
+  std::unordered_map<int64_t, std::string> values;
+  auto status = BatchGetVectorValues(Constant::kVectorTableCF, region_range, partition_id, vector_with_ids, values);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (auto* vector_with_id : vector_with_ids) {
+    auto it = values.find(vector_with_id->id());
+    if (it == values.end()) {
+      continue;
+    }
+
+    if (!vector_with_id->mutable_table_data()->ParseFromString(it->second)) {
+      DINGO_LOG(WARNING) << fmt::format("Decode vector table data failed, vector_id: {}", vector_with_id->id());
+      vector_with_id->clear_table_data();
+    }
   }
 
   return butil::Status();
@@ -440,48 +611,63 @@ butil::Status VectorReader::VectorBatchSearch(std::shared_ptr<Engine::VectorRead
 
 butil::Status VectorReader::VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                              std::vector<pb::common::VectorWithId>& vector_with_ids) {
-  for (auto vector_id : ctx->vector_ids) {
-    pb::common::VectorWithId vector_with_id;
-    auto status =
-        QueryVectorWithId(ctx->region_range, ctx->partition_id, vector_id, ctx->with_vector_data, vector_with_id);
-    if ((!status.ok()) && status.error_code() != pb::error::EKEY_NOT_FOUND) {
-      DINGO_LOG(WARNING) << fmt::format("Query vector_with_id failed, vector_id: {} error: {}", vector_id,
-                                        status.error_str());
+  // the vector data cf tells whether the ids exist, read it even without vector data.
+  std::vector<pb::common::VectorWithId> query_vector_with_ids(ctx->vector_ids.size());
+  std::vector<pb::common::VectorWithId*> query_vector_with_id_ptrs;
+  query_vector_with_id_ptrs.reserve(ctx->vector_ids.size());
+  for (size_t i = 0; i < ctx->vector_ids.size(); ++i) {
+    query_vector_with_ids[i].set_id(ctx->vector_ids[i]);
+    query_vector_with_id_ptrs.push_back(&query_vector_with_ids[i]);
+  }
+
+  std::unordered_map<int64_t, std::string> values;
+  auto status = BatchGetVectorValues(Constant::kStoreDataCF, ctx->region_range, ctx->partition_id,
+                                     query_vector_with_id_ptrs, values);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("Query vector_with_id failed, count: {} error: {}", ctx->vector_ids.size(),
+                                      status.error_str());
+  }
+
+  std::vector<pb::common::VectorWithId*> exist_vector_with_ids;
+  exist_vector_with_ids.reserve(query_vector_with_ids.size());
+  for (auto& vector_with_id : query_vector_with_ids) {
+    auto it = values.find(vector_with_id.id());
+    if (it == values.end()) {
+      // if the id is not exist, the vector_with_id will be empty, sdk client will handle this
+      vector_with_id.Clear();
+      continue;
     }
 
-    // if the id is not exist, the vector_with_id will be empty, sdk client will handle this
-    vector_with_ids.push_back(vector_with_id);
+    if (ctx->with_vector_data && !VectorCodec::DecodeVectorValue(it->second, *vector_with_id.mutable_vector())) {
+      DINGO_LOG(WARNING) << fmt::format("Query vector_with_id failed, vector_id: {} error: parse vector failed",
+                                        vector_with_id.id());
+      vector_with_id.Clear();
+      continue;
+    }
+    exist_vector_with_ids.push_back(&vector_with_id);
   }
 
   if (ctx->with_scalar_data) {
-    for (auto& vector_with_id : vector_with_ids) {
-      if (vector_with_id.ByteSizeLong() == 0) {
-        continue;
-      }
-
-      auto status =
-          QueryVectorScalarData(ctx->region_range, ctx->partition_id, ctx->selected_scalar_keys, vector_with_id);
-      if (!status.ok()) {
-        DINGO_LOG(WARNING) << fmt::format("Query vector scalar data failed, vector_id: {} error: {} ",
-                                          vector_with_id.id(), status.error_str());
-      }
+    auto status = BatchQueryVectorScalarData(ctx->region_range, ctx->partition_id, ctx->selected_scalar_keys,
+                                             exist_vector_with_ids);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("Query vector scalar data failed, count: {} error: {} ",
+                                        exist_vector_with_ids.size(), status.error_str());
     }
   }
 
   if (ctx->with_table_data) {
-    for (auto& vector_with_id : vector_with_ids) {
-      if (vector_with_id.ByteSizeLong() == 0) {
-        continue;
-      }
-
-      auto status = QueryVectorTableData(ctx->region_range, ctx->partition_id, vector_with_id);
-      if (!status.ok()) {
-        DINGO_LOG(WARNING) << fmt::format("Query vector table data failed, vector_id: {} error: {} ",
-                                          vector_with_id.id(), status.error_str());
-      }
+    auto status = BatchQueryVectorTableData(ctx->region_range, ctx->partition_id, exist_vector_with_ids);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("Query vector table data failed, count: {} error: {} ",
+                                        exist_vector_with_ids.size(), status.error_str());
     }
   }
 
+  for (auto& vector_with_id : query_vector_with_ids) {
+    vector_with_ids.push_back(std::move(vector_with_id));
+  }
+
   return butil::Status::OK();
 }
 
@@ -605,6 +791,8 @@ butil::Status VectorReader::VectorGetRegionMetrics(int64_t /*region_id*/, const
   region_metrics.set_max_id(max_id);
   region_metrics.set_min_id(min_id);
 
+  vector_index->GetSearchStats(*region_metrics.mutable_search_stats());
+
   return butil::Status();
 }
 
@@ -820,56 +1008,89 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilter(
     const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
     std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {  // NOLINT
   // scalar pre filter search
-  butil::Status status;
-  bool use_coprocessor = parameter.has_vector_coprocessor();
-
-  if (!use_coprocessor && vector_with_ids[0].scalar_data().scalar_data_size() == 0) {
-    std::string s = fmt::format("vector_with_ids[0].scalar_data() empty not support");
-    DINGO_LOG(ERROR) << s;
-    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+  VectorFilterPlanner::ScalarFilterFunc filter_func;
+  butil::Status status = NewScalarFilterFunc(vector_with_ids, parameter, filter_func);
+  if (!status.ok()) {
+    return status;
   }
 
-  const auto& std_vector_scalar = vector_with_ids[0].scalar_data();
-  auto lambda_scalar_compare_function =
-      [&std_vector_scalar](const pb::common::VectorScalardata& internal_vector_scalar) {
-        for (const auto& [key, value] : std_vector_scalar.scalar_data()) {
-          auto it = internal_vector_scalar.scalar_data().find(key);
-          if (it == internal_vector_scalar.scalar_data().end()) {
-            return false;
-          }
+  std::vector<int64_t> vector_ids;
+  if (!LookupScalarInvertedIndex(vector_index, region_range, vector_with_ids, parameter, vector_ids)) {
+    status = ScanScalarFilterIds(region_range, filter_func, vector_ids);
+    if (!status.ok()) {
+      return status;
+    }
+  }
 
-          bool compare_result = Helper::IsEqualVectorScalarValue(value, it->second);
-          if (!compare_result) {
-            return false;
-          }
-        }
-        return true;
-      };
+  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
+  status = VectorReader::SetVectorIndexIdsFilter(vector_index, filters, vector_ids);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
 
-  const auto& coprocessor = parameter.vector_coprocessor();
+  status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids, parameter,
+                                                     vector_with_distance_results, parameter.top_n(), filters);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
 
-  std::shared_ptr<RawCoprocessor> scalar_coprocessor = std::make_shared<CoprocessorScalar>();
+  return butil::Status::OK();
+}
 
-  if (use_coprocessor) {
-    status = scalar_coprocessor->Open(CoprocessorPbWrapper{coprocessor});
+butil::Status VectorReader::NewScalarFilterFunc(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                                const pb::common::VectorSearchParameter& parameter,
+                                                VectorFilterPlanner::ScalarFilterFunc& filter_func) {
+  if (parameter.has_vector_coprocessor()) {
+    std::shared_ptr<RawCoprocessor> scalar_coprocessor = std::make_shared<CoprocessorScalar>();
+    auto status = scalar_coprocessor->Open(CoprocessorPbWrapper{parameter.vector_coprocessor()});
     if (!status.ok()) {
       DINGO_LOG(ERROR) << "scalar coprocessor::Open failed " << status.error_cstr();
       return status;
     }
+
+    filter_func = [scalar_coprocessor](const pb::common::VectorScalardata& internal_vector_scalar) {
+      bool is_reverse = false;
+      butil::Status status = scalar_coprocessor->Filter(internal_vector_scalar, is_reverse);
+      if (!status.ok()) {
+        LOG(ERROR) << "[" << __PRETTY_FUNCTION__ << "] "
+                   << "scalar coprocessor::Filter failed " << status.error_cstr();
+        return false;
+      }
+      return is_reverse;
+    };
+    return butil::Status::OK();
   }
 
-  auto lambda_scalar_compare_with_coprocessor_function =
-      [&scalar_coprocessor](const pb::common::VectorScalardata& internal_vector_scalar) {
-        bool is_reverse = false;
-        butil::Status status = scalar_coprocessor->Filter(internal_vector_scalar, is_reverse);
-        if (!status.ok()) {
-          LOG(ERROR) << "[" << __PRETTY_FUNCTION__ << "] "
-                     << "scalar coprocessor::Filter failed " << status.error_cstr();
-          return false;
-        }
-        return is_reverse;
-      };
+  if (vector_with_ids.empty() || vector_with_ids[0].scalar_data().scalar_data_size() == 0) {
+    std::string s = fmt::format("vector_with_ids[0].scalar_data() empty not support");
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+  }
+
+  filter_func = [std_vector_scalar = vector_with_ids[0].scalar_data()](
+                    const pb::common::VectorScalardata& internal_vector_scalar) {
+    for (const auto& [key, value] : std_vector_scalar.scalar_data()) {
+      auto it = internal_vector_scalar.scalar_data().find(key);
+      if (it == internal_vector_scalar.scalar_data().end()) {
+        return false;
+      }
+
+      bool compare_result = Helper::IsEqualVectorScalarValue(value, it->second);
+      if (!compare_result) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  return butil::Status::OK();
+}
 
+butil::Status VectorReader::ScanScalarFilterIds(const pb::common::Range& region_range,
+                                                const VectorFilterPlanner::ScalarFilterFunc& filter_func,
+                                                std::vector<int64_t>& vector_ids) {
   const std::string& start_key = region_range.start_key();
   const std::string& end_key = region_range.end_key();
 
@@ -884,7 +1105,6 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilter(
     return butil::Status(pb::error::Errno::EINTERNAL, "New iterator failed");
   }
 
-  std::vector<int64_t> vector_ids;
   vector_ids.reserve(1024);
   for (iter->Seek(start_key); iter->Valid(); iter->Next()) {
     pb::common::VectorScalardata internal_vector_scalar;
@@ -892,10 +1112,7 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilter(
       return butil::Status(pb::error::EINTERNAL, "Internal error, decode VectorScalar failed");
     }
 
-    bool compare_result = use_coprocessor ? lambda_scalar_compare_with_coprocessor_function(internal_vector_scalar)
-                                          : lambda_scalar_compare_function(internal_vector_scalar);
-
-    if (compare_result) {
+    if (filter_func(internal_vector_scalar)) {
       std::string key(iter->Key());
       int64_t internal_vector_id = VectorCodec::DecodeVectorId(key);
       if (0 == internal_vector_id) {
@@ -907,47 +1124,313 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilter(
     }
   }
 
-  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
-  status = VectorReader::SetVectorIndexIdsFilter(vector_index, filters, vector_ids);
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << status.error_cstr();
-    return status;
+  return butil::Status::OK();
+}
+
+bool VectorReader::LookupScalarInvertedIndex(VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+                                             const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                             const pb::common::VectorSearchParameter& parameter,
+                                             std::vector<int64_t>& vector_ids) {
+  // Coprocessor filter is not equal filter.
+  if (!VectorScalarInvertedIndex::IsEnabled() || parameter.has_vector_coprocessor() || vector_with_ids.empty()) {
+    return false;
   }
 
-  status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids, parameter,
-                                                     vector_with_distance_results, parameter.top_n(), filters);
+  auto scalar_inverted_index = vector_index->ScalarInvertedIndex();
+  const auto& query = vector_with_ids[0].scalar_data();
+  if (scalar_inverted_index->Lookup(region_range, query, vector_ids)) {
+    return true;
+  }
+
+  auto status = scalar_inverted_index->Build(reader_, region_range);
   if (!status.ok()) {
-    DINGO_LOG(ERROR) << status.error_cstr();
-    return status;
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.scalar_inverted_index][id({})] build failed, error: {}",
+                                      vector_index->Id(), Helper::PrintStatus(status));
+    return false;
   }
 
-  return butil::Status::OK();
+  return scalar_inverted_index->Lookup(region_range, query, vector_ids);
 }
 
-butil::Status VectorReader::DoVectorSearchForTableCoprocessor(  // NOLINT(*static)
-    [[maybe_unused]] VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
-    [[maybe_unused]] const std::vector<pb::common::VectorWithId>& vector_with_ids,
-    [[maybe_unused]] const pb::common::VectorSearchParameter& parameter,
-    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {  // NOLINT
-  //   std::string s = fmt::format("vector index search table filter for coprocessor not support now !!! ");
-  //   DINGO_LOG(ERROR) << s;
-  //   return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, s);
-
-  DINGO_LOG(DEBUG) << "vector index search table filter for coprocessor support";
+butil::Status VectorReader::FilterVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
+                                                   int64_t vector_id,
+                                                   const VectorFilterPlanner::ScalarFilterFunc& filter_func,
+                                                   bool& is_match) {
+  is_match = false;
+  std::string key, value;
+  VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, vector_id, key);
 
-  // table pre filter search
+  auto status = reader_->KvGet(Constant::kVectorScalarCF, key, value);
+  if (status.error_code() == pb::error::EKEY_NOT_FOUND) {
+    // deleted after search.
+    return butil::Status::OK();
+  } else if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("Get vector scalar data failed, vector_id: {} error: {} ", vector_id,
+                                      status.error_str());
+    return status;
+  }
 
-  if (!parameter.has_vector_coprocessor()) {
-    std::string s = fmt::format("vector_coprocessor empty not support");
-    DINGO_LOG(ERROR) << s;
-    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+  pb::common::VectorScalardata vector_scalar;
+  if (!vector_scalar.ParseFromString(value)) {
+    return butil::Status(pb::error::EINTERNAL, "Decode vector scalar data failed");
   }
 
-  const auto& coprocessor = parameter.vector_coprocessor();
+  is_match = filter_func(vector_scalar);
+  return butil::Status::OK();
+}
 
-  std::shared_ptr<RawCoprocessor> table_coprocessor = std::make_shared<CoprocessorV2>();
-  butil::Status status;
-  status = table_coprocessor->Open(CoprocessorPbWrapper{coprocessor});
+butil::Status VectorReader::GetVectorScalarSamples(
+    int64_t region_id, const pb::common::Range& region_range, int64_t partition_id,
+    std::shared_ptr<const std::vector<pb::common::VectorScalardata>>& samples) {
+  store::RegionMetricsPtr region_metrics;
+  auto metrics_manager = Server::GetInstance().GetStoreMetricsManager();
+  if (metrics_manager != nullptr) {
+    region_metrics = metrics_manager->GetStoreRegionMetrics()->GetMetrics(region_id);
+  }
+
+  int64_t min_id = 0;
+  int64_t max_id = 0;
+  if (region_metrics != nullptr) {
+    int64_t timestamp_ms = 0;
+    samples = region_metrics->GetVectorScalarSamples(timestamp_ms);
+    if (samples != nullptr &&
+        butil::gettimeofday_ms() - timestamp_ms < FLAGS_vector_filter_planner_sample_interval_s * 1000) {
+      return butil::Status::OK();
+    }
+
+    if (samples != nullptr) {
+      // other searches keep using the old samples until sampled again.
+      region_metrics->SetVectorScalarSamples(samples);
+    }
+    min_id = region_metrics->GetVectorMinId();
+    max_id = region_metrics->GetVectorMaxId();
+  }
+
+  auto new_samples = std::make_shared<std::vector<pb::common::VectorScalardata>>();
+  auto status = SampleVectorScalarData(region_range, partition_id, min_id, max_id, *new_samples);
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (region_metrics != nullptr) {
+    region_metrics->SetVectorScalarSamples(new_samples);
+  }
+  samples = new_samples;
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorReader::SampleVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
+                                                   int64_t min_id, int64_t max_id,
+                                                   std::vector<pb::common::VectorScalardata>& samples) {
+  IteratorOptions options;
+  options.upper_bound = region_range.end_key();
+
+  auto iter = reader_->NewIterator(Constant::kVectorScalarCF, options);
+  if (iter == nullptr) {
+    DINGO_LOG(ERROR) << fmt::format("New iterator failed, region range [{}-{})",
+                                    Helper::StringToHex(region_range.start_key()),
+                                    Helper::StringToHex(region_range.end_key()));
+    return butil::Status(pb::error::Errno::EINTERNAL, "New iterator failed");
+  }
+
+  int64_t sample_count = FLAGS_vector_filter_planner_sample_count;
+  samples.reserve(sample_count);
+
+  auto add_sample = [&]() -> butil::Status {
+    pb::common::VectorScalardata vector_scalar;
+    if (!vector_scalar.ParseFromArray(iter->Value().data(), iter->Value().size())) {
+      return butil::Status(pb::error::EINTERNAL, "Internal error, decode VectorScalar failed");
+    }
+    samples.push_back(std::move(vector_scalar));
+    return butil::Status::OK();
+  };
+
+  // few vectors or id range is unknown, take from the head.
+  if (max_id - min_id <= sample_count) {
+    for (iter->Seek(region_range.start_key()); iter->Valid(); iter->Next()) {
+      if (static_cast<int64_t>(samples.size()) >= sample_count) {
+        break;
+      }
+
+      auto status = add_sample();
+      if (!status.ok()) {
+        return status;
+      }
+    }
+    return butil::Status::OK();
+  }
+
+  // seek at random ids, the ids are not dense, it is not uniform but good enough for planning.
+  std::mt19937_64 rng(std::random_device{}());
+  std::uniform_int_distribution<int64_t> distrib(min_id, max_id);
+  for (int64_t i = 0; i < sample_count; ++i) {
+    std::string key;
+    VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, distrib(rng), key);
+    iter->Seek(std::max(key, region_range.start_key()));
+    if (!iter->Valid()) {
+      iter->Seek(region_range.start_key());
+      if (!iter->Valid()) {
+        break;
+      }
+    }
+
+    auto status = add_sample();
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorReader::DoVectorSearchByFilterPlanner(
+    int64_t partition_id, VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+    const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
+    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {
+  VectorFilterPlanner::ScalarFilterFunc filter_func;
+  auto status = NewScalarFilterFunc(vector_with_ids, parameter, filter_func);
+  if (!status.ok()) {
+    return status;
+  }
+
+  int64_t vector_count = 0;
+  vector_index->GetCount(vector_count);
+
+  // The inverted index give the exact selectivity.
+  std::vector<int64_t> vector_ids;
+  bool is_lookup = LookupScalarInvertedIndex(vector_index, region_range, vector_with_ids, parameter, vector_ids);
+
+  double selectivity = 1.0;
+  std::shared_ptr<const std::vector<pb::common::VectorScalardata>> samples;
+  if (is_lookup) {
+    selectivity = vector_count > 0 ? std::min(1.0, static_cast<double>(vector_ids.size()) / vector_count) : 1.0;
+  } else {
+    status = GetVectorScalarSamples(vector_index->Id(), region_range, partition_id, samples);
+    if (status.ok() && samples != nullptr) {
+      selectivity = VectorFilterPlanner::EstimateSelectivity(*samples, filter_func);
+    } else {
+      DINGO_LOG(WARNING) << fmt::format("[vector_filter_planner][id({})] sample scalar data failed, error: {}",
+                                        vector_index->Id(), status.error_str());
+    }
+  }
+
+  uint32_t top_n = parameter.top_n();
+  auto decision = VectorFilterPlanner::Choose(selectivity, vector_count, top_n);
+  DINGO_LOG(DEBUG) << fmt::format(
+      "[vector_filter_planner][id({})] selectivity: {} vector count: {} plan: {} topk: {}", vector_index->Id(),
+      selectivity, vector_count, VectorFilterPlanner::PlanName(decision.plan), decision.topk);
+
+  if (decision.plan == VectorFilterPlanner::Plan::kPostFilter) {
+    std::vector<pb::index::VectorWithDistanceResult> candidate_results;
+    status = SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids, parameter, candidate_results,
+                                         decision.topk, {});
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+
+    bool is_enough = true;
+    int64_t filter_checked_count = 0;
+    int64_t filter_passed_count = 0;
+    std::vector<pb::index::VectorWithDistanceResult> filter_results;
+    filter_results.reserve(candidate_results.size());
+    for (auto& candidate_result : candidate_results) {
+      pb::index::VectorWithDistanceResult filter_result;
+      for (auto& vector_with_distance : *candidate_result.mutable_vector_with_distances()) {
+        bool is_match = false;
+        status = FilterVectorScalarData(region_range, partition_id, vector_with_distance.vector_with_id().id(),
+                                        filter_func, is_match);
+        if (!status.ok()) {
+          return status;
+        }
+        ++filter_checked_count;
+        if (!is_match) {
+          continue;
+        }
+        ++filter_passed_count;
+
+        filter_result.add_vector_with_distances()->Swap(&vector_with_distance);
+        if (static_cast<uint32_t>(filter_result.vector_with_distances_size()) >= top_n) {
+          break;
+        }
+      }
+
+      // the index has more candidates, the result may be incomplete.
+      if (static_cast<uint32_t>(filter_result.vector_with_distances_size()) < top_n &&
+          static_cast<uint32_t>(candidate_result.vector_with_distances_size()) >= decision.topk) {
+        is_enough = false;
+        break;
+      }
+      filter_results.push_back(std::move(filter_result));
+    }
+    vector_index->AddFilterStats(filter_checked_count, filter_passed_count);
+
+    if (is_enough) {
+      g_vector_filter_plan_post_filter_count << 1;
+      vector_with_distance_results.swap(filter_results);
+      return butil::Status::OK();
+    }
+
+    // estimated selectivity is too high, retry by pre filter.
+    g_vector_filter_plan_fallback_count << 1;
+  }
+
+  if (!is_lookup) {
+    status = ScanScalarFilterIds(region_range, filter_func, vector_ids);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  if (VectorFilterPlanner::IsBruteForceCount(vector_ids.size())) {
+    g_vector_filter_plan_brute_force_count << 1;
+    return BruteForceSearchByIds(vector_index, region_range, vector_with_ids, top_n, vector_ids,
+                                 vector_with_distance_results);
+  }
+
+  g_vector_filter_plan_pre_filter_count << 1;
+  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
+  status = VectorReader::SetVectorIndexIdsFilter(vector_index, filters, vector_ids);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids, parameter,
+                                                     vector_with_distance_results, top_n, filters);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorReader::DoVectorSearchForTableCoprocessor(  // NOLINT(*static)
+    [[maybe_unused]] VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
+    [[maybe_unused]] const std::vector<pb::common::VectorWithId>& vector_with_ids,
+    [[maybe_unused]] const pb::common::VectorSearchParameter& parameter,
+    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {  // NOLINT
+  //   std::string s = fmt::format("vector index search table filter for coprocessor not support now !!! ");
+  //   DINGO_LOG(ERROR) << s;
+  //   return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, s);
+
+  DINGO_LOG(DEBUG) << "vector index search table filter for coprocessor support";
+
+  // table pre filter search
+
+  if (!parameter.has_vector_coprocessor()) {
+    std::string s = fmt::format("vector_coprocessor empty not support");
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+  }
+
+  const auto& coprocessor = parameter.vector_coprocessor();
+
+  std::shared_ptr<RawCoprocessor> table_coprocessor = std::make_shared<CoprocessorV2>();
+  butil::Status status;
+  status = table_coprocessor->Open(CoprocessorPbWrapper{coprocessor});
   if (!status.ok()) {
     DINGO_LOG(ERROR) << "table coprocessor::Open failed " << status.error_cstr();
     return status;
@@ -1387,10 +1870,55 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilterDebug(
 butil::Status VectorReader::SetVectorIndexIdsFilter(VectorIndexWrapperPtr /*vector_index*/,
                                                     std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
                                                     const std::vector<int64_t>& vector_ids) {
-  filters.push_back(std::make_shared<VectorIndex::ConcreteFilterFunctor>(vector_ids));
+  filters.push_back(std::make_shared<VectorIndex::BitmapFilterFunctor>(vector_ids));
   return butil::Status::OK();
 }
 
+static bool IsRangeSearchPaging(const pb::common::VectorSearchParameter& parameter) {
+  return parameter.range_search_page_size() > 0;
+}
+
+// Order of paging range search results, ties of distance are broken by id so the cursor is unique.
+static bool RangeSearchLess(float distance, int64_t id, float other_distance, int64_t other_id) {
+  return distance < other_distance || (distance == other_distance && id < other_id);
+}
+
+static bool IsAfterRangeSearchCursor(const pb::common::VectorSearchParameter& parameter,
+                                     const pb::common::VectorWithDistance& vector_with_distance) {
+  if (parameter.range_search_after_vector_id() == 0) {
+    return true;
+  }
+  return RangeSearchLess(parameter.range_search_after_distance(), parameter.range_search_after_vector_id(),
+                         vector_with_distance.distance(), vector_with_distance.vector_with_id().id());
+}
+
+// Keep the results after cursor, sort them and cut one page.
+static void PageRangeSearchResult(const pb::common::VectorSearchParameter& parameter,
+                                  pb::index::VectorWithDistanceResult& result) {
+  auto* vector_with_distances = result.mutable_vector_with_distances();
+  std::vector<pb::common::VectorWithDistance> candidates;
+  candidates.reserve(vector_with_distances->size());
+  for (auto& vector_with_distance : *vector_with_distances) {
+    if (IsAfterRangeSearchCursor(parameter, vector_with_distance)) {
+      candidates.push_back(std::move(vector_with_distance));
+    }
+  }
+
+  size_t page_size = parameter.range_search_page_size();
+  size_t sort_size = std::min(page_size, candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + sort_size, candidates.end(),
+                    [](const pb::common::VectorWithDistance& lhs, const pb::common::VectorWithDistance& rhs) {
+                      return RangeSearchLess(lhs.distance(), lhs.vector_with_id().id(), rhs.distance(),
+                                             rhs.vector_with_id().id());
+                    });
+
+  result.set_has_more(candidates.size() > page_size);
+  vector_with_distances->Clear();
+  for (size_t i = 0; i < sort_size; ++i) {
+    vector_with_distances->Add(std::move(candidates[i]));
+  }
+}
+
 butil::Status VectorReader::SearchAndRangeSearchWrapper(
     VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
     const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
@@ -1402,9 +1930,10 @@ butil::Status VectorReader::SearchAndRangeSearchWrapper(
   butil::Status status;
 
   // if vector index does not support restruct vector ,we restruct it using RocksDB
-  // if use_brute_force is true, we use brute force search, else we call vector index search, if vector index not
-  // support, then use brute force search again to get result
-  if (parameter.use_brute_force()) {
+  // if use_brute_force is true or vector index is not ready, we use brute force search, else we call vector index
+  // search, if vector index not support, then use brute force search again to get result
+  // not ready vector index is loading, it is searchable only when enable_vector_bruteforce_search_when_loading.
+  if (parameter.use_brute_force() || !vector_index->IsReady()) {
     if (enable_range_search) {
       status = BruteForceRangeSearch(vector_index, vector_with_ids, radius, region_range, filters, with_vector_data,
                                      parameter, vector_with_distance_results);
@@ -1428,15 +1957,28 @@ butil::Status VectorReader::SearchAndRangeSearchWrapper(
                                          vector_with_distance_results);
       if (status.error_code() == pb::error::Errno::EVECTOR_NOT_SUPPORT) {
         DINGO_LOG(INFO) << "RangeSearch vector index not support, try brute force, id: " << vector_index->Id();
-        return BruteForceRangeSearch(vector_index, vector_with_ids, radius, region_range, filters, with_vector_data,
-                                     parameter, vector_with_distance_results);
-      } else if (!status.ok()) {
+        status = BruteForceRangeSearch(vector_index, vector_with_ids, radius, region_range, filters,
+                                       with_vector_data, parameter, vector_with_distance_results);
+      }
+      if (!status.ok()) {
         DINGO_LOG(ERROR) << fmt::format("RangeSearch vector index failed, error: {} {}", status.error_code(),
                                         status.error_str());
         return status;
       }
     } else {
-      status = vector_index->Search(vector_with_ids, topk, region_range, filters, with_vector_data, parameter,
+      // lossy quantized hnsw and ivf pq search more candidates, and re-rank them by float vectors.
+      int32_t rerank_factor = 0;
+      auto quantizer_type = vector_index->IndexParameter().hnsw_parameter().quantizer_type();
+      if (vector_index->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW &&
+          (quantizer_type == pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_SQ8 ||
+           quantizer_type == pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_FP16)) {
+        rerank_factor = parameter.hnsw().rerank_factor();
+      } else if (vector_index->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ) {
+        rerank_factor = parameter.ivf_pq().rerank_factor();
+      }
+      uint32_t search_topk = rerank_factor > 0 ? topk * rerank_factor : topk;
+
+      status = vector_index->Search(vector_with_ids, search_topk, region_range, filters, with_vector_data, parameter,
                                     vector_with_distance_results);
       if (status.error_code() == pb::error::Errno::EVECTOR_NOT_SUPPORT) {
         DINGO_LOG(DEBUG) << "Search vector index not support, try brute force, id: " << vector_index->Id();
@@ -1447,56 +1989,136 @@ butil::Status VectorReader::SearchAndRangeSearchWrapper(
                                         status.error_str());
         return status;
       }
+
+      if (rerank_factor > 0) {
+        status = RerankByVectorData(vector_index, region_range, vector_with_ids, topk, with_vector_data,
+                                    vector_with_distance_results);
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << fmt::format("Rerank vector failed, error: {} {}", status.error_code(),
+                                          status.error_str());
+          return status;
+        }
+      }
+    }
+  }
+
+  if (enable_range_search && IsRangeSearchPaging(parameter)) {
+    for (auto& result : vector_with_distance_results) {
+      PageRangeSearchResult(parameter, result);
     }
   }
 
   return butil::Status::OK();
 }
 
-// DistanceResult
-// This class is used for priority queue to merge the search result from many batch scan data from raw engine.
-class DistanceResult {
- public:
-  float distance{0};
-  pb::common::VectorWithDistance vector_with_distance{};
-  DistanceResult() = default;
-  DistanceResult(float distance, pb::common::VectorWithDistance vector_with_distance)
-      : distance(distance), vector_with_distance(vector_with_distance) {}
-};
-
-// Overload the < operator.
-bool operator<(const DistanceResult& result1, const DistanceResult& result2) {
-  if (result1.distance != result2.distance) {
-    return result1.distance < result2.distance;
-  } else {
-    return result1.vector_with_distance.vector_with_id().id() < result2.vector_with_distance.vector_with_id().id();
+butil::Status VectorReader::RerankByVectorData(VectorIndexWrapperPtr vector_index,
+                                               const pb::common::Range& region_range,
+                                               const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                               uint32_t topk, bool with_vector_data,
+                                               std::vector<pb::index::VectorWithDistanceResult>& results) {
+  auto metric_type = vector_index->GetMetricType();
+  auto dimension = vector_index->GetDimension();
+  int64_t partition_id = VectorCodec::DecodePartitionId(region_range.start_key());
+
+  // read the candidates of all queries in one batch, the queries of batch share most candidates.
+  std::vector<std::string> keys;
+  std::unordered_set<int64_t> candidate_ids;
+  for (const auto& result : results) {
+    for (const auto& vector_with_distance : result.vector_with_distances()) {
+      int64_t vector_id = vector_with_distance.vector_with_id().id();
+      if (candidate_ids.insert(vector_id).second) {
+        std::string key;
+        VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, vector_id, key);
+        keys.push_back(std::move(key));
+      }
+    }
   }
-}
 
-// Overload the > operator.
-bool operator>(const DistanceResult& result1, const DistanceResult& result2) {
-  if (result1.distance != result2.distance) {
-    return result1.distance > result2.distance;
-  } else {
-    return result1.vector_with_distance.vector_with_id().id() > result2.vector_with_distance.vector_with_id().id();
+  std::vector<pb::common::KeyValue> kvs;
+  auto status = reader_->KvBatchGet(Constant::kVectorDataCF, keys, kvs);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("Rerank batch get {} vectors failed, error: {}", keys.size(), status.error_str());
+    return status;
+  }
+
+  // deleted after search are not found, keep the quantized distance of them.
+  std::unordered_map<int64_t, const std::string*> vector_values;
+  vector_values.reserve(kvs.size());
+  for (const auto& kv : kvs) {
+    vector_values.emplace(VectorCodec::DecodeVectorId(kv.key()), &kv.value());
+  }
+
+  std::vector<float> buffer(dimension);
+  for (size_t row = 0; row < results.size() && row < vector_with_ids.size(); ++row) {
+    const auto& query_values = vector_with_ids[row].vector().float_values();
+    if (query_values.size() != dimension) {
+      return butil::Status(pb::error::EVECTOR_INVALID, "vector dimension is not match");
+    }
+
+    std::vector<float> query(query_values.begin(), query_values.end());
+    if (metric_type == pb::common::MetricType::METRIC_TYPE_COSINE) {
+      VectorIndexUtils::NormalizeVectorForFaiss(query.data(), dimension);
+    }
+
+    auto* vector_with_distances = results[row].mutable_vector_with_distances();
+    for (auto& vector_with_distance : *vector_with_distances) {
+      auto it = vector_values.find(vector_with_distance.vector_with_id().id());
+      if (it == vector_values.end()) {
+        continue;
+      }
+
+      const float* values = VectorCodec::DecodeVectorValueToFloat(*it->second, dimension, buffer.data());
+      if (values == nullptr) {
+        continue;
+      }
+
+      float distance = 0.0f;
+      if (metric_type == pb::common::MetricType::METRIC_TYPE_L2) {
+        distance = VectorScanKernel::L2Sqr(query.data(), values, dimension);
+      } else {
+        if (metric_type == pb::common::MetricType::METRIC_TYPE_COSINE) {
+          if (values != buffer.data()) {
+            std::copy(values, values + dimension, buffer.data());
+            values = buffer.data();
+          }
+          VectorIndexUtils::NormalizeVectorForFaiss(buffer.data(), dimension);
+        }
+        distance = 1.0f - VectorScanKernel::InnerProduct(query.data(), values, dimension);
+      }
+      vector_with_distance.set_distance(distance);
+
+      if (with_vector_data) {
+        pb::common::Vector vector;
+        if (VectorCodec::DecodeVectorValue(*it->second, vector)) {
+          vector_with_distance.mutable_vector_with_id()->mutable_vector()->Swap(&vector);
+        }
+      }
+    }
+
+    std::sort(vector_with_distances->begin(), vector_with_distances->end(),
+              [](const pb::common::VectorWithDistance& lhs, const pb::common::VectorWithDistance& rhs) {
+                return lhs.distance() < rhs.distance();
+              });
+    if (vector_with_distances->size() > topk) {
+      vector_with_distances->DeleteSubrange(topk, vector_with_distances->size() - topk);
+    }
   }
+
+  return butil::Status::OK();
 }
 
-// ScanData from raw engine, build vector index and search
+// ScanData from raw engine, compute distance by scan kernel
 butil::Status VectorReader::BruteForceSearch(VectorIndexWrapperPtr vector_index,
                                              const std::vector<pb::common::VectorWithId>& vector_with_ids,
                                              uint32_t topk, const pb::common::Range& region_range,
                                              std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
-                                             bool reconstruct, const pb::common::VectorSearchParameter& parameter,
+                                             bool /*reconstruct*/, const pb::common::VectorSearchParameter& /*parameter*/,
                                              std::vector<pb::index::VectorWithDistanceResult>& results) {
+  vector_index->IncBruteForceCount();
+
   auto metric_type = vector_index->GetMetricType();
   auto dimension = vector_index->GetDimension();
 
-  pb::common::RegionEpoch epoch;
-  pb::common::VectorIndexParameter index_parameter;
-  index_parameter.mutable_flat_parameter()->set_dimension(dimension);
-  index_parameter.mutable_flat_parameter()->set_metric_type(metric_type);
-
   IteratorOptions options;
   options.lower_bound = region_range.start_key();
   options.upper_bound = region_range.end_key();
@@ -1507,151 +2129,138 @@ butil::Status VectorReader::BruteForceSearch(VectorIndexWrapperPtr vector_index,
     return butil::Status();
   }
 
-  BvarLatencyGuard bvar_guard(&g_bruteforce_search_latency);
+  if (topk == 0) {
+    results.resize(vector_with_ids.size());
+    return butil::Status::OK();
+  }
 
-  // topk results
-  std::vector<std::priority_queue<DistanceResult>> top_results;
-  top_results.resize(vector_with_ids.size());
+  BvarLatencyGuard bvar_guard(&g_bruteforce_search_latency);
 
-  int64_t count = 0;
-  std::vector<pb::common::VectorWithId> vector_with_id_batch;
-  std::vector<pb::index::VectorWithDistanceResult> results_batch;
+  VectorScanKernel scan_kernel(metric_type, dimension, topk, FLAGS_vector_index_bruteforce_batch_count);
+  auto status = scan_kernel.SetQueries(vector_with_ids);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("Set bruteforce queries failed, error: {} {}", status.error_code(),
+                                    status.error_str());
+    return status;
+  }
 
   // scan data from raw engine
   while (iterator->Valid()) {
-    std::string key(iterator->Key());
-    auto vector_id = VectorCodec::DecodeVectorId(key);
+    auto vector_id = VectorCodec::DecodeVectorId(std::string(iterator->Key()));
     if (vector_id == 0 || vector_id == INT64_MAX || vector_id < 0) {
       iterator->Next();
       continue;
     }
 
-    auto value = iterator->Value();
-
-    pb::common::Vector vector;
-    if (!vector.ParseFromArray(value.data(), value.size())) {
-      return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
-    }
-    pb::common::VectorWithId vector_with_id;
-    vector_with_id.mutable_vector()->Swap(&vector);
-    vector_with_id.set_id(vector_id);
-
-    vector_with_id_batch.push_back(vector_with_id);
-
-    if (vector_with_id_batch.size() == FLAGS_vector_index_bruteforce_batch_count) {
-      auto thread_pool = Server::GetInstance().GetVectorIndexThreadPool();
-      auto flat_index = VectorIndexFactory::NewFlat(INT64_MAX, index_parameter, epoch, region_range, thread_pool);
-      if (flat_index == nullptr) {
-        DINGO_LOG(FATAL) << "flat_index is nullptr";
+    // pre-filter before decoding the vector
+    bool is_member = true;
+    for (const auto& filter : filters) {
+      if (!filter->Check(vector_id)) {
+        is_member = false;
+        break;
       }
+    }
 
-      auto ret = flat_index->Add(vector_with_id_batch);
-      if (!ret.ok()) {
-        DINGO_LOG(ERROR) << fmt::format("Add vector to flat index failed, error: {} {}", ret.error_code(),
-                                        ret.error_str());
-        return ret;
+    if (is_member) {
+      status = scan_kernel.AddEncoded(vector_id, iterator->Value());
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("Add vector to bruteforce scan kernel failed, error: {} {}",
+                                        status.error_code(), status.error_str());
+        return status;
       }
+    }
 
-      ret = flat_index->Search(vector_with_ids, topk, filters, reconstruct, parameter, results_batch);
-      if (!ret.ok()) {
-        DINGO_LOG(ERROR) << fmt::format("Search vector index failed, error: {} {}", ret.error_code(), ret.error_str());
-        return ret;
-      }
+    iterator->Next();
+  }
 
-      CHECK(results_batch.size() == vector_with_ids.size());
+  // results are sorted by distance
+  scan_kernel.GetResults(results);
 
-      for (int i = 0; i < results_batch.size(); i++) {
-        auto& result = results_batch[i];
-        auto& top_result = top_results[i];
-
-        for (const auto& vector_with_distance : result.vector_with_distances()) {
-          auto& top_result = top_results[i];
-          if (top_result.size() < topk) {
-            top_result.emplace(vector_with_distance.distance(), vector_with_distance);
-          } else {
-            if (top_result.top().distance > vector_with_distance.distance()) {
-              top_result.pop();
-              top_result.emplace(vector_with_distance.distance(), vector_with_distance);
-            }
-          }
-        }
-      }
+  return butil::Status::OK();
+}
 
-      results_batch.clear();
-      vector_with_id_batch.clear();
-    }
+butil::Status VectorReader::BruteForceSearchByIds(VectorIndexWrapperPtr vector_index,
+                                                  const pb::common::Range& region_range,
+                                                  const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                                  uint32_t topk, const std::vector<int64_t>& vector_ids,
+                                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
+  vector_index->IncBruteForceCount();
 
-    iterator->Next();
+  if (topk == 0 || vector_ids.empty()) {
+    results.resize(vector_with_ids.size());
+    return butil::Status::OK();
   }
 
-  if (!vector_with_id_batch.empty()) {
-    auto thread_pool = Server::GetInstance().GetVectorIndexThreadPool();
-    auto flat_index = VectorIndexFactory::NewFlat(INT64_MAX, index_parameter, epoch, region_range, thread_pool);
-    if (flat_index == nullptr) {
-      DINGO_LOG(FATAL) << "flat_index is nullptr";
-    }
+  BvarLatencyGuard bvar_guard(&g_bruteforce_search_latency);
 
-    auto ret = flat_index->Add(vector_with_id_batch);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("Add vector to flat index failed, error: {} {}", ret.error_code(),
-                                      ret.error_str());
-      return ret;
-    }
+  VectorScanKernel scan_kernel(vector_index->GetMetricType(), vector_index->GetDimension(), topk,
+                               FLAGS_vector_index_bruteforce_batch_count);
+  auto status = scan_kernel.SetQueries(vector_with_ids);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("Set bruteforce queries failed, error: {} {}", status.error_code(),
+                                    status.error_str());
+    return status;
+  }
 
-    ret = flat_index->Search(vector_with_ids, topk, filters, reconstruct, parameter, results_batch);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("Search vector index failed, error: {} {}", ret.error_code(), ret.error_str());
-      return ret;
+  int64_t partition_id = VectorCodec::DecodePartitionId(region_range.start_key());
+  for (auto vector_id : vector_ids) {
+    std::string key, value;
+    VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, vector_id, key);
+    status = reader_->KvGet(Constant::kVectorDataCF, key, value);
+    if (status.error_code() == pb::error::EKEY_NOT_FOUND) {
+      continue;
+    } else if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Get vector {} failed, error: {}", vector_id, status.error_str());
+      return status;
     }
 
-    CHECK(results_batch.size() == vector_with_ids.size());
-
-    for (int i = 0; i < results_batch.size(); i++) {
-      auto& result = results_batch[i];
-      auto& top_result = top_results[i];
-
-      for (const auto& vector_with_distance : result.vector_with_distances()) {
-        auto& top_result = top_results[i];
-        if (top_result.size() < topk) {
-          top_result.emplace(vector_with_distance.distance(), vector_with_distance);
-        } else {
-          if (top_result.top().distance > vector_with_distance.distance()) {
-            top_result.pop();
-            top_result.emplace(vector_with_distance.distance(), vector_with_distance);
-          }
-        }
-      }
+    status = scan_kernel.AddEncoded(vector_id, value);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Add vector to bruteforce scan kernel failed, error: {} {}", status.error_code(),
+                                      status.error_str());
+      return status;
     }
-
-    results_batch.clear();
-    vector_with_id_batch.clear();
   }
 
-  // copy top_results to results
-  // we don't do sorting by distance here
-  // the client will do sorting by distance
-  results.resize(top_results.size());
-
-  for (int i = 0; i < top_results.size(); i++) {
-    auto& top_result = top_results[i];
-    auto& result = results[i];
+  scan_kernel.GetResults(results);
 
-    std::deque<pb::common::VectorWithDistance> vector_with_distances_deque;
+  return butil::Status::OK();
+}
 
-    while (!top_result.empty()) {
-      auto top = top_result.top();
-      vector_with_distances_deque.emplace_front(top.vector_with_distance);
-      top_result.pop();
+// Without paging the first vector_index_max_range_search_result_count results are kept.
+// With paging only the best page_size + 1 results after cursor are kept, the extra one tells whether has more,
+// so memory is bounded by page size however large the radius is.
+static void AppendRangeSearchResult(const pb::common::VectorSearchParameter& parameter,
+                                    pb::index::VectorWithDistanceResult& result,
+                                    std::vector<std::pair<float, pb::common::VectorWithDistance>>& top_result) {
+  if (!IsRangeSearchPaging(parameter)) {
+    for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
+      if (top_result.size() < FLAGS_vector_index_max_range_search_result_count) {
+        top_result.emplace_back(vector_with_distance.distance(), std::move(vector_with_distance));
+      } else {
+        DINGO_LOG(WARNING) << fmt::format("RangeSearch result count exceed limit, limit: {}, actual: {}",
+                                          FLAGS_vector_index_max_range_search_result_count, top_result.size() + 1);
+        break;
+      }
     }
+    return;
+  }
 
-    while (!vector_with_distances_deque.empty()) {
-      auto& vector_with_distance = *result.add_vector_with_distances();
-      vector_with_distance.Swap(&vector_with_distances_deque.front());
-      vector_with_distances_deque.pop_front();
+  size_t keep_size = static_cast<size_t>(parameter.range_search_page_size()) + 1;
+  for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
+    if (IsAfterRangeSearchCursor(parameter, vector_with_distance)) {
+      top_result.emplace_back(vector_with_distance.distance(), std::move(vector_with_distance));
     }
   }
 
-  return butil::Status::OK();
+  if (top_result.size() >= keep_size * 2) {
+    std::nth_element(top_result.begin(), top_result.begin() + keep_size, top_result.end(),
+                     [](const auto& lhs, const auto& rhs) {
+                       return RangeSearchLess(lhs.first, lhs.second.vector_with_id().id(), rhs.first,
+                                              rhs.second.vector_with_id().id());
+                     });
+    top_result.resize(keep_size);
+  }
 }
 
 butil::Status VectorReader::BruteForceRangeSearch(VectorIndexWrapperPtr vector_index,
@@ -1660,6 +2269,8 @@ butil::Status VectorReader::BruteForceRangeSearch(VectorIndexWrapperPtr vector_i
                                                   std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters,
                                                   bool reconstruct, const pb::common::VectorSearchParameter& parameter,
                                                   std::vector<pb::index::VectorWithDistanceResult>& results) {
+  vector_index->IncBruteForceCount();
+
   auto metric_type = vector_index->GetMetricType();
   auto dimension = vector_index->GetDimension();
 
@@ -1700,7 +2311,7 @@ butil::Status VectorReader::BruteForceRangeSearch(VectorIndexWrapperPtr vector_i
     auto value = iterator->Value();
 
     pb::common::Vector vector;
-    if (!vector.ParseFromArray(value.data(), value.size())) {
+    if (!VectorCodec::DecodeVectorValue(value, vector)) {
       return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
     }
     pb::common::VectorWithId vector_with_id;
@@ -1733,19 +2344,7 @@ butil::Status VectorReader::BruteForceRangeSearch(VectorIndexWrapperPtr vector_i
       CHECK(results_batch.size() == vector_with_ids.size());
 
       for (int i = 0; i < results_batch.size(); i++) {
-        auto& result = results_batch[i];
-        auto& top_result = range_rsults[i];
-
-        for (const auto& vector_with_distance : result.vector_with_distances()) {
-          auto& top_result = range_rsults[i];
-          if (top_result.size() < FLAGS_vector_index_max_range_search_result_count) {
-            top_result.emplace_back(vector_with_distance.distance(), vector_with_distance);
-          } else {
-            DINGO_LOG(WARNING) << fmt::format("RangeSearch result count exceed limit, limit: {}, actual: {}",
-                                              FLAGS_vector_index_max_range_search_result_count, top_result.size() + 1);
-            break;
-          }
-        }
+        AppendRangeSearchResult(parameter, results_batch[i], range_rsults[i]);
       }
 
       results_batch.clear();
@@ -1779,19 +2378,7 @@ butil::Status VectorReader::BruteForceRangeSearch(VectorIndexWrapperPtr vector_i
     CHECK(results_batch.size() == vector_with_ids.size());
 
     for (int i = 0; i < results_batch.size(); i++) {
-      auto& result = results_batch[i];
-      auto& top_result = range_rsults[i];
-
-      for (const auto& vector_with_distance : result.vector_with_distances()) {
-        auto& top_result = range_rsults[i];
-        if (top_result.size() < FLAGS_vector_index_max_range_search_result_count) {
-          top_result.emplace_back(vector_with_distance.distance(), vector_with_distance);
-        } else {
-          DINGO_LOG(WARNING) << fmt::format("RangeSearch result count exceed limit, limit: {}, actual: {}",
-                                            FLAGS_vector_index_max_range_search_result_count, top_result.size() + 1);
-          break;
-        }
-      }
+      AppendRangeSearchResult(parameter, results_batch[i], range_rsults[i]);
     }
 
     results_batch.clear();
@@ -1800,7 +2387,7 @@ butil::Status VectorReader::BruteForceRangeSearch(VectorIndexWrapperPtr vector_i
 
   // copy top_results to results
   // we don't do sorting by distance here
-  // the client will do sorting by distance
+  // the client will do sorting by distance, paging results are sorted in SearchAndRangeSearchWrapper
   results.resize(range_rsults.size());
   for (int i = 0; i < range_rsults.size(); i++) {
     auto& top_result = range_rsults[i];
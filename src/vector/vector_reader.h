@@ -19,6 +19,8 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "butil/status.h"
@@ -27,6 +29,7 @@
 #include "engine/raw_engine.h"
 #include "proto/common.pb.h"
 #include "proto/index.pb.h"
+#include "vector/vector_filter_planner.h"
 
 namespace dingodb {
 
@@ -95,6 +98,20 @@ class VectorReader {
   butil::Status QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
                                      std::vector<pb::index::VectorWithDistanceResult>& results);
 
+  // Read values of vectors from cf by one batch get, the same vector id is read once, not found ids are skipped.
+  butil::Status BatchGetVectorValues(const std::string& cf_name, const pb::common::Range& region_range,
+                                     int64_t partition_id,
+                                     const std::vector<pb::common::VectorWithId*>& vector_with_ids,
+                                     std::unordered_map<int64_t, std::string>& values);
+  // Fill the vector data, scalar data or table data of vectors by one batch get.
+  butil::Status BatchQueryVectorData(const pb::common::Range& region_range, int64_t partition_id,
+                                     const std::vector<pb::common::VectorWithId*>& vector_with_ids);
+  butil::Status BatchQueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
+                                           const std::vector<std::string>& selected_scalar_keys,
+                                           const std::vector<pb::common::VectorWithId*>& vector_with_ids);
+  butil::Status BatchQueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
+                                          const std::vector<pb::common::VectorWithId*>& vector_with_ids);
+
   butil::Status GetBorderId(const pb::common::Range& region_range, bool get_min, int64_t& vector_id);
   butil::Status ScanVectorId(std::shared_ptr<Engine::VectorReader::Context> ctx, std::vector<int64_t>& vector_ids);
 
@@ -113,6 +130,36 @@ class VectorReader {
       const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
       std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results);
 
+  // scalar filter search, the plan is chosen by VectorFilterPlanner.
+  butil::Status DoVectorSearchByFilterPlanner(
+      int64_t partition_id, VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+      const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
+      std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results);
+
+  static butil::Status NewScalarFilterFunc(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                           const pb::common::VectorSearchParameter& parameter,
+                                           VectorFilterPlanner::ScalarFilterFunc& filter_func);
+
+  butil::Status ScanScalarFilterIds(const pb::common::Range& region_range,
+                                    const VectorFilterPlanner::ScalarFilterFunc& filter_func,
+                                    std::vector<int64_t>& vector_ids);
+
+  // Get the vector ids match the scalar data of query by the scalar inverted index, build it if not built.
+  // Return false if the inverted index not support the query, then scan.
+  bool LookupScalarInvertedIndex(VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+                                 const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                 const pb::common::VectorSearchParameter& parameter, std::vector<int64_t>& vector_ids);
+
+  butil::Status FilterVectorScalarData(const pb::common::Range& region_range, int64_t partition_id, int64_t vector_id,
+                                       const VectorFilterPlanner::ScalarFilterFunc& filter_func, bool& is_match);
+
+  // get the cached samples of region, sample again if expired.
+  butil::Status GetVectorScalarSamples(int64_t region_id, const pb::common::Range& region_range, int64_t partition_id,
+                                       std::shared_ptr<const std::vector<pb::common::VectorScalardata>>& samples);
+
+  butil::Status SampleVectorScalarData(const pb::common::Range& region_range, int64_t partition_id, int64_t min_id,
+                                       int64_t max_id, std::vector<pb::common::VectorScalardata>& samples);
+
   // This function is for testing only
   butil::Status SearchVectorDebug(int64_t partition_id, VectorIndexWrapperPtr vector_index,
                                   pb::common::Range region_range,
@@ -153,6 +200,12 @@ class VectorReader {
                                  const pb::common::VectorSearchParameter& parameter,
                                  std::vector<pb::index::VectorWithDistanceResult>& results);
 
+  // compute distance of the given vectors only.
+  butil::Status BruteForceSearchByIds(VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+                                      const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                      const std::vector<int64_t>& vector_ids,
+                                      std::vector<pb::index::VectorWithDistanceResult>& results);
+
   butil::Status BruteForceRangeSearch(VectorIndexWrapperPtr vector_index,
                                       const std::vector<pb::common::VectorWithId>& vector_with_ids, float radius,
                                       const pb::common::Range& region_range,
@@ -160,6 +213,11 @@ class VectorReader {
                                       bool reconstruct, const pb::common::VectorSearchParameter& parameter,
                                       std::vector<pb::index::VectorWithDistanceResult>& results);
 
+  // re-rank the candidates of quantized index by the float vectors in raw engine, keep topk.
+  butil::Status RerankByVectorData(VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+                                   const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                   bool with_vector_data, std::vector<pb::index::VectorWithDistanceResult>& results);
+
   RawEngine::ReaderPtr reader_;
 };
 
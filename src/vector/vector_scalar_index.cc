@@ -0,0 +1,303 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_scalar_index.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "butil/strings/string_split.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "vector/codec.h"
+
+namespace dingodb {
+
+DEFINE_string(vector_scalar_inverted_index_keys, "",
+              "comma separated scalar keys indexed by the scalar inverted index for pre filter, empty is disable");
+
+bool VectorScalarInvertedIndex::IsEnabled() { return !FLAGS_vector_scalar_inverted_index_keys.empty(); }
+
+std::set<std::string> VectorScalarInvertedIndex::IndexedKeys() {
+  std::vector<std::string> keys;
+  butil::SplitString(FLAGS_vector_scalar_inverted_index_keys, ',', &keys);
+
+  std::set<std::string> result;
+  for (auto& key : keys) {
+    if (!key.empty()) {
+      result.insert(key);
+    }
+  }
+  return result;
+}
+
+static void AppendTermField(const std::string& data, std::string& term) {
+  term.append(std::to_string(data.size()));
+  term.push_back(':');
+  term.append(data);
+}
+
+std::string VectorScalarInvertedIndex::EncodeTerm(const std::string& key, const pb::common::ScalarValue& value) {
+  // Same fields as Helper::IsEqualVectorScalarValue compare.
+  std::string term;
+  AppendTermField(key, term);
+  term.append(std::to_string(static_cast<int>(value.field_type())));
+  for (const auto& field : value.fields()) {
+    term.push_back('|');
+    switch (value.field_type()) {
+      case pb::common::ScalarFieldType::BOOL:
+        term.push_back(field.bool_data() ? '1' : '0');
+        break;
+      case pb::common::ScalarFieldType::INT8:
+      case pb::common::ScalarFieldType::INT16:
+      case pb::common::ScalarFieldType::INT32:
+        term.append(std::to_string(field.int_data()));
+        break;
+      case pb::common::ScalarFieldType::INT64:
+        term.append(std::to_string(field.long_data()));
+        break;
+      case pb::common::ScalarFieldType::STRING:
+        AppendTermField(field.string_data(), term);
+        break;
+      case pb::common::ScalarFieldType::BYTES:
+        AppendTermField(field.bytes_data(), term);
+        break;
+      default:
+        // float and double equal is not the equal of bytes, e.g. 0.0 and -0.0.
+        return "";
+    }
+  }
+
+  return term;
+}
+
+void VectorScalarInvertedIndex::Upsert(int64_t vector_id, const pb::common::VectorScalardata& scalar_data) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (state_ == State::kBuilding) {
+    pending_writes_.emplace_back(vector_id, std::make_shared<pb::common::VectorScalardata>(scalar_data));
+  } else if (state_ == State::kReady) {
+    UpsertWithoutLock(keys_, vector_id, scalar_data);
+  }
+}
+
+void VectorScalarInvertedIndex::Delete(int64_t vector_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (state_ == State::kBuilding) {
+    pending_writes_.emplace_back(vector_id, nullptr);
+  } else if (state_ == State::kReady) {
+    DeleteWithoutLock(vector_id);
+  }
+}
+
+void VectorScalarInvertedIndex::Clear() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  state_ = State::kNone;
+  pending_writes_.clear();
+  postings_.clear();
+  vector_terms_.clear();
+}
+
+void VectorScalarInvertedIndex::UpsertWithoutLock(const std::set<std::string>& keys, int64_t vector_id,
+                                                  const pb::common::VectorScalardata& scalar_data) {
+  DeleteWithoutLock(vector_id);
+
+  std::vector<std::string> terms;
+  for (const auto& [key, value] : scalar_data.scalar_data()) {
+    if (keys.count(key) == 0) {
+      continue;
+    }
+    auto term = EncodeTerm(key, value);
+    if (term.empty()) {
+      continue;
+    }
+    postings_[term].insert(vector_id);
+    terms.push_back(std::move(term));
+  }
+
+  if (!terms.empty()) {
+    vector_terms_[vector_id] = std::move(terms);
+  }
+}
+
+void VectorScalarInvertedIndex::DeleteWithoutLock(int64_t vector_id) {
+  auto it = vector_terms_.find(vector_id);
+  if (it == vector_terms_.end()) {
+    return;
+  }
+
+  for (const auto& term : it->second) {
+    auto posting_it = postings_.find(term);
+    if (posting_it != postings_.end()) {
+      posting_it->second.erase(vector_id);
+      if (posting_it->second.empty()) {
+        postings_.erase(posting_it);
+      }
+    }
+  }
+  vector_terms_.erase(it);
+}
+
+butil::Status VectorScalarInvertedIndex::Build(RawEngine::ReaderPtr reader, const pb::common::Range& range) {
+  auto keys = IndexedKeys();
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (state_ == State::kBuilding) {
+      return butil::Status::OK();
+    }
+    if (state_ == State::kReady && range_.start_key() == range.start_key() && range_.end_key() == range.end_key() &&
+        keys_ == keys) {
+      return butil::Status::OK();
+    }
+
+    // The iterator is created after state is building, so the writes not seen by it are pending.
+    state_ = State::kBuilding;
+    range_ = range;
+    keys_ = keys;
+    pending_writes_.clear();
+    postings_.clear();
+    vector_terms_.clear();
+  }
+
+  int64_t start_time = Helper::TimestampMs();
+  std::unordered_map<std::string, std::set<int64_t>> postings;
+  std::unordered_map<int64_t, std::vector<std::string>> vector_terms;
+
+  IteratorOptions options;
+  options.upper_bound = range.end_key();
+  auto iter = reader->NewIterator(Constant::kVectorScalarCF, options);
+  if (iter == nullptr) {
+    Clear();
+    return butil::Status(pb::error::EINTERNAL, "New iterator failed");
+  }
+
+  for (iter->Seek(range.start_key()); iter->Valid(); iter->Next()) {
+    pb::common::VectorScalardata scalar_data;
+    if (!scalar_data.ParseFromArray(iter->Value().data(), iter->Value().size())) {
+      Clear();
+      return butil::Status(pb::error::EINTERNAL, "Internal error, decode VectorScalar failed");
+    }
+
+    int64_t vector_id = VectorCodec::DecodeVectorId(std::string(iter->Key()));
+    std::vector<std::string> terms;
+    for (const auto& [key, value] : scalar_data.scalar_data()) {
+      if (keys.count(key) == 0) {
+        continue;
+      }
+      auto term = EncodeTerm(key, value);
+      if (!term.empty()) {
+        postings[term].insert(vector_id);
+        terms.push_back(std::move(term));
+      }
+    }
+    if (!terms.empty()) {
+      vector_terms[vector_id] = std::move(terms);
+    }
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  // Cleared or rebuilt by others during scan.
+  if (state_ != State::kBuilding || range_.start_key() != range.start_key() || range_.end_key() != range.end_key() ||
+      keys_ != keys) {
+    return butil::Status::OK();
+  }
+
+  postings_.swap(postings);
+  vector_terms_.swap(vector_terms);
+  for (const auto& [vector_id, scalar_data] : pending_writes_) {
+    if (scalar_data != nullptr) {
+      UpsertWithoutLock(keys, vector_id, *scalar_data);
+    } else {
+      DeleteWithoutLock(vector_id);
+    }
+  }
+  int64_t pending_count = pending_writes_.size();
+  pending_writes_.clear();
+  state_ = State::kReady;
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.scalar_inverted_index] build finish, range({}) term count({}) vector count({}) pending({}) "
+      "elapsed time({}ms)",
+      VectorCodec::DecodeRangeToString(range), postings_.size(), vector_terms_.size(), pending_count,
+      Helper::TimestampMs() - start_time);
+
+  return butil::Status::OK();
+}
+
+bool VectorScalarInvertedIndex::Lookup(const pb::common::Range& range, const pb::common::VectorScalardata& query,
+                                       std::vector<int64_t>& vector_ids) {
+  if (query.scalar_data().empty()) {
+    return false;
+  }
+
+  auto keys = IndexedKeys();
+  std::vector<std::string> terms;
+  for (const auto& [key, value] : query.scalar_data()) {
+    if (keys.count(key) == 0) {
+      return false;
+    }
+    auto term = EncodeTerm(key, value);
+    if (term.empty()) {
+      return false;
+    }
+    terms.push_back(std::move(term));
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  // Not built with the same range and keys.
+  if (state_ != State::kReady || range_.start_key() != range.start_key() || range_.end_key() != range.end_key() ||
+      keys_ != keys) {
+    return false;
+  }
+
+  std::vector<const std::set<int64_t>*> postings;
+  for (const auto& term : terms) {
+    auto it = postings_.find(term);
+    if (it == postings_.end()) {
+      // no vector match the term.
+      vector_ids.clear();
+      return true;
+    }
+    postings.push_back(&it->second);
+  }
+
+  // Intersect from the shortest posting list.
+  std::sort(postings.begin(), postings.end(),
+            [](const auto* lhs, const auto* rhs) { return lhs->size() < rhs->size(); });
+  vector_ids.clear();
+  vector_ids.reserve(postings[0]->size());
+  for (auto vector_id : *postings[0]) {
+    bool is_match = std::all_of(postings.begin() + 1, postings.end(),
+                                [vector_id](const auto* posting) { return posting->count(vector_id) > 0; });
+    if (is_match) {
+      vector_ids.push_back(vector_id);
+    }
+  }
+
+  return true;
+}
+
+int64_t VectorScalarInvertedIndex::TermCount() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return postings_.size();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,89 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_SCALAR_INDEX_H_  // NOLINT
+#define DINGODB_VECTOR_SCALAR_INDEX_H_
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "engine/raw_engine.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Inverted index of vector scalar data, term(scalar key and value) -> posting list of vector ids.
+// Only the keys of vector_scalar_inverted_index_keys are indexed, float and double values are not indexed.
+// It is built from kVectorScalarCF on first lookup, then maintained in the apply path.
+// The writes applied during building are recorded and replayed after the scan, the replay is idempotent
+// because the scan sees the same or older data, so the apply path is never blocked by building.
+class VectorScalarInvertedIndex {
+ public:
+  VectorScalarInvertedIndex() = default;
+  ~VectorScalarInvertedIndex() = default;
+
+  static bool IsEnabled();
+  static std::set<std::string> IndexedKeys();
+  // Term of scalar key and value, equal terms if and only if equal values, empty if not support.
+  static std::string EncodeTerm(const std::string& key, const pb::common::ScalarValue& value);
+
+  // Called after the apply of vector add/delete write the raw engine.
+  void Upsert(int64_t vector_id, const pb::common::VectorScalardata& scalar_data);
+  void Delete(int64_t vector_id);
+  // Drop all postings, e.g. the data is replaced by snapshot or ingest, rebuild on next lookup.
+  void Clear();
+
+  // Build from the scalar data of range if not built or the range is changed.
+  butil::Status Build(RawEngine::ReaderPtr reader, const pb::common::Range& range);
+
+  // Get the sorted vector ids match all the scalar of query, return false if the index is not built for range
+  // or any scalar of query is not indexed, then the caller should scan.
+  bool Lookup(const pb::common::Range& range, const pb::common::VectorScalardata& query,
+              std::vector<int64_t>& vector_ids);
+
+  int64_t TermCount();
+
+ private:
+  enum class State { kNone, kBuilding, kReady };
+
+  // Pending write during building, scalar_data is nullptr means delete.
+  using PendingWrite = std::pair<int64_t, std::shared_ptr<pb::common::VectorScalardata>>;
+
+  void UpsertWithoutLock(const std::set<std::string>& keys, int64_t vector_id,
+                         const pb::common::VectorScalardata& scalar_data);
+  void DeleteWithoutLock(int64_t vector_id);
+
+  bthread::Mutex mutex_;
+  State state_{State::kNone};
+  pb::common::Range range_;
+  // indexed keys when build.
+  std::set<std::string> keys_;
+  std::vector<PendingWrite> pending_writes_;
+
+  std::unordered_map<std::string, std::set<int64_t>> postings_;
+  // terms of vector, for removing the old postings when update and delete.
+  std::unordered_map<int64_t, std::vector<std::string>> vector_terms_;
+};
+using VectorScalarInvertedIndexPtr = std::shared_ptr<VectorScalarInvertedIndex>;
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_SCALAR_INDEX_H_  // NOLINT
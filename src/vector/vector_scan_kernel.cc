@@ -0,0 +1,396 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_scan_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "butil/status.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/codec.h"
+#include "vector/vector_index_utils.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DINGO_SCAN_KERNEL_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DINGO_SCAN_KERNEL_NEON 1
+#endif
+
+namespace dingodb {
+
+static constexpr size_t kVectorAlignFloats = 16;
+static constexpr size_t kVectorAlignBytes = kVectorAlignFloats * sizeof(float);
+
+static float L2SqrScalar(const float* x, const float* y, size_t d) {
+  float sum = 0.0f;
+  for (size_t i = 0; i < d; ++i) {
+    float diff = x[i] - y[i];
+    sum += diff * diff;
+  }
+  return sum;
+}
+
+static float InnerProductScalar(const float* x, const float* y, size_t d) {
+  float sum = 0.0f;
+  for (size_t i = 0; i < d; ++i) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+#if defined(DINGO_SCAN_KERNEL_X86)
+
+__attribute__((target("avx2,fma"))) static float HorizontalSumAvx2(__m256 sum) {
+  __m128 low = _mm256_castps256_ps128(sum);
+  __m128 high = _mm256_extractf128_ps(sum, 1);
+  low = _mm_add_ps(low, high);
+  low = _mm_hadd_ps(low, low);
+  low = _mm_hadd_ps(low, low);
+  return _mm_cvtss_f32(low);
+}
+
+__attribute__((target("avx2,fma"))) static float L2SqrAvx2(const float* x, const float* y, size_t d) {
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= d; i += 16) {
+    __m256 diff0 = _mm256_sub_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i));
+    __m256 diff1 = _mm256_sub_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8));
+    sum0 = _mm256_fmadd_ps(diff0, diff0, sum0);
+    sum1 = _mm256_fmadd_ps(diff1, diff1, sum1);
+  }
+  for (; i + 8 <= d; i += 8) {
+    __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i));
+    sum0 = _mm256_fmadd_ps(diff, diff, sum0);
+  }
+  float sum = HorizontalSumAvx2(_mm256_add_ps(sum0, sum1));
+  return sum + L2SqrScalar(x + i, y + i, d - i);
+}
+
+__attribute__((target("avx2,fma"))) static float InnerProductAvx2(const float* x, const float* y, size_t d) {
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= d; i += 16) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), sum0);
+    sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), sum1);
+  }
+  for (; i + 8 <= d; i += 8) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), sum0);
+  }
+  float sum = HorizontalSumAvx2(_mm256_add_ps(sum0, sum1));
+  return sum + InnerProductScalar(x + i, y + i, d - i);
+}
+
+__attribute__((target("avx512f"))) static float L2SqrAvx512(const float* x, const float* y, size_t d) {
+  __m512 sum = _mm512_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= d; i += 16) {
+    __m512 diff = _mm512_sub_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i));
+    sum = _mm512_fmadd_ps(diff, diff, sum);
+  }
+  if (i < d) {
+    __mmask16 mask = static_cast<__mmask16>((1U << (d - i)) - 1);
+    __m512 diff = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i));
+    sum = _mm512_fmadd_ps(diff, diff, sum);
+  }
+  return _mm512_reduce_add_ps(sum);
+}
+
+__attribute__((target("avx512f"))) static float InnerProductAvx512(const float* x, const float* y, size_t d) {
+  __m512 sum = _mm512_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= d; i += 16) {
+    sum = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), sum);
+  }
+  if (i < d) {
+    __mmask16 mask = static_cast<__mmask16>((1U << (d - i)) - 1);
+    sum = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i), sum);
+  }
+  return _mm512_reduce_add_ps(sum);
+}
+
+#elif defined(DINGO_SCAN_KERNEL_NEON)
+
+static float L2SqrNeon(const float* x, const float* y, size_t d) {
+  float32x4_t sum0 = vdupq_n_f32(0.0f);
+  float32x4_t sum1 = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 8 <= d; i += 8) {
+    float32x4_t diff0 = vsubq_f32(vld1q_f32(x + i), vld1q_f32(y + i));
+    float32x4_t diff1 = vsubq_f32(vld1q_f32(x + i + 4), vld1q_f32(y + i + 4));
+    sum0 = vfmaq_f32(sum0, diff0, diff0);
+    sum1 = vfmaq_f32(sum1, diff1, diff1);
+  }
+  float sum = vaddvq_f32(vaddq_f32(sum0, sum1));
+  return sum + L2SqrScalar(x + i, y + i, d - i);
+}
+
+static float InnerProductNeon(const float* x, const float* y, size_t d) {
+  float32x4_t sum0 = vdupq_n_f32(0.0f);
+  float32x4_t sum1 = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 8 <= d; i += 8) {
+    sum0 = vfmaq_f32(sum0, vld1q_f32(x + i), vld1q_f32(y + i));
+    sum1 = vfmaq_f32(sum1, vld1q_f32(x + i + 4), vld1q_f32(y + i + 4));
+  }
+  float sum = vaddvq_f32(vaddq_f32(sum0, sum1));
+  return sum + InnerProductScalar(x + i, y + i, d - i);
+}
+
+#endif
+
+enum class SimdLevel { kScalar, kAvx2, kAvx512, kNeon };
+
+static SimdLevel DetectSimdLevel() {
+#if defined(DINGO_SCAN_KERNEL_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return SimdLevel::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SimdLevel::kAvx2;
+  }
+  return SimdLevel::kScalar;
+#elif defined(DINGO_SCAN_KERNEL_NEON)
+  return SimdLevel::kNeon;
+#else
+  return SimdLevel::kScalar;
+#endif
+}
+
+static SimdLevel GetSimdLevel() {
+  static const SimdLevel kSimdLevel = DetectSimdLevel();
+  return kSimdLevel;
+}
+
+float VectorScanKernel::L2Sqr(const float* x, const float* y, size_t d) {
+  switch (GetSimdLevel()) {
+#if defined(DINGO_SCAN_KERNEL_X86)
+    case SimdLevel::kAvx512:
+      return L2SqrAvx512(x, y, d);
+    case SimdLevel::kAvx2:
+      return L2SqrAvx2(x, y, d);
+#elif defined(DINGO_SCAN_KERNEL_NEON)
+    case SimdLevel::kNeon:
+      return L2SqrNeon(x, y, d);
+#endif
+    default:
+      return L2SqrScalar(x, y, d);
+  }
+}
+
+float VectorScanKernel::InnerProduct(const float* x, const float* y, size_t d) {
+  switch (GetSimdLevel()) {
+#if defined(DINGO_SCAN_KERNEL_X86)
+    case SimdLevel::kAvx512:
+      return InnerProductAvx512(x, y, d);
+    case SimdLevel::kAvx2:
+      return InnerProductAvx2(x, y, d);
+#elif defined(DINGO_SCAN_KERNEL_NEON)
+    case SimdLevel::kNeon:
+      return InnerProductNeon(x, y, d);
+#endif
+    default:
+      return InnerProductScalar(x, y, d);
+  }
+}
+
+const char* VectorScanKernel::SimdName() {
+  switch (GetSimdLevel()) {
+    case SimdLevel::kAvx512:
+      return "avx512";
+    case SimdLevel::kAvx2:
+      return "avx2";
+    case SimdLevel::kNeon:
+      return "neon";
+    default:
+      return "scalar";
+  }
+}
+
+// resolve the simd function once, avoid the switch for every distance.
+static float (*ResolveDistanceFunc(bool is_l2))(const float*, const float*, size_t) {
+  switch (GetSimdLevel()) {
+#if defined(DINGO_SCAN_KERNEL_X86)
+    case SimdLevel::kAvx512:
+      return is_l2 ? L2SqrAvx512 : InnerProductAvx512;
+    case SimdLevel::kAvx2:
+      return is_l2 ? L2SqrAvx2 : InnerProductAvx2;
+#elif defined(DINGO_SCAN_KERNEL_NEON)
+    case SimdLevel::kNeon:
+      return is_l2 ? L2SqrNeon : InnerProductNeon;
+#endif
+    default:
+      return is_l2 ? L2SqrScalar : InnerProductScalar;
+  }
+}
+
+static void NormalizeVector(float* x, size_t d) {
+  float norm = std::sqrt(VectorScanKernel::InnerProduct(x, x, d));
+  if (norm > 0.00001f) {
+    for (size_t i = 0; i < d; ++i) {
+      x[i] /= norm;
+    }
+  }
+}
+
+VectorScanKernel::AlignedBuffer VectorScanKernel::AllocAligned(size_t float_num) {
+  // aligned_alloc require the size is a multiple of alignment
+  size_t size = std::max((float_num * sizeof(float) + kVectorAlignBytes - 1) / kVectorAlignBytes * kVectorAlignBytes,
+                         kVectorAlignBytes);
+  auto* ptr = static_cast<float*>(std::aligned_alloc(kVectorAlignBytes, size));
+  memset(ptr, 0, size);
+  return AlignedBuffer(ptr);
+}
+
+VectorScanKernel::VectorScanKernel(pb::common::MetricType metric_type, int32_t dimension, uint32_t topk,
+                                   size_t block_size)
+    : metric_type_(metric_type),
+      dimension_(dimension),
+      stride_((dimension + kVectorAlignFloats - 1) / kVectorAlignFloats * kVectorAlignFloats),
+      topk_(topk),
+      normalize_(metric_type == pb::common::MetricType::METRIC_TYPE_COSINE),
+      binarize_(metric_type == pb::common::MetricType::METRIC_TYPE_HAMMING),
+      block_size_(std::max(block_size, static_cast<size_t>(1))) {
+  is_l2_ = !(metric_type == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT ||
+             metric_type == pb::common::MetricType::METRIC_TYPE_COSINE);
+  distance_func_ = ResolveDistanceFunc(is_l2_);
+
+  block_ = AllocAligned(block_size_ * stride_);
+  block_ids_.resize(block_size_);
+}
+
+butil::Status VectorScanKernel::SetQueries(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  query_num_ = vector_with_ids.size();
+  queries_ = AllocAligned(query_num_ * stride_);
+  for (size_t i = 0; i < query_num_; ++i) {
+    // integer vectors are widened to float.
+    const auto& vector = vector_with_ids[i].vector();
+    if (!VectorCodec::VectorToFloat(vector, dimension_, QueryVector(i))) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                           fmt::format("query vector dimension float({}) binary({}) not match {}",
+                                       vector.float_values_size(), vector.binary_values_size(), dimension_));
+    }
+    if (normalize_) {
+      NormalizeVector(QueryVector(i), dimension_);
+    } else if (binarize_) {
+      VectorIndexUtils::BinarizeVector(QueryVector(i), dimension_);
+    }
+  }
+
+  heaps_.clear();
+  heaps_.resize(query_num_);
+  for (auto& heap : heaps_) {
+    heap.reserve(topk_);
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorScanKernel::AddEncoded(int64_t vector_id, std::string_view value) {
+  decode_buffer_.resize(dimension_);
+  // Packed float values are used in place, without protobuf parsing and copying.
+  const float* vector = VectorCodec::DecodeVectorValueToFloat(value, dimension_, decode_buffer_.data());
+  if (vector == nullptr) {
+    return butil::Status(pb::error::EINTERNAL,
+                         fmt::format("decode vector {} failed or dimension not match {}", vector_id, dimension_));
+  }
+
+  return Add(vector_id, vector);
+}
+
+butil::Status VectorScanKernel::Add(int64_t vector_id, const float* vector) {
+  float* dst = BlockVector(block_count_);
+  memcpy(dst, vector, dimension_ * sizeof(float));
+  if (normalize_) {
+    NormalizeVector(dst, dimension_);
+  } else if (binarize_) {
+    VectorIndexUtils::BinarizeVector(dst, dimension_);
+  }
+  block_ids_[block_count_] = vector_id;
+
+  if (++block_count_ == block_size_) {
+    ComputeBlock();
+  }
+
+  return butil::Status::OK();
+}
+
+void VectorScanKernel::Flush() {
+  if (block_count_ > 0) {
+    ComputeBlock();
+  }
+}
+
+void VectorScanKernel::Push(std::vector<HeapItem>& heap, float distance, int64_t vector_id) const {
+  if (heap.size() < topk_) {
+    heap.emplace_back(distance, vector_id);
+    std::push_heap(heap.begin(), heap.end());
+  } else if (distance < heap.front().first) {
+    std::pop_heap(heap.begin(), heap.end());
+    heap.back() = HeapItem(distance, vector_id);
+    std::push_heap(heap.begin(), heap.end());
+  }
+}
+
+void VectorScanKernel::ComputeBlock() {
+  // the block is small enough to stay in cache, so iterate queries in the outer loop.
+  for (size_t q = 0; q < query_num_; ++q) {
+    const float* query = QueryVector(q);
+    auto& heap = heaps_[q];
+    for (size_t i = 0; i < block_count_; ++i) {
+      float distance = distance_func_(query, BlockVector(i), dimension_);
+      Push(heap, is_l2_ ? distance : 1.0f - distance, block_ids_[i]);
+    }
+  }
+
+  block_count_ = 0;
+}
+
+void VectorScanKernel::GetResults(std::vector<pb::index::VectorWithDistanceResult>& results) {
+  Flush();
+
+  results.resize(query_num_);
+  for (size_t q = 0; q < query_num_; ++q) {
+    auto& heap = heaps_[q];
+    std::sort_heap(heap.begin(), heap.end());
+
+    auto& result = results[q];
+    for (const auto& [distance, vector_id] : heap) {
+      auto* vector_with_distance = result.add_vector_with_distances();
+      auto* vector_with_id = vector_with_distance->mutable_vector_with_id();
+      vector_with_id->set_id(vector_id);
+      vector_with_id->mutable_vector()->set_dimension(dimension_);
+      vector_with_id->mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+      vector_with_distance->set_distance(distance);
+      vector_with_distance->set_metric_type(metric_type_);
+    }
+    heap.clear();
+  }
+}
+
+}  // namespace dingodb
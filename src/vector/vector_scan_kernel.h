@@ -0,0 +1,107 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_SCAN_KERNEL_H_  // NOLINT
+#define DINGODB_VECTOR_SCAN_KERNEL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "butil/status.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+
+namespace dingodb {
+
+// Brute force scan kernel, compute the distance between the scanned vectors and all queries at once,
+// and keep a fixed size heap per query.
+// The scanned vectors are decoded into a block buffer, the block is computed when it is full or Flush.
+// The distance has the same semantics as flat index, L2 is squared distance, IP and COSINE is 1 - inner product,
+// HAMMING is count of different bits. Integer vectors are widened to float.
+class VectorScanKernel {
+ public:
+  VectorScanKernel(pb::common::MetricType metric_type, int32_t dimension, uint32_t topk, size_t block_size);
+  ~VectorScanKernel() = default;
+
+  VectorScanKernel(const VectorScanKernel&) = delete;
+  VectorScanKernel& operator=(const VectorScanKernel&) = delete;
+
+  butil::Status SetQueries(const std::vector<pb::common::VectorWithId>& vector_with_ids);
+
+  // value is the serialized pb::common::Vector
+  butil::Status AddEncoded(int64_t vector_id, std::string_view value);
+  butil::Status Add(int64_t vector_id, const float* vector);
+
+  // compute the rest vectors in block
+  void Flush();
+
+  // results are sorted by distance
+  void GetResults(std::vector<pb::index::VectorWithDistanceResult>& results);
+
+  static float L2Sqr(const float* x, const float* y, size_t d);
+  static float InnerProduct(const float* x, const float* y, size_t d);
+
+  // the simd instruction set selected by cpu
+  static const char* SimdName();
+
+ private:
+  using DistanceFunc = float (*)(const float*, const float*, size_t);
+  using HeapItem = std::pair<float, int64_t>;
+
+  struct AlignedDeleter {
+    void operator()(float* ptr) const { std::free(ptr); }
+  };
+  using AlignedBuffer = std::unique_ptr<float[], AlignedDeleter>;
+  static AlignedBuffer AllocAligned(size_t float_num);
+
+  float* BlockVector(size_t pos) { return block_.get() + pos * stride_; }
+  float* QueryVector(size_t pos) { return queries_.get() + pos * stride_; }
+
+  void ComputeBlock();
+  void Push(std::vector<HeapItem>& heap, float distance, int64_t vector_id) const;
+
+  pb::common::MetricType metric_type_;
+  int32_t dimension_;
+  // dimension padded to 16 floats, so every vector is 64 bytes aligned.
+  size_t stride_;
+  uint32_t topk_;
+  bool normalize_;
+  // hamming distance is the squared L2 distance of bits.
+  bool binarize_;
+  bool is_l2_;
+  DistanceFunc distance_func_;
+
+  size_t query_num_{0};
+  AlignedBuffer queries_;
+
+  size_t block_size_;
+  size_t block_count_{0};
+  AlignedBuffer block_;
+  std::vector<int64_t> block_ids_;
+
+  // max heap of topk per query
+  std::vector<std::vector<HeapItem>> heaps_;
+
+  // reused for decoding to avoid memory allocation
+  std::vector<float> decode_buffer_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_SCAN_KERNEL_H_  // NOLINT
@@ -0,0 +1,174 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_search_batcher.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "butil/status.h"
+#include "bvar/reducer.h"
+#include "bvar/recorder.h"
+#include "common/logging.h"
+#include "engine/engine.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/index.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_vector_search_batch, true, "merge concurrent vector search of the same region into one search");
+DEFINE_int64(vector_search_batch_window_us, 200, "max wait time of collecting vector search batch");
+DEFINE_int64(vector_search_batch_max_query_count, 64, "max query count of one vector search batch");
+
+bvar::IntRecorder g_vector_search_batch_query_count("dingo_vector_search_batch_query_count");
+bvar::Adder<int64_t> g_vector_search_batch_fallback_count("dingo_vector_search_batch_fallback_count");
+
+VectorSearchBatcher::VectorSearchBatcher(SearchFunc search_func) : search_func_(std::move(search_func)) {}
+
+std::string VectorSearchBatcher::BatchKey(std::shared_ptr<Engine::VectorReader::Context> ctx) {
+  // range is part of key, the region maybe split between two requests.
+  return fmt::format("{}_{}_{}_{}", ctx->region_id, ctx->region_range.start_key(), ctx->region_range.end_key(),
+                     ctx->parameter.SerializeAsString());
+}
+
+butil::Status VectorSearchBatcher::Search(std::shared_ptr<Engine::VectorReader::Context> ctx,
+                                          std::vector<pb::index::VectorWithDistanceResult>& results) {
+  int64_t query_count = ctx->vector_with_ids.size();
+  if (!FLAGS_enable_vector_search_batch || query_count >= FLAGS_vector_search_batch_max_query_count) {
+    return search_func_(ctx, results);
+  }
+
+  auto key = BatchKey(ctx);
+  Request request{ctx, &results, butil::Status()};
+
+  BatchPtr batch;
+  bool is_leader = false;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto& slot = slots_[key];
+    if (slot.pending != nullptr &&
+        slot.pending->query_count + query_count <= FLAGS_vector_search_batch_max_query_count) {
+      // join the collecting batch.
+      batch = slot.pending;
+      batch->requests.push_back(&request);
+      batch->query_count += query_count;
+      if (batch->query_count >= FLAGS_vector_search_batch_max_query_count) {
+        // full, detach it, the leader will execute it when wake up.
+        slot.pending = nullptr;
+      }
+    } else if (slot.pending == nullptr && slot.running_count == 0) {
+      // no concurrency, no need to wait.
+      ++slot.running_count;
+    } else {
+      // start a new batch, the full batch has been detached or is executing.
+      batch = std::make_shared<Batch>();
+      batch->requests.push_back(&request);
+      batch->query_count = query_count;
+      slot.pending = batch;
+      is_leader = true;
+    }
+  }
+
+  if (batch == nullptr) {
+    auto status = search_func_(ctx, results);
+    FinishRunning(key);
+    return status;
+  }
+
+  if (!is_leader) {
+    batch->cond.Wait(0);
+    return request.status;
+  }
+
+  bthread_usleep(FLAGS_vector_search_batch_window_us);
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto& slot = slots_[key];
+    if (slot.pending == batch) {
+      slot.pending = nullptr;
+    }
+    ++slot.running_count;
+  }
+
+  Execute(batch);
+  FinishRunning(key);
+  batch->cond.DecreaseBroadcast();
+
+  return request.status;
+}
+
+void VectorSearchBatcher::Execute(BatchPtr batch) {
+  // requests are appended under lock before the batch is detached, no more changes here.
+  g_vector_search_batch_query_count << batch->query_count;
+
+  if (batch->requests.size() == 1) {
+    auto* request = batch->requests[0];
+    request->status = search_func_(request->ctx, *request->results);
+    return;
+  }
+
+  auto merge_ctx = std::make_shared<Engine::VectorReader::Context>(*batch->requests[0]->ctx);
+  merge_ctx->vector_with_ids.clear();
+  merge_ctx->vector_with_ids.reserve(batch->query_count);
+  for (auto* request : batch->requests) {
+    merge_ctx->vector_with_ids.insert(merge_ctx->vector_with_ids.end(), request->ctx->vector_with_ids.begin(),
+                                      request->ctx->vector_with_ids.end());
+  }
+
+  std::vector<pb::index::VectorWithDistanceResult> merge_results;
+  auto status = search_func_(merge_ctx, merge_results);
+  if (status.ok() && static_cast<int64_t>(merge_results.size()) == batch->query_count) {
+    size_t offset = 0;
+    for (auto* request : batch->requests) {
+      size_t count = request->ctx->vector_with_ids.size();
+      request->results->reserve(count);
+      for (size_t i = offset; i < offset + count; ++i) {
+        request->results->push_back(std::move(merge_results[i]));
+      }
+      offset += count;
+    }
+    return;
+  }
+
+  // one bad query should not fail the others, run them one by one.
+  DINGO_LOG(WARNING) << fmt::format(
+      "[vector_search_batch] merge search failed, region: {} query count: {} result count: {} error: {}, retry one "
+      "by one.",
+      merge_ctx->region_id, batch->query_count, merge_results.size(), status.error_str());
+  g_vector_search_batch_fallback_count << 1;
+  for (auto* request : batch->requests) {
+    request->results->clear();
+    request->status = search_func_(request->ctx, *request->results);
+  }
+}
+
+void VectorSearchBatcher::FinishRunning(const std::string& key) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = slots_.find(key);
+  if (it == slots_.end()) {
+    return;
+  }
+  --it->second.running_count;
+  if (it->second.running_count <= 0 && it->second.pending == nullptr) {
+    slots_.erase(it);
+  }
+}
+
+}  // namespace dingodb
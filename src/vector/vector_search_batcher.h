@@ -0,0 +1,88 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_SEARCH_BATCHER_H_  // NOLINT
+#define DINGODB_VECTOR_SEARCH_BATCHER_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "common/synchronization.h"
+#include "engine/engine.h"
+#include "proto/index.pb.h"
+
+namespace dingodb {
+
+// Merge concurrent search requests of the same vector index into one multi-query search,
+// so that the brute force part of flat/ivf index run as matrix multiplication.
+// Only requests with the same region and search parameter can be merged, one search call
+// cover only one vector index.
+// Batching only happens under concurrency, when no other search of the same region is running
+// the request is executed at once and pays no extra latency.
+class VectorSearchBatcher {
+ public:
+  using SearchFunc = std::function<butil::Status(std::shared_ptr<Engine::VectorReader::Context>,
+                                                 std::vector<pb::index::VectorWithDistanceResult>&)>;
+
+  explicit VectorSearchBatcher(SearchFunc search_func);
+  ~VectorSearchBatcher() = default;
+
+  VectorSearchBatcher(const VectorSearchBatcher&) = delete;
+  VectorSearchBatcher& operator=(const VectorSearchBatcher&) = delete;
+
+  butil::Status Search(std::shared_ptr<Engine::VectorReader::Context> ctx,
+                       std::vector<pb::index::VectorWithDistanceResult>& results);
+
+ private:
+  struct Request {
+    std::shared_ptr<Engine::VectorReader::Context> ctx;
+    std::vector<pb::index::VectorWithDistanceResult>* results;
+    butil::Status status;
+  };
+
+  struct Batch {
+    std::vector<Request*> requests;
+    int64_t query_count{0};
+    // leader decrease it when all requests are done.
+    BthreadCond cond{1};
+  };
+  using BatchPtr = std::shared_ptr<Batch>;
+
+  struct Slot {
+    // the batch is collecting requests.
+    BatchPtr pending;
+    // number of searches in progress.
+    int32_t running_count{0};
+  };
+
+  static std::string BatchKey(std::shared_ptr<Engine::VectorReader::Context> ctx);
+
+  void Execute(BatchPtr batch);
+  void FinishRunning(const std::string& key);
+
+  SearchFunc search_func_;
+
+  bthread::Mutex mutex_;
+  std::unordered_map<std::string, Slot> slots_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_SEARCH_BATCHER_H_  // NOLINT
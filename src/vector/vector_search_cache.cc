@@ -0,0 +1,138 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_search_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "butil/status.h"
+#include "bvar/reducer.h"
+#include "engine/engine.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/index.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_vector_search_cache, false, "cache vector search results until region apply new raft log");
+DEFINE_int64(vector_search_cache_capacity, 4096, "max cached vector search request num of the server");
+
+bvar::Adder<int64_t> g_vector_search_cache_hit_count("dingo_vector_search_cache_hit_count");
+bvar::Adder<int64_t> g_vector_search_cache_miss_count("dingo_vector_search_cache_miss_count");
+bvar::Adder<int64_t> g_vector_search_cache_share_count("dingo_vector_search_cache_share_count");
+
+VectorSearchCache::VectorSearchCache(SearchFunc search_func) : search_func_(std::move(search_func)) {}
+
+std::string VectorSearchCache::CacheKey(std::shared_ptr<Engine::VectorReader::Context> ctx, int64_t applied_index) {
+  std::string key = fmt::format("{}_{}_{}_{}_{}", ctx->region_id, applied_index, ctx->region_range.start_key(),
+                                ctx->region_range.end_key(), ctx->parameter.SerializeAsString());
+  for (const auto& vector_with_id : ctx->vector_with_ids) {
+    key.append(vector_with_id.SerializeAsString());
+  }
+  return key;
+}
+
+butil::Status VectorSearchCache::Search(std::shared_ptr<Engine::VectorReader::Context> ctx, int64_t applied_index,
+                                        std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (!FLAGS_enable_vector_search_cache || applied_index < 0) {
+    return search_func_(ctx, results);
+  }
+
+  auto key = CacheKey(ctx, applied_index);
+
+  ResultsPtr cached_results;
+  FlightPtr flight;
+  bool is_leader = false;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+      cached_results = it->second->results;
+    } else {
+      auto flight_it = flights_.find(key);
+      if (flight_it != flights_.end()) {
+        flight = flight_it->second;
+      } else {
+        flight = std::make_shared<Flight>();
+        flights_.emplace(key, flight);
+        is_leader = true;
+      }
+    }
+  }
+
+  if (cached_results != nullptr) {
+    g_vector_search_cache_hit_count << 1;
+    results = *cached_results;
+    return butil::Status();
+  }
+
+  if (!is_leader) {
+    g_vector_search_cache_share_count << 1;
+    flight->cond.Wait(0);
+    if (flight->status.ok()) {
+      results = *flight->results;
+    }
+    return flight->status;
+  }
+
+  g_vector_search_cache_miss_count << 1;
+  auto search_results = std::make_shared<std::vector<pb::index::VectorWithDistanceResult>>();
+  flight->status = search_func_(ctx, *search_results);
+  flight->results = search_results;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    flights_.erase(key);
+    if (flight->status.ok()) {
+      Insert(key, flight->results);
+    }
+  }
+  flight->cond.DecreaseBroadcast();
+
+  if (flight->status.ok()) {
+    results = *flight->results;
+  }
+  return flight->status;
+}
+
+void VectorSearchCache::Insert(const std::string& key, ResultsPtr results) {
+  if (FLAGS_vector_search_cache_capacity <= 0) {
+    return;
+  }
+
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    it->second->results = results;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return;
+  }
+
+  lru_.push_front(Entry{key, results});
+  entries_.emplace(key, lru_.begin());
+  while (static_cast<int64_t>(lru_.size()) > FLAGS_vector_search_cache_capacity) {
+    entries_.erase(lru_.back().key);
+    lru_.pop_back();
+  }
+}
+
+int64_t VectorSearchCache::Size() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return lru_.size();
+}
+
+}  // namespace dingodb
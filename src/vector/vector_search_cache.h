@@ -0,0 +1,87 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_SEARCH_CACHE_H_  // NOLINT
+#define DINGODB_VECTOR_SEARCH_CACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "common/synchronization.h"
+#include "engine/engine.h"
+#include "proto/index.pb.h"
+
+namespace dingodb {
+
+// Cache results of identical vector search requests, and run concurrent identical requests only once.
+// The applied index of region is part of the cache key, any applied raft log makes the old results missed,
+// they are evicted by lru later.
+// The applied index must be got before searching, so a cached result is never older than its key.
+class VectorSearchCache {
+ public:
+  using SearchFunc = std::function<butil::Status(std::shared_ptr<Engine::VectorReader::Context>,
+                                                 std::vector<pb::index::VectorWithDistanceResult>&)>;
+
+  explicit VectorSearchCache(SearchFunc search_func);
+  ~VectorSearchCache() = default;
+
+  VectorSearchCache(const VectorSearchCache&) = delete;
+  VectorSearchCache& operator=(const VectorSearchCache&) = delete;
+
+  // applied_index < 0 means unknown, search without cache.
+  butil::Status Search(std::shared_ptr<Engine::VectorReader::Context> ctx, int64_t applied_index,
+                       std::vector<pb::index::VectorWithDistanceResult>& results);
+
+  int64_t Size();
+
+ private:
+  using ResultsPtr = std::shared_ptr<const std::vector<pb::index::VectorWithDistanceResult>>;
+
+  // A search in progress, identical requests wait for it.
+  struct Flight {
+    butil::Status status;
+    ResultsPtr results;
+    // leader decrease it when the search is done.
+    BthreadCond cond{1};
+  };
+  using FlightPtr = std::shared_ptr<Flight>;
+
+  struct Entry {
+    std::string key;
+    ResultsPtr results;
+  };
+
+  static std::string CacheKey(std::shared_ptr<Engine::VectorReader::Context> ctx, int64_t applied_index);
+
+  void Insert(const std::string& key, ResultsPtr results);
+
+  SearchFunc search_func_;
+
+  bthread::Mutex mutex_;
+  // front is the most recently used.
+  std::list<Entry> lru_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> entries_;
+  std::unordered_map<std::string, FlightPtr> flights_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_SEARCH_CACHE_H_  // NOLINT
@@ -0,0 +1,51 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/latch.h"
+#include "fmt/core.h"
+
+namespace dingodb {
+
+// range(0): key count of a lock
+static void BM_LatchAcquireRelease(benchmark::State& state) {
+  const int key_count = state.range(0);
+  static Latches latches(1024);
+
+  // every thread lock its own keys, measure the latch overhead without contention.
+  std::vector<std::string> keys;
+  for (int i = 0; i < key_count; ++i) {
+    keys.push_back(fmt::format("key_{}_{}", state.thread_index(), i));
+  }
+
+  uint64_t who = state.thread_index() + 1;
+  for (auto _ : state) {
+    Lock lock(keys);
+    if (!latches.Acquire(&lock, who)) {
+      state.SkipWithError("acquire latch failed");
+      break;
+    }
+    latches.Release(&lock, who, std::nullopt);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LatchAcquireRelease)->Arg(1)->Arg(16)->Threads(1)->Threads(8);
+
+}  // namespace dingodb
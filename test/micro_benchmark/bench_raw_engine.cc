@@ -0,0 +1,161 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/rocks_raw_engine.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+static const std::string kRawEngineRootPath = "./micro_benchmark/raw_engine";
+static const std::string kDefaultCf = "default";
+
+static const std::string kRawEngineYamlConfig =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 12345\n"
+    "  coordinators: 127.0.0.1:19190,127.0.0.1:19191,127.0.0.1:19192\n"
+    "  keyring: TO_BE_CONTINUED\n"
+    "server:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23000\n"
+    "log:\n"
+    "  path: " +
+    kRawEngineRootPath +
+    "/log\n"
+    "store:\n"
+    "  path: " +
+    kRawEngineRootPath + "/db\n";
+
+static std::vector<pb::common::KeyValue> GenKvs(int64_t start, int count, int value_size) {
+  std::vector<pb::common::KeyValue> kvs;
+  kvs.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    pb::common::KeyValue kv;
+    kv.set_key(fmt::format("key{:012}", start + i));
+    kv.set_value(std::string(value_size, 'v'));
+    kvs.push_back(std::move(kv));
+  }
+
+  return kvs;
+}
+
+class RawEngineFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State& state) override {
+    if (state.thread_index() != 0) {
+      return;
+    }
+
+    Helper::CreateDirectories(kRawEngineRootPath + "/db");
+    auto config = std::make_shared<YamlConfig>();
+    if (config->Load(kRawEngineYamlConfig) != 0) {
+      return;
+    }
+
+    engine = std::make_shared<RocksRawEngine>();
+    if (!engine->Init(config, {kDefaultCf})) {
+      engine = nullptr;
+    }
+  }
+
+  void TearDown(const benchmark::State& state) override {
+    if (state.thread_index() != 0) {
+      return;
+    }
+
+    if (engine != nullptr) {
+      engine->Close();
+      engine->Destroy();
+      engine = nullptr;
+    }
+    Helper::RemoveAllFileOrDirectory(kRawEngineRootPath);
+  }
+
+  std::shared_ptr<RocksRawEngine> engine;
+};
+
+// range(0): batch size, range(1): value size
+BENCHMARK_DEFINE_F(RawEngineFixture, KvBatchPut)(benchmark::State& state) {
+  if (engine == nullptr) {
+    state.SkipWithError("init raw engine failed");
+    return;
+  }
+
+  const int batch_size = state.range(0);
+  const int value_size = state.range(1);
+  auto writer = engine->Writer();
+  int64_t start = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto kvs = GenKvs(start, batch_size, value_size);
+    start += batch_size;
+    state.ResumeTiming();
+
+    auto status = writer->KvBatchPutAndDelete(kDefaultCf, kvs, {});
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+  state.SetBytesProcessed(state.iterations() * batch_size * value_size);
+}
+BENCHMARK_REGISTER_F(RawEngineFixture, KvBatchPut)
+    ->ArgNames({"batch", "value_size"})
+    ->Args({1, 256})
+    ->Args({64, 256})
+    ->Args({64, 4096})
+    ->Unit(benchmark::kMicrosecond);
+
+// range(0): preload key count
+BENCHMARK_DEFINE_F(RawEngineFixture, KvGet)(benchmark::State& state) {
+  if (engine == nullptr) {
+    state.SkipWithError("init raw engine failed");
+    return;
+  }
+
+  const int key_count = state.range(0);
+  auto status = engine->Writer()->KvBatchPutAndDelete(kDefaultCf, GenKvs(0, key_count, 256), {});
+  if (!status.ok()) {
+    state.SkipWithError(status.error_cstr());
+    return;
+  }
+
+  auto reader = engine->Reader();
+  int64_t i = 0;
+  for (auto _ : state) {
+    std::string value;
+    status = reader->KvGet(kDefaultCf, fmt::format("key{:012}", i++ % key_count), value);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_REGISTER_F(RawEngineFixture, KvGet)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+}  // namespace dingodb
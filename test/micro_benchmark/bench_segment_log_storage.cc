@@ -0,0 +1,106 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "braft/configuration_manager.h"
+#include "braft/log_entry.h"
+#include "butil/iobuf.h"
+#include "common/helper.h"
+#include "fmt/core.h"
+#include "log/segment_log_storage.h"
+#include "proto/raft.pb.h"
+
+namespace dingodb {
+
+static const std::string kSegmentLogPath = "./micro_benchmark/segment_log";
+
+static braft::LogEntry* GenLogEntry(int64_t index, const std::string& value) {
+  auto* log_entry = new braft::LogEntry();
+  log_entry->AddRef();
+  log_entry->type = braft::ENTRY_TYPE_DATA;
+  log_entry->id.term = 1;
+  log_entry->id.index = index;
+
+  pb::raft::RaftCmdRequest raft_cmd;
+  auto* request = raft_cmd.add_requests();
+  request->set_cmd_type(pb::raft::PUT);
+  auto* kv = request->mutable_put()->add_kvs();
+  kv->set_key(fmt::format("key{:012}", index));
+  kv->set_value(value);
+
+  butil::IOBufAsZeroCopyOutputStream wrapper(&log_entry->data);
+  raft_cmd.SerializeToZeroCopyStream(&wrapper);
+
+  return log_entry;
+}
+
+// range(0): entry num of a batch, range(1): value size
+static void BM_SegmentLogStorageAppendEntries(benchmark::State& state) {
+  const int batch_size = state.range(0);
+  const int value_size = state.range(1);
+
+  Helper::RemoveAllFileOrDirectory(kSegmentLogPath);
+  Helper::CreateDirectories(kSegmentLogPath);
+  auto log_storage = std::make_shared<SegmentLogStorage>(kSegmentLogPath, 100, 8 * 1024 * 1024, INT64_MAX);
+  braft::ConfigurationManager configuration_manager;
+  if (log_storage->Init(&configuration_manager) != 0) {
+    state.SkipWithError("init segment log storage failed");
+    return;
+  }
+
+  std::string value(value_size, 'v');
+  int64_t index = log_storage->LastLogIndex();
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<braft::LogEntry*> entries;
+    entries.reserve(batch_size);
+    for (int i = 0; i < batch_size; ++i) {
+      entries.push_back(GenLogEntry(++index, value));
+    }
+    state.ResumeTiming();
+
+    int ret = log_storage->AppendEntries(entries, nullptr);
+
+    state.PauseTiming();
+    for (auto* entry : entries) {
+      entry->Release();
+    }
+    state.ResumeTiming();
+
+    if (ret != batch_size) {
+      state.SkipWithError("append entries failed");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+  state.SetBytesProcessed(state.iterations() * batch_size * value_size);
+
+  log_storage->Reset(log_storage->LastLogIndex() + 1);
+  log_storage->GcInstance(kSegmentLogPath);
+  Helper::RemoveAllFileOrDirectory(kSegmentLogPath);
+}
+BENCHMARK(BM_SegmentLogStorageAppendEntries)
+    ->ArgNames({"batch", "value_size"})
+    ->Args({1, 256})
+    ->Args({32, 256})
+    ->Args({32, 4096})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace dingodb
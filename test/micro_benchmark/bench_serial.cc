@@ -0,0 +1,171 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <any>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "proto/common.pb.h"
+#include "serial/buf.h"
+#include "serial/record_decoder.h"
+#include "serial/record_encoder.h"
+#include "serial/schema/base_schema.h"
+
+namespace dingodb {
+
+using Schemas = std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>;
+
+// id int key, name string key, age int, score double, addr string, height long
+static Schemas GenSchemas() {
+  auto schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+
+  auto id = std::make_shared<DingoSchema<std::optional<int32_t>>>();
+  id->SetIndex(0);
+  id->SetAllowNull(false);
+  id->SetIsKey(true);
+  schemas->push_back(id);
+
+  auto name = std::make_shared<DingoSchema<std::optional<std::shared_ptr<std::string>>>>();
+  name->SetIndex(1);
+  name->SetAllowNull(false);
+  name->SetIsKey(true);
+  schemas->push_back(name);
+
+  auto age = std::make_shared<DingoSchema<std::optional<int32_t>>>();
+  age->SetIndex(2);
+  age->SetAllowNull(true);
+  age->SetIsKey(false);
+  schemas->push_back(age);
+
+  auto score = std::make_shared<DingoSchema<std::optional<double>>>();
+  score->SetIndex(3);
+  score->SetAllowNull(true);
+  score->SetIsKey(false);
+  schemas->push_back(score);
+
+  auto addr = std::make_shared<DingoSchema<std::optional<std::shared_ptr<std::string>>>>();
+  addr->SetIndex(4);
+  addr->SetAllowNull(true);
+  addr->SetIsKey(false);
+  schemas->push_back(addr);
+
+  auto height = std::make_shared<DingoSchema<std::optional<int64_t>>>();
+  height->SetIndex(5);
+  height->SetAllowNull(true);
+  height->SetIsKey(false);
+  schemas->push_back(height);
+
+  return schemas;
+}
+
+static std::vector<std::any> GenRecord() {
+  std::vector<std::any> record(6);
+  record[0] = std::optional<int32_t>(10001);
+  record[1] = std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>("dingodb-micro-benchmark"));
+  record[2] = std::optional<int32_t>(28);
+  record[3] = std::optional<double>(98.5);
+  record[4] = std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>(std::string(128, 'a')));
+  record[5] = std::optional<int64_t>(180);
+  return record;
+}
+
+static void BM_RecordEncode(benchmark::State& state) {
+  auto schemas = GenSchemas();
+  auto record = GenRecord();
+  RecordEncoder encoder(1, schemas, 1001L);
+
+  for (auto _ : state) {
+    pb::common::KeyValue kv;
+    benchmark::DoNotOptimize(encoder.Encode(record, kv));
+    benchmark::DoNotOptimize(kv);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RecordEncode);
+
+static void BM_RecordDecode(benchmark::State& state) {
+  auto schemas = GenSchemas();
+  auto record = GenRecord();
+  RecordEncoder encoder(1, schemas, 1001L);
+  pb::common::KeyValue kv;
+  encoder.Encode(record, kv);
+
+  RecordDecoder decoder(1, schemas, 1001L);
+  for (auto _ : state) {
+    std::vector<std::any> decoded_record;
+    benchmark::DoNotOptimize(decoder.Decode(kv, decoded_record));
+    benchmark::DoNotOptimize(decoded_record);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RecordDecode);
+
+// decode part of columns, like selection pushdown.
+static void BM_RecordDecodeSelection(benchmark::State& state) {
+  auto schemas = GenSchemas();
+  auto record = GenRecord();
+  RecordEncoder encoder(1, schemas, 1001L);
+  pb::common::KeyValue kv;
+  encoder.Encode(record, kv);
+
+  RecordDecoder decoder(1, schemas, 1001L);
+  std::vector<int> column_indexes = {0, 3};
+  for (auto _ : state) {
+    std::vector<std::any> decoded_record;
+    benchmark::DoNotOptimize(decoder.Decode(kv, column_indexes, decoded_record));
+    benchmark::DoNotOptimize(decoded_record);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RecordDecodeSelection);
+
+static void BM_BufWriteLong(benchmark::State& state) {
+  const int64_t count = state.range(0);
+  for (auto _ : state) {
+    Buf buf(count * 8, false);
+    for (int64_t i = 0; i < count; ++i) {
+      buf.WriteLong(i);
+    }
+    benchmark::DoNotOptimize(buf.GetString());
+  }
+  state.SetBytesProcessed(state.iterations() * count * 8);
+}
+BENCHMARK(BM_BufWriteLong)->Arg(64)->Arg(1024);
+
+static void BM_BufReadLong(benchmark::State& state) {
+  const int64_t count = state.range(0);
+  Buf write_buf(count * 8, false);
+  for (int64_t i = 0; i < count; ++i) {
+    write_buf.WriteLong(i);
+  }
+  std::string data = write_buf.GetString();
+
+  for (auto _ : state) {
+    Buf buf(data, false);
+    int64_t sum = 0;
+    for (int64_t i = 0; i < count; ++i) {
+      sum += buf.ReadLong();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * count * 8);
+}
+BENCHMARK(BM_BufReadLong)->Arg(64)->Arg(1024);
+
+}  // namespace dingodb
@@ -0,0 +1,153 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "common/threadpool.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index.h"
+#include "vector/vector_index_factory.h"
+
+namespace dingodb {
+
+static const int kDimension = 128;
+static const int kDataSize = 10000;
+static const uint32_t kTopk = 10;
+
+static ThreadPoolPtr GetThreadPool() {
+  static ThreadPoolPtr thread_pool = std::make_shared<ThreadPool>("vector_index", 4);
+  return thread_pool;
+}
+
+static pb::common::RegionEpoch GenEpoch() {
+  pb::common::RegionEpoch epoch;
+  epoch.set_conf_version(1);
+  epoch.set_version(1);
+  return epoch;
+}
+
+static std::vector<pb::common::VectorWithId> GenVectors(int64_t start_id, int count) {
+  std::mt19937 rng(start_id);
+  std::uniform_real_distribution<float> distrib(0.0, 1.0);
+
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  vector_with_ids.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(start_id + i);
+    auto* vector = vector_with_id.mutable_vector();
+    vector->set_dimension(kDimension);
+    vector->set_value_type(pb::common::ValueType::FLOAT);
+    for (int j = 0; j < kDimension; ++j) {
+      vector->add_float_values(distrib(rng));
+    }
+    vector_with_ids.push_back(std::move(vector_with_id));
+  }
+
+  return vector_with_ids;
+}
+
+static VectorIndexPtr NewVectorIndex(pb::common::VectorIndexType type) {
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(type);
+  if (type == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT) {
+    index_parameter.mutable_flat_parameter()->set_dimension(kDimension);
+    index_parameter.mutable_flat_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+    return VectorIndexFactory::NewFlat(1, index_parameter, GenEpoch(), pb::common::Range(), GetThreadPool());
+  }
+
+  index_parameter.mutable_hnsw_parameter()->set_dimension(kDimension);
+  index_parameter.mutable_hnsw_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+  index_parameter.mutable_hnsw_parameter()->set_efconstruction(200);
+  index_parameter.mutable_hnsw_parameter()->set_max_elements(kDataSize * 4);
+  index_parameter.mutable_hnsw_parameter()->set_nlinks(32);
+  return VectorIndexFactory::NewHnsw(1, index_parameter, GenEpoch(), pb::common::Range(), GetThreadPool());
+}
+
+// range(0): vector index type, range(1): batch size
+static void BM_VectorIndexAdd(benchmark::State& state) {
+  auto type = static_cast<pb::common::VectorIndexType>(state.range(0));
+  const int batch_size = state.range(1);
+  auto vector_index = NewVectorIndex(type);
+  if (vector_index == nullptr) {
+    state.SkipWithError("new vector index failed");
+    return;
+  }
+
+  int64_t start_id = 1;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto vector_with_ids = GenVectors(start_id, batch_size);
+    start_id += batch_size;
+    state.ResumeTiming();
+
+    auto status = vector_index->Add(vector_with_ids);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_VectorIndexAdd)
+    ->ArgNames({"type", "batch"})
+    ->Args({pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT, 64})
+    ->Args({pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW, 64})
+    ->Iterations(100)
+    ->Unit(benchmark::kMicrosecond);
+
+// range(0): vector index type, range(1): query batch size
+static void BM_VectorIndexSearch(benchmark::State& state) {
+  auto type = static_cast<pb::common::VectorIndexType>(state.range(0));
+  const int batch_size = state.range(1);
+  auto vector_index = NewVectorIndex(type);
+  if (vector_index == nullptr) {
+    state.SkipWithError("new vector index failed");
+    return;
+  }
+  auto status = vector_index->Add(GenVectors(1, kDataSize));
+  if (!status.ok()) {
+    state.SkipWithError(status.error_cstr());
+    return;
+  }
+
+  auto query_vectors = GenVectors(kDataSize + 1, batch_size);
+  pb::common::VectorSearchParameter parameter;
+  parameter.mutable_hnsw()->set_efsearch(64);
+  for (auto _ : state) {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    status = vector_index->Search(query_vectors, kTopk, {}, false, parameter, results);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    benchmark::DoNotOptimize(results);
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_VectorIndexSearch)
+    ->ArgNames({"type", "batch"})
+    ->Args({pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT, 1})
+    ->Args({pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT, 16})
+    ->Args({pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW, 1})
+    ->Args({pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW, 16})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace dingodb
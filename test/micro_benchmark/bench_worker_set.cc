@@ -0,0 +1,69 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "common/runnable.h"
+#include "common/synchronization.h"
+
+namespace dingodb {
+
+class BenchWorkerSetTask : public TaskRunnable {
+ public:
+  explicit BenchWorkerSetTask(BthreadCond* cond) : cond_(cond) {}
+  ~BenchWorkerSetTask() override = default;
+
+  std::string Type() override { return "BENCH_TASK"; }
+
+  void Run() override { cond_->DecreaseSignal(); }
+
+ private:
+  BthreadCond* cond_{nullptr};
+};
+
+// range(0): worker num, range(1): task num of a iteration
+static void BM_WorkerSetExecuteRR(benchmark::State& state) {
+  const int worker_num = state.range(0);
+  const int task_num = state.range(1);
+
+  auto worker_set = WorkerSet::New("BenchWorkerSet", worker_num, task_num * 2);
+  if (!worker_set->Init()) {
+    state.SkipWithError("init worker set failed");
+    return;
+  }
+
+  for (auto _ : state) {
+    BthreadCond cond(task_num);
+    for (int i = 0; i < task_num; ++i) {
+      if (!worker_set->ExecuteRR(std::make_shared<BenchWorkerSetTask>(&cond))) {
+        cond.DecreaseSignal();
+      }
+    }
+    cond.Wait(0);
+  }
+  state.SetItemsProcessed(state.iterations() * task_num);
+
+  worker_set->Destroy();
+}
+BENCHMARK(BM_WorkerSetExecuteRR)
+    ->ArgNames({"worker", "task"})
+    ->Args({4, 1000})
+    ->Args({16, 1000})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace dingodb
@@ -47,6 +47,10 @@ class MockCoordinatorProxy final : public CoordinatorProxy {
 
   MOCK_METHOD(Status, TsoService, (const pb::meta::TsoRequest& request, pb::meta::TsoResponse& response), (override));
 
+  MOCK_METHOD(Status, Watch,
+              (const pb::meta::WatchRequest& request, pb::meta::WatchResponse& response, int64_t timeout_ms),
+              (override));
+
   MOCK_METHOD(Status, CreateIndex,
               (const pb::meta::CreateIndexRequest& request, pb::meta::CreateIndexResponse& response), (override));
 
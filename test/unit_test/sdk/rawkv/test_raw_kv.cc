@@ -11,11 +11,14 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 // See the License for the specific language governing permissions and
 // limitations under the License.
+#include <atomic>
 #include <cstdint>
 #include <cstdio>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -28,8 +31,10 @@
 #include "proto/error.pb.h"
 #include "sdk/client.h"
 #include "sdk/common/common.h"
+#include "sdk/common/param_config.h"
 #include "sdk/status.h"
 #include "sdk/store/store_rpc.h"
+#include "sdk/utils/async_util.h"
 #include "sdk/utils/callback.h"
 #include "test_base.h"
 #include "test_common.h"
@@ -83,6 +88,62 @@ TEST_F(RawKVTest, Get) {
   EXPECT_EQ(value, "pong");
 }
 
+TEST_F(RawKVTest, AsyncGet) {
+  std::string key = "b";
+  std::string value;
+
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillOnce([&](Rpc& rpc, std::function<void()> cb) {
+    auto* kv_get_rpc = dynamic_cast<KvGetRpc*>(&rpc);
+    CHECK_NOTNULL(kv_get_rpc);
+
+    kv_get_rpc->MutableResponse()->set_value("pong");
+    cb();
+  });
+
+  Status got;
+  Synchronizer sync;
+  raw_kv->AsyncGet(key, value, sync.AsStatusCallBack(got));
+  sync.Wait();
+
+  EXPECT_TRUE(got.IsOK());
+  EXPECT_EQ(value, "pong");
+}
+
+TEST_F(RawKVTest, CoalescePut) {
+  FLAGS_enable_raw_kv_coalesce = true;
+  FLAGS_raw_kv_coalesce_window_us = 500 * 1000;
+  FLAGS_raw_kv_coalesce_max_keys = 2;
+
+  std::atomic<int> batch_put_count{0};
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    auto* batch_put_rpc = dynamic_cast<KvBatchPutRpc*>(&rpc);
+    CHECK_NOTNULL(batch_put_rpc);
+    ++batch_put_count;
+
+    const auto* request = batch_put_rpc->Request();
+    EXPECT_EQ(2, request->kvs_size());
+    for (const auto& kv : request->kvs()) {
+      EXPECT_EQ(kv.key(), kv.value());
+    }
+
+    cb();
+  });
+
+  Status s1;
+  Status s2;
+  std::thread thread([&]() { s1 = raw_kv->Put("a", "a"); });
+  s2 = raw_kv->Put("b", "b");
+  thread.join();
+
+  EXPECT_EQ(1, batch_put_count.load());
+  EXPECT_TRUE(s1.ok());
+  EXPECT_TRUE(s2.ok());
+
+  FLAGS_enable_raw_kv_coalesce = false;
+  FLAGS_raw_kv_coalesce_window_us = 200;
+  FLAGS_raw_kv_coalesce_max_keys = 128;
+}
+
 TEST_F(RawKVTest, BatchGetSuccess) {
   std::vector<std::string> keys;
   keys.emplace_back("b");
@@ -761,6 +822,105 @@ TEST_F(RawKVTest, DeleteRangeNonContinuous) {
   EXPECT_EQ(4 * count, delete_count);
 }
 
+TEST_F(RawKVTest, ParallelDeleteRangeInThressRegion) {
+  FLAGS_raw_kv_delete_range_parallel_regions = 2;
+
+  std::string start = "b";
+  std::string end = "f";
+
+  EXPECT_CALL(*coordinator_proxy, ScanRegions)
+      .WillOnce(
+          [&](const pb::coordinator::ScanRegionsRequest& request, pb::coordinator::ScanRegionsResponse& response) {
+            EXPECT_EQ(request.key(), start);
+            EXPECT_EQ(request.range_end(), end);
+
+            Region2ScanRegionInfo(RegionA2C(), response.add_regions());
+            Region2ScanRegionInfo(RegionC2E(), response.add_regions());
+            Region2ScanRegionInfo(RegionE2G(), response.add_regions());
+
+            return Status::OK();
+          });
+
+  int64_t count = 100;
+  std::atomic<int> rpc_count{0};
+
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    auto* kv_rpc = dynamic_cast<KvDeleteRangeRpc*>(&rpc);
+    CHECK_NOTNULL(kv_rpc);
+
+    EXPECT_TRUE(kv_rpc->Request()->has_context());
+    auto context = kv_rpc->Request()->context();
+    EXPECT_TRUE(context.has_region_epoch());
+
+    auto range_with_option = kv_rpc->Request()->range();
+    const auto& range = range_with_option.range();
+
+    if (range.start_key() == start) {
+      EXPECT_EQ(range.end_key(), "c");
+    } else if (range.start_key() == "c") {
+      EXPECT_EQ(range.end_key(), "e");
+    } else if (range.start_key() == "e") {
+      EXPECT_EQ(range.end_key(), end);
+    } else {
+      EXPECT_TRUE(false);
+    }
+
+    EXPECT_TRUE(range_with_option.with_start());
+    EXPECT_FALSE(range_with_option.with_end());
+
+    kv_rpc->MutableResponse()->set_delete_count(count);
+    rpc_count.fetch_add(1);
+
+    cb();
+  });
+
+  int64_t delete_count;
+
+  EXPECT_TRUE(raw_kv->DeleteRange(start, end, delete_count).IsOK());
+  EXPECT_EQ(3 * count, delete_count);
+  EXPECT_EQ(3, rpc_count.load());
+
+  FLAGS_raw_kv_delete_range_parallel_regions = 1;
+}
+
+TEST_F(RawKVTest, ParallelDeleteRangeRegionFail) {
+  FLAGS_raw_kv_delete_range_parallel_regions = 2;
+
+  std::string start = "a";
+  std::string end = "g";
+
+  EXPECT_CALL(*coordinator_proxy, ScanRegions)
+      .WillOnce(
+          [&](const pb::coordinator::ScanRegionsRequest& request, pb::coordinator::ScanRegionsResponse& response) {
+            Region2ScanRegionInfo(RegionA2C(), response.add_regions());
+            Region2ScanRegionInfo(RegionC2E(), response.add_regions());
+            Region2ScanRegionInfo(RegionE2G(), response.add_regions());
+
+            return Status::OK();
+          });
+
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    auto* kv_rpc = dynamic_cast<KvDeleteRangeRpc*>(&rpc);
+    CHECK_NOTNULL(kv_rpc);
+
+    const auto& range = kv_rpc->Request()->range().range();
+    if (range.start_key() == "c") {
+      auto* error = kv_rpc->MutableResponse()->mutable_error();
+      error->set_errcode(pb::error::EINTERNAL);
+    } else {
+      kv_rpc->MutableResponse()->set_delete_count(100);
+    }
+
+    cb();
+  });
+
+  int64_t delete_count;
+
+  EXPECT_FALSE(raw_kv->DeleteRange(start, end, delete_count).IsOK());
+
+  FLAGS_raw_kv_delete_range_parallel_regions = 1;
+}
+
 TEST_F(RawKVTest, CompareAndSet) {
   std::string key = "d";
   std::string value = "d";
@@ -1423,5 +1583,51 @@ TEST_F(RawKVTest, ScanRegionDiscontinuousWithLimit) {
     EXPECT_EQ(kv.key, kv.value);
   }
 }
+TEST_F(RawKVTest, ParallelScanThreeRegion) {
+  FLAGS_raw_kv_scan_parallel_regions = 2;
+  FLAGS_raw_kv_scan_region_prefetch_max_kvs = 2;
+
+  std::map<std::string, std::vector<std::string>> fake_datas = {
+      {"a", {"a001", "a002", "a003"}}, {"c", {"c001", "c002", "c003"}}, {"e", {"e001", "e002", "e003"}}};
+  std::map<std::string, int> iters;
+
+  EXPECT_CALL(*region_scanner_factory, NewRegionScanner)
+      .Times(3)
+      .WillRepeatedly([&](const ScannerOptions& options, std::shared_ptr<RegionScanner>& scanner) {
+        auto mock_scanner =
+            std::make_shared<MockRegionScanner>(options.stub, options.region, options.start_key, options.end_key);
+        const auto& datas = fake_datas[options.region->Range().start_key()];
+        int& iter = iters[options.region->Range().start_key()];
+
+        EXPECT_CALL(*mock_scanner, AsyncOpen).WillOnce([&](StatusCallback cb) { cb(Status::OK()); });
+        EXPECT_CALL(*mock_scanner, HasMore).WillRepeatedly([&]() { return iter < datas.size(); });
+        EXPECT_CALL(*mock_scanner, SetBatchSize).WillRepeatedly(testing::Return(Status::OK()));
+        EXPECT_CALL(*mock_scanner, AsyncNextBatch).WillRepeatedly([&](std::vector<KVPair>& kvs, StatusCallback cb) {
+          if (iter < datas.size()) {
+            kvs.push_back({datas[iter], datas[iter]});
+            iter++;
+          }
+          cb(Status::OK());
+        });
+
+        scanner = std::move(mock_scanner);
+        return Status::OK();
+      });
+
+  std::vector<KVPair> kvs;
+  Status ret = raw_kv->Scan("a", "g", 0, kvs);
+  EXPECT_TRUE(ret.IsOK());
+
+  std::vector<std::string> expect_keys = {"a001", "a002", "a003", "c001", "c002", "c003", "e001", "e002", "e003"};
+  ASSERT_EQ(kvs.size(), expect_keys.size());
+  for (size_t i = 0; i < kvs.size(); ++i) {
+    EXPECT_EQ(kvs[i].key, expect_keys[i]);
+    EXPECT_EQ(kvs[i].key, kvs[i].value);
+  }
+
+  FLAGS_raw_kv_scan_parallel_regions = 1;
+  FLAGS_raw_kv_scan_region_prefetch_max_kvs = 1024;
+}
+
 }  // namespace sdk
 }  // namespace dingodb
\ No newline at end of file
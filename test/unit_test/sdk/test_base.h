@@ -59,6 +59,10 @@ class TestBase : public ::testing::Test {
     ON_CALL(*stub, GetStoreRpcInteraction).WillByDefault(testing::Return(store_rpc_interaction));
     EXPECT_CALL(*stub, GetStoreRpcInteraction).Times(testing::AnyNumber());
 
+    store_rpc_retry_budget = std::make_shared<StoreRpcRetryBudget>();
+    ON_CALL(*stub, GetStoreRpcRetryBudget).WillByDefault(testing::Return(store_rpc_retry_budget));
+    EXPECT_CALL(*stub, GetStoreRpcRetryBudget).Times(testing::AnyNumber());
+
     region_scanner_factory = std::make_shared<MockRegionScannerFactory>();
     ON_CALL(*stub, GetRawKvRegionScannerFactory).WillByDefault(testing::Return(region_scanner_factory));
     EXPECT_CALL(*stub, GetRawKvRegionScannerFactory).Times(testing::AnyNumber());
@@ -70,6 +74,15 @@ class TestBase : public ::testing::Test {
     txn_lock_resolver = std::make_shared<MockTxnLockResolver>(*stub);
     ON_CALL(*stub, GetTxnLockResolver).WillByDefault(testing::Return(txn_lock_resolver));
     EXPECT_CALL(*stub, GetTxnLockResolver).Times(testing::AnyNumber());
+    EXPECT_CALL(*txn_lock_resolver, ResolveLocks).Times(testing::AnyNumber());
+
+    txn_batch_get_coalescer = std::make_shared<TxnBatchGetCoalescer>(*stub);
+    ON_CALL(*stub, GetTxnBatchGetCoalescer).WillByDefault(testing::Return(txn_batch_get_coalescer));
+    EXPECT_CALL(*stub, GetTxnBatchGetCoalescer).Times(testing::AnyNumber());
+
+    raw_kv_coalescer = std::make_shared<RawKvCoalescer>(*stub);
+    ON_CALL(*stub, GetRawKvCoalescer).WillByDefault(testing::Return(raw_kv_coalescer));
+    EXPECT_CALL(*stub, GetRawKvCoalescer).Times(testing::AnyNumber());
 
     actuator.reset(new ThreadPoolActuator());
     actuator->Start(FLAGS_actuator_thread_num);
@@ -98,9 +111,12 @@ class TestBase : public ::testing::Test {
   std::shared_ptr<MockCoordinatorProxy> coordinator_proxy;
   std::shared_ptr<MetaCache> meta_cache;
   std::shared_ptr<MockRpcInteraction> store_rpc_interaction;
+  std::shared_ptr<StoreRpcRetryBudget> store_rpc_retry_budget;
   std::shared_ptr<MockRegionScannerFactory> region_scanner_factory;
   std::shared_ptr<AdminTool> admin_tool;
   std::shared_ptr<MockTxnLockResolver> txn_lock_resolver;
+  std::shared_ptr<TxnBatchGetCoalescer> txn_batch_get_coalescer;
+  std::shared_ptr<RawKvCoalescer> raw_kv_coalescer;
   std::shared_ptr<Actuator> actuator;
 
   // client own stub
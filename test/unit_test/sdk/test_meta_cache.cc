@@ -12,10 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <string_view>
 #include <vector>
 
 #include "gtest/gtest.h"
 #include "mock_coordinator_proxy.h"
+#include "sdk/common/param_config.h"
 #include "sdk/coordinator_proxy.h"
 #include "sdk/meta_cache.h"
 #include "test_common.h"
@@ -56,6 +58,112 @@ TEST_F(MetaCacheTest, LookupRegionByKey) {
   EXPECT_EQ(tmp->Range().end_key(), region->Range().end_key());
 }
 
+TEST_F(MetaCacheTest, LookupRegionsByKeys) {
+  auto a2c = RegionA2C();
+  auto c2e = RegionC2E();
+  meta_cache->MaybeAddRegion(a2c);
+  meta_cache->MaybeAddRegion(c2e);
+
+  auto e2g = RegionE2G();
+  EXPECT_CALL(*cooridnator_proxy, ScanRegions)
+      .WillOnce(
+          [&](const pb::coordinator::ScanRegionsRequest& request, pb::coordinator::ScanRegionsResponse& response) {
+            EXPECT_EQ(request.key(), "f");
+            Region2ScanRegionInfo(e2g, response.add_regions());
+            return Status::OK();
+          });
+
+  std::vector<std::string_view> keys = {"a", "b", "c", "d", "f"};
+  std::vector<std::shared_ptr<Region>> regions;
+  Status got = meta_cache->LookupRegionsByKeys(keys, regions);
+  EXPECT_TRUE(got.IsOK());
+  ASSERT_EQ(keys.size(), regions.size());
+  EXPECT_EQ(a2c->RegionId(), regions[0]->RegionId());
+  EXPECT_EQ(a2c->RegionId(), regions[1]->RegionId());
+  EXPECT_EQ(c2e->RegionId(), regions[2]->RegionId());
+  EXPECT_EQ(c2e->RegionId(), regions[3]->RegionId());
+  EXPECT_EQ(e2g->RegionId(), regions[4]->RegionId());
+}
+
+TEST_F(MetaCacheTest, LookupRemovedRegionFromSnapshot) {
+  auto a2c = RegionA2C();
+  meta_cache->MaybeAddRegion(a2c);
+
+  std::shared_ptr<Region> tmp;
+  Status got = meta_cache->LookupRegionByKey("b", tmp);
+  EXPECT_TRUE(got.IsOK());
+  EXPECT_EQ(a2c->RegionId(), tmp->RegionId());
+
+  // the removed region must not be found from the snapshot cached by this thread
+  meta_cache->RemoveRegion(a2c->RegionId());
+  EXPECT_CALL(*cooridnator_proxy, ScanRegions)
+      .WillOnce(
+          [&](const pb::coordinator::ScanRegionsRequest& request, pb::coordinator::ScanRegionsResponse& response) {
+            EXPECT_EQ(request.key(), "b");
+            return Status::OK();
+          });
+  got = meta_cache->LookupRegionByKey("b", tmp);
+  EXPECT_TRUE(got.IsNotFound());
+}
+
+TEST_F(MetaCacheTest, PrefetchLookupRegionByKey) {
+  FLAGS_meta_cache_prefetch_region_count = 3;
+  auto a2c = RegionA2C();
+  auto c2e = RegionC2E();
+  auto e2g = RegionE2G();
+
+  EXPECT_CALL(*cooridnator_proxy, ScanRegions)
+      .WillOnce(
+          [&](const pb::coordinator::ScanRegionsRequest& request, pb::coordinator::ScanRegionsResponse& response) {
+            EXPECT_EQ(request.key(), "b");
+            EXPECT_EQ(request.range_end(), std::string(1, '\0'));
+            EXPECT_EQ(request.limit(), 3);
+            Region2ScanRegionInfo(a2c, response.add_regions());
+            Region2ScanRegionInfo(c2e, response.add_regions());
+            Region2ScanRegionInfo(e2g, response.add_regions());
+            return Status::OK();
+          });
+
+  std::shared_ptr<Region> tmp;
+  Status got = meta_cache->LookupRegionByKey("b", tmp);
+  EXPECT_TRUE(got.IsOK());
+  EXPECT_EQ(tmp->RegionId(), a2c->RegionId());
+
+  // adjacent regions are cached
+  got = meta_cache->TEST_FastLookUpRegionByKey("d", tmp);
+  EXPECT_TRUE(got.IsOK());
+  EXPECT_EQ(tmp->RegionId(), c2e->RegionId());
+  got = meta_cache->TEST_FastLookUpRegionByKey("f", tmp);
+  EXPECT_TRUE(got.IsOK());
+  EXPECT_EQ(tmp->RegionId(), e2g->RegionId());
+
+  FLAGS_meta_cache_prefetch_region_count = 1;
+}
+
+TEST_F(MetaCacheTest, WarmUp) {
+  auto a2c = RegionA2C();
+  auto c2e = RegionC2E();
+
+  EXPECT_CALL(*cooridnator_proxy, ScanRegions)
+      .WillOnce(
+          [&](const pb::coordinator::ScanRegionsRequest& request, pb::coordinator::ScanRegionsResponse& response) {
+            EXPECT_EQ(request.key(), "a");
+            EXPECT_EQ(request.range_end(), "e");
+            EXPECT_EQ(request.limit(), 0);
+            Region2ScanRegionInfo(a2c, response.add_regions());
+            Region2ScanRegionInfo(c2e, response.add_regions());
+            return Status::OK();
+          });
+
+  EXPECT_TRUE(meta_cache->WarmUp("a", "e").IsOK());
+
+  std::shared_ptr<Region> tmp;
+  EXPECT_TRUE(meta_cache->TEST_FastLookUpRegionByKey("b", tmp).IsOK());
+  EXPECT_EQ(tmp->RegionId(), a2c->RegionId());
+  EXPECT_TRUE(meta_cache->TEST_FastLookUpRegionByKey("d", tmp).IsOK());
+  EXPECT_EQ(tmp->RegionId(), c2e->RegionId());
+}
+
 TEST_F(MetaCacheTest, ClearRange) {
   auto region = RegionA2C();
 
@@ -357,6 +465,27 @@ TEST_F(MetaCacheTest, StaleRegion) {
   }
 }
 
+TEST_F(MetaCacheTest, RemoveRegionIfStale) {
+  auto a2c = RegionA2C(2, 2);
+  meta_cache->MaybeAddRegion(a2c);
+
+  // same or older epoch, keep region
+  EXPECT_FALSE(meta_cache->RemoveRegionIfStale(a2c->RegionId(), a2c->Epoch()));
+  EXPECT_FALSE(meta_cache->RemoveRegionIfStale(a2c->RegionId(), RegionA2C(1, 2)->Epoch()));
+  EXPECT_FALSE(a2c->IsStale());
+
+  // not cached region
+  EXPECT_FALSE(meta_cache->RemoveRegionIfStale(RegionC2E()->RegionId(), RegionC2E(3, 3)->Epoch()));
+
+  // newer epoch, remove region
+  EXPECT_TRUE(meta_cache->RemoveRegionIfStale(a2c->RegionId(), RegionA2C(3, 2)->Epoch()));
+  EXPECT_TRUE(a2c->IsStale());
+
+  std::shared_ptr<Region> tmp;
+  Status got = meta_cache->TEST_FastLookUpRegionByKey("b", tmp);
+  EXPECT_TRUE(got.IsNotFound());
+}
+
 TEST_F(MetaCacheTest, LookupRegionBetweenRangeNotFound) {
   EXPECT_CALL(*cooridnator_proxy, ScanRegions)
       .WillOnce(
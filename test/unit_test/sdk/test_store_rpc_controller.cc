@@ -22,13 +22,16 @@
 #include "mock_rpc_interaction.h"
 #include "mock_store_rpc_controller.h"
 #include "proto/error.pb.h"
+#include "proto/store.pb.h"
 #include "sdk/common/common.h"
+#include "sdk/common/param_config.h"
 #include "sdk/meta_cache.h"
 #include "sdk/region.h"
 #include "sdk/rpc/rpc.h"
 #include "sdk/status.h"
 #include "sdk/store/store_rpc.h"
 #include "sdk/store/store_rpc_controller.h"
+#include "sdk/store/store_rpc_retry_budget.h"
 #include "test_base.h"
 #include "test_common.h"
 
@@ -409,6 +412,98 @@ TEST_F(StoreRpcControllerTest, OtherErrorCode) {
   EXPECT_FALSE(region->IsStale());
 }
 
+TEST_F(StoreRpcControllerTest, RetryBudget) {
+  FLAGS_store_rpc_retry_budget_percent = 50;
+  FLAGS_store_rpc_retry_budget_burst = 2;
+
+  StoreRpcRetryBudget budget;
+  // start full
+  EXPECT_TRUE(budget.TryWithdraw());
+  EXPECT_TRUE(budget.TryWithdraw());
+  EXPECT_FALSE(budget.TryWithdraw());
+
+  // two new rpcs earn one retry
+  budget.Deposit();
+  EXPECT_FALSE(budget.TryWithdraw());
+  budget.Deposit();
+  EXPECT_TRUE(budget.TryWithdraw());
+
+  FLAGS_store_rpc_retry_budget_percent = 0;
+  EXPECT_TRUE(budget.TryWithdraw());
+  FLAGS_store_rpc_retry_budget_burst = 100;
+}
+
+TEST_F(StoreRpcControllerTest, RequestFullRetryBudgetExhausted) {
+  FLAGS_store_rpc_retry_budget_percent = 50;
+  FLAGS_store_rpc_retry_budget_burst = 1;
+  store_rpc_retry_budget = std::make_shared<StoreRpcRetryBudget>();
+  ON_CALL(*stub, GetStoreRpcRetryBudget).WillByDefault(testing::Return(store_rpc_retry_budget));
+
+  KvGetRpc rpc;
+  std::string key = "d";
+  rpc.MutableRequest()->set_key(key);
+  std::shared_ptr<Region> region;
+  Status got = meta_cache->LookupRegionByKey(key, region);
+  EXPECT_TRUE(got.IsOK());
+
+  StoreRpcController controller(*stub, rpc, region);
+
+  // only one retry in budget
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).Times(2).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    auto* kv_rpc = dynamic_cast<KvGetRpc*>(&rpc);
+    CHECK_NOTNULL(kv_rpc);
+    kv_rpc->MutableResponse()->mutable_error()->set_errcode(pb::error::EREQUEST_FULL);
+    cb();
+  });
+
+  Status call = controller.Call();
+  EXPECT_TRUE(call.IsAborted());
+
+  FLAGS_store_rpc_retry_budget_percent = 0;
+  FLAGS_store_rpc_retry_budget_burst = 100;
+}
+
+TEST_F(StoreRpcControllerTest, HedgeStaleRead) {
+  FLAGS_enable_store_rpc_hedge = true;
+
+  KvGetRpc rpc;
+  std::string key = "d";
+  rpc.MutableRequest()->set_key(key);
+  rpc.MutableRequest()->mutable_context()->set_read_mode(pb::store::ReadStale);
+  std::shared_ptr<Region> region;
+  Status got = meta_cache->LookupRegionByKey(key, region);
+  EXPECT_TRUE(got.IsOK());
+
+  StoreRpcController controller(*stub, rpc, region);
+
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillOnce([&](Rpc& rpc, std::function<void()> cb) {
+    EXPECT_EQ(rpc.GetHedgeEndPoints().size(), region->ReplicaEndPoint().size());
+    auto* get_rpc = dynamic_cast<KvGetRpc*>(&rpc);
+    CHECK_NOTNULL(get_rpc);
+    get_rpc->MutableResponse()->set_value("pong");
+    cb();
+  });
+
+  Status call = controller.Call();
+  EXPECT_TRUE(call.IsOK());
+  EXPECT_EQ(rpc.Response()->value(), "pong");
+
+  // leader read is not hedged
+  KvGetRpc leader_rpc;
+  leader_rpc.MutableRequest()->set_key(key);
+  StoreRpcController leader_controller(*stub, leader_rpc, region);
+
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillOnce([&](Rpc& rpc, std::function<void()> cb) {
+    EXPECT_TRUE(rpc.GetHedgeEndPoints().empty());
+    cb();
+  });
+
+  call = leader_controller.Call();
+  EXPECT_TRUE(call.IsOK());
+
+  FLAGS_enable_store_rpc_hedge = false;
+}
+
 }  // namespace sdk
 
 }  // namespace dingodb
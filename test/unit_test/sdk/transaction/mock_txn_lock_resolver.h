@@ -15,6 +15,8 @@
 #ifndef DINGODB_SDK_TEST_MOCK_TXN_RESOLVER_H_
 #define DINGODB_SDK_TEST_MOCK_TXN_RESOLVER_H_
 
+#include <vector>
+
 #include "sdk/client_stub.h"
 #include "gmock/gmock.h"
 #include "sdk/status.h"
@@ -25,11 +27,26 @@ namespace sdk {
 
 class MockTxnLockResolver final : public TxnLockResolver {
  public:
-  explicit MockTxnLockResolver(const ClientStub& stub) : sdk::TxnLockResolver(stub){};
+  explicit MockTxnLockResolver(const ClientStub& stub) : sdk::TxnLockResolver(stub) {
+    // resolve every lock by ResolveLock, so tests only expect ResolveLock
+    ON_CALL(*this, ResolveLocks)
+        .WillByDefault([this](const std::vector<pb::store::LockInfo>& lock_infos, int64_t caller_start_ts) {
+          Status ret;
+          for (const auto& lock_info : lock_infos) {
+            Status s = ResolveLock(lock_info, caller_start_ts);
+            if (!s.ok()) {
+              ret = s;
+            }
+          }
+          return ret;
+        });
+  };
 
   ~MockTxnLockResolver() override = default;
 
   MOCK_METHOD(Status, ResolveLock, (const pb::store::LockInfo& lock_info, int64_t caller_start_ts), (override));
+  MOCK_METHOD(Status, ResolveLocks, (const std::vector<pb::store::LockInfo>& lock_infos, int64_t caller_start_ts),
+              (override));
 };
 
 }  // namespace sdk
@@ -12,8 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <memory>
+#include <thread>
 
 #include "common/synchronization.h"
 #include "glog/logging.h"
@@ -23,6 +26,7 @@
 #include "proto/store.pb.h"
 #include "sdk/client.h"
 #include "sdk/common/common.h"
+#include "sdk/common/param_config.h"
 #include "sdk/status.h"
 #include "sdk/store/store_rpc.h"
 #include "sdk/transaction/txn_impl.h"
@@ -119,6 +123,35 @@ TEST_F(TxnImplTest, Get) {
   EXPECT_EQ(value, "pong");
 }
 
+TEST_F(TxnImplTest, StaleRead) {
+  options.stale_read_ms = 10000;
+  auto txn = NewTransactionImpl(options);
+  auto normal_txn = NewTransactionImpl(TransactionOptions{kOptimistic, kSnapshotIsolation, 0});
+  EXPECT_LT(txn->TEST_GetStartTs(), normal_txn->TEST_GetStartTs());
+
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillOnce([&](Rpc& rpc, std::function<void()> cb) {
+    auto* txn_rpc = dynamic_cast<TxnGetRpc*>(&rpc);
+    CHECK_NOTNULL(txn_rpc);
+
+    const auto* request = txn_rpc->Request();
+    EXPECT_EQ(pb::store::ReadStale, request->context().read_mode());
+    EXPECT_EQ(request->start_ts(), txn->TEST_GetStartTs());
+
+    txn_rpc->MutableResponse()->set_value("pong");
+    cb();
+  });
+
+  std::string value;
+  EXPECT_TRUE(txn->Get("b", value).ok());
+  EXPECT_EQ(value, "pong");
+
+  // stale read txn is read only
+  EXPECT_TRUE(txn->Put("b", "b").IsIllegalState());
+  EXPECT_TRUE(txn->PreCommit().IsIllegalState());
+
+  options.stale_read_ms = 0;
+}
+
 TEST_F(TxnImplTest, SingleOP) {
   auto txn = NewTransactionImpl(options);
 
@@ -228,6 +261,54 @@ TEST_F(TxnImplTest, BatchGet) {
   }
 }
 
+TEST_F(TxnImplTest, CoalesceGet) {
+  FLAGS_enable_txn_batch_get_coalesce = true;
+  FLAGS_txn_batch_get_coalesce_window_us = 500 * 1000;
+  FLAGS_txn_batch_get_coalesce_max_keys = 2;
+
+  auto txn1 = NewTransactionImpl(options);
+  auto txn2 = NewTransactionImpl(options);
+
+  std::atomic<int> batch_get_count{0};
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    auto* txn_rpc = dynamic_cast<TxnBatchGetRpc*>(&rpc);
+    CHECK_NOTNULL(txn_rpc);
+    ++batch_get_count;
+
+    const auto* request = txn_rpc->Request();
+    EXPECT_EQ(2, request->keys_size());
+    EXPECT_EQ(2, request->key_start_ts_size());
+    for (int i = 0; i < request->keys_size(); ++i) {
+      int64_t expect_ts = request->keys(i) == "a" ? txn1->TEST_GetStartTs() : txn2->TEST_GetStartTs();
+      EXPECT_EQ(expect_ts, request->key_start_ts(i));
+      if (request->keys(i) == "a") {
+        auto* kv = txn_rpc->MutableResponse()->add_kvs();
+        kv->set_key("a");
+        kv->set_value("a");
+      }
+    }
+
+    cb();
+  });
+
+  std::string value1;
+  std::string value2;
+  Status s1;
+  Status s2;
+  std::thread thread([&]() { s1 = txn1->Get("a", value1); });
+  s2 = txn2->Get("b", value2);
+  thread.join();
+
+  EXPECT_EQ(1, batch_get_count.load());
+  EXPECT_TRUE(s1.ok());
+  EXPECT_EQ("a", value1);
+  EXPECT_TRUE(s2.IsNotFound());
+
+  FLAGS_enable_txn_batch_get_coalesce = false;
+  FLAGS_txn_batch_get_coalesce_window_us = 200;
+  FLAGS_txn_batch_get_coalesce_max_keys = 128;
+}
+
 TEST_F(TxnImplTest, BatchGetFromBuffer) {
   std::vector<KVPair> kvs;
   kvs.push_back({"b", "b"});
@@ -257,6 +338,112 @@ TEST_F(TxnImplTest, BatchGetFromBuffer) {
   }
 }
 
+TEST_F(TxnImplTest, ReadCache) {
+  auto txn = NewTransactionImpl(options);
+
+  std::atomic<int> get_count{0};
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    auto* txn_rpc = dynamic_cast<TxnGetRpc*>(&rpc);
+    CHECK_NOTNULL(txn_rpc);
+    ++get_count;
+
+    if (txn_rpc->Request()->key() == "b") {
+      txn_rpc->MutableResponse()->set_value("b");
+    }
+    cb();
+  });
+
+  for (int i = 0; i < 3; ++i) {
+    std::string value;
+    EXPECT_TRUE(txn->Get("b", value).ok());
+    EXPECT_EQ("b", value);
+    EXPECT_TRUE(txn->Get("d", value).IsNotFound());
+  }
+  EXPECT_EQ(2, get_count.load());
+  EXPECT_EQ(2, txn->TEST_ReadCacheSize());
+
+  // write of txn is read from buffer
+  EXPECT_TRUE(txn->Put("b", "nb").ok());
+  std::string value;
+  EXPECT_TRUE(txn->Get("b", value).ok());
+  EXPECT_EQ("nb", value);
+
+  // batch get of cached keys sends no rpc
+  std::vector<KVPair> kvs;
+  EXPECT_TRUE(txn->BatchGet({"b", "d"}, kvs).ok());
+  ASSERT_EQ(1, kvs.size());
+  EXPECT_EQ("nb", kvs[0].value);
+  EXPECT_EQ(2, get_count.load());
+}
+
+TEST_F(TxnImplTest, ReadCacheReadCommitted) {
+  options.isolation = kReadCommitted;
+  auto txn = NewTransactionImpl(options);
+
+  std::atomic<int> get_count{0};
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    auto* txn_rpc = dynamic_cast<TxnGetRpc*>(&rpc);
+    CHECK_NOTNULL(txn_rpc);
+    ++get_count;
+
+    txn_rpc->MutableResponse()->set_value("b");
+    cb();
+  });
+
+  // read committed txn reads the latest committed value every time
+  std::string value;
+  EXPECT_TRUE(txn->Get("b", value).ok());
+  EXPECT_TRUE(txn->Get("b", value).ok());
+  EXPECT_EQ(2, get_count.load());
+  EXPECT_EQ(0, txn->TEST_ReadCacheSize());
+
+  EXPECT_TRUE(txn->Prefetch({"b", "d"}).ok());
+  EXPECT_EQ(2, get_count.load());
+
+  options.isolation = kSnapshotIsolation;
+}
+
+TEST_F(TxnImplTest, Prefetch) {
+  auto txn = NewTransactionImpl(options);
+  EXPECT_TRUE(txn->Put("a", "a").ok());
+
+  std::atomic<int> batch_get_count{0};
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    auto* txn_rpc = dynamic_cast<TxnBatchGetRpc*>(&rpc);
+    CHECK_NOTNULL(txn_rpc);
+    ++batch_get_count;
+
+    // key in buffer is not fetched, keys of region [a, c) and [c, e) are fetched by one rpc each
+    const auto* request = txn_rpc->Request();
+    for (const auto& key : request->keys()) {
+      EXPECT_NE("a", key);
+      if (key != "d") {
+        auto* kv = txn_rpc->MutableResponse()->add_kvs();
+        kv->set_key(key);
+        kv->set_value(key);
+      }
+    }
+    cb();
+  });
+
+  EXPECT_TRUE(txn->Prefetch({"a", "b", "bb", "c", "d", "b"}).ok());
+  EXPECT_EQ(2, batch_get_count.load());
+  EXPECT_EQ(4, txn->TEST_ReadCacheSize());
+
+  // prefetched keys are served from cache
+  std::string value;
+  EXPECT_TRUE(txn->Get("bb", value).ok());
+  EXPECT_EQ("bb", value);
+  EXPECT_TRUE(txn->Get("d", value).IsNotFound());
+
+  std::vector<KVPair> kvs;
+  EXPECT_TRUE(txn->BatchGet({"a", "b", "c", "d"}, kvs).ok());
+  EXPECT_EQ(3, kvs.size());
+
+  EXPECT_TRUE(txn->Prefetch({"b", "c"}).ok());
+  EXPECT_EQ(2, batch_get_count.load());
+}
+
 TEST_F(TxnImplTest, BatchOp) {
   std::vector<KVPair> kvs;
   kvs.push_back({"b", "b"});
@@ -386,6 +573,136 @@ TEST_F(TxnImplTest, CommitWithData) {
   EXPECT_EQ(txn->TEST_GetTransactionState(), TransactionState::kCommitted);
 }
 
+TEST_F(TxnImplTest, CommitSingleRegion) {
+  FLAGS_enable_txn_single_region_commit = true;
+
+  auto txn = NewTransactionImpl(options);
+
+  // a and b are both in region [a, c)
+  txn->Put("a", "a");
+  txn->Put("b", "b");
+
+  int prewrite_count = 0;
+  int commit_count = 0;
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    TxnPrewriteRpc* txn_rpc = dynamic_cast<TxnPrewriteRpc*>(&rpc);
+    if (nullptr == txn_rpc) {
+      TxnCommitRpc* txn_rpc = dynamic_cast<TxnCommitRpc*>(&rpc);
+      CHECK_NOTNULL(txn_rpc);
+      const auto* request = txn_rpc->Request();
+      EXPECT_EQ(request->commit_ts(), txn->TEST_GetCommitTs());
+      EXPECT_EQ(request->keys_size(), 2);
+      EXPECT_EQ(request->keys(0), txn->TEST_GetPrimaryKey());
+      ++commit_count;
+    } else {
+      const auto* request = txn_rpc->Request();
+      EXPECT_EQ(request->mutations_size(), 2);
+      EXPECT_EQ(request->primary_lock(), txn->TEST_GetPrimaryKey());
+      ++prewrite_count;
+    }
+    cb();
+  });
+
+  Status s = txn->PreCommit();
+  EXPECT_TRUE(s.ok());
+  EXPECT_EQ(txn->TEST_GetTransactionState(), TransactionState::kPreCommitted);
+
+  s = txn->Commit();
+  EXPECT_TRUE(s.ok());
+  EXPECT_EQ(txn->TEST_GetTransactionState(), TransactionState::kCommitted);
+
+  EXPECT_EQ(1, prewrite_count);
+  EXPECT_EQ(1, commit_count);
+
+  FLAGS_enable_txn_single_region_commit = false;
+}
+
+TEST_F(TxnImplTest, AsyncCommitSecondary) {
+  FLAGS_enable_txn_async_commit_secondary = true;
+
+  auto txn = NewTransactionImpl(options);
+  txn->Put("a", "a");
+  txn->Put("b", "b");
+  txn->Put("d", "d");
+
+  std::atomic<int> commit_count{0};
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    TxnCommitRpc* txn_rpc = dynamic_cast<TxnCommitRpc*>(&rpc);
+    if (txn_rpc != nullptr) {
+      ++commit_count;
+    }
+    cb();
+  });
+
+  Status s = txn->PreCommit();
+  EXPECT_TRUE(s.ok());
+
+  s = txn->Commit();
+  EXPECT_TRUE(s.ok());
+  EXPECT_EQ(txn->TEST_GetTransactionState(), TransactionState::kCommitted);
+
+  // primary key and secondary keys of two regions
+  for (int i = 0; i < 100 && commit_count.load() < 3; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(3, commit_count.load());
+
+  FLAGS_enable_txn_async_commit_secondary = false;
+}
+
+TEST_F(TxnImplTest, PipelinedFlush) {
+  FLAGS_txn_pipelined_flush_mutations = 2;
+
+  auto txn = NewTransactionImpl(options);
+
+  std::atomic<int> prewrite_count = 0;
+  std::atomic<int> commit_count = 0;
+  std::atomic<int> resolve_count = 0;
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    if (auto* prewrite_rpc = dynamic_cast<TxnPrewriteRpc*>(&rpc); prewrite_rpc != nullptr) {
+      const auto* request = prewrite_rpc->Request();
+      EXPECT_EQ(request->mutations_size(), 1);
+      EXPECT_EQ(request->primary_lock(), "a");
+      ++prewrite_count;
+    } else if (auto* commit_rpc = dynamic_cast<TxnCommitRpc*>(&rpc); commit_rpc != nullptr) {
+      const auto* request = commit_rpc->Request();
+      EXPECT_EQ(request->keys_size(), 1);
+      EXPECT_EQ(request->keys(0), "a");
+      ++commit_count;
+    } else {
+      auto* resolve_rpc = dynamic_cast<TxnResolveLockRpc*>(&rpc);
+      CHECK_NOTNULL(resolve_rpc);
+      const auto* request = resolve_rpc->Request();
+      EXPECT_EQ(request->keys_size(), 0);
+      EXPECT_EQ(request->commit_ts(), txn->TEST_GetCommitTs());
+      ++resolve_count;
+    }
+    cb();
+  });
+
+  // a and b are flushed, primary key a first
+  EXPECT_TRUE(txn->Put("a", "a").ok());
+  EXPECT_TRUE(txn->Put("b", "b").ok());
+  EXPECT_EQ(txn->TEST_MutationsSize(), 0);
+  EXPECT_TRUE(txn->Put("d", "d").ok());
+  EXPECT_EQ(txn->TEST_MutationsSize(), 1);
+  EXPECT_EQ(txn->TEST_GetPrimaryKey(), "a");
+
+  Status s = txn->PreCommit();
+  EXPECT_TRUE(s.ok());
+  EXPECT_EQ(txn->TEST_GetTransactionState(), TransactionState::kPreCommitted);
+  EXPECT_EQ(3, prewrite_count);
+
+  s = txn->Commit();
+  EXPECT_TRUE(s.ok());
+  EXPECT_EQ(txn->TEST_GetTransactionState(), TransactionState::kCommitted);
+  EXPECT_EQ(1, commit_count);
+  // region [a, c) and [c, e)
+  EXPECT_EQ(2, resolve_count);
+
+  FLAGS_txn_pipelined_flush_mutations = 0;
+}
+
 TEST_F(TxnImplTest, PrimaryKeyLockConflict) {
   auto txn = NewTransactionImpl(options);
 
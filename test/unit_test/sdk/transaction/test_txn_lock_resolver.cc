@@ -12,7 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "sdk/common/common.h"
@@ -487,6 +490,59 @@ TEST_F(TxnLockResolverTest, Rollbacked) {
   EXPECT_TRUE(s.ok());
 }
 
+TEST_F(TxnLockResolverTest, BatchResolveAndCache) {
+  auto fake_lock = PrepareLockInfo();
+  std::vector<pb::store::LockInfo> lock_infos;
+  for (const auto& key : {"b", "b1", "d"}) {
+    fake_lock.set_key(key);
+    lock_infos.push_back(fake_lock);
+  }
+
+  auto fake_tso = CurrentFakeTso();
+  EXPECT_CALL(*coordinator_proxy, TsoService)
+      .WillOnce([&](const pb::meta::TsoRequest& request, pb::meta::TsoResponse& response) {
+        *response.mutable_start_timestamp() = fake_tso;
+        return Status::OK();
+      });
+
+  int check_count = 0;
+  std::map<int64_t, std::vector<std::string>> resolved_keys;
+  EXPECT_CALL(*store_rpc_interaction, SendRpc).WillRepeatedly([&](Rpc& rpc, std::function<void()> cb) {
+    if (auto* check_rpc = dynamic_cast<TxnCheckTxnStatusRpc*>(&rpc); check_rpc != nullptr) {
+      ++check_count;
+      EXPECT_EQ(check_rpc->Request()->primary_key(), fake_lock.primary_lock());
+      check_rpc->MutableResponse()->set_commit_ts(check_rpc->Request()->current_ts());
+    } else {
+      auto* resolve_rpc = dynamic_cast<TxnResolveLockRpc*>(&rpc);
+      CHECK_NOTNULL(resolve_rpc);
+      EXPECT_EQ(resolve_rpc->Request()->commit_ts(), Tso2Timestamp(fake_tso));
+      auto& keys = resolved_keys[resolve_rpc->Request()->context().region_id()];
+      keys.insert(keys.end(), resolve_rpc->Request()->keys().begin(), resolve_rpc->Request()->keys().end());
+    }
+    cb();
+  });
+
+  Status s = lock_resolver->ResolveLocks(lock_infos, Tso2Timestamp(init_tso));
+  EXPECT_TRUE(s.ok());
+  EXPECT_EQ(1, check_count);
+
+  std::shared_ptr<Region> region_ac;
+  std::shared_ptr<Region> region_ce;
+  CHECK(meta_cache->LookupRegionByKey("b", region_ac).IsOK());
+  CHECK(meta_cache->LookupRegionByKey("d", region_ce).IsOK());
+  // primary key and keys of region [a, c) are resolved by two rpc, region [c, e) by one rpc
+  EXPECT_EQ((std::vector<std::string>{fake_lock.primary_lock(), "b", "b1"}), resolved_keys[region_ac->RegionId()]);
+  EXPECT_EQ((std::vector<std::string>{"d"}), resolved_keys[region_ce->RegionId()]);
+
+  // txn status is cached, no more check
+  resolved_keys.clear();
+  fake_lock.set_key("b2");
+  s = lock_resolver->ResolveLock(fake_lock, Tso2Timestamp(init_tso));
+  EXPECT_TRUE(s.ok());
+  EXPECT_EQ(1, check_count);
+  EXPECT_EQ((std::vector<std::string>{"b2"}), resolved_keys[region_ac->RegionId()]);
+}
+
 }  // namespace sdk
 
 }  // namespace dingodb
\ No newline at end of file
@@ -0,0 +1,127 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/async_logger.h"
+#include "glog/logging.h"
+
+namespace dingodb {
+
+class FakeLogger : public google::base::Logger {
+ public:
+  void Write(bool /*force_flush*/, time_t /*timestamp*/, const char* message, size_t message_len) override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    messages_.emplace_back(message, message_len);
+  }
+
+  void Flush() override { flush_count_.fetch_add(1); }
+
+  uint32_t LogSize() override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return messages_.size();
+  }
+
+  std::vector<std::string> Messages() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return messages_;
+  }
+
+  int FlushCount() const { return flush_count_.load(); }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::string> messages_;
+  std::atomic<int> flush_count_{0};
+};
+
+class AsyncLoggerTest : public testing::Test {};
+
+TEST_F(AsyncLoggerTest, WriteAndFlush) {
+  FakeLogger fake_logger;
+  AsyncLogger logger(&fake_logger, 1024 * 1024);
+  logger.Start();
+
+  for (int i = 0; i < 100; ++i) {
+    std::string message = "message_" + std::to_string(i);
+    logger.Write(false, time(nullptr), message.data(), message.size());
+  }
+  logger.Flush();
+
+  auto messages = fake_logger.Messages();
+  ASSERT_EQ(messages.size(), 100);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(messages[i], "message_" + std::to_string(i));
+  }
+  EXPECT_GE(fake_logger.FlushCount(), 1);
+
+  logger.Stop();
+}
+
+TEST_F(AsyncLoggerTest, SmallBuffer) {
+  FakeLogger fake_logger;
+  // every message fills the buffer, the writers wait for the background thread.
+  AsyncLogger logger(&fake_logger, 16);
+  logger.Start();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&logger, t] {
+      for (int i = 0; i < 100; ++i) {
+        std::string message = "thread_" + std::to_string(t) + "_message_" + std::to_string(i);
+        logger.Write(false, time(nullptr), message.data(), message.size());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  logger.Stop();
+  EXPECT_EQ(fake_logger.Messages().size(), 400);
+  EXPECT_EQ(logger.DroppedCount(), 0);
+}
+
+TEST_F(AsyncLoggerTest, WriteWhenStopped) {
+  FakeLogger fake_logger;
+  AsyncLogger logger(&fake_logger, 1024);
+
+  std::string message = "before_start";
+  logger.Write(false, time(nullptr), message.data(), message.size());
+  EXPECT_EQ(fake_logger.Messages().size(), 1);
+
+  logger.Start();
+  message = "after_start";
+  logger.Write(false, time(nullptr), message.data(), message.size());
+  logger.Stop();
+
+  message = "after_stop";
+  logger.Write(false, time(nullptr), message.data(), message.size());
+
+  auto messages = fake_logger.Messages();
+  ASSERT_EQ(messages.size(), 3);
+  EXPECT_EQ(messages[0], "before_start");
+  EXPECT_EQ(messages[1], "after_start");
+  EXPECT_EQ(messages[2], "after_stop");
+}
+
+}  // namespace dingodb
@@ -17,9 +17,11 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "butil/status.h"
+#include "coprocessor/aggregation_group_table.h"
 #include "coprocessor/aggregation_manager.h"
 #include "coprocessor/utils.h"
 #include "proto/common.pb.h"
@@ -2795,4 +2797,37 @@ TEST_F(CoprocessorAggregationManagerTest, CreateIterator) {
 
 TEST_F(CoprocessorAggregationManagerTest, Close) { aggregation_manager->Close(); }
 
+TEST_F(CoprocessorAggregationManagerTest, GroupTable) {
+  AggregationGroupTable table;
+
+  // enough groups to rehash several times, include a big key which own an arena block.
+  for (int i = 0; i < 1000; i++) {
+    bool is_new = false;
+    size_t index = table.FindOrInsert("key_" + std::to_string(i), is_new);
+    EXPECT_TRUE(is_new);
+    EXPECT_EQ(index, i);
+  }
+  std::string big_key(64 * 1024, 'b');
+  bool is_new = false;
+  EXPECT_EQ(table.FindOrInsert(big_key, is_new), 1000);
+  EXPECT_TRUE(is_new);
+  EXPECT_EQ(table.FindOrInsert("", is_new), 1001);
+  EXPECT_TRUE(is_new);
+
+  for (int i = 0; i < 1000; i++) {
+    size_t index = table.FindOrInsert("key_" + std::to_string(i), is_new);
+    EXPECT_FALSE(is_new);
+    EXPECT_EQ(index, i);
+    EXPECT_EQ(table.GetGroup(index).key, "key_" + std::to_string(i));
+  }
+  EXPECT_EQ(table.FindOrInsert(big_key, is_new), 1000);
+  EXPECT_FALSE(is_new);
+  EXPECT_EQ(table.GetGroup(1000).key, big_key);
+  EXPECT_EQ(table.FindOrInsert("", is_new), 1001);
+  EXPECT_FALSE(is_new);
+
+  EXPECT_EQ(table.Size(), 1002);
+  EXPECT_GT(table.MemoryBytes(), big_key.size());
+}
+
 }  // namespace dingodb
@@ -0,0 +1,149 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <any>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "coprocessor/top_n.h"
+#include "coprocessor/utils.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {  // NOLINT
+
+class CoprocessorTopNTest : public testing::Test {
+ protected:
+  static std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> GenResultSchemas() {
+    google::protobuf::RepeatedPtrField<pb::common::Schema> pb_schemas;
+
+    pb::common::Schema schema1;
+    schema1.set_type(::dingodb::pb::common::Schema_Type::Schema_Type_LONG);
+    schema1.set_is_key(true);
+    schema1.set_is_nullable(true);
+    schema1.set_index(0);
+    pb_schemas.Add(std::move(schema1));
+
+    pb::common::Schema schema2;
+    schema2.set_type(::dingodb::pb::common::Schema_Type::Schema_Type_STRING);
+    schema2.set_is_key(false);
+    schema2.set_is_nullable(true);
+    schema2.set_index(1);
+    pb_schemas.Add(std::move(schema2));
+
+    auto result_serial_schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+    butil::Status ok = Utils::TransToSerialSchema(pb_schemas, &result_serial_schemas);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    return result_serial_schemas;
+  }
+
+  static std::vector<std::any> GenRecord(std::optional<int64_t> score, const std::string& name) {
+    std::vector<std::any> record;
+    record.emplace_back(score);
+    record.emplace_back(std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>(name)));
+    return record;
+  }
+
+  static int64_t GetScore(const std::vector<std::any>& record) {
+    const auto& score = std::any_cast<const std::optional<int64_t>&>(record[0]);
+    return score.has_value() ? score.value() : -1;
+  }
+
+  static std::string GetName(const std::vector<std::any>& record) {
+    const auto& name = std::any_cast<const std::optional<std::shared_ptr<std::string>>&>(record[1]);
+    return *name.value();
+  }
+};
+
+TEST_F(CoprocessorTopNTest, Init) {
+  pb::common::CoprocessorV2::TopN top_n;
+  top_n.set_limit(3);
+  {
+    TopNHeap heap(top_n, GenResultSchemas());
+    EXPECT_EQ(pb::error::EILLEGAL_PARAMTETERS, heap.Init().error_code());
+  }
+
+  top_n.add_sort_columns()->set_index(2);
+  {
+    TopNHeap heap(top_n, GenResultSchemas());
+    EXPECT_EQ(pb::error::EILLEGAL_PARAMTETERS, heap.Init().error_code());
+  }
+
+  top_n.mutable_sort_columns(0)->set_index(0);
+  {
+    TopNHeap heap(top_n, GenResultSchemas());
+    EXPECT_TRUE(heap.Init().ok());
+  }
+}
+
+TEST_F(CoprocessorTopNTest, Desc) {
+  pb::common::CoprocessorV2::TopN top_n;
+  top_n.set_limit(3);
+  auto* sort_column = top_n.add_sort_columns();
+  sort_column->set_index(0);
+  sort_column->set_desc(true);
+
+  TopNHeap heap(top_n, GenResultSchemas());
+  ASSERT_TRUE(heap.Init().ok());
+
+  std::vector<int64_t> scores = {5, 1, 9, 3, 7, 9, 2, 8};
+  for (auto score : scores) {
+    heap.Add(GenRecord(score, "name"));
+  }
+  heap.Add(GenRecord(std::nullopt, "null"));
+  EXPECT_EQ(3, heap.Size());
+
+  auto rows = heap.Finish();
+  ASSERT_EQ(3, rows.size());
+  EXPECT_EQ(9, GetScore(rows[0]));
+  EXPECT_EQ(9, GetScore(rows[1]));
+  EXPECT_EQ(8, GetScore(rows[2]));
+  EXPECT_EQ(0, heap.Size());
+}
+
+TEST_F(CoprocessorTopNTest, MultiColumns) {
+  pb::common::CoprocessorV2::TopN top_n;
+  top_n.set_limit(4);
+  top_n.add_sort_columns()->set_index(0);
+  auto* sort_column = top_n.add_sort_columns();
+  sort_column->set_index(1);
+  sort_column->set_desc(true);
+
+  TopNHeap heap(top_n, GenResultSchemas());
+  ASSERT_TRUE(heap.Init().ok());
+
+  heap.Add(GenRecord(2, "a"));
+  heap.Add(GenRecord(1, "a"));
+  heap.Add(GenRecord(1, "c"));
+  heap.Add(GenRecord(3, "z"));
+  heap.Add(GenRecord(std::nullopt, "b"));
+  heap.Add(GenRecord(1, "b"));
+
+  auto rows = heap.Finish();
+  ASSERT_EQ(4, rows.size());
+  // null is less than any value
+  EXPECT_EQ(-1, GetScore(rows[0]));
+  EXPECT_EQ("c", GetName(rows[1]));
+  EXPECT_EQ("b", GetName(rows[2]));
+  EXPECT_EQ("a", GetName(rows[3]));
+  EXPECT_EQ(1, GetScore(rows[3]));
+}
+
+}  // namespace dingodb
@@ -18,6 +18,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
@@ -38,8 +39,10 @@
 #include "coordinator/tso_control.h"
 #include "coprocessor/coprocessor_scalar.h"
 #include "coprocessor/coprocessor_v2.h"
+#include "coprocessor/coprocessor_v2_plan_cache.h"
 #include "engine/rocks_raw_engine.h"
 #include "engine/txn_engine_helper.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/store_internal.pb.h"
@@ -52,6 +55,11 @@
 
 namespace dingodb {
 
+DECLARE_int32(coprocessor_v2_batch_size);
+DECLARE_int32(coprocessor_v2_decode_thread_num);
+DECLARE_int32(coprocessor_v2_decode_min_rows_per_thread);
+DECLARE_int32(coprocessor_v2_plan_cache_capacity);
+
 static const std::string kDefaultCf = "default";
 
 static const std::vector<std::string> kAllCFs = {Constant::kTxnWriteCF, Constant::kTxnDataCF, Constant::kTxnLockCF,
@@ -921,6 +929,109 @@ TEST_F(CoprocessorTestV2, Execute) {
   EXPECT_EQ(cnt, keys.size());
 }
 
+TEST_F(CoprocessorTestV2, ExecuteBatch) {
+  butil::Status ok;
+
+  std::sort(keys.begin(), keys.end());
+
+  IteratorOptions options;
+  options.upper_bound = Helper::PrefixNext(keys.back());
+  auto iter = engine->Reader()->NewIterator(kDefaultCf, options);
+  bool key_only = false;
+  size_t max_fetch_cnt = 5;
+  int64_t max_bytes_rpc = 1000000000000000;
+  std::vector<pb::common::KeyValue> kvs;
+
+  iter->Seek(keys.front());
+
+  // batch size not divide max_fetch_cnt, the last batch is flushed by limit.
+  FLAGS_coprocessor_v2_batch_size = 2;
+  size_t cnt = 0;
+
+  while (true) {
+    bool has_more = false;
+    ok = coprocessor->Execute(iter, key_only, max_fetch_cnt, max_bytes_rpc, &kvs, has_more);
+    EXPECT_EQ(ok.error_code(), pb::error::OK);
+    cnt += kvs.size();
+    if (!has_more) {
+      break;
+    }
+    kvs.clear();
+  }
+  FLAGS_coprocessor_v2_batch_size = 0;
+
+  LOG(INFO) << "ExecuteBatch key_values cnt : " << cnt;
+
+  EXPECT_EQ(cnt, keys.size());
+}
+
+TEST_F(CoprocessorTestV2, ExecuteBatchParallelDecode) {
+  butil::Status ok;
+
+  std::sort(keys.begin(), keys.end());
+
+  IteratorOptions options;
+  options.upper_bound = Helper::PrefixNext(keys.back());
+  auto iter = engine->Reader()->NewIterator(kDefaultCf, options);
+  bool key_only = false;
+  size_t max_fetch_cnt = 5;
+  int64_t max_bytes_rpc = 1000000000000000;
+  std::vector<pb::common::KeyValue> kvs;
+  std::vector<std::string> result_keys;
+
+  iter->Seek(keys.front());
+
+  // every batch is split to parts decoded by the thread pool.
+  FLAGS_coprocessor_v2_batch_size = 4;
+  FLAGS_coprocessor_v2_decode_thread_num = 2;
+  FLAGS_coprocessor_v2_decode_min_rows_per_thread = 1;
+
+  while (true) {
+    bool has_more = false;
+    ok = coprocessor->Execute(iter, key_only, max_fetch_cnt, max_bytes_rpc, &kvs, has_more);
+    EXPECT_EQ(ok.error_code(), pb::error::OK);
+    for (const auto& kv : kvs) {
+      result_keys.push_back(kv.key());
+    }
+    if (!has_more) {
+      break;
+    }
+    kvs.clear();
+  }
+  FLAGS_coprocessor_v2_batch_size = 0;
+  FLAGS_coprocessor_v2_decode_thread_num = 0;
+  FLAGS_coprocessor_v2_decode_min_rows_per_thread = 256;
+
+  EXPECT_EQ(result_keys.size(), keys.size());
+  EXPECT_TRUE(std::is_sorted(result_keys.begin(), result_keys.end()));
+}
+
+TEST_F(CoprocessorTestV2, PlanCache) {
+  auto& plan_cache = CoprocessorV2PlanCache::GetInstance();
+  plan_cache.Clear();
+  EXPECT_FALSE(plan_cache.IsEnabled());
+
+  FLAGS_coprocessor_v2_plan_cache_capacity = 2;
+  EXPECT_TRUE(plan_cache.IsEnabled());
+
+  auto plan1 = std::make_shared<CoprocessorV2Plan>();
+  plan1->selection_column_indexes = {0, 2};
+  plan_cache.Put("plan1", plan1);
+  plan_cache.Put("plan2", std::make_shared<CoprocessorV2Plan>());
+  EXPECT_EQ(plan_cache.Get("plan1"), plan1);
+  EXPECT_EQ(plan_cache.Get("plan3"), nullptr);
+
+  // the oldest plan is evicted.
+  plan_cache.Put("plan3", std::make_shared<CoprocessorV2Plan>());
+  EXPECT_EQ(plan_cache.Size(), 2);
+  EXPECT_EQ(plan_cache.Get("plan1"), nullptr);
+  EXPECT_NE(plan_cache.Get("plan3"), nullptr);
+
+  FLAGS_coprocessor_v2_plan_cache_capacity = 0;
+  plan_cache.Clear();
+  EXPECT_EQ(plan_cache.Size(), 0);
+}
+
 TEST_F(CoprocessorTestV2, ExecuteTxn) {
   butil::Status ok;
 
@@ -18,9 +18,13 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "butil/crc32c.h"
+#include "butil/iobuf.h"
 #include "common/helper.h"
 #include "fmt/core.h"
+#include "proto/raft.pb.h"
 #include "server/service_helper.h"
 
 class HelperTest : public testing::Test {
@@ -568,3 +572,93 @@ TEST_F(HelperTest, GetMemComparableRange) {
   EXPECT_EQ(dingodb::Helper::PaddingUserKey(range.start_key()), mem_comparable_range.start_key());
   EXPECT_EQ(dingodb::Helper::PaddingUserKey(range.end_key()), mem_comparable_range.end_key());
 }
+
+TEST_F(HelperTest, CalculateUniformSplitKeys) {
+  auto split_keys = dingodb::Helper::CalculateUniformSplitKeys("a", "b", 2);
+  ASSERT_EQ(1, split_keys.size());
+  EXPECT_EQ(std::string("a\x80", 2), split_keys[0]);
+
+  std::string start_key("t\x00\x00\x00\x00\x00\x00\x00\x01", 9);
+  std::string end_key("t\x00\x00\x00\x00\x00\x00\x00\x02", 9);
+  split_keys = dingodb::Helper::CalculateUniformSplitKeys(start_key, end_key, 4);
+  ASSERT_EQ(3, split_keys.size());
+  EXPECT_EQ(start_key + std::string("\x40", 1), split_keys[0]);
+  EXPECT_EQ(start_key + std::string("\x80", 1), split_keys[1]);
+  EXPECT_EQ(start_key + std::string("\xc0", 1), split_keys[2]);
+
+  // every split key is in range and increasing
+  split_keys = dingodb::Helper::CalculateUniformSplitKeys("abc", "abd", 300);
+  ASSERT_FALSE(split_keys.empty());
+  std::string prev_key = "abc";
+  for (const auto& split_key : split_keys) {
+    EXPECT_GT(split_key, prev_key);
+    EXPECT_LT(split_key, "abd");
+    prev_key = split_key;
+  }
+
+  EXPECT_TRUE(dingodb::Helper::CalculateUniformSplitKeys("a", "b", 1).empty());
+  EXPECT_TRUE(dingodb::Helper::CalculateUniformSplitKeys("b", "a", 4).empty());
+}
+
+TEST_F(HelperTest, CalculateSampleSplitKeys) {
+  std::vector<std::string> sample_keys = {"a5", "a1", "z", "a3", "a2", "a4", "a", "a6", "a3"};
+  auto split_keys = dingodb::Helper::CalculateSampleSplitKeys("a", "b", sample_keys, 3);
+  ASSERT_EQ(2, split_keys.size());
+  EXPECT_EQ("a3", split_keys[0]);
+  EXPECT_EQ("a5", split_keys[1]);
+
+  // less sample keys than regions
+  split_keys = dingodb::Helper::CalculateSampleSplitKeys("a", "b", {"a1"}, 4);
+  ASSERT_EQ(1, split_keys.size());
+  EXPECT_EQ("a1", split_keys[0]);
+
+  EXPECT_TRUE(dingodb::Helper::CalculateSampleSplitKeys("a", "b", {"c"}, 4).empty());
+}
+
+TEST_F(HelperTest, IsVectorIndexWarmPeer) {
+  dingodb::pb::common::RegionDefinition definition;
+  for (int64_t store_id : {1003, 1001, 1002}) {
+    definition.add_peers()->set_store_id(store_id);
+  }
+
+  EXPECT_TRUE(dingodb::Helper::IsVectorIndexWarmPeer(definition, 1001, 1));
+  EXPECT_TRUE(dingodb::Helper::IsVectorIndexWarmPeer(definition, 1002, 1));
+  EXPECT_FALSE(dingodb::Helper::IsVectorIndexWarmPeer(definition, 1003, 1));
+  EXPECT_FALSE(dingodb::Helper::IsVectorIndexWarmPeer(definition, 1002, 0));
+  EXPECT_TRUE(dingodb::Helper::IsVectorIndexWarmPeer(definition, 1003, 5));
+  EXPECT_FALSE(dingodb::Helper::IsVectorIndexWarmPeer(definition, 1004, 5));
+}
+
+TEST_F(HelperTest, NewArenaMessage) {
+  dingodb::pb::raft::RaftCmdRequest request;
+  request.mutable_header()->set_region_id(1001);
+  auto* put = request.add_requests()->mutable_put();
+  put->set_cf_name("default");
+  put->add_kvs()->set_key("key1");
+  std::string data = request.SerializeAsString();
+
+  std::shared_ptr<dingodb::pb::raft::RaftCmdRequest> arena_request;
+  {
+    auto message = dingodb::Helper::NewArenaMessage<dingodb::pb::raft::RaftCmdRequest>(256);
+    ASSERT_NE(nullptr, message->GetArena());
+    ASSERT_TRUE(message->ParseFromString(data));
+    // the arena lives with the last reference
+    arena_request = message;
+  }
+
+  EXPECT_EQ(1001, arena_request->header().region_id());
+  ASSERT_EQ(1, arena_request->requests_size());
+  EXPECT_EQ("key1", arena_request->requests(0).put().kvs(0).key());
+}
+
+TEST_F(HelperTest, Crc32c) {
+  std::string data(100000, 'a');
+  butil::IOBuf buf;
+  buf.append(data.data(), 30000);
+  butil::IOBuf other;
+  other.append(data.data() + 30000, data.size() - 30000);
+  buf.append(other);
+
+  EXPECT_EQ(butil::crc32c::Value(data.data(), data.size()), dingodb::Helper::Crc32c(buf));
+  EXPECT_EQ(0, dingodb::Helper::Crc32c(butil::IOBuf()));
+}
@@ -397,4 +397,68 @@ TEST(DingoLatchTest, partially_releasing) {
   TestPartiallyReleasingImpl(64);
   TestPartiallyReleasingImpl(4);
   TestPartiallyReleasingImpl(2);
-}
\ No newline at end of file
+}
+TEST(DingoLatchTest, range_lock) {
+  dingodb::Latches latches(256);
+
+  std::vector<std::string> keys_a{"k1", "k2"};
+  std::vector<std::string> keys_c{"k3"};
+  dingodb::Lock lock_a(keys_a);
+  dingodb::Lock lock_b("k0", "k9");
+  dingodb::Lock lock_c(keys_c);
+  uint64_t cid_a = 1;
+  uint64_t cid_b = 2;
+  uint64_t cid_c = 3;
+
+  std::vector<uint64_t> wakeup;
+
+  // a acquire key lock success
+  EXPECT_TRUE(latches.Acquire(&lock_a, cid_a, &wakeup));
+
+  // b acquire range lock failed, cause a is holding key lock
+  EXPECT_FALSE(latches.Acquire(&lock_b, cid_b, &wakeup));
+
+  // c acquire key lock failed, cause b is waiting for the range
+  EXPECT_FALSE(latches.Acquire(&lock_c, cid_c, &wakeup));
+  EXPECT_TRUE(wakeup.empty());
+
+  // a release key lock, wakeup b
+  wakeup = latches.Release(&lock_a, cid_a, std::nullopt);
+  ASSERT_EQ(wakeup.size(), 1);
+  EXPECT_EQ(wakeup[0], cid_b);
+
+  // b acquire range lock success
+  EXPECT_TRUE(latches.Acquire(&lock_b, cid_b, &wakeup));
+
+  // b release range lock, wakeup c
+  wakeup = latches.Release(&lock_b, cid_b, std::nullopt);
+  ASSERT_EQ(wakeup.size(), 1);
+  EXPECT_EQ(wakeup[0], cid_c);
+
+  // c acquire key lock success
+  EXPECT_TRUE(latches.Acquire(&lock_c, cid_c, &wakeup));
+  latches.Release(&lock_c, cid_c, std::nullopt);
+}
+
+TEST(DingoLatchTest, hot_slots) {
+  dingodb::Latches latches(256);
+
+  std::vector<std::string> keys{"k1"};
+  dingodb::Lock lock_a(keys);
+  dingodb::Lock lock_b(keys);
+  uint64_t cid_a = 1;
+  uint64_t cid_b = 2;
+
+  EXPECT_TRUE(latches.Acquire(&lock_a, cid_a));
+  EXPECT_FALSE(latches.Acquire(&lock_b, cid_b));
+  latches.Release(&lock_a, cid_a, std::nullopt);
+  EXPECT_TRUE(latches.Acquire(&lock_b, cid_b));
+  latches.Release(&lock_b, cid_b, std::nullopt);
+
+  auto slot_stats = latches.GetHotSlots(10);
+  ASSERT_EQ(slot_stats.size(), 1);
+  EXPECT_EQ(slot_stats[0].index, latches.GetSlotIndex(dingodb::Lock::Hash("k1")));
+  EXPECT_EQ(slot_stats[0].acquire_count, 2);
+  EXPECT_EQ(slot_stats[0].wait_count, 1);
+  EXPECT_EQ(slot_stats[0].waiting_num, 0);
+}
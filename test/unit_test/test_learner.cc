@@ -0,0 +1,63 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "meta/store_meta_manager.h"
+#include "proto/common.pb.h"
+#include "store/learner.h"
+
+namespace dingodb {
+
+class LearnerTest : public testing::Test {};
+
+static pb::common::Peer GenPeer(int64_t store_id, pb::common::PeerRole role) {
+  pb::common::Peer peer;
+  peer.set_store_id(store_id);
+  peer.set_role(role);
+  return peer;
+}
+
+TEST_F(LearnerTest, IsLearner) {
+  std::vector<pb::common::Peer> peers = {GenPeer(1001, pb::common::VOTER), GenPeer(1002, pb::common::VOTER),
+                                         GenPeer(1003, pb::common::LEARNER)};
+
+  EXPECT_FALSE(LearnerManager::IsLearner(peers, 1001));
+  EXPECT_TRUE(LearnerManager::IsLearner(peers, 1003));
+  EXPECT_FALSE(LearnerManager::IsLearner(peers, 1004));
+  EXPECT_FALSE(LearnerManager::IsLearner({}, 1003));
+}
+
+TEST_F(LearnerTest, PeersByRole) {
+  pb::common::RegionDefinition definition;
+  definition.set_id(1);
+  *definition.add_peers() = GenPeer(1001, pb::common::VOTER);
+  *definition.add_peers() = GenPeer(1003, pb::common::LEARNER);
+  *definition.add_peers() = GenPeer(1002, pb::common::VOTER);
+  auto region = store::Region::New(definition);
+
+  auto voters = region->Peers(pb::common::VOTER);
+  ASSERT_EQ(2, voters.size());
+  EXPECT_EQ(1001, voters[0].store_id());
+  EXPECT_EQ(1002, voters[1].store_id());
+
+  auto learners = region->Peers(pb::common::LEARNER);
+  ASSERT_EQ(1, learners.size());
+  EXPECT_EQ(1003, learners[0].store_id());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,92 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "fmt/core.h"
+#include "split/load_split.h"
+
+namespace dingodb {
+
+class RegionLoadTest : public testing::Test {};
+
+TEST_F(RegionLoadTest, Statistic) {
+  RegionLoad region_load;
+  // first statistic only start the window.
+  region_load.Statistic(1000, 1, 4, 100);
+  EXPECT_EQ(0, region_load.ReadQps());
+
+  for (int i = 0; i < 100; ++i) {
+    region_load.Record(fmt::format("key{:03}", i), i % 2 == 0, 1, 0);
+  }
+  region_load.Statistic(2000, 1, 4, 100);
+
+  EXPECT_EQ(50, region_load.ReadQps());
+  EXPECT_EQ(50, region_load.WriteQps());
+  EXPECT_EQ("key050", region_load.MedianKey());
+  EXPECT_EQ(1, region_load.HotCount());
+
+  auto buckets = region_load.Buckets();
+  ASSERT_EQ(4, buckets.size());
+  EXPECT_EQ("key000", buckets[0].start_key());
+  EXPECT_EQ("key025", buckets[0].end_key());
+  EXPECT_TRUE(buckets[3].end_key().empty());
+
+  // no load in next window, not hot any more.
+  region_load.Statistic(3000, 1, 4, 100);
+  EXPECT_EQ(0, region_load.ReadQps());
+  EXPECT_EQ(0, region_load.HotCount());
+  EXPECT_TRUE(region_load.MedianKey().empty());
+}
+
+TEST_F(RegionLoadTest, HotKeys) {
+  RegionLoad region_load;
+  region_load.Statistic(1000, 1, 4, 100);
+
+  for (int i = 0; i < 200; ++i) {
+    region_load.Record(fmt::format("key{:03}", i), false, 1, 10);
+  }
+  for (int i = 0; i < 100; ++i) {
+    region_load.Record("hot_key", true, 1, 100);
+  }
+  region_load.RecordBytes(false, 1000);
+  region_load.Statistic(2000, 1, 4, 100);
+
+  EXPECT_EQ(3000, region_load.ReadBytesPerSecond());
+  EXPECT_EQ(10000, region_load.WriteBytesPerSecond());
+
+  auto hot_keys = region_load.HotKeys();
+  ASSERT_FALSE(hot_keys.empty());
+  EXPECT_EQ("hot_key", hot_keys[0].key());
+  EXPECT_LE(100, hot_keys[0].qps());
+}
+
+TEST_F(RegionLoadTest, CountMinSketch) {
+  CountMinSketch sketch;
+  for (int i = 0; i < 1000; ++i) {
+    sketch.Add(fmt::format("key{}", i), 1);
+  }
+  // Estimate is never less than real count.
+  EXPECT_LE(1, sketch.Estimate("key1"));
+  EXPECT_LE(101, sketch.Add("key1", 100));
+
+  sketch.Clear();
+  EXPECT_EQ(0, sketch.Estimate("key1"));
+}
+
+}  // namespace dingodb
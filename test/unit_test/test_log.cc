@@ -37,3 +37,48 @@ class DingoLoggerTest : public testing::Test {
 //   VLOG(1) << "This is a log";
 //   EXPECT_EQ(FLAGS_v, debug_level);
 // }
+
+TEST_F(DingoLoggerTest, LogRateLimiterEveryN) {
+  dingodb::LogRateLimiter limiter;
+  int allowed = 0;
+  for (int i = 0; i < 10; ++i) {
+    if (limiter.AllowEveryN(3)) {
+      ++allowed;
+    }
+  }
+  // 1st, 4th, 7th, 10th
+  EXPECT_EQ(allowed, 4);
+
+  dingodb::LogRateLimiter limiter2;
+  EXPECT_TRUE(limiter2.AllowEveryN(1));
+  EXPECT_TRUE(limiter2.AllowEveryN(1));
+}
+
+TEST_F(DingoLoggerTest, LogRateLimiterEverySeconds) {
+  dingodb::LogRateLimiter limiter;
+  EXPECT_TRUE(limiter.AllowEverySeconds(1));
+  EXPECT_FALSE(limiter.AllowEverySeconds(1));
+  EXPECT_FALSE(limiter.AllowEverySeconds(1));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  EXPECT_TRUE(limiter.AllowEverySeconds(1));
+  EXPECT_FALSE(limiter.AllowEverySeconds(1));
+}
+
+TEST_F(DingoLoggerTest, LogIsOn) {
+  int old_level = FLAGS_minloglevel;
+  int evaluated = 0;
+  auto eval = [&]() { return ++evaluated; };
+
+  FLAGS_minloglevel = google::GLOG_WARNING;
+  EXPECT_FALSE(DINGO_LOG_IS_ON(INFO));
+  DINGO_LOG(INFO) << eval();
+  EXPECT_EQ(evaluated, 0);
+
+  FLAGS_minloglevel = google::GLOG_INFO;
+  EXPECT_TRUE(DINGO_LOG_IS_ON(INFO));
+  DINGO_LOG(INFO) << eval();
+  EXPECT_EQ(evaluated, 1);
+
+  FLAGS_minloglevel = old_level;
+}
@@ -0,0 +1,144 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "braft/log_entry.h"
+#include "log/log_entry_cache.h"
+
+class LogEntryCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  static std::vector<braft::LogEntry*> GenLogEntries(int64_t start_index, int64_t count, size_t data_size) {
+    std::vector<braft::LogEntry*> entries;
+    for (int64_t i = 0; i < count; ++i) {
+      auto* entry = new braft::LogEntry();
+      entry->AddRef();
+      entry->type = braft::ENTRY_TYPE_DATA;
+      entry->id.term = 1;
+      entry->id.index = start_index + i;
+      entry->data.append(std::string(data_size, 'a'));
+      entries.push_back(entry);
+    }
+    return entries;
+  }
+
+  static void ReleaseLogEntries(std::vector<braft::LogEntry*>& entries) {
+    for (auto* entry : entries) {
+      entry->Release();
+    }
+    entries.clear();
+  }
+};
+
+TEST_F(LogEntryCacheTest, PutAndGet) {
+  dingodb::LogEntryCache cache(1);
+  cache.SetCapacity(1024 * 1024);
+
+  auto entries = GenLogEntries(1, 10, 100);
+  cache.Put(1001, entries.data(), entries.size());
+  ReleaseLogEntries(entries);
+  EXPECT_EQ(10, cache.Count());
+
+  auto* entry = cache.Get(1001, 5);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(5, entry->id.index);
+  EXPECT_EQ(100, entry->data.length());
+  entry->Release();
+
+  EXPECT_EQ(nullptr, cache.Get(1001, 11));
+  EXPECT_EQ(nullptr, cache.Get(1002, 5));
+
+  // replace entry of same index
+  entries = GenLogEntries(5, 1, 200);
+  entries[0]->id.term = 2;
+  cache.Put(1001, entries.data(), entries.size());
+  ReleaseLogEntries(entries);
+  EXPECT_EQ(10, cache.Count());
+  entry = cache.Get(1001, 5);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(2, entry->id.term);
+  EXPECT_EQ(200, entry->data.length());
+  entry->Release();
+}
+
+TEST_F(LogEntryCacheTest, Truncate) {
+  dingodb::LogEntryCache cache(4);
+  cache.SetCapacity(4 * 1024 * 1024);
+
+  auto entries = GenLogEntries(1, 10, 100);
+  cache.Put(1001, entries.data(), entries.size());
+  cache.Put(1002, entries.data(), entries.size());
+  ReleaseLogEntries(entries);
+  EXPECT_EQ(20, cache.Count());
+
+  cache.TruncatePrefix(1001, 4);
+  EXPECT_EQ(nullptr, cache.Get(1001, 3));
+  EXPECT_EQ(17, cache.Count());
+
+  cache.TruncateSuffix(1001, 8);
+  EXPECT_EQ(nullptr, cache.Get(1001, 9));
+  EXPECT_EQ(15, cache.Count());
+
+  auto* entry = cache.Get(1001, 8);
+  ASSERT_NE(nullptr, entry);
+  entry->Release();
+
+  cache.EraseRegion(1001);
+  EXPECT_EQ(10, cache.Count());
+  EXPECT_EQ(nullptr, cache.Get(1001, 5));
+
+  cache.EraseRegion(1002);
+  EXPECT_EQ(0, cache.Count());
+  EXPECT_EQ(0, cache.Bytes());
+}
+
+TEST_F(LogEntryCacheTest, Evict) {
+  dingodb::LogEntryCache cache(1);
+  int64_t entry_bytes = sizeof(braft::LogEntry) + 1000;
+  cache.SetCapacity(entry_bytes * 5);
+
+  auto entries = GenLogEntries(1, 5, 1000);
+  cache.Put(1001, entries.data(), entries.size());
+  ReleaseLogEntries(entries);
+  EXPECT_EQ(5, cache.Count());
+
+  // touch the oldest entry, the second one is evicted
+  auto* entry = cache.Get(1001, 1);
+  ASSERT_NE(nullptr, entry);
+  entry->Release();
+
+  entries = GenLogEntries(6, 1, 1000);
+  cache.Put(1001, entries.data(), entries.size());
+  ReleaseLogEntries(entries);
+  EXPECT_EQ(5, cache.Count());
+  EXPECT_LE(cache.Bytes(), entry_bytes * 5);
+
+  entry = cache.Get(1001, 1);
+  ASSERT_NE(nullptr, entry);
+  entry->Release();
+  EXPECT_EQ(nullptr, cache.Get(1001, 2));
+
+  // entry exceeds capacity is not cached
+  entries = GenLogEntries(7, 1, entry_bytes * 5);
+  cache.Put(1001, entries.data(), entries.size());
+  ReleaseLogEntries(entries);
+  EXPECT_EQ(nullptr, cache.Get(1001, 7));
+}
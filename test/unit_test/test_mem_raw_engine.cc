@@ -0,0 +1,154 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine/mem_raw_engine.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+static const std::string kDefaultCf = "default";
+
+class MemRawEngineTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    engine = std::make_shared<MemRawEngine>();
+    ASSERT_TRUE(engine->Init(nullptr, {kDefaultCf}));
+  }
+
+  void TearDown() override { engine->Close(); }
+
+  static pb::common::KeyValue GenKv(const std::string& key, const std::string& value) {
+    pb::common::KeyValue kv;
+    kv.set_key(key);
+    kv.set_value(value);
+    return kv;
+  }
+
+  std::shared_ptr<MemRawEngine> engine;
+};
+
+TEST_F(MemRawEngineTest, PutGetDelete) {
+  auto writer = engine->Writer();
+  auto reader = engine->Reader();
+  ASSERT_TRUE(writer->KvPut(kDefaultCf, GenKv("key1", "value1")).ok());
+
+  std::string value;
+  ASSERT_TRUE(reader->KvGet(kDefaultCf, "key1", value).ok());
+  EXPECT_EQ("value1", value);
+
+  ASSERT_TRUE(writer->KvDelete(kDefaultCf, "key1").ok());
+  EXPECT_EQ(pb::error::EKEY_NOT_FOUND, reader->KvGet(kDefaultCf, "key1", value).error_code());
+
+  EXPECT_EQ(pb::error::EINTERNAL, writer->KvPut("not_exist_cf", GenKv("key1", "value1")).error_code());
+}
+
+TEST_F(MemRawEngineTest, Snapshot) {
+  auto writer = engine->Writer();
+  auto reader = engine->Reader();
+  ASSERT_TRUE(writer->KvPut(kDefaultCf, GenKv("key1", "value1")).ok());
+
+  auto snapshot = engine->GetSnapshot();
+  ASSERT_TRUE(writer->KvPut(kDefaultCf, GenKv("key1", "value2")).ok());
+  ASSERT_TRUE(writer->KvPut(kDefaultCf, GenKv("key2", "value2")).ok());
+
+  std::string value;
+  ASSERT_TRUE(reader->KvGet(kDefaultCf, snapshot, "key1", value).ok());
+  EXPECT_EQ("value1", value);
+  EXPECT_EQ(pb::error::EKEY_NOT_FOUND, reader->KvGet(kDefaultCf, snapshot, "key2", value).error_code());
+
+  // Old version is kept for snapshot after compact.
+  ASSERT_TRUE(engine->Compact(kDefaultCf).ok());
+  ASSERT_TRUE(reader->KvGet(kDefaultCf, snapshot, "key1", value).ok());
+  EXPECT_EQ("value1", value);
+
+  ASSERT_TRUE(reader->KvGet(kDefaultCf, "key1", value).ok());
+  EXPECT_EQ("value2", value);
+
+  // Old version is reclaimed after snapshot released.
+  int64_t memtable_bytes = 0;
+  int64_t block_cache_bytes = 0;
+  engine->GetMemoryUsage(memtable_bytes, block_cache_bytes);
+  int64_t bytes_with_snapshot = memtable_bytes;
+  snapshot.reset();
+  ASSERT_TRUE(engine->Compact(kDefaultCf).ok());
+  engine->GetMemoryUsage(memtable_bytes, block_cache_bytes);
+  EXPECT_LT(memtable_bytes, bytes_with_snapshot);
+}
+
+TEST_F(MemRawEngineTest, DeleteRange) {
+  auto writer = engine->Writer();
+  auto reader = engine->Reader();
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(writer->KvPut(kDefaultCf, GenKv("key" + std::to_string(i), "value")).ok());
+  }
+
+  auto snapshot = engine->GetSnapshot();
+
+  pb::common::Range range;
+  range.set_start_key("key3");
+  range.set_end_key("key7");
+  ASSERT_TRUE(writer->KvDeleteRange(kDefaultCf, range).ok());
+
+  int64_t count = 0;
+  ASSERT_TRUE(reader->KvCount(kDefaultCf, "key", "kez", count).ok());
+  EXPECT_EQ(6, count);
+  ASSERT_TRUE(reader->KvCount(kDefaultCf, snapshot, "key", "kez", count).ok());
+  EXPECT_EQ(10, count);
+}
+
+TEST_F(MemRawEngineTest, Iterator) {
+  auto writer = engine->Writer();
+  auto reader = engine->Reader();
+  ASSERT_TRUE(writer->KvBatchPutAndDelete(kDefaultCf, {GenKv("a", "1"), GenKv("b", "2"), GenKv("c", "3")}, {}).ok());
+
+  IteratorOptions options;
+  options.lower_bound = "a";
+  options.upper_bound = "c";
+  auto iter = reader->NewIterator(kDefaultCf, options);
+  ASSERT_NE(nullptr, iter);
+
+  // Write after iterator created is not visible.
+  ASSERT_TRUE(writer->KvPut(kDefaultCf, GenKv("aa", "4")).ok());
+  ASSERT_TRUE(writer->KvDelete(kDefaultCf, "b").ok());
+
+  std::vector<std::string> keys;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    keys.emplace_back(iter->Key());
+  }
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), keys);
+
+  iter->SeekToLast();
+  ASSERT_TRUE(iter->Valid());
+  EXPECT_EQ("b", iter->Key());
+  EXPECT_EQ("2", iter->Value());
+  iter->Prev();
+  ASSERT_TRUE(iter->Valid());
+  EXPECT_EQ("a", iter->Key());
+  iter->Prev();
+  EXPECT_FALSE(iter->Valid());
+
+  iter->SeekForPrev("az");
+  ASSERT_TRUE(iter->Valid());
+  EXPECT_EQ("a", iter->Key());
+}
+
+}  // namespace dingodb
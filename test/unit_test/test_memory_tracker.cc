@@ -0,0 +1,69 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "common/memory_tracker.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DECLARE_int64(memory_budget_total_bytes);
+DECLARE_int64(memory_budget_scan_context_bytes);
+
+class MemoryTrackerTest : public testing::Test {
+ protected:
+  void TearDown() override {
+    FLAGS_memory_budget_total_bytes = 0;
+    FLAGS_memory_budget_scan_context_bytes = 0;
+    for (int i = 0; i < static_cast<int>(MemoryTracker::Type::kMax); ++i) {
+      MemoryTracker::GetInstance().Set(static_cast<MemoryTracker::Type>(i), 0);
+    }
+  }
+};
+
+TEST_F(MemoryTrackerTest, Usage) {
+  auto& memory_tracker = MemoryTracker::GetInstance();
+  memory_tracker.Set(MemoryTracker::Type::kBlockCache, 100);
+  memory_tracker.Add(MemoryTracker::Type::kScanContext, 30);
+  memory_tracker.Add(MemoryTracker::Type::kScanContext, -10);
+
+  EXPECT_EQ(100, memory_tracker.Usage(MemoryTracker::Type::kBlockCache));
+  EXPECT_EQ(20, memory_tracker.Usage(MemoryTracker::Type::kScanContext));
+  EXPECT_EQ(120, memory_tracker.TotalUsage());
+}
+
+TEST_F(MemoryTrackerTest, CheckBudget) {
+  auto& memory_tracker = MemoryTracker::GetInstance();
+  memory_tracker.Set(MemoryTracker::Type::kScanContext, 100);
+
+  // unlimited
+  EXPECT_TRUE(memory_tracker.CheckBudget(MemoryTracker::Type::kScanContext, 1000).ok());
+
+  FLAGS_memory_budget_scan_context_bytes = 200;
+  EXPECT_TRUE(memory_tracker.CheckBudget(MemoryTracker::Type::kScanContext, 100).ok());
+  auto status = memory_tracker.CheckBudget(MemoryTracker::Type::kScanContext, 101);
+  EXPECT_EQ(pb::error::ESYSTEM_MEMORY_CAPACITY_FULL, status.error_code());
+
+  // exceed total budget by other subsystem.
+  memory_tracker.Set(MemoryTracker::Type::kMemtable, 1000);
+  FLAGS_memory_budget_total_bytes = 1000;
+  status = memory_tracker.CheckBudget(MemoryTracker::Type::kScanContext, 0);
+  EXPECT_EQ(pb::error::ESYSTEM_MEMORY_CAPACITY_FULL, status.error_code());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,42 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "common/numa.h"
+
+namespace dingodb {
+
+class NumaTest : public testing::Test {};
+
+TEST_F(NumaTest, ParseList) {
+  EXPECT_TRUE(Numa::ParseList("").empty());
+  EXPECT_EQ(std::vector<int>({0}), Numa::ParseList("0"));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 8, 9}), Numa::ParseList("0-3,8-9"));
+  EXPECT_EQ(std::vector<int>({1, 4, 5}), Numa::ParseList("1,4-5"));
+}
+
+TEST_F(NumaTest, NodeOfRegion) {
+  int node_num = Numa::NodeNum();
+  ASSERT_LE(1, node_num);
+  for (int64_t region_id = 1; region_id < 10; ++region_id) {
+    int node = Numa::NodeOfRegion(region_id);
+    EXPECT_LE(0, node);
+    EXPECT_GT(node_num, node);
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,123 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "engine/raw_kv_ttl.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+DECLARE_bool(enable_raw_kv_ttl);
+
+class RawKvTtlTest : public testing::Test {
+ protected:
+  void SetUp() override { FLAGS_enable_raw_kv_ttl = true; }
+  void TearDown() override { FLAGS_enable_raw_kv_ttl = false; }
+
+  static pb::common::KeyValue GenKv(const std::string& key, const std::string& value, int64_t expire_ms) {
+    pb::common::KeyValue kv;
+    kv.set_key(key);
+    kv.set_value(value);
+    RawKvTtl::EncodeValueWithExpireTs(expire_ms, *kv.mutable_value());
+    return kv;
+  }
+};
+
+TEST_F(RawKvTtlTest, IsEnabled) {
+  std::string client_raw_key = std::string(1, Constant::kClientRaw) + "key";
+  std::string executor_raw_key = std::string(1, Constant::kExecutorRaw) + "key";
+
+  EXPECT_TRUE(RawKvTtl::IsEnabled(Constant::kStoreDataCF, client_raw_key));
+  EXPECT_FALSE(RawKvTtl::IsEnabled(Constant::kStoreDataCF, executor_raw_key));
+  EXPECT_FALSE(RawKvTtl::IsEnabled(Constant::kTxnDataCF, client_raw_key));
+  EXPECT_FALSE(RawKvTtl::IsEnabled(Constant::kStoreDataCF, ""));
+
+  FLAGS_enable_raw_kv_ttl = false;
+  EXPECT_FALSE(RawKvTtl::IsEnabled(Constant::kStoreDataCF, client_raw_key));
+}
+
+TEST_F(RawKvTtlTest, EncodeDecode) {
+  std::string value = "value";
+  RawKvTtl::EncodeValueWithExpireTs(1000, value);
+  EXPECT_EQ(RawKvTtl::kHeaderSize + 5, value.size());
+  EXPECT_EQ(1000, RawKvTtl::GetExpireTs(value));
+
+  std::string_view user_value;
+  EXPECT_TRUE(RawKvTtl::DecodeValue(value, 999, user_value));
+  EXPECT_EQ("value", user_value);
+  EXPECT_FALSE(RawKvTtl::DecodeValue(value, 1000, user_value));
+
+  // never expire
+  std::string forever_value = "value";
+  RawKvTtl::EncodeValue(0, forever_value);
+  EXPECT_EQ(0, RawKvTtl::GetExpireTs(forever_value));
+  EXPECT_TRUE(RawKvTtl::DecodeValue(forever_value, INT64_MAX, user_value));
+  EXPECT_EQ("value", user_value);
+
+  // empty value is not encoded
+  std::string empty_value;
+  RawKvTtl::EncodeValue(1000, empty_value);
+  EXPECT_TRUE(empty_value.empty());
+  EXPECT_TRUE(RawKvTtl::DecodeValue(empty_value, INT64_MAX, user_value));
+  EXPECT_TRUE(user_value.empty());
+
+  std::string ttl_value = "value";
+  int64_t now_ms = Helper::TimestampMs();
+  RawKvTtl::EncodeValue(60 * 1000, ttl_value);
+  EXPECT_GE(RawKvTtl::GetExpireTs(ttl_value), now_ms + 60 * 1000);
+}
+
+TEST_F(RawKvTtlTest, DecodeKvs) {
+  int64_t now_ms = Helper::TimestampMs();
+  std::vector<pb::common::KeyValue> kvs;
+  kvs.push_back(GenKv("wa", "va", 0));
+  kvs.push_back(GenKv("wb", "vb", now_ms - 1000));
+  kvs.push_back(GenKv("wc", "vc", now_ms + 60 * 1000));
+  kvs.push_back(GenKv("wd", "vd", 1));
+
+  RawKvTtl::DecodeKvs(kvs);
+  ASSERT_EQ(2, kvs.size());
+  EXPECT_EQ("wa", kvs[0].key());
+  EXPECT_EQ("va", kvs[0].value());
+  EXPECT_EQ("wc", kvs[1].key());
+  EXPECT_EQ("vc", kvs[1].value());
+}
+
+TEST_F(RawKvTtlTest, CompactionFilter) {
+  RawKvTtlCompactionFilter filter(1000);
+
+  auto filter_kv = [&filter](const pb::common::KeyValue& kv) {
+    std::string new_value;
+    bool value_changed = false;
+    return filter.Filter(0, kv.key(), kv.value(), &new_value, &value_changed);
+  };
+
+  EXPECT_TRUE(filter_kv(GenKv("wa", "va", 999)));
+  EXPECT_TRUE(filter_kv(GenKv("wb", "vb", 1000)));
+  EXPECT_FALSE(filter_kv(GenKv("wc", "vc", 1001)));
+  EXPECT_FALSE(filter_kv(GenKv("wd", "vd", 0)));
+  // not client raw kv
+  EXPECT_FALSE(filter_kv(GenKv("ra", "va", 999)));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,49 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "engine/raw_engine.h"
+#include "engine/region_compactor.h"
+
+namespace dingodb {
+
+class RegionCompactorTest : public testing::Test {};
+
+TEST_F(RegionCompactorTest, NeedCompact) {
+  RawEngine::DeletionStats stats;
+  EXPECT_FALSE(RegionCompactor::NeedCompact(stats, 0.3, 1000));
+
+  // Dense tombstones, but too few.
+  stats.entry_count = 1000;
+  stats.deletion_count = 900;
+  EXPECT_FALSE(RegionCompactor::NeedCompact(stats, 0.3, 1000));
+
+  stats.entry_count = 100000;
+  stats.deletion_count = 20000;
+  EXPECT_FALSE(RegionCompactor::NeedCompact(stats, 0.3, 1000));
+  stats.deletion_count = 30000;
+  EXPECT_TRUE(RegionCompactor::NeedCompact(stats, 0.3, 1000));
+}
+
+TEST_F(RegionCompactorTest, RangeDeletion) {
+  RawEngine::DeletionStats stats;
+  stats.range_deletion_count = 1;
+  EXPECT_FALSE(RegionCompactor::NeedCompact(stats, 0.3, 1000));
+
+  stats.entry_count = 10;
+  EXPECT_TRUE(RegionCompactor::NeedCompact(stats, 0.3, 1000));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,105 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <any>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "proto/common.pb.h"
+#include "proto/store.pb.h"
+#include "store/region_export.h"
+
+namespace dingodb {
+
+class RegionExportTest : public testing::Test {};
+
+static void AddSchema(google::protobuf::RepeatedPtrField<pb::common::Schema>& schemas, const std::string& name,
+                      pb::common::Schema::Type type) {
+  auto* schema = schemas.Add();
+  schema->set_name(name);
+  schema->set_type(type);
+  schema->set_index(schemas.size() - 1);
+  schema->set_is_nullable(true);
+}
+
+TEST_F(RegionExportTest, InitBatch) {
+  google::protobuf::RepeatedPtrField<pb::common::Schema> schemas;
+  AddSchema(schemas, "id", pb::common::Schema::LONG);
+  AddSchema(schemas, "name", pb::common::Schema::STRING);
+
+  pb::store::ExportBatch batch;
+  auto status = RegionExport::InitBatch(schemas, batch);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  ASSERT_EQ(batch.columns_size(), 2);
+  EXPECT_EQ(batch.columns(0).name(), "id");
+  EXPECT_EQ(batch.columns(1).type(), pb::common::Schema::STRING);
+  EXPECT_EQ(batch.row_count(), 0);
+
+  AddSchema(schemas, "tags", pb::common::Schema::STRINGLIST);
+  status = RegionExport::InitBatch(schemas, batch);
+  EXPECT_EQ(status.error_code(), pb::error::ENOT_SUPPORT);
+}
+
+TEST_F(RegionExportTest, AppendRecord) {
+  google::protobuf::RepeatedPtrField<pb::common::Schema> schemas;
+  AddSchema(schemas, "flag", pb::common::Schema::BOOL);
+  AddSchema(schemas, "age", pb::common::Schema::INTEGER);
+  AddSchema(schemas, "score", pb::common::Schema::DOUBLE);
+  AddSchema(schemas, "name", pb::common::Schema::STRING);
+
+  pb::store::ExportBatch batch;
+  ASSERT_TRUE(RegionExport::InitBatch(schemas, batch).ok());
+
+  std::vector<std::any> record1{std::optional<bool>(true), std::optional<int32_t>(18), std::optional<double>(1.5),
+                                std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>("a"))};
+  ASSERT_TRUE(RegionExport::AppendRecord(record1, batch).ok());
+
+  std::vector<std::any> record2{std::optional<bool>(std::nullopt), std::optional<int32_t>(20),
+                                std::optional<double>(std::nullopt),
+                                std::optional<std::shared_ptr<std::string>>(std::nullopt)};
+  ASSERT_TRUE(RegionExport::AppendRecord(record2, batch).ok());
+
+  EXPECT_EQ(batch.row_count(), 2);
+  const auto& flag = batch.columns(0);
+  ASSERT_EQ(flag.is_null_size(), 2);
+  EXPECT_FALSE(flag.is_null(0));
+  EXPECT_TRUE(flag.is_null(1));
+  ASSERT_EQ(flag.long_values_size(), 1);
+  EXPECT_EQ(flag.long_values(0), 1);
+
+  const auto& age = batch.columns(1);
+  ASSERT_EQ(age.long_values_size(), 2);
+  EXPECT_EQ(age.long_values(1), 20);
+
+  const auto& score = batch.columns(2);
+  ASSERT_EQ(score.double_values_size(), 1);
+  EXPECT_DOUBLE_EQ(score.double_values(0), 1.5);
+
+  const auto& name = batch.columns(3);
+  ASSERT_EQ(name.string_values_size(), 1);
+  EXPECT_EQ(name.string_values(0), "a");
+  EXPECT_TRUE(name.is_null(1));
+
+  // type not match
+  std::vector<std::any> record3{std::optional<int64_t>(1), std::optional<int32_t>(20), std::optional<double>(1.0),
+                                std::optional<std::shared_ptr<std::string>>(std::nullopt)};
+  EXPECT_FALSE(RegionExport::AppendRecord(record3, batch).ok());
+}
+
+}  // namespace dingodb
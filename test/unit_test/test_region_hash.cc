@@ -0,0 +1,82 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "proto/common.pb.h"
+#include "store/region_hash.h"
+
+namespace dingodb {
+
+class RegionHashTest : public testing::Test {};
+
+static pb::common::Range GenRange(const std::string& start_key, const std::string& end_key) {
+  pb::common::Range range;
+  range.set_start_key(start_key);
+  range.set_end_key(end_key);
+  return range;
+}
+
+TEST_F(RegionHashTest, BucketIndex) {
+  std::vector<std::string> bucket_keys = {"c", "f", "k"};
+
+  EXPECT_EQ(0, RegionHashManager::BucketIndex(bucket_keys, "a"));
+  EXPECT_EQ(0, RegionHashManager::BucketIndex(bucket_keys, "bzz"));
+  EXPECT_EQ(1, RegionHashManager::BucketIndex(bucket_keys, "c"));
+  EXPECT_EQ(2, RegionHashManager::BucketIndex(bucket_keys, "f"));
+  EXPECT_EQ(3, RegionHashManager::BucketIndex(bucket_keys, "k"));
+  EXPECT_EQ(3, RegionHashManager::BucketIndex(bucket_keys, "y"));
+
+  EXPECT_EQ(0, RegionHashManager::BucketIndex({}, "y"));
+}
+
+TEST_F(RegionHashTest, BucketRanges) {
+  auto ranges = RegionHashManager::BucketRanges(GenRange("a", "z"), {"c", "f"});
+  ASSERT_EQ(3, ranges.size());
+  EXPECT_EQ("a", ranges[0].start_key());
+  EXPECT_EQ("c", ranges[0].end_key());
+  EXPECT_EQ("c", ranges[1].start_key());
+  EXPECT_EQ("f", ranges[1].end_key());
+  EXPECT_EQ("f", ranges[2].start_key());
+  EXPECT_EQ("z", ranges[2].end_key());
+
+  ranges = RegionHashManager::BucketRanges(GenRange("a", "z"), {});
+  ASSERT_EQ(1, ranges.size());
+  EXPECT_EQ("a", ranges[0].start_key());
+  EXPECT_EQ("z", ranges[0].end_key());
+}
+
+TEST_F(RegionHashTest, CompareCheckpoint) {
+  RegionHashManager::HashCheckpoint local;
+  local.log_id = 100;
+  local.range = GenRange("a", "z");
+  local.bucket_keys = {"c", "f"};
+  local.hashes = {1, 2, 3};
+
+  auto remote = local;
+  EXPECT_TRUE(RegionHashManager::CompareCheckpoint(local, remote).empty());
+
+  remote.hashes[1] = 20;
+  EXPECT_EQ(std::vector<size_t>({1}), RegionHashManager::CompareCheckpoint(local, remote));
+
+  // Different buckets are not comparable.
+  remote = local;
+  remote.bucket_keys = {"c", "g"};
+  EXPECT_EQ(std::vector<size_t>({0, 1, 2}), RegionHashManager::CompareCheckpoint(local, remote));
+}
+
+}  // namespace dingodb
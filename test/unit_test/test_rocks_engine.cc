@@ -34,6 +34,7 @@
 #include "config/config.h"
 #include "config/yaml_config.h"
 #include "engine/rocks_raw_engine.h"
+#include "fmt/core.h"
 #include "proto/common.pb.h"
 
 namespace dingodb {  // NOLINT
@@ -583,48 +584,72 @@ TEST_F(RawRocksEngineTest, KvGet) {
   }
 }
 
-#ifdef TEST_KV_BATCH_GET_SWITCH
 TEST_F(RawRocksEngineTest, KvBatchGet) {
   const std::string &cf_name = kDefaultCf;
+  auto writer = RawRocksEngineTest::engine->Writer();
   auto reader = RawRocksEngineTest::engine->Reader();
 
-  // key all empty
+  {
+    std::vector<pb::common::KeyValue> kvs;
+    for (int i = 0; i < 10; ++i) {
+      pb::common::KeyValue kv;
+      kv.set_key(fmt::format("batch_get_key{}", i));
+      kv.set_value(fmt::format("batch_get_value{}", i));
+      kvs.push_back(kv);
+    }
+
+    butil::Status ok = writer->KvBatchPutAndDelete(cf_name, kvs, {});
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  }
+
+  // keys empty
   {
     std::vector<std::string> keys;
     std::vector<pb::common::KeyValue> kvs;
 
     butil::Status ok = reader->KvBatchGet(cf_name, keys, kvs);
-    EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_EMPTY);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    EXPECT_TRUE(kvs.empty());
   }
 
   // key some empty
   {
-    std::vector<std::string> keys{"key1", "", "key"};
+    std::vector<std::string> keys{"batch_get_key1", "", "batch_get_key2"};
     std::vector<pb::common::KeyValue> kvs;
 
     butil::Status ok = reader->KvBatchGet(cf_name, keys, kvs);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_EMPTY);
   }
 
-  // some key not exist
+  // some key not exist, unsorted keys
   {
-    std::vector<std::string> keys{"key1", "key2", "key", "key4"};
+    std::vector<std::string> keys{"batch_get_key7", "batch_get_not_exist", "batch_get_key3", "batch_get_key5"};
     std::vector<pb::common::KeyValue> kvs;
 
     butil::Status ok = reader->KvBatchGet(cf_name, keys, kvs);
-    EXPECT_EQ(ok.error_code(), pb::error::Errno::EINTERNAL);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    ASSERT_EQ(3, kvs.size());
+    EXPECT_EQ("batch_get_key7", kvs[0].key());
+    EXPECT_EQ("batch_get_value7", kvs[0].value());
+    EXPECT_EQ("batch_get_key3", kvs[1].key());
+    EXPECT_EQ("batch_get_value3", kvs[1].value());
+    EXPECT_EQ("batch_get_key5", kvs[2].key());
+    EXPECT_EQ("batch_get_value5", kvs[2].value());
   }
 
-  // normal
+  // with snapshot
   {
-    std::vector<std::string> keys{"key1", "key"};
+    auto snapshot = RawRocksEngineTest::engine->GetSnapshot();
+    std::vector<std::string> keys{"batch_get_key9", "batch_get_key0"};
     std::vector<pb::common::KeyValue> kvs;
 
-    butil::Status ok = reader->KvBatchGet(cf_name, keys, kvs);
+    butil::Status ok = reader->KvBatchGet(cf_name, snapshot, keys, kvs);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    ASSERT_EQ(2, kvs.size());
+    EXPECT_EQ("batch_get_value9", kvs[0].value());
+    EXPECT_EQ("batch_get_value0", kvs[1].value());
   }
 }
-#endif
 
 TEST_F(RawRocksEngineTest, KvScan) {
   const std::string &cf_name = kDefaultCf;
@@ -105,6 +105,68 @@ TEST(DingoSafeMapTest, DingoSafeMapCopy) {
   EXPECT_EQ(map3.size(), 3);
 }
 
+TEST(DingoSafeMapTest, DingoShardedSafeMap) {
+  dingodb::DingoShardedSafeMap<int64_t, int64_t, 8> safe_map;
+  safe_map.Init(1000);
+
+  std::vector<int64_t> key_list;
+  std::vector<int64_t> value_list;
+  for (int64_t i = 1; i <= 100; ++i) {
+    key_list.push_back(i);
+    value_list.push_back(i * 10);
+  }
+  EXPECT_EQ(safe_map.MultiPut(key_list, value_list), 1);
+  EXPECT_EQ(safe_map.Size(), 100);
+  EXPECT_EQ(safe_map.Get(50), 500);
+
+  EXPECT_EQ(safe_map.PutIfAbsent(50, 1), -1);
+  EXPECT_EQ(safe_map.PutIfExists(50, 1), 1);
+  EXPECT_EQ(safe_map.Get(50), 1);
+
+  std::vector<int64_t> values;
+  std::vector<bool> exists;
+  safe_map.MultiGet({1, 101}, values, exists);
+  ASSERT_EQ(values.size(), 2);
+  EXPECT_EQ(values[0], 10);
+  EXPECT_TRUE(exists[0]);
+  EXPECT_FALSE(exists[1]);
+
+  std::vector<int64_t> big_values;
+  EXPECT_EQ(safe_map.GetAllValues(big_values, [](int64_t value) { return value > 500; }), 50);
+
+  EXPECT_EQ(safe_map.MultiErase({1, 2, 3}), 1);
+  EXPECT_EQ(safe_map.Size(), 97);
+  EXPECT_FALSE(safe_map.Exists(1));
+
+  butil::FlatMap<int64_t, int64_t> map2;
+  map2.init(100);
+  map2.insert(1, 1);
+  map2.insert(2, 2);
+  EXPECT_EQ(safe_map.CopyFromRawMap(map2), 1);
+  EXPECT_EQ(safe_map.Size(), 2);
+
+  butil::FlatMap<int64_t, int64_t> map3;
+  map3.init(100);
+  safe_map.GetRawMapCopy(map3);
+  EXPECT_EQ(map3.size(), 2);
+
+  // concurrent read and write of different keys
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&safe_map, t]() {
+      for (int64_t i = 0; i < 1000; ++i) {
+        int64_t key = t * 10000 + i;
+        safe_map.Put(key, key);
+        EXPECT_EQ(safe_map.Get(key), key);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(safe_map.Size(), 4000);
+}
+
 TEST(DingoSafeStdMapTest, DingoSafeStdMapGetRangeValues) {
   dingodb::DingoSafeStdMap<std::string, std::string> safe_map;
 
@@ -315,6 +377,13 @@ TEST(DingoSafeStdMapTest, DingoSafeStdMapFindIntervalValues) {
 
   EXPECT_EQ(ret, 3);
 
+  values.clear();
+  start_key = "wa1";
+  end_key = "wb2";
+  ret = safe_map.FindIntervalValues(values, start_key, end_key, nullptr, nullptr, 2);
+
+  EXPECT_EQ(ret, 2);
+
   values.clear();
   start_key = "wd";
   end_key = "wd0";
@@ -18,6 +18,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
@@ -36,12 +38,16 @@
 #include "config/yaml_config.h"
 #include "crontab/crontab.h"
 #include "engine/rocks_raw_engine.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "scan/scan.h"
 #include "scan/scan_manager.h"
 
 namespace dingodb {
 
+DECLARE_bool(enable_scan_prefetch);
+
 static const std::string &kDefaultCf = "default";  // NOLINT
 
 static const std::vector<std::string> kAllCFs = {kDefaultCf};
@@ -950,4 +956,58 @@ TEST_F(ScanV2Test, KvDeleteRange) {
   }
 }
 
+TEST_F(ScanV2Test, ScanPrefetch) {
+  auto raw_rocks_engine = this->GetRawRocksEngine();
+  int64_t scan_id = 2;
+  auto scan = ScanManagerV2::GetInstance().CreateScan(scan_id);
+  ASSERT_NE(scan.get(), nullptr);
+
+  butil::Status ok = scan->Open(std::to_string(scan_id), raw_rocks_engine, kDefaultCf);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+  auto writer = raw_rocks_engine->Writer();
+  for (int i = 0; i < 11; i++) {
+    dingodb::pb::common::KeyValue kv;
+    kv.set_key(fmt::format("prefetch_key{:02}", i));
+    kv.set_value("value");
+    ok = writer->KvPut(kDefaultCf, kv);
+    EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+  }
+
+  FLAGS_enable_scan_prefetch = true;
+
+  pb::common::Range range;
+  range.set_start_key("prefetch_key");
+  range.set_end_key("prefetch_kez");
+  std::vector<pb::common::KeyValue> kvs;
+  ok = ScanHandler::ScanBegin(scan, 1, range, 2, true, true, true, {}, &kvs);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+  // the prefetched batches are returned in order, no kv is lost or repeated.
+  std::vector<std::string> keys;
+  for (const auto &kv : kvs) {
+    keys.push_back(kv.key());
+  }
+  bool has_more = true;
+  while (has_more) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    kvs.clear();
+    ok = ScanHandler::ScanContinue(scan, std::to_string(scan_id), 2, &kvs, has_more);
+    EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+    for (const auto &kv : kvs) {
+      keys.push_back(kv.key());
+    }
+  }
+
+  FLAGS_enable_scan_prefetch = false;
+
+  EXPECT_EQ(keys.size(), 11);
+  EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+  EXPECT_EQ(std::adjacent_find(keys.begin(), keys.end()), keys.end());
+
+  ok = ScanHandler::ScanRelease(scan, std::to_string(scan_id));
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+  ScanManagerV2::GetInstance().DeleteScan(scan_id);
+}
+
 }  // namespace dingodb
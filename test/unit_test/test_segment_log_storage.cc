@@ -18,12 +18,19 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <vector>
 
 #include "braft/log_entry.h"
 #include "common/helper.h"
+#include "gflags/gflags.h"
 #include "log/segment_log_storage.h"
 #include "proto/raft.pb.h"
 
+namespace dingodb {
+DECLARE_bool(dingo_raft_log_group_commit);
+DECLARE_bool(dingo_raft_log_mmap_closed_segment);
+}  // namespace dingodb
+
 const std::string kRootPath = "./unit_test";
 const std::string kLogPath = kRootPath + "/segment_log";
 
@@ -122,4 +129,115 @@ TEST_F(SegmentLogStorageTest, GetEntrys) {
   auto log_entrys = log_stroage->GetEntrys(begin_index, end_index);
 
   EXPECT_EQ(end_index - begin_index + 1, log_entrys.size());
-}
\ No newline at end of file
+}
+TEST_F(SegmentLogStorageTest, AppendEntriesWithGroupCommit) {
+  dingodb::FLAGS_dingo_raft_log_group_commit = true;
+
+  int64_t begin_log_index = log_stroage->LastLogIndex() + 1;
+
+  const int k_log_entry_count = 50;
+  std::vector<braft::LogEntry*> log_entries;
+  for (int i = 0; i < k_log_entry_count; ++i) {
+    log_entries.push_back(GenLogEntry());
+  }
+
+  EXPECT_EQ(k_log_entry_count, log_stroage->AppendEntries(log_entries, nullptr));
+  EXPECT_EQ(begin_log_index + k_log_entry_count, log_stroage->LastLogIndex() + 1);
+
+  for (int i = 0; i < k_log_entry_count; ++i) {
+    auto* log_entry = log_stroage->GetEntry(begin_log_index + i);
+    ASSERT_TRUE(log_entry != nullptr);
+    EXPECT_EQ(log_entries[i]->data.to_string(), log_entry->data.to_string());
+    log_entry->Release();
+  }
+
+  for (auto* log_entry : log_entries) {
+    log_entry->Release();
+  }
+
+  dingodb::FLAGS_dingo_raft_log_group_commit = false;
+}
+
+TEST_F(SegmentLogStorageTest, ReadClosedSegmentWithMmap) {
+  dingodb::FLAGS_dingo_raft_log_mmap_closed_segment = true;
+
+  const std::string log_path = kRootPath + "/segment_log_mmap";
+  dingodb::Helper::CreateDirectories(log_path);
+
+  // small segment size to produce closed segments
+  auto log_storage = std::make_shared<dingodb::SegmentLogStorage>(log_path, 101, 64 * 1024, INT64_MAX);
+  braft::ConfigurationManager configuration_manager;
+  ASSERT_EQ(0, log_storage->Init(&configuration_manager));
+
+  const int k_log_entry_count = 50;
+  std::vector<braft::LogEntry*> log_entries;
+  for (int i = 0; i < k_log_entry_count; ++i) {
+    auto* log_entry = GenLogEntry();
+    log_entry->id.index = i + 1;
+    log_entries.push_back(log_entry);
+    ASSERT_EQ(0, log_storage->AppendEntry(log_entry));
+  }
+  EXPECT_LT(1, log_storage->Segments().size());
+
+  // closed segments are mapped when they are closed
+  for (int i = 0; i < k_log_entry_count; ++i) {
+    auto* log_entry = log_storage->GetEntry(i + 1);
+    ASSERT_TRUE(log_entry != nullptr);
+    EXPECT_EQ(log_entries[i]->data.to_string(), log_entry->data.to_string());
+    log_entry->Release();
+  }
+
+  // closed segments are mapped when they are loaded
+  {
+    auto reload_log_storage = std::make_shared<dingodb::SegmentLogStorage>(log_path, 101, 64 * 1024, INT64_MAX);
+    braft::ConfigurationManager reload_configuration_manager;
+    ASSERT_EQ(0, reload_log_storage->Init(&reload_configuration_manager));
+    EXPECT_EQ(k_log_entry_count, reload_log_storage->LastLogIndex());
+    for (int i = 0; i < k_log_entry_count; ++i) {
+      auto* log_entry = reload_log_storage->GetEntry(i + 1);
+      ASSERT_TRUE(log_entry != nullptr);
+      EXPECT_EQ(log_entries[i]->data.to_string(), log_entry->data.to_string());
+      log_entry->Release();
+    }
+  }
+
+  for (auto* log_entry : log_entries) {
+    log_entry->Release();
+  }
+
+  dingodb::FLAGS_dingo_raft_log_mmap_closed_segment = false;
+}
+
+TEST_F(SegmentLogStorageTest, LazyLoadSegmentBeforeFirstLogIndex) {
+  const std::string log_path = kRootPath + "/segment_log_lazy";
+  dingodb::Helper::CreateDirectories(log_path);
+
+  // keep the log before first log index for vector index
+  auto log_storage = std::make_shared<dingodb::SegmentLogStorage>(log_path, 102, 64 * 1024, 0);
+  braft::ConfigurationManager configuration_manager;
+  ASSERT_EQ(0, log_storage->Init(&configuration_manager));
+
+  const int k_log_entry_count = 50;
+  for (int i = 0; i < k_log_entry_count; ++i) {
+    auto* log_entry = GenLogEntry();
+    log_entry->id.index = i + 1;
+    ASSERT_EQ(0, log_storage->AppendEntry(log_entry));
+    log_entry->Release();
+  }
+  ASSERT_EQ(0, log_storage->TruncatePrefix(40));
+
+  auto reload_log_storage = std::make_shared<dingodb::SegmentLogStorage>(log_path, 102, 64 * 1024, 0);
+  braft::ConfigurationManager reload_configuration_manager;
+  ASSERT_EQ(0, reload_log_storage->Init(&reload_configuration_manager));
+  EXPECT_EQ(40, reload_log_storage->FirstLogIndex());
+  EXPECT_EQ(k_log_entry_count, reload_log_storage->LastLogIndex());
+
+  auto segments = reload_log_storage->Segments();
+  ASSERT_FALSE(segments.empty());
+  EXPECT_FALSE(segments.begin()->second->IsLoaded());
+
+  // the segments before first log index are loaded on access
+  auto log_entrys = reload_log_storage->GetEntrys(1, k_log_entry_count);
+  EXPECT_EQ(k_log_entry_count, log_entrys.size());
+  EXPECT_TRUE(segments.begin()->second->IsLoaded());
+}
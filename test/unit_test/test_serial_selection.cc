@@ -17,6 +17,7 @@
 #include <proto/meta.pb.h>
 #include <serial/record_decoder.h>
 #include <serial/record_encoder.h>
+#include <serial/record_view_decoder.h>
 #include <serial/utils.h>
 
 #include <memory>
@@ -233,6 +234,110 @@ TEST_F(DingoSerialTest, keyvaluecodeStringLoopTest) {
   }
 }
 
+TEST_F(DingoSerialTest, recordViewDecoder) {
+  InitVector();
+  InitRecord();
+  auto schemas = GetSchemas();
+  auto* record = GetRecord();
+
+  RecordEncoder re(0, schemas, 100L, this->le);
+  pb::common::KeyValue kv;
+  ASSERT_EQ(0, re.Encode(*record, kv));
+
+  // score is a key column after string key columns, which are skipped.
+  std::vector<int> column_indexes = {10, 3, 4, 6, 7, 8, 0, 5};
+  RecordViewDecoder view_decoder(0, schemas, 100L, this->le);
+  ASSERT_TRUE(view_decoder.Compile(column_indexes));
+
+  RecordViewDecoder::Row row;
+  ASSERT_EQ(0, view_decoder.Decode(kv.key(), kv.value(), row));
+  ASSERT_EQ(column_indexes.size(), row.size());
+  EXPECT_DOUBLE_EQ(873485.4234, row[0].double_value);
+  EXPECT_EQ(214748364700L, row[1].long_value);
+  EXPECT_FALSE(row[2].string_value.empty());
+  EXPECT_TRUE(row[3].is_null);
+  EXPECT_TRUE(row[4].is_null);
+  EXPECT_EQ(-20, row[5].int_value);
+  EXPECT_EQ(0, row[6].int_value);
+  EXPECT_FALSE(row[7].is_null);
+  EXPECT_FALSE(row[7].bool_value);
+
+  // same result as RecordDecoder
+  RecordDecoder rd(0, schemas, 100L, this->le);
+  std::vector<std::any> expect_record;
+  ASSERT_EQ(0, rd.Decode(kv, column_indexes, expect_record));
+  std::vector<std::any> view_record;
+  RecordViewDecoder::ToRecord(row, view_record);
+  ASSERT_EQ(expect_record.size(), view_record.size());
+  for (size_t i = 0; i < expect_record.size(); ++i) {
+    EXPECT_EQ(expect_record[i].type(), view_record[i].type());
+  }
+  EXPECT_EQ(*any_cast<optional<shared_ptr<string>>>(expect_record[2]).value(),
+            *any_cast<optional<shared_ptr<string>>>(view_record[2]).value());
+
+  // string key column can not be decoded by view.
+  EXPECT_FALSE(view_decoder.Compile({1}));
+
+  // wrong common id
+  RecordViewDecoder other_decoder(0, schemas, 101L, this->le);
+  ASSERT_TRUE(other_decoder.Compile(column_indexes));
+  EXPECT_EQ(-1, other_decoder.Decode(kv.key(), kv.value(), row));
+
+  DeleteRecords();
+  DeleteSchemas();
+}
+
+TEST_F(DingoSerialTest, valueOffsetTable) {
+  InitVector();
+  InitRecord();
+  auto schemas = GetSchemas();
+  auto* record = GetRecord();
+
+  RecordEncoder re(1, schemas, 100L, this->le);
+  pb::common::KeyValue kv;
+  ASSERT_EQ(0, re.Encode(*record, kv));
+  re.SetValueOffsetTable(true);
+  pb::common::KeyValue kv_with_table;
+  ASSERT_EQ(0, re.Encode(*record, kv_with_table));
+  EXPECT_EQ(kv.key(), kv_with_table.key());
+  // count and 7 value column offsets
+  EXPECT_EQ(kv.value().size() + 4 + 7 * 4, kv_with_table.value().size());
+
+  RecordDecoder rd(1, schemas, 100L, this->le);
+  std::vector<int> column_indexes = {10, 8, 4, 3};
+  std::vector<std::any> expect_record;
+  ASSERT_EQ(0, rd.Decode(kv, column_indexes, expect_record));
+  std::vector<std::any> table_record;
+  ASSERT_EQ(0, rd.Decode(kv_with_table, column_indexes, table_record));
+  EXPECT_DOUBLE_EQ(any_cast<optional<double>>(expect_record[0]).value(),
+                   any_cast<optional<double>>(table_record[0]).value());
+  EXPECT_EQ(any_cast<optional<int32_t>>(expect_record[1]).value(),
+            any_cast<optional<int32_t>>(table_record[1]).value());
+  EXPECT_EQ(*any_cast<optional<shared_ptr<string>>>(expect_record[2]).value(),
+            *any_cast<optional<shared_ptr<string>>>(table_record[2]).value());
+  EXPECT_EQ(any_cast<optional<int64_t>>(expect_record[3]).value(),
+            any_cast<optional<int64_t>>(table_record[3]).value());
+
+  // sequential decoding skip the offset table
+  std::vector<std::any> all_record;
+  ASSERT_EQ(0, rd.Decode(kv_with_table, all_record));
+  EXPECT_EQ(-20, any_cast<optional<int32_t>>(all_record[8]).value());
+
+  RecordViewDecoder view_decoder(1, schemas, 100L, this->le);
+  ASSERT_TRUE(view_decoder.Compile(column_indexes));
+  RecordViewDecoder::Row row;
+  ASSERT_EQ(0, view_decoder.Decode(kv_with_table.key(), kv_with_table.value(), row));
+  EXPECT_EQ(-20, row[1].int_value);
+  EXPECT_EQ(*any_cast<optional<shared_ptr<string>>>(expect_record[2]).value(), std::string(row[2].string_value));
+
+  // reader of lower schema version can not read it.
+  RecordDecoder old_rd(0, schemas, 100L, this->le);
+  EXPECT_EQ(-1, old_rd.Decode(kv_with_table, column_indexes, table_record));
+
+  DeleteRecords();
+  DeleteSchemas();
+}
+
 // TEST_F(DingoSerialTest, keyvaluecodeDoubleLoopTest) {
 //   auto td = std::make_shared<pb::meta::TableDefinition>();
 //   td->set_name("test");
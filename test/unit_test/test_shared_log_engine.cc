@@ -0,0 +1,121 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "braft/log_entry.h"
+#include "common/helper.h"
+#include "fmt/core.h"
+#include "log/shared_log_engine.h"
+
+static const std::string kSharedLogPath = "./unit_test/shared_log";
+
+class SharedLogEngineTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    dingodb::Helper::RemoveAllFileOrDirectory(kSharedLogPath);
+    dingodb::Helper::CreateDirectories(kSharedLogPath);
+  }
+  void TearDown() override { dingodb::Helper::RemoveAllFileOrDirectory(kSharedLogPath); }
+
+  static std::vector<braft::LogEntry*> GenLogEntries(int64_t region_id, int64_t start_index, int64_t count,
+                                                     int64_t term) {
+    std::vector<braft::LogEntry*> entries;
+    for (int64_t i = 0; i < count; ++i) {
+      auto* entry = new braft::LogEntry();
+      entry->AddRef();
+      entry->type = braft::ENTRY_TYPE_DATA;
+      entry->id.term = term;
+      entry->id.index = start_index + i;
+      entry->data.append(fmt::format("region_{}_index_{}_term_{}", region_id, entry->id.index, term));
+      entries.push_back(entry);
+    }
+    return entries;
+  }
+
+  static void ReleaseLogEntries(std::vector<braft::LogEntry*>& entries) {
+    for (auto* entry : entries) {
+      entry->Release();
+    }
+    entries.clear();
+  }
+
+  static void CheckEntry(dingodb::SharedLogEngine& engine, int64_t region_id, int64_t index, int64_t term) {
+    auto* entry = engine.Get(region_id, index);
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(term, entry->id.term);
+    EXPECT_EQ(fmt::format("region_{}_index_{}_term_{}", region_id, index, term), entry->data.to_string());
+    entry->Release();
+  }
+};
+
+TEST_F(SharedLogEngineTest, AppendAndRecover) {
+  {
+    dingodb::SharedLogEngine engine(kSharedLogPath);
+    ASSERT_EQ(0, engine.Init());
+
+    // interleave entries of two regions
+    for (int64_t i = 0; i < 10; ++i) {
+      auto entries1 = GenLogEntries(1, i * 10 + 1, 10, 1);
+      ASSERT_EQ(0, engine.Append(1, entries1.data(), entries1.size(), true));
+      ReleaseLogEntries(entries1);
+
+      auto entries2 = GenLogEntries(2, i * 5 + 1, 5, 1);
+      ASSERT_EQ(0, engine.Append(2, entries2.data(), entries2.size(), true));
+      ReleaseLogEntries(entries2);
+    }
+
+    // overwrite the tail of region 2 by a new term
+    ASSERT_EQ(0, engine.TruncateSuffix(2, 40));
+    auto entries = GenLogEntries(2, 41, 5, 2);
+    ASSERT_EQ(0, engine.Append(2, entries.data(), entries.size(), true));
+    ReleaseLogEntries(entries);
+
+    int64_t first_log_index = 0;
+    int64_t last_log_index = 0;
+    ASSERT_TRUE(engine.GetRegionLogIndex(2, first_log_index, last_log_index));
+    EXPECT_EQ(1, first_log_index);
+    EXPECT_EQ(45, last_log_index);
+    EXPECT_EQ(2, engine.GetTerm(2, 41));
+    EXPECT_EQ(0, engine.GetTerm(2, 46));
+
+    ASSERT_EQ(0, engine.TruncatePrefix(1, 50));
+    EXPECT_EQ(nullptr, engine.Get(1, 49));
+  }
+
+  dingodb::SharedLogEngine engine(kSharedLogPath);
+  ASSERT_EQ(0, engine.Init());
+
+  int64_t first_log_index = 0;
+  int64_t last_log_index = 0;
+  ASSERT_TRUE(engine.GetRegionLogIndex(1, first_log_index, last_log_index));
+  EXPECT_EQ(1, first_log_index);
+  EXPECT_EQ(100, last_log_index);
+  CheckEntry(engine, 1, 1, 1);
+  CheckEntry(engine, 1, 100, 1);
+
+  ASSERT_TRUE(engine.GetRegionLogIndex(2, first_log_index, last_log_index));
+  EXPECT_EQ(1, first_log_index);
+  EXPECT_EQ(45, last_log_index);
+  CheckEntry(engine, 2, 40, 1);
+  CheckEntry(engine, 2, 41, 2);
+
+  ASSERT_EQ(0, engine.RemoveRegion(2));
+  EXPECT_FALSE(engine.GetRegionLogIndex(2, first_log_index, last_log_index));
+}
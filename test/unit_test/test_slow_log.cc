@@ -0,0 +1,73 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "common/slow_log.h"
+#include "gflags/gflags.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+DECLARE_int64(slow_log_threshold_ms);
+DECLARE_int32(slow_log_capacity);
+
+class SlowLogTest : public testing::Test {};
+
+TEST_F(SlowLogTest, Record) {
+  FLAGS_slow_log_threshold_ms = 100;
+  FLAGS_slow_log_capacity = 2;
+  ASSERT_TRUE(SlowLog::GetInstance().SetMethodThresholds("KvBatchGet:10"));
+  ASSERT_FALSE(SlowLog::GetInstance().SetMethodThresholds("KvBatchGet:abc"));
+
+  pb::store::KvGetRequest get_request;
+  get_request.mutable_context()->set_region_id(1001);
+  get_request.set_key("key1");
+
+  // not slow
+  SlowLog::GetInstance().Record("KvGet", 50 * 1000 * 1000, get_request, 0, nullptr);
+  EXPECT_TRUE(SlowLog::GetInstance().GetSlowRequests("KvGet", 0, 0).empty());
+
+  SlowLog::GetInstance().Record("KvGet", 150 * 1000 * 1000, get_request, 0, nullptr);
+  auto slow_requests = SlowLog::GetInstance().GetSlowRequests("KvGet", 0, 0);
+  ASSERT_EQ(1, slow_requests.size());
+  EXPECT_EQ(1001, slow_requests[0].region_id());
+  EXPECT_EQ("key1", slow_requests[0].start_key());
+  EXPECT_EQ(150 * 1000, slow_requests[0].elapsed_us());
+
+  // method threshold
+  pb::store::KvBatchGetRequest batch_get_request;
+  batch_get_request.add_keys("key2");
+  batch_get_request.add_keys("key3");
+  SlowLog::GetInstance().Record("KvBatchGet", 20 * 1000 * 1000, batch_get_request, 0, nullptr);
+  SlowLog::GetInstance().Record("KvBatchGet", 30 * 1000 * 1000, batch_get_request, 0, nullptr);
+
+  // ring buffer only keep the newest, newest first.
+  slow_requests = SlowLog::GetInstance().GetSlowRequests("", 0, 0);
+  ASSERT_EQ(2, slow_requests.size());
+  EXPECT_EQ(30 * 1000, slow_requests[0].elapsed_us());
+  EXPECT_EQ("key2", slow_requests[0].start_key());
+  EXPECT_EQ("key3", slow_requests[0].end_key());
+  EXPECT_EQ(2, slow_requests[0].key_count());
+  EXPECT_EQ(20 * 1000, slow_requests[1].elapsed_us());
+
+  EXPECT_EQ(1, SlowLog::GetInstance().GetSlowRequests("", 25 * 1000, 0).size());
+
+  ASSERT_TRUE(SlowLog::GetInstance().SetMethodThresholds(""));
+}
+
+}  // namespace dingodb
@@ -290,4 +290,17 @@ TEST_F(SplitCheckerTest, KeysSplitKeys) {  // NOLINT
   writer->KvDeleteRange(kAllCFs, range);
 }
 
+TEST_F(SplitCheckerTest, IndexSplitChecker) {  // NOLINT
+  auto split_checker = std::make_shared<IndexSplitChecker>();
+  EXPECT_EQ("INDEX", split_checker->GetPolicyName());
+
+  // store region without vector index never split by index.
+  std::vector<std::string> raft_addrs;
+  auto region = BuildRegion(1001, "unit_test", raft_addrs, "aa", "zz");
+  EXPECT_FALSE(IndexSplitChecker::IsExceedsLimit(region));
+
+  uint32_t count = 0;
+  EXPECT_TRUE(split_checker->SplitKey(region, region->Range(), kAllCFs, count).empty());
+}
+
 }  // namespace dingodb
\ No newline at end of file
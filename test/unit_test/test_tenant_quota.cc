@@ -0,0 +1,88 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+
+#include "common/tenant_quota.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DECLARE_string(tenant_quota_spec);
+DECLARE_int64(tenant_quota_default_qps);
+DECLARE_int64(tenant_quota_default_bytes);
+
+class TenantQuotaTest : public testing::Test {
+ protected:
+  void TearDown() override {
+    FLAGS_tenant_quota_spec = "";
+    FLAGS_tenant_quota_default_qps = 0;
+    FLAGS_tenant_quota_default_bytes = 0;
+  }
+};
+
+TEST_F(TenantQuotaTest, ParseSpec) {
+  std::map<int64_t, TenantQuota::Quota> quotas;
+  EXPECT_TRUE(TenantQuota::ParseSpec("", quotas));
+  EXPECT_TRUE(quotas.empty());
+
+  EXPECT_TRUE(TenantQuota::ParseSpec("1:100:1048576:2;2:10:0", quotas));
+  EXPECT_EQ(2, quotas.size());
+  EXPECT_EQ(100, quotas[1].qps);
+  EXPECT_EQ(1048576, quotas[1].bytes_per_second);
+  EXPECT_EQ(2, quotas[1].priority);
+  EXPECT_EQ(10, quotas[2].qps);
+  EXPECT_EQ(0, quotas[2].priority);
+
+  std::map<int64_t, TenantQuota::Quota> invalid_quotas;
+  EXPECT_FALSE(TenantQuota::ParseSpec("1:100", invalid_quotas));
+  EXPECT_FALSE(TenantQuota::ParseSpec("1:abc:0", invalid_quotas));
+  EXPECT_FALSE(TenantQuota::ParseSpec("1:-1:0", invalid_quotas));
+}
+
+TEST_F(TenantQuotaTest, Acquire) {
+  FLAGS_tenant_quota_spec = "1001:2:0:3";
+  auto& tenant_quota = TenantQuota::GetInstance();
+
+  int32_t priority = 0;
+  EXPECT_TRUE(tenant_quota.Acquire(1001, 100, priority).ok());
+  EXPECT_EQ(3, priority);
+  EXPECT_TRUE(tenant_quota.Acquire(1001, 100, priority).ok());
+
+  auto status = tenant_quota.Acquire(1001, 100, priority);
+  EXPECT_EQ(pb::error::ETENANT_QUOTA_EXCEEDED, status.error_code());
+
+  // other tenants are unlimited by default.
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(tenant_quota.Acquire(1002, 100, priority).ok());
+  }
+  EXPECT_EQ(0, priority);
+}
+
+TEST_F(TenantQuotaTest, AcquireBytes) {
+  FLAGS_tenant_quota_default_bytes = 1000;
+  auto& tenant_quota = TenantQuota::GetInstance();
+
+  int32_t priority = 0;
+  // the request larger than the left bytes is admitted, and the following is rejected.
+  EXPECT_TRUE(tenant_quota.Acquire(2001, 1500, priority).ok());
+  auto status = tenant_quota.Acquire(2001, 10, priority);
+  EXPECT_EQ(pb::error::ETENANT_QUOTA_EXCEEDED, status.error_code());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,80 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "common/helper.h"
+#include "engine/txn_gc_compaction_filter.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+class TxnGcCompactionFilterTest : public testing::Test {
+ protected:
+  static std::string WriteValue(pb::store::Op op, int64_t start_ts, const std::string& short_value = "") {
+    pb::store::WriteInfo write_info;
+    write_info.set_op(op);
+    write_info.set_start_ts(start_ts);
+    write_info.set_short_value(short_value);
+    return write_info.SerializeAsString();
+  }
+
+  static bool Filter(const TxnGcCompactionFilter& filter, const std::string& key, int64_t commit_ts,
+                     const std::string& value) {
+    std::string write_key = Helper::EncodeTxnKey(key, commit_ts);
+    std::string new_value;
+    bool value_changed = false;
+    return filter.Filter(0, write_key, value, &new_value, &value_changed);
+  }
+};
+
+TEST_F(TxnGcCompactionFilterTest, Filter) {
+  TxnGcCompactionFilter filter(100, nullptr, nullptr);
+
+  // ka: newer than safe point is kept, the newest put before safe point is kept, older are removed.
+  EXPECT_FALSE(Filter(filter, "ka", 120, WriteValue(pb::store::Op::Put, 110)));
+  EXPECT_TRUE(Filter(filter, "ka", 95, WriteValue(pb::store::Op::Rollback, 95)));
+  EXPECT_FALSE(Filter(filter, "ka", 90, WriteValue(pb::store::Op::Put, 85)));
+  EXPECT_TRUE(Filter(filter, "ka", 80, WriteValue(pb::store::Op::Put, 75)));
+  EXPECT_TRUE(Filter(filter, "ka", 70, WriteValue(pb::store::Op::Put, 65, "v")));
+
+  // kb: delete before safe point is kept, older are removed.
+  EXPECT_FALSE(Filter(filter, "kb", 90, WriteValue(pb::store::Op::Delete, 85)));
+  EXPECT_TRUE(Filter(filter, "kb", 80, WriteValue(pb::store::Op::Put, 75)));
+
+  // kc: only one put, kept.
+  EXPECT_FALSE(Filter(filter, "kc", 50, WriteValue(pb::store::Op::Put, 45)));
+
+  // data of removed put without short value should be deleted.
+  ASSERT_EQ(2, filter.PendingDataKeys().size());
+  EXPECT_EQ(Helper::EncodeTxnKey(std::string("ka"), 75), filter.PendingDataKeys()[0]);
+  EXPECT_EQ(Helper::EncodeTxnKey(std::string("kb"), 75), filter.PendingDataKeys()[1]);
+
+  // no db, nothing is written.
+  filter.FlushDataKeys();
+}
+
+TEST_F(TxnGcCompactionFilterTest, FactoryWithoutSafePoint) {
+  TxnGcCompactionFilterFactory factory;
+  TxnGcCompactionFilterFactory::SetSafePointTs(0);
+
+  rocksdb::CompactionFilter::Context context;
+  EXPECT_EQ(nullptr, factory.CreateCompactionFilter(context));
+}
+
+}  // namespace dingodb
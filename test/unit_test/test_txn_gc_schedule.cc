@@ -0,0 +1,63 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "engine/txn_engine_helper.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DECLARE_double(txn_gc_garbage_ratio_threshold);
+DECLARE_int64(txn_gc_min_versions);
+DECLARE_int64(txn_gc_max_regions_per_round);
+
+class TxnGcScheduleTest : public testing::Test {};
+
+TEST_F(TxnGcScheduleTest, PickByGarbageRatio) {
+  FLAGS_txn_gc_garbage_ratio_threshold = 0.5;
+  FLAGS_txn_gc_min_versions = 100;
+  FLAGS_txn_gc_max_regions_per_round = 2;
+
+  std::vector<TxnEngineHelper::TxnGcCandidate> candidates;
+  // cold region, no new versions.
+  candidates.push_back({1, 0, 10000});
+  // ratio is low.
+  candidates.push_back({2, 1000, 10000});
+  // too few versions, though ratio is high.
+  candidates.push_back({3, 50, 10});
+  candidates.push_back({4, 6000, 10000});
+  candidates.push_back({5, 20000, 10000});
+  // key count not collected yet.
+  candidates.push_back({6, 200, 0});
+
+  auto region_ids = TxnEngineHelper::PickTxnGcRegionIds(candidates);
+  ASSERT_EQ(2, region_ids.size());
+  EXPECT_EQ(5, region_ids[0]);
+  EXPECT_EQ(4, region_ids[1]);
+
+  FLAGS_txn_gc_max_regions_per_round = 0;
+  region_ids = TxnEngineHelper::PickTxnGcRegionIds(candidates);
+  ASSERT_EQ(3, region_ids.size());
+  EXPECT_EQ(6, region_ids[2]);
+
+  FLAGS_txn_gc_max_regions_per_round = 64;
+  FLAGS_txn_gc_min_versions = 1000;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,76 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "engine/txn_lock_table.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DECLARE_int64(txn_lock_table_max_keys);
+
+class TxnLockTableTest : public testing::Test {};
+
+TEST_F(TxnLockTableTest, PutAndDelete) {
+  TxnLockTable lock_table;
+  std::string lock_key_a = Helper::EncodeTxnKey("ta", Constant::kLockVer);
+  std::string lock_key_b = Helper::EncodeTxnKey("tb", Constant::kLockVer);
+  std::string lock_key_c = Helper::EncodeTxnKey("tc", Constant::kLockVer);
+
+  EXPECT_FALSE(lock_table.MaybeLocked(lock_key_a));
+
+  lock_table.Put(lock_key_a);
+  lock_table.Put(lock_key_b);
+  lock_table.Put(lock_key_b);
+  EXPECT_EQ(2, lock_table.Size());
+  EXPECT_TRUE(lock_table.MaybeLocked(lock_key_a));
+  EXPECT_TRUE(lock_table.MaybeLocked(lock_key_b));
+  EXPECT_FALSE(lock_table.MaybeLocked(lock_key_c));
+
+  lock_table.Delete(lock_key_a);
+  EXPECT_FALSE(lock_table.MaybeLocked(lock_key_a));
+  EXPECT_EQ(1, lock_table.Size());
+
+  lock_table.Put(lock_key_c);
+  lock_table.DeleteRange(Helper::EncodeTxnKey("ta", Constant::kMaxVer), Helper::EncodeTxnKey("tc", 0));
+  EXPECT_FALSE(lock_table.MaybeLocked(lock_key_b));
+  EXPECT_FALSE(lock_table.MaybeLocked(lock_key_c));
+  EXPECT_EQ(0, lock_table.Size());
+}
+
+TEST_F(TxnLockTableTest, Overflow) {
+  int64_t max_keys = FLAGS_txn_lock_table_max_keys;
+  FLAGS_txn_lock_table_max_keys = 2;
+
+  TxnLockTable lock_table;
+  lock_table.Put(Helper::EncodeTxnKey("ta", Constant::kLockVer));
+  lock_table.Put(Helper::EncodeTxnKey("tb", Constant::kLockVer));
+  EXPECT_FALSE(lock_table.IsOverflow());
+  EXPECT_FALSE(lock_table.MaybeLocked(Helper::EncodeTxnKey("tc", Constant::kLockVer)));
+
+  lock_table.Put(Helper::EncodeTxnKey("tc", Constant::kLockVer));
+  EXPECT_TRUE(lock_table.IsOverflow());
+  EXPECT_TRUE(lock_table.MaybeLocked(Helper::EncodeTxnKey("td", Constant::kLockVer)));
+
+  FLAGS_txn_lock_table_max_keys = max_keys;
+}
+
+}  // namespace dingodb
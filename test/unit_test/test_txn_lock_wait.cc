@@ -0,0 +1,95 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "bthread/bthread.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "engine/txn_lock_wait.h"
+
+namespace dingodb {
+
+class TxnLockWaitTest : public testing::Test {};
+
+TEST_F(TxnLockWaitTest, WakeUp) {
+  auto& manager = TxnLockWaitManager::GetInstance();
+  std::string lock_key = Helper::EncodeTxnKey("wa", Constant::kLockVer);
+
+  std::atomic<int> wake_count{0};
+  std::atomic<int> timeout_count{0};
+  auto func = [&](bool is_timeout) { is_timeout ? ++timeout_count : ++wake_count; };
+
+  EXPECT_TRUE(manager.Wait(lock_key, 20, 10, 10000, func));
+  EXPECT_TRUE(manager.Wait(lock_key, 30, 10, 10000, func));
+  EXPECT_EQ(2, manager.WaiterCount());
+
+  manager.WakeUp(Helper::EncodeTxnKey("wb", Constant::kLockVer));
+  EXPECT_EQ(0, wake_count.load());
+
+  manager.WakeUp(lock_key);
+  EXPECT_EQ(2, wake_count.load());
+  EXPECT_EQ(0, timeout_count.load());
+  EXPECT_EQ(0, manager.WaiterCount());
+}
+
+TEST_F(TxnLockWaitTest, Timeout) {
+  auto& manager = TxnLockWaitManager::GetInstance();
+  std::string lock_key = Helper::EncodeTxnKey("wc", Constant::kLockVer);
+
+  std::atomic<int> timeout_count{0};
+  EXPECT_TRUE(manager.Wait(lock_key, 20, 10, 10, [&](bool is_timeout) {
+    EXPECT_TRUE(is_timeout);
+    ++timeout_count;
+  }));
+
+  for (int i = 0; i < 100 && timeout_count.load() == 0; ++i) {
+    bthread_usleep(10 * 1000);
+  }
+  EXPECT_EQ(1, timeout_count.load());
+  EXPECT_EQ(0, manager.WaiterCount());
+
+  // woken up after timeout, do nothing.
+  manager.WakeUp(lock_key);
+  EXPECT_EQ(1, timeout_count.load());
+}
+
+TEST_F(TxnLockWaitTest, Deadlock) {
+  auto& manager = TxnLockWaitManager::GetInstance();
+  std::string lock_key_a = Helper::EncodeTxnKey("wd", Constant::kLockVer);
+  std::string lock_key_b = Helper::EncodeTxnKey("we", Constant::kLockVer);
+  std::string lock_key_c = Helper::EncodeTxnKey("wf", Constant::kLockVer);
+
+  auto func = [](bool) {};
+  // 10 -> 20 -> 30
+  EXPECT_TRUE(manager.Wait(lock_key_b, 10, 20, 10000, func));
+  EXPECT_TRUE(manager.Wait(lock_key_c, 20, 30, 10000, func));
+  // 30 -> 10 is a deadlock
+  EXPECT_FALSE(manager.Wait(lock_key_a, 30, 10, 10000, func));
+  EXPECT_EQ(2, manager.WaiterCount());
+
+  // 20 -> 30 is removed, then 30 -> 10 is ok
+  manager.WakeUp(lock_key_c);
+  EXPECT_TRUE(manager.Wait(lock_key_a, 30, 10, 10000, func));
+
+  manager.WakeUp({lock_key_a, lock_key_b});
+  EXPECT_EQ(0, manager.WaiterCount());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,59 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "engine/txn_resolved_ts.h"
+
+namespace dingodb {
+
+class TxnResolvedTsTest : public testing::Test {};
+
+TEST_F(TxnResolvedTsTest, CalcResolvedTs) {
+  // no lock
+  EXPECT_EQ(100, TxnResolvedTsManager::CalcResolvedTs(100, 0));
+  // lock older than tso
+  EXPECT_EQ(49, TxnResolvedTsManager::CalcResolvedTs(100, 50));
+  // lock newer than tso
+  EXPECT_EQ(100, TxnResolvedTsManager::CalcResolvedTs(100, 200));
+}
+
+TEST_F(TxnResolvedTsTest, Advance) {
+  auto& manager = TxnResolvedTsManager::GetInstance();
+  const int64_t region_id = 1001;
+  EXPECT_EQ(0, manager.GetResolvedTs(region_id));
+
+  int64_t generation = manager.Generation();
+  manager.AdvanceResolvedTs(region_id, 100, generation);
+  EXPECT_EQ(100, manager.GetResolvedTs(region_id));
+
+  // never go back
+  manager.AdvanceResolvedTs(region_id, 50, generation);
+  EXPECT_EQ(100, manager.GetResolvedTs(region_id));
+
+  // resolved before remove is ignored
+  manager.Remove(region_id);
+  EXPECT_EQ(0, manager.GetResolvedTs(region_id));
+  manager.AdvanceResolvedTs(region_id, 200, generation);
+  EXPECT_EQ(0, manager.GetResolvedTs(region_id));
+
+  manager.AdvanceResolvedTs(region_id, 200, manager.Generation());
+  EXPECT_EQ(200, manager.GetResolvedTs(region_id));
+  manager.Remove(region_id);
+}
+
+}  // namespace dingodb
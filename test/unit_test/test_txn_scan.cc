@@ -773,6 +773,60 @@ TEST_F(TxnScanTest, Scan) {
   EXPECT_FALSE(has_more);
 }
 
+TEST_F(TxnScanTest, ReverseScan) {
+  std::sort(keys.begin(), keys.end());
+
+  pb::common::Range range;
+  range.set_start_key(keys.front());
+  range.set_end_key(Helper::PrefixNext(keys.back()));
+
+  int64_t ts = ++end_ts;
+  std::set<int64_t> resolved_locks = {};
+
+  std::vector<pb::common::KeyValue> forward_kvs;
+  {
+    pb::store::TxnResultInfo txn_result_info;
+    std::string end_key;
+    bool has_more = false;
+    auto ok = TxnEngineHelper::Scan(engine, pb::store::IsolationLevel::SnapshotIsolation, ts, range, 1024, false, false,
+                                    resolved_locks, true, pb_coprocessor, txn_result_info, forward_kvs, has_more,
+                                    end_key);
+    EXPECT_TRUE(ok.ok());
+  }
+
+  std::vector<pb::common::KeyValue> reverse_kvs;
+  {
+    pb::store::TxnResultInfo txn_result_info;
+    std::string end_key;
+    bool has_more = false;
+    auto ok = TxnEngineHelper::Scan(engine, pb::store::IsolationLevel::SnapshotIsolation, ts, range, 1024, false, true,
+                                    resolved_locks, true, pb_coprocessor, txn_result_info, reverse_kvs, has_more,
+                                    end_key);
+    EXPECT_TRUE(ok.ok());
+  }
+
+  ASSERT_EQ(forward_kvs.size(), keys.size());
+  ASSERT_EQ(reverse_kvs.size(), forward_kvs.size());
+  for (size_t i = 0; i < forward_kvs.size(); ++i) {
+    const auto& expect_kv = forward_kvs[forward_kvs.size() - 1 - i];
+    EXPECT_EQ(reverse_kvs[i].key(), expect_kv.key());
+    EXPECT_EQ(reverse_kvs[i].value(), expect_kv.value());
+  }
+
+  // limit from the end of range
+  {
+    std::vector<pb::common::KeyValue> kvs;
+    pb::store::TxnResultInfo txn_result_info;
+    std::string end_key;
+    bool has_more = false;
+    auto ok = TxnEngineHelper::Scan(engine, pb::store::IsolationLevel::SnapshotIsolation, ts, range, 1, false, true,
+                                    resolved_locks, true, pb_coprocessor, txn_result_info, kvs, has_more, end_key);
+    EXPECT_TRUE(ok.ok());
+    ASSERT_EQ(1, kvs.size());
+    EXPECT_EQ(keys.back(), kvs[0].key());
+  }
+}
+
 TEST_F(TxnScanTest, KvDeleteRange) { DeleteRange(); }
 
 }  // namespace dingodb
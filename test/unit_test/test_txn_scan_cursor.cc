@@ -0,0 +1,93 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "common/helper.h"
+#include "engine/txn_scan_cursor.h"
+
+namespace dingodb {
+
+class TxnScanCursorTest : public testing::Test {};
+
+static TxnScanCursorPtr NewCursor() {
+  auto cursor = std::make_shared<TxnScanCursor>();
+  cursor->region_id = 1001;
+  cursor->epoch_version = 2;
+  cursor->start_ts = 100;
+  cursor->key_only = false;
+  cursor->end_key = "z";
+  cursor->next_start_key = Helper::PrefixNext("key010");
+  return cursor;
+}
+
+TEST_F(TxnScanCursorTest, IsNextPage) {
+  auto cursor = NewCursor();
+
+  pb::common::Range range;
+  range.set_start_key(Helper::PrefixNext("key010"));
+  range.set_end_key("z");
+  EXPECT_TRUE(cursor->IsNextPage(1001, 2, 100, false, range));
+
+  // region epoch changed
+  EXPECT_FALSE(cursor->IsNextPage(1001, 3, 100, false, range));
+  // another txn
+  EXPECT_FALSE(cursor->IsNextPage(1001, 2, 101, false, range));
+  EXPECT_FALSE(cursor->IsNextPage(1001, 2, 100, true, range));
+
+  // not continue from the last page
+  range.set_start_key("key005");
+  EXPECT_FALSE(cursor->IsNextPage(1001, 2, 100, false, range));
+}
+
+TEST_F(TxnScanCursorTest, PutAndTake) {
+  auto& manager = TxnScanCursorManager::GetInstance();
+  int64_t count = manager.Count();
+
+  auto cursor = NewCursor();
+  int64_t scan_id = manager.Put(0, cursor);
+  ASSERT_GT(scan_id, 0);
+  EXPECT_EQ(count + 1, manager.Count());
+
+  // the cursor is taken away by the page request
+  EXPECT_EQ(cursor, manager.Take(scan_id));
+  EXPECT_EQ(nullptr, manager.Take(scan_id));
+
+  // put back with the same scan_id
+  EXPECT_EQ(scan_id, manager.Put(scan_id, cursor));
+  EXPECT_EQ(cursor, manager.Take(scan_id));
+  EXPECT_EQ(count, manager.Count());
+}
+
+TEST_F(TxnScanCursorTest, CleanExpired) {
+  auto& manager = TxnScanCursorManager::GetInstance();
+
+  int64_t scan_id = manager.Put(0, NewCursor());
+  ASSERT_GT(scan_id, 0);
+
+  // not expired
+  manager.CleanExpired(Helper::TimestampMs(), 60 * 1000);
+  EXPECT_NE(nullptr, manager.Take(scan_id));
+
+  scan_id = manager.Put(0, NewCursor());
+  ASSERT_GT(scan_id, 0);
+  manager.CleanExpired(Helper::TimestampMs() + 60 * 1000, 60 * 1000);
+  EXPECT_EQ(nullptr, manager.Take(scan_id));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,102 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "proto/common.pb.h"
+#include "vector/vector_filter_planner.h"
+
+namespace dingodb {
+
+class VectorFilterPlannerTest : public testing::Test {};
+
+TEST_F(VectorFilterPlannerTest, IsApplicable) {
+  std::vector<pb::common::VectorWithId> vector_with_ids(1);
+  pb::common::VectorSearchParameter parameter;
+  parameter.set_top_n(10);
+  parameter.set_vector_filter(pb::common::VectorFilter::SCALAR_FILTER);
+
+  // no filter condition
+  EXPECT_FALSE(VectorFilterPlanner::IsApplicable(vector_with_ids, parameter));
+
+  pb::common::ScalarValue scalar_value;
+  scalar_value.set_field_type(pb::common::ScalarFieldType::STRING);
+  scalar_value.add_fields()->set_string_data("value");
+  (*vector_with_ids[0].mutable_scalar_data()->mutable_scalar_data())["key"] = scalar_value;
+  EXPECT_TRUE(VectorFilterPlanner::IsApplicable(vector_with_ids, parameter));
+
+  parameter.set_vector_filter_type(pb::common::VectorFilterType::QUERY_PRE);
+  EXPECT_TRUE(VectorFilterPlanner::IsApplicable(vector_with_ids, parameter));
+
+  parameter.set_enable_range_search(true);
+  EXPECT_FALSE(VectorFilterPlanner::IsApplicable(vector_with_ids, parameter));
+  parameter.set_enable_range_search(false);
+
+  parameter.set_use_brute_force(true);
+  EXPECT_FALSE(VectorFilterPlanner::IsApplicable(vector_with_ids, parameter));
+  parameter.set_use_brute_force(false);
+
+  parameter.set_vector_filter(pb::common::VectorFilter::VECTOR_ID_FILTER);
+  EXPECT_FALSE(VectorFilterPlanner::IsApplicable(vector_with_ids, parameter));
+}
+
+TEST_F(VectorFilterPlannerTest, EstimateSelectivity) {
+  std::vector<pb::common::VectorScalardata> samples(100);
+  for (size_t i = 0; i < samples.size(); ++i) {
+    pb::common::ScalarValue scalar_value;
+    scalar_value.set_field_type(pb::common::ScalarFieldType::INT64);
+    scalar_value.add_fields()->set_long_data(i);
+    (*samples[i].mutable_scalar_data())["key"] = scalar_value;
+  }
+
+  auto filter_func = [](const pb::common::VectorScalardata& scalar_data) {
+    return scalar_data.scalar_data().at("key").fields(0).long_data() < 25;
+  };
+  EXPECT_DOUBLE_EQ(0.25, VectorFilterPlanner::EstimateSelectivity(samples, filter_func));
+  EXPECT_DOUBLE_EQ(1.0, VectorFilterPlanner::EstimateSelectivity({}, filter_func));
+}
+
+TEST_F(VectorFilterPlannerTest, Choose) {
+  // few vectors match, compute them directly.
+  auto decision = VectorFilterPlanner::Choose(0.001, 1000000, 10);
+  EXPECT_EQ(VectorFilterPlanner::Plan::kBruteForce, decision.plan);
+  EXPECT_EQ(10, decision.topk);
+
+  // small region
+  decision = VectorFilterPlanner::Choose(1.0, 100, 10);
+  EXPECT_EQ(VectorFilterPlanner::Plan::kBruteForce, decision.plan);
+
+  // loose filter, search more candidates and filter them.
+  decision = VectorFilterPlanner::Choose(0.5, 1000000, 10);
+  EXPECT_EQ(VectorFilterPlanner::Plan::kPostFilter, decision.plan);
+  EXPECT_EQ(40, decision.topk);
+
+  decision = VectorFilterPlanner::Choose(1.0, 1000000, 10);
+  EXPECT_EQ(VectorFilterPlanner::Plan::kPostFilter, decision.plan);
+  EXPECT_EQ(20, decision.topk);
+
+  // strict filter
+  decision = VectorFilterPlanner::Choose(0.05, 1000000, 10);
+  EXPECT_EQ(VectorFilterPlanner::Plan::kPreFilter, decision.plan);
+  EXPECT_EQ(10, decision.topk);
+
+  EXPECT_TRUE(VectorFilterPlanner::IsBruteForceCount(0));
+  EXPECT_FALSE(VectorFilterPlanner::IsBruteForceCount(1000000));
+}
+
+}  // namespace dingodb
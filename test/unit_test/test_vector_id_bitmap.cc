@@ -0,0 +1,85 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "vector/vector_id_bitmap.h"
+
+namespace dingodb {
+
+class VectorIdBitmapTest : public testing::Test {};
+
+TEST_F(VectorIdBitmapTest, Sparse) {
+  std::mt19937_64 rng(1234);
+  std::uniform_int_distribution<int64_t> distrib(1, INT64_MAX / 2);
+
+  std::vector<int64_t> vector_ids;
+  std::set<int64_t> expect_ids;
+  for (int i = 0; i < 10000; ++i) {
+    auto vector_id = distrib(rng);
+    vector_ids.push_back(vector_id);
+    expect_ids.insert(vector_id);
+  }
+  // duplicate
+  vector_ids.push_back(vector_ids[0]);
+
+  VectorIdBitmap bitmap(vector_ids);
+  EXPECT_EQ(expect_ids.size(), bitmap.Count());
+  for (auto vector_id : vector_ids) {
+    EXPECT_TRUE(bitmap.Contains(vector_id));
+  }
+  for (int i = 0; i < 10000; ++i) {
+    auto vector_id = distrib(rng);
+    EXPECT_EQ(expect_ids.count(vector_id) > 0, bitmap.Contains(vector_id));
+  }
+}
+
+TEST_F(VectorIdBitmapTest, Dense) {
+  // ascending like scan, every third id of [1, 1000000)
+  VectorIdBitmap bitmap;
+  int64_t count = 0;
+  for (int64_t vector_id = 1; vector_id < 1000000; vector_id += 3) {
+    bitmap.Add(vector_id);
+    ++count;
+  }
+  EXPECT_EQ(count, bitmap.Count());
+
+  for (int64_t vector_id = 0; vector_id < 1000010; ++vector_id) {
+    EXPECT_EQ(vector_id < 1000000 && vector_id % 3 == 1, bitmap.Contains(vector_id)) << vector_id;
+  }
+
+  // dense containers are bitmaps, much smaller than int64 array.
+  EXPECT_LT(bitmap.MemorySize(), count * sizeof(int64_t) / 2);
+
+  // add to a bitmap container out of order
+  bitmap.Add(2);
+  bitmap.Add(2);
+  EXPECT_TRUE(bitmap.Contains(2));
+  EXPECT_EQ(count + 1, bitmap.Count());
+}
+
+TEST_F(VectorIdBitmapTest, Empty) {
+  VectorIdBitmap bitmap(std::vector<int64_t>{});
+  EXPECT_EQ(0, bitmap.Count());
+  EXPECT_FALSE(bitmap.Contains(0));
+  EXPECT_FALSE(bitmap.Contains(1));
+  EXPECT_FALSE(bitmap.Contains(INT64_MAX));
+}
+
+}  // namespace dingodb
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "butil/status.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/index.pb.h"
 #include "vector/codec.h"
@@ -28,6 +29,8 @@
 
 namespace dingodb {
 
+DECLARE_int64(vector_index_reload_search_count);
+
 class VectorIndexWrapperTest : public testing::Test {
  protected:
   static void SetUpTestSuite() { vector_index_thread_pool = std::make_shared<ThreadPool>("vector_index", 4); }
@@ -228,4 +231,29 @@ TEST_F(VectorIndexWrapperTest, MergeSearchResult) {
   }
 }
 
+TEST_F(VectorIndexWrapperTest, CountOffloadedSearch) {
+  FLAGS_vector_index_reload_search_count = 3;
+
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+  index_parameter.mutable_flat_parameter()->set_dimension(8);
+  index_parameter.mutable_flat_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+  auto vector_index_wrapper = VectorIndexWrapper::New(1, index_parameter);
+
+  EXPECT_FALSE(vector_index_wrapper->IsOffloaded());
+  vector_index_wrapper->SetOffloaded(true);
+  EXPECT_TRUE(vector_index_wrapper->IsOffloaded());
+
+  // only the 3rd search of the window need reload
+  EXPECT_FALSE(vector_index_wrapper->CountOffloadedSearch());
+  EXPECT_FALSE(vector_index_wrapper->CountOffloadedSearch());
+  EXPECT_TRUE(vector_index_wrapper->CountOffloadedSearch());
+  EXPECT_FALSE(vector_index_wrapper->CountOffloadedSearch());
+
+  vector_index_wrapper->IncSearchQueryCount(1);
+  EXPECT_GT(vector_index_wrapper->LastSearchTimeMs(), 0);
+
+  FLAGS_vector_index_reload_search_count = 100;
+}
+
 }  // namespace dingodb
@@ -0,0 +1,185 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/helper.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index_diskann.h"
+#include "vector/vector_index_factory.h"
+
+namespace dingodb {
+
+DECLARE_string(diskann_vector_file_path);
+
+static const std::string kTempDataDirectory = "./unit_test/vector_index_diskann";
+
+class VectorIndexDiskAnnTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    Helper::CreateDirectories(kTempDataDirectory);
+    FLAGS_diskann_vector_file_path = kTempDataDirectory + "/work";
+    vector_index_thread_pool = std::make_shared<ThreadPool>("vector_index", 4);
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<> distrib;
+    data_base.resize(data_base_size * dimension);
+    for (auto& value : data_base) {
+      value = distrib(rng);
+    }
+  }
+
+  static void TearDownTestSuite() { Helper::RemoveAllFileOrDirectory(kTempDataDirectory); }
+
+  static std::shared_ptr<VectorIndex> Create(pb::common::MetricType metric_type) {
+    static const pb::common::Range kRange;
+    pb::common::RegionEpoch epoch;
+    epoch.set_conf_version(1);
+    epoch.set_version(10);
+
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_DISKANN);
+    index_parameter.mutable_diskann_parameter()->set_dimension(dimension);
+    index_parameter.mutable_diskann_parameter()->set_metric_type(metric_type);
+    index_parameter.mutable_diskann_parameter()->set_ncentroids(ncentroids);
+    index_parameter.mutable_diskann_parameter()->set_nsubvector(nsubvector);
+    index_parameter.mutable_diskann_parameter()->set_nbits_per_idx(nbits_per_idx);
+    return VectorIndexFactory::NewDiskAnn(1, index_parameter, epoch, kRange, vector_index_thread_pool);
+  }
+
+  static std::vector<pb::common::VectorWithId> GenVectorWithIds(int64_t begin, int64_t end) {
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (int64_t i = begin; i < end; ++i) {
+      pb::common::VectorWithId vector_with_id;
+      vector_with_id.set_id(start_id + i);
+      for (int j = 0; j < dimension; ++j) {
+        vector_with_id.mutable_vector()->add_float_values(data_base[i * dimension + j]);
+      }
+      vector_with_ids.push_back(vector_with_id);
+    }
+    return vector_with_ids;
+  }
+
+  inline static int32_t dimension = 32;
+  inline static int data_base_size = 1000;
+  inline static int32_t ncentroids = 10;
+  inline static int32_t nsubvector = 8;
+  inline static int32_t nbits_per_idx = 8;
+  inline static int64_t start_id = 1000;
+  inline static std::vector<float> data_base;
+
+  static ThreadPoolPtr vector_index_thread_pool;
+};
+
+ThreadPoolPtr VectorIndexDiskAnnTest::vector_index_thread_pool = nullptr;
+
+TEST_F(VectorIndexDiskAnnTest, Create) {
+  pb::common::RegionEpoch epoch;
+  pb::common::Range range;
+
+  // dimension not divisible by nsubvector
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_DISKANN);
+  index_parameter.mutable_diskann_parameter()->set_dimension(30);
+  index_parameter.mutable_diskann_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+  index_parameter.mutable_diskann_parameter()->set_nsubvector(8);
+  EXPECT_EQ(nullptr, VectorIndexFactory::NewDiskAnn(1, index_parameter, epoch, range, vector_index_thread_pool));
+
+  auto vector_index = Create(pb::common::MetricType::METRIC_TYPE_L2);
+  ASSERT_NE(nullptr, vector_index);
+  EXPECT_TRUE(vector_index->NeedTrain());
+  EXPECT_FALSE(vector_index->IsTrained());
+}
+
+TEST_F(VectorIndexDiskAnnTest, AddSearchDelete) {
+  for (auto metric_type : {pb::common::MetricType::METRIC_TYPE_L2, pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT,
+                           pb::common::MetricType::METRIC_TYPE_COSINE}) {
+    auto vector_index = Create(metric_type);
+    ASSERT_NE(nullptr, vector_index);
+
+    // train by the first add
+    auto vector_with_ids = GenVectorWithIds(0, data_base_size);
+    ASSERT_TRUE(vector_index->Add(vector_with_ids).ok());
+    EXPECT_TRUE(vector_index->IsTrained());
+
+    int64_t count = 0;
+    ASSERT_TRUE(vector_index->GetCount(count).ok());
+    EXPECT_EQ(data_base_size, count);
+
+    // search itself, the re-rank by full precision vectors must find it at first.
+    pb::common::VectorSearchParameter parameter;
+    parameter.mutable_diskann()->set_nprobe(ncentroids);
+    parameter.mutable_diskann()->set_rerank_factor(10);
+    std::vector<pb::common::VectorWithId> query = {vector_with_ids[10]};
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ASSERT_TRUE(vector_index->Search(query, 5, {}, false, parameter, results).ok());
+    ASSERT_EQ(1, results.size());
+    ASSERT_FALSE(results[0].vector_with_distances().empty());
+    EXPECT_EQ(start_id + 10, results[0].vector_with_distances(0).vector_with_id().id());
+
+    ASSERT_TRUE(vector_index->Delete({start_id + 10}).ok());
+    results.clear();
+    ASSERT_TRUE(vector_index->Search(query, 5, {}, false, parameter, results).ok());
+    ASSERT_EQ(1, results.size());
+    for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+      EXPECT_NE(start_id + 10, vector_with_distance.vector_with_id().id());
+    }
+  }
+}
+
+TEST_F(VectorIndexDiskAnnTest, SaveAndLoad) {
+  auto vector_index = Create(pb::common::MetricType::METRIC_TYPE_L2);
+  ASSERT_NE(nullptr, vector_index);
+
+  ASSERT_TRUE(vector_index->Add(GenVectorWithIds(0, data_base_size)).ok());
+  // upsert override the old record on SSD
+  auto upsert_vectors = GenVectorWithIds(1, 2);
+  upsert_vectors[0].set_id(start_id);
+  ASSERT_TRUE(vector_index->Upsert(upsert_vectors).ok());
+  ASSERT_TRUE(vector_index->Delete({start_id + 20}).ok());
+
+  std::string path = kTempDataDirectory + "/l2_diskann";
+  ASSERT_TRUE(vector_index->Save(path).ok());
+  EXPECT_TRUE(Helper::IsExistPath(VectorIndexDiskAnn::VectorFilePath(path)));
+
+  auto load_vector_index = Create(pb::common::MetricType::METRIC_TYPE_L2);
+  ASSERT_NE(nullptr, load_vector_index);
+  ASSERT_TRUE(load_vector_index->Load(path).ok());
+  EXPECT_TRUE(load_vector_index->IsTrained());
+
+  int64_t count = 0;
+  ASSERT_TRUE(load_vector_index->GetCount(count).ok());
+  EXPECT_EQ(data_base_size - 1, count);
+
+  pb::common::VectorSearchParameter parameter;
+  parameter.mutable_diskann()->set_nprobe(ncentroids);
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  ASSERT_TRUE(load_vector_index->Search(upsert_vectors, 2, {}, false, parameter, results).ok());
+  ASSERT_EQ(1, results.size());
+  ASSERT_EQ(2, results[0].vector_with_distances().size());
+  // start_id and start_id + 1 have the same vector now.
+  EXPECT_FLOAT_EQ(0.0f, results[0].vector_with_distances(0).distance());
+  EXPECT_FLOAT_EQ(0.0f, results[0].vector_with_distances(1).distance());
+}
+
+}  // namespace dingodb
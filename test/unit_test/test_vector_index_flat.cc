@@ -32,6 +32,7 @@
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
 #include "vector/vector_index_factory.h"
+#include "vector/vector_index_gpu.h"
 
 namespace dingodb {
 
@@ -1723,4 +1724,57 @@ TEST_F(VectorIndexFlatTest, RangeSearchAfterLoad) {
   }
 }
 
+TEST_F(VectorIndexFlatTest, SearchWithGpu) {
+  static const pb::common::Range kRange;
+  static pb::common::RegionEpoch kEpoch;  // NOLINT
+  kEpoch.set_conf_version(1);
+  kEpoch.set_version(10);
+
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+  index_parameter.mutable_flat_parameter()->set_dimension(dimension);
+  index_parameter.mutable_flat_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+  index_parameter.mutable_flat_parameter()->set_use_gpu(true);
+  auto vector_index = VectorIndexFactory::NewFlat(2, index_parameter, kEpoch, kRange, vector_index_thread_pool);
+  ASSERT_NE(vector_index.get(), nullptr);
+
+  std::mt19937 rng;
+  std::uniform_real_distribution<> distrib;
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  for (int64_t id = 0; id < 100; ++id) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(id);
+    for (int j = 0; j < dimension; j++) {
+      vector_with_id.mutable_vector()->add_float_values(distrib(rng));
+    }
+    vector_with_ids.push_back(vector_with_id);
+  }
+  ASSERT_TRUE(vector_index->Upsert(vector_with_ids).ok());
+
+  auto search_and_check = [&]() {
+    std::vector<pb::common::VectorWithId> queries = {vector_with_ids[7], vector_with_ids[42]};
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ASSERT_TRUE(vector_index->Search(queries, 3, {}, false, {}, results).ok());
+    ASSERT_EQ(2, results.size());
+    EXPECT_EQ(7, results[0].vector_with_distances(0).vector_with_id().id());
+    EXPECT_EQ(42, results[1].vector_with_distances(0).vector_with_id().id());
+  };
+
+  // stale replica, search on cpu.
+  search_and_check();
+
+  // without gpu, the replica is never synced.
+  EXPECT_EQ(GpuIndexReplica::IsAvailable(), vector_index->NeedToRepair());
+  if (GpuIndexReplica::IsAvailable()) {
+    ASSERT_TRUE(vector_index->Repair().ok());
+    EXPECT_FALSE(vector_index->NeedToRepair());
+    search_and_check();
+
+    // write make replica stale again.
+    ASSERT_TRUE(vector_index->Delete({99}).ok());
+    EXPECT_TRUE(vector_index->NeedToRepair());
+    search_and_check();
+  }
+}
+
 }  // namespace dingodb
@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
@@ -22,11 +23,13 @@
 #include <iostream>
 #include <memory>
 #include <random>
+#include <thread>
 #include <vector>
 
 #include "butil/status.h"
 #include "faiss/MetricType.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
@@ -37,6 +40,9 @@
 
 namespace dingodb {
 
+DECLARE_uint32(hnsw_max_init_max_elements);
+DECLARE_double(hnsw_resize_ahead_ratio);
+
 class VectorIndexHnswTest : public testing::Test {
  protected:
   static void SetUpTestSuite() {}
@@ -607,4 +613,214 @@ TEST_F(VectorIndexHnswTest, EfSearchCosine) {
   }
 }
 
+TEST_F(VectorIndexHnswTest, ResizeAheadWithSearch) {
+  static const pb::common::Range kRange;
+  auto old_init_max_elements = FLAGS_hnsw_max_init_max_elements;
+  FLAGS_hnsw_max_init_max_elements = 64;
+
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+  index_parameter.mutable_hnsw_parameter()->set_dimension(dimension);
+  index_parameter.mutable_hnsw_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+  index_parameter.mutable_hnsw_parameter()->set_efconstruction(efconstruction);
+  index_parameter.mutable_hnsw_parameter()->set_max_elements(100000);
+  index_parameter.mutable_hnsw_parameter()->set_nlinks(16);
+
+  pb::common::RegionEpoch epoch;
+  auto vector_index = VectorIndexFactory::NewHnsw(1, index_parameter, epoch, kRange, nullptr);
+  ASSERT_NE(nullptr, vector_index);
+  FLAGS_hnsw_max_init_max_elements = old_init_max_elements;
+
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<> distrib;
+  auto gen_vector_with_id = [&](int64_t id) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(id);
+    for (int i = 0; i < dimension; ++i) {
+      vector_with_id.mutable_vector()->add_float_values(distrib(rng));
+    }
+    return vector_with_id;
+  };
+
+  std::vector<pb::common::VectorWithId> queries = {gen_vector_with_id(0)};
+
+  // search keep running when index grows
+  std::atomic<bool> stop = false;
+  std::atomic<int64_t> search_count = 0;
+  std::thread search_thread([&]() {
+    pb::common::VectorSearchParameter parameter;
+    while (!stop.load()) {
+      std::vector<pb::index::VectorWithDistanceResult> results;
+      EXPECT_TRUE(vector_index->Search(queries, 5, {}, false, parameter, results).ok());
+      search_count.fetch_add(1);
+    }
+  });
+
+  const int64_t batch_count = 20;
+  const int64_t batch_size = 100;
+  for (int64_t batch = 0; batch < batch_count; ++batch) {
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (int64_t i = 0; i < batch_size; ++i) {
+      vector_with_ids.push_back(gen_vector_with_id(batch * batch_size + i + 1));
+    }
+    ASSERT_TRUE(vector_index->Upsert(vector_with_ids).ok());
+  }
+
+  stop.store(true);
+  search_thread.join();
+  EXPECT_GT(search_count.load(), 0);
+
+  int64_t count = 0;
+  ASSERT_TRUE(vector_index->GetCount(count).ok());
+  EXPECT_EQ(batch_count * batch_size, count);
+
+  // the capacity is kept above the watermark
+  int64_t max_elements = 0;
+  ASSERT_TRUE(std::dynamic_pointer_cast<VectorIndexHnsw>(vector_index)->GetMaxElements(max_elements).ok());
+  EXPECT_GE(max_elements * FLAGS_hnsw_resize_ahead_ratio, count);
+}
+
+TEST_F(VectorIndexHnswTest, ReuseDeletedSlot) {
+  static const pb::common::Range kRange;
+
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+  index_parameter.mutable_hnsw_parameter()->set_dimension(dimension);
+  index_parameter.mutable_hnsw_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+  index_parameter.mutable_hnsw_parameter()->set_efconstruction(efconstruction);
+  index_parameter.mutable_hnsw_parameter()->set_max_elements(100000);
+  index_parameter.mutable_hnsw_parameter()->set_nlinks(16);
+
+  pb::common::RegionEpoch epoch;
+  auto vector_index = VectorIndexFactory::NewHnsw(1, index_parameter, epoch, kRange, nullptr);
+  ASSERT_NE(nullptr, vector_index);
+  auto hnsw_index = std::dynamic_pointer_cast<VectorIndexHnsw>(vector_index);
+
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<> distrib;
+  auto gen_vector_with_ids = [&](int64_t start_id, int64_t end_id) {
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (int64_t id = start_id; id < end_id; ++id) {
+      pb::common::VectorWithId vector_with_id;
+      vector_with_id.set_id(id);
+      for (int i = 0; i < dimension; ++i) {
+        vector_with_id.mutable_vector()->add_float_values(distrib(rng));
+      }
+      vector_with_ids.push_back(vector_with_id);
+    }
+    return vector_with_ids;
+  };
+
+  auto search_self = [&](const pb::common::VectorWithId& vector_with_id) {
+    pb::common::VectorSearchParameter parameter;
+    parameter.mutable_hnsw()->set_efsearch(100);
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ASSERT_TRUE(vector_index->Search({vector_with_id}, 1, {}, false, parameter, results).ok());
+    ASSERT_EQ(1, results.size());
+    ASSERT_EQ(1, results[0].vector_with_distances_size());
+    EXPECT_EQ(vector_with_id.id(), results[0].vector_with_distances(0).vector_with_id().id());
+  };
+
+  ASSERT_TRUE(vector_index->Upsert(gen_vector_with_ids(1, 1001)).ok());
+
+  std::vector<int64_t> delete_ids;
+  for (int64_t id = 1; id <= 500; ++id) {
+    delete_ids.push_back(id);
+  }
+  ASSERT_TRUE(vector_index->Delete(delete_ids).ok());
+
+  EXPECT_NEAR(0.5, hnsw_index->DeletedRatio(), 1e-6);
+  EXPECT_TRUE(vector_index->NeedToRepair());
+  ASSERT_TRUE(vector_index->Repair().ok());
+  EXPECT_FALSE(vector_index->NeedToRepair());
+
+  // new vectors take the slots of deleted vectors, the element count not grow.
+  auto new_vector_with_ids = gen_vector_with_ids(1001, 1501);
+  ASSERT_TRUE(vector_index->Upsert(new_vector_with_ids).ok());
+
+  int64_t count = 0;
+  ASSERT_TRUE(vector_index->GetCount(count).ok());
+  EXPECT_EQ(1000, count);
+  int64_t deleted_count = 0;
+  ASSERT_TRUE(vector_index->GetDeletedCount(deleted_count).ok());
+  EXPECT_EQ(0, deleted_count);
+
+  for (int64_t i = 0; i < 500; i += 50) {
+    search_self(new_vector_with_ids[i]);
+  }
+
+  // upsert a deleted id again
+  ASSERT_TRUE(vector_index->Delete({600}).ok());
+  auto vector_with_ids = gen_vector_with_ids(600, 601);
+  ASSERT_TRUE(vector_index->Upsert(vector_with_ids).ok());
+  ASSERT_TRUE(vector_index->GetCount(count).ok());
+  EXPECT_EQ(1000, count);
+  search_self(vector_with_ids[0]);
+}
+
+TEST_F(VectorIndexHnswTest, OptimizeLayout) {
+  static const pb::common::Range kRange;
+
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+  index_parameter.mutable_hnsw_parameter()->set_dimension(dimension);
+  index_parameter.mutable_hnsw_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+  index_parameter.mutable_hnsw_parameter()->set_efconstruction(efconstruction);
+  index_parameter.mutable_hnsw_parameter()->set_max_elements(100000);
+  index_parameter.mutable_hnsw_parameter()->set_nlinks(16);
+
+  pb::common::RegionEpoch epoch;
+  auto vector_index = VectorIndexFactory::NewHnsw(1, index_parameter, epoch, kRange, nullptr);
+  ASSERT_NE(nullptr, vector_index);
+
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<> distrib;
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  for (int64_t id = 1; id <= 1000; ++id) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(id);
+    for (int i = 0; i < dimension; ++i) {
+      vector_with_id.mutable_vector()->add_float_values(distrib(rng));
+    }
+    vector_with_ids.push_back(vector_with_id);
+  }
+  ASSERT_TRUE(vector_index->Upsert(vector_with_ids).ok());
+  ASSERT_TRUE(vector_index->Delete({1, 2, 3}).ok());
+
+  pb::common::VectorSearchParameter parameter;
+  parameter.mutable_hnsw()->set_efsearch(100);
+  std::vector<pb::common::VectorWithId> queries(vector_with_ids.begin() + 100, vector_with_ids.begin() + 110);
+  std::vector<pb::index::VectorWithDistanceResult> before_results;
+  ASSERT_TRUE(vector_index->Search(queries, 5, {}, true, parameter, before_results).ok());
+
+  ASSERT_TRUE(vector_index->OptimizeLayout().ok());
+
+  // renumber internal ids not change the graph, so the same results.
+  std::vector<pb::index::VectorWithDistanceResult> after_results;
+  ASSERT_TRUE(vector_index->Search(queries, 5, {}, true, parameter, after_results).ok());
+  ASSERT_EQ(before_results.size(), after_results.size());
+  for (size_t i = 0; i < before_results.size(); ++i) {
+    ASSERT_EQ(before_results[i].vector_with_distances_size(), after_results[i].vector_with_distances_size());
+    EXPECT_EQ(queries[i].id(), after_results[i].vector_with_distances(0).vector_with_id().id());
+    for (int j = 0; j < before_results[i].vector_with_distances_size(); ++j) {
+      const auto& before = before_results[i].vector_with_distances(j).vector_with_id();
+      const auto& after = after_results[i].vector_with_distances(j).vector_with_id();
+      EXPECT_EQ(before.id(), after.id());
+      EXPECT_EQ(before.vector().float_values(0), after.vector().float_values(0));
+    }
+  }
+
+  int64_t deleted_count = 0;
+  ASSERT_TRUE(vector_index->GetDeletedCount(deleted_count).ok());
+  EXPECT_EQ(3, deleted_count);
+
+  // write after optimize.
+  ASSERT_TRUE(vector_index->Delete({500}).ok());
+  ASSERT_TRUE(vector_index->Upsert({vector_with_ids[0]}).ok());
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  ASSERT_TRUE(vector_index->Search({vector_with_ids[0]}, 1, {}, false, parameter, results).ok());
+  ASSERT_EQ(1, results[0].vector_with_distances_size());
+  EXPECT_EQ(1, results[0].vector_with_distances(0).vector_with_id().id());
+}
+
 }  // namespace dingodb
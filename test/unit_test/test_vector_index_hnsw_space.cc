@@ -0,0 +1,270 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/codec.h"
+#include "vector/vector_index_factory.h"
+#include "vector/vector_index_hnsw.h"
+#include "vector/vector_index_hnsw_space.h"
+
+namespace dingodb {
+
+class VectorIndexHnswSpaceTest : public testing::Test {
+ protected:
+  static std::vector<float> RandomVector(std::mt19937& rng, size_t dimension) {
+    std::uniform_real_distribution<float> distrib(-1.0f, 1.0f);
+    std::vector<float> vector(dimension);
+    for (auto& value : vector) {
+      value = distrib(rng);
+    }
+    return vector;
+  }
+
+  inline static size_t dimension = 64;
+};
+
+TEST_F(VectorIndexHnswSpaceTest, Fp16Convert) {
+  for (uint32_t i = 0; i < 65536; ++i) {
+    auto half = static_cast<uint16_t>(i);
+    float value = HnswFp16Space::HalfToFloat(half);
+    if (std::isnan(value)) {
+      continue;
+    }
+    EXPECT_EQ(half, HnswFp16Space::FloatToHalf(value));
+  }
+
+  EXPECT_EQ(0x3c00, HnswFp16Space::FloatToHalf(1.0f));
+  EXPECT_EQ(0x7c00, HnswFp16Space::FloatToHalf(1e6f));
+  EXPECT_EQ(0, HnswFp16Space::FloatToHalf(1e-10f));
+}
+
+TEST_F(VectorIndexHnswSpaceTest, Distance) {
+  std::mt19937 rng(1234);
+
+  for (auto quantizer_type :
+       {pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_SQ8, pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_FP16}) {
+    for (bool is_ip : {false, true}) {
+      std::unique_ptr<HnswQuantizedSpace> space(HnswQuantizedSpace::New(quantizer_type, dimension, is_ip));
+      ASSERT_NE(nullptr, space);
+      EXPECT_EQ(HnswQuantizedSpace::CodeSize(quantizer_type, dimension), space->get_data_size());
+      EXPECT_LT(space->get_data_size(), dimension * sizeof(float));
+
+      auto x = RandomVector(rng, dimension);
+      auto y = RandomVector(rng, dimension);
+      std::vector<uint8_t> code_x(space->get_data_size());
+      std::vector<uint8_t> code_y(space->get_data_size());
+      space->Encode(x.data(), code_x.data());
+      space->Encode(y.data(), code_y.data());
+
+      std::vector<float> decoded(dimension);
+      space->Decode(code_x.data(), decoded.data());
+      for (size_t i = 0; i < dimension; ++i) {
+        EXPECT_NEAR(x[i], decoded[i], 0.01);
+      }
+
+      float expect = 0.0f;
+      for (size_t i = 0; i < dimension; ++i) {
+        expect += is_ip ? x[i] * y[i] : (x[i] - y[i]) * (x[i] - y[i]);
+      }
+      if (is_ip) {
+        expect = 1.0f - expect;
+      }
+
+      float distance = space->get_dist_func()(code_x.data(), code_y.data(), space->get_dist_func_param());
+      EXPECT_NEAR(expect, distance, 0.1);
+    }
+  }
+}
+
+TEST_F(VectorIndexHnswSpaceTest, IntegerDistance) {
+  std::unique_ptr<HnswQuantizedSpace> int8_space(
+      HnswQuantizedSpace::New(pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_INT8, 4, false));
+  ASSERT_NE(nullptr, int8_space);
+  EXPECT_EQ(4, int8_space->get_data_size());
+
+  std::vector<float> x = {1.0f, -2.0f, 127.0f, 300.0f};
+  std::vector<float> y = {0.0f, 2.0f, -128.0f, 0.0f};
+  std::vector<int8_t> code_x(4);
+  std::vector<int8_t> code_y(4);
+  int8_space->Encode(x.data(), code_x.data());
+  int8_space->Encode(y.data(), code_y.data());
+  EXPECT_EQ(127, code_x[3]);
+
+  float distance = int8_space->get_dist_func()(code_x.data(), code_y.data(), int8_space->get_dist_func_param());
+  EXPECT_FLOAT_EQ(1.0f + 16.0f + 255.0f * 255.0f + 127.0f * 127.0f, distance);
+
+  std::unique_ptr<HnswQuantizedSpace> binary_space(
+      HnswQuantizedSpace::New(pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_BINARY, 100, false));
+  ASSERT_NE(nullptr, binary_space);
+  EXPECT_EQ(13, binary_space->get_data_size());
+
+  std::vector<float> a(100, 0.0f);
+  std::vector<float> b(100, 0.0f);
+  for (size_t i = 0; i < 100; i += 3) {
+    a[i] = 1.0f;
+  }
+  b[0] = 1.0f;
+  b[99] = -1.0f;
+  std::vector<uint8_t> code_a(binary_space->get_data_size());
+  std::vector<uint8_t> code_b(binary_space->get_data_size());
+  binary_space->Encode(a.data(), code_a.data());
+  binary_space->Encode(b.data(), code_b.data());
+
+  // a has 34 bits set including bit 0 and bit 99
+  distance = binary_space->get_dist_func()(code_a.data(), code_b.data(), binary_space->get_dist_func_param());
+  EXPECT_FLOAT_EQ(32.0f, distance);
+
+  std::vector<float> decoded(100);
+  binary_space->Decode(code_b.data(), decoded.data());
+  EXPECT_EQ(1.0f, decoded[0]);
+  EXPECT_EQ(1.0f, decoded[99]);
+  EXPECT_EQ(0.0f, decoded[1]);
+}
+
+TEST_F(VectorIndexHnswSpaceTest, VectorToFloat) {
+  pb::common::Vector binary_vector;
+  binary_vector.set_value_type(pb::common::ValueType::UINT8);
+  binary_vector.add_binary_values(std::string("\x05\x80", 2));
+  EXPECT_TRUE(VectorCodec::CheckVectorDimension(binary_vector, 16));
+  EXPECT_FALSE(VectorCodec::CheckVectorDimension(binary_vector, 24));
+
+  std::vector<float> values(16);
+  ASSERT_TRUE(VectorCodec::VectorToFloat(binary_vector, 16, values.data()));
+  std::vector<float> expect = {1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1};
+  EXPECT_EQ(expect, values);
+
+  pb::common::Vector int8_vector;
+  int8_vector.set_value_type(pb::common::ValueType::SINT8);
+  int8_vector.add_binary_values(std::string("\x01\xff", 2));
+  int8_vector.add_binary_values(std::string("\x80", 1));
+  ASSERT_TRUE(VectorCodec::CheckVectorDimension(int8_vector, 3));
+  values.resize(3);
+  ASSERT_TRUE(VectorCodec::VectorToFloat(int8_vector, 3, values.data()));
+  EXPECT_EQ(std::vector<float>({1.0f, -1.0f, -128.0f}), values);
+}
+
+TEST_F(VectorIndexHnswSpaceTest, BinaryHnswSearch) {
+  static const pb::common::Range kRange;
+  pb::common::RegionEpoch epoch;
+  epoch.set_conf_version(1);
+  epoch.set_version(10);
+
+  std::mt19937 rng(5678);
+  std::uniform_int_distribution<int> distrib(0, 255);
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  for (int64_t i = 1; i <= 200; ++i) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(i);
+    vector_with_id.mutable_vector()->set_value_type(pb::common::ValueType::UINT8);
+    std::string bits(dimension / 8, '\0');
+    for (auto& byte : bits) {
+      byte = static_cast<char>(distrib(rng));
+    }
+    vector_with_id.mutable_vector()->add_binary_values(bits);
+    vector_with_ids.push_back(vector_with_id);
+  }
+
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+  index_parameter.mutable_hnsw_parameter()->set_dimension(dimension);
+  index_parameter.mutable_hnsw_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_HAMMING);
+  index_parameter.mutable_hnsw_parameter()->set_efconstruction(200);
+  index_parameter.mutable_hnsw_parameter()->set_max_elements(1000);
+  index_parameter.mutable_hnsw_parameter()->set_nlinks(16);
+
+  auto vector_index = VectorIndexFactory::NewHnsw(1, index_parameter, epoch, kRange, nullptr);
+  ASSERT_NE(nullptr, vector_index);
+  EXPECT_TRUE(std::dynamic_pointer_cast<VectorIndexHnsw>(vector_index)->IsQuantized());
+  ASSERT_TRUE(vector_index->Upsert(vector_with_ids).ok());
+
+  pb::common::VectorSearchParameter parameter;
+  parameter.mutable_hnsw()->set_efsearch(64);
+  std::vector<pb::common::VectorWithId> query = {vector_with_ids[7]};
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  ASSERT_TRUE(vector_index->Search(query, 3, {}, false, parameter, results).ok());
+  ASSERT_EQ(1, results.size());
+  ASSERT_FALSE(results[0].vector_with_distances().empty());
+  EXPECT_EQ(vector_with_ids[7].id(), results[0].vector_with_distances(0).vector_with_id().id());
+  EXPECT_FLOAT_EQ(0.0f, results[0].vector_with_distances(0).distance());
+}
+
+TEST_F(VectorIndexHnswSpaceTest, QuantizedHnswSearch) {
+  static const pb::common::Range kRange;
+  pb::common::RegionEpoch epoch;
+  epoch.set_conf_version(1);
+  epoch.set_version(10);
+
+  std::mt19937 rng(4321);
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  for (int64_t i = 1; i <= 500; ++i) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(i);
+    for (auto value : RandomVector(rng, dimension)) {
+      vector_with_id.mutable_vector()->add_float_values(value);
+    }
+    vector_with_ids.push_back(vector_with_id);
+  }
+
+  for (auto quantizer_type :
+       {pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_SQ8, pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_FP16}) {
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+    index_parameter.mutable_hnsw_parameter()->set_dimension(dimension);
+    index_parameter.mutable_hnsw_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+    index_parameter.mutable_hnsw_parameter()->set_efconstruction(200);
+    index_parameter.mutable_hnsw_parameter()->set_max_elements(1000);
+    index_parameter.mutable_hnsw_parameter()->set_nlinks(16);
+    index_parameter.mutable_hnsw_parameter()->set_quantizer_type(quantizer_type);
+
+    auto vector_index = VectorIndexFactory::NewHnsw(1, index_parameter, epoch, kRange, nullptr);
+    ASSERT_NE(nullptr, vector_index);
+    EXPECT_TRUE(std::dynamic_pointer_cast<VectorIndexHnsw>(vector_index)->IsQuantized());
+
+    ASSERT_TRUE(vector_index->Upsert(vector_with_ids).ok());
+
+    // search itself
+    pb::common::VectorSearchParameter parameter;
+    parameter.mutable_hnsw()->set_efsearch(64);
+    std::vector<pb::common::VectorWithId> query = {vector_with_ids[42]};
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ASSERT_TRUE(vector_index->Search(query, 3, {}, true, parameter, results).ok());
+    ASSERT_EQ(1, results.size());
+    ASSERT_FALSE(results[0].vector_with_distances().empty());
+
+    const auto& nearest = results[0].vector_with_distances(0);
+    EXPECT_EQ(vector_with_ids[42].id(), nearest.vector_with_id().id());
+    ASSERT_EQ(dimension, nearest.vector_with_id().vector().float_values_size());
+    for (size_t i = 0; i < dimension; ++i) {
+      EXPECT_NEAR(vector_with_ids[42].vector().float_values(i), nearest.vector_with_id().vector().float_values(i),
+                  0.01);
+    }
+  }
+
+  // quantized index can hold more vectors in the same memory
+  EXPECT_GT(VectorIndexHnsw::CalcHnswCountFromMemory(1024 * 1024, 128, 32,
+                                                     pb::common::HnswQuantizerType::HNSW_QUANTIZER_TYPE_SQ8),
+            2 * VectorIndexHnsw::CalcHnswCountFromMemory(1024 * 1024, 128, 32));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,92 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "faiss/IndexFlat.h"
+#include "faiss/IndexIDMap.h"
+#include "faiss/index_io.h"
+#include "gflags/gflags.h"
+#include "vector/vector_index_mmap_reader.h"
+
+namespace dingodb {
+
+DECLARE_bool(vector_index_load_use_mmap);
+DECLARE_int64(vector_index_load_mmap_release_size);
+
+class VectorIndexMmapReaderTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> distrib;
+    data.resize(kCount * kDimension);
+    for (auto& value : data) {
+      value = distrib(rng);
+    }
+    std::vector<faiss::idx_t> ids(kCount);
+    for (int64_t i = 0; i < kCount; ++i) {
+      ids[i] = i + 100;
+    }
+
+    faiss::IndexFlatL2 flat_index(kDimension);
+    faiss::IndexIDMap2 index(&flat_index);
+    index.add_with_ids(kCount, data.data(), ids.data());
+    faiss::write_index(&index, kPath.c_str());
+  }
+
+  static void TearDownTestSuite() { std::remove(kPath.c_str()); }
+
+  inline static const std::string kPath = "./vector_index_mmap_reader_test.idx";
+  inline static const int64_t kCount = 10000;
+  inline static const int kDimension = 64;
+  inline static std::vector<float> data;
+};
+
+TEST_F(VectorIndexMmapReaderTest, ReadIndex) {
+  auto old_release_size = FLAGS_vector_index_load_mmap_release_size;
+  // release pages during read
+  FLAGS_vector_index_load_mmap_release_size = 4096;
+
+  for (bool use_mmap : {true, false}) {
+    FLAGS_vector_index_load_use_mmap = use_mmap;
+
+    std::unique_ptr<faiss::Index> index(MmapIndexReader::ReadIndex(kPath));
+    auto* id_map = dynamic_cast<faiss::IndexIDMap2*>(index.get());
+    ASSERT_NE(nullptr, id_map);
+    ASSERT_EQ(kDimension, id_map->d);
+    ASSERT_EQ(kCount, id_map->ntotal);
+
+    std::vector<float> distances(1);
+    std::vector<faiss::idx_t> labels(1);
+    id_map->search(1, data.data() + 42 * kDimension, 1, distances.data(), labels.data());
+    EXPECT_EQ(142, labels[0]);
+    EXPECT_FLOAT_EQ(0.0f, distances[0]);
+  }
+
+  FLAGS_vector_index_load_use_mmap = true;
+  FLAGS_vector_index_load_mmap_release_size = old_release_size;
+
+  // not exist file
+  EXPECT_THROW(MmapIndexReader::ReadIndex("./not_exist_vector_index.idx"), std::exception);
+}
+
+}  // namespace dingodb
@@ -29,14 +29,19 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "faiss/MetricType.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
 #include "vector/vector_index_factory.h"
 #include "vector/vector_index_raw_ivf_pq.h"
+#include "vector/vector_index_utils.h"
 
 namespace dingodb {
 
+DECLARE_int64(ivf_pq_rebalance_interval_s);
+DECLARE_int64(ivf_pq_rebalance_min_split_size);
+
 static const std::string kTempDataDirectory = "./unit_test/vector_index_raw_ivf_pq";
 
 class VectorIndexRawIvfPqTest : public testing::Test {
@@ -1559,4 +1564,186 @@ TEST_F(VectorIndexRawIvfPqTest, SearchAfterLoad) {
   }
 }
 
+TEST_F(VectorIndexRawIvfPqTest, FastScan) {
+  static const pb::common::Range kRange;
+  static pb::common::RegionEpoch k_epoch;
+  k_epoch.set_conf_version(1);
+  k_epoch.set_version(10);
+
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ);
+  index_parameter.mutable_ivf_pq_parameter()->set_dimension(dimension);
+  index_parameter.mutable_ivf_pq_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+  index_parameter.mutable_ivf_pq_parameter()->set_ncentroids(10);
+  index_parameter.mutable_ivf_pq_parameter()->set_nsubvector(nsubvector);
+  index_parameter.mutable_ivf_pq_parameter()->set_nbits_per_idx(4);
+  index_parameter.mutable_ivf_pq_parameter()->set_use_fast_scan(true);
+  EXPECT_TRUE(VectorIndexUtils::ValidateVectorIndexParameter(index_parameter).ok());
+
+  auto fast_scan_index =
+      std::make_shared<VectorIndexRawIvfPq>(100, index_parameter, k_epoch, kRange, vector_index_thread_pool);
+
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<> distrib;
+  std::vector<float> datas(data_base_size * dimension);
+  for (auto& data : datas) {
+    data = distrib(rng);
+  }
+
+  butil::Status ok = fast_scan_index->Train(datas);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  EXPECT_TRUE(fast_scan_index->IsTrained());
+
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  for (int i = 0; i < data_base_size; i++) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(i + start_id);
+    for (size_t j = 0; j < dimension; j++) {
+      vector_with_id.mutable_vector()->add_float_values(datas[i * dimension + j]);
+    }
+    vector_with_ids.push_back(vector_with_id);
+  }
+  ok = fast_scan_index->Add(vector_with_ids);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  std::vector<pb::common::VectorWithId> query_vectors(vector_with_ids.begin(), vector_with_ids.begin() + 2);
+  pb::common::VectorSearchParameter parameter;
+  parameter.mutable_ivf_pq()->set_nprobe(10);
+
+  uint32_t topk = 5;
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  ok = fast_scan_index->Search(query_vectors, topk, {}, false, parameter, results);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  ASSERT_EQ(results.size(), query_vectors.size());
+  EXPECT_EQ(results[0].vector_with_distances_size(), topk);
+
+  // the filtered results only contain the selected ids
+  std::vector<int64_t> select_ids;
+  for (int i = 0; i < data_base_size; i += 3) {
+    select_ids.push_back(i + start_id);
+  }
+  std::vector<int64_t> select_ids_clone = select_ids;
+  auto filter = std::make_shared<VectorIndex::ConcreteFilterFunctor>(std::move(select_ids));
+  results.clear();
+  ok = fast_scan_index->Search(query_vectors, topk, {filter}, false, parameter, results);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  ASSERT_EQ(results.size(), query_vectors.size());
+  for (const auto& result : results) {
+    EXPECT_GT(result.vector_with_distances_size(), 0);
+    for (const auto& distance : result.vector_with_distances()) {
+      EXPECT_NE(std::find(select_ids_clone.begin(), select_ids_clone.end(), distance.vector_with_id().id()),
+                select_ids_clone.end());
+    }
+  }
+
+  results.clear();
+  ok = fast_scan_index->RangeSearch(query_vectors, 10.0F, {}, false, parameter, results);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::EVECTOR_NOT_SUPPORT);
+
+  // save and load, the snapshot of fast scan can not be loaded by ivf pq
+  std::string path = kTempDataDirectory + "/l2_raw_ivf_pq_fast_scan";
+  ok = fast_scan_index->Save(path);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  auto load_index =
+      std::make_shared<VectorIndexRawIvfPq>(101, index_parameter, k_epoch, kRange, vector_index_thread_pool);
+  ok = load_index->Load(path);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  int64_t count = 0;
+  load_index->GetCount(count);
+  EXPECT_EQ(count, data_base_size);
+
+  index_parameter.mutable_ivf_pq_parameter()->set_use_fast_scan(false);
+  auto ivf_pq_index =
+      std::make_shared<VectorIndexRawIvfPq>(102, index_parameter, k_epoch, kRange, vector_index_thread_pool);
+  ok = ivf_pq_index->Load(path);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::EINTERNAL);
+}
+
+TEST_F(VectorIndexRawIvfPqTest, PlanRebalance) {
+  // balanced
+  EXPECT_TRUE(VectorIndexRawIvfPq::PlanRebalance({100, 100, 100, 100}, 4.0, 0.1, 10, 10000).empty());
+
+  // the largest list pairs with the smallest list
+  auto plans = VectorIndexRawIvfPq::PlanRebalance({100, 5000, 0, 100, 3000, 2, 100, 100}, 2.0, 0.1, 10, 10000);
+  ASSERT_EQ(plans.size(), 2);
+  EXPECT_EQ(plans[0], std::make_pair<size_t, size_t>(1, 2));
+  EXPECT_EQ(plans[1], std::make_pair<size_t, size_t>(4, 5));
+
+  // the first plan is kept even if over budget
+  plans = VectorIndexRawIvfPq::PlanRebalance({100, 5000, 0, 100, 3000, 2, 100, 100}, 2.0, 0.1, 10, 1000);
+  ASSERT_EQ(plans.size(), 1);
+  EXPECT_EQ(plans[0], std::make_pair<size_t, size_t>(1, 2));
+
+  // too small to split
+  EXPECT_TRUE(VectorIndexRawIvfPq::PlanRebalance({1, 50, 0, 1}, 2.0, 0.1, 100, 10000).empty());
+}
+
+TEST_F(VectorIndexRawIvfPqTest, Rebalance) {
+  static const pb::common::Range kRange;
+  static pb::common::RegionEpoch k_epoch;
+  k_epoch.set_conf_version(1);
+  k_epoch.set_version(10);
+
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ);
+  index_parameter.mutable_ivf_pq_parameter()->set_dimension(dimension);
+  index_parameter.mutable_ivf_pq_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+  index_parameter.mutable_ivf_pq_parameter()->set_ncentroids(10);
+  index_parameter.mutable_ivf_pq_parameter()->set_nsubvector(nsubvector);
+  index_parameter.mutable_ivf_pq_parameter()->set_nbits_per_idx(4);
+  index_parameter.mutable_ivf_pq_parameter()->set_use_fast_scan(true);
+
+  auto index = std::make_shared<VectorIndexRawIvfPq>(103, index_parameter, k_epoch, kRange, vector_index_thread_pool);
+
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<> distrib;
+  std::vector<float> datas(data_base_size * dimension);
+  for (auto& data : datas) {
+    data = distrib(rng);
+  }
+  butil::Status ok = index->Train(datas);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  // drifted data, most vectors are near the first vector and land in one list
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  for (int i = 0; i < data_base_size; i++) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(i + start_id);
+    for (size_t j = 0; j < dimension; j++) {
+      float value = i % 50 == 0 ? datas[i * dimension + j] : datas[j] + distrib(rng) * 0.01F;
+      vector_with_id.mutable_vector()->add_float_values(value);
+    }
+    vector_with_ids.push_back(vector_with_id);
+  }
+  ok = index->Add(vector_with_ids);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  int64_t old_interval = FLAGS_ivf_pq_rebalance_interval_s;
+  int64_t old_min_split_size = FLAGS_ivf_pq_rebalance_min_split_size;
+  FLAGS_ivf_pq_rebalance_interval_s = 0;
+  FLAGS_ivf_pq_rebalance_min_split_size = 10;
+
+  EXPECT_TRUE(index->NeedToRepair());
+  ok = index->Repair();
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  FLAGS_ivf_pq_rebalance_interval_s = old_interval;
+  FLAGS_ivf_pq_rebalance_min_split_size = old_min_split_size;
+
+  // no vector is lost by rebalance
+  int64_t count = 0;
+  index->GetCount(count);
+  EXPECT_EQ(count, data_base_size);
+
+  std::vector<pb::common::VectorWithId> query_vectors(vector_with_ids.begin(), vector_with_ids.begin() + 2);
+  pb::common::VectorSearchParameter parameter;
+  parameter.mutable_ivf_pq()->set_nprobe(10);
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  ok = index->Search(query_vectors, 5, {}, false, parameter, results);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  ASSERT_EQ(results.size(), query_vectors.size());
+  EXPECT_EQ(results[0].vector_with_distances_size(), 5);
+}
+
 }  // namespace dingodb
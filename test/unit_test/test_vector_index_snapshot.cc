@@ -20,9 +20,12 @@
 #include <string>
 #include <vector>
 
+#include "braft/protobuf_file.h"
 #include "butil/endpoint.h"
 #include "butil/strings/string_split.h"
+#include "common/helper.h"
 #include "fmt/core.h"
+#include "proto/store_internal.pb.h"
 #include "vector/vector_index_snapshot.h"
 
 class VectorIndexSnapshotTest : public testing::Test {
@@ -149,3 +152,62 @@ TEST_F(VectorIndexSnapshotTest, AddSnapshot) {  // NOLINT
     EXPECT_EQ(1, snapshot_set->GetSnapshots().size());
   }
 }
+
+TEST_F(VectorIndexSnapshotTest, DeltaSnapshot) {  // NOLINT
+  int64_t vector_index_id = 102;
+  int64_t snapshot_log_id = 30;
+  std::string path = fmt::format("/tmp/{}/snapshot_{:020}", vector_index_id, snapshot_log_id);
+  ASSERT_TRUE(dingodb::Helper::CreateDirectories(path).ok());
+
+  // write delta file
+  std::string delta_file_name = fmt::format("delta_{:020}_{:020}.log", 21, snapshot_log_id);
+  {
+    dingodb::vector_index::SnapshotDeltaWriter writer(fmt::format("{}/{}", path, delta_file_name));
+    ASSERT_TRUE(writer.Open());
+
+    dingodb::pb::store_internal::VectorIndexSnapshotDelta delta;
+    for (int64_t id = 1; id <= 10; ++id) {
+      auto* vector_with_id = delta.add_vectors();
+      vector_with_id->set_id(id);
+      vector_with_id->mutable_vector()->add_float_values(static_cast<float>(id));
+    }
+    ASSERT_TRUE(writer.Append(delta));
+
+    delta.Clear();
+    delta.add_delete_ids(3);
+    delta.add_delete_ids(5);
+    ASSERT_TRUE(writer.Append(delta));
+    EXPECT_GT(writer.Size(), 0);
+    ASSERT_TRUE(writer.Close());
+  }
+
+  // write meta
+  dingodb::pb::store_internal::VectorIndexSnapshotMeta meta;
+  meta.set_vector_index_id(vector_index_id);
+  meta.set_snapshot_log_id(snapshot_log_id);
+  meta.set_base_snapshot_log_id(20);
+  meta.add_delta_file_names(delta_file_name);
+  braft::ProtoBufFile pb_file_meta(fmt::format("{}/meta", path));
+  ASSERT_EQ(0, pb_file_meta.save(&meta, true));
+
+  auto snapshot = dingodb::vector_index::SnapshotMeta::New(vector_index_id, path);
+  ASSERT_TRUE(snapshot->Init());
+  EXPECT_TRUE(snapshot->IsDelta());
+  EXPECT_EQ(snapshot_log_id, snapshot->SnapshotLogId());
+  EXPECT_EQ(20, snapshot->BaseSnapshotLogId());
+  EXPECT_EQ(fmt::format("{}/index_{}_{}.idx", path, vector_index_id, 20), snapshot->IndexDataPath());
+  ASSERT_EQ(1, snapshot->DeltaFilePaths().size());
+
+  // read delta file by order
+  std::vector<dingodb::pb::store_internal::VectorIndexSnapshotDelta> deltas;
+  ASSERT_TRUE(dingodb::vector_index::SnapshotDeltaWriter::Read(
+      snapshot->DeltaFilePaths()[0], [&](const dingodb::pb::store_internal::VectorIndexSnapshotDelta& delta) {
+        deltas.push_back(delta);
+        return true;
+      }));
+  ASSERT_EQ(2, deltas.size());
+  EXPECT_EQ(10, deltas[0].vectors_size());
+  EXPECT_EQ(0, deltas[0].delete_ids_size());
+  EXPECT_EQ(2, deltas[1].delete_ids_size());
+  EXPECT_EQ(5, deltas[1].delete_ids(1));
+}
@@ -0,0 +1,133 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/constant.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "vector/codec.h"
+#include "vector/vector_index_train.h"
+
+namespace dingodb {
+
+DECLARE_int32(vector_index_train_thread_num);
+
+class VectorIndexTrainTest : public testing::Test {
+ protected:
+  void SetUp() override { CentroidCache::GetInstance().Clear(); }
+  void TearDown() override { CentroidCache::GetInstance().Clear(); }
+
+  static pb::common::Vector NewVector(float value, int32_t dimension) {
+    pb::common::Vector vector;
+    for (int32_t i = 0; i < dimension; ++i) {
+      vector.add_float_values(value);
+    }
+    return vector;
+  }
+
+  static pb::common::Range NewRange(int64_t partition_id) {
+    pb::common::Range range;
+    std::string start_key;
+    VectorCodec::EncodeVectorKey(Constant::kExecutorRaw, partition_id, 0, start_key);
+    range.set_start_key(start_key);
+    return range;
+  }
+};
+
+TEST_F(VectorIndexTrainTest, Sampler) {
+  const int32_t dimension = 4;
+
+  // keep all
+  {
+    TrainDataSampler sampler(dimension, 0);
+    for (int i = 0; i < 100; ++i) {
+      sampler.Add(NewVector(i, dimension));
+    }
+    EXPECT_EQ(100, sampler.Count());
+    EXPECT_EQ(100 * dimension, sampler.Datas().size());
+  }
+
+  // sampled vectors are the whole added vectors, mismatch dimension is skipped.
+  {
+    TrainDataSampler sampler(dimension, 10);
+    for (int i = 0; i < 1000; ++i) {
+      sampler.Add(NewVector(i, dimension));
+    }
+    sampler.Add(NewVector(0, dimension + 1));
+    EXPECT_EQ(1000, sampler.Count());
+    ASSERT_EQ(10 * dimension, sampler.Datas().size());
+
+    const auto& datas = sampler.Datas();
+    int later_count = 0;
+    for (int i = 0; i < 10; ++i) {
+      for (int j = 1; j < dimension; ++j) {
+        EXPECT_EQ(datas[i * dimension], datas[i * dimension + j]);
+      }
+      if (datas[i * dimension] >= 10) {
+        ++later_count;
+      }
+    }
+    // the sample is not the first vectors.
+    EXPECT_GT(later_count, 0);
+  }
+}
+
+TEST_F(VectorIndexTrainTest, CentroidCache) {
+  pb::common::VectorIndexParameter parameter;
+  parameter.set_vector_index_type(pb::common::VECTOR_INDEX_TYPE_IVF_FLAT);
+  parameter.mutable_ivf_flat_parameter()->set_dimension(4);
+  parameter.mutable_ivf_flat_parameter()->set_ncentroids(2);
+
+  auto key = CentroidCache::GenKey(NewRange(100), parameter, 2);
+  EXPECT_EQ(key, CentroidCache::GenKey(NewRange(100), parameter, 2));
+  EXPECT_NE(key, CentroidCache::GenKey(NewRange(101), parameter, 2));
+  EXPECT_NE(key, CentroidCache::GenKey(NewRange(100), parameter, 1));
+
+  std::vector<float> centroids;
+  EXPECT_FALSE(CentroidCache::GetInstance().Get(key, 100, centroids));
+
+  CentroidCache::GetInstance().Put(key, 100, std::vector<float>(8, 1.0f));
+  EXPECT_TRUE(CentroidCache::GetInstance().Get(key, 100, centroids));
+  EXPECT_EQ(8, centroids.size());
+
+  // trained by less data, not reused.
+  EXPECT_FALSE(CentroidCache::GetInstance().Get(key, 101, centroids));
+  EXPECT_EQ(1, CentroidCache::GetInstance().Size());
+}
+
+TEST_F(VectorIndexTrainTest, ThreadBudget) {
+  int32_t origin_thread_num = FLAGS_vector_index_train_thread_num;
+  FLAGS_vector_index_train_thread_num = 4;
+
+  {
+    TrainThreadGuard guard1;
+    EXPECT_EQ(4, guard1.ThreadNum());
+
+    // budget is used up, at least one.
+    TrainThreadGuard guard2;
+    EXPECT_EQ(1, guard2.ThreadNum());
+  }
+
+  TrainThreadGuard guard3;
+  EXPECT_EQ(4, guard3.ThreadNum());
+
+  FLAGS_vector_index_train_thread_num = origin_thread_num;
+}
+
+}  // namespace dingodb
@@ -4057,4 +4057,47 @@ TEST_F(VectorIndexUtilsTest, NormalizeVectorForHnsw) {
   }
 }
 
+TEST_F(VectorIndexUtilsTest, CheckAndViewVectorData) {
+  constexpr uint32_t kDimension = 4;
+  std::vector<pb::common::VectorWithId> vector_with_ids(1);
+  auto* vector = vector_with_ids[0].mutable_vector();
+  vector->set_dimension(kDimension);
+  vector->set_value_type(pb::common::ValueType::FLOAT);
+  for (uint32_t i = 0; i < kDimension; ++i) {
+    vector->add_float_values(static_cast<float>(i + 1));
+  }
+
+  // one float vector without normalization is not copied
+  {
+    auto [vectors, status] = VectorIndexUtils::CheckAndViewVectorData(vector_with_ids, kDimension, false);
+    EXPECT_TRUE(status.ok());
+    EXPECT_TRUE(vectors.IsView());
+    EXPECT_EQ(vectors.get(), vector->float_values().data());
+  }
+
+  // normalized
+  {
+    auto [vectors, status] = VectorIndexUtils::CheckAndViewVectorData(vector_with_ids, kDimension, true);
+    EXPECT_TRUE(status.ok());
+    EXPECT_FALSE(vectors.IsView());
+    EXPECT_NE(vectors.get(), vector->float_values().data());
+    EXPECT_EQ(vector->float_values(0), 1.0F);
+  }
+
+  // not contiguous
+  {
+    vector_with_ids.push_back(vector_with_ids[0]);
+    auto [vectors, status] = VectorIndexUtils::CheckAndViewVectorData(vector_with_ids, kDimension, false);
+    EXPECT_TRUE(status.ok());
+    EXPECT_FALSE(vectors.IsView());
+    EXPECT_EQ(vectors.get()[kDimension + 3], 4.0F);
+  }
+
+  // dimension not match
+  {
+    auto [vectors, status] = VectorIndexUtils::CheckAndViewVectorData(vector_with_ids, kDimension + 1, false);
+    EXPECT_EQ(status.error_code(), pb::error::Errno::EVECTOR_INVALID);
+  }
+}
+
 }  // namespace dingodb
@@ -0,0 +1,165 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/rocks_raw_engine.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "vector/codec.h"
+#include "vector/vector_scalar_index.h"
+
+namespace dingodb {
+
+DECLARE_string(vector_scalar_inverted_index_keys);
+
+static const std::string kRootPath = "./unit_test_vector_scalar_index";
+static const std::string kLogPath = kRootPath + "/log";
+static const std::string kStorePath = kRootPath + "/db";
+static const std::string kYamlConfigContent =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 666\n"
+    "server:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23000\n"
+    "log:\n"
+    "  path: " +
+    kLogPath +
+    "\n"
+    "store:\n"
+    "  path: " +
+    kStorePath + "\n";
+
+static const std::vector<std::string> kAllCFs = {Constant::kVectorScalarCF};
+
+static pb::common::VectorScalardata GenScalarData(const std::string& tag, int64_t level) {
+  pb::common::VectorScalardata scalar_data;
+  auto& tag_value = (*scalar_data.mutable_scalar_data())["tag"];
+  tag_value.set_field_type(pb::common::ScalarFieldType::STRING);
+  tag_value.add_fields()->set_string_data(tag);
+  auto& level_value = (*scalar_data.mutable_scalar_data())["level"];
+  level_value.set_field_type(pb::common::ScalarFieldType::INT64);
+  level_value.add_fields()->set_long_data(level);
+  return scalar_data;
+}
+
+class VectorScalarInvertedIndexTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    Helper::CreateDirectories(kLogPath);
+    Helper::CreateDirectories(kStorePath);
+    std::shared_ptr<Config> config = std::make_shared<YamlConfig>();
+    ASSERT_EQ(0, config->Load(kYamlConfigContent));
+
+    engine = std::make_shared<RocksRawEngine>();
+    ASSERT_TRUE(engine->Init(config, kAllCFs));
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine->Destroy();
+    Helper::RemoveAllFileOrDirectory(kRootPath);
+  }
+
+  void SetUp() override { FLAGS_vector_scalar_inverted_index_keys = "tag,level"; }
+  void TearDown() override { FLAGS_vector_scalar_inverted_index_keys = ""; }
+
+  static std::shared_ptr<RocksRawEngine> engine;
+};
+
+std::shared_ptr<RocksRawEngine> VectorScalarInvertedIndexTest::engine = nullptr;
+
+TEST_F(VectorScalarInvertedIndexTest, EncodeTerm) {
+  pb::common::ScalarValue value1;
+  value1.set_field_type(pb::common::ScalarFieldType::STRING);
+  value1.add_fields()->set_string_data("a|b");
+  pb::common::ScalarValue value2;
+  value2.set_field_type(pb::common::ScalarFieldType::STRING);
+  value2.add_fields()->set_string_data("a");
+  value2.add_fields()->set_string_data("b");
+
+  EXPECT_NE(VectorScalarInvertedIndex::EncodeTerm("k", value1), VectorScalarInvertedIndex::EncodeTerm("k", value2));
+  EXPECT_NE(VectorScalarInvertedIndex::EncodeTerm("k", value1), VectorScalarInvertedIndex::EncodeTerm("k1", value1));
+  EXPECT_EQ(VectorScalarInvertedIndex::EncodeTerm("k", value1), VectorScalarInvertedIndex::EncodeTerm("k", value1));
+
+  pb::common::ScalarValue float_value;
+  float_value.set_field_type(pb::common::ScalarFieldType::FLOAT32);
+  float_value.add_fields()->set_float_data(1.0);
+  EXPECT_TRUE(VectorScalarInvertedIndex::EncodeTerm("k", float_value).empty());
+}
+
+TEST_F(VectorScalarInvertedIndexTest, BuildAndLookup) {
+  pb::common::Range range;
+  VectorCodec::EncodeVectorKey(Constant::kClientRaw, 1, 1, *range.mutable_start_key());
+  VectorCodec::EncodeVectorKey(Constant::kClientRaw, 1, 1000, *range.mutable_end_key());
+
+  auto writer = engine->Writer();
+  for (int64_t id = 1; id <= 100; ++id) {
+    pb::common::KeyValue kv;
+    VectorCodec::EncodeVectorKey(Constant::kClientRaw, 1, id, *kv.mutable_key());
+    kv.set_value(GenScalarData(id % 2 == 0 ? "even" : "odd", id % 10).SerializeAsString());
+    ASSERT_TRUE(writer->KvPut(Constant::kVectorScalarCF, kv).ok());
+  }
+
+  VectorScalarInvertedIndex index;
+  std::vector<int64_t> vector_ids;
+  auto query = GenScalarData("even", 4);
+  // not built
+  EXPECT_FALSE(index.Lookup(range, query, vector_ids));
+
+  ASSERT_TRUE(index.Build(engine->Reader(), range).ok());
+  ASSERT_TRUE(index.Lookup(range, query, vector_ids));
+  std::vector<int64_t> expect_ids = {4, 14, 24, 34, 44, 54, 64, 74, 84, 94};
+  EXPECT_EQ(expect_ids, vector_ids);
+
+  // apply path
+  index.Upsert(4, GenScalarData("odd", 4));
+  index.Delete(14);
+  index.Upsert(200, GenScalarData("even", 4));
+  ASSERT_TRUE(index.Lookup(range, query, vector_ids));
+  expect_ids = {24, 34, 44, 54, 64, 74, 84, 94, 200};
+  EXPECT_EQ(expect_ids, vector_ids);
+
+  // not match any
+  ASSERT_TRUE(index.Lookup(range, GenScalarData("none", 4), vector_ids));
+  EXPECT_TRUE(vector_ids.empty());
+
+  // not indexed key
+  FLAGS_vector_scalar_inverted_index_keys = "tag";
+  EXPECT_FALSE(index.Lookup(range, query, vector_ids));
+
+  // range changed, e.g. split
+  FLAGS_vector_scalar_inverted_index_keys = "tag,level";
+  pb::common::Range child_range = range;
+  VectorCodec::EncodeVectorKey(Constant::kClientRaw, 1, 50, *child_range.mutable_end_key());
+  EXPECT_FALSE(index.Lookup(child_range, query, vector_ids));
+  ASSERT_TRUE(index.Build(engine->Reader(), child_range).ok());
+  ASSERT_TRUE(index.Lookup(child_range, query, vector_ids));
+  expect_ids = {4, 14, 24, 34, 44};
+  EXPECT_EQ(expect_ids, vector_ids);
+
+  index.Clear();
+  EXPECT_FALSE(index.Lookup(child_range, query, vector_ids));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,161 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/codec.h"
+#include "vector/vector_scan_kernel.h"
+
+namespace dingodb {
+
+DECLARE_string(vector_value_encoding);
+
+class VectorScanKernelTest : public testing::Test {
+ protected:
+  static std::vector<float> RandomVector(std::mt19937& rng, int32_t dimension) {
+    std::uniform_real_distribution<float> distrib(-1.0f, 1.0f);
+    std::vector<float> vector(dimension);
+    for (auto& value : vector) {
+      value = distrib(rng);
+    }
+    return vector;
+  }
+};
+
+TEST_F(VectorScanKernelTest, Distance) {
+  std::mt19937 rng(1234);
+  for (int32_t dimension = 1; dimension <= 130; ++dimension) {
+    auto x = RandomVector(rng, dimension);
+    auto y = RandomVector(rng, dimension);
+
+    float l2 = 0.0f;
+    float ip = 0.0f;
+    for (int32_t i = 0; i < dimension; ++i) {
+      l2 += (x[i] - y[i]) * (x[i] - y[i]);
+      ip += x[i] * y[i];
+    }
+
+    EXPECT_NEAR(l2, VectorScanKernel::L2Sqr(x.data(), y.data(), dimension), 1e-3) << VectorScanKernel::SimdName();
+    EXPECT_NEAR(ip, VectorScanKernel::InnerProduct(x.data(), y.data(), dimension), 1e-3)
+        << VectorScanKernel::SimdName();
+  }
+}
+
+TEST_F(VectorScanKernelTest, Topk) {
+  const int32_t dimension = 37;
+  const uint32_t topk = 10;
+  std::mt19937 rng(4321);
+
+  std::vector<std::vector<float>> data_base;
+  for (int i = 0; i < 1000; ++i) {
+    data_base.push_back(RandomVector(rng, dimension));
+  }
+
+  std::vector<pb::common::VectorWithId> queries(3);
+  for (auto& query : queries) {
+    for (auto value : RandomVector(rng, dimension)) {
+      query.mutable_vector()->add_float_values(value);
+    }
+  }
+
+  for (auto metric_type : {pb::common::MetricType::METRIC_TYPE_L2, pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT}) {
+    // block size is not a divisor of data base size, the last block is computed by GetResults.
+    VectorScanKernel scan_kernel(metric_type, dimension, topk, 64);
+    ASSERT_TRUE(scan_kernel.SetQueries(queries).ok());
+
+    for (size_t i = 0; i < data_base.size(); ++i) {
+      pb::common::Vector vector;
+      for (auto value : data_base[i]) {
+        vector.add_float_values(value);
+      }
+      ASSERT_TRUE(scan_kernel.AddEncoded(i + 1, vector.SerializeAsString()).ok());
+    }
+
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    scan_kernel.GetResults(results);
+    ASSERT_EQ(queries.size(), results.size());
+
+    for (size_t q = 0; q < queries.size(); ++q) {
+      const float* query = queries[q].vector().float_values().data();
+      std::vector<std::pair<float, int64_t>> expects;
+      for (size_t i = 0; i < data_base.size(); ++i) {
+        float distance = metric_type == pb::common::MetricType::METRIC_TYPE_L2
+                             ? VectorScanKernel::L2Sqr(query, data_base[i].data(), dimension)
+                             : 1.0f - VectorScanKernel::InnerProduct(query, data_base[i].data(), dimension);
+        expects.emplace_back(distance, i + 1);
+      }
+      std::sort(expects.begin(), expects.end());
+
+      ASSERT_EQ(topk, results[q].vector_with_distances().size());
+      for (uint32_t i = 0; i < topk; ++i) {
+        const auto& vector_with_distance = results[q].vector_with_distances(i);
+        EXPECT_EQ(expects[i].second, vector_with_distance.vector_with_id().id());
+        EXPECT_FLOAT_EQ(expects[i].first, vector_with_distance.distance());
+      }
+    }
+  }
+
+  // dimension not match
+  VectorScanKernel scan_kernel(pb::common::MetricType::METRIC_TYPE_L2, dimension + 1, topk, 64);
+  EXPECT_FALSE(scan_kernel.SetQueries(queries).ok());
+}
+
+TEST_F(VectorScanKernelTest, PackedVectorValue) {
+  pb::common::Vector vector;
+  vector.set_dimension(4);
+  vector.set_value_type(pb::common::ValueType::FLOAT);
+  for (float value : {0.5f, -1.25f, 3.0f, 100.0f}) {
+    vector.add_float_values(value);
+  }
+
+  for (const std::string encoding : {"protobuf", "packed_float", "packed_fp16"}) {
+    FLAGS_vector_value_encoding = encoding;
+    std::string value;
+    VectorCodec::EncodeVectorValue(vector, value);
+    EXPECT_EQ(encoding != "protobuf", VectorCodec::IsPackedVectorValue(value));
+
+    pb::common::Vector decode_vector;
+    ASSERT_TRUE(VectorCodec::DecodeVectorValue(value, decode_vector));
+    EXPECT_EQ(4, decode_vector.dimension());
+    ASSERT_EQ(4, decode_vector.float_values_size());
+    // These values are exact in fp16.
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_FLOAT_EQ(vector.float_values(i), decode_vector.float_values(i));
+    }
+
+    float buffer[4];
+    const float* floats = VectorCodec::DecodeVectorValueToFloat(value, 4, buffer);
+    ASSERT_NE(nullptr, floats);
+    EXPECT_FLOAT_EQ(-1.25f, floats[1]);
+    EXPECT_EQ(nullptr, VectorCodec::DecodeVectorValueToFloat(value, 3, buffer));
+  }
+  FLAGS_vector_value_encoding = "protobuf";
+
+  // Broken packed value.
+  pb::common::Vector decode_vector;
+  EXPECT_FALSE(VectorCodec::DecodeVectorValue(std::string("\xFE\x01\x00", 3), decode_vector));
+}
+
+}  // namespace dingodb
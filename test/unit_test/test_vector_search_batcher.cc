@@ -0,0 +1,144 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "butil/status.h"
+#include "engine/engine.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_search_batcher.h"
+
+namespace dingodb {
+
+DECLARE_int64(vector_search_batch_window_us);
+
+class VectorSearchBatcherTest : public testing::Test {
+ protected:
+  // make batching not depend on thread start time.
+  void SetUp() override {
+    window_us_ = FLAGS_vector_search_batch_window_us;
+    FLAGS_vector_search_batch_window_us = 100 * 1000;
+  }
+  void TearDown() override { FLAGS_vector_search_batch_window_us = window_us_; }
+
+  static std::shared_ptr<Engine::VectorReader::Context> NewContext(int64_t region_id, int64_t query_id) {
+    auto ctx = std::make_shared<Engine::VectorReader::Context>();
+    ctx->region_id = region_id;
+    ctx->parameter.set_top_n(3);
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(query_id);
+    ctx->vector_with_ids.push_back(vector_with_id);
+    return ctx;
+  }
+
+  // echo the query id as the result id.
+  static butil::Status EchoSearch(std::shared_ptr<Engine::VectorReader::Context> ctx,
+                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
+    for (const auto& vector_with_id : ctx->vector_with_ids) {
+      if (vector_with_id.id() < 0) {
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "invalid query");
+      }
+      pb::index::VectorWithDistanceResult result;
+      result.add_vector_with_distances()->mutable_vector_with_id()->set_id(vector_with_id.id());
+      results.push_back(result);
+    }
+    return butil::Status();
+  }
+
+  int64_t window_us_{0};
+};
+
+TEST_F(VectorSearchBatcherTest, Search) {
+  std::atomic<int64_t> call_count{0};
+  std::atomic<int64_t> max_query_count{0};
+  VectorSearchBatcher batcher([&](std::shared_ptr<Engine::VectorReader::Context> ctx,
+                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
+    ++call_count;
+    int64_t query_count = ctx->vector_with_ids.size();
+    int64_t old_count = max_query_count.load();
+    while (old_count < query_count && !max_query_count.compare_exchange_weak(old_count, query_count)) {
+    }
+    bthread_usleep(5000);
+    return EchoSearch(ctx, results);
+  });
+
+  // no concurrency
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  ASSERT_TRUE(batcher.Search(NewContext(1, 100), results).ok());
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(100, results[0].vector_with_distances(0).vector_with_id().id());
+  EXPECT_EQ(1, call_count.load());
+
+  // concurrent requests of the same region are merged, and each gets its own result.
+  const int kThreadNum = 16;
+  std::vector<std::vector<pb::index::VectorWithDistanceResult>> thread_results(kThreadNum);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadNum; ++i) {
+    threads.emplace_back([&, i]() { EXPECT_TRUE(batcher.Search(NewContext(1, i + 1), thread_results[i]).ok()); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < kThreadNum; ++i) {
+    ASSERT_EQ(1, thread_results[i].size());
+    EXPECT_EQ(i + 1, thread_results[i][0].vector_with_distances(0).vector_with_id().id());
+  }
+  EXPECT_GT(max_query_count.load(), 1);
+  EXPECT_LT(call_count.load(), kThreadNum + 1);
+}
+
+TEST_F(VectorSearchBatcherTest, Fallback) {
+  VectorSearchBatcher batcher([&](std::shared_ptr<Engine::VectorReader::Context> ctx,
+                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
+    bthread_usleep(5000);
+    return EchoSearch(ctx, results);
+  });
+
+  // the invalid query fails alone, others are retried one by one.
+  const int kThreadNum = 8;
+  std::vector<std::vector<pb::index::VectorWithDistanceResult>> thread_results(kThreadNum);
+  std::vector<butil::Status> statuses(kThreadNum);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadNum; ++i) {
+    int64_t query_id = i == 3 ? -1 : i + 1;
+    threads.emplace_back(
+        [&, i, query_id]() { statuses[i] = batcher.Search(NewContext(2, query_id), thread_results[i]); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < kThreadNum; ++i) {
+    if (i == 3) {
+      EXPECT_FALSE(statuses[i].ok());
+      continue;
+    }
+    ASSERT_TRUE(statuses[i].ok());
+    ASSERT_EQ(1, thread_results[i].size());
+    EXPECT_EQ(i + 1, thread_results[i][0].vector_with_distances(0).vector_with_id().id());
+  }
+}
+
+}  // namespace dingodb
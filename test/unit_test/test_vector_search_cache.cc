@@ -0,0 +1,163 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "butil/status.h"
+#include "engine/engine.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_search_cache.h"
+
+namespace dingodb {
+
+DECLARE_bool(enable_vector_search_cache);
+DECLARE_int64(vector_search_cache_capacity);
+
+class VectorSearchCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    enable_ = FLAGS_enable_vector_search_cache;
+    capacity_ = FLAGS_vector_search_cache_capacity;
+    FLAGS_enable_vector_search_cache = true;
+  }
+  void TearDown() override {
+    FLAGS_enable_vector_search_cache = enable_;
+    FLAGS_vector_search_cache_capacity = capacity_;
+  }
+
+  static std::shared_ptr<Engine::VectorReader::Context> NewContext(int64_t region_id, int64_t query_id) {
+    auto ctx = std::make_shared<Engine::VectorReader::Context>();
+    ctx->region_id = region_id;
+    ctx->parameter.set_top_n(3);
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(query_id);
+    ctx->vector_with_ids.push_back(vector_with_id);
+    return ctx;
+  }
+
+  bool enable_{false};
+  int64_t capacity_{0};
+};
+
+TEST_F(VectorSearchCacheTest, Search) {
+  std::atomic<int64_t> call_count{0};
+  VectorSearchCache cache([&](std::shared_ptr<Engine::VectorReader::Context> ctx,
+                              std::vector<pb::index::VectorWithDistanceResult>& results) {
+    ++call_count;
+    pb::index::VectorWithDistanceResult result;
+    result.add_vector_with_distances()->mutable_vector_with_id()->set_id(ctx->vector_with_ids[0].id());
+    results.push_back(result);
+    return butil::Status();
+  });
+
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  ASSERT_TRUE(cache.Search(NewContext(1, 10), 100, results).ok());
+  ASSERT_TRUE(cache.Search(NewContext(1, 10), 100, results).ok());
+  EXPECT_EQ(1, call_count.load());
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(10, results[0].vector_with_distances(0).vector_with_id().id());
+
+  // another query, another region and new applied index all miss.
+  ASSERT_TRUE(cache.Search(NewContext(1, 11), 100, results).ok());
+  ASSERT_TRUE(cache.Search(NewContext(2, 10), 100, results).ok());
+  ASSERT_TRUE(cache.Search(NewContext(1, 10), 101, results).ok());
+  EXPECT_EQ(4, call_count.load());
+
+  // unknown applied index is not cached.
+  ASSERT_TRUE(cache.Search(NewContext(1, 10), -1, results).ok());
+  ASSERT_TRUE(cache.Search(NewContext(1, 10), -1, results).ok());
+  EXPECT_EQ(6, call_count.load());
+
+  FLAGS_enable_vector_search_cache = false;
+  ASSERT_TRUE(cache.Search(NewContext(1, 10), 100, results).ok());
+  EXPECT_EQ(7, call_count.load());
+}
+
+TEST_F(VectorSearchCacheTest, Evict) {
+  FLAGS_vector_search_cache_capacity = 2;
+  int64_t call_count = 0;
+  VectorSearchCache cache([&](std::shared_ptr<Engine::VectorReader::Context>,
+                              std::vector<pb::index::VectorWithDistanceResult>& results) {
+    ++call_count;
+    results.emplace_back();
+    return butil::Status();
+  });
+
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  for (int64_t i = 0; i < 3; ++i) {
+    ASSERT_TRUE(cache.Search(NewContext(1, i), 100, results).ok());
+  }
+  EXPECT_EQ(2, cache.Size());
+
+  // the first one is evicted.
+  ASSERT_TRUE(cache.Search(NewContext(1, 2), 100, results).ok());
+  EXPECT_EQ(3, call_count);
+  ASSERT_TRUE(cache.Search(NewContext(1, 0), 100, results).ok());
+  EXPECT_EQ(4, call_count);
+}
+
+TEST_F(VectorSearchCacheTest, ErrorNotCached) {
+  int64_t call_count = 0;
+  VectorSearchCache cache(
+      [&](std::shared_ptr<Engine::VectorReader::Context>, std::vector<pb::index::VectorWithDistanceResult>&) {
+        ++call_count;
+        return butil::Status(pb::error::EINTERNAL, "search failed");
+      });
+
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  EXPECT_FALSE(cache.Search(NewContext(1, 1), 100, results).ok());
+  EXPECT_FALSE(cache.Search(NewContext(1, 1), 100, results).ok());
+  EXPECT_EQ(2, call_count);
+  EXPECT_EQ(0, cache.Size());
+}
+
+TEST_F(VectorSearchCacheTest, SingleFlight) {
+  std::atomic<int64_t> call_count{0};
+  VectorSearchCache cache([&](std::shared_ptr<Engine::VectorReader::Context>,
+                              std::vector<pb::index::VectorWithDistanceResult>& results) {
+    ++call_count;
+    // keep the search running until all requests arrive.
+    bthread_usleep(200 * 1000);
+    results.emplace_back();
+    return butil::Status();
+  });
+
+  std::vector<std::thread> threads;
+  std::atomic<int64_t> result_count{0};
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&]() {
+      std::vector<pb::index::VectorWithDistanceResult> results;
+      if (cache.Search(NewContext(1, 1), 100, results).ok()) {
+        result_count += results.size();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(1, call_count.load());
+  EXPECT_EQ(8, result_count.load());
+}
+
+}  // namespace dingodb
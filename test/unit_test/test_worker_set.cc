@@ -17,6 +17,7 @@
 
 #include <atomic>
 #include <cstdint>
+#include <mutex>
 #include <vector>
 
 #include "common/helper.h"
@@ -172,3 +173,197 @@ TEST(DingoWorkerSetTest, perf_prior) {
 
   DINGO_LOG(ERROR) << "total_time_ns of WorkerSet: " << total_time_ns.load(std::memory_order_relaxed);
 }
+
+class TestFuncTask : public dingodb::TaskRunnable {
+ public:
+  explicit TestFuncTask(std::function<void()> func) : func_(func) {}
+  ~TestFuncTask() override = default;
+
+  std::string Type() override { return "TEST_FUNC_TASK"; }
+
+  void Run() override { func_(); }
+
+ private:
+  std::function<void()> func_;
+};
+
+TEST(DingoWorkerSetTest, work_stealing) {
+  dingodb::WorkerSetPtr test_worker_set = dingodb::WorkerSet::New("TestStealWorkerSet", 4, 0, true);
+  ASSERT_TRUE(test_worker_set->Init());
+
+  // block worker 0 by a long ordered task
+  std::atomic<bool> is_blocked{true};
+  ASSERT_TRUE(test_worker_set->ExecuteHashByRegionId(0, std::make_shared<TestFuncTask>([&]() {
+    while (is_blocked.load()) {
+      bthread_usleep(1000);
+    }
+  })));
+
+  // stealable tasks dispatched to worker 0 are run by other workers
+  const int k_task_num = 1000;
+  std::atomic<int> finish_count{0};
+  for (int i = 0; i < k_task_num; ++i) {
+    ASSERT_TRUE(test_worker_set->ExecuteRR(std::make_shared<TestFuncTask>([&]() { finish_count.fetch_add(1); })));
+  }
+
+  // ordered tasks of same region keep order
+  std::vector<int> orders;
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(
+        test_worker_set->ExecuteHashByRegionId(1, std::make_shared<TestFuncTask>([&, i]() { orders.push_back(i); })));
+  }
+
+  for (int i = 0; i < 1000 && finish_count.load() < k_task_num; ++i) {
+    bthread_usleep(10000);
+  }
+  EXPECT_EQ(k_task_num, finish_count.load());
+
+  is_blocked.store(false);
+  for (int i = 0; i < 1000 && test_worker_set->PendingTaskCount() > 0; ++i) {
+    bthread_usleep(10000);
+  }
+  EXPECT_EQ(0, test_worker_set->PendingTaskCount());
+
+  ASSERT_EQ(100, orders.size());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, orders[i]);
+  }
+
+  test_worker_set->Destroy();
+}
+
+class TestExpireTask : public dingodb::TaskRunnable {
+ public:
+  TestExpireTask(std::atomic<int>* run_count, std::atomic<int>* expire_count)
+      : run_count_(run_count), expire_count_(expire_count) {}
+  ~TestExpireTask() override = default;
+
+  std::string Type() override { return "TEST_EXPIRE_TASK"; }
+
+  void Run() override { run_count_->fetch_add(1); }
+  void Expire() override { expire_count_->fetch_add(1); }
+
+ private:
+  std::atomic<int>* run_count_;
+  std::atomic<int>* expire_count_;
+};
+
+TEST(DingoWorkerSetTest, prior_lane_deadline) {
+  dingodb::PriorWorkerSetPtr test_worker_set = dingodb::PriorWorkerSet::New("TestLanePriorWorkerSet", 2, 0, false);
+  ASSERT_TRUE(test_worker_set->Init());
+
+  std::atomic<int> run_count{0};
+  std::atomic<int> expire_count{0};
+
+  // deadline already passed
+  auto expired_task = std::make_shared<TestExpireTask>(&run_count, &expire_count);
+  expired_task->SetLane(dingodb::TaskLane::kScan);
+  expired_task->SetDeadlineUs(dingodb::Helper::TimestampUs() - 1000);
+  ASSERT_TRUE(test_worker_set->Execute(expired_task));
+
+  // far deadline
+  auto task = std::make_shared<TestExpireTask>(&run_count, &expire_count);
+  task->SetLane(dingodb::TaskLane::kPointRead);
+  task->SetDeadlineUs(dingodb::Helper::TimestampUs() + 60 * 1000 * 1000);
+  ASSERT_TRUE(test_worker_set->Execute(task));
+
+  for (int i = 0; i < 1000 && run_count.load() + expire_count.load() < 2; ++i) {
+    bthread_usleep(1000);
+  }
+  EXPECT_EQ(1, run_count.load());
+  EXPECT_EQ(1, expire_count.load());
+}
+
+TEST(DingoWorkerSetTest, prior_task_priority) {
+  dingodb::PriorWorkerSetPtr test_worker_set = dingodb::PriorWorkerSet::New("TestPriorityWorkerSet", 1, 0, false);
+  ASSERT_TRUE(test_worker_set->Init());
+
+  // block the only worker, so the following tasks are queued
+  std::atomic<bool> is_started{false};
+  std::atomic<bool> is_blocked{true};
+  ASSERT_TRUE(test_worker_set->Execute(std::make_shared<TestFuncTask>([&]() {
+    is_started.store(true);
+    while (is_blocked.load()) {
+      bthread_usleep(1000);
+    }
+  })));
+  for (int i = 0; i < 1000 && !is_started.load(); ++i) {
+    bthread_usleep(1000);
+  }
+  ASSERT_TRUE(is_started.load());
+
+  std::mutex mutex;
+  std::vector<int> orders;
+  std::vector<int32_t> priorities = {0, 2, 1, 2, 0};
+  for (int i = 0; i < static_cast<int>(priorities.size()); ++i) {
+    auto task = std::make_shared<TestFuncTask>([&, i]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      orders.push_back(i);
+    });
+    task->SetPriority(priorities[i]);
+    ASSERT_TRUE(test_worker_set->Execute(task));
+  }
+
+  is_blocked.store(false);
+  for (int i = 0; i < 1000 && test_worker_set->PendingTaskCount() > 0; ++i) {
+    bthread_usleep(1000);
+  }
+
+  // higher priority first, same priority by submit order
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_EQ(std::vector<int>({1, 3, 2, 0, 4}), orders);
+
+  test_worker_set->Destroy();
+}
+
+TEST(DingoWorkerSetTest, resize) {
+  dingodb::WorkerSetPtr test_worker_set = dingodb::WorkerSet::New("TestResizeWorkerSet", 2, 0);
+  ASSERT_TRUE(test_worker_set->Init());
+
+  EXPECT_FALSE(test_worker_set->Resize(0));
+  ASSERT_TRUE(test_worker_set->Resize(4));
+  ASSERT_TRUE(test_worker_set->Resize(1));
+  ASSERT_TRUE(test_worker_set->Resize(3));
+
+  const int k_task_num = 1000;
+  std::atomic<int> finish_count{0};
+  for (int i = 0; i < k_task_num; ++i) {
+    ASSERT_TRUE(test_worker_set->ExecuteRR(std::make_shared<TestFuncTask>([&]() { finish_count.fetch_add(1); })));
+  }
+
+  for (int i = 0; i < 1000 && finish_count.load() < k_task_num; ++i) {
+    bthread_usleep(10000);
+  }
+  EXPECT_EQ(k_task_num, finish_count.load());
+
+  test_worker_set->Destroy();
+}
+
+TEST(DingoWorkerSetTest, prior_resize) {
+  dingodb::PriorWorkerSetPtr test_worker_set = dingodb::PriorWorkerSet::New("TestResizePriorWorkerSet", 2, 0, false);
+  ASSERT_TRUE(test_worker_set->Init());
+
+  EXPECT_FALSE(test_worker_set->Resize(0));
+
+  const int k_task_num = 1000;
+  std::atomic<int> finish_count{0};
+  auto execute_tasks = [&]() {
+    for (int i = 0; i < k_task_num; ++i) {
+      ASSERT_TRUE(test_worker_set->Execute(std::make_shared<TestFuncTask>([&]() { finish_count.fetch_add(1); })));
+    }
+  };
+
+  ASSERT_TRUE(test_worker_set->Resize(4));
+  execute_tasks();
+
+  // the removed workers finish their running task before exit, the pending tasks are run by the rest
+  ASSERT_TRUE(test_worker_set->Resize(1));
+  execute_tasks();
+
+  for (int i = 0; i < 1000 && finish_count.load() < 2 * k_task_num; ++i) {
+    bthread_usleep(10000);
+  }
+  EXPECT_EQ(2 * k_task_num, finish_count.load());
+
+  test_worker_set->Destroy();
+}
@@ -15,6 +15,8 @@
 #include <gtest/gtest.h>
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "engine/write_data.h"
 #include "fmt/core.h"
@@ -41,4 +43,51 @@ TEST_F(WriteDataBuilderTest, BuildWriteData) {
   }
 
   EXPECT_EQ(true, true);
-}
\ No newline at end of file
+}
+TEST_F(WriteDataBuilderTest, BuildCompareAndSetWrite) {
+  dingodb::pb::common::KeyValue kv;
+  kv.set_key("key0001");
+  kv.set_value("value0002");
+
+  auto writedata = dingodb::WriteDataBuilder::BuildCompareAndSetWrite("default", {kv}, {"value0001"}, true, 1000);
+  ASSERT_EQ(1, writedata->Datums().size());
+  auto* request = writedata->Datums()[0]->TransformToRaft();
+  EXPECT_EQ(dingodb::pb::raft::CmdType::COMPAREANDSET, request->cmd_type());
+  const auto& compare_and_set = request->compare_and_set();
+  EXPECT_EQ("default", compare_and_set.cf_name());
+  ASSERT_EQ(1, compare_and_set.kvs_size());
+  EXPECT_EQ("key0001", compare_and_set.kvs(0).key());
+  EXPECT_EQ("value0001", compare_and_set.expect_values(0));
+  EXPECT_TRUE(compare_and_set.is_atomic());
+  EXPECT_EQ(1000, compare_and_set.now_ms());
+  delete request;
+
+  writedata = dingodb::WriteDataBuilder::BuildPutIfAbsentWrite("default", {kv}, false, 1000);
+  request = writedata->Datums()[0]->TransformToRaft();
+  EXPECT_EQ(dingodb::pb::raft::CmdType::PUTIFABSENT, request->cmd_type());
+  EXPECT_EQ(1, request->put_if_absent().kvs_size());
+  EXPECT_FALSE(request->put_if_absent().is_atomic());
+  delete request;
+}
+
+TEST_F(WriteDataBuilderTest, BuildVectorAddWriteMove) {
+  std::vector<dingodb::pb::common::VectorWithId> vectors;
+  for (int i = 0; i < 4; ++i) {
+    dingodb::pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(i + 1);
+    for (int j = 0; j < 8; ++j) {
+      vector_with_id.mutable_vector()->add_float_values(static_cast<float>(j));
+    }
+    vectors.push_back(vector_with_id);
+  }
+
+  auto writedata = dingodb::WriteDataBuilder::BuildWrite("default", std::move(vectors));
+  ASSERT_EQ(1, writedata->Datums().size());
+  auto* request = writedata->Datums()[0]->TransformToRaft();
+  EXPECT_EQ(dingodb::pb::raft::CmdType::VECTOR_ADD, request->cmd_type());
+  const auto& vector_add = request->vector_add();
+  ASSERT_EQ(4, vector_add.vectors_size());
+  EXPECT_EQ(1, vector_add.vectors(0).id());
+  EXPECT_EQ(8, vector_add.vectors(3).vector().float_values_size());
+  delete request;
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "engine/raw_engine.h"
+#include "engine/write_throttler.h"
+
+namespace dingodb {
+
+class WriteThrottlerTest : public testing::Test {};
+
+static RawEngine::CompactionStats GenCompactionStats() {
+  RawEngine::CompactionStats stats;
+  stats.cf_name = "default";
+  stats.soft_pending_compaction_bytes_limit = 64L * 1024 * 1024 * 1024;
+  stats.hard_pending_compaction_bytes_limit = 256L * 1024 * 1024 * 1024;
+  stats.l0_slowdown_writes_trigger = 20;
+  stats.l0_stop_writes_trigger = 36;
+  return stats;
+}
+
+TEST_F(WriteThrottlerTest, CalculatePressure) {
+  auto stats = GenCompactionStats();
+  EXPECT_DOUBLE_EQ(0, WriteThrottler::CalculatePressure(stats, 0.5));
+
+  // L0 pressure start at 20 * 0.5, full at 36.
+  stats.l0_file_num = 10;
+  EXPECT_DOUBLE_EQ(0, WriteThrottler::CalculatePressure(stats, 0.5));
+  stats.l0_file_num = 23;
+  EXPECT_DOUBLE_EQ(0.5, WriteThrottler::CalculatePressure(stats, 0.5));
+  stats.l0_file_num = 40;
+  EXPECT_DOUBLE_EQ(1, WriteThrottler::CalculatePressure(stats, 0.5));
+
+  // Pending compaction bytes pressure start at 32GB, full at 256GB, the max one is the pressure.
+  stats.l0_file_num = 0;
+  stats.pending_compaction_bytes = 144L * 1024 * 1024 * 1024;
+  EXPECT_DOUBLE_EQ(0.5, WriteThrottler::CalculatePressure(stats, 0.5));
+  stats.l0_file_num = 36;
+  EXPECT_DOUBLE_EQ(1, WriteThrottler::CalculatePressure(stats, 0.5));
+}
+
+TEST_F(WriteThrottlerTest, WriteStopped) {
+  auto stats = GenCompactionStats();
+  stats.is_write_stopped = true;
+  EXPECT_DOUBLE_EQ(1, WriteThrottler::CalculatePressure(stats, 0.5));
+}
+
+TEST_F(WriteThrottlerTest, NoLimit) {
+  RawEngine::CompactionStats stats;
+  stats.pending_compaction_bytes = 1024;
+  stats.l0_file_num = 100;
+  EXPECT_DOUBLE_EQ(0, WriteThrottler::CalculatePressure(stats, 0.5));
+}
+
+}  // namespace dingodb